@@ -114,6 +114,63 @@ namespace epl
 			return COMP_RESULT_LESSTHAN;
 	}
 
+	/*!
+	@class CompFunctor epAlgorithm.h
+	@brief A template Compare Functor for the Comparison of the objects.
+
+	Same as CompClass::CompFunc, but the comparison is inlined when passed to the sort and search functions.
+	*/
+	template <typename T>
+	class CompFunctor{
+	public:
+		/*!
+		Compares object a with object b
+
+		@param[in] a the pointer to the object.
+		@param[in] b the pointer to another object.
+		@return the Result of Comparison
+		*/
+		CompResultType operator()(const void *a, const void *b) const
+		{
+			const T &_a=*reinterpret_cast<const T*>(a);
+			const T &_b=*reinterpret_cast<const T*>(b);
+			if(_a==_b)
+				return COMP_RESULT_EQUAL;
+			else if(_a>_b)
+				return COMP_RESULT_GREATERTHAN;
+			else
+				return COMP_RESULT_LESSTHAN;
+		}
+	};
+
+	/*!
+	@class CompLess epAlgorithm.h
+	@brief A template Adaptor Class which turns the Compare Function into the less-than predicate for STL.
+	*/
+	template <typename T,typename CompFuncType>
+	class CompLess{
+	public:
+		/*!
+		Default Constructor
+		@param[in] compFunc the Compare Function pointer or functor.
+		*/
+		CompLess(CompFuncType compFunc):m_compFunc(compFunc){}
+
+		/*!
+		Check if object a is less than object b
+		@param[in] a the object.
+		@param[in] b another object.
+		@return true if a is less than b, otherwise false.
+		*/
+		bool operator()(const T &a, const T &b) const
+		{
+			return m_compFunc(&a,&b)==COMP_RESULT_LESSTHAN;
+		}
+	private:
+		/// the Compare Function pointer or functor
+		CompFuncType m_compFunc;
+	};
+
 	/*!
 	Template Default Swap Function
 	@param[in] a The pointer to the swap object.
@@ -187,6 +244,10 @@ namespace epl
 		LOCK_POLICY_CRITICALSECTION,
 		/// a multi process environment
 		LOCK_POLICY_MUTEX,
+		/// a multi thread environment with the short critical sections
+		LOCK_POLICY_SPIN_PARK,
+		/// a multi thread environment with the readers sharing the lock
+		LOCK_POLICY_READER_WRITER,
 	}LockPolicy;
 
 	/// Console Priority
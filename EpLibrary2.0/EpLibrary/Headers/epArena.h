@@ -0,0 +1,409 @@
+/*! 
+@file epArena.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Arena Allocator Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Arena Allocator Class.
+
+*/
+#ifndef __EP_ARENA_H__
+#define __EP_ARENA_H__
+#include "epLib.h"
+#include <new>
+#include "epSystem.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+/// the default size of the block allocated by the arena
+#define ARENA_DEFAULT_BLOCK_SIZE 65536
+/// the default alignment of the memory allocated from the arena
+#define ARENA_DEFAULT_ALIGNMENT 8
+
+namespace epl
+{
+	/*! 
+	@class Arena epArena.h
+	@brief A class that implements the bump-pointer allocator over chunked blocks.
+
+	The memory allocated from the arena is not freed one by one, but released all together by Reset or Release.
+	The objects created by New and NewArray are destroyed in the reverse order of creation when the arena is reset.
+	*/
+	class EP_LIBRARY Arena
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the arena
+		@param[in] blockSize the size of the block allocated from the heap.
+		@param[in] lockPolicyType The lock policy
+		*/
+		Arena(size_t blockSize=ARENA_DEFAULT_BLOCK_SIZE, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the objects created and release all blocks
+		*/
+		virtual ~Arena();
+
+		/*!
+		Allocate the memory of given size from the arena.
+		@param[in] size the size of the memory in bytes.
+		@param[in] alignment the alignment of the memory, which must be the power of 2.
+		@return the memory allocated.
+		@remark the memory larger than the block size gets its own block.
+		*/
+		void *Allocate(size_t size, size_t alignment=ARENA_DEFAULT_ALIGNMENT);
+
+		/*!
+		Create the object of given type in the arena.
+		@return the object created.
+		@remark the object is destroyed when the arena is reset.
+		*/
+		template <typename ObjectType>
+		ObjectType *New()
+		{
+			ObjectType *retObj=::new(Allocate(sizeof(ObjectType),__alignof(ObjectType))) ObjectType();
+			registerDestructor<ObjectType>(retObj,1);
+			return retObj;
+		}
+
+		/*!
+		Create the object of given type in the arena from the given argument.
+		@param[in] arg1 The argument for the constructor of the object.
+		@return the object created.
+		@remark the object is destroyed when the arena is reset.
+		*/
+		template <typename ObjectType, typename Arg1>
+		ObjectType *New(Arg1 const &arg1)
+		{
+			ObjectType *retObj=::new(Allocate(sizeof(ObjectType),__alignof(ObjectType))) ObjectType(arg1);
+			registerDestructor<ObjectType>(retObj,1);
+			return retObj;
+		}
+
+		/*!
+		Create the object of given type in the arena from the given arguments.
+		@param[in] arg1 The first argument for the constructor of the object.
+		@param[in] arg2 The second argument for the constructor of the object.
+		@return the object created.
+		@remark the object is destroyed when the arena is reset.
+		*/
+		template <typename ObjectType, typename Arg1, typename Arg2>
+		ObjectType *New(Arg1 const &arg1, Arg2 const &arg2)
+		{
+			ObjectType *retObj=::new(Allocate(sizeof(ObjectType),__alignof(ObjectType))) ObjectType(arg1,arg2);
+			registerDestructor<ObjectType>(retObj,1);
+			return retObj;
+		}
+
+		/*!
+		Create the array of the objects of given type in the arena.
+		@param[in] count the number of the objects.
+		@return the first object of the array.
+		@remark the objects are destroyed when the arena is reset.
+		*/
+		template <typename ObjectType>
+		ObjectType *NewArray(size_t count)
+		{
+			ObjectType *retArr=reinterpret_cast<ObjectType*>(Allocate(sizeof(ObjectType)*count,__alignof(ObjectType)));
+			for(size_t objTrav=0;objTrav<count;objTrav++)
+				::new(retArr+objTrav) ObjectType();
+			registerDestructor<ObjectType>(retArr,count);
+			return retArr;
+		}
+
+		/*!
+		Destroy the objects created, and keep the blocks to reuse for the next allocations.
+		@remark the blocks larger than the block size are released.
+		*/
+		void Reset();
+
+		/*!
+		Destroy the objects created, and release all blocks.
+		*/
+		void Release();
+
+		/*!
+		Return the number of bytes allocated from the arena since the last reset.
+		@return the number of bytes allocated.
+		*/
+		size_t GetUsedSize() const;
+
+		/*!
+		Return the number of bytes of the blocks held by the arena.
+		@return the number of bytes held.
+		*/
+		size_t GetReservedSize() const;
+
+		/*!
+		Return the size of the block allocated from the heap.
+		@return the size of the block.
+		*/
+		size_t GetBlockSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		Arena(const Arena & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		Arena &operator=(const Arena & b){EP_ASSERT(0);return *this;}
+
+		/// the function type which destroys the objects
+		typedef void (*DestroyFunc)(void *obj, size_t count);
+
+		/*!
+		Destroy the given number of objects of given type.
+		@param[in] obj the first object to destroy.
+		@param[in] count the number of objects to destroy.
+		*/
+		template <typename ObjectType>
+		static void destroyObjects(void *obj, size_t count)
+		{
+			ObjectType *objArr=reinterpret_cast<ObjectType*>(obj);
+			for(size_t objTrav=count;objTrav>0;objTrav--)
+				(objArr+objTrav-1)->~ObjectType();
+		}
+
+		/*!
+		Register the given objects to be destroyed when the arena is reset.
+		@param[in] obj the first object to destroy.
+		@param[in] count the number of objects to destroy.
+		*/
+		template <typename ObjectType>
+		void registerDestructor(ObjectType *obj, size_t count)
+		{
+			if(!__has_trivial_destructor(ObjectType) && count)
+				registerDestructor(obj,count,&destroyObjects<ObjectType>);
+		}
+
+		/*!
+		Register the given objects to be destroyed by the given function when the arena is reset.
+		@param[in] obj the first object to destroy.
+		@param[in] count the number of objects to destroy.
+		@param[in] destroyFunc the function to destroy the objects.
+		*/
+		void registerDestructor(void *obj, size_t count, DestroyFunc destroyFunc);
+
+		/*!
+		Actual allocate the memory of given size from the arena.
+		@param[in] size the size of the memory in bytes.
+		@param[in] alignment the alignment of the memory.
+		@return the memory allocated.
+		*/
+		void *allocate(size_t size, size_t alignment);
+
+		/*!
+		Destroy all objects registered.
+		*/
+		void destroyAll();
+
+		/// Block Header
+		struct Block
+		{
+			/// the next block
+			Block *m_next;
+			/// the size of the data in bytes
+			size_t m_size;
+			/// the number of bytes used
+			size_t m_used;
+		};
+
+		/// Destructor Record
+		struct Destructor
+		{
+			/// the previously registered record
+			Destructor *m_next;
+			/// the function to destroy the objects
+			DestroyFunc m_destroyFunc;
+			/// the first object to destroy
+			void *m_obj;
+			/// the number of objects to destroy
+			size_t m_count;
+		};
+
+		/*!
+		Allocate the new block to hold the data of given size.
+		@param[in] dataSize the size of the data in bytes.
+		@return the new block.
+		*/
+		Block *allocateBlock(size_t dataSize);
+
+		/*!
+		Return the data of the given block.
+		@param[in] block the block to return the data.
+		@return the data of the block.
+		*/
+		static unsigned char *blockData(Block *block);
+
+		/// the block currently allocating from
+		Block *m_currentBlock;
+		/// the blocks filled or the large blocks
+		Block *m_usedBlocks;
+		/// the blocks kept for reuse
+		Block *m_freeBlocks;
+		/// the destructors registered
+		Destructor *m_destructors;
+		/// the size of the block
+		size_t m_blockSize;
+		/// the number of bytes allocated since the last reset
+		size_t m_usedSize;
+		/// the number of bytes of the blocks held
+		size_t m_reservedSize;
+		/// arena lock
+		BaseLock *m_arenaLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class ArenaStlAllocator epArena.h
+	@brief A template class for STL allocator which allocates from the Arena.
+
+	The deallocation is ignored, and the memory is released with the arena.
+	*/
+	template <typename DataType>
+	class ArenaStlAllocator
+	{
+	public:
+		typedef DataType value_type;
+		typedef DataType *pointer;
+		typedef const DataType *const_pointer;
+		typedef DataType &reference;
+		typedef const DataType &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		/// The allocator for the other type
+		template <typename OtherType>
+		struct rebind
+		{
+			typedef ArenaStlAllocator<OtherType> other;
+		};
+
+		/*!
+		Default Constructor
+
+		Initializes the allocator
+		@param[in] arena the arena to allocate from.
+		*/
+		ArenaStlAllocator(Arena &arena):m_arena(&arena)
+		{
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the allocator
+		@param[in] b the allocator to copy from.
+		*/
+		template <typename OtherType>
+		ArenaStlAllocator(const ArenaStlAllocator<OtherType> &b):m_arena(b.GetArena())
+		{
+		}
+
+		/*!
+		Return the arena to allocate from.
+		@return the arena.
+		*/
+		Arena *GetArena() const
+		{
+			return m_arena;
+		}
+
+		pointer address(reference data) const
+		{
+			return &data;
+		}
+
+		const_pointer address(const_reference data) const
+		{
+			return &data;
+		}
+
+		pointer allocate(size_type count, const void *hint=0)
+		{
+			return reinterpret_cast<pointer>(m_arena->Allocate(sizeof(DataType)*count,__alignof(DataType)));
+		}
+
+		void deallocate(pointer ptr, size_type count)
+		{
+		}
+
+		size_type max_size() const
+		{
+			return static_cast<size_type>(-1)/sizeof(DataType);
+		}
+
+		void construct(pointer ptr, const DataType &data)
+		{
+			::new(ptr) DataType(data);
+		}
+
+		void destroy(pointer ptr)
+		{
+			ptr->~DataType();
+		}
+
+		template <typename OtherType>
+		bool operator==(const ArenaStlAllocator<OtherType> &b) const
+		{
+			return m_arena==b.GetArena();
+		}
+
+		template <typename OtherType>
+		bool operator!=(const ArenaStlAllocator<OtherType> &b) const
+		{
+			return m_arena!=b.GetArena();
+		}
+
+	private:
+		/// the arena to allocate from
+		Arena *m_arena;
+	};
+}
+
+#endif //__EP_ARENA_H__
\ No newline at end of file
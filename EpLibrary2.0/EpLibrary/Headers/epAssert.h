@@ -43,48 +43,59 @@ An Interface for Assert.
 #include <assert.h>
 #include "epMemory.h"
 
+namespace epl
+{
+	/*! 
+	@class Assert epAssert.h
+	@brief A class for reporting the failed assertion and the fatal error out of the line of the caller.
+
+	The formatting of the message is done here instead of every call site of EP_ASSERT_EXPR,
+	so the code checked stays compact, and only the compare and the branch are left in the line.
+	*/
+	class EP_LIBRARY Assert
+	{
+	public:
+		/*!
+		Report the failed assertion with the formatted message.
+		@param[in] expression the expression failed
+		@param[in] fileName the name of the source file of the assertion
+		@param[in] lineNumber the line number of the assertion
+		@param[in] formatString the format string for the message
+		*/
+		static EP_NOINLINE void Fail(const wchar_t *expression, const wchar_t *fileName, unsigned int lineNumber, const wchar_t *formatString, ...);
+
+		/*!
+		Report the failed assertion with the formatted message.
+		@param[in] expression the expression failed
+		@param[in] fileName the name of the source file of the assertion
+		@param[in] lineNumber the line number of the assertion
+		@param[in] formatString the format string for the message
+		*/
+		static EP_NOINLINE void Fail(const wchar_t *expression, const wchar_t *fileName, unsigned int lineNumber, const char *formatString, ...);
+
+		/*!
+		Report the fatal error, and abort the process.
+		@param[in] message the message of the error
+		@remark used instead of throwing the exception when EP_NO_EXCEPTIONS is defined.
+		*/
+		static EP_NOINLINE void Fatal(const char *message);
+	};
+}
+
 /*!
 @def EP_ASSERT_EXPR
 @brief Macro Function for assert with message
 @param[in] _Expression the boolean expression to evaluate the assert
 @param[in] formatString the format string for the message
+@remark compiled out of the release build entirely, so the expression is not evaluated.
 */
 #if defined(_DEBUG)
-#if defined(_UNICODE) || defined(UNICODE)
-#define EP_ASSERT_EXPR(_Expression,formatString, ...)\
-	do{\
-	if(!!!(_Expression)){\
-	int len=_scwprintf(formatString,__VA_ARGS__)+1;\
-	wchar_t * expression=EP_NEW wchar_t[len];\
-	swprintf_s(expression,len,formatString,__VA_ARGS__);\
-	\
-	int len2=_scwprintf(WIDEN("%s\r\n\r\nMessage: %s"),WIDEN(#_Expression),expression )+1;\
-	wchar_t * expression2=EP_NEW wchar_t[len2];\
-	swprintf_s(expression2,len2,WIDEN("%s\r\n\r\nMessage: %s"),WIDEN(#_Expression),expression);\
-	\
-	(void)( (_wassert(expression2,__WFILE__, __LINE__), 0) );\
-	EP_DELETE[] expression;\
-	EP_DELETE[] expression2;\
-	}\
-	}while(0)
-#else // defined(_UNICODE) || defined(UNICODE)
 #define EP_ASSERT_EXPR(_Expression,formatString, ...)\
 	do{\
-	if(!!!(_Expression)){\
-	int len=_scprintf(formatString,__VA_ARGS__)+1;\
-	char * expression=EP_NEW char[len];\
-	sprintf_s(expression,len,formatString,__VA_ARGS__);\
-	\
-	int len2=_scprintf("%s\r\n\r\nMessage: %s",#_Expression,expression )+1;\
-	wchar_t * expression2=EP_NEW wchar_t[len2];\
-	swprintf_s(expression2,len2,WIDEN("%s\r\n\r\nMessage: %s"),WIDEN(#_Expression),expression);\
-	\
-	(void)( (_wassert(expression2,__WFILE__, __LINE__), 0) );\
-	EP_DELETE[] expression;\
-	EP_DELETE[] expression2;\
+	if(EP_UNLIKELY(!!!(_Expression))){\
+	epl::Assert::Fail(WIDEN(#_Expression),__WFILE__,__LINE__,formatString,__VA_ARGS__);\
 	}\
 	}while(0)
-#endif // defined(_UNICODE) || defined(UNICODE)
 #else //defined(_DEBUG)
 #define EP_ASSERT_EXPR(_Expression,formatString, ...) ((void)0)
 #endif //defined(_DEBUG)
@@ -40,6 +40,7 @@ An Interface for Base Job.
 #include "epLib.h"
 #include "epThreadSafePQueue.h"
 #include "epSmartObject.h"
+#include "epCancellationToken.h"
 
 namespace epl
 {
@@ -49,6 +50,11 @@ namespace epl
 	/// Normal Priority is 0
 	#define PRIORITY_NORMAL 0
 
+	class JobHandle;
+	class JobGraph;
+	class BaseJobProcessor;
+	class BaseJobPool;
+
 	/*! 
 	@class BaseJob epBaseJob.h
 	@brief A base class for Job Objects.
@@ -61,6 +67,12 @@ namespace epl
 		friend class WorkerThreadSingle;
 		friend class ThreadSafePQueue<BaseJob*,BaseJob>;
 		friend class JobScheduleQueue;
+		friend class ThreadPool;
+		friend class ThreadPoolWorker;
+		friend class JobGraph;
+		friend class ElasticWorkerPool;
+		friend class ElasticWorker;
+		friend class BaseJobPool;
 
 		/// Enumeration for Job Status
 		enum JobStatus{
@@ -80,6 +92,8 @@ namespace epl
 			JOB_STATUS_TIMEOUT,
 			/// Job Processor and Job is in Pending State
 			JOB_STATUS_PENDING,
+			/// Job is cancelled before processed
+			JOB_STATUS_CANCELLED,
 		};
 
 		/*!
@@ -99,6 +113,11 @@ namespace epl
 				SmartObject::operator =(b);
 				m_status=b.m_status;
 				m_priority=m_priority;
+				SetCancellationToken(b.m_cancellationToken);
+				m_isCancelled=b.m_isCancelled;
+				m_deadlineStartTick=b.m_deadlineStartTick;
+				m_deadlineTime=b.m_deadlineTime;
+				SetJobProcessor(b.m_jobProcessor);
 				
 			}
 			return *this;
@@ -122,6 +141,63 @@ namespace epl
 		*/
 		void SetPriority(Priority newPrio);
 
+		/*!
+		Return the completion handle of this job.
+		@return the completion handle of this job.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		@remark the handle is bound to one submission, and a new handle is created when the job is queued again after completion.
+		*/
+		JobHandle *GetHandle();
+
+		/*!
+		Set the job processor for this job only.
+		@param[in] jobProcessor the job processor to process this job instead of the worker's. (NULL to use the worker's)
+		*/
+		void SetJobProcessor(BaseJobProcessor *jobProcessor);
+
+		/*!
+		Return the job processor for this job only.
+		@return the job processor of this job, or NULL if the worker's is used.
+		*/
+		BaseJobProcessor *GetJobProcessor() const;
+
+		/*!
+		Cancel this job.
+		@remark if the job is still in the queue, it is dropped at dequeue and reported as JOB_STATUS_CANCELLED.
+		@remark if the job is already in process, DoJob can check IsCancelled to stop early.
+		*/
+		void Cancel();
+
+		/*!
+		Check if this job or its cancellation token is cancelled.
+		@return true if cancelled, otherwise false.
+		*/
+		bool IsCancelled() const;
+
+		/*!
+		Set the cancellation token shared with other jobs.
+		@param[in] token the cancellation token. (NULL to remove)
+		*/
+		void SetCancellationToken(CancellationToken *token);
+
+		/*!
+		Return the cancellation token of this job.
+		@return the cancellation token, or NULL if not set.
+		*/
+		CancellationToken *GetCancellationToken() const;
+
+		/*!
+		Set the deadline of this job from now.
+		@param[in] timeoutInMilliSec the time until the deadline in milliseconds. (WAITTIME_INIFINITE to remove)
+		@remark if the job is dequeued after the deadline, it is dropped and reported as JOB_STATUS_TIMEOUT.
+		*/
+		void SetDeadline(unsigned int timeoutInMilliSec);
+
+		/*!
+		Check if the deadline of this job has passed.
+		@return true if the deadline has passed, otherwise false.
+		*/
+		bool IsExpired() const;
 		
 	protected:
 		/*!
@@ -142,6 +218,19 @@ namespace epl
 		{
 			m_status=b.m_status;
 			m_priority=m_priority;
+			m_handle=NULL;
+			m_graph=NULL;
+			m_graphNodeIdx=0;
+			m_cancellationToken=b.m_cancellationToken;
+			if(m_cancellationToken)
+				m_cancellationToken->RetainObj();
+			m_isCancelled=b.m_isCancelled;
+			m_deadlineStartTick=b.m_deadlineStartTick;
+			m_deadlineTime=b.m_deadlineTime;
+			m_enqueueTime=0;
+			m_jobProcessor=NULL;
+			SetJobProcessor(b.m_jobProcessor);
+			m_pool=NULL;
 		}
 
 		/*!
@@ -151,6 +240,18 @@ namespace epl
 		*/
 		virtual void handleReport(const JobStatus status);
 
+		/*!
+		Handles when the Job is returned to its JobPool for reuse
+		Subclass should overwrite this function to reset its own state!!
+		*/
+		virtual void handleRecycle();
+
+		/*!
+		Reset this Job and return it to its JobPool instead of deleting it.
+		@return true if the Job is kept by the pool, otherwise false.
+		*/
+		virtual bool recycleObj();
+
 	private:
 		/*!
 		Call Back Function When Job's Status Changed.
@@ -166,13 +267,59 @@ namespace epl
 		*/
 		static CompResultType CompFunc(const void *a,const void *b);
 
+		/*!
+		Check if the given status is the final status of the job.
+		@param[in] status The Status of the Job
+		@return true if the given status is the final status, otherwise false.
+		*/
+		static bool isFinalStatus(const JobStatus status);
+
+		/*!
+		Report and return true if this job is cancelled or expired, so that the worker drops it.
+		@return true if the job should be dropped without DoJob, otherwise false.
+		*/
+		bool dropIfStale();
+
 
 		/// current Job Status
 		JobStatus m_status;
 
+		/// the padding between the status written by the worker and the members read by the queue and the submitter
+		EP_CACHE_LINE_PADDING(m_statusPadding)
+
 		/// priority of the Job
 		Priority m_priority;
 
+		/// completion handle of the Job
+		JobHandle * volatile m_handle;
+
+		/// the graph which owns this Job
+		JobGraph *m_graph;
+
+		/// the node index of this Job in the graph
+		unsigned int m_graphNodeIdx;
+
+		/// cancellation token of the Job
+		CancellationToken *m_cancellationToken;
+
+		/// cancelled flag of the Job
+		volatile long m_isCancelled;
+
+		/// time of Clock in milliseconds when the deadline was set
+		__int64 m_deadlineStartTick;
+
+		/// time until the deadline in milliseconds
+		unsigned int m_deadlineTime;
+
+		/// the time when the Job was queued in microseconds
+		__int64 m_enqueueTime;
+
+		/// the job processor for this Job only
+		BaseJobProcessor *m_jobProcessor;
+
+		/// the pool which recycles this Job
+		BaseJobPool *m_pool;
+
 
 	};
 }
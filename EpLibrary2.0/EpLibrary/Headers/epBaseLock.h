@@ -42,6 +42,8 @@ An Interface for Virtual Lock Class.
 
 namespace epl
 {
+	struct LockProfileStat;
+
 	/*! 
 	@class BaseLock epBaseLock.h
 	@brief A class that handles the virtual base lock.
@@ -63,6 +65,23 @@ namespace epl
 		*/
 		virtual ~BaseLock();
 
+		/*!
+		Default Copy Constructor
+
+		Initializes the lock without the profiling
+		@param[in] b the second object
+		*/
+		BaseLock(const BaseLock& b);
+
+		/*!
+		Assignment operator overloading
+
+		Keeps the profiling of this lock as it is.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BaseLock & operator=(const BaseLock&b);
+
 		/*!
 		Locks the Critical Section
 		@return true if locked, false otherwise
@@ -94,6 +113,60 @@ namespace epl
 		*/
 		virtual void Unlock()=0;
 
+		/*!
+		Locks the Critical Section for reading
+
+		The readers may share the lock if the lock supports it, otherwise same as Lock.
+		@return true if locked, false otherwise
+		@remark the shared holder must not call Lock before UnlockShared.
+		*/
+		virtual bool LockShared();
+
+		/*!
+		Try to Lock the Critical Section for reading
+
+		If other thread is writing in the Critical Section, it just returns false and continue, otherwise obtain the Critical Section for reading.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockShared();
+
+		/*!
+		Leave the Critical Section for reading
+
+		The LockShared and UnlockShared has to be matched for each Critical Section.
+		*/
+		virtual void UnlockShared();
+
+		/*!
+		Enable the contention profiling of this lock with given name.
+
+		The acquisitions, contended acquisitions, total wait time and maximum hold time are reported by LOCK_PROFILE_INSTANCE.
+		@param[in] name the name of this lock in the report.
+		@remark call before the lock is shared by the threads.
+		@remark only the exclusive locks taken by LockObj or ProfiledLock are recorded.
+		*/
+		void SetProfileName(const TCHAR *name);
+
+		/*!
+		Return the flag whether this lock is profiled.
+		@return true if this lock is profiled, otherwise false.
+		*/
+		bool IsProfiled() const
+		{
+			return m_profileStat!=NULL;
+		}
+
+		/*!
+		Locks the Critical Section, recording the contention if this lock is profiled.
+		@return true if locked, false otherwise
+		*/
+		bool ProfiledLock();
+
+		/*!
+		Leave the Critical Section, recording the hold time if this lock is profiled.
+		*/
+		void ProfiledUnlock();
+
 
 		/*! 
 		@class BaseLockObj epBaseLock.h
@@ -145,10 +218,69 @@ namespace epl
 			BaseLock *m_lock;
 		};
 
+		/*! 
+		@class BaseSharedLockObj epBaseLock.h
+		@brief A class that handles the shared lock for reading.
+		*/
+		class EP_LIBRARY BaseSharedLockObj
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Locks for reading where this object instantiated.
+			@param[in] lock the pointer to the lock to lock.
+			*/
+			BaseSharedLockObj(BaseLock *lock);
+
+			/*!
+			Default Destructor
+
+			Unlock for reading when this object destroyed.
+			*/
+			virtual ~BaseSharedLockObj();
+
+		private:
+
+			/*!
+			Default Constructor
+
+			*Cannot be Used.
+			*/
+			BaseSharedLockObj();
+
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			BaseSharedLockObj(const BaseSharedLockObj & b){EP_ASSERT(0);m_lock=NULL;}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			BaseSharedLockObj &operator=(const BaseSharedLockObj & b){EP_ASSERT(0);return *this;}
+
+			/// The pointer to the lock used.
+			BaseLock *m_lock;
+		};
+
+	private:
+		friend class LockProfileManager;
+
+		/// the contention statistics, or NULL if not profiled
+		LockProfileStat *m_profileStat;
 	};
 
 	/// type definition  for lock object
 	typedef BaseLock::BaseLockObj LockObj;
+
+	/// type definition  for shared lock object
+	typedef BaseLock::BaseSharedLockObj SharedLockObj;
 }
 
 #endif //__EP_BASE_LOCK_H__
\ No newline at end of file
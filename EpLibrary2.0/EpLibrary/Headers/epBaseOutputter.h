@@ -43,9 +43,17 @@ An Interface for Outputting data Template class.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include "epEventEx.h"
+
+/// the default interval in milliseconds the background thread flushes the outputter
+#define OUTPUTTER_DEFAULT_FLUSH_INTERVAL 1000
 
 namespace epl
 {
+	class OutputterFlushThread;
+
 	/*! 
 	@class BaseOutputter epBaseOutputter.h
 	@brief A Base Class for output the data.
@@ -53,11 +61,35 @@ namespace epl
 	class EP_LIBRARY BaseOutputter
 	{
 	public:
+		friend class OutputterFlushThread;
 
 		/*!
 		Write the all data to the file.
+		@remark the incremental outputter detaches the nodes added since the last flush in O(1), 
+		        and writes and deletes them without holding the node list lock.
 		*/
 		virtual void FlushToFile();
+
+		/*!
+		Start the background thread which calls FlushToFile periodically.
+		@param[in] flushInterval the interval in milliseconds.
+		@remark the thread already started only takes the new interval.
+		@remark the derived class must call StopFlushThread in its destructor, since the thread calls its FlushToFile.
+		*/
+		void StartFlushThread(unsigned int flushInterval=OUTPUTTER_DEFAULT_FLUSH_INTERVAL);
+
+		/*!
+		Stop the background thread which calls FlushToFile, and wait until it ends.
+		@remark the data added after the last flush are not written, until FlushToFile is called.
+		*/
+		void StopFlushThread();
+
+		/*!
+		Return the flag whether the background thread is flushing this outputter.
+		@return true if the background thread is running, otherwise false.
+		*/
+		bool IsFlushThreadStarted() const;
+
 		/*!
 		Set the output file name.
 		@param[in] fileName the file name for the output.
@@ -74,6 +106,13 @@ namespace epl
 		*/
 		virtual void Clear();
 
+		/*!
+		Enable the contention profiling of the node list lock.
+		@param[in] name the name of the lock in the report.
+		@remark the statistics are reported by LOCK_PROFILE_INSTANCE.
+		*/
+		void SetLockProfileName(const TCHAR *name);
+
 		/*!
 		Assignment operator overloading
 		@param[in] b the second object
@@ -147,10 +186,22 @@ namespace epl
 		*/
 		virtual ~BaseOutputter();
 
+		/*!
+		Set whether FlushToFile writes only the nodes added since the last flush, and deletes them.
+		@param[in] isIncremental true to flush incrementally, false to write the whole list every time.
+		@remark only the outputter whose nodes are not changed after added may flush incrementally, 
+		        and Print shows only the nodes not flushed yet.
+		*/
+		void setIncrementalFlush(bool isIncremental);
+
 		/// Log List
 		std::vector<OutputNode*> m_list;
 		/// Lock
 		BaseLock* m_nodeListLock;
+		/// the lock keeping the flushes in order, while the node list lock is released
+		BaseLock* m_flushLock;
+		/// the flag whether FlushToFile writes only the nodes added since the last flush
+		bool m_isIncrementalFlush;
 		/// Lock Policy
 		LockPolicy m_lockPolicy;
 		/// File Name
@@ -160,8 +211,16 @@ namespace epl
 		/*!
 		Write the data to given file.
 		@param[in] file the file which data will be written.
+		@param[in] nodeList the nodes to write.
 		*/
-		void writeToFile(EpFile* const file);
+		static void writeToFile(EpFile* const file, const std::vector<OutputNode*> &nodeList);
+
+		/// the background thread flushing this outputter, or NULL if not started
+		OutputterFlushThread *m_flushThread;
+		/// the event waking the background thread
+		EventEx m_flushEvent;
+		/// the interval the background thread flushes in milliseconds
+		volatile unsigned int m_flushInterval;
 	};
 }
 #endif //__EP_OUTPUTTER_H__
\ No newline at end of file
@@ -41,9 +41,14 @@ An Interface for the Base Text File Class.
 #include "epSystem.h"
 #include "epMemory.h"
 #include <list>
+#include <vector>
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include "epFileIoJob.h"
+#include "epTextLineReader.h"
 
 using namespace std;
 
@@ -116,9 +121,41 @@ namespace epl{
 		Load the list of the properties from the given file
 		@param[in] filename the name of the file to load the list of properties
 		@return true if successfully loaded, otherwise false
+		@remark the file is read line by line with TextLineReader, so the file is never held whole in the memory 
+		        unless the sub class keeps the whole text.
 		*/
 		bool LoadFromFile(const TCHAR *filename);
 
+		/*!
+		Save the list of the properties to the given file on the I/O pool
+		@param[in] filename the name of the file to save the list of properties
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result. (NULL to report to the handle only)
+		@return the completion handle, which the caller must call ReleaseObj
+		@remark this object must not be destroyed or modified until the handle becomes ready.
+		*/
+		JobHandle *SaveToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj=NULL);
+
+		/*!
+		Append the list of the properties to the given file on the I/O pool
+		@param[in] filename the name of the file to append the list of properties
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result. (NULL to report to the handle only)
+		@return the completion handle, which the caller must call ReleaseObj
+		@remark this object must not be destroyed or modified until the handle becomes ready.
+		*/
+		JobHandle *AppendToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj=NULL);
+
+		/*!
+		Load the list of the properties from the given file on the I/O pool
+		@param[in] filename the name of the file to load the list of properties
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result. (NULL to report to the handle only)
+		@return the completion handle, which the caller must call ReleaseObj
+		@remark this object must not be destroyed or accessed until the handle becomes ready.
+		*/
+		JobHandle *LoadFromFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj=NULL);
+
 		/*!
 		Get a single line from the given buffer
 		@param[in] buf the buffer that holds all lines
@@ -132,12 +169,36 @@ namespace epl{
 
 	protected:
 
+		/*!
+		Submit the file I/O of this object to the I/O pool
+		@param[in] ioType the type of the file I/O
+		@param[in] filename the name of the file
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result
+		@return the completion handle, which the caller must call ReleaseObj
+		*/
+		JobHandle *submitIo(FileIoType ioType, const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj);
+
 		/*!
 		Write the given string to the file
 		@param[in] toFileString the string to write to the file
 		*/
 		void writeToFile(const TCHAR *toFileString);
 
+		/*!
+		Write the given characters to the file
+		@param[in] toFileString the characters to write to the file
+		@param[in] strLength the number of the characters
+		*/
+		void writeToFile(const TCHAR *toFileString, size_t strLength);
+
+		/*!
+		Transcode the given UTF-16 string to the UTF-8, and write it to the file
+		@param[in] wideString the string to write to the file
+		@param[in] charCount the number of the characters of the string
+		*/
+		void writeUtf8ToFile(const wchar_t *wideString, size_t charCount);
+
 		/*!
 		Loop Function that writes to the file.
 		@remark Sub classes should implement this function
@@ -151,6 +212,14 @@ namespace epl{
 		*/
 		virtual void loadFromFile(const EpTString &lines)=0;
 
+		/*!
+		Load Function that loads values from the file line by line.
+		@remark The default joins the lines and calls loadFromFile, 
+		        and the sub class parsing each line may override this to load without the whole text.
+		@param[in] reader the reader of the file opened
+		*/
+		virtual void loadFromReader(TextLineReader &reader);
+
 		/// Encoding type of the file
 		FileEncodingType m_encodingType;
 		/// File Pointer
@@ -159,6 +228,8 @@ namespace epl{
 		BaseLock * m_baseTextLock;
 		/// Lock Policy
 		LockPolicy m_lockPolicy;
+		/// the UTF-8 bytes to write, which is reused over the strings written
+		std::vector<char> m_utf8Buffer;
 	};
 
 }
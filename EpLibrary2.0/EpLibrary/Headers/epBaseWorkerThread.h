@@ -42,6 +42,7 @@ A Interface for Base Worker Thread Class.
 #include "epThread.h"
 #include "epBaseJob.h"
 #include "epWorkerThreadDelegate.h"
+#include "epWorkerMetrics.h"
 
 namespace epl
 {
@@ -93,8 +94,33 @@ namespace epl
 		/*!
 		Push in the new work to the work pool.
 		@param[in] work the new work to put into the work pool.
+		@remark the work rejected by the bounded work pool is reported as JOB_STATUS_INCOMPLETE.
 		*/
-		void Push(BaseJob * const  work);
+		virtual void Push(BaseJob * const  work);
+
+		/*!
+		Push in the given works to the work pool with a single lock acquisition.
+		@param[in] works the array of new works to put into the work pool.
+		@param[in] count the number of works in the array.
+		*/
+		virtual void PushBatch(BaseJob * const *works, size_t count);
+
+		/*!
+		Push in the new work to the work pool, handing over the reference held by the given pointer.
+		@param[in] work the new work to put into the work pool, which becomes NULL.
+		@remark the reference is moved into the work pool without touching the reference count,
+		        so create the work with SmartPtr::Attach to push it without any retain and release.
+		@remark the work rejected by the bounded work pool is reported as JOB_STATUS_INCOMPLETE, and released.
+		*/
+		void PushOwned(SmartPtr<BaseJob> &work);
+
+		/*!
+		Push in the new work to the work pool, and return its completion handle.
+		@param[in] work the new work to put into the work pool.
+		@return the completion handle of the work.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		*/
+		JobHandle *Submit(BaseJob * const  work);
 
 		/*!
 		Pop a work from the work pool.
@@ -123,6 +149,74 @@ namespace epl
 			return m_lifePolicy;
 		}
 
+		/*!
+		Set the maximum number of jobs to take from the work pool per lock acquisition.
+		@param[in] batchSize the maximum number of jobs to dequeue at once. (0 is treated as 1)
+		*/
+		void SetDequeueBatchSize(unsigned int batchSize);
+
+		/*!
+		Return the maximum number of jobs to take from the work pool per lock acquisition.
+		@return the maximum number of jobs to dequeue at once.
+		*/
+		unsigned int GetDequeueBatchSize() const;
+
+		/*!
+		Set the maximum wait time before the queued job is taken regardless of its priority.
+		@param[in] maxWaitInMilliSec the maximum wait time in milliseconds. (WAITTIME_INIFINITE for strict priority)
+		*/
+		void SetMaxWaitTime(unsigned int maxWaitInMilliSec);
+
+		/*!
+		Return the maximum wait time before the queued job is taken regardless of its priority.
+		@return the maximum wait time in milliseconds, or WAITTIME_INIFINITE for strict priority.
+		*/
+		unsigned int GetMaxWaitTime() const;
+
+		/*!
+		Set the capacity of the work pool and the policy when the work pool is full.
+		@param[in] capacity the maximum number of works in the work pool. (0 for unbounded)
+		@param[in] policy the overflow policy when the work pool is full.
+		@remark with OVERFLOW_POLICY_BLOCK, the job running on this worker must not push to this worker.
+		*/
+		void SetQueueCapacity(size_t capacity, OverflowPolicy policy=OVERFLOW_POLICY_BLOCK);
+
+		/*!
+		Return the capacity of the work pool.
+		@return the maximum number of works in the work pool, or 0 if unbounded.
+		*/
+		size_t GetQueueCapacity() const;
+
+		/*!
+		Return the policy when the work pool is full.
+		@return the overflow policy.
+		*/
+		OverflowPolicy GetQueueOverflowPolicy() const;
+
+		/*!
+		Return the highest number of works the work pool held since the last reset.
+		@return the high-water mark.
+		*/
+		size_t GetQueueHighWaterMark() const;
+
+		/*!
+		Reset the high-water mark of the work pool to 0.
+		*/
+		void ResetQueueHighWaterMark();
+
+		/*!
+		Return the number of works dropped or rejected by the overflow policy.
+		@return the number of works dropped or rejected.
+		*/
+		size_t GetQueueDropCount() const;
+
+		/*!
+		Copy the metrics of this worker thread to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		@remark can be called while the worker thread is running.
+		*/
+		void GetMetrics(WorkerMetricsSnapshot &retSnapshot) const;
+
 		/*!
 		Set call back class to call when work is done.
 		@param[in] callBackClass the call back class.
@@ -169,11 +263,38 @@ namespace epl
 		*/
 		virtual void execute()=0;
 
+		/*!
+		Wake up the thread for the work pushed.
+		@remark the subclass waiting on its own signal overrides this, and calls BaseWorkerThread::signalWork.
+		*/
+		virtual void signalWork();
+
 		/*!
 		Call the Call Back Class if callback class is assigned.
 		*/
 		void callCallBack();
 
+		/*!
+		Take up to GetDequeueBatchSize() jobs from the work pool with a single lock acquisition.
+		@param[in,out] jobBatch the buffer to receive the jobs, grown if smaller than the batch size.
+		@return the number of jobs taken.
+		@remark the caller owns the reference of each returned job and must call ReleaseObj.
+		*/
+		size_t popJobBatch(std::vector<BaseJob*> &jobBatch);
+
+		/*!
+		Process the given job dequeued from the work pool, and record it to the metrics.
+		@param[in] job the job to process.
+		@remark the job is dropped without DoJob if cancelled or expired, and released in any case.
+		*/
+		void processJob(BaseJob *job);
+
+		/*!
+		Record the time spent waiting for the job since the given time.
+		@param[in] idleStartTime the time when the wait began, from WorkerMetrics::GetCurrentMicroSec.
+		*/
+		void recordIdle(__int64 idleStartTime);
+
 		/// the work list
 		JobScheduleQueue m_workPool;
 		/// the life policy of the thread
@@ -187,6 +308,10 @@ namespace epl
 		LockPolicy m_lockPolicy;
 		/// Job Processor
 		BaseJobProcessor* m_jobProcessor;
+		/// the maximum number of jobs to dequeue at once
+		volatile unsigned int m_dequeueBatchSize;
+		/// the metrics of this worker thread
+		WorkerMetrics m_metrics;
 
 	};
 }
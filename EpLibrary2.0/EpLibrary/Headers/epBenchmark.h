@@ -0,0 +1,364 @@
+/*! 
+@file epBenchmark.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Benchmark Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+This is a class for measuring and reporting the throughput of the benchmark cases.
+
+*/
+#ifndef __EP_BENCHMARK_H__
+#define __EP_BENCHMARK_H__
+#include "epLib.h"
+#include "epBaseOutputter.h"
+#include "epSingletonHolder.h"
+#include "epEventEx.h"
+#include <vector>
+
+/*!
+@def BENCHMARK_INSTANCE
+@brief A Simple Macro to get the Benchmark Manager Instance
+
+Macro that returns the reference of Benchmark Manager Instance.
+*/
+#define BENCHMARK_INSTANCE epl::SingletonHolder<epl::BenchmarkManager>::Instance()
+
+/// the default time in milliseconds each measurement runs at least
+#define BENCHMARK_MIN_TIME 100
+
+/// the number of the measurements of which the fastest is reported
+#define BENCHMARK_REPEAT_COUNT 5
+
+namespace epl
+{
+	/*! 
+	@class BenchmarkCase epBenchmark.h
+	@brief A virtual class for the case measured by BenchmarkManager.
+	*/
+	class EP_LIBRARY BenchmarkCase
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~BenchmarkCase(){}
+
+		/*!
+		Prepare the measurement, which is not timed.
+		@param[in] iterationCount the number of the operations the next Run performs.
+		*/
+		virtual void SetUp(unsigned int iterationCount){}
+
+		/*!
+		Perform the operations, which is timed.
+		@param[in] iterationCount the number of the operations to perform.
+		*/
+		virtual void Run(unsigned int iterationCount)=0;
+
+		/*!
+		Clean up after the measurement, which is not timed.
+		*/
+		virtual void TearDown(){}
+
+		/*!
+		Return the number of the threads performing the operations.
+		@return the number of the threads.
+		*/
+		virtual unsigned int GetThreadCount() const{return 1;}
+	};
+
+	class BenchmarkWorker;
+
+	/*! 
+	@class BenchmarkParallelCase epBenchmark.h
+	@brief A virtual class for the case whose operations are divided among the threads.
+
+	The threads are started by SetUp and wait until Run releases them all at once,
+	so the creation of the threads is not timed, and Run returns when all threads finished.
+	The time reported for each operation is the elapsed time divided by the operations of all threads,
+	so the operations per second is the throughput of all threads together.
+	*/
+	class EP_LIBRARY BenchmarkParallelCase:public BenchmarkCase
+	{
+	public:
+		friend class BenchmarkWorker;
+		/*!
+		Default Constructor
+
+		Initializes the case
+		@param[in] threadCount the number of the threads performing the operations.
+		*/
+		BenchmarkParallelCase(unsigned int threadCount);
+
+		/*!
+		Default Destructor
+
+		Stop the threads left
+		*/
+		virtual ~BenchmarkParallelCase();
+
+		/*!
+		Start the threads waiting for Run.
+		@param[in] iterationCount the number of the operations of all threads.
+		@remark the derived class overriding this must call this as well.
+		*/
+		virtual void SetUp(unsigned int iterationCount);
+
+		/*!
+		Release the threads, and wait for all of them to finish.
+		@param[in] iterationCount the number of the operations of all threads.
+		*/
+		virtual void Run(unsigned int iterationCount);
+
+		/*!
+		Destroy the threads.
+		@remark the derived class overriding this must call this as well.
+		*/
+		virtual void TearDown();
+
+		/*!
+		Return the number of the threads performing the operations.
+		@return the number of the threads.
+		*/
+		virtual unsigned int GetThreadCount() const;
+
+		/*!
+		Perform the operations of one thread, which is timed.
+		@param[in] threadIdx the index of the thread from 0.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		virtual void RunThread(unsigned int threadIdx, unsigned int iterationCount)=0;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		BenchmarkParallelCase(const BenchmarkParallelCase& b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BenchmarkParallelCase & operator=(const BenchmarkParallelCase&b){EP_ASSERT(0);return *this;}
+
+		/// the number of the threads
+		unsigned int m_threadCount;
+		/// the threads started by SetUp
+		std::vector<BenchmarkWorker*> m_workerList;
+		/// the event releasing the threads
+		EventEx m_startEvent;
+	};
+
+	/*! 
+	@struct BenchmarkResult epBenchmark.h
+	@brief The result of one benchmark case.
+	*/
+	struct EP_LIBRARY BenchmarkResult
+	{
+		/// the name of the suite
+		EpTString suiteName;
+		/// the name of the case
+		EpTString caseName;
+		/// the parameter of the case such as the lock policy or the byte size
+		EpTString parameter;
+		/// the number of the operations of the fastest measurement
+		unsigned int iterationCount;
+		/// the byte size each operation processes
+		size_t byteSize;
+		/// the time in nanoseconds each operation takes
+		double nanoSecPerOp;
+		/// the throughput in megabytes per second, or 0 if no byte size is given
+		double megaBytePerSec;
+		/// the number of the threads performing the operations
+		unsigned int threadCount;
+		/// the number of the operations per second, or 0 if not measured by the calibrated run
+		double opPerSec;
+
+		/*!
+		Default Constructor
+
+		Initializes the result to zero
+		*/
+		BenchmarkResult();
+	};
+
+	/*! 
+	@class BenchmarkManager epBenchmark.h
+	@brief A class that measures the benchmark cases and reports their results.
+
+	Each case is calibrated to run for the minimum time, and measured BENCHMARK_REPEAT_COUNT times,
+	and the fastest measurement is reported.
+	The results are printed and written to the file as the comma-separated values,
+	so they can be compared between the builds by the tools.
+	*/
+	class EP_LIBRARY BenchmarkManager:public BaseOutputter
+	{
+	public:
+		friend class SingletonHolder<BenchmarkManager>;
+
+		/*!
+		Measure the benchmark case, and add its result to the report.
+		@param[in] suiteName the name of the suite.
+		@param[in] caseName the name of the case.
+		@param[in] parameter the parameter of the case.
+		@param[in] benchCase the case to measure.
+		@param[in] byteSize the byte size each operation processes. (0 to report the time only)
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@return the result of the case.
+		*/
+		BenchmarkResult Run(const TCHAR *suiteName, const TCHAR *caseName, const TCHAR *parameter, BenchmarkCase &benchCase, size_t byteSize=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Add the result measured by the caller to the report.
+		@param[in] result the result to add.
+		@remark used for the values the calibrated run cannot measure, such as the latency percentiles.
+		*/
+		void AddResult(const BenchmarkResult &result);
+
+		/*!
+		Add the 50th, 90th and 99th percentiles and the maximum of the times measured by the caller to the report,
+		as the cases with the suffix P50, P90, P99 and Max.
+		@param[in] suiteName the name of the suite.
+		@param[in] caseName the name of the case the suffixes are appended to.
+		@param[in] parameter the parameter of the case.
+		@param[in] sampleList the times in the performance counter ticks, which are sorted in place.
+		@remark the percentile is the nearest rank, so it is always one of the times measured.
+		*/
+		void AddPercentiles(const TCHAR *suiteName, const TCHAR *caseName, const TCHAR *parameter, std::vector<__int64> &sampleList);
+
+		/*!
+		Return the number of the results reported.
+		@return the number of the results.
+		*/
+		size_t GetResultCount() const;
+
+		/*!
+		Return the result reported.
+		@param[in] resultIdx the index of the result.
+		@return the result.
+		*/
+		BenchmarkResult GetResult(size_t resultIdx) const;
+
+		/*!
+		Print the header and the results to command line.
+		*/
+		virtual void Print() const;
+
+		/*!
+		Write the header and the results to the file, replacing the file.
+		*/
+		virtual void FlushToFile();
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy
+		*/
+		BenchmarkManager(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		BenchmarkManager(const BenchmarkManager& b):BaseOutputter(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BenchmarkManager & operator=(const BenchmarkManager&b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~BenchmarkManager();
+
+		/*! 
+		@class BenchmarkNode epBenchmark.h
+		@brief A class to hold the result of one benchmark case.
+		*/
+		class EP_LIBRARY BenchmarkNode:public BaseOutputter::OutputNode
+		{
+		public:
+			friend class BenchmarkManager;
+
+			/*!
+			Default Constructor
+			@param[in] result the result of the case.
+			*/
+			BenchmarkNode(const BenchmarkResult &result);
+
+			/*!
+			Default Destructor
+			*/
+			virtual ~BenchmarkNode();
+
+			/*!
+			It prints the data in format,
+			*/
+			virtual void Print() const;
+
+			/*!
+			Write the data to file in format,
+			@param[in] file the file to output the data.
+			*/
+			virtual void Write(EpFile* const file);
+
+		private:
+			/*!
+			Format the result into given string.
+			@param[out] retString the formatted string.
+			*/
+			void format(EpTString &retString) const;
+
+			/// the result
+			BenchmarkResult m_result;
+		};
+
+		/*!
+		Measure the case once.
+		@param[in] benchCase the case to measure.
+		@param[in] iterationCount the number of the operations to perform.
+		@return the time taken in the performance counter ticks.
+		*/
+		static __int64 measure(BenchmarkCase &benchCase, unsigned int iterationCount);
+	};
+}
+#endif //__EP_BENCHMARK_H__
\ No newline at end of file
@@ -43,7 +43,10 @@ An Interface for the Binary File Class.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 #include "epStream.h"
+#include "epFileIoJob.h"
 
 
 namespace epl{
@@ -106,6 +109,36 @@ namespace epl{
 		*/
 		bool LoadFromFile(const TCHAR *filename);
 
+		/*!
+		Save the list of the properties to the given file on the I/O pool
+		@param[in] filename the name of the file to save the list of properties
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result. (NULL to report to the handle only)
+		@return the completion handle, which the caller must call ReleaseObj
+		@remark this object must not be destroyed or modified until the handle becomes ready.
+		*/
+		JobHandle *SaveToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj=NULL);
+
+		/*!
+		Append the list of the properties to the given file on the I/O pool
+		@param[in] filename the name of the file to append the list of properties
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result. (NULL to report to the handle only)
+		@return the completion handle, which the caller must call ReleaseObj
+		@remark this object must not be destroyed or modified until the handle becomes ready.
+		*/
+		JobHandle *AppendToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj=NULL);
+
+		/*!
+		Load the list of the properties from the given file on the I/O pool
+		@param[in] filename the name of the file to load the list of properties
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result. (NULL to report to the handle only)
+		@return the completion handle, which the caller must call ReleaseObj
+		@remark this object must not be destroyed or accessed until the handle becomes ready.
+		*/
+		JobHandle *LoadFromFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj=NULL);
+
 		/*!
 		Get the current stream
 		@return the current stream
@@ -127,6 +160,16 @@ namespace epl{
 
 	protected:
 
+		/*!
+		Submit the file I/O of this object to the I/O pool
+		@param[in] ioType the type of the file I/O
+		@param[in] filename the name of the file
+		@param[in] ioPool the thread pool to perform the file I/O
+		@param[in] callBackObj the callback object to report the result
+		@return the completion handle, which the caller must call ReleaseObj
+		*/
+		JobHandle *submitIo(FileIoType ioType, const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj);
+
 		/// File Stream
 		Stream m_stream;
 		/// File Pointer
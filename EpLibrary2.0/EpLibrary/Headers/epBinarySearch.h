@@ -41,6 +41,14 @@ An Interface for Binary Search Algorithm.
 #include "epLib.h"
 #include "epAlgorithm.h"
 #include "epSystem.h"
+#include <vector>
+#include <xmmintrin.h>
+
+/// the number of the searches interleaved by the batch search functions
+#define BSEARCH_BATCH_SIZE 8
+/// the stride of the prefetch in EytzingerSearch (prefetches the descendants four levels down)
+#define EYTZINGER_PREFETCH_STRIDE 16
+
 namespace epl
 {
 	/*!
@@ -52,12 +60,12 @@ namespace epl
 	@param[in] _pKey The key to search the list
 	@param[in] searchList The list to search.
 	@param[in] listSize The size of the list.
-	@param[in] CompareFunc The Compare Function pointer.
+	@param[in] CompareFunc The Compare Function pointer or functor.
 	@param[out] retIdx The found item's index in the list.
 	@return the pointer to the item found. If not found returns NULL.
 	*/
-	template <typename T,typename T2>
-	T2 * BinarySearch (T const &_pKey,T2* searchList,size_t listSize,CompResultType (__cdecl *CompareFunc)(const void * , const void *), size_t &retIdx)
+	template <typename T,typename T2,typename CompFuncType>
+	T2 * BinarySearch (T const &_pKey,T2* searchList,size_t listSize,CompFuncType CompareFunc, size_t &retIdx)
 	{
 		if (searchList == NULL || listSize<1)
 		{
@@ -101,5 +109,406 @@ namespace epl
 		return NULL;
 	}
 
+	/*!
+	Prefetch the cache line of the given item for the read.
+	@param[in] item the pointer to the item to prefetch.
+	@remark the prefetch is only a hint, so the item does not have to be within the list.
+	*/
+	template <typename T>
+	inline void searchPrefetch(const T *item)
+	{
+		_mm_prefetch(reinterpret_cast<const char*>(item),_MM_HINT_T0);
+	}
+
+	/*!
+	Template Branchless Lower Bound Function
+
+	Search the sorted list with operator< and the key, 
+	and return the index of the first item which is not less than the key.
+	@param[in] key The key to search the list
+	@param[in] searchList The sorted list to search.
+	@param[in] listSize The size of the list.
+	@return the index of the first item not less than the key. If none, returns listSize.
+	@remark the loop runs exactly log2(listSize) times with the conditional move instead of the branch,
+	        so it is faster than BinarySearch for the primitive keys.
+	*/
+	template <typename T>
+	size_t LowerBound(T const &key,const T *searchList,size_t listSize)
+	{
+		if(searchList==NULL || listSize<1)
+			return 0;
+		const T *base=searchList;
+		size_t remain=listSize;
+		while(remain>1)
+		{
+			size_t half=remain/2;
+			base=(base[half]<key)?base+half:base;
+			remain-=half;
+		}
+		return (base-searchList)+(*base<key);
+	}
+
+	/*!
+	Template Branchless Lower Bound Function
+
+	Search the sorted list with Compare Function Pointer and the key, 
+	and return the index of the first item which is not less than the key.
+	@param[in] key The key to search the list
+	@param[in] searchList The sorted list to search.
+	@param[in] listSize The size of the list.
+	@param[in] CompareFunc The Compare Function pointer or functor.
+	@return the index of the first item not less than the key. If none, returns listSize.
+	@remark the search is branchless only when CompareFunc is an inlined functor such as CompFunctor.
+	*/
+	template <typename T,typename T2,typename CompFuncType>
+	size_t LowerBound(T const &key,const T2 *searchList,size_t listSize,CompFuncType CompareFunc)
+	{
+		if(searchList==NULL || listSize<1)
+			return 0;
+		const T2 *base=searchList;
+		size_t remain=listSize;
+		while(remain>1)
+		{
+			size_t half=remain/2;
+			base=(CompareFunc(&key,base+half)==COMP_RESULT_GREATERTHAN)?base+half:base;
+			remain-=half;
+		}
+		return (base-searchList)+(CompareFunc(&key,base)==COMP_RESULT_GREATERTHAN);
+	}
+
+	/*!
+	Template Batch Lower Bound Function
+
+	Search the sorted list for each of the given keys with operator<,
+	and return the index of the first item which is not less than the key for each key.
+	@param[in] keyList The keys to search the list
+	@param[in] keyCount The number of the keys.
+	@param[in] searchList The sorted list to search.
+	@param[in] listSize The size of the list.
+	@param[out] retIdxList The list of keyCount indices to receive the result for each key.
+	@remark BSEARCH_BATCH_SIZE searches run interleaved with the prefetch of their next probes,
+	        so the cache misses on the large list are overlapped.
+	*/
+	template <typename T>
+	void BatchLowerBound(const T *keyList,size_t keyCount,const T *searchList,size_t listSize,size_t *retIdxList)
+	{
+		if(searchList==NULL || listSize<1)
+		{
+			for(size_t keyTrav=0;keyTrav<keyCount;keyTrav++)
+				retIdxList[keyTrav]=0;
+			return;
+		}
+		const T *baseList[BSEARCH_BATCH_SIZE];
+		for(size_t keyTrav=0;keyTrav<keyCount;keyTrav+=BSEARCH_BATCH_SIZE)
+		{
+			size_t batchCount=keyCount-keyTrav;
+			if(batchCount>BSEARCH_BATCH_SIZE)
+				batchCount=BSEARCH_BATCH_SIZE;
+			const T *batchKeyList=keyList+keyTrav;
+			size_t batchTrav;
+			for(batchTrav=0;batchTrav<batchCount;batchTrav++)
+				baseList[batchTrav]=searchList;
+
+			// every search in the batch halves the same remain, so they step in lockstep.
+			size_t remain=listSize;
+			while(remain>1)
+			{
+				size_t half=remain/2;
+				size_t nextHalf=(remain-half)/2;
+				for(batchTrav=0;batchTrav<batchCount;batchTrav++)
+				{
+					const T *base=baseList[batchTrav];
+					base=(base[half]<batchKeyList[batchTrav])?base+half:base;
+					searchPrefetch(base+nextHalf);
+					searchPrefetch(base+half+nextHalf);
+					baseList[batchTrav]=base;
+				}
+				remain-=half;
+			}
+			for(batchTrav=0;batchTrav<batchCount;batchTrav++)
+			{
+				const T *base=baseList[batchTrav];
+				retIdxList[keyTrav+batchTrav]=(base-searchList)+(*base<batchKeyList[batchTrav]);
+			}
+		}
+	}
+
+	/*!
+	Template Batch Membership Test Function
+
+	Test whether each of the given keys exists in the sorted list with operator<.
+	@param[in] keyList The keys to search the list
+	@param[in] keyCount The number of the keys.
+	@param[in] searchList The sorted list to search.
+	@param[in] listSize The size of the list.
+	@param[out] retExistList The list of keyCount flags to receive whether each key exists.
+	*/
+	template <typename T>
+	void BatchIsExist(const T *keyList,size_t keyCount,const T *searchList,size_t listSize,bool *retExistList)
+	{
+		size_t idxList[BSEARCH_BATCH_SIZE];
+		for(size_t keyTrav=0;keyTrav<keyCount;keyTrav+=BSEARCH_BATCH_SIZE)
+		{
+			size_t batchCount=keyCount-keyTrav;
+			if(batchCount>BSEARCH_BATCH_SIZE)
+				batchCount=BSEARCH_BATCH_SIZE;
+			BatchLowerBound(keyList+keyTrav,batchCount,searchList,listSize,idxList);
+			for(size_t batchTrav=0;batchTrav<batchCount;batchTrav++)
+			{
+				size_t idx=idxList[batchTrav];
+				retExistList[keyTrav+batchTrav]=(idx<listSize && !(keyList[keyTrav+batchTrav]<searchList[idx]));
+			}
+		}
+	}
+
+	/*!
+	@class EytzingerSearch epBinarySearch.h
+	@brief A template class for the search on the static sorted list in Eytzinger layout.
+
+	The sorted list is copied in the breadth-first order of the implicit binary search tree,
+	so the first levels of the search share the cache lines and the descendants are prefetched ahead.
+	The key type must support operator<.
+	*/
+	template <typename T>
+	class EytzingerSearch
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty search list
+		*/
+		EytzingerSearch():m_list(1),m_rankList(1)
+		{
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the search list with given sorted list
+		@param[in] sortedList the sorted list to search.
+		@param[in] listSize the size of the list.
+		*/
+		EytzingerSearch(const T *sortedList,size_t listSize):m_list(1),m_rankList(1)
+		{
+			Build(sortedList,listSize);
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the search list with given search list
+		@param[in] b the EytzingerSearch Object to copy from
+		*/
+		EytzingerSearch(const EytzingerSearch & b):m_list(b.m_list),m_rankList(b.m_rankList)
+		{
+		}
+
+		/*!
+		Default Destructor
+
+		Destroy the search list
+		*/
+		virtual ~EytzingerSearch()
+		{
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		EytzingerSearch & operator=(const EytzingerSearch & b)
+		{
+			if(this!=&b)
+			{
+				m_list=b.m_list;
+				m_rankList=b.m_rankList;
+			}
+			return *this;
+		}
+
+		/*!
+		Rebuild the search list with given sorted list
+		@param[in] sortedList the sorted list to search.
+		@param[in] listSize the size of the list.
+		*/
+		void Build(const T *sortedList,size_t listSize)
+		{
+			m_list.clear();
+			m_rankList.clear();
+			// index 0 is not used, so the children of k are 2k and 2k+1.
+			m_list.resize(listSize+1);
+			m_rankList.resize(listSize+1);
+			m_rankList[0]=listSize;
+			if(sortedList==NULL || listSize<1)
+				return;
+			size_t rank=0;
+			build(sortedList,rank,1);
+		}
+
+		/*!
+		Return the number of the items in the search list.
+		@return the number of the items.
+		*/
+		size_t GetSize() const
+		{
+			return m_list.size()-1;
+		}
+
+		/*!
+		Return the index of the first item which is not less than the key.
+		@param[in] key the key to search.
+		@return the index of the item in the original sorted list. If none, returns GetSize().
+		*/
+		size_t LowerBound(T const &key) const
+		{
+			return m_rankList[search(key)];
+		}
+
+		/*!
+		Check if the given key exists in the search list.
+		@param[in] key the key to search.
+		@return true if exists, otherwise false.
+		*/
+		bool IsExist(T const &key) const
+		{
+			size_t pos=search(key);
+			return pos!=0 && !(key<m_list[pos]);
+		}
+
+		/*!
+		Return the index of the first item which is not less than the key for each of the given keys.
+		@param[in] keyList the keys to search.
+		@param[in] keyCount the number of the keys.
+		@param[out] retIdxList the list of keyCount indices in the original sorted list.
+		*/
+		void BatchLowerBound(const T *keyList,size_t keyCount,size_t *retIdxList) const
+		{
+			size_t posList[BSEARCH_BATCH_SIZE];
+			for(size_t keyTrav=0;keyTrav<keyCount;keyTrav+=BSEARCH_BATCH_SIZE)
+			{
+				size_t batchCount=keyCount-keyTrav;
+				if(batchCount>BSEARCH_BATCH_SIZE)
+					batchCount=BSEARCH_BATCH_SIZE;
+				batchSearch(keyList+keyTrav,batchCount,posList);
+				for(size_t batchTrav=0;batchTrav<batchCount;batchTrav++)
+					retIdxList[keyTrav+batchTrav]=m_rankList[posList[batchTrav]];
+			}
+		}
+
+		/*!
+		Check if each of the given keys exists in the search list.
+		@param[in] keyList the keys to search.
+		@param[in] keyCount the number of the keys.
+		@param[out] retExistList the list of keyCount flags to receive whether each key exists.
+		*/
+		void BatchIsExist(const T *keyList,size_t keyCount,bool *retExistList) const
+		{
+			size_t posList[BSEARCH_BATCH_SIZE];
+			for(size_t keyTrav=0;keyTrav<keyCount;keyTrav+=BSEARCH_BATCH_SIZE)
+			{
+				size_t batchCount=keyCount-keyTrav;
+				if(batchCount>BSEARCH_BATCH_SIZE)
+					batchCount=BSEARCH_BATCH_SIZE;
+				batchSearch(keyList+keyTrav,batchCount,posList);
+				for(size_t batchTrav=0;batchTrav<batchCount;batchTrav++)
+				{
+					size_t pos=posList[batchTrav];
+					retExistList[keyTrav+batchTrav]=(pos!=0 && !(keyList[keyTrav+batchTrav]<m_list[pos]));
+				}
+			}
+		}
+
+	private:
+		/*!
+		Fill the subtree at given position with the sorted list in order.
+		@param[in] sortedList the sorted list.
+		@param[in,out] rank the index of the next item in the sorted list.
+		@param[in] pos the position of the subtree root.
+		*/
+		void build(const T *sortedList,size_t &rank,size_t pos)
+		{
+			size_t size=m_list.size()-1;
+			if(pos>size)
+				return;
+			build(sortedList,rank,2*pos);
+			m_list[pos]=sortedList[rank];
+			m_rankList[pos]=rank;
+			rank++;
+			build(sortedList,rank,2*pos+1);
+		}
+
+		/*!
+		Find the position of the first item which is not less than the key.
+		@param[in] key the key to search.
+		@return the position in the Eytzinger list. If none, returns 0.
+		*/
+		size_t search(T const &key) const
+		{
+			size_t size=m_list.size()-1;
+			const T *list=&m_list[0];
+			size_t pos=1;
+			while(pos<=size)
+			{
+				searchPrefetch(list+pos*EYTZINGER_PREFETCH_STRIDE);
+				pos=2*pos+(list[pos]<key);
+			}
+			return ancestor(pos);
+		}
+
+		/*!
+		Find the positions of the first item which is not less than the key for each of the given keys.
+		@param[in] keyList the keys to search.
+		@param[in] keyCount the number of the keys. (at most BSEARCH_BATCH_SIZE)
+		@param[out] retPosList the positions in the Eytzinger list. (0 if none)
+		*/
+		void batchSearch(const T *keyList,size_t keyCount,size_t *retPosList) const
+		{
+			size_t size=m_list.size()-1;
+			const T *list=&m_list[0];
+			size_t keyTrav;
+			for(keyTrav=0;keyTrav<keyCount;keyTrav++)
+				retPosList[keyTrav]=1;
+			// the leaves differ at most by one level, so step every search until all have fallen off.
+			bool isSearching=size>0;
+			while(isSearching)
+			{
+				isSearching=false;
+				for(keyTrav=0;keyTrav<keyCount;keyTrav++)
+				{
+					size_t pos=retPosList[keyTrav];
+					if(pos<=size)
+					{
+						searchPrefetch(list+pos*EYTZINGER_PREFETCH_STRIDE);
+						pos=2*pos+(list[pos]<keyList[keyTrav]);
+						retPosList[keyTrav]=pos;
+						isSearching=true;
+					}
+				}
+			}
+			for(keyTrav=0;keyTrav<keyCount;keyTrav++)
+				retPosList[keyTrav]=ancestor(retPosList[keyTrav]);
+		}
+
+		/*!
+		Return the last ancestor where the search went to the left child.
+		@param[in] pos the position where the search fell off the tree.
+		@return the position of the ancestor, or 0 if the search never went left.
+		*/
+		static size_t ancestor(size_t pos)
+		{
+			// the trailing one bits are the right turns, so cancel them and the last left turn.
+			while(pos&1)
+				pos>>=1;
+			return pos>>1;
+		}
+
+		/// the items in Eytzinger order (index 0 is not used)
+		std::vector<T> m_list;
+		/// the index in the original sorted list for each position
+		std::vector<size_t> m_rankList;
+	};
+
 }
 #endif //__EP_BINARY_SEARCH_H__
\ No newline at end of file
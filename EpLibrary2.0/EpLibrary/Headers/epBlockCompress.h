@@ -0,0 +1,376 @@
+/*! 
+@file epBlockCompress.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Block Compress Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the block compression of the stream.
+
+*/
+#ifndef __EP_BLOCK_COMPRESS_H__
+#define __EP_BLOCK_COMPRESS_H__
+#include "epLib.h"
+#include <vector>
+#include "epStream.h"
+#include "epNetworkStream.h"
+
+/// the default byte size of the raw data compressed into one block
+#define BLOCK_COMPRESS_BLOCK_SIZE 262144
+
+/// the byte size of the header written before each block
+#define BLOCK_COMPRESS_HEADER_SIZE 9
+
+namespace epl
+{
+	class ThreadPool;
+
+	/// Enumeration for the block codec
+	enum BlockCodecType{
+		/// The block is stored without compression
+		BLOCK_CODEC_TYPE_STORE=0,
+		/// The block is compressed in the LZ4 block format
+		BLOCK_CODEC_TYPE_LZ4,
+		/// Block Codec Count
+		BLOCK_CODEC_TYPE_COUNT,
+	};
+
+	/*!
+	@class BlockCodec epBlockCompress.h
+	@brief A class for compressing and decompressing one block with the selected codec.
+	*/
+	class EP_LIBRARY BlockCodec
+	{
+	public:
+		/*!
+		Return the byte size the compressed block can take at most.
+		@param[in] codecType the codec to compress with.
+		@param[in] rawByteSize the byte size of the raw block.
+		@return the maximum byte size of the compressed block.
+		*/
+		static size_t GetMaxCompressedSize(BlockCodecType codecType, size_t rawByteSize);
+
+		/*!
+		Compress the block with given codec.
+		@param[in] codecType the codec to compress with.
+		@param[out] dest the buffer to receive the compressed block.
+		@param[in] destByteSize the byte size of the buffer.
+		@param[in] src the raw block.
+		@param[in] srcByteSize the byte size of the raw block.
+		@return the byte size of the compressed block, or 0 if the buffer is too small.
+		*/
+		static size_t Compress(BlockCodecType codecType, unsigned char *dest, size_t destByteSize, const unsigned char *src, size_t srcByteSize);
+
+		/*!
+		Decompress the block with given codec.
+		@param[in] codecType the codec the block is compressed with.
+		@param[out] dest the buffer to receive the raw block.
+		@param[in] destByteSize the byte size of the raw block.
+		@param[in] src the compressed block.
+		@param[in] srcByteSize the byte size of the compressed block.
+		@return true if the block is decompressed to exactly given byte size, false if the block is corrupted.
+		@remark the compressed block is fully validated, so the corrupted block never writes out of the buffer.
+		*/
+		static bool Decompress(BlockCodecType codecType, unsigned char *dest, size_t destByteSize, const unsigned char *src, size_t srcByteSize);
+	};
+
+	/*!
+	@class BlockCompressWriter epBlockCompress.h
+	@brief A class for writing the data to the stream as the independently compressed blocks.
+
+	Each block is written as the header followed by the compressed data,
+	and the index of the blocks is written at Close, so that the blocks can be read randomly and decompressed in parallel.
+	The block which does not shrink is stored without compression.
+	*/
+	class EP_LIBRARY BlockCompressWriter
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the writer
+		@param[in] target the stream to write the blocks to.
+		@param[in] codecType the codec to compress the blocks with.
+		@param[in] blockSize the byte size of the raw data compressed into one block.
+		@param[in] lockPolicyType The lock policy
+		@remark the target must outlive the writer.
+		*/
+		BlockCompressWriter(Stream &target, BlockCodecType codecType=BLOCK_CODEC_TYPE_LZ4, unsigned int blockSize=BLOCK_COMPRESS_BLOCK_SIZE, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Close and destroy the writer
+		*/
+		virtual ~BlockCompressWriter();
+
+		/*!
+		Write the data to the writer.
+		@param[in] data the data to write.
+		@param[in] byteSize the byte size of the data.
+		@return true if successful, otherwise false.
+		@remark the block is compressed and written to the target whenever it is filled.
+		*/
+		bool Write(const void *data, size_t byteSize);
+
+		/*!
+		Write the last block and the index to the target.
+		@return true if successful, otherwise false.
+		@remark nothing can be written after Close.
+		*/
+		bool Close();
+
+		/*!
+		Return the flag whether the writer is closed.
+		@return true if closed, otherwise false.
+		*/
+		bool IsClosed() const;
+
+		/*!
+		Return the byte size of the raw data written.
+		@return the byte size of the raw data.
+		*/
+		unsigned __int64 GetRawSize() const;
+
+		/*!
+		Return the byte size written to the target.
+		@return the byte size of the compressed data.
+		*/
+		unsigned __int64 GetCompressedSize() const;
+
+		/*!
+		Compress the whole data to the stream at once.
+		@param[in] target the stream to write the blocks to.
+		@param[in] data the data to compress.
+		@param[in] byteSize the byte size of the data.
+		@param[in] codecType the codec to compress the blocks with.
+		@param[in] blockSize the byte size of the raw data compressed into one block.
+		@param[in] pool the thread pool to compress the blocks in parallel. (NULL to run on the calling thread only)
+		@return true if successful, otherwise false.
+		@remark the result is the same as writing the data to the writer and closing it.
+		*/
+		static bool Compress(Stream &target, const void *data, size_t byteSize, BlockCodecType codecType=BLOCK_CODEC_TYPE_LZ4, unsigned int blockSize=BLOCK_COMPRESS_BLOCK_SIZE, ThreadPool *pool=NULL);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		BlockCompressWriter(const BlockCompressWriter & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BlockCompressWriter &operator=(const BlockCompressWriter & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Compress the filled block, and write it to the target.
+		@return true if successful, otherwise false.
+		*/
+		bool writeBlock();
+
+		/// the target stream
+		Stream *m_target;
+		/// the codec
+		BlockCodecType m_codecType;
+		/// the byte size of the raw block
+		unsigned int m_blockSize;
+		/// the raw block being filled
+		unsigned char *m_block;
+		/// the byte size filled in the raw block
+		unsigned int m_blockFill;
+		/// the buffer for the compressed block
+		unsigned char *m_compressed;
+		/// the byte size of the buffer for the compressed block
+		size_t m_compressedCapacity;
+		/// the offset of each block written
+		std::vector<unsigned __int64> m_offsetList;
+		/// the raw byte size of each block written
+		std::vector<unsigned int> m_rawSizeList;
+		/// the byte size of the raw data written
+		unsigned __int64 m_rawSize;
+		/// the byte size written to the target
+		unsigned __int64 m_compressedSize;
+		/// the flag whether the writer is closed
+		bool m_isClosed;
+		/// writer lock
+		BaseLock *m_writerLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*!
+	@class BlockCompressReader epBlockCompress.h
+	@brief A class for reading the blocks written by BlockCompressWriter.
+
+	The reader reads the compressed data in place, and never changes once opened,
+	so the blocks can be decompressed from many threads at the same time.
+	*/
+	class EP_LIBRARY BlockCompressReader
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the reader
+		*/
+		BlockCompressReader();
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the reader reading the same data as given reader
+		@param[in] b the second object
+		*/
+		BlockCompressReader(const BlockCompressReader& b);
+
+		/*!
+		Default Destructor
+
+		Destroy the reader
+		*/
+		virtual ~BlockCompressReader();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BlockCompressReader & operator=(const BlockCompressReader&b);
+
+		/*!
+		Open the compressed data, and read its index.
+		@param[in] data the compressed data written by BlockCompressWriter.
+		@param[in] byteSize the byte size of the compressed data.
+		@return true if successful, false if the data is not valid.
+		@remark the data is read in place, and must outlive the reader or the next Open.
+		*/
+		bool Open(const unsigned char *data, size_t byteSize);
+
+		/*!
+		Open the whole stream as the compressed data, and read its index.
+		@param[in] source the stream holding the compressed data.
+		@return true if successful, false if the data is not valid.
+		@remark the stream is read in place, and must not be modified until the next Open.
+		*/
+		bool Open(const Stream &source);
+
+		/*!
+		Close the reader.
+		*/
+		void Close();
+
+		/*!
+		Return the flag whether the reader is opened.
+		@return true if opened, otherwise false.
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Return the number of the blocks.
+		@return the number of the blocks.
+		*/
+		size_t GetBlockCount() const;
+
+		/*!
+		Return the byte size of the whole raw data.
+		@return the byte size of the raw data.
+		*/
+		unsigned __int64 GetRawSize() const;
+
+		/*!
+		Return the offset of the block within the raw data.
+		@param[in] blockIdx the index of the block.
+		@return the offset of the block within the raw data.
+		*/
+		unsigned __int64 GetBlockRawOffset(size_t blockIdx) const;
+
+		/*!
+		Return the raw byte size of the block.
+		@param[in] blockIdx the index of the block.
+		@return the raw byte size of the block.
+		*/
+		unsigned int GetBlockRawSize(size_t blockIdx) const;
+
+		/*!
+		Decompress the block.
+		@param[in] blockIdx the index of the block.
+		@param[out] dest the buffer to receive the raw block, of GetBlockRawSize bytes at least.
+		@return true if successful, false if the block is corrupted.
+		*/
+		bool DecompressBlock(size_t blockIdx, unsigned char *dest) const;
+
+		/*!
+		Read the raw data at given offset.
+		@param[in] rawOffset the offset within the raw data.
+		@param[out] dest the buffer to receive the raw data.
+		@param[in] byteSize the byte size to read.
+		@return true if successful, false if out of the raw data or the block is corrupted.
+		@remark only the blocks covering the range are decompressed.
+		*/
+		bool Read(unsigned __int64 rawOffset, void *dest, size_t byteSize) const;
+
+		/*!
+		Decompress the whole raw data to the stream.
+		@param[in] dest the stream to write the raw data to.
+		@param[in] pool the thread pool to decompress the blocks in parallel. (NULL to run on the calling thread only)
+		@return true if successful, false if any block is corrupted.
+		@remark the raw data is decompressed in place at the seek of the stream.
+		*/
+		bool DecompressAll(Stream &dest, ThreadPool *pool=NULL) const;
+
+		/*!
+		Decompress the next block from the network stream in the order written.
+		@param[in] source the stream receiving the compressed data.
+		@param[in] dest the stream to write the raw block to.
+		@param[out] retIsEnd set to true if the index written at Close is consumed instead of the block.
+		@return true if the block or the index is consumed, false if the stream does not hold the whole block yet or the block is corrupted.
+		@remark the read seek is left unchanged if failed, so the block can be read again after more data arrives.
+		*/
+		static bool DecompressNextBlock(NetworkStream &source, Stream &dest, bool &retIsEnd);
+
+	private:
+		/// the compressed data
+		const unsigned char *m_data;
+		/// the byte size of the compressed data
+		size_t m_byteSize;
+		/// the offset of each block within the compressed data
+		std::vector<size_t> m_offsetList;
+		/// the offset of each block within the raw data, and the whole raw size at the end
+		std::vector<unsigned __int64> m_rawOffsetList;
+	};
+}
+
+#endif //__EP_BLOCK_COMPRESS_H__
\ No newline at end of file
@@ -46,6 +46,7 @@ An Interface for CStringEx Class.
 #define __EP_CSTRING_EX_H__
 #include "epLib.h"
 #include "epSystem.h"
+#include "epStringView.h"
 
 namespace epl
 {
@@ -78,6 +79,13 @@ namespace epl
 		CStringEx LeftOfRightmost(TCHAR c) const;					// everything to the left of the last occurance of <c>
 		CStringEx SubStr(int begin, int len) const;					// substring from s[begin] to s[begin+len]
 
+		StringView GetView() const;									// view of the whole string
+		StringView LeftView(TCHAR c, int n=1) const;				// Left without copying the characters
+		StringView RightView(TCHAR c, int n=1) const;				// Right without copying the characters
+		StringView RightmostView(TCHAR c) const;					// Rightmost without copying the characters
+		StringView LeftOfRightmostView(TCHAR c) const;				// LeftOfRightmost without copying the characters
+		StringView SubStrView(int begin, int len) const;			// SubStr without copying the characters
+
 		void Trim(void) {TrimLeft(); TrimRight();};					// trims both left and right sides
 
 		CStringEx& operator=(const CString& s) {CString::operator=(s); return *this;}
@@ -0,0 +1,637 @@
+/*! 
+@file epCache.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Cache Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Concurrent Cache Template Class with CLOCK Eviction.
+
+*/
+#ifndef __EP_CACHE_H__
+#define __EP_CACHE_H__
+#include "epLib.h"
+#include "epConcurrentHashMap.h"
+#include "epEpochReclaimer.h"
+#include "epLightEvent.h"
+#include "epClock.h"
+#include <map>
+
+/// the default number of shards of the cache
+#define CACHE_DEFAULT_SHARD_COUNT 16
+/// the cache line size to keep the shards apart
+#define CACHE_CACHE_LINE_SIZE 64
+
+namespace epl
+{
+	/*! 
+	@class CacheLoaderInterface epCache.h
+	@brief An interface to load the data for the key missed in the cache.
+	*/
+	template<typename KeyType, typename DataType>
+	class CacheLoaderInterface
+	{
+	public:
+		/*!
+		Load the data with given key.
+		@param[in] key the key missed
+		@param[out] retData the data loaded
+		@param[out] retSize the size of the data loaded to account for the capacity
+		@return true if loaded otherwise false
+		@remark called without any lock of the cache held, by only one thread for the same key at a time.
+		*/
+		virtual bool Load(const KeyType &key, DataType &retData, size_t &retSize)=0;
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~CacheLoaderInterface(){}
+	};
+
+	/*! 
+	@class Cache epCache.h
+	@brief A Concurrent Cache Template class bounded by the total size of the data, with the CLOCK eviction.
+
+	The entries are found through the concurrent hash map, so the hits take no lock,
+	and only mark the entry referenced, which the CLOCK hand of the shard clears as it sweeps.
+	The hand evicts the entries not referenced since its last sweep until the shard fits its share of the capacity.
+	The entries evicted or replaced are retired to the epoch reclaimer, so the readers copying the data never see them freed.
+	When the loader is given, the concurrent misses for the same key wait for the one load in progress.
+	@remark each thread reading the cache must call UnregisterThread before it exits.
+	*/
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *)=HashClass<KeyType>::HashFunc, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)=CompClass<KeyType>::CompFunc>
+	class Cache
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Cache
+		@param[in] capacity the maximum total size of the data, divided evenly among the shards
+		@param[in] timeToLiveInMilliSec the time in milliseconds the entry expires after set, or 0 to never expire
+		@param[in] shardCount the number of shards (rounded up to power of two, at most 256)
+		@param[in] lockPolicyType The lock policy of each shard
+		*/
+		Cache(size_t capacity, unsigned int timeToLiveInMilliSec=0, unsigned int shardCount=CACHE_DEFAULT_SHARD_COUNT, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the Cache
+		@remark no thread may be reading the cache.
+		*/
+		virtual ~Cache();
+
+		/*!
+		Find the given key from the cache and return the data with the given key
+		@param[in] key The key value to find
+		@param[out] retData the data with the given key
+		@return true if found otherwise false
+		@remark takes no lock.
+		*/
+		bool Find(const KeyType &key, DataType &retData) const;
+
+		/*!
+		Find the given key from the cache, or load it by the given loader if missed
+		@param[in] key The key value to find
+		@param[out] retData the data with the given key
+		@param[in] loader the loader to load the data missed
+		@return true if found or loaded otherwise false
+		@remark the threads missing the key while it is loaded wait for the load, and share its result.
+		*/
+		bool FindOrLoad(const KeyType &key, DataType &retData, CacheLoaderInterface<KeyType,DataType> *loader);
+
+		/*!
+		Insert the key with given data to the cache, or replace the data if the key already exists
+		@param[in] key The key value to set.
+		@param[in] data the data with the given key
+		@param[in] size the size of the data to account for the capacity
+		@remark the entries not referenced recently are evicted to fit the capacity.
+		*/
+		void Set(const KeyType &key, const DataType &data, size_t size=1);
+
+		/*!
+		Remove the given key from the cache
+		@param[in] key The key value to remove
+		@return true if succeeded otherwise false
+		*/
+		bool Erase(const KeyType &key);
+
+		/*!
+		Clear the cache
+		*/
+		void Clear();
+
+		/*!
+		return the number of entries in the cache.
+		@return the number of entries in the cache
+		@remark the expired entries are counted until evicted.
+		*/
+		size_t Size() const;
+
+		/*!
+		return the total size of the data in the cache.
+		@return the total size of the data in the cache
+		*/
+		size_t GetUsedSize() const;
+
+		/*!
+		return the maximum total size of the data.
+		@return the capacity of the cache
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		return the time the entry expires after set.
+		@return the time to live in milliseconds, or 0 if the entries never expire
+		*/
+		unsigned int GetTimeToLive() const;
+
+		/*!
+		Give back the reclaimer slots of the calling thread.
+		*/
+		void UnregisterThread();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		Cache(const Cache & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		Cache &operator=(const Cache & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		@struct CacheEntry epCache.h
+		@brief A structure for the cached data, immutable except the referenced flag and the ring index.
+		*/
+		struct CacheEntry
+		{
+			/// the key
+			KeyType m_key;
+			/// the data
+			DataType m_data;
+			/// the size of the data
+			size_t m_size;
+			/// the time in milliseconds the entry expires, or 0 if never
+			__int64 m_expireMilliSec;
+			/// the flag whether the entry is hit since the last sweep of the hand
+			volatile long m_isReferenced;
+			/// the index of the entry in the ring of its shard
+			size_t m_ringIdx;
+		};
+
+		/*!
+		@struct PendingLoad epCache.h
+		@brief A structure for the load in progress, shared by the threads missed the same key.
+		*/
+		struct PendingLoad
+		{
+			/// the event raised when the load is done
+			LightEvent m_doneEvent;
+			/// the data loaded
+			DataType m_data;
+			/// the flag whether loaded
+			bool m_isLoaded;
+			/// the number of the threads referencing
+			volatile long m_refCount;
+
+			PendingLoad():m_doneEvent(false,true)
+			{
+				m_isLoaded=false;
+				m_refCount=1;
+			}
+		};
+
+		/*!
+		@struct KeyLess epCache.h
+		@brief Key ordering of the pending loads by KeyCompareFunc
+		*/
+		struct KeyLess
+		{
+			bool operator()(const KeyType &a, const KeyType &b) const
+			{
+				return KeyCompareFunc(&a,&b)==COMP_RESULT_LESSTHAN;
+			}
+		};
+		/// Pending Load Map Type
+		typedef std::map<KeyType,PendingLoad*,KeyLess> PendingLoadMap;
+
+		/*!
+		@struct Shard epCache.h
+		@brief A structure for the shard.
+		*/
+		struct Shard
+		{
+			/// the entries of the shard swept by the hand
+			std::vector<CacheEntry*> m_ring;
+			/// the position of the CLOCK hand
+			size_t m_hand;
+			/// the total size of the data in the shard
+			size_t m_usedSize;
+			/// the loads in progress
+			PendingLoadMap m_pendingMap;
+			/// shard lock for the writers
+			BaseLock *m_lock;
+			/// padding to keep the shards on the different cache lines
+			char m_padding[CACHE_CACHE_LINE_SIZE];
+		};
+
+		/// Entry Map Type
+		typedef ConcurrentHashMap<KeyType,CacheEntry*,KeyHashFunc,KeyCompareFunc> EntryMap;
+
+		/*!
+		Return the shard of the given key
+		@param[in] key the key
+		@return the shard for the key
+		@remark the shard is chosen by the same hash bits as the stripe of the entry map.
+		*/
+		Shard &getShard(const KeyType &key) const
+		{
+			if(m_shardBits==0)
+				return m_shardList[0];
+			return m_shardList[KeyHashFunc(&key)>>(sizeof(size_t)*8-m_shardBits)];
+		}
+
+		/*!
+		Check if the given entry is expired
+		@param[in] entry the entry to check
+		@return true if expired otherwise false
+		*/
+		static bool isExpired(const CacheEntry *entry)
+		{
+			return entry->m_expireMilliSec!=0 && COARSE_CLOCK_INSTANCE.GetMilliSec()>=entry->m_expireMilliSec;
+		}
+
+		/*!
+		Find the entry with the given key still alive
+		@param[in] key the key to find
+		@param[out] retData the data with the given key
+		@return true if found otherwise false
+		@remark the calling thread must hold the shard lock.
+		*/
+		bool findLocked(const KeyType &key, DataType &retData) const;
+
+		/*!
+		Insert or replace the entry, and evict the entries to fit the capacity of the shard
+		@param[in] shard the shard locked by the calling thread
+		@param[in] key The key value to set.
+		@param[in] data the data with the given key
+		@param[in] size the size of the data
+		*/
+		void setLocked(Shard &shard, const KeyType &key, const DataType &data, size_t size);
+
+		/*!
+		Remove the entry at the given position of the ring
+		@param[in] shard the shard locked by the calling thread
+		@param[in] ringIdx the position of the entry in the ring
+		*/
+		void removeLocked(Shard &shard, size_t ringIdx);
+
+		/*!
+		Release the given pending load
+		@param[in] pending the pending load to release
+		*/
+		static void releasePending(PendingLoad *pending)
+		{
+			if(InterlockedDecrement(&pending->m_refCount)==0)
+				EP_DELETE pending;
+		}
+
+		/// the entries by the key
+		EntryMap m_entryMap;
+		/// the shards
+		Shard *m_shardList;
+		/// the number of the hash bits selecting the shard
+		unsigned int m_shardBits;
+		/// the maximum total size of the data in each shard
+		size_t m_shardCapacity;
+		/// the maximum total size of the data
+		size_t m_capacity;
+		/// the time in milliseconds the entry expires after set
+		unsigned int m_timeToLive;
+		/// the reclaimer for the entries evicted or replaced
+		EpochReclaimer *m_reclaimer;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Cache(size_t capacity, unsigned int timeToLiveInMilliSec, unsigned int shardCount, LockPolicy lockPolicyType)
+		:m_entryMap(shardCount,HASH_MAP_DEFAULT_CAPACITY,LOCK_POLICY_NONE)
+	{
+		// the entry map is written only under the shard lock of the same hash bits, so its stripes need no lock
+		m_lockPolicy=lockPolicyType;
+		m_shardBits=0;
+		while((1U<<m_shardBits)<shardCount && m_shardBits<8)
+			m_shardBits++;
+		unsigned int actualCount=1U<<m_shardBits;
+		m_capacity=capacity;
+		m_shardCapacity=capacity/actualCount;
+		if(m_shardCapacity==0)
+			m_shardCapacity=1;
+		m_timeToLive=timeToLiveInMilliSec;
+		m_reclaimer=EP_NEW EpochReclaimer(EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT,EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD,EP_LOCK_POLICY);
+		m_shardList=EP_NEW Shard[actualCount];
+		for(unsigned int shardTrav=0;shardTrav<actualCount;shardTrav++)
+		{
+			Shard &shard=m_shardList[shardTrav];
+			shard.m_hand=0;
+			shard.m_usedSize=0;
+			switch(lockPolicyType)
+			{
+			case LOCK_POLICY_CRITICALSECTION:
+				shard.m_lock=EP_NEW CriticalSectionEx();
+				break;
+			case LOCK_POLICY_MUTEX:
+				shard.m_lock=EP_NEW Mutex();
+				break;
+			case LOCK_POLICY_NONE:
+				shard.m_lock=EP_NEW NoLock();
+				break;
+			case LOCK_POLICY_SPIN_PARK:
+				shard.m_lock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				shard.m_lock=EP_NEW ReaderWriterLock();
+				break;
+			default:
+				shard.m_lock=NULL;
+			}
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::~Cache()
+	{
+		unsigned int shardCount=1U<<m_shardBits;
+		for(unsigned int shardTrav=0;shardTrav<shardCount;shardTrav++)
+		{
+			Shard &shard=m_shardList[shardTrav];
+			for(size_t entryTrav=0;entryTrav<shard.m_ring.size();entryTrav++)
+				EP_DELETE shard.m_ring[entryTrav];
+			if(shard.m_lock)
+				EP_DELETE shard.m_lock;
+		}
+		EP_DELETE[] m_shardList;
+		// reclaims the entries still retired
+		EP_DELETE m_reclaimer;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Find(const KeyType &key, DataType &retData) const
+	{
+		EpochReclaimer::EpochGuard guard(*m_reclaimer);
+		CacheEntry *entry;
+		if(!m_entryMap.Find(key,entry))
+			return false;
+		if(isExpired(entry))
+			return false;
+		// write only when not set, so the hits on the hot entry do not bounce its cache line
+		if(!entry->m_isReferenced)
+			entry->m_isReferenced=1;
+		retData=entry->m_data;
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::findLocked(const KeyType &key, DataType &retData) const
+	{
+		CacheEntry *entry;
+		if(!m_entryMap.Find(key,entry) || isExpired(entry))
+			return false;
+		entry->m_isReferenced=1;
+		retData=entry->m_data;
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::FindOrLoad(const KeyType &key, DataType &retData, CacheLoaderInterface<KeyType,DataType> *loader)
+	{
+		EP_ASSERT(loader);
+		if(Find(key,retData))
+			return true;
+
+		Shard &shard=getShard(key);
+		PendingLoad *pending;
+		bool isLoader=false;
+		{
+			LockObj lock(shard.m_lock);
+			// the key may be set while this thread was waiting for the lock
+			if(findLocked(key,retData))
+				return true;
+			typename PendingLoadMap::iterator iter=shard.m_pendingMap.find(key);
+			if(iter!=shard.m_pendingMap.end())
+			{
+				pending=iter->second;
+				InterlockedIncrement(&pending->m_refCount);
+			}
+			else
+			{
+				pending=EP_NEW PendingLoad();
+				shard.m_pendingMap.insert(typename PendingLoadMap::value_type(key,pending));
+				isLoader=true;
+			}
+		}
+
+		if(!isLoader)
+		{
+			pending->m_doneEvent.WaitForEvent();
+			bool retVal=pending->m_isLoaded;
+			if(retVal)
+				retData=pending->m_data;
+			releasePending(pending);
+			return retVal;
+		}
+
+		size_t size=1;
+		pending->m_isLoaded=loader->Load(key,pending->m_data,size);
+		{
+			LockObj lock(shard.m_lock);
+			if(pending->m_isLoaded)
+				setLocked(shard,key,pending->m_data,size);
+			shard.m_pendingMap.erase(key);
+		}
+		bool retVal=pending->m_isLoaded;
+		if(retVal)
+			retData=pending->m_data;
+		pending->m_doneEvent.SetEvent();
+		releasePending(pending);
+		return retVal;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Set(const KeyType &key, const DataType &data, size_t size)
+	{
+		Shard &shard=getShard(key);
+		LockObj lock(shard.m_lock);
+		setLocked(shard,key,data,size);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::setLocked(Shard &shard, const KeyType &key, const DataType &data, size_t size)
+	{
+		CacheEntry *newEntry=EP_NEW CacheEntry();
+		newEntry->m_key=key;
+		newEntry->m_data=data;
+		newEntry->m_size=size;
+		newEntry->m_expireMilliSec=0;
+		if(m_timeToLive)
+			newEntry->m_expireMilliSec=COARSE_CLOCK_INSTANCE.GetMilliSec()+m_timeToLive;
+		newEntry->m_isReferenced=0;
+
+		CacheEntry *oldEntry;
+		if(m_entryMap.Find(key,oldEntry))
+		{
+			newEntry->m_ringIdx=oldEntry->m_ringIdx;
+			shard.m_ring[newEntry->m_ringIdx]=newEntry;
+			shard.m_usedSize-=oldEntry->m_size;
+			m_entryMap.Set(key,newEntry);
+			m_reclaimer->RetireObject(oldEntry);
+		}
+		else
+		{
+			newEntry->m_ringIdx=shard.m_ring.size();
+			shard.m_ring.push_back(newEntry);
+			m_entryMap.Set(key,newEntry);
+		}
+		shard.m_usedSize+=size;
+
+		// sweep the hand, sparing the entry just set, until the shard fits
+		while(shard.m_usedSize>m_shardCapacity && shard.m_ring.size()>1)
+		{
+			if(shard.m_hand>=shard.m_ring.size())
+				shard.m_hand=0;
+			CacheEntry *entry=shard.m_ring[shard.m_hand];
+			if(entry==newEntry)
+			{
+				shard.m_hand++;
+			}
+			else if(entry->m_isReferenced && !isExpired(entry))
+			{
+				entry->m_isReferenced=0;
+				shard.m_hand++;
+			}
+			else
+			{
+				// the last entry is moved to the hand, so the hand stays to look at it next
+				removeLocked(shard,shard.m_hand);
+			}
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::removeLocked(Shard &shard, size_t ringIdx)
+	{
+		CacheEntry *entry=shard.m_ring[ringIdx];
+		CacheEntry *lastEntry=shard.m_ring.back();
+		shard.m_ring[ringIdx]=lastEntry;
+		lastEntry->m_ringIdx=ringIdx;
+		shard.m_ring.pop_back();
+		shard.m_usedSize-=entry->m_size;
+		m_entryMap.Erase(entry->m_key);
+		m_reclaimer->RetireObject(entry);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Erase(const KeyType &key)
+	{
+		Shard &shard=getShard(key);
+		LockObj lock(shard.m_lock);
+		CacheEntry *entry;
+		if(!m_entryMap.Find(key,entry))
+			return false;
+		removeLocked(shard,entry->m_ringIdx);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Clear()
+	{
+		unsigned int shardCount=1U<<m_shardBits;
+		for(unsigned int shardTrav=0;shardTrav<shardCount;shardTrav++)
+		{
+			Shard &shard=m_shardList[shardTrav];
+			LockObj lock(shard.m_lock);
+			while(!shard.m_ring.empty())
+				removeLocked(shard,shard.m_ring.size()-1);
+			shard.m_hand=0;
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Size() const
+	{
+		return m_entryMap.Size();
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetUsedSize() const
+	{
+		size_t retSize=0;
+		unsigned int shardCount=1U<<m_shardBits;
+		for(unsigned int shardTrav=0;shardTrav<shardCount;shardTrav++)
+		{
+			LockObj lock(m_shardList[shardTrav].m_lock);
+			retSize+=m_shardList[shardTrav].m_usedSize;
+		}
+		return retSize;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	unsigned int Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetTimeToLive() const
+	{
+		return m_timeToLive;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void Cache<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::UnregisterThread()
+	{
+		m_entryMap.UnregisterThread();
+		m_reclaimer->UnregisterThread();
+	}
+}
+
+#endif //__EP_CACHE_H__
@@ -0,0 +1,109 @@
+/*! 
+@file epCancellationToken.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Cancellation Token Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Cooperative Cancellation Token Class.
+
+*/
+#ifndef __EP_CANCELLATION_TOKEN_H__
+#define __EP_CANCELLATION_TOKEN_H__
+#include "epLib.h"
+#include "epSmartObject.h"
+
+namespace epl
+{
+	/*! 
+	@class CancellationToken epCancellationToken.h
+	@brief A class for cooperative cancellation shared by many jobs.
+
+	Cancelling the token is O(1) regardless of how many jobs share it.
+	The queued jobs with the cancelled token are dropped at dequeue,
+	and the running jobs can check IsCancelled to stop early.
+	*/
+	class EP_LIBRARY CancellationToken: public SmartObject
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the token
+		@param[in] lockPolicyType The lock policy
+		*/
+		CancellationToken(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the token
+		*/
+		virtual ~CancellationToken();
+
+		/*!
+		Cancel the token.
+		*/
+		void Cancel();
+
+		/*!
+		Clear the cancellation so that the token can be reused.
+		*/
+		void Reset();
+
+		/*!
+		Check if the token is cancelled.
+		@return true if cancelled, otherwise false.
+		*/
+		bool IsCancelled() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		CancellationToken(const CancellationToken & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		CancellationToken &operator=(const CancellationToken & b){EP_ASSERT(0);return *this;}
+
+		/// cancelled flag
+		volatile long m_isCancelled;
+	};
+}
+
+#endif //__EP_CANCELLATION_TOKEN_H__
\ No newline at end of file
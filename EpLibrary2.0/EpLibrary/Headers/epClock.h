@@ -0,0 +1,247 @@
+/*! 
+@file epClock.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Monotonic Clock Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Monotonic and Coarse Clocks.
+
+*/
+#ifndef __EP_CLOCK_H__
+#define __EP_CLOCK_H__
+#include "epLib.h"
+#include "epSingletonHolder.h"
+#include "epAssert.h"
+
+/*!
+@def COARSE_CLOCK_INSTANCE
+@brief A Simple Macro to get the Coarse Clock Instance
+
+Macro that returns the reference of Coarse Clock Instance.
+*/
+#define COARSE_CLOCK_INSTANCE epl::SingletonHolder<epl::CoarseClock,epl::SINGLETON_LIFETIME_NEVER_DESTROY>::Instance()
+
+/// the time in milliseconds the time stamp counter is calibrated against the performance counter
+#define CLOCK_CALIBRATION_TIME 10
+
+/// the default time in milliseconds between the updates of the coarse clock
+#define COARSE_CLOCK_DEFAULT_UPDATE_INTERVAL 10
+
+namespace epl
+{
+	class CoarseClockThread;
+
+	/*! 
+	@class Clock epClock.h
+	@brief A class for the monotonic high-resolution clock.
+
+	The ticks are read from the time stamp counter of the processor, when it is invariant,
+	and the frequency of it is calibrated against the performance counter on the first use.
+	Otherwise the ticks are read from the performance counter.
+	The ticks only make sense as the differences, and convert to the time with the given functions.
+	*/
+	class EP_LIBRARY Clock
+	{
+	public:
+		/*!
+		Return the current tick of the clock.
+		@return the current tick.
+		*/
+		static __int64 GetTick();
+
+		/*!
+		Return the number of the ticks per second.
+		@return the number of the ticks per second.
+		*/
+		static __int64 GetFrequency();
+
+		/*!
+		Return the flag whether the ticks are read from the time stamp counter.
+		@return true if the time stamp counter is used, otherwise false.
+		*/
+		static bool IsTscBased();
+
+		/*!
+		Convert the ticks to the nanoseconds.
+		@param[in] tick the ticks to convert.
+		@return the nanoseconds of the given ticks.
+		*/
+		static __int64 ToNanoSec(__int64 tick);
+
+		/*!
+		Convert the ticks to the microseconds.
+		@param[in] tick the ticks to convert.
+		@return the microseconds of the given ticks.
+		*/
+		static __int64 ToMicroSec(__int64 tick);
+
+		/*!
+		Convert the ticks to the milliseconds.
+		@param[in] tick the ticks to convert.
+		@return the milliseconds of the given ticks.
+		*/
+		static __int64 ToMilliSec(__int64 tick);
+
+		/*!
+		Convert the nanoseconds to the ticks.
+		@param[in] nanoSec the nanoseconds to convert.
+		@return the ticks of the given nanoseconds.
+		*/
+		static __int64 FromNanoSec(__int64 nanoSec);
+
+		/*!
+		Return the current time of the clock in nanoseconds.
+		@return the current time in nanoseconds.
+		*/
+		static __int64 GetNanoSec();
+
+		/*!
+		Return the current time of the clock in microseconds.
+		@return the current time in microseconds.
+		*/
+		static __int64 GetMicroSec();
+
+		/*!
+		Return the current time of the clock in milliseconds.
+		@return the current time in milliseconds.
+		*/
+		static __int64 GetMilliSec();
+
+	private:
+		/*!
+		Convert the ticks to the given unit.
+		@param[in] tick the ticks to convert.
+		@param[in] unitPerSec the number of the units per second.
+		@return the units of the given ticks.
+		*/
+		static __int64 toUnit(__int64 tick, __int64 unitPerSec);
+
+		/*!
+		Default Constructor
+
+		@remark Clock only has the static functions.
+		*/
+		Clock();
+	};
+
+	/*! 
+	@class CoarseClock epClock.h
+	@brief A class for the clock, which is cached by a timer thread.
+
+	Reading the clock is a few loads, so it is for the time stamps taken very often,
+	which are fine with the accuracy of the update interval.
+	The timer thread is started on the first call of COARSE_CLOCK_INSTANCE.
+	@remark The actual update interval is not shorter than the resolution of the system timer.
+	*/
+	class EP_LIBRARY CoarseClock
+	{
+	public:
+		friend class SingletonHolder<CoarseClock,SINGLETON_LIFETIME_NEVER_DESTROY>;
+		friend class CoarseClockThread;
+
+		/*!
+		Return the cached time of Clock in milliseconds.
+		@return the cached time in milliseconds.
+		*/
+		__int64 GetMilliSec() const;
+
+		/*!
+		Return the lower 32 bits of the cached time in milliseconds.
+		@return the cached time in milliseconds, which wraps around like System::GetTickCount.
+		*/
+		unsigned int GetTickCount() const;
+
+		/*!
+		Return the cached local time.
+		@return the cached local time.
+		*/
+		SYSTEMTIME GetLocalTime() const;
+
+		/*!
+		Set the time between the updates of the clock.
+		@param[in] updateInterval the time in milliseconds between the updates.
+		*/
+		void SetUpdateInterval(unsigned int updateInterval);
+
+		/*!
+		Return the time between the updates of the clock.
+		@return the time in milliseconds between the updates.
+		*/
+		unsigned int GetUpdateInterval() const;
+
+	private:
+		/*!
+		Default Constructor
+
+		Reads the clock and starts the timer thread.
+		*/
+		CoarseClock();
+
+		/*!
+		Default Destructor
+
+		Stops the timer thread.
+		*/
+		~CoarseClock();
+
+		/*!
+		Copy Constructor
+
+		@remark The copy constructor is in private to protect the singleton property.
+		*/
+		CoarseClock(const CoarseClock& b){EP_ASSERT(0);}
+
+		/*!
+		Copy Operator
+
+		@remark The copy operator is in private to protect the singleton property.
+		*/
+		CoarseClock & operator=(const CoarseClock&b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Read the clock and the local time, and publish them to the readers.
+		*/
+		void update();
+
+		/// the sequence of the updates, which is odd while the values are written
+		volatile long m_sequence;
+		/// the cached time in milliseconds
+		__int64 m_milliSec;
+		/// the cached local time
+		SYSTEMTIME m_localTime;
+		/// the time in milliseconds between the updates
+		volatile unsigned int m_updateInterval;
+		/// the timer thread
+		CoarseClockThread *m_thread;
+	};
+}
+
+#endif //__EP_CLOCK_H__
@@ -74,6 +74,7 @@ An Interface for CmdLineOptions Class.
 #include "epLocale.h"
 #include <vector>
 #include <map>
+#include <algorithm>
 
 using namespace std;
 
@@ -159,7 +160,7 @@ namespace epl
 		@param[in] option the option string to get argument
 		@param[in] idx the index of the arguments of given option
 		@return the argument string found.
-		@remark if the argument does not exist then throws exception 0.
+		@remark if the argument does not exist then throws exception 0, or returns the empty string if EP_NO_EXCEPTIONS is defined.
 		*/
 		EpTString GetArgument(const TCHAR *option,size_t idx) const;
 
@@ -179,8 +180,189 @@ namespace epl
 		*/
 		bool isOption(const TCHAR *option) const;
 
+		/*!
+		Find the argument of given option at given index.
+		@param[in] option the option string to get argument
+		@param[in] idx the index of the arguments of given option
+		@param[out] retArg the argument string found.
+		@return true if the argument exists, otherwise false.
+		*/
+		bool findArgument(const TCHAR *option,size_t idx, EpTString &retArg) const;
+
+
+
+	};
+
+	/*! 
+	@class CmdLineView epCmdLineOptions.h
+	@brief A CmdLine Options class, which refers to the argument strings instead of copying them.
+
+	The options are kept in the flat array sorted by their names, and each option refers to its arguments in argv,
+	so the parsing allocates only the array, and the look-up returns the argument string without copying it.
+	FindOption resolves the option to its index once, and the look-ups by the index take the constant time.
+	@remark argv must outlive the view, as the argv of main does.
+	@remark like CmdLineOptions, the first of the same options is kept.
+	*/
+	class EP_LIBRARY CmdLineView
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty CmdLine View
+		*/
+		CmdLineView();
+
+		/*!
+		Default Constructor
+
+		Initializes the CmdLine View parsed from the given arguments
+		@param[in] argc the number of arguments of Command Line
+		@param[in] argv the array of argument strings.
+		*/
+		CmdLineView(int argc, TCHAR **argv);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the CmdLine View with given CmdLine View
+		@param[in] b the CmdLine View Object to copy from
+		*/
+		CmdLineView(const CmdLineView& b);
+
+		/*!
+		Default Destructor
+
+		Destroys the CmdLine View
+		*/
+		virtual ~CmdLineView();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		CmdLineView &operator=(const CmdLineView & b);
+
+		/*!
+		Parse the Command Line Argument with given.
+		@param[in] argc the number of arguments of Command Line
+		@param[in] argv the array of argument strings.
+		@return the number of CmdLine Options parsed
+		*/
+		size_t Parse(int argc, TCHAR **argv);
+
+		/*!
+		Return the number of the options parsed
+		@return the number of the options
+		*/
+		size_t GetOptionCount() const;
+
+		/*!
+		Find the index of the given option
+		@param[in] option the option string to find
+		@return the index of the option, or -1 if not exists
+		*/
+		int FindOption(const TCHAR *option) const;
+
+		/*!
+		Find the indices of the given options at once, such as the option table of the tool
+		@param[in] options the option strings to find
+		@param[in] optionCount the number of the option strings
+		@param[out] retOptionIdxs the indices of the options, or -1 for the option not exists
+		@return the number of the options found
+		*/
+		size_t FindOptions(const TCHAR * const *options, size_t optionCount, int *retOptionIdxs) const;
+
+		/*!
+		Check if CmdLineView contain the given option
+		@param[in] option the option string to check
+		@return true if exists otherwise false
+		*/
+		bool HasOption(const TCHAR *option) const;
+
+		/*!
+		Return the option string at the given index
+		@param[in] optionIdx the index of the option
+		@return the option string
+		*/
+		const TCHAR *GetOption(int optionIdx) const;
+
+		/*!
+		Get argument of given option at given index.
+		@param[in] optionIdx the index of the option found by FindOption
+		@param[in] idx the index of the arguments of given option
+		@param[in] defaultArg the default argument string if not found 
+		@return the argument string found, or given default argument string if not exists.
+		*/
+		const TCHAR *GetArgument(int optionIdx, size_t idx, const TCHAR *defaultArg=NULL) const;
+
+		/*!
+		Get argument of given option at given index.
+		@param[in] option the option string to get argument
+		@param[in] idx the index of the arguments of given option
+		@param[in] defaultArg the default argument string if not found 
+		@return the argument string found, or given default argument string if not exists.
+		*/
+		const TCHAR *GetArgument(const TCHAR *option, size_t idx, const TCHAR *defaultArg=NULL) const;
+
+		/*!
+		Return the arguments of given option
+		@param[in] optionIdx the index of the option found by FindOption
+		@return the first of the arguments in argv, which are as many as GetArgumentCount
+		*/
+		const TCHAR * const *GetArguments(int optionIdx) const;
+
+		/*!
+		Get the number of arguments of given option
+		@param[in] optionIdx the index of the option found by FindOption
+		@return the number of arguments of given option
+		@remark if the option does not exist then return -1
+		*/
+		int GetArgumentCount(int optionIdx) const;
+
+		/*!
+		Get the number of arguments of given option
+		@param[in] option the option string to get the number of arguments
+		@return the number of arguments of given option
+		@remark if the option does not exist then return -1
+		*/
+		int GetArgumentCount(const TCHAR *option) const;
 
+		/*!
+		Check if given argument is an option (starts with '-'), the same as CmdLineOptions without copying the string
+		@param[in] arg the argument string to check
+		@return true if given argument string is an option otherwise false.
+		*/
+		static bool IsOption(const TCHAR *arg);
+
+	private:
+		/*!
+		@struct OptionEntry epCmdLineOptions.h
+		@brief A structure of the option parsed.
+		*/
+		struct OptionEntry
+		{
+			/// the option string in argv
+			const TCHAR *m_option;
+			/// the index of the option in argv, which orders the same options
+			int m_argvIdx;
+			/// the first argument in argv
+			TCHAR **m_args;
+			/// the number of the arguments
+			size_t m_argCount;
+		};
+
+		/*!
+		Compare the given options by their strings, and then by their indices in argv
+		@param[in] a the first option
+		@param[in] b the second option
+		@return true if the first option goes before the second option
+		*/
+		static bool lessOption(const OptionEntry &a, const OptionEntry &b);
 
+		/// the options sorted by their strings
+		vector<OptionEntry> m_options;
 	};
 
 
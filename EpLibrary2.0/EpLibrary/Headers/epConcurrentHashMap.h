@@ -0,0 +1,572 @@
+/*! 
+@file epConcurrentHashMap.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Concurrent Hash Map Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Concurrent Hash Map Template Class with Lock-Free Readers.
+
+*/
+#ifndef __EP_CONCURRENT_HASH_MAP_H__
+#define __EP_CONCURRENT_HASH_MAP_H__
+#include "epLib.h"
+#include "epHashMap.h"
+#include "epEpochReclaimer.h"
+
+/// the default number of stripes of the concurrent hash map
+#define CONCURRENT_HASH_MAP_DEFAULT_STRIPE_COUNT 16
+/// the average number of keys per bucket to trigger the growth of the stripe
+#define CONCURRENT_HASH_MAP_MAX_LOAD 1
+/// the cache line size to keep the stripes apart
+#define CONCURRENT_HASH_MAP_CACHE_LINE_SIZE 64
+
+namespace epl
+{
+	/*! 
+	@class ConcurrentHashMap epConcurrentHashMap.h
+	@brief A Concurrent Hash Map Template class with the lock-free readers.
+
+	The keys are spread over the stripes by the high bits of the hash, and each stripe has its own lock and bucket table.
+	The writers lock only the stripe they change, and never modify the node readers can see except its link.
+	Replacing the data inserts the new node, and the node unlinked is retired to the epoch reclaimer.
+	The stripe grows by building the new table aside and publishing it, so neither the readers nor the other stripes stop.
+	Find, IsExist, Size and IsEmpty take no lock.
+	@remark each thread reading the map must call UnregisterThread before it exits.
+	*/
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *)=HashClass<KeyType>::HashFunc, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)=CompClass<KeyType>::CompFunc>
+	class ConcurrentHashMap
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Concurrent Hash Map
+		@param[in] stripeCount the number of stripes (rounded up to power of two, at most 256)
+		@param[in] capacity the initial number of keys the map can hold without growing
+		@param[in] lockPolicyType The lock policy of each stripe
+		*/
+		ConcurrentHashMap(unsigned int stripeCount=CONCURRENT_HASH_MAP_DEFAULT_STRIPE_COUNT, size_t capacity=HASH_MAP_DEFAULT_CAPACITY, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the Concurrent Hash Map
+		@remark no thread may be reading the map.
+		*/
+		virtual ~ConcurrentHashMap();
+
+		/*!
+		Insert the key with given data to the map
+		@param[in] key The key value to insert.
+		@param[in] data the data with the given key
+		@return true if succeeded otherwise false if the key already exists
+		*/
+		bool Insert(const KeyType &key, const DataType &data);
+
+		/*!
+		Insert the key with given data to the map, or replace the data if the key already exists
+		@param[in] key The key value to set.
+		@param[in] data the data with the given key
+		*/
+		void Set(const KeyType &key, const DataType &data);
+
+		/*!
+		Remove the given key from the map
+		@param[in] key The key value to remove
+		@param[out] retData the data with the key removed (can be NULL)
+		@return true if succeeded otherwise false
+		*/
+		bool Erase(const KeyType &key, DataType *retData=NULL);
+
+		/*!
+		Find the given key from the map and return the data with the given key
+		@param[in] key The key value to find
+		@param[out] retData the data with the given key
+		@return true if succeeded otherwise false
+		*/
+		bool Find(const KeyType &key, DataType &retData) const;
+
+		/*!
+		Check if the given key exists in the map
+		@param[in] key The key value to check
+		@return true if exists otherwise false
+		*/
+		bool IsExist(const KeyType &key) const;
+
+		/*!
+		Clear the map
+		*/
+		void Clear();
+
+		/*!
+		Check if the map is empty
+		@return true if the map is empty otherwise false
+		@remark the result may be outdated as soon as returned.
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		return the number of element in the map.
+		@return the number of element in the map
+		@remark the result may be outdated as soon as returned.
+		*/
+		size_t Size() const;
+
+		/*!
+		return the number of stripes.
+		@return the number of stripes
+		*/
+		unsigned int GetStripeCount() const;
+
+		/*!
+		Give back the reclaimer slot of the calling thread.
+		*/
+		void UnregisterThread();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ConcurrentHashMap(const ConcurrentHashMap & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ConcurrentHashMap &operator=(const ConcurrentHashMap & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		@struct MapNode epConcurrentHashMap.h
+		@brief A structure for the key and data pair, immutable except the link once published.
+		*/
+		struct MapNode
+		{
+			/// the key
+			KeyType m_key;
+			/// the data
+			DataType m_data;
+			/// the hash of the key
+			size_t m_hash;
+			/// the next node in the bucket
+			MapNode * volatile m_next;
+		};
+
+		/*!
+		@struct BucketTable epConcurrentHashMap.h
+		@brief A structure for the bucket table of the stripe.
+		*/
+		struct BucketTable
+		{
+			/// the mask for the bucket index
+			size_t m_mask;
+			/// the buckets
+			MapNode * volatile *m_bucketList;
+		};
+
+		/*!
+		@struct Stripe epConcurrentHashMap.h
+		@brief A structure for the stripe.
+		*/
+		struct Stripe
+		{
+			/// the current bucket table
+			BucketTable * volatile m_table;
+			/// the number of keys in the stripe
+			volatile long m_size;
+			/// stripe lock for the writers
+			BaseLock *m_lock;
+			/// padding to keep the stripes on the different cache lines
+			char m_padding[CONCURRENT_HASH_MAP_CACHE_LINE_SIZE];
+		};
+
+		/*!
+		Return the stripe of the given hash
+		@param[in] hash the hash of the key
+		@return the stripe for the hash
+		*/
+		Stripe &getStripe(size_t hash) const
+		{
+			if(m_stripeBits==0)
+				return m_stripeList[0];
+			return m_stripeList[hash>>(sizeof(size_t)*8-m_stripeBits)];
+		}
+
+		/*!
+		Return the hash of the given key
+		@param[in] key the key to hash
+		@return the hash of the key
+		*/
+		static size_t hashKey(const KeyType &key)
+		{
+			return KeyHashFunc(&key);
+		}
+
+		/*!
+		Create the empty bucket table
+		@param[in] bucketCount the number of buckets (power of two)
+		@return the new bucket table
+		*/
+		static BucketTable *createTable(size_t bucketCount);
+
+		/*!
+		Delete the given bucket table with all its nodes
+		@param[in] ptr the bucket table to delete
+		*/
+		static void reclaimTable(void *ptr);
+
+		/*!
+		Return the link pointing to the node with given key in the given table
+		@param[in] table the bucket table
+		@param[in] key the key to find
+		@param[in] hash the hash of the key
+		@return the link pointing to the node found, or the link at the end of the bucket if not found
+		@remark the calling thread must hold the stripe lock.
+		*/
+		static MapNode * volatile *findLink(BucketTable *table, const KeyType &key, size_t hash);
+
+		/*!
+		Return the node with given key in the given table
+		@param[in] table the bucket table
+		@param[in] key the key to find
+		@param[in] hash the hash of the key
+		@return the node found, or NULL if not found
+		@remark used by the readers, which do not hold the stripe lock.
+		*/
+		static MapNode *findNode(BucketTable *table, const KeyType &key, size_t hash);
+
+		/*!
+		Publish the given pointer to the given link
+		@param[in] link the link to write
+		@param[in] node the node to publish
+		*/
+		static void publish(MapNode * volatile *link, MapNode *node)
+		{
+			InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(link),node);
+		}
+
+		/*!
+		Grow the table of the given stripe if one more key exceeds the maximum load
+		@param[in] stripe the stripe locked by the calling thread
+		*/
+		void growIfNeeded(Stripe &stripe);
+
+		/// the stripes
+		Stripe *m_stripeList;
+		/// the number of the hash bits selecting the stripe
+		unsigned int m_stripeBits;
+		/// the reclaimer for the nodes and tables unlinked
+		EpochReclaimer *m_reclaimer;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::ConcurrentHashMap(unsigned int stripeCount, size_t capacity, LockPolicy lockPolicyType)
+	{
+		m_lockPolicy=lockPolicyType;
+		m_stripeBits=0;
+		while((1U<<m_stripeBits)<stripeCount && m_stripeBits<8)
+			m_stripeBits++;
+		unsigned int actualCount=1U<<m_stripeBits;
+		size_t bucketCount=8;
+		while(bucketCount*actualCount*CONCURRENT_HASH_MAP_MAX_LOAD<capacity)
+			bucketCount*=2;
+		// the readers are concurrent even if the writers are not, so the reclaimer keeps the default lock
+		m_reclaimer=EP_NEW EpochReclaimer(EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT,EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD,EP_LOCK_POLICY);
+		m_stripeList=EP_NEW Stripe[actualCount];
+		for(unsigned int stripeTrav=0;stripeTrav<actualCount;stripeTrav++)
+		{
+			Stripe &stripe=m_stripeList[stripeTrav];
+			stripe.m_table=createTable(bucketCount);
+			stripe.m_size=0;
+			switch(lockPolicyType)
+			{
+			case LOCK_POLICY_CRITICALSECTION:
+				stripe.m_lock=EP_NEW CriticalSectionEx();
+				break;
+			case LOCK_POLICY_MUTEX:
+				stripe.m_lock=EP_NEW Mutex();
+				break;
+			case LOCK_POLICY_NONE:
+				stripe.m_lock=EP_NEW NoLock();
+				break;
+			case LOCK_POLICY_SPIN_PARK:
+				stripe.m_lock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				stripe.m_lock=EP_NEW ReaderWriterLock();
+				break;
+			default:
+				stripe.m_lock=NULL;
+			}
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::~ConcurrentHashMap()
+	{
+		unsigned int stripeCount=1U<<m_stripeBits;
+		for(unsigned int stripeTrav=0;stripeTrav<stripeCount;stripeTrav++)
+		{
+			reclaimTable(m_stripeList[stripeTrav].m_table);
+			if(m_stripeList[stripeTrav].m_lock)
+				EP_DELETE m_stripeList[stripeTrav].m_lock;
+		}
+		EP_DELETE[] m_stripeList;
+		// reclaims the nodes still retired
+		EP_DELETE m_reclaimer;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	typename ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::BucketTable *ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::createTable(size_t bucketCount)
+	{
+		BucketTable *retTable=EP_NEW BucketTable();
+		retTable->m_mask=bucketCount-1;
+		retTable->m_bucketList=EP_NEW MapNode * volatile[bucketCount];
+		for(size_t bucketTrav=0;bucketTrav<bucketCount;bucketTrav++)
+			retTable->m_bucketList[bucketTrav]=NULL;
+		return retTable;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::reclaimTable(void *ptr)
+	{
+		BucketTable *table=static_cast<BucketTable*>(ptr);
+		for(size_t bucketTrav=0;bucketTrav<=table->m_mask;bucketTrav++)
+		{
+			MapNode *node=table->m_bucketList[bucketTrav];
+			while(node)
+			{
+				MapNode *nextNode=node->m_next;
+				EP_DELETE node;
+				node=nextNode;
+			}
+		}
+		EP_DELETE[] table->m_bucketList;
+		EP_DELETE table;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	typename ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::MapNode * volatile *ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::findLink(BucketTable *table, const KeyType &key, size_t hash)
+	{
+		MapNode * volatile *link=&table->m_bucketList[hash&table->m_mask];
+		while(*link)
+		{
+			MapNode *node=*link;
+			if(node->m_hash==hash && KeyCompareFunc(&key,&node->m_key)==COMP_RESULT_EQUAL)
+				break;
+			link=&node->m_next;
+		}
+		return link;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	typename ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::MapNode *ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::findNode(BucketTable *table, const KeyType &key, size_t hash)
+	{
+		// read each link once, since the writer may unlink the node between two reads
+		MapNode *node=table->m_bucketList[hash&table->m_mask];
+		while(node)
+		{
+			if(node->m_hash==hash && KeyCompareFunc(&key,&node->m_key)==COMP_RESULT_EQUAL)
+				return node;
+			node=node->m_next;
+		}
+		return NULL;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::growIfNeeded(Stripe &stripe)
+	{
+		BucketTable *oldTable=stripe.m_table;
+		size_t bucketCount=oldTable->m_mask+1;
+		if(static_cast<size_t>(stripe.m_size)+1<=bucketCount*CONCURRENT_HASH_MAP_MAX_LOAD)
+			return;
+
+		// the readers may be walking the old table, so build the new table with the copies of the nodes
+		BucketTable *newTable=createTable(bucketCount*2);
+		for(size_t bucketTrav=0;bucketTrav<bucketCount;bucketTrav++)
+		{
+			for(MapNode *node=oldTable->m_bucketList[bucketTrav];node;node=node->m_next)
+			{
+				MapNode *newNode=EP_NEW MapNode();
+				newNode->m_key=node->m_key;
+				newNode->m_data=node->m_data;
+				newNode->m_hash=node->m_hash;
+				newNode->m_next=newTable->m_bucketList[node->m_hash&newTable->m_mask];
+				newTable->m_bucketList[node->m_hash&newTable->m_mask]=newNode;
+			}
+		}
+		InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&stripe.m_table),newTable);
+		m_reclaimer->Retire(oldTable,&reclaimTable);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Insert(const KeyType &key, const DataType &data)
+	{
+		size_t hash=hashKey(key);
+		Stripe &stripe=getStripe(hash);
+		LockObj lock(stripe.m_lock);
+		if(*findLink(stripe.m_table,key,hash))
+			return false;
+		growIfNeeded(stripe);
+		MapNode *newNode=EP_NEW MapNode();
+		newNode->m_key=key;
+		newNode->m_data=data;
+		newNode->m_hash=hash;
+		MapNode * volatile *bucket=&stripe.m_table->m_bucketList[hash&stripe.m_table->m_mask];
+		newNode->m_next=*bucket;
+		publish(bucket,newNode);
+		InterlockedIncrement(&stripe.m_size);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Set(const KeyType &key, const DataType &data)
+	{
+		size_t hash=hashKey(key);
+		Stripe &stripe=getStripe(hash);
+		LockObj lock(stripe.m_lock);
+		MapNode * volatile *link=findLink(stripe.m_table,key,hash);
+		MapNode *oldNode=*link;
+		if(!oldNode)
+		{
+			growIfNeeded(stripe);
+			link=&stripe.m_table->m_bucketList[hash&stripe.m_table->m_mask];
+		}
+		MapNode *newNode=EP_NEW MapNode();
+		newNode->m_key=key;
+		newNode->m_data=data;
+		newNode->m_hash=hash;
+		if(oldNode)
+		{
+			// the readers on the old node still see the rest of the bucket through its link
+			newNode->m_next=oldNode->m_next;
+			publish(link,newNode);
+			m_reclaimer->RetireObject(oldNode);
+		}
+		else
+		{
+			newNode->m_next=*link;
+			publish(link,newNode);
+			InterlockedIncrement(&stripe.m_size);
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Erase(const KeyType &key, DataType *retData)
+	{
+		size_t hash=hashKey(key);
+		Stripe &stripe=getStripe(hash);
+		LockObj lock(stripe.m_lock);
+		MapNode * volatile *link=findLink(stripe.m_table,key,hash);
+		MapNode *oldNode=*link;
+		if(!oldNode)
+			return false;
+		if(retData)
+			*retData=oldNode->m_data;
+		publish(link,oldNode->m_next);
+		InterlockedDecrement(&stripe.m_size);
+		m_reclaimer->RetireObject(oldNode);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Find(const KeyType &key, DataType &retData) const
+	{
+		size_t hash=hashKey(key);
+		Stripe &stripe=getStripe(hash);
+		EpochReclaimer::EpochGuard guard(*m_reclaimer);
+		MapNode *node=findNode(stripe.m_table,key,hash);
+		if(!node)
+			return false;
+		retData=node->m_data;
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::IsExist(const KeyType &key) const
+	{
+		size_t hash=hashKey(key);
+		Stripe &stripe=getStripe(hash);
+		EpochReclaimer::EpochGuard guard(*m_reclaimer);
+		return findNode(stripe.m_table,key,hash)!=NULL;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Clear()
+	{
+		unsigned int stripeCount=1U<<m_stripeBits;
+		for(unsigned int stripeTrav=0;stripeTrav<stripeCount;stripeTrav++)
+		{
+			Stripe &stripe=m_stripeList[stripeTrav];
+			LockObj lock(stripe.m_lock);
+			BucketTable *oldTable=stripe.m_table;
+			InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&stripe.m_table),createTable(oldTable->m_mask+1));
+			InterlockedExchange(&stripe.m_size,0);
+			m_reclaimer->Retire(oldTable,&reclaimTable);
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::IsEmpty() const
+	{
+		return Size()==0;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Size() const
+	{
+		size_t retSize=0;
+		unsigned int stripeCount=1U<<m_stripeBits;
+		for(unsigned int stripeTrav=0;stripeTrav<stripeCount;stripeTrav++)
+			retSize+=static_cast<size_t>(m_stripeList[stripeTrav].m_size);
+		return retSize;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	unsigned int ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetStripeCount() const
+	{
+		return 1U<<m_stripeBits;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void ConcurrentHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::UnregisterThread()
+	{
+		m_reclaimer->UnregisterThread();
+	}
+}
+#endif //__EP_CONCURRENT_HASH_MAP_H__
\ No newline at end of file
@@ -39,9 +39,21 @@ An Interface for the Console Processing Operation.
 #define __EP_CONSOLE_HELPER_H__
 #include "epLib.h"
 #include "epSystem.h"
+#include "epBaseJob.h"
+#include <string>
+
+/// the byte size of each buffer reading the output of the console command
+#define CONSOLE_HELPER_OUTPUT_BUFFER_SIZE (64*1024)
+
+/// the interval in milliseconds to check the cancellation while waiting for the output
+#define CONSOLE_HELPER_CANCEL_CHECK_INTERVAL 50
 
 namespace epl
 {
+	class ThreadPool;
+	class JobHandle;
+	class Stream;
+
 	/*! 
 	@class ConsoleHelper epConsoleHelper.h
 	@brief This is a class for Console Processing Class
@@ -77,6 +89,173 @@ namespace epl
 		*/
 		static void ExecuteProgram(const TCHAR *execFilePath, const TCHAR *parameters=NULL);
 	};
+
+	/*!
+	@class ConsoleCallbackInterface epConsoleHelper.h
+	@brief A class for Console Command Callback Interface.
+	*/
+	class EP_LIBRARY ConsoleCallbackInterface
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~ConsoleCallbackInterface(){}
+
+		/*!
+		Received when the console command wrote the output
+		@param[in] command the command executing
+		@param[in] output the output bytes, as written by the process
+		@param[in] outputSize the byte size of the output
+		@remark this is called on the worker thread, while the next output is being read.
+		*/
+		virtual void OnConsoleOutput(const TCHAR *command, const char *output, size_t outputSize)=0;
+
+		/*!
+		Received when the console command is completed
+		@param[in] command the command executed
+		@param[in] exitCode the exit code of the process
+		@param[in] result true if the output is read to the end, false if failed, cancelled or timed out
+		@remark this is called on the worker thread before the completion handle becomes ready.
+		*/
+		virtual void OnConsoleComplete(const TCHAR *command, unsigned long exitCode, bool result)=0;
+	};
+
+	/*!
+	@class ConsoleCommandJob epConsoleHelper.h
+	@brief A class for the job executing the console command on the thread pool.
+
+	The output is read by the overlapped I/O into the two large buffers,
+	so the next output is read while the previous output is handled,
+	and is streamed to the callback object or the stream instead of the string.
+	Each job occupies one worker of the pool until the process exits,
+	so the number of the commands executing at once is the worker count of the pool.
+	*/
+	class EP_LIBRARY ConsoleCommandJob: public BaseJob
+	{
+	public:
+		friend class ConsoleCommandJobProcessor;
+
+		/*!
+		Default Constructor
+
+		Initializes the job
+		@param[in] command the command to execute
+		@param[in] isDosCommand flag whether the command is standard DOS command or not
+		@param[in] callBackObj the callback object to stream the output and report the completion. (NULL to report to the handle only)
+		@param[in] outputStream the stream to write the output. (NULL to keep the output for GetOutput when callBackObj is also NULL)
+		@param[in] priority the priority of the process executing
+		@param[in] lockPolicyType The lock policy
+		*/
+		ConsoleCommandJob(const TCHAR *command, bool isDosCommand=false, ConsoleCallbackInterface *callBackObj=NULL, Stream *outputStream=NULL, ConsolePriority priority=CONSOLE_PRIORITY_NORMAL, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~ConsoleCommandJob();
+
+		/*!
+		Return the command to execute.
+		@return the command to execute.
+		*/
+		const TCHAR *GetCommand() const;
+
+		/*!
+		Return the result of the command.
+		@return true if the output is read to the end, otherwise false.
+		@remark valid only after the completion handle becomes ready.
+		*/
+		bool GetResult() const;
+
+		/*!
+		Return the exit code of the process.
+		@return the exit code of the process.
+		@remark valid only after the completion handle becomes ready.
+		*/
+		unsigned long GetExitCode() const;
+
+		/*!
+		Return the output of the command.
+		@return the output of the command.
+		@remark the output is kept only when neither the callback object nor the stream is given.
+		        valid only after the completion handle becomes ready.
+		*/
+		EpTString GetOutput() const;
+
+		/*!
+		Push this job to the given pool.
+		@param[in] pool the thread pool to execute the command.
+		@return the completion handle of this job.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		        Cancel terminates the process while executing.
+		*/
+		JobHandle *Submit(ThreadPool *pool);
+
+	protected:
+		/*!
+		Execute the command and read its output to the end.
+		@return true if the output is read to the end, otherwise false.
+		@remark this is called on the worker thread.
+		*/
+		virtual bool execute();
+
+		/*!
+		Report the completion to the callback object when the job reaches the final status.
+		@param[in] status The Status of the Job
+		*/
+		virtual void handleReport(const JobStatus status);
+
+	private:
+		/*!
+		Read the output from given pipe until the process closes it.
+		@param[in] hPipeRead the overlapped read end of the output pipe
+		@param[in] hProcess the process writing the output
+		@return true if the output is read to the end, otherwise false.
+		*/
+		bool readOutput(HANDLE hPipeRead, HANDLE hProcess);
+
+		/*!
+		Handle the output read.
+		@param[in] output the output bytes
+		@param[in] outputSize the byte size of the output
+		*/
+		void handleOutput(const char *output, size_t outputSize);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ConsoleCommandJob(const ConsoleCommandJob & b):BaseJob(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ConsoleCommandJob &operator=(const ConsoleCommandJob & b){EP_ASSERT(0);return *this;}
+
+		/// the command to execute
+		EpTString m_command;
+		/// the command line to create the process
+		EpTString m_commandLine;
+		/// the priority of the process
+		ConsolePriority m_priority;
+		/// the callback object
+		ConsoleCallbackInterface *m_callBackObj;
+		/// the stream to write the output
+		Stream *m_outputStream;
+		/// the output kept when no callback object and stream are given
+		std::string m_output;
+		/// the exit code of the process
+		volatile unsigned long m_exitCode;
+		/// the result of the command
+		volatile bool m_result;
+		/// the flag whether the completion is reported
+		volatile long m_isReported;
+	};
 }
 
 
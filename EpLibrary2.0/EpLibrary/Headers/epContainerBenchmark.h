@@ -0,0 +1,108 @@
+/*! 
+@file epContainerBenchmark.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Container Benchmark Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Container and Algorithm Benchmark.
+
+*/
+#ifndef __EP_CONTAINER_BENCHMARK_H__
+#define __EP_CONTAINER_BENCHMARK_H__
+#include "epLib.h"
+#include "epBenchmark.h"
+
+/// the default number of the elements of the largest container measured
+#define CONTAINER_BENCHMARK_MAX_SIZE (256*1024)
+
+namespace epl
+{
+	/*! 
+	@class ContainerBenchmark epContainerBenchmark.h
+	@brief A class for measuring the containers and the algorithms of the library against their standard library equivalents.
+
+	Each case is measured for each size from 1024 elements up to given size, growing by 16 times,
+	and the standard library equivalent is measured with the same data, as the parameter starting with STD.
+	The data is generated by the fixed seed, so the runs are comparable with each other.
+	The containers are measured with LOCK_POLICY_NONE, so the cost of the lock is not included.
+	The results are added to BENCHMARK_INSTANCE, and reported by its Print or FlushToFile.
+	*/
+	class EP_LIBRARY ContainerBenchmark
+	{
+	public:
+		/*!
+		Run all the container and algorithm benchmarks.
+		@param[in] maxSize the number of the elements of the largest container to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void Run(size_t maxSize=CONTAINER_BENCHMARK_MAX_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks of KAryHeap for k of 2, 4, 5 and 8 against std::priority_queue and std::map.
+		@param[in] maxSize the number of the elements of the largest heap to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the HeapHold case pops the minimum and pushes a larger key per operation, so the heap size stays the same.
+		@remark the HeapChangeKey case raises the key of a random element per operation in KARY_HEAP_MODE_INDEXED.
+		*/
+		static void RunKAryHeap(size_t maxSize=CONTAINER_BENCHMARK_MAX_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks of PatriciaTrie inserting, finding and finding with the prefix, against std::map.
+		@param[in] maxSize the number of the strings of the largest trie to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the strings are the words of the English letter frequency, and the paths sharing the long prefixes.
+		*/
+		static void RunPatriciaTrie(size_t maxSize=CONTAINER_BENCHMARK_MAX_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks of DynamicArray appending and accessing, against std::vector.
+		@param[in] maxSize the number of the elements of the largest array to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunDynamicArray(size_t maxSize=CONTAINER_BENCHMARK_MAX_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks of QuickSort and MergeSort for each mode on the random and the sorted lists, against std::sort and std::stable_sort.
+		@param[in] maxSize the number of the elements of the largest list to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark one operation sorts the whole list, including copying the unsorted list in.
+		*/
+		static void RunSort(size_t maxSize=CONTAINER_BENCHMARK_MAX_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks of BinarySearch, LowerBound and EytzingerSearch, against std::lower_bound.
+		@param[in] maxSize the number of the elements of the largest list to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunSearch(size_t maxSize=CONTAINER_BENCHMARK_MAX_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+	};
+}
+#endif //__EP_CONTAINER_BENCHMARK_H__
@@ -0,0 +1,521 @@
+/*! 
+@file epCoroutineScheduler.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Coroutine Scheduler Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Coroutine Scheduler, which runs the coroutines on the pooled fibers of the worker threads.
+
+*/
+#ifndef __EP_COROUTINE_SCHEDULER_H__
+#define __EP_COROUTINE_SCHEDULER_H__
+#include "epLib.h"
+#include <vector>
+#include <deque>
+#include "epSystem.h"
+#include "epSmartObject.h"
+#include "epThread.h"
+#include "epEventEx.h"
+#include "epLightSemaphore.h"
+#include "epJobHandle.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+/// The default stack size of the pooled fiber in bytes
+#define COROUTINE_SCHEDULER_DEFAULT_STACK_SIZE (64*1024)
+
+/// The default maximum number of the idle fibers kept in the pool
+#define COROUTINE_SCHEDULER_DEFAULT_MAX_POOLED_FIBER_COUNT 1024
+
+namespace epl
+{
+	class CoroutineScheduler;
+	class CoroutineWorker;
+	class CoroutineEvent;
+
+	/// Enumeration of the coroutine status
+	typedef enum _coroutineStatus{
+		/// not spawned yet
+		COROUTINE_STATUS_NONE=0,
+		/// waiting to be run by the worker
+		COROUTINE_STATUS_READY,
+		/// running on the worker
+		COROUTINE_STATUS_RUNNING,
+		/// waiting for the event
+		COROUTINE_STATUS_WAITING,
+		/// finished the execution
+		COROUTINE_STATUS_DONE,
+	}CoroutineStatus;
+
+	/*!
+	@class BaseCoroutine epCoroutineScheduler.h
+	@brief A base class for the coroutine run by CoroutineScheduler.
+
+	Unlike Coroutine, the coroutine does not own the fiber.
+	The scheduler runs it on the fiber taken from the pool, and puts the fiber back when finished,
+	so the stack is reused by the next coroutine.
+	The coroutine stays on the worker which it is spawned to, and pauses by YieldExecution, AwaitJob or CoroutineEvent::Wait
+	without blocking the worker thread. MoveTo resumes it on the worker of the other scheduler.
+	@remark the coroutine may also pause within the Coroutine which it drives,
+	        since it is resumed on the fiber which paused rather than the fiber which it started on.
+	*/
+	class EP_LIBRARY BaseCoroutine:public SmartObject
+	{
+	public:
+		friend class CoroutineScheduler;
+		friend class CoroutineWorker;
+		friend class CoroutineEvent;
+
+		/*!
+		Default Constructor
+
+		Initializes the coroutine
+		@param[in] lockPolicyType The lock policy
+		*/
+		BaseCoroutine(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the coroutine
+		*/
+		virtual ~BaseCoroutine();
+
+		/*!
+		Return the status of the coroutine
+		@return the status of the coroutine
+		*/
+		CoroutineStatus GetStatus() const;
+
+		/*!
+		Wait for the coroutine to finish
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if finished, otherwise false.
+		@remark this blocks the calling thread, so it must not be called within the coroutine of the same worker.
+		*/
+		bool WaitFor(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Return the coroutine running on the calling thread
+		@return the coroutine running, or NULL if not called within the coroutine
+		*/
+		static BaseCoroutine *GetCurrent();
+
+		/*!
+		Pause the coroutine and let the other coroutines of the worker run
+		@remark the coroutine is resumed after the coroutines already ready.
+		*/
+		void YieldExecution();
+
+		/*!
+		Pause the coroutine until the given job is completed
+		@param[in] handle the completion handle of the job, such as the one returned by Submit
+		@return the final status of the job
+		@remark if not called within the coroutine itself, this blocks the calling thread as JobHandle::Wait.
+		*/
+		BaseJob::JobStatus AwaitJob(JobHandle *handle);
+
+		/*!
+		Pause the coroutine and resume it on one of the workers of the given scheduler
+		@param[in] scheduler the scheduler to resume on
+		@return true if resumed on the given scheduler, false if not started or not called within the coroutine itself.
+		@remark the fiber is put back to the pool of the scheduler which created it, so that scheduler must outlive the coroutine.
+		*/
+		bool MoveTo(CoroutineScheduler *scheduler);
+
+	protected:
+		/*!
+		User defined coroutine function
+		@remark Subclass should override this function to create the coroutine
+		*/
+		virtual void execute()=0;
+
+	private:
+		/*!
+		Switch back to the worker until resumed
+		*/
+		void suspend();
+
+		/*!
+		Put the coroutine back to the ready queue of its worker
+		*/
+		void resume();
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		BaseCoroutine(const BaseCoroutine & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BaseCoroutine &operator=(const BaseCoroutine & b){EP_ASSERT(0);return *this;}
+
+		/// the worker which runs the coroutine
+		CoroutineWorker *m_worker;
+		/// the fiber taken from the pool, or NULL if not started yet
+		LPVOID m_fiber;
+		/// the scheduler whose pool the fiber is taken from
+		CoroutineScheduler *m_fiberOwner;
+		/// the fiber which paused, or NULL to resume on m_fiber
+		LPVOID m_resumeFiber;
+		/// the status of the coroutine
+		volatile CoroutineStatus m_status;
+		/// the index in the coroutine list of the scheduler
+		size_t m_listIdx;
+		/// the event raised when finished
+		EventEx m_doneEvent;
+	};
+
+	/*!
+	@class CoroutineEvent epCoroutineScheduler.h
+	@brief A class for the event which the coroutine waits for without blocking the worker thread.
+
+	The event can be set from any thread, such as the callback of the IPC completion,
+	and resumes the waiting coroutines on their workers.
+	*/
+	class EP_LIBRARY CoroutineEvent
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the event
+		@param[in] isInitialRaised the flag whether the event is raised at first
+		@param[in] isManualReset the flag whether the event stays raised until ResetEvent, otherwise one waiter is resumed per SetEvent
+		@param[in] lockPolicyType The lock policy
+		*/
+		CoroutineEvent(bool isInitialRaised=false, bool isManualReset=false, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the event
+		*/
+		virtual ~CoroutineEvent();
+
+		/*!
+		Raise the event and resume the waiting coroutines
+		*/
+		void SetEvent();
+
+		/*!
+		Reset the event
+		*/
+		void ResetEvent();
+
+		/*!
+		Pause the calling coroutine until the event is raised
+		@return true if the event is raised, or false if not called within the coroutine
+		*/
+		bool Wait();
+
+		/*!
+		Return the number of the coroutines waiting
+		@return the number of the coroutines waiting
+		*/
+		size_t GetWaitingCount() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		CoroutineEvent(const CoroutineEvent & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		CoroutineEvent &operator=(const CoroutineEvent & b){EP_ASSERT(0);return *this;}
+
+		/// the flag whether the event is raised
+		bool m_isRaised;
+		/// the flag whether the event is reset manually
+		bool m_isManualReset;
+		/// the coroutines waiting
+		std::deque<BaseCoroutine*> m_waitingList;
+		/// lock
+		BaseLock *m_lock;
+	};
+
+	/*!
+	@class CoroutineWorker epCoroutineScheduler.h
+	@brief A class that implements the worker thread owned by CoroutineScheduler.
+
+	The worker converts itself to the fiber, and switches to the fibers of its ready coroutines in turn.
+	*/
+	class EP_LIBRARY CoroutineWorker:public Thread
+	{
+	public:
+		friend class CoroutineScheduler;
+		friend class BaseCoroutine;
+
+		/*!
+		Default Constructor
+
+		Initializes the worker thread
+		@param[in] owner the scheduler which owns this worker.
+		@param[in] lockPolicyType The lock policy
+		*/
+		CoroutineWorker(CoroutineScheduler *owner, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the worker thread
+		*/
+		virtual ~CoroutineWorker();
+
+		/*!
+		Return the number of the coroutines ready to run
+		@return the number of the coroutines ready
+		*/
+		size_t GetReadyCount() const;
+
+	protected:
+		/*!
+		Actual coroutine worker Thread Code.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Put the coroutine into the ready queue
+		@param[in] coroutine the coroutine ready, or NULL to stop the worker
+		*/
+		void pushReady(BaseCoroutine *coroutine);
+
+		/*!
+		The function of the pooled fiber, which runs the coroutines assigned to it one after another.
+		@param[in] param unused
+		*/
+		static void __stdcall fiberFunc(LPVOID param);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		CoroutineWorker(const CoroutineWorker & b):Thread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		CoroutineWorker &operator=(const CoroutineWorker & b){EP_ASSERT(0);return *this;}
+
+		/// the owner of this worker
+		CoroutineScheduler *m_owner;
+		/// the fiber of the worker thread itself
+		LPVOID m_mainFiber;
+		/// the coroutine running
+		BaseCoroutine *m_current;
+		/// the coroutine to put into the ready queue of its new worker after it paused
+		BaseCoroutine *m_movingCoroutine;
+		/// the coroutines ready to run
+		std::deque<BaseCoroutine*> m_readyQueue;
+		/// the signal counting the coroutines ready
+		LightSemaphore m_readySignal;
+		/// ready queue lock
+		BaseLock *m_readyLock;
+	};
+
+	/*!
+	@class CoroutineScheduler epCoroutineScheduler.h
+	@brief A class that runs many coroutines on a few worker threads.
+
+	The coroutines spawned are distributed to the workers in turn.
+	The fibers are created with the given stack size and kept in the pool when their coroutines finish,
+	so thousands of coroutines, such as one per connection, run with the bounded number of the small stacks.
+	*/
+	class EP_LIBRARY CoroutineScheduler
+	{
+	public:
+		friend class CoroutineWorker;
+		friend class BaseCoroutine;
+
+		/*!
+		Default Constructor
+
+		Initializes the scheduler
+		@param[in] workerCount the number of the worker threads. (0 means System::GetNumberOfCores())
+		@param[in] stackSize the stack size of the fiber in bytes.
+		@param[in] maxPooledFiberCount the maximum number of the idle fibers kept in the pool.
+		@param[in] lockPolicyType The lock policy
+		*/
+		CoroutineScheduler(unsigned int workerCount=0, size_t stackSize=COROUTINE_SCHEDULER_DEFAULT_STACK_SIZE, size_t maxPooledFiberCount=COROUTINE_SCHEDULER_DEFAULT_MAX_POOLED_FIBER_COUNT, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Stop the workers and destroy the scheduler
+		*/
+		virtual ~CoroutineScheduler();
+
+		/*!
+		Start the worker threads.
+		@return true if successfully started, otherwise false.
+		*/
+		bool Start();
+
+		/*!
+		Stop the worker threads after the coroutines already ready.
+		@remark the coroutines not finished are released without being resumed, and their stacks are not unwound.
+		@remark the events which the unfinished coroutines wait for must not be set after stopped.
+		*/
+		void Stop();
+
+		/*!
+		Spawn the coroutine to one of the workers.
+		@param[in] coroutine the coroutine to run.
+		@return true if spawned, false if not started or the coroutine is spawned already.
+		@remark the scheduler retains the coroutine until it finishes.
+		*/
+		bool Spawn(BaseCoroutine *coroutine);
+
+		/*!
+		Return the number of the worker threads.
+		@return the number of the worker threads.
+		*/
+		unsigned int GetWorkerCount() const;
+
+		/*!
+		Return the stack size of the fiber.
+		@return the stack size of the fiber in bytes.
+		*/
+		size_t GetStackSize() const;
+
+		/*!
+		Return the number of the coroutines spawned and not finished.
+		@return the number of the coroutines not finished.
+		*/
+		size_t GetCoroutineCount() const;
+
+		/*!
+		Return the number of the idle fibers in the pool.
+		@return the number of the idle fibers.
+		*/
+		size_t GetPooledFiberCount() const;
+
+	private:
+		/*!
+		Take the fiber from the pool, or create the new fiber if the pool is empty.
+		@return the fiber, or NULL if failed to create.
+		*/
+		LPVOID acquireFiber();
+
+		/*!
+		Put the fiber back to the pool, or delete it if the pool is full.
+		@param[in] fiber the fiber which finished its coroutine.
+		*/
+		void releaseFiber(LPVOID fiber);
+
+		/*!
+		Remove the finished coroutine from the scheduler.
+		@param[in] coroutine the coroutine finished.
+		*/
+		void onCoroutineDone(BaseCoroutine *coroutine);
+
+		/*!
+		Add the coroutine to the scheduler, and assign it to one of the workers.
+		@param[in] coroutine the coroutine to add.
+		@return true if added, false if not started.
+		*/
+		bool addCoroutine(BaseCoroutine *coroutine);
+
+		/*!
+		Remove the coroutine from the scheduler.
+		@param[in] coroutine the coroutine to remove.
+		*/
+		void removeCoroutine(BaseCoroutine *coroutine);
+
+		/*!
+		Delete the idle fibers in the pool.
+		*/
+		void clearFiberPool();
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		CoroutineScheduler(const CoroutineScheduler & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		CoroutineScheduler &operator=(const CoroutineScheduler & b){EP_ASSERT(0);return *this;}
+
+		/// the workers
+		std::vector<CoroutineWorker*> m_workerList;
+		/// the coroutines spawned and not finished
+		std::vector<BaseCoroutine*> m_coroutineList;
+		/// the idle fibers
+		std::vector<LPVOID> m_fiberPool;
+		/// the stack size of the fiber
+		size_t m_stackSize;
+		/// the maximum number of the idle fibers
+		size_t m_maxPooledFiberCount;
+		/// the counter to distribute the coroutines to the workers
+		volatile long m_spawnCount;
+		/// the flag whether started
+		bool m_isStarted;
+		/// scheduler lock
+		BaseLock *m_lock;
+		/// fiber pool lock
+		BaseLock *m_fiberLock;
+		/// lock policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_COROUTINE_SCHEDULER_H__
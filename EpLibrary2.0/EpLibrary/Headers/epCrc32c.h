@@ -0,0 +1,72 @@
+/*! 
+@file epCrc32c.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief CRC32C Checksum Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+This is a class for computing the CRC32C (Castagnoli) checksum of the data.
+
+*/
+#ifndef __EP_CRC32C_H__
+#define __EP_CRC32C_H__
+#include "epLib.h"
+
+namespace epl
+{
+	/*!
+	@class Crc32c epCrc32c.h
+	@brief A class for computing the CRC32C (Castagnoli) checksum.
+
+	The checksum is computed with the SSE4.2 CRC32 instruction when the processor supports it,
+	otherwise with the slicing-by-8 tables.
+	*/
+	class EP_LIBRARY Crc32c
+	{
+	public:
+		/*!
+		Compute the checksum of the data.
+		@param[in] data the data to compute the checksum of.
+		@param[in] byteSize the byte size of the data.
+		@param[in] crc the checksum of the preceding data to extend. (0 to start a new checksum)
+		@return the checksum of the preceding data followed by the data.
+		@remark Compute(b,bSize,Compute(a,aSize)) is the same as the checksum of a followed by b.
+		*/
+		static unsigned int Compute(const void *data, size_t byteSize, unsigned int crc=0);
+
+		/*!
+		Return the flag whether the checksum is computed with the hardware instruction.
+		@return true if the hardware instruction is used, otherwise false.
+		*/
+		static bool IsHardwareAccelerated();
+	};
+}
+
+#endif //__EP_CRC32C_H__
\ No newline at end of file
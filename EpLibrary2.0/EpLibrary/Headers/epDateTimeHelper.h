@@ -40,6 +40,12 @@ An Interface for the DateTime Operation.
 #include "epLib.h"
 #include "epSystem.h"
 
+/// the maximum length of the timestamp formatted by TimestampFormatter including the null character
+#define TIMESTAMP_MAX_LENGTH 32
+
+/// the maximum number of the sub-second digits of TimestampFormatter
+#define TIMESTAMP_MAX_SUB_SECOND_DIGITS 7
+
 namespace epl 
 {
 	/*! 
@@ -358,6 +364,102 @@ namespace epl
 		static __int64 InSec(const SYSTEMTIME &systemTime);
 
 	};
+
+	/// Enumerator for the Layout of the Timestamp
+	typedef enum _timestampLayout{
+		/// MM/DD/YY HH:MM:SS
+		TIMESTAMP_LAYOUT_SHORT=0,
+		/// MM/DD/YYYY, HH:MM:SS
+		TIMESTAMP_LAYOUT_LONG,
+		/// YYYY-MM-DD HH:MM:SS
+		TIMESTAMP_LAYOUT_ISO8601,
+	}TimestampLayout;
+
+	/*! 
+	@class TimestampFormatter epDateTimeHelper.h
+	@brief A class that formats the timestamps, caching the part up to the second.
+
+	The date and the time up to the second are formatted only when the second changes,
+	and otherwise only the sub-second digits are rewritten.
+	Formatting the UTC FILETIME converts it to the local time only when the second changes as well.
+	@remark The formatter is not thread-safe, so each thread or lock needs its own.
+	*/
+	class EP_LIBRARY TimestampFormatter
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] layout the layout of the date and the time.
+		@param[in] subSecondDigits the number of the sub-second digits. (0 to TIMESTAMP_MAX_SUB_SECOND_DIGITS)
+		*/
+		TimestampFormatter(TimestampLayout layout=TIMESTAMP_LAYOUT_SHORT, unsigned int subSecondDigits=0);
+
+		/*!
+		Format the given local time.
+		@param[in] localTime the local time to format.
+		@return the formatted timestamp, which is valid until the next call.
+		*/
+		const TCHAR *Format(const SYSTEMTIME &localTime);
+
+		/*!
+		Format the given UTC file time in the local time.
+		@param[in] fileTime the UTC file time to format.
+		@return the formatted timestamp, which is valid until the next call.
+		*/
+		const TCHAR *Format(const FILETIME &fileTime);
+
+		/*!
+		Return the last formatted timestamp.
+		@return the last formatted timestamp.
+		*/
+		const TCHAR *GetString() const;
+
+		/*!
+		Return the length of the last formatted timestamp.
+		@return the length of the last formatted timestamp.
+		*/
+		size_t GetLength() const;
+
+		/*!
+		Return the layout of the date and the time.
+		@return the layout of the date and the time.
+		*/
+		TimestampLayout GetLayout() const;
+
+		/*!
+		Return the number of the sub-second digits.
+		@return the number of the sub-second digits.
+		*/
+		unsigned int GetSubSecondDigits() const;
+
+	private:
+		/*!
+		Format the date and the time up to the second.
+		@param[in] localTime the local time to format.
+		*/
+		void formatPrefix(const SYSTEMTIME &localTime);
+
+		/*!
+		Rewrite the sub-second digits after the cached prefix.
+		@param[in] subSecond the time in 100-nano second within the second.
+		*/
+		void formatSubSecond(unsigned int subSecond);
+
+		/// the formatted timestamp
+		TCHAR m_string[TIMESTAMP_MAX_LENGTH];
+		/// the length of the date and the time up to the second
+		size_t m_prefixLength;
+		/// the length of the formatted timestamp
+		size_t m_length;
+		/// the layout of the date and the time
+		TimestampLayout m_layout;
+		/// the number of the sub-second digits
+		unsigned int m_subSecondDigits;
+		/// the UTC second of the cached prefix formatted from FILETIME, or -1
+		__int64 m_cachedSecond;
+		/// the local time of the cached prefix formatted from SYSTEMTIME, whose year is 0 if not cached
+		SYSTEMTIME m_cachedTime;
+	};
 }
 
 
@@ -39,24 +39,780 @@ An Interface for C# Style Delegate Class.
 #define __EP_DELEGATE_H__
 #include "epLib.h"
 #include "epSystem.h"
+#include "epMemory.h"
 #include <vector>
+#include <new>
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+/// the size of the storage for the member function pointer of the delegate target
+#define DELEGATE_TARGET_STORAGE_SIZE (sizeof(void*)*4)
 
 using namespace std;
 
-namespace epl
-{
+namespace epl
+{
+	/*! 
+	@class DelegateTarget epDelegate.h
+	@brief A class for the target of the delegate, which is the function, the member function or the functor.
+
+	The target only keeps the pointers, so neither the object nor the functor is copied or owned.
+	@remark the object or the functor must outlive the delegate holding the target.
+	*/
+	template<typename RetType,typename ArgType=void>
+	class DelegateTarget{
+	public:
+		/// Function Pointer Type Definition
+		typedef RetType (*FuncType) (ArgType);
+
+		/*!
+		Default Constructor
+
+		Initializes the empty target
+		*/
+		DelegateTarget()
+		{
+			initialize(NULL,NULL,NULL);
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given function pointer
+		@param[in] func the function pointer
+		*/
+		DelegateTarget(RetType (*func)(ArgType))
+		{
+			initialize(&invokeFunction,func,NULL);
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given member function of the given object
+		@param[in] object the object to call the member function on
+		@param[in] method the member function pointer
+		*/
+		template<typename ClassType>
+		DelegateTarget(ClassType *object,RetType (ClassType::*method)(ArgType))
+		{
+			typedef RetType (ClassType::*MethodType)(ArgType);
+			typedef char MethodSizeCheck[sizeof(MethodType)<=DELEGATE_TARGET_STORAGE_SIZE?1:-1];
+			initialize(&invokeMethod<ClassType,MethodType>,NULL,object);
+			memcpy(m_storage,&method,sizeof(MethodType));
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given const member function of the given object
+		@param[in] object the object to call the member function on
+		@param[in] method the const member function pointer
+		*/
+		template<typename ClassType>
+		DelegateTarget(const ClassType *object,RetType (ClassType::*method)(ArgType) const)
+		{
+			typedef RetType (ClassType::*MethodType)(ArgType) const;
+			typedef char MethodSizeCheck[sizeof(MethodType)<=DELEGATE_TARGET_STORAGE_SIZE?1:-1];
+			initialize(&invokeMethod<const ClassType,MethodType>,NULL,const_cast<ClassType*>(object));
+			memcpy(m_storage,&method,sizeof(MethodType));
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given functor
+		@param[in] functor the functor to call
+		*/
+		template<typename FunctorType>
+		DelegateTarget(FunctorType *functor)
+		{
+			initialize(&invokeFunctor<FunctorType>,NULL,const_cast<void*>(static_cast<const void*>(functor)));
+		}
+
+		/*!
+		Check if the target is empty.
+		@return true if the target is empty, otherwise false.
+		*/
+		bool IsEmpty() const
+		{
+			return m_invoker==NULL;
+		}
+
+		/*!
+		Return the function pointer of the target.
+		@return the function pointer, or NULL if the target is not the function.
+		*/
+		FuncType GetFunction() const
+		{
+			return m_func;
+		}
+
+		/*!
+		Check if the target is same as the given target.
+		@param[in] b the target to compare
+		@return true if same, otherwise false.
+		*/
+		bool operator ==(const DelegateTarget<RetType,ArgType> &b) const
+		{
+			return m_invoker==b.m_invoker && m_func==b.m_func && m_object==b.m_object && memcmp(m_storage,b.m_storage,DELEGATE_TARGET_STORAGE_SIZE)==0;
+		}
+
+		/*!
+		Check if the target is different from the given target.
+		@param[in] b the target to compare
+		@return true if different, otherwise false.
+		*/
+		bool operator !=(const DelegateTarget<RetType,ArgType> &b) const
+		{
+			return !(*this==b);
+		}
+
+		/*!
+		Call the target with the argument given
+		@param[in] arg the argument of the target
+		@return the return value of the target
+		*/
+		RetType operator ()(ArgType arg) const
+		{
+			EP_ASSERT(m_invoker);
+			return m_invoker(*this,arg);
+		}
+
+	private:
+		/// Invoker Type Definition
+		typedef RetType (*InvokerType) (const DelegateTarget<RetType,ArgType> &,ArgType);
+
+		/*!
+		Initialize the target.
+		@param[in] invoker the invoker of the target
+		@param[in] func the function pointer
+		@param[in] object the object or the functor
+		*/
+		void initialize(InvokerType invoker,FuncType func,void *object)
+		{
+			m_invoker=invoker;
+			m_func=func;
+			m_object=object;
+			// the unused bytes are compared as well
+			memset(m_storage,0,DELEGATE_TARGET_STORAGE_SIZE);
+		}
+
+		/*!
+		Call the function of the given target.
+		@param[in] target the target to call
+		@param[in] arg the argument of the target
+		@return the return value of the target
+		*/
+		static RetType invokeFunction(const DelegateTarget<RetType,ArgType> &target,ArgType arg)
+		{
+			return target.m_func(arg);
+		}
+
+		/*!
+		Call the member function of the given target.
+		@param[in] target the target to call
+		@param[in] arg the argument of the target
+		@return the return value of the target
+		*/
+		template<typename ClassType,typename MethodType>
+		static RetType invokeMethod(const DelegateTarget<RetType,ArgType> &target,ArgType arg)
+		{
+			MethodType method;
+			memcpy(&method,target.m_storage,sizeof(MethodType));
+			return (static_cast<ClassType*>(target.m_object)->*method)(arg);
+		}
+
+		/*!
+		Call the functor of the given target.
+		@param[in] target the target to call
+		@param[in] arg the argument of the target
+		@return the return value of the target
+		*/
+		template<typename FunctorType>
+		static RetType invokeFunctor(const DelegateTarget<RetType,ArgType> &target,ArgType arg)
+		{
+			return (*static_cast<FunctorType*>(target.m_object))(arg);
+		}
+
+		/// the invoker
+		InvokerType m_invoker;
+		/// the function pointer
+		FuncType m_func;
+		/// the object or the functor
+		void *m_object;
+		/// the storage for the member function pointer
+		char m_storage[DELEGATE_TARGET_STORAGE_SIZE];
+	};
+
+	/*! 
+	@class DelegateTarget epDelegate.h
+	@brief A partial specialization class for the target of the delegate with void argument.
+	@remark the object or the functor must outlive the delegate holding the target.
+	*/
+	template<typename RetType>
+	class DelegateTarget<RetType,void>{
+	public:
+		/// Function Pointer Type Definition
+		typedef RetType (*FuncType) (void);
+
+		/*!
+		Default Constructor
+
+		Initializes the empty target
+		*/
+		DelegateTarget()
+		{
+			initialize(NULL,NULL,NULL);
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given function pointer
+		@param[in] func the function pointer
+		*/
+		DelegateTarget(RetType (*func)(void))
+		{
+			initialize(&invokeFunction,func,NULL);
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given member function of the given object
+		@param[in] object the object to call the member function on
+		@param[in] method the member function pointer
+		*/
+		template<typename ClassType>
+		DelegateTarget(ClassType *object,RetType (ClassType::*method)(void))
+		{
+			typedef RetType (ClassType::*MethodType)(void);
+			typedef char MethodSizeCheck[sizeof(MethodType)<=DELEGATE_TARGET_STORAGE_SIZE?1:-1];
+			initialize(&invokeMethod<ClassType,MethodType>,NULL,object);
+			memcpy(m_storage,&method,sizeof(MethodType));
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given const member function of the given object
+		@param[in] object the object to call the member function on
+		@param[in] method the const member function pointer
+		*/
+		template<typename ClassType>
+		DelegateTarget(const ClassType *object,RetType (ClassType::*method)(void) const)
+		{
+			typedef RetType (ClassType::*MethodType)(void) const;
+			typedef char MethodSizeCheck[sizeof(MethodType)<=DELEGATE_TARGET_STORAGE_SIZE?1:-1];
+			initialize(&invokeMethod<const ClassType,MethodType>,NULL,const_cast<ClassType*>(object));
+			memcpy(m_storage,&method,sizeof(MethodType));
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the target with given functor
+		@param[in] functor the functor to call
+		*/
+		template<typename FunctorType>
+		DelegateTarget(FunctorType *functor)
+		{
+			initialize(&invokeFunctor<FunctorType>,NULL,const_cast<void*>(static_cast<const void*>(functor)));
+		}
+
+		/*!
+		Check if the target is empty.
+		@return true if the target is empty, otherwise false.
+		*/
+		bool IsEmpty() const
+		{
+			return m_invoker==NULL;
+		}
+
+		/*!
+		Return the function pointer of the target.
+		@return the function pointer, or NULL if the target is not the function.
+		*/
+		FuncType GetFunction() const
+		{
+			return m_func;
+		}
+
+		/*!
+		Check if the target is same as the given target.
+		@param[in] b the target to compare
+		@return true if same, otherwise false.
+		*/
+		bool operator ==(const DelegateTarget<RetType,void> &b) const
+		{
+			return m_invoker==b.m_invoker && m_func==b.m_func && m_object==b.m_object && memcmp(m_storage,b.m_storage,DELEGATE_TARGET_STORAGE_SIZE)==0;
+		}
+
+		/*!
+		Check if the target is different from the given target.
+		@param[in] b the target to compare
+		@return true if different, otherwise false.
+		*/
+		bool operator !=(const DelegateTarget<RetType,void> &b) const
+		{
+			return !(*this==b);
+		}
+
+		/*!
+		Call the target
+		@return the return value of the target
+		*/
+		RetType operator ()() const
+		{
+			EP_ASSERT(m_invoker);
+			return m_invoker(*this);
+		}
+
+	private:
+		/// Invoker Type Definition
+		typedef RetType (*InvokerType) (const DelegateTarget<RetType,void> &);
+
+		/*!
+		Initialize the target.
+		@param[in] invoker the invoker of the target
+		@param[in] func the function pointer
+		@param[in] object the object or the functor
+		*/
+		void initialize(InvokerType invoker,FuncType func,void *object)
+		{
+			m_invoker=invoker;
+			m_func=func;
+			m_object=object;
+			// the unused bytes are compared as well
+			memset(m_storage,0,DELEGATE_TARGET_STORAGE_SIZE);
+		}
+
+		/*!
+		Call the function of the given target.
+		@param[in] target the target to call
+		@return the return value of the target
+		*/
+		static RetType invokeFunction(const DelegateTarget<RetType,void> &target)
+		{
+			return target.m_func();
+		}
+
+		/*!
+		Call the member function of the given target.
+		@param[in] target the target to call
+		@return the return value of the target
+		*/
+		template<typename ClassType,typename MethodType>
+		static RetType invokeMethod(const DelegateTarget<RetType,void> &target)
+		{
+			MethodType method;
+			memcpy(&method,target.m_storage,sizeof(MethodType));
+			return (static_cast<ClassType*>(target.m_object)->*method)();
+		}
+
+		/*!
+		Call the functor of the given target.
+		@param[in] target the target to call
+		@return the return value of the target
+		*/
+		template<typename FunctorType>
+		static RetType invokeFunctor(const DelegateTarget<RetType,void> &target)
+		{
+			return (*static_cast<FunctorType*>(target.m_object))();
+		}
+
+		/// the invoker
+		InvokerType m_invoker;
+		/// the function pointer
+		FuncType m_func;
+		/// the object or the functor
+		void *m_object;
+		/// the storage for the member function pointer
+		char m_storage[DELEGATE_TARGET_STORAGE_SIZE];
+	};
+
+	/*! 
+	@class BaseDelegate epDelegate.h
+	@brief A base class for the copy-on-write invocation list of the delegate.
+
+	The invocation list is immutable once published, and each list keeps its targets inline in a single block.
+	The writers build the new list under the lock and swap it in, while the invocation only pins the current list,
+	so the invocation takes neither the lock nor the allocation.
+	The list stays alive until the last invocation holding it is done, 
+	so the target may change the delegate while being called.
+	*/
+	template<typename TargetType>
+	class BaseDelegate{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the delegate
+		@param[in] lockPolicyType The lock policy
+		*/
+		BaseDelegate(LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		{
+			m_list=NULL;
+			m_pinCount=0;
+			m_lockPolicy=lockPolicyType;
+			m_delegateLock=createLock(lockPolicyType);
+		}
+
+		/*!
+		Copy Constructor
+
+		Initializes the delegate with given delegate
+		@param[in] orig the delegate
+		*/
+		BaseDelegate(const BaseDelegate<TargetType> &orig)
+		{
+			m_pinCount=0;
+			m_lockPolicy=orig.m_lockPolicy;
+			m_delegateLock=createLock(m_lockPolicy);
+			// the list is immutable, so it is shared
+			m_list=orig.acquireList();
+		}
+
+		/*!
+		Default Destructor
+
+		Destroy the delegate
+		*/
+		virtual ~BaseDelegate()
+		{
+			releaseList(m_list);
+			if(m_delegateLock)
+				EP_DELETE m_delegateLock;
+		}
+
+		/*!
+		Assignment Operator Overloading
+
+		the Delegate set as given delegate b
+		@param[in] b right side of delegate
+		@return this object
+		*/
+		BaseDelegate<TargetType> & operator=(const BaseDelegate<TargetType>&b)
+		{
+			if(this!=&b)
+			{
+				LockObj lock(m_delegateLock);
+				publishList(b.acquireList());
+			}
+			return *this;
+		}
+
+		/*!
+		Check if the delegate is empty.
+		@return true if the delegate is empty, otherwise false.
+		*/
+		bool IsEmpty() const
+		{
+			return Size()==0;
+		}
+
+		/*!
+		Return the size of the delegate.
+		@return the size of the delegate.
+		*/
+		int Size() const
+		{
+			ListHolder holder(*this);
+			return static_cast<int>(holder.GetCount());
+		}
+
+		/*!
+		Clear the delegate.
+		*/
+		void Clear()
+		{
+			LockObj lock(m_delegateLock);
+			publishList(NULL);
+		}
+
+	protected:
+		/*!
+		@struct InvocationList epDelegate.h
+		@brief A structure for the header of the immutable invocation list, followed by its targets.
+		*/
+		struct InvocationList
+		{
+			/// the reference count
+			volatile long m_refCount;
+			/// the number of targets
+			size_t m_count;
+		};
+
+		class ListHolder;
+		friend class ListHolder;
+
+		/*!
+		@class ListHolder epDelegate.h
+		@brief A class that holds the current invocation list of the delegate during its lifetime.
+		*/
+		class ListHolder{
+		public:
+			/*!
+			Default Constructor
+
+			Hold the current invocation list of the given delegate
+			@param[in] owner the delegate
+			*/
+			ListHolder(const BaseDelegate<TargetType> &owner)
+			{
+				m_list=owner.acquireList();
+			}
+
+			/*!
+			Default Destructor
+
+			Release the invocation list
+			*/
+			virtual ~ListHolder()
+			{
+				releaseList(m_list);
+			}
+
+			/*!
+			Return the number of targets.
+			@return the number of targets.
+			*/
+			size_t GetCount() const
+			{
+				return m_list?m_list->m_count:0;
+			}
+
+			/*!
+			Return the target at given index.
+			@param[in] idx the index of the target
+			@return the target at given index
+			*/
+			const TargetType &GetTarget(size_t idx) const
+			{
+				EP_ASSERT(idx<GetCount());
+				return getTargets(m_list)[idx];
+			}
+		private:
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			ListHolder(const ListHolder & b){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			ListHolder &operator=(const ListHolder & b){EP_ASSERT(0);return *this;}
+
+			/// the invocation list held
+			InvocationList *m_list;
+		};
+
+		/*!
+		Replace the targets with the given target.
+		@param[in] target the target to set
+		*/
+		void assignTarget(const TargetType &target)
+		{
+			LockObj lock(m_delegateLock);
+			InvocationList *newList=createList(1);
+			new(getTargets(newList)) TargetType(target);
+			publishList(newList);
+		}
+
+		/*!
+		Append the given targets.
+		@param[in] targets the targets to append
+		@param[in] count the number of the targets
+		*/
+		void appendTargets(const TargetType *targets,size_t count)
+		{
+			if(count==0)
+				return;
+			LockObj lock(m_delegateLock);
+			size_t oldCount=m_list?m_list->m_count:0;
+			InvocationList *newList=createList(oldCount+count);
+			TargetType *newTargets=getTargets(newList);
+			for(size_t targetTrav=0;targetTrav<oldCount;targetTrav++)
+				new(&newTargets[targetTrav]) TargetType(getTargets(m_list)[targetTrav]);
+			for(size_t targetTrav=0;targetTrav<count;targetTrav++)
+				new(&newTargets[oldCount+targetTrav]) TargetType(targets[targetTrav]);
+			publishList(newList);
+		}
+
+		/*!
+		Remove all occurrences of the given targets.
+		@param[in] targets the targets to remove
+		@param[in] count the number of the targets
+		*/
+		void removeTargets(const TargetType *targets,size_t count)
+		{
+			LockObj lock(m_delegateLock);
+			if(m_list==NULL || count==0)
+				return;
+			const TargetType *oldTargets=getTargets(m_list);
+			size_t remainCount=0;
+			for(size_t targetTrav=0;targetTrav<m_list->m_count;targetTrav++)
+			{
+				if(!containsTarget(targets,count,oldTargets[targetTrav]))
+					remainCount++;
+			}
+			if(remainCount==m_list->m_count)
+				return;
+			if(remainCount==0)
+			{
+				publishList(NULL);
+				return;
+			}
+			InvocationList *newList=createList(remainCount);
+			TargetType *newTargets=getTargets(newList);
+			size_t newTrav=0;
+			for(size_t targetTrav=0;targetTrav<m_list->m_count;targetTrav++)
+			{
+				if(!containsTarget(targets,count,oldTargets[targetTrav]))
+					new(&newTargets[newTrav++]) TargetType(oldTargets[targetTrav]);
+			}
+			publishList(newList);
+		}
+
+		/*!
+		Return the targets of the given list.
+		@param[in] list the invocation list
+		@return the targets of the given list
+		*/
+		static TargetType *getTargets(InvocationList *list)
+		{
+			return reinterpret_cast<TargetType*>(list+1);
+		}
+
+	private:
+		/*!
+		Create the lock of the given policy.
+		@param[in] lockPolicyType The lock policy
+		@return the lock created
+		*/
+		static BaseLock *createLock(LockPolicy lockPolicyType)
+		{
+			switch(lockPolicyType)
+			{
+			case LOCK_POLICY_CRITICALSECTION:
+				return EP_NEW CriticalSectionEx();
+			case LOCK_POLICY_MUTEX:
+				return EP_NEW Mutex();
+			case LOCK_POLICY_NONE:
+				return EP_NEW NoLock();
+			case LOCK_POLICY_SPIN_PARK:
+				return EP_NEW SpinParkLock();
+			case LOCK_POLICY_READER_WRITER:
+				return EP_NEW ReaderWriterLock();
+			default:
+				return NULL;
+			}
+		}
+
+		/*!
+		Create the invocation list with room for the given number of targets.
+		@param[in] count the number of targets
+		@return the invocation list created with the reference count of 1
+		*/
+		static InvocationList *createList(size_t count)
+		{
+			InvocationList *list=reinterpret_cast<InvocationList*>(EP_Malloc(sizeof(InvocationList)+sizeof(TargetType)*count));
+			list->m_refCount=1;
+			list->m_count=count;
+			return list;
+		}
+
+		/*!
+		Release the given invocation list, and free it if no one holds it.
+		@param[in] list the invocation list to release
+		@remark the targets need no destruction, since they only keep the pointers.
+		*/
+		static void releaseList(InvocationList *list)
+		{
+			if(list && InterlockedDecrement(&list->m_refCount)==0)
+				EP_Free(list);
+		}
+
+		/*!
+		Check if the given target is in the given targets.
+		@param[in] targets the targets to search
+		@param[in] count the number of the targets
+		@param[in] target the target to find
+		@return true if found, otherwise false.
+		*/
+		static bool containsTarget(const TargetType *targets,size_t count,const TargetType &target)
+		{
+			for(size_t targetTrav=0;targetTrav<count;targetTrav++)
+			{
+				if(targets[targetTrav]==target)
+					return true;
+			}
+			return false;
+		}
+
+		/*!
+		Return the current invocation list with its reference count increased.
+		@return the current invocation list, or NULL if empty.
+		*/
+		InvocationList *acquireList() const
+		{
+			// the pin keeps the writer from releasing the list between the load and the reference
+			InterlockedIncrement(&m_pinCount);
+			InvocationList *list=m_list;
+			if(list)
+				InterlockedIncrement(&list->m_refCount);
+			InterlockedDecrement(&m_pinCount);
+			return list;
+		}
+
+		/*!
+		Publish the given invocation list, and release the old one.
+		@param[in] newList the invocation list to publish, or NULL to clear.
+		@remark must be called within the lock.
+		*/
+		void publishList(InvocationList *newList)
+		{
+			InvocationList *oldList=reinterpret_cast<InvocationList*>(InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_list),newList));
+			// only the few instructions within acquireList are waited, never the invocation itself
+			while(m_pinCount!=0)
+				YieldProcessor();
+			releaseList(oldList);
+		}
+
+		/// the current invocation list
+		InvocationList * volatile m_list;
+		/// the number of readers loading the list
+		mutable volatile long m_pinCount;
+		/// lock for the writers
+		BaseLock *m_delegateLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
 	/*! 
 	@class Delegate epDelegate.h
 	@brief A class for C# Style Delegate.
+
+	The targets are the functions, the member functions or the functors, given as DelegateTarget.
+	The invocation takes no lock, and calls the snapshot of the targets taken when it started.
 	*/
 	template<typename RetType,typename ArgType=void>
-	class Delegate{
+	class Delegate: public BaseDelegate<DelegateTarget<RetType,ArgType> >{
 	public:
 		/// Function Pointer Type Definition
 		typedef RetType (*FuncType) (ArgType);
+		/// Target Type Definition
+		typedef DelegateTarget<RetType,ArgType> TargetType;
 
 		/*!
 		Default Constructor
@@ -64,24 +820,8 @@ namespace epl
 		Initializes the delegate
 		@param[in] lockPolicyType The lock policy
 		*/
-		Delegate(LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		Delegate(LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseDelegate<TargetType>(lockPolicyType)
 		{
-			m_lockPolicy=lockPolicyType;
-			switch(lockPolicyType)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_delegateLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_delegateLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_delegateLock=EP_NEW NoLock();
-				break;
-			default:
-				m_delegateLock=NULL;
-				break;
-			}
 		}
 
 		/*!
@@ -91,25 +831,21 @@ namespace epl
 		@param[in] func the initial function pointer
 		@param[in] lockPolicyType The lock policy
 		*/
-		Delegate(RetType (*func)(ArgType),LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		Delegate(RetType (*func)(ArgType),LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseDelegate<TargetType>(lockPolicyType)
 		{
-			m_lockPolicy=lockPolicyType;
-			m_funcList.push_back(func);
-			switch(lockPolicyType)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_delegateLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_delegateLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_delegateLock=EP_NEW NoLock();
-				break;
-			default:
-				m_delegateLock=NULL;
-				break;
-			}
+			this->assignTarget(TargetType(func));
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the delegate with given target
+		@param[in] target the initial target
+		@param[in] lockPolicyType The lock policy
+		*/
+		Delegate(const TargetType &target,LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseDelegate<TargetType>(lockPolicyType)
+		{
+			this->assignTarget(target);
 		}
 
 		/*!
@@ -118,26 +854,8 @@ namespace epl
 		Initializes the delegate with given delegate
 		@param[in] orig the delegate
 		*/
-		Delegate(const Delegate<RetType,ArgType> &orig)
+		Delegate(const Delegate<RetType,ArgType> &orig):BaseDelegate<TargetType>(orig)
 		{
-			m_lockPolicy=orig.m_lockPolicy;
-			switch(m_lockPolicy)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_delegateLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_delegateLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_delegateLock=EP_NEW NoLock();
-				break;
-			default:
-				m_delegateLock=NULL;
-				break;
-			}
-			LockObj lock(b.m_delegateLock);
-			m_funcList=b.m_funcList;
 		}
 
 		/*!
@@ -147,100 +865,63 @@ namespace epl
 		*/
 		virtual ~Delegate()
 		{
-			if(m_delegateLock)
-				EP_DELETE m_delegateLock;
 		}	
 		
 		/*!
 		Assignment Operator Overloading
 
-		the Packet set as given packet b
-		@param[in] b right side of packet
+		the Delegate set as given delegate b
+		@param[in] b right side of delegate
 		@return this object
 		*/
 		Delegate<RetType,ArgType> & operator=(const Delegate<RetType,ArgType>&b)
 		{
-			if(this!=&b)
-			{
-				if(m_delegateLock)
-				{
-					EP_DELETE m_delegateLock;
-					m_delegateLock=NULL;
-				}
-				
-				m_lockPolicy=b.m_lockPolicy;
-				switch(m_lockPolicy)
-				{
-				case LOCK_POLICY_CRITICALSECTION:
-					m_delegateLock=EP_NEW CriticalSectionEx();
-					break;
-				case LOCK_POLICY_MUTEX:
-					m_delegateLock=EP_NEW Mutex();
-					break;
-				case LOCK_POLICY_NONE:
-					m_delegateLock=EP_NEW NoLock();
-					break;
-				default:
-					m_delegateLock=NULL;
-					break;
-				}
-				LockObj lock(b.m_delegateLock);
-				m_funcList=b.m_funcList;
-			}
+			BaseDelegate<TargetType>::operator =(b);
 			return *this;
 		}
 
 		/*!
-		Check if the delegate is empty.
-		@return true if the delegate is empty, otherwise false.
-		*/
-		bool IsEmpty() const
-		{
-			LockObj lock(m_delegateLock);
-			return m_funcList.empty();
-		}
-
-		/*!
-		Return the size of the delegate.
-		@return the size of the delegate.
+		Initialize the delegate with given function pointer
+		@param[in] func The initial function pointer
+		@return reference to this delegate
 		*/
-		int Size() const
+		virtual Delegate<RetType,ArgType> & operator =(RetType (*func)(ArgType))
 		{
-			LockObj lock(m_delegateLock);
-			return m_funcList.size();
+			this->assignTarget(TargetType(func));
+			return *this;
 		}
 
 		/*!
-		Clear the delegate.
+		Initialize the delegate with given target
+		@param[in] target The initial target
+		@return reference to this delegate
 		*/
-		void Clear()
+		virtual Delegate<RetType,ArgType> & operator =(const TargetType &target)
 		{
-			LockObj lock(m_delegateLock);
-			m_funcList.clear();
+			this->assignTarget(target);
+			return *this;
 		}
 
 		/*!
-		Initialize the delegate with given function pointer
-		@param[in] func The initial function pointer
+		Append the delegate with given function pointer
+		@param[in] func The function pointer to append
 		@return reference to this delegate
 		*/
-		virtual Delegate<RetType,ArgType> & operator =(RetType (*func)(ArgType))
+		virtual Delegate<RetType,ArgType> & operator +=(RetType (*func)(ArgType))
 		{
-			LockObj lock(m_delegateLock);
-			m_funcList.clear();
-			m_funcList.push_back(func);
+			TargetType target(func);
+			this->appendTargets(&target,1);
 			return *this;
 		}
 
 		/*!
-		Append the delegate with given function pointer
-		@param[in] func The function pointer to append
+		Append the delegate with given target
+		@param[in] target The target to append
 		@return reference to this delegate
 		*/
-		virtual Delegate<RetType,ArgType> & operator +=(RetType (*func)(ArgType))
+		virtual Delegate<RetType,ArgType> & operator +=(const TargetType &target)
 		{
-			LockObj lock(m_delegateLock);
-			m_funcList.push_back(func);
+			this->appendTargets(&target,1);
 			return *this;
 		}
 
@@ -257,35 +938,23 @@ namespace epl
 		}
 
 		/*!
-		Append the delegate with function pointers from the given delegate
+		Append the delegate with targets from the given delegate
 		@param[in] right The delegate to append
 		@return reference to this delegate
 		*/
 		virtual Delegate<RetType,ArgType> & operator +=(const Delegate<RetType,ArgType> &right)
 		{
-			LockObj lock(m_delegateLock);
-			vector<RetType (*)(ArgType)>::const_iterator iter;
-			if(this==&right)
-			{
-				Delegate<RetType,ArgType> tempDel(right);
-				for(iter=tempDel.m_funcList.begin();iter!=tempDel.m_funcList.end();iter++)
-				{
-					m_funcList.push_back(*iter);
-				}
-				return *this;
-			}
-
-			for(iter=right.m_funcList.begin();iter!=right.m_funcList.end();iter++)
-			{
-				m_funcList.push_back(*iter);
-			}
+			// the snapshot of the right stays valid even if the right is this delegate
+			typename BaseDelegate<TargetType>::ListHolder holder(right);
+			if(holder.GetCount())
+				this->appendTargets(&holder.GetTarget(0),holder.GetCount());
 			return *this;
 		}
 
 		/*!
-		Add the delegate with function pointers from the given delegate
+		Add the delegate with targets from the given delegate
 		@param[in] right The delegate to append
-		@return the delegate with the function pointers from this delegate and given delegate
+		@return the delegate with the targets from this delegate and given delegate
 		*/
 		virtual Delegate<RetType,ArgType> operator +(const Delegate<RetType,ArgType> &right) const
 		{
@@ -301,18 +970,19 @@ namespace epl
 		*/
 		virtual Delegate<RetType,ArgType> & operator -=(RetType (*func)(ArgType))
 		{
-			LockObj lock(m_delegateLock);
-			vector<RetType (*)(ArgType)>::iterator iter;
-			for(iter=m_funcList.begin();iter!=m_funcList.end();)
-			{
-				if(*iter==func)
-				{
-					iter=m_funcList.erase(iter);
-				}
-				else 
-					iter++;
-			}
+			TargetType target(func);
+			this->removeTargets(&target,1);
+			return *this;
+		}
 
+		/*!
+		Remove the given target from this delegate
+		@param[in] target The target to remove
+		@return reference to this delegate
+		*/
+		virtual Delegate<RetType,ArgType> & operator -=(const TargetType &target)
+		{
+			this->removeTargets(&target,1);
 			return *this;
 		}
 
@@ -329,52 +999,22 @@ namespace epl
 		}
 
 		/*!
-		Remove the function pointers of the given delegate from this delegate
+		Remove the targets of the given delegate from this delegate
 		@param[in] right The delegate to remove
 		@return reference to this delegate
 		*/
 		virtual Delegate<RetType,ArgType> & operator -=(const Delegate<RetType,ArgType> &right)
 		{
-			LockObj lock(m_delegateLock);
-
-			vector<RetType (*)(ArgType)>::const_iterator rightIter;
-			vector<RetType (*)(ArgType)>::iterator iter;
-			if(this==&right)
-			{
-				Delegate<RetType,ArgType> tempDel(right);
-				for(rightIter=tempDel.m_funcList.begin();rightIter!=tempDel.m_funcList.end();rightIter++)
-				{
-					for(iter=m_funcList.begin();iter!=m_funcList.end();)
-					{
-						if(*iter==*rightIter)
-						{
-							iter=m_funcList.erase(iter);
-						}
-						else 
-							iter++;
-					}
-				}
-				return *this;
-			}
-			for(rightIter=right.m_funcList.begin();rightIter!=right.m_funcList.end();rightIter++)
-			{
-				for(iter=m_funcList.begin();iter!=m_funcList.end();)
-				{
-					if(*iter==*rightIter)
-					{
-						iter=m_funcList.erase(iter);
-					}
-					else 
-						iter++;
-				}
-			}
+			typename BaseDelegate<TargetType>::ListHolder holder(right);
+			if(holder.GetCount())
+				this->removeTargets(&holder.GetTarget(0),holder.GetCount());
 			return *this;
 		}
 
 		/*!
-		Remove the function pointers of the given delegate from this delegate 
+		Remove the targets of the given delegate from this delegate 
 		@param[in] right The delegate to remove
-		@return the delegate with the function pointers of given delegate extracted from this delegate
+		@return the delegate with the targets of given delegate extracted from this delegate
 		*/
 		virtual Delegate<RetType,ArgType> operator -(const Delegate<RetType,ArgType> &right) const
 		{
@@ -386,57 +1026,63 @@ namespace epl
 		/*!
 		Return the function pointer at given index
 		@param[in] idx the index to return the function pointer
-		@return the function pointer at given index
+		@return the function pointer at given index, or NULL if the target is not the function
 		*/
 		virtual FuncType operator [](size_t idx) const
 		{
-			EP_ASSERT(idx<m_funcList.size());
-			vector<RetType (*)(ArgType)>::const_iterator iter=m_funcList.begin();
-			iter+=idx;
-			return *iter;
-		
+			return GetTarget(idx).GetFunction();
 		}
 
 		/*!
-		Execute the function pointers within this delegate with the argument given
-		@param[in] arg the argument of the function pointer
-		@return the return value of the last function pointer
+		Return the target at given index
+		@param[in] idx the index to return the target
+		@return the target at given index
 		*/
-		virtual RetType operator ()(ArgType arg)
+		TargetType GetTarget(size_t idx) const
 		{
-			EP_ASSERT(m_funcList.size());
-			vector<RetType (*)(ArgType)>::iterator iter;
-			vector<RetType (*)(ArgType)>::iterator lastIterCheck;
-			for(iter=m_funcList.begin();iter!=m_funcList.end();iter++)
+			typename BaseDelegate<TargetType>::ListHolder holder(*this);
+			if(idx>=holder.GetCount())
 			{
-				lastIterCheck=iter;
-				lastIterCheck++;
-				if(lastIterCheck==m_funcList.end())
-					break;
-				else
-					(*iter)(arg);
+				EP_ASSERT(0);
+				return TargetType();
 			}
-			return (*iter)(arg);
+			return holder.GetTarget(idx);
 		}
 
-	private:
-		/// function pointer list
-		vector<RetType (*)(ArgType)> m_funcList;
-		/// lock
-		BaseLock *m_delegateLock;
-		/// Lock Policy
-		LockPolicy m_lockPolicy;
+		/*!
+		Execute the targets within this delegate with the argument given
+		@param[in] arg the argument of the targets
+		@return the return value of the last target
+		*/
+		virtual RetType operator ()(ArgType arg)
+		{
+			typename BaseDelegate<TargetType>::ListHolder holder(*this);
+			size_t count=holder.GetCount();
+			EP_ASSERT(count);
+			if(count==0)
+				return RetType();
+			for(size_t targetTrav=0;targetTrav<count-1;targetTrav++)
+			{
+				holder.GetTarget(targetTrav)(arg);
+			}
+			return holder.GetTarget(count-1)(arg);
+		}
 	};
 
 	/*! 
 	@class Delegate epDelegate.h
 	@brief A partial specialization class for C# Style Delegate with void argument.
+
+	The targets are the functions, the member functions or the functors, given as DelegateTarget.
+	The invocation takes no lock, and calls the snapshot of the targets taken when it started.
 	*/
 	template<typename RetType>
-	class Delegate<RetType,void>{
+	class Delegate<RetType,void>: public BaseDelegate<DelegateTarget<RetType,void> >{
 	public:
 		/// Function Pointer Type Definition
 		typedef RetType (*FuncType) (void);
+		/// Target Type Definition
+		typedef DelegateTarget<RetType,void> TargetType;
 
 		/*!
 		Default Constructor
@@ -444,24 +1090,8 @@ namespace epl
 		Initializes the delegate
 		@param[in] lockPolicyType The lock policy
 		*/
-		Delegate(LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		Delegate(LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseDelegate<TargetType>(lockPolicyType)
 		{
-			m_lockPolicy=lockPolicyType;
-			switch(lockPolicyType)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_delegateLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_delegateLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_delegateLock=EP_NEW NoLock();
-				break;
-			default:
-				m_delegateLock=NULL;
-				break;
-			}
 		}
 
 		/*!
@@ -471,25 +1101,21 @@ namespace epl
 		@param[in] func the initial function pointer
 		@param[in] lockPolicyType The lock policy
 		*/
-		Delegate(RetType (*func)(void),LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		Delegate(RetType (*func)(void),LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseDelegate<TargetType>(lockPolicyType)
 		{
-			m_lockPolicy=lockPolicyType;
-			m_funcList.push_back(func);
-			switch(lockPolicyType)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_delegateLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_delegateLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_delegateLock=EP_NEW NoLock();
-				break;
-			default:
-				m_delegateLock=NULL;
-				break;
-			}
+			this->assignTarget(TargetType(func));
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the delegate with given target
+		@param[in] target the initial target
+		@param[in] lockPolicyType The lock policy
+		*/
+		Delegate(const TargetType &target,LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseDelegate<TargetType>(lockPolicyType)
+		{
+			this->assignTarget(target);
 		}
 
 		/*!
@@ -498,27 +1124,8 @@ namespace epl
 		Initializes the delegate with given delegate
 		@param[in] orig the delegate
 		*/
-		Delegate(const Delegate<RetType,void> &orig)
+		Delegate(const Delegate<RetType,void> &orig):BaseDelegate<TargetType>(orig)
 		{
-
-			m_lockPolicy=orig.m_lockPolicy;
-			switch(m_lockPolicy)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_delegateLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_delegateLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_delegateLock=EP_NEW NoLock();
-				break;
-			default:
-				m_delegateLock=NULL;
-				break;
-			}
-			LockObj lock(b.m_delegateLock);
-			m_funcList=orig.m_funcList;
 		}
 
 		/*!
@@ -528,100 +1135,63 @@ namespace epl
 		*/
 		virtual ~Delegate()
 		{
-			if(m_delegateLock)
-				EP_DELETE m_delegateLock;
-		}
-
+		}	
+		
 		/*!
 		Assignment Operator Overloading
 
-		the Delegate set as given packet b
-		@param[in] b right side of packet
+		the Delegate set as given delegate b
+		@param[in] b right side of delegate
 		@return this object
 		*/
 		Delegate<RetType,void> & operator=(const Delegate<RetType,void>&b)
 		{
-			if(this!=&b)
-			{
-				if(m_delegateLock)
-				{
-					EP_DELETE m_delegateLock;
-					m_delegateLock=NULL;
-				}
-				
-				m_lockPolicy=b.m_lockPolicy;
-				switch(m_lockPolicy)
-				{
-				case LOCK_POLICY_CRITICALSECTION:
-					m_delegateLock=EP_NEW CriticalSectionEx();
-					break;
-				case LOCK_POLICY_MUTEX:
-					m_delegateLock=EP_NEW Mutex();
-					break;
-				case LOCK_POLICY_NONE:
-					m_delegateLock=EP_NEW NoLock();
-					break;
-				default:
-					m_delegateLock=NULL;
-					break;
-				}
-				LockObj lock(b.m_delegateLock);
-				m_funcList=b.m_funcList;
-			}
+			BaseDelegate<TargetType>::operator =(b);
 			return *this;
 		}
 
 		/*!
-		Check if the delegate is empty.
-		@returns Returns true if the delegate is empty, otherwise false.
-		*/
-		bool IsEmpty() const
-		{
-			LockObj lock(m_delegateLock);
-			return m_funcList.empty();
-		}
-
-		/*!
-		Return the size of the delegate.
-		@return the size of the delegate.
+		Initialize the delegate with given function pointer
+		@param[in] func The initial function pointer
+		@return reference to this delegate
 		*/
-		int Size() const
+		virtual Delegate<RetType,void> & operator =(RetType (*func)(void))
 		{
-			LockObj lock(m_delegateLock);
-			return m_funcList.size();
+			this->assignTarget(TargetType(func));
+			return *this;
 		}
 
 		/*!
-		Clear the delegate.
+		Initialize the delegate with given target
+		@param[in] target The initial target
+		@return reference to this delegate
 		*/
-		void Clear()
+		virtual Delegate<RetType,void> & operator =(const TargetType &target)
 		{
-			LockObj lock(m_delegateLock);
-			m_funcList.clear();
+			this->assignTarget(target);
+			return *this;
 		}
 
 		/*!
-		Initialize the delegate with given function pointer
-		@param[in] func The initial function pointer
+		Append the delegate with given function pointer
+		@param[in] func The function pointer to append
 		@return reference to this delegate
 		*/
-		virtual Delegate<RetType,void> & operator =(RetType (*func)(void))
+		virtual Delegate<RetType,void> & operator +=(RetType (*func)(void))
 		{
-			LockObj lock(m_delegateLock);
-			m_funcList.clear();
-			m_funcList.push_back(func);
+			TargetType target(func);
+			this->appendTargets(&target,1);
 			return *this;
 		}
 
 		/*!
-		Append the delegate with given function pointer
-		@param[in] func The function pointer to append
+		Append the delegate with given target
+		@param[in] target The target to append
 		@return reference to this delegate
 		*/
-		virtual Delegate<RetType,void> & operator +=(RetType (*func)(void))
+		virtual Delegate<RetType,void> & operator +=(const TargetType &target)
 		{
-			LockObj lock(m_delegateLock);
-			m_funcList.push_back(func);
+			this->appendTargets(&target,1);
 			return *this;
 		}
 
@@ -638,35 +1208,23 @@ namespace epl
 		}
 
 		/*!
-		Append the delegate with function pointers from the given delegate
+		Append the delegate with targets from the given delegate
 		@param[in] right The delegate to append
 		@return reference to this delegate
 		*/
 		virtual Delegate<RetType,void> & operator +=(const Delegate<RetType,void> &right)
 		{
-			LockObj lock(m_delegateLock);
-			vector<RetType (*)(void)>::const_iterator iter;
-			if(this==&right)
-			{
-				Delegate<RetType,void> tempDel(right);
-				for(iter=tempDel.m_funcList.begin();iter!=tempDel.m_funcList.end();iter++)
-				{
-					m_funcList.push_back(*iter);
-				}
-				return *this;
-			}
-			
-			for(iter=right.m_funcList.begin();iter!=right.m_funcList.end();iter++)
-			{
-				m_funcList.push_back(*iter);
-			}
+			// the snapshot of the right stays valid even if the right is this delegate
+			typename BaseDelegate<TargetType>::ListHolder holder(right);
+			if(holder.GetCount())
+				this->appendTargets(&holder.GetTarget(0),holder.GetCount());
 			return *this;
 		}
 
 		/*!
-		Add the delegate with function pointers from the given delegate
+		Add the delegate with targets from the given delegate
 		@param[in] right The delegate to append
-		@return the delegate with the function pointers from this delegate and given delegate
+		@return the delegate with the targets from this delegate and given delegate
 		*/
 		virtual Delegate<RetType,void> operator +(const Delegate<RetType,void> &right) const
 		{
@@ -682,18 +1240,19 @@ namespace epl
 		*/
 		virtual Delegate<RetType,void> & operator -=(RetType (*func)(void))
 		{
-			LockObj lock(m_delegateLock);
-			vector<RetType (*)(void)>::iterator iter;
-			for(iter=m_funcList.begin();iter!=m_funcList.end();)
-			{
-				if(*iter==func)
-				{
-					iter=m_funcList.erase(iter);
-				}
-				else 
-					iter++;
-			}
+			TargetType target(func);
+			this->removeTargets(&target,1);
+			return *this;
+		}
 
+		/*!
+		Remove the given target from this delegate
+		@param[in] target The target to remove
+		@return reference to this delegate
+		*/
+		virtual Delegate<RetType,void> & operator -=(const TargetType &target)
+		{
+			this->removeTargets(&target,1);
 			return *this;
 		}
 
@@ -710,52 +1269,22 @@ namespace epl
 		}
 
 		/*!
-		Remove the function pointers of the given delegate from this delegate
+		Remove the targets of the given delegate from this delegate
 		@param[in] right The delegate to remove
 		@return reference to this delegate
 		*/
 		virtual Delegate<RetType,void> & operator -=(const Delegate<RetType,void> &right)
 		{
-			LockObj lock(m_delegateLock);
-
-			vector<RetType (*)(void)>::const_iterator rightIter;
-			vector<RetType (*)(void)>::iterator iter;
-			if(this==&right)
-			{
-				Delegate<RetType,void> tempDel(right);
-				for(rightIter=tempDel.m_funcList.begin();rightIter!=tempDel.m_funcList.end();rightIter++)
-				{
-					for(iter=m_funcList.begin();iter!=m_funcList.end();)
-					{
-						if(*iter==*rightIter)
-						{
-							iter=m_funcList.erase(iter);
-						}
-						else 
-							iter++;
-					}
-				}
-				return *this;
-			}
-			for(rightIter=right.m_funcList.begin();rightIter!=right.m_funcList.end();rightIter++)
-			{
-				for(iter=m_funcList.begin();iter!=m_funcList.end();)
-				{
-					if(*iter==*rightIter)
-					{
-						iter=m_funcList.erase(iter);
-					}
-					else 
-						iter++;
-				}
-			}
+			typename BaseDelegate<TargetType>::ListHolder holder(right);
+			if(holder.GetCount())
+				this->removeTargets(&holder.GetTarget(0),holder.GetCount());
 			return *this;
 		}
 
 		/*!
-		Remove the function pointers of the given delegate from this delegate 
+		Remove the targets of the given delegate from this delegate 
 		@param[in] right The delegate to remove
-		@return the delegate with the function pointers of given delegate extracted from this delegate
+		@return the delegate with the targets of given delegate extracted from this delegate
 		*/
 		virtual Delegate<RetType,void> operator -(const Delegate<RetType,void> &right) const
 		{
@@ -767,45 +1296,46 @@ namespace epl
 		/*!
 		Return the function pointer at given index
 		@param[in] idx the index to return the function pointer
-		@return the function pointer at given index
+		@return the function pointer at given index, or NULL if the target is not the function
 		*/
 		virtual FuncType operator [](size_t idx) const
 		{
-			EP_ASSERT(idx<m_funcList.size());
-			vector<RetType (*)(void)>::const_iterator iter=m_funcList.begin();
-			iter+=idx;
-			return *iter;
+			return GetTarget(idx).GetFunction();
+		}
 
+		/*!
+		Return the target at given index
+		@param[in] idx the index to return the target
+		@return the target at given index
+		*/
+		TargetType GetTarget(size_t idx) const
+		{
+			typename BaseDelegate<TargetType>::ListHolder holder(*this);
+			if(idx>=holder.GetCount())
+			{
+				EP_ASSERT(0);
+				return TargetType();
+			}
+			return holder.GetTarget(idx);
 		}
 
 		/*!
-		Execute the function pointers within this delegate
-		@return the return value of the last function pointer
+		Execute the targets within this delegate
+		@return the return value of the last target
 		*/
 		virtual RetType operator ()()
 		{
-			EP_ASSERT(m_funcList.size());
-			vector<RetType (*)(void)>::iterator iter;
-			vector<RetType (*)(void)>::iterator lastIterCheck;
-			for(iter=m_funcList.begin();iter!=m_funcList.end();iter++)
+			typename BaseDelegate<TargetType>::ListHolder holder(*this);
+			size_t count=holder.GetCount();
+			EP_ASSERT(count);
+			if(count==0)
+				return RetType();
+			for(size_t targetTrav=0;targetTrav<count-1;targetTrav++)
 			{
-				lastIterCheck=iter;
-				lastIterCheck++;
-				if(lastIterCheck==m_funcList.end())
-					break;
-				else
-					(*iter)();
+				holder.GetTarget(targetTrav)();
 			}
-			return (*iter)();
+			return holder.GetTarget(count-1)();
 		}
-
-	private:
-		/// function pointer list
-		vector<RetType (*)(void)> m_funcList;
-		/// lock
-		BaseLock *m_delegateLock;
-		/// Lock Policy
-		LockPolicy m_lockPolicy;
 	};
 
 	template<typename RetType,typename ArgType>
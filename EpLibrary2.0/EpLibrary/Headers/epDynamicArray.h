@@ -42,10 +42,33 @@ An Interface for Dynamic Array Data Structure.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 #include "epException.h"
+#include <new>
+#include <utility>
 
 namespace epl
 {
+	/*! 
+	@struct DynamicArrayTraits epDynamicArray.h
+	@brief A template structure for the element traits of DynamicArray.
+
+	The trivially copyable element is copied with System::Memcpy, and not constructed or destroyed.
+	The trivially relocatable element is grown with EP_Realloc, and the other elements are moved one by one.
+	@remark specialize for the type which can be moved with memcpy while it has the non-trivial copy constructor.
+	*/
+	template <typename DataType>
+	struct DynamicArrayTraits
+	{
+		enum{
+			/// true if the element can be copied with memcpy
+			IS_TRIVIALLY_COPYABLE=__has_trivial_copy(DataType)&&__has_trivial_destructor(DataType),
+			/// true if the element can be moved to the new memory with memcpy
+			IS_TRIVIALLY_RELOCATABLE=IS_TRIVIALLY_COPYABLE,
+		};
+	};
+
 	/*! 
 	@class DynamicArray epDynamicArray.h
 	@brief A template class for Dynamic Array.
@@ -54,6 +77,187 @@ namespace epl
 	class DynamicArray
 	{
 	public:
+		/*!
+		@class View epDynamicArray.h
+		@brief A class that holds the lock of the array during its lifetime, and exposes the raw elements.
+
+		The element access through the view does not take the lock, so the tight loop over the view can be vectorized.
+		@remark the array must not be modified except through the view while the view exists.
+		*/
+		class View
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Lock the given array exclusively
+			@param[in] arr the array to view
+			*/
+			View(DynamicArray<DataType> &arr):m_lock(arr.m_arrayLock),m_head(arr.m_head),m_size(arr.m_numOfElements)
+			{
+			}
+
+			/*!
+			Default Destructor
+
+			Unlock the array
+			*/
+			virtual ~View()
+			{
+			}
+
+			/*!
+			Return the pointer to the first element.
+			@return the pointer to the first element, or NULL if the array is empty.
+			*/
+			DataType *Data() const
+			{
+				return m_head;
+			}
+
+			/*!
+			Return the pointer to the one past the last element.
+			@return the pointer to the one past the last element.
+			*/
+			DataType *End() const
+			{
+				return m_head+m_size;
+			}
+
+			/*!
+			Return the number of elements.
+			@return the number of elements.
+			*/
+			size_t Size() const
+			{
+				return m_size;
+			}
+
+			/*!
+			Return the element at the given index without the lock.
+			@param[in] idx The index to return the element.
+			@return the element at the given index.
+			*/
+			DataType &operator[](size_t idx) const
+			{
+				EP_ASSERT(m_size>idx);
+				return m_head[idx];
+			}
+		private:
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			View(const View & b):m_lock(NULL){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			View &operator=(const View & b){EP_ASSERT(0);return *this;}
+
+			/// the lock of the array
+			LockObj m_lock;
+			/// the first element
+			DataType *m_head;
+			/// the number of elements
+			size_t m_size;
+		};
+
+		/*!
+		@class ConstView epDynamicArray.h
+		@brief A class that holds the shared lock of the array during its lifetime, and exposes the raw elements as read-only.
+
+		The element access through the view does not take the lock, so the tight loop over the view can be vectorized.
+		*/
+		class ConstView
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Lock the given array shared
+			@param[in] arr the array to view
+			*/
+			ConstView(const DynamicArray<DataType> &arr):m_lock(arr.m_arrayLock),m_head(arr.m_head),m_size(arr.m_numOfElements)
+			{
+			}
+
+			/*!
+			Default Destructor
+
+			Unlock the array
+			*/
+			virtual ~ConstView()
+			{
+			}
+
+			/*!
+			Return the pointer to the first element.
+			@return the pointer to the first element, or NULL if the array is empty.
+			*/
+			const DataType *Data() const
+			{
+				return m_head;
+			}
+
+			/*!
+			Return the pointer to the one past the last element.
+			@return the pointer to the one past the last element.
+			*/
+			const DataType *End() const
+			{
+				return m_head+m_size;
+			}
+
+			/*!
+			Return the number of elements.
+			@return the number of elements.
+			*/
+			size_t Size() const
+			{
+				return m_size;
+			}
+
+			/*!
+			Return the element at the given index without the lock.
+			@param[in] idx The index to return the element.
+			@return the element at the given index.
+			*/
+			const DataType &operator[](size_t idx) const
+			{
+				EP_ASSERT(m_size>idx);
+				return m_head[idx];
+			}
+		private:
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			ConstView(const ConstView & b):m_lock(NULL){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			ConstView &operator=(const ConstView & b){EP_ASSERT(0);return *this;}
+
+			/// the shared lock of the array
+			SharedLockObj m_lock;
+			/// the first element
+			const DataType *m_head;
+			/// the number of elements
+			size_t m_size;
+		};
+
 		/*!
 		Default Constructor
 
@@ -108,6 +312,24 @@ namespace epl
 		*/
 		bool Resize(size_t newSize);
 
+		/*!
+		Reserve the memory of the given array for given number of elements.
+		@param[in] capacity The number of elements to reserve the memory for.
+		@return true if the memory is grown, false if already reserved.
+		*/
+		bool Reserve(size_t capacity);
+
+		/*!
+		Free the memory of the given array not used by the elements.
+		*/
+		void ShrinkToFit();
+
+		/*!
+		Return the number of elements the given array can hold without growing.
+		@return the number of elements the memory is reserved for.
+		*/
+		size_t GetCapacity() const;
+
 		/*!
 		Return the element at the given index of the given array.
 		@param[in] idx The index to return the element.
@@ -115,6 +337,24 @@ namespace epl
 		*/
 		DataType &At(size_t idx);
 
+		/*!
+		Copy the elements from the given index to the given buffer under a single lock.
+		@param[out] retBuff The buffer to copy the elements to.
+		@param[in] count The maximum number of elements to copy.
+		@param[in] startIdx The index of the first element to copy.
+		@return the number of elements copied.
+		*/
+		size_t CopyTo(DataType *retBuff, size_t count, size_t startIdx=0) const;
+
+		/*!
+		Copy the elements of the given buffer to the array from the given index under a single lock.
+		@param[in] buff The buffer to copy the elements from.
+		@param[in] count The number of elements to copy.
+		@param[in] startIdx The index of the array to copy the first element to.
+		@remark the array grows if the elements copied go past the end.
+		*/
+		void CopyFrom(const DataType *buff, size_t count, size_t startIdx=0);
+
 		/*!
 		Append the element given to the dynamic array given.
 		@param[in] data The data to append at the end.
@@ -122,6 +362,48 @@ namespace epl
 		*/
 		DynamicArray<DataType> &Append(const DataType &data);
 
+#if _MSC_VER>=MSVC100
+		/*!
+		Append the element given to the dynamic array given by moving it.
+		@param[in] data The data to append at the end.
+		@return the result dynamic array
+		*/
+		DynamicArray<DataType> &Append(DataType &&data);
+#endif //_MSC_VER>=MSVC100
+
+		/*!
+		Construct the new element at the end of the dynamic array.
+		@return the element constructed.
+		*/
+		DataType &Emplace();
+
+		/*!
+		Construct the new element at the end of the dynamic array from the given argument.
+		@param[in] arg1 The argument for the constructor of the data.
+		@return the element constructed.
+		*/
+		template <typename Arg1>
+		DataType &Emplace(Arg1 const &arg1);
+
+		/*!
+		Construct the new element at the end of the dynamic array from the given arguments.
+		@param[in] arg1 The first argument for the constructor of the data.
+		@param[in] arg2 The second argument for the constructor of the data.
+		@return the element constructed.
+		*/
+		template <typename Arg1, typename Arg2>
+		DataType &Emplace(Arg1 const &arg1, Arg2 const &arg2);
+
+		/*!
+		Construct the new element at the end of the dynamic array from the given arguments.
+		@param[in] arg1 The first argument for the constructor of the data.
+		@param[in] arg2 The second argument for the constructor of the data.
+		@param[in] arg3 The third argument for the constructor of the data.
+		@return the element constructed.
+		*/
+		template <typename Arg1, typename Arg2, typename Arg3>
+		DataType &Emplace(Arg1 const &arg1, Arg2 const &arg2, Arg3 const &arg3);
+
 		/*!
 		Append the given dynamic array to the this dynamic array.
 		@param[in] dArr The dynamic array structure to append.
@@ -186,6 +468,46 @@ namespace epl
 		*/
 		bool resize(size_t newSize);
 
+		/*!
+		Grow the given array geometrically to hold at least given number of elements.
+		@param[in] minSize The number of elements to hold.
+		*/
+		void grow(size_t minSize);
+
+		/*!
+		Move the elements to the new memory of given size.
+		@param[in] newSize The number of elements of the new memory.
+		*/
+		void reallocate(size_t newSize);
+
+		/*!
+		Grow the given array for one more element at the end.
+		@return the memory for the new element at the end.
+		*/
+		void *prepareBack();
+
+		/*!
+		Default construct the given number of elements.
+		@param[in] first The first element to construct.
+		@param[in] count The number of elements to construct.
+		*/
+		static void constructElements(DataType *first, size_t count);
+
+		/*!
+		Copy construct the given number of elements.
+		@param[in] dest The first element to construct.
+		@param[in] src The first element to copy from.
+		@param[in] count The number of elements to copy.
+		*/
+		static void copyElements(DataType *dest, const DataType *src, size_t count);
+
+		/*!
+		Destroy the given number of elements.
+		@param[in] first The first element to destroy.
+		@param[in] count The number of elements to destroy.
+		*/
+		static void destroyElements(DataType *first, size_t count);
+
 		/*!
 		Actual append the element given to the dynamic array given.
 		@param[in] data The data to append at the end.
@@ -234,6 +556,12 @@ namespace epl
 		case LOCK_POLICY_NONE:
 			m_arrayLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_arrayLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_arrayLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_arrayLock=NULL;
 			break;
@@ -244,6 +572,7 @@ namespace epl
 		{
 			m_head=reinterpret_cast<DataType*>(EP_Malloc(sizeof(DataType)*m_actualSize));
 			EP_ASSERT(m_head);
+			constructElements(m_head,m_numOfElements);
 		}
 		else
 			m_head=NULL;
@@ -264,6 +593,12 @@ namespace epl
 		case LOCK_POLICY_NONE:
 			m_arrayLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_arrayLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_arrayLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_arrayLock=NULL;
 			break;
@@ -275,7 +610,7 @@ namespace epl
 		{
 			m_head=reinterpret_cast<DataType*>(EP_Malloc(sizeof(DataType)*m_actualSize));
 			EP_ASSERT(m_head);
-			System::Memcpy(m_head,sizeof(DataType)*m_actualSize,dArr.m_head,sizeof(DataType)*m_actualSize);
+			copyElements(m_head,dArr.m_head,m_numOfElements);
 		}
 		else
 			m_head=NULL;
@@ -286,8 +621,7 @@ namespace epl
 	DynamicArray<DataType>::~DynamicArray()
 	{
 		m_arrayLock->Lock();
-		if(m_head)
-			EP_Free(m_head);
+		deleteArr();
 		m_arrayLock->Unlock();
 		if(m_arrayLock)
 			EP_DELETE m_arrayLock;
@@ -303,6 +637,7 @@ namespace epl
 	template <typename DataType>
 	void DynamicArray<DataType>::deleteArr()
 	{
+		destroyElements(m_head,m_numOfElements);
 		if(m_head)
 			EP_Free(m_head);
 		m_head=NULL;
@@ -314,14 +649,16 @@ namespace epl
 	void DynamicArray<DataType>::Clear()
 	{
 		LockObj lock(m_arrayLock);
-		System::Memset(m_head,0,sizeof(DataType)*m_actualSize);
+		destroyElements(m_head,m_numOfElements);
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_COPYABLE)
+			System::Memset(m_head,0,sizeof(DataType)*m_actualSize);
 		m_numOfElements=0;
 	}
 
 	template <typename DataType>
 	bool DynamicArray<DataType>::IsEmpty() const
 	{
-		LockObj lock(m_arrayLock);
+		SharedLockObj lock(m_arrayLock);
 		if(m_numOfElements)
 			return true;
 		return false;
@@ -330,7 +667,7 @@ namespace epl
 	template <typename DataType>
 	size_t DynamicArray<DataType>::Size() const
 	{
-		LockObj lock(m_arrayLock);
+		SharedLockObj lock(m_arrayLock);
 		return m_numOfElements;
 	}
 
@@ -346,20 +683,132 @@ namespace epl
 	{
 		if(m_actualSize>=newSize)
 			return false;
-		if(m_head)
+		reallocate(newSize);
+		return true;
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::reallocate(size_t newSize)
+	{
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_RELOCATABLE)
 		{
-			m_head=reinterpret_cast<DataType*>(EP_Realloc(m_head,newSize*sizeof(DataType)));
-			System::Memset(m_head+m_actualSize,0,(newSize-m_actualSize)*sizeof(DataType));
-			m_actualSize=newSize;
+			if(m_head)
+				m_head=reinterpret_cast<DataType*>(EP_Realloc(m_head,newSize*sizeof(DataType)));
+			else
+				m_head=reinterpret_cast<DataType*>(EP_Malloc(newSize*sizeof(DataType)));
 		}
 		else
 		{
-			m_head=reinterpret_cast<DataType*>(EP_Malloc(newSize*sizeof(DataType)));
-			System::Memset(m_head,0,newSize*sizeof(DataType));
-			m_actualSize=newSize;
+			DataType *newHead=reinterpret_cast<DataType*>(EP_Malloc(newSize*sizeof(DataType)));
+			EP_ASSERT(newHead);
+			for(size_t elemTrav=0;elemTrav<m_numOfElements;elemTrav++)
+			{
+#if _MSC_VER>=MSVC100
+				::new(newHead+elemTrav) DataType(std::move(m_head[elemTrav]));
+#else //_MSC_VER>=MSVC100
+				::new(newHead+elemTrav) DataType(m_head[elemTrav]);
+#endif //_MSC_VER>=MSVC100
+				(m_head+elemTrav)->~DataType();
+			}
+			if(m_head)
+				EP_Free(m_head);
+			m_head=newHead;
 		}
 		EP_ASSERT(m_head);
-		return true;
+		m_actualSize=newSize;
+	}
+
+	template <typename DataType>
+	void *DynamicArray<DataType>::prepareBack()
+	{
+		if(m_actualSize<m_numOfElements+1)
+		{
+			grow(m_numOfElements+1);
+		}
+		return m_head+m_numOfElements;
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::constructElements(DataType *first, size_t count)
+	{
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_COPYABLE)
+		{
+			if(count)
+				System::Memset(first,0,count*sizeof(DataType));
+			return;
+		}
+		for(size_t elemTrav=0;elemTrav<count;elemTrav++)
+		{
+			::new(first+elemTrav) DataType();
+		}
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::copyElements(DataType *dest, const DataType *src, size_t count)
+	{
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_COPYABLE)
+		{
+			if(count)
+				System::Memcpy(dest,count*sizeof(DataType),src,count*sizeof(DataType));
+			return;
+		}
+		for(size_t elemTrav=0;elemTrav<count;elemTrav++)
+		{
+			::new(dest+elemTrav) DataType(src[elemTrav]);
+		}
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::destroyElements(DataType *first, size_t count)
+	{
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_COPYABLE)
+			return;
+		for(size_t elemTrav=0;elemTrav<count;elemTrav++)
+		{
+			(first+elemTrav)->~DataType();
+		}
+	}
+
+	template <typename DataType>
+	bool DynamicArray<DataType>::Reserve(size_t capacity)
+	{
+		LockObj lock(m_arrayLock);
+		return resize(capacity);
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::ShrinkToFit()
+	{
+		LockObj lock(m_arrayLock);
+		if(m_actualSize==m_numOfElements)
+			return;
+		if(m_numOfElements==0)
+		{
+			EP_Free(m_head);
+			m_head=NULL;
+			m_actualSize=0;
+			return;
+		}
+		reallocate(m_numOfElements);
+	}
+
+	template <typename DataType>
+	size_t DynamicArray<DataType>::GetCapacity() const
+	{
+		SharedLockObj lock(m_arrayLock);
+		return m_actualSize;
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::grow(size_t minSize)
+	{
+		if(m_actualSize>=minSize)
+			return;
+		// double the memory, so n appends cost O(n) copying in total
+		size_t newSize=m_actualSize*2;
+		if(newSize<m_actualSize || newSize<minSize)
+			newSize=minSize;
+		resize(newSize);
 	}
 
 	template <typename DataType>
@@ -368,18 +817,128 @@ namespace epl
 		LockObj lock(m_arrayLock);
 		if(m_numOfElements<=idx)
 		{
-			resize(idx+1);
+			grow(idx+1);
+			constructElements(m_head+m_numOfElements,idx+1-m_numOfElements);
 			m_numOfElements=idx+1;
 		}
 		return *(m_head+idx);
 	}
 
 
+	template <typename DataType>
+	size_t DynamicArray<DataType>::CopyTo(DataType *retBuff, size_t count, size_t startIdx) const
+	{
+		SharedLockObj lock(m_arrayLock);
+		if(startIdx>=m_numOfElements)
+			return 0;
+		if(count>m_numOfElements-startIdx)
+			count=m_numOfElements-startIdx;
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_COPYABLE)
+		{
+			if(count)
+				System::Memcpy(retBuff,count*sizeof(DataType),m_head+startIdx,count*sizeof(DataType));
+		}
+		else
+		{
+			for(size_t elemTrav=0;elemTrav<count;elemTrav++)
+				retBuff[elemTrav]=m_head[startIdx+elemTrav];
+		}
+		return count;
+	}
+
+	template <typename DataType>
+	void DynamicArray<DataType>::CopyFrom(const DataType *buff, size_t count, size_t startIdx)
+	{
+		LockObj lock(m_arrayLock);
+		if(count==0)
+			return;
+		size_t endIdx=startIdx+count;
+		if(endIdx>m_numOfElements)
+		{
+			grow(endIdx);
+			if(startIdx>m_numOfElements)
+				constructElements(m_head+m_numOfElements,startIdx-m_numOfElements);
+		}
+		if(DynamicArrayTraits<DataType>::IS_TRIVIALLY_COPYABLE)
+		{
+			System::Memcpy(m_head+startIdx,count*sizeof(DataType),buff,count*sizeof(DataType));
+		}
+		else
+		{
+			for(size_t elemTrav=0;elemTrav<count;elemTrav++)
+			{
+				if(startIdx+elemTrav<m_numOfElements)
+					m_head[startIdx+elemTrav]=buff[elemTrav];
+				else
+					::new(m_head+startIdx+elemTrav) DataType(buff[elemTrav]);
+			}
+		}
+		if(endIdx>m_numOfElements)
+			m_numOfElements=endIdx;
+	}
+
 	template <typename DataType>
 	DynamicArray<DataType> &DynamicArray<DataType>::Append(const DataType &data)
 	{
 		LockObj lock(m_arrayLock);
-		append(data);
+		return append(data);
+	}
+
+#if _MSC_VER>=MSVC100
+	template <typename DataType>
+	DynamicArray<DataType> &DynamicArray<DataType>::Append(DataType &&data)
+	{
+		LockObj lock(m_arrayLock);
+		// the data may be the element of this array, which moves when grown
+		if(&data>=m_head && &data<m_head+m_numOfElements)
+		{
+			DataType tmpData(std::move(data));
+			::new(prepareBack()) DataType(std::move(tmpData));
+		}
+		else
+			::new(prepareBack()) DataType(std::move(data));
+		m_numOfElements++;
+		return *this;
+	}
+#endif //_MSC_VER>=MSVC100
+
+	template <typename DataType>
+	DataType &DynamicArray<DataType>::Emplace()
+	{
+		LockObj lock(m_arrayLock);
+		DataType *retData=::new(prepareBack()) DataType();
+		m_numOfElements++;
+		return *retData;
+	}
+
+	template <typename DataType>
+	template <typename Arg1>
+	DataType &DynamicArray<DataType>::Emplace(Arg1 const &arg1)
+	{
+		LockObj lock(m_arrayLock);
+		DataType *retData=::new(prepareBack()) DataType(arg1);
+		m_numOfElements++;
+		return *retData;
+	}
+
+	template <typename DataType>
+	template <typename Arg1, typename Arg2>
+	DataType &DynamicArray<DataType>::Emplace(Arg1 const &arg1, Arg2 const &arg2)
+	{
+		LockObj lock(m_arrayLock);
+		DataType *retData=::new(prepareBack()) DataType(arg1,arg2);
+		m_numOfElements++;
+		return *retData;
+	}
+
+	template <typename DataType>
+	template <typename Arg1, typename Arg2, typename Arg3>
+	DataType &DynamicArray<DataType>::Emplace(Arg1 const &arg1, Arg2 const &arg2, Arg3 const &arg3)
+	{
+		LockObj lock(m_arrayLock);
+		DataType *retData=::new(prepareBack()) DataType(arg1,arg2,arg3);
+		m_numOfElements++;
+		return *retData;
 	}
 
 	template <typename DataType>
@@ -392,12 +951,17 @@ namespace epl
 	template <typename DataType>
 	DynamicArray<DataType> &DynamicArray<DataType>::append(const DataType &data)
 	{
-		if(m_actualSize<m_numOfElements+1)
+		// the data may be the element of this array, which moves when grown
+		if(&data>=m_head && &data<m_head+m_numOfElements && m_actualSize<m_numOfElements+1)
 		{
-			resize(m_numOfElements+1);
+			size_t dataIdx=&data-m_head;
+			grow(m_numOfElements+1);
+			::new(m_head+m_numOfElements) DataType(m_head[dataIdx]);
 		}
-		*(m_head+m_numOfElements)=data;
+		else
+			::new(prepareBack()) DataType(data);
 		m_numOfElements++;
+		return *this;
 	}
 
 	template <typename DataType>
@@ -405,10 +969,10 @@ namespace epl
 	{
 		if(m_actualSize < m_numOfElements+dArr.m_numOfElements)
 		{
-			resize(m_numOfElements+dArr.m_numOfElements);
+			grow(m_numOfElements+dArr.m_numOfElements);
 		}
 		if(m_head && dArr.m_head && dArr.m_actualSize)
-			System::Memcpy(m_head+m_numOfElements,dArr.m_numOfElements*sizeof(DataType),dArr.m_head,dArr.m_numOfElements*sizeof(DataType));
+			copyElements(m_head+m_numOfElements,dArr.m_head,dArr.m_numOfElements);
 		m_numOfElements+=dArr.m_numOfElements;
 		return *this;
 	}
@@ -419,16 +983,14 @@ namespace epl
 		if(this != &b)
 		{
 			m_arrayLock->Lock();
-			if(m_head)
-				EP_Free(m_head);
-			m_head=NULL;
+			deleteArr();
 			m_arrayLock->Unlock();
 			if(m_arrayLock)
 				EP_DELETE m_arrayLock;
 			m_arrayLock=NULL;
 
 		
-			m_lockPolicy=dArr.m_lockPolicy;
+			m_lockPolicy=b.m_lockPolicy;
 			switch(m_lockPolicy)
 			{
 			case LOCK_POLICY_CRITICALSECTION:
@@ -440,19 +1002,27 @@ namespace epl
 			case LOCK_POLICY_NONE:
 				m_arrayLock=EP_NEW NoLock();
 				break;
+			case LOCK_POLICY_SPIN_PARK:
+				m_arrayLock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				m_arrayLock=EP_NEW ReaderWriterLock();
+				break;
 			default:
 				m_arrayLock=NULL;
 				break;
 			}
-			LockObj lock(dArr.m_arrayLock);
-			m_actualSize=dArr.m_actualSize;
-			m_numOfElements=dArr.m_numOfElements;
+			LockObj lock(b.m_arrayLock);
+			m_actualSize=b.m_actualSize;
+			m_numOfElements=b.m_numOfElements;
 			if(m_actualSize)
+			{
 				m_head=reinterpret_cast<DataType*>(EP_Malloc(sizeof(DataType)*m_actualSize));
+				EP_ASSERT(m_head);
+				copyElements(m_head,b.m_head,m_numOfElements);
+			}
 			else
 				m_head=NULL;
-			EP_ASSERT(m_head);
-			System::Memcpy(m_head,sizeof(DataType)*m_actualSize,dArr.m_head,sizeof(DataType)*m_actualSize);
 
 
 		}
@@ -468,7 +1038,7 @@ namespace epl
 	template <typename DataType>
 	const DataType& DynamicArray<DataType>::operator[](size_t idx) const	
 	{
-		LockObj lock(m_arrayLock);
+		SharedLockObj lock(m_arrayLock);
 		EP_ASSERT(m_numOfElements>idx);
 		return *(m_head+idx);
 	}
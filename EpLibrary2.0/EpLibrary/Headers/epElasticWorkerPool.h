@@ -0,0 +1,304 @@
+/*! 
+@file epElasticWorkerPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Elastic Worker Pool Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Elastic Worker Pool Class.
+
+*/
+#ifndef __EP_ELASTIC_WORKER_POOL_H__
+#define __EP_ELASTIC_WORKER_POOL_H__
+#include "epLib.h"
+#include <vector>
+#include "epBaseWorkerThread.h"
+#include "epBaseJobProcessor.h"
+#include "epJobScheduleQueue.h"
+#include "epLightSemaphore.h"
+
+namespace epl
+{
+	class ElasticWorkerPool;
+
+	/*!
+	@class ElasticWorker epElasticWorkerPool.h
+	@brief A class that implements the worker thread owned by ElasticWorkerPool.
+
+	The worker takes the jobs from the shared queue of the owner,
+	and terminates itself when no job arrives within the keep-alive time.
+	The worker object is kept by the owner and started again when the pool grows.
+	*/
+	class EP_LIBRARY ElasticWorker:public BaseWorkerThread
+	{
+	public:
+		friend class ElasticWorkerPool;
+
+		/*!
+		Default Constructor
+
+		Initializes the worker thread
+		@param[in] owner the pool which owns this worker.
+		@param[in] lockPolicyType The lock policy
+		*/
+		ElasticWorker(ElasticWorkerPool *owner, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the worker thread
+		*/
+		virtual ~ElasticWorker();
+
+	protected:
+		/*!
+		Actual elastic worker Thread Code.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ElasticWorker(const ElasticWorker & b):BaseWorkerThread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ElasticWorker &operator=(const ElasticWorker & b){EP_ASSERT(0);return *this;}
+
+		/// the owner of this worker
+		ElasticWorkerPool *m_owner;
+	};
+
+	/*!
+	@class ElasticWorkerPool epElasticWorkerPool.h
+	@brief A class that implements the worker pool which grows and shrinks with the queue depth.
+
+	The pool starts with the minimum number of workers.
+	When no worker is idle and either the queue depth per worker reaches the grow threshold
+	or no job has been dequeued within the grow latency, a worker is added up to the maximum.
+	A worker which stays idle for the keep-alive time retires, down to the minimum.
+	*/
+	class EP_LIBRARY ElasticWorkerPool
+	{
+	public:
+		friend class ElasticWorker;
+
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] jobProcessor the job processor for all workers in the pool.
+		@param[in] minWorkerCount the minimum number of workers. (at least 1)
+		@param[in] maxWorkerCount the maximum number of workers. (0 means System::GetNumberOfCores())
+		@param[in] keepAliveInMilliSec the idle time before the worker above the minimum retires, in milliseconds.
+		@param[in] lockPolicyType The lock policy
+		*/
+		ElasticWorkerPool(BaseJobProcessor *jobProcessor, unsigned int minWorkerCount=1, unsigned int maxWorkerCount=0, unsigned int keepAliveInMilliSec=60000, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Stop the workers and destroy the pool
+		*/
+		virtual ~ElasticWorkerPool();
+
+		/*!
+		Start the minimum number of workers.
+		@return true if successfully started, otherwise false.
+		*/
+		bool Start();
+
+		/*!
+		Stop all workers in the pool.
+		@param[in] waitTimeInMilliSec the time-out interval for each worker, in milliseconds.
+		@remark the jobs still in the pool are reported as JOB_STATUS_INCOMPLETE.
+		*/
+		void Stop(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Push in the new job to the pool, and grow the pool if needed.
+		@param[in] job the new job to put into the pool.
+		*/
+		void Push(BaseJob * const job);
+
+		/*!
+		Push in the new job to the pool, and return its completion handle.
+		@param[in] job the new job to put into the pool.
+		@return the completion handle of the job.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		*/
+		JobHandle *Submit(BaseJob * const job);
+
+		/*!
+		Get job count in the pool.
+		@return the job count in the pool.
+		*/
+		size_t GetJobCount() const;
+
+		/*!
+		Return the number of running workers.
+		@return the number of running workers.
+		*/
+		unsigned int GetWorkerCount() const;
+
+		/*!
+		Return the number of workers waiting for the job.
+		@return the number of idle workers.
+		*/
+		unsigned int GetIdleWorkerCount() const;
+
+		/*!
+		Copy the metrics summed over all workers, including retired ones, in the pool to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		@remark can be called while the workers are running.
+		*/
+		void GetMetrics(WorkerMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Set the maximum wait time before the queued job is taken regardless of its priority.
+		@param[in] maxWaitInMilliSec the maximum wait time in milliseconds. (WAITTIME_INIFINITE for strict priority)
+		*/
+		void SetMaxWaitTime(unsigned int maxWaitInMilliSec);
+
+		/*!
+		Return the maximum wait time before the queued job is taken regardless of its priority.
+		@return the maximum wait time in milliseconds, or WAITTIME_INIFINITE for strict priority.
+		*/
+		unsigned int GetMaxWaitTime() const;
+
+		/*!
+		Set the queue depth per worker which makes the pool grow.
+		@param[in] jobCountPerWorker the queue depth per running worker. (0 is treated as 1)
+		*/
+		void SetGrowThreshold(unsigned int jobCountPerWorker);
+
+		/*!
+		Return the queue depth per worker which makes the pool grow.
+		@return the queue depth per running worker.
+		*/
+		unsigned int GetGrowThreshold() const;
+
+		/*!
+		Set the time without any dequeue which makes the pool grow.
+		@param[in] latencyInMilliSec the latency in milliseconds.
+		*/
+		void SetGrowLatency(unsigned int latencyInMilliSec);
+
+		/*!
+		Return the time without any dequeue which makes the pool grow.
+		@return the latency in milliseconds.
+		*/
+		unsigned int GetGrowLatency() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ElasticWorkerPool(const ElasticWorkerPool & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ElasticWorkerPool &operator=(const ElasticWorkerPool & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Start a new worker or restart a retired one.
+		@return true if successfully started, otherwise false.
+		@remark m_poolLock must be held.
+		*/
+		bool spawnWorker();
+
+		/*!
+		Add a worker if the queue depth or latency requires it.
+		*/
+		void growIfNeeded();
+
+		/*!
+		Decide whether the idle worker may retire.
+		@return true if the worker should retire, otherwise false.
+		*/
+		bool tryRetire();
+
+		/*!
+		Return the flag whether the pool is stopping.
+		@return true if the pool is stopping, otherwise false.
+		*/
+		bool isStopping() const;
+
+		/// the workers
+		std::vector<ElasticWorker*> m_workers;
+		/// the shared job queue
+		JobScheduleQueue m_jobQueue;
+		/// the job signal
+		LightSemaphore m_jobSignal;
+		/// the job processor
+		BaseJobProcessor *m_jobProcessor;
+		/// the minimum number of workers
+		unsigned int m_minWorkerCount;
+		/// the maximum number of workers
+		unsigned int m_maxWorkerCount;
+		/// the keep-alive time in milliseconds
+		unsigned int m_keepAliveTime;
+		/// the queue depth per worker to grow
+		volatile unsigned int m_growThreshold;
+		/// the latency in milliseconds to grow
+		volatile unsigned int m_growLatency;
+		/// the tick count of the last dequeue
+		volatile long m_lastDequeueTick;
+		/// the number of running workers
+		volatile long m_activeCount;
+		/// the number of idle workers
+		volatile long m_idleCount;
+		/// the flag for stopping
+		volatile long m_isStopping;
+		/// the flag for started
+		volatile long m_isStarted;
+		/// pool lock
+		BaseLock *m_poolLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_ELASTIC_WORKER_POOL_H__
\ No newline at end of file
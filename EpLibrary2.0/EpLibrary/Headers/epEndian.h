@@ -46,9 +46,27 @@ namespace epl
 	/*! 
 	@class Endian epEndian.h
 	@brief A class for Endian.
+
+	The arrays are swapped with SSSE3 shuffles when the processor supports, 
+	and with the byte-swap intrinsics otherwise.
 	*/
 	class EP_LIBRARY Endian
 	{
+	public:
+		/// Enumeration for Endian Type
+		enum EndianType{
+			/// The least significant byte comes first
+			ENDIAN_TYPE_LITTLE=0,
+			/// The most significant byte comes first
+			ENDIAN_TYPE_BIG,
+		};
+
+		/*!
+		Return the endianness of the system.
+		@return the endianness of the system.
+		*/
+		static EndianType GetSystemEndian();
+
 		/*!
 		Swap Short Endianness and return the swapped value.
 		@param[in] value the value to swap.
@@ -91,6 +109,86 @@ namespace epl
 		*/
 		static double Swap(const double value);
 
+		/*!
+		Swap 64-bit Int Endianness and return the swapped value.
+		@param[in] value the value to swap.
+		@return the swapped value
+		*/
+		static __int64 Swap(const __int64 value);
+
+		/*!
+		Swap Unsigned 64-bit Int Endianness and return the swapped value.
+		@param[in] value the value to swap.
+		@return the swapped value
+		*/
+		static unsigned __int64 Swap(const unsigned __int64 value);
+
+		/*!
+		Swap Endianness of the short array in place.
+		@param[in,out] shortList the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(short *shortList, size_t listSize);
+
+		/*!
+		Swap Endianness of the unsigned short array in place.
+		@param[in,out] ushortList the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(unsigned short *ushortList, size_t listSize);
+
+		/*!
+		Swap Endianness of the int array in place.
+		@param[in,out] intList the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(int *intList, size_t listSize);
+
+		/*!
+		Swap Endianness of the unsigned int array in place.
+		@param[in,out] uintList the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(unsigned int *uintList, size_t listSize);
+
+		/*!
+		Swap Endianness of the float array in place.
+		@param[in,out] floatList the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(float *floatList, size_t listSize);
+
+		/*!
+		Swap Endianness of the double array in place.
+		@param[in,out] doubleList the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(double *doubleList, size_t listSize);
+
+		/*!
+		Swap Endianness of the 64-bit int array in place.
+		@param[in,out] int64List the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(__int64 *int64List, size_t listSize);
+
+		/*!
+		Swap Endianness of the unsigned 64-bit int array in place.
+		@param[in,out] uint64List the array to swap.
+		@param[in] listSize the number of the elements.
+		*/
+		static void SwapArray(unsigned __int64 *uint64List, size_t listSize);
+
+		/*!
+		Copy the elements of given byte size with Endianness swapped.
+		@param[out] retBuffer the buffer to copy to.
+		@param[in] buffer the elements to swap.
+		@param[in] elementSize the byte size of the element. (2, 4 or 8)
+		@param[in] count the number of the elements.
+		@remark retBuffer may be same as buffer, but must not overlap it otherwise.
+		*/
+		static void SwapBytes(void *retBuffer, const void *buffer, size_t elementSize, size_t count);
+
 	};
 }
 #endif //__EP_ENDIAN_H__
@@ -0,0 +1,297 @@
+/*! 
+@file epEpochReclaimer.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Epoch-Based Reclamation Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Epoch-Based Memory Reclamation Class.
+
+*/
+#ifndef __EP_EPOCH_RECLAIMER_H__
+#define __EP_EPOCH_RECLAIMER_H__
+#include "epLib.h"
+#include <vector>
+#include "epSystem.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+/// the default maximum number of threads registered to the reclaimer at the same time
+#define EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT 64
+/// the default number of retired pointers per thread to trigger the reclamation
+#define EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD 64
+/// the cache line size to keep the thread slots apart
+#define EPOCH_RECLAIMER_CACHE_LINE_SIZE 64
+
+namespace epl
+{
+	/*! 
+	@class EpochReclaimer epEpochReclaimer.h
+	@brief A class for Epoch-Based Memory Reclamation of the lock-free structures.
+
+	The reader enters the critical region before loading the shared pointers, and leaves after it is done with them.
+	The writer retires the pointer unlinked from the structure instead of deleting it,
+	and the pointer is reclaimed only after every thread in the critical region has left the epoch it was retired in.
+	Each thread keeps its own retire list, so neither Enter/Leave nor Retire takes a lock.
+	@remark the garbage per thread is bounded by the max pending count,
+	        as long as no thread stalls inside the critical region.
+	@remark each thread must call UnregisterThread before it exits, to give its slot back.
+	*/
+	class EP_LIBRARY EpochReclaimer
+	{
+	public:
+		/// the function to reclaim the retired pointer
+		typedef void (*ReclaimFunc)(void *ptr);
+
+		/*!
+		@class EpochGuard epEpochReclaimer.h
+		@brief A class that enters the critical region on construction, and leaves on destruction.
+		*/
+		class EP_LIBRARY EpochGuard
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Enter the critical region of the given reclaimer
+			@param[in] reclaimer the reclaimer to enter
+			*/
+			EpochGuard(EpochReclaimer &reclaimer);
+
+			/*!
+			Default Destructor
+
+			Leave the critical region
+			*/
+			virtual ~EpochGuard();
+		private:
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			EpochGuard(const EpochGuard & b):m_reclaimer(b.m_reclaimer){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			EpochGuard &operator=(const EpochGuard & b){EP_ASSERT(0);return *this;}
+
+			/// the reclaimer entered
+			EpochReclaimer &m_reclaimer;
+		};
+
+		/*!
+		Default Constructor
+
+		Initializes the reclaimer
+		@param[in] maxThreadCount the maximum number of threads registered at the same time.
+		@param[in] reclaimThreshold the number of retired pointers per thread to trigger the reclamation.
+		@param[in] lockPolicyType The lock policy for the orphaned garbage
+		@remark Retire waits for the reclamation when the thread has four times the threshold pending.
+		*/
+		EpochReclaimer(unsigned int maxThreadCount=EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT, unsigned int reclaimThreshold=EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Reclaim all retired pointers and destroy the reclaimer
+		@remark no thread may be in the critical region.
+		*/
+		virtual ~EpochReclaimer();
+
+		/*!
+		Enter the critical region, within which the shared pointers loaded stay valid.
+		@remark reentrant, and registers the calling thread on the first call.
+		*/
+		void Enter();
+
+		/*!
+		Leave the critical region.
+		*/
+		void Leave();
+
+		/*!
+		Retire the pointer unlinked from the shared structure, to be reclaimed when no thread can see it.
+		@param[in] ptr the pointer to retire.
+		@param[in] reclaimFunc the function to reclaim the pointer.
+		@remark called outside the critical region, waits while the thread has too much garbage pending.
+		*/
+		void Retire(void *ptr, ReclaimFunc reclaimFunc);
+
+		/*!
+		Retire the object unlinked from the shared structure, to be deleted when no thread can see it.
+		@param[in] obj the object to retire.
+		*/
+		template<typename ObjectType>
+		void RetireObject(ObjectType *obj)
+		{
+			Retire(obj,&deleteObject<ObjectType>);
+		}
+
+		/*!
+		Try to advance the global epoch, and reclaim the garbage of the calling thread that became safe.
+		@return true if the epoch advanced, otherwise false.
+		*/
+		bool TryReclaim();
+
+		/*!
+		Give back the slot of the calling thread.
+		@remark the garbage still pending is handed over to the reclaimer.
+		*/
+		void UnregisterThread();
+
+		/*!
+		Return the number of retired pointers not reclaimed yet.
+		@return the number of pending pointers.
+		@remark the result may be outdated as soon as returned.
+		*/
+		size_t GetPendingCount() const;
+
+	private:
+		/*!
+		@struct RetiredNode epEpochReclaimer.h
+		@brief A structure for the retired pointer.
+		*/
+		struct RetiredNode
+		{
+			/// the retired pointer
+			void *m_ptr;
+			/// the function to reclaim the pointer
+			ReclaimFunc m_reclaimFunc;
+			/// the global epoch when retired
+			long m_epoch;
+		};
+
+		/*!
+		@struct ThreadSlot epEpochReclaimer.h
+		@brief A structure for the state of the registered thread.
+		*/
+		struct ThreadSlot
+		{
+			/// the announced epoch shifted by 1, with the lowest bit set while in the critical region
+			volatile long m_state;
+			/// the owner thread ID, or 0 if free
+			volatile long m_ownerThreadId;
+			/// the nesting count of the critical region
+			unsigned int m_nestCount;
+			/// the number of retired pointers pending
+			volatile long m_pendingCount;
+			/// the retire list owned by the thread
+			std::vector<RetiredNode> m_retireList;
+			/// padding to keep the slots on the different cache lines
+			char m_padding[EPOCH_RECLAIMER_CACHE_LINE_SIZE];
+		};
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		EpochReclaimer(const EpochReclaimer & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		EpochReclaimer &operator=(const EpochReclaimer & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Delete the given object.
+		@param[in] ptr the object to delete.
+		*/
+		template<typename ObjectType>
+		static void deleteObject(void *ptr)
+		{
+			EP_DELETE static_cast<ObjectType*>(ptr);
+		}
+
+		/*!
+		Return the slot of the calling thread, registering it if not registered.
+		@return the slot of the calling thread.
+		*/
+		ThreadSlot *getSlot();
+
+		/*!
+		Try to advance the global epoch, if every thread in the critical region is in the current epoch.
+		@return true if the epoch advanced, otherwise false.
+		*/
+		bool tryAdvance();
+
+		/*!
+		Reclaim the pointers in the given list, retired two epochs or more before the given epoch.
+		@param[in] retireList the list to reclaim from.
+		@param[in] globalEpoch the current global epoch.
+		@return the number of pointers reclaimed.
+		*/
+		static size_t reclaimList(std::vector<RetiredNode> &retireList, long globalEpoch);
+
+		/*!
+		Reclaim the garbage of the given slot.
+		@param[in] slot the slot of the calling thread.
+		*/
+		void reclaimSlot(ThreadSlot *slot);
+
+		/*!
+		Reclaim the garbage handed over by the unregistered threads.
+		*/
+		void reclaimOrphans();
+
+		/// the global epoch
+		volatile long m_globalEpoch;
+		/// the thread slots
+		ThreadSlot *m_slots;
+		/// the number of thread slots
+		unsigned int m_slotCount;
+		/// the number of retired pointers per thread to trigger the reclamation
+		unsigned int m_reclaimThreshold;
+		/// the TLS index for the slot of the calling thread
+		unsigned long m_tlsIndex;
+		/// the garbage handed over by the unregistered threads
+		std::vector<RetiredNode> m_orphanList;
+		/// the number of orphaned pointers pending
+		volatile long m_orphanCount;
+		/// orphan list lock
+		BaseLock *m_orphanLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+}
+#endif //__EP_EPOCH_RECLAIMER_H__
\ No newline at end of file
@@ -38,20 +38,77 @@ An Interface for Exception.
 #ifndef __EP_EXCEPTION_H__
 #define __EP_EXCEPTION_H__
 #include "epLib.h"
+#include "epAssert.h"
 #include <exception>
+#include <string>
+
+namespace epl
+{
+	/*! 
+	@class ExceptionThrower epException.h
+	@brief A template class throwing the exception of ExceptionType out of the line of the caller.
+
+	The construction and the throw of the exception are kept in one cold function for each exception type,
+	so the checks of EP_VERIFY_* leave only the compare and the branch in the line of the hot loops.
+	If EP_NO_EXCEPTIONS is defined, the error is reported by Assert::Fatal instead of being thrown.
+	*/
+	template<typename ExceptionType>
+	class ExceptionThrower
+	{
+	public:
+		/*!
+		Throw the exception constructed by default.
+		*/
+		static EP_NOINLINE void Throw()
+		{
+#if defined(EP_NO_EXCEPTIONS)
+			Assert::Fatal("EP_VERIFY failed");
+#else //defined(EP_NO_EXCEPTIONS)
+			throw ExceptionType();
+#endif //defined(EP_NO_EXCEPTIONS)
+		}
+
+		/*!
+		Throw the exception with given message.
+		@param[in] message the message for the exception
+		*/
+		static EP_NOINLINE void Throw(const char *message)
+		{
+#if defined(EP_NO_EXCEPTIONS)
+			Assert::Fatal(message);
+#else //defined(EP_NO_EXCEPTIONS)
+			throw ExceptionType(message);
+#endif //defined(EP_NO_EXCEPTIONS)
+		}
+
+		/*!
+		Throw the exception with given message.
+		@param[in] message the message for the exception
+		*/
+		static EP_NOINLINE void Throw(const std::string &message)
+		{
+#if defined(EP_NO_EXCEPTIONS)
+			Assert::Fatal(message.c_str());
+#else //defined(EP_NO_EXCEPTIONS)
+			throw ExceptionType(message);
+#endif //defined(EP_NO_EXCEPTIONS)
+		}
+	};
+}
 
 /*!
 @def EP_VERIFY_EXCEPTION_W_MSG
 @brief Macro Function for verify and throw exception with message.
 @remark Expression must be 0 to throw the given exception like an Assert.
+@remark aborts instead of throwing if EP_NO_EXCEPTIONS is defined.
 @param[in] _Expression the boolean expression to evaluate the exception
 @param[in] _Exception the exception to throw
 @param[in] _Message the message for the exception
 */
 #define EP_VERIFY_EXCEPTION_W_MSG(_Expression,_Exception,_Message)\
 	do{\
-	if(!!!(_Expression)){\
-	throw _Exception(_Message);\
+	if(EP_UNLIKELY(!!!(_Expression))){\
+	epl::ExceptionThrower<_Exception>::Throw(_Message);\
 	}\
 	}while(0)
 
@@ -59,13 +116,14 @@ An Interface for Exception.
 @def EP_VERIFY_EXCEPTION
 @brief Macro Function for verify and throw exception.
 @remark Expression must be 0 to throw the given exception like an Assert.
+@remark aborts instead of throwing if EP_NO_EXCEPTIONS is defined.
 @param[in] _Expression the boolean expression to evaluate the exception
 @param[in] _Exception the exception to throw
 */
 #define EP_VERIFY_EXCEPTION(_Expression,_Exception)\
 	do{\
-	if(!!!(_Expression)){\
-	throw _Exception();\
+	if(EP_UNLIKELY(!!!(_Expression))){\
+	epl::ExceptionThrower<_Exception>::Throw();\
 	}\
 	}while(0)
 
@@ -107,6 +107,24 @@ namespace epl{
 		*/
 		static short FLogL(short input);
 
+		/*!
+		Fast Log Function by upper bound over the array
+		@param[in] input the values for log.
+		@param[out] retOutput the logs of the values, or FLOG_ERROR for 0 (can be same as input)
+		@param[in] count the number of values
+		@remark uses AVX2 or SSE2 if the processor supports.
+		*/
+		static void FLogU(const unsigned int *input, unsigned int *retOutput, size_t count);
+
+		/*!
+		Fast Log Function by lower bound over the array
+		@param[in] input the values for log.
+		@param[out] retOutput the logs of the values, or FLOG_ERROR for 0 (can be same as input)
+		@param[in] count the number of values
+		@remark uses AVX2 or SSE2 if the processor supports.
+		*/
+		static void FLogL(const unsigned int *input, unsigned int *retOutput, size_t count);
+
 	};
 
 	
@@ -78,6 +78,32 @@ namespace epl
 		*/
 		static unsigned int Sqrt(const unsigned int val);
 
+		/*!
+		Exact Integer Square Root Function 
+		@param[in] val the value for sqrt.
+		@return the largest integer whose square is less than or equal to val
+		@remark unlike Sqrt approximating from the table, this uses the hardware square root.
+		*/
+		static unsigned int ISqrt(const unsigned int val);
+
+		/*!
+		Exact Integer Square Root Function over the array
+		@param[in] input the values for sqrt.
+		@param[out] retOutput the square roots of the values (can be same as input)
+		@param[in] count the number of values
+		@remark uses AVX or SSE2 if the processor supports.
+		*/
+		static void ISqrt(const unsigned int *input, unsigned int *retOutput, size_t count);
+
+		/*!
+		Square Root Function over the array
+		@param[in] input the values for sqrt.
+		@param[out] retOutput the square roots of the values (can be same as input)
+		@param[in] count the number of values
+		@remark uses AVX or SSE2 if the processor supports.
+		*/
+		static void Sqrt(const float *input, float *retOutput, size_t count);
+
 	};
 }
 #endif __EP_FAST_SQRT_H__
\ No newline at end of file
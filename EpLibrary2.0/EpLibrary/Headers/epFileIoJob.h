@@ -0,0 +1,179 @@
+/*! 
+@file epFileIoJob.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief File I/O Job Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the job performing the file I/O on the thread pool.
+
+*/
+#ifndef __EP_FILE_IO_JOB_H__
+#define __EP_FILE_IO_JOB_H__
+#include "epLib.h"
+#include "epBaseJob.h"
+
+namespace epl
+{
+	class ThreadPool;
+	class JobHandle;
+
+	/// Enumeration for the File I/O Type
+	enum FileIoType{
+		/// Save to the file
+		FILE_IO_TYPE_SAVE=0,
+		/// Append to the file
+		FILE_IO_TYPE_APPEND,
+		/// Load from the file
+		FILE_IO_TYPE_LOAD,
+	};
+
+	/*!
+	@class FileIoCallbackInterface epFileIoJob.h
+	@brief A class for File I/O Callback Interface.
+	*/
+	class EP_LIBRARY FileIoCallbackInterface
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~FileIoCallbackInterface(){}
+
+		/*!
+		Received when the asynchronous file I/O is completed
+		@param[in] ioType the type of the file I/O
+		@param[in] fileName the name of the file
+		@param[in] result true if the file I/O succeeded, false if failed, cancelled or timed out
+		@remark this is called on the I/O thread before the completion handle becomes ready.
+		*/
+		virtual void OnFileIoComplete(FileIoType ioType, const TCHAR *fileName, bool result)=0;
+	};
+
+	/*!
+	@class FileIoJob epFileIoJob.h
+	@brief A base class for the job performing the file I/O on the thread pool.
+
+	The I/O is moved off the calling thread to the dedicated I/O pool,
+	and the completion is reported to the callback object and the completion handle.
+	*/
+	class EP_LIBRARY FileIoJob: public BaseJob
+	{
+	public:
+		friend class FileIoJobProcessor;
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~FileIoJob();
+
+		/*!
+		Return the type of the file I/O.
+		@return the type of the file I/O.
+		*/
+		FileIoType GetIoType() const;
+
+		/*!
+		Return the name of the file.
+		@return the name of the file.
+		*/
+		const TCHAR *GetFileName() const;
+
+		/*!
+		Return the result of the file I/O.
+		@return true if the file I/O succeeded, otherwise false.
+		@remark valid only after the completion handle becomes ready.
+		*/
+		bool GetResult() const;
+
+		/*!
+		Push this job to the given I/O pool.
+		@param[in] ioPool the thread pool to perform the file I/O.
+		@return the completion handle of this job.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		*/
+		JobHandle *Submit(ThreadPool *ioPool);
+
+	protected:
+		/*!
+		Default Constructor
+
+		Initializes the job
+		@param[in] ioType the type of the file I/O
+		@param[in] fileName the name of the file
+		@param[in] callBackObj the callback object to report the completion. (NULL to report to the handle only)
+		@param[in] lockPolicyType The lock policy
+		*/
+		FileIoJob(FileIoType ioType, const TCHAR *fileName, FileIoCallbackInterface *callBackObj=NULL, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Perform the file I/O, subclasses must implement this function.
+		@return true if the file I/O succeeded, otherwise false.
+		@remark this is called on the I/O thread.
+		*/
+		virtual bool doIo()=0;
+
+		/*!
+		Report the completion to the callback object when the job reaches the final status.
+		@param[in] status The Status of the Job
+		*/
+		virtual void handleReport(const JobStatus status);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		FileIoJob(const FileIoJob & b):BaseJob(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		FileIoJob &operator=(const FileIoJob & b){EP_ASSERT(0);return *this;}
+
+		/// the type of the file I/O
+		FileIoType m_ioType;
+		/// the name of the file
+		EpTString m_fileName;
+		/// the callback object
+		FileIoCallbackInterface *m_callBackObj;
+		/// the result of the file I/O
+		volatile bool m_result;
+		/// the flag whether the completion is reported
+		volatile long m_isReported;
+	};
+}
+
+#endif //__EP_FILE_IO_JOB_H__
\ No newline at end of file
@@ -40,15 +40,47 @@ An Interface for File Stream Class.
 #include "epLib.h"
 #include "epStream.h"
 
+/// The default byte size of the mapped window on the 32-bit system
+#define FILE_STREAM_MAP_WINDOW_SIZE (64*1024*1024)
+
+/// The default byte size of the chunk to read ahead or write behind
+#define FILE_STREAM_CHUNK_SIZE (1024*1024)
+
+/// The alignment of the offset, the byte size and the buffer of the unbuffered I/O, which covers the sector size of the disks
+#define FILE_STREAM_SECTOR_SIZE 4096
+
 namespace epl
 {
 	/*! 
 	@class FileStream epFileStream.h
 	@brief A class for File Stream.
+
+	The stream either loads the whole file into the memory, or maps the file and reads and writes straight on the mapping.
+	The mapping is viewed through the sliding window, so the file larger than the address space can be mapped.
+	The chunked stream reads or writes the file sequentially in chunks with the overlapped I/O, 
+	so the file of any size is processed in the constant memory.
+	The unbuffered chunked stream bypasses the system cache with the sector-aligned I/O,
+	so the large sequential scan neither evicts the cache nor copies the data twice.
 	*/
 	class EP_LIBRARY FileStream:public Stream
 	{
 	public:
+		/// Enumeration for File Stream Map Type
+		enum FileStreamMapType{
+			/// The mapping is read only
+			FILE_STREAM_MAP_TYPE_READ_ONLY=0,
+			/// The mapping is readable and writable
+			FILE_STREAM_MAP_TYPE_READ_WRITE,
+		};
+
+		/// Enumeration for File Stream Chunk Type
+		enum FileStreamChunkType{
+			/// The chunks are read ahead from the file
+			FILE_STREAM_CHUNK_TYPE_READ=0,
+			/// The chunks are written behind to the file
+			FILE_STREAM_CHUNK_TYPE_WRITE,
+		};
+
 		/*!
 		Default Constructor
 
@@ -63,6 +95,7 @@ namespace epl
 
 		Initializes the File Stream
 		@param[in] b the second object
+		@remark the copy of the mapped stream holds the copy of the current window, and is not mapped.
 		*/
 		FileStream(const FileStream& b);
 
@@ -105,6 +138,97 @@ namespace epl
 		*/
 		bool WriteStreamToFile();
 
+		/*!
+		Map the file to the stream, instead of loading it
+		@param[in] mapType the type of the mapping.
+		@param[in] windowSize the byte size of the mapped window. (0 means the whole file on the 64-bit system, 
+		and FILE_STREAM_MAP_WINDOW_SIZE on the 32-bit system)
+		@return true if successful, otherwise false.
+		@remark the seek is set to the start of the file.
+		@remark the writable mapping creates the file if not exists, and grows the file when written over the end.
+		@remark GetStream and GetStreamSize return the current window, and GetMappedSize returns the size of the file.
+		@remark the string longer than the window cannot be read, and ReadInPlace fails across the end of the window.
+		*/
+		bool MapStreamFromFile(FileStreamMapType mapType=FILE_STREAM_MAP_TYPE_READ_ONLY, size_t windowSize=0);
+
+		/*!
+		Unmap the file from the stream
+		@remark the written data stay in the file, and the stream becomes empty.
+		*/
+		void UnmapStream();
+
+		/*!
+		Return the flag whether the file is mapped to the stream
+		@return true if the file is mapped, otherwise false.
+		*/
+		bool IsMapped() const;
+
+		/*!
+		Return the byte size of the mapped file
+		@return the byte size of the mapped file, or 0 if not mapped.
+		*/
+		unsigned __int64 GetMappedSize() const;
+
+		/*!
+		Set the seek of the mapped file
+		@param[in] offset the offset from the start of the file.
+		*/
+		void SetMappedSeek(unsigned __int64 offset);
+
+		/*!
+		Return the seek of the mapped file
+		@return the offset from the start of the file.
+		*/
+		unsigned __int64 GetMappedSeek() const;
+
+		/*!
+		Set the seek of the stream
+		@param[in] seekType The type of Seek to set
+		@param[in] offset The offset from the seek type.
+		@remark the seek of the mapped stream is the offset within the file.
+		*/
+		virtual void SetSeek(const StreamSeekType seekType,size_t offset=0);
+
+		/*!
+		Return the current seek of the stream
+		@return the current seek offset.
+		@remark use GetMappedSeek or GetChunkedSeek for the file larger than 4GB on the 32-bit system.
+		*/
+		virtual size_t GetSeek() const;
+
+		/*!
+		Open the file as the chunked stream, instead of loading it
+		@param[in] chunkType the type of the chunked stream.
+		@param[in] chunkSize the byte size of the chunk.
+		@param[in] isUnbuffered the flag whether to bypass the system cache.
+		@return true if successful, otherwise false.
+		@remark the reading stream keeps the next chunk read ahead, and the writing stream writes the filled chunk behind, 
+		so the stream holds about two chunks at most.
+		@remark the writing stream truncates the file.
+		@remark the chunked stream is sequential, so SetSeek is ignored.
+		@remark the unbuffered stream rounds the chunk up to FILE_STREAM_SECTOR_SIZE, and writes only the whole sectors until closed,
+		so WriteStreamToFile leaves the last partial sector in the stream.
+		*/
+		bool OpenChunkedStream(FileStreamChunkType chunkType=FILE_STREAM_CHUNK_TYPE_READ, size_t chunkSize=FILE_STREAM_CHUNK_SIZE, bool isUnbuffered=false);
+
+		/*!
+		Close the chunked stream
+		@remark the data written behind are flushed to the file, and the stream becomes empty.
+		*/
+		void CloseChunkedStream();
+
+		/*!
+		Return the flag whether the file is opened as the chunked stream
+		@return true if opened as the chunked stream, otherwise false.
+		*/
+		bool IsChunked() const;
+
+		/*!
+		Return the seek of the chunked stream
+		@return the offset from the start of the file.
+		*/
+		unsigned __int64 GetChunkedSeek() const;
+
 	private:
 		/*!
 		Write the value to the stream.
@@ -122,9 +246,125 @@ namespace epl
 		*/
 		virtual bool read(void * value,size_t byteSize);
 
+		/*!
+		Return the seek within the current window, moving the window to the seek if needed.
+		@return the reference to the seek within the current window.
+		*/
+		virtual size_t &readOffset();
+
+		/*!
+		Map the window holding the given offset of the file.
+		@param[in] offset the offset within the mapping.
+		@return true if successful, otherwise false.
+		@remark the seek is moved to the given offset.
+		*/
+		bool slide(unsigned __int64 offset);
+
+		/*!
+		Grow the file and the mapping to hold given byte size.
+		@param[in] byteSize the byte size to hold.
+		@return true if successful, otherwise false.
+		*/
+		bool growMapping(unsigned __int64 byteSize);
+
+		/*!
+		Let the stream buffer borrow the valid bytes of the current window.
+		*/
+		void borrowWindow();
+
+		/*!
+		Unmap the current window.
+		*/
+		void unmapWindow();
+
+		/*!
+		Close the mapping and the file without taking the lock.
+		*/
+		void closeMapping();
+
+		/*!
+		Start reading the next chunk ahead.
+		*/
+		void readAhead();
+
+		/*!
+		Append the chunk read ahead to the stream, and start reading the next one.
+		@return true if any byte is appended, otherwise false.
+		*/
+		bool appendChunk();
+
+		/*!
+		Write the stream behind, and empty the stream.
+		@param[in] isLast the flag whether the stream holds the end of the file, so that the partial sector is written too.
+		@return true if successfully started, otherwise false.
+		@remark the unbuffered stream keeps the partial sector in the stream unless isLast is true.
+		*/
+		bool writeBehind(bool isLast=false);
+
+		/*!
+		Allocate the buffer of the pending I/O, aligned to the sector if unbuffered.
+		@param[in] byteSize the byte size of the buffer.
+		@return true if successful, otherwise false.
+		@remark the previous buffer is freed, so no I/O must be pending.
+		*/
+		bool allocChunk(size_t byteSize);
+
+		/*!
+		Wait for the pending I/O of the chunked stream.
+		@return the byte size transferred by the pending I/O.
+		*/
+		DWORD waitChunk();
+
+		/*!
+		Close the chunked stream without taking the lock.
+		*/
+		void closeChunked();
+
 		/// The file name to load/write the stream
 		EpTString m_fileName;
 
+		/// The mapped file, or INVALID_HANDLE_VALUE if not mapped
+		HANDLE m_fileHandle;
+		/// The file mapping, or NULL if the file is empty
+		HANDLE m_mappingHandle;
+		/// The type of the mapping
+		FileStreamMapType m_mapType;
+		/// The current window, or NULL if not mapped
+		unsigned char *m_view;
+		/// The offset of the current window within the file
+		unsigned __int64 m_viewBase;
+		/// The byte size of the current window
+		size_t m_viewSize;
+		/// The byte size of the window to map, or 0 for the whole file
+		size_t m_windowSize;
+		/// The byte size of the data in the file
+		unsigned __int64 m_mappedSize;
+		/// The byte size of the mapping
+		unsigned __int64 m_mappedCapacity;
+
+		/// The file opened as the chunked stream, or INVALID_HANDLE_VALUE if not opened
+		HANDLE m_chunkHandle;
+		/// The type of the chunked stream
+		FileStreamChunkType m_chunkType;
+		/// The byte size of the chunk
+		size_t m_chunkSize;
+		/// The flag whether the chunked stream bypasses the system cache
+		bool m_isUnbuffered;
+		/// The memory allocated for the buffer of the pending I/O
+		void *m_pendingMemory;
+		/// The buffer of the pending I/O
+		unsigned char *m_pendingChunk;
+		/// The byte size of the buffer of the pending I/O
+		size_t m_pendingCapacity;
+		/// The overlapped structure of the pending I/O
+		OVERLAPPED m_overlapped;
+		/// The flag whether the I/O is pending
+		bool m_isPending;
+		/// The offset of the next I/O within the file
+		unsigned __int64 m_chunkOffset;
+		/// The offset of the start of the stream within the file
+		unsigned __int64 m_chunkBase;
+
 	};
 }
 #endif //__EP_FILE_STREAM_H__
\ No newline at end of file
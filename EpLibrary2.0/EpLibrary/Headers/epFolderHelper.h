@@ -39,8 +39,18 @@ An Interface for the File System Folder Processing Operation.
 #define __EP_FOLDER_HELPER_H__
 #include "epLib.h"
 #include "epSystem.h"
+#include <vector>
+
+/// the byte size from which the files are copied without the system cache
+#define FOLDER_HELPER_UNBUFFERED_COPY_SIZE (16*1024*1024)
+
+/// the number of the files each job of the bulk operations processes
+#define FOLDER_HELPER_BATCH_SIZE 64
+
 namespace epl
 {
+	class ThreadPool;
+
 	/*! 
 	@class FolderHelper epFolderHelper.h
 	@brief This is a class for Folder Processing Class
@@ -80,9 +90,31 @@ namespace epl
 		/*!
 		Delete given folder path from file system
 		@param[in] strPath the file path to delete
-		@return true if the folder is deleted successfully, otherwise false
+		@param[in] pool the thread pool to delete the files and the folders of the same depth in parallel. (NULL to delete on the calling thread)
+		@remark The files are deleted in the batches of FOLDER_HELPER_BATCH_SIZE, and then the folders from the deepest.
+		*/
+		static void DeleteFolder(const TCHAR *strPath, ThreadPool *pool=NULL);
+
+		/*!
+		Find all files and folders under given folder path
+		@param[in] strPath the folder path to scan
+		@param[out] retFileList the full paths of the files found
+		@param[out] retFolderList the full paths of the folders found ending with "\", ordered from the shallowest
+		@param[in] pool the thread pool to list the folders of the same depth in parallel. (NULL to scan on the calling thread)
+		@remark The junctions and the symbolic links to the folders are listed, but not followed.
 		*/
-		static void DeleteFolder(const TCHAR *strPath);
+		static void ScanFolder(const TCHAR *strPath, std::vector<EpTString> &retFileList, std::vector<EpTString> &retFolderList, ThreadPool *pool=NULL);
+
+		/*!
+		Copy the source folder with all its files and folders to the destination folder
+		@param[in] strFromPath the source folder path
+		@param[in] strToPath the destination folder path
+		@param[in] failIfExist if this is true and a destination file exist then fail to copy that file
+		@param[in] pool the thread pool to copy the files in parallel. (NULL to copy on the calling thread)
+		@return true if all files are copied successfully, otherwise false
+		@remark The files larger than FOLDER_HELPER_UNBUFFERED_COPY_SIZE are copied without the system cache.
+		*/
+		static bool CopyFolder(const TCHAR *strFromPath, const TCHAR *strToPath, bool failIfExist=false, ThreadPool *pool=NULL);
 
 		/*!
 		Get Special Folder Path String
@@ -99,6 +131,7 @@ namespace epl
 		@param[in] strToFile the destination file path
 		@param[in] failIfExist if this is true and the destination file exist then fail copy
 		@return true if the copied successfully, otherwise false
+		@remark The files larger than FOLDER_HELPER_UNBUFFERED_COPY_SIZE are copied without the system cache.
 		*/
 		static bool CopyFile(const TCHAR * strFromFile, const TCHAR *strToFile,bool failIfExist=false);
 
@@ -138,10 +171,21 @@ namespace epl
 
 	private:
 		/*!
-		Recursively delete given folder path from file system
-		@param[in] strPath the file path to delete
+		Delete given folder path from file system
+		@param[in] strPath the file path to delete ending with "\"
+		@param[in] pool the thread pool to delete in parallel, or NULL
 		*/
-		static void removeDir(const TCHAR * strPath);
+		static void removeDir(const TCHAR * strPath, ThreadPool *pool);
+
+		/*!
+		Find all files and folders under given folder path level by level
+		@param[in] strPath the folder path to scan ending with "\"
+		@param[out] retFileList the full paths of the files found
+		@param[out] retFileSizeList the byte sizes of the files found
+		@param[out] retFolderLevelList the full paths of the folders found for each depth
+		@param[in] pool the thread pool to list in parallel, or NULL
+		*/
+		static void scanTree(const EpTString &strPath, std::vector<EpTString> &retFileList, std::vector<unsigned __int64> &retFileSizeList, std::vector<std::vector<EpTString> > &retFolderLevelList, ThreadPool *pool);
 	};
 
 	/*! 
@@ -0,0 +1,214 @@
+/*! 
+@file epFrameBatch.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Frame Batch Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the batch of length-prefixed frames written at once.
+
+*/
+#ifndef __EP_FRAME_BATCH_H__
+#define __EP_FRAME_BATCH_H__
+#include "epLib.h"
+#include <vector>
+#include "epStream.h"
+#include "epNetworkStream.h"
+#include "epIpcConf.h"
+#include "epIpcServerInterfaces.h"
+#include "epIpcClientInterfaces.h"
+
+/// the payload byte size from which AddFrameReference references the payload instead of copying it
+#define FRAME_BATCH_COPY_THRESHOLD 512
+
+namespace epl
+{
+	/*!
+	@class FrameBatch epFrameBatch.h
+	@brief A class for the batch of length-prefixed frames written at once.
+
+	Each frame is written as the unsigned int byte size of the payload followed by the payload.
+	The small frames are copied into one buffer so that many of them are coalesced into one write,
+	and the large payloads are only referenced as the segments, and gathered when the batch is flushed.
+	*/
+	class EP_LIBRARY FrameBatch
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty batch
+		@param[in] lockPolicyType The lock policy
+		*/
+		FrameBatch(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the batch with the same frames as given batch
+		@param[in] b the second object
+		@remark the referenced payloads are not copied, and still referenced by both batches.
+		*/
+		FrameBatch(const FrameBatch& b);
+
+		/*!
+		Default Destructor
+
+		Destroy the batch
+		*/
+		virtual ~FrameBatch();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		FrameBatch & operator=(const FrameBatch&b);
+
+		/*!
+		Copy the frame into the batch.
+		@param[in] data the payload of the frame
+		@param[in] dataByteSize the byte size of the payload
+		@return true if successful, otherwise false.
+		*/
+		bool AddFrame(const void *data, unsigned int dataByteSize);
+
+		/*!
+		Add the frame referencing the payload without copying it.
+		@param[in] data the payload of the frame
+		@param[in] dataByteSize the byte size of the payload
+		@return true if successful, otherwise false.
+		@remark the payload smaller than FRAME_BATCH_COPY_THRESHOLD is copied, since gathering it costs more than copying.
+		@remark the payload referenced must stay valid until the batch is flushed or cleared.
+		*/
+		bool AddFrameReference(const void *data, unsigned int dataByteSize);
+
+		/*!
+		Return the number of the frames in the batch.
+		@return the number of the frames.
+		*/
+		size_t GetFrameCount() const;
+
+		/*!
+		Return the byte size of the batch including the length prefixes.
+		@return the byte size of the batch.
+		*/
+		size_t GetByteSize() const;
+
+		/*!
+		Remove all frames from the batch.
+		*/
+		void Clear();
+
+		/*!
+		Write all frames to the pipe, and clear the batch.
+		@param[in] pipe the pipe to write to.
+		@return true if successful, false if any frame is larger than the maximum write size of the pipe.
+		@remark the frames are packed into as few writes as possible, and no frame is split across the writes.
+		@remark nothing is written and the batch is kept if failed.
+		*/
+		bool Flush(IpcInterface *pipe);
+
+		/*!
+		Write all frames to the client pipe, and clear the batch.
+		@param[in] client the client to write to.
+		@return true if successful, false if any frame is larger than the maximum write size of the client.
+		@remark the frames are packed into as few writes as possible, and no frame is split across the writes.
+		@remark nothing is written and the batch is kept if failed.
+		*/
+		bool Flush(IpcClientInterface *client);
+
+		/*!
+		Write all frames to the stream, and clear the batch.
+		@param[in] stream the stream to write to.
+		@return true if successful, otherwise false.
+		@remark the stream is locked once for the whole batch.
+		*/
+		bool Flush(Stream &stream);
+
+		/*!
+		Read the next frame from the network stream in place without copying.
+		@param[in] stream the stream to read from.
+		@param[out] retFrame the payload of the frame read.
+		@param[out] retFrameByteSize the byte size of the payload read.
+		@return true if the whole frame is read, false if the stream does not hold the whole frame yet.
+		@remark the read seek is left unchanged if failed, so the frame can be read again after more data arrives.
+		@remark the payload is valid only until the stream is modified or flushed.
+		*/
+		static bool ReadFrame(NetworkStream &stream, const unsigned char *&retFrame, unsigned int &retFrameByteSize);
+
+	private:
+		/*!
+		@struct Frame epFrameBatch.h
+		@brief A struct for the frame in the batch.
+		*/
+		struct Frame{
+			/// Offset of the frame within the buffer
+			size_t m_offset;
+			/// Byte size of the frame within the buffer
+			unsigned int m_byteSize;
+			/// Payload referenced, or NULL if the payload is in the buffer
+			const void *m_reference;
+			/// Byte size of the payload referenced
+			unsigned int m_referenceSize;
+		};
+
+		/*!
+		Add the frame to the batch.
+		@param[in] data the payload of the frame
+		@param[in] dataByteSize the byte size of the payload
+		@param[in] isReferenced the flag whether the payload is referenced instead of copied
+		@return true if successful, otherwise false.
+		*/
+		bool addFrame(const void *data, unsigned int dataByteSize, bool isReferenced);
+
+		/*!
+		Gather the frames into the writes no larger than given size.
+		@param[in] maxWriteByteSize the maximum byte size of one write.
+		@param[out] retSegmentList the segments of all writes.
+		@param[out] retWriteList the number of the segments of each write.
+		@return true if successful, false if any frame is larger than the maximum.
+		*/
+		bool gather(unsigned int maxWriteByteSize, std::vector<IpcWriteSegment> &retSegmentList, std::vector<unsigned int> &retWriteList) const;
+
+		/// the buffer holding the length prefixes and the copied payloads
+		StreamBuffer m_buffer;
+		/// the frames in the batch
+		std::vector<Frame> m_frameList;
+		/// the byte size of the batch
+		size_t m_byteSize;
+		/// batch lock
+		BaseLock *m_batchLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_FRAME_BATCH_H__
\ No newline at end of file
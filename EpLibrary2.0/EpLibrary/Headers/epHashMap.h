@@ -0,0 +1,957 @@
+/*! 
+@file epHashMap.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Open-Addressing Hash Map Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Open-Addressing Hash Map Template Class.
+
+*/
+#ifndef __EP_HASH_MAP_H__
+#define __EP_HASH_MAP_H__
+#include "epLib.h"
+#include "epAlgorithm.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+using namespace std;
+
+/// the default capacity of the hash map
+#define HASH_MAP_DEFAULT_CAPACITY 16
+/// the maximum load factor of the hash map in percent
+#define HASH_MAP_MAX_LOAD_PERCENT 80
+/// the default number of stripes of the striped hash map
+#define STRIPED_HASH_MAP_DEFAULT_STRIPE_COUNT 16
+
+namespace epl
+{
+	/*!
+	Hash the given bytes
+	@param[in] data the bytes to hash
+	@param[in] size the number of bytes
+	@return the hash value of the bytes
+	*/
+	inline size_t HashBytes(const void *data, size_t size)
+	{
+		const unsigned char *bytes=reinterpret_cast<const unsigned char*>(data);
+#ifdef  _WIN64
+		// FNV-1a followed by the murmur3 finalizer, so the high bits mix as well as the low bits
+		size_t retHash=(static_cast<size_t>(0xcbf29ce4)<<32)|0x84222325;
+		const size_t prime=(static_cast<size_t>(0x00000100)<<32)|0x000001b3;
+		for(size_t byteTrav=0;byteTrav<size;byteTrav++)
+		{
+			retHash^=bytes[byteTrav];
+			retHash*=prime;
+		}
+		retHash^=retHash>>33;
+		retHash*=(static_cast<size_t>(0xff51afd7)<<32)|0xed558ccd;
+		retHash^=retHash>>33;
+		retHash*=(static_cast<size_t>(0xc4ceb9fe)<<32)|0x1a85ec53;
+		retHash^=retHash>>33;
+#else //_WIN64
+		// FNV-1a followed by the murmur3 finalizer, so the high bits mix as well as the low bits
+		size_t retHash=0x811c9dc5;
+		for(size_t byteTrav=0;byteTrav<size;byteTrav++)
+		{
+			retHash^=bytes[byteTrav];
+			retHash*=0x01000193;
+		}
+		retHash^=retHash>>16;
+		retHash*=0x85ebca6b;
+		retHash^=retHash>>13;
+		retHash*=0xc2b2ae35;
+		retHash^=retHash>>16;
+#endif //_WIN64
+		return retHash;
+	}
+
+	/*! 
+	@class HashClass epHashMap.h
+	@brief A template Hash Class for the Hashing of the objects.	
+
+	The default hashes the bytes of the object, so it fits the plain keys without padding.
+	std::string and std::wstring hash their characters.
+	*/
+	template <typename T>
+	class HashClass{
+	public:
+		/*!
+		Default Constructor
+		*/
+		HashClass(){}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~HashClass(){}
+
+		/*!
+		Hash Function
+		@param[in] a the pointer to the object to hash
+		@return the hash value of the object
+		*/
+		static size_t HashFunc(const void *a);
+	};
+
+	template<typename T>
+	size_t HashClass<T>::HashFunc(const void * a)
+	{
+		return HashBytes(a,sizeof(T));
+	}
+
+	template<>
+	inline size_t HashClass<std::string>::HashFunc(const void * a)
+	{
+		const std::string *str=reinterpret_cast<const std::string*>(a);
+		return HashBytes(str->c_str(),str->size()*sizeof(char));
+	}
+
+	template<>
+	inline size_t HashClass<std::wstring>::HashFunc(const void * a)
+	{
+		const std::wstring *str=reinterpret_cast<const std::wstring*>(a);
+		return HashBytes(str->c_str(),str->size()*sizeof(wchar_t));
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	class StripedHashMap;
+
+	/*! 
+	@class HashMap epHashMap.h
+	@brief An Open-Addressing Hash Map Template class.
+
+	The map uses the Robin Hood probing, which keeps the probe length short and the variance low,
+	and the backward-shift deletion, which leaves no tombstones behind.
+	The hashes, the keys and the data are kept in separate contiguous arrays,
+	so the probe compares the stored hashes before touching any key.
+	The reference to the data returned is valid only until the map is modified.
+	*/
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *)=HashClass<KeyType>::HashFunc, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)=CompClass<KeyType>::CompFunc>
+	class HashMap
+	{
+	public:
+		friend class StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>;
+
+		/*!
+		Default Constructor
+
+		Initializes the Hash Map
+		@param[in] capacity the initial number of keys the map can hold without growing
+		@param[in] lockPolicyType The lock policy
+		*/
+		HashMap(size_t capacity=HASH_MAP_DEFAULT_CAPACITY, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the Hash Map with given map
+		@param[in] b the Hash Map Object to copy from
+		*/
+		HashMap(const HashMap & b);
+
+		/*!
+		Default Destructor
+
+		Destroys the Hash Map
+		*/
+		virtual ~HashMap();
+
+		/*!
+		Initialize this map to given map
+		@param[in] b the Hash Map structure to initialize this map
+		@return the result Hash Map
+		*/
+		HashMap &operator=(const HashMap & b);
+
+		/*!
+		Return the reference to data with given key if not exist insert and return the reference to data
+		@param[in] key The key to return the reference to the data.
+		@return the reference to the data with given key.
+		*/
+		DataType &operator[](const KeyType & key);
+
+		/*!
+		Return the reference to data with given key and return the reference to data
+		@param[in] key The key to return the reference to the data.
+		@return the reference to the data with given key.
+		*/
+		const DataType &operator[](const KeyType & key) const;
+
+		/*!
+		Insert the key with given data to the map
+		@param[in] key The key value to insert.
+		@param[in] data the data with the given key
+		@return true if succeeded otherwise false if the key already exists
+		*/
+		bool Insert(const KeyType &key, const DataType &data);
+
+		/*!
+		Insert the key with given data to the map, or replace the data if the key already exists
+		@param[in] key The key value to set.
+		@param[in] data the data with the given key
+		*/
+		void Set(const KeyType &key, const DataType &data);
+
+		/*!
+		Remove the given key from the map
+		@param[in] key The key value to remove
+		@return true if succeeded otherwise false
+		*/
+		bool Erase(const KeyType &key);
+
+		/*!
+		Find the given key from the map and return the data with the given key
+		@param[in] key The key value to find
+		@param[out] retData the data with the given key
+		@return true if succeeded otherwise false
+		*/
+		bool Find(const KeyType &key, DataType &retData) const;
+
+		/*!
+		Check if the given key exists in the map
+		@param[in] key The key value to check
+		@return true if exists otherwise false
+		*/
+		bool IsExist(const KeyType &key) const;
+
+		/*!
+		Make the map hold the given number of keys without growing
+		@param[in] count the number of keys
+		*/
+		void Reserve(size_t count);
+
+		/*!
+		Clear the map
+		*/
+		void Clear();
+
+		/*!
+		Check if the map is empty
+		@return true if the map is empty otherwise false
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		return the number of element in the map.
+		@return the number of element in the map
+		*/
+		size_t Size() const;
+
+		/*!
+		return the number of slots in the map.
+		@return the number of slots in the map
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Copy the all keys in the map to the given list
+		@param[out] retKeyList the list to receive the keys
+		*/
+		void GetKeyList(vector<KeyType> &retKeyList) const;
+
+	protected:
+		/*!
+		Actually return the slot index of the given key
+		@param[in] key the key to find
+		@param[in] hash the hash of the key
+		@return the slot index of the key, or the capacity if not found
+		*/
+		size_t findIndex(const KeyType &key, size_t hash) const;
+
+		/*!
+		Actually insert the given key not existing in the map
+		@param[in] key the key to insert
+		@param[in] data the data with the given key
+		@param[in] hash the hash of the key
+		@return the slot index of the key inserted
+		*/
+		size_t insertNew(const KeyType &key, const DataType &data, size_t hash);
+
+		/*!
+		Actually remove the key in given slot
+		@param[in] idx the slot index to remove
+		*/
+		void eraseIndex(size_t idx);
+
+		/*!
+		Rebuild the slots with given capacity
+		@param[in] capacity the new number of slots (power of two)
+		*/
+		void rehash(size_t capacity);
+
+		/*!
+		Grow the slots if one more key exceeds the maximum load factor
+		*/
+		void growIfNeeded();
+
+		/*!
+		Return the number of slots needed to hold the given number of keys
+		@param[in] count the number of keys
+		@return the number of slots (power of two)
+		*/
+		static size_t capacityFor(size_t count);
+
+		/*!
+		Return the hash of the given key, which is never 0
+		@param[in] key the key to hash
+		@return the hash of the key
+		*/
+		static size_t hashKey(const KeyType &key)
+		{
+			size_t retHash=KeyHashFunc(&key);
+			// 0 marks the empty slot
+			if(retHash==0)
+				retHash=1;
+			return retHash;
+		}
+
+		/*!
+		Return the distance of the given slot from the home slot of the given hash
+		@param[in] hash the hash stored in the slot
+		@param[in] idx the slot index
+		@return the probe distance
+		*/
+		size_t probeDistance(size_t hash, size_t idx) const
+		{
+			return (idx-(hash&m_mask))&m_mask;
+		}
+
+		/// hash list (0 if the slot is empty)
+		vector<size_t> m_hashList;
+		/// key list
+		vector<KeyType> m_keyList;
+		/// data list
+		vector<DataType> m_dataList;
+		/// the number of keys in the map
+		size_t m_size;
+		/// the mask for the slot index
+		size_t m_mask;
+		/// lock
+		BaseLock *m_mapLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class StripedHashMap epHashMap.h
+	@brief A Concurrent Hash Map Template class with the striped locks.
+
+	The keys are spread over the independent HashMaps by the high bits of the hash,
+	so the threads working on the different stripes do not wait for each other.
+	*/
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *)=HashClass<KeyType>::HashFunc, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)=CompClass<KeyType>::CompFunc>
+	class StripedHashMap
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Striped Hash Map
+		@param[in] stripeCount the number of stripes (rounded up to power of two, at most 256)
+		@param[in] capacity the initial number of keys the map can hold without growing
+		@param[in] lockPolicyType The lock policy of each stripe
+		*/
+		StripedHashMap(unsigned int stripeCount=STRIPED_HASH_MAP_DEFAULT_STRIPE_COUNT, size_t capacity=HASH_MAP_DEFAULT_CAPACITY, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the Striped Hash Map
+		*/
+		virtual ~StripedHashMap();
+
+		/*!
+		Insert the key with given data to the map
+		@param[in] key The key value to insert.
+		@param[in] data the data with the given key
+		@return true if succeeded otherwise false if the key already exists
+		*/
+		bool Insert(const KeyType &key, const DataType &data);
+
+		/*!
+		Insert the key with given data to the map, or replace the data if the key already exists
+		@param[in] key The key value to set.
+		@param[in] data the data with the given key
+		*/
+		void Set(const KeyType &key, const DataType &data);
+
+		/*!
+		Remove the given key from the map
+		@param[in] key The key value to remove
+		@return true if succeeded otherwise false
+		*/
+		bool Erase(const KeyType &key);
+
+		/*!
+		Find the given key from the map and return the data with the given key
+		@param[in] key The key value to find
+		@param[out] retData the data with the given key
+		@return true if succeeded otherwise false
+		*/
+		bool Find(const KeyType &key, DataType &retData) const;
+
+		/*!
+		Check if the given key exists in the map
+		@param[in] key The key value to check
+		@return true if exists otherwise false
+		*/
+		bool IsExist(const KeyType &key) const;
+
+		/*!
+		Clear the map
+		*/
+		void Clear();
+
+		/*!
+		Check if the map is empty
+		@return true if the map is empty otherwise false
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		return the number of element in the map.
+		@return the number of element in the map
+		@remark the result may be outdated as soon as returned.
+		*/
+		size_t Size() const;
+
+		/*!
+		return the number of stripes.
+		@return the number of stripes
+		*/
+		unsigned int GetStripeCount() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		StripedHashMap(const StripedHashMap & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		StripedHashMap &operator=(const StripedHashMap & b){EP_ASSERT(0);return *this;}
+
+		/// the type of the stripe
+		typedef HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc> StripeType;
+
+		/*!
+		Return the stripe of the given hash
+		@param[in] hash the hash of the key
+		@return the stripe for the hash
+		*/
+		StripeType *getStripe(size_t hash) const
+		{
+			if(m_stripeBits==0)
+				return m_stripeList[0];
+			return m_stripeList[hash>>(sizeof(size_t)*8-m_stripeBits)];
+		}
+
+		/// the stripes
+		vector<StripeType*> m_stripeList;
+		/// the number of the hash bits selecting the stripe
+		unsigned int m_stripeBits;
+	};
+
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::HashMap(size_t capacity, LockPolicy lockPolicyType)
+	{
+		m_size=0;
+		size_t slotCount=capacityFor(capacity);
+		m_mask=slotCount-1;
+		m_hashList.resize(slotCount,0);
+		m_keyList.resize(slotCount);
+		m_dataList.resize(slotCount);
+		m_lockPolicy=lockPolicyType;
+		switch(lockPolicyType)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			m_mapLock=EP_NEW CriticalSectionEx();
+			break;
+		case LOCK_POLICY_MUTEX:
+			m_mapLock=EP_NEW Mutex();
+			break;
+		case LOCK_POLICY_NONE:
+			m_mapLock=EP_NEW NoLock();
+			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_mapLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_mapLock=EP_NEW ReaderWriterLock();
+			break;
+		default:
+			m_mapLock=NULL;
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::HashMap(const HashMap & b)
+	{
+		m_lockPolicy=b.m_lockPolicy;
+		switch(m_lockPolicy)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			m_mapLock=EP_NEW CriticalSectionEx();
+			break;
+		case LOCK_POLICY_MUTEX:
+			m_mapLock=EP_NEW Mutex();
+			break;
+		case LOCK_POLICY_NONE:
+			m_mapLock=EP_NEW NoLock();
+			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_mapLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_mapLock=EP_NEW ReaderWriterLock();
+			break;
+		default:
+			m_mapLock=NULL;
+			break;
+		}
+		SharedLockObj lock(b.m_mapLock);
+		m_hashList=b.m_hashList;
+		m_keyList=b.m_keyList;
+		m_dataList=b.m_dataList;
+		m_size=b.m_size;
+		m_mask=b.m_mask;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::~HashMap()
+	{
+		if(m_mapLock)
+			EP_DELETE m_mapLock;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc> &HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::operator=(const HashMap & b)
+	{
+		if(this!=&b)
+		{
+			vector<size_t> hashList;
+			vector<KeyType> keyList;
+			vector<DataType> dataList;
+			size_t size;
+			size_t mask;
+			{
+				SharedLockObj lock(b.m_mapLock);
+				hashList=b.m_hashList;
+				keyList=b.m_keyList;
+				dataList=b.m_dataList;
+				size=b.m_size;
+				mask=b.m_mask;
+			}
+			LockObj lock(m_mapLock);
+			m_hashList.swap(hashList);
+			m_keyList.swap(keyList);
+			m_dataList.swap(dataList);
+			m_size=size;
+			m_mask=mask;
+		}
+		return *this;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	DataType &HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::operator[](const KeyType & key)
+	{
+		size_t hash=hashKey(key);
+		LockObj lock(m_mapLock);
+		size_t idx=findIndex(key,hash);
+		if(idx>m_mask)
+		{
+			growIfNeeded();
+			idx=insertNew(key,DataType(),hash);
+		}
+		return m_dataList[idx];
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	const DataType &HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::operator[](const KeyType & key) const
+	{
+		size_t hash=hashKey(key);
+		SharedLockObj lock(m_mapLock);
+		size_t idx=findIndex(key,hash);
+		EP_ASSERT_EXPR(idx<=m_mask,_T("The given key does not exist in the map"));
+		return m_dataList[idx];
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Insert(const KeyType &key, const DataType &data)
+	{
+		size_t hash=hashKey(key);
+		LockObj lock(m_mapLock);
+		if(findIndex(key,hash)<=m_mask)
+			return false;
+		growIfNeeded();
+		insertNew(key,data,hash);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Set(const KeyType &key, const DataType &data)
+	{
+		size_t hash=hashKey(key);
+		LockObj lock(m_mapLock);
+		size_t idx=findIndex(key,hash);
+		if(idx<=m_mask)
+		{
+			m_dataList[idx]=data;
+			return;
+		}
+		growIfNeeded();
+		insertNew(key,data,hash);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Erase(const KeyType &key)
+	{
+		size_t hash=hashKey(key);
+		LockObj lock(m_mapLock);
+		size_t idx=findIndex(key,hash);
+		if(idx>m_mask)
+			return false;
+		eraseIndex(idx);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Find(const KeyType &key, DataType &retData) const
+	{
+		size_t hash=hashKey(key);
+		SharedLockObj lock(m_mapLock);
+		size_t idx=findIndex(key,hash);
+		if(idx>m_mask)
+			return false;
+		retData=m_dataList[idx];
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::IsExist(const KeyType &key) const
+	{
+		size_t hash=hashKey(key);
+		SharedLockObj lock(m_mapLock);
+		return findIndex(key,hash)<=m_mask;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Reserve(size_t count)
+	{
+		LockObj lock(m_mapLock);
+		size_t slotCount=capacityFor(count);
+		if(slotCount>m_mask+1)
+			rehash(slotCount);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Clear()
+	{
+		LockObj lock(m_mapLock);
+		size_t slotCount=m_mask+1;
+		m_hashList.assign(slotCount,0);
+		m_keyList.assign(slotCount,KeyType());
+		m_dataList.assign(slotCount,DataType());
+		m_size=0;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::IsEmpty() const
+	{
+		SharedLockObj lock(m_mapLock);
+		return m_size==0;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Size() const
+	{
+		SharedLockObj lock(m_mapLock);
+		return m_size;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetCapacity() const
+	{
+		SharedLockObj lock(m_mapLock);
+		return m_mask+1;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetKeyList(vector<KeyType> &retKeyList) const
+	{
+		SharedLockObj lock(m_mapLock);
+		retKeyList.reserve(retKeyList.size()+m_size);
+		for(size_t slotTrav=0;slotTrav<=m_mask;slotTrav++)
+		{
+			if(m_hashList[slotTrav])
+				retKeyList.push_back(m_keyList[slotTrav]);
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::findIndex(const KeyType &key, size_t hash) const
+	{
+		size_t idx=hash&m_mask;
+		size_t distance=0;
+		while(true)
+		{
+			size_t slotHash=m_hashList[idx];
+			// the key would have displaced the slot closer to its home, so it does not exist
+			if(slotHash==0 || distance>probeDistance(slotHash,idx))
+				return m_mask+1;
+			if(slotHash==hash && KeyCompareFunc(&key,&m_keyList[idx])==COMP_RESULT_EQUAL)
+				return idx;
+			idx=(idx+1)&m_mask;
+			distance++;
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::insertNew(const KeyType &key, const DataType &data, size_t hash)
+	{
+		KeyType curKey=key;
+		DataType curData=data;
+		size_t curHash=hash;
+		size_t idx=curHash&m_mask;
+		size_t distance=0;
+		size_t retIdx=m_mask+1;
+		m_size++;
+		while(true)
+		{
+			size_t slotHash=m_hashList[idx];
+			if(slotHash==0)
+			{
+				m_hashList[idx]=curHash;
+				std::swap(m_keyList[idx],curKey);
+				std::swap(m_dataList[idx],curData);
+				if(retIdx>m_mask)
+					retIdx=idx;
+				return retIdx;
+			}
+			size_t slotDistance=probeDistance(slotHash,idx);
+			if(slotDistance<distance)
+			{
+				// take the slot from the richer key, and carry it on
+				std::swap(m_hashList[idx],curHash);
+				std::swap(m_keyList[idx],curKey);
+				std::swap(m_dataList[idx],curData);
+				if(retIdx>m_mask)
+					retIdx=idx;
+				distance=slotDistance;
+			}
+			idx=(idx+1)&m_mask;
+			distance++;
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::eraseIndex(size_t idx)
+	{
+		size_t nextIdx=(idx+1)&m_mask;
+		while(m_hashList[nextIdx]!=0 && probeDistance(m_hashList[nextIdx],nextIdx)!=0)
+		{
+			m_hashList[idx]=m_hashList[nextIdx];
+			std::swap(m_keyList[idx],m_keyList[nextIdx]);
+			std::swap(m_dataList[idx],m_dataList[nextIdx]);
+			idx=nextIdx;
+			nextIdx=(nextIdx+1)&m_mask;
+		}
+		m_hashList[idx]=0;
+		m_keyList[idx]=KeyType();
+		m_dataList[idx]=DataType();
+		m_size--;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::rehash(size_t capacity)
+	{
+		vector<size_t> hashList(capacity,0);
+		vector<KeyType> keyList(capacity);
+		vector<DataType> dataList(capacity);
+		m_hashList.swap(hashList);
+		m_keyList.swap(keyList);
+		m_dataList.swap(dataList);
+		m_mask=capacity-1;
+		m_size=0;
+		for(size_t slotTrav=0;slotTrav<hashList.size();slotTrav++)
+		{
+			if(hashList[slotTrav])
+				insertNew(keyList[slotTrav],dataList[slotTrav],hashList[slotTrav]);
+		}
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::growIfNeeded()
+	{
+		if((m_size+1)*100>(m_mask+1)*HASH_MAP_MAX_LOAD_PERCENT)
+			rehash((m_mask+1)*2);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t HashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::capacityFor(size_t count)
+	{
+		size_t retCapacity=8;
+		while(count*100>retCapacity*HASH_MAP_MAX_LOAD_PERCENT)
+			retCapacity*=2;
+		return retCapacity;
+	}
+
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::StripedHashMap(unsigned int stripeCount, size_t capacity, LockPolicy lockPolicyType)
+	{
+		m_stripeBits=0;
+		while((1U<<m_stripeBits)<stripeCount && m_stripeBits<8)
+			m_stripeBits++;
+		unsigned int actualCount=1U<<m_stripeBits;
+		for(unsigned int stripeTrav=0;stripeTrav<actualCount;stripeTrav++)
+			m_stripeList.push_back(EP_NEW StripeType(capacity/actualCount,lockPolicyType));
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::~StripedHashMap()
+	{
+		for(size_t stripeTrav=0;stripeTrav<m_stripeList.size();stripeTrav++)
+			EP_DELETE m_stripeList[stripeTrav];
+		m_stripeList.clear();
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Insert(const KeyType &key, const DataType &data)
+	{
+		size_t hash=StripeType::hashKey(key);
+		StripeType *stripe=getStripe(hash);
+		LockObj lock(stripe->m_mapLock);
+		if(stripe->findIndex(key,hash)<=stripe->m_mask)
+			return false;
+		stripe->growIfNeeded();
+		stripe->insertNew(key,data,hash);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Set(const KeyType &key, const DataType &data)
+	{
+		size_t hash=StripeType::hashKey(key);
+		StripeType *stripe=getStripe(hash);
+		LockObj lock(stripe->m_mapLock);
+		size_t idx=stripe->findIndex(key,hash);
+		if(idx<=stripe->m_mask)
+		{
+			stripe->m_dataList[idx]=data;
+			return;
+		}
+		stripe->growIfNeeded();
+		stripe->insertNew(key,data,hash);
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Erase(const KeyType &key)
+	{
+		size_t hash=StripeType::hashKey(key);
+		StripeType *stripe=getStripe(hash);
+		LockObj lock(stripe->m_mapLock);
+		size_t idx=stripe->findIndex(key,hash);
+		if(idx>stripe->m_mask)
+			return false;
+		stripe->eraseIndex(idx);
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Find(const KeyType &key, DataType &retData) const
+	{
+		size_t hash=StripeType::hashKey(key);
+		StripeType *stripe=getStripe(hash);
+		SharedLockObj lock(stripe->m_mapLock);
+		size_t idx=stripe->findIndex(key,hash);
+		if(idx>stripe->m_mask)
+			return false;
+		retData=stripe->m_dataList[idx];
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::IsExist(const KeyType &key) const
+	{
+		size_t hash=StripeType::hashKey(key);
+		StripeType *stripe=getStripe(hash);
+		SharedLockObj lock(stripe->m_mapLock);
+		return stripe->findIndex(key,hash)<=stripe->m_mask;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	void StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Clear()
+	{
+		for(size_t stripeTrav=0;stripeTrav<m_stripeList.size();stripeTrav++)
+			m_stripeList[stripeTrav]->Clear();
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	bool StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::IsEmpty() const
+	{
+		for(size_t stripeTrav=0;stripeTrav<m_stripeList.size();stripeTrav++)
+		{
+			if(!m_stripeList[stripeTrav]->IsEmpty())
+				return false;
+		}
+		return true;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	size_t StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::Size() const
+	{
+		size_t retSize=0;
+		for(size_t stripeTrav=0;stripeTrav<m_stripeList.size();stripeTrav++)
+			retSize+=m_stripeList[stripeTrav]->Size();
+		return retSize;
+	}
+
+	template<typename KeyType, typename DataType, size_t (__cdecl *KeyHashFunc)(const void *), CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	unsigned int StripedHashMap<KeyType,DataType,KeyHashFunc,KeyCompareFunc>::GetStripeCount() const
+	{
+		return static_cast<unsigned int>(m_stripeList.size());
+	}
+}
+#endif //__EP_HASH_MAP_H__
\ No newline at end of file
@@ -0,0 +1,390 @@
+/*! 
+@file epInlineLock.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief InlineLock Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Inline Lock Template Class.
+
+*/
+#ifndef __EP_INLINE_LOCK_H__
+#define __EP_INLINE_LOCK_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseLock.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+namespace epl
+{
+	/*! 
+	@class InlineLock epInlineLock.h
+	@brief A template class that holds the lock of given type within the object.
+
+	The calls are bound at compile time, so no allocation or virtual dispatch is needed,
+	and InlineLock<NoLock> compiles down to nothing.
+	InlineLock<BaseLock> holds the lock chosen by LockPolicy at runtime instead.
+	*/
+	template<typename LockType>
+	class InlineLock
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		@param[in] lockPolicyType ignored, since the lock type is given at compile time.
+		*/
+		InlineLock(LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		{
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the new lock
+		@param[in] b the second object
+		*/
+		InlineLock(const InlineLock<LockType>& b)
+		{
+		}
+
+		/*!
+		Assignment operator overloading
+
+		Keeps the lock as it is.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		InlineLock<LockType> & operator=(const InlineLock<LockType>&b)
+		{
+			return *this;
+		}
+
+		/*!
+		Locks the lock
+		*/
+		void Lock() const
+		{
+			m_lock.LockType::Lock();
+		}
+
+		/*!
+		Unlocks the lock
+		*/
+		void Unlock() const
+		{
+			m_lock.LockType::Unlock();
+		}
+
+		/*!
+		Locks the lock for reading
+		*/
+		void LockShared() const
+		{
+			m_lock.LockType::LockShared();
+		}
+
+		/*!
+		Unlocks the lock for reading
+		*/
+		void UnlockShared() const
+		{
+			m_lock.LockType::UnlockShared();
+		}
+
+		/*!
+		Return the lock as BaseLock for the interfaces taking BaseLock.
+		@return the pointer to the lock.
+		*/
+		BaseLock *GetBaseLock() const
+		{
+			return &m_lock;
+		}
+
+	private:
+		/// the lock
+		mutable LockType m_lock;
+	};
+
+	/*! 
+	@class InlineLock<BaseLock> epInlineLock.h
+	@brief A class that holds the lock chosen by LockPolicy at runtime.
+	*/
+	template<>
+	class InlineLock<BaseLock>
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		@param[in] lockPolicyType The lock policy
+		*/
+		InlineLock(LockPolicy lockPolicyType=EP_LOCK_POLICY)
+		{
+			m_lockPolicy=lockPolicyType;
+			m_lock=createLock(m_lockPolicy);
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the new lock with the lock policy of the given lock
+		@param[in] b the second object
+		*/
+		InlineLock(const InlineLock<BaseLock>& b)
+		{
+			m_lockPolicy=b.m_lockPolicy;
+			m_lock=createLock(m_lockPolicy);
+		}
+
+		/*!
+		Default Destructor
+
+		Deletes the lock
+		*/
+		~InlineLock()
+		{
+			if(m_lock)
+				EP_DELETE m_lock;
+		}
+
+		/*!
+		Assignment operator overloading
+
+		Recreates the lock with the lock policy of the given lock.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		InlineLock<BaseLock> & operator=(const InlineLock<BaseLock>&b)
+		{
+			if(this!=&b)
+			{
+				if(m_lock)
+					EP_DELETE m_lock;
+				m_lockPolicy=b.m_lockPolicy;
+				m_lock=createLock(m_lockPolicy);
+			}
+			return *this;
+		}
+
+		/*!
+		Locks the lock
+		*/
+		void Lock() const
+		{
+			EP_ASSERT_EXPR(m_lock,_T("Lock is NULL!"));
+			if(m_lock)
+				m_lock->ProfiledLock();
+		}
+
+		/*!
+		Unlocks the lock
+		*/
+		void Unlock() const
+		{
+			if(m_lock)
+				m_lock->ProfiledUnlock();
+		}
+
+		/*!
+		Locks the lock for reading
+		*/
+		void LockShared() const
+		{
+			EP_ASSERT_EXPR(m_lock,_T("Lock is NULL!"));
+			if(m_lock)
+				m_lock->LockShared();
+		}
+
+		/*!
+		Unlocks the lock for reading
+		*/
+		void UnlockShared() const
+		{
+			if(m_lock)
+				m_lock->UnlockShared();
+		}
+
+		/*!
+		Return the lock as BaseLock for the interfaces taking BaseLock.
+		@return the pointer to the lock.
+		*/
+		BaseLock *GetBaseLock() const
+		{
+			return m_lock;
+		}
+
+		/*!
+		Return the lock policy of the lock.
+		@return the lock policy.
+		*/
+		LockPolicy GetLockPolicy() const
+		{
+			return m_lockPolicy;
+		}
+
+	private:
+		/*!
+		Create the lock for given lock policy.
+		@param[in] lockPolicyType The lock policy
+		@return the new lock, or NULL if the lock policy is invalid.
+		*/
+		static BaseLock *createLock(LockPolicy lockPolicyType)
+		{
+			switch(lockPolicyType)
+			{
+			case LOCK_POLICY_CRITICALSECTION:
+				return EP_NEW CriticalSectionEx();
+			case LOCK_POLICY_MUTEX:
+				return EP_NEW Mutex();
+			case LOCK_POLICY_NONE:
+				return EP_NEW NoLock();
+			case LOCK_POLICY_SPIN_PARK:
+				return EP_NEW SpinParkLock();
+			case LOCK_POLICY_READER_WRITER:
+				return EP_NEW ReaderWriterLock();
+			default:
+				return NULL;
+			}
+		}
+
+		/// the lock
+		BaseLock *m_lock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class InlineLockObj epInlineLock.h
+	@brief A template class that locks the InlineLock within the scope.
+	*/
+	template<typename LockType>
+	class InlineLockObj
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Locks where this object instantiated.
+		@param[in] lock the lock to lock.
+		*/
+		InlineLockObj(const InlineLock<LockType> &lock):m_lock(lock)
+		{
+			m_lock.Lock();
+		}
+
+		/*!
+		Default Destructor
+
+		Unlock when this object destroyed.
+		*/
+		~InlineLockObj()
+		{
+			m_lock.Unlock();
+		}
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		InlineLockObj(const InlineLockObj<LockType> & b):m_lock(b.m_lock){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		InlineLockObj<LockType> &operator=(const InlineLockObj<LockType> & b){EP_ASSERT(0);return *this;}
+
+		/// the lock used.
+		const InlineLock<LockType> &m_lock;
+	};
+
+	/*! 
+	@class InlineSharedLockObj epInlineLock.h
+	@brief A template class that locks the InlineLock for reading within the scope.
+	*/
+	template<typename LockType>
+	class InlineSharedLockObj
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Locks for reading where this object instantiated.
+		@param[in] lock the lock to lock.
+		*/
+		InlineSharedLockObj(const InlineLock<LockType> &lock):m_lock(lock)
+		{
+			m_lock.LockShared();
+		}
+
+		/*!
+		Default Destructor
+
+		Unlock for reading when this object destroyed.
+		*/
+		~InlineSharedLockObj()
+		{
+			m_lock.UnlockShared();
+		}
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		InlineSharedLockObj(const InlineSharedLockObj<LockType> & b):m_lock(b.m_lock){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		InlineSharedLockObj<LockType> &operator=(const InlineSharedLockObj<LockType> & b){EP_ASSERT(0);return *this;}
+
+		/// the lock used.
+		const InlineLock<LockType> &m_lock;
+	};
+}
+#endif //__EP_INLINE_LOCK_H__
\ No newline at end of file
@@ -50,10 +50,10 @@ namespace epl
 	@param[in] sortList The list to sort.
 	@param[in] low the low index.
 	@param[in] high the high index
-	@param[in] SortFunc The Compare Function pointer.
+	@param[in] SortFunc The Compare Function pointer or functor.
 	*/
-	template<typename T>
-	inline void InsertionSort(T* sortList, size_t low, size_t high,CompResultType (__cdecl *SortFunc)(const void * , const void *))
+	template<typename T,typename CompFuncType>
+	inline void InsertionSort(T* sortList, size_t low, size_t high,CompFuncType SortFunc)
 	{
 		size_t i;
 		for(i=low+1; i<=high; i++)
@@ -0,0 +1,116 @@
+/*! 
+@file epIpcBenchmark.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief IPC Benchmark Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+This is a class for measuring the latency and the throughput of the IPC transports.
+
+*/
+#ifndef __EP_IPC_BENCHMARK_H__
+#define __EP_IPC_BENCHMARK_H__
+#include "epLib.h"
+#include "epBenchmark.h"
+
+/// the default byte size of the largest message measured
+#define IPC_BENCHMARK_MAX_MESSAGE_SIZE (1024*1024)
+
+/// the default number of the clients writing to the server in the fan-in benchmark
+#define IPC_BENCHMARK_FAN_IN_CLIENT_COUNT 4
+
+namespace epl
+{
+	/// Enumeration for the IPC transport measured
+	enum IpcBenchmarkTransport{
+		/// IpcServer in IPC_SERVER_MODE_COMPLETION_ROUTINE and IpcClient
+		IPC_BENCHMARK_TRANSPORT_PIPE=0,
+		/// IpcServer in IPC_SERVER_MODE_COMPLETION_PORT and IpcClient
+		IPC_BENCHMARK_TRANSPORT_PIPE_COMPLETION_PORT,
+		/// IpcServer in IPC_SERVER_MODE_COMPLETION_PORT and IpcClient, both with the batched write
+		IPC_BENCHMARK_TRANSPORT_PIPE_BATCH,
+		/// ShmIpcServer and ShmIpcClient
+		IPC_BENCHMARK_TRANSPORT_SHM,
+		/// Transport Count
+		IPC_BENCHMARK_TRANSPORT_COUNT,
+	};
+
+	/*! 
+	@class IpcBenchmark epIpcBenchmark.h
+	@brief A class for measuring the latency and the throughput of the IPC servers and clients.
+
+	Each scenario is measured for each transport and for each message size from 16 bytes up to given size, growing by 16 times.
+	The results are added to BENCHMARK_INSTANCE, and reported by its Print or FlushToFile.
+	The ping-pong benchmark also adds the 50th, 90th and 99th percentiles and the maximum of the round trip times of its last measurement,
+	as the cases with the suffix P50, P90, P99 and Max.
+	A transport which cannot be started or fails a case is not measured for the larger messages.
+	*/
+	class EP_LIBRARY IpcBenchmark
+	{
+	public:
+		/*!
+		Run all the IPC benchmarks for all the transports.
+		@param[in] pipeName the name of the pipe to serve, which must not be used by another server.
+		@param[in] maxMessageSize the byte size of the largest message to measure.
+		@param[in] clientCount the number of the clients in the fan-in benchmark.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void Run(const TCHAR *pipeName, unsigned int maxMessageSize=IPC_BENCHMARK_MAX_MESSAGE_SIZE, unsigned int clientCount=IPC_BENCHMARK_FAN_IN_CLIENT_COUNT, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where one client writes the message and waits for the server to echo it back.
+		@param[in] transport the transport to measure.
+		@param[in] pipeName the name of the pipe to serve.
+		@param[in] maxMessageSize the byte size of the largest message to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunPingPong(IpcBenchmarkTransport transport, const TCHAR *pipeName, unsigned int maxMessageSize=IPC_BENCHMARK_MAX_MESSAGE_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where one client writes the messages to the server without waiting for the replies.
+		@param[in] transport the transport to measure.
+		@param[in] pipeName the name of the pipe to serve.
+		@param[in] maxMessageSize the byte size of the largest message to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunStreaming(IpcBenchmarkTransport transport, const TCHAR *pipeName, unsigned int maxMessageSize=IPC_BENCHMARK_MAX_MESSAGE_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where the clients write the messages to the server at the same time, each on its own thread.
+		@param[in] transport the transport to measure.
+		@param[in] pipeName the name of the pipe to serve.
+		@param[in] maxMessageSize the byte size of the largest message to measure.
+		@param[in] clientCount the number of the clients.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunFanIn(IpcBenchmarkTransport transport, const TCHAR *pipeName, unsigned int maxMessageSize=IPC_BENCHMARK_MAX_MESSAGE_SIZE, unsigned int clientCount=IPC_BENCHMARK_FAN_IN_CLIENT_COUNT, unsigned int minTime=BENCHMARK_MIN_TIME);
+	};
+}
+#endif //__EP_IPC_BENCHMARK_H__
\ No newline at end of file
@@ -39,7 +39,8 @@ An Interface for the IPC Client Class.
 #define __EP_IPC_CLIENT_H__
 #include "epLib.h"
 #include "epIpcClientInterfaces.h"
-#include <queue>
+#include "epIpcMetrics.h"
+#include <deque>
 
 using namespace std;
 
@@ -49,8 +50,9 @@ namespace epl{
 	@class IpcClient epIpcClient.h
 	@brief A class for IPC Client.
 	*/
-	class EP_LIBRARY IpcClient:public IpcClientInterface
+	class EP_LIBRARY IpcClient:public IpcClientInterface,public IpcMetricsSourceInterface
 	{
+	public:
 		/*!
 		Default Constructor
 
@@ -114,16 +116,100 @@ namespace epl{
 		*/
 		virtual unsigned int GetMaxReadDataByteSize() const;
 
+		/*!
+		Copy the current metrics to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		@remark the counters are cumulative, so subtract the earlier snapshot to get the counters of an interval.
+		*/
+		virtual void GetMetrics(IpcMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Report the metrics by IPC_METRICS_INSTANCE with the given name.
+		@param[in] name the name in the report.
+		*/
+		void SetMetricsName(const TCHAR *name);
+
 		/*!
 		Write data to the pipe
 		@param[in] data the data to write
 		@param[in] dataByteSize byte size of the data
 		*/
 		virtual void Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@remark the segments are copied once into the write buffer, so they can be freed after the call.
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize byte size of the data to write
+		@return the write element whose m_data holds dataByteSize bytes
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize);
+
+		/*!
+		Write the pooled write buffer to the pipe without copying
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, so the caller must not touch it after the call.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem);
 	
 
 	private:
 
+		/*!
+		Queue the write element, and start writing if nothing is in progress
+		@param[in] elem the write element holding the data
+		*/
+		void queueWrite(PipeWriteElem *elem);
+
+		/*!
+		Return the maximum byte size of the batched write
+		@return the maximum byte size of the batched write, or 0 if the writes are not batched
+		*/
+		unsigned int getWriteBatchByteSize() const;
+
+		/*!
+		Acquire the write element from the write buffer pool, or from the pool set if longer than the write buffer
+		@param[in] dataByteSize the byte size of the data
+		@return the write element acquired
+		*/
+		PipeWriteElem *acquireWriteElem(unsigned int dataByteSize);
+
+		/*!
+		Gather the writes waiting at the front of the write queue into one batched write
+		@remark the write queue lock must be held, and nothing must be in progress.
+		*/
+		void coalesceWrites();
+
+		/*!
+		Report the completion of the write element for each message it holds
+		@param[in] elem the write element completed
+		@param[in] status the write status
+		@param[in] errCode the error code
+		@param[in] cbWritten the bytes written
+		*/
+		void reportWrite(const PipeWriteElem *elem, WriteStatus status, unsigned long errCode, unsigned int cbWritten);
+
+		/*!
+		Report the data read for each message it holds
+		@param[in] errCode the error code
+		@param[in] cbBytesRead the bytes of the last part of the message read into the read buffer
+		*/
+		void reportRead(unsigned long errCode, unsigned int cbBytesRead);
+
+		/*!
+		Keep the part of the message read with ERROR_MORE_DATA, and make room for the rest
+		@param[in] cbBytesRead the bytes of the part read
+		@return true if the rest can be read, false if the message exceeds the maximum message byte size
+		*/
+		bool growRead(unsigned int cbBytesRead);
+
 		/*!
 		Handles when Read is completed
 		@param[in] dwErr the error code
@@ -152,16 +238,26 @@ namespace epl{
 		/// Lock policy
 		LockPolicy m_lockPolicy;
 
-		/// Write buffer queue
-		queue<PipeWriteElem*> m_writeQueue;
-		/// Read buffer
-		char *m_readBuffer; 
+		/// Write buffer queue (the front is the write in progress)
+		deque<PipeWriteElem*> m_writeQueue;
+		/// Read buffer reassembling the message longer than the default buffer
+		IpcReadBuffer m_readBuffer; 
 		/// Size of bytes read from pipe
 		unsigned int m_bytesRead;
 
 		/// Lock for write buffer queue
 		BaseLock *m_writeQueueLock;
 
+		/// the pool of the write buffers (created at Connect)
+		IpcWriteBufferPool *m_writeBufferPool;
+		/// the pool set for the messages longer than the default buffers (created at Connect)
+		IpcBufferPoolSet *m_bufferPoolSet;
+
+		/// the metrics of the connections
+		IpcMetrics m_metrics;
+		/// the flag whether the metrics are reported by IPC_METRICS_INSTANCE
+		bool m_isMetricsRegistered;
+
 	};
 }
 
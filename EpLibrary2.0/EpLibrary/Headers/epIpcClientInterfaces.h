@@ -61,10 +61,14 @@ namespace epl
 		TCHAR *pipeName;
 		/// Wait time in millisecond for pipe threads
 		unsigned int waitTimeInMilliSec;
-		/// read byte size
+		/// the byte size of the default read buffer
 		unsigned int numOfReadBytes;
-		/// write byte size
+		/// the byte size of the pooled write buffer
 		unsigned int numOfWriteBytes;
+		/// the maximum byte size of the batched write gathering the queued messages with the framing (0 to write each message as it is, both ends must use the same)
+		unsigned int writeBatchByteSize;
+		/// the maximum byte size of the message read or written, the message longer than numOfReadBytes is reassembled (0 for no limit)
+		unsigned int maxMessageByteSize;
 
 		/*!
 		Default Constructor
@@ -79,6 +83,8 @@ namespace epl
 			waitTimeInMilliSec=WAITTIME_INIFINITE;
 			numOfReadBytes=DEFAULT_READ_BUF_SIZE;
 			numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
+			writeBatchByteSize=0;
+			maxMessageByteSize=0;
 
 		}
 
@@ -91,6 +97,11 @@ namespace epl
 	@brief A class for IPC Client Interface.
 	*/
 	class EP_LIBRARY IpcClientInterface{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcClientInterface(){}
 
 		/*!
 		Get the pipe name of server
@@ -113,10 +124,11 @@ namespace epl
 		/*!
 		Connect to the server
 		@param[in] ops the server options
+		@param[in] waitTimeInMilliSec the wait time for connection in milli-second.
 		@return Connect status
 		@remark if argument is NULL then previously setting value is used
 		*/
-		virtual ConnectStatus Connect(const IpcClientOps &ops=IpcClientOps::defaultIpcClientOps)=0;
+		virtual ConnectStatus Connect(const IpcClientOps &ops=IpcClientOps::defaultIpcClientOps, unsigned int waitTimeInMilliSec=0)=0;
 		/*!
 		Disconnect from the server
 		*/
@@ -145,6 +157,28 @@ namespace epl
 		@param[in] dataByteSize byte size of the data
 		*/
 		virtual void Write(char *data,unsigned int dataByteSize)=0;
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)=0;
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize byte size of the data to write
+		@return the write element whose m_data holds dataByteSize bytes
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize)=0;
+
+		/*!
+		Write the pooled write buffer to the pipe without copying
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, so the caller must not touch it after the call.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem)=0;
 		
 	};
 
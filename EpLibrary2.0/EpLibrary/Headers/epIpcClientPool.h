@@ -0,0 +1,315 @@
+/*! 
+@file epIpcClientPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief IPC Client Pool Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the pool of the warm IPC client connections.
+
+*/
+#ifndef __EP_IPC_CLIENT_POOL_H__
+#define __EP_IPC_CLIENT_POOL_H__
+#include "epLib.h"
+#include "epThread.h"
+#include "epEventEx.h"
+#include "epIpcClientInterfaces.h"
+#include <vector>
+
+namespace epl
+{
+/// the default number of the connections in the pool
+#define IPC_CLIENT_POOL_DEFAULT_CONNECTION_COUNT 4
+/// the default interval in millisecond to retry the connections lost
+#define IPC_CLIENT_POOL_DEFAULT_RECONNECT_INTERVAL 1000
+
+	/*! 
+	@struct IpcClientPoolOps epIpcClientPool.h
+	@brief A class for IPC Client Pool Options.
+	*/
+	struct EP_LIBRARY IpcClientPoolOps{
+		/// the options for each connection (the callback object is the one to forward)
+		IpcClientOps clientOps;
+		/// the number of the connections
+		unsigned int connectionCount;
+		/// the interval in millisecond to retry the connections lost
+		unsigned int reconnectIntervalInMilliSec;
+		/// the wait time in millisecond for each connect
+		unsigned int connectWaitTimeInMilliSec;
+
+		/*!
+		Default Constructor
+
+		Initializes the Client Pool Options
+		*/
+		IpcClientPoolOps()
+		{
+			connectionCount=IPC_CLIENT_POOL_DEFAULT_CONNECTION_COUNT;
+			reconnectIntervalInMilliSec=IPC_CLIENT_POOL_DEFAULT_RECONNECT_INTERVAL;
+			connectWaitTimeInMilliSec=0;
+		}
+
+		/// Default IPC Client Pool options
+		static IpcClientPoolOps defaultIpcClientPoolOps;
+	};
+
+	/*! 
+	@class IpcClientPool epIpcClientPool.h
+	@brief A class for the pool of the warm IPC client connections to one pipe.
+
+	The connections are made and remade on the thread of the pool, so the callers never block on the connect,
+	and each write goes to the connected connection with the fewest writes in flight.
+	The thread of the pool waits alertably, so the completion routines of the connections made on it are run there.
+	*/
+	class EP_LIBRARY IpcClientPool:public Thread, public IpcClientCallbackInterface
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Pool
+		@param[in] lockPolicyType lock policy
+		*/
+		IpcClientPool(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Close the Pool
+		*/
+		virtual ~IpcClientPool();
+
+		/*!
+		Open the pool, and start connecting on the thread of the pool.
+		@param[in] ops the pool options
+		@return true if successfully started otherwise false
+		*/
+		bool Open(const IpcClientPoolOps &ops=IpcClientPoolOps::defaultIpcClientPoolOps);
+
+		/*!
+		Disconnect and destroy all connections.
+		*/
+		void Close();
+
+		/*!
+		Check if the pool is opened
+		@return true if the pool is opened otherwise false
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Write data to the connection with the fewest writes in flight
+		@param[in] data the data to write
+		@param[in] dataByteSize byte size of the data
+		@return true if written to a connection, false if no connection is alive
+		*/
+		bool Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments as one message to the connection with the fewest writes in flight
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@return true if written to a connection, false if no connection is alive
+		*/
+		bool Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Return the number of the connections
+		@return the number of the connections
+		*/
+		unsigned int GetConnectionCount() const;
+
+		/*!
+		Return the number of the connections alive
+		@return the number of the connections alive
+		*/
+		unsigned int GetAliveConnectionCount() const;
+
+		/*!
+		Return the connection at given index
+		@param[in] idx the index of the connection
+		@return the connection
+		*/
+		IpcClientInterface *GetConnection(unsigned int idx) const;
+
+		/*!
+		Check if the connection at given index is alive
+		@param[in] idx the index of the connection
+		@return true if the connection is alive otherwise false
+		*/
+		bool IsConnectionAlive(unsigned int idx) const;
+
+		/*!
+		Return the number of the writes in flight on the connection at given index
+		@param[in] idx the index of the connection
+		@return the number of the writes in flight
+		*/
+		unsigned int GetInFlightCount(unsigned int idx) const;
+
+		/*!
+		Return the number of the times the connection at given index is made
+		@param[in] idx the index of the connection
+		@return the number of the times the connection is made
+		*/
+		unsigned int GetConnectCount(unsigned int idx) const;
+
+		/*!
+		Return the status of the last connect of the connection at given index
+		@param[in] idx the index of the connection
+		@return the status of the last connect
+		*/
+		ConnectStatus GetLastConnectStatus(unsigned int idx) const;
+
+		/*!
+		Set the Callback Object to forward the callbacks of the connections.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		void SetCallbackObject(IpcClientCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object to forward the callbacks of the connections
+		@return the current Callback Object
+		*/
+		IpcClientCallbackInterface *GetCallbackObject();
+
+		/*!
+		Received the data from the connection.
+		@param[in] pipe the connection which received the packet
+		@param[in] receivedData the received data
+		@param[in] receivedDataByteSize the received data byte size
+		@param[in] status the status of read
+		@param[in] errCode the error code
+		*/
+		virtual void OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode);
+
+		/*!
+		The write of the connection is completed.
+		@param[in] pipe the connection which wrote the packet
+		@param[in] writtenDataByteSize the byte size of data written
+		@param[in] status the status of write
+		@param[in] errCode the error code
+		*/
+		virtual void OnWriteComplete(IpcClientInterface *pipe,unsigned int writtenDataByteSize, WriteStatus status, unsigned long errCode);
+
+		/*!
+		The connection is disconnected, and it is remade on the thread of the pool.
+		@param[in] pipe the connection, disconnected.
+		*/
+		virtual void OnDisconnect(IpcClientInterface *pipe);
+
+	protected:
+		/*!
+		Create the connection of the pool.
+		@return the new connection.
+		@remark the default creates IpcClient, and subclasses may override to use the other transport.
+		*/
+		virtual IpcClientInterface *createConnection();
+
+		/*!
+		Destroy the connection created by createConnection.
+		@param[in] connection the connection to destroy.
+		*/
+		virtual void destroyConnection(IpcClientInterface *connection);
+
+		/*!
+		Connect the connections lost until the pool is closed.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcClientPool(const IpcClientPool & b):Thread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcClientPool &operator=(const IpcClientPool & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Connect the connections not alive.
+		*/
+		void connectAll();
+
+		/*!
+		Return the index of given connection.
+		@param[in] pipe the connection to find.
+		@return the index of the connection, or -1 if not found.
+		*/
+		int findConnection(const IpcClientInterface *pipe) const;
+
+		/*!
+		Return the alive connection with the fewest writes in flight, and count the write in flight.
+		@return the index of the connection, or -1 if no connection is alive.
+		*/
+		int pickConnection();
+
+		/*!
+		@struct Connection epIpcClientPool.h
+		@brief A struct for the connection of the pool and its health.
+		*/
+		struct Connection{
+			/// the connection
+			IpcClientInterface *m_client;
+			/// the number of the writes in flight
+			volatile long m_inFlightCount;
+			/// the number of the times the connection is made
+			volatile long m_connectCount;
+			/// the status of the last connect
+			ConnectStatus m_lastConnectStatus;
+		};
+
+		/// the connections
+		std::vector<Connection> m_connections;
+		/// the pool options
+		IpcClientPoolOps m_options;
+		/// the callback object to forward
+		IpcClientCallbackInterface *m_callBackObj;
+		/// flag whether the pool is opened
+		bool m_isOpened;
+		/// flag whether the pool is closing
+		volatile bool m_isClosing;
+		/// the index to start the scan for the next write
+		volatile long m_nextIdx;
+		/// the event waking the thread of the pool
+		EventEx m_wakeEvent;
+		/// Lock policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_IPC_CLIENT_POOL_H__
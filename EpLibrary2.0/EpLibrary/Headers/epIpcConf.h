@@ -40,11 +40,24 @@ An Interface for the IPC Configuration Interfaces.
 
 #include "epLib.h"
 #include "epSmartObject.h"
+#include <vector>
 namespace epl
 {
 
 #define DEFAULT_WRITE_BUF_SIZE 4096
 #define DEFAULT_READ_BUF_SIZE 4096
+/// the default number of the pipe instances kept waiting for the clients in the completion port mode
+#define DEFAULT_LISTENING_INSTANCES 8
+/// the maximum number of the callbacks one dispatch job delivers before yielding to the other pipes
+#define IPC_CALLBACK_BATCH_SIZE 64
+/// the default maximum number of the free write buffers the write buffer pool keeps
+#define IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT 256
+/// the byte size of the length header framing each message in the batched write
+#define IPC_FRAME_HEADER_SIZE 4
+/// the maximum message byte size when no limit is given
+#define IPC_MESSAGE_BYTE_SIZE_UNLIMITED 0xFFFFFFFF
+/// the default maximum number of the free buffers each size class of the buffer pool set keeps
+#define IPC_BUFFER_POOL_SET_MAX_FREE_COUNT 8
 
 
 	/// Connect Status
@@ -76,13 +89,18 @@ namespace epl
 		WRITE_STATUS_SUCCESS=0,
 		/// Send failed
 		WRITE_STATUS_FAIL_WRITE_FAILED,
+		/// Dropped by the write queue overflow policy
+		WRITE_STATUS_FAIL_QUEUE_FULL,
 	}WriteStatus;
 
+	class IpcWriteBufferPool;
+
 	/*! 
 	@class PipeWriteElem epIpcPipe.h
 	@brief A class for IPC Write Element.
 	*/
 	struct EP_LIBRARY PipeWriteElem:public SmartObject{
+		friend class IpcWriteBufferPool;
 		/*!
 		Default Constructor
 
@@ -110,6 +128,319 @@ namespace epl
 		unsigned int m_dataSize;
 		/// Data buffer
 		char *m_data;
+		/// the time the element is queued for the write in microseconds
+		__int64 m_queueTime;
+
+	protected:
+		/*!
+		Return this element to its write buffer pool instead of deleting it.
+		@return true if the element is kept by the pool, otherwise false.
+		*/
+		virtual bool recycleObj();
+
+	private:
+		/// the pool this element is acquired from (NULL if not pooled)
+		IpcWriteBufferPool *m_pool;
+	};
+
+	/*! 
+	@class IpcWriteBufferPool epIpcConf.h
+	@brief A class for the free list which recycles the write elements with the buffer of the same byte size.
+
+	The released element returns to the pool with its buffer, so the write takes no allocation once the pool is warm.
+	Each element acquired retains the pool, so the pool lives until the last element is released.
+	*/
+	class EP_LIBRARY IpcWriteBufferPool:public SmartObject{
+	public:
+		friend struct PipeWriteElem;
+
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] bufferByteSize the byte size of the buffer of each element
+		@param[in] maxFreeCount the maximum number of the free elements kept in the pool
+		@param[in] lockPolicyType lock policy
+		*/
+		IpcWriteBufferPool(unsigned int bufferByteSize,unsigned int maxFreeCount=IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT,epl::LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the free elements
+		*/
+		virtual ~IpcWriteBufferPool();
+
+		/*!
+		Acquire the write element from the pool.
+		@param[in] dataByteSize the byte size of the data to write
+		@return the element whose m_data holds dataByteSize bytes, with the reference count 1.
+		@remark the caller must call ReleaseObj or pass the element to the write queue.
+		*/
+		PipeWriteElem *Acquire(unsigned int dataByteSize);
+
+		/*!
+		Return the byte size of the buffer of each element.
+		@return the byte size of the buffer.
+		*/
+		unsigned int GetBufferByteSize() const;
+
+		/*!
+		Return the number of the free elements kept in the pool.
+		@return the number of the free elements.
+		*/
+		size_t GetFreeCount() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcWriteBufferPool(const IpcWriteBufferPool & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcWriteBufferPool &operator=(const IpcWriteBufferPool & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Keep the released element in the free list.
+		@param[in] elem the element released
+		@return true if kept, false if the free list is full.
+		*/
+		bool recycleElem(PipeWriteElem *elem);
+
+		/// the free elements
+		std::vector<PipeWriteElem*> m_freeList;
+		/// the byte size of the buffer of each element
+		unsigned int m_bufferByteSize;
+		/// the maximum number of the free elements
+		unsigned int m_maxFreeCount;
+		/// Lock for the free list
+		BaseLock *m_poolLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class IpcBufferPoolSet epIpcConf.h
+	@brief A class for the write buffer pools of the doubling size classes for the messages larger than the default buffer.
+
+	The size classes start from the minimum buffer byte size and double,
+	and the pool of each class is created when the class is first used.
+	*/
+	class EP_LIBRARY IpcBufferPoolSet:public SmartObject{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the pool set
+		@param[in] minBufferByteSize the byte size of the buffer of the smallest size class
+		@param[in] maxFreeCount the maximum number of the free elements kept in each size class
+		@param[in] lockPolicyType lock policy
+		*/
+		IpcBufferPoolSet(unsigned int minBufferByteSize,unsigned int maxFreeCount=IPC_BUFFER_POOL_SET_MAX_FREE_COUNT,epl::LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Release the pools of the size classes
+		*/
+		virtual ~IpcBufferPoolSet();
+
+		/*!
+		Acquire the write element from the smallest size class holding the given byte size.
+		@param[in] dataByteSize the byte size of the data
+		@return the element whose m_data holds dataByteSize bytes, with the reference count 1.
+		@remark the byte size over the largest size class is allocated as it is and not pooled.
+		*/
+		PipeWriteElem *Acquire(unsigned int dataByteSize);
+
+		/*!
+		Return the byte size of the buffer of the smallest size class.
+		@return the byte size of the buffer of the smallest size class.
+		*/
+		unsigned int GetMinBufferByteSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcBufferPoolSet(const IpcBufferPoolSet & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcBufferPoolSet &operator=(const IpcBufferPoolSet & b){EP_ASSERT(0);return *this;}
+
+		/// the pools of the size classes (NULL until the class is used)
+		std::vector<IpcWriteBufferPool*> m_poolList;
+		/// the byte size of the buffer of the smallest size class
+		unsigned int m_minBufferByteSize;
+		/// the maximum number of the free elements kept in each size class
+		unsigned int m_maxFreeCount;
+		/// Lock for the pool list
+		BaseLock *m_poolLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class IpcReadBuffer epIpcConf.h
+	@brief A class for the read buffer which reassembles the message longer than its default buffer.
+
+	The read goes into the compact default buffer, and when the pipe reports ERROR_MORE_DATA
+	the rest of the message is read into the buffer acquired from the pool set,
+	which goes back to the pool set once the message is reported.
+	*/
+	class EP_LIBRARY IpcReadBuffer{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the read buffer
+		*/
+		IpcReadBuffer();
+
+		/*!
+		Default Destructor
+
+		Destroy the buffers
+		*/
+		~IpcReadBuffer();
+
+		/*!
+		Allocate the default buffer.
+		@param[in] defaultByteSize the byte size of the default buffer
+		@param[in] maxMessageByteSize the maximum byte size of the message to reassemble
+		@param[in] bufferPoolSet the pool set to acquire the buffer for the longer message from
+		*/
+		void Initialize(unsigned int defaultByteSize, unsigned int maxMessageByteSize, IpcBufferPoolSet *bufferPoolSet);
+
+		/*!
+		Return the position to read the next part of the message into.
+		@return the position to read into.
+		*/
+		char *GetReadPosition() const;
+
+		/*!
+		Return the byte size left to read into from the read position.
+		@return the byte size left to read into.
+		*/
+		unsigned int GetReadByteSize() const;
+
+		/*!
+		Keep the part read with ERROR_MORE_DATA and make room for the rest of the message.
+		@param[in] readByteSize the byte size of the part read
+		@param[in] leftByteSize the byte size left in the message (0 if unknown)
+		@return true if the rest fits, false if the message exceeds the maximum message byte size.
+		*/
+		bool Grow(unsigned int readByteSize, unsigned int leftByteSize);
+
+		/*!
+		Complete the message with the last part read.
+		@param[in] readByteSize the byte size of the last part read
+		@return the byte size of the whole message.
+		*/
+		unsigned int Complete(unsigned int readByteSize);
+
+		/*!
+		Return the data of the message.
+		@return the data of the message.
+		*/
+		char *GetData() const;
+
+		/*!
+		Release the buffer of the longer message and read into the default buffer again.
+		*/
+		void Reset();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcReadBuffer(const IpcReadBuffer & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcReadBuffer &operator=(const IpcReadBuffer & b){EP_ASSERT(0);return *this;}
+
+		/// the default buffer
+		char *m_defaultBuffer;
+		/// the byte size of the default buffer
+		unsigned int m_defaultByteSize;
+		/// the element holding the buffer of the longer message (NULL when reading into the default buffer)
+		PipeWriteElem *m_largeElem;
+		/// the buffer being read into
+		char *m_buffer;
+		/// the byte size of the buffer being read into
+		unsigned int m_bufferByteSize;
+		/// the byte size of the message read so far
+		unsigned int m_readByteSize;
+		/// the maximum byte size of the message
+		unsigned int m_maxMessageByteSize;
+		/// the pool set to acquire the buffer for the longer message from
+		IpcBufferPoolSet *m_bufferPoolSet;
+	};
+
+	/*! 
+	@class IpcFrame epIpcConf.h
+	@brief A class for the framing envelope which gathers several messages into one pipe message.
+
+	Each message is written as the 4-byte length header followed by its data,
+	so the receiver splits one pipe message back into the messages written.
+	*/
+	class EP_LIBRARY IpcFrame{
+	public:
+		/*!
+		Append the data of the element to the batch as one frame.
+		@param[in] batch the batch element to append to.
+		@param[in] batchByteSize the maximum byte size of the batch.
+		@param[in] elem the element holding the message.
+		@return true if appended, false if the frame does not fit in the batch.
+		*/
+		static bool AppendFrame(PipeWriteElem *batch, unsigned int batchByteSize, const PipeWriteElem *elem);
+
+		/*!
+		Read the next frame from the batched data.
+		@param[in] data the batched data.
+		@param[in] byteSize the byte size of the batched data.
+		@param[in,out] offset the offset of the next frame, moved past the frame read.
+		@param[out] retFrame set to the data of the frame.
+		@param[out] retFrameSize set to the byte size of the frame.
+		@return true if the frame is read, false at the end of the data or if the frame is truncated.
+		@remark the data is malformed if offset is not byteSize after the last frame.
+		*/
+		static bool NextFrame(const char *data, unsigned int byteSize, unsigned int &offset, const char *&retFrame, unsigned int &retFrameSize);
+	};
+
+	/*! 
+	@struct IpcWriteSegment epIpcConf.h
+	@brief A struct for the segment of the data gathered into one write.
+	*/
+	struct IpcWriteSegment{
+		/// Data of the segment
+		const void *m_data;
+		/// Byte size of the segment
+		unsigned int m_dataSize;
 	};
 }
 #endif //__EP_IPC_CONF_H__
\ No newline at end of file
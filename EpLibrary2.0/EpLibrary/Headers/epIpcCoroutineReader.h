@@ -0,0 +1,155 @@
+/*! 
+@file epIpcCoroutineReader.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief IPC Coroutine Reader Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the IPC Coroutine Reader, which lets the coroutine await the packets of the IPC client.
+
+*/
+#ifndef __EP_IPC_COROUTINE_READER_H__
+#define __EP_IPC_COROUTINE_READER_H__
+#include "epLib.h"
+#include <vector>
+#include <deque>
+#include "epIpcClientInterfaces.h"
+#include "epCoroutineScheduler.h"
+
+namespace epl
+{
+	/*!
+	@class IpcCoroutineReader epIpcCoroutineReader.h
+	@brief A class for the callback of the IPC client, which lets the coroutine await the data received.
+
+	The data received is queued by the callback of the client,
+	and Read pauses the calling coroutine until the data arrives, so the worker thread keeps running the other coroutines.
+	@remark set this object as the callback object of the client, such as IpcClient::SetCallbackObject.
+	*/
+	class EP_LIBRARY IpcCoroutineReader:public IpcClientCallbackInterface
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the reader
+		@param[in] lockPolicyType The lock policy
+		*/
+		IpcCoroutineReader(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the reader
+		*/
+		virtual ~IpcCoroutineReader();
+
+		/*!
+		Read the next data received, pausing the calling coroutine until it arrives.
+		@param[out] retData the data received
+		@param[out] retStatus the status of read, if not NULL
+		@return true if read, false if disconnected and no data is left, or not called within the coroutine.
+		*/
+		bool Read(std::vector<char> &retData, ReadStatus *retStatus=NULL);
+
+		/*!
+		Return the number of the data received and not read yet.
+		@return the number of the data not read.
+		*/
+		size_t GetPendingCount() const;
+
+		/*!
+		Return the flag whether the client is disconnected.
+		@return true if disconnected, otherwise false.
+		*/
+		bool IsDisconnected() const;
+
+		/*!
+		Clear the data not read and the disconnected flag, before the client connects again.
+		*/
+		void Reset();
+
+		/*!
+		Received the data from the server.
+		@param[in] pipe the pipe which received the packet
+		@param[in] receivedData the received data
+		@param[in] receivedDataByteSize the received data byte size
+		@param[in] status the status of read
+		@param[in] errCode the error code
+		*/
+		virtual void OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode);
+
+		/*!
+		The pipe is disconnected.
+		@param[in] pipe the pipe, disconnected.
+		*/
+		virtual void OnDisconnect(IpcClientInterface *pipe);
+
+	private:
+		/*!
+		@struct ReadResult epIpcCoroutineReader.h
+		@brief A structure of the data received.
+		*/
+		struct ReadResult
+		{
+			/// the data received
+			std::vector<char> m_data;
+			/// the status of read
+			ReadStatus m_status;
+		};
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcCoroutineReader(const IpcCoroutineReader & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcCoroutineReader &operator=(const IpcCoroutineReader & b){EP_ASSERT(0);return *this;}
+
+		/// the data received and not read yet
+		std::deque<ReadResult> m_pendingList;
+		/// the flag whether the client is disconnected
+		bool m_isDisconnected;
+		/// the event raised while the data is pending or the client is disconnected
+		CoroutineEvent m_readEvent;
+		/// lock
+		BaseLock *m_lock;
+	};
+}
+
+#endif //__EP_IPC_COROUTINE_READER_H__
@@ -0,0 +1,376 @@
+/*! 
+@file epIpcMetrics.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief IPC Metrics Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the IPC Metrics.
+
+*/
+#ifndef __EP_IPC_METRICS_H__
+#define __EP_IPC_METRICS_H__
+#include "epLib.h"
+#include "epBaseOutputter.h"
+#include "epSingletonHolder.h"
+
+/*!
+@def IPC_METRICS_INSTANCE
+@brief A Simple Macro to get the IPC Metrics Manager Instance
+
+Macro that returns the reference of IPC Metrics Manager Instance.
+*/
+#define IPC_METRICS_INSTANCE epl::SingletonHolder<epl::IpcMetricsManager>::Instance()
+
+/// the number of the log2 buckets of the write latency histogram
+#define IPC_METRICS_BUCKET_COUNT 32
+
+namespace epl
+{
+	/*! 
+	@struct IpcMetricsSnapshot epIpcMetrics.h
+	@brief A point-in-time copy of the IPC metrics of a connection or a server.
+
+	All times are in microseconds.
+	The write latency is the time from queueing the write to its completion.
+	The bucket i of the histogram counts the writes whose latency was in [2^(i-1), 2^i) microseconds. (bucket 0 is under 1 microsecond)
+	*/
+	struct EP_LIBRARY IpcMetricsSnapshot
+	{
+		/// the number of the messages read
+		__int64 messagesIn;
+		/// the byte size of the messages read
+		__int64 bytesIn;
+		/// the number of the messages written
+		__int64 messagesOut;
+		/// the byte size of the messages written
+		__int64 bytesOut;
+		/// the number of the failed reads
+		__int64 failedReads;
+		/// the number of the failed writes
+		__int64 failedWrites;
+		/// the number of the writes dropped by the write queue overflow policy
+		__int64 droppedWrites;
+		/// the number of the connections made (each one after the first is a reconnect)
+		__int64 connectCount;
+		/// the number of the disconnections
+		__int64 disconnectCount;
+		/// the number of the writes in the write queue when the snapshot is taken
+		__int64 writeQueueDepth;
+		/// the highest number of the writes one write queue held
+		__int64 maxWriteQueueDepth;
+		/// the sum of the write latency
+		__int64 totalWriteLatency;
+		/// the longest write latency
+		__int64 maxWriteLatency;
+		/// the histogram of the write latency
+		__int64 writeLatencyHistogram[IPC_METRICS_BUCKET_COUNT];
+
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		*/
+		IpcMetricsSnapshot();
+
+		/*!
+		Subtract the counters of the given earlier snapshot from this snapshot.
+		@param[in] b the earlier snapshot to subtract.
+		@remark the maximums and the write queue depth are kept as they are.
+		*/
+		void Subtract(const IpcMetricsSnapshot &b);
+
+		/*!
+		Add the counters of the given snapshot to this snapshot.
+		@param[in] b the snapshot to add.
+		@remark used to aggregate the metrics of the connections.
+		*/
+		void Add(const IpcMetricsSnapshot &b);
+
+		/*!
+		Return the average write latency.
+		@return the average write latency in microseconds.
+		*/
+		double GetMeanWriteLatency() const;
+
+		/*!
+		Return the upper bound of the write latency for the given percentile.
+		@param[in] percentile the percentile between 0.0 and 100.0.
+		@return the upper bound of the write latency in microseconds.
+		*/
+		__int64 GetWriteLatencyPercentile(double percentile) const;
+	};
+
+	/*! 
+	@class IpcMetricsSourceInterface epIpcMetrics.h
+	@brief An interface for the object which reports its IPC metrics.
+	*/
+	class EP_LIBRARY IpcMetricsSourceInterface
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcMetricsSourceInterface(){}
+
+		/*!
+		Copy the current metrics to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		*/
+		virtual void GetMetrics(IpcMetricsSnapshot &retSnapshot) const=0;
+	};
+
+	/*! 
+	@class IpcMetrics epIpcMetrics.h
+	@brief A class that keeps the IPC counters of a connection, and adds them to the counters of its server.
+
+	The counters are recorded from the I/O thread and the writing threads, so they are guarded by the lock.
+	*/
+	class EP_LIBRARY IpcMetrics
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		@param[in] lockPolicyType The lock policy
+		*/
+		IpcMetrics(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the metrics
+		*/
+		virtual ~IpcMetrics();
+
+		/*!
+		Set the metrics which also receive every record of this metrics.
+		@param[in] parent the metrics of the server. (NULL to record to this metrics only)
+		@remark the parent must outlive this metrics.
+		*/
+		void SetParent(IpcMetrics *parent);
+
+		/*!
+		Record the message read.
+		@param[in] byteSize the byte size of the message.
+		*/
+		void RecordRead(unsigned int byteSize);
+
+		/*!
+		Record the failed read.
+		*/
+		void RecordReadFailure();
+
+		/*!
+		Record the message written.
+		@param[in] byteSize the byte size of the message.
+		@param[in] latency the time from queueing the write to its completion in microseconds.
+		*/
+		void RecordWrite(unsigned int byteSize, __int64 latency);
+
+		/*!
+		Record the failed write.
+		*/
+		void RecordWriteFailure();
+
+		/*!
+		Record the write dropped by the write queue overflow policy.
+		*/
+		void RecordDroppedWrite();
+
+		/*!
+		Record the connection made.
+		*/
+		void RecordConnect();
+
+		/*!
+		Record the disconnection.
+		*/
+		void RecordDisconnect();
+
+		/*!
+		Record the number of the writes in the write queue.
+		@param[in] depth the number of the writes in the write queue.
+		*/
+		void RecordWriteQueueDepth(size_t depth);
+
+		/*!
+		Copy the current counters to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the counters.
+		@remark the counters are cumulative, so subtract the earlier snapshot to get the counters of an interval.
+		*/
+		void GetSnapshot(IpcMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Reset all counters to zero.
+		*/
+		void Reset();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcMetrics(const IpcMetrics & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcMetrics &operator=(const IpcMetrics & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Return the log2 bucket of the given time.
+		@param[in] time the time in microseconds.
+		@return the bucket index.
+		*/
+		static unsigned int getBucket(__int64 time);
+
+		/// the counters
+		IpcMetricsSnapshot m_counters;
+		/// the metrics of the server
+		IpcMetrics *m_parent;
+		/// Lock for the counters
+		BaseLock *m_metricsLock;
+	};
+
+	/*! 
+	@class IpcMetricsManager epIpcMetrics.h
+	@brief A class that reports the metrics of the registered IPC servers, pipes and clients.
+
+	The object is registered by its SetMetricsName, and reported by Print or FlushToFile
+	with the metrics read when reported.
+	*/
+	class EP_LIBRARY IpcMetricsManager:public BaseOutputter
+	{
+	public:
+		friend class SingletonHolder<IpcMetricsManager>;
+
+		/*!
+		Register given object, or rename it if already registered.
+		@param[in] source the object to report the metrics of.
+		@param[in] name the name of the object in the report.
+		*/
+		void Register(const IpcMetricsSourceInterface *source, const TCHAR *name);
+
+		/*!
+		Unregister given object, keeping its last metrics in the report.
+		@param[in] source the object destroyed.
+		*/
+		void Unregister(const IpcMetricsSourceInterface *source);
+
+		/*!
+		Remove the objects already destroyed from the report.
+		*/
+		virtual void Clear();
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy
+		*/
+		IpcMetricsManager(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcMetricsManager(const IpcMetricsManager& b):BaseOutputter(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcMetricsManager & operator=(const IpcMetricsManager&b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcMetricsManager();
+
+		/*! 
+		@class IpcMetricsNode epIpcMetrics.h
+		@brief A class to report the metrics of one registered object.
+		*/
+		class EP_LIBRARY IpcMetricsNode:public BaseOutputter::OutputNode
+		{
+		public:
+			friend class IpcMetricsManager;
+
+			/*!
+			Default Constructor
+			@param[in] source the object to report the metrics of.
+			@param[in] name the name of the object.
+			*/
+			IpcMetricsNode(const IpcMetricsSourceInterface *source, const TCHAR *name);
+
+			/*!
+			Default Destructor
+			*/
+			virtual ~IpcMetricsNode();
+
+			/*!
+			It prints the data in format,
+			*/
+			virtual void Print() const;
+
+			/*!
+			Write the data to file in format,
+			@param[in] file the file to output the data.
+			*/
+			virtual void Write(EpFile* const file);
+
+		private:
+			/*!
+			Format the metrics into given string.
+			@param[out] retString the formatted string.
+			*/
+			void format(EpTString &retString) const;
+
+			/// the registered object, or NULL if the object is already destroyed
+			const IpcMetricsSourceInterface *m_source;
+			/// the name of the object
+			EpTString m_name;
+			/// the last metrics of the object destroyed
+			IpcMetricsSnapshot m_lastSnapshot;
+		};
+	};
+}
+
+#endif //__EP_IPC_METRICS_H__
@@ -41,7 +41,9 @@ An Interface for the IPC Pipe Class.
 #include "epEventEx.h"
 #include "epIpcServerInterfaces.h"
 #include "epSmartObject.h"
+#include "epIpcMetrics.h"
 #include <queue>
+#include <deque>
 
 using namespace std;
  
@@ -54,15 +56,71 @@ namespace epl{
 		/// Reading State
 		PIPE_STATE_READING,
 		/// Writing State
-		PIPE_STATE_WRITING
+		PIPE_STATE_WRITING,
+		/// Closed State (the instance is closed in the completion port mode)
+		PIPE_STATE_CLOSED
 	}PipeState;
 
+	/// Pipe I/O Types
+	typedef enum _pipeIoType{
+		/// Connect I/O
+		PIPE_IO_TYPE_CONNECT=0,
+		/// Read I/O
+		PIPE_IO_TYPE_READ,
+		/// Write I/O
+		PIPE_IO_TYPE_WRITE
+	}PipeIoType;
+
+	/// Pipe Callback Types
+	typedef enum _pipeCallbackType{
+		/// OnNewConnection
+		PIPE_CALLBACK_TYPE_NEW_CONNECTION=0,
+		/// OnReadComplete
+		PIPE_CALLBACK_TYPE_READ,
+		/// OnWriteComplete
+		PIPE_CALLBACK_TYPE_WRITE,
+		/// OnDisconnect
+		PIPE_CALLBACK_TYPE_DISCONNECT
+	}PipeCallbackType;
+
+	class IpcPipe;
+	class IpcServer;
+
+	/*! 
+	@struct IpcPipeCallback epIpcPipe.h
+	@brief A struct for the callback queued to be dispatched to the callback pool.
+	*/
+	struct IpcPipeCallback{
+		/// the type of the callback
+		PipeCallbackType m_type;
+		/// the read or write status
+		int m_status;
+		/// the error code
+		unsigned long m_errCode;
+		/// the byte size of the data
+		unsigned int m_byteSize;
+		/// the data read (copied for the dispatch)
+		char *m_data;
+	};
+
+	/*! 
+	@struct IpcPipeOverlapped epIpcPipe.h
+	@brief A struct for the overlapped I/O of the pipe in the completion port mode.
+	*/
+	struct IpcPipeOverlapped{
+		/// Overlap structure (must be the first member)
+		OVERLAPPED m_overlap;
+		/// the type of the I/O
+		PipeIoType m_ioType;
+		/// the pipe which issued the I/O
+		IpcPipe *m_pipe;
+	};
 	
 	/*! 
 	@class IpcPipe epIpcPipe.h
 	@brief A class for IPC Pipe.
 	*/
-	class EP_LIBRARY IpcPipe:public IpcInterface, public SmartObject
+	class EP_LIBRARY IpcPipe:public IpcInterface, public SmartObject, public IpcMetricsSourceInterface
 	{
 		friend class IpcServer;
 	public:
@@ -73,8 +131,10 @@ namespace epl{
 		@param[in] pipeName the name of the pipe
 		@param[in] options the options for the pipe
 		@param[in] lockPolicyType lock policy
+		@param[in] writeBufferPool the write buffer pool shared with other instances (NULL to create its own)
+		@param[in] bufferPoolSet the pool set for the messages longer than the default buffers shared with other instances (NULL to create its own)
 		*/
-		IpcPipe(EpTString pipeName, IpcServerOps options,epl::LockPolicy lockPolicyType=EP_LOCK_POLICY);
+		IpcPipe(EpTString pipeName, IpcServerOps options,epl::LockPolicy lockPolicyType=EP_LOCK_POLICY,IpcWriteBufferPool *writeBufferPool=NULL,IpcBufferPoolSet *bufferPoolSet=NULL);
 
 		/*!
 		Default Destructor
@@ -92,8 +152,70 @@ namespace epl{
 		Write data to the pipe
 		@param[in] data the data to write
 		@param[in] dataByteSize byte size of the data
+		@remark the write dropped by the write queue overflow policy is reported
+		        to OnWriteComplete with WRITE_STATUS_FAIL_QUEUE_FULL.
 		*/
 		virtual void Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@remark the segments are copied once into the write buffer, so they can be freed after the call.
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize byte size of the data to write
+		@return the write element whose m_data holds dataByteSize bytes
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize);
+
+		/*!
+		Write the pooled write buffer to the pipe without copying
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, so the caller must not touch it after the call.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem);
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Return the number of writes pending in the write queue.
+		@return the number of pending writes including the one in progress.
+		*/
+		size_t GetWriteQueueSize() const;
+
+		/*!
+		Return the highest number of writes the write queue held since the connection.
+		@return the high-water mark of the write queue.
+		*/
+		size_t GetWriteQueueHighWaterMark() const;
+
+		/*!
+		Return the number of writes dropped by the write queue overflow policy.
+		@return the number of dropped writes.
+		*/
+		size_t GetWriteQueueDropCount() const;
+
+		/*!
+		Copy the current metrics to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		@remark the counters are cumulative, so subtract the earlier snapshot to get the counters of an interval.
+		*/
+		virtual void GetMetrics(IpcMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Report the metrics by IPC_METRICS_INSTANCE with the given name.
+		@param[in] name the name in the report.
+		*/
+		void SetMetricsName(const TCHAR *name);
 	
 		/*!
 		Check if the connection is alive
@@ -137,6 +259,54 @@ namespace epl{
 		Disconnect from the client
 		*/
 		void disconnect();
+
+		/*!
+		Queue the write element, and start writing if nothing is in progress
+		@param[in] elem the write element holding the data
+		*/
+		void queueWrite(PipeWriteElem *elem);
+
+		/*!
+		Return the maximum byte size of the batched write
+		@return the maximum byte size of the batched write, or 0 if the writes are not batched
+		*/
+		unsigned int getWriteBatchByteSize() const;
+
+		/*!
+		Acquire the write element from the write buffer pool, or from the pool set if longer than the write buffer
+		@param[in] dataByteSize the byte size of the data
+		@return the write element acquired
+		*/
+		PipeWriteElem *acquireWriteElem(unsigned int dataByteSize);
+
+		/*!
+		Gather the writes waiting at the front of the write queue into one batched write
+		@remark the write queue lock must be held, and nothing must be in progress.
+		*/
+		void coalesceWrites();
+
+		/*!
+		Report the completion of the write element for each message it holds
+		@param[in] elem the write element completed
+		@param[in] status the write status
+		@param[in] errCode the error code
+		@param[in] cbWritten the bytes written
+		*/
+		void reportWrite(const PipeWriteElem *elem, WriteStatus status, unsigned long errCode, unsigned int cbWritten);
+
+		/*!
+		Report the data read for each message it holds
+		@param[in] errCode the error code
+		@param[in] cbBytesRead the bytes of the last part of the message read into the read buffer
+		*/
+		void reportRead(unsigned long errCode, unsigned int cbBytesRead);
+
+		/*!
+		Keep the part of the message read with ERROR_MORE_DATA, and make room for the rest
+		@param[in] cbBytesRead the bytes of the part read
+		@return true if the rest can be read, false if the message exceeds the maximum message byte size
+		*/
+		bool growRead(unsigned int cbBytesRead);
 		/*!
 		Reconnect to new client
 		*/
@@ -148,6 +318,83 @@ namespace epl{
 		*/
 		static void DisconnectAndReconnect(IpcPipe *pipeInst) ;
 
+		/*!
+		Start waiting for the client in the completion port mode
+		@return true if the connect is issued otherwise false
+		*/
+		bool listen();
+
+		/*!
+		Issue the next read in the completion port mode
+		@return true if the read is issued otherwise false
+		*/
+		bool startRead();
+
+		/*!
+		Issue the write at the front of the write queue in the completion port mode
+		@return true if the write is issued otherwise false
+		@remark the write queue lock must be held, and the front is removed if failed.
+		*/
+		bool issueWrite();
+
+		/*!
+		Handles when Connect is completed in the completion port mode
+		@param[in] success the flag whether the connect succeeded
+		@return true if the client is connected otherwise false
+		*/
+		bool onConnectCompletion(bool success);
+
+		/*!
+		Handles when Write is completed in the completion port mode
+		@param[in] success the flag whether the write succeeded
+		@param[in] cbWritten the bytes written
+		@param[in] dwErr the error code
+		*/
+		void onWriteCompletion(bool success, DWORD cbWritten, DWORD dwErr);
+
+		/*!
+		Disconnect the client and close the instance in the completion port mode
+		@remark the pending I/O completes with the failure, and releases the instance.
+		*/
+		void closeInstance();
+
+		/*!
+		Retain the instance for the I/O to issue in the completion port mode
+		@param[in] io the overlapped I/O to issue
+		@param[in] ioType the type of the I/O
+		*/
+		void retainIo(IpcPipeOverlapped &io, PipeIoType ioType);
+
+		/*!
+		Release the instance retained for the I/O which is not issued in the completion port mode
+		*/
+		void releaseIo();
+
+		/*!
+		Report the callback to the callback object, or queue it for the callback pool if given
+		@param[in] type the type of the callback
+		@param[in] status the read or write status
+		@param[in] errCode the error code
+		@param[in] byteSize the byte size of the data
+		@param[in] data the data read
+		@remark the data is copied when queued, so the read buffer can be reused after the call.
+		*/
+		void reportCallback(PipeCallbackType type, int status=0, unsigned long errCode=0, unsigned int byteSize=0, const char *data=NULL);
+
+		/*!
+		Call the callback object with the given callback
+		@param[in] callback the callback to deliver
+		*/
+		void deliverCallback(const IpcPipeCallback &callback);
+
+		/*!
+		Deliver the callbacks queued for the callback pool
+		@param[in] maxCount the maximum number of the callbacks to deliver
+		@return true if more callbacks remain queued otherwise false
+		@remark this is called on the callback pool, one call at a time for this instance.
+		*/
+		bool deliverQueuedCallbacks(unsigned int maxCount);
+
 		/*!
 		Handles when Read is completed
 		@param[in] dwErr the error code
@@ -181,19 +428,46 @@ namespace epl{
 		OVERLAPPED m_overlap; 
 		/// Pipe handle
 		HANDLE m_pipeHandle; 
-		/// Read buffer
-		char *m_readBuffer; 
+		/// Read buffer reassembling the message longer than the default buffer
+		IpcReadBuffer m_readBuffer; 
 		/// Size of bytes read from pipe
 		unsigned int m_bytesRead;
 		/// Pipe Event
 		EventEx m_pipeEvent;
+
+		/// the server which owns this instance
+		IpcServer *m_server;
+		/// Overlapped I/O for connect and read in the completion port mode
+		IpcPipeOverlapped m_readOverlap;
+		/// Overlapped I/O for write in the completion port mode
+		IpcPipeOverlapped m_writeOverlap;
 		
-		/// Write buffer queue
-		queue<PipeWriteElem*> m_writeQueue;
+		/// Write buffer queue (the front is the write in progress)
+		deque<PipeWriteElem*> m_writeQueue;
+
+		/// Write buffer queue bound
+		QueueBound m_writeQueueBound;
 
-		/// Lock for write buffer queue
+		/// Lock for write buffer queue (and the pipe state in the completion port mode)
 		BaseLock *m_writeQueueLock;
 
+		/// the pool of the write buffers
+		IpcWriteBufferPool *m_writeBufferPool;
+		/// the pool set for the messages longer than the default buffers
+		IpcBufferPoolSet *m_bufferPoolSet;
+
+		/// the metrics of this instance
+		IpcMetrics m_metrics;
+		/// the flag whether the metrics are reported by IPC_METRICS_INSTANCE
+		bool m_isMetricsRegistered;
+
+		/// the callbacks queued for the callback pool
+		deque<IpcPipeCallback> m_callbackQueue;
+		/// the flag whether the dispatch job is scheduled for the queued callbacks
+		bool m_isCallbackScheduled;
+		/// Lock for the callback queue
+		BaseLock *m_callbackLock;
+
 		/// Lock Policy
 		LockPolicy m_lockPolicy;
 	};
@@ -0,0 +1,467 @@
+/*! 
+@file epIpcRpc.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief IPC Request/Response Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for IPC Request/Response with the correlation IDs.
+
+*/
+#ifndef __EP_IPC_RPC_H__
+#define __EP_IPC_RPC_H__
+#include "epLib.h"
+#include "epSmartObject.h"
+#include "epEventEx.h"
+#include "epLightSemaphore.h"
+#include "epIpcServerInterfaces.h"
+#include "epIpcClientInterfaces.h"
+#include <map>
+#include <deque>
+#include <vector>
+
+namespace epl
+{
+/// the default maximum number of the requests in flight for each connection
+#define IPC_RPC_DEFAULT_MAX_IN_FLIGHT_COUNT 64
+
+	/// Enumeration for the type of the RPC message
+	typedef enum _ipcRpcMessageType{
+		/// The request from the client
+		IPC_RPC_MESSAGE_TYPE_REQUEST=0,
+		/// The response from the server
+		IPC_RPC_MESSAGE_TYPE_RESPONSE,
+		/// The fault response from the server
+		IPC_RPC_MESSAGE_TYPE_FAULT,
+	}IpcRpcMessageType;
+
+	/// Enumeration for the status of the RPC call
+	typedef enum _ipcRpcStatus{
+		/// The call is in flight
+		IPC_RPC_STATUS_NONE=0,
+		/// The response is received
+		IPC_RPC_STATUS_SUCCESS,
+		/// The fault response is received
+		IPC_RPC_STATUS_FAULT,
+		/// The window of the connection did not open in time
+		IPC_RPC_STATUS_FAIL_BUSY,
+		/// The request could not be written
+		IPC_RPC_STATUS_FAIL_WRITE_FAILED,
+		/// The connection is closed before the response
+		IPC_RPC_STATUS_FAIL_DISCONNECTED,
+		/// The call is cancelled
+		IPC_RPC_STATUS_CANCELLED,
+	}IpcRpcStatus;
+
+	/*! 
+	@struct IpcRpcHeader epIpcRpc.h
+	@brief A struct for the header prepended to each RPC message.
+	*/
+	struct IpcRpcHeader{
+		/// the correlation ID matching the response to the request
+		unsigned int m_correlationId;
+		/// the type of the message
+		unsigned int m_messageType;
+	};
+
+	/*! 
+	@class IpcRpcFuture epIpcRpc.h
+	@brief A class for future of the RPC call.
+	*/
+	class EP_LIBRARY IpcRpcFuture: public SmartObject
+	{
+	public:
+		friend class IpcRpcClient;
+
+		/*!
+		Default Constructor
+
+		Initializes the future
+		@param[in] correlationId the correlation ID of the call
+		@param[in] lockPolicyType The lock policy
+		*/
+		IpcRpcFuture(unsigned int correlationId, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the future
+		*/
+		virtual ~IpcRpcFuture();
+
+		/*!
+		Return the correlation ID of the call.
+		@return the correlation ID of the call.
+		*/
+		unsigned int GetCorrelationId() const;
+
+		/*!
+		Check if the future is ready.
+		@return true if the call is completed, otherwise false.
+		*/
+		bool IsReady() const;
+
+		/*!
+		Wait for the call to be completed.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if the call is completed, otherwise false.
+		@remark the call is still in flight after the time-out, so Cancel it to give its window back.
+		*/
+		bool Wait(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Return the final status of the call.
+		@return the final status of the call, or IPC_RPC_STATUS_NONE if not ready.
+		*/
+		IpcRpcStatus GetStatus() const;
+
+		/*!
+		Return the response of the call.
+		@return the response, or NULL if not ready or no response.
+		*/
+		const char *GetResponse() const;
+
+		/*!
+		Return the byte size of the response.
+		@return the byte size of the response.
+		*/
+		unsigned int GetResponseByteSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcRpcFuture(const IpcRpcFuture & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcRpcFuture &operator=(const IpcRpcFuture & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Make this future ready with given status and response.
+		@param[in] status the final status of the call.
+		@param[in] response the response. (NULL for no response)
+		@param[in] responseByteSize the byte size of the response.
+		@remark this is called only once for each call.
+		*/
+		void complete(IpcRpcStatus status, const char *response=NULL, unsigned int responseByteSize=0);
+
+		/// the correlation ID of the call
+		unsigned int m_correlationId;
+		/// the response
+		std::vector<char> m_response;
+		/// ready flag
+		volatile long m_isReady;
+		/// the number of waiting threads
+		volatile long m_waiterCount;
+		/// the final status of the call
+		IpcRpcStatus m_status;
+		/// ready event
+		EventEx m_readyEvent;
+	};
+
+	/*! 
+	@class IpcRpcClient epIpcRpc.h
+	@brief A class for the client side of the RPC over the IPC client.
+
+	This object must be set as the callback object of the IPC client.
+	Many calls are in flight on one connection at a time, each matched to its response by the correlation ID,
+	and the number of calls in flight is bounded by the window of the connection.
+	*/
+	class EP_LIBRARY IpcRpcClient: public IpcClientCallbackInterface
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the RPC client
+		@param[in] client the IPC client to send the requests.
+		@param[in] maxInFlightCount the maximum number of the calls in flight.
+		@param[in] lockPolicyType The lock policy
+		*/
+		IpcRpcClient(IpcClientInterface *client, unsigned int maxInFlightCount=IPC_RPC_DEFAULT_MAX_IN_FLIGHT_COUNT, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Cancel the calls in flight and destroy the RPC client
+		*/
+		virtual ~IpcRpcClient();
+
+		/*!
+		Send the request to the server.
+		@param[in] request the request to send.
+		@param[in] requestByteSize the byte size of the request.
+		@param[in] waitTimeInMilliSec the time to wait for the window of the connection to open, in milliseconds.
+		@return the future of the call.
+		@remark the returned future is retained for the caller, so the caller must call ReleaseObj.
+		@remark the future is completed before return if the call failed to start.
+		*/
+		IpcRpcFuture *Call(const char *request, unsigned int requestByteSize, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Cancel the call in flight.
+		@param[in] future the future of the call.
+		@return true if cancelled, false if already completed.
+		@remark the response arriving later is ignored.
+		*/
+		bool Cancel(IpcRpcFuture *future);
+
+		/*!
+		Cancel all calls in flight.
+		*/
+		void CancelAll();
+
+		/*!
+		Return the number of the calls in flight.
+		@return the number of the calls in flight.
+		*/
+		unsigned int GetInFlightCount() const;
+
+		/*!
+		Return the maximum number of the calls in flight.
+		@return the maximum number of the calls in flight.
+		*/
+		unsigned int GetMaxInFlightCount() const;
+
+		/*!
+		Return the maximum byte size of the request.
+		@return the maximum byte size of the request.
+		*/
+		unsigned int GetMaxRequestByteSize() const;
+
+		/*!
+		Received the response from the server.
+		@param[in] pipe the pipe which received the packet
+		@param[in] receivedData the received data
+		@param[in] receivedDataByteSize the received data byte size
+		@param[in] status the status of read
+		@param[in] errCode the error code
+		*/
+		virtual void OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode);
+
+		/*!
+		The request is written.
+		@param[in] pipe the pipe which wrote the packet
+		@param[in] writtenDataByteSize the byte size of data written
+		@param[in] status the status of write
+		@param[in] errCode the error code
+		*/
+		virtual void OnWriteComplete(IpcClientInterface *pipe,unsigned int writtenDataByteSize, WriteStatus status, unsigned long errCode);
+
+		/*!
+		The pipe is disconnected, so the calls in flight are failed.
+		@param[in] pipe the pipe, disconnected.
+		*/
+		virtual void OnDisconnect(IpcClientInterface *pipe);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcRpcClient(const IpcRpcClient & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcRpcClient &operator=(const IpcRpcClient & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Remove the call from the calls in flight, and complete its future.
+		@param[in] correlationId the correlation ID of the call.
+		@param[in] status the final status of the call.
+		@param[in] response the response. (NULL for no response)
+		@param[in] responseByteSize the byte size of the response.
+		@return true if the call was in flight, otherwise false.
+		*/
+		bool finish(unsigned int correlationId, IpcRpcStatus status, const char *response=NULL, unsigned int responseByteSize=0);
+
+		/*!
+		Complete all calls in flight with given status.
+		@param[in] status the final status of the calls.
+		*/
+		void finishAll(IpcRpcStatus status);
+
+		/// the IPC client
+		IpcClientInterface *m_client;
+		/// the maximum number of the calls in flight
+		unsigned int m_maxInFlightCount;
+		/// the window of the connection
+		LightSemaphore m_window;
+		/// the correlation ID of the last call
+		volatile long m_lastCorrelationId;
+		/// the calls in flight
+		std::map<unsigned int,IpcRpcFuture*> m_pendingMap;
+		/// the correlation IDs of the requests in the order written, matched to the write completions
+		std::deque<unsigned int> m_writeOrder;
+		/// the lock for the calls in flight
+		BaseLock *m_pendingLock;
+		/// the lock for the write order
+		BaseLock *m_writeOrderLock;
+		/// the lock keeping the write order same as the order written
+		BaseLock *m_writeLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class IpcRpcRequestHandlerInterface epIpcRpc.h
+	@brief A class for the handler of the RPC requests on the server.
+	*/
+	class EP_LIBRARY IpcRpcRequestHandlerInterface
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcRpcRequestHandlerInterface(){}
+
+		/*!
+		Received the request from the client.
+		@param[in] pipe the pipe which received the request
+		@param[in] correlationId the correlation ID to pass to IpcRpcServer::Respond
+		@param[in] request the request
+		@param[in] requestByteSize the byte size of the request
+		@remark the response may be sent later from any thread, in any order, if the pipe is retained until then.
+		*/
+		virtual void OnRequest(IpcInterface *pipe, unsigned int correlationId, const char *request, unsigned int requestByteSize)=0;
+
+		/*!
+		When accepted client tries to make connection.
+		@param[in] pipe the pipe
+		*/
+		virtual void OnNewConnection(IpcInterface *pipe){}
+
+		/*!
+		The pipe is disconnected.
+		@param[in] pipe the pipe, disconnected.
+		*/
+		virtual void OnDisconnect(IpcInterface *pipe){}
+	};
+
+	/*! 
+	@class IpcRpcServer epIpcRpc.h
+	@brief A class for the server side of the RPC over the IPC server.
+
+	This object must be set as the callback object of the IPC server.
+	*/
+	class EP_LIBRARY IpcRpcServer: public IpcServerCallbackInterface
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the RPC server
+		@param[in] handler the handler of the requests.
+		*/
+		IpcRpcServer(IpcRpcRequestHandlerInterface *handler);
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcRpcServer();
+
+		/*!
+		Send the response to the request.
+		@param[in] pipe the pipe which received the request
+		@param[in] correlationId the correlation ID of the request
+		@param[in] response the response
+		@param[in] responseByteSize the byte size of the response
+		*/
+		static void Respond(IpcInterface *pipe, unsigned int correlationId, const char *response, unsigned int responseByteSize);
+
+		/*!
+		Send the fault response to the request.
+		@param[in] pipe the pipe which received the request
+		@param[in] correlationId the correlation ID of the request
+		@param[in] reason the reason of the fault (NULL for no reason)
+		@param[in] reasonByteSize the byte size of the reason
+		*/
+		static void RespondFault(IpcInterface *pipe, unsigned int correlationId, const char *reason=NULL, unsigned int reasonByteSize=0);
+
+		/*!
+		Return the maximum byte size of the response.
+		@param[in] pipe the pipe to respond
+		@return the maximum byte size of the response.
+		*/
+		static unsigned int GetMaxResponseByteSize(const IpcInterface *pipe);
+
+		/*!
+		When accepted client tries to make connection.
+		@param[in] pipe the pipe
+		*/
+		virtual void OnNewConnection(IpcInterface *pipe);
+
+		/*!
+		Received the request from the client.
+		@param[in] pipe the pipe which received the packet
+		@param[in] receivedData the received data
+		@param[in] receivedDataByteSize the received data byte size
+		@param[in] status the status of read
+		@param[in] errCode the error code
+		*/
+		virtual void OnReadComplete(IpcInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode);
+
+		/*!
+		The pipe is disconnected.
+		@param[in] pipe the pipe, disconnected.
+		*/
+		virtual void OnDisconnect(IpcInterface *pipe);
+
+	private:
+		/*!
+		Send the message with the header.
+		@param[in] pipe the pipe to write
+		@param[in] correlationId the correlation ID of the request
+		@param[in] messageType the type of the message
+		@param[in] data the data to send
+		@param[in] dataByteSize the byte size of the data
+		*/
+		static void send(IpcInterface *pipe, unsigned int correlationId, IpcRpcMessageType messageType, const char *data, unsigned int dataByteSize);
+
+		/// the handler of the requests
+		IpcRpcRequestHandlerInterface *m_handler;
+	};
+}
+
+#endif //__EP_IPC_RPC_H__
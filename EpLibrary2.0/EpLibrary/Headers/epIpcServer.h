@@ -43,6 +43,7 @@ An Interface for the IPC Server Class.
 #include "epEventEx.h"
 #include "epIpcServerInterfaces.h"
 #include "epIpcPipe.h"
+#include "epBaseJobProcessor.h"
 #include <vector>
 
 using namespace std;
@@ -51,8 +52,17 @@ namespace epl{
 	/*! 
 	@class IpcServer epIpcServer.h
 	@brief A class for IPC Server.
+
+	In IPC_SERVER_MODE_COMPLETION_ROUTINE, all pipe instances are created at start and served on the server thread,
+	so the maximum instances are limited to MAXIMUM_WAIT_OBJECTS.
+	In IPC_SERVER_MODE_COMPLETION_PORT, only the listening instances are kept waiting for the clients,
+	and the new instance is created whenever one gets connected, while the I/O is served by the pool of the completion port threads.
 	*/
-	class EP_LIBRARY IpcServer:public Thread,public IpcServerInterface{
+	class EP_LIBRARY IpcServer:public Thread,public IpcServerInterface,public IpcMetricsSourceInterface{
+		friend class IpcPipe;
+		friend class IpcCompletionThread;
+		friend class IpcCallbackJob;
+		friend class IpcCallbackJobProcessor;
 	public:
 		/*!
 		Default Constructor
@@ -127,6 +137,19 @@ namespace epl{
 		@return the maximum read data byte size
 		*/
 		virtual unsigned int GetMaxReadDataByteSize() const;
+
+		/*!
+		Copy the current metrics of all instances to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		@remark the counters are cumulative, so subtract the earlier snapshot to get the counters of an interval.
+		*/
+		virtual void GetMetrics(IpcMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Report the metrics by IPC_METRICS_INSTANCE with the given name.
+		@param[in] name the name in the report.
+		*/
+		void SetMetricsName(const TCHAR *name);
 	private:
 		/*!
 		Listening Loop Function
@@ -137,6 +160,65 @@ namespace epl{
 		Actually Stop the server
 		*/
 		void stopServer();
+
+		/*!
+		Start the server in the completion port mode
+		@return true if successfully started otherwise false
+		*/
+		bool startCompletionServer();
+
+		/*!
+		Stop the server in the completion port mode
+		*/
+		void stopCompletionServer();
+
+		/*!
+		Create the listening instances until the number of listening instances reaches the option
+		@remark the pipe list lock must be held.
+		*/
+		void addListeningInstances();
+
+		/*!
+		Remove the closed instance from the pipe list, and replace the listening instance if needed
+		@param[in] pipeInst the instance to remove
+		@param[in] isListening the flag whether the instance was listening
+		*/
+		void removeInstance(IpcPipe *pipeInst, bool isListening);
+
+		/*!
+		Dequeue and handle the completions until the server stops
+		@remark this is called on the completion port threads.
+		*/
+		void processCompletions();
+
+		/*!
+		Handle the completion of the I/O dequeued from the completion port
+		@param[in] io the overlapped I/O completed
+		@param[in] success the flag whether the I/O succeeded
+		@param[in] bytesTransferred the bytes transferred
+		@param[in] errCode the error code
+		*/
+		void handleCompletion(IpcPipeOverlapped *io, bool success, unsigned long bytesTransferred, unsigned long errCode);
+
+		/*!
+		Release the instance retained for the I/O
+		@param[in] pipeInst the instance which issued the I/O
+		*/
+		void releaseIo(IpcPipe *pipeInst);
+
+		/*!
+		Push the dispatch job delivering the queued callbacks of the instance to the callback pool
+		@param[in] pipeInst the instance whose callbacks are queued
+		*/
+		void scheduleCallbacks(IpcPipe *pipeInst);
+
+		/*!
+		Deliver the queued callbacks of the instance, and push the job again if more remain
+		@param[in] pipeInst the instance whose callbacks are queued
+		@param[in] isDropped the flag whether the job was dropped by the pool, so all callbacks are delivered at once
+		@remark this is called on the callback pool.
+		*/
+		void dispatchCallbacks(IpcPipe *pipeInst, bool isDropped=false);
 		
 	private:
 		/// pipe list
@@ -157,6 +239,33 @@ namespace epl{
 
 		/// Server termination event
 		EventEx m_serverThreadEvent;
+
+		/// the completion port (IPC_SERVER_MODE_COMPLETION_PORT only)
+		HANDLE m_completionPort;
+		/// the completion port threads
+		vector<Thread*> m_completionThreads;
+		/// the number of the listening instances
+		unsigned int m_listeningCount;
+		/// the number of the I/O pending on the completion port
+		volatile long m_ioCount;
+		/// the event set when all pending I/O are completed after stop
+		EventEx m_ioDrainedEvent;
+
+		/// the job processor delivering the queued callbacks
+		BaseJobProcessor *m_callbackProcessor;
+
+		/// the pool of the write buffers shared by all instances
+		IpcWriteBufferPool *m_writeBufferPool;
+		/// the pool set for the messages longer than the default buffers shared with the instances
+		IpcBufferPoolSet *m_bufferPoolSet;
+		/// the metrics of all instances
+		IpcMetrics m_metrics;
+		/// the flag whether the metrics are reported by IPC_METRICS_INSTANCE
+		bool m_isMetricsRegistered;
+		/// the number of the dispatch jobs pushed to the callback pool
+		volatile long m_callbackJobCount;
+		/// the event set when all dispatch jobs are done after stop
+		EventEx m_callbackDrainedEvent;
 	};
 
 }
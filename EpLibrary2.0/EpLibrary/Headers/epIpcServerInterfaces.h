@@ -42,11 +42,23 @@ An Interface for the IPC Server Interfaces.
 
 #include "epLib.h"
 #include "epIpcConf.h"
+#include "epQueueBound.h"
 
 namespace epl
 {
 
 	class IpcServerCallbackInterface;
+	class ThreadPool;
+	class ElasticWorkerPool;
+
+	/// IPC Server Mode
+	typedef enum _ipcServerMode{
+		/// All pipe instances are created at start, and served by the completion routines on the server thread
+		IPC_SERVER_MODE_COMPLETION_ROUTINE=0,
+		/// The pipe instances are created as the clients connect, and served by the pool of the completion port threads
+		IPC_SERVER_MODE_COMPLETION_PORT,
+	}IpcServerMode;
+
 	/*! 
 	@struct ServerOps epIpcServerInterfaces.h
 	@brief A class for IPC Server Options.
@@ -63,10 +75,28 @@ namespace epl
 		unsigned int waitTimeInMilliSec;
 		///The maximum possible number of pipe instances
 		unsigned int maximumInstances;
-		/// read byte size
+		/// the byte size of the default read buffer of each instance
 		unsigned int numOfReadBytes;
-		/// write byte size
+		/// the byte size of the pooled write buffer
 		unsigned int numOfWriteBytes;
+		/// the maximum number of pending writes per pipe (0 for unbounded)
+		unsigned int writeQueueCapacity;
+		/// the policy when the write queue is full (OVERFLOW_POLICY_BLOCK is treated as OVERFLOW_POLICY_FAIL)
+		OverflowPolicy writeQueueOverflowPolicy;
+		/// the server mode
+		IpcServerMode serverMode;
+		/// the number of the completion port threads (0 for the number of the cores, IPC_SERVER_MODE_COMPLETION_PORT only)
+		unsigned int completionThreadCount;
+		/// the number of the pipe instances kept waiting for the clients (IPC_SERVER_MODE_COMPLETION_PORT only)
+		unsigned int listeningInstances;
+		/// the thread pool to dispatch the callbacks to (NULL to call them on the I/O thread)
+		ThreadPool *callbackPool;
+		/// the worker pool to dispatch the callbacks to, used when callbackPool is NULL (NULL to call them on the I/O thread)
+		ElasticWorkerPool *callbackWorkerPool;
+		/// the maximum byte size of the batched write gathering the queued messages with the framing (0 to write each message as it is, both ends must use the same)
+		unsigned int writeBatchByteSize;
+		/// the maximum byte size of the message read or written, the message longer than numOfReadBytes is reassembled (0 for no limit)
+		unsigned int maxMessageByteSize;
 
 		/*!
 		Default Constructor
@@ -82,6 +112,15 @@ namespace epl
 			maximumInstances=PIPE_UNLIMITED_INSTANCES;
 			numOfReadBytes=DEFAULT_READ_BUF_SIZE;
 			numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
+			writeQueueCapacity=0;
+			writeQueueOverflowPolicy=OVERFLOW_POLICY_FAIL;
+			serverMode=IPC_SERVER_MODE_COMPLETION_ROUTINE;
+			completionThreadCount=0;
+			listeningInstances=DEFAULT_LISTENING_INSTANCES;
+			callbackPool=NULL;
+			callbackWorkerPool=NULL;
+			writeBatchByteSize=0;
+			maxMessageByteSize=0;
 
 		}
 
@@ -94,6 +133,11 @@ namespace epl
 	@brief A class for IPC Server Interface.
 	*/
 	class EP_LIBRARY IpcServerInterface{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcServerInterface(){}
 
 		/*!
 		Get the pipe name of server
@@ -169,6 +213,34 @@ namespace epl
 		@param[in] dataByteSize byte size of the data
 		*/
 		virtual void Write(char *data,unsigned int dataByteSize)=0;
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)=0;
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize byte size of the data to write
+		@return the write element whose m_data holds dataByteSize bytes
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize)=0;
+
+		/*!
+		Write the pooled write buffer to the pipe without copying
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, so the caller must not touch it after the call.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem)=0;
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const=0;
 	
 		/*!
 		Check if the connection is alive
@@ -199,6 +271,9 @@ namespace epl
 	/*! 
 	@class IpcServerCallbackInterface epIpcServerInterfaces.h
 	@brief A class for Server Callback Interface.
+
+	When the callback pool is given in the server options, the callbacks of one pipe are delivered one at a time in order,
+	while the callbacks of the different pipes run in parallel on the pool.
 	*/
 	class EP_LIBRARY IpcServerCallbackInterface{
 	public:
@@ -0,0 +1,125 @@
+/*! 
+@file epJobBenchmark.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Job Benchmark Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Job Benchmark.
+
+*/
+#ifndef __EP_JOB_BENCHMARK_H__
+#define __EP_JOB_BENCHMARK_H__
+#include "epLib.h"
+#include "epBenchmark.h"
+
+/// the number of the loop iterations of the work done by each job of the fan-out and the load
+#define JOB_BENCHMARK_WORK_COUNT 1000
+
+/// the number of the jobs spread and joined per operation of the fan-out/fan-in
+#define JOB_BENCHMARK_FAN_COUNT 64
+
+/// the number of the low priority jobs queued ahead of the high priority job in the priority inversion
+#define JOB_BENCHMARK_LOAD_COUNT 256
+
+namespace epl
+{
+	/// Enumeration for the job system measured
+	enum JobBenchmarkTarget{
+		/// the workers of WorkerThreadFactory with THREAD_LIFE_INFINITE
+		JOB_BENCHMARK_TARGET_INFINITE=0,
+		/// the workers of WorkerThreadFactory with THREAD_LIFE_SUSPEND_AFTER_WORK
+		JOB_BENCHMARK_TARGET_SUSPEND_AFTER_WORK,
+		/// the work-stealing ThreadPool
+		JOB_BENCHMARK_TARGET_THREAD_POOL,
+		/// Target Count
+		JOB_BENCHMARK_TARGET_COUNT,
+	};
+
+	/*! 
+	@class JobBenchmark epJobBenchmark.h
+	@brief A class for measuring the throughput and the latency of the worker threads and the thread pool.
+
+	Each case is measured for each target, and for the worker counts from 1 up to given count, doubling each time.
+	The jobs of the workers of WorkerThreadFactory are pushed to the workers in round-robin,
+	so each worker schedules its share by its own JobScheduleQueue.
+	The jobs are recycled by JobPool, so the allocation of the jobs is not included.
+	The results are added to BENCHMARK_INSTANCE, and reported by its Print or FlushToFile.
+	*/
+	class EP_LIBRARY JobBenchmark
+	{
+	public:
+		/*!
+		Run all the job benchmarks for all targets.
+		@param[in] maxWorkerCount the largest number of the workers to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void Run(unsigned int maxWorkerCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark of pushing the empty jobs as fast as they are processed.
+		@param[in] target the job system to measure.
+		@param[in] maxWorkerCount the largest number of the workers to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the ops_per_sec of the report is the jobs processed per second by all workers together.
+		*/
+		static void RunThroughput(JobBenchmarkTarget target, unsigned int maxWorkerCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark of pushing one empty job at a time to the idle workers, and waiting for it.
+		@param[in] target the job system to measure.
+		@param[in] maxWorkerCount the largest number of the workers to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the percentiles of the time from the push until the job processor starts the job are reported
+		as the cases with the suffix P50, P90, P99 and Max, which includes waking up the worker.
+		*/
+		static void RunLatency(JobBenchmarkTarget target, unsigned int maxWorkerCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark of spreading JOB_BENCHMARK_FAN_COUNT jobs to the workers, and waiting for all of them per operation.
+		@param[in] target the job system to measure.
+		@param[in] maxWorkerCount the largest number of the workers to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunFanOutIn(JobBenchmarkTarget target, unsigned int maxWorkerCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark of pushing one high priority job behind JOB_BENCHMARK_LOAD_COUNT low priority jobs per operation.
+		@param[in] target the job system to measure.
+		@param[in] maxWorkerCount the largest number of the workers to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the percentiles of the time from the push of the high priority job until it starts are reported
+		as the cases with the suffix P50, P90, P99 and Max.
+		@remark ThreadPool does not order its jobs by the priority, so its high priority job starts by the order of its deques.
+		*/
+		static void RunPriorityInversion(JobBenchmarkTarget target, unsigned int maxWorkerCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+	};
+}
+#endif //__EP_JOB_BENCHMARK_H__
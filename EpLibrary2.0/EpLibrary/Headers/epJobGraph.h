@@ -0,0 +1,227 @@
+/*! 
+@file epJobGraph.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Job Graph Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Job Dependency Graph Executor Class.
+
+*/
+#ifndef __EP_JOB_GRAPH_H__
+#define __EP_JOB_GRAPH_H__
+#include "epLib.h"
+#include <vector>
+#include "epBaseJob.h"
+#include "epBaseWorkerThread.h"
+#include "epThreadPool.h"
+#include "epEventEx.h"
+
+namespace epl
+{
+	/*! 
+	@class JobGraph epJobGraph.h
+	@brief A class that executes the jobs in the order of their dependencies.
+
+	Each job is pushed to the worker thread or the thread pool as soon as all its predecessors are done.
+	If a predecessor does not finish with JOB_STATUS_DONE, its successors are not run and reported as JOB_STATUS_INCOMPLETE.
+	The graph can be run again after it finishes, without reallocating its nodes.
+	*/
+	class EP_LIBRARY JobGraph
+	{
+	public:
+		friend class BaseJob;
+
+		/// Node Index Type
+		typedef unsigned int NodeIndex;
+
+		/*!
+		Default Constructor
+
+		Initializes the job graph
+		@param[in] useCriticalPathPriority set true to overwrite the priority of each job with its critical path length.
+		@param[in] lockPolicyType The lock policy
+		*/
+		JobGraph(bool useCriticalPathPriority=true, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the job graph
+		@remark the graph must not be running.
+		*/
+		virtual ~JobGraph();
+
+		/*!
+		Add the job to the graph.
+		@param[in] job the job to add.
+		@return the node index of the job.
+		@remark a job can only belong to one graph.
+		*/
+		NodeIndex AddJob(BaseJob * const job);
+
+		/*!
+		Add the dependency so that the job of afterIdx runs after the job of beforeIdx.
+		@param[in] beforeIdx the node index of the predecessor.
+		@param[in] afterIdx the node index of the successor.
+		@return true if successfully added, otherwise false.
+		*/
+		bool AddDependency(NodeIndex beforeIdx, NodeIndex afterIdx);
+
+		/*!
+		Remove all jobs and dependencies from the graph.
+		@remark the graph must not be running.
+		*/
+		void Clear();
+
+		/*!
+		Run the graph on the given worker thread.
+		@param[in] workerThread the worker thread to push the ready jobs to.
+		@return true if successfully started, otherwise false.
+		*/
+		bool Run(BaseWorkerThread *workerThread);
+
+		/*!
+		Run the graph on the given thread pool.
+		@param[in] threadPool the thread pool to push the ready jobs to.
+		@return true if successfully started, otherwise false.
+		*/
+		bool Run(ThreadPool *threadPool);
+
+		/*!
+		Wait for all jobs in the graph to be finished.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if all jobs are finished, otherwise false.
+		*/
+		bool Wait(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Return the flag whether the graph is running.
+		@return true if the graph is running, otherwise false.
+		*/
+		bool IsRunning() const;
+
+		/*!
+		Return the number of jobs in the graph.
+		@return the number of jobs.
+		*/
+		size_t GetJobCount() const;
+
+		/*!
+		Return the number of jobs which did not finish with JOB_STATUS_DONE in the last run.
+		@return the number of incomplete jobs.
+		*/
+		size_t GetIncompleteCount() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		JobGraph(const JobGraph & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		JobGraph &operator=(const JobGraph & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Compute the critical path length of each node, and check for cycles.
+		@return true if the graph has no cycle, otherwise false.
+		*/
+		bool build();
+
+		/*!
+		Reset the counters and push the root jobs.
+		@return true if successfully started, otherwise false.
+		*/
+		bool start();
+
+		/*!
+		Push the given job to the current target.
+		@param[in] job the job to push.
+		*/
+		void dispatch(BaseJob *job);
+
+		/*!
+		Called when the job of given node reaches the final status.
+		@param[in] nodeIdx the node index of the job.
+		@param[in] status the final status of the job.
+		*/
+		void onJobFinished(NodeIndex nodeIdx, const BaseJob::JobStatus status);
+
+		/// Job Node
+		struct JobNode
+		{
+			/// the job
+			BaseJob *m_job;
+			/// the successors
+			std::vector<NodeIndex> m_successorList;
+			/// the number of predecessors
+			long m_predecessorCount;
+			/// the number of predecessors not finished in the current run
+			volatile long m_pendingCount;
+			/// the flag whether any predecessor failed in the current run
+			volatile long m_isFailed;
+			/// the critical path length from this node
+			Priority m_pathLength;
+		};
+
+		/// the nodes
+		std::vector<JobNode> m_nodeList;
+		/// the flag whether the critical path needs rebuilding
+		bool m_isDirty;
+		/// the flag for critical path priority
+		bool m_useCriticalPathPriority;
+		/// the number of jobs not finished in the current run
+		volatile long m_remainingCount;
+		/// the number of jobs not finished with JOB_STATUS_DONE in the current run
+		volatile long m_incompleteCount;
+		/// the flag for running
+		volatile long m_isRunning;
+		/// the worker thread target
+		BaseWorkerThread *m_workerThread;
+		/// the thread pool target
+		ThreadPool *m_threadPool;
+		/// finish event
+		EventEx m_finishEvent;
+		/// graph lock
+		BaseLock *m_graphLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_JOB_GRAPH_H__
\ No newline at end of file
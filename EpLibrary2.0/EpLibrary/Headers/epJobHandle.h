@@ -0,0 +1,193 @@
+/*! 
+@file epJobHandle.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Job Handle Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Job Completion Handle Class.
+
+*/
+#ifndef __EP_JOB_HANDLE_H__
+#define __EP_JOB_HANDLE_H__
+#include "epLib.h"
+#include <vector>
+#include "epBaseJob.h"
+#include "epEventEx.h"
+
+namespace epl
+{
+	class JobHandle;
+
+	/*! 
+	@class JobContinuation epJobHandle.h
+	@brief A base class for continuation to run when the job is completed.
+	*/
+	class EP_LIBRARY JobContinuation: public SmartObject
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~JobContinuation(){}
+
+		/*!
+		Called when the handle becomes ready, subclasses must implement this function.
+		@param[in] handle the handle which became ready.
+		@remark this is called on the thread which completed the job.
+		*/
+		virtual void Continue(JobHandle *handle)=0;
+
+	protected:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy
+		*/
+		JobContinuation(LockPolicy lockPolicyType=EP_LOCK_POLICY):SmartObject(lockPolicyType)
+		{
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the JobContinuation
+		@param[in] b the second object
+		*/
+		JobContinuation(const JobContinuation& b):SmartObject(b)
+		{
+		}
+	};
+
+	/*! 
+	@class JobHandle epJobHandle.h
+	@brief A class for future of the job completion.
+
+	The handle becomes ready when the job reaches one of the final status
+	(JOB_STATUS_DONE, JOB_STATUS_INCOMPLETE, JOB_STATUS_JOB_PROCESSOR_TIMEOUT, JOB_STATUS_TIMEOUT).
+	*/
+	class EP_LIBRARY JobHandle: public SmartObject
+	{
+	public:
+		friend class BaseJob;
+
+		/*!
+		Default Constructor
+
+		Initializes the handle
+		@param[in] lockPolicyType The lock policy
+		*/
+		JobHandle(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the handle
+		*/
+		virtual ~JobHandle();
+
+		/*!
+		Check if the handle is ready.
+		@return true if the job is completed, otherwise false.
+		*/
+		bool IsReady() const;
+
+		/*!
+		Wait for the job to be completed.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if the job is completed, otherwise false.
+		*/
+		bool Wait(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Return the final status of the job.
+		@return the final status of the job, or JOB_STATUS_NONE if not ready.
+		*/
+		BaseJob::JobStatus GetStatus() const;
+
+		/*!
+		Register the continuation to run when this handle becomes ready.
+		@param[in] continuation the continuation to run.
+		@return the new handle which becomes ready after the continuation runs.
+		@remark the continuation runs on the completing thread, or immediately on the calling thread if already ready.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		*/
+		JobHandle *Then(JobContinuation *continuation);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		JobHandle(const JobHandle & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		JobHandle &operator=(const JobHandle & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Make this handle ready with given status, and run the continuations.
+		@param[in] status the final status of the job.
+		@remark only the first call has effect.
+		*/
+		void complete(const BaseJob::JobStatus status);
+
+		/// Continuation and its chained handle
+		struct ContinuationNode
+		{
+			/// the continuation to run
+			JobContinuation *m_continuation;
+			/// the handle to complete after the continuation
+			JobHandle *m_nextHandle;
+		};
+
+		/// the list of continuations
+		std::vector<ContinuationNode> m_continuationList;
+		/// ready flag
+		volatile long m_isReady;
+		/// the number of waiting threads
+		volatile long m_waiterCount;
+		/// the final status of the job
+		BaseJob::JobStatus m_resultStatus;
+		/// ready event
+		EventEx m_readyEvent;
+		/// handle lock
+		BaseLock *m_handleLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_JOB_HANDLE_H__
\ No newline at end of file
@@ -0,0 +1,201 @@
+/*! 
+@file epJobPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Job Pool Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Job Object Pool Class.
+
+*/
+#ifndef __EP_JOB_POOL_H__
+#define __EP_JOB_POOL_H__
+#include "epLib.h"
+#include <vector>
+#include <set>
+#include "epBaseJob.h"
+
+namespace epl
+{
+	/*! 
+	@class BaseJobPool epJobPool.h
+	@brief A base class for the free list which recycles the Job objects of one type.
+
+	When the last reference of the pooled job is released, the job is reset by BaseJob::handleRecycle
+	and kept in the free list instead of being deleted, so the steady-state submission allocates nothing.
+	*/
+	class EP_LIBRARY BaseJobPool
+	{
+	public:
+		friend class BaseJob;
+
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] maxFreeCount the maximum number of jobs kept in the free list. (0 for unlimited)
+		@param[in] lockPolicyType The lock policy
+		*/
+		BaseJobPool(size_t maxFreeCount=0, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Delete the jobs in the free list, and detach the jobs still in use, so they are deleted when released.
+		@remark all jobs should be released before the pool is destroyed.
+		*/
+		virtual ~BaseJobPool();
+
+		/*!
+		Create the jobs in advance up to the given number in the free list.
+		@param[in] count the number of jobs to have in the free list.
+		*/
+		void Reserve(size_t count);
+
+		/*!
+		Return the number of jobs in the free list.
+		@return the number of jobs in the free list.
+		*/
+		size_t GetFreeCount() const;
+
+		/*!
+		Return the number of jobs created by this pool and not deleted yet.
+		@return the number of jobs created by this pool.
+		*/
+		size_t GetJobCount() const;
+
+	protected:
+		/*!
+		Return the job from the free list, or create new one if the free list is empty.
+		@return the job with the reference count 1, so the caller must call ReleaseObj.
+		*/
+		BaseJob *acquireJob();
+
+		/*!
+		Create the new job of the type of this pool, subclasses must implement this function.
+		@return the new job.
+		*/
+		virtual BaseJob *createJob()=0;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		BaseJobPool(const BaseJobPool & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		BaseJobPool &operator=(const BaseJobPool & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Create the new job, and register it to this pool.
+		@return the new job.
+		*/
+		BaseJob *newJob();
+
+		/*!
+		Keep the given released job in the free list.
+		@param[in] job the job released.
+		@return true if the job is kept, false if the free list is full and the job must be deleted.
+		*/
+		bool recycleJob(BaseJob *job);
+
+		/// the free list
+		std::vector<BaseJob*> m_freeList;
+		/// all jobs created and not deleted
+		std::set<BaseJob*> m_jobSet;
+		/// the maximum number of jobs in the free list
+		size_t m_maxFreeCount;
+		/// pool lock
+		BaseLock *m_poolLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*! 
+	@class JobPool epJobPool.h
+	@brief A template free list for the Job class JobType.
+
+	JobType must derive from BaseJob and have the default constructor.
+	Overwrite BaseJob::handleRecycle in JobType to reset its own members.
+	*/
+	template<typename JobType>
+	class JobPool: public BaseJobPool
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] maxFreeCount the maximum number of jobs kept in the free list. (0 for unlimited)
+		@param[in] lockPolicyType The lock policy
+		*/
+		JobPool(size_t maxFreeCount=0, LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseJobPool(maxFreeCount,lockPolicyType)
+		{
+		}
+
+		/*!
+		Default Destructor
+
+		Destroy the pool
+		*/
+		virtual ~JobPool()
+		{
+		}
+
+		/*!
+		Return the recycled job, or new one if none is free.
+		@return the job with the reference count 1, so the caller must call ReleaseObj.
+		*/
+		JobType *Acquire()
+		{
+			return static_cast<JobType*>(acquireJob());
+		}
+
+	protected:
+		/*!
+		Create the new JobType object.
+		@return the new job.
+		*/
+		virtual BaseJob *createJob()
+		{
+			return EP_NEW JobType();
+		}
+	};
+}
+
+#endif //__EP_JOB_POOL_H__
\ No newline at end of file
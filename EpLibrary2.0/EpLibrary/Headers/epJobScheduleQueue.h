@@ -38,16 +38,28 @@ An Interface for Job Scheudle Queue.
 #ifndef __EP_JOB_SCHEDULE_QUEUE_H__
 #define __EP_JOB_SCHEDULE_QUEUE_H__
 #include "epLib.h"
+#include <map>
+#include <deque>
+#include <vector>
+#include <functional>
 #include "epThreadSafePQueue.h"
 #include "epBaseJob.h"
+#include "epQueueBound.h"
+#include "epSmartPtr.h"
 
 namespace epl
 {
 	/*! 
 	@class JobScheduleQueue epJobScheduleQueue.h
 	@brief A class for Thread Safe Priority Queue.
+
+	The jobs are kept in one FIFO band per priority, and the bands are ordered from the highest priority.
+	Push and Pop cost O(log(number of priorities)) instead of moving the whole queue,
+	and IsEmpty/Size are read without taking the lock.
+	With the maximum wait time set, PopBatch takes the oldest job of the lower band first
+	once it has waited longer than the maximum, so the low priority jobs cannot starve.
 	*/
-	class EP_LIBRARY JobScheduleQueue :public ThreadSafePQueue<BaseJob*, BaseJob>
+	class EP_LIBRARY JobScheduleQueue
 	{
 	public:
 		/*!
@@ -60,12 +72,10 @@ namespace epl
 		/*!
 		Default Copy Constructor
 
-		Initializes the Semaphore
+		Initializes the schedule queue
 		@param[in] b the second object
 		*/
-		JobScheduleQueue(const JobScheduleQueue& b):ThreadSafePQueue<BaseJob*, BaseJob>(b)
-		{
-		}
+		JobScheduleQueue(const JobScheduleQueue& b);
 		/*!
 		Default Destructor
 
@@ -78,26 +88,129 @@ namespace epl
 		@param[in] b the second object
 		@return the new copied object
 		*/
-		JobScheduleQueue & operator=(const JobScheduleQueue&b)
-		{
-			if(this!=&b)
-			{
-				ThreadSafePQueue::operator =((const ThreadSafePQueue<BaseJob*, BaseJob>&)b);
-			}
-			return *this;
-		}
+		JobScheduleQueue & operator=(const JobScheduleQueue&b);
+
+		/*!
+		Check if the queue is empty.
+		@returns Returns true if the queue is empty, otherwise false.
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		Check if the given obj exists in the queue.
+		@returns Returns true if exists, otherwise false.
+		*/
+		bool IsExist(BaseJob* const &data) const;
+
+		/*!
+		Return the size of the queue.
+		@return the size of the queue.
+		*/
+		size_t Size() const;
+
+		/*!
+		Return the job with the highest priority within the queue.
+		@return the first element of the queue.
+		*/
+		BaseJob* &Front();
+
 		/*!
 		Insert the new item into the schedule queue.
 		@param[in] data The inserting data.'
 		@param[in] status the status to set for the data
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark the job dropped by the overflow policy is reported as JOB_STATUS_INCOMPLETE.
+		@remark the status is reported under the queue lock before the job becomes visible to the consumers.
+		*/
+		virtual bool Push(BaseJob* const &data,const BaseJob::JobStatus status=BaseJob::JOB_STATUS_IN_QUEUE);
+
+		/*!
+		Insert the new item into the schedule queue, handing over the reference held by the given pointer.
+		@param[in] data The inserting data, which becomes NULL if taken.
+		@param[in] status the status to set for the data
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark the reference is moved into the queue without touching the reference count.
+		@remark the job rejected stays in the given pointer.
+		*/
+		bool Push(SmartPtr<BaseJob> &data,const BaseJob::JobStatus status=BaseJob::JOB_STATUS_IN_QUEUE);
+
+		/*!
+		Insert the given items into the schedule queue with a single lock acquisition.
+		@param[in] data The array of inserting data.
+		@param[in] count The number of items in the array.
+		@param[in] status the status to set for the data
+		@return the number of items taken from the front of the array.
+		@remark when bounded, the overflow policy is applied with a lock acquisition per item,
+		        and the items from the first rejected one are not taken.
 		*/
-		virtual void Push(BaseJob* const &data,const BaseJob::JobStatus status=BaseJob::JOB_STATUS_IN_QUEUE);
+		virtual size_t PushBatch(BaseJob* const *data, size_t count,const BaseJob::JobStatus status=BaseJob::JOB_STATUS_IN_QUEUE);
 
 		/*!
 		Remove the first item from the queue.
 		*/
 		virtual void Pop();
 
+		/*!
+		Remove up to given number of items from the front of the schedule queue with a single lock acquisition.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@return the number of items removed.
+		@remark Unlike Pop, the reference held by the queue is handed to the caller,
+		        so the caller must call ReleaseObj for each returned item.
+		*/
+		size_t PopBatch(BaseJob** retData, size_t maxCount);
+
+		/*!
+		Set the maximum wait time before the job is taken regardless of its priority.
+		@param[in] maxWaitInMilliSec the maximum wait time in milliseconds. (WAITTIME_INIFINITE for strict priority)
+		@remark only PopBatch applies the aging, so Front and Pop stay consistent with each other.
+		@remark the aging check costs O(number of priorities) per job taken.
+		*/
+		void SetMaxWaitTime(unsigned int maxWaitInMilliSec);
+
+		/*!
+		Return the maximum wait time before the job is taken regardless of its priority.
+		@return the maximum wait time in milliseconds, or WAITTIME_INIFINITE for strict priority.
+		*/
+		unsigned int GetMaxWaitTime() const;
+
+		/*!
+		Set the capacity of the schedule queue and the policy when the queue is full.
+		@param[in] capacity the maximum number of jobs in the queue. (0 for unbounded)
+		@param[in] policy the overflow policy when the queue is full.
+		@remark OVERFLOW_POLICY_DROP_OLDEST drops the oldest job of the lowest priority.
+		*/
+		void SetCapacity(size_t capacity, OverflowPolicy policy=OVERFLOW_POLICY_BLOCK);
+
+		/*!
+		Return the capacity of the schedule queue.
+		@return the maximum number of jobs in the queue, or 0 if unbounded.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Return the policy when the schedule queue is full.
+		@return the overflow policy.
+		*/
+		OverflowPolicy GetOverflowPolicy() const;
+
+		/*!
+		Return the highest number of jobs the schedule queue held since the last reset.
+		@return the high-water mark.
+		*/
+		size_t GetHighWaterMark() const;
+
+		/*!
+		Reset the high-water mark to 0.
+		*/
+		void ResetHighWaterMark();
+
+		/*!
+		Return the number of jobs dropped or rejected by the overflow policy.
+		@return the number of jobs dropped or rejected.
+		*/
+		size_t GetDropCount() const;
+
 		/*!
 		Erase the element with given schedule policy holder
 		@param[in] object the schedule policy holder to erase
@@ -110,6 +223,92 @@ namespace epl
 		@param[in] status the status to give to all element in the queue
 		*/
 		void ReportAllJob(const BaseJob::JobStatus status);
+
+		/*!
+		Return the copy of the queue in the order of the priority.
+		@return the copy of the queue.
+		*/
+		std::vector<BaseJob*> GetQueue() const;
+
+	private:
+		/// Priority Band Type
+		typedef std::deque<BaseJob*> JobBand;
+		/// Priority Band Map Type (highest priority first)
+		typedef std::map<Priority, JobBand, std::greater<Priority> > JobBandMap;
+
+		/*!
+		Copy the bands from the given queue, and retain the copied jobs.
+		@param[in] b the queue to copy from.
+		*/
+		void copyFrom(const JobScheduleQueue &b);
+
+		/*!
+		Release all jobs in the queue.
+		*/
+		void releaseAll();
+
+		/*!
+		Insert the new item, whose reference is already taken for the queue, into the schedule queue.
+		@param[in] data The inserting data.
+		@param[in] status the status to set for the data
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark the reference of the job rejected is left to the caller.
+		*/
+		bool pushRetained(BaseJob *data, BaseJob::JobStatus status);
+
+		/*!
+		Erase the given job from the given band without locking.
+		@param[in] band the band to erase from.
+		@param[in] object the job to erase.
+		@return true if successful, otherwise false.
+		*/
+		bool eraseFromBand(JobBand &band, BaseJob * const object);
+
+		/*!
+		Return the first non-empty band without locking.
+		@return the first non-empty band, or NULL if the queue is empty.
+		*/
+		JobBand *frontBand();
+
+		/*!
+		Return the band to take the next job from, applying the aging, without locking.
+		@param[in] curTime the current time from WorkerMetrics::GetCurrentMicroSec.
+		@return the band to take from, or NULL if the queue is empty.
+		*/
+		JobBand *nextBand(__int64 curTime);
+
+		/*!
+		Apply the overflow policy before inserting the new job, the queue lock must be held.
+		@param[out] retDroppedJob the job dropped to make the room, or unchanged if none.
+		@return the admission result other than QueueBound::ADMISSION_WAIT.
+		@remark with OVERFLOW_POLICY_BLOCK, the queue lock is released while sleeping.
+		*/
+		QueueBound::Admission admit(BaseJob *&retDroppedJob);
+
+		/*!
+		Remove the oldest job of the lowest priority without locking.
+		@return the job removed, or NULL if the queue is empty.
+		*/
+		BaseJob *dropLowest();
+
+		/*!
+		Report the given job dropped by the overflow policy, and release it.
+		@param[in] job the job dropped.
+		*/
+		static void reportDropped(BaseJob *job);
+
+		/// the bands
+		JobBandMap m_bandMap;
+		/// the number of jobs in the queue
+		volatile long m_jobCount;
+		/// the maximum wait time in milliseconds
+		volatile unsigned int m_maxWaitTime;
+		/// the capacity bound
+		QueueBound m_bound;
+		/// lock
+		BaseLock *m_queueLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
 	};
 }
 #endif //__EP_JOB_SCHEDULE_QUEUE_H__
\ No newline at end of file
@@ -41,6 +41,9 @@ An Interface for K-ary Heap Template class.
 #include "epDynamicArray.h"
 #include "epException.h"
 #include <stack>
+#include <map>
+#include <vector>
+#include <algorithm>
 using namespace std;
 
 namespace epl
@@ -50,12 +53,21 @@ namespace epl
 		/// K-ary Heap Mode using Recursive operation
 		KARY_HEAP_MODE_RECURSIVE,
 		/// K-ary Heap Mode using Loop operation
-		KARY_HEAP_MODE_LOOP
+		KARY_HEAP_MODE_LOOP,
+		/// K-ary Heap Mode using the index from key to the node position
+		KARY_HEAP_MODE_INDEXED
 	}KaryHeapMode;
 
 	/*! 
 	@class KAryHeap epKAryHeap.h
 	@brief A K-ary Heap Template class.
+
+	In KARY_HEAP_MODE_INDEXED mode, the heap keeps the index from key to the node position,
+	so the key lookup of ChangeKey, ChangeData, Erase and GetData does not walk the heap.
+
+	The keys and the data are kept in separate contiguous arrays,
+	so the heapify compares the keys of the siblings without chasing the pointers.
+	The reference to the data returned is valid only until the heap is modified.
 	*/
 	template <typename KeyType,typename DataType, size_t k=5, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)=CompClass<KeyType>::CompFunc >
 	class KAryHeap
@@ -69,6 +81,19 @@ namespace epl
 		@param[in] lockPolicyType The lock policy
 		*/
 		KAryHeap(KaryHeapMode mode=KARY_HEAP_MODE_LOOP,LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Constructor
+
+		Initializes the K-ary Heap with given keys and data
+		@param[in] keyList the list of keys.
+		@param[in] dataList the list of data for each key.
+		@param[in] count the number of keys.
+		@param[in] mode the flag for recursive or loop mode
+		@param[in] lockPolicyType The lock policy
+		@remark the heap is built bottom-up in O(n).
+		*/
+		KAryHeap(const KeyType *keyList, const DataType *dataList, size_t count, KaryHeapMode mode=KARY_HEAP_MODE_LOOP,LockPolicy lockPolicyType=EP_LOCK_POLICY);
 		
 		/*!
 		Default Copy Constructor
@@ -123,6 +148,48 @@ namespace epl
 		*/
 		DataType &Push(const KeyType &key, const DataType &data);
 
+		/*!
+		Replace the heap with given keys and data
+		@param[in] keyList the list of keys.
+		@param[in] dataList the list of data for each key.
+		@param[in] count the number of keys.
+		@remark the heap is built bottom-up in O(n).
+		@remark the keys must be unique.
+		*/
+		void Assign(const KeyType *keyList, const DataType *dataList, size_t count);
+
+		/*!
+		Insert the given keys and data to the heap
+		@param[in] keyList the list of keys.
+		@param[in] dataList the list of data for each key.
+		@param[in] count the number of keys.
+		@remark the heap is rebuilt bottom-up if the number of keys is large compared to the heap.
+		@remark the keys must be unique and not exist in the heap.
+		*/
+		void PushRange(const KeyType *keyList, const DataType *dataList, size_t count);
+
+		/*!
+		Insert the key with given data to the heap, keeping at most the given number of nodes
+		@param[in] key The key value to insert.
+		@param[in] data the data with the given key
+		@param[in] maxSize the maximum number of nodes to keep.
+		@return true if the key is kept in the heap, otherwise false.
+		@remark when the heap is full, the key replaces the minimum only if greater than the minimum,
+		so pushing n keys keeps the maxSize largest keys in O(n*log(maxSize)).
+		@remark unlike Push, the heap is not searched for the key, so the keys need not be unique 
+		except in KARY_HEAP_MODE_INDEXED mode.
+		*/
+		bool PushBounded(const KeyType &key, const DataType &data, size_t maxSize);
+
+		/*!
+		Remove the given number of minimums of heap in order
+		@param[out] retKeyList the buffer to receive the keys.
+		@param[out] retDataList the buffer to receive the data. (can be NULL)
+		@param[in] count the maximum number of keys to remove.
+		@return the number of keys removed.
+		*/
+		size_t PopN(KeyType *retKeyList, DataType *retDataList, size_t count);
+
 		/*!
 		Return the minimum of heap
 		@param[out] retKey The minimum key value of the heap.
@@ -176,6 +243,7 @@ namespace epl
 		@param[in] key The original key.
 		@param[in] newKey the new key for the given original key
 		@return true if succeeded otherwise false
+		@remark in KARY_HEAP_MODE_INDEXED mode, fails if the new key already exists.
 		*/
 		bool ChangeKey(const KeyType &key, const KeyType &newKey);
 
@@ -219,8 +287,9 @@ namespace epl
 		Actually insert the key with given data to the heap
 		@param[in] key The key value to insert.
 		@param[in] data the data with the given key
+		@return the index of the node inserted
 		*/
-		void push(const KeyType &key, const DataType &data);
+		int push(const KeyType &key, const DataType &data);
 
 		/*!
 		Actually change the key of the node with given index with new key.
@@ -245,8 +314,9 @@ namespace epl
 		/*!
 		Heapify up the node with given index
 		@param[in] idx The index for the node to heapify up.
+		@return the index of the node after heapified
 		*/
-		void heapifyUp(int idx);
+		int heapifyUp(int idx);
 
 		/*!
 		Heapify down the node with given index
@@ -254,6 +324,26 @@ namespace epl
 		*/
 		void heapifyDown(int idx);
 
+		/*!
+		Swap the nodes with given indices
+		@param[in] idxA The index of the first node.
+		@param[in] idxB The index of the second node.
+		@remark updates the key index in KARY_HEAP_MODE_INDEXED mode.
+		*/
+		void swapNode(int idxA, int idxB);
+
+		/*!
+		Rebuild the key index from the nodes of the heap.
+		@remark does nothing if not in KARY_HEAP_MODE_INDEXED mode.
+		*/
+		void rebuildIndex();
+
+		/*!
+		Rebuild the heap order of all nodes bottom-up.
+		@remark rebuilds the key index as well.
+		*/
+		void buildHeap();
+
 		/*!
 		Return the minimum child of the given node index
 		@param[in] parentIdx The index for the node to find minimum child.
@@ -289,8 +379,24 @@ namespace epl
 		*/
 		int findIndexLoop(const KeyType &key, int rootIdx) const;
 
-		///  K-ary heap
-		DynamicArray<Pair<KeyType,DataType> *> m_heap;
+		/*!
+		@struct KeyLess epKAryHeap.h
+		@brief Key ordering of the key index by KeyCompareFunc
+		*/
+		struct KeyLess
+		{
+			bool operator()(const KeyType &a, const KeyType &b) const
+			{
+				return KeyCompareFunc(&a,&b)==COMP_RESULT_LESSTHAN;
+			}
+		};
+		/// Key Index Type
+		typedef std::map<KeyType,int,KeyLess> KeyIndexMap;
+
+		/// the keys of the nodes in heap order
+		std::vector<KeyType> m_keys;
+		/// the data of the nodes in heap order
+		std::vector<DataType> m_data;
 		/// the actual heap size
 		size_t m_heapSize;
 		/// lock
@@ -299,6 +405,10 @@ namespace epl
 		LockPolicy m_lockPolicy;
 		/// K-ary Heap Mode
 		KaryHeapMode m_mode;
+		/// the node position of each key (KARY_HEAP_MODE_INDEXED only)
+		KeyIndexMap m_keyIndex;
+		/// the key index entry of each node (KARY_HEAP_MODE_INDEXED only)
+		std::vector<typename KeyIndexMap::iterator> m_nodeIndex;
 
 	};
 
@@ -307,7 +417,6 @@ namespace epl
 	{
 		EP_ASSERT_EXPR(k>0,_T("Template Declaration Error: k cannnot be less than/equal to 0"));
 
-		m_heap=DynamicArray<Pair<KeyType,DataType> *>(lockPolicyType);
 		m_heapSize=0;
 		m_lockPolicy=lockPolicyType;
 		m_mode=mode;
@@ -322,12 +431,52 @@ namespace epl
 		case LOCK_POLICY_NONE:
 			m_heapLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_heapLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_heapLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_heapLock=NULL;
 		}
 
 	}
 
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
+	KAryHeap<KeyType,DataType,k,KeyCompareFunc>::KAryHeap(const KeyType *keyList, const DataType *dataList, size_t count, KaryHeapMode mode,LockPolicy lockPolicyType)
+	{
+		EP_ASSERT_EXPR(k>0,_T("Template Declaration Error: k cannnot be less than/equal to 0"));
+
+		m_heapSize=0;
+		m_lockPolicy=lockPolicyType;
+		m_mode=mode;
+		switch(lockPolicyType)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			m_heapLock=EP_NEW CriticalSectionEx();
+			break;
+		case LOCK_POLICY_MUTEX:
+			m_heapLock=EP_NEW Mutex();
+			break;
+		case LOCK_POLICY_NONE:
+			m_heapLock=EP_NEW NoLock();
+			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_heapLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_heapLock=EP_NEW ReaderWriterLock();
+			break;
+		default:
+			m_heapLock=NULL;
+		}
+		m_keys.assign(keyList,keyList+count);
+		m_data.assign(dataList,dataList+count);
+		m_heapSize=count;
+		buildHeap();
+	}
+
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
 	KAryHeap<KeyType,DataType,k,KeyCompareFunc>::KAryHeap(const KAryHeap<KeyType,DataType,k,KeyCompareFunc> & b)
 	{
@@ -344,21 +493,22 @@ namespace epl
 		case LOCK_POLICY_NONE:
 			m_heapLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_heapLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_heapLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_heapLock=NULL;
 			break;
 		}
 		LockObj lock(b.m_heapLock);
 		m_mode=b.m_mode;
-		m_heap.Resize(b.m_heap.Size());
-		for(int trav=0;trav<b.m_heap.Size();trav++)
-		{
-			m_heap[trav]=EP_NEW Pair<KeyType,DataType>();
-			m_heap[trav]->first=b.m_heap[trav]->first;
-			m_heap[trav]->second=b.m_heap[trav]->second;
-
-		}
+		m_keys=b.m_keys;
+		m_data=b.m_data;
 		m_heapSize=b.m_heapSize;
+		rebuildIndex();
 	
 
 	}
@@ -366,15 +516,6 @@ namespace epl
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
 	KAryHeap<KeyType,DataType,k,KeyCompareFunc>::~KAryHeap()
 	{
-		m_heapLock->Lock();
-		for(int trav=0;trav<m_heapSize;trav++)
-		{
-			if(m_heap[trav])	
-				EP_DELETE m_heap[trav];
-
-		}
-		m_heap.Delete();
-		m_heapLock->Unlock();
 		if(m_heapLock)
 			EP_DELETE m_heapLock;
 	}
@@ -385,15 +526,6 @@ namespace epl
 	{
 		if(this!=&b)
 		{
-			m_heapLock->Lock();
-			for(int trav=0;trav<m_heapSize;trav++)
-			{
-				if(m_heap[trav])	
-					EP_DELETE m_heap[trav];
-
-			}
-			m_heap.Delete();
-			m_heapLock->Unlock();
 			if(m_heapLock)
 				EP_DELETE m_heapLock;
 			m_heapLock=NULL;
@@ -411,21 +543,22 @@ namespace epl
 			case LOCK_POLICY_NONE:
 				m_heapLock=EP_NEW NoLock();
 				break;
+			case LOCK_POLICY_SPIN_PARK:
+				m_heapLock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				m_heapLock=EP_NEW ReaderWriterLock();
+				break;
 			default:
 				m_heapLock=NULL;
 				break;
 			}
 			LockObj lock(b.m_heapLock);
 			m_mode=b.m_mode;
-			m_heap.Resize(b.m_heap.Size());
-			for(int trav=0;trav<b.m_heap.Size();trav++)
-			{
-				m_heap[trav]=EP_NEW Pair<KeyType,DataType>();
-				m_heap[trav]->first=b.m_heap[trav]->first;
-				m_heap[trav]->second=b.m_heap[trav]->second;
-
-			}
+			m_keys=b.m_keys;
+			m_data=b.m_data;
 			m_heapSize=b.m_heapSize;
+			rebuildIndex();
 		}
 		return *this;
 	}
@@ -436,11 +569,9 @@ namespace epl
 		LockObj lock(m_heapLock);
 		int idx=findIndex(key, 0);
 		if(idx>=0)
-			return m_heap[idx]->second;
-		push(key,reinterpret_cast<DataType>(0));
-		idx=findIndex(key,0);
-		EP_ASSERT(idx>=0);
-		return m_heap[idx]->second;
+			return m_data[idx];
+		idx=push(key,reinterpret_cast<DataType>(0));
+		return m_data[idx];
 		
 	}
 
@@ -450,7 +581,7 @@ namespace epl
 		LockObj lock(m_heapLock);
 		int idx=findIndex(key, 0);
 		EP_ASSERT(idx>=0);
-		return m_heap[idx]->second;
+		return m_data[idx];
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
@@ -459,7 +590,7 @@ namespace epl
 		LockObj lock(m_heapLock);
 		int idx=findIndex(key, 0);
 		EP_ASSERT_EXPR(idx>=0,_T("The given key does not exist in the heap"));
-		return m_heap[idx]->second;
+		return m_data[idx];
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
@@ -468,7 +599,7 @@ namespace epl
 		LockObj lock(m_heapLock);
 		int idx=findIndex(key, 0);
 		EP_ASSERT_EXPR(idx>=0,_T("The given key does not exist in the heap"));
-		return m_heap[idx]->second;
+		return m_data[idx];
 	}
 	
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
@@ -478,7 +609,7 @@ namespace epl
 		int idx=findIndex(key, 0);
 		if(idx>=0)
 		{
-			retData=m_heap[idx]->second;
+			retData=m_data[idx];
 			return true;
 		}
 		return false;
@@ -505,8 +636,8 @@ namespace epl
 		LockObj lock(m_heapLock);
 		if(m_heapSize>0)
 		{
-			retKey=m_heap[0]->first;
-			retData=m_heap[0]->second;
+			retKey=m_keys[0];
+			retData=m_data[0];
 			return true;
 		}
 		return false;
@@ -518,7 +649,7 @@ namespace epl
 	{
 		LockObj lock(m_heapLock);
 		EP_ASSERT_EXPR(m_heapSize>0,_T("The heap is empty."));
-		return Pair(m_heap[0]->first,m_heap[0]->second);
+		return Pair<KeyType,DataType>(m_keys[0],m_data[0]);
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
@@ -528,6 +659,8 @@ namespace epl
 		int idx=findIndex(key, 0);
 		if(idx>=0)
 		{
+			if(m_mode==KARY_HEAP_MODE_INDEXED && KeyCompareFunc(&key,&newKey)!=COMP_RESULT_EQUAL && m_keyIndex.find(newKey)!=m_keyIndex.end())
+				return false;
 			changeKey(idx,newKey);
 			return true;
 		}
@@ -551,13 +684,12 @@ namespace epl
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
 	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::Clear()
 	{
-		for(int trav=0;trav<m_heapSize;trav++)
-		{
-			if(m_heap[trav])	
-				EP_DELETE m_heap[trav];
-			m_heap[trav]=NULL;
-		}
+		LockObj lock(m_heapLock);
+		m_keys.clear();
+		m_data.clear();
 		m_heapSize=0;
+		m_keyIndex.clear();
+		m_nodeIndex.clear();
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
@@ -567,7 +699,8 @@ namespace epl
 		int idx=findIndex(key,0);
 		if(idx>=0)
 		{
-			erase(key);
+			erase(idx);
+			return true;
 		}
 		return false;
 	}
@@ -593,11 +726,82 @@ namespace epl
 	DataType &KAryHeap<KeyType,DataType,k,KeyCompareFunc>::Push(const KeyType &key, const DataType &data)
 	{	
 		LockObj lock(m_heapLock);
-		int index=findIndex(key,0);
-		EP_ASSERT_EXPR(index==-1,_T("Given key already exists in the K-ary heap. Duplicated insertion is not allowed."));
-		push(key,data);
-		index=findIndex(key,0);
-		return m_heap[index]->second;
+		// the linear search for the duplicate is compiled out of the release build with the assertion.
+		EP_ASSERT_EXPR(findIndex(key,0)==-1,_T("Given key already exists in the K-ary heap. Duplicated insertion is not allowed."));
+		int index=push(key,data);
+		return m_data[index];
+	}
+
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
+	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::Assign(const KeyType *keyList, const DataType *dataList, size_t count)
+	{
+		LockObj lock(m_heapLock);
+		m_keys.assign(keyList,keyList+count);
+		m_data.assign(dataList,dataList+count);
+		m_heapSize=count;
+		buildHeap();
+	}
+
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
+	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::PushRange(const KeyType *keyList, const DataType *dataList, size_t count)
+	{
+		LockObj lock(m_heapLock);
+		// pushing one by one costs O(count*log(n)), and rebuilding costs O(n+count).
+		if(count<m_heapSize)
+		{
+			m_keys.reserve(m_heapSize+count);
+			m_data.reserve(m_heapSize+count);
+			for(size_t trav=0;trav<count;trav++)
+			{
+				push(keyList[trav],dataList[trav]);
+			}
+		}
+		else
+		{
+			m_keys.insert(m_keys.end(),keyList,keyList+count);
+			m_data.insert(m_data.end(),dataList,dataList+count);
+			m_heapSize+=count;
+			buildHeap();
+		}
+	}
+
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
+	bool KAryHeap<KeyType,DataType,k,KeyCompareFunc>::PushBounded(const KeyType &key, const DataType &data, size_t maxSize)
+	{
+		LockObj lock(m_heapLock);
+		while(m_heapSize>maxSize)
+			erase(0);
+		if(maxSize==0)
+			return false;
+		if(m_heapSize>=maxSize && KeyCompareFunc(&key,&(m_keys[0]))!=COMP_RESULT_GREATERTHAN)
+			return false;
+		EP_ASSERT_EXPR(m_mode!=KARY_HEAP_MODE_INDEXED || m_keyIndex.find(key)==m_keyIndex.end(),_T("Given key already exists in the K-ary heap. Duplicated insertion is not allowed."));
+		if(m_heapSize<maxSize)
+		{
+			push(key,data);
+		}
+		else
+		{
+			// the new key is greater than the minimum, so it only sifts down from the root.
+			m_data[0]=data;
+			changeKey(0,key);
+		}
+		return true;
+	}
+
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>  
+	size_t KAryHeap<KeyType,DataType,k,KeyCompareFunc>::PopN(KeyType *retKeyList, DataType *retDataList, size_t count)
+	{
+		LockObj lock(m_heapLock);
+		size_t trav;
+		for(trav=0;trav<count && m_heapSize>0;trav++)
+		{
+			retKeyList[trav]=m_keys[0];
+			if(retDataList)
+				retDataList[trav]=m_data[0];
+			erase(0);
+		}
+		return trav;
 	}
 
 
@@ -605,34 +809,25 @@ namespace epl
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
 	bool KAryHeap<KeyType,DataType,k,KeyCompareFunc>::pop( Pair<KeyType,DataType> &retMin )
 	{
-		if(m_heap.Size()> 0 && m_heapSize >0)
+		if(m_heapSize >0)
 		{
-			retMin.first=m_heap[0]->first;
-			retMin.second=m_heap[0]->second;
-			EP_DELETE m_heap[0];
-			m_heap[0]= m_heap[m_heapSize-1];
-			m_heap[m_heapSize-1]=NULL;
-			m_heapSize--;
-			heapifyDown(0);
+			retMin.first=m_keys[0];
+			retMin.second=m_data[0];
+			erase(0);
 			return true;
 		}
 		return false;
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
-	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::push(const KeyType &key, const DataType &data)
+	int KAryHeap<KeyType,DataType,k,KeyCompareFunc>::push(const KeyType &key, const DataType &data)
 	{
-	
-		if(m_heapSize+1>m_heap.Size())
-		{
-			long newSize=m_heap.Size()+m_heap.Size()/2;
-			newSize=(m_heap.Size()==newSize)?m_heap.Size()+1:newSize;
-			m_heap.Resize(newSize);
-		}
-		m_heap[m_heapSize]=EP_NEW Pair<KeyType,DataType>(key,data);
+		m_keys.push_back(key);
+		m_data.push_back(data);
+		if(m_mode==KARY_HEAP_MODE_INDEXED)
+			m_nodeIndex.push_back(m_keyIndex.insert(typename KeyIndexMap::value_type(key,static_cast<int>(m_heapSize))).first);
 		m_heapSize++;
-		heapifyUp(m_heapSize-1);
-
+		return heapifyUp(m_heapSize-1);
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
@@ -641,14 +836,19 @@ namespace epl
 
 		if(index<m_heapSize)
 		{
-			if(KeyCompareFunc(&(m_heap[index]->first),&newKey)==COMP_RESULT_LESSTHAN)
+			if(m_mode==KARY_HEAP_MODE_INDEXED)
+			{
+				m_keyIndex.erase(m_nodeIndex[index]);
+				m_nodeIndex[index]=m_keyIndex.insert(typename KeyIndexMap::value_type(newKey,index)).first;
+			}
+			if(KeyCompareFunc(&(m_keys[index]),&newKey)==COMP_RESULT_LESSTHAN)
 			{	
-				m_heap[index]->first=newKey;
+				m_keys[index]=newKey;
 				heapifyDown(index);
 			}
 			else
 			{
-				m_heap[index]->first=newKey;
+				m_keys[index]=newKey;
 				heapifyUp(index);
 			}
 		}
@@ -660,7 +860,7 @@ namespace epl
 
 		if(index<m_heapSize)
 		{
-			m_heap[index]->second=data;
+			m_data[index]=newData;
 		}
 	}
 
@@ -670,33 +870,39 @@ namespace epl
 
 		if(index<m_heapSize)
 		{
-			Pair<KeyType,DataType> * tmp=m_heap[m_heapSize-1];
-			m_heap[m_heapSize-1]=m_heap[index];
-			m_heap[index]=tmp;
-			EP_DELETE m_heap[m_heapSize-1];
-			m_heap[m_heapSize-1]=NULL;
+			int lastIdx=static_cast<int>(m_heapSize)-1;
+			swapNode(index,lastIdx);
+			if(m_mode==KARY_HEAP_MODE_INDEXED)
+			{
+				m_keyIndex.erase(m_nodeIndex[lastIdx]);
+				m_nodeIndex.pop_back();
+			}
+			m_keys.pop_back();
+			m_data.pop_back();
 			m_heapSize--;
-			heapifyDown(index);
+			if(index<lastIdx)
+			{
+				// the node moved from the end can be smaller than the parent of the erased node
+				heapifyDown(index);
+				heapifyUp(index);
+			}
 		}
 	}
 
 
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
-	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::heapifyUp(int idx)
+	int KAryHeap<KeyType,DataType,k,KeyCompareFunc>::heapifyUp(int idx)
 	{
-		if(m_heap.Size()>0)
+		int currentIdx=idx;//size-1;
+		if(m_heapSize>0)
 		{
-			int currentIdx=idx;//size-1;
 			int parentIdx=getParentIdx(currentIdx);
-			Pair<KeyType,DataType> *tmp;
 			while(parentIdx!=-1)
 			{
-				if(KeyCompareFunc(&(m_heap[parentIdx]->first) ,&(m_heap[currentIdx]->first))==COMP_RESULT_GREATERTHAN)
+				if(KeyCompareFunc(&(m_keys[parentIdx]) ,&(m_keys[currentIdx]))==COMP_RESULT_GREATERTHAN)
 				{
-					tmp = m_heap[currentIdx];
-					m_heap[currentIdx]=m_heap[parentIdx];
-					m_heap[parentIdx]=tmp;
+					swapNode(currentIdx,parentIdx);
 					currentIdx=parentIdx;
 					parentIdx=getParentIdx(currentIdx);
 				}
@@ -706,24 +912,22 @@ namespace epl
 				}
 			}
 		}
+		return currentIdx;
 	}
 
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
 	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::heapifyDown(int idx)
 	{
-		if(m_heap.Size()>0)
+		if(m_heapSize>0)
 		{
 			
 			int parentIdx=idx;//0;
 			int minChildIdx=findMinChild(parentIdx);
-			Pair<KeyType,DataType> *tmp;
 			while(minChildIdx!=-1)
 			{
-				if(KeyCompareFunc(&(m_heap[parentIdx]->first ), &(m_heap[minChildIdx]->first))!=COMP_RESULT_LESSTHAN)
+				if(KeyCompareFunc(&(m_keys[parentIdx] ), &(m_keys[minChildIdx]))!=COMP_RESULT_LESSTHAN)
 				{
-					tmp = m_heap[parentIdx];
-					m_heap[parentIdx]=m_heap[minChildIdx];
-					m_heap[minChildIdx]=tmp;
+					swapNode(parentIdx,minChildIdx);
 					parentIdx= minChildIdx;
 					minChildIdx=findMinChild(parentIdx);
 				}
@@ -735,19 +939,68 @@ namespace epl
 		}
 	}
 
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
+	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::swapNode(int idxA, int idxB)
+	{
+		if(idxA==idxB)
+			return;
+		std::swap(m_keys[idxA],m_keys[idxB]);
+		std::swap(m_data[idxA],m_data[idxB]);
+		if(m_mode==KARY_HEAP_MODE_INDEXED)
+		{
+			typename KeyIndexMap::iterator tmpIter=m_nodeIndex[idxA];
+			m_nodeIndex[idxA]=m_nodeIndex[idxB];
+			m_nodeIndex[idxB]=tmpIter;
+			m_nodeIndex[idxA]->second=idxA;
+			m_nodeIndex[idxB]->second=idxB;
+		}
+	}
+
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
+	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::rebuildIndex()
+	{
+		m_keyIndex.clear();
+		m_nodeIndex.clear();
+		if(m_mode!=KARY_HEAP_MODE_INDEXED)
+			return;
+		m_nodeIndex.reserve(m_heapSize);
+		for(int trav=0;trav<m_heapSize;trav++)
+		{
+			m_nodeIndex.push_back(m_keyIndex.insert(typename KeyIndexMap::value_type(m_keys[trav],trav)).first);
+		}
+	}
+
+	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
+	void KAryHeap<KeyType,DataType,k,KeyCompareFunc>::buildHeap()
+	{
+		rebuildIndex();
+		EP_ASSERT_EXPR(m_mode!=KARY_HEAP_MODE_INDEXED || m_keyIndex.size()==m_heapSize,_T("Duplicated key is not allowed in the K-ary heap."));
+		if(m_heapSize<=1)
+			return;
+		// heapify down from the last parent to the root
+		for(int trav=getParentIdx(static_cast<int>(m_heapSize)-1);trav>=0;trav--)
+		{
+			heapifyDown(trav);
+		}
+	}
+
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
 	int KAryHeap<KeyType,DataType,k,KeyCompareFunc>::findMinChild(int parentIdx) const
 	{
 		int arrTrav;
-		if(k*parentIdx+1<m_heapSize)
+		int firstChildIdx=k*parentIdx+1;
+		if(firstChildIdx<m_heapSize)
 		{
-			Pair<KeyType,DataType> *minNode=m_heap[k*parentIdx+1];
-			int minIdx=k*parentIdx+1;
-			for(arrTrav=k*parentIdx+2; arrTrav<=k*parentIdx+k;arrTrav++)
+			// the children are adjacent, so scan their keys in place.
+			int lastChildIdx=firstChildIdx+k;
+			if(lastChildIdx>m_heapSize)
+				lastChildIdx=static_cast<int>(m_heapSize);
+			const KeyType *keys=&m_keys[0];
+			int minIdx=firstChildIdx;
+			for(arrTrav=firstChildIdx+1; arrTrav<lastChildIdx;arrTrav++)
 			{
-				if(arrTrav<m_heapSize && KeyCompareFunc(&(minNode->first) , &(m_heap[arrTrav]->first))==COMP_RESULT_GREATERTHAN)
+				if(KeyCompareFunc(keys+minIdx , keys+arrTrav)==COMP_RESULT_GREATERTHAN)
 				{
-					minNode=m_heap[arrTrav];
 					minIdx=arrTrav;
 				}
 			}
@@ -785,16 +1038,16 @@ namespace epl
 			case 0:
 				if(currentSnaptshot.rootIdx<m_heapSize)
 				{
-					Pair<KeyType,DataType> *pair=m_heap[currentSnaptshot.rootIdx];
+					const KeyType &nodeKey=m_keys[currentSnaptshot.rootIdx];
 
 
-					if(KeyCompareFunc(&(pair->first), &(key))==COMP_RESULT_EQUAL)
+					if(KeyCompareFunc(&nodeKey, &(key))==COMP_RESULT_EQUAL)
 					{	
 						retValue=currentSnaptshot.rootIdx;
 						continue;
 					}
 
-					if(KeyCompareFunc(&(pair->first) ,&(key))!=COMP_RESULT_GREATERTHAN)
+					if(KeyCompareFunc(&nodeKey ,&(key))!=COMP_RESULT_GREATERTHAN)
 					{
 
 						trav=1;
@@ -849,19 +1102,26 @@ namespace epl
 	template <typename KeyType,typename DataType,size_t k, CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *) >  
 	int KAryHeap<KeyType,DataType,k,KeyCompareFunc>::findIndex(const KeyType &key, int rootIdx) const
 	{
-		if(m_mode==KARY_HEAP_MODE_RECURSIVE)
+		if(m_mode==KARY_HEAP_MODE_INDEXED)
+		{
+			typename KeyIndexMap::const_iterator iter=m_keyIndex.find(key);
+			if(iter!=m_keyIndex.end())
+				return iter->second;
+			return -1;
+		}
+		else if(m_mode==KARY_HEAP_MODE_RECURSIVE)
 		{
 			if(rootIdx<m_heapSize)
 			{
-				Pair<KeyType,DataType> *pair=m_heap[rootIdx];
+				const KeyType &nodeKey=m_keys[rootIdx];
 
 
-				if(KeyCompareFunc(&(pair->first), &(key))==COMP_RESULT_EQUAL)
+				if(KeyCompareFunc(&nodeKey, &(key))==COMP_RESULT_EQUAL)
 				{	
 					return rootIdx;
 				}
 
-				if(KeyCompareFunc(&(pair->first) ,&(key))!=COMP_RESULT_GREATERTHAN)
+				if(KeyCompareFunc(&nodeKey ,&(key))!=COMP_RESULT_GREATERTHAN)
 				{
 
 					int trav;
@@ -900,7 +1160,10 @@ namespace epl
 // 		{
 // 			return childIdx/k;
 // 		}
-		return (childIdx-1)/k;
+		// k is unsigned, so the root must not be divided into the huge parent index.
+		if(childIdx<=0)
+			return -1;
+		return (childIdx-1)/static_cast<int>(k);
 	}
 }
 #endif //__EP_KARYHEAP_H__
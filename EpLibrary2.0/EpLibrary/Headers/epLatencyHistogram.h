@@ -0,0 +1,147 @@
+/*! 
+@file epLatencyHistogram.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief LatencyHistogram Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Log-Linear Latency Histogram.
+
+*/
+#ifndef __EP_LATENCY_HISTOGRAM_H__
+#define __EP_LATENCY_HISTOGRAM_H__
+#include "epLib.h"
+
+/// the number of the bits of the sub-bucket index, which sets the precision of the histogram
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS 5
+
+/// the number of the sub-buckets, the values under which are counted exactly
+#define LATENCY_HISTOGRAM_SUB_BUCKET_COUNT (1<<LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+
+/// the number of the buckets to cover all non-negative 64-bit values
+#define LATENCY_HISTOGRAM_BUCKET_COUNT ((64-LATENCY_HISTOGRAM_SUB_BUCKET_BITS+1)*(LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2))
+
+namespace epl
+{
+	/*! 
+	@class LatencyHistogram epLatencyHistogram.h
+	@brief A log-linear (HDR-style) histogram of the latencies.
+
+	The values under LATENCY_HISTOGRAM_SUB_BUCKET_COUNT are counted exactly,
+	and each power of two range above is split into LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2 linear buckets,
+	so the percentiles are reported within 1/16 of the recorded value with the fixed memory.
+	The histogram is not thread-safe, and the histograms of each thread are merged with Add to report.
+	The unit of the values is up to the caller.
+	*/
+	class EP_LIBRARY LatencyHistogram
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty histogram
+		*/
+		LatencyHistogram();
+
+		/*!
+		Record the value.
+		@param[in] value the value to record. (the negative value is recorded as 0)
+		*/
+		void Record(__int64 value);
+
+		/*!
+		Record the value with the interlocked operations, so the threads can record to one histogram.
+		@param[in] value the value to record. (the negative value is recorded as 0)
+		@remark the other operations are still not thread-safe, and read the counts being recorded slightly behind.
+		*/
+		void RecordConcurrent(__int64 value);
+
+		/*!
+		Add the counts of the given histogram to this histogram.
+		@param[in] b the histogram to add.
+		*/
+		void Add(const LatencyHistogram &b);
+
+		/*!
+		Subtract the counts of the given histogram, which is an earlier copy of this histogram.
+		@param[in] b the earlier copy.
+		@remark the maximum value is kept, since it is not known which values came after the copy.
+		*/
+		void Subtract(const LatencyHistogram &b);
+
+		/*!
+		Remove all the values.
+		*/
+		void Clear();
+
+		/*!
+		Return the number of the values recorded.
+		@return the number of the values.
+		*/
+		__int64 GetTotalCount() const;
+
+		/*!
+		Return the maximum value recorded.
+		@return the maximum value, or 0 if empty.
+		*/
+		__int64 GetMaxValue() const;
+
+		/*!
+		Return the value at the given percentile.
+		@param[in] percentile the percentile between 0.0 and 100.0.
+		@return the highest value of the bucket where the percentile falls, but not above the maximum value, or 0 if empty.
+		*/
+		__int64 GetValueAtPercentile(double percentile) const;
+
+		/*!
+		Return the index of the bucket of the given value.
+		@param[in] value the non-negative value.
+		@return the index of the bucket.
+		*/
+		static unsigned int GetBucketIndex(__int64 value);
+
+		/*!
+		Return the highest value of the given bucket.
+		@param[in] bucketIdx the index of the bucket.
+		@return the highest value of the bucket.
+		*/
+		static __int64 GetBucketHighestValue(unsigned int bucketIdx);
+
+	private:
+		/// the counts of each bucket
+		__int64 m_counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+		/// the number of the values recorded
+		__int64 m_totalCount;
+		/// the maximum value recorded
+		__int64 m_maxValue;
+	};
+}
+
+#endif //__EP_LATENCY_HISTOGRAM_H__
\ No newline at end of file
@@ -71,6 +71,28 @@ An Interface for EpLibrary.
 
 #endif //_DEBUG
 
+/// Enables PROFILE_SCOPE in all builds including the release build<br/>
+/// Uncomment below line and recompile if you want to profile under the real load
+// #define EP_ENABLE_SAMPLING_PROFILE
+
+/// Enables LOG_ASYNC and LOG_ASYNC_MSG in all builds including the release build<br/>
+/// Uncomment below line and recompile if you want to log from the hot paths
+// #define EP_ENABLE_ASYNC_LOG
+
+/// The lowest level of LOG_TRACE to LOG_FATAL compiled in all builds<br/>
+/// Uncomment below line and recompile if you want to remove the lower levels from the binary
+// #define EP_LOG_COMPILE_LEVEL EP_LOG_LEVEL_INFO
+
+/// Reports the errors without throwing the C++ exceptions from the library<br/>
+/// Uncomment below line and recompile if you build with the exceptions turned off (/EHs-c- or -fno-exceptions),
+/// then the failed EP_VERIFY_* checks and the failed allocations abort, and the lookups return their defaults
+// #define EP_NO_EXCEPTIONS
+
+/// Pads the members written by many threads of the shared objects to their own cache lines<br/>
+/// Uncomment below line and recompile if the threads scale poorly from the false sharing,
+/// then SmartObject, BaseJob and ThreadSafeQueue grow by one or two cache lines each
+// #define EP_ENABLE_CACHE_LINE_PADDING
+
 #define WIDEN2(x) L ## x
 #define WIDEN(x) WIDEN2(x)
 #define __WFILE__ WIDEN(__FILE__)
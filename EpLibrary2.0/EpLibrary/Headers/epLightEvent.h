@@ -0,0 +1,163 @@
+/*! 
+@file epLightEvent.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Lightweight Event Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Lightweight Event Class.
+
+*/
+#ifndef __EP_LIGHT_EVENT_H__
+#define __EP_LIGHT_EVENT_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseLock.h"
+#include "epPlatformSync.h"
+
+namespace epl
+{
+
+	/*! 
+	@class LightEvent epLightEvent.h
+	@brief A class that handles the event functionality within the process, keeping the state in user space.
+
+	The state is kept with the interlocked operations, so SetEvent without the waiting thread,
+	and WaitForEvent on the raised event or with zero wait time, do not call into the kernel.
+	@remark Use EventEx instead, if the object will be used across process boundaries,
+	        or its handle is needed for WaitForMultipleObjects.
+	*/
+	class EP_LIBRARY LightEvent :public BaseLock
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock.
+		@param[in] isInitialRaised flag for the initial state
+		@param[in] isManualReset flag for the manual reset
+		*/
+		LightEvent(bool isInitialRaised=true,bool isManualReset=false);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the event with the initial state of given object.
+		@param[in] b the second object
+		*/
+		LightEvent(const LightEvent& b);
+
+		/*!
+		Default Destructor
+
+		Deletes the lock
+		*/
+		virtual ~LightEvent();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark no thread may be waiting on this event.
+		*/
+		LightEvent & operator=(const LightEvent&b);
+
+		/*!
+		Wait for the event to be raised.
+		@return true if locked, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Try to take the raised event.
+		If the event is not raised, it just returns false and continue, without calling into the kernel.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Wait for the event to be raised,
+		and if it is not raised in given time, it returns false, otherwise return true.
+		@param[in] dwMilliSecond the wait time.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Raise the event.
+		*/
+		virtual void Unlock();
+
+		/*!
+		Reset the event
+		@return true if succeeded, otherwise false
+		*/
+		bool ResetEvent();
+
+		/*!
+		Set the event
+		@return true if succeeded, otherwise false
+		@remark calls into the kernel only for the threads actually waiting.
+		*/
+		bool SetEvent();
+
+		/*!
+		Check if the event is manual reset event.
+		@return true if the event is manual reset event, otherwise false.
+		*/
+		bool IsManualReset() const;
+
+		/*!
+		Wait for the event
+		@param[in] dwMilliSecond the wait time.
+		@return true if the event is raised, otherwise false.
+		*/
+		bool WaitForEvent(const unsigned int dwMilliSecond=WAITTIME_INIFINITE);
+
+	private:
+		/*!
+		Try to take the raised event without waiting.
+		@return true if the event is raised, otherwise false.
+		*/
+		bool tryTake();
+
+		/// the semaphore of the platform for the waiting threads
+		PlatformSemaphore m_sem;
+		/// 1 if raised, otherwise the negative number of the waiting threads
+		volatile long m_state;
+		/// Flag for Initial State
+		bool m_isInitialRaised;
+		/// Flag for Manual Reset
+		bool m_isManualReset;
+	};
+
+}
+
+#endif //__EP_LIGHT_EVENT_H__
\ No newline at end of file
@@ -0,0 +1,163 @@
+/*! 
+@file epLightSemaphore.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Lightweight Semaphore Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Lightweight Semaphore Class.
+
+*/
+#ifndef __EP_LIGHT_SEMAPHORE_H__
+#define __EP_LIGHT_SEMAPHORE_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseLock.h"
+#include "epPlatformSync.h"
+
+/// the default number of spins before waiting on the kernel semaphore
+#define LIGHT_SEMAPHORE_DEFAULT_SPIN_COUNT 1000
+
+namespace epl
+{
+
+	/*! 
+	@class LightSemaphore epLightSemaphore.h
+	@brief A class that handles the semaphore functionality within the process, keeping the count in user space.
+
+	The count is kept with the interlocked operations, and the kernel semaphore is used only
+	when the thread actually has to block, or the blocked thread has to be woken up.
+	@remark Use Semaphore instead, if the object will be used across process boundaries.
+	@remark the count has no maximum, unlike Semaphore.
+	*/
+	class EP_LIBRARY LightSemaphore :public BaseLock
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock.
+		@param[in] initialCount The initial count for the semaphore.
+		@param[in] spinCount the number of spins before waiting on the kernel semaphore.
+		*/
+		LightSemaphore(long initialCount=1, unsigned int spinCount=LIGHT_SEMAPHORE_DEFAULT_SPIN_COUNT);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the Semaphore with the initial count of given object.
+		@param[in] b the second object
+		*/
+		LightSemaphore(const LightSemaphore& b);
+
+		/*!
+		Default Destructor
+
+		Deletes the lock
+		*/
+		virtual ~LightSemaphore();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark no thread may be waiting on this semaphore.
+		*/
+		LightSemaphore & operator=(const LightSemaphore&b);
+
+		/*!
+		Take a count of the semaphore, and wait if not available.
+		@return true if locked, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Try to take a count of the semaphore.
+		If the count is not available, it just returns false and continue, without calling into the kernel.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Take a count of the semaphore,
+		and if it fails to take in given time, it returns false, otherwise return true.
+		@param[in] dwMilliSecond the wait time.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Give back a count of the semaphore.
+		*/
+		virtual void Unlock();
+
+		/*!
+		Release the semaphore with given count
+		@param[in] releaseCount the count of the semaphore to release
+		@param[out] retPreviousCount the count of the semaphore before the release
+		@return nonzero if successful otherwise 0
+		@remark calls into the kernel only for the threads actually waiting.
+		*/
+		long Release(long releaseCount, long * retPreviousCount=NULL);
+
+		/*!
+		Return the count of the semaphore available.
+		@return the count available, or 0 if the threads are waiting.
+		@remark the result may be outdated as soon as returned.
+		*/
+		long GetCount() const;
+
+	private:
+		/*!
+		Try to take a count without waiting.
+		@return true if taken, otherwise false.
+		*/
+		bool tryTake();
+
+		/*!
+		Take a count with spinning first, and wait on the kernel semaphore for given time.
+		@param[in] dwMilliSecond the wait time.
+		@return true if taken, otherwise false.
+		*/
+		bool take(const unsigned int dwMilliSecond);
+
+		/// the semaphore of the platform for the waiting threads
+		PlatformSemaphore m_sem;
+		/// the count available, or the negative number of the waiting threads
+		volatile long m_count;
+		/// Semaphore Initial Count
+		long m_initialCount;
+		/// the number of spins before waiting
+		unsigned int m_spinCount;
+	};
+
+}
+
+#endif //__EP_LIGHT_SEMAPHORE_H__
\ No newline at end of file
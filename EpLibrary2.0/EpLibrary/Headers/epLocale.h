@@ -41,6 +41,7 @@ An Interface for Locale Class.
 #include "epLib.h"
 #include <vector>
 #include <string>
+#include <locale>
 namespace epl{
 	/// A type definition for EpString Type
 	typedef std::string EpString;
@@ -53,12 +54,52 @@ namespace epl{
 #else //defined(_UNICODE) || defined(UNICODE)
 	typedef EpString EpTString;
 #endif //defined(_UNICODE) || defined(UNICODE)
-	
+
+	/// Enumeration of the character classes of ASCII characters
+	typedef enum _localeCharClass{
+		/// control
+		LOCALE_CHAR_CLASS_CNTRL=0x0001,
+		/// space
+		LOCALE_CHAR_CLASS_SPACE=0x0002,
+		/// printable
+		LOCALE_CHAR_CLASS_PRINT=0x0004,
+		/// graph
+		LOCALE_CHAR_CLASS_GRAPH=0x0008,
+		/// punctuation
+		LOCALE_CHAR_CLASS_PUNCT=0x0010,
+		/// digit
+		LOCALE_CHAR_CLASS_DIGIT=0x0020,
+		/// hexa-decimal
+		LOCALE_CHAR_CLASS_XDIGIT=0x0040,
+		/// upper character
+		LOCALE_CHAR_CLASS_UPPER=0x0080,
+		/// lower character
+		LOCALE_CHAR_CLASS_LOWER=0x0100,
+		/// alphabet
+		LOCALE_CHAR_CLASS_ALPHA=0x0200,
+		/// alphanumeric
+		LOCALE_CHAR_CLASS_ALNUM=LOCALE_CHAR_CLASS_ALPHA|LOCALE_CHAR_CLASS_DIGIT
+	}LocaleCharClass;
+
+	/// The character classes of ASCII characters in C locale, which are looked up without the locale
+	static const unsigned short s_localeAsciiCharClassTable[128]={
+		0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0003, 0x0003, 0x0003, 0x0003, 0x0003, 0x0001, 0x0001,	// 0x00-0x0F
+		0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001, 0x0001,	// 0x10-0x1F
+		0x0006, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C,	// 0x20-0x2F
+		0x006C, 0x006C, 0x006C, 0x006C, 0x006C, 0x006C, 0x006C, 0x006C, 0x006C, 0x006C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C,	// 0x30-0x3F
+		0x001C, 0x02CC, 0x02CC, 0x02CC, 0x02CC, 0x02CC, 0x02CC, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C,	// 0x40-0x4F
+		0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x028C, 0x001C, 0x001C, 0x001C, 0x001C, 0x001C,	// 0x50-0x5F
+		0x001C, 0x034C, 0x034C, 0x034C, 0x034C, 0x034C, 0x034C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C,	// 0x60-0x6F
+		0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x030C, 0x001C, 0x001C, 0x001C, 0x001C, 0x0001,	// 0x70-0x7F
+	};
+
 	/*! 
 	@class Locale epLocale.h
 	@brief This is a base class for Locale  Class
 
 	Implements the Locale Functions.
+	@remark the character functions classify ASCII characters by the table of C locale,
+	        and the other characters by the global locale.
 	*/
 	class EP_LIBRARY Locale
 	{
@@ -365,6 +406,22 @@ namespace epl{
 		*/
 		static EpTString Trim(const EpTString& str);
 
+		/*!
+		Find the begin index of the given characters trimmed as TrimLeft, without copying them
+		@param[in] str the characters to trim
+		@param[in] length the number of the characters
+		@return the index of the first character remained
+		*/
+		static size_t TrimLeftIndex(const TCHAR *str, size_t length);
+
+		/*!
+		Find the end index of the given characters trimmed as TrimRight, without copying them
+		@param[in] str the characters to trim
+		@param[in] length the number of the characters
+		@return the index after the last character remained
+		*/
+		static size_t TrimRightIndex(const TCHAR *str, size_t length);
+
 		/*!
 		Return the string that is transformed to all capitalized characters
 		@param[in] str the sting to transform
@@ -408,6 +465,327 @@ namespace epl{
 		*/
 		static EpTString ToLower(const EpTString& str);
 
+	private:
+		/*!
+		Check whether given ASCII character is in given character classes
+		@param[in] c the ASCII character to check
+		@param[in] charClass the character classes to check
+		@return true if given character is in any of given character classes otherwise false
+		*/
+		static bool isAsciiClass(unsigned int c, unsigned short charClass);
+
+		/*!
+		Check whether given character is in given character classes by the global locale
+		@param[in] c the character to check
+		@param[in] mask the character classes of the locale to check
+		@return true if given character is in any of given character classes otherwise false
+		*/
+		static bool isLocaleClass(char c, std::ctype_base::mask mask);
+
+		/*!
+		Check whether given character is in given character classes by the global locale
+		@param[in] c the character to check
+		@param[in] mask the character classes of the locale to check
+		@return true if given character is in any of given character classes otherwise false
+		*/
+		static bool isLocaleClass(wchar_t c, std::ctype_base::mask mask);
+
+		/*!
+		Return the small-case character of given character by the global locale
+		@param[in] c the character to transform to small-case character
+		@return small-case character of given character
+		*/
+		static char toLocaleLower(char c);
+
+		/*!
+		Return the small-case character of given character by the global locale
+		@param[in] c the character to transform to small-case character
+		@return small-case character of given character
+		*/
+		static wchar_t toLocaleLower(wchar_t c);
+
+		/*!
+		Return the capitalized character of given character by the global locale
+		@param[in] c the character to transform to capitalized character
+		@return capitalized character of given character
+		*/
+		static char toLocaleUpper(char c);
+
+		/*!
+		Return the capitalized character of given character by the global locale
+		@param[in] c the character to transform to capitalized character
+		@return capitalized character of given character
+		*/
+		static wchar_t toLocaleUpper(wchar_t c);
+
 	};
+
+	inline bool Locale::isAsciiClass(unsigned int c, unsigned short charClass)
+	{
+		return (s_localeAsciiCharClassTable[c]&charClass)!=0;
+	}
+
+	inline bool Locale::IsCAlnum(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_ALNUM);
+		return isLocaleClass(c,std::ctype_base::alnum);
+	}
+	inline bool Locale::IsCAlpha(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_ALPHA);
+		return isLocaleClass(c,std::ctype_base::alpha);
+	}
+	inline bool Locale::IsCCntrl(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_CNTRL);
+		return isLocaleClass(c,std::ctype_base::cntrl);
+	}
+	inline bool Locale::IsCDigit(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_DIGIT);
+		return isLocaleClass(c,std::ctype_base::digit);
+	}
+	inline bool Locale::IsCGraph(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_GRAPH);
+		return isLocaleClass(c,std::ctype_base::graph);
+	}
+	inline bool Locale::IsCLower(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_LOWER);
+		return isLocaleClass(c,std::ctype_base::lower);
+	}
+	inline bool Locale::IsCPunct(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_PUNCT);
+		return isLocaleClass(c,std::ctype_base::punct);
+	}
+	inline bool Locale::IsCUpper(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_UPPER);
+		return isLocaleClass(c,std::ctype_base::upper);
+	}
+	inline bool Locale::IsCXdigit(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_XDIGIT);
+		return isLocaleClass(c,std::ctype_base::xdigit);
+	}
+	inline bool Locale::IsCSpace(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_SPACE);
+		return isLocaleClass(c,std::ctype_base::space);
+	}
+	inline bool Locale::IsCPrint(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_PRINT);
+		return isLocaleClass(c,std::ctype_base::print);
+	}
+	inline char Locale::ToCLower(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_UPPER)?static_cast<char>(c+('a'-'A')):c;
+		return toLocaleLower(c);
+	}
+	inline char Locale::ToCUpper(char c)
+	{
+		if(static_cast<unsigned char>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned char>(c),LOCALE_CHAR_CLASS_LOWER)?static_cast<char>(c-('a'-'A')):c;
+		return toLocaleUpper(c);
+	}
+
+	inline bool Locale::IsWAlnum(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_ALNUM);
+		return isLocaleClass(c,std::ctype_base::alnum);
+	}
+	inline bool Locale::IsWAlpha(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_ALPHA);
+		return isLocaleClass(c,std::ctype_base::alpha);
+	}
+	inline bool Locale::IsWCntrl(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_CNTRL);
+		return isLocaleClass(c,std::ctype_base::cntrl);
+	}
+	inline bool Locale::IsWDigit(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_DIGIT);
+		return isLocaleClass(c,std::ctype_base::digit);
+	}
+	inline bool Locale::IsWGraph(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_GRAPH);
+		return isLocaleClass(c,std::ctype_base::graph);
+	}
+	inline bool Locale::IsWLower(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_LOWER);
+		return isLocaleClass(c,std::ctype_base::lower);
+	}
+	inline bool Locale::IsWPunct(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_PUNCT);
+		return isLocaleClass(c,std::ctype_base::punct);
+	}
+	inline bool Locale::IsWUpper(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_UPPER);
+		return isLocaleClass(c,std::ctype_base::upper);
+	}
+	inline bool Locale::IsWXdigit(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_XDIGIT);
+		return isLocaleClass(c,std::ctype_base::xdigit);
+	}
+	inline bool Locale::IsWSpace(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_SPACE);
+		return isLocaleClass(c,std::ctype_base::space);
+	}
+	inline bool Locale::IsWPrint(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_PRINT);
+		return isLocaleClass(c,std::ctype_base::print);
+	}
+	inline wchar_t Locale::ToWLower(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_UPPER)?static_cast<wchar_t>(c+('a'-'A')):c;
+		return toLocaleLower(c);
+	}
+	inline wchar_t Locale::ToWUpper(wchar_t c)
+	{
+		if(static_cast<unsigned int>(c)<0x80)
+			return isAsciiClass(static_cast<unsigned int>(c),LOCALE_CHAR_CLASS_LOWER)?static_cast<wchar_t>(c-('a'-'A')):c;
+		return toLocaleUpper(c);
+	}
+
+	inline bool Locale::IsAlnum(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWAlnum(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCAlnum(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsAlpha(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWAlpha(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCAlpha(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsCntrl(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWCntrl(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCCntrl(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsDigit(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWDigit(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCDigit(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsGraph(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWGraph(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCGraph(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsLower(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWLower(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCLower(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsPunct(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWPunct(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCPunct(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsUpper(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWUpper(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCUpper(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsXdigit(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWXdigit(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCXdigit(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsSpace(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWSpace(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCSpace(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline bool Locale::IsPrint(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return IsWPrint(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return IsCPrint(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline TCHAR Locale::ToLower(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return ToWLower(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return ToCLower(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	inline TCHAR Locale::ToUpper(TCHAR c)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		return ToWUpper(c);
+#else //defined(_UNICODE) || defined(UNICODE)
+		return ToCUpper(c);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
 }
 #endif //__EP_LOCALE_H__
\ No newline at end of file
@@ -0,0 +1,365 @@
+/*! 
+@file epLockFreeQueue.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Lock-Free Queue Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Bounded Lock-Free Multi-Producer Multi-Consumer Queue.
+
+*/
+#ifndef __EP_LOCK_FREE_QUEUE_H__
+#define __EP_LOCK_FREE_QUEUE_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epException.h"
+
+/// the cache line size to keep the producer and consumer positions apart
+#define LOCK_FREE_QUEUE_CACHE_LINE_SIZE 64
+
+namespace epl
+{
+
+	/*! 
+	@class LockFreeQueue epLockFreeQueue.h
+	@brief A class for Bounded Lock-Free Multi-Producer Multi-Consumer Queue.
+
+	The queue is a ring of fixed capacity where each slot keeps its own sequence number,
+	so the producers and the consumers only compete on one InterlockedCompareExchange each,
+	and no lock is taken or allocated.
+	The capacity is rounded up to the power of two.
+	@remark Use this instead of ThreadSafeQueue when the queue can be bounded,
+	        and the Front/Erase operations are not needed.
+	*/
+	template <typename DataType>
+	class LockFreeQueue
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the queue
+		@param[in] capacity the maximum number of items in the queue. (rounded up to the power of two)
+		*/
+		LockFreeQueue(unsigned int capacity=1024);
+
+		/*!
+		Default Destructor
+
+		Destroy the queue
+		*/
+		virtual ~LockFreeQueue();
+
+		/*!
+		Check if the queue is empty.
+		@returns Returns true if the queue is empty, otherwise false.
+		@remark the result may be outdated as soon as returned, if other threads are pushing or popping.
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		Return the size of the queue.
+		@return the size of the queue.
+		@remark the result may be outdated as soon as returned, if other threads are pushing or popping.
+		*/
+		size_t Size() const;
+
+		/*!
+		Return the capacity of the queue.
+		@return the maximum number of items in the queue.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Try to insert the new item into the queue.
+		@param[in] data The inserting data.
+		@return true if inserted, false if the queue is full.
+		*/
+		bool TryPush(DataType const &data);
+
+		/*!
+		Try to remove the first item from the queue.
+		@param[out] retData The removed data.
+		@return true if removed, false if the queue is empty.
+		*/
+		bool TryPop(DataType &retData);
+
+		/*!
+		Insert the new item into the queue, and wait while the queue is full.
+		@param[in] data The inserting data.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if inserted, false if timed out.
+		*/
+		bool Push(DataType const &data, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Remove the first item from the queue, and wait while the queue is empty.
+		@param[out] retData The removed data.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if removed, false if timed out.
+		*/
+		bool Pop(DataType &retData, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Insert the given items into the queue until it is full.
+		@param[in] data The array of inserting data.
+		@param[in] count The number of items in the array.
+		@return the number of items inserted.
+		*/
+		size_t PushBatch(DataType const *data, size_t count);
+
+		/*!
+		Remove up to given number of items from the front of the queue.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@return the number of items removed.
+		*/
+		size_t PopBatch(DataType *retData, size_t maxCount);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		LockFreeQueue(const LockFreeQueue & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		LockFreeQueue &operator=(const LockFreeQueue & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Back off after the failed try, spinning first and then yielding the time slice.
+		@param[in,out] tryCount the number of tries so far.
+		*/
+		static void backOff(unsigned int &tryCount);
+
+		/// Slot of the ring
+		struct Cell
+		{
+			/// the sequence number of the slot
+			volatile long sequence;
+			/// the data of the slot
+			DataType data;
+		};
+
+		/// the ring buffer
+		Cell *m_buffer;
+		/// the mask of the index (capacity-1)
+		unsigned long m_mask;
+		/// padding to keep the enqueue position in its own cache line
+		char m_padding0[LOCK_FREE_QUEUE_CACHE_LINE_SIZE];
+		/// the position for the next push
+		volatile long m_enqueuePos;
+		/// padding to keep the dequeue position in its own cache line
+		char m_padding1[LOCK_FREE_QUEUE_CACHE_LINE_SIZE-sizeof(long)];
+		/// the position for the next pop
+		volatile long m_dequeuePos;
+		/// padding to keep the following members off the dequeue position
+		char m_padding2[LOCK_FREE_QUEUE_CACHE_LINE_SIZE-sizeof(long)];
+	};
+
+
+	template <typename DataType>
+	LockFreeQueue<DataType>::LockFreeQueue(unsigned int capacity)
+	{
+		unsigned long bufferSize=2;
+		while(bufferSize<capacity && bufferSize<0x40000000)
+			bufferSize<<=1;
+		m_mask=bufferSize-1;
+		m_buffer=EP_NEW Cell[bufferSize];
+		for(unsigned long cellTrav=0;cellTrav<bufferSize;cellTrav++)
+		{
+			m_buffer[cellTrav].sequence=static_cast<long>(cellTrav);
+		}
+		m_enqueuePos=0;
+		m_dequeuePos=0;
+	}
+
+	template <typename DataType>
+	LockFreeQueue<DataType>::~LockFreeQueue()
+	{
+		EP_DELETE[] m_buffer;
+	}
+
+	template <typename DataType>
+	bool LockFreeQueue<DataType>::IsEmpty() const
+	{
+		return Size()==0;
+	}
+
+	template <typename DataType>
+	size_t LockFreeQueue<DataType>::Size() const
+	{
+		long dequeuePos=m_dequeuePos;
+		long enqueuePos=m_enqueuePos;
+		long size=enqueuePos-dequeuePos;
+		if(size<0)
+			return 0;
+		return static_cast<size_t>(size);
+	}
+
+	template <typename DataType>
+	size_t LockFreeQueue<DataType>::GetCapacity() const
+	{
+		return static_cast<size_t>(m_mask+1);
+	}
+
+	template <typename DataType>
+	bool LockFreeQueue<DataType>::TryPush(DataType const &data)
+	{
+		long pos=m_enqueuePos;
+		while(true)
+		{
+			Cell *cell=&m_buffer[static_cast<unsigned long>(pos)&m_mask];
+			long sequence=cell->sequence;
+			long diff=sequence-pos;
+			if(diff==0)
+			{
+				long prevPos=InterlockedCompareExchange(&m_enqueuePos,pos+1,pos);
+				if(prevPos==pos)
+				{
+					cell->data=data;
+					// publish the data to the consumer of this slot
+					InterlockedExchange(&cell->sequence,pos+1);
+					return true;
+				}
+				pos=prevPos;
+			}
+			else if(diff<0)
+			{
+				// the slot is not consumed yet since the last lap, so the queue is full
+				return false;
+			}
+			else
+			{
+				pos=m_enqueuePos;
+			}
+		}
+	}
+
+	template <typename DataType>
+	bool LockFreeQueue<DataType>::TryPop(DataType &retData)
+	{
+		long pos=m_dequeuePos;
+		while(true)
+		{
+			Cell *cell=&m_buffer[static_cast<unsigned long>(pos)&m_mask];
+			long sequence=cell->sequence;
+			long diff=sequence-(pos+1);
+			if(diff==0)
+			{
+				long prevPos=InterlockedCompareExchange(&m_dequeuePos,pos+1,pos);
+				if(prevPos==pos)
+				{
+					retData=cell->data;
+					// hand the slot back to the producer of the next lap
+					InterlockedExchange(&cell->sequence,pos+static_cast<long>(m_mask)+1);
+					return true;
+				}
+				pos=prevPos;
+			}
+			else if(diff<0)
+			{
+				// the slot is not produced yet, so the queue is empty
+				return false;
+			}
+			else
+			{
+				pos=m_dequeuePos;
+			}
+		}
+	}
+
+	template <typename DataType>
+	bool LockFreeQueue<DataType>::Push(DataType const &data, unsigned int waitTimeInMilliSec)
+	{
+		unsigned int startTick=System::GetTickCount();
+		unsigned int tryCount=0;
+		while(!TryPush(data))
+		{
+			if(waitTimeInMilliSec!=WAITTIME_INIFINITE && System::GetTickCount()-startTick>=waitTimeInMilliSec)
+				return false;
+			backOff(tryCount);
+		}
+		return true;
+	}
+
+	template <typename DataType>
+	bool LockFreeQueue<DataType>::Pop(DataType &retData, unsigned int waitTimeInMilliSec)
+	{
+		unsigned int startTick=System::GetTickCount();
+		unsigned int tryCount=0;
+		while(!TryPop(retData))
+		{
+			if(waitTimeInMilliSec!=WAITTIME_INIFINITE && System::GetTickCount()-startTick>=waitTimeInMilliSec)
+				return false;
+			backOff(tryCount);
+		}
+		return true;
+	}
+
+	template <typename DataType>
+	size_t LockFreeQueue<DataType>::PushBatch(DataType const *data, size_t count)
+	{
+		size_t pushCount=0;
+		while(pushCount<count && TryPush(data[pushCount]))
+			pushCount++;
+		return pushCount;
+	}
+
+	template <typename DataType>
+	size_t LockFreeQueue<DataType>::PopBatch(DataType *retData, size_t maxCount)
+	{
+		size_t popCount=0;
+		while(popCount<maxCount && TryPop(retData[popCount]))
+			popCount++;
+		return popCount;
+	}
+
+	template <typename DataType>
+	void LockFreeQueue<DataType>::backOff(unsigned int &tryCount)
+	{
+		tryCount++;
+		if(tryCount<64)
+			YieldProcessor();
+		else if(tryCount<128)
+			Sleep(0);
+		else
+			Sleep(1);
+	}
+}
+
+#endif //__EP_LOCK_FREE_QUEUE_H__
\ No newline at end of file
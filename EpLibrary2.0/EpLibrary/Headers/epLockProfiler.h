@@ -0,0 +1,191 @@
+/*! 
+@file epLockProfiler.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Lock Profiler Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Lock Contention Profiler.
+
+*/
+#ifndef __EP_LOCK_PROFILER_H__
+#define __EP_LOCK_PROFILER_H__
+#include "epLib.h"
+#include "epBaseOutputter.h"
+#include "epSingletonHolder.h"
+
+/*!
+@def LOCK_PROFILE_INSTANCE
+@brief A Simple Macro to get the Lock Profile Manager Instance
+
+Macro that returns the reference of Lock Profile Manager Instance.
+*/
+#define LOCK_PROFILE_INSTANCE epl::SingletonHolder<epl::LockProfileManager>::Instance()
+
+namespace epl
+{
+	/*! 
+	@struct LockProfileStat epLockProfiler.h
+	@brief The contention statistics of one profiled lock.
+
+	All times are in microseconds.
+	The statistics are updated while holding the profiled lock, so no interlocked operation is needed.
+	*/
+	struct EP_LIBRARY LockProfileStat
+	{
+		/// the number of acquisitions
+		__int64 acquireCount;
+		/// the number of acquisitions which had to wait
+		__int64 contendedCount;
+		/// the sum of the wait time of the contended acquisitions
+		__int64 totalWaitTime;
+		/// the longest hold time
+		__int64 maxHoldTime;
+		/// the time the current holder obtained the lock
+		__int64 holdStartTime;
+		/// the recursion depth of the current holder
+		unsigned int holdDepth;
+
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		*/
+		LockProfileStat();
+	};
+
+	/*! 
+	@class LockProfileManager epLockProfiler.h
+	@brief A class that reports the contention statistics of the profiled locks.
+
+	The lock is profiled by BaseLock::SetProfileName, and reported by Print or FlushToFile.
+	*/
+	class EP_LIBRARY LockProfileManager:public BaseOutputter
+	{
+	public:
+		friend class SingletonHolder<LockProfileManager>;
+		friend class BaseLock;
+
+		/*!
+		Reset the statistics of the profiled locks, and remove the locks already destroyed.
+		*/
+		virtual void Clear();
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy
+		*/
+		LockProfileManager(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		LockProfileManager(const LockProfileManager& b):BaseOutputter(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		LockProfileManager & operator=(const LockProfileManager&b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~LockProfileManager();
+
+		/*! 
+		@class LockProfileNode epLockProfiler.h
+		@brief A class to hold the statistics of one profiled lock.
+		*/
+		class EP_LIBRARY LockProfileNode:public BaseOutputter::OutputNode
+		{
+		public:
+			friend class LockProfileManager;
+
+			/*!
+			Default Constructor
+			@param[in] lock the profiled lock.
+			@param[in] name the name of the lock.
+			*/
+			LockProfileNode(BaseLock *lock, const TCHAR *name);
+
+			/*!
+			Default Destructor
+			*/
+			virtual ~LockProfileNode();
+
+			/*!
+			It prints the data in format,
+			*/
+			virtual void Print() const;
+
+			/*!
+			Write the data to file in format,
+			@param[in] file the file to output the data.
+			*/
+			virtual void Write(EpFile* const file);
+
+		private:
+			/*!
+			Format the statistics into given string.
+			@param[out] retString the formatted string.
+			*/
+			void format(EpTString &retString) const;
+
+			/// the profiled lock, or NULL if the lock is already destroyed
+			BaseLock *m_lock;
+			/// the name of the lock
+			EpTString m_name;
+			/// the statistics
+			LockProfileStat m_stat;
+		};
+
+		/*!
+		Register given lock.
+		@param[in] lock the lock to profile.
+		@param[in] name the name of the lock.
+		@return the statistics of the lock.
+		*/
+		LockProfileStat *registerLock(BaseLock *lock, const TCHAR *name);
+
+		/*!
+		Unregister given lock, keeping its statistics in the report.
+		@param[in] lock the lock destroyed.
+		*/
+		void unregisterLock(BaseLock *lock);
+	};
+}
+#endif //__EP_LOCK_PROFILER_H__
\ No newline at end of file
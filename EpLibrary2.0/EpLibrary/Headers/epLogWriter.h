@@ -41,6 +41,8 @@ An Interface for Log Writer.
 #include "epLib.h"
 #include "epBaseTextFile.h"
 #include "epSingletonHolder.h"
+#include "epEventEx.h"
+#include "epDateTimeHelper.h"
 
 
 /*!
@@ -51,23 +53,118 @@ Macro for the Log Writer Singleton Instance.
 */
 #define LOG_WRITER_INSTANCE epl::SingletonHolder<LogWriter>::Instance()
 
+/// the default interval in milliseconds the log writer flushes the buffered logs
+#define LOG_WRITER_DEFAULT_FLUSH_INTERVAL 1000
+
+/// the default number of the characters buffered before the log writer flushes
+#define LOG_WRITER_DEFAULT_FLUSH_SIZE 65536
+
+/// the default number of the rotated log files kept
+#define LOG_WRITER_DEFAULT_MAX_BACKUP_COUNT 5
+
 namespace epl
 {
+	class LogFlushThread;
+
 	/*! 
 	@class LogWriter epLogWriter.h
 	@brief A class for Writing Log.
+
+	The logs are buffered and written by the background thread to the log file, which is kept open,
+	on every flush interval, or as soon as the flush size is buffered.
+	So the caller only holds the lock while appending the log to the buffer.
 	*/
 	class EP_LIBRARY LogWriter:public BaseTextFile
 	{
 	public:
 		friend SingletonHolder<LogWriter>;
+		friend class LogFlushThread;
 		
 		/*!
 		Writer given message to the log with current time.
 		@param[in] pMsg the message to print to the log file.
+		@remark with the group commit, this returns after the log is committed to the disk.
 		*/
 		void WriteLog(const TCHAR* pMsg);
 
+		/*!
+		Write the buffered logs to the log file now.
+		*/
+		void Flush();
+
+		/*!
+		Set the interval to flush the buffered logs.
+		@param[in] flushInterval the interval in milliseconds.
+		*/
+		void SetFlushInterval(unsigned int flushInterval);
+
+		/*!
+		Return the interval to flush the buffered logs.
+		@return the interval in milliseconds.
+		*/
+		unsigned int GetFlushInterval() const;
+
+		/*!
+		Set the number of the characters buffered, which triggers the flush.
+		@param[in] flushSize the number of the characters. (0 to flush every log)
+		*/
+		void SetFlushSize(unsigned int flushSize);
+
+		/*!
+		Return the number of the characters buffered, which triggers the flush.
+		@return the number of the characters.
+		*/
+		unsigned int GetFlushSize() const;
+
+		/*!
+		Enable or disable the group commit.
+		@param[in] isGroupCommit the flag whether WriteLog waits until the log is committed to the disk.
+		@remark the logs of all threads waiting together are committed by one disk flush.
+		*/
+		void SetGroupCommit(bool isGroupCommit);
+
+		/*!
+		Check if the group commit is enabled.
+		@return true if the group commit is enabled, otherwise false.
+		*/
+		bool IsGroupCommit() const;
+
+		/*!
+		Set the size of the log file, which triggers the rotation.
+		@param[in] maxFileSize the size in byte. (0 for no limit)
+		*/
+		void SetMaxFileSize(unsigned int maxFileSize);
+
+		/*!
+		Return the size of the log file, which triggers the rotation.
+		@return the size in byte.
+		*/
+		unsigned int GetMaxFileSize() const;
+
+		/*!
+		Set the time since the log file is opened, which triggers the rotation.
+		@param[in] maxFileAge the time in seconds. (0 for no limit)
+		*/
+		void SetMaxFileAge(unsigned int maxFileAge);
+
+		/*!
+		Return the time since the log file is opened, which triggers the rotation.
+		@return the time in seconds.
+		*/
+		unsigned int GetMaxFileAge() const;
+
+		/*!
+		Set the number of the rotated log files kept.
+		@param[in] maxBackupCount the number of the files, named as the log file with ".1", ".2" and so on. (0 to discard the rotated log)
+		*/
+		void SetMaxBackupCount(unsigned int maxBackupCount);
+
+		/*!
+		Return the number of the rotated log files kept.
+		@return the number of the files.
+		*/
+		unsigned int GetMaxBackupCount() const;
+
 	private:
 		/*!
 		Default Constructor
@@ -107,6 +204,27 @@ namespace epl
 		*/
 		virtual void writeLoop();
 
+		/*!
+		Initialize the buffering and the rotation.
+		*/
+		void initWriter();
+
+		/*!
+		Write the buffered logs to the log file, rotating it if needed.
+		*/
+		void flushLogs();
+
+		/*!
+		Open the log file to append, if not opened.
+		@return true if the log file is opened, otherwise false.
+		*/
+		bool openLogFile();
+
+		/*!
+		Close the log file, and rename it to the first backup.
+		*/
+		void rotateLogFile();
+
 		/*!
 		Actual load Function that loads values from the file.
 		@remark Sub classes should implement this function
@@ -127,8 +245,44 @@ namespace epl
 		/// Log String
 		CString m_logString;
 
+		/// The logs being written by flushLogs
+		CString m_writeString;
+
 		/// Log Lock
 		BaseLock *m_logLock;
+
+		/// the log file kept open, or NULL
+		EpFile *m_logFile;
+		/// the approximate size of the log file in byte
+		__int64 m_logFileSize;
+		/// the tick count when the log file is opened
+		unsigned int m_logFileOpenTime;
+
+		/// the background thread, or NULL until the first log
+		LogFlushThread *m_flushThread;
+		/// the event to wake the background thread
+		EventEx m_flushEvent;
+		/// the event raised when the buffered logs are committed
+		EventEx m_commitEvent;
+		/// the formatter of the timestamps, used under the log lock
+		TimestampFormatter m_timestampFormatter;
+		/// the number of the logs buffered
+		volatile long m_logCount;
+		/// the number of the logs written
+		volatile long m_writtenCount;
+
+		/// the interval to flush in milliseconds
+		volatile unsigned int m_flushInterval;
+		/// the number of the characters buffered to trigger the flush
+		volatile unsigned int m_flushSize;
+		/// the flag whether WriteLog waits until the log is committed
+		volatile bool m_isGroupCommit;
+		/// the size of the log file to trigger the rotation
+		unsigned int m_maxFileSize;
+		/// the age of the log file in seconds to trigger the rotation
+		unsigned int m_maxFileAge;
+		/// the number of the rotated log files kept
+		unsigned int m_maxBackupCount;
 		
 	};
 }
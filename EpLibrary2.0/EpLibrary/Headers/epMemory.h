@@ -33,16 +33,213 @@ THE SOFTWARE.
 @section DESCRIPTION
 
 An Interface for Memory Dependencies.
+The allocator behind EP_Malloc, EP_Realloc and EP_Free can be replaced at runtime.
 
 */
 
 #ifndef __EP_MEMORY_H__
 #define __EP_MEMORY_H__
+#include "epLib.h"
+#include <stdlib.h>
+#include <new>
 
-#define EP_Malloc  malloc
-#define EP_Realloc realloc
-#define EP_Free    free
+namespace epl
+{
+	/// Enumerator for the subsystem tag of the allocated memory
+	enum MemoryTag
+	{
+		/// General memory
+		MEMORY_TAG_GENERAL=0,
+		/// Memory for the jobs and the worker threads
+		MEMORY_TAG_JOB,
+		/// Memory for the IPC
+		MEMORY_TAG_IPC,
+		/// Memory for the streams
+		MEMORY_TAG_STREAM,
+		/// Memory for the XML
+		MEMORY_TAG_XML,
+		/// Memory Tag Count
+		MEMORY_TAG_COUNT,
+	};
+
+	/*! 
+	@class BaseAllocator epMemory.h
+	@brief An interface class for the allocator behind EP_Malloc, EP_Realloc and EP_Free.
+	*/
+	class EP_LIBRARY BaseAllocator
+	{
+	public:
+		/*!
+		Default Destructor
+
+		Destroy the allocator
+		*/
+		virtual ~BaseAllocator(){}
+
+		/*!
+		Allocate the memory of given size.
+		@param[in] size the size of the memory in bytes.
+		@param[in] tag the subsystem tag of the memory.
+		@return the memory allocated, or NULL if failed.
+		*/
+		virtual void *Malloc(size_t size, MemoryTag tag)=0;
+
+		/*!
+		Reallocate the given memory to given size.
+		@param[in] ptr the memory to reallocate, or NULL.
+		@param[in] size the new size of the memory in bytes.
+		@param[in] tag the subsystem tag of the memory.
+		@return the memory reallocated, or NULL if failed.
+		*/
+		virtual void *Realloc(void *ptr, size_t size, MemoryTag tag)=0;
+
+		/*!
+		Free the given memory.
+		@param[in] ptr the memory to free, or NULL.
+		@param[in] tag the subsystem tag of the memory.
+		*/
+		virtual void Free(void *ptr, MemoryTag tag)=0;
+	};
+
+	/*! 
+	@class Memory epMemory.h
+	@brief A class that routes the memory functions to the installed allocator.
+
+	The CRT heap is used until another allocator is installed.
+	*/
+	class EP_LIBRARY Memory
+	{
+	public:
+		/*!
+		Install the given allocator.
+		@param[in] allocator the allocator to install, or NULL to restore the CRT heap.
+		@return the allocator previously installed.
+		@remark install at the start up before any memory is allocated, since the memory must be freed by the allocator which allocated it.
+		@remark the allocator must live until the program ends.
+		*/
+		static BaseAllocator *SetAllocator(BaseAllocator *allocator);
+
+		/*!
+		Return the allocator installed.
+		@return the allocator installed, or NULL if the CRT heap is used.
+		*/
+		static BaseAllocator *GetAllocator();
+
+		/*!
+		Allocate the memory of given size with the installed allocator.
+		@param[in] size the size of the memory in bytes.
+		@param[in] tag the subsystem tag of the memory.
+		@return the memory allocated, or NULL if failed.
+		*/
+		static void *Malloc(size_t size, MemoryTag tag=MEMORY_TAG_GENERAL)
+		{
+			BaseAllocator *allocator=m_allocator;
+			if(allocator)
+				return allocator->Malloc(size,tag);
+			return malloc(size);
+		}
+
+		/*!
+		Reallocate the given memory to given size with the installed allocator.
+		@param[in] ptr the memory to reallocate, or NULL.
+		@param[in] size the new size of the memory in bytes.
+		@param[in] tag the subsystem tag of the memory.
+		@return the memory reallocated, or NULL if failed.
+		*/
+		static void *Realloc(void *ptr, size_t size, MemoryTag tag=MEMORY_TAG_GENERAL)
+		{
+			BaseAllocator *allocator=m_allocator;
+			if(allocator)
+				return allocator->Realloc(ptr,size,tag);
+			return realloc(ptr,size);
+		}
+
+		/*!
+		Free the given memory with the installed allocator.
+		@param[in] ptr the memory to free, or NULL.
+		@param[in] tag the subsystem tag of the memory.
+		*/
+		static void Free(void *ptr, MemoryTag tag=MEMORY_TAG_GENERAL)
+		{
+			BaseAllocator *allocator=m_allocator;
+			if(allocator)
+				allocator->Free(ptr,tag);
+			else
+				free(ptr);
+		}
+
+		/*!
+		Return the name of the given tag.
+		@param[in] tag the subsystem tag.
+		@return the name of the tag.
+		*/
+		static const TCHAR *GetTagName(MemoryTag tag);
+
+	private:
+		/// the allocator installed
+		static BaseAllocator * volatile m_allocator;
+	};
+}
+
+#define EP_Malloc(size)				epl::Memory::Malloc(size)
+#define EP_Realloc(ptr,size)		epl::Memory::Realloc(ptr,size)
+#define EP_Free(ptr)				epl::Memory::Free(ptr)
+#define EP_MallocTag(size,tag)		epl::Memory::Malloc(size,tag)
+#define EP_ReallocTag(ptr,size,tag)	epl::Memory::Realloc(ptr,size,tag)
+#define EP_FreeTag(ptr,tag)			epl::Memory::Free(ptr,tag)
 #define EP_NEW     new
 #define EP_DELETE  delete
 
+/*!
+@def EP_BAD_ALLOC
+@brief Macro Function for the failed allocation of the global operator new.
+@remark aborts instead of throwing std::bad_alloc if EP_NO_EXCEPTIONS is defined.
+*/
+#if defined(EP_NO_EXCEPTIONS)
+#define EP_BAD_ALLOC() abort()
+#else //defined(EP_NO_EXCEPTIONS)
+#define EP_BAD_ALLOC() throw std::bad_alloc()
+#endif //defined(EP_NO_EXCEPTIONS)
+
+/*!
+Define the global operator new and delete forwarding to the installed allocator.
+@remark use once in a single source file of the executable, since the global operators must be defined only once in the program.
+*/
+#define EP_REPLACE_GLOBAL_NEW_DELETE() \
+	void *operator new(size_t size) \
+	{ \
+		void *retPtr=epl::Memory::Malloc(size?size:1); \
+		if(EP_UNLIKELY(!retPtr)) \
+			EP_BAD_ALLOC(); \
+		return retPtr; \
+	} \
+	void *operator new[](size_t size) \
+	{ \
+		return operator new(size); \
+	} \
+	void *operator new(size_t size, const std::nothrow_t &) throw() \
+	{ \
+		return epl::Memory::Malloc(size?size:1); \
+	} \
+	void *operator new[](size_t size, const std::nothrow_t &) throw() \
+	{ \
+		return epl::Memory::Malloc(size?size:1); \
+	} \
+	void operator delete(void *ptr) throw() \
+	{ \
+		epl::Memory::Free(ptr); \
+	} \
+	void operator delete[](void *ptr) throw() \
+	{ \
+		epl::Memory::Free(ptr); \
+	} \
+	void operator delete(void *ptr, const std::nothrow_t &) throw() \
+	{ \
+		epl::Memory::Free(ptr); \
+	} \
+	void operator delete[](void *ptr, const std::nothrow_t &) throw() \
+	{ \
+		epl::Memory::Free(ptr); \
+	}
+
 #endif //__EP_MEMORY_H__
\ No newline at end of file
@@ -0,0 +1,348 @@
+/*! 
+@file epMemoryTracker.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Memory Tracker Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Memory Allocation Tracker Class.
+
+*/
+#ifndef __EP_MEMORY_TRACKER_H__
+#define __EP_MEMORY_TRACKER_H__
+#include "epLib.h"
+#include "epMemory.h"
+#include "epBaseOutputter.h"
+#include "epSingletonHolder.h"
+
+/*!
+@def MEMORY_TRACKER_INSTANCE
+@brief A Simple Macro to get the Memory Tracker Instance
+
+Macro that returns the reference of Memory Tracker Instance.
+@remark the tracker is never destroyed, since the memory may be freed after the static objects are destroyed.
+*/
+#define MEMORY_TRACKER_INSTANCE epl::SingletonHolder<epl::MemoryTracker,epl::SINGLETON_LIFETIME_NEVER_DESTROY>::Instance()
+
+/// the default number of allocations per call site sample
+#define MEMORY_TRACKER_DEFAULT_SAMPLE_RATE 1024
+/// the maximum number of call sites recorded
+#define MEMORY_TRACKER_MAX_CALL_SITE_COUNT 1024
+/// the number of frames captured for a call site
+#define MEMORY_TRACKER_CALL_STACK_DEPTH 6
+/// the number of call sites in the report
+#define MEMORY_TRACKER_REPORT_CALL_SITE_COUNT 16
+
+namespace epl
+{
+	/*! 
+	@struct MemoryTagStat epMemoryTracker.h
+	@brief The allocation statistics of one memory tag.
+	*/
+	struct EP_LIBRARY MemoryTagStat
+	{
+		/// the number of bytes currently allocated
+		__int64 liveBytes;
+		/// the highest number of bytes allocated at the same time
+		__int64 peakBytes;
+		/// the number of allocations
+		__int64 allocCount;
+		/// the number of bytes allocated in total
+		__int64 allocBytes;
+		/// the number of frees
+		__int64 freeCount;
+
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		*/
+		MemoryTagStat();
+	};
+
+	/*! 
+	@class MemoryTracker epMemoryTracker.h
+	@brief A class that tracks the allocations through EP_Malloc, EP_Realloc and EP_Free, and reports them.
+
+	Once installed, the tracker is the allocator behind the memory macros, and forwards to the allocator which was installed before.
+	It records the live bytes, the peak and the allocation rate of each memory tag,
+	and captures the call stack of every sampled allocation.
+	The report is emitted by Print or FlushToFile.
+	@remark EP_NEW is tracked only if the global operators are replaced by EP_REPLACE_GLOBAL_NEW_DELETE.
+	*/
+	class EP_LIBRARY MemoryTracker:public BaseOutputter, public BaseAllocator
+	{
+	public:
+		friend class SingletonHolder<MemoryTracker,SINGLETON_LIFETIME_NEVER_DESTROY>;
+
+		/*!
+		Install the tracker as the allocator behind the memory macros.
+		@param[in] sampleRate the number of allocations per call site sample. (0 means no call site capture)
+		@remark the tracker cannot be uninstalled, since the memory tracked must be freed by the tracker.
+		*/
+		void Install(unsigned int sampleRate=MEMORY_TRACKER_DEFAULT_SAMPLE_RATE);
+
+		/*!
+		Return the flag whether the tracker is installed.
+		@return true if installed, otherwise false.
+		*/
+		bool IsInstalled() const;
+
+		/*!
+		Copy the statistics of given tag.
+		@param[in] tag the memory tag.
+		@param[out] retStat the statistics of the tag.
+		*/
+		void GetTagStat(MemoryTag tag, MemoryTagStat &retStat) const;
+
+		/*!
+		Reset the counters and the call sites, keeping the live bytes.
+		*/
+		virtual void Clear();
+
+		/*!
+		Allocate the memory of given size, and record it.
+		@param[in] size the size of the memory in bytes.
+		@param[in] tag the subsystem tag of the memory.
+		@return the memory allocated, or NULL if failed.
+		*/
+		virtual void *Malloc(size_t size, MemoryTag tag);
+
+		/*!
+		Reallocate the given memory to given size, and record it.
+		@param[in] ptr the memory to reallocate, or NULL.
+		@param[in] size the new size of the memory in bytes.
+		@param[in] tag the subsystem tag of the memory.
+		@return the memory reallocated, or NULL if failed.
+		*/
+		virtual void *Realloc(void *ptr, size_t size, MemoryTag tag);
+
+		/*!
+		Free the given memory, and record it.
+		@param[in] ptr the memory to free, or NULL.
+		@param[in] tag the subsystem tag of the memory.
+		*/
+		virtual void Free(void *ptr, MemoryTag tag);
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy
+		*/
+		MemoryTracker(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MemoryTracker(const MemoryTracker& b):BaseOutputter(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MemoryTracker & operator=(const MemoryTracker&b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~MemoryTracker();
+
+		/// Header in front of each memory tracked
+		struct BlockHeader
+		{
+			/// the size requested
+			size_t size;
+			/// the memory tag
+			unsigned int tag;
+			/// the check value to tell the memory tracked from the memory allocated before install
+			unsigned int check;
+		};
+
+		/// Sampled Call Site
+		struct CallSite
+		{
+			/// the hash of the frames, or 0 if the slot is not used
+			unsigned long hash;
+			/// the return addresses
+			void *frames[MEMORY_TRACKER_CALL_STACK_DEPTH];
+			/// the number of samples
+			__int64 sampleCount;
+			/// the number of bytes sampled
+			__int64 sampleBytes;
+		};
+
+		/*! 
+		@class MemoryTagNode epMemoryTracker.h
+		@brief A class to report the statistics of one memory tag.
+		*/
+		class EP_LIBRARY MemoryTagNode:public BaseOutputter::OutputNode
+		{
+		public:
+			/*!
+			Default Constructor
+			@param[in] tracker the tracker owning the node.
+			@param[in] tag the memory tag.
+			*/
+			MemoryTagNode(const MemoryTracker *tracker, MemoryTag tag);
+
+			/*!
+			Default Destructor
+			*/
+			virtual ~MemoryTagNode();
+
+			/*!
+			It prints the data in format,
+			*/
+			virtual void Print() const;
+
+			/*!
+			Write the data to file in format,
+			@param[in] file the file to output the data.
+			*/
+			virtual void Write(EpFile* const file);
+
+		private:
+			/*!
+			Format the statistics into given string.
+			@param[out] retString the formatted string.
+			*/
+			void format(EpTString &retString) const;
+
+			/// the tracker owning the node
+			const MemoryTracker *m_tracker;
+			/// the memory tag
+			MemoryTag m_tag;
+		};
+
+		/*! 
+		@class MemoryCallSiteNode epMemoryTracker.h
+		@brief A class to report the call sites sampled most.
+		*/
+		class EP_LIBRARY MemoryCallSiteNode:public BaseOutputter::OutputNode
+		{
+		public:
+			/*!
+			Default Constructor
+			@param[in] tracker the tracker owning the node.
+			*/
+			MemoryCallSiteNode(const MemoryTracker *tracker);
+
+			/*!
+			Default Destructor
+			*/
+			virtual ~MemoryCallSiteNode();
+
+			/*!
+			It prints the data in format,
+			*/
+			virtual void Print() const;
+
+			/*!
+			Write the data to file in format,
+			@param[in] file the file to output the data.
+			*/
+			virtual void Write(EpFile* const file);
+
+		private:
+			/*!
+			Format the call sites into given string.
+			@param[out] retString the formatted string.
+			*/
+			void format(EpTString &retString) const;
+
+			/// the tracker owning the node
+			const MemoryTracker *m_tracker;
+		};
+
+		/*!
+		Record the allocation of given size.
+		@param[in] size the size allocated.
+		@param[in] tag the memory tag.
+		*/
+		void recordAlloc(size_t size, MemoryTag tag);
+
+		/*!
+		Record the free of given size.
+		@param[in] size the size freed.
+		@param[in] tag the memory tag.
+		*/
+		void recordFree(size_t size, MemoryTag tag);
+
+		/*!
+		Capture the call stack of the allocation of given size.
+		@param[in] size the size allocated.
+		*/
+		void sampleCallSite(size_t size);
+
+		/*!
+		Write the header of the block, and return the memory for the user.
+		@param[in] block the block allocated.
+		@param[in] size the size requested.
+		@param[in] tag the memory tag.
+		@return the memory for the user.
+		*/
+		static void *initBlock(void *block, size_t size, MemoryTag tag);
+
+		/*!
+		Return the header of the given memory, if tracked.
+		@param[in] ptr the memory for the user.
+		@return the header of the memory, or NULL if the memory is not tracked.
+		*/
+		static BlockHeader *headerOf(void *ptr);
+
+		/// the function type of RtlCaptureStackBackTrace
+		typedef unsigned short (WINAPI *CaptureStackFunc)(unsigned long framesToSkip, unsigned long framesToCapture, void **backTrace, unsigned long *backTraceHash);
+
+		/// the allocator forwarded to, or NULL for the CRT heap
+		BaseAllocator *m_allocator;
+		/// the flag whether installed
+		volatile long m_isInstalled;
+		/// the number of allocations per sample
+		unsigned int m_sampleRate;
+		/// the allocation counter for sampling
+		volatile long m_sampleCounter;
+		/// the function to capture the call stack
+		CaptureStackFunc m_captureStack;
+		/// the statistics of each tag
+		MemoryTagStat m_tagStats[MEMORY_TAG_COUNT];
+		/// the call sites sampled
+		CallSite *m_callSites;
+		/// the tick count of the last reset
+		unsigned long m_startTick;
+		/// statistics lock
+		BaseLock *m_statLock;
+	};
+}
+#endif //__EP_MEMORY_TRACKER_H__
\ No newline at end of file
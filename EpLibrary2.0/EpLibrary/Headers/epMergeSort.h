@@ -38,9 +38,20 @@ An Interface for Merge Sort Algorithm Function.
 #ifndef __EP_MERGE_SORT_H__
 #define __EP_MERGE_SORT_H__
 #include "epLib.h"
+#include "epParallel.h"
+#include "epInsertionSort.h"
 #include <stack>
 using namespace std;
 
+/// the minimum size of the list to sort both halves on the different threads in MSORT_MODE_PARALLEL
+#define MSORT_PARALLEL_CUTOFF 32768
+/// the minimum size of the merge to split across the different threads in MSORT_MODE_PARALLEL
+#define MSORT_PARALLEL_MERGE_CUTOFF 32768
+/// the size of the runs sorted with the insertion sort in MSORT_MODE_BOTTOM_UP and MSORT_MODE_ADAPTIVE
+#define MSORT_RUN_SIZE 32
+/// the maximum number of the pending runs in MSORT_MODE_ADAPTIVE (enough for any 64-bit list size)
+#define MSORT_MAX_RUN_COUNT 128
+
 namespace epl
 {
 	/// Enumeration Type for Merge Sort Mode
@@ -48,44 +59,24 @@ namespace epl
 		/// MSort Mode using Recursive operation
 		MSORT_MODE_RECURSIVE,
 		/// MSort Mode using Loop operation
-		MSORT_MODE_LOOP
+		MSORT_MODE_LOOP,
+		/// MSort Mode forking the halves and the merge onto the thread pool
+		MSORT_MODE_PARALLEL,
+		/// MSort Mode using stable Bottom-up operation without allocation
+		MSORT_MODE_BOTTOM_UP,
+		/// MSort Mode using stable Adaptive operation merging the natural runs without allocation
+		MSORT_MODE_ADAPTIVE
 	}MSortMode;
 
-	/*!
-	Template Insertion Sort Function
-
-	Sort the given list with Sort Function Pointer.
-	@param[in] sortList The list to sort.
-	@param[in] listSize The size of the list.
-	@param[in] SortFunc The Compare Function pointer.
-	@param[in] mode the flag for recursive or loop mode
-	*/
-	template<typename T>
-	inline void MergeSort(T *sortList, size_t listSize,CompResultType (__cdecl *SortFunc)(const void * , const void *), MSortMode mode=MSORT_MODE_LOOP)
-	{ 
-		if(sortList==NULL || listSize<=1)
-			return;
-		T* mergeSpace=reinterpret_cast<T*>(EP_Malloc(sizeof(T)*listSize));
-
-		T* sortedList;
-		if(mode==MSORT_MODE_RECURSIVE)
-			sortedList=subMergeSortRecursive<T>(sortList,listSize,mergeSpace,SortFunc);
-		else if(mode==MSORT_MODE_LOOP)
-			sortedList=subMergeSortLoop<T>(sortList,listSize,mergeSpace,SortFunc);
-
-		EP_Free(mergeSpace);
-		return;
-	}
-
 	/*!
 	Actual Merge Sort Operation Function.
 	@param[in] sortList The list to sort.
 	@param[in] listSize The size of the list.
 	@param[in] workSpace the list for sorting operation
-	@param[in] SortFunc The Compare Function pointer.
+	@param[in] SortFunc The Compare Function pointer or functor.
 	*/
-	template<typename T>
-	inline T* subMergeSortRecursive(T *sortList, size_t listSize, T* workSpace,CompResultType (__cdecl *SortFunc)(const void * , const void *))
+	template<typename T,typename CompFuncType>
+	inline T* subMergeSortRecursive(T *sortList, size_t listSize, T* workSpace,CompFuncType SortFunc)
 	{
 		if(listSize!=1)
 		{
@@ -141,10 +132,10 @@ namespace epl
 	@param[in] sortList The list to sort.
 	@param[in] listSize The size of the list.
 	@param[in] workSpace the list for sorting operation
-	@param[in] SortFunc The Compare Function pointer.
+	@param[in] SortFunc The Compare Function pointer or functor.
 	*/
-	template<typename T>
-	inline T* subMergeSortLoop(T *sortList, size_t listSize, T* workSpace,CompResultType (__cdecl *SortFunc)(const void * , const void *))
+	template<typename T,typename CompFuncType>
+	inline T* subMergeSortLoop(T *sortList, size_t listSize, T* workSpace,CompFuncType SortFunc)
 	{
 		struct SnapShotStruct
 		{
@@ -255,5 +246,523 @@ namespace epl
 		}
 		return sortList;
 	}
+
+	/*!
+	Merge the given two sorted lists into the output list.
+	@param[in] leftList the left sorted list.
+	@param[in] leftSize the size of the left list.
+	@param[in] rightList the right sorted list.
+	@param[in] rightSize the size of the right list.
+	@param[out] outList the list to receive the merged list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark the element of the left list comes first if equal.
+	*/
+	template<typename T,typename CompFuncType>
+	inline void subMerge(const T *leftList, size_t leftSize, const T *rightList, size_t rightSize, T *outList,CompFuncType SortFunc)
+	{
+		const T *leftEnd=leftList+leftSize;
+		const T *rightEnd=rightList+rightSize;
+		while(leftList!=leftEnd && rightList!=rightEnd)
+		{
+			if(SortFunc(rightList,leftList)<COMP_RESULT_EQUAL)
+				*outList++=*rightList++;
+			else
+				*outList++=*leftList++;
+		}
+		while(leftList!=leftEnd)
+			*outList++=*leftList++;
+		while(rightList!=rightEnd)
+			*outList++=*rightList++;
+	}
+
+	/*!
+	Actual Merge Sort Operation Function with Bottom-up Operation.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] workSpace the list for sorting operation
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark the runs of MSORT_RUN_SIZE are insertion sorted, and merged in the doubling width 
+	between the list and the work space, so nothing is allocated.
+	*/
+	template<typename T,typename CompFuncType>
+	inline T* subMergeSortBottomUp(T *sortList, size_t listSize, T* workSpace,CompFuncType SortFunc)
+	{
+		size_t trav;
+		for(trav=0;trav<listSize;trav+=MSORT_RUN_SIZE)
+		{
+			size_t runSize=listSize-trav;
+			if(runSize>MSORT_RUN_SIZE)
+				runSize=MSORT_RUN_SIZE;
+			InsertionSort<T>(sortList,trav,trav+runSize-1,SortFunc);
+		}
+
+		T *srcList=sortList;
+		T *destList=workSpace;
+		for(size_t width=MSORT_RUN_SIZE;width<listSize;width*=2)
+		{
+			for(size_t begin=0;begin<listSize;begin+=2*width)
+			{
+				size_t mid=begin+width;
+				if(mid>=listSize)
+				{
+					for(trav=begin;trav<listSize;trav++)
+						destList[trav]=srcList[trav];
+					break;
+				}
+				size_t end=mid+width;
+				if(end>listSize)
+					end=listSize;
+				subMerge<T>(srcList+begin,mid-begin,srcList+mid,end-mid,destList+begin,SortFunc);
+			}
+			T *tmpList=srcList;
+			srcList=destList;
+			destList=tmpList;
+		}
+		if(srcList!=sortList)
+		{
+			for(trav=0;trav<listSize;trav++)
+				sortList[trav]=srcList[trav];
+		}
+		return sortList;
+	}
+
+	/*!
+	Return the number of the items in the sorted list which are not greater than the key.
+	@param[in] key the key to search.
+	@param[in] searchList the sorted list.
+	@param[in] listSize the size of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@return the index of the first item greater than the key.
+	*/
+	template<typename T,typename CompFuncType>
+	inline size_t mergeUpperBound(const T &key, const T *searchList, size_t listSize,CompFuncType SortFunc)
+	{
+		size_t low=0;
+		size_t high=listSize;
+		while(low<high)
+		{
+			size_t mid=low+(high-low)/2;
+			if(SortFunc(&searchList[mid],&key)>COMP_RESULT_EQUAL)
+				high=mid;
+			else
+				low=mid+1;
+		}
+		return low;
+	}
+
+	/*!
+	Return the number of the items in the sorted list which are less than the key.
+	@param[in] key the key to search.
+	@param[in] searchList the sorted list.
+	@param[in] listSize the size of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@return the index of the first item not less than the key.
+	*/
+	template<typename T,typename CompFuncType>
+	inline size_t mergeLowerBound(const T &key, const T *searchList, size_t listSize,CompFuncType SortFunc)
+	{
+		size_t low=0;
+		size_t high=listSize;
+		while(low<high)
+		{
+			size_t mid=low+(high-low)/2;
+			if(SortFunc(&searchList[mid],&key)<COMP_RESULT_EQUAL)
+				low=mid+1;
+			else
+				high=mid;
+		}
+		return low;
+	}
+
+	/*!
+	Return the length of the natural run at the beginning of the given list.
+	@param[in] sortList The list to scan.
+	@param[in] listSize The size of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@return the length of the run.
+	@remark the strictly descending run is reversed in place, so the equal items keep their order.
+	*/
+	template<typename T,typename CompFuncType>
+	inline size_t mergeRunLength(T *sortList, size_t listSize,CompFuncType SortFunc)
+	{
+		if(listSize<2)
+			return listSize;
+		size_t runSize=2;
+		if(SortFunc(&sortList[1],&sortList[0])<COMP_RESULT_EQUAL)
+		{
+			while(runSize<listSize && SortFunc(&sortList[runSize],&sortList[runSize-1])<COMP_RESULT_EQUAL)
+				runSize++;
+			for(size_t low=0,high=runSize-1;low<high;low++,high--)
+			{
+				T tmp=sortList[low];
+				sortList[low]=sortList[high];
+				sortList[high]=tmp;
+			}
+		}
+		else
+		{
+			while(runSize<listSize && SortFunc(&sortList[runSize],&sortList[runSize-1])>=COMP_RESULT_EQUAL)
+				runSize++;
+		}
+		return runSize;
+	}
+
+	/*!
+	Merge the given two adjacent sorted runs in place with the work space.
+	@param[in] leftList the left run.
+	@param[in] leftSize the size of the left run.
+	@param[in] rightSize the size of the right run which follows the left run.
+	@param[in] workSpace the list for merging operation
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark the head of the left run and the tail of the right run already in place are skipped, 
+	so the merge of the ordered runs costs only the binary searches.
+	*/
+	template<typename T,typename CompFuncType>
+	inline void mergeRuns(T *leftList, size_t leftSize, size_t rightSize, T* workSpace,CompFuncType SortFunc)
+	{
+		T *rightList=leftList+leftSize;
+		size_t skipSize=mergeUpperBound<T>(rightList[0],leftList,leftSize,SortFunc);
+		leftList+=skipSize;
+		leftSize-=skipSize;
+		if(leftSize==0)
+			return;
+		rightSize=mergeLowerBound<T>(leftList[leftSize-1],rightList,rightSize,SortFunc);
+		for(size_t trav=0;trav<leftSize;trav++)
+			workSpace[trav]=leftList[trav];
+		// the output never passes the unread part of the right run.
+		subMerge<T>(workSpace,leftSize,rightList,rightSize,leftList,SortFunc);
+	}
+
+	/*!
+	Return the minimum run length for the adaptive merge sort.
+	@param[in] listSize The size of the list.
+	@return the minimum run length between MSORT_RUN_SIZE and 2*MSORT_RUN_SIZE.
+	@remark the list is split into a power of two runs or slightly fewer, to keep the merges balanced.
+	*/
+	inline size_t mergeMinRunLength(size_t listSize)
+	{
+		size_t lowBit=0;
+		while(listSize>=2*MSORT_RUN_SIZE)
+		{
+			lowBit|=listSize&1;
+			listSize>>=1;
+		}
+		return listSize+lowBit;
+	}
+
+	/*!
+	Actual Merge Sort Operation Function with Adaptive Operation.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] workSpace the list for sorting operation
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark the natural runs are detected and extended to the minimum run length with the insertion sort,
+	and merged with the TimSort invariants on the fixed-size run stack, so nothing is allocated.
+	*/
+	template<typename T,typename CompFuncType>
+	inline T* subMergeSortAdaptive(T *sortList, size_t listSize, T* workSpace,CompFuncType SortFunc)
+	{
+		size_t runBase[MSORT_MAX_RUN_COUNT];
+		size_t runSize[MSORT_MAX_RUN_COUNT];
+		size_t runCount=0;
+		size_t minRunSize=mergeMinRunLength(listSize);
+		size_t pos=0;
+		while(pos<listSize)
+		{
+			size_t remainSize=listSize-pos;
+			size_t curRunSize=mergeRunLength<T>(sortList+pos,remainSize,SortFunc);
+			if(curRunSize<minRunSize)
+			{
+				curRunSize=minRunSize;
+				if(curRunSize>remainSize)
+					curRunSize=remainSize;
+				InsertionSort<T>(sortList,pos,pos+curRunSize-1,SortFunc);
+			}
+			EP_ASSERT_EXPR(runCount<MSORT_MAX_RUN_COUNT,_T("The run stack of the adaptive merge sort overflowed."));
+			runBase[runCount]=pos;
+			runSize[runCount]=curRunSize;
+			runCount++;
+			pos+=curRunSize;
+
+			// keep runSize[i-2] > runSize[i-1]+runSize[i] and runSize[i-1] > runSize[i]
+			while(runCount>1)
+			{
+				size_t mergeIdx=runCount-2;
+				if((mergeIdx>0 && runSize[mergeIdx-1]<=runSize[mergeIdx]+runSize[mergeIdx+1]) 
+					|| (mergeIdx>1 && runSize[mergeIdx-2]<=runSize[mergeIdx-1]+runSize[mergeIdx]))
+				{
+					if(runSize[mergeIdx-1]<runSize[mergeIdx+1])
+						mergeIdx--;
+				}
+				else if(runSize[mergeIdx]>runSize[mergeIdx+1])
+				{
+					break;
+				}
+				mergeRuns<T>(sortList+runBase[mergeIdx],runSize[mergeIdx],runSize[mergeIdx+1],workSpace,SortFunc);
+				runSize[mergeIdx]+=runSize[mergeIdx+1];
+				for(size_t runTrav=mergeIdx+1;runTrav<runCount-1;runTrav++)
+				{
+					runBase[runTrav]=runBase[runTrav+1];
+					runSize[runTrav]=runSize[runTrav+1];
+				}
+				runCount--;
+			}
+		}
+		while(runCount>1)
+		{
+			size_t mergeIdx=runCount-2;
+			if(mergeIdx>0 && runSize[mergeIdx-1]<runSize[mergeIdx+1])
+				mergeIdx--;
+			mergeRuns<T>(sortList+runBase[mergeIdx],runSize[mergeIdx],runSize[mergeIdx+1],workSpace,SortFunc);
+			runSize[mergeIdx]+=runSize[mergeIdx+1];
+			for(size_t runTrav=mergeIdx+1;runTrav<runCount-1;runTrav++)
+			{
+				runBase[runTrav]=runBase[runTrav+1];
+				runSize[runTrav]=runSize[runTrav+1];
+			}
+			runCount--;
+		}
+		return sortList;
+	}
+
+	template<typename T,typename CompFuncType>
+	void subMergeParallel(const T *leftList, size_t leftSize, const T *rightList, size_t rightSize, T *outList,CompFuncType SortFunc,ThreadPool *pool);
+
+	/*!
+	@struct ParallelMergeFunctor epMergeSort.h
+	@brief A functor which merges the split parts given to ParallelFor.
+	*/
+	template<typename T,typename CompFuncType>
+	struct ParallelMergeFunctor
+	{
+		/// the left sorted list of each part
+		const T *m_leftList[2];
+		/// the size of the left list of each part
+		size_t m_leftSize[2];
+		/// the right sorted list of each part
+		const T *m_rightList[2];
+		/// the size of the right list of each part
+		size_t m_rightSize[2];
+		/// the output list of each part
+		T *m_outList[2];
+		/// the compare function
+		CompFuncType m_sortFunc;
+		/// the thread pool to fork onto
+		ThreadPool *m_pool;
+
+		/*!
+		Merge the parts of the given chunk.
+		@param[in] chunkBegin the first part index of the chunk.
+		@param[in] chunkEnd the index after the last part of the chunk.
+		*/
+		void operator()(size_t chunkBegin, size_t chunkEnd) const
+		{
+			for(size_t partTrav=chunkBegin;partTrav<chunkEnd;partTrav++)
+				subMergeParallel<T>(m_leftList[partTrav],m_leftSize[partTrav],m_rightList[partTrav],m_rightSize[partTrav],m_outList[partTrav],m_sortFunc,m_pool);
+		}
+	};
+
+	/*!
+	Merge the given two sorted lists into the output list across the thread pool.
+	@param[in] leftList the left sorted list.
+	@param[in] leftSize the size of the left list.
+	@param[in] rightList the right sorted list.
+	@param[in] rightSize the size of the right list.
+	@param[out] outList the list to receive the merged list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] pool the thread pool to fork onto.
+	@remark the middle of the larger list is located in the other list by the binary search, 
+	and the two pairs of the parts are merged independently.
+	*/
+	template<typename T,typename CompFuncType>
+	void subMergeParallel(const T *leftList, size_t leftSize, const T *rightList, size_t rightSize, T *outList,CompFuncType SortFunc,ThreadPool *pool)
+	{
+		if(leftSize+rightSize<=MSORT_PARALLEL_MERGE_CUTOFF || leftSize==0 || rightSize==0)
+		{
+			subMerge<T>(leftList,leftSize,rightList,rightSize,outList,SortFunc);
+			return;
+		}
+		size_t leftMid;
+		size_t rightMid;
+		if(leftSize>=rightSize)
+		{
+			// the first element of the right list, not less than the middle of the left list
+			leftMid=leftSize/2;
+			size_t low=0;
+			size_t high=rightSize;
+			while(low<high)
+			{
+				size_t mid=low+(high-low)/2;
+				if(SortFunc(&rightList[mid],&leftList[leftMid])<COMP_RESULT_EQUAL)
+					low=mid+1;
+				else
+					high=mid;
+			}
+			rightMid=low;
+		}
+		else
+		{
+			// the first element of the left list, greater than the middle of the right list
+			rightMid=rightSize/2;
+			size_t low=0;
+			size_t high=leftSize;
+			while(low<high)
+			{
+				size_t mid=low+(high-low)/2;
+				if(SortFunc(&leftList[mid],&rightList[rightMid])>COMP_RESULT_EQUAL)
+					high=mid;
+				else
+					low=mid+1;
+			}
+			leftMid=low;
+		}
+		ParallelMergeFunctor<T,CompFuncType> func;
+		func.m_leftList[0]=leftList;
+		func.m_leftSize[0]=leftMid;
+		func.m_rightList[0]=rightList;
+		func.m_rightSize[0]=rightMid;
+		func.m_outList[0]=outList;
+		func.m_leftList[1]=leftList+leftMid;
+		func.m_leftSize[1]=leftSize-leftMid;
+		func.m_rightList[1]=rightList+rightMid;
+		func.m_rightSize[1]=rightSize-rightMid;
+		func.m_outList[1]=outList+leftMid+rightMid;
+		func.m_sortFunc=SortFunc;
+		func.m_pool=pool;
+		ParallelFor(pool,0,2,1,func);
+	}
+
+	template<typename T,typename CompFuncType>
+	void subMergeSortParallel(T *sortList, size_t listSize, T* workSpace, bool isToWorkSpace,CompFuncType SortFunc,ThreadPool *pool);
+
+	/*!
+	@struct ParallelMergeSortFunctor epMergeSort.h
+	@brief A functor which sorts the halves given to ParallelFor.
+	*/
+	template<typename T,typename CompFuncType>
+	struct ParallelMergeSortFunctor
+	{
+		/// the list of each half
+		T *m_sortList[2];
+		/// the size of each half
+		size_t m_listSize[2];
+		/// the work space of each half
+		T *m_workSpace[2];
+		/// the flag whether the sorted halves go to the work space
+		bool m_isToWorkSpace;
+		/// the compare function
+		CompFuncType m_sortFunc;
+		/// the thread pool to fork onto
+		ThreadPool *m_pool;
+
+		/*!
+		Sort the halves of the given chunk.
+		@param[in] chunkBegin the first half index of the chunk.
+		@param[in] chunkEnd the index after the last half of the chunk.
+		*/
+		void operator()(size_t chunkBegin, size_t chunkEnd) const
+		{
+			for(size_t partTrav=chunkBegin;partTrav<chunkEnd;partTrav++)
+				subMergeSortParallel<T>(m_sortList[partTrav],m_listSize[partTrav],m_workSpace[partTrav],m_isToWorkSpace,m_sortFunc,m_pool);
+		}
+	};
+
+	/*!
+	Actual Merge Sort Operation Function with Parallel Operation.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] workSpace the list for sorting operation
+	@param[in] isToWorkSpace the flag whether the sorted list goes to the work space instead of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] pool the thread pool to fork onto.
+	@remark the halves are sorted into the other buffer and merged back, so no level copies the list back.
+	*/
+	template<typename T,typename CompFuncType>
+	void subMergeSortParallel(T *sortList, size_t listSize, T* workSpace, bool isToWorkSpace,CompFuncType SortFunc,ThreadPool *pool)
+	{
+		if(listSize<=MSORT_PARALLEL_CUTOFF)
+		{
+			if(listSize>1)
+				subMergeSortBottomUp<T>(sortList,listSize,workSpace,SortFunc);
+			if(isToWorkSpace)
+			{
+				for(size_t trav=0;trav<listSize;trav++)
+					workSpace[trav]=sortList[trav];
+			}
+			return;
+		}
+		size_t leftSize=listSize/2;
+		ParallelMergeSortFunctor<T,CompFuncType> func;
+		func.m_sortList[0]=sortList;
+		func.m_listSize[0]=leftSize;
+		func.m_workSpace[0]=workSpace;
+		func.m_sortList[1]=sortList+leftSize;
+		func.m_listSize[1]=listSize-leftSize;
+		func.m_workSpace[1]=workSpace+leftSize;
+		func.m_isToWorkSpace=!isToWorkSpace;
+		func.m_sortFunc=SortFunc;
+		func.m_pool=pool;
+		ParallelFor(pool,0,2,1,func);
+		if(isToWorkSpace)
+			subMergeParallel<T>(sortList,leftSize,sortList+leftSize,listSize-leftSize,workSpace,SortFunc,pool);
+		else
+			subMergeParallel<T>(workSpace,leftSize,workSpace+leftSize,listSize-leftSize,sortList,SortFunc,pool);
+	}
+
+	/*!
+	Template Merge Sort Function
+
+	Sort the given list with Sort Function Pointer or Functor, using the given work space.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] workSpace the list of at least listSize items for sorting operation
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] mode the flag for recursive, loop, parallel, bottom-up or adaptive mode
+	@param[in] pool the thread pool for MSORT_MODE_PARALLEL (NULL to sort on the calling thread)
+	@remark MSORT_MODE_BOTTOM_UP and MSORT_MODE_ADAPTIVE are stable and allocate nothing,
+	so the same work space can be reused for many sorts.
+	@remark for MSORT_MODE_PARALLEL, SortFunc must be safe to call concurrently.
+	*/
+	template<typename T,typename CompFuncType>
+	inline void MergeSort(T *sortList, size_t listSize, T *workSpace,CompFuncType SortFunc, MSortMode mode=MSORT_MODE_LOOP, ThreadPool *pool=NULL)
+	{
+		if(sortList==NULL || listSize<=1)
+			return;
+		EP_ASSERT_EXPR(workSpace!=NULL,_T("The work space of the merge sort is NULL."));
+		if(mode==MSORT_MODE_RECURSIVE)
+			subMergeSortRecursive<T>(sortList,listSize,workSpace,SortFunc);
+		else if(mode==MSORT_MODE_LOOP)
+			subMergeSortLoop<T>(sortList,listSize,workSpace,SortFunc);
+		else if(mode==MSORT_MODE_PARALLEL)
+			subMergeSortParallel<T>(sortList,listSize,workSpace,false,SortFunc,pool);
+		else if(mode==MSORT_MODE_BOTTOM_UP)
+			subMergeSortBottomUp<T>(sortList,listSize,workSpace,SortFunc);
+		else if(mode==MSORT_MODE_ADAPTIVE)
+			subMergeSortAdaptive<T>(sortList,listSize,workSpace,SortFunc);
+	}
+
+	/*!
+	Template Merge Sort Function
+
+	Sort the given list with Sort Function Pointer or Functor.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] mode the flag for recursive, loop, parallel, bottom-up or adaptive mode
+	@param[in] pool the thread pool for MSORT_MODE_PARALLEL (NULL to sort on the calling thread)
+	@remark for MSORT_MODE_PARALLEL, SortFunc must be safe to call concurrently.
+	*/
+	template<typename T,typename CompFuncType>
+	inline void MergeSort(T *sortList, size_t listSize,CompFuncType SortFunc, MSortMode mode=MSORT_MODE_LOOP, ThreadPool *pool=NULL)
+	{ 
+		if(sortList==NULL || listSize<=1)
+			return;
+		T* mergeSpace=reinterpret_cast<T*>(EP_Malloc(sizeof(T)*listSize));
+
+		MergeSort<T>(sortList,listSize,mergeSpace,SortFunc,mode,pool);
+
+		EP_Free(mergeSpace);
+		return;
+	}
 }
 #endif //__EP_MERGE_SORT_H__
\ No newline at end of file
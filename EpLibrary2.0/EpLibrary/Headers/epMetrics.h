@@ -0,0 +1,661 @@
+/*! 
+@file epMetrics.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Metrics Registry Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Metrics Registry.
+
+*/
+#ifndef __EP_METRICS_H__
+#define __EP_METRICS_H__
+#include "epLib.h"
+#include "epBaseOutputter.h"
+#include "epSingletonHolder.h"
+#include "epLatencyHistogram.h"
+#include <map>
+
+/*!
+@def METRICS_INSTANCE
+@brief A Simple Macro to get the Metrics Registry Instance
+
+Macro that returns the reference of Metrics Registry Instance.
+*/
+#define METRICS_INSTANCE epl::SingletonHolder<epl::MetricsRegistry>::Instance()
+
+/// the number of the shards of the counter, which must be a power of two
+#define METRICS_SHARD_COUNT 16
+
+/// the number of the shards of the histogram, which must be a power of two
+#define METRICS_HISTOGRAM_SHARD_COUNT 4
+
+/// the byte size of the cache line the shards are kept apart by
+#define METRICS_CACHE_LINE_SIZE 64
+
+/// the magic number of the serialized snapshot ('EPMS')
+#define METRICS_SNAPSHOT_MAGIC 0x534d5045
+
+/// the version of the serialized snapshot
+#define METRICS_SNAPSHOT_VERSION 1
+
+/*!
+@def METRICS_COUNTER_ADD
+@brief Macro to add to the counter of the given name
+
+Macro that looks up the counter only on the first call of the site, 
+and adds with one interlocked operation after.
+@param[in] name the name of the counter.
+@param[in] delta the value to add.
+*/
+#define METRICS_COUNTER_ADD(name,delta) do{ \
+	static epl::MetricCounter * volatile _metricCounter=NULL; \
+	if(!_metricCounter) \
+		_metricCounter=METRICS_INSTANCE.GetCounter(name); \
+	if(_metricCounter) \
+		_metricCounter->Add(delta); \
+	}while(0)
+
+/*!
+@def METRICS_GAUGE_SET
+@brief Macro to set the gauge of the given name
+
+Macro that looks up the gauge only on the first call of the site.
+@param[in] name the name of the gauge.
+@param[in] value the value to set.
+*/
+#define METRICS_GAUGE_SET(name,value) do{ \
+	static epl::MetricGauge * volatile _metricGauge=NULL; \
+	if(!_metricGauge) \
+		_metricGauge=METRICS_INSTANCE.GetGauge(name); \
+	if(_metricGauge) \
+		_metricGauge->Set(value); \
+	}while(0)
+
+/*!
+@def METRICS_HISTOGRAM_RECORD
+@brief Macro to record to the histogram of the given name
+
+Macro that looks up the histogram only on the first call of the site.
+@param[in] name the name of the histogram.
+@param[in] value the value to record.
+*/
+#define METRICS_HISTOGRAM_RECORD(name,value) do{ \
+	static epl::MetricHistogram * volatile _metricHistogram=NULL; \
+	if(!_metricHistogram) \
+		_metricHistogram=METRICS_INSTANCE.GetHistogram(name); \
+	if(_metricHistogram) \
+		_metricHistogram->Record(value); \
+	}while(0)
+
+namespace epl
+{
+	class Stream;
+	class IpcClientInterface;
+
+	/// Enumeration for the Metric Type
+	enum MetricType{
+		/// the counter, which only adds up
+		METRIC_TYPE_COUNTER=0,
+		/// the gauge, which is set to the current value
+		METRIC_TYPE_GAUGE,
+		/// the histogram of the values recorded
+		METRIC_TYPE_HISTOGRAM,
+	};
+
+	/*! 
+	@class MetricCounter epMetrics.h
+	@brief A counter split into the shards on the different cache lines.
+
+	Each thread adds to the shard of its thread ID, so the threads adding at once rarely share a cache line,
+	and the value is the sum of the shards.
+	*/
+	class EP_LIBRARY MetricCounter
+	{
+	public:
+		friend class MetricsRegistry;
+
+		/*!
+		Add the given value to the counter.
+		@param[in] delta the value to add.
+		*/
+		void Add(__int64 delta=1)
+		{
+			InterlockedExchangeAdd64(&m_shards[(GetCurrentThreadId()>>2)&(METRICS_SHARD_COUNT-1)].m_value,delta);
+		}
+
+		/*!
+		Return the sum of the shards.
+		@return the value of the counter.
+		*/
+		__int64 GetValue() const;
+
+		/*!
+		Return the name of the counter.
+		@return the name registered.
+		*/
+		const TCHAR *GetName() const;
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] name the name of the counter.
+		*/
+		MetricCounter(const TCHAR *name);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MetricCounter(const MetricCounter & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MetricCounter &operator=(const MetricCounter & b){EP_ASSERT(0);return *this;}
+
+		/*! 
+		@struct MetricShard epMetrics.h
+		@brief A part of the counter on its own cache line.
+		*/
+		struct MetricShard
+		{
+			/// the value added to this shard
+			volatile __int64 m_value;
+			/// padding to keep the shards on the different cache lines
+			char m_padding[METRICS_CACHE_LINE_SIZE];
+		};
+
+		/// the shards
+		MetricShard m_shards[METRICS_SHARD_COUNT];
+		/// the name of the counter
+		EpTString m_name;
+	};
+
+	/*! 
+	@class MetricGauge epMetrics.h
+	@brief A gauge holding the current value on its own cache line.
+	*/
+	class EP_LIBRARY MetricGauge
+	{
+	public:
+		friend class MetricsRegistry;
+
+		/*!
+		Set the current value.
+		@param[in] value the value to set.
+		*/
+		void Set(__int64 value)
+		{
+			InterlockedExchange64(&m_value,value);
+		}
+
+		/*!
+		Add the given value to the current value.
+		@param[in] delta the value to add. (negative to subtract)
+		*/
+		void Add(__int64 delta)
+		{
+			InterlockedExchangeAdd64(&m_value,delta);
+		}
+
+		/*!
+		Return the current value.
+		@return the current value.
+		*/
+		__int64 GetValue() const;
+
+		/*!
+		Return the name of the gauge.
+		@return the name registered.
+		*/
+		const TCHAR *GetName() const;
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] name the name of the gauge.
+		*/
+		MetricGauge(const TCHAR *name);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MetricGauge(const MetricGauge & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MetricGauge &operator=(const MetricGauge & b){EP_ASSERT(0);return *this;}
+
+		/// padding to keep the value off the cache line of the other data
+		char m_headPadding[METRICS_CACHE_LINE_SIZE];
+		/// the current value
+		volatile __int64 m_value;
+		/// padding to keep the value off the cache line of the other data
+		char m_tailPadding[METRICS_CACHE_LINE_SIZE];
+		/// the name of the gauge
+		EpTString m_name;
+	};
+
+	/*! 
+	@class MetricHistogram epMetrics.h
+	@brief A histogram split into the LatencyHistogram shards recorded with the interlocked operations.
+
+	The shards are merged when the snapshot is taken.
+	*/
+	class EP_LIBRARY MetricHistogram
+	{
+	public:
+		friend class MetricsRegistry;
+
+		/*!
+		Record the value.
+		@param[in] value the value to record. (the negative value is recorded as 0)
+		*/
+		void Record(__int64 value)
+		{
+			m_shards[(GetCurrentThreadId()>>2)&(METRICS_HISTOGRAM_SHARD_COUNT-1)].m_histogram.RecordConcurrent(value);
+		}
+
+		/*!
+		Merge the shards into the given histogram.
+		@param[out] retHistogram the histogram to receive all the values recorded.
+		*/
+		void GetHistogram(LatencyHistogram &retHistogram) const;
+
+		/*!
+		Return the name of the histogram.
+		@return the name registered.
+		*/
+		const TCHAR *GetName() const;
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] name the name of the histogram.
+		*/
+		MetricHistogram(const TCHAR *name);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MetricHistogram(const MetricHistogram & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MetricHistogram &operator=(const MetricHistogram & b){EP_ASSERT(0);return *this;}
+
+		/*! 
+		@struct MetricHistogramShard epMetrics.h
+		@brief A part of the histogram apart from the other parts.
+		*/
+		struct MetricHistogramShard
+		{
+			/// the values recorded to this shard
+			LatencyHistogram m_histogram;
+			/// padding to keep the shards on the different cache lines
+			char m_padding[METRICS_CACHE_LINE_SIZE];
+		};
+
+		/// the shards
+		MetricHistogramShard m_shards[METRICS_HISTOGRAM_SHARD_COUNT];
+		/// the name of the histogram
+		EpTString m_name;
+	};
+
+	/*! 
+	@struct MetricSample epMetrics.h
+	@brief The value of a metric when the snapshot is taken.
+
+	The delta and the percentiles are of the interval since the last snapshot.
+	*/
+	struct EP_LIBRARY MetricSample
+	{
+		/// the name of the metric
+		EpTString name;
+		/// the type of the metric
+		MetricType type;
+		/// the counter value, the gauge value, or the number of the values recorded to the histogram
+		__int64 value;
+		/// the change of the value since the last snapshot
+		__int64 delta;
+		/// the maximum value recorded to the histogram ever
+		__int64 maxValue;
+		/// the median of the interval
+		__int64 p50;
+		/// the 90th percentile of the interval
+		__int64 p90;
+		/// the 99th percentile of the interval
+		__int64 p99;
+		/// the 99.9th percentile of the interval
+		__int64 p999;
+
+		/*!
+		Default Constructor
+
+		Initializes all values to zero
+		*/
+		MetricSample();
+	};
+
+	/*! 
+	@struct MetricsSnapshot epMetrics.h
+	@brief The values of all the metrics registered at a point in time.
+	*/
+	struct EP_LIBRARY MetricsSnapshot
+	{
+		/// the tick count in milliseconds when the snapshot is taken
+		unsigned int tickCount;
+		/// the length of the interval since the last snapshot in milliseconds
+		unsigned int interval;
+		/// the samples in the order the metrics were registered
+		std::vector<MetricSample> samples;
+
+		/*!
+		Default Constructor
+
+		Initializes the empty snapshot
+		*/
+		MetricsSnapshot();
+
+		/*!
+		Write the snapshot to the given stream.
+		@param[in] stream the stream to write.
+		@return true if successful, otherwise false.
+		*/
+		bool Serialize(Stream &stream) const;
+
+		/*!
+		Read the snapshot written by Serialize from the given stream.
+		@param[in] stream the stream to read.
+		@return true if successful, otherwise false.
+		*/
+		bool Deserialize(Stream &stream);
+	};
+
+	/*! 
+	@class MetricsExporterInterface epMetrics.h
+	@brief An interface for the object which receives every snapshot the registry flushes.
+	*/
+	class EP_LIBRARY MetricsExporterInterface
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~MetricsExporterInterface(){}
+
+		/*!
+		Receive the snapshot flushed.
+		@param[in] snapshot the snapshot taken.
+		@remark called from the thread calling FlushToFile, which is the flush thread if started.
+		*/
+		virtual void OnMetricsSnapshot(const MetricsSnapshot &snapshot)=0;
+	};
+
+	/*! 
+	@class MetricsIpcExporter epMetrics.h
+	@brief An exporter writing each snapshot serialized to the IPC client as one message.
+	*/
+	class EP_LIBRARY MetricsIpcExporter:public MetricsExporterInterface
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] client the client connected to the metrics collector.
+		@remark the client must outlive this exporter.
+		*/
+		MetricsIpcExporter(IpcClientInterface *client);
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~MetricsIpcExporter();
+
+		/*!
+		Write the snapshot to the client.
+		@param[in] snapshot the snapshot taken.
+		@remark the snapshot is dropped if the client is not connected, or it is larger than the maximum write size.
+		*/
+		virtual void OnMetricsSnapshot(const MetricsSnapshot &snapshot);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MetricsIpcExporter(const MetricsIpcExporter & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MetricsIpcExporter &operator=(const MetricsIpcExporter & b){EP_ASSERT(0);return *this;}
+
+		/// the client to write
+		IpcClientInterface *m_client;
+	};
+
+	/*! 
+	@class MetricsRegistry epMetrics.h
+	@brief A class that keeps the metrics registered by name, and reports their snapshots.
+
+	The metric is registered once and kept until the registry is destroyed,
+	so the pointer returned can be cached and updated without the lock.
+	FlushToFile takes the snapshot, writes it to the file and passes it to the exporters,
+	and StartFlushThread takes the snapshots periodically.
+	*/
+	class EP_LIBRARY MetricsRegistry:public BaseOutputter
+	{
+	public:
+		friend class SingletonHolder<MetricsRegistry>;
+
+		/*!
+		Return the counter of the given name, registering it if not registered.
+		@param[in] name the name of the counter.
+		@return the counter, or NULL if the name is registered with the other type.
+		*/
+		MetricCounter *GetCounter(const TCHAR *name);
+
+		/*!
+		Return the gauge of the given name, registering it if not registered.
+		@param[in] name the name of the gauge.
+		@return the gauge, or NULL if the name is registered with the other type.
+		*/
+		MetricGauge *GetGauge(const TCHAR *name);
+
+		/*!
+		Return the histogram of the given name, registering it if not registered.
+		@param[in] name the name of the histogram.
+		@return the histogram, or NULL if the name is registered with the other type.
+		*/
+		MetricHistogram *GetHistogram(const TCHAR *name);
+
+		/*!
+		Take the snapshot of all the metrics, and start the next interval.
+		@param[out] retSnapshot the snapshot to receive the values.
+		*/
+		void TakeSnapshot(MetricsSnapshot &retSnapshot);
+
+		/*!
+		Add the exporter which receives every snapshot flushed.
+		@param[in] exporter the exporter to add.
+		@remark the exporter must be removed before it is destroyed.
+		*/
+		void AddExporter(MetricsExporterInterface *exporter);
+
+		/*!
+		Remove the given exporter.
+		@param[in] exporter the exporter to remove.
+		@remark the exporter is not called after this returns.
+		*/
+		void RemoveExporter(MetricsExporterInterface *exporter);
+
+		/*!
+		Take the snapshot, write it to the file, and pass it to the exporters.
+		*/
+		virtual void FlushToFile();
+
+		/*!
+		Start the interval of all the metrics from now.
+		@remark the metrics are kept, since their pointers may be cached.
+		*/
+		virtual void Clear();
+
+	private:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType The lock policy
+		*/
+		MetricsRegistry(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MetricsRegistry(const MetricsRegistry& b):BaseOutputter(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MetricsRegistry & operator=(const MetricsRegistry&b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~MetricsRegistry();
+
+		/*! 
+		@class MetricNode epMetrics.h
+		@brief A class to keep one registered metric and its value at the last snapshot.
+		*/
+		class EP_LIBRARY MetricNode:public BaseOutputter::OutputNode
+		{
+		public:
+			friend class MetricsRegistry;
+
+			/*!
+			Default Constructor
+			@param[in] name the name of the metric.
+			@param[in] type the type of the metric.
+			*/
+			MetricNode(const TCHAR *name, MetricType type);
+
+			/*!
+			Default Destructor
+			*/
+			virtual ~MetricNode();
+
+			/*!
+			It prints the data in format,
+			*/
+			virtual void Print() const;
+
+			/*!
+			Write the data to file in format,
+			@param[in] file the file to output the data.
+			*/
+			virtual void Write(EpFile* const file);
+
+		private:
+			/*!
+			Read the current value of the metric.
+			@param[out] retSample the sample to receive the value.
+			@param[in] isAdvancing true to start the next interval from the value read.
+			*/
+			void sample(MetricSample &retSample, bool isAdvancing);
+
+			/// the type of the metric
+			MetricType m_type;
+			/// the counter, if the type is the counter
+			MetricCounter *m_counter;
+			/// the gauge, if the type is the gauge
+			MetricGauge *m_gauge;
+			/// the histogram, if the type is the histogram
+			MetricHistogram *m_histogram;
+			/// the value at the last snapshot
+			__int64 m_lastValue;
+			/// the histogram at the last snapshot, if the type is the histogram
+			LatencyHistogram *m_lastHistogram;
+		};
+
+		/*!
+		Return the node of the given name, registering it if not registered.
+		@param[in] name the name of the metric.
+		@param[in] type the type of the metric.
+		@return the node, or NULL if the name is registered with the other type.
+		*/
+		MetricNode *getNode(const TCHAR *name, MetricType type);
+
+		/*!
+		Format the sample into given string.
+		@param[in] sample the sample to format.
+		@param[out] retString the formatted string.
+		*/
+		static void formatSample(const MetricSample &sample, EpTString &retString);
+
+		/// the nodes by the name
+		std::map<EpTString,MetricNode*> m_nodeMap;
+		/// the exporters
+		std::vector<MetricsExporterInterface*> m_exporterList;
+		/// the tick count of the last snapshot
+		unsigned int m_lastSnapshotTick;
+	};
+}
+
+#endif //__EP_METRICS_H__
@@ -148,6 +148,17 @@ namespace epl
 		*/
 		virtual bool read(void *value,size_t byteSize);
 
+		/*!
+		Return the read seek offset.
+		@return the reference to the read seek offset.
+		*/
+		virtual size_t &readOffset();
+
+		/*!
+		Erase up to the read seek offset without taking the lock.
+		*/
+		void flush();
+
 		/// Network Stream Flush Type
 		NetworkStreamFlushType m_flushType;
 		/// Read Seek Offset
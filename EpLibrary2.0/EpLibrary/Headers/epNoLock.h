@@ -83,14 +83,20 @@ namespace epl
 		Locks the NoLock
 		@return true if locked, false otherwise
 		*/
-		virtual bool Lock();
+		virtual bool Lock()
+		{
+			return true;
+		}
 
 		/*!
 		Try to Lock the NoLock
 
 		@return true always.
 		*/
-		virtual long TryLock();
+		virtual long TryLock()
+		{
+			return 1;
+		}
 
 		/*!
 		Locks the Critical Section
@@ -98,14 +104,19 @@ namespace epl
 		@param[in] dwMilliSecond the wait time.
 		@return true always.
 		*/
-		virtual long TryLockFor(const unsigned int dwMilliSecond);
+		virtual long TryLockFor(const unsigned int dwMilliSecond)
+		{
+			return 1;
+		}
 
 		/*!
 		Leave the Critical Section
 
 		The Lock and Unlock has to be matched for each NoLock.
 		*/
-		virtual void Unlock();
+		virtual void Unlock()
+		{
+		}
 
 	};
 
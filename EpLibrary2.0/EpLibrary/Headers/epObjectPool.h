@@ -0,0 +1,499 @@
+/*! 
+@file epObjectPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Object Pool Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Fixed-Size Object Pool Template Class.
+
+*/
+#ifndef __EP_OBJECT_POOL_H__
+#define __EP_OBJECT_POOL_H__
+#include "epLib.h"
+#include <new>
+#include "epSystem.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+/// the default number of objects in a slab of the object pool
+#define OBJECT_POOL_DEFAULT_SLAB_OBJECT_COUNT 64
+
+namespace epl
+{
+	/*! 
+	@class ObjectPool epObjectPool.h
+	@brief A template class for Fixed-Size Object Pool.
+
+	The objects are carved from the pre-allocated slabs, and the released objects are kept in the lock-free free list,
+	so Acquire and Release take no lock unless a new slab is needed.
+	If constructing on acquire, the object is constructed by Acquire and destroyed by Release.
+	Otherwise the objects are constructed once when the slab is allocated, and recycled as they are.
+	*/
+	template <typename DataType>
+	class ObjectPool
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the pool
+		@param[in] slabObjectCount the number of objects in a slab.
+		@param[in] isConstructOnAcquire the flag whether to construct the object on acquire and destroy on release.
+		@param[in] shrinkThreshold the number of free objects to trigger Shrink on release. (0 means never shrink automatically)
+		@param[in] lockPolicyType The lock policy for the slab list
+		*/
+		ObjectPool(unsigned int slabObjectCount=OBJECT_POOL_DEFAULT_SLAB_OBJECT_COUNT, bool isConstructOnAcquire=true, unsigned int shrinkThreshold=0, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Release all slabs
+		@remark all objects must be released before the pool is destroyed.
+		*/
+		virtual ~ObjectPool();
+
+		/*!
+		Acquire the object from the pool.
+		@return the object acquired.
+		*/
+		DataType *Acquire();
+
+		/*!
+		Acquire the object constructed from the given argument.
+		@param[in] arg1 The argument for the constructor of the object.
+		@return the object acquired.
+		@remark only for the pool constructing on acquire.
+		*/
+		template <typename Arg1>
+		DataType *Acquire(Arg1 const &arg1);
+
+		/*!
+		Acquire the object constructed from the given arguments.
+		@param[in] arg1 The first argument for the constructor of the object.
+		@param[in] arg2 The second argument for the constructor of the object.
+		@return the object acquired.
+		@remark only for the pool constructing on acquire.
+		*/
+		template <typename Arg1, typename Arg2>
+		DataType *Acquire(Arg1 const &arg1, Arg2 const &arg2);
+
+		/*!
+		Release the given object to the pool.
+		@param[in] obj the object acquired from this pool.
+		*/
+		void Release(DataType *obj);
+
+		/*!
+		Free the slabs all of whose objects are in the free list.
+		@return the number of slabs freed.
+		*/
+		unsigned int Shrink();
+
+		/*!
+		Return the number of objects in the free list.
+		@return the number of free objects.
+		*/
+		size_t GetFreeCount() const;
+
+		/*!
+		Return the number of objects in all slabs.
+		@return the number of objects held by the pool.
+		*/
+		size_t GetTotalCount() const;
+
+		/*!
+		Return the flag whether the object is constructed on acquire.
+		@return true if the object is constructed on acquire, otherwise false.
+		*/
+		bool IsConstructOnAcquire() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ObjectPool(const ObjectPool & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ObjectPool &operator=(const ObjectPool & b){EP_ASSERT(0);return *this;}
+
+		struct Slab;
+
+		/// Slot Header in front of each object
+		struct Slot
+		{
+			/// the entry of the free list
+			SLIST_ENTRY m_entry;
+			/// the slab owning this slot
+			Slab *m_slab;
+		};
+
+		/// Slab Header
+		struct Slab
+		{
+			/// the next slab
+			Slab *m_next;
+			/// the memory allocated for this slab
+			void *m_memory;
+			/// the number of free slots counted by Shrink
+			unsigned int m_freeCount;
+		};
+
+		/*!
+		Pop the free slot, allocating the new slab if the free list is empty.
+		@return the slot popped.
+		*/
+		Slot *acquireSlot();
+
+		/*!
+		Push the given slot to the free list.
+		@param[in] slot the slot to push.
+		*/
+		void releaseSlot(Slot *slot);
+
+		/*!
+		Allocate the new slab and push its slots except the one returned.
+		@return the slot of the new slab not pushed.
+		*/
+		Slot *allocateSlab();
+
+		/*!
+		Free the given slab.
+		@param[in] slab the slab to free.
+		*/
+		void freeSlab(Slab *slab);
+
+		/*!
+		Return the slot of given index in the given slab.
+		@param[in] slab the slab.
+		@param[in] slotIdx the index of the slot.
+		@return the slot of given index.
+		*/
+		Slot *slotAt(Slab *slab, unsigned int slotIdx) const;
+
+		/*!
+		Return the object of the given slot.
+		@param[in] slot the slot.
+		@return the object of the slot.
+		*/
+		DataType *objectOf(Slot *slot) const;
+
+		/*!
+		Return the slot of the given object.
+		@param[in] obj the object.
+		@return the slot of the object.
+		*/
+		Slot *slotOf(DataType *obj) const;
+
+		/// the lock-free free list
+		PSLIST_HEADER m_freeList;
+		/// the slabs allocated
+		Slab *m_slabs;
+		/// the number of objects in a slab
+		unsigned int m_slabObjectCount;
+		/// the alignment of the slab and the slot
+		size_t m_alignment;
+		/// the size of the slab header
+		size_t m_slabHeaderSize;
+		/// the offset of the object from the slot
+		size_t m_objectOffset;
+		/// the size of the slot
+		size_t m_slotSize;
+		/// the number of objects in all slabs
+		volatile long m_totalCount;
+		/// the number of objects in the free list
+		volatile long m_freeCount;
+		/// the number of free objects to trigger Shrink
+		unsigned int m_shrinkThreshold;
+		/// the flag whether Shrink is running
+		volatile long m_isShrinking;
+		/// the flag whether to construct the object on acquire
+		bool m_isConstructOnAcquire;
+		/// slab lock
+		BaseLock *m_slabLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	template <typename DataType>
+	ObjectPool<DataType>::ObjectPool(unsigned int slabObjectCount, bool isConstructOnAcquire, unsigned int shrinkThreshold, LockPolicy lockPolicyType)
+	{
+		EP_ASSERT_EXPR(slabObjectCount>0,_T("The slab object count must be greater than 0."));
+		m_alignment=MEMORY_ALLOCATION_ALIGNMENT;
+		if(__alignof(DataType)>m_alignment)
+			m_alignment=__alignof(DataType);
+		m_slabHeaderSize=(sizeof(Slab)+m_alignment-1)&~(m_alignment-1);
+		m_objectOffset=(sizeof(Slot)+m_alignment-1)&~(m_alignment-1);
+		m_slotSize=(m_objectOffset+sizeof(DataType)+m_alignment-1)&~(m_alignment-1);
+		m_slabObjectCount=slabObjectCount;
+		m_isConstructOnAcquire=isConstructOnAcquire;
+		m_shrinkThreshold=shrinkThreshold;
+		m_isShrinking=0;
+		m_totalCount=0;
+		m_freeCount=0;
+		m_slabs=NULL;
+		m_freeList=reinterpret_cast<PSLIST_HEADER>(_aligned_malloc(sizeof(SLIST_HEADER),MEMORY_ALLOCATION_ALIGNMENT));
+		EP_ASSERT(m_freeList);
+		InitializeSListHead(m_freeList);
+
+		m_lockPolicy=lockPolicyType;
+		switch(lockPolicyType)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			m_slabLock=EP_NEW CriticalSectionEx();
+			break;
+		case LOCK_POLICY_MUTEX:
+			m_slabLock=EP_NEW Mutex();
+			break;
+		case LOCK_POLICY_NONE:
+			m_slabLock=EP_NEW NoLock();
+			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_slabLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_slabLock=EP_NEW ReaderWriterLock();
+			break;
+		default:
+			m_slabLock=NULL;
+			break;
+		}
+	}
+
+	template <typename DataType>
+	ObjectPool<DataType>::~ObjectPool()
+	{
+		EP_ASSERT_EXPR(m_freeCount==m_totalCount,_T("The objects are not released to the pool."));
+		InterlockedFlushSList(m_freeList);
+		while(m_slabs)
+		{
+			Slab *slab=m_slabs;
+			m_slabs=slab->m_next;
+			freeSlab(slab);
+		}
+		_aligned_free(m_freeList);
+		if(m_slabLock)
+			EP_DELETE m_slabLock;
+	}
+
+	template <typename DataType>
+	DataType *ObjectPool<DataType>::Acquire()
+	{
+		Slot *slot=acquireSlot();
+		if(!m_isConstructOnAcquire)
+			return objectOf(slot);
+		return ::new(objectOf(slot)) DataType();
+	}
+
+	template <typename DataType>
+	template <typename Arg1>
+	DataType *ObjectPool<DataType>::Acquire(Arg1 const &arg1)
+	{
+		EP_ASSERT_EXPR(m_isConstructOnAcquire,_T("The pool does not construct on acquire."));
+		return ::new(objectOf(acquireSlot())) DataType(arg1);
+	}
+
+	template <typename DataType>
+	template <typename Arg1, typename Arg2>
+	DataType *ObjectPool<DataType>::Acquire(Arg1 const &arg1, Arg2 const &arg2)
+	{
+		EP_ASSERT_EXPR(m_isConstructOnAcquire,_T("The pool does not construct on acquire."));
+		return ::new(objectOf(acquireSlot())) DataType(arg1,arg2);
+	}
+
+	template <typename DataType>
+	void ObjectPool<DataType>::Release(DataType *obj)
+	{
+		if(!obj)
+			return;
+		if(m_isConstructOnAcquire)
+			obj->~DataType();
+		releaseSlot(slotOf(obj));
+		if(m_shrinkThreshold && GetFreeCount()>m_shrinkThreshold)
+			Shrink();
+	}
+
+	template <typename DataType>
+	unsigned int ObjectPool<DataType>::Shrink()
+	{
+		// only one thread shrinks at a time, and the others skip
+		if(InterlockedCompareExchange(&m_isShrinking,1,0)!=0)
+			return 0;
+		LockObj lock(m_slabLock);
+		Slab *slabTrav;
+		for(slabTrav=m_slabs;slabTrav;slabTrav=slabTrav->m_next)
+			slabTrav->m_freeCount=0;
+
+		// the slots flushed stay counted as free, since they are pushed back or freed with the slab
+		PSLIST_ENTRY freeEntries=InterlockedFlushSList(m_freeList);
+		PSLIST_ENTRY entryTrav;
+		for(entryTrav=freeEntries;entryTrav;entryTrav=entryTrav->Next)
+			reinterpret_cast<Slot*>(entryTrav)->m_slab->m_freeCount++;
+
+		// return the slots of the slabs in use
+		entryTrav=freeEntries;
+		while(entryTrav)
+		{
+			PSLIST_ENTRY nextEntry=entryTrav->Next;
+			if(reinterpret_cast<Slot*>(entryTrav)->m_slab->m_freeCount!=m_slabObjectCount)
+				InterlockedPushEntrySList(m_freeList,entryTrav);
+			entryTrav=nextEntry;
+		}
+
+		unsigned int retCount=0;
+		Slab **slabLink=&m_slabs;
+		while(*slabLink)
+		{
+			Slab *slab=*slabLink;
+			if(slab->m_freeCount==m_slabObjectCount)
+			{
+				*slabLink=slab->m_next;
+				InterlockedExchangeAdd(&m_freeCount,-static_cast<long>(m_slabObjectCount));
+				freeSlab(slab);
+				retCount++;
+			}
+			else
+				slabLink=&slab->m_next;
+		}
+		InterlockedExchange(&m_isShrinking,0);
+		return retCount;
+	}
+
+	template <typename DataType>
+	size_t ObjectPool<DataType>::GetFreeCount() const
+	{
+		long freeCount=m_freeCount;
+		if(freeCount<0)
+			return 0;
+		return static_cast<size_t>(freeCount);
+	}
+
+	template <typename DataType>
+	size_t ObjectPool<DataType>::GetTotalCount() const
+	{
+		return static_cast<size_t>(m_totalCount);
+	}
+
+	template <typename DataType>
+	bool ObjectPool<DataType>::IsConstructOnAcquire() const
+	{
+		return m_isConstructOnAcquire;
+	}
+
+	template <typename DataType>
+	typename ObjectPool<DataType>::Slot *ObjectPool<DataType>::acquireSlot()
+	{
+		PSLIST_ENTRY entry=InterlockedPopEntrySList(m_freeList);
+		if(!entry)
+		{
+			LockObj lock(m_slabLock);
+			// other thread may have allocated the slab while waiting
+			entry=InterlockedPopEntrySList(m_freeList);
+			if(!entry)
+				return allocateSlab();
+		}
+		InterlockedDecrement(&m_freeCount);
+		return reinterpret_cast<Slot*>(entry);
+	}
+
+	template <typename DataType>
+	void ObjectPool<DataType>::releaseSlot(Slot *slot)
+	{
+		InterlockedPushEntrySList(m_freeList,&slot->m_entry);
+		InterlockedIncrement(&m_freeCount);
+	}
+
+	template <typename DataType>
+	typename ObjectPool<DataType>::Slot *ObjectPool<DataType>::allocateSlab()
+	{
+		void *memory=EP_Malloc(m_alignment+m_slabHeaderSize+m_slotSize*m_slabObjectCount);
+		EP_ASSERT_EXPR(memory,_T("Allocation Failed"));
+		size_t slabAddr=(reinterpret_cast<size_t>(memory)+m_alignment-1)&~(m_alignment-1);
+		Slab *slab=reinterpret_cast<Slab*>(slabAddr);
+		slab->m_memory=memory;
+		slab->m_freeCount=0;
+		for(unsigned int slotTrav=0;slotTrav<m_slabObjectCount;slotTrav++)
+		{
+			Slot *slot=slotAt(slab,slotTrav);
+			slot->m_slab=slab;
+			if(!m_isConstructOnAcquire)
+				::new(objectOf(slot)) DataType();
+		}
+		for(unsigned int slotTrav=1;slotTrav<m_slabObjectCount;slotTrav++)
+			releaseSlot(slotAt(slab,slotTrav));
+		slab->m_next=m_slabs;
+		m_slabs=slab;
+		InterlockedExchangeAdd(&m_totalCount,static_cast<long>(m_slabObjectCount));
+		return slotAt(slab,0);
+	}
+
+	template <typename DataType>
+	void ObjectPool<DataType>::freeSlab(Slab *slab)
+	{
+		if(!m_isConstructOnAcquire)
+		{
+			for(unsigned int slotTrav=0;slotTrav<m_slabObjectCount;slotTrav++)
+				objectOf(slotAt(slab,slotTrav))->~DataType();
+		}
+		InterlockedExchangeAdd(&m_totalCount,-static_cast<long>(m_slabObjectCount));
+		EP_Free(slab->m_memory);
+	}
+
+	template <typename DataType>
+	typename ObjectPool<DataType>::Slot *ObjectPool<DataType>::slotAt(Slab *slab, unsigned int slotIdx) const
+	{
+		return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(slab)+m_slabHeaderSize+m_slotSize*slotIdx);
+	}
+
+	template <typename DataType>
+	DataType *ObjectPool<DataType>::objectOf(Slot *slot) const
+	{
+		return reinterpret_cast<DataType*>(reinterpret_cast<unsigned char*>(slot)+m_objectOffset);
+	}
+
+	template <typename DataType>
+	typename ObjectPool<DataType>::Slot *ObjectPool<DataType>::slotOf(DataType *obj) const
+	{
+		return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(obj)-m_objectOffset);
+	}
+}
+
+#endif //__EP_OBJECT_POOL_H__
\ No newline at end of file
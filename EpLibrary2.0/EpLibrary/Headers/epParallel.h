@@ -0,0 +1,293 @@
+/*! 
+@file epParallel.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Parallel Loop Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Parallel-For and Parallel-Reduce Functions.
+
+*/
+#ifndef __EP_PARALLEL_H__
+#define __EP_PARALLEL_H__
+#include "epLib.h"
+#include <vector>
+#include "epSmartObject.h"
+#include "epEventEx.h"
+#include "epThreadPool.h"
+
+namespace epl
+{
+	/*! 
+	@class ParallelContext epParallel.h
+	@brief A base class for the range split across the thread pool.
+
+	The range is cut into the chunks of the grain size, and the caller and the helper jobs in the pool
+	claim the next chunk one by one, so the faster participant simply takes more chunks.
+	The caller runs the chunks too, so it never waits for the helper which has not started yet,
+	and the nested parallel loop within the pool worker does not deadlock.
+	*/
+	class EP_LIBRARY ParallelContext: public SmartObject
+	{
+	public:
+		friend class ParallelJobProcessor;
+
+		/*!
+		Default Constructor
+
+		Initializes the context
+		@param[in] begin the first index of the range.
+		@param[in] end the index after the last of the range.
+		@param[in] grain the number of indices per chunk. (0 is treated as 1)
+		@param[in] lockPolicyType The lock policy
+		*/
+		ParallelContext(size_t begin, size_t end, size_t grain, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the context
+		*/
+		virtual ~ParallelContext();
+
+		/*!
+		Process all chunks with the given pool, and wait until all chunks are finished.
+		@param[in] pool the thread pool to help. (NULL to run all chunks on the calling thread)
+		*/
+		void Run(ThreadPool *pool);
+
+		/*!
+		Return the number of chunks.
+		@return the number of chunks.
+		*/
+		size_t GetChunkCount() const;
+
+		/*!
+		Return the grain size for the given range.
+		@param[in] pool the thread pool to split the range across.
+		@param[in] begin the first index of the range.
+		@param[in] end the index after the last of the range.
+		@param[in] grain the grain size requested. (0 to pick about 4 chunks per participant)
+		@return the grain size to use.
+		*/
+		static size_t GetGrainSize(ThreadPool *pool, size_t begin, size_t end, size_t grain);
+
+	protected:
+		/*!
+		Process the given chunk, subclasses must implement this function.
+		@param[in] chunkIdx the index of the chunk.
+		@param[in] chunkBegin the first index of the chunk.
+		@param[in] chunkEnd the index after the last of the chunk.
+		@remark this is called concurrently from the caller and the pool workers.
+		*/
+		virtual void processChunk(size_t chunkIdx, size_t chunkBegin, size_t chunkEnd)=0;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ParallelContext(const ParallelContext & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ParallelContext &operator=(const ParallelContext & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Claim and process the chunks until none is left.
+		*/
+		void runChunks();
+
+		/// the first index of the range
+		size_t m_begin;
+		/// the index after the last of the range
+		size_t m_end;
+		/// the number of indices per chunk
+		size_t m_grain;
+		/// the number of chunks
+		size_t m_chunkCount;
+		/// the index of the next chunk to claim, 64-bit so it holds any chunk count of size_t
+		volatile __int64 m_nextChunk;
+		/// the number of chunks finished
+		volatile __int64 m_doneChunkCount;
+		/// the event raised when all chunks are finished
+		EventEx m_doneEvent;
+	};
+
+	/*! 
+	@class ParallelForContext epParallel.h
+	@brief A template context which calls the functor for each chunk.
+	*/
+	template<typename Functor>
+	class ParallelForContext: public ParallelContext
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the context
+		@param[in] begin the first index of the range.
+		@param[in] end the index after the last of the range.
+		@param[in] grain the number of indices per chunk.
+		@param[in] func the functor to call as func(chunkBegin, chunkEnd).
+		*/
+		ParallelForContext(size_t begin, size_t end, size_t grain, const Functor &func):ParallelContext(begin,end,grain),m_func(func)
+		{
+		}
+
+	protected:
+		/*!
+		Call the functor for the given chunk.
+		@param[in] chunkIdx the index of the chunk.
+		@param[in] chunkBegin the first index of the chunk.
+		@param[in] chunkEnd the index after the last of the chunk.
+		*/
+		virtual void processChunk(size_t chunkIdx, size_t chunkBegin, size_t chunkEnd)
+		{
+			m_func(chunkBegin,chunkEnd);
+		}
+
+	private:
+		/// the functor
+		Functor m_func;
+	};
+
+	/*! 
+	@class ParallelReduceContext epParallel.h
+	@brief A template context which keeps the partial result of each chunk.
+	*/
+	template<typename T, typename Functor>
+	class ParallelReduceContext: public ParallelContext
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the context
+		@param[in] begin the first index of the range.
+		@param[in] end the index after the last of the range.
+		@param[in] grain the number of indices per chunk.
+		@param[in] identity the initial value of each partial result.
+		@param[in] func the functor to call as func(chunkBegin, chunkEnd), which returns the partial result.
+		*/
+		ParallelReduceContext(size_t begin, size_t end, size_t grain, const T &identity, const Functor &func):ParallelContext(begin,end,grain),m_func(func)
+		{
+			m_results.resize(GetChunkCount(),identity);
+		}
+
+		/*!
+		Return the partial result of the given chunk.
+		@param[in] chunkIdx the index of the chunk.
+		@return the partial result of the chunk.
+		*/
+		const T &GetResult(size_t chunkIdx) const
+		{
+			return m_results[chunkIdx];
+		}
+
+	protected:
+		/*!
+		Call the functor for the given chunk, and keep its result.
+		@param[in] chunkIdx the index of the chunk.
+		@param[in] chunkBegin the first index of the chunk.
+		@param[in] chunkEnd the index after the last of the chunk.
+		*/
+		virtual void processChunk(size_t chunkIdx, size_t chunkBegin, size_t chunkEnd)
+		{
+			m_results[chunkIdx]=m_func(chunkBegin,chunkEnd);
+		}
+
+	private:
+		/// the functor
+		Functor m_func;
+		/// the partial result of each chunk
+		std::vector<T> m_results;
+	};
+
+	/*!
+	Template Parallel-For Function
+
+	Split the given range into chunks, and call func(chunkBegin, chunkEnd) for each chunk across the pool.
+	The calling thread works on the chunks too, and the function returns when all chunks are finished.
+	@param[in] pool the thread pool to help. (NULL to run on the calling thread only)
+	@param[in] begin the first index of the range.
+	@param[in] end the index after the last of the range.
+	@param[in] grain the number of indices per chunk. (0 to pick automatically)
+	@param[in] func the functor to call for each chunk, which must be safe to call concurrently.
+	*/
+	template<typename Functor>
+	void ParallelFor(ThreadPool *pool, size_t begin, size_t end, size_t grain, Functor func)
+	{
+		if(begin>=end)
+			return;
+		ParallelForContext<Functor> *context=EP_NEW ParallelForContext<Functor>(begin,end,ParallelContext::GetGrainSize(pool,begin,end,grain),func);
+		context->Run(pool);
+		context->ReleaseObj();
+	}
+
+	/*!
+	Template Parallel-Reduce Function
+
+	Split the given range into chunks, compute func(chunkBegin, chunkEnd) for each chunk across the pool,
+	and fold the partial results in the chunk order with combine(a, b).
+	The result is the same for every run, since the folding order does not depend on the scheduling.
+	@param[in] pool the thread pool to help. (NULL to run on the calling thread only)
+	@param[in] begin the first index of the range.
+	@param[in] end the index after the last of the range.
+	@param[in] grain the number of indices per chunk. (0 to pick automatically)
+	@param[in] identity the identity value of the combine.
+	@param[in] func the functor which returns the partial result of the chunk, and must be safe to call concurrently.
+	@param[in] combine the associative functor which combines two partial results.
+	@return the combined result, or identity if the range is empty.
+	*/
+	template<typename T, typename Functor, typename Combiner>
+	T ParallelReduce(ThreadPool *pool, size_t begin, size_t end, size_t grain, const T &identity, Functor func, Combiner combine)
+	{
+		if(begin>=end)
+			return identity;
+		ParallelReduceContext<T,Functor> *context=EP_NEW ParallelReduceContext<T,Functor>(begin,end,ParallelContext::GetGrainSize(pool,begin,end,grain),identity,func);
+		context->Run(pool);
+		T retVal=identity;
+		for(size_t chunkTrav=0;chunkTrav<context->GetChunkCount();chunkTrav++)
+		{
+			retVal=combine(retVal,context->GetResult(chunkTrav));
+		}
+		context->ReleaseObj();
+		return retVal;
+	}
+}
+
+#endif //__EP_PARALLEL_H__
\ No newline at end of file
@@ -0,0 +1,296 @@
+/*! 
+@file epPartialSort.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Partial Sort and Selection Algorithm Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Partial Sort, Nth Element Selection and Top-K Accumulator.
+
+*/
+#ifndef __EP_PARTIAL_SORT_H__
+#define __EP_PARTIAL_SORT_H__
+#include "epLib.h"
+#include "epQuickSort.h"
+#include "epKAryHeap.h"
+#include <algorithm>
+
+/// the ratio of the list size to the sort size, over which PartialSort selects with the heap instead of NthElement
+#define PSORT_HEAP_SELECT_RATIO 64
+
+namespace epl
+{
+	/*!
+	Template Nth Element Function
+
+	Rearrange the given list so that the nth item is the one which would be there if the list is sorted,
+	with no item before it greater and no item after it less than it.
+	@param[in] sortList The list to rearrange.
+	@param[in] listSize The size of the list.
+	@param[in] nth the index of the item to select.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark only the partition containing nth is partitioned again, so the selection costs O(n) on average.
+	@remark the partition depth is bounded by twice the log2 of the size, and the deeper range falls back to the heap sort.
+	*/
+	template<typename T,typename CompFuncType>
+	void NthElement(T* sortList, size_t listSize, size_t nth,CompFuncType SortFunc)
+	{
+		if(sortList==NULL || nth>=listSize)
+			return;
+		size_t low=0;
+		size_t high=listSize-1;
+		size_t depthLimit=quickSortDepthLimit(listSize);
+		while(high>low)
+		{
+			size_t rangeSize=(high-low)+1;
+			if(rangeSize<=QSORT_DEFAULT_MIN_SIZE)
+			{
+				InsertionSort<T>(sortList,low,high,SortFunc);
+				return;
+			}
+			if(depthLimit==0)
+			{
+				subHeapSort<T>(sortList,low,high,SortFunc);
+				return;
+			}
+			depthLimit--;
+			size_t lessIdx;
+			size_t greaterIdx;
+			partitionThreeWay<T>(sortList,low,high,lessIdx,greaterIdx,SortFunc);
+			if(nth<lessIdx)
+				high=lessIdx-1;
+			else if(nth>greaterIdx)
+				low=greaterIdx+1;
+			else
+				return;
+			if((high-low)+1>rangeSize-rangeSize/8)
+				breakPattern<T>(sortList,low,high);
+		}
+	}
+
+	/*!
+	Template Partial Sort Function
+
+	Sort the given number of the smallest items of the given list to the front of the list.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] sortSize the number of the smallest items to sort.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark the order of the items after sortSize is unspecified.
+	@remark the small sortSize selects with the bounded heap in O(n*log(sortSize)) and single pass,
+	otherwise the list is split with NthElement and only the front is sorted.
+	*/
+	template<typename T,typename CompFuncType>
+	void PartialSort(T* sortList, size_t listSize, size_t sortSize,CompFuncType SortFunc)
+	{
+		if(sortList==NULL || sortSize==0 || listSize<=1)
+			return;
+		if(sortSize>=listSize)
+		{
+			QuickSort<T>(sortList,listSize,SortFunc,QSORT_MODE_LOOP);
+			return;
+		}
+		if(sortSize<=listSize/PSORT_HEAP_SELECT_RATIO)
+		{
+			CompLess<T,CompFuncType> lessFunc(SortFunc);
+			std::make_heap(sortList,sortList+sortSize,lessFunc);
+			for(size_t trav=sortSize;trav<listSize;trav++)
+			{
+				if(SortFunc(&sortList[trav],&sortList[0])<COMP_RESULT_EQUAL)
+				{
+					std::pop_heap(sortList,sortList+sortSize,lessFunc);
+					SwapFunc<T>(&sortList[sortSize-1],&sortList[trav]);
+					std::push_heap(sortList,sortList+sortSize,lessFunc);
+				}
+			}
+			std::sort_heap(sortList,sortList+sortSize,lessFunc);
+			return;
+		}
+		NthElement<T>(sortList,listSize,sortSize-1,SortFunc);
+		QuickSort<T>(sortList,sortSize-1,SortFunc,QSORT_MODE_LOOP);
+	}
+
+	/*!
+	@class TopKCompClass epPartialSort.h
+	@brief A template Compare Class which reverses the given Compare Function.
+	*/
+	template <typename KeyType,CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)>
+	class TopKCompClass{
+	public:
+		/*!
+		Compares object b with object a
+
+		@param[in] a the pointer to the object.
+		@param[in] b the pointer to another object.
+		@return the Result of Comparison
+		*/
+		static CompResultType CompFunc(const void *a, const void *b)
+		{
+			return KeyCompareFunc(b,a);
+		}
+	};
+
+	/*!
+	@class TopK epPartialSort.h
+	@brief A template class which accumulates the given number of the smallest keys from the stream.
+
+	The keys kept are held in the bounded KAryHeap with the greatest key kept on top,
+	so each key pushed is compared once with the greatest and rejected in O(1) if not less.
+	The keys need not be unique.
+	*/
+	template <typename KeyType,typename DataType,CompResultType (__cdecl *KeyCompareFunc)(const void *,const void *)=CompClass<KeyType>::CompFunc >
+	class TopK
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the accumulator
+		@param[in] topCount the number of the smallest keys to keep.
+		@param[in] lockPolicyType The lock policy
+		*/
+		TopK(size_t topCount, LockPolicy lockPolicyType=EP_LOCK_POLICY):m_heap(KARY_HEAP_MODE_LOOP,lockPolicyType)
+		{
+			m_topCount=topCount;
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the accumulator with given accumulator
+		@param[in] b the TopK Object to copy from
+		*/
+		TopK(const TopK & b):m_heap(b.m_heap)
+		{
+			m_topCount=b.m_topCount;
+		}
+
+		/*!
+		Default Destructor
+
+		Destroys the accumulator
+		*/
+		virtual ~TopK()
+		{
+		}
+
+		/*!
+		Initialize this accumulator to given accumulator
+		@param[in] b the TopK Object to copy from
+		@return the new copied object
+		*/
+		TopK & operator=(const TopK & b)
+		{
+			if(this!=&b)
+			{
+				m_heap=b.m_heap;
+				m_topCount=b.m_topCount;
+			}
+			return *this;
+		}
+
+		/*!
+		Offer the key with given data to the accumulator
+		@param[in] key The key value to offer.
+		@param[in] data the data with the given key
+		@return true if the key is kept, otherwise false.
+		*/
+		bool Push(const KeyType &key, const DataType &data)
+		{
+			return m_heap.PushBounded(key,data,m_topCount);
+		}
+
+		/*!
+		Return the greatest key kept
+		@param[out] retKey the greatest key kept, which the key offered must be less than to be kept once full.
+		@param[out] retData the data of the greatest key kept.
+		@return true if any key is kept, otherwise false.
+		*/
+		bool Back(KeyType &retKey, DataType &retData) const
+		{
+			return m_heap.Front(retKey,retData);
+		}
+
+		/*!
+		Remove all keys kept in the ascending order
+		@param[out] retKeyList the list of at least Size() keys to receive the keys.
+		@param[out] retDataList the list of at least Size() data to receive the data. (NULL to ignore the data)
+		@return the number of the keys removed.
+		*/
+		size_t PopSorted(KeyType *retKeyList, DataType *retDataList)
+		{
+			size_t retCount=m_heap.Size();
+			KeyType key;
+			DataType data;
+			for(size_t trav=retCount;trav>0;trav--)
+			{
+				m_heap.Pop(key,data);
+				retKeyList[trav-1]=key;
+				if(retDataList)
+					retDataList[trav-1]=data;
+			}
+			return retCount;
+		}
+
+		/*!
+		Clear the accumulator
+		*/
+		void Clear()
+		{
+			m_heap.Clear();
+		}
+
+		/*!
+		Return the number of the keys kept.
+		@return the number of the keys kept.
+		*/
+		size_t Size() const
+		{
+			return m_heap.Size();
+		}
+
+		/*!
+		Return the number of the smallest keys to keep.
+		@return the number of the keys to keep.
+		*/
+		size_t GetTopCount() const
+		{
+			return m_topCount;
+		}
+
+	private:
+		/// the heap with the greatest key kept on top
+		KAryHeap<KeyType,DataType,5,TopKCompClass<KeyType,KeyCompareFunc>::CompFunc> m_heap;
+		/// the number of the smallest keys to keep
+		size_t m_topCount;
+	};
+}
+
+#endif //__EP_PARTIAL_SORT_H__
\ No newline at end of file
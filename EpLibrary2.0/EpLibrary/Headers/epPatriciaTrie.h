@@ -40,9 +40,24 @@ An Interface for Patricia Trie Template class.
 
 #include "epLib.h"
 #include "epBinarySearch.h"
+#include "epEpochReclaimer.h"
+#include "epStream.h"
 #include <vector>
 using namespace std;
 
+/// the number of children up to which the node searches its child keys linearly
+#define PATRICIA_TRIE_LINEAR_SEARCH_SIZE 16
+/// the number of children from which the node with byte-sized characters keeps the direct index table
+#define PATRICIA_TRIE_DIRECT_INDEX_SIZE 48
+/// the number of characters including the terminator the leaf stores inline
+#define PATRICIA_TRIE_INLINE_STRING_SIZE 16
+/// the magic number of the serialized Patricia Trie ('EPPT')
+#define PATRICIA_TRIE_MAPPED_MAGIC 0x54505045
+/// the version of the serialized Patricia Trie format
+#define PATRICIA_TRIE_MAPPED_VERSION 1
+/// the data index of the serialized node without data
+#define PATRICIA_TRIE_MAPPED_NO_DATA 0xFFFFFFFF
+
 namespace epl
 {
 	/// Enumeration Type for Patricia Trie Mode
@@ -50,12 +65,55 @@ namespace epl
 		/// Patricia Trie Mode using Recursive operation
 		PATRICIA_TRIE_MODE_RECURSIVE,
 		/// Patricia Trie Mode using Loop operation
-		PATRICIA_TRIE_MODE_LOOP
+		PATRICIA_TRIE_MODE_LOOP,
+		/// Patricia Trie Mode using Loop operation with lock-free readers and serialized writers
+		PATRICIA_TRIE_MODE_CONCURRENT
 	}PatriciaTrieMode;
 
+	/*! 
+	@struct PatriciaTrieMappedHeader epPatriciaTrie.h
+	@brief A header structure of the serialized Patricia Trie.
+
+	The header is followed by the data array, and then by the node records in breadth-first order.
+	Each node record is the child count, the data index, the sorted child characters padded to 4 bytes, 
+	and the offsets of the child records from the start of the buffer.
+	*/
+	struct PatriciaTrieMappedHeader
+	{
+		/// the magic number
+		unsigned int m_magic;
+		/// the format version
+		unsigned int m_version;
+		/// the size of the character type
+		unsigned int m_characterSize;
+		/// the size of the data type
+		unsigned int m_dataSize;
+		/// the number of strings
+		unsigned int m_stringCount;
+		/// the offset of the data array
+		unsigned int m_dataOffset;
+		/// the offset of the root record
+		unsigned int m_rootOffset;
+		/// the total size of the serialized trie
+		unsigned int m_totalSize;
+	};
+
 	/*! 
 	@class PatriciaTrie epPatriciaTrie.h
 	@brief A Patricia Trie Template class.
+
+	Each node keeps the characters of its children in a contiguous sorted key list parallel to the child list,
+	so finding a child touches only the key list instead of every child node.
+	The small node scans the key list linearly, and the large node uses the binary search.
+	When the character is byte-sized and compared by default, the node with many children 
+	also keeps the 256-entry direct index table.
+	The leaf stores the short string inline.
+
+	In PATRICIA_TRIE_MODE_CONCURRENT, Find, FindAll, Size and IsEmpty do not take the lock.
+	The writers are serialized by the lock, and never modify the nodes readers can see.
+	Instead a writer copies the path from the root to the node it changes, publishes the new root,
+	and retires the replaced nodes to the epoch reclaimer.
+	@remark in PATRICIA_TRIE_MODE_CONCURRENT, each reader thread must call UnregisterThread before it exits.
 	*/
 	template<typename CharacterType, typename DataType , CharacterType Terminator=(CharacterType)0, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)=CompClass<CharacterType>::CompFunc>
 	class PatriciaTrie
@@ -97,6 +155,7 @@ namespace epl
 		Return the reference to data with given string if not exist insert and return the reference to data
 		@param[in] str The string to return the reference to the data.
 		@return the reference to the data with given string.
+		@remark in PATRICIA_TRIE_MODE_CONCURRENT, writing through the reference races with the readers.
 		*/
 		DataType &operator[](const CharacterType * str);
 
@@ -104,6 +163,7 @@ namespace epl
 		Return the reference to data with given string and return the reference to data
 		@param[in] str The string to return the reference to the data.
 		@return the reference to the data with given string.
+		@remark in PATRICIA_TRIE_MODE_CONCURRENT, the reference is valid until the string is erased.
 		*/
 		const DataType &operator[](const CharacterType * str) const;
 
@@ -135,6 +195,8 @@ namespace epl
 		@param[in] str The string value to find
 		@param[out] retStrDataPairList the string and data pairs found
 		@return true if succeeded otherwise false
+		@remark the strings returned are valid until they are erased.
+		@remark use PrefixCursor to iterate the matches lazily without building the list.
 		*/
 		bool FindAll(const CharacterType* str, vector<Pair<const CharacterType*,DataType> > &retStrDataPairList) const;
 
@@ -155,6 +217,21 @@ namespace epl
 		@return the number of element in the trie
 		*/
 		size_t Size() const;
+
+		/*!
+		Write the trie to the given stream in the pointer-free layout, which MappedPatriciaTrie can query in place
+		@param[in] stream the stream to write to
+		@remark DataType is written byte by byte, so it must not hold pointers.
+		@remark the offsets are 32-bit, so the serialized trie must be smaller than 4GB.
+		@return true if succeeded otherwise false
+		*/
+		bool SaveToStream(Stream &stream) const;
+
+		/*!
+		Give back the reclaimer slot of the calling thread.
+		@remark only meaningful in PATRICIA_TRIE_MODE_CONCURRENT.
+		*/
+		void UnregisterThread();
 	protected:
 
 		/*! 
@@ -286,8 +363,12 @@ namespace epl
 		protected:
 			/// data of this node
 			DataType m_data;
-			/// string of this node
+			/// inline string of this node if the string is short
+			CharacterType m_inlineString[PATRICIA_TRIE_INLINE_STRING_SIZE];
+			/// string of this node if the string is too long for the inline string
 			vector<CharacterType> m_string;
+			/// flag whether the string is stored inline
+			bool m_isInline;
 			/// string terminator character holder
 			CharacterType m_terminator;
 		};
@@ -383,13 +464,178 @@ namespace epl
 			*/
 			const BasePatriciaTrieNode *operator[](const CharacterType &character) const;
 
+			/*!
+			Return the new node with the same character, sharing the children of this node
+			@return the pointer to the new node
+			*/
+			PatriciaTrieNode *CloneShallow() const;
+
+			/*!
+			Replace the child with the same character as the given node
+			@param[in] node the node to replace with
+			@remark the child replaced is not deleted.
+			@return true if succeeded otherwise false.
+			*/
+			bool ReplaceNode(BasePatriciaTrieNode *node);
+
+			/*!
+			Remove the child with given character without deleting it
+			@param[in] c the character of the child to remove
+			@remark if the child with the given character does not exists then return NULL.
+			@return the pointer to the child removed
+			*/
+			BasePatriciaTrieNode *DetachNode(CharacterType c);
+
+			/*!
+			Remove all children without deleting them
+			*/
+			void DetachAll();
+
 		protected:
+			/*!
+			Find the index of the child with given character
+			@param[in] character the character of the child to find
+			@param[out] retIdx the index of the child found, or the index to insert the child if not found
+			@return true if found otherwise false
+			*/
+			bool findIndex(const CharacterType &character, size_t &retIdx) const;
+
+			/*!
+			Insert the given child to the lists at given index
+			@param[in] idx the index to insert
+			@param[in] node the child to insert
+			*/
+			void insertChild(size_t idx, BasePatriciaTrieNode *node);
+
+			/*!
+			Remove the child at given index from the lists
+			@param[in] idx the index to remove
+			*/
+			void eraseChild(size_t idx);
+
+			/*!
+			Rebuild the direct index table if this node qualifies, otherwise drop the table
+			*/
+			void rebuildDirectIndex();
+
+			/*!
+			Delete all children and clear the lists
+			*/
+			void clearChildren();
+
+			/*!
+			Copy all children from given node
+			@param[in] b the node to copy the children from
+			*/
+			void copyChildren(const PatriciaTrieNode &b);
+
+			/*!
+			Return whether the direct index table can be used for this trie
+			@return true if the character is byte-sized and compared by default otherwise false
+			*/
+			static bool canDirectIndex()
+			{
+				return sizeof(CharacterType)==1 && CharCompareFunc==&CompClass<CharacterType>::CompFunc;
+			}
+
 			/// character list of this node
 			vector<BasePatriciaTrieNode*> m_charList;
+			/// sorted character keys of the children parallel to the character list
+			vector<CharacterType> m_keyList;
+			/// direct index table mapping the byte character to the child index plus one (NULL if not used)
+			unsigned short *m_directIndex;
 			/// string terminator character holder
 			CharacterType m_terminator;
 		};
 
+	public:
+		/*! 
+		@class PrefixCursor epPatriciaTrie.h
+		@brief A cursor class which iterates the strings starting with the given prefix in order.
+
+		The cursor walks the trie lazily, so no list of the matches is built.
+		@remark the trie is locked shared, or the epoch is entered in PATRICIA_TRIE_MODE_CONCURRENT, 
+		        from the construction to the destruction of the cursor.
+		        So the cursor must be destroyed on the thread created it, and the writers wait while the cursor lives
+		        unless the trie is in PATRICIA_TRIE_MODE_CONCURRENT.
+		*/
+		class PrefixCursor
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Initializes the cursor
+			@param[in] trie the trie to iterate
+			@param[in] prefix the prefix of the strings to iterate
+			@param[in] limit the maximum number of strings to iterate (0 means no limit)
+			*/
+			PrefixCursor(const PatriciaTrie &trie, const CharacterType *prefix, size_t limit=0);
+
+			/*!
+			Default Destructor
+
+			Destroys the cursor
+			*/
+			virtual ~PrefixCursor();
+
+			/*!
+			Move to the next string starting with the prefix
+			@param[out] retStr the next string
+			@param[out] retData the data with the next string
+			@remark the string returned is valid while this cursor lives.
+			@return true if the next string exists otherwise false
+			*/
+			bool Next(const CharacterType *&retStr, DataType &retData);
+
+			/*!
+			Return the number of strings iterated so far
+			@return the number of strings iterated
+			*/
+			size_t GetCount() const;
+
+		private:
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			PrefixCursor(const PrefixCursor & b):m_trie(b.m_trie){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			PrefixCursor &operator=(const PrefixCursor & b){EP_ASSERT(0);return *this;}
+
+			/*!
+			@struct CursorFrame epPatriciaTrie.h
+			@brief A structure for the node on the traversing path.
+			*/
+			struct CursorFrame
+			{
+				/// the node
+				const PatriciaTrieNode *node;
+				/// the index of the next child to visit
+				size_t childIdx;
+			};
+
+			/// the trie iterating
+			const PatriciaTrie &m_trie;
+			/// the traversing path, bounded by the depth of the trie
+			vector<CursorFrame> m_frameStack;
+			/// the maximum number of strings to iterate
+			size_t m_limit;
+			/// the number of strings iterated
+			size_t m_count;
+		};
+		friend class PrefixCursor;
+
+	protected:
+
 		/*!
 		Actually insert the string with given data to the trie by recursive
 		@param[in] root the root of the trie
@@ -489,6 +735,40 @@ namespace epl
 		*/
 		void traverseAllLoop(BasePatriciaTrieNode *root, vector<Pair<const CharacterType*,DataType> > &retStrDataPairList) const;
 
+		/*!
+		Actually insert the string with given data to the trie by copying the path
+		@param[in] str The string value to insert.
+		@param[in] data the data with the given string
+		@remark returns NULL if insertion fails
+		@return Pointer to the node inserted.
+		*/
+		PatriciaTrieLeaf *insertConcurrent(const CharacterType* str,const DataType &data);
+
+		/*!
+		Actually remove the given string from the trie by copying the path
+		@param[in] str The string value to erase.
+		@return true if succeeded otherwise false
+		*/
+		bool eraseConcurrent(const CharacterType* str);
+
+		/*!
+		Publish the given root, and retire the replaced nodes
+		@param[in] newRoot the new root to publish
+		@param[in] shellList the nodes replaced by the copies, whose children must not be deleted
+		*/
+		void publishRoot(PatriciaTrieNode *newRoot,const vector<PatriciaTrieNode*> &shellList);
+
+		/*!
+		Delete the given node replaced by its copy, without deleting its children
+		@param[in] ptr the node to delete
+		*/
+		static void reclaimShell(void *ptr)
+		{
+			PatriciaTrieNode *node=static_cast<PatriciaTrieNode*>(ptr);
+			node->DetachAll();
+			EP_DELETE node;
+		}
+
 
 
 
@@ -508,8 +788,8 @@ namespace epl
 		}
 
 
-		/// Root of the trie
-		PatriciaTrieNode* m_root;
+		/// Root of the trie (volatile, since readers load it without lock in concurrent mode)
+		PatriciaTrieNode* volatile m_root;
 		/// Total number of strings in the trie
 		size_t m_totalCount;             
 		/// String Terminator holder
@@ -520,6 +800,8 @@ namespace epl
 		LockPolicy m_lockPolicy;
 		/// Patricia Trie Mode
 		PatriciaTrieMode m_mode;
+		/// reclaimer for the nodes replaced in concurrent mode (NULL if not concurrent)
+		EpochReclaimer *m_reclaimer;
 
 	};
 
@@ -534,6 +816,9 @@ namespace epl
 		m_terminator=Terminator;
 		m_lockPolicy=lockPolicyType;
 		m_mode=mode;
+		m_reclaimer=NULL;
+		if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			m_reclaimer=EP_NEW EpochReclaimer(EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT,EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD,lockPolicyType);
 		switch(lockPolicyType)
 		{
 		case LOCK_POLICY_CRITICALSECTION:
@@ -545,6 +830,12 @@ namespace epl
 		case LOCK_POLICY_NONE:
 			m_trieLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_trieLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_trieLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_trieLock=NULL;
 		}
@@ -565,6 +856,12 @@ namespace epl
 		case LOCK_POLICY_NONE:
 			m_trieLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_trieLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_trieLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_trieLock=NULL;
 			break;
@@ -575,8 +872,9 @@ namespace epl
 		*m_root=*(b.m_root);
 		m_mode=b.m_mode;
 		m_terminator=b.m_terminator;
-	
-
+		m_reclaimer=NULL;
+		if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			m_reclaimer=EP_NEW EpochReclaimer(EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT,EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD,m_lockPolicy);
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
@@ -586,6 +884,8 @@ namespace epl
 		if(m_root)
 			EP_DELETE m_root;
 		m_trieLock->Unlock();
+		if(m_reclaimer)
+			EP_DELETE m_reclaimer;
 		if(m_trieLock)
 			EP_DELETE m_trieLock;
 	}
@@ -597,7 +897,13 @@ namespace epl
 		{
 			m_trieLock->Lock();
 			if(m_root)
-				EP_DELETE m_root;
+			{
+				// readers may still be on the old root in concurrent mode
+				if(m_reclaimer)
+					m_reclaimer->RetireObject(static_cast<PatriciaTrieNode*>(m_root));
+				else
+					EP_DELETE m_root;
+			}
 			m_root=NULL;
 			m_trieLock->Unlock();
 			if(m_trieLock)
@@ -617,16 +923,25 @@ namespace epl
 			case LOCK_POLICY_NONE:
 				m_trieLock=EP_NEW NoLock();
 				break;
+			case LOCK_POLICY_SPIN_PARK:
+				m_trieLock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				m_trieLock=EP_NEW ReaderWriterLock();
+				break;
 			default:
 				m_trieLock=NULL;
 				break;
 			}
-			m_root=EP_NEW PatriciaTrieNode(Terminator);
+			PatriciaTrieNode *newRoot=EP_NEW PatriciaTrieNode(Terminator);
 			LockObj lock(b.m_trieLock);
 			m_totalCount=b.m_totalCount;
-			*m_root=*(b.m_root);
+			*newRoot=*(b.m_root);
 			m_mode=b.m_mode;
 			m_terminator=b.m_terminator;
+			if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT && !m_reclaimer)
+				m_reclaimer=EP_NEW EpochReclaimer(EPOCH_RECLAIMER_DEFAULT_MAX_THREAD_COUNT,EPOCH_RECLAIMER_DEFAULT_RECLAIM_THRESHOLD,m_lockPolicy);
+			InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_root),newRoot);
 		}
 		return *this;
 	}
@@ -645,7 +960,10 @@ namespace epl
 		}
 		else
 		{
-			foundNode=insert(m_root,str,0,retData);
+			if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+				foundNode=insertConcurrent(str,retData);
+			else
+				foundNode=insert(m_root,str,0,retData);
 			EP_ASSERT_EXPR(foundNode,_T("Insert Failed"));
 			m_totalCount++;
 			return foundNode->GetData();		
@@ -657,8 +975,17 @@ namespace epl
 	{
 		EP_ASSERT_EXPR(str,_T("String is NULL"));
 		DataType retData;
-		LockObj lock(m_trieLock);
-		PatriciaTrieLeaf *foundNode=find(m_root,str,0,retData);
+		PatriciaTrieLeaf *foundNode=NULL;
+		if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+		{
+			EpochReclaimer::EpochGuard guard(*m_reclaimer);
+			foundNode=findLoop(m_root,str,0,retData);
+		}
+		else
+		{
+			SharedLockObj lock(m_trieLock);
+			foundNode=find(m_root,str,0,retData);
+		}
 		EP_ASSERT(foundNode);
 		return foundNode->GetData();
 	}
@@ -668,6 +995,12 @@ namespace epl
 	{
 		LockObj lock(m_trieLock);
 		m_totalCount=0;	
+		if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+		{
+			PatriciaTrieNode *oldRoot=static_cast<PatriciaTrieNode*>(InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_root),EP_NEW PatriciaTrieNode(Terminator)));
+			m_reclaimer->RetireObject(oldRoot);
+			return;
+		}
 		if(m_root)
 			EP_DELETE m_root;
 		m_root=EP_NEW PatriciaTrieNode(Terminator);
@@ -676,7 +1009,9 @@ namespace epl
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::IsEmpty() const
 	{
-		LockObj lock(m_trieLock);
+		if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			return m_totalCount!=0;
+		SharedLockObj lock(m_trieLock);
 		if(m_totalCount)
 			return true;
 		return false;
@@ -685,10 +1020,121 @@ namespace epl
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	size_t PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::Size() const
 	{
-		LockObj lock(m_trieLock);
+		if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			return m_totalCount;
+		SharedLockObj lock(m_trieLock);
 		return m_totalCount;
 	}
 
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::SaveToStream(Stream &stream) const
+	{
+		EpochReclaimer *reclaimer=(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)?m_reclaimer:NULL;
+		if(reclaimer)
+			reclaimer->Enter();
+		else if(m_trieLock)
+			m_trieLock->LockShared();
+
+		// first pass lays the records out in breadth-first order
+		vector<const PatriciaTrieNode*> nodeList;
+		vector<unsigned int> offsetList;
+		vector<size_t> firstChildList;
+		vector<const DataType*> dataList;
+		unsigned int dataOffset=sizeof(PatriciaTrieMappedHeader);
+		const PatriciaTrieNode *rootNode=m_root;
+		nodeList.push_back(rootNode);
+		for(size_t nodeTrav=0;nodeTrav<nodeList.size();nodeTrav++)
+		{
+			const vector<BasePatriciaTrieNode*> &childList=nodeList.at(nodeTrav)->GetList();
+			firstChildList.push_back(nodeList.size());
+			for(size_t childTrav=0;childTrav<childList.size();childTrav++)
+			{
+				if(childList.at(childTrav)->IsLeaf())
+					dataList.push_back(&static_cast<const PatriciaTrieLeaf*>(childList.at(childTrav))->GetData());
+				else
+					nodeList.push_back(static_cast<const PatriciaTrieNode*>(childList.at(childTrav)));
+			}
+		}
+		size_t currentOffset=dataOffset+((dataList.size()*sizeof(DataType)+3)&~3);
+		for(size_t nodeTrav=0;nodeTrav<nodeList.size();nodeTrav++)
+		{
+			size_t childCount=(nodeTrav+1<nodeList.size()?firstChildList.at(nodeTrav+1):nodeList.size())-firstChildList.at(nodeTrav);
+			offsetList.push_back(static_cast<unsigned int>(currentOffset));
+			currentOffset+=sizeof(unsigned int)*2+((childCount*sizeof(CharacterType)+3)&~3)+sizeof(unsigned int)*childCount;
+		}
+		if(currentOffset>0xFFFFFFFF)
+		{
+			if(reclaimer)
+				reclaimer->Leave();
+			else if(m_trieLock)
+				m_trieLock->UnlockShared();
+			return false;
+		}
+
+		PatriciaTrieMappedHeader header;
+		header.m_magic=PATRICIA_TRIE_MAPPED_MAGIC;
+		header.m_version=PATRICIA_TRIE_MAPPED_VERSION;
+		header.m_characterSize=sizeof(CharacterType);
+		header.m_dataSize=sizeof(DataType);
+		header.m_stringCount=static_cast<unsigned int>(dataList.size());
+		header.m_dataOffset=dataOffset;
+		header.m_rootOffset=offsetList.at(0);
+		header.m_totalSize=static_cast<unsigned int>(currentOffset);
+		bool retBool=stream.WriteBytes(reinterpret_cast<const unsigned char*>(&header),sizeof(PatriciaTrieMappedHeader));
+
+		for(size_t dataTrav=0;retBool && dataTrav<dataList.size();dataTrav++)
+			retBool=stream.WriteBytes(reinterpret_cast<const unsigned char*>(dataList.at(dataTrav)),sizeof(DataType));
+		unsigned char padding[4]={0,0,0,0};
+		size_t paddingSize=((dataList.size()*sizeof(DataType)+3)&~3)-dataList.size()*sizeof(DataType);
+		if(retBool && paddingSize)
+			retBool=stream.WriteBytes(padding,paddingSize);
+
+		// second pass writes the records, numbering the data in the same order as the first pass
+		vector<unsigned char> record;
+		unsigned int dataIdx=0;
+		for(size_t nodeTrav=0;retBool && nodeTrav<nodeList.size();nodeTrav++)
+		{
+			const vector<BasePatriciaTrieNode*> &childList=nodeList.at(nodeTrav)->GetList();
+			size_t childIdx=firstChildList.at(nodeTrav);
+			unsigned int childCount=0;
+			unsigned int recordDataIdx=PATRICIA_TRIE_MAPPED_NO_DATA;
+			for(size_t childTrav=0;childTrav<childList.size();childTrav++)
+			{
+				if(childList.at(childTrav)->IsLeaf())
+					recordDataIdx=dataIdx++;
+				else
+					childCount++;
+			}
+			size_t keySize=(childCount*sizeof(CharacterType)+3)&~3;
+			record.assign(sizeof(unsigned int)*2+keySize+sizeof(unsigned int)*childCount,0);
+			System::Memcpy(&record.at(0),&childCount,sizeof(unsigned int));
+			System::Memcpy(&record.at(sizeof(unsigned int)),&recordDataIdx,sizeof(unsigned int));
+			size_t keyTrav=0;
+			for(size_t childTrav=0;childTrav<childList.size();childTrav++)
+			{
+				if(childList.at(childTrav)->IsLeaf())
+					continue;
+				System::Memcpy(&record.at(sizeof(unsigned int)*2+keyTrav*sizeof(CharacterType)),&childList.at(childTrav)->GetCharacter(),sizeof(CharacterType));
+				System::Memcpy(&record.at(sizeof(unsigned int)*2+keySize+keyTrav*sizeof(unsigned int)),&offsetList.at(childIdx+keyTrav),sizeof(unsigned int));
+				keyTrav++;
+			}
+			retBool=stream.WriteBytes(&record.at(0),record.size());
+		}
+
+		if(reclaimer)
+			reclaimer->Leave();
+		else if(m_trieLock)
+			m_trieLock->UnlockShared();
+		return retBool;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::UnregisterThread()
+	{
+		if(m_reclaimer)
+			m_reclaimer->UnregisterThread();
+	}
+
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::Insert(const CharacterType* str,const DataType &data)
@@ -696,7 +1142,12 @@ namespace epl
 		if(str!=NULL )
 		{		
 			LockObj lock(m_trieLock);
-			if(insert(m_root,str,0,data))
+			PatriciaTrieLeaf *retLeaf=NULL;
+			if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+				retLeaf=insertConcurrent(str,data);
+			else
+				retLeaf=insert(m_root,str,0,data);
+			if(retLeaf)
 			{
 				m_totalCount++;
 				return true;		
@@ -711,7 +1162,12 @@ namespace epl
 		if(str!=NULL)
 		{
 			LockObj lock(m_trieLock);
-			if(erase(m_root,str,0))
+			bool retBool=false;
+			if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+				retBool=eraseConcurrent(str);
+			else
+				retBool=erase(m_root,str,0);
+			if(retBool)
 			{
 				m_totalCount--;
 				return true;
@@ -725,7 +1181,12 @@ namespace epl
 	{
 		if(str!=NULL)
 		{
-			LockObj lock(m_trieLock);
+			if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			{
+				EpochReclaimer::EpochGuard guard(*m_reclaimer);
+				return findLoop(m_root,str,0,retData)!=NULL;
+			}
+			SharedLockObj lock(m_trieLock);
 			if(find(m_root,str,0,retData))
 			{
 				return true;
@@ -739,7 +1200,12 @@ namespace epl
 	{
 		if(str!=NULL)
 		{
-			LockObj lock(m_trieLock);
+			if(m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			{
+				EpochReclaimer::EpochGuard guard(*m_reclaimer);
+				return findAllLoop(m_root,str,0,retStrDataPairList);
+			}
+			SharedLockObj lock(m_trieLock);
 			if(findAll(m_root,str,0,retStrDataPairList))
 			{
 				return true;
@@ -1206,7 +1672,7 @@ namespace epl
 		SnapShotStruct currentSnaptshot;
 		currentSnaptshot.root=root;
 		snapshotStack.push(currentSnaptshot);
-		PatriciaTrieLeaf *retBool=false;
+		PatriciaTrieLeaf *retBool=NULL;
 
 		while(!snapshotStack.empty())
 		{
@@ -1232,6 +1698,92 @@ namespace epl
 		}
 	}
 
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieLeaf *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::insertConcurrent(const CharacterType* str,const DataType &data)
+	{
+		DataType retData;
+		if(findLoop(m_root,str,0,retData))
+			return NULL;
+
+		PatriciaTrieNode *oldRoot=m_root;
+		vector<PatriciaTrieNode*> shellList;
+		PatriciaTrieNode *newRoot=oldRoot->CloneShallow();
+		shellList.push_back(oldRoot);
+		PatriciaTrieNode *currentNode=newRoot;
+		size_t strTrav=0;
+		while(CharCompareFunc(&str[strTrav],&m_terminator)!=COMP_RESULT_EQUAL)
+		{
+			BasePatriciaTrieNode *childNode=(*currentNode)[str[strTrav]];
+			PatriciaTrieNode *nextNode=NULL;
+			if(childNode)
+			{
+				// the child is visible to readers, so replace it with its copy
+				nextNode=static_cast<PatriciaTrieNode*>(childNode)->CloneShallow();
+				currentNode->ReplaceNode(nextNode);
+				shellList.push_back(static_cast<PatriciaTrieNode*>(childNode));
+			}
+			else
+			{
+				nextNode=static_cast<PatriciaTrieNode*>(currentNode->AddNode(str[strTrav]));
+			}
+			currentNode=nextNode;
+			strTrav++;
+		}
+		PatriciaTrieLeaf *retLeaf=currentNode->AddLeaf(str,data);
+		publishRoot(newRoot,shellList);
+		return retLeaf;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::eraseConcurrent(const CharacterType* str)
+	{
+		vector<PatriciaTrieNode*> pathList;
+		PatriciaTrieNode *currentNode=m_root;
+		pathList.push_back(currentNode);
+		size_t strTrav=0;
+		while(CharCompareFunc(&str[strTrav],&m_terminator)!=COMP_RESULT_EQUAL)
+		{
+			BasePatriciaTrieNode *childNode=(*currentNode)[str[strTrav]];
+			if(!childNode)
+				return false;
+			currentNode=static_cast<PatriciaTrieNode*>(childNode);
+			pathList.push_back(currentNode);
+			strTrav++;
+		}
+		if(!(*currentNode)[m_terminator])
+			return false;
+
+		// cut at the deepest node which still has other children after the erase
+		size_t cutIdx=pathList.size()-1;
+		while(cutIdx>0 && pathList.at(cutIdx)->GetList().size()==1)
+			cutIdx--;
+
+		vector<PatriciaTrieNode*> shellList;
+		PatriciaTrieNode *newRoot=pathList.at(0)->CloneShallow();
+		shellList.push_back(pathList.at(0));
+		currentNode=newRoot;
+		for(size_t pathTrav=1;pathTrav<=cutIdx;pathTrav++)
+		{
+			PatriciaTrieNode *nextNode=pathList.at(pathTrav)->CloneShallow();
+			currentNode->ReplaceNode(nextNode);
+			shellList.push_back(pathList.at(pathTrav));
+			currentNode=nextNode;
+		}
+		CharacterType cutChar=(cutIdx==pathList.size()-1)?m_terminator:str[cutIdx];
+		BasePatriciaTrieNode *removedNode=currentNode->DetachNode(cutChar);
+		publishRoot(newRoot,shellList);
+		m_reclaimer->RetireObject(removedNode);
+		return true;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::publishRoot(PatriciaTrieNode *newRoot,const vector<PatriciaTrieNode*> &shellList)
+	{
+		InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_root),newRoot);
+		for(size_t shellTrav=0;shellTrav<shellList.size();shellTrav++)
+			m_reclaimer->Retire(shellList.at(shellTrav),&reclaimShell);
+	}
+
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode::BasePatriciaTrieNode(CharacterType c, bool isLeaf)
 	{
@@ -1284,15 +1836,24 @@ namespace epl
 	{
 		m_data=data;
 		m_terminator=Terminator;
+		m_isInline=false;
 		if(str!=NULL)
 		{
-			int trav=0;
-			while(CharCompareFunc(&str[trav],&m_terminator)!=COMP_RESULT_EQUAL)
+			size_t strLength=0;
+			while(CharCompareFunc(&str[strLength],&m_terminator)!=COMP_RESULT_EQUAL)
+				strLength++;
+			if(strLength<PATRICIA_TRIE_INLINE_STRING_SIZE)
 			{
-				m_string.push_back(str[trav]);
-				trav++;
+				m_isInline=true;
+				for(size_t trav=0;trav<strLength;trav++)
+					m_inlineString[trav]=str[trav];
+				m_inlineString[strLength]=m_terminator;
+			}
+			else
+			{
+				m_string.assign(str,str+strLength);
+				m_string.push_back(m_terminator);
 			}
-			m_string.push_back(m_terminator);
 		}
 	}
 
@@ -1301,6 +1862,10 @@ namespace epl
 	{
 		m_data=b.m_data;
 		m_string=b.m_string;
+		m_isInline=b.m_isInline;
+		m_terminator=b.m_terminator;
+		for(int trav=0;trav<PATRICIA_TRIE_INLINE_STRING_SIZE;trav++)
+			m_inlineString[trav]=b.m_inlineString[trav];
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
@@ -1316,6 +1881,10 @@ namespace epl
 			BasePatriciaTrieNode::operator =(b);
 			m_data=b.m_data;
 			m_string=b.m_string;
+			m_isInline=b.m_isInline;
+			m_terminator=b.m_terminator;
+			for(int trav=0;trav<PATRICIA_TRIE_INLINE_STRING_SIZE;trav++)
+				m_inlineString[trav]=b.m_inlineString[trav];
 		}
 		return *this;
 	}
@@ -1341,6 +1910,8 @@ namespace epl
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	const CharacterType *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieLeaf::GetString() const
 	{
+		if(m_isInline)
+			return m_inlineString;
 		if(m_string.size())
 		{
 			return &m_string.at(0);
@@ -1353,14 +1924,58 @@ namespace epl
 	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::PatriciaTrieNode(CharacterType c):BasePatriciaTrieNode(c)
 	{
 		m_terminator=Terminator;
+		m_directIndex=NULL;
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::PatriciaTrieNode(const PatriciaTrieNode &b):BasePatriciaTrieNode(b)
 	{
-		BasePatriciaTrieNode *tmpNode=NULL;
 		m_terminator=b.m_terminator;
-		for(int listTrav=0;listTrav<b.m_charList.size();listTrav++)
+		m_directIndex=NULL;
+		copyChildren(b);
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::~PatriciaTrieNode()
+	{
+		clearChildren();
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode &PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::operator=(const PatriciaTrieNode & b)
+	{
+		if(this!=&b)
+		{
+			BasePatriciaTrieNode::operator =(b);
+			m_terminator=b.m_terminator;
+			clearChildren();
+			copyChildren(b);
+		}
+		return *this;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::clearChildren()
+	{
+		for(size_t listTrav=0;listTrav<m_charList.size();listTrav++)
+		{
+			if(m_charList.at(listTrav))
+				EP_DELETE m_charList.at(listTrav);
+		}
+		m_charList.clear();
+		m_keyList.clear();
+		if(m_directIndex)
+			EP_DELETE[] m_directIndex;
+		m_directIndex=NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::copyChildren(const PatriciaTrieNode &b)
+	{
+		BasePatriciaTrieNode *tmpNode=NULL;
+		m_charList.reserve(b.m_charList.size());
+		m_keyList.reserve(b.m_keyList.size());
+		for(size_t listTrav=0;listTrav<b.m_charList.size();listTrav++)
 		{
 			tmpNode=b.m_charList.at(listTrav);
 			if(tmpNode)
@@ -1368,64 +1983,134 @@ namespace epl
 				if(tmpNode->IsLeaf())
 				{
 					PatriciaTrieLeaf *node=EP_NEW PatriciaTrieLeaf(*static_cast<PatriciaTrieLeaf*>(tmpNode));
-					*node=*static_cast<PatriciaTrieLeaf*>(tmpNode);
 					m_charList.push_back(node);
 				}
 				else
 				{
 					PatriciaTrieNode *node=EP_NEW PatriciaTrieNode(*static_cast<PatriciaTrieNode*>(tmpNode));
-					*node=*static_cast<PatriciaTrieNode*>(tmpNode);
 					m_charList.push_back(node);
 				}
+				m_keyList.push_back(b.m_keyList.at(listTrav));
 			}
 		}
-
+		rebuildDirectIndex();
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
-	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::~PatriciaTrieNode()
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::rebuildDirectIndex()
 	{
-		BasePatriciaTrieNode *tmpNode=NULL;
-		for(int listTrav=0;listTrav<m_charList.size();listTrav++)
+		if(!canDirectIndex() || m_keyList.size()<PATRICIA_TRIE_DIRECT_INDEX_SIZE)
 		{
-			tmpNode=m_charList.at(listTrav);
-			if(tmpNode)
-				EP_DELETE tmpNode;
-			tmpNode=NULL;
+			if(m_directIndex)
+				EP_DELETE[] m_directIndex;
+			m_directIndex=NULL;
+			return;
 		}
+		if(!m_directIndex)
+			m_directIndex=EP_NEW unsigned short[256];
+		for(int tableTrav=0;tableTrav<256;tableTrav++)
+			m_directIndex[tableTrav]=0;
+		for(size_t keyTrav=0;keyTrav<m_keyList.size();keyTrav++)
+			m_directIndex[static_cast<unsigned char>(m_keyList.at(keyTrav))]=static_cast<unsigned short>(keyTrav+1);
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
-	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode &PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::operator=(const PatriciaTrieNode & b)
+	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::findIndex(const CharacterType &character, size_t &retIdx) const
 	{
-		if(this!=&b)
+		size_t keyCount=m_keyList.size();
+		if(keyCount==0)
 		{
-			BasePatriciaTrieNode::operator =(b);
-			m_terminator=b.m_terminator;
-			BasePatriciaTrieNode *tmpNode=NULL;
-			for(int listTrav=0;listTrav<b.m_charList.size();listTrav++)
+			retIdx=0;
+			return false;
+		}
+		if(m_directIndex)
+		{
+			unsigned short directIdx=m_directIndex[static_cast<unsigned char>(character)];
+			if(directIdx)
+			{
+				retIdx=directIdx-1;
+				return true;
+			}
+			// fall through to the binary search for the insert position
+		}
+		const CharacterType *keys=&(m_keyList.at(0));
+		if(keyCount<=PATRICIA_TRIE_LINEAR_SEARCH_SIZE)
+		{
+			for(size_t keyTrav=0;keyTrav<keyCount;keyTrav++)
 			{
-				tmpNode=b.m_charList.at(listTrav);
-				if(tmpNode)
+				CompResultType ret=CharCompareFunc(&character,&keys[keyTrav]);
+				if(ret==COMP_RESULT_EQUAL)
 				{
-					if(tmpNode->IsLeaf())
-					{
-						PatriciaTrieLeaf *node=EP_NEW PatriciaTrieLeaf(*static_cast<PatriciaTrieLeaf*>(tmpNode));
-						*node=*static_cast<PatriciaTrieLeaf*>(tmpNode);
-						m_charList.push_back(node);
-					}
-					else
-					{
-						PatriciaTrieNode *node=EP_NEW PatriciaTrieNode(*static_cast<PatriciaTrieNode*>(tmpNode));
-						*node=*static_cast<PatriciaTrieNode*>(tmpNode);
-						m_charList.push_back(node);
-					}
+					retIdx=keyTrav;
+					return true;
+				}
+				if(ret==COMP_RESULT_LESSTHAN)
+				{
+					retIdx=keyTrav;
+					return false;
 				}
 			}
+			retIdx=keyCount;
+			return false;
 		}
-		return *this;
+		return BinarySearch(character,keys,keyCount,CharCompareFunc,retIdx)!=NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::insertChild(size_t idx, BasePatriciaTrieNode *node)
+	{
+		m_charList.insert(m_charList.begin()+idx,node);
+		m_keyList.insert(m_keyList.begin()+idx,node->GetCharacter());
+		rebuildDirectIndex();
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::eraseChild(size_t idx)
+	{
+		m_charList.erase(m_charList.begin()+idx);
+		m_keyList.erase(m_keyList.begin()+idx);
+		rebuildDirectIndex();
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::CloneShallow() const
+	{
+		PatriciaTrieNode *newNode=EP_NEW PatriciaTrieNode(this->m_character);
+		newNode->m_terminator=m_terminator;
+		newNode->m_charList=m_charList;
+		newNode->m_keyList=m_keyList;
+		newNode->rebuildDirectIndex();
+		return newNode;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::ReplaceNode(BasePatriciaTrieNode *node)
+	{
+		size_t retIdx;
+		if(!findIndex(node->GetCharacter(),retIdx))
+			return false;
+		m_charList[retIdx]=node;
+		return true;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::DetachNode(CharacterType c)
+	{
+		size_t retIdx;
+		if(!findIndex(c,retIdx))
+			return NULL;
+		BasePatriciaTrieNode *retNode=m_charList.at(retIdx);
+		eraseChild(retIdx);
+		return retNode;
 	}
 
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	void PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::DetachAll()
+	{
+		m_charList.clear();
+		m_keyList.clear();
+		rebuildDirectIndex();
+	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	const vector<typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *> &PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::GetList() const
@@ -1442,107 +2127,365 @@ namespace epl
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
 	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::AddNode(const CharacterType c)
 	{
-		if(m_charList.size())
+		size_t retIdx;
+		if(findIndex(c,retIdx))
+			return NULL;
+		PatriciaTrieNode *newNode=EP_NEW PatriciaTrieNode(c);
+		insertChild(retIdx,newNode);
+		return newNode;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieLeaf *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::AddLeaf(const CharacterType *str,const DataType& data)
+	{
+		size_t retIdx;
+		if(findIndex(m_terminator,retIdx))
+			return NULL;
+		PatriciaTrieLeaf *newNode=EP_NEW PatriciaTrieLeaf(str,data);
+		insertChild(retIdx,newNode);
+		return newNode;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::RemoveNode(CharacterType c)
+	{
+		size_t retIdx;
+		if(findIndex(c,retIdx))
 		{
-			int retIdx;
-			BasePatriciaTrieNode **existNode=BinarySearch(c,&(m_charList.at(0)),m_charList.size(),NodeCompareFunc,retIdx);
-			if(existNode)
-				return NULL;
-			else
+			BasePatriciaTrieNode *existNode=m_charList.at(retIdx);
+			if(existNode->IsLeaf() || static_cast<PatriciaTrieNode*>(existNode)->GetList().size()==0)
 			{
-				PatriciaTrieNode *newNode=EP_NEW PatriciaTrieNode(c);		
-				m_charList.insert(m_charList.begin()+retIdx,newNode);
-				return newNode;
+				EP_DELETE existNode;
+				eraseChild(retIdx);
+				return true;
 			}
 		}
-		else
+		return false;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::operator[](const CharacterType &character)
+	{
+		size_t retIdx;
+		if(findIndex(character,retIdx))
+			return m_charList[retIdx];
+		return NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	const typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::operator[](const CharacterType &character) const
+	{
+		size_t retIdx;
+		if(findIndex(character,retIdx))
+			return m_charList[retIdx];
+		return NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PrefixCursor::PrefixCursor(const PatriciaTrie &trie, const CharacterType *prefix, size_t limit):m_trie(trie)
+	{
+		m_limit=limit;
+		m_count=0;
+		if(m_trie.m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			m_trie.m_reclaimer->Enter();
+		else if(m_trie.m_trieLock)
+			m_trie.m_trieLock->LockShared();
+
+		if(prefix==NULL)
+			return;
+		const PatriciaTrieNode *currentNode=m_trie.m_root;
+		size_t strTrav=0;
+		while(CharCompareFunc(&prefix[strTrav],&m_trie.m_terminator)!=COMP_RESULT_EQUAL)
 		{
-			PatriciaTrieNode *newNode=EP_NEW PatriciaTrieNode(c);
-			m_charList.push_back(newNode);
-			return newNode;
+			const BasePatriciaTrieNode *childNode=(*currentNode)[prefix[strTrav]];
+			if(!childNode)
+				return;
+			currentNode=static_cast<const PatriciaTrieNode*>(childNode);
+			strTrav++;
 		}
+		CursorFrame frame;
+		frame.node=currentNode;
+		frame.childIdx=0;
+		m_frameStack.push_back(frame);
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
-	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieLeaf *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::AddLeaf(const CharacterType *str,const DataType& data)
+	PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PrefixCursor::~PrefixCursor()
+	{
+		if(m_trie.m_mode==PATRICIA_TRIE_MODE_CONCURRENT)
+			m_trie.m_reclaimer->Leave();
+		else if(m_trie.m_trieLock)
+			m_trie.m_trieLock->UnlockShared();
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PrefixCursor::Next(const CharacterType *&retStr, DataType &retData)
 	{
-		if(m_charList.size())
+		if(m_limit && m_count>=m_limit)
+			return false;
+		while(!m_frameStack.empty())
 		{
-			int retIdx;
-			BasePatriciaTrieNode **existNode= BinarySearch(m_terminator,&(m_charList.at(0)),m_charList.size(),NodeCompareFunc,retIdx);
-			if(existNode)
-				return NULL;
-			else
+			CursorFrame &topFrame=m_frameStack.back();
+			const vector<BasePatriciaTrieNode*> &childList=topFrame.node->GetList();
+			if(topFrame.childIdx>=childList.size())
 			{
-				PatriciaTrieLeaf *newNode=EP_NEW PatriciaTrieLeaf(str,data);		
-				m_charList.insert(m_charList.begin()+retIdx,newNode);
-				return newNode;
+				m_frameStack.pop_back();
+				continue;
 			}
+			const BasePatriciaTrieNode *childNode=childList[topFrame.childIdx];
+			topFrame.childIdx++;
+			if(childNode->IsLeaf())
+			{
+				const PatriciaTrieLeaf *leaf=static_cast<const PatriciaTrieLeaf*>(childNode);
+				retStr=leaf->GetString();
+				retData=leaf->GetData();
+				m_count++;
+				return true;
+			}
+			CursorFrame frame;
+			frame.node=static_cast<const PatriciaTrieNode*>(childNode);
+			frame.childIdx=0;
+			m_frameStack.push_back(frame);
 		}
-		else
-		{
-			PatriciaTrieLeaf *newNode=EP_NEW PatriciaTrieLeaf(str,data);		
-			m_charList.push_back(newNode);
-			return newNode;
-		}
+		return false;
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
-	bool PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::RemoveNode(CharacterType c)
+	size_t PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PrefixCursor::GetCount() const
 	{
-		if(m_charList.size())
-		{
-			int retIdx;
-			BasePatriciaTrieNode **existNode= BinarySearch(c,&(m_charList.at(0)),m_charList.size(),PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::NodeCompareFunc,retIdx);
-			if(existNode)
-			{
-				if((*existNode)->IsLeaf())
-				{
-					EP_DELETE *existNode;
-					m_charList.erase(m_charList.begin()+retIdx);
-					return true;
-				}
-				else
-				{
-					PatriciaTrieNode *checkNode=static_cast<PatriciaTrieNode*>((*existNode));
-					if(checkNode->GetList().size()==0)
-					{
-						EP_DELETE *existNode;
-						m_charList.erase(m_charList.begin()+retIdx);
-						return true;
-					}
-				}
+		return m_count;
+	}
 
-			}
+	/*! 
+	@class MappedPatriciaTrie epPatriciaTrie.h
+	@brief A read-only Patricia Trie Template class querying the trie written by PatriciaTrie::SaveToStream in place.
+
+	Nothing is deserialized, so attaching is constant time,
+	and the processes mapping the same file share the pages.
+	@remark the template arguments must be the same as the PatriciaTrie saved the buffer.
+	*/
+	template<typename CharacterType, typename DataType , CharacterType Terminator=(CharacterType)0, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)=CompClass<CharacterType>::CompFunc>
+	class MappedPatriciaTrie
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Mapped Patricia Trie
+		*/
+		MappedPatriciaTrie();
+
+		/*!
+		Default Destructor
+
+		Detaches and destroys the Mapped Patricia Trie
+		*/
+		virtual ~MappedPatriciaTrie();
+
+		/*!
+		Attach the trie to the given buffer
+		@param[in] buffer the buffer holding the trie written by PatriciaTrie::SaveToStream
+		@param[in] bufferSize the size of the buffer
+		@remark the buffer is not copied, so it must live until detached.
+		@return true if succeeded otherwise false
+		*/
+		bool Attach(const void *buffer, size_t bufferSize);
+
+		/*!
+		Map the given file read-only and attach the trie to it
+		@param[in] fileName the file holding the trie written by PatriciaTrie::SaveToStream
+		@return true if succeeded otherwise false
+		*/
+		bool AttachFile(const TCHAR *fileName);
+
+		/*!
+		Detach the trie, and unmap the file if mapped by AttachFile
+		*/
+		void Detach();
+
+		/*!
+		Return whether the trie is attached
+		@return true if attached otherwise false
+		*/
+		bool IsAttached() const;
+
+		/*!
+		Find the given string from the trie and return the data with the given string
+		@param[in] str The string value to find
+		@param[out] retData the data with the given string
+		@return true if succeeded otherwise false
+		*/
+		bool Find(const CharacterType* str, DataType &retData) const;
+
+		/*!
+		return the number of element in the trie.
+		@return the number of element in the trie
+		*/
+		size_t Size() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		MappedPatriciaTrie(const MappedPatriciaTrie & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		MappedPatriciaTrie &operator=(const MappedPatriciaTrie & b){EP_ASSERT(0);return *this;}
+
+		/// the buffer attached
+		const unsigned char *m_buffer;
+		/// the header of the buffer attached
+		const PatriciaTrieMappedHeader *m_header;
+		/// the file handle if mapped by AttachFile
+		HANDLE m_fileHandle;
+		/// the file mapping handle if mapped by AttachFile
+		HANDLE m_mappingHandle;
+	};
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::MappedPatriciaTrie()
+	{
+		m_buffer=NULL;
+		m_header=NULL;
+		m_fileHandle=INVALID_HANDLE_VALUE;
+		m_mappingHandle=NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::~MappedPatriciaTrie()
+	{
+		Detach();
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::Attach(const void *buffer, size_t bufferSize)
+	{
+		Detach();
+		if(buffer==NULL || bufferSize<sizeof(PatriciaTrieMappedHeader))
+			return false;
+		const PatriciaTrieMappedHeader *header=reinterpret_cast<const PatriciaTrieMappedHeader*>(buffer);
+		if(header->m_magic!=PATRICIA_TRIE_MAPPED_MAGIC || header->m_version!=PATRICIA_TRIE_MAPPED_VERSION)
+			return false;
+		if(header->m_characterSize!=sizeof(CharacterType) || header->m_dataSize!=sizeof(DataType))
+			return false;
+		if(header->m_totalSize>bufferSize || header->m_rootOffset+sizeof(unsigned int)*2>header->m_totalSize
+			|| header->m_dataOffset+static_cast<size_t>(header->m_stringCount)*sizeof(DataType)>header->m_rootOffset)
+			return false;
+		m_buffer=reinterpret_cast<const unsigned char*>(buffer);
+		m_header=header;
+		return true;
+	}
 
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::AttachFile(const TCHAR *fileName)
+	{
+		Detach();
+		HANDLE fileHandle=CreateFile(fileName,GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+		if(fileHandle==INVALID_HANDLE_VALUE)
+			return false;
+		DWORD fileSize=GetFileSize(fileHandle,NULL);
+		HANDLE mappingHandle=NULL;
+		const void *buffer=NULL;
+		if(fileSize!=INVALID_FILE_SIZE && fileSize>=sizeof(PatriciaTrieMappedHeader))
+			mappingHandle=CreateFileMapping(fileHandle,NULL,PAGE_READONLY,0,0,NULL);
+		if(mappingHandle)
+			buffer=MapViewOfFile(mappingHandle,FILE_MAP_READ,0,0,0);
+		if(buffer && Attach(buffer,fileSize))
+		{
+			m_fileHandle=fileHandle;
+			m_mappingHandle=mappingHandle;
+			return true;
 		}
+		if(buffer)
+			UnmapViewOfFile(buffer);
+		if(mappingHandle)
+			CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
 		return false;
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
-	typename PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::operator[](const CharacterType &character)
+	void MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::Detach()
 	{
-		if(m_charList.size())
+		if(m_mappingHandle)
 		{
-			int retIdx;
-			BasePatriciaTrieNode ** retNode=BinarySearch(character,&(m_charList.at(0)),m_charList.size(),NodeCompareFunc,retIdx);
-			if(retNode)
-				return *retNode;
+			UnmapViewOfFile(m_buffer);
+			CloseHandle(m_mappingHandle);
+			CloseHandle(m_fileHandle);
 		}
-		return NULL;
+		m_mappingHandle=NULL;
+		m_fileHandle=INVALID_HANDLE_VALUE;
+		m_buffer=NULL;
+		m_header=NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	bool MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::IsAttached() const
+	{
+		return m_header!=NULL;
+	}
+
+	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
+	size_t MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::Size() const
+	{
+		if(m_header)
+			return m_header->m_stringCount;
+		return 0;
 	}
 
 	template<typename CharacterType, typename DataType , CharacterType Terminator, CompResultType (__cdecl *CharCompareFunc)(const void *,const void *)>
-	typename const PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::BasePatriciaTrieNode *PatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::PatriciaTrieNode::operator[](const CharacterType &character) const
+	bool MappedPatriciaTrie<CharacterType,DataType,Terminator,CharCompareFunc>::Find(const CharacterType* str, DataType &retData) const
 	{
-		if(m_charList.size())
+		if(str==NULL || m_header==NULL)
+			return false;
+		CharacterType terminator=Terminator;
+		unsigned int recordOffset=m_header->m_rootOffset;
+		const unsigned int *record=reinterpret_cast<const unsigned int*>(m_buffer+recordOffset);
+		size_t strTrav=0;
+		while(CharCompareFunc(&str[strTrav],&terminator)!=COMP_RESULT_EQUAL)
 		{
-			int retIdx;
-			BasePatriciaTrieNode ** retNode=BinarySearch(character,&(m_charList.at(0)),m_charList.size(),NodeCompareFunc,retIdx);
-			if(retNode)
-				return *retNode;
+			unsigned int childCount=record[0];
+			const CharacterType *keys=reinterpret_cast<const CharacterType*>(record+2);
+			const unsigned int *childOffsets=reinterpret_cast<const unsigned int*>(reinterpret_cast<const unsigned char*>(keys)+((childCount*sizeof(CharacterType)+3)&~3));
+			if(reinterpret_cast<const unsigned char*>(childOffsets+childCount)>m_buffer+m_header->m_totalSize)
+				return false;
+			size_t retIdx=childCount;
+			if(childCount<=PATRICIA_TRIE_LINEAR_SEARCH_SIZE)
+			{
+				for(size_t keyTrav=0;keyTrav<childCount;keyTrav++)
+				{
+					if(CharCompareFunc(&str[strTrav],&keys[keyTrav])==COMP_RESULT_EQUAL)
+					{
+						retIdx=keyTrav;
+						break;
+					}
+				}
+			}
+			else if(!BinarySearch(str[strTrav],keys,childCount,CharCompareFunc,retIdx))
+			{
+				retIdx=childCount;
+			}
+			if(retIdx>=childCount)
+				return false;
+			recordOffset=childOffsets[retIdx];
+			if(recordOffset<m_header->m_rootOffset || recordOffset+sizeof(unsigned int)*2>m_header->m_totalSize)
+				return false;
+			record=reinterpret_cast<const unsigned int*>(m_buffer+recordOffset);
+			strTrav++;
 		}
-		return NULL;
+		unsigned int dataIdx=record[1];
+		if(dataIdx==PATRICIA_TRIE_MAPPED_NO_DATA || dataIdx>=m_header->m_stringCount)
+			return false;
+		System::Memcpy(&retData,m_buffer+m_header->m_dataOffset+dataIdx*sizeof(DataType),sizeof(DataType));
+		return true;
 	}
 }
 #endif //__EP_PATRICIA_TRIE_H__
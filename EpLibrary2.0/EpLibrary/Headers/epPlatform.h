@@ -61,6 +61,45 @@ An Interface for the Platform Dependencies.
 #define WINDOWS_NT40       0x0400
 #define WINDOWS_95         0x0400
 
+#if defined(_WIN32) || defined(_WIN64)
+/// the platform is Windows
+#define EP_PLATFORM_WINDOWS 1
+#else //defined(_WIN32) || defined(_WIN64)
+/// the platform is POSIX
+#define EP_PLATFORM_POSIX 1
+#if defined(__linux__)
+/// the platform is Linux
+#define EP_PLATFORM_LINUX 1
+#endif //defined(__linux__)
+#endif //defined(_WIN32) || defined(_WIN64)
+
+#if defined(_MSC_VER)
+/// Keeps the function out of the line of its callers, for the cold paths such as the error reporting
+#define EP_NOINLINE __declspec(noinline)
+/// Hints that the expression is mostly true (no effect on MSVC, which lays out the if-branch as the likely one)
+#define EP_LIKELY(_Expression) (_Expression)
+/// Hints that the expression is mostly false (no effect on MSVC, so the cold branch should be kept out of the line)
+#define EP_UNLIKELY(_Expression) (_Expression)
+#else //defined(_MSC_VER)
+/// Keeps the function out of the line of its callers, for the cold paths such as the error reporting
+#define EP_NOINLINE __attribute__((noinline))
+/// Hints that the expression is mostly true
+#define EP_LIKELY(_Expression) __builtin_expect(!!(_Expression),1)
+/// Hints that the expression is mostly false
+#define EP_UNLIKELY(_Expression) __builtin_expect(!!(_Expression),0)
+#endif //defined(_MSC_VER)
+
+/// the byte size of the cache line the padded members are kept apart by
+#define EP_CACHE_LINE_SIZE 64
+
+#if defined(EP_ENABLE_CACHE_LINE_PADDING)
+/// Declares the padding member of one cache line, so the members before and after it never share the cache line
+#define EP_CACHE_LINE_PADDING(_Name) char _Name[EP_CACHE_LINE_SIZE];
+#else //defined(EP_ENABLE_CACHE_LINE_PADDING)
+/// Declares nothing unless EP_ENABLE_CACHE_LINE_PADDING is defined
+#define EP_CACHE_LINE_PADDING(_Name)
+#endif //defined(EP_ENABLE_CACHE_LINE_PADDING)
+
 #if defined(_WIN32) || defined(_WIN64)
 
 // MSVC++ 9.0   _MSC_VER = 1500
@@ -132,14 +171,36 @@ An Interface for the Platform Dependencies.
 
 #else //defined(_WIN32) || defined(_WIN64)
 
+#include <sched.h>
+
 #ifndef TCHAR
 #if defined(_UNICODE) || defined(UNICODE)
-typedef unsigned short TCHAR 
+typedef wchar_t TCHAR;
 #else// defined(_UNICODE) || defined(UNICODE)
-#define char TCHAR 
+typedef char TCHAR;
 #endif// defined(_UNICODE) || defined(UNICODE)
 #endif// TCHAR
 
+typedef long long __int64;
+typedef long LONG;
+typedef unsigned long DWORD;
+typedef void *PVOID;
+
+// the interlocked operations of Win32 used by the user space locks, with the full barrier
+inline LONG InterlockedIncrement(LONG volatile *addend){return __sync_add_and_fetch(addend,1);}
+inline LONG InterlockedDecrement(LONG volatile *addend){return __sync_sub_and_fetch(addend,1);}
+inline LONG InterlockedExchangeAdd(LONG volatile *addend, LONG value){return __sync_fetch_and_add(addend,value);}
+inline LONG InterlockedExchange(LONG volatile *target, LONG value){__sync_synchronize();return __sync_lock_test_and_set(target,value);}
+inline LONG InterlockedCompareExchange(LONG volatile *destination, LONG exchange, LONG comparand){return __sync_val_compare_and_swap(destination,comparand,exchange);}
+inline PVOID InterlockedCompareExchangePointer(PVOID volatile *destination, PVOID exchange, PVOID comparand){return __sync_val_compare_and_swap(destination,comparand,exchange);}
+inline PVOID InterlockedExchangePointer(PVOID volatile *target, PVOID value){__sync_synchronize();return __sync_lock_test_and_set(target,value);}
+
+#if defined(__i386__) || defined(__x86_64__)
+#define YieldProcessor() __builtin_ia32_pause()
+#else //defined(__i386__) || defined(__x86_64__)
+#define YieldProcessor() sched_yield()
+#endif //defined(__i386__) || defined(__x86_64__)
+
 #ifndef _T
 #if defined(_UNICODE) || defined(UNICODE)
 #define _T(x) L ## x
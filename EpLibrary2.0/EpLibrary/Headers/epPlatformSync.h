@@ -0,0 +1,169 @@
+/*! 
+@file epPlatformSync.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Platform Synchronization Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Platform Dependent Waiting Primitives.
+
+*/
+#ifndef __EP_PLATFORM_SYNC_H__
+#define __EP_PLATFORM_SYNC_H__
+#include "epLib.h"
+#include "epSystem.h"
+
+#if !defined(EP_PLATFORM_WINDOWS) && !defined(EP_PLATFORM_LINUX)
+#include <semaphore.h>
+#endif //!defined(EP_PLATFORM_WINDOWS) && !defined(EP_PLATFORM_LINUX)
+
+namespace epl
+{
+	/*! 
+	@class PlatformSync epPlatformSync.h
+	@brief A class for waiting on the value of the address, which backs the user space locks.
+
+	On Windows, WaitOnAddress and WakeByAddressSingle are used if available (Windows 8 or later).
+	On Linux, the private futex is used.
+	@remark the waiting thread may wake up spuriously, so the caller must check the value again.
+	@remark on Linux, only the lower 32 bits of the value are compared, since the futex word is 32 bits.
+	*/
+	class EP_LIBRARY PlatformSync
+	{
+	public:
+		/*!
+		Check if waiting on the address is supported.
+		@return true if supported otherwise false
+		@remark if not supported, WaitOnAddress returns false immediately, and the caller must wait by other means.
+		*/
+		static bool IsAddressWaitSupported();
+
+		/*!
+		Wait while the value of the given address is equal to given value.
+		@param[in] address the address to wait on
+		@param[in] compareValue the value to wait while equal
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return false if timed out or not supported, otherwise true
+		*/
+		static bool WaitOnAddress(volatile long *address, long compareValue, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Wake one thread waiting on the given address.
+		@param[in] address the address waited on
+		*/
+		static void WakeByAddressSingle(volatile long *address);
+
+		/*!
+		Wake all threads waiting on the given address.
+		@param[in] address the address waited on
+		*/
+		static void WakeByAddressAll(volatile long *address);
+
+	private:
+		/*!
+		Default Constructor
+
+		@remark PlatformSync only has the static functions.
+		*/
+		PlatformSync(){}
+	};
+
+	/*! 
+	@class PlatformSemaphore epPlatformSync.h
+	@brief A class for the counting semaphore of the platform within the process, which the light locks block on.
+
+	On Windows, the kernel semaphore is used.
+	On Linux, the count is the futex word, so Post wakes the waiters without the kernel object.
+	On the other POSIX platforms, the unnamed POSIX semaphore is used.
+	@remark the count has no maximum.
+	*/
+	class EP_LIBRARY PlatformSemaphore
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the semaphore with zero count.
+		*/
+		PlatformSemaphore();
+
+		/*!
+		Default Destructor
+
+		Destroys the semaphore
+		@remark no thread may be waiting on the semaphore.
+		*/
+		virtual ~PlatformSemaphore();
+
+		/*!
+		Take a count of the semaphore, waiting until available or timed out.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if taken, false if timed out
+		*/
+		bool Wait(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Give the counts to the semaphore, and wake the threads waiting for them.
+		@param[in] count the number of counts to give
+		@return true if succeeded otherwise false
+		*/
+		bool Post(long count=1);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		PlatformSemaphore(const PlatformSemaphore & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		PlatformSemaphore &operator=(const PlatformSemaphore & b){EP_ASSERT(0);return *this;}
+
+#if defined(EP_PLATFORM_WINDOWS)
+		/// the kernel semaphore
+		HANDLE m_sem;
+#elif defined(EP_PLATFORM_LINUX)
+		/// the count, which is the futex word
+		volatile int m_count;
+#else
+		/// the POSIX semaphore
+		sem_t m_sem;
+#endif
+	};
+}
+
+#endif //__EP_PLATFORM_SYNC_H__
@@ -39,12 +39,20 @@ An Interface for the Fast Prime Number Calculation.
 #define __EP_PRIME_NUM_H__
 
 #include "epLib.h"
+#include <vector>
+
+/// the number of odd numbers sieved per segment of PrimeNum::GetPrimes
+#define PRIME_NUM_SIEVE_SEGMENT_SIZE 32768
 
 namespace epl
 {
+	class ThreadPool;
+
 	/*! 
 	@class PrimeNum epPrimeNum.h
 	@brief A class that calculates Prime Number.
+
+	IsPrime runs the deterministic Miller-Rabin test, and GetPrimes runs the segmented sieve of Eratosthenes.
 	*/
 	class EP_LIBRARY PrimeNum
 	{
@@ -56,12 +64,42 @@ namespace epl
 		*/
 		static bool IsPrime(unsigned int x);
 
+		/*!
+		Check if the given 64-bit number is a prime number
+		@param[in] x the value to check if it is a prime number.
+		@return true if x is a prime number, false otherwise
+		*/
+		static bool IsPrime64(unsigned __int64 x);
+
 		/*!
 		Find the first prime number larger than given number.
 		@param[in] x the value to find a first prime number larger than x.
-		@return first prime number larger than x
+		@return first prime number larger than x, or 0 if no 32-bit prime is larger than x
 		*/
 		static unsigned int NextPrime(unsigned int x);
+
+		/*!
+		Find the first 64-bit prime number larger than given number.
+		@param[in] x the value to find a first prime number larger than x.
+		@return first prime number larger than x, or 0 if no 64-bit prime is larger than x
+		*/
+		static unsigned __int64 NextPrime64(unsigned __int64 x);
+
+		/*!
+		Return the prime capacity for the hash table, from the precomputed table growing about twice per step.
+		@param[in] minCapacity the minimum capacity required.
+		@return the smallest prime in the table not less than minCapacity, or NextPrime beyond the table
+		*/
+		static unsigned int GetPrimeCapacity(unsigned int minCapacity);
+
+		/*!
+		Generate all prime numbers between startNum and endNum inclusive, in ascending order.
+		@param[in] startNum the start number of the range
+		@param[in] endNum the end number of the range
+		@param[out] retPrimes the prime numbers appended
+		@param[in] pool the thread pool to sieve the segments in parallel (NULL to sieve on the calling thread)
+		*/
+		static void GetPrimes(unsigned int startNum, unsigned int endNum, std::vector<unsigned int> &retPrimes, ThreadPool *pool=NULL);
 	};
 }
-#endif //__EP_PRIME_NUM_H__
\ No newline at end of file
+#endif //__EP_PRIME_NUM_H__
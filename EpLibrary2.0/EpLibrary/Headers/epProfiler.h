@@ -39,6 +39,7 @@ An Interface for the Debugging Profiler.
 #include "epLib.h"
 #include "epBaseOutputter.h"
 #include "epSingletonHolder.h"
+#include "epLatencyHistogram.h"
 
 /*!
 @def PROFILE_INSTANCE
@@ -73,6 +74,33 @@ Macro that profiles the function where it called.
 #define PROFILE_THIS(varName) ((void)0)
 #endif
 
+/*!
+@def PROFILE_SCOPE
+@brief Simple Macro to profile the scope with the low overhead, in any build.
+
+Macro that profiles the scope where it called, when EP_ENABLE_SAMPLING_PROFILE is defined.
+The site is registered once on its first call, and each call after that only updates the slot of the calling thread.
+@param[in] varName the variable name for the profile
+@remark Usage: PROFILE_SCOPE(profile);
+*/
+#if defined(EP_ENABLE_SAMPLING_PROFILE)
+#define PROFILE_SCOPE(varName) static volatile long varName##SiteId=0; epl::ProfileSiteObj varName(varName##SiteId,__TFILE__,__TFUNCTION__,__LINE__)
+#else
+#define PROFILE_SCOPE(varName) ((void)0)
+#endif
+
+/// the maximum number of the sites PROFILE_SCOPE can profile
+#define PROFILE_MAX_SITE_COUNT 1024
+
+/// the default number of the calls per timed call of each site
+#define PROFILE_DEFAULT_SAMPLE_INTERVAL 16
+
+/// the maximum number of the call tree nodes of each thread
+#define PROFILE_MAX_CALL_TREE_NODE_COUNT 4096
+
+/// the maximum number of the hardware counters read around each timed call
+#define PROFILE_MAX_COUNTER_COUNT 4
+
 
 
 
@@ -217,15 +245,224 @@ namespace epl
 	};
 
 	
+	/*! 
+	@class ProfileCounterSource epProfiler.h
+	@brief An interface for the hardware counters read around each timed call of PROFILE_SCOPE.
+
+	The counters are read on the profiled thread, so the source must read the counters of the calling thread.
+	*/
+	class EP_LIBRARY ProfileCounterSource
+	{
+	public:
+		/*!
+		Default Destructor
+		*/
+		virtual ~ProfileCounterSource(){}
+
+		/*!
+		Return the number of the counters.
+		@return the number of the counters, at most PROFILE_MAX_COUNTER_COUNT.
+		*/
+		virtual unsigned int GetCounterCount() const=0;
+
+		/*!
+		Return the name of the counter written in the report.
+		@param[in] counterIdx the index of the counter.
+		@return the name of the counter.
+		*/
+		virtual const TCHAR *GetCounterName(unsigned int counterIdx) const=0;
+
+		/*!
+		Read the current values of the counters of the calling thread.
+		@param[out] retValues the values of the counters, GetCounterCount values.
+		*/
+		virtual void ReadCounters(unsigned __int64 *retValues)=0;
+	};
+
+#if (_MSC_VER >=MSVC90) && (WINVER>=WINDOWS_VISTA) // Only for VS2008 and above and Windows Vista and above
+	/*! 
+	@class ThreadCycleCounterSource epProfiler.h
+	@brief A counter source reading the CPU cycles of the calling thread with QueryThreadCycleTime.
+
+	The cycles are counted only while the thread runs, so the cycles per call against the time per call 
+	show how long the call waited for the I/O, the lock or the scheduler.
+	*/
+	class EP_LIBRARY ThreadCycleCounterSource:public ProfileCounterSource
+	{
+	public:
+		/*!
+		Return the number of the counters.
+		@return 1 for the cycles.
+		*/
+		virtual unsigned int GetCounterCount() const;
+
+		/*!
+		Return the name of the counter written in the report.
+		@param[in] counterIdx the index of the counter.
+		@return the name of the counter.
+		*/
+		virtual const TCHAR *GetCounterName(unsigned int counterIdx) const;
+
+		/*!
+		Read the CPU cycles of the calling thread.
+		@param[out] retValues the cycles.
+		*/
+		virtual void ReadCounters(unsigned __int64 *retValues);
+	};
+#endif //(_MSC_VER >=MSVC90) && (WINVER>=WINDOWS_VISTA)
+
+#if defined(_M_IX86) || defined(_M_X64)
+	/*! 
+	@class PmcCounterSource epProfiler.h
+	@brief A counter source reading the performance monitoring counters of the CPU with RDPMC.
+
+	The counters such as the instructions retired, the cache misses and the branch mispredictions 
+	must be programmed, and RDPMC must be allowed in the user mode, by the kernel driver or the tool owning the PMU 
+	before the source is used, otherwise RDPMC raises the exception.
+	*/
+	class EP_LIBRARY PmcCounterSource:public ProfileCounterSource
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] counterNames the names of the counters.
+		@param[in] pmcIndices the indices RDPMC reads for the counters.
+		@param[in] counterCount the number of the counters, at most PROFILE_MAX_COUNTER_COUNT.
+		*/
+		PmcCounterSource(const TCHAR * const *counterNames, const int *pmcIndices, unsigned int counterCount);
+
+		/*!
+		Return the number of the counters.
+		@return the number of the counters.
+		*/
+		virtual unsigned int GetCounterCount() const;
+
+		/*!
+		Return the name of the counter written in the report.
+		@param[in] counterIdx the index of the counter.
+		@return the name of the counter.
+		*/
+		virtual const TCHAR *GetCounterName(unsigned int counterIdx) const;
+
+		/*!
+		Read the performance monitoring counters.
+		@param[out] retValues the values of the counters.
+		*/
+		virtual void ReadCounters(unsigned __int64 *retValues);
+
+	private:
+		/// the names of the counters
+		EpTString m_counterNames[PROFILE_MAX_COUNTER_COUNT];
+		/// the indices RDPMC reads
+		int m_pmcIndices[PROFILE_MAX_COUNTER_COUNT];
+		/// the number of the counters
+		unsigned int m_counterCount;
+	};
+#endif //defined(_M_IX86) || defined(_M_X64)
+
+	/*! 
+	@struct ProfileSiteStat epProfiler.h
+	@brief The statistics of one profiled site on one thread.
+	*/
+	struct EP_LIBRARY ProfileSiteStat
+	{
+		/// the number of the calls
+		__int64 callCount;
+		/// the number of the calls timed
+		__int64 sampleCount;
+		/// the sum of the time of the calls timed in the ticks of Clock
+		__int64 totalTick;
+		/// the number of the calls timed with the hardware counters
+		__int64 counterSampleCount;
+		/// the sum of the hardware counters of the calls timed with them
+		__int64 counterTotals[PROFILE_MAX_COUNTER_COUNT];
+
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		*/
+		ProfileSiteStat();
+	};
+
+	/*! 
+	@class ProfileSiteObj epProfiler.h
+	@brief This is a class for profiling the scope of PROFILE_SCOPE.
+
+	Every call is counted, and one of every sample interval calls is timed with Clock.
+	While the call tree or the timeline is enabled, every call is timed.
+	*/
+	class EP_LIBRARY ProfileSiteObj
+	{
+	public:
+		/*!
+		Default Contructor
+
+		If PROFILE_SCOPE Macro is used the inputs are automatically generated.
+		@param[in] siteId the static ID of the site, which is 0 until the site is registered.
+		@param[in] fileName the file name of the caller
+		@param[in] functionName the function name of the caller
+		@param[in] lineNum the line number where it called
+		*/
+		ProfileSiteObj(volatile long &siteId, const TCHAR *fileName, const TCHAR *functionName, unsigned int lineNum);
+
+		/*!
+		Default Destructor
+		*/
+		~ProfileSiteObj();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ProfileSiteObj(const ProfileSiteObj & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ProfileSiteObj &operator=(const ProfileSiteObj & b){EP_ASSERT(0);return *this;}
+
+		/// the statistics of the site on the calling thread, or NULL if the site is not profiled
+		ProfileSiteStat *m_stat;
+		/// the tick of Clock when the call started, or 0 if the call is not timed
+		__int64 m_startTick;
+		/// the ID of the site
+		long m_siteId;
+		/// the index of the call tree node of this call, or -1 if not in the call tree
+		long m_treeNodeIdx;
+		/// the flag whether this call is recorded to the timeline
+		bool m_isTimeline;
+		/// the counter source read at the start of the call, or NULL if the counters are not read
+		ProfileCounterSource *m_counterSource;
+		/// the counters at the start of the call
+		unsigned __int64 m_startCounters[PROFILE_MAX_COUNTER_COUNT];
+	};
+
 	/*! 
 	@class ProfileManager epProfiler.h
 	@brief A class that manages the profile data.
+
+	The sites of PROFILE_SCOPE are accumulated into the slots of each thread without the lock,
+	and the slots are merged when printed or written to the file.
+	When the call tree is enabled, each thread also builds the tree of the nested sites
+	with the inclusive and the exclusive time of each path.
+	When the timeline is enabled, each thread keeps its last calls in the ring,
+	which is written as the Chrome trace event JSON, so it can be opened by chrome://tracing or Perfetto.
+	When the counter source is set, the hardware counters are also read around each timed call,
+	and their averages per call are reported alongside the time.
 	*/
 	class EP_LIBRARY ProfileManager:public BaseOutputter
 	{
 	public:
 		friend class SingletonHolder<ProfileManager>;
 		friend class Profiler;
+		friend class ProfileSiteObj;
 		
 		/*!
 		Assignment operator overloading
@@ -240,7 +477,77 @@ namespace epl
 		*/
 		virtual void FlushToFile();
 
-	
+		/*!
+		Print the all data to command line.
+		*/
+		virtual void Print() const;
+
+		/*!
+		Clear all the data.
+		@remark the sites stay registered, and report the calls after this call only.
+		*/
+		virtual void Clear();
+
+		/*!
+		Set the number of the calls per timed call of each site.
+		@param[in] sampleInterval the number of the calls, rounded up to the power of two. (1 to time every call)
+		*/
+		void SetSampleInterval(unsigned int sampleInterval);
+
+		/*!
+		Return the number of the calls per timed call of each site.
+		@return the number of the calls.
+		*/
+		unsigned int GetSampleInterval() const;
+
+		/*!
+		Enable or disable the call tree of the nested sites.
+		@param[in] isEnabled the flag whether to build the call tree.
+		@remark the call tree is not reset by Clear.
+		*/
+		void SetCallTreeEnabled(bool isEnabled);
+
+		/*!
+		Check if the call tree is enabled.
+		@return true if the call tree is enabled, otherwise false.
+		*/
+		bool IsCallTreeEnabled() const;
+
+		/*!
+		Set the number of the last calls each thread keeps for the timeline.
+		@param[in] capacity the number of the calls, rounded up to the power of two. (0 to disable the timeline)
+		@remark the ring of each thread is allocated on its first call recorded,
+		        so the capacity must be set before the threads start calling the sites.
+		*/
+		void SetTimelineCapacity(unsigned int capacity);
+
+		/*!
+		Return the number of the last calls each thread keeps for the timeline.
+		@return the number of the calls.
+		*/
+		unsigned int GetTimelineCapacity() const;
+
+		/*!
+		Write the timelines of all threads to the file, as the Chrome trace event JSON.
+		@param[in] fileName the name of the file, which is replaced.
+		@return true if the file is written, otherwise false.
+		@remark the calls recorded while writing may be torn, so it is best called when the threads are idle.
+		*/
+		bool WriteTimelineToFile(const TCHAR *fileName) const;
+
+		/*!
+		Set the source of the hardware counters read around each timed call.
+		@param[in] counterSource the counter source, or NULL to stop reading the counters.
+		@remark the source is not deleted by this manager, so it must live until this manager is destroyed or the source is replaced.
+		@remark the counters already summed belong to the previous source, so Clear is best called after the source is replaced.
+		*/
+		void SetCounterSource(ProfileCounterSource *counterSource);
+
+		/*!
+		Return the source of the hardware counters.
+		@return the counter source, or NULL if the counters are not read.
+		*/
+		ProfileCounterSource *GetCounterSource() const;
 
 	private:
 		/*!
@@ -336,6 +643,8 @@ namespace epl
 			int m_cnt;
 			/// The Total Profiling Time elapsed.
 			unsigned __int64 m_totalTime;
+			/// The histogram of the Profiling Time in milliseconds
+			LatencyHistogram m_histogram;
 
 		};
 
@@ -360,6 +669,210 @@ namespace epl
 		*/
 		void addProfile(const TCHAR *uniqueName, const unsigned __int64 &time);
 
+		/*! 
+		@struct ProfileTreeNode epProfiler.h
+		@brief The node of the call tree, which is one path of the nested sites.
+		*/
+		struct ProfileTreeNode
+		{
+			/// the ID of the site, or 0 for the root
+			long m_siteId;
+			/// the index of the parent node
+			long m_parentIdx;
+			/// the index of the first child node, or -1 if none
+			long m_firstChildIdx;
+			/// the index of the next sibling node, or -1 if none
+			long m_nextSiblingIdx;
+			/// the number of the calls
+			__int64 m_callCount;
+			/// the sum of the time of the calls in the ticks of Clock
+			__int64 m_inclusiveTick;
+			/// the sum of the time of the child calls in the ticks of Clock
+			__int64 m_childTick;
+		};
+
+		/*! 
+		@struct ProfileTimelineEvent epProfiler.h
+		@brief One call recorded in the timeline.
+		*/
+		struct ProfileTimelineEvent
+		{
+			/// the ID of the site
+			long m_siteId;
+			/// the tick of Clock when the call started
+			__int64 m_startTick;
+			/// the tick of Clock when the call ended
+			__int64 m_endTick;
+		};
+
+		/*! 
+		@struct ProfileThreadSlot epProfiler.h
+		@brief The statistics of all sites on one thread.
+
+		Only the owner thread writes the slot, and the nodes and the events are published by their counts.
+		The slot is padded at both ends, so the slots of the threads never share the cache line.
+		*/
+		struct ProfileThreadSlot
+		{
+			/*!
+			Default Constructor
+
+			Initializes the slot of the calling thread
+			*/
+			ProfileThreadSlot();
+
+			/*!
+			Default Destructor
+
+			Free the call tree and the timeline
+			*/
+			~ProfileThreadSlot();
+
+			/// the padding to the slot of the thread allocated before
+			char m_headPadding[EP_CACHE_LINE_SIZE];
+			/// the statistics indexed by the site ID minus one
+			ProfileSiteStat m_stats[PROFILE_MAX_SITE_COUNT];
+			/// the histograms of the time of the calls timed in the ticks of Clock, or NULL until the first call timed
+			LatencyHistogram * volatile m_histograms[PROFILE_MAX_SITE_COUNT];
+			/// the ID of the owner thread
+			unsigned long m_threadId;
+			/// the call tree nodes, or NULL until the first call in the call tree
+			ProfileTreeNode * volatile m_treeNodes;
+			/// the number of the call tree nodes
+			volatile long m_treeNodeCount;
+			/// the index of the call tree node of the innermost call
+			long m_currentNodeIdx;
+			/// the timeline ring, or NULL until the first call recorded
+			ProfileTimelineEvent * volatile m_timeline;
+			/// the mask of the timeline ring index
+			unsigned long m_timelineMask;
+			/// the number of the calls recorded to the timeline
+			volatile long m_timelineCount;
+			/// the padding to the slot of the thread allocated after
+			char m_tailPadding[EP_CACHE_LINE_SIZE];
+		};
+
+		/*! 
+		@struct ProfileSite epProfiler.h
+		@brief The registered site.
+		*/
+		struct ProfileSite
+		{
+			/// the name of the site
+			EpTString m_uniqueName;
+			/// the merged statistics when Clear was called
+			ProfileSiteStat m_baseStat;
+			/// the merged histogram when Clear was called, or NULL if never cleared
+			LatencyHistogram *m_baseHistogram;
+		};
+
+		/*!
+		Initialize the sites and the thread slots.
+		*/
+		void initSites();
+
+		/*!
+		Register the site, or find the site already registered with the same name.
+		@param[in] fileName the file name of the site
+		@param[in] functionName the function name of the site
+		@param[in] lineNum the line number of the site
+		@return the ID of the site, or -1 if PROFILE_MAX_SITE_COUNT sites are already registered.
+		*/
+		long registerSite(const TCHAR *fileName, const TCHAR *functionName, unsigned int lineNum);
+
+		/*!
+		Return the statistics of the site on the calling thread, creating the slot of the thread if none.
+		@param[in] siteId the ID of the site.
+		@return the statistics of the site.
+		*/
+		ProfileSiteStat *getSiteStat(long siteId);
+
+		/*!
+		Return the histogram of the site on the calling thread, creating it if none.
+		@param[in] siteId the ID of the site.
+		@return the histogram of the site.
+		@remark the slot of the calling thread must be created by getSiteStat already.
+		*/
+		LatencyHistogram *getSiteHistogram(long siteId);
+
+		/*!
+		Enter the child node of the site under the innermost call of the calling thread.
+		@param[in] siteId the ID of the site.
+		@return the index of the node entered, or -1 if PROFILE_MAX_CALL_TREE_NODE_COUNT nodes are already used.
+		*/
+		long enterTreeNode(long siteId);
+
+		/*!
+		Leave the call tree node, and add the time of the call to it and to its parent.
+		@param[in] nodeIdx the index of the node returned by enterTreeNode.
+		@param[in] elapsedTick the time of the call in the ticks of Clock.
+		*/
+		void leaveTreeNode(long nodeIdx, __int64 elapsedTick);
+
+		/*!
+		Record the call to the timeline of the calling thread.
+		@param[in] siteId the ID of the site.
+		@param[in] startTick the tick of Clock when the call started.
+		@param[in] endTick the tick of Clock when the call ended.
+		*/
+		void recordTimeline(long siteId, __int64 startTick, __int64 endTick);
+
+		/*!
+		Format the call tree under given node into given string, one node per line.
+		@param[in] slot the thread slot of the call tree.
+		@param[in] nodeIdx the index of the node to format.
+		@param[in] depth the depth of the node.
+		@param[in,out] retString the string to append to.
+		*/
+		void formatTreeNode(const ProfileThreadSlot *slot, long nodeIdx, unsigned int depth, EpTString &retString) const;
+
+		/*!
+		Format the call trees of all threads into given string.
+		@param[out] retString the formatted string.
+		*/
+		void formatCallTree(EpTString &retString) const;
+
+		/*!
+		Convert the ticks of Clock to the microseconds.
+		@param[in] tick the ticks of Clock.
+		@return the microseconds.
+		*/
+		double toMicroSec(__int64 tick) const;
+
+		/*!
+		Sum the statistics and the histograms of the site over all thread slots.
+		@param[in] siteIdx the index of the site.
+		@param[out] retStat the merged statistics.
+		@param[out] retHistogram the merged histogram.
+		@remark the slots are read while their threads update them, so the values may be slightly behind.
+		*/
+		void mergeSite(size_t siteIdx, ProfileSiteStat &retStat, LatencyHistogram &retHistogram) const;
+
+		/*!
+		Format the merged statistics of the site into given string.
+		@param[in] siteIdx the index of the site.
+		@param[out] retString the formatted string.
+		*/
+		void formatSite(size_t siteIdx, EpTString &retString) const;
+
+		/// the TLS index of the thread slot
+		unsigned long m_tlsIndex;
+		/// the thread slots, kept until this manager is destroyed so the exited threads are still reported
+		std::vector<ProfileThreadSlot*> m_slotList;
+		/// the registered sites
+		std::vector<ProfileSite> m_siteList;
+		/// the mask of the call count selecting the calls timed
+		volatile long m_sampleMask;
+		/// the frequency of Clock
+		__int64 m_tickFrequency;
+		/// the tick of Clock when this manager is created, the origin of the timeline
+		__int64 m_originTick;
+		/// the flag whether the call tree is enabled
+		volatile bool m_isCallTreeEnabled;
+		/// the capacity of the timeline ring of each thread (0 if the timeline is disabled)
+		volatile long m_timelineCapacity;
+		/// the source of the hardware counters, or NULL if the counters are not read
+		ProfileCounterSource * volatile m_counterSource;
 	};
 
 }
@@ -50,6 +50,10 @@ namespace epl{
 	/*!
 	@class PropertiesFile epPropertiesFile.h
 	@brief A class for Peroperties File.
+
+	The properties are kept in the file order for writing, and indexed by the hash of their keys,
+	so the lookups by the key do not scan the list or build the temporary strings.
+	The lookups share the lock when created with LOCK_POLICY_READER_WRITER.
 	*/
 	class EP_LIBRARY PropertiesFile:public BaseTextFile{
 	public:
@@ -171,17 +175,58 @@ namespace epl{
 		virtual void loadFromFile(const EpTString &lines);
 
 		/*!
-		Parse the key and value from the line buffer
-		@param[in] buf the buffer that holds a line
-		@param[out] retKey the key part of the given line
-		@param[out] retVal the value part of the given line
-		@return true if successfully parsed the key and value, otherwise false
+		Load Function that parses the properties from each line read
+		@param[in] reader the reader of the file opened
+		*/
+		virtual void loadFromReader(TextLineReader &reader);
+
+		/*!
+		Add the property parsed from the given line to the list
+		@param[in] line the first character of the line
+		@param[in] lineLength the number of the characters of the line
+		*/
+		void addPropertyLine(const TCHAR *line, size_t lineLength);
+
+		/*!
+		Find the range of the given string without the leading and trailing spaces, as Locale::Trim does.
+		@param[in] str the first character of the string to trim
+		@param[in] strLength the number of the characters of the string
+		@param[out] retBegin the first character of the trimmed string
+		@param[out] retLength the number of the characters of the trimmed string
+		*/
+		static void trimRange(const TCHAR *str, size_t strLength, const TCHAR *&retBegin, size_t &retLength);
+
+		/*!
+		Return the index of the property with the given key in the list
+		@param[in] key the key of the property to find
+		@return the index of the property, or the size of the list if not found
 		*/
-		bool getValueKeyFromLine(const EpTString &buf, EpTString &retKey, EpTString &retVal);
+		size_t findProperty(const TCHAR *key) const;
+
+		/*!
+		Add the property in the list at given index to the hash index
+		@param[in] propertyIdx the index of the property in the list
+		@remark the line which is not a property, and the key already indexed are skipped, so the first one is found as before.
+		*/
+		void indexProperty(size_t propertyIdx);
+
+		/*!
+		Rebuild the hash index from the list of the properties
+		*/
+		void rebuildIndex();
 
 		/// The list of the properties
 		vector<Pair<EpTString,EpTString> > m_propertyList;
 
+		/// the slots of the hash index, each holding the index of the property in the list plus one, or 0 if empty
+		vector<size_t> m_indexSlotList;
+
+		/// the hashes of the keys in the slots of the hash index
+		vector<size_t> m_indexHashList;
+
+		/// the number of the properties in the hash index
+		size_t m_indexedCount;
+
 		/// Null String
 		EpTString m_nullString;
 	};
@@ -0,0 +1,192 @@
+/*! 
+@file epQueueBound.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Queue Capacity Bound Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Queue Capacity Bound Class.
+
+*/
+#ifndef __EP_QUEUE_BOUND_H__
+#define __EP_QUEUE_BOUND_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseLock.h"
+#include "epEventEx.h"
+
+namespace epl
+{
+	/// Overflow Policy for the bounded queue
+	typedef enum _overflowPolicy{
+		/// Block the producer until the room is made
+		OVERFLOW_POLICY_BLOCK=0,
+		/// Reject the new item, and return false to the producer
+		OVERFLOW_POLICY_FAIL,
+		/// Drop the oldest item to make the room for the new item
+		OVERFLOW_POLICY_DROP_OLDEST,
+		/// Drop the new item, and return true to the producer
+		OVERFLOW_POLICY_DROP_NEWEST,
+	}OverflowPolicy;
+
+	/*! 
+	@class QueueBound epQueueBound.h
+	@brief A class for the capacity bound of the queue.
+
+	The owner queue calls Admit and the Notify functions with its own lock held,
+	so the bound adds no lock of its own.
+	The capacity 0 means unbounded, which costs one comparison per push.
+	*/
+	class EP_LIBRARY QueueBound
+	{
+	public:
+		/// Enumerator for the admission result
+		enum Admission
+		{
+			/// The new item can be inserted.
+			ADMISSION_ACCEPT=0,
+			/// The queue is full, and the producer must wait with WaitNotFull.
+			ADMISSION_WAIT,
+			/// The queue is full, and the oldest item must be dropped before inserting the new item.
+			ADMISSION_DROP_OLDEST,
+			/// The queue is full, and the new item is rejected.
+			ADMISSION_REJECT,
+			/// The queue is full, and the new item is dropped.
+			ADMISSION_DROP_NEWEST,
+		};
+
+		/*!
+		Default Constructor
+
+		Initializes the unbounded queue bound
+		*/
+		QueueBound();
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the queue bound with the capacity and the policy of the given bound
+		@param[in] b the second object
+		@remark the counters and the waiters are not copied.
+		*/
+		QueueBound(const QueueBound& b);
+
+		/*!
+		Default Destructor
+
+		Destroy the queue bound
+		*/
+		virtual ~QueueBound();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark the counters and the waiters are not copied.
+		*/
+		QueueBound & operator=(const QueueBound&b);
+
+		/*!
+		Set the capacity and the overflow policy.
+		@param[in] capacity the maximum number of items in the queue. (0 for unbounded)
+		@param[in] policy the overflow policy when the queue is full.
+		@remark the producers blocked are woken to check the new capacity.
+		*/
+		void SetCapacity(size_t capacity, OverflowPolicy policy=OVERFLOW_POLICY_BLOCK);
+
+		/*!
+		Return the capacity.
+		@return the maximum number of items in the queue, or 0 if unbounded.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Return the overflow policy.
+		@return the overflow policy when the queue is full.
+		*/
+		OverflowPolicy GetOverflowPolicy() const;
+
+		/*!
+		Return the highest number of items the queue held since the last reset.
+		@return the high-water mark.
+		*/
+		size_t GetHighWaterMark() const;
+
+		/*!
+		Reset the high-water mark to 0.
+		*/
+		void ResetHighWaterMark();
+
+		/*!
+		Return the number of items dropped or rejected by the overflow policy.
+		@return the number of items dropped or rejected.
+		*/
+		size_t GetDropCount() const;
+
+		/*!
+		Decide how to insert the new item, the owner lock must be held.
+		@param[in] curSize the current number of items in the queue.
+		@return the admission result.
+		*/
+		Admission Admit(size_t curSize);
+
+		/*!
+		Sleep until an item is removed, the owner lock must be held.
+		@param[in] lock the owner lock, released while sleeping.
+		*/
+		void WaitNotFull(BaseLock *lock);
+
+		/*!
+		Update the high-water mark after the push, the owner lock must be held.
+		@param[in] newSize the number of items in the queue after the push.
+		*/
+		void NotifyPushed(size_t newSize);
+
+		/*!
+		Wake the blocked producers after the removal, the owner lock must be held.
+		*/
+		void NotifyPopped();
+
+	private:
+		/// the capacity (0 for unbounded)
+		volatile size_t m_capacity;
+		/// the overflow policy
+		volatile OverflowPolicy m_overflowPolicy;
+		/// the high-water mark
+		volatile long m_highWaterMark;
+		/// the number of items dropped or rejected
+		volatile long m_dropCount;
+		/// not-full event, created by the first producer to sleep
+		EventEx *m_notFullEvent;
+		/// the number of producers sleeping on the not-full event
+		volatile long m_waiterCount;
+	};
+}
+#endif //__EP_QUEUE_BOUND_H__
\ No newline at end of file
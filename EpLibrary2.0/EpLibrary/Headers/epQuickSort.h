@@ -40,9 +40,18 @@ An Interface for Quick Sort Algorithm Function.
 #include "epLib.h"
 #include "epInsertionSort.h"
 #include "epSystem.h"
+#include "epParallel.h"
 #include <stack>
+#include <algorithm>
 using namespace std;
 
+/// the minimum size of both partitions to sort them on the different threads in QSORT_MODE_PARALLEL
+#define QSORT_PARALLEL_CUTOFF 32768
+/// the minimum size for the insertion sort when not given
+#define QSORT_DEFAULT_MIN_SIZE 16
+/// the minimum size of the list to take the median of three medians as the pivot
+#define QSORT_NINTHER_SIZE 128
+
 namespace epl
 {
 	/// Enumeration Type for QSort Mode
@@ -52,105 +61,23 @@ namespace epl
 		/// QSort Mode using Recursive operation
 		QSORT_MODE_RECURSIVE,
 		/// QSort Mode using Loop operation
-		QSORT_MODE_LOOP
+		QSORT_MODE_LOOP,
+		/// QSort Mode forking the partitions onto the thread pool
+		QSORT_MODE_PARALLEL
 	}QSortMode;
 
 
-	/*!
-	Template Quick Sort Function
-
-	Sort the given list with Sort Function Pointer.
-	@param[in] sortList The list to sort.
-	@param[in] listSize The size of the list.
-	@param[in] SortFunc The Compare Function pointer.
-	@param[in] mode The QSort Mode
-	@param[in] minSize the minimum size for the insertion sort start
-	*/
-	template <typename T>
-	void QuickSort (T* sortList,const size_t listSize,CompResultType (__cdecl *SortFunc)(const void * , const void *), QSortMode mode=QSORT_MODE_STL, ssize_t minSize=-1)
-	{
-		if(mode==QSORT_MODE_STL)
-		{
-			qsort(sortList,listSize,sizeof(T),(int (__cdecl *)(const void *,const void *))SortFunc);
-		}
-		else
-		{
-			if (sortList == NULL || listSize<=1)
-			{
-				return;
-			}
-			if(minSize<0 || minSize>ssize_t(listSize))
-				minSize=ssize_t(listSize)/2;
-			if(mode==QSORT_MODE_RECURSIVE)
-				subQuickSortRecursive<T>(sortList,0,listSize-1,SortFunc, minSize);
-			else if(mode==QSORT_MODE_LOOP)
-				subQuickSortLoop<T>(sortList,0,listSize-1,SortFunc, minSize);
-
-		}
-		
-		
-	}
-
-	/*!
-	Sub Function for Quick Sort with Recursive Operation.
-	@param[in] sortList The list to sort.
-	@param[in] low the low index of the list.
-	@param[in] high the high index of the list.
-	@param[in] SortFunc The Compare Function pointer.
-	@param[in] minSize the minimum size of the list for insertion Sort operation
-	*/
-	template<typename T>
-	inline void subQuickSortRecursive(T* sortList, size_t low, size_t high,CompResultType (__cdecl *SortFunc)(const void * , const void *), ssize_t minSize)
-	{
-		if(high>low+1)
-		{
-			if((high-low)+1<=minSize)
-			{
-				InsertionSort<T>(sortList,low,high,SortFunc);
-			}
-			else
-			{
-				ssize_t index = partitionWrapper<T>(sortList, low, high,SortFunc);
-				if (index>=1)
-					subQuickSortRecursive<T>(sortList, low, index-1,SortFunc, minSize);
-				subQuickSortRecursive<T>(sortList,index+1, high,SortFunc,minSize);
-			}
-		}
-		else if((high==low+1)&& SortFunc(&sortList[low],&sortList[high])>COMP_RESULT_EQUAL)
-		{
-			SwapFunc<T>(&sortList[low],&sortList[high]);
-		}
-	}
-
-
-	/*!
-	Wrapper Function of partition function of Quick Sort with Recursive Operation.
-	@param[in] sortList The list to sort.
-	@param[in] low the low index of the list.
-	@param[in] high the high index of the list.
-	@param[in] SortFunc The Compare Function pointer.
-	@return the median index
-	*/
-	template<typename T>
-	inline size_t partitionWrapper(T* sortList, size_t low, size_t high,CompResultType (__cdecl *SortFunc)(const void * , const void *))
-	{
-		SwapFunc<T>(&sortList[low], &sortList[medianLocation<T>(sortList,low+1,high,(low+high)/2,SortFunc)]);
-		size_t med=partition<T>(sortList, low+1, high, sortList[low],SortFunc);
-		SwapFunc<T>(&sortList[low],&sortList[med]);
-		return med;
-	}
-
 	/*!
 	Median Locator Function for Quick Sort with Recursive Operation.
 	@param[in] sortList The list to sort.
 	@param[in] i the low index of the possible median.
 	@param[in] j the middle index of the possible median.
 	@param[in] k the high index of the possible median.
-	@param[in] SortFunc The Compare Function pointer.
+	@param[in] SortFunc The Compare Function pointer or functor.
 	@return the median index
 	*/
-	template<typename T>
-	inline size_t medianLocation(T* sortList, size_t i, size_t j, size_t k,CompResultType (__cdecl *SortFunc)(const void * , const void *))
+	template<typename T,typename CompFuncType>
+	inline size_t medianLocation(T* sortList, size_t i, size_t j, size_t k,CompFuncType SortFunc)
 	{
 		if (SortFunc(&sortList[i] , &sortList[j])<COMP_RESULT_GREATERTHAN)
 			if (SortFunc(&sortList[j] , &sortList[k])<COMP_RESULT_GREATERTHAN)
@@ -174,11 +101,11 @@ namespace epl
 	@param[in] low the low index of the list.
 	@param[in] high the high index of the list.
 	@param[in] pivot the pivot index of the list
-	@param[in] SortFunc The Compare Function pointer.
+	@param[in] SortFunc The Compare Function pointer or functor.
 	@return the median index
 	*/
-	template<typename T>
-	inline size_t partition(T* sortList, size_t low, size_t high, T &pivot,CompResultType (__cdecl *SortFunc)(const void * , const void *))
+	template<typename T,typename CompFuncType>
+	inline size_t partition(T* sortList, size_t low, size_t high, T &pivot,CompFuncType SortFunc)
 	{
 		while(high!=low)
 		{
@@ -207,27 +134,236 @@ namespace epl
 			return low-1;
 	}
 
+	/*!
+	Wrapper Function of partition function of Quick Sort with Recursive Operation.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@return the median index
+	*/
+	template<typename T,typename CompFuncType>
+	inline size_t partitionWrapper(T* sortList, size_t low, size_t high,CompFuncType SortFunc)
+	{
+		SwapFunc<T>(&sortList[low], &sortList[medianLocation<T>(sortList,low+1,high,(low+high)/2,SortFunc)]);
+		size_t med=partition<T>(sortList, low+1, high, sortList[low],SortFunc);
+		SwapFunc<T>(&sortList[low],&sortList[med]);
+		return med;
+	}
+
+	/*!
+	Pivot Locator Function for Quick Sort.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@return the pivot index
+	@remark the large list takes the median of three medians, so the patterned input does not keep picking the bad pivot.
+	*/
+	template<typename T,typename CompFuncType>
+	inline size_t pivotLocation(T* sortList, size_t low, size_t high,CompFuncType SortFunc)
+	{
+		size_t listSize=(high-low)+1;
+		size_t mid=low+listSize/2;
+		if(listSize<=QSORT_NINTHER_SIZE)
+			return medianLocation<T>(sortList,low+1,high,mid,SortFunc);
+		size_t step=listSize/8;
+		size_t lowMed=medianLocation<T>(sortList,low,low+step,low+step*2,SortFunc);
+		size_t midMed=medianLocation<T>(sortList,mid-step,mid,mid+step,SortFunc);
+		size_t highMed=medianLocation<T>(sortList,high-step*2,high-step,high,SortFunc);
+		return medianLocation<T>(sortList,lowMed,midMed,highMed,SortFunc);
+	}
+
+	/*!
+	Three-way partition function of Quick Sort.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[out] retLess the index of the first element equal to the pivot.
+	@param[out] retGreater the index of the last element equal to the pivot.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@remark the elements equal to the pivot are gathered in the middle, so the large range of the same keys is not partitioned again.
+	*/
+	template<typename T,typename CompFuncType>
+	inline void partitionThreeWay(T* sortList, size_t low, size_t high, size_t &retLess, size_t &retGreater,CompFuncType SortFunc)
+	{
+		SwapFunc<T>(&sortList[low], &sortList[pivotLocation<T>(sortList,low,high,SortFunc)]);
+		T pivot=sortList[low];
+		size_t lessIdx=low;
+		size_t greaterIdx=high;
+		size_t trav=low+1;
+		while(trav<=greaterIdx)
+		{
+			CompResultType res=SortFunc(&sortList[trav],&pivot);
+			if(res<COMP_RESULT_EQUAL)
+			{
+				SwapFunc<T>(&sortList[lessIdx],&sortList[trav]);
+				lessIdx++;
+				trav++;
+			}
+			else if(res>COMP_RESULT_EQUAL)
+			{
+				SwapFunc<T>(&sortList[trav],&sortList[greaterIdx]);
+				greaterIdx--;
+			}
+			else
+				trav++;
+		}
+		retLess=lessIdx;
+		retGreater=greaterIdx;
+	}
+
+	/*!
+	Check if the given list is already sorted, and reverse it if sorted in descending order.
+	@param[in] sortList The list to check.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@return true if the list is sorted on return, otherwise false.
+	@remark the scan stops at the first element breaking both orders, so the random list costs only a few comparisons.
+	*/
+	template<typename T,typename CompFuncType>
+	inline bool sortRun(T* sortList, size_t low, size_t high,CompFuncType SortFunc)
+	{
+		bool isAscending=true;
+		bool isDescending=true;
+		for(size_t trav=low;trav<high && (isAscending || isDescending);trav++)
+		{
+			CompResultType res=SortFunc(&sortList[trav],&sortList[trav+1]);
+			if(res>COMP_RESULT_EQUAL)
+				isAscending=false;
+			else if(res<COMP_RESULT_EQUAL)
+				isDescending=false;
+		}
+		if(isAscending)
+			return true;
+		if(isDescending)
+		{
+			std::reverse(sortList+low,sortList+high+1);
+			return true;
+		}
+		return false;
+	}
+
+	/*!
+	Swap a few elements of the given partition to break the pattern after the unbalanced partition.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the partition.
+	@param[in] high the high index of the partition.
+	*/
+	template<typename T>
+	inline void breakPattern(T* sortList, size_t low, size_t high)
+	{
+		size_t listSize=(high-low)+1;
+		if(listSize<8)
+			return;
+		SwapFunc<T>(&sortList[low],&sortList[low+listSize/4]);
+		SwapFunc<T>(&sortList[high],&sortList[high-listSize/4]);
+	}
+
+	/*!
+	Heap Sort Function for the fallback of Quick Sort when the depth limit is reached.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	*/
+	template<typename T,typename CompFuncType>
+	inline void subHeapSort(T* sortList, size_t low, size_t high,CompFuncType SortFunc)
+	{
+		std::make_heap(sortList+low,sortList+high+1,CompLess<T,CompFuncType>(SortFunc));
+		std::sort_heap(sortList+low,sortList+high+1,CompLess<T,CompFuncType>(SortFunc));
+	}
+
+	/*!
+	Return the depth limit of Quick Sort for the list of given size.
+	@param[in] listSize the size of the list.
+	@return the depth limit, twice the log2 of the size.
+	*/
+	inline size_t quickSortDepthLimit(size_t listSize)
+	{
+		size_t retDepth=0;
+		while(listSize>1)
+		{
+			retDepth+=2;
+			listSize>>=1;
+		}
+		return retDepth;
+	}
+
+	/*!
+	Sub Function for Quick Sort with Recursive Operation.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] minSize the minimum size of the list for insertion Sort operation
+	@param[in] depthLimit the number of partition levels left before the heap sort fallback
+	*/
+	template<typename T,typename CompFuncType>
+	inline void subQuickSortRecursive(T* sortList, size_t low, size_t high,CompFuncType SortFunc, ssize_t minSize, size_t depthLimit)
+	{
+		if(high>low+1)
+		{
+			if((high-low)+1<=minSize)
+			{
+				InsertionSort<T>(sortList,low,high,SortFunc);
+			}
+			else if(depthLimit==0)
+			{
+				subHeapSort<T>(sortList,low,high,SortFunc);
+			}
+			else if(!sortRun<T>(sortList,low,high,SortFunc))
+			{
+				size_t lessIdx;
+				size_t greaterIdx;
+				partitionThreeWay<T>(sortList,low,high,lessIdx,greaterIdx,SortFunc);
+				size_t leftSize=lessIdx-low;
+				size_t rightSize=high-greaterIdx;
+				size_t listSize=(high-low)+1;
+				if(leftSize<listSize/8 || rightSize<listSize/8)
+				{
+					if(leftSize>0)
+						breakPattern<T>(sortList,low,lessIdx-1);
+					if(rightSize>0)
+						breakPattern<T>(sortList,greaterIdx+1,high);
+				}
+				if (leftSize>0)
+					subQuickSortRecursive<T>(sortList, low, lessIdx-1,SortFunc, minSize,depthLimit-1);
+				if (rightSize>0)
+					subQuickSortRecursive<T>(sortList,greaterIdx+1, high,SortFunc,minSize,depthLimit-1);
+			}
+		}
+		else if((high==low+1)&& SortFunc(&sortList[low],&sortList[high])>COMP_RESULT_EQUAL)
+		{
+			SwapFunc<T>(&sortList[low],&sortList[high]);
+		}
+	}
+
 	/*!
 	Sub Function for Quick Sort with Loop Operation.
 	@param[in] sortList The list to sort.
 	@param[in] iLow the low index of the list.
 	@param[in] iHigh the high index of the list.
-	@param[in] SortFunc The Compare Function pointer.
+	@param[in] SortFunc The Compare Function pointer or functor.
 	@param[in] minSize the minimum size of the list for insertion Sort operation
+	@param[in] depthLimit the number of partition levels left before the heap sort fallback
 	*/
-	template<typename T>
-	inline void subQuickSortLoop(T* sortList, size_t iLow, size_t iHigh,CompResultType (__cdecl *SortFunc)(const void *,const void *),ssize_t minSize)
+	template<typename T,typename CompFuncType>
+	inline void subQuickSortLoop(T* sortList, size_t iLow, size_t iHigh,CompFuncType SortFunc,ssize_t minSize, size_t depthLimit)
 	{
 		struct SnapShotStruct
 		{
 			size_t low;
 			size_t high;
+			size_t depthLimit;
 		};
 
 		stack<SnapShotStruct> snapshotStack;
 		SnapShotStruct currentSnaptshot;
 		currentSnaptshot.low=iLow;
 		currentSnaptshot.high=iHigh;
+		currentSnaptshot.depthLimit=depthLimit;
 		snapshotStack.push(currentSnaptshot);
 		while(!snapshotStack.empty())
 		{
@@ -240,100 +376,230 @@ namespace epl
 				{
 					InsertionSort<T>(sortList,currentSnaptshot.low,currentSnaptshot.high,SortFunc);
 				}
-				else
+				else if(currentSnaptshot.depthLimit==0)
 				{
-					size_t i=currentSnaptshot.low+1;
-					size_t j=(currentSnaptshot.low+currentSnaptshot.high)/2;
-					size_t k=currentSnaptshot.high;
-					size_t medLoc;
-					if (SortFunc(&sortList[i] , &sortList[j])<COMP_RESULT_GREATERTHAN)
-						if (SortFunc(&sortList[j] , &sortList[k])<COMP_RESULT_GREATERTHAN)
-							medLoc=j;
-						else if (SortFunc(&sortList[i] , &sortList[k])<COMP_RESULT_GREATERTHAN)
-							medLoc=k;
-						else
-							medLoc=i;
-					else // sortList[j] < sortList[i]
-						if (SortFunc(&sortList[i] , &sortList[k])<COMP_RESULT_GREATERTHAN)
-							medLoc=i;
-						else if (SortFunc(&sortList[j] , &sortList[k])<COMP_RESULT_GREATERTHAN)
-							medLoc=k;
-						else
-							medLoc=j;
-
-						T tmp;
-						tmp=sortList[currentSnaptshot.low];
-						sortList[currentSnaptshot.low]=sortList[medLoc];
-						sortList[medLoc]=tmp;
-
-						T &pivot=sortList[currentSnaptshot.low];
-						size_t relHigh=currentSnaptshot.high;
-						size_t relLow=currentSnaptshot.low+1;
-						CompResultType res1=SortFunc(&sortList[relLow],&pivot);
-						CompResultType res2=SortFunc(&sortList[relHigh],&pivot);
-						while(relHigh!=relLow)
-						{
-							if(res1<COMP_RESULT_GREATERTHAN)
-							{
-								relLow++;
-								res1=SortFunc(&sortList[relLow],&pivot);
-								if(res2>COMP_RESULT_LESSTHAN && relHigh>relLow)
-								{
-									relHigh--;
-									res2=SortFunc(&sortList[relHigh],&pivot);
-								}
-							}
-							else if(res2>COMP_RESULT_LESSTHAN)
-							{
-								relHigh--;
-								res2=SortFunc(&sortList[relHigh],&pivot);
-							}
-							else
-							{
-								tmp=sortList[relLow];
-								sortList[relLow]=sortList[relHigh];
-								sortList[relHigh]=tmp;
-								relLow++;
-								res1=SortFunc(&sortList[relLow],&pivot);
-								if(relHigh>relLow)
-								{
-									relHigh--;
-									res2=SortFunc(&sortList[relHigh],&pivot);
-								}
-							}
-						}
-						size_t med;
-						if (SortFunc(&sortList[relLow], &pivot) < COMP_RESULT_EQUAL)
-							med= relLow;
-						else
-							med= relLow-1;
-						tmp=sortList[currentSnaptshot.low];
-						sortList[currentSnaptshot.low]=sortList[med];
-						sortList[med]=tmp;
-						size_t index = med;
-
-						SnapShotStruct leftHalf,rightHalf;
-						leftHalf.low=currentSnaptshot.low;
-						leftHalf.high=index-1;
-						if (index>=1)
-							snapshotStack.push(leftHalf);
-
+					subHeapSort<T>(sortList,currentSnaptshot.low,currentSnaptshot.high,SortFunc);
+				}
+				else if(!sortRun<T>(sortList,currentSnaptshot.low,currentSnaptshot.high,SortFunc))
+				{
+					size_t lessIdx;
+					size_t greaterIdx;
+					partitionThreeWay<T>(sortList,currentSnaptshot.low,currentSnaptshot.high,lessIdx,greaterIdx,SortFunc);
+					size_t leftSize=lessIdx-currentSnaptshot.low;
+					size_t rightSize=currentSnaptshot.high-greaterIdx;
+					size_t listSize=(currentSnaptshot.high-currentSnaptshot.low)+1;
+					if(leftSize<listSize/8 || rightSize<listSize/8)
+					{
+						if(leftSize>0)
+							breakPattern<T>(sortList,currentSnaptshot.low,lessIdx-1);
+						if(rightSize>0)
+							breakPattern<T>(sortList,greaterIdx+1,currentSnaptshot.high);
+					}
 
-						rightHalf.low=index+1;
-						rightHalf.high=currentSnaptshot.high;
-						snapshotStack.push(rightHalf);
+					SnapShotStruct leftHalf,rightHalf;
+					leftHalf.low=currentSnaptshot.low;
+					leftHalf.high=lessIdx-1;
+					leftHalf.depthLimit=currentSnaptshot.depthLimit-1;
+					rightHalf.low=greaterIdx+1;
+					rightHalf.high=currentSnaptshot.high;
+					rightHalf.depthLimit=currentSnaptshot.depthLimit-1;
+					// push the larger half first, so the stack holds at most log2 of the size
+					if(leftSize>rightSize)
+					{
+						if(leftSize>0)
+							snapshotStack.push(leftHalf);
+						if(rightSize>0)
+							snapshotStack.push(rightHalf);
+					}
+					else
+					{
+						if(rightSize>0)
+							snapshotStack.push(rightHalf);
+						if(leftSize>0)
+							snapshotStack.push(leftHalf);
+					}
 				}
 			}
 			else if((currentSnaptshot.high==currentSnaptshot.low+1)&& SortFunc(&sortList[currentSnaptshot.low],&sortList[currentSnaptshot.high])>COMP_RESULT_EQUAL)
 			{
-				T tmp;
-				tmp=sortList[currentSnaptshot.low];
-				sortList[currentSnaptshot.low]=sortList[currentSnaptshot.high];
-				sortList[currentSnaptshot.high]=tmp;
+				SwapFunc<T>(&sortList[currentSnaptshot.low],&sortList[currentSnaptshot.high]);
 			}
 		}
 		
 	}
 
+	template<typename T,typename CompFuncType>
+	void subQuickSortParallel(T* sortList, size_t low, size_t high,CompFuncType SortFunc,ssize_t minSize,size_t depthLimit,ThreadPool *pool);
+
+	/*!
+	@struct ParallelQuickSortFunctor epQuickSort.h
+	@brief A functor which sorts the partitions given to ParallelFor.
+	*/
+	template<typename T,typename CompFuncType>
+	struct ParallelQuickSortFunctor
+	{
+		/// the list to sort
+		T* m_sortList;
+		/// the low index of each partition
+		size_t m_lowList[2];
+		/// the high index of each partition
+		size_t m_highList[2];
+		/// the compare function
+		CompFuncType m_sortFunc;
+		/// the minimum size of the list for insertion Sort operation
+		ssize_t m_minSize;
+		/// the number of partition levels left before the heap sort fallback
+		size_t m_depthLimit;
+		/// the thread pool to fork onto
+		ThreadPool *m_pool;
+
+		/*!
+		Sort the partitions of the given chunk.
+		@param[in] chunkBegin the first partition index of the chunk.
+		@param[in] chunkEnd the index after the last partition of the chunk.
+		*/
+		void operator()(size_t chunkBegin, size_t chunkEnd) const
+		{
+			for(size_t partTrav=chunkBegin;partTrav<chunkEnd;partTrav++)
+				subQuickSortParallel<T>(m_sortList,m_lowList[partTrav],m_highList[partTrav],m_sortFunc,m_minSize,m_depthLimit,m_pool);
+		}
+	};
+
+	/*!
+	Sub Function for Quick Sort with Parallel Operation.
+	@param[in] sortList The list to sort.
+	@param[in] low the low index of the list.
+	@param[in] high the high index of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] minSize the minimum size of the list for insertion Sort operation
+	@param[in] depthLimit the number of partition levels left before the heap sort fallback
+	@param[in] pool the thread pool to fork onto.
+	@remark the smaller partition is sorted on the calling thread until both partitions are worth the fork.
+	*/
+	template<typename T,typename CompFuncType>
+	void subQuickSortParallel(T* sortList, size_t low, size_t high,CompFuncType SortFunc,ssize_t minSize,size_t depthLimit,ThreadPool *pool)
+	{
+		while(high>low && (high-low)+1>QSORT_PARALLEL_CUTOFF)
+		{
+			if(depthLimit==0)
+			{
+				subHeapSort<T>(sortList,low,high,SortFunc);
+				return;
+			}
+			if(sortRun<T>(sortList,low,high,SortFunc))
+				return;
+			depthLimit--;
+			size_t lessIdx;
+			size_t greaterIdx;
+			partitionThreeWay<T>(sortList,low,high,lessIdx,greaterIdx,SortFunc);
+			size_t leftSize=lessIdx-low;
+			size_t rightSize=high-greaterIdx;
+			if(leftSize>=QSORT_PARALLEL_CUTOFF && rightSize>=QSORT_PARALLEL_CUTOFF)
+			{
+				ParallelQuickSortFunctor<T,CompFuncType> func;
+				func.m_sortList=sortList;
+				func.m_lowList[0]=low;
+				func.m_highList[0]=lessIdx-1;
+				func.m_lowList[1]=greaterIdx+1;
+				func.m_highList[1]=high;
+				func.m_sortFunc=SortFunc;
+				func.m_minSize=minSize;
+				func.m_depthLimit=depthLimit;
+				func.m_pool=pool;
+				ParallelFor(pool,0,2,1,func);
+				return;
+			}
+			size_t listSize=(high-low)+1;
+			if(leftSize<listSize/8 || rightSize<listSize/8)
+			{
+				if(leftSize>0)
+					breakPattern<T>(sortList,low,lessIdx-1);
+				if(rightSize>0)
+					breakPattern<T>(sortList,greaterIdx+1,high);
+			}
+			if(leftSize<rightSize)
+			{
+				if(leftSize>0)
+					subQuickSortLoop<T>(sortList,low,lessIdx-1,SortFunc,minSize,depthLimit);
+				low=greaterIdx+1;
+			}
+			else
+			{
+				if(rightSize>0)
+					subQuickSortLoop<T>(sortList,greaterIdx+1,high,SortFunc,minSize,depthLimit);
+				if(leftSize==0)
+					return;
+				high=lessIdx-1;
+			}
+		}
+		subQuickSortLoop<T>(sortList,low,high,SortFunc,minSize,depthLimit);
+	}
+
+	/*!
+	Template Quick Sort Function
+
+	Sort the given list with Sort Function Pointer or Functor.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] SortFunc The Compare Function pointer or functor.
+	@param[in] mode The QSort Mode
+	@param[in] minSize the minimum size for the insertion sort start (-1 for QSORT_DEFAULT_MIN_SIZE)
+	@param[in] pool the thread pool for QSORT_MODE_PARALLEL (NULL to sort on the calling thread)
+	@remark the comparison of the functor is inlined, so use the functor such as CompFunctor for the hot path.
+	@remark QSORT_MODE_STL sorts with std::sort.
+	@remark the partition depth is bounded by twice the log2 of the size, and the deeper range falls back to the heap sort.
+	@remark for QSORT_MODE_PARALLEL, SortFunc must be safe to call concurrently.
+	*/
+	template <typename T,typename CompFuncType>
+	void QuickSort (T* sortList,const size_t listSize,CompFuncType SortFunc, QSortMode mode=QSORT_MODE_STL, ssize_t minSize=-1, ThreadPool *pool=NULL)
+	{
+		if (sortList == NULL || listSize<=1)
+		{
+			return;
+		}
+		if(mode==QSORT_MODE_STL)
+		{
+			std::sort(sortList,sortList+listSize,CompLess<T,CompFuncType>(SortFunc));
+		}
+		else
+		{
+			if(minSize<0)
+				minSize=QSORT_DEFAULT_MIN_SIZE;
+			else if(minSize>ssize_t(listSize))
+				minSize=ssize_t(listSize)/2;
+			size_t depthLimit=quickSortDepthLimit(listSize);
+			if(mode==QSORT_MODE_RECURSIVE)
+				subQuickSortRecursive<T>(sortList,0,listSize-1,SortFunc, minSize,depthLimit);
+			else if(mode==QSORT_MODE_LOOP)
+				subQuickSortLoop<T>(sortList,0,listSize-1,SortFunc, minSize,depthLimit);
+			else if(mode==QSORT_MODE_PARALLEL)
+				subQuickSortParallel<T>(sortList,0,listSize-1,SortFunc,minSize,depthLimit,pool);
+		}
+	}
+
+	/*!
+	Template Quick Sort Function
+
+	Sort the given list with Sort Function Pointer.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] SortFunc The Compare Function pointer.
+	@param[in] mode The QSort Mode
+	@param[in] minSize the minimum size for the insertion sort start (-1 for QSORT_DEFAULT_MIN_SIZE)
+	@param[in] pool the thread pool for QSORT_MODE_PARALLEL (NULL to sort on the calling thread)
+	@remark QSORT_MODE_STL sorts with qsort.
+	*/
+	template <typename T>
+	void QuickSort (T* sortList,const size_t listSize,CompResultType (__cdecl *SortFunc)(const void * , const void *), QSortMode mode=QSORT_MODE_STL, ssize_t minSize=-1, ThreadPool *pool=NULL)
+	{
+		if(mode==QSORT_MODE_STL)
+		{
+			qsort(sortList,listSize,sizeof(T),(int (__cdecl *)(const void *,const void *))SortFunc);
+		}
+		else
+		{
+			QuickSort<T,CompResultType (__cdecl *)(const void * , const void *)>(sortList,listSize,SortFunc,mode,minSize,pool);
+		}
+	}
 }
 #endif //__EP_QUICK_SORT_H__
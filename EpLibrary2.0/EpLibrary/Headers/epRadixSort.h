@@ -0,0 +1,591 @@
+/*! 
+@file epRadixSort.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Radix Sort Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Radix Sort Algorithm Function.
+
+*/
+#ifndef __EP_RADIX_SORT_H__
+#define __EP_RADIX_SORT_H__
+#include "epLib.h"
+#include "epParallel.h"
+#include <string>
+#include <vector>
+
+/// the maximum size of the list to sort with the insertion sort instead
+#define RSORT_INSERTION_SIZE 64
+/// the minimum number of elements per chunk in RSORT_MODE_PARALLEL
+#define RSORT_PARALLEL_CHUNK_SIZE 65536
+
+namespace epl
+{
+	/// Enumeration Type for Radix Sort Mode
+	typedef enum _rSortMode{
+		/// RSort Mode from the least significant digit (stable, uses the work space)
+		RSORT_MODE_LSD=0,
+		/// RSort Mode from the most significant digit (in place, not stable)
+		RSORT_MODE_MSD,
+		/// RSort Mode from the least significant digit across the thread pool (stable, uses the work space)
+		RSORT_MODE_PARALLEL
+	}RSortMode;
+
+	/*! 
+	@class RadixKey epRadixSort.h
+	@brief A template functor which returns the unsigned radix key ordered the same as the element.
+
+	Specialized for the integer and floating point types.
+	The custom key functor must define KeyType as the unsigned integer type of the key, 
+	and return the key of the element with const operator().
+	*/
+	template<typename T>
+	class RadixKey
+	{
+	};
+
+	/*! 
+	@class RadixUnsignedKey epRadixSort.h
+	@brief A template functor which returns the unsigned integer as the radix key.
+	*/
+	template<typename T>
+	class RadixUnsignedKey
+	{
+	public:
+		/// the type of the key
+		typedef T KeyType;
+
+		/*!
+		Return the radix key of the given element.
+		@param[in] a the element.
+		@return the radix key of the element.
+		*/
+		KeyType operator()(const T &a) const
+		{
+			return a;
+		}
+	};
+
+	/*! 
+	@class RadixSignedKey epRadixSort.h
+	@brief A template functor which returns the signed integer with the sign bit flipped as the radix key.
+	*/
+	template<typename T, typename UnsignedType>
+	class RadixSignedKey
+	{
+	public:
+		/// the type of the key
+		typedef UnsignedType KeyType;
+
+		/*!
+		Return the radix key of the given element.
+		@param[in] a the element.
+		@return the radix key of the element.
+		*/
+		KeyType operator()(const T &a) const
+		{
+			return static_cast<KeyType>(a)^(static_cast<KeyType>(1)<<(sizeof(KeyType)*8-1));
+		}
+	};
+
+	template<> class RadixKey<unsigned char>:public RadixUnsignedKey<unsigned char>{};
+	template<> class RadixKey<unsigned short>:public RadixUnsignedKey<unsigned short>{};
+	template<> class RadixKey<unsigned int>:public RadixUnsignedKey<unsigned int>{};
+	template<> class RadixKey<unsigned long>:public RadixUnsignedKey<unsigned long>{};
+	template<> class RadixKey<unsigned __int64>:public RadixUnsignedKey<unsigned __int64>{};
+	template<> class RadixKey<signed char>:public RadixSignedKey<signed char,unsigned char>{};
+	template<> class RadixKey<short>:public RadixSignedKey<short,unsigned short>{};
+	template<> class RadixKey<int>:public RadixSignedKey<int,unsigned int>{};
+	template<> class RadixKey<long>:public RadixSignedKey<long,unsigned long>{};
+	template<> class RadixKey<__int64>:public RadixSignedKey<__int64,unsigned __int64>{};
+
+	/*! 
+	@class RadixKey<float> epRadixSort.h
+	@brief A functor which returns the bits of the float as the radix key.
+
+	The negative value has all bits flipped, and the positive value has the sign bit set,
+	so the key orders the same as the value. (-0.0 comes before 0.0)
+	*/
+	template<>
+	class RadixKey<float>
+	{
+	public:
+		/// the type of the key
+		typedef unsigned int KeyType;
+
+		/*!
+		Return the radix key of the given element.
+		@param[in] a the element.
+		@return the radix key of the element.
+		*/
+		KeyType operator()(const float &a) const
+		{
+			KeyType bits;
+			memcpy(&bits,&a,sizeof(bits));
+			if(bits&0x80000000U)
+				return ~bits;
+			return bits|0x80000000U;
+		}
+	};
+
+	/*! 
+	@class RadixKey<double> epRadixSort.h
+	@brief A functor which returns the bits of the double as the radix key.
+
+	The negative value has all bits flipped, and the positive value has the sign bit set,
+	so the key orders the same as the value. (-0.0 comes before 0.0)
+	*/
+	template<>
+	class RadixKey<double>
+	{
+	public:
+		/// the type of the key
+		typedef unsigned __int64 KeyType;
+
+		/*!
+		Return the radix key of the given element.
+		@param[in] a the element.
+		@return the radix key of the element.
+		*/
+		KeyType operator()(const double &a) const
+		{
+			KeyType bits;
+			memcpy(&bits,&a,sizeof(bits));
+			KeyType signBit=static_cast<KeyType>(1)<<63;
+			if(bits&signBit)
+				return ~bits;
+			return bits|signBit;
+		}
+	};
+
+	/*! 
+	@class RadixStringPrefixKey epRadixSort.h
+	@brief A functor which returns the first 8 characters of the string as the radix key.
+
+	The shorter string is padded with 0, so it comes before the longer string with the same prefix.
+	The strings with the same prefix keep their order in RSORT_MODE_LSD and RSORT_MODE_PARALLEL.
+	*/
+	class RadixStringPrefixKey
+	{
+	public:
+		/// the type of the key
+		typedef unsigned __int64 KeyType;
+
+		/*!
+		Return the radix key of the given element.
+		@param[in] a the element.
+		@return the radix key of the element.
+		*/
+		KeyType operator()(const std::string &a) const
+		{
+			KeyType retKey=0;
+			for(size_t charTrav=0;charTrav<sizeof(KeyType);charTrav++)
+			{
+				retKey<<=8;
+				if(charTrav<a.size())
+					retKey|=static_cast<unsigned char>(a[charTrav]);
+			}
+			return retKey;
+		}
+	};
+
+	/*!
+	Return the digit of the given key.
+	@param[in] key the radix key.
+	@param[in] digitIdx the index of the digit from the least significant.
+	@return the digit of the key.
+	*/
+	template<typename KeyType>
+	inline size_t radixDigit(KeyType key, size_t digitIdx)
+	{
+		return static_cast<size_t>((key>>(digitIdx*8))&0xFF);
+	}
+
+	/*!
+	Insertion Sort Function by the radix key.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] keyFunc the radix key functor.
+	*/
+	template<typename T,typename KeyFunc>
+	inline void radixInsertionSort(T *sortList, size_t listSize, KeyFunc keyFunc)
+	{
+		typedef typename KeyFunc::KeyType KeyType;
+		for(size_t trav=1;trav<listSize;trav++)
+		{
+			T tmp=sortList[trav];
+			KeyType key=keyFunc(tmp);
+			size_t insertIdx=trav;
+			while(insertIdx>0 && key<keyFunc(sortList[insertIdx-1]))
+			{
+				sortList[insertIdx]=sortList[insertIdx-1];
+				insertIdx--;
+			}
+			sortList[insertIdx]=tmp;
+		}
+	}
+
+	/*!
+	Actual Radix Sort Operation Function from the least significant digit.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] workSpace the list for sorting operation
+	@param[in] keyFunc the radix key functor.
+	@remark the histograms of all digits are counted in one pass over the list, 
+	and the digit which every key shares is skipped.
+	*/
+	template<typename T,typename KeyFunc>
+	inline void subRadixSortLSD(T *sortList, size_t listSize, T* workSpace, KeyFunc keyFunc)
+	{
+		typedef typename KeyFunc::KeyType KeyType;
+		size_t countList[sizeof(KeyType)][256];
+		memset(countList,0,sizeof(countList));
+		for(size_t trav=0;trav<listSize;trav++)
+		{
+			KeyType key=keyFunc(sortList[trav]);
+			for(size_t digitTrav=0;digitTrav<sizeof(KeyType);digitTrav++)
+				countList[digitTrav][radixDigit(key,digitTrav)]++;
+		}
+		KeyType firstKey=keyFunc(sortList[0]);
+		T *srcList=sortList;
+		T *destList=workSpace;
+		for(size_t digitTrav=0;digitTrav<sizeof(KeyType);digitTrav++)
+		{
+			size_t *count=countList[digitTrav];
+			if(count[radixDigit(firstKey,digitTrav)]==listSize)
+				continue;
+			size_t offset=0;
+			for(size_t bucketTrav=0;bucketTrav<256;bucketTrav++)
+			{
+				size_t bucketSize=count[bucketTrav];
+				count[bucketTrav]=offset;
+				offset+=bucketSize;
+			}
+			for(size_t trav=0;trav<listSize;trav++)
+				destList[count[radixDigit(keyFunc(srcList[trav]),digitTrav)]++]=srcList[trav];
+			T *tmpList=srcList;
+			srcList=destList;
+			destList=tmpList;
+		}
+		if(srcList!=sortList)
+		{
+			for(size_t trav=0;trav<listSize;trav++)
+				sortList[trav]=srcList[trav];
+		}
+	}
+
+	/*!
+	Actual Radix Sort Operation Function from the most significant digit.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] keyFunc the radix key functor.
+	@param[in] digitIdx the index of the digit to sort by, from the least significant.
+	@remark each digit permutes the list in place into the buckets, and the buckets are sorted by the next digit.
+	*/
+	template<typename T,typename KeyFunc>
+	inline void subRadixSortMSD(T *sortList, size_t listSize, KeyFunc keyFunc, size_t digitIdx)
+	{
+		while(true)
+		{
+			if(listSize<=RSORT_INSERTION_SIZE)
+			{
+				radixInsertionSort<T>(sortList,listSize,keyFunc);
+				return;
+			}
+			size_t count[256];
+			memset(count,0,sizeof(count));
+			for(size_t trav=0;trav<listSize;trav++)
+				count[radixDigit(keyFunc(sortList[trav]),digitIdx)]++;
+			if(count[radixDigit(keyFunc(sortList[0]),digitIdx)]==listSize)
+			{
+				// every key shares this digit, so go on to the next digit without moving
+				if(digitIdx==0)
+					return;
+				digitIdx--;
+				continue;
+			}
+			size_t head[256];
+			size_t tail[256];
+			size_t offset=0;
+			for(size_t bucketTrav=0;bucketTrav<256;bucketTrav++)
+			{
+				head[bucketTrav]=offset;
+				offset+=count[bucketTrav];
+				tail[bucketTrav]=offset;
+			}
+			for(size_t bucketTrav=0;bucketTrav<256;bucketTrav++)
+			{
+				while(head[bucketTrav]<tail[bucketTrav])
+				{
+					T value=sortList[head[bucketTrav]];
+					size_t digit=radixDigit(keyFunc(value),digitIdx);
+					while(digit!=bucketTrav)
+					{
+						T tmp=sortList[head[digit]];
+						sortList[head[digit]++]=value;
+						value=tmp;
+						digit=radixDigit(keyFunc(value),digitIdx);
+					}
+					sortList[head[bucketTrav]++]=value;
+				}
+			}
+			if(digitIdx==0)
+				return;
+			offset=0;
+			for(size_t bucketTrav=0;bucketTrav<256;bucketTrav++)
+			{
+				if(count[bucketTrav]>1)
+					subRadixSortMSD<T>(sortList+offset,count[bucketTrav],keyFunc,digitIdx-1);
+				offset+=count[bucketTrav];
+			}
+			return;
+		}
+	}
+
+	/*!
+	@struct RadixHistogramFunctor epRadixSort.h
+	@brief A functor which counts the digits of each chunk given to ParallelFor.
+	*/
+	template<typename T,typename KeyFunc>
+	struct RadixHistogramFunctor
+	{
+		/// the list to count
+		const T *m_sortList;
+		/// the number of elements per chunk
+		size_t m_grain;
+		/// the index of the first digit to count
+		size_t m_firstDigit;
+		/// the number of digits to count
+		size_t m_digitCount;
+		/// the counts, 256 per digit per chunk
+		size_t *m_countList;
+		/// the radix key functor
+		KeyFunc m_keyFunc;
+
+		/*!
+		Count the digits of the given chunk.
+		@param[in] chunkBegin the first index of the chunk.
+		@param[in] chunkEnd the index after the last of the chunk.
+		*/
+		void operator()(size_t chunkBegin, size_t chunkEnd) const
+		{
+			size_t *count=m_countList+(chunkBegin/m_grain)*m_digitCount*256;
+			for(size_t trav=chunkBegin;trav<chunkEnd;trav++)
+			{
+				typename KeyFunc::KeyType key=m_keyFunc(m_sortList[trav]);
+				for(size_t digitTrav=0;digitTrav<m_digitCount;digitTrav++)
+					count[digitTrav*256+radixDigit(key,m_firstDigit+digitTrav)]++;
+			}
+		}
+	};
+
+	/*!
+	@struct RadixScatterFunctor epRadixSort.h
+	@brief A functor which moves the elements of each chunk given to ParallelFor to their buckets.
+	*/
+	template<typename T,typename KeyFunc>
+	struct RadixScatterFunctor
+	{
+		/// the list to move from
+		const T *m_srcList;
+		/// the list to move to
+		T *m_destList;
+		/// the number of elements per chunk
+		size_t m_grain;
+		/// the index of the digit to sort by
+		size_t m_digitIdx;
+		/// the next position of each bucket, 256 per chunk
+		size_t *m_offsetList;
+		/// the radix key functor
+		KeyFunc m_keyFunc;
+
+		/*!
+		Move the elements of the given chunk.
+		@param[in] chunkBegin the first index of the chunk.
+		@param[in] chunkEnd the index after the last of the chunk.
+		*/
+		void operator()(size_t chunkBegin, size_t chunkEnd) const
+		{
+			size_t *offset=m_offsetList+(chunkBegin/m_grain)*256;
+			for(size_t trav=chunkBegin;trav<chunkEnd;trav++)
+				m_destList[offset[radixDigit(m_keyFunc(m_srcList[trav]),m_digitIdx)]++]=m_srcList[trav];
+		}
+	};
+
+	/*!
+	Actual Radix Sort Operation Function from the least significant digit across the thread pool.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] workSpace the list for sorting operation
+	@param[in] keyFunc the radix key functor, which must be safe to call concurrently.
+	@param[in] pool the thread pool to help.
+	@remark each digit counts the chunks in parallel, places each chunk after the same bucket of the preceding chunks,
+	and moves the chunks in parallel, so the order of the equal keys is kept.
+	*/
+	template<typename T,typename KeyFunc>
+	inline void subRadixSortParallel(T *sortList, size_t listSize, T* workSpace, KeyFunc keyFunc, ThreadPool *pool)
+	{
+		typedef typename KeyFunc::KeyType KeyType;
+		size_t chunkCount=1;
+		if(pool && pool->IsStarted())
+			chunkCount+=pool->GetWorkerCount();
+		if(chunkCount>(listSize+RSORT_PARALLEL_CHUNK_SIZE-1)/RSORT_PARALLEL_CHUNK_SIZE)
+			chunkCount=(listSize+RSORT_PARALLEL_CHUNK_SIZE-1)/RSORT_PARALLEL_CHUNK_SIZE;
+		if(chunkCount<=1)
+		{
+			subRadixSortLSD<T>(sortList,listSize,workSpace,keyFunc);
+			return;
+		}
+		size_t grain=(listSize+chunkCount-1)/chunkCount;
+		chunkCount=(listSize+grain-1)/grain;
+
+		std::vector<size_t> totalList(chunkCount*sizeof(KeyType)*256,0);
+		RadixHistogramFunctor<T,KeyFunc> totalFunc;
+		totalFunc.m_sortList=sortList;
+		totalFunc.m_grain=grain;
+		totalFunc.m_firstDigit=0;
+		totalFunc.m_digitCount=sizeof(KeyType);
+		totalFunc.m_countList=&totalList[0];
+		totalFunc.m_keyFunc=keyFunc;
+		ParallelFor(pool,0,listSize,grain,totalFunc);
+
+		std::vector<size_t> countList(chunkCount*256);
+		KeyType firstKey=keyFunc(sortList[0]);
+		T *srcList=sortList;
+		T *destList=workSpace;
+		for(size_t digitTrav=0;digitTrav<sizeof(KeyType);digitTrav++)
+		{
+			size_t firstBucketSize=0;
+			for(size_t chunkTrav=0;chunkTrav<chunkCount;chunkTrav++)
+				firstBucketSize+=totalList[(chunkTrav*sizeof(KeyType)+digitTrav)*256+radixDigit(firstKey,digitTrav)];
+			if(firstBucketSize==listSize)
+				continue;
+
+			// the chunks of the first pass are still in the original order, so reuse the total counts
+			if(srcList==sortList && digitTrav==0)
+			{
+				for(size_t chunkTrav=0;chunkTrav<chunkCount;chunkTrav++)
+					memcpy(&countList[chunkTrav*256],&totalList[(chunkTrav*sizeof(KeyType))*256],sizeof(size_t)*256);
+			}
+			else
+			{
+				std::fill(countList.begin(),countList.end(),0);
+				RadixHistogramFunctor<T,KeyFunc> countFunc;
+				countFunc.m_sortList=srcList;
+				countFunc.m_grain=grain;
+				countFunc.m_firstDigit=digitTrav;
+				countFunc.m_digitCount=1;
+				countFunc.m_countList=&countList[0];
+				countFunc.m_keyFunc=keyFunc;
+				ParallelFor(pool,0,listSize,grain,countFunc);
+			}
+
+			size_t offset=0;
+			for(size_t bucketTrav=0;bucketTrav<256;bucketTrav++)
+			{
+				for(size_t chunkTrav=0;chunkTrav<chunkCount;chunkTrav++)
+				{
+					size_t bucketSize=countList[chunkTrav*256+bucketTrav];
+					countList[chunkTrav*256+bucketTrav]=offset;
+					offset+=bucketSize;
+				}
+			}
+
+			RadixScatterFunctor<T,KeyFunc> scatterFunc;
+			scatterFunc.m_srcList=srcList;
+			scatterFunc.m_destList=destList;
+			scatterFunc.m_grain=grain;
+			scatterFunc.m_digitIdx=digitTrav;
+			scatterFunc.m_offsetList=&countList[0];
+			scatterFunc.m_keyFunc=keyFunc;
+			ParallelFor(pool,0,listSize,grain,scatterFunc);
+
+			T *tmpList=srcList;
+			srcList=destList;
+			destList=tmpList;
+		}
+		if(srcList!=sortList)
+		{
+			for(size_t trav=0;trav<listSize;trav++)
+				sortList[trav]=srcList[trav];
+		}
+	}
+
+	/*!
+	Template Radix Sort Function
+
+	Sort the given list by the radix key returned from the key functor.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] keyFunc the radix key functor, which defines KeyType and returns the key of the element.
+	@param[in] mode The RSort Mode
+	@param[in] pool the thread pool for RSORT_MODE_PARALLEL (NULL to sort on the calling thread)
+	@remark RSORT_MODE_LSD and RSORT_MODE_PARALLEL allocate the work space of the same size as the list, so T must be default constructible.
+	*/
+	template<typename T,typename KeyFunc>
+	void RadixSort(T *sortList, size_t listSize, KeyFunc keyFunc, RSortMode mode=RSORT_MODE_LSD, ThreadPool *pool=NULL)
+	{
+		if(sortList==NULL || listSize<=1)
+			return;
+		if(listSize<=RSORT_INSERTION_SIZE)
+		{
+			radixInsertionSort<T>(sortList,listSize,keyFunc);
+			return;
+		}
+		if(mode==RSORT_MODE_MSD)
+		{
+			subRadixSortMSD<T>(sortList,listSize,keyFunc,sizeof(typename KeyFunc::KeyType)-1);
+			return;
+		}
+		T* workSpace=EP_NEW T[listSize];
+		if(mode==RSORT_MODE_PARALLEL)
+			subRadixSortParallel<T>(sortList,listSize,workSpace,keyFunc,pool);
+		else
+			subRadixSortLSD<T>(sortList,listSize,workSpace,keyFunc);
+		EP_DELETE[] workSpace;
+	}
+
+	/*!
+	Template Radix Sort Function
+
+	Sort the given list of the integer or floating point type by its value.
+	@param[in] sortList The list to sort.
+	@param[in] listSize The size of the list.
+	@param[in] mode The RSort Mode
+	@param[in] pool the thread pool for RSORT_MODE_PARALLEL (NULL to sort on the calling thread)
+	*/
+	template<typename T>
+	void RadixSort(T *sortList, size_t listSize, RSortMode mode=RSORT_MODE_LSD, ThreadPool *pool=NULL)
+	{
+		RadixSort<T,RadixKey<T> >(sortList,listSize,RadixKey<T>(),mode,pool);
+	}
+}
+#endif //__EP_RADIX_SORT_H__
\ No newline at end of file
@@ -40,13 +40,174 @@ An Interface for the Random Number Generator.
 
 #include "epLib.h"
 #include "epSingletonHolder.h"
+#include "epCriticalSectionEx.h"
+#include <vector>
 
 #define RANDOM_INSTANCE epl::SingletonHolder<Random>::Instance()
 namespace epl
 {
+	/*! 
+	@class Xoshiro256Engine epRandom.h
+	@brief A class for the xoshiro256** pseudo random number engine.
+
+	The engine has the period of 2^256-1, and Jump/LongJump skip 2^128/2^192 numbers ahead,
+	so the engines jumped from the same seed give the parallel streams that never overlap.
+	@remark the engine is not thread-safe, and each thread should use its own engine.
+	*/
+	class EP_LIBRARY Xoshiro256Engine
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the engine with the given seed
+		@param[in] seed the seed of the engine
+		*/
+		Xoshiro256Engine(unsigned __int64 seed=0);
+
+		/*!
+		Seed the engine
+		@param[in] seed the seed of the engine
+		*/
+		void Seed(unsigned __int64 seed);
+
+		/*!
+		Return the next 64-bit random number
+		@return the next 64-bit random number
+		*/
+		unsigned __int64 Next();
+
+		/*!
+		Return the next 32-bit random number
+		@return the next 32-bit random number
+		*/
+		unsigned int NextUInt();
+
+		/*!
+		Return the random number less than the given range without bias
+		@param[in] range the number of the possible values
+		@return the random number in [0, range), or 0 if the range is 0
+		*/
+		unsigned int NextBounded(unsigned int range);
+
+		/*!
+		Return the random number in [0, 1)
+		@return the random number in [0, 1)
+		*/
+		double NextDouble();
+
+		/*!
+		Skip 2^128 numbers ahead
+		*/
+		void Jump();
+
+		/*!
+		Skip 2^192 numbers ahead
+		*/
+		void LongJump();
+
+		/*!
+		Fill the given buffer with the 64-bit random numbers
+		@param[out] retBuffer the buffer to fill
+		@param[in] count the number of random numbers to fill
+		@remark the odd numbers are drawn from the stream jumped 2^128 ahead, two at a time with SSE2,
+		        so the buffer differs from the numbers Next would return.
+		*/
+		void Fill(unsigned __int64 *retBuffer, size_t count);
+
+	private:
+		/*!
+		Skip ahead with the given jump polynomial
+		@param[in] jumpTable the jump polynomial
+		*/
+		void jump(const unsigned __int64 *jumpTable);
+
+		/// the state
+		unsigned __int64 m_state[4];
+	};
+
+	/*! 
+	@class Pcg64Engine epRandom.h
+	@brief A class for the PCG64 (XSL-RR 128/64) pseudo random number engine.
+
+	The engine has the period of 2^128, and each odd stream selects the independent sequence.
+	Advance skips any number of steps in logarithmic time.
+	@remark the engine is not thread-safe, and each thread should use its own engine.
+	*/
+	class EP_LIBRARY Pcg64Engine
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the engine with the given seed and stream
+		@param[in] seed the seed of the engine
+		@param[in] stream the stream of the engine
+		*/
+		Pcg64Engine(unsigned __int64 seed=0, unsigned __int64 stream=0);
+
+		/*!
+		Seed the engine
+		@param[in] seed the seed of the engine
+		@param[in] stream the stream of the engine
+		*/
+		void Seed(unsigned __int64 seed, unsigned __int64 stream=0);
+
+		/*!
+		Return the next 64-bit random number
+		@return the next 64-bit random number
+		*/
+		unsigned __int64 Next();
+
+		/*!
+		Return the next 32-bit random number
+		@return the next 32-bit random number
+		*/
+		unsigned int NextUInt();
+
+		/*!
+		Return the random number less than the given range without bias
+		@param[in] range the number of the possible values
+		@return the random number in [0, range), or 0 if the range is 0
+		*/
+		unsigned int NextBounded(unsigned int range);
+
+		/*!
+		Return the random number in [0, 1)
+		@return the random number in [0, 1)
+		*/
+		double NextDouble();
+
+		/*!
+		Skip the given number of steps ahead
+		@param[in] delta the number of steps to skip
+		*/
+		void Advance(unsigned __int64 delta);
+
+		/*!
+		Fill the given buffer with the 64-bit random numbers
+		@param[out] retBuffer the buffer to fill
+		@param[in] count the number of random numbers to fill
+		*/
+		void Fill(unsigned __int64 *retBuffer, size_t count);
+
+	private:
+		/// the high 64 bits of the state
+		unsigned __int64 m_stateHigh;
+		/// the low 64 bits of the state
+		unsigned __int64 m_stateLow;
+		/// the high 64 bits of the increment
+		unsigned __int64 m_incHigh;
+		/// the low 64 bits of the increment
+		unsigned __int64 m_incLow;
+	};
+
 	/*! 
 	@class Random epRandom.h
 	@brief A class that generate the random number.
+
+	Each thread draws from its own xoshiro256** engine, jumped from the shared seed,
+	so the threads neither share the state nor take the lock after their first call.
 	*/
 	class EP_LIBRARY Random
 	{
@@ -54,7 +215,7 @@ namespace epl
 		friend class SingletonHolder<Random>;
 		/*!
 		Return the random number
-		@return the random number
+		@return the random number between 0 and 0x7FFFFFFF inclusive
 		*/
 		int GetRandom();
 
@@ -66,6 +227,26 @@ namespace epl
 		@return the random number between startNum and endNum inclusive
 		*/
 		int GetRandom(int startNum, int endNum);
+
+		/*!
+		Return the random number in [0, 1)
+		@return the random number in [0, 1)
+		*/
+		double GetRandomDouble();
+
+		/*!
+		Fill the given buffer with the 64-bit random numbers
+		@param[out] retBuffer the buffer to fill
+		@param[in] count the number of random numbers to fill
+		*/
+		void Fill(unsigned __int64 *retBuffer, size_t count);
+
+		/*!
+		Return the engine of the calling thread
+		@return the engine of the calling thread
+		@remark the engine must not be used by the other threads.
+		*/
+		Xoshiro256Engine &GetThreadEngine();
 	private:
 		/*!
 		Default Constructor
@@ -75,6 +256,15 @@ namespace epl
 		Default Destructor
 		*/
 		~Random();
+
+		/// the engine to jump the thread engines from
+		Xoshiro256Engine m_baseEngine;
+		/// the engines created for the threads
+		std::vector<Xoshiro256Engine*> m_engineList;
+		/// the TLS index for the engine of the calling thread
+		unsigned long m_tlsIndex;
+		/// the lock for the base engine and the engine list
+		CriticalSectionEx m_engineLock;
 	};
 }
-#endif //__EP_RANDOM_H__
+#endif //__EP_RANDOM_H__
\ No newline at end of file
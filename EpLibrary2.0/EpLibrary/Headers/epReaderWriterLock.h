@@ -0,0 +1,159 @@
+/*! 
+@file epReaderWriterLock.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief ReaderWriterLock Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Reader-Writer Lock Class.
+
+*/
+#ifndef __EP_READER_WRITER_LOCK_H__
+#define __EP_READER_WRITER_LOCK_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseLock.h"
+
+namespace epl
+{
+	/*! 
+	@class ReaderWriterLock epReaderWriterLock.h
+	@brief A class that handles the reader-writer lock functionality.
+
+	The readers share the lock with LockShared, while the writer holds it alone with Lock.
+	The lock is backed by SRWLOCK on Windows 7 or later, otherwise it falls back to the critical section
+	where the readers do not share the lock.
+	The exclusive lock is recursive, and the exclusive owner may also call LockShared,
+	but the shared holder must not call Lock or LockShared again.
+	*/
+	class EP_LIBRARY ReaderWriterLock :public BaseLock
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		*/
+		ReaderWriterLock();
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the lock
+		@param[in] b the second object
+		*/
+		ReaderWriterLock(const ReaderWriterLock& b);
+
+		/*!
+		Default Destructor
+
+		Deletes the lock
+		*/
+		virtual ~ReaderWriterLock();
+
+		/*!	
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ReaderWriterLock & operator=(const ReaderWriterLock&b);
+
+		/*!
+		Locks the Critical Section
+		@return true if locked, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Try to Lock the Critical Section
+
+		If other thread is already in the Critical Section, it just returns false and continue, otherwise obtain the Critical Section.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Locks the Critical Section
+
+		if other thread is already in the Critical Section,
+		and if it fails to lock in given time, it returns false, otherwise lock and return true.
+		@param[in] dwMilliSecond the wait time.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Leave the Critical Section
+
+		The Lock and Unlock has to be matched for each Critical Section.
+		*/
+		virtual void Unlock();
+
+		/*!
+		Locks the Critical Section for reading
+		@return true if locked, false otherwise
+		*/
+		virtual bool LockShared();
+
+		/*!
+		Try to Lock the Critical Section for reading
+
+		If other thread is writing in the Critical Section, it just returns false and continue, otherwise obtain the Critical Section for reading.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockShared();
+
+		/*!
+		Leave the Critical Section for reading
+
+		The LockShared and UnlockShared has to be matched for each Critical Section.
+		*/
+		virtual void UnlockShared();
+
+		/*!
+		Return the flag whether the readers share the lock.
+		@return true if backed by SRWLOCK, otherwise false.
+		*/
+		static bool IsSharedSupported();
+
+	private:
+		/// the SRWLOCK storage
+		PVOID m_srwLock;
+		/// the critical section used when SRWLOCK is not available
+		CRITICAL_SECTION m_criticalSection;
+		/// the thread id of the exclusive owner
+		volatile DWORD m_ownerThreadId;
+		/// exclusive lock counter
+		int m_lockCounter;
+		/// shared lock counter
+		volatile long m_sharedCounter;
+	};
+}
+#endif //__EP_READER_WRITER_LOCK_H__
\ No newline at end of file
@@ -0,0 +1,305 @@
+/*! 
+@file epRecordLog.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Record Log Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+This is a class for the checksummed, append-only record file with the group commit.
+
+*/
+#ifndef __EP_RECORD_LOG_H__
+#define __EP_RECORD_LOG_H__
+#include "epLib.h"
+#include <vector>
+#include "epEventEx.h"
+
+/// the byte size of the header written before each record (length and checksum)
+#define RECORD_LOG_HEADER_SIZE 8
+
+/// the byte size of the sync marker
+#define RECORD_LOG_MARKER_SIZE 16
+
+/// the byte size of the records after which the next sync marker is written
+#define RECORD_LOG_SYNC_INTERVAL 65536
+
+/// the byte size of the appended records held in memory before written to the file
+#define RECORD_LOG_BUFFER_SIZE 1048576
+
+/// the byte size the record can take at most
+#define RECORD_LOG_MAX_RECORD_SIZE 0x7FFFFFFF
+
+namespace epl
+{
+	class RecordLogScanner;
+
+	/*!
+	@class RecordLog epRecordLog.h
+	@brief A class for the checksummed, append-only record file for the durable logs.
+
+	Each record is written as its length and CRC32C followed by the record,
+	and the sync marker holding its own offset is written every RECORD_LOG_SYNC_INTERVAL bytes.
+	When opened, the file is scanned backward for the last sync markers,
+	and the torn records after the last valid record are truncated, so the whole file never has to be scanned.
+
+	The records are appended to the memory buffer, and the committing threads share one write and flush,
+	so the durability costs one fsync per group of the records rather than one per record.
+	*/
+	class EP_LIBRARY RecordLog
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the record log
+		@param[in] lockPolicyType The lock policy
+		*/
+		RecordLog(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Close and destroy the record log
+		@remark the appended records not committed are written to the file without the flush.
+		*/
+		virtual ~RecordLog();
+
+		/*!
+		Open the record log file, creating it if not exists, and recover the last valid record.
+		@param[in] fileName the name of the record log file.
+		@return true if successful, otherwise false.
+		@remark the torn records after the last valid record are truncated from the file.
+		*/
+		bool Open(const TCHAR *fileName);
+
+		/*!
+		Write the appended records to the file, and close the record log.
+		@return true if the appended records are written, otherwise false.
+		@remark the records are not flushed, so call Sync before to make them durable.
+		*/
+		bool Close();
+
+		/*!
+		Return the flag whether the record log is opened.
+		@return true if opened, otherwise false.
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Append the record to the record log.
+		@param[in] data the record to append.
+		@param[in] byteSize the byte size of the record.
+		@return the sequence number of the record, or 0 if failed.
+		@remark the record is durable only after committed with the returned sequence number.
+		*/
+		unsigned __int64 Append(const void *data, unsigned int byteSize);
+
+		/*!
+		Write and flush the records up to the given sequence number to the file.
+		@param[in] sequence the sequence number returned from Append.
+		@return true if the records are durable, otherwise false.
+		@remark while one thread flushes the file, the other committing threads wait,
+		        and the next of them flushes all the records appended meanwhile at once.
+		*/
+		bool Commit(unsigned __int64 sequence);
+
+		/*!
+		Write and flush all the appended records to the file.
+		@return true if the records are durable, otherwise false.
+		*/
+		bool Sync();
+
+		/*!
+		Return the sequence number of the last appended record.
+		@return the sequence number of the last appended record.
+		@remark the sequence number is the byte size of the file including the record.
+		*/
+		unsigned __int64 GetAppendedSequence() const;
+
+		/*!
+		Return the sequence number of the last durable record.
+		@return the sequence number of the last durable record.
+		*/
+		unsigned __int64 GetDurableSequence() const;
+
+		/*!
+		Return the byte size of the torn records truncated at the last Open.
+		@return the byte size of the truncated records.
+		*/
+		unsigned __int64 GetTruncatedSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		RecordLog(const RecordLog & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		RecordLog &operator=(const RecordLog & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Write the appended records up to the given sequence number to the file.
+		@param[in] sequence the sequence number to write up to.
+		@param[in] isDurable the flag whether to flush the file after written.
+		@return true if successful, otherwise false.
+		@remark only one thread writes at a time, and the others wait for it.
+		*/
+		bool flush(unsigned __int64 sequence, bool isDurable);
+
+		/*!
+		Append the sync marker to the buffer.
+		*/
+		void appendMarker();
+
+		/// the handle of the record log file
+		HANDLE m_fileHandle;
+		/// the records appended but not written yet
+		std::vector<unsigned char> m_buffer;
+		/// the records being written by the flushing thread
+		std::vector<unsigned char> m_flushBuffer;
+		/// the sequence number of the last appended record
+		unsigned __int64 m_appendedSequence;
+		/// the sequence number of the last written record
+		unsigned __int64 m_writtenSequence;
+		/// the sequence number of the last durable record
+		unsigned __int64 m_durableSequence;
+		/// the byte size appended since the last sync marker
+		unsigned __int64 m_markerDistance;
+		/// the byte size truncated at the last Open
+		unsigned __int64 m_truncatedSize;
+		/// the flag whether a thread is writing the file
+		bool m_isFlushing;
+		/// the flag whether writing the file failed
+		bool m_isFailed;
+		/// the event raised when the flushing thread is done
+		EventEx m_flushEvent;
+		/// log lock
+		BaseLock *m_logLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
+	/*!
+	@class RecordLogReader epRecordLog.h
+	@brief A class for reading the records of the record log file in the order appended.
+	*/
+	class EP_LIBRARY RecordLogReader
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the reader
+		*/
+		RecordLogReader();
+
+		/*!
+		Default Destructor
+
+		Close and destroy the reader
+		*/
+		virtual ~RecordLogReader();
+
+		/*!
+		Open the record log file to read.
+		@param[in] fileName the name of the record log file.
+		@return true if successful, otherwise false.
+		@remark the torn records at the end of the file are not read, but kept in the file.
+		*/
+		bool Open(const TCHAR *fileName);
+
+		/*!
+		Close the reader.
+		*/
+		void Close();
+
+		/*!
+		Return the flag whether the reader is opened.
+		@return true if opened, otherwise false.
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Read the next record.
+		@param[out] retByteSize the byte size of the record read.
+		@return the record read, or NULL if no more valid record.
+		@remark the returned record is valid until the next read or Close.
+		*/
+		const unsigned char *ReadRecord(unsigned int &retByteSize);
+
+		/*!
+		Return the sequence number of the last record read.
+		@return the sequence number of the last record read.
+		*/
+		unsigned __int64 GetSequence() const;
+
+		/*!
+		Return the byte size of the valid records in the file.
+		@return the byte size of the valid records.
+		*/
+		unsigned __int64 GetValidSize() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		RecordLogReader(const RecordLogReader & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		RecordLogReader &operator=(const RecordLogReader & b){EP_ASSERT(0);return *this;}
+
+		/// the handle of the record log file
+		HANDLE m_fileHandle;
+		/// the byte size of the valid records
+		unsigned __int64 m_validSize;
+		/// the offset of the next record
+		unsigned __int64 m_offset;
+		/// the scanner reading the file
+		RecordLogScanner *m_scanner;
+	};
+}
+
+#endif //__EP_RECORD_LOG_H__
\ No newline at end of file
@@ -39,6 +39,9 @@ An Interface for the Registry Processing Operation.
 #define __EP_REGISTRY_HELPER_H__
 #include "epLib.h"
 #include "epSystem.h"
+#include "epBaseLock.h"
+#include <vector>
+#include <map>
 
 namespace epl
 {
@@ -128,6 +131,214 @@ namespace epl
 		*/
 		static HKEY GetRegistryMode(const TCHAR *strRegPath);
 	};
+
+	/*! 
+	@class RegistryCache epRegistryHelper.h
+	@brief This is a class for the cached registry subtree
+
+	Loads the values of the registry subtree at once, enumerating each key in one pass,
+	and serves the reads from memory until the subtree is changed.
+	The change is notified by RegNotifyChangeKeyValue, so the read with no change costs no system call.
+	The sub keys and the names are compared case-insensitively as the registry does.
+	*/
+	class EP_LIBRARY RegistryCache
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the cache and loads the subtree
+		@param[in] key the registry mode ex. (HKEY_LOCAL_MACHINE)
+		@param[in] subKey the subkey within the registry mode to cache ex. ("SOFTWARE\\MyCompany\\")
+		@param[in] isSubtree flag whether to cache the sub keys as well
+		@param[in] lockPolicyType The lock policy
+		*/
+		RegistryCache(HKEY key,const TCHAR *subKey,bool isSubtree=true,LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the cache
+		*/
+		virtual ~RegistryCache();
+
+		/*!
+		Get the given registry string data of given registry name
+		@param[in] subKey the subkey within the cached subkey. (NULL or "" for the cached subkey itself)
+		@param[in] regName the name of the registry to read the data
+		@param[out] retString the string data read
+		@return true if successful, otherwise false
+		@remark REG_EXPAND_SZ data is expanded as RegistryHelper::GetRegistryData.
+		*/
+		bool GetRegistryData(const TCHAR * subKey,const TCHAR * regName, EpTString &retString);
+
+		/*!
+		Get the given registry data of given registry name
+		@param[in] subKey the subkey within the cached subkey. (NULL or "" for the cached subkey itself)
+		@param[in] regName the name of the registry to read the data
+		@param[in] sizeInByte the size of the retBuf in Byte
+		@param[out] retBuf the buffer for writing the data read
+		@param[out] retSizeReadInByte the size of data read in Byte
+		@param[out] retRegType the type of the data read ex. (REG_SZ)
+		@return true if successful, otherwise false
+		*/
+		bool GetRegistryData(const TCHAR * subKey,const TCHAR * regName,unsigned long sizeInByte,void *retBuf, unsigned long &retSizeReadInByte, unsigned long &retRegType);
+
+		/*!
+		Get the size of the data in Registry
+		@param[in] subKey the subkey within the cached subkey. (NULL or "" for the cached subkey itself)
+		@param[in] regName the name of the registry to get the data size
+		@return the data size of the given registry name, or 0 if not found
+		*/
+		unsigned long GetRegistryDataSize(const TCHAR * subKey,const TCHAR * regName);
+
+		/*!
+		Get the names of all values of given key
+		@param[in] subKey the subkey within the cached subkey. (NULL or "" for the cached subkey itself)
+		@param[out] retNameList the names of the values
+		@return true if the key is found, otherwise false
+		*/
+		bool GetValueNames(const TCHAR * subKey, std::vector<EpTString> &retNameList);
+
+		/*!
+		Get the names of all sub keys of given key
+		@param[in] subKey the subkey within the cached subkey. (NULL or "" for the cached subkey itself)
+		@param[out] retNameList the names of the sub keys
+		@return true if the key is found, otherwise false
+		@remark the sub keys are listed even if the cache is created without isSubtree, but their values are not cached.
+		*/
+		bool GetSubKeyNames(const TCHAR * subKey, std::vector<EpTString> &retNameList);
+
+		/*!
+		Reload the subtree regardless of the change.
+		@return true if loaded, otherwise false
+		*/
+		bool Reload();
+
+		/*!
+		Return whether the subtree is loaded.
+		@return true if loaded, otherwise false
+		*/
+		bool IsLoaded();
+
+	private:
+		/*!
+		@struct CachedValue epRegistryHelper.h
+		@brief The cached registry value.
+		*/
+		struct CachedValue
+		{
+			/// the type of the data
+			unsigned long regType;
+			/// the data
+			std::vector<unsigned char> data;
+		};
+
+		/*!
+		@struct CachedKey epRegistryHelper.h
+		@brief The cached registry key.
+		*/
+		struct CachedKey
+		{
+			/// the names of the values
+			std::vector<EpTString> valueNameList;
+			/// the names of the sub keys
+			std::vector<EpTString> subKeyNameList;
+			/// the values by the lower case name
+			std::map<EpTString,CachedValue> valueMap;
+		};
+
+		/*!
+		Actually reload the subtree with the lock held.
+		@return true if loaded, otherwise false
+		*/
+		bool reload();
+
+		/*!
+		Reload the subtree if changed since the last load.
+		*/
+		void refresh();
+
+		/*!
+		Load given key into the key map.
+		@param[in] hKey the opened key
+		@param[in] path the lower case path of the key within the cached subkey
+		@param[out] retKeyMap the key map to load into
+		@return true if loaded, otherwise false
+		*/
+		bool loadKey(HKEY hKey,const EpTString &path,std::map<EpTString,CachedKey> &retKeyMap);
+
+		/*!
+		Find the cached value of given name.
+		@param[in] subKey the subkey within the cached subkey
+		@param[in] regName the name of the registry
+		@return the cached value found, or NULL if not found
+		@remark the lock must be held while using the returned value.
+		*/
+		const CachedValue *findValue(const TCHAR *subKey,const TCHAR *regName) const;
+
+		/*!
+		Return the path or the name as the key of the map.
+		@param[in] name the path or the name
+		@param[in] isPath flag whether the name is the path of the key
+		@return the name in lower case, without the leading and the trailing backslashes if the path
+		*/
+		static EpTString getMapKey(const TCHAR *name,bool isPath);
+
+		/*!
+		Mark the cache changed when the change is notified.
+		@param[in] param the cache object
+		@param[in] isTimedOut ignored
+		*/
+		static void CALLBACK onChange(void *param, BOOLEAN isTimedOut);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the cache
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		RegistryCache(const RegistryCache& b)
+		{
+			EP_ASSERT(0);
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		RegistryCache & operator=(const RegistryCache&b)
+		{
+			EP_ASSERT(0);
+			return *this;
+		}
+
+		/// the registry mode
+		HKEY m_rootKey;
+		/// the cached subkey
+		EpTString m_subKey;
+		/// the flag whether to cache the sub keys
+		bool m_isSubtree;
+		/// the opened cached subkey to watch the change
+		HKEY m_watchKey;
+		/// the event signaled when the subtree is changed
+		HANDLE m_changeEvent;
+		/// the wait registered for the change event
+		HANDLE m_changeWait;
+		/// the flag whether the subtree is changed since the last load
+		volatile long m_isChanged;
+		/// the flag whether the subtree is loaded
+		bool m_isLoaded;
+		/// the cached keys by the lower case path
+		std::map<EpTString,CachedKey> m_keyMap;
+		/// cache lock
+		BaseLock *m_cacheLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
 }
 
 
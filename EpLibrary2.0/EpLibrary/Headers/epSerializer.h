@@ -0,0 +1,879 @@
+/*! 
+@file epSerializer.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Binary Serializer Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Compact Binary Serializer over Stream.
+
+*/
+#ifndef __EP_SERIALIZER_H__
+#define __EP_SERIALIZER_H__
+#include "epLib.h"
+#include "epStream.h"
+#include <vector>
+
+/// the byte size of the message encoded on the stack instead of the heap
+#define SERIALIZE_STACK_BUFFER_SIZE 256
+
+/// the maximum byte size of the varint
+#define SERIALIZE_MAX_VARINT_SIZE 10
+
+namespace epl
+{
+	/// Enumeration for Serialize Wire Type
+	enum SerializeWireType{
+		/// The varint encoded integer
+		SERIALIZE_WIRE_TYPE_VARINT=0,
+		/// The 8-byte fixed value
+		SERIALIZE_WIRE_TYPE_FIXED64=1,
+		/// The length-prefixed bytes
+		SERIALIZE_WIRE_TYPE_LENGTH=2,
+		/// The 4-byte fixed value
+		SERIALIZE_WIRE_TYPE_FIXED32=5,
+	};
+
+	template<typename T>
+	class SerializeTraits;
+
+	/*!
+	@class SerializeVarint epSerializer.h
+	@brief A class for the varint and zigzag encoding of the integer.
+	*/
+	class SerializeVarint
+	{
+	public:
+		/*!
+		Return the byte size of the varint of given value.
+		@param[in] value the value to encode.
+		@return the byte size of the varint.
+		*/
+		static size_t GetSize(unsigned __int64 value)
+		{
+			size_t retSize=1;
+			while(value>=0x80)
+			{
+				value>>=7;
+				retSize++;
+			}
+			return retSize;
+		}
+
+		/*!
+		Map the signed value to the unsigned value, so the small negative value gets the short varint.
+		@param[in] value the signed value.
+		@return the zigzag encoded value.
+		*/
+		static unsigned __int64 ZigZag(__int64 value)
+		{
+			return (static_cast<unsigned __int64>(value)<<1)^static_cast<unsigned __int64>(value>>63);
+		}
+
+		/*!
+		Restore the signed value from the zigzag encoded value.
+		@param[in] value the zigzag encoded value.
+		@return the signed value.
+		*/
+		static __int64 UnZigZag(unsigned __int64 value)
+		{
+			return static_cast<__int64>(value>>1)^-static_cast<__int64>(value&1);
+		}
+	};
+
+	/*!
+	@class SerializeSizer epSerializer.h
+	@brief A class that counts the byte size of the fields visited.
+	*/
+	class SerializeSizer
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the sizer
+		*/
+		SerializeSizer()
+		{
+			m_size=0;
+		}
+
+		/*!
+		Count the byte size of the field.
+		@param[in] fieldId the id of the field.
+		@param[in] value the value of the field.
+		*/
+		template<typename T>
+		void Field(unsigned int fieldId, const T &value)
+		{
+			m_size+=SerializeVarint::GetSize((static_cast<unsigned __int64>(fieldId)<<3)|SerializeTraits<T>::WIRE_TYPE);
+			m_size+=SerializeTraits<T>::GetSize(value);
+		}
+
+		/*!
+		Return the byte size counted.
+		@return the byte size counted.
+		*/
+		size_t GetSize() const
+		{
+			return m_size;
+		}
+
+	private:
+		/// the byte size counted
+		size_t m_size;
+	};
+
+	/*!
+	@class SerializeWriter epSerializer.h
+	@brief A class that encodes the fields visited to the buffer.
+	@remark the buffer must hold the byte size counted by SerializeSizer.
+	*/
+	class SerializeWriter
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the writer
+		@param[in] buffer the buffer to encode to.
+		*/
+		SerializeWriter(unsigned char *buffer)
+		{
+			m_cursor=buffer;
+		}
+
+		/*!
+		Encode the field.
+		@param[in] fieldId the id of the field.
+		@param[in] value the value of the field.
+		*/
+		template<typename T>
+		void Field(unsigned int fieldId, const T &value)
+		{
+			WriteVarint((static_cast<unsigned __int64>(fieldId)<<3)|SerializeTraits<T>::WIRE_TYPE);
+			SerializeTraits<T>::Write(*this,value);
+		}
+
+		/*!
+		Encode the varint.
+		@param[in] value the value to encode.
+		*/
+		void WriteVarint(unsigned __int64 value)
+		{
+			while(value>=0x80)
+			{
+				*m_cursor++=static_cast<unsigned char>(value|0x80);
+				value>>=7;
+			}
+			*m_cursor++=static_cast<unsigned char>(value);
+		}
+
+		/*!
+		Copy the bytes.
+		@param[in] value the bytes to copy.
+		@param[in] byteSize the byte size to copy.
+		*/
+		void WriteBytes(const void *value, size_t byteSize)
+		{
+			if(byteSize)
+				memcpy(m_cursor,value,byteSize);
+			m_cursor+=byteSize;
+		}
+
+		/*!
+		Return the position to encode next.
+		@return the position to encode next.
+		*/
+		unsigned char *GetCursor() const
+		{
+			return m_cursor;
+		}
+
+	private:
+		/// the position to encode next
+		unsigned char *m_cursor;
+	};
+
+	/*!
+	@class SerializeReader epSerializer.h
+	@brief A class that decodes the fields visited from the buffer.
+
+	The fields must be visited in ascending order of the id.
+	The field of unknown id is skipped, and the field missing keeps its value.
+	*/
+	class SerializeReader
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the reader
+		@param[in] buffer the buffer to decode from.
+		@param[in] byteSize the byte size of the buffer.
+		*/
+		SerializeReader(const unsigned char *buffer, size_t byteSize)
+		{
+			m_cursor=buffer;
+			m_end=buffer+byteSize;
+			m_tag=0;
+			m_hasTag=false;
+			m_isFailed=false;
+		}
+
+		/*!
+		Decode the field.
+		@param[in] fieldId the id of the field.
+		@param[out] value the value of the field.
+		*/
+		template<typename T>
+		void Field(unsigned int fieldId, T &value)
+		{
+			while(!m_isFailed && peekTag())
+			{
+				unsigned __int64 streamId=m_tag>>3;
+				// the field of the greater id belongs to the next field, so this field is missing.
+				if(streamId>fieldId)
+					return;
+				m_hasTag=false;
+				if(streamId==fieldId && (m_tag&7)==SerializeTraits<T>::WIRE_TYPE)
+				{
+					if(!SerializeTraits<T>::Read(*this,value))
+						m_isFailed=true;
+					return;
+				}
+				// the field of unknown id, or of the changed type
+				skip(static_cast<unsigned int>(m_tag&7));
+			}
+		}
+
+		/*!
+		Decode the varint.
+		@param[out] retValue the value decoded.
+		@return true if successful, otherwise false.
+		*/
+		bool ReadVarint(unsigned __int64 &retValue)
+		{
+			retValue=0;
+			for(unsigned int shift=0;shift<SERIALIZE_MAX_VARINT_SIZE*7;shift+=7)
+			{
+				if(m_cursor>=m_end)
+					break;
+				unsigned char byte=*m_cursor++;
+				retValue|=static_cast<unsigned __int64>(byte&0x7F)<<shift;
+				if(!(byte&0x80))
+					return true;
+			}
+			m_isFailed=true;
+			return false;
+		}
+
+		/*!
+		Return the given number of bytes in place.
+		@param[in] byteSize the number of bytes.
+		@return the pointer to the bytes, or NULL if not enough bytes left.
+		*/
+		const unsigned char *ReadInPlace(size_t byteSize)
+		{
+			if(static_cast<size_t>(m_end-m_cursor)<byteSize)
+			{
+				m_isFailed=true;
+				return NULL;
+			}
+			const unsigned char *retData=m_cursor;
+			m_cursor+=byteSize;
+			return retData;
+		}
+
+		/*!
+		Start decoding the length-prefixed message.
+		@param[out] retOuterEnd the end of the outer message to restore.
+		@return true if successful, otherwise false.
+		*/
+		bool BeginMessage(const unsigned char *&retOuterEnd)
+		{
+			unsigned __int64 byteSize;
+			if(!ReadVarint(byteSize))
+				return false;
+			if(byteSize>static_cast<unsigned __int64>(m_end-m_cursor))
+			{
+				m_isFailed=true;
+				return false;
+			}
+			retOuterEnd=m_end;
+			m_end=m_cursor+static_cast<size_t>(byteSize);
+			m_hasTag=false;
+			return true;
+		}
+
+		/*!
+		Finish decoding the length-prefixed message, skipping the fields left.
+		@param[in] outerEnd the end of the outer message returned by BeginMessage.
+		*/
+		void EndMessage(const unsigned char *outerEnd)
+		{
+			m_cursor=m_end;
+			m_end=outerEnd;
+			m_hasTag=false;
+		}
+
+		/*!
+		Return the byte size left in the current message.
+		@return the byte size left.
+		*/
+		size_t GetRemainSize() const
+		{
+			return static_cast<size_t>(m_end-m_cursor);
+		}
+
+		/*!
+		Return the flag whether the decoding failed.
+		@return true if failed, otherwise false.
+		*/
+		bool IsFailed() const
+		{
+			return m_isFailed;
+		}
+
+	private:
+		/*!
+		Decode the tag of the next field, if not decoded yet.
+		@return true if the next field exists, otherwise false.
+		*/
+		bool peekTag()
+		{
+			if(m_hasTag)
+				return true;
+			if(m_cursor>=m_end)
+				return false;
+			m_hasTag=ReadVarint(m_tag);
+			return m_hasTag;
+		}
+
+		/*!
+		Skip the value of given wire type.
+		@param[in] wireType the wire type of the value.
+		*/
+		void skip(unsigned int wireType)
+		{
+			unsigned __int64 byteSize;
+			switch(wireType)
+			{
+			case SERIALIZE_WIRE_TYPE_VARINT:
+				ReadVarint(byteSize);
+				break;
+			case SERIALIZE_WIRE_TYPE_FIXED64:
+				ReadInPlace(8);
+				break;
+			case SERIALIZE_WIRE_TYPE_LENGTH:
+				if(ReadVarint(byteSize))
+				{
+					if(byteSize>GetRemainSize())
+						m_isFailed=true;
+					else
+						ReadInPlace(static_cast<size_t>(byteSize));
+				}
+				break;
+			case SERIALIZE_WIRE_TYPE_FIXED32:
+				ReadInPlace(4);
+				break;
+			default:
+				m_isFailed=true;
+				break;
+			}
+		}
+
+		/// the position to decode next
+		const unsigned char *m_cursor;
+		/// the end of the current message
+		const unsigned char *m_end;
+		/// the tag of the next field
+		unsigned __int64 m_tag;
+		/// the flag whether the tag of the next field is decoded
+		bool m_hasTag;
+		/// the flag whether the decoding failed
+		bool m_isFailed;
+	};
+
+	/*!
+	@class SerializeTraits epSerializer.h
+	@brief A class that encodes the message, the class with the member template Serialize.
+
+	The message is length-prefixed, and Serialize visits each field with SerializeSizer, SerializeWriter and SerializeReader.
+	*/
+	template<typename T>
+	class SerializeTraits
+	{
+	public:
+		/// the wire type of the message
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_LENGTH};
+
+		/*!
+		Return the byte size of the encoded value.
+		@param[in] value the value to encode.
+		@return the byte size of the encoded value.
+		*/
+		static size_t GetSize(const T &value)
+		{
+			size_t bodySize=getBodySize(value);
+			return SerializeVarint::GetSize(bodySize)+bodySize;
+		}
+
+		/*!
+		Encode the value.
+		@param[in] writer the writer to encode to.
+		@param[in] value the value to encode.
+		*/
+		static void Write(SerializeWriter &writer, const T &value)
+		{
+			writer.WriteVarint(getBodySize(value));
+			// the writer only reads the fields.
+			const_cast<T&>(value).Serialize(writer);
+		}
+
+		/*!
+		Decode the value.
+		@param[in] reader the reader to decode from.
+		@param[out] retValue the value decoded.
+		@return true if successful, otherwise false.
+		*/
+		static bool Read(SerializeReader &reader, T &retValue)
+		{
+			const unsigned char *outerEnd;
+			if(!reader.BeginMessage(outerEnd))
+				return false;
+			retValue.Serialize(reader);
+			reader.EndMessage(outerEnd);
+			return !reader.IsFailed();
+		}
+
+	private:
+		/*!
+		Return the byte size of the fields of the message.
+		@param[in] value the message.
+		@return the byte size of the fields.
+		*/
+		static size_t getBodySize(const T &value)
+		{
+			SerializeSizer sizer;
+			const_cast<T&>(value).Serialize(sizer);
+			return sizer.GetSize();
+		}
+	};
+
+	/*!
+	@class SerializeUnsignedTraits epSerializer.h
+	@brief A class that encodes the unsigned integer as the varint.
+	*/
+	template<typename T>
+	class SerializeUnsignedTraits
+	{
+	public:
+		/// the wire type of the unsigned integer
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_VARINT};
+
+		static size_t GetSize(const T &value)
+		{
+			return SerializeVarint::GetSize(static_cast<unsigned __int64>(value));
+		}
+		static void Write(SerializeWriter &writer, const T &value)
+		{
+			writer.WriteVarint(static_cast<unsigned __int64>(value));
+		}
+		static bool Read(SerializeReader &reader, T &retValue)
+		{
+			unsigned __int64 value;
+			if(!reader.ReadVarint(value))
+				return false;
+			retValue=static_cast<T>(value);
+			return true;
+		}
+	};
+
+	/*!
+	@class SerializeSignedTraits epSerializer.h
+	@brief A class that encodes the signed integer as the zigzag varint.
+	*/
+	template<typename T>
+	class SerializeSignedTraits
+	{
+	public:
+		/// the wire type of the signed integer
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_VARINT};
+
+		static size_t GetSize(const T &value)
+		{
+			return SerializeVarint::GetSize(SerializeVarint::ZigZag(static_cast<__int64>(value)));
+		}
+		static void Write(SerializeWriter &writer, const T &value)
+		{
+			writer.WriteVarint(SerializeVarint::ZigZag(static_cast<__int64>(value)));
+		}
+		static bool Read(SerializeReader &reader, T &retValue)
+		{
+			unsigned __int64 value;
+			if(!reader.ReadVarint(value))
+				return false;
+			retValue=static_cast<T>(SerializeVarint::UnZigZag(value));
+			return true;
+		}
+	};
+
+	/*!
+	@class SerializeFixedTraits epSerializer.h
+	@brief A class that encodes the floating point value as the fixed bytes in little-endian.
+	*/
+	template<typename T>
+	class SerializeFixedTraits
+	{
+	public:
+		/// the wire type of the floating point value
+		enum {WIRE_TYPE=(sizeof(T)==4)?SERIALIZE_WIRE_TYPE_FIXED32:SERIALIZE_WIRE_TYPE_FIXED64};
+
+		static size_t GetSize(const T &value)
+		{
+			return sizeof(T);
+		}
+		static void Write(SerializeWriter &writer, const T &value)
+		{
+			writer.WriteBytes(&value,sizeof(T));
+		}
+		static bool Read(SerializeReader &reader, T &retValue)
+		{
+			const unsigned char *data=reader.ReadInPlace(sizeof(T));
+			if(!data)
+				return false;
+			memcpy(&retValue,data,sizeof(T));
+			return true;
+		}
+	};
+
+	template<> class SerializeTraits<unsigned char>:public SerializeUnsignedTraits<unsigned char>{};
+	template<> class SerializeTraits<unsigned short>:public SerializeUnsignedTraits<unsigned short>{};
+	template<> class SerializeTraits<unsigned int>:public SerializeUnsignedTraits<unsigned int>{};
+	template<> class SerializeTraits<unsigned long>:public SerializeUnsignedTraits<unsigned long>{};
+	template<> class SerializeTraits<unsigned __int64>:public SerializeUnsignedTraits<unsigned __int64>{};
+	template<> class SerializeTraits<char>:public SerializeSignedTraits<char>{};
+	template<> class SerializeTraits<signed char>:public SerializeSignedTraits<signed char>{};
+	template<> class SerializeTraits<short>:public SerializeSignedTraits<short>{};
+	template<> class SerializeTraits<int>:public SerializeSignedTraits<int>{};
+	template<> class SerializeTraits<long>:public SerializeSignedTraits<long>{};
+	template<> class SerializeTraits<__int64>:public SerializeSignedTraits<__int64>{};
+	template<> class SerializeTraits<float>:public SerializeFixedTraits<float>{};
+	template<> class SerializeTraits<double>:public SerializeFixedTraits<double>{};
+
+	/*!
+	@class SerializeTraits<bool> epSerializer.h
+	@brief A class that encodes the boolean as the varint.
+	*/
+	template<>
+	class SerializeTraits<bool>
+	{
+	public:
+		/// the wire type of the boolean
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_VARINT};
+
+		static size_t GetSize(const bool &value)
+		{
+			return 1;
+		}
+		static void Write(SerializeWriter &writer, const bool &value)
+		{
+			writer.WriteVarint(value?1:0);
+		}
+		static bool Read(SerializeReader &reader, bool &retValue)
+		{
+			unsigned __int64 value;
+			if(!reader.ReadVarint(value))
+				return false;
+			retValue=(value!=0);
+			return true;
+		}
+	};
+
+	/*!
+	@class SerializeTraits<EpString> epSerializer.h
+	@brief A class that encodes the string as the length-prefixed characters.
+	*/
+	template<>
+	class SerializeTraits<EpString>
+	{
+	public:
+		/// the wire type of the string
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_LENGTH};
+
+		static size_t GetSize(const EpString &value)
+		{
+			return SerializeVarint::GetSize(value.length())+value.length();
+		}
+		static void Write(SerializeWriter &writer, const EpString &value)
+		{
+			writer.WriteVarint(value.length());
+			writer.WriteBytes(value.data(),value.length());
+		}
+		static bool Read(SerializeReader &reader, EpString &retValue)
+		{
+			unsigned __int64 length;
+			if(!reader.ReadVarint(length) || length>reader.GetRemainSize())
+				return false;
+			const unsigned char *data=reader.ReadInPlace(static_cast<size_t>(length));
+			if(!data)
+				return false;
+			retValue.assign(reinterpret_cast<const char*>(data),static_cast<size_t>(length));
+			return true;
+		}
+	};
+
+	/*!
+	@class SerializeTraits<EpWString> epSerializer.h
+	@brief A class that encodes the wide string as the length-prefixed characters.
+	*/
+	template<>
+	class SerializeTraits<EpWString>
+	{
+	public:
+		/// the wire type of the wide string
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_LENGTH};
+
+		static size_t GetSize(const EpWString &value)
+		{
+			size_t byteSize=value.length()*sizeof(wchar_t);
+			return SerializeVarint::GetSize(byteSize)+byteSize;
+		}
+		static void Write(SerializeWriter &writer, const EpWString &value)
+		{
+			size_t byteSize=value.length()*sizeof(wchar_t);
+			writer.WriteVarint(byteSize);
+			writer.WriteBytes(value.data(),byteSize);
+		}
+		static bool Read(SerializeReader &reader, EpWString &retValue)
+		{
+			unsigned __int64 byteSize;
+			if(!reader.ReadVarint(byteSize) || byteSize>reader.GetRemainSize() || byteSize%sizeof(wchar_t))
+				return false;
+			const unsigned char *data=reader.ReadInPlace(static_cast<size_t>(byteSize));
+			if(!data)
+				return false;
+			// the characters may be unaligned within the buffer.
+			retValue.resize(static_cast<size_t>(byteSize)/sizeof(wchar_t));
+			if(byteSize)
+				memcpy(&retValue[0],data,static_cast<size_t>(byteSize));
+			return true;
+		}
+	};
+
+	/*!
+	@class SerializeTraits<std::vector<T> > epSerializer.h
+	@brief A class that encodes the array as the length-prefixed count and elements.
+	*/
+	template<typename T>
+	class SerializeTraits<std::vector<T> >
+	{
+	public:
+		/// the wire type of the array
+		enum {WIRE_TYPE=SERIALIZE_WIRE_TYPE_LENGTH};
+
+		static size_t GetSize(const std::vector<T> &value)
+		{
+			size_t bodySize=getBodySize(value);
+			return SerializeVarint::GetSize(bodySize)+bodySize;
+		}
+		static void Write(SerializeWriter &writer, const std::vector<T> &value)
+		{
+			writer.WriteVarint(getBodySize(value));
+			writer.WriteVarint(value.size());
+			for(size_t elementTrav=0;elementTrav<value.size();elementTrav++)
+				SerializeTraits<T>::Write(writer,value[elementTrav]);
+		}
+		static bool Read(SerializeReader &reader, std::vector<T> &retValue)
+		{
+			const unsigned char *outerEnd;
+			if(!reader.BeginMessage(outerEnd))
+				return false;
+			unsigned __int64 count;
+			// every element takes at least one byte, so the broken count is caught before the allocation.
+			if(!reader.ReadVarint(count) || count>reader.GetRemainSize())
+			{
+				reader.EndMessage(outerEnd);
+				return false;
+			}
+			retValue.resize(static_cast<size_t>(count));
+			bool retVal=true;
+			for(size_t elementTrav=0;elementTrav<retValue.size() && retVal;elementTrav++)
+				retVal=SerializeTraits<T>::Read(reader,retValue[elementTrav]);
+			reader.EndMessage(outerEnd);
+			return retVal;
+		}
+
+	private:
+		static size_t getBodySize(const std::vector<T> &value)
+		{
+			size_t retSize=SerializeVarint::GetSize(value.size());
+			for(size_t elementTrav=0;elementTrav<value.size();elementTrav++)
+				retSize+=SerializeTraits<T>::GetSize(value[elementTrav]);
+			return retSize;
+		}
+	};
+
+	/*!
+	@class Serializer epSerializer.h
+	@brief A class that serializes the message in the compact binary format.
+
+	The message is the class with the member template Serialize, which visits each field with its id in ascending order.
+	(e.g. template<typename ArchiveType> void Serialize(ArchiveType &archive){ archive.Field(1,m_id); archive.Field(2,m_name); })
+	Each field is written with its id and wire type, the integers are varint and zigzag encoded, 
+	and the strings, arrays and nested messages are length-prefixed.
+	The reader skips the field of unknown id and keeps the value of the field missing, 
+	so the older and newer versions of the message read each other.
+	*/
+	class Serializer
+	{
+	public:
+		/*!
+		Return the byte size of the serialized message.
+		@param[in] message the message to serialize.
+		@return the byte size of the serialized message.
+		*/
+		template<typename T>
+		static size_t GetSize(const T &message)
+		{
+			return SerializeTraits<T>::GetSize(message);
+		}
+
+		/*!
+		Serialize the message to the given buffer.
+		@param[out] retBuffer the buffer to serialize to.
+		@param[in] bufferSize the byte size of the buffer.
+		@param[in] message the message to serialize.
+		@return the byte size serialized, or 0 if the buffer is too small.
+		*/
+		template<typename T>
+		static size_t Write(unsigned char *retBuffer, size_t bufferSize, const T &message)
+		{
+			size_t byteSize=SerializeTraits<T>::GetSize(message);
+			if(!retBuffer || byteSize>bufferSize)
+				return 0;
+			SerializeWriter writer(retBuffer);
+			SerializeTraits<T>::Write(writer,message);
+			return byteSize;
+		}
+
+		/*!
+		Serialize the message to the stream.
+		@param[in] stream the stream to serialize to.
+		@param[in] message the message to serialize.
+		@return true if successful, otherwise false.
+		@remark the message is encoded at once and written with one call, so the stream is locked only once.
+		*/
+		template<typename T>
+		static bool Write(Stream &stream, const T &message)
+		{
+			size_t byteSize=SerializeTraits<T>::GetSize(message);
+			unsigned char stackBuffer[SERIALIZE_STACK_BUFFER_SIZE];
+			unsigned char *buffer=stackBuffer;
+			if(byteSize>SERIALIZE_STACK_BUFFER_SIZE)
+			{
+				buffer=reinterpret_cast<unsigned char*>(EP_MallocTag(byteSize,MEMORY_TAG_STREAM));
+				if(!buffer)
+					return false;
+			}
+			SerializeWriter writer(buffer);
+			SerializeTraits<T>::Write(writer,message);
+			EP_ASSERT_EXPR(writer.GetCursor()==buffer+byteSize,_T("The serialized size does not match!"));
+			bool retVal=stream.WriteBytes(buffer,byteSize);
+			if(buffer!=stackBuffer)
+				EP_FreeTag(buffer,MEMORY_TAG_STREAM);
+			return retVal;
+		}
+
+		/*!
+		Deserialize the message from the given buffer.
+		@param[in] buffer the buffer to deserialize from.
+		@param[in] byteSize the byte size of the buffer.
+		@param[out] retMessage the message deserialized.
+		@return true if successful, otherwise false.
+		*/
+		template<typename T>
+		static bool Read(const unsigned char *buffer, size_t byteSize, T &retMessage)
+		{
+			if(!buffer)
+				return false;
+			SerializeReader reader(buffer,byteSize);
+			return SerializeTraits<T>::Read(reader,retMessage);
+		}
+
+		/*!
+		Deserialize the message from the stream.
+		@param[in] stream the stream to deserialize from.
+		@param[out] retMessage the message deserialized.
+		@return true if successful, otherwise false.
+		@remark the fields are decoded in place if the stream holds the whole message, 
+		such as the stream attached to the buffer, otherwise copied once.
+		*/
+		template<typename T>
+		static bool Read(Stream &stream, T &retMessage)
+		{
+			Stream::BatchLockObj lock(&stream);
+			// the length prefix is read byte by byte, so nothing after the message is read.
+			unsigned __int64 byteSize=0;
+			unsigned char byte=0x80;
+			for(unsigned int shift=0;(byte&0x80);shift+=7)
+			{
+				if(shift>=SERIALIZE_MAX_VARINT_SIZE*7 || !stream.ReadByte(byte))
+					return false;
+				byteSize|=static_cast<unsigned __int64>(byte&0x7F)<<shift;
+			}
+			if(byteSize!=static_cast<size_t>(byteSize))
+				return false;
+
+			const unsigned char *body=stream.ReadInPlace(static_cast<size_t>(byteSize));
+			unsigned char *copied=NULL;
+			if(!body)
+			{
+				copied=reinterpret_cast<unsigned char*>(EP_MallocTag(static_cast<size_t>(byteSize),MEMORY_TAG_STREAM));
+				if(!copied)
+					return false;
+				if(!stream.ReadBytes(copied,static_cast<size_t>(byteSize)))
+				{
+					EP_FreeTag(copied,MEMORY_TAG_STREAM);
+					return false;
+				}
+				body=copied;
+			}
+			SerializeReader reader(body,static_cast<size_t>(byteSize));
+			retMessage.Serialize(reader);
+			bool retVal=!reader.IsFailed();
+			if(copied)
+				EP_FreeTag(copied,MEMORY_TAG_STREAM);
+			return retVal;
+		}
+	};
+}
+#endif //__EP_SERIALIZER_H__
\ No newline at end of file
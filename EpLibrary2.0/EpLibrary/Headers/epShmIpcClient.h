@@ -0,0 +1,207 @@
+/*! 
+@file epShmIpcClient.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Shared Memory IPC Client Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Shared Memory IPC Client.
+
+*/
+#ifndef __EP_SHM_IPC_CLIENT_H__
+#define __EP_SHM_IPC_CLIENT_H__
+#include "epLib.h"
+#include "epThread.h"
+#include "epIpcClientInterfaces.h"
+#include "epShmIpcConf.h"
+
+namespace epl{
+
+	/*! 
+	@class ShmIpcClient epShmIpcClient.h
+	@brief A class for IPC Client over the shared memory.
+
+	The client creates the pair of rings for the connection and requests the server to open it.
+	The messages are read in place from the ring on the thread of this instance,
+	and the write is copied into the ring and completed before Write returns.
+	*/
+	class EP_LIBRARY ShmIpcClient:public Thread, public IpcClientInterface
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the IPC Client
+		@param[in] lockPolicyType lock policy
+		*/
+		ShmIpcClient(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Client
+		*/
+		virtual ~ShmIpcClient();
+
+		/*!
+		Get the pipe name of server
+		@return the pipe name in string
+		*/
+		virtual epl::EpTString GetFullPipeName() const;
+
+		/*!
+		Set the Callback Object for the server.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		virtual void SetCallbackObject(IpcClientCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object of server
+		@return the current Callback Object
+		*/
+		virtual IpcClientCallbackInterface *GetCallbackObject();
+
+		/*!
+		Connect to the server
+		@param[in] ops the client options
+		@param[in] waitTimeInMilliSec the wait time for the server to accept in milli-second. (0 to use the wait time of the options)
+		@return connect status
+		@remark the domain of the options is ignored.
+		*/
+		virtual ConnectStatus Connect(const IpcClientOps &ops=IpcClientOps::defaultIpcClientOps, unsigned int waitTimeInMilliSec=0);
+
+		/*!
+		Disconnect from the server
+		*/
+		virtual void Disconnect();
+
+		/*!
+		Check if the client is connected to server
+		@return true if the client is connected to server otherwise false
+		*/
+		virtual bool IsConnected() const;
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Get the maximum read data byte size
+		@return the maximum read data byte size
+		*/
+		virtual unsigned int GetMaxReadDataByteSize() const;
+
+		/*!
+		Write data to the pipe
+		@param[in] data the data to write
+		@param[in] dataByteSize byte size of the data
+		@remark the write is reported to OnWriteComplete before return,
+		        with WRITE_STATUS_FAIL_QUEUE_FULL if the ring has no room.
+		*/
+		virtual void Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@remark the segments are gathered directly into the ring.
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize byte size of the data to write
+		@return the write element whose m_data holds dataByteSize bytes
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize);
+
+		/*!
+		Write the pooled write buffer to the pipe
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, and it is released once copied into the ring.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem);
+
+	protected:
+		/*!
+		Read the messages until the connection is closed.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ShmIpcClient(const ShmIpcClient & b):Thread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ShmIpcClient &operator=(const ShmIpcClient & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Post the connect request to the control block of the server
+		@param[in] connectionName the name of the connection created
+		@param[in] waitTimeInMilliSec the wait time for the free slot in milli-second
+		@return connect status
+		*/
+		ConnectStatus request(const TCHAR *connectionName, unsigned int waitTimeInMilliSec);
+
+		/*!
+		Wait for the thread of this instance and close the connection
+		*/
+		void closeConnection();
+
+		/// IPC client options
+		IpcClientOps m_options;
+		/// Name of the pipe
+		EpTString m_pipeName;
+		/// Lock policy
+		LockPolicy m_lockPolicy;
+		/// the connection
+		ShmIpcChannel m_channel;
+		/// the number of the connections created in this process, to make the connection name unique
+		static volatile long m_connectionCount;
+
+		/// the pool of the write buffers (created at Connect)
+		IpcWriteBufferPool *m_writeBufferPool;
+	};
+}
+
+#endif //__EP_SHM_IPC_CLIENT_H__
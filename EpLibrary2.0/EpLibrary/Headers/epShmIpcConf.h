@@ -0,0 +1,414 @@
+/*! 
+@file epShmIpcConf.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Shared Memory IPC Configuration Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Shared Memory IPC Configuration.
+
+*/
+#ifndef __EP_SHM_IPC_CONF_H__
+#define __EP_SHM_IPC_CONF_H__
+#include "epLib.h"
+#include "epIpcConf.h"
+
+namespace epl
+{
+
+/// the prefix of the name of the control block of the server
+#define SHM_IPC_NAME_PREFIX _T("Local\\EpShmIpc_")
+/// the suffix of the name of the event set when the connection is requested
+#define SHM_IPC_ACCEPT_EVENT_SUFFIX _T("_accept")
+/// the number of the connect request slots in the control block of the server
+#define SHM_IPC_REQUEST_SLOT_COUNT 32
+/// the maximum length of the connection name including the NULL
+#define SHM_IPC_MAX_NAME_LENGTH 128
+/// the minimum byte size of the ring for each direction of the connection
+#define SHM_IPC_DEFAULT_RING_BYTE_SIZE 1048576
+/// the number of the polls before the reader waits on the event
+#define SHM_IPC_SPIN_COUNT 4000
+/// the record header marking the rest of the ring is skipped
+#define SHM_RING_WRAP_MARKER 0xFFFFFFFF
+/// the alignment of each record in the ring
+#define SHM_RING_RECORD_ALIGNMENT 8
+/// the byte size of the cache line the producer and the consumer are kept apart
+#define SHM_RING_CACHE_LINE_SIZE 64
+
+	/// Enumeration for the state of the connect request slot
+	typedef enum _shmIpcSlotState{
+		/// The slot is free
+		SHM_IPC_SLOT_STATE_FREE=0,
+		/// The slot is claimed by the client filling the request
+		SHM_IPC_SLOT_STATE_CLAIMED,
+		/// The request is ready for the server
+		SHM_IPC_SLOT_STATE_REQUESTED,
+	}ShmIpcSlotState;
+
+	/// Enumeration for the state of the connection
+	typedef enum _shmIpcConnectionState{
+		/// The connection is waiting for the server
+		SHM_IPC_CONNECTION_STATE_REQUESTED=0,
+		/// The connection is accepted by the server
+		SHM_IPC_CONNECTION_STATE_CONNECTED,
+		/// The connection is rejected by the server
+		SHM_IPC_CONNECTION_STATE_REJECTED,
+	}ShmIpcConnectionState;
+
+	/*! 
+	@struct ShmIpcRequestSlot epShmIpcConf.h
+	@brief A struct for the connect request posted by the client.
+	*/
+	struct ShmIpcRequestSlot{
+		/// the state of the slot
+		volatile long m_state;
+		/// the name of the connection the client created
+		TCHAR m_connectionName[SHM_IPC_MAX_NAME_LENGTH];
+	};
+
+	/*! 
+	@struct ShmIpcControlBlock epShmIpcConf.h
+	@brief A struct for the shared control block the server publishes.
+	*/
+	struct ShmIpcControlBlock{
+		/// the process ID of the server
+		unsigned long m_serverProcessId;
+		/// the flag whether the server is accepting
+		volatile long m_isAccepting;
+		/// the connect request slots
+		ShmIpcRequestSlot m_slots[SHM_IPC_REQUEST_SLOT_COUNT];
+	};
+
+	/*! 
+	@struct ShmIpcConnectionBlock epShmIpcConf.h
+	@brief A struct for the shared header of one connection, followed by the rings of both directions.
+	*/
+	struct ShmIpcConnectionBlock{
+		/// the state of the connection
+		volatile long m_state;
+		/// the process ID of the client
+		unsigned long m_clientProcessId;
+		/// the process ID of the server
+		unsigned long m_serverProcessId;
+		/// the byte size of the ring from the client to the server
+		unsigned int m_clientToServerCapacity;
+		/// the byte size of the ring from the server to the client
+		unsigned int m_serverToClientCapacity;
+		/// the flag whether the client closed the connection
+		volatile long m_isClientClosed;
+		/// the flag whether the server closed the connection
+		volatile long m_isServerClosed;
+	};
+
+	/*! 
+	@struct ShmRingHeader epShmIpcConf.h
+	@brief A struct for the shared header of the ring, with the producer and the consumer on the separate cache lines.
+	*/
+	struct ShmRingHeader{
+		/// the byte offset the producer writes next
+		volatile long m_head;
+		/// padding to the cache line
+		char m_headPadding[SHM_RING_CACHE_LINE_SIZE-sizeof(long)];
+		/// the byte offset the consumer reads next
+		volatile long m_tail;
+		/// the flag whether the consumer is waiting on the event
+		volatile long m_isConsumerWaiting;
+		/// padding to the cache line
+		char m_tailPadding[SHM_RING_CACHE_LINE_SIZE-sizeof(long)*2];
+	};
+
+	/*! 
+	@class ShmRing epShmIpcConf.h
+	@brief A class for the single producer, single consumer ring of variable-size messages in the shared memory.
+
+	Each message is one record of the length header and the data, which never wraps around,
+	so the consumer reads the message in place.
+	*/
+	class EP_LIBRARY ShmRing{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the ring detached
+		*/
+		ShmRing();
+
+		/*!
+		Return the byte size of the shared memory the ring takes.
+		@param[in] capacity the byte size of the ring data.
+		@return the byte size including the header.
+		*/
+		static size_t GetRequiredByteSize(unsigned int capacity);
+
+		/*!
+		Return the ring capacity which holds the messages of given byte size.
+		@param[in] maxMessageByteSize the maximum byte size of the message.
+		@return the power of two capacity at least SHM_IPC_DEFAULT_RING_BYTE_SIZE.
+		*/
+		static unsigned int GetCapacityFor(unsigned int maxMessageByteSize);
+
+		/*!
+		Attach the ring to the shared memory.
+		@param[in] memory the shared memory of GetRequiredByteSize bytes.
+		@param[in] capacity the byte size of the ring data, which must be the power of two.
+		@param[in] isInitialize the flag whether to initialize the header.
+		*/
+		void Attach(void *memory, unsigned int capacity, bool isInitialize);
+
+		/*!
+		Return the maximum byte size of one message.
+		@return the maximum byte size of one message.
+		*/
+		unsigned int GetMaxMessageByteSize() const;
+
+		/*!
+		Push the segments as one message.
+		@param[in] segmentList the segments to gather.
+		@param[in] segmentCount the number of the segments.
+		@param[in] byteSize the byte size of all segments.
+		@return true if pushed, false if the ring is full.
+		@remark only one thread may push at a time.
+		*/
+		bool Push(const IpcWriteSegment *segmentList, unsigned int segmentCount, unsigned int byteSize);
+
+		/*!
+		Return the message at the front without removing it.
+		@param[out] retByteSize set to the byte size of the message.
+		@return the data of the message in place, or NULL if the ring is empty.
+		@remark only one thread may consume at a time.
+		*/
+		const char *Peek(unsigned int &retByteSize);
+
+		/*!
+		Remove the message returned by the last Peek.
+		*/
+		void Pop();
+
+		/*!
+		Check if the ring is empty.
+		@return true if empty, otherwise false.
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		Set the flag whether the consumer is waiting on the event.
+		@param[in] isWaiting the flag to set.
+		@remark the flag is set with the full barrier, so the consumer checks the ring again after setting it.
+		*/
+		void SetConsumerWaiting(bool isWaiting);
+
+		/*!
+		Check if the consumer is waiting on the event.
+		@return true if waiting, otherwise false.
+		*/
+		bool IsConsumerWaiting() const;
+
+	private:
+		/// the shared header
+		ShmRingHeader *m_header;
+		/// the shared ring data
+		char *m_data;
+		/// the byte size of the ring data
+		unsigned int m_capacity;
+		/// the byte size of the record returned by the last Peek
+		unsigned int m_peekRecordSize;
+	};
+
+	/*! 
+	@class ShmIpcChannel epShmIpcConf.h
+	@brief A class for one end of the shared memory connection.
+
+	The writer wakes the reader by the event only when the reader is waiting,
+	and the reader polls for SHM_IPC_SPIN_COUNT times before waiting,
+	so the busy connection takes no kernel transition.
+	*/
+	class EP_LIBRARY ShmIpcChannel{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the channel
+		@param[in] lockPolicyType The lock policy
+		*/
+		ShmIpcChannel(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Close the channel
+		*/
+		virtual ~ShmIpcChannel();
+
+		/*!
+		Create the connection as the client.
+		@param[in] connectionName the name of the connection.
+		@param[in] clientToServerCapacity the byte size of the ring to the server.
+		@param[in] serverToClientCapacity the byte size of the ring to the client.
+		@return true if successfully created, otherwise false.
+		*/
+		bool Create(const TCHAR *connectionName, unsigned int clientToServerCapacity, unsigned int serverToClientCapacity);
+
+		/*!
+		Open the connection created by the client as the server.
+		@param[in] connectionName the name of the connection.
+		@return true if successfully opened, otherwise false.
+		*/
+		bool Open(const TCHAR *connectionName);
+
+		/*!
+		Unmap the connection.
+		@remark the reader must not be running.
+		*/
+		void Close();
+
+		/*!
+		Check if the channel is mapped.
+		@return true if mapped, otherwise false.
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Return the shared header of the connection.
+		@return the shared header, or NULL if not mapped.
+		*/
+		ShmIpcConnectionBlock *GetBlock() const;
+
+		/*!
+		Watch the process of the peer, so the connection is closed when the peer exits.
+		@param[in] processId the process ID of the peer.
+		*/
+		void WatchPeer(unsigned long processId);
+
+		/*!
+		Send the segments as one message.
+		@param[in] segmentList the segments to gather.
+		@param[in] segmentCount the number of the segments.
+		@param[in] byteSize the byte size of all segments.
+		@return true if sent, false if the ring is full.
+		*/
+		bool Send(const IpcWriteSegment *segmentList, unsigned int segmentCount, unsigned int byteSize);
+
+		/*!
+		Return the maximum byte size of the message sent.
+		@return the maximum byte size of the message sent.
+		*/
+		unsigned int GetMaxSendByteSize() const;
+
+		/*!
+		Wait until the message arrives.
+		@return true if the message is arrived, false if the connection is closed.
+		*/
+		bool WaitForData();
+
+		/*!
+		Return the message arrived without removing it.
+		@param[out] retByteSize set to the byte size of the message.
+		@return the data of the message in place, or NULL if nothing arrived.
+		*/
+		const char *Peek(unsigned int &retByteSize);
+
+		/*!
+		Remove the message returned by the last Peek.
+		*/
+		void Pop();
+
+		/*!
+		Close this end of the connection, and wake both ends.
+		*/
+		void Shutdown();
+
+		/*!
+		Check if either end closed the connection.
+		@return true if closed, otherwise false.
+		*/
+		bool IsClosed() const;
+
+		/*!
+		Wake the peer waiting for the state of the connection.
+		*/
+		void NotifyPeer();
+
+		/*!
+		Wait for the peer to notify.
+		@param[in] waitTimeInMilliSec the time to wait in milliseconds.
+		@return true if notified, false if timed out.
+		*/
+		bool WaitForNotify(unsigned int waitTimeInMilliSec);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ShmIpcChannel(const ShmIpcChannel & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ShmIpcChannel &operator=(const ShmIpcChannel & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Attach the rings and the events to the connection mapped.
+		@param[in] connectionName the name of the connection.
+		@param[in] isServer the flag whether this end is the server.
+		@param[in] isInitialize the flag whether to initialize the rings.
+		@return true if successful, otherwise false.
+		*/
+		bool attach(const TCHAR *connectionName, bool isServer, bool isInitialize);
+
+		/// the mapping handle
+		HANDLE m_mapping;
+		/// the shared header of the connection
+		ShmIpcConnectionBlock *m_block;
+		/// the ring to send
+		ShmRing m_sendRing;
+		/// the ring to receive
+		ShmRing m_recvRing;
+		/// the event to wake the peer
+		HANDLE m_sendEvent;
+		/// the event to wake this end
+		HANDLE m_recvEvent;
+		/// the handle of the peer process
+		HANDLE m_peerProcess;
+		/// the flag whether this end closed
+		volatile long *m_isSelfClosed;
+		/// the flag whether the peer closed
+		volatile long *m_isPeerClosed;
+		/// the lock for the producer, so many threads can send
+		BaseLock *m_sendLock;
+	};
+}
+
+#endif //__EP_SHM_IPC_CONF_H__
@@ -0,0 +1,196 @@
+/*! 
+@file epShmIpcPipe.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Shared Memory IPC Pipe Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Shared Memory IPC Pipe.
+
+*/
+#ifndef __EP_SHM_IPC_PIPE_H__
+#define __EP_SHM_IPC_PIPE_H__
+#include "epLib.h"
+#include "epThread.h"
+#include "epSmartObject.h"
+#include "epIpcServerInterfaces.h"
+#include "epShmIpcConf.h"
+
+namespace epl{
+
+	class ShmIpcServer;
+
+	/*! 
+	@class ShmIpcPipe epShmIpcPipe.h
+	@brief A class for the server end of one shared memory connection.
+
+	The messages are read in place from the ring on the thread of this instance,
+	and the write is copied into the ring and completed before Write returns.
+	*/
+	class EP_LIBRARY ShmIpcPipe:public Thread, public IpcInterface, public SmartObject
+	{
+		friend class ShmIpcServer;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Pipe
+		@param[in] server the server which owns this instance
+		@param[in] options the options for the pipe
+		@param[in] writeBufferPool the write buffer pool shared with other instances
+		@param[in] lockPolicyType lock policy
+		*/
+		ShmIpcPipe(ShmIpcServer *server, const IpcServerOps &options, IpcWriteBufferPool *writeBufferPool, epl::LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Pipe
+		*/
+		virtual ~ShmIpcPipe();
+
+		/*!
+		Write data to the pipe
+		@param[in] data the data to write
+		@param[in] dataByteSize byte size of the data
+		@remark the write is reported to OnWriteComplete before return,
+		        with WRITE_STATUS_FAIL_QUEUE_FULL if the ring has no room.
+		*/
+		virtual void Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@remark the segments are gathered directly into the ring.
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize byte size of the data to write
+		@return the write element whose m_data holds dataByteSize bytes
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize);
+
+		/*!
+		Write the pooled write buffer to the pipe
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, and it is released once copied into the ring.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem);
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Check if the connection is alive
+		@return true if the connection is alive otherwise false
+		*/
+		virtual bool IsConnectionAlive() const;
+
+		/*!
+		Kill the connection
+		@remark the disconnect is reported on the thread of this instance.
+		*/
+		virtual void KillConnection();
+
+		/*!
+		Set the Callback Object for the server.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		virtual void SetCallbackObject(IpcServerCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object of server
+		@return the current Callback Object
+		*/
+		virtual IpcServerCallbackInterface *GetCallbackObject();
+
+	protected:
+		/*!
+		Read the messages until the connection is closed.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ShmIpcPipe(const ShmIpcPipe & b):Thread(b),SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ShmIpcPipe &operator=(const ShmIpcPipe & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Open the connection the client requested
+		@param[in] connectionName the name of the connection
+		@return true if successfully opened otherwise false
+		*/
+		bool open(const TCHAR *connectionName);
+
+		/*!
+		Accept or reject the connection opened, and start reading if accepted
+		@param[in] isAccept the flag whether to accept
+		@return true if the connection is accepted and started otherwise false
+		*/
+		bool accept(bool isAccept);
+
+		/*!
+		Check if the thread of this instance finished
+		@return true if finished otherwise false
+		*/
+		bool isFinished() const;
+
+		/// the server which owns this instance
+		ShmIpcServer *m_server;
+		/// the options for the pipe
+		IpcServerOps m_options;
+		/// the connection
+		ShmIpcChannel m_channel;
+		/// the pool of the write buffers
+		IpcWriteBufferPool *m_writeBufferPool;
+		/// the flag whether the thread of this instance finished
+		volatile long m_isFinished;
+	};
+}
+#endif //__EP_SHM_IPC_PIPE_H__
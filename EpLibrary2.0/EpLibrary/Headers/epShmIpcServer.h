@@ -0,0 +1,211 @@
+/*! 
+@file epShmIpcServer.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Shared Memory IPC Server Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Shared Memory IPC Server.
+
+*/
+#ifndef __EP_SHM_IPC_SERVER_H__
+#define __EP_SHM_IPC_SERVER_H__
+#include "epLib.h"
+#include "epThread.h"
+#include "epIpcServerInterfaces.h"
+#include "epShmIpcConf.h"
+#include "epShmIpcPipe.h"
+#include <vector>
+
+using namespace std;
+
+namespace epl{
+
+	/*! 
+	@class ShmIpcServer epShmIpcServer.h
+	@brief A class for IPC Server over the shared memory.
+
+	The server publishes the control block under the pipe name, and each client
+	creates its own pair of rings and requests the connection through the slots of the control block.
+	The transport is local to the machine, so the domain of the options is ignored.
+	*/
+	class EP_LIBRARY ShmIpcServer:public Thread,public IpcServerInterface{
+		friend class ShmIpcPipe;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the IPC Server
+		@param[in] lockPolicyType lock policy
+		*/
+		ShmIpcServer(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+	
+		/*!
+		Default Destructor
+
+		Destroy the Server
+		*/
+		virtual ~ShmIpcServer();
+
+		/*!
+		Get the pipe name of server
+		@return the pipe name in string
+		*/
+		virtual epl::EpTString GetFullPipeName() const;
+
+		/*!
+		Get the Maximum Instances of server
+		@return the Maximum Instances
+		*/
+		virtual unsigned int GetMaximumInstances() const;
+
+		/*!
+		Set the Callback Object for the server.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		virtual void SetCallbackObject(IpcServerCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object of server
+		@return the current Callback Object
+		*/
+		virtual IpcServerCallbackInterface *GetCallbackObject();
+
+		/*!
+		Start the server
+		@param[in] ops the server options
+		@return true if successfully started otherwise false
+		@remark the domain of the options is ignored.
+		*/
+		virtual bool StartServer(const IpcServerOps &ops=IpcServerOps::defaultIpcServerOps);
+
+		/*!
+		Stop the server
+		*/
+		virtual void StopServer();
+
+		/*!
+		Check if the server is started
+		@return true if the server is started otherwise false
+		*/
+		virtual bool IsServerStarted() const;
+
+		/*!
+		Terminate all clients' connection.
+		*/
+		virtual void ShutdownAllClient();
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Get the maximum read data byte size
+		@return the maximum read data byte size
+		*/
+		virtual unsigned int GetMaxReadDataByteSize() const;
+
+	private:
+		/*!
+		Accepting Loop Function
+		*/
+		virtual void execute();
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ShmIpcServer(const ShmIpcServer & b):Thread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ShmIpcServer &operator=(const ShmIpcServer & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Open the connections requested in the slots of the control block
+		*/
+		void acceptRequests();
+
+		/*!
+		Actually release the control block and the accept event
+		*/
+		void stopServer();
+
+		/*!
+		Remove and release the instances
+		@param[in] isAll the flag whether to remove all instances, otherwise only the finished instances are removed
+		*/
+		void removeInstances(bool isAll);
+
+		/*!
+		Wake up the accepting loop
+		@remark this is called by the instance whose connection is finished.
+		*/
+		void wakeUp();
+
+	private:
+		/// pipe list
+		vector<ShmIpcPipe*> m_pipes; 
+
+		/// flag whether the server is started
+		bool m_started;
+		/// flag whether the server is stopping
+		volatile bool m_isStopping;
+		/// IPC server options
+		IpcServerOps m_options;
+		/// Name of the pipe
+		EpTString m_pipeName;
+		/// Lock policy
+		LockPolicy m_lockPolicy;
+		/// pipe list lock
+		BaseLock *m_pipesLock;
+
+		/// the file mapping of the control block
+		HANDLE m_controlMapping;
+		/// the control block
+		ShmIpcControlBlock *m_control;
+		/// the event set by the client requesting the connection
+		HANDLE m_acceptEvent;
+
+		/// the pool of the write buffers shared by all instances
+		IpcWriteBufferPool *m_writeBufferPool;
+	};
+
+}
+
+#endif //__EP_SHM_IPC_SERVER_H__
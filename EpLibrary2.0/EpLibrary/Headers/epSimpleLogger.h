@@ -40,6 +40,7 @@ An Interface for Managing the Logs.
 #include "epLib.h"
 #include "epBaseOutputter.h"
 #include "epSingletonHolder.h"
+#include "epDateTimeHelper.h"
 
 
 
@@ -75,17 +76,206 @@ Macro that logs the line, and time where it called, with user message.
 #define LOG_THIS_MSG(inputString,...) ((void)0)
 #endif
 
+/*!
+@def LOG_ASYNC_MSG
+@brief Simple Macro to log simple line with msg, asynchronously.
+
+Macro that logs the line, and time where it called, with user message, when EP_ENABLE_ASYNC_LOG is defined.
+The calling thread only copies the arguments to its ring,
+and the background thread formats them, and writes to the file.
+@remark the %s arguments are copied, but the other pointers are logged as the values only.
+*/
+#if defined(EP_ENABLE_ASYNC_LOG)
+#define LOG_ASYNC_MSG(inputString,...) do{static volatile long epAsyncLogSiteId=0; LOG_INSTANCE.AddAsyncLog(epAsyncLogSiteId,__TFILE__,__TFUNCTION__,__LINE__,inputString,__VA_ARGS__);}while(0)
+#else
+#define LOG_ASYNC_MSG(inputString,...) ((void)0)
+#endif
+
+/*!
+@def LOG_ASYNC
+@brief Simple Macro to log simple line, asynchronously.
+
+Macro that logs the line and time where it called, when EP_ENABLE_ASYNC_LOG is defined.
+*/
+#if defined(EP_ENABLE_ASYNC_LOG)
+#define LOG_ASYNC LOG_ASYNC_MSG(_T(""))
+#else
+#define LOG_ASYNC ((void)0)
+#endif
+
+/// the trace level, which is the lowest
+#define EP_LOG_LEVEL_TRACE 0
+/// the debug level
+#define EP_LOG_LEVEL_DEBUG 1
+/// the info level
+#define EP_LOG_LEVEL_INFO 2
+/// the warning level
+#define EP_LOG_LEVEL_WARN 3
+/// the error level
+#define EP_LOG_LEVEL_ERROR 4
+/// the fatal level, which is the highest
+#define EP_LOG_LEVEL_FATAL 5
+/// the level above all levels, which disables the logs
+#define EP_LOG_LEVEL_OFF 6
+
+#if !defined(EP_LOG_COMPILE_LEVEL)
+/// the lowest level compiled, and the lower levels compile to nothing
+#define EP_LOG_COMPILE_LEVEL EP_LOG_LEVEL_TRACE
+#endif
+
+/// the number of the log categories (must be the power of two)
+#define LOG_MAX_CATEGORY_COUNT 64
+
+/// the default category of the logs
+#define LOG_CATEGORY_DEFAULT 0
+
+/// the lowest level enabled at the start for all categories
+#define LOG_DEFAULT_LEVEL EP_LOG_LEVEL_INFO
+
+/*!
+@def LOG_LEVEL_MSG
+@brief Simple Macro to log simple line with msg, in the given level and category.
+
+Macro that logs the line, and time where it called, with user message, if the level is enabled for the category.
+The arguments are not evaluated if the level is disabled, which costs one load.
+The log is written asynchronously with LOG_ASYNC_MSG, in any build.
+@param[in] level the epl::LogLevel of the log.
+@param[in] category the category of the log, less than LOG_MAX_CATEGORY_COUNT.
+@param[in] inputString the format of the user message.
+@remark Usage: LOG_LEVEL_MSG(epl::LOG_LEVEL_WARN,LOG_CATEGORY_DEFAULT,_T("retry %d"),retryCount);
+*/
+#define LOG_LEVEL_MSG(level,category,inputString,...) do{if(epl::SimpleLogManager::IsLogEnabled(level,category)){static volatile long epLevelLogSiteId=0; LOG_INSTANCE.AddLevelLog(epLevelLogSiteId,level,category,__TFILE__,__TFUNCTION__,__LINE__,inputString,__VA_ARGS__);}}while(0)
+
+/*!
+@def LOG_TRACE
+@brief Simple Macro to log simple line with msg in the trace level.
+
+Macro that is as same as LOG_LEVEL_MSG in the trace level, and compiles to nothing if EP_LOG_COMPILE_LEVEL is higher.
+*/
+#if EP_LOG_COMPILE_LEVEL<=EP_LOG_LEVEL_TRACE
+#define LOG_TRACE(category,inputString,...) LOG_LEVEL_MSG(epl::LOG_LEVEL_TRACE,category,inputString,__VA_ARGS__)
+#else
+#define LOG_TRACE(category,inputString,...) ((void)0)
+#endif
+
+/*!
+@def LOG_DEBUG
+@brief Simple Macro to log simple line with msg in the debug level.
+
+Macro that is as same as LOG_LEVEL_MSG in the debug level, and compiles to nothing if EP_LOG_COMPILE_LEVEL is higher.
+*/
+#if EP_LOG_COMPILE_LEVEL<=EP_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(category,inputString,...) LOG_LEVEL_MSG(epl::LOG_LEVEL_DEBUG,category,inputString,__VA_ARGS__)
+#else
+#define LOG_DEBUG(category,inputString,...) ((void)0)
+#endif
+
+/*!
+@def LOG_INFO
+@brief Simple Macro to log simple line with msg in the info level.
+
+Macro that is as same as LOG_LEVEL_MSG in the info level, and compiles to nothing if EP_LOG_COMPILE_LEVEL is higher.
+*/
+#if EP_LOG_COMPILE_LEVEL<=EP_LOG_LEVEL_INFO
+#define LOG_INFO(category,inputString,...) LOG_LEVEL_MSG(epl::LOG_LEVEL_INFO,category,inputString,__VA_ARGS__)
+#else
+#define LOG_INFO(category,inputString,...) ((void)0)
+#endif
+
+/*!
+@def LOG_WARN
+@brief Simple Macro to log simple line with msg in the warning level.
+
+Macro that is as same as LOG_LEVEL_MSG in the warning level, and compiles to nothing if EP_LOG_COMPILE_LEVEL is higher.
+*/
+#if EP_LOG_COMPILE_LEVEL<=EP_LOG_LEVEL_WARN
+#define LOG_WARN(category,inputString,...) LOG_LEVEL_MSG(epl::LOG_LEVEL_WARN,category,inputString,__VA_ARGS__)
+#else
+#define LOG_WARN(category,inputString,...) ((void)0)
+#endif
+
+/*!
+@def LOG_ERROR
+@brief Simple Macro to log simple line with msg in the error level.
+
+Macro that is as same as LOG_LEVEL_MSG in the error level, and compiles to nothing if EP_LOG_COMPILE_LEVEL is higher.
+*/
+#if EP_LOG_COMPILE_LEVEL<=EP_LOG_LEVEL_ERROR
+#define LOG_ERROR(category,inputString,...) LOG_LEVEL_MSG(epl::LOG_LEVEL_ERROR,category,inputString,__VA_ARGS__)
+#else
+#define LOG_ERROR(category,inputString,...) ((void)0)
+#endif
+
+/*!
+@def LOG_FATAL
+@brief Simple Macro to log simple line with msg in the fatal level.
+
+Macro that is as same as LOG_LEVEL_MSG in the fatal level, and compiles to nothing if EP_LOG_COMPILE_LEVEL is higher.
+*/
+#if EP_LOG_COMPILE_LEVEL<=EP_LOG_LEVEL_FATAL
+#define LOG_FATAL(category,inputString,...) LOG_LEVEL_MSG(epl::LOG_LEVEL_FATAL,category,inputString,__VA_ARGS__)
+#else
+#define LOG_FATAL(category,inputString,...) ((void)0)
+#endif
+
+/// the maximum number of the sites LOG_ASYNC_MSG can log
+#define ASYNC_LOG_MAX_SITE_COUNT 1024
+
+/// the number of the logs each thread can hold until the background thread writes them (must be the power of two)
+#define ASYNC_LOG_QUEUE_CAPACITY 1024
+
+/// the maximum number of the arguments of the asynchronous log
+#define ASYNC_LOG_MAX_ARG_COUNT 8
+
+/// the number of the characters for the string arguments of the asynchronous log
+#define ASYNC_LOG_STRING_LENGTH 256
+
+/// the default interval in milliseconds the background thread writes the asynchronous logs
+#define ASYNC_LOG_DEFAULT_FLUSH_INTERVAL 100
+
+/// the magic number at the start of the binary log file ("EPLB")
+#define BINARY_LOG_MAGIC 0x424c5045
+
+/// the version of the binary log format
+#define BINARY_LOG_VERSION 1
+
 namespace epl
 {
+	class AsyncLogWriter;
+	class FileStream;
+	class Stream;
+
+	/// Enumeration for the Log Level
+	enum LogLevel{
+		/// the trace level
+		LOG_LEVEL_TRACE=EP_LOG_LEVEL_TRACE,
+		/// the debug level
+		LOG_LEVEL_DEBUG=EP_LOG_LEVEL_DEBUG,
+		/// the info level
+		LOG_LEVEL_INFO=EP_LOG_LEVEL_INFO,
+		/// the warning level
+		LOG_LEVEL_WARN=EP_LOG_LEVEL_WARN,
+		/// the error level
+		LOG_LEVEL_ERROR=EP_LOG_LEVEL_ERROR,
+		/// the fatal level
+		LOG_LEVEL_FATAL=EP_LOG_LEVEL_FATAL,
+		/// the level above all levels
+		LOG_LEVEL_OFF=EP_LOG_LEVEL_OFF,
+	};
 
 	/*! 
 	@class SimpleLogManager epSimpleLogger.h
 	@brief A class that manages the logs.
+
+	The asynchronous logs are kept in the lock-free ring of each thread,
+	and the background thread writes them to the file in the order of their time.
+	When the ring of a thread is full, the log is dropped and counted, so the calling thread never waits.
 	*/
 	class EP_LIBRARY SimpleLogManager:public BaseOutputter
 	{
 	public:
 		friend class SingletonHolder<SimpleLogManager>;
+		friend class AsyncLogWriter;
 
 		/*!
 		Add the new simple log to the simple log list.
@@ -96,8 +286,117 @@ namespace epl
 		*/
 		void AddSimpleLog(const TCHAR *fileName, const TCHAR *funcName,const int lineNum,const TCHAR *format,...);
 
+		/*!
+		Add the new asynchronous log to the ring of the calling thread.
+		@param[in] siteId the static ID of the site, which is 0 until the site is registered.
+		@param[in] fileName the File Name for the log.
+		@param[in] funcName The Function Name for the log.
+		@param[in] lineNum The Line Number for the log.
+		@param[in] format The user inputted message
+		@remark the format of the site must be the same for every call.
+		        Only %d, %i, %u, %o, %x, %X, %c, %e, %f, %g, %a, %p and %s with the optional flags, width, precision and size are recorded as the arguments,
+		        and the site with the other format is formatted on the calling thread.
+		*/
+		void AddAsyncLog(volatile long &siteId, const TCHAR *fileName, const TCHAR *funcName,const int lineNum,const TCHAR *format,...);
+
+		/*!
+		Add the new asynchronous log with the level and the category to the ring of the calling thread.
+		@param[in] siteId the static ID of the site, which is 0 until the site is registered.
+		@param[in] level the level of the log.
+		@param[in] category the category of the log.
+		@param[in] fileName the File Name for the log.
+		@param[in] funcName The Function Name for the log.
+		@param[in] lineNum The Line Number for the log.
+		@param[in] format The user inputted message
+		@remark this does not check the level, which LOG_LEVEL_MSG checks before evaluating the arguments.
+		*/
+		void AddLevelLog(volatile long &siteId, LogLevel level, unsigned int category, const TCHAR *fileName, const TCHAR *funcName,const int lineNum,const TCHAR *format,...);
+
+		/*!
+		Check if the given level is enabled for the given category.
+		@param[in] level the level to check.
+		@param[in] category the category to check, less than LOG_MAX_CATEGORY_COUNT.
+		@return true if the level is enabled, otherwise false.
+		*/
+		static bool IsLogEnabled(LogLevel level, unsigned int category)
+		{
+			return static_cast<long>(level)>=m_categoryLevels[category&(LOG_MAX_CATEGORY_COUNT-1)];
+		}
+
+		/*!
+		Set the lowest level enabled for all categories.
+		@param[in] level the lowest level enabled. (LOG_LEVEL_OFF to disable all)
+		*/
+		static void SetLogLevel(LogLevel level);
+
+		/*!
+		Set the lowest level enabled for the given category.
+		@param[in] category the category, less than LOG_MAX_CATEGORY_COUNT.
+		@param[in] level the lowest level enabled. (LOG_LEVEL_OFF to disable the category)
+		*/
+		static void SetCategoryLogLevel(unsigned int category, LogLevel level);
+
+		/*!
+		Return the lowest level enabled for the given category.
+		@param[in] category the category, less than LOG_MAX_CATEGORY_COUNT.
+		@return the lowest level enabled.
+		*/
+		static LogLevel GetCategoryLogLevel(unsigned int category);
+
+		/*!
+		Set the name of the category written with the logs.
+		@param[in] category the category, less than LOG_MAX_CATEGORY_COUNT.
+		@param[in] name the name of the category.
+		@remark the category without the name is written as its number.
+		*/
+		void SetCategoryName(unsigned int category, const TCHAR *name);
+
+		/*!
+		Set the interval the background thread writes the asynchronous logs.
+		@param[in] flushInterval the interval in milliseconds.
+		*/
+		void SetAsyncFlushInterval(unsigned int flushInterval);
+
+		/*!
+		Return the interval the background thread writes the asynchronous logs.
+		@return the interval in milliseconds.
+		*/
+		unsigned int GetAsyncFlushInterval() const;
+
+		/*!
+		Set the file to write the asynchronous logs in the binary format, instead of the text.
+		@param[in] fileName the name of the binary log file, or NULL to write the text again.
+		@return true if the file is opened, otherwise false.
+		@remark the binary log holds the site ID, the time and the raw arguments of each log,
+		        with the file, function, line and format of each site written once, and DecodeBinaryLog renders it to the text later.
+		@remark the file is truncated, and the logs recorded so far are written to the previous file.
+		*/
+		bool SetBinaryFileName(const TCHAR *fileName);
+
+		/*!
+		Return the name of the binary log file.
+		@return the name of the binary log file, or the empty string if the text is written.
+		*/
+		EpTString GetBinaryFileName() const;
+
+		/*!
+		Render the binary log file into the text file, as same as the text written by the asynchronous logs.
+		@param[in] binaryFileName the name of the binary log file.
+		@param[in] textFileName the name of the text file to write.
+		@return true if the whole binary log is rendered, otherwise false.
+		@remark the logs before the truncated or corrupted part are still written to the text file.
+		*/
+		static bool DecodeBinaryLog(const TCHAR *binaryFileName, const TCHAR *textFileName);
+
+		/*!
+		Return the number of the asynchronous logs dropped since the rings were full.
+		@return the number of the logs dropped.
+		*/
+		__int64 GetAsyncDroppedCount() const;
+
 		/*!
 		Write the all data to the file.
+		@remark the asynchronous logs recorded so far are also written.
 		*/
 		virtual void FlushToFile();
 		/*!
@@ -161,10 +460,8 @@ namespace epl
 			EpTString m_funcName;
 			/// The line number where the log is called.
 			int m_lineNum;
-			/// The date when the log is called.
-			TCHAR m_dateStr[9];
-			/// The time when the log is called.
-			TCHAR m_timeStr[9];
+			/// The date and the time when the log is called.
+			TCHAR m_timeStr[TIMESTAMP_MAX_LENGTH];
 			/// The user string
 			EpTString m_userStr;
 
@@ -190,6 +487,249 @@ namespace epl
 		*/
 		virtual ~SimpleLogManager();
 
+		/// Enumeration for the type of the asynchronous log argument
+		enum AsyncLogArgType{
+			/// int, or the smaller integer promoted to int
+			ASYNC_LOG_ARG_TYPE_INT=0,
+			/// __int64
+			ASYNC_LOG_ARG_TYPE_INT64,
+			/// double
+			ASYNC_LOG_ARG_TYPE_DOUBLE,
+			/// pointer
+			ASYNC_LOG_ARG_TYPE_POINTER,
+			/// the TCHAR string copied to the record
+			ASYNC_LOG_ARG_TYPE_STRING,
+		};
+
+		/*! 
+		@struct AsyncLogSegment epSimpleLogger.h
+		@brief The literal text of the format and the conversion following it.
+		*/
+		struct AsyncLogSegment
+		{
+			/// the literal text before the conversion
+			EpTString m_literal;
+			/// the conversion specification such as "%5.2f", or empty for the last literal
+			EpTString m_spec;
+			/// the type of the argument of the conversion
+			AsyncLogArgType m_argType;
+		};
+
+		/*! 
+		@struct AsyncLogSite epSimpleLogger.h
+		@brief The registered site of the asynchronous log.
+		*/
+		struct AsyncLogSite
+		{
+			/// The name of file where the log is called.
+			EpTString m_fileName;
+			/// The name of function where the log is called.
+			EpTString m_funcName;
+			/// The line number where the log is called.
+			int m_lineNum;
+			/// the level of the log, or LOG_LEVEL_OFF if logged without the level
+			LogLevel m_level;
+			/// the category of the log
+			unsigned int m_category;
+			/// the segments of the format, the last of which has no conversion
+			std::vector<AsyncLogSegment> m_segments;
+			/// the number of the arguments
+			unsigned int m_argCount;
+			/// the flag whether the message is formatted on the calling thread
+			bool m_isPreformatted;
+			/// the format of the site
+			EpTString m_format;
+			/// the flag whether the site is written to the binary log file
+			bool m_isBinaryWritten;
+		};
+
+		/// Enumeration for the chunk of the binary log
+		enum BinaryLogChunkType{
+			/// the site, written before its first record
+			BINARY_LOG_CHUNK_TYPE_SITE=1,
+			/// the record of one log
+			BINARY_LOG_CHUNK_TYPE_RECORD,
+			/// the number of the logs dropped on one thread
+			BINARY_LOG_CHUNK_TYPE_DROPPED,
+		};
+
+		/*! 
+		@union AsyncLogArg epSimpleLogger.h
+		@brief The raw value of one argument of the asynchronous log.
+		*/
+		union AsyncLogArg
+		{
+			/// the integer, the pointer or the offset of the string
+			__int64 m_intValue;
+			/// the floating point
+			double m_doubleValue;
+		};
+
+		/*! 
+		@struct AsyncLogRecord epSimpleLogger.h
+		@brief One asynchronous log in the ring.
+		*/
+		struct AsyncLogRecord
+		{
+			/// the ID of the site
+			long m_siteId;
+			/// the tick of Clock when the log is called
+			__int64 m_tick;
+			/// the arguments
+			AsyncLogArg m_args[ASYNC_LOG_MAX_ARG_COUNT];
+			/// the string arguments, or the message formatted if the site is preformatted
+			TCHAR m_strings[ASYNC_LOG_STRING_LENGTH];
+		};
+
+		/*! 
+		@struct AsyncLogThreadSlot epSimpleLogger.h
+		@brief The ring of the asynchronous logs of one thread.
+
+		Only the owner thread writes the records, and only the background thread reads them.
+		*/
+		struct AsyncLogThreadSlot
+		{
+			/// the records indexed by the count masked with ASYNC_LOG_QUEUE_CAPACITY-1
+			AsyncLogRecord m_records[ASYNC_LOG_QUEUE_CAPACITY];
+			/// the ID of the owner thread
+			unsigned long m_threadId;
+			/// the number of the records written by the owner thread
+			volatile long m_writeCount;
+			/// the number of the records written to the file
+			volatile long m_readCount;
+			/// the number of the logs dropped
+			volatile long m_droppedCount;
+			/// the number of the logs dropped, which are reported to the file
+			long m_reportedDroppedCount;
+		};
+
+		/*! 
+		@struct AsyncLogEntry epSimpleLogger.h
+		@brief The record to write, sorted by its time.
+		*/
+		struct AsyncLogEntry
+		{
+			/// the tick of Clock when the log is called
+			__int64 m_tick;
+			/// the record
+			const AsyncLogRecord *m_record;
+
+			/*!
+			Compare the time of the entries.
+			@param[in] b the second entry.
+			@return true if this entry is earlier than the second entry.
+			*/
+			bool operator<(const AsyncLogEntry &b) const
+			{
+				return m_tick<b.m_tick;
+			}
+		};
+
+		/*!
+		Initialize the asynchronous log.
+		*/
+		void initAsyncLog();
+
+		/*!
+		Register the site of the asynchronous log, or find the site already registered.
+		@param[in] fileName the File Name for the log.
+		@param[in] funcName The Function Name for the log.
+		@param[in] lineNum The Line Number for the log.
+		@param[in] format The format of the site.
+		@param[in] level the level of the site, or LOG_LEVEL_OFF if logged without the level.
+		@param[in] category the category of the site.
+		@return the ID of the site, or -1 if ASYNC_LOG_MAX_SITE_COUNT sites are already registered.
+		*/
+		long registerAsyncSite(const TCHAR *fileName, const TCHAR *funcName, const int lineNum, const TCHAR *format, LogLevel level, unsigned int category);
+
+		/*!
+		Record the asynchronous log of the registered site to the ring of the calling thread.
+		@param[in] siteId the ID of the site.
+		@param[in] format The format of the site.
+		@param[in] args the arguments of the format.
+		*/
+		void recordAsyncLog(long siteId, const TCHAR *format, va_list args);
+
+		/*!
+		Split the format into the segments with the type of each argument.
+		@param[in] format the format to parse.
+		@param[in,out] site the site to set the segments.
+		*/
+		static void parseAsyncFormat(const TCHAR *format, AsyncLogSite &site);
+
+		/*!
+		Return the ring of the calling thread, creating the ring and the background thread if none.
+		@return the ring of the calling thread.
+		*/
+		AsyncLogThreadSlot *getAsyncSlot();
+
+		/*!
+		Write the asynchronous logs of all threads recorded so far to the file, in the order of their time.
+		*/
+		void writeAsyncLogs();
+
+		/*!
+		Format the asynchronous log into given string, as same as the synchronous log.
+		@param[in] site the site of the record.
+		@param[in] record the record to format.
+		@param[in] categoryName the name of the category of the site, or the empty string to write its number.
+		@param[in] originTick the tick of Clock at the origin time.
+		@param[in] originTime the origin time in the FILETIME unit.
+		@param[in] tickFrequency the frequency of Clock.
+		@param[in] formatter the formatter of the timestamps, which keeps the prefix of the previous record.
+		@param[out] retString the formatted line.
+		*/
+		static void formatAsyncRecord(const AsyncLogSite &site, const AsyncLogRecord &record, const EpTString &categoryName, __int64 originTick, __int64 originTime, __int64 tickFrequency, TimestampFormatter &formatter, EpTString &retString);
+
+		/*!
+		Write the record to the binary log file, with its site if not written yet.
+		@param[in] record the record to write.
+		*/
+		void writeBinaryRecord(const AsyncLogRecord &record);
+
+		/*!
+		Read the string written to the binary log file into the strings of the record.
+		@param[in] stream the binary log file.
+		@param[in,out] record the record to hold the string.
+		@param[in,out] stringOffset the offset of the string in the strings of the record, moved past the string.
+		@return true if successful, otherwise false.
+		*/
+		static bool readBinaryString(Stream &stream, AsyncLogRecord &record, size_t &stringOffset);
+
+		/*!
+		Close the binary log file without taking the lock.
+		*/
+		void closeBinaryLog();
+
+		/// the TLS index of the ring
+		unsigned long m_asyncTlsIndex;
+		/// the rings, kept until this manager is destroyed so the logs of the exited threads are still written
+		std::vector<AsyncLogThreadSlot*> m_asyncSlotList;
+		/// the registered sites, published before their IDs
+		AsyncLogSite *m_asyncSites[ASYNC_LOG_MAX_SITE_COUNT];
+		/// the number of the registered sites
+		long m_asyncSiteCount;
+		/// the background thread, or NULL until the first asynchronous log
+		AsyncLogWriter *m_asyncWriter;
+		/// the interval the background thread writes the logs in milliseconds
+		volatile unsigned int m_asyncFlushInterval;
+		/// the tick of Clock when initialized
+		__int64 m_asyncOriginTick;
+		/// the system time when initialized in the FILETIME unit
+		__int64 m_asyncOriginTime;
+		/// the frequency of Clock
+		__int64 m_asyncTickFrequency;
+		/// the formatter of the timestamps of the synchronous logs, used under the node list lock
+		TimestampFormatter m_timestampFormatter;
+		/// the names of the categories
+		EpTString m_categoryNames[LOG_MAX_CATEGORY_COUNT];
+		/// the name of the binary log file
+		EpTString m_binaryFileName;
+		/// the binary log file, or NULL if the text is written
+		FileStream *m_binaryStream;
+
+		/// the lowest level enabled for each category
+		static volatile long m_categoryLevels[LOG_MAX_CATEGORY_COUNT];
 	};
 
 }
@@ -39,17 +39,27 @@ An Interface for the Template Singleton Holder.
 #define __EP_SINGLETON_HOLDER_H__
 
 #include "epLib.h"
+#include "epAssert.h"
+#include <new>
 
 namespace epl
 {
+	/// Enumerator for Singleton Lifetime Policy
+	typedef enum _singletonLifetime{
+		/// The singleton is destroyed at exit, in the reverse order of creation.
+		SINGLETON_LIFETIME_DESTROY_AT_EXIT=0,
+		/// The singleton is never destroyed, so it can be used while other static objects are destroyed.
+		SINGLETON_LIFETIME_NEVER_DESTROY,
+	}SingletonLifetime;
 
 	/*! 
 	@class SingletonHolder epSingletonHolder.h
 	@brief This is a template holding class for Singleton classes  
 
 	Interface for the Singlton Holder class.
+	The instance is created once on the first call, and after that Instance() is a single load of the cached pointer.
 	*/
-	template<typename SingletonClass>
+	template<typename SingletonClass, SingletonLifetime lifetime=SINGLETON_LIFETIME_DESTROY_AT_EXIT>
 	class SingletonHolder
 	{
 	public:
@@ -58,9 +68,58 @@ namespace epl
 		Get the Singleton Instance of the Object
 		@return the reference to the Singleton Object.
 		*/
-		static SingletonClass &Instance();
+		static SingletonClass &Instance()
+		{
+			SingletonClass *instance=m_instance;
+			// the pointer is published after the construction, so no reordering is allowed past this load
+			_ReadWriteBarrier();
+			if(instance)
+				return *instance;
+			return *createInstance();
+		}
 	private:
+		/// Enumerator for Initialization State
+		enum InitState{
+			/// The instance is not created yet.
+			INIT_STATE_NONE=0,
+			/// The instance is being created.
+			INIT_STATE_CREATING,
+			/// The instance is created.
+			INIT_STATE_CREATED,
+			/// The instance is destroyed at exit.
+			INIT_STATE_DESTROYED,
+		};
 
+		/*!
+		@class DestroySentinel epSingletonHolder.h
+		@brief A class that marks the instance destroyed at exit.
+		*/
+		class DestroySentinel
+		{
+		public:
+			/*!
+			Default Destructor
+
+			Marks the instance destroyed, right before the instance itself is destroyed.
+			*/
+			~DestroySentinel()
+			{
+				m_instance=NULL;
+				InterlockedExchange(&m_initState,INIT_STATE_DESTROYED);
+			}
+		};
+
+		/*!
+		Create the instance exactly once, and wait for the thread creating it.
+		@return the pointer to the Singleton Object.
+		*/
+		static SingletonClass *createInstance();
+
+		/*!
+		Construct the instance according to the lifetime policy.
+		@return the pointer to the Singleton Object.
+		*/
+		static SingletonClass *constructInstance();
 
 		/*!
 		Default Constructor
@@ -89,22 +148,59 @@ namespace epl
 		@remark The copy operator is in private to protect the singleton property.
 		*/
 		SingletonHolder& operator=(const SingletonHolder& b);
+
+		/// the pointer to the instance created
+		static SingletonClass * volatile m_instance;
+		/// the initialization state
+		static volatile long m_initState;
 	};
 
-	template<typename SingletonClass>
-	SingletonClass &SingletonHolder<SingletonClass>::Instance()
+	template<typename SingletonClass, SingletonLifetime lifetime>
+	SingletonClass * volatile SingletonHolder<SingletonClass,lifetime>::m_instance=NULL;
+
+	template<typename SingletonClass, SingletonLifetime lifetime>
+	volatile long SingletonHolder<SingletonClass,lifetime>::m_initState=SingletonHolder<SingletonClass,lifetime>::INIT_STATE_NONE;
+
+	template<typename SingletonClass, SingletonLifetime lifetime>
+	SingletonClass *SingletonHolder<SingletonClass,lifetime>::createInstance()
 	{
-#if (EP_LOCK_POLICY==LOCK_POLICY_CRITICALSECTION)
-		static CriticalSectionEx m_lock;
-#elif (EP_LOCK_POLICY==LOCK_POLICY_MUTEX)
-		static Mutex m_lock;
-#elif (EP_LOCK_POLICY==LOCK_POLICY_NONE)
-		static NoLock m_lock;
-#endif //(EP_LOCK_POLICY==LOCK_POLICY_CRITICALSECTION)
-		LockObj lock(&m_lock);
-		static SingletonClass holder;
-		return holder;
+		long prevState=InterlockedCompareExchange(&m_initState,INIT_STATE_CREATING,INIT_STATE_NONE);
+		if(prevState==INIT_STATE_NONE)
+		{
+			SingletonClass *instance=constructInstance();
+			InterlockedExchangePointer(reinterpret_cast<PVOID volatile*>(&m_instance),instance);
+			InterlockedExchange(&m_initState,INIT_STATE_CREATED);
+			return instance;
+		}
+		EP_ASSERT_EXPR(prevState!=INIT_STATE_DESTROYED,_T("The singleton is used after destroyed at exit."));
+		while(m_initState==INIT_STATE_CREATING)
+		{
+			// the creating thread is running the constructor, which may take long
+			Sleep(0);
+		}
+		return static_cast<SingletonClass*>(InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(&m_instance),NULL,NULL));
+	}
 
+	template<typename SingletonClass, SingletonLifetime lifetime>
+	SingletonClass *SingletonHolder<SingletonClass,lifetime>::constructInstance()
+	{
+		if(lifetime==SINGLETON_LIFETIME_NEVER_DESTROY)
+		{
+			// static storage instead of the heap, so the instance is not reported as the leak
+			static union
+			{
+				char m_buffer[sizeof(SingletonClass)];
+				double m_alignDouble;
+				__int64 m_alignInt64;
+				void *m_alignPointer;
+			} storage;
+			return ::new(storage.m_buffer) SingletonClass();
+		}
+		// only the creating thread reaches here, so the local static is initialized once,
+		// and the sentinel constructed after the holder is destroyed right before it.
+		static SingletonClass holder;
+		static DestroySentinel sentinel;
+		return &holder;
 	}
 }
-#endif //__EP_SINGLETON_HOLDER_H__
+#endif //__EP_SINGLETON_HOLDER_H__
\ No newline at end of file
@@ -43,6 +43,8 @@ An Interface for the Smart Object.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 #include "epException.h"
 
 namespace epl
@@ -61,6 +63,7 @@ namespace epl
 		Assignment operator overloading
 		@param[in] b the second object
 		@return the new copied object
+		@remark the reference count is not copied.
 		*/
 		SmartObject & operator=(const SmartObject&b);
 
@@ -70,7 +73,6 @@ namespace epl
 		*/
 		int GetReferenceCount()
 		{
-			LockObj lock(m_refCounterLock);
 			return m_refCount;
 		}
 
@@ -91,6 +93,7 @@ namespace epl
 		/*!
 		Default Contructor
 		@param[in] lockPolicyType The lock policy
+		@remark the reference count is always counted by the interlocked operations, so the lock policy is ignored.
 		*/
 		SmartObject(LockPolicy lockPolicyType=EP_LOCK_POLICY);
 		 
@@ -111,9 +114,8 @@ namespace epl
 		*/
 		void RetainObj(TCHAR *fileName, TCHAR *funcName, unsigned int lineNum)
 		{
-			LockObj lock(m_refCounterLock);
-			m_refCount++;
-			LOG_THIS_MSG(_T("%s::%s(%d) Retained Object : %d (Current Reference Count = %d)"),fileName,funcName,lineNum,this, this->m_refCount);
+			long refCount=InterlockedIncrement(&m_refCount);
+			LOG_THIS_MSG(_T("%s::%s(%d) Retained Object : %d (Current Reference Count = %d)"),fileName,funcName,lineNum,this, refCount);
 		}
 
 		/*!
@@ -122,46 +124,30 @@ namespace epl
 		*/
 		void ReleaseObj(TCHAR *fileName, TCHAR *funcName, unsigned int lineNum)
 		{
-			m_refCounterLock->Lock();
-			m_refCount--;
-			LOG_THIS_MSG(_T("%s::%s(%d) Released Object : %d (Current Reference Count = %d)"),fileName,funcName,lineNum,this, this->m_refCount);
-			if(m_refCount==0)
+			// the full barrier of InterlockedDecrement orders all prior writes before the final release
+			long refCount=InterlockedDecrement(&m_refCount);
+			LOG_THIS_MSG(_T("%s::%s(%d) Released Object : %d (Current Reference Count = %d)"),fileName,funcName,lineNum,this, refCount);
+			if(refCount==0)
 			{
-				m_refCount++; // this increment is dummy addition to make pair with destructor.
-				m_refCounterLock->Unlock();
+				m_refCount=1; // this is dummy count to make pair with destructor.
+				if(recycleObj())
+					return;
 				EP_DELETE this;
 				return;
 			}
-			EP_ASSERT_EXPR(m_refCount>=0, _T("Reference Count is negative Value! Reference Count : %d"),m_refCount);
-			m_refCounterLock->Unlock();
-
+			EP_ASSERT_EXPR(refCount>=0, _T("Reference Count is negative Value! Reference Count : %d"),refCount);
 		}
 
 	protected:
 		/*!
 		Default Contructor
 		@param[in] lockPolicyType The lock policy
+		@remark the reference count is always counted by the interlocked operations, so the lock policy is ignored.
 		*/
 		SmartObject(TCHAR *fileName, TCHAR *funcName, unsigned int lineNum,LockPolicy lockPolicyType=EP_LOCK_POLICY)
 		{
 			m_refCount=1;
 			LOG_THIS_MSG(_T("%s::%s(%d) Allocated Object : %d (Current Reference Count = %d)"),fileName,funcName,lineNum,this, this->m_refCount);
-			m_lockPolicy=lockPolicyType;
-			switch(lockPolicyType)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_refCounterLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_refCounterLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_refCounterLock=EP_NEW NoLock();
-				break;
-			default:
-				m_refCounterLock=NULL;
-				break;
-			}
 		}
 
 		/*!
@@ -172,22 +158,6 @@ namespace epl
 		{
 			m_refCount=1;
 			LOG_THIS_MSG(_T("%s::%s(%d) Allocated Object : %d (Current Reference Count = %d)"),fileName,funcName,lineNum,this, this->m_refCount);
-			m_lockPolicy=b.m_lockPolicy;
-			switch(m_lockPolicy)
-			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_refCounterLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_refCounterLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_refCounterLock=EP_NEW NoLock();
-				break;
-			default:
-				m_refCounterLock=NULL;
-				break;
-			}
 		}
 
 		/*!
@@ -195,28 +165,31 @@ namespace epl
 		*/
 		virtual ~SmartObject()
 		{
-			m_refCounterLock->Lock();
 			m_refCount--;
-			m_refCounterLock->Unlock();
 			LOG_THIS_MSG(_T("Deleted Object : %d (Current Reference Count = %d)"),this, this->m_refCount);
 			EP_ASSERT_EXPR(m_refCount==0,_T("The Reference Count is not 0!! Reference Count : %d"),m_refCount);
-			if(m_refCounterLock)
-			{
-				EP_DELETE m_refCounterLock;
-			}
 		}
 	#endif //!defined(_DEBUG)
 
-
+		/*!
+		Called when the reference count reaches 0, before the object is deleted.
+		Subclass can overwrite this function to keep the object for reuse.
+		@return true if the object is kept for reuse and must not be deleted, otherwise false.
+		@remark the reference count is already back to 1 when this is called, as if newly created.
+		*/
+		virtual bool recycleObj()
+		{
+			return false;
+		}
 		
 	private:
 
+		/// the padding between the virtual table pointer and the reference counter
+		EP_CACHE_LINE_PADDING(m_headPadding)
 		/// Reference Counter
-		int m_refCount;
-		/// Lock
-		BaseLock *m_refCounterLock;
-		/// Lock Policy
-		LockPolicy m_lockPolicy;
+		volatile long m_refCount;
+		/// the padding between the reference counter and the members of the subclass
+		EP_CACHE_LINE_PADDING(m_tailPadding)
 	};
 #if defined(_DEBUG)
 #define SmartObject(...) SmartObject(__TFILE__,__TFUNCTION__,__LINE__,__VA_ARGS__)
@@ -0,0 +1,272 @@
+/*! 
+@file epSmartPtr.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Smart Pointer Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Intrusive Smart Pointer Template Class for SmartObject.
+
+*/
+#ifndef __EP_SMART_PTR_H__
+#define __EP_SMART_PTR_H__
+#include "epLib.h"
+#include "epSmartObject.h"
+
+namespace epl
+{
+	/*! 
+	@class SmartPtr epSmartPtr.h
+	@brief A template class that holds one reference of the SmartObject.
+
+	Copying the pointer retains the object once, and destroying it releases the object once.
+	Moving or swapping the pointer transfers the reference without touching the reference count,
+	so ThreadSafeQueue<SmartPtr<T> > with Push(move) and TryPop, or PushSwap and TryPopSwap, costs no reference count operation.
+	*/
+	template<typename T>
+	class SmartPtr
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the NULL pointer
+		*/
+		SmartPtr()
+		{
+			m_ptr=NULL;
+		}
+
+		/*!
+		Default Constructor
+
+		Initializes the pointer with given object, retaining it.
+		@param[in] ptr the object to hold.
+		*/
+		explicit SmartPtr(T *ptr)
+		{
+			m_ptr=ptr;
+			if(m_ptr)
+				m_ptr->RetainObj();
+		}
+
+		/*!
+		Default Copy Constructor
+
+		Retains the object held by given pointer.
+		@param[in] b the second object
+		*/
+		SmartPtr(const SmartPtr<T> &b)
+		{
+			m_ptr=b.m_ptr;
+			if(m_ptr)
+				m_ptr->RetainObj();
+		}
+
+#if _MSC_VER>=MSVC100
+		/*!
+		Default Move Constructor
+
+		Takes over the reference held by given pointer, leaving it NULL.
+		@param[in] b the second object
+		*/
+		SmartPtr(SmartPtr<T> &&b)
+		{
+			m_ptr=b.m_ptr;
+			b.m_ptr=NULL;
+		}
+
+		/*!
+		Move Assignment operator overloading
+
+		Takes over the reference held by given pointer, leaving it NULL.
+		@param[in] b the second object
+		@return the new moved object
+		*/
+		SmartPtr<T> &operator=(SmartPtr<T> &&b)
+		{
+			if(this!=&b)
+			{
+				T *oldPtr=m_ptr;
+				m_ptr=b.m_ptr;
+				b.m_ptr=NULL;
+				if(oldPtr)
+					oldPtr->ReleaseObj();
+			}
+			return *this;
+		}
+#endif //_MSC_VER>=MSVC100
+
+		/*!
+		Default Destructor
+
+		Releases the object held.
+		*/
+		~SmartPtr()
+		{
+			if(m_ptr)
+				m_ptr->ReleaseObj();
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		SmartPtr<T> &operator=(const SmartPtr<T> &b)
+		{
+			Reset(b.m_ptr);
+			return *this;
+		}
+
+		/*!
+		Hold given object, retaining it, and release the object held before.
+		@param[in] ptr the object to hold.
+		*/
+		void Reset(T *ptr=NULL)
+		{
+			if(ptr)
+				ptr->RetainObj();
+			T *oldPtr=m_ptr;
+			m_ptr=ptr;
+			if(oldPtr)
+				oldPtr->ReleaseObj();
+		}
+
+		/*!
+		Take over the reference already held by the caller, and release the object held before.
+		@param[in] ptr the object to hold without retaining.
+		@remark use for the object just created, whose reference count is already 1.
+		*/
+		void Attach(T *ptr)
+		{
+			T *oldPtr=m_ptr;
+			m_ptr=ptr;
+			if(oldPtr)
+				oldPtr->ReleaseObj();
+		}
+
+		/*!
+		Give up the reference held to the caller, leaving this pointer NULL.
+		@return the object held, which the caller must release.
+		*/
+		T *Detach()
+		{
+			T *retPtr=m_ptr;
+			m_ptr=NULL;
+			return retPtr;
+		}
+
+		/*!
+		Swap the objects held by this and given pointer.
+		@param[in] b the second object
+		*/
+		void Swap(SmartPtr<T> &b)
+		{
+			T *tmpPtr=m_ptr;
+			m_ptr=b.m_ptr;
+			b.m_ptr=tmpPtr;
+		}
+
+		/*!
+		Return the object held.
+		@return the object held, or NULL.
+		*/
+		T *Get() const
+		{
+			return m_ptr;
+		}
+
+		/*!
+		Return the flag whether the pointer is NULL.
+		@return true if the pointer is NULL, otherwise false.
+		*/
+		bool IsNull() const
+		{
+			return m_ptr==NULL;
+		}
+
+		/*!
+		Member access operator overloading
+		@return the object held.
+		*/
+		T *operator->() const
+		{
+			EP_ASSERT_EXPR(m_ptr,_T("SmartPtr is NULL!"));
+			return m_ptr;
+		}
+
+		/*!
+		Dereference operator overloading
+		@return the reference to the object held.
+		*/
+		T &operator*() const
+		{
+			EP_ASSERT_EXPR(m_ptr,_T("SmartPtr is NULL!"));
+			return *m_ptr;
+		}
+
+		/*!
+		Equal operator overloading
+		@param[in] b the second object
+		@return true if both hold the same object, otherwise false.
+		*/
+		bool operator==(const SmartPtr<T> &b) const
+		{
+			return m_ptr==b.m_ptr;
+		}
+
+		/*!
+		Not equal operator overloading
+		@param[in] b the second object
+		@return true if both hold the different objects, otherwise false.
+		*/
+		bool operator!=(const SmartPtr<T> &b) const
+		{
+			return m_ptr!=b.m_ptr;
+		}
+
+	private:
+		/// the object held
+		T *m_ptr;
+	};
+
+	/*!
+	Swap the objects held by given pointers without touching the reference count.
+	@param[in] a the first pointer
+	@param[in] b the second pointer
+	*/
+	template<typename T>
+	void swap(SmartPtr<T> &a, SmartPtr<T> &b)
+	{
+		a.Swap(b);
+	}
+}
+#endif //__EP_SMART_PTR_H__
\ No newline at end of file
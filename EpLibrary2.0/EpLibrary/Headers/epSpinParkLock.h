@@ -0,0 +1,172 @@
+/*! 
+@file epSpinParkLock.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief SpinParkLock Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Userspace Spin-then-park Lock Class.
+
+*/
+#ifndef __EP_SPIN_PARK_LOCK_H__
+#define __EP_SPIN_PARK_LOCK_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseLock.h"
+#include "epPlatformSync.h"
+
+/// the default number of spins before parking the thread
+#define SPIN_PARK_LOCK_DEFAULT_SPIN_COUNT 4000
+
+namespace epl
+{
+	/*! 
+	@class SpinParkLock epSpinParkLock.h
+	@brief A class that handles the userspace spin-then-park lock functionality.
+
+	The uncontended Lock and Unlock are a single interlocked operation each, without the kernel call.
+	The contended Lock spins for a while, and then parks the thread on the lock state by PlatformSync if supported
+	(WaitOnAddress on Windows 8 or later, futex on Linux), otherwise on the semaphore created at the first contention.
+	The lock is recursive as CriticalSectionEx, and cannot be used across the process boundaries.
+	*/
+	class EP_LIBRARY SpinParkLock :public BaseLock
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the lock
+		@param[in] spinCount the number of spins before parking the thread. (ignored on the single core system)
+		*/
+		SpinParkLock(unsigned int spinCount=SPIN_PARK_LOCK_DEFAULT_SPIN_COUNT);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the lock with the spin count of the given lock
+		@param[in] b the second object
+		*/
+		SpinParkLock(const SpinParkLock& b);
+
+		/*!
+		Default Destructor
+
+		Deletes the lock
+		*/
+		virtual ~SpinParkLock();
+
+		/*!	
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		SpinParkLock & operator=(const SpinParkLock&b);
+
+		/*!
+		Locks the Critical Section
+		@return true if locked, false otherwise
+		*/
+		virtual bool Lock();
+
+		/*!
+		Try to Lock the Critical Section
+
+		If other thread is already in the Critical Section, it just returns false and continue, otherwise obtain the Critical Section.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLock();
+
+		/*!
+		Locks the Critical Section
+
+		if other thread is already in the Critical Section,
+		and if it fails to lock in given time, it returns false, otherwise lock and return true.
+		@param[in] dwMilliSecond the wait time.
+		@return true if the lock is succeeded, otherwise false.
+		*/
+		virtual long TryLockFor(const unsigned int dwMilliSecond);
+
+		/*!
+		Leave the Critical Section
+
+		The Lock and Unlock has to be matched for each Critical Section.
+		*/
+		virtual void Unlock();
+
+		/*!
+		Set the number of spins before parking the thread.
+		@param[in] spinCount the number of spins before parking the thread.
+		*/
+		void SetSpinCount(unsigned int spinCount);
+
+		/*!
+		Return the number of spins before parking the thread.
+		@return the number of spins before parking the thread.
+		*/
+		unsigned int GetSpinCount() const;
+
+	private:
+		/*!
+		Obtain the lock, spinning and then parking within given time.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if the lock is obtained, otherwise false.
+		*/
+		bool acquire(unsigned int waitTimeInMilliSec);
+
+		/*!
+		Park the calling thread until the lock is released or timed out.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		*/
+		void park(unsigned int waitTimeInMilliSec);
+
+		/*!
+		Wake one parked thread.
+		*/
+		void unpark();
+
+		/*!
+		Return the park semaphore, creating it at the first call.
+		@return the park semaphore.
+		*/
+		PlatformSemaphore *getParkSemaphore();
+
+		/// the lock state (0: unlocked, 1: locked, 2: locked with the parked threads)
+		volatile long m_state;
+		/// the thread id of the owner
+		volatile DWORD m_ownerThreadId;
+		/// lock counter
+		int m_lockCounter;
+		/// the number of spins before parking
+		unsigned int m_spinCount;
+		/// the park semaphore used when waiting on the address is not available
+		PlatformSemaphore * volatile m_parkSem;
+	};
+}
+#endif //__EP_SPIN_PARK_LOCK_H__
\ No newline at end of file
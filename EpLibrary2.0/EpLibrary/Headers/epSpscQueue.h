@@ -0,0 +1,337 @@
+/*! 
+@file epSpscQueue.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Single-Producer Single-Consumer Queue Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Bounded Single-Producer Single-Consumer Queue.
+
+*/
+#ifndef __EP_SPSC_QUEUE_H__
+#define __EP_SPSC_QUEUE_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epException.h"
+#include "epLockFreeQueue.h"
+
+namespace epl
+{
+
+	/*! 
+	@class SpscQueue epSpscQueue.h
+	@brief A class for Bounded Single-Producer Single-Consumer Queue.
+
+	Only one thread may push and only one other thread may pop.
+	The producer writes only the tail and the consumer writes only the head, each in its own cache line,
+	so the fast path is the plain volatile read and write without any interlocked operation.
+	Each side also keeps the cached copy of the other side's index, and reads the shared one only when the cache says full or empty.
+	The capacity is rounded up to the power of two.
+	@remark the volatile read and write are relied on to have the acquire and release semantics, as MSVC gives them.
+	*/
+	template <typename DataType>
+	class SpscQueue
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the queue
+		@param[in] capacity the maximum number of items in the queue. (rounded up to the power of two)
+		*/
+		SpscQueue(unsigned int capacity=1024);
+
+		/*!
+		Default Destructor
+
+		Destroy the queue
+		*/
+		virtual ~SpscQueue();
+
+		/*!
+		Check if the queue is empty.
+		@returns Returns true if the queue is empty, otherwise false.
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		Return the size of the queue.
+		@return the size of the queue.
+		*/
+		size_t Size() const;
+
+		/*!
+		Return the capacity of the queue.
+		@return the maximum number of items in the queue.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Try to insert the new item into the queue.
+		@param[in] data The inserting data.
+		@return true if inserted, false if the queue is full.
+		@remark must be called only from the producer thread.
+		*/
+		bool TryPush(DataType const &data);
+
+		/*!
+		Try to remove the first item from the queue.
+		@param[out] retData The removed data.
+		@return true if removed, false if the queue is empty.
+		@remark must be called only from the consumer thread.
+		*/
+		bool TryPop(DataType &retData);
+
+		/*!
+		Insert the given items into the queue until it is full.
+		@param[in] data The array of inserting data.
+		@param[in] count The number of items in the array.
+		@return the number of items inserted.
+		@remark the tail is published once for the whole batch.
+		@remark must be called only from the producer thread.
+		*/
+		size_t PushBatch(DataType const *data, size_t count);
+
+		/*!
+		Remove up to given number of items from the front of the queue.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@return the number of items removed.
+		@remark the head is published once for the whole batch.
+		@remark must be called only from the consumer thread.
+		*/
+		size_t PopBatch(DataType *retData, size_t maxCount);
+
+		/*!
+		Return the contiguous free span in the ring to write in place.
+		@param[out] retSpan the pointer to the first free slot.
+		@return the number of contiguous free slots, which may be 0.
+		@remark call CommitWrite to publish the slots written.
+		@remark must be called only from the producer thread.
+		*/
+		size_t BeginWrite(DataType *&retSpan);
+
+		/*!
+		Publish the given number of slots written through BeginWrite.
+		@param[in] count the number of slots written, up to the count BeginWrite returned.
+		*/
+		void CommitWrite(size_t count);
+
+		/*!
+		Return the contiguous filled span in the ring to read in place.
+		@param[out] retSpan the pointer to the first filled slot.
+		@return the number of contiguous filled slots, which may be 0.
+		@remark call CommitRead to free the slots read.
+		@remark must be called only from the consumer thread.
+		*/
+		size_t BeginRead(DataType *&retSpan);
+
+		/*!
+		Free the given number of slots read through BeginRead.
+		@param[in] count the number of slots read, up to the count BeginRead returned.
+		*/
+		void CommitRead(size_t count);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		SpscQueue(const SpscQueue & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		SpscQueue &operator=(const SpscQueue & b){EP_ASSERT(0);return *this;}
+
+		/// the ring buffer
+		DataType *m_buffer;
+		/// the mask of the index (capacity-1)
+		unsigned long m_mask;
+		/// padding to keep the tail in its own cache line
+		char m_padding0[LOCK_FREE_QUEUE_CACHE_LINE_SIZE];
+		/// the index for the next push, written by the producer only
+		volatile unsigned long m_tail;
+		/// the producer's copy of the head
+		unsigned long m_cachedHead;
+		/// padding to keep the head in its own cache line
+		char m_padding1[LOCK_FREE_QUEUE_CACHE_LINE_SIZE-sizeof(unsigned long)*2];
+		/// the index for the next pop, written by the consumer only
+		volatile unsigned long m_head;
+		/// the consumer's copy of the tail
+		unsigned long m_cachedTail;
+		/// padding to keep the following members off the head
+		char m_padding2[LOCK_FREE_QUEUE_CACHE_LINE_SIZE-sizeof(unsigned long)*2];
+	};
+
+
+	template <typename DataType>
+	SpscQueue<DataType>::SpscQueue(unsigned int capacity)
+	{
+		unsigned long bufferSize=2;
+		while(bufferSize<capacity && bufferSize<0x40000000)
+			bufferSize<<=1;
+		m_mask=bufferSize-1;
+		m_buffer=EP_NEW DataType[bufferSize];
+		m_tail=0;
+		m_cachedHead=0;
+		m_head=0;
+		m_cachedTail=0;
+	}
+
+	template <typename DataType>
+	SpscQueue<DataType>::~SpscQueue()
+	{
+		EP_DELETE[] m_buffer;
+	}
+
+	template <typename DataType>
+	bool SpscQueue<DataType>::IsEmpty() const
+	{
+		return m_head==m_tail;
+	}
+
+	template <typename DataType>
+	size_t SpscQueue<DataType>::Size() const
+	{
+		unsigned long head=m_head;
+		unsigned long tail=m_tail;
+		return static_cast<size_t>(tail-head);
+	}
+
+	template <typename DataType>
+	size_t SpscQueue<DataType>::GetCapacity() const
+	{
+		return static_cast<size_t>(m_mask+1);
+	}
+
+	template <typename DataType>
+	bool SpscQueue<DataType>::TryPush(DataType const &data)
+	{
+		unsigned long tail=m_tail;
+		if(tail-m_cachedHead>m_mask)
+		{
+			m_cachedHead=m_head;
+			if(tail-m_cachedHead>m_mask)
+				return false;
+		}
+		m_buffer[tail&m_mask]=data;
+		m_tail=tail+1;
+		return true;
+	}
+
+	template <typename DataType>
+	bool SpscQueue<DataType>::TryPop(DataType &retData)
+	{
+		unsigned long head=m_head;
+		if(head==m_cachedTail)
+		{
+			m_cachedTail=m_tail;
+			if(head==m_cachedTail)
+				return false;
+		}
+		retData=m_buffer[head&m_mask];
+		m_head=head+1;
+		return true;
+	}
+
+	template <typename DataType>
+	size_t SpscQueue<DataType>::PushBatch(DataType const *data, size_t count)
+	{
+		unsigned long tail=m_tail;
+		m_cachedHead=m_head;
+		size_t freeCount=static_cast<size_t>(m_mask+1-(tail-m_cachedHead));
+		if(count>freeCount)
+			count=freeCount;
+		for(size_t dataTrav=0;dataTrav<count;dataTrav++)
+		{
+			m_buffer[(tail+static_cast<unsigned long>(dataTrav))&m_mask]=data[dataTrav];
+		}
+		m_tail=tail+static_cast<unsigned long>(count);
+		return count;
+	}
+
+	template <typename DataType>
+	size_t SpscQueue<DataType>::PopBatch(DataType *retData, size_t maxCount)
+	{
+		unsigned long head=m_head;
+		m_cachedTail=m_tail;
+		size_t filledCount=static_cast<size_t>(m_cachedTail-head);
+		if(maxCount>filledCount)
+			maxCount=filledCount;
+		for(size_t dataTrav=0;dataTrav<maxCount;dataTrav++)
+		{
+			retData[dataTrav]=m_buffer[(head+static_cast<unsigned long>(dataTrav))&m_mask];
+		}
+		m_head=head+static_cast<unsigned long>(maxCount);
+		return maxCount;
+	}
+
+	template <typename DataType>
+	size_t SpscQueue<DataType>::BeginWrite(DataType *&retSpan)
+	{
+		unsigned long tail=m_tail;
+		m_cachedHead=m_head;
+		unsigned long freeCount=m_mask+1-(tail-m_cachedHead);
+		unsigned long untilWrap=m_mask+1-(tail&m_mask);
+		retSpan=&m_buffer[tail&m_mask];
+		return static_cast<size_t>((freeCount<untilWrap)?freeCount:untilWrap);
+	}
+
+	template <typename DataType>
+	void SpscQueue<DataType>::CommitWrite(size_t count)
+	{
+		m_tail=m_tail+static_cast<unsigned long>(count);
+	}
+
+	template <typename DataType>
+	size_t SpscQueue<DataType>::BeginRead(DataType *&retSpan)
+	{
+		unsigned long head=m_head;
+		m_cachedTail=m_tail;
+		unsigned long filledCount=m_cachedTail-head;
+		unsigned long untilWrap=m_mask+1-(head&m_mask);
+		retSpan=&m_buffer[head&m_mask];
+		return static_cast<size_t>((filledCount<untilWrap)?filledCount:untilWrap);
+	}
+
+	template <typename DataType>
+	void SpscQueue<DataType>::CommitRead(size_t count)
+	{
+		m_head=m_head+static_cast<unsigned long>(count);
+	}
+}
+
+#endif //__EP_SPSC_QUEUE_H__
\ No newline at end of file
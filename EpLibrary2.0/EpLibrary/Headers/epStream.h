@@ -41,10 +41,209 @@ An Interface for Stream Class.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include "epVirtualBuffer.h"
+#include "epEndian.h"
+
+/// the byte size of the first allocation of the stream buffer
+#define STREAM_MIN_CAPACITY 64
+
+/// the byte size of the buffer to swap the values written in the other byte order
+#define STREAM_SWAP_BUFFER_SIZE 1024
 
 namespace epl
 {
 
+	/*! 
+	@class StreamBuffer epStream.h
+	@brief A class for the byte buffer of Stream.
+
+	The buffer is allocated from the heap by default,
+	and can be backed by the reserved virtual memory region so that the growth never copies the data.
+	The buffer can also borrow the external memory to read in place without copying.
+	*/
+	class EP_LIBRARY StreamBuffer
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty buffer on the heap
+		*/
+		StreamBuffer();
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the buffer with the same backing and data as given buffer
+		@param[in] b the second object
+		*/
+		StreamBuffer(const StreamBuffer& b);
+
+		/*!
+		Default Destructor
+
+		Destroy the buffer
+		*/
+		virtual ~StreamBuffer();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		StreamBuffer & operator=(const StreamBuffer&b);
+
+		/*!
+		Move the buffer to the reserved virtual memory region of given size.
+		@param[in] maxSize the maximum size of the buffer in bytes.
+		@param[in] flags the combination of VirtualBufferFlag.
+		@return true if successfully moved, otherwise false.
+		@remark the data already in the buffer is kept.
+		@remark on failure, the buffer stays as it was.
+		*/
+		bool ReserveVirtual(size_t maxSize, unsigned int flags=VIRTUAL_BUFFER_FLAG_NONE);
+
+		/*!
+		Return the flag whether the buffer is backed by the virtual memory region.
+		@return true if the buffer is backed by the virtual memory region, otherwise false.
+		*/
+		bool IsVirtual() const;
+
+		/*!
+		Borrow the given external memory as the buffer without copying.
+		@param[in] data the start of the external memory.
+		@param[in] size the byte size of the external memory.
+		@remark the memory is not freed by the buffer, and must outlive the buffer or the next Clear.
+		@remark the memory is never written, since the growth and the erase move the data to the own memory first.
+		*/
+		void Borrow(const unsigned char *data, size_t size);
+
+		/*!
+		Return the flag whether the buffer is borrowing the external memory.
+		@return true if the buffer is borrowing the external memory, otherwise false.
+		*/
+		bool IsBorrowed() const;
+
+		/*!
+		Give up the ownership of the heap memory of the buffer to the caller.
+		@param[out] retSize the byte size of the memory detached.
+		@return the memory detached, or NULL if the buffer is empty, virtual or borrowing.
+		@remark the buffer becomes empty, and the caller must free the memory with EP_FreeTag(data,MEMORY_TAG_STREAM).
+		*/
+		unsigned char *Detach(size_t &retSize);
+
+		/*!
+		Resize the buffer.
+		@param[in] size the new byte size of the buffer.
+		@return true if successfully resized, otherwise false.
+		@remark the bytes added are filled with 0.
+		@remark fails if the size is larger than the reserved size of the virtual memory region.
+		*/
+		bool Resize(size_t size);
+
+		/*!
+		Resize the buffer without filling the bytes added.
+		@param[in] size the new byte size of the buffer.
+		@return true if successfully resized, otherwise false.
+		@remark the bytes added are left uninitialized, so the caller must overwrite them.
+		@remark fails if the size is larger than the reserved size of the virtual memory region.
+		*/
+		bool ResizeUninitialized(size_t size);
+
+		/*!
+		Reserve the buffer to hold given byte size without growing.
+		@param[in] capacity the byte size to hold without growing.
+		@return true if successfully reserved, otherwise false.
+		@remark the size of the buffer is not changed.
+		@remark fails if the capacity is larger than the reserved size of the virtual memory region.
+		*/
+		bool Reserve(size_t capacity);
+
+		/*!
+		Return the byte size the buffer can hold without growing
+		@return the byte size the buffer can hold without growing.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Clear the buffer.
+		@remark the memory is kept for reuse.
+		*/
+		void Clear();
+
+		/*!
+		Erase the bytes of given range from the buffer.
+		@param[in] startIdx the index of the first byte to erase.
+		@param[in] count the number of bytes to erase.
+		*/
+		void Erase(size_t startIdx, size_t count);
+
+		/*!
+		Return the byte size of the buffer
+		@return the byte size of the buffer.
+		*/
+		size_t GetSize() const;
+
+		/*!
+		Check if the buffer is empty.
+		@return true if the buffer is empty, otherwise false.
+		*/
+		bool IsEmpty() const;
+
+		/*!
+		Return the pointer to the start of the buffer.
+		@return the pointer to the start of the buffer.
+		*/
+		unsigned char *GetData();
+
+		/*!
+		Return the pointer to the start of the buffer.
+		@return the pointer to the start of the buffer.
+		*/
+		const unsigned char *GetData() const;
+
+	private:
+		/*!
+		Copy the backing and data of given buffer.
+		@param[in] b the buffer to copy from.
+		*/
+		void copyFrom(const StreamBuffer &b);
+
+		/*!
+		Release the memory of the buffer.
+		*/
+		void release();
+
+		/*!
+		Grow the capacity to at least given byte size, doubling the capacity.
+		@param[in] size the byte size to hold.
+		@return true if successfully grown, otherwise false.
+		*/
+		bool grow(size_t size);
+
+		/*!
+		Reallocate the buffer to given capacity.
+		@param[in] capacity the new byte size to hold without growing.
+		@return true if successfully reallocated, otherwise false.
+		*/
+		bool reallocate(size_t capacity);
+
+		/// the start of the buffer
+		unsigned char *m_data;
+		/// the byte size of the buffer
+		size_t m_size;
+		/// the byte size accessible without growing
+		size_t m_capacity;
+		/// the virtual memory region, or NULL if on the heap
+		VirtualBuffer *m_virtualBuffer;
+		/// the flags of the virtual memory region
+		unsigned int m_virtualFlags;
+		/// the flag whether the buffer is borrowing the external memory
+		bool m_isBorrowed;
+	};
+
 	/*! 
 	@class Stream epStream.h
 	@brief A class for Stream.
@@ -64,11 +263,68 @@ namespace epl
 			STREAM_SEEK_TYPE_SEEK_END,
 		};
 
+		/*!
+		@class BatchLockObj epStream.h
+		@brief A class that holds the stream lock for a sequence of reads and writes.
+
+		While the object lives, the calls of the stream from the creating thread do not take the lock again, 
+		and the calls from other threads wait until the object is destroyed.
+		*/
+		class EP_LIBRARY BatchLockObj
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Locks the given stream for the calling thread
+			@param[in] stream the stream to lock.
+			@remark nested objects on the same thread hold the lock only once.
+			*/
+			BatchLockObj(Stream *stream);
+
+			/*!
+			Default Destructor
+
+			Unlocks the stream
+			*/
+			virtual ~BatchLockObj();
+
+		private:
+			/*!
+			Default Constructor
+
+			*Cannot be Used.
+			*/
+			BatchLockObj(){EP_ASSERT(0);}
+
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			BatchLockObj(const BatchLockObj & b){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			BatchLockObj & operator=(const BatchLockObj&b){EP_ASSERT(0);return *this;}
+
+			/// the batch-locked stream
+			Stream *m_stream;
+			/// the flag whether this object holds the lock
+			bool m_isOwner;
+		};
+
 		/*!
 		Default Constructor
 
 		Initializes the Stream
 		@param[in] lockPolicyType The lock policy
+		@remark LOCK_POLICY_NONE creates no lock, so the stream owned by single thread never pays for the locking.
 		*/
 		Stream(LockPolicy lockPolicyType=EP_LOCK_POLICY);
 		
@@ -110,6 +366,71 @@ namespace epl
 		*/
 		const unsigned char *GetBuffer() const;
 
+		/*!
+		Back the stream with the reserved virtual memory region of given size.
+		@param[in] maxSize the maximum byte size of the stream.
+		@param[in] flags the combination of VirtualBufferFlag.
+		@return true if successfully reserved, otherwise false.
+		@remark the writing beyond the maximum size fails instead of growing the stream.
+		@remark use this for the large streams, since the growth commits the pages in place instead of copying.
+		*/
+		bool ReserveVirtualBuffer(size_t maxSize, unsigned int flags=VIRTUAL_BUFFER_FLAG_NONE);
+
+		/*!
+		Reserve the stream to hold given byte size without growing.
+		@param[in] byteSize the byte size to hold without growing.
+		@return true if successfully reserved, otherwise false.
+		@remark reserve the expected size before serializing many small values, so the stream does not grow on the way.
+		*/
+		bool Reserve(size_t byteSize);
+
+		/*!
+		Return the byte size the stream can hold without growing
+		@return the byte size the stream can hold without growing.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Extend the stream over given number of bytes at the seek without writing them.
+		@param[in] byteSize the number of bytes to extend.
+		@return the pointer to the bytes extended, or NULL if failed.
+		@remark the seek is moved after the bytes extended, and the bytes beyond the previous end are left uninitialized.
+		@remark the pointer is valid only until the stream is modified, so fill the bytes before the next write.
+		*/
+		unsigned char *WriteUninitialized(size_t byteSize);
+
+		/*!
+		Read the given external buffer in place as the stream without copying.
+		@param[in] buffer the start of the external buffer.
+		@param[in] byteSize the byte size of the external buffer.
+		@return true if successfully attached, otherwise false.
+		@remark the stream becomes read-only with the seek at the start, and the writing fails until Clear.
+		@remark the buffer is not freed by the stream, and must outlive the stream, its copies or the next Clear.
+		*/
+		bool AttachBuffer(const unsigned char *buffer, size_t byteSize);
+
+		/*!
+		Return the flag whether the stream is reading the external buffer in place.
+		@return true if the stream is read-only, otherwise false.
+		*/
+		bool IsReadOnly() const;
+
+		/*!
+		Give up the ownership of the stream buffer to the caller without copying.
+		@param[out] retByteSize the byte size of the buffer detached.
+		@return the buffer detached, or NULL if the stream is empty, read-only or backed by the virtual memory region.
+		@remark the stream becomes empty, and the caller must free the buffer with EP_FreeTag(buffer,MEMORY_TAG_STREAM).
+		*/
+		unsigned char *DetachBuffer(size_t &retByteSize);
+
+		/*!
+		Read given number of bytes from the stream in place without copying.
+		@param[in] byteSize the number of bytes to read.
+		@return the pointer to the bytes read, or NULL if the stream does not hold the bytes after the seek.
+		@remark the seek is moved after the bytes read, and the pointer is valid only until the stream is modified.
+		*/
+		const unsigned char *ReadInPlace(size_t byteSize);
+
 		/*!
 		Set the seek offset. 
 		@param[in] seekType The type of Seek to set
@@ -123,6 +444,20 @@ namespace epl
 		*/
 		virtual size_t GetSeek() const;
 
+		/*!
+		Set the byte order of the numeric values in the stream.
+		@param[in] byteOrder the byte order of the values.
+		@remark the short, int, float and double values and their arrays are swapped while written and read, 
+		if the byte order differs from the system.
+		*/
+		void SetByteOrder(Endian::EndianType byteOrder);
+
+		/*!
+		Return the byte order of the numeric values in the stream.
+		@return the byte order of the values.
+		*/
+		Endian::EndianType GetByteOrder() const;
+
 		/*!
 		Write the short value to the stream.
 		@param[in] value the short value to write to the stream
@@ -270,6 +605,40 @@ namespace epl
 		*/
 		virtual bool WriteTString(const EpTString &str);
 
+		/*!
+		Write given string to the stream with the length prefix
+		@param[in] str the string to write.
+		@return true if successfully written otherwise false
+		@remark the number of the characters is written as unsigned int before the characters without the terminator,
+		so the string can contain the null character and is read back with ReadPrefixedString in one copy.
+		*/
+		virtual bool WritePrefixedString(const EpString &str);
+
+		/*!
+		Write given wide string to the stream with the length prefix
+		@param[in] str the string to write.
+		@return true if successfully written otherwise false
+		@remark the number of the characters is written as unsigned int before the characters without the terminator.
+		*/
+		virtual bool WritePrefixedWString(const EpWString &str);
+
+		/*!
+		Write given TString to the stream with the length prefix
+		@param[in] str the string to write.
+		@return true if successfully written otherwise false
+		@remark the number of the characters is written as unsigned int before the characters without the terminator.
+		*/
+		virtual bool WritePrefixedTString(const EpTString &str);
+
+		/*!
+		Write given TString to the stream as the UTF-8 with the length prefix
+		@param[in] str the string to write.
+		@return true if successfully written otherwise false
+		@remark the byte size of the UTF-8 is written as unsigned int before the bytes without the terminator,
+		so the string is read back with ReadPrefixedUtf8String regardless of the character set of the build.
+		*/
+		virtual bool WritePrefixedUtf8String(const EpTString &str);
+
 
 
 		/*!
@@ -397,6 +766,38 @@ namespace epl
 		@return true if successfully extracted otherwise false
 		*/
 		virtual bool ReadTString(EpTString &retString);
+
+		/*!
+		Get the string written by WritePrefixedString from the stream
+		@param[out] retString the string extracted.
+		@return true if successfully extracted otherwise false
+		@remark nothing is read if the stream does not hold the whole string.
+		*/
+		virtual bool ReadPrefixedString(EpString &retString);
+
+		/*!
+		Get the wide string written by WritePrefixedWString from the stream
+		@param[out] retString the string extracted.
+		@return true if successfully extracted otherwise false
+		@remark nothing is read if the stream does not hold the whole string.
+		*/
+		virtual bool ReadPrefixedWString(EpWString &retString);
+
+		/*!
+		Get the TString written by WritePrefixedTString from the stream
+		@param[out] retString the string extracted.
+		@return true if successfully extracted otherwise false
+		@remark nothing is read if the stream does not hold the whole string.
+		*/
+		virtual bool ReadPrefixedTString(EpTString &retString);
+
+		/*!
+		Get the TString written by WritePrefixedUtf8String from the stream
+		@param[out] retString the string extracted.
+		@return true if successfully extracted otherwise false
+		@remark nothing is read if the stream does not hold the whole string.
+		*/
+		virtual bool ReadPrefixedUtf8String(EpTString &retString);
 		
 		/*!
 		Write the current stream to the given file
@@ -406,6 +807,67 @@ namespace epl
 		bool WriteStreamToFile(const TCHAR *fileName);
 
 	protected:
+		/*!
+		@class StreamLockObj epStream.h
+		@brief A class that locks the stream within the scope.
+
+		Nothing is locked if the stream has no lock, or the calling thread holds the BatchLockObj of the stream.
+		*/
+		class EP_LIBRARY StreamLockObj
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Locks the given stream
+			@param[in] stream the stream to lock.
+			*/
+			StreamLockObj(const Stream *stream);
+
+			/*!
+			Default Destructor
+
+			Unlocks the stream
+			*/
+			virtual ~StreamLockObj();
+
+		private:
+			/*!
+			Default Constructor
+
+			*Cannot be Used.
+			*/
+			StreamLockObj(){EP_ASSERT(0);}
+
+			/*!
+			Default Copy Constructor
+
+			*Cannot be Used.
+			*/
+			StreamLockObj(const StreamLockObj & b){EP_ASSERT(0);}
+
+			/*!
+			Assignment operator overloading
+
+			*Cannot be Used.
+			@param[in] b the second object
+			@return the new copied object
+			*/
+			StreamLockObj & operator=(const StreamLockObj&b){EP_ASSERT(0);return *this;}
+
+			/// the lock taken
+			BaseLock *m_lock;
+		};
+
+		/*!
+		Make the stream hold given number of bytes at the seek.
+		@param[in] byteSize the number of bytes to hold after the seek.
+		@return true if successful, otherwise false.
+		@remark only the gap between the previous end and the seek is filled with 0, 
+		since the bytes after the seek are to be overwritten by the caller.
+		*/
+		bool extend(size_t byteSize);
+
 		/*!
 		Write the value to the stream.
 		@param[in] value the value/values to write to the stream
@@ -422,14 +884,61 @@ namespace epl
 		*/
 		virtual bool read(void *value,size_t byteSize);
 
+		/*!
+		Return the read seek offset.
+		@return the reference to the read seek offset.
+		@remark the stream keeping the separate read seek overrides this.
+		*/
+		virtual size_t &readOffset();
+
+		/*!
+		Find the terminator of the string at the read seek.
+		@param[in] charSize the byte size of the character.
+		@param[out] retCharCount the number of the characters before the terminator, 
+		or the number of the whole characters left if not terminated.
+		@return true if the terminator is found, otherwise false.
+		@remark the terminator is searched with memchr or wmemchr instead of reading the characters one by one.
+		*/
+		bool scanString(size_t charSize, size_t &retCharCount);
+
+		/*!
+		Check the length prefix of the string at the read seek without reading it.
+		@param[in] charSize the byte size of the character.
+		@param[out] retCharCount the number of the characters of the string.
+		@return true if the stream holds the prefix and whole string, otherwise false.
+		*/
+		bool scanPrefixedString(size_t charSize, size_t &retCharCount);
+
+		/*!
+		Write the numeric values to the stream in the byte order of the stream.
+		@param[in] value the values to write to the stream
+		@param[in] elementSize the byte size of the value
+		@param[in] count the number of the values
+		@return true if successful, otherwise false.
+		*/
+		bool writeOrdered(const void *value, size_t elementSize, size_t count);
+
+		/*!
+		Read the numeric values from the stream in the byte order of the stream.
+		@param[out] retValue the values read from the stream
+		@param[in] elementSize the byte size of the value
+		@param[in] count the number of the values
+		@return true if successful, otherwise false.
+		*/
+		bool readOrdered(void *retValue, size_t elementSize, size_t count);
+
 		/// The actual stream buffer
-		std::vector<unsigned char> m_stream;
+		StreamBuffer m_stream;
 		/// The offset for the seek
 		size_t m_offset;
 		/// The Stream Lock
 		BaseLock *m_streamLock;
+		/// The thread holding the BatchLockObj of the stream, 0 if none
+		volatile unsigned long m_batchOwnerId;
 		/// Lock Policy
 		LockPolicy m_lockPolicy;
+		/// the flag whether the byte order of the stream differs from the system
+		bool m_isSwapped;
 		
 	};
 }
@@ -0,0 +1,86 @@
+/*! 
+@file epStreamBenchmark.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Stream Benchmark Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+This is a class for measuring the throughput of the streams and the files.
+
+*/
+#ifndef __EP_STREAM_BENCHMARK_H__
+#define __EP_STREAM_BENCHMARK_H__
+#include "epLib.h"
+#include "epBenchmark.h"
+
+/// the default byte size of the largest file measured
+#define STREAM_BENCHMARK_MAX_FILE_SIZE (16*1024*1024)
+
+namespace epl
+{
+	/*! 
+	@class StreamBenchmark epStreamBenchmark.h
+	@brief A class for measuring the throughput of Stream, NetworkStream, FileStream and BinaryFile.
+
+	The results are added to BENCHMARK_INSTANCE, and reported by its Print or FlushToFile.
+	*/
+	class EP_LIBRARY StreamBenchmark
+	{
+	public:
+		/*!
+		Run all the stream and file benchmarks.
+		@param[in] workFileName the name of the file to write and read, which is deleted at the end.
+		@param[in] maxFileSize the byte size of the largest file to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void Run(const TCHAR *workFileName, size_t maxFileSize=STREAM_BENCHMARK_MAX_FILE_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks writing and reading each primitive and the strings, for each lock policy.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunStream(unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks passing the packets through the network stream, for each flush type.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunNetworkStream(unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks saving and loading the file in each way, for each file size up to given size.
+		@param[in] workFileName the name of the file to write and read, which is deleted at the end.
+		@param[in] maxFileSize the byte size of the largest file to measure.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunFile(const TCHAR *workFileName, size_t maxFileSize=STREAM_BENCHMARK_MAX_FILE_SIZE, unsigned int minTime=BENCHMARK_MIN_TIME);
+	};
+}
+#endif //__EP_STREAM_BENCHMARK_H__
\ No newline at end of file
@@ -0,0 +1,221 @@
+/*! 
+@file epStringView.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief String View Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the String View.
+
+*/
+#ifndef __EP_STRING_VIEW_H__
+#define __EP_STRING_VIEW_H__
+#include "epLib.h"
+#include "epLocale.h"
+#include "epAssert.h"
+
+namespace epl
+{
+	/*! 
+	@class StringView epStringView.h
+	@brief A class which refers to the characters of the other string without copying them.
+
+	The sub-strings and the trimmed strings are returned as the views of the same characters,
+	so the parsing loop can split the string without allocating.
+	@remark the characters referred must outlive the view, and the view is not null-terminated.
+	*/
+	class EP_LIBRARY StringView
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty view
+		*/
+		StringView() {m_begin=_T(""); m_length=0;}
+
+		/*!
+		Default Constructor
+
+		Initializes the view of the given null-terminated string
+		@param[in] str the null-terminated string to refer
+		*/
+		StringView(const TCHAR *str);
+
+		/*!
+		Default Constructor
+
+		Initializes the view of the given characters
+		@param[in] str the characters to refer
+		@param[in] length the number of the characters
+		*/
+		StringView(const TCHAR *str, size_t length) {m_begin=str; m_length=length;}
+
+		/*!
+		Default Constructor
+
+		Initializes the view of the given string
+		@param[in] str the string to refer
+		*/
+		StringView(const EpTString &str) {m_begin=str.c_str(); m_length=str.length();}
+
+		/*!
+		Return the first character referred
+		@return the pointer to the first character, which is not null-terminated
+		*/
+		const TCHAR *GetString() const {return m_begin;}
+
+		/*!
+		Return the number of the characters
+		@return the number of the characters
+		*/
+		size_t GetLength() const {return m_length;}
+
+		/*!
+		Return the flag whether the view is empty
+		@return true if empty, otherwise false
+		*/
+		bool IsEmpty() const {return m_length==0;}
+
+		/*!
+		Return the character at the given index
+		@param[in] idx the index of the character
+		@return the character at the given index
+		*/
+		TCHAR operator[](size_t idx) const {EP_ASSERT(idx<m_length); return m_begin[idx];}
+
+		/*!
+		Find the given character from the given index
+		@param[in] c the character to find
+		@param[in] start the index to start from
+		@return the index of the character found, or -1 if not exists
+		*/
+		int Find(TCHAR c, int start=0) const;
+
+		/*!
+		Find the last of the given character
+		@param[in] c the character to find
+		@return the index of the character found, or -1 if not exists
+		*/
+		int ReverseFind(TCHAR c) const;
+
+		/*!
+		Return the view to the left of the nth occurance of the given character
+		@param[in] c the character to find
+		@param[in] n the occurance of the character
+		@return the view to the left of the character, or the whole view if not exists
+		*/
+		StringView Left(TCHAR c, int n=1) const;
+
+		/*!
+		Return the view to the right of the nth occurance of the given character
+		@param[in] c the character to find
+		@param[in] n the occurance of the character
+		@return the view to the right of the character, or the empty view if not exists
+		*/
+		StringView Right(TCHAR c, int n=1) const;
+
+		/*!
+		Return the view to the right of the last occurance of the given character
+		@param[in] c the character to find
+		@return the view to the right of the character, or the empty view if not exists
+		*/
+		StringView Rightmost(TCHAR c) const;
+
+		/*!
+		Return the view to the left of the last occurance of the given character
+		@param[in] c the character to find
+		@return the view to the left of the character, or the empty view if not exists
+		*/
+		StringView LeftOfRightmost(TCHAR c) const;
+
+		/*!
+		Return the view of the sub-string as CString::Mid
+		@param[in] begin the index of the first character
+		@param[in] len the number of the characters
+		@return the view of the sub-string
+		*/
+		StringView SubStr(int begin, int len) const;
+
+		/*!
+		Return the view trimmed on the left side as Locale::TrimLeft
+		@return the view trimmed
+		*/
+		StringView TrimLeft() const;
+
+		/*!
+		Return the view trimmed on the right side as Locale::TrimRight
+		@return the view trimmed
+		*/
+		StringView TrimRight() const;
+
+		/*!
+		Return the view trimmed as Locale::Trim
+		@return the view trimmed
+		*/
+		StringView Trim() const;
+
+		/*!
+		Return the flag whether the characters are the same as the given view
+		@param[in] str the view to compare
+		@return true if the same, otherwise false
+		*/
+		bool Equals(const StringView &str) const;
+
+		/*!
+		Return the flag whether the characters are the same as the given view
+		@param[in] str the view to compare
+		@return true if the same, otherwise false
+		*/
+		bool operator==(const StringView &str) const {return Equals(str);}
+
+		/*!
+		Return the flag whether the characters are different from the given view
+		@param[in] str the view to compare
+		@return true if different, otherwise false
+		*/
+		bool operator!=(const StringView &str) const {return !Equals(str);}
+
+		/*!
+		Return the copy of the characters
+		@return the string copied
+		*/
+		EpTString ToString() const {return EpTString(m_begin,m_length);}
+
+	private:
+		/// the first character
+		const TCHAR *m_begin;
+		/// the number of the characters
+		size_t m_length;
+	};
+
+}
+
+#endif //__EP_STRING_VIEW_H__
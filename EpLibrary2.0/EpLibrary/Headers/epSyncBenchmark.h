@@ -0,0 +1,147 @@
+/*! 
+@file epSyncBenchmark.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Synchronization Benchmark Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Synchronization Benchmark.
+
+*/
+#ifndef __EP_SYNC_BENCHMARK_H__
+#define __EP_SYNC_BENCHMARK_H__
+#include "epLib.h"
+#include "epBenchmark.h"
+
+/// the number of the loop iterations of the work done between the operations in the low contention
+#define SYNC_BENCHMARK_WORK_COUNT 100
+
+/// the number of the items each queue holds before the measurement
+#define SYNC_BENCHMARK_QUEUE_DEPTH 64
+
+namespace epl
+{
+	/// Enumeration for the contention of the threads measured
+	enum SyncBenchmarkContention{
+		/// each thread operates on its own object
+		SYNC_BENCHMARK_CONTENTION_NONE=0,
+		/// all threads operate on one object, with the work between the operations
+		SYNC_BENCHMARK_CONTENTION_LOW,
+		/// all threads operate on one object, without the work between the operations
+		SYNC_BENCHMARK_CONTENTION_HIGH,
+		/// Contention Count
+		SYNC_BENCHMARK_CONTENTION_COUNT,
+	};
+
+	/// Enumeration for the lock measured
+	enum SyncBenchmarkLock{
+		/// CriticalSectionEx
+		SYNC_BENCHMARK_LOCK_CRITICALSECTION=0,
+		/// Mutex
+		SYNC_BENCHMARK_LOCK_MUTEX,
+		/// Semaphore with the count of 1
+		SYNC_BENCHMARK_LOCK_SEMAPHORE,
+		/// InterlockedEx
+		SYNC_BENCHMARK_LOCK_INTERLOCKED,
+		/// SpinParkLock
+		SYNC_BENCHMARK_LOCK_SPIN_PARK,
+		/// ReaderWriterLock
+		SYNC_BENCHMARK_LOCK_READER_WRITER,
+		/// Lock Count
+		SYNC_BENCHMARK_LOCK_COUNT,
+	};
+
+	/*! 
+	@class SyncBenchmark epSyncBenchmark.h
+	@brief A class for measuring the cost of the synchronization primitives, the thread safe queues and the shared objects.
+
+	Each case is measured for the thread counts from 1 up to given count, doubling each time,
+	and for each contention unless noted otherwise.
+	The operations are divided among the threads, so the ops_per_sec of the report is the throughput of all threads together.
+	The results are added to BENCHMARK_INSTANCE, and reported by its Print or FlushToFile.
+	*/
+	class EP_LIBRARY SyncBenchmark
+	{
+	public:
+		/*!
+		Run all the synchronization benchmarks.
+		@param[in] maxThreadCount the largest number of the threads to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void Run(unsigned int maxThreadCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where the threads lock, increment the value guarded and unlock.
+		@param[in] lockType the lock to measure.
+		@param[in] maxThreadCount the largest number of the threads to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunLock(SyncBenchmarkLock lockType, unsigned int maxThreadCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmarks of EventEx, setting and waiting on one thread, and signaling back and forth between two threads.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunEvent(unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where the threads push an item to and pop an item from ThreadSafeQueue and ThreadSafePQueue.
+		@param[in] maxThreadCount the largest number of the threads to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the queues are measured for each lock policy guarding them in the multi thread environment.
+		*/
+		static void RunQueue(unsigned int maxThreadCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where the threads retain and release SmartObject.
+		@param[in] maxThreadCount the largest number of the threads to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		*/
+		static void RunSmartObject(unsigned int maxThreadCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where the threads allocate and free TinyObject, and the same object from the heap as the baseline.
+		@param[in] maxThreadCount the largest number of the threads to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark each thread allocates its own objects, so the contention is not varied.
+		*/
+		static void RunTinyObject(unsigned int maxThreadCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+
+		/*!
+		Run the benchmark where each thread increments its own counter, packed next to the counters of the other threads, and padded to its own cache line.
+		@param[in] maxThreadCount the largest number of the threads to measure, or 0 for the number of the cores.
+		@param[in] minTime the time in milliseconds each measurement runs at least.
+		@remark the gap between PACKED and PADDED is the cost of the false sharing,
+		which EP_ENABLE_CACHE_LINE_PADDING removes from the shared objects of the library.
+		*/
+		static void RunFalseSharing(unsigned int maxThreadCount=0, unsigned int minTime=BENCHMARK_MIN_TIME);
+	};
+}
+#endif //__EP_SYNC_BENCHMARK_H__
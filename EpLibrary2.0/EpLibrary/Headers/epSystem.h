@@ -98,6 +98,25 @@ namespace epl
 	typedef int   ssize_t;
 #endif
 
+	/*!
+	@def SYSTEM_MEMORY_SMALL_SIZE
+	@brief the largest byte size handled inline by Memcpy, Memset and Memcmp
+
+	Macro for the largest byte size handled inline without calling the dispatched routines.
+	*/
+#define SYSTEM_MEMORY_SMALL_SIZE 16
+
+#ifndef SYSTEM_MEMORY_NON_TEMPORAL_SIZE
+	/*!
+	@def SYSTEM_MEMORY_NON_TEMPORAL_SIZE
+	@brief the byte size from which Memcpy and Memset bypass the cache
+
+	Macro for the byte size from which the non-temporal stores are used.
+	Buffers this large would evict most of the cache, so they are written around it.
+	*/
+#define SYSTEM_MEMORY_NON_TEMPORAL_SIZE (1024*1024)
+#endif //SYSTEM_MEMORY_NON_TEMPORAL_SIZE
+
 	/*! 
 	@class System epSystem.h
 	@brief This is a base class for System  Class
@@ -121,6 +140,51 @@ namespace epl
 		*/
 		static unsigned long GetNumberOfCores();
 
+		/*!
+		Return the number of physical cores of running computer.
+		@return the number of physical cores of running computer.
+		@remark returns GetNumberOfCores() if the physical core information is not available.
+		*/
+		static unsigned long GetNumberOfPhysicalCores();
+
+		/*!
+		Return the affinity mask of each physical core in the current processor group.
+		@param[out] retMaskList the list of the affinity masks, one mask per physical core.
+		@remark each mask contains all logical processors (hyper-threads) of the core.
+		@remark one mask per logical processor is returned if the physical core information is not available.
+		*/
+		static void GetPhysicalCoreAffinityMasks(std::vector<ULONG_PTR> &retMaskList);
+
+		/*!
+		Return the number of NUMA nodes of running computer.
+		@return the number of NUMA nodes.
+		*/
+		static unsigned long GetNumberOfNumaNodes();
+
+		/*!
+		Return the NUMA node of the given processor.
+		@param[in] processorNumber the logical processor number.
+		@return the NUMA node number of the processor, or 0 if not available.
+		*/
+		static unsigned long GetNumaNodeOfProcessor(unsigned long processorNumber);
+
+		/*!
+		Allocate the memory on the given NUMA node.
+		@param[in] size the size of the memory in bytes.
+		@param[in] numaNode the NUMA node to allocate the memory on.
+		@return the allocated memory, or NULL if failed.
+		@remark the memory is committed in pages, so use this for large buffers only.
+		@remark falls back to VirtualAlloc if VirtualAllocExNuma is not available.
+		@remark the memory must be freed with NumaFree.
+		*/
+		static void *NumaAlloc(size_t size, unsigned long numaNode);
+
+		/*!
+		Free the memory allocated by NumaAlloc.
+		@param[in] memory the memory to free.
+		*/
+		static void NumaFree(void *memory);
+
 		/*!
 		Return the time in milliseconds from first call of GetTime.
 		@return the time in milliseconds from first call of GetTime.
@@ -148,8 +212,16 @@ namespace epl
 		@param[in] source The source buffer to be copied.
 		@param[in] srcSizeInByte the size of source to copy.
 		@return the resulting buffer.
+		@remark The buffers must not overlap.
+		@remark Copies up to SYSTEM_MEMORY_SMALL_SIZE bytes are done inline,
+		        and the larger ones are dispatched to the routine chosen for the processor.
 		*/
-		static void* Memcpy (void* dest, size_t dstSizeInByte, const void* source, size_t srcSizeInByte);
+		static void* Memcpy (void* dest, size_t dstSizeInByte, const void* source, size_t srcSizeInByte)
+		{
+			if(dstSizeInByte<srcSizeInByte)
+				return 0;
+			return Memcpy(dest,source,srcSizeInByte);
+		}
 
 		/*!
 		Copy the source buffer to destination buffer.
@@ -157,8 +229,19 @@ namespace epl
 		@param[in] source The source buffer to be copied.
 		@param[in] srcSizeInByte the size of source to copy.
 		@return the resulting buffer.
-		*/
-		static void* Memcpy (void* dest, const void* source, size_t srcSizeInByte);
+		@remark The buffers must not overlap.
+		*/
+		static void* Memcpy (void* dest, const void* source, size_t srcSizeInByte)
+		{
+			if(srcSizeInByte>SYSTEM_MEMORY_SMALL_SIZE)
+				return copyMemory(dest,source,srcSizeInByte);
+			if(!srcSizeInByte)
+				return dest;
+			if(!dest || !source)
+				return 0;
+			copySmallMemory(static_cast<unsigned char*>(dest),static_cast<const unsigned char*>(source),srcSizeInByte);
+			return dest;
+		}
 
 		
 		/*!
@@ -170,7 +253,19 @@ namespace epl
 		        >0 if buf1 is greater than buf2 <br/>
 				<0 if buf1 is less than buf2
 		*/
-		static int Memcmp (void* buf1, const void* buf2, size_t compSizeInByte);
+		static int Memcmp (void* buf1, const void* buf2, size_t compSizeInByte)
+		{
+			if(compSizeInByte>SYSTEM_MEMORY_SMALL_SIZE)
+				return compareMemory(buf1,buf2,compSizeInByte);
+			const unsigned char *first=static_cast<const unsigned char*>(buf1);
+			const unsigned char *second=static_cast<const unsigned char*>(buf2);
+			for(size_t byteTrav=0;byteTrav<compSizeInByte;byteTrav++)
+			{
+				if(first[byteTrav]!=second[byteTrav])
+					return static_cast<int>(first[byteTrav])-static_cast<int>(second[byteTrav]);
+			}
+			return 0;
+		}
 
 		/*!
 		Set the source buffer with given value.
@@ -179,7 +274,16 @@ namespace epl
 		@param[in] srcSizeInByte the size of source.
 		@return the resulting buffer.
 		*/
-		static void* Memset(void* source,int val,size_t srcSizeInByte);
+		static void* Memset(void* source,int val,size_t srcSizeInByte)
+		{
+			if(srcSizeInByte>SYSTEM_MEMORY_SMALL_SIZE)
+				return setMemory(source,val,srcSizeInByte);
+			unsigned char *dest=static_cast<unsigned char*>(source);
+			unsigned char byteVal=static_cast<unsigned char>(val);
+			for(size_t byteTrav=0;byteTrav<srcSizeInByte;byteTrav++)
+				dest[byteTrav]=byteVal;
+			return source;
+		}
 
 
 		/*!
@@ -809,6 +913,21 @@ namespace epl
 		@return 0 if the stream is successfully closed.
 		*/
 		static int FClose(EpFile * const fileStream);
+
+		/*!
+		Write the buffered data of the given file stream to the operating system.
+		@param[in] fileStream Pointer to FILE structure.
+		@return 0 if the buffer was successfully flushed.
+		*/
+		static int FFlush(EpFile * const fileStream);
+
+		/*!
+		Write the buffered data of the given file stream, and commit it to the disk.
+		@param[in] fileStream Pointer to FILE structure.
+		@return 0 if the data was successfully committed.
+		@remark this waits for the disk, so it is far slower than FFlush.
+		*/
+		static int FCommit(EpFile * const fileStream);
 		
 		/*!
 		Write the given buffer to the given file stream.
@@ -1053,6 +1172,67 @@ namespace epl
 		@return result of the termination
 		*/
 		static long TerminateThread(HANDLE threadHandle, unsigned long exitCode);
+
+	private:
+		/*!
+		Copy the source buffer larger than SYSTEM_MEMORY_SMALL_SIZE with the routine chosen for the processor.
+		@param[in] dest The destination for copying.
+		@param[in] source The source buffer to be copied.
+		@param[in] srcSizeInByte the size of source to copy.
+		@return the resulting buffer.
+		*/
+		static void* copyMemory(void* dest, const void* source, size_t srcSizeInByte);
+
+		/*!
+		Compare the buffers larger than SYSTEM_MEMORY_SMALL_SIZE with the routine chosen for the processor.
+		@param[in] buf1 The first buffer to compare.
+		@param[in] buf2 The second buffer to compare
+		@param[in] compSizeInByte the size of buffer to compare.
+		@return the difference of the first mismatching bytes, or 0 if equal.
+		*/
+		static int compareMemory(const void* buf1, const void* buf2, size_t compSizeInByte);
+
+		/*!
+		Set the source buffer larger than SYSTEM_MEMORY_SMALL_SIZE with the routine chosen for the processor.
+		@param[in] source The source to be set.
+		@param[in] val The value to set.
+		@param[in] srcSizeInByte the size of source.
+		@return the resulting buffer.
+		*/
+		static void* setMemory(void* source,int val,size_t srcSizeInByte);
+
+		/*!
+		Copy 1 to SYSTEM_MEMORY_SMALL_SIZE bytes with at most four overlapping moves.
+		@param[in] dest The destination for copying.
+		@param[in] source The source buffer to be copied.
+		@param[in] srcSizeInByte the size of source to copy.
+		*/
+		static void copySmallMemory(unsigned char* dest, const unsigned char* source, size_t srcSizeInByte)
+		{
+			if(srcSizeInByte>=8)
+			{
+				unsigned __int64 head,tail;
+				memcpy(&head,source,8);
+				memcpy(&tail,source+srcSizeInByte-8,8);
+				memcpy(dest,&head,8);
+				memcpy(dest+srcSizeInByte-8,&tail,8);
+			}
+			else if(srcSizeInByte>=4)
+			{
+				unsigned int head,tail;
+				memcpy(&head,source,4);
+				memcpy(&tail,source+srcSizeInByte-4,4);
+				memcpy(dest,&head,4);
+				memcpy(dest+srcSizeInByte-4,&tail,4);
+			}
+			else
+			{
+				unsigned char head=source[0],middle=source[srcSizeInByte>>1],tail=source[srcSizeInByte-1];
+				dest[0]=head;
+				dest[srcSizeInByte>>1]=middle;
+				dest[srcSizeInByte-1]=tail;
+			}
+		}
 	};
 
 }
@@ -130,6 +130,7 @@ namespace epl
 	protected:
 		unsigned char* Get24BitPixels(HBITMAP pBitmap, WORD *pwWidth, WORD *pwHeight);
 		HRGN GenerateRegion(HBITMAP hBitmap, unsigned char red, unsigned char green, unsigned char blue);
+		HRGN GetSkinRegion(HINSTANCE hInstance, UINT nBitmapID, const TCHAR *szFileName, unsigned char red, unsigned char green, unsigned char blue);
 
 	protected:
 		DECLARE_MESSAGE_MAP()
@@ -0,0 +1,168 @@
+/*! 
+@file epTextLineReader.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Text Line Reader Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Streaming Text Line Reader.
+
+*/
+#ifndef __EP_TEXT_LINE_READER_H__
+#define __EP_TEXT_LINE_READER_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include <vector>
+
+/// the default byte size of the block read from the file at once
+#define TEXT_LINE_READER_BUFFER_SIZE (64*1024)
+
+namespace epl{
+	class FileStream;
+
+	/*!
+	@class TextLineReader epTextLineReader.h
+	@brief A class that reads the text file line by line over the fixed buffer.
+
+	The file is mapped read-only, and each block is decoded into the text buffer only when the lines before are read,
+	so the memory held is about twice the block size, whatever the size of the file.
+	The byte encodings are decoded up to the last new line of the block, so a multi-byte character is never split,
+	and the block grows only for the line longer than the block.
+	The lines are returned as the views into the text buffer, without allocating a string for each line.
+	*/
+	class EP_LIBRARY TextLineReader{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Text Line Reader
+		@param[in] encodingType the encoding type of the file
+		@param[in] bufferSize the byte size of the block read from the file at once
+		*/
+		TextLineReader(FileEncodingType encodingType=FILE_ENCODING_TYPE_UTF16LE, size_t bufferSize=TEXT_LINE_READER_BUFFER_SIZE);
+
+		/*!
+		Default Destructor
+
+		Destroy the Text Line Reader
+		*/
+		virtual ~TextLineReader();
+
+		/*!
+		Open the given file to read
+		@param[in] fileName the name of the file to read
+		@return true if successfully opened, otherwise false
+		@remark the file opened before is closed.
+		*/
+		bool Open(const TCHAR *fileName);
+
+		/*!
+		Close the file
+		*/
+		void Close();
+
+		/*!
+		Return the flag whether the file is opened
+		@return true if opened, otherwise false
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Return the byte size of the file opened
+		@return the byte size of the file, or 0 if not opened
+		*/
+		unsigned __int64 GetFileSize() const;
+
+		/*!
+		Read the next line
+		@param[out] retLine the first character of the line, which is not null-terminated
+		@param[out] retLength the number of the characters of the line without the new line
+		@param[out] retHasNewLine the flag whether the line ended with the new line. (false only for the last line)
+		@return true if the line is read, otherwise false at the end of the file
+		@remark the line is valid only until the next call, and the "\r\n" is treated as the new line.
+		*/
+		bool ReadLine(const TCHAR *&retLine, size_t &retLength, bool *retHasNewLine=NULL);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		TextLineReader(const TextLineReader & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		TextLineReader &operator=(const TextLineReader & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Read the next block from the file, and decode it after the text not read yet
+		@return true if any byte is read or left to decode, otherwise false at the end of the file
+		*/
+		bool fill();
+
+		/*!
+		Decode the given bytes, and append them to the text buffer
+		@param[in] bytes the bytes to decode
+		@param[in] byteSize the byte size of the bytes
+		*/
+		void decode(const char *bytes, size_t byteSize);
+
+		/// the encoding type of the file
+		FileEncodingType m_encodingType;
+		/// the mapped file, or NULL if not opened
+		FileStream *m_stream;
+		/// the byte size of the file
+		unsigned __int64 m_fileSize;
+		/// the offset of the file to read next
+		unsigned __int64 m_readOffset;
+		/// the bytes read but not decoded yet
+		std::vector<char> m_rawBuffer;
+		/// the number of the bytes in the raw buffer
+		size_t m_rawSize;
+		/// the decoded text
+		std::vector<TCHAR> m_textBuffer;
+		/// the start of the text not returned yet
+		size_t m_textBegin;
+		/// the end of the decoded text
+		size_t m_textEnd;
+		/// the end of the text already searched for the new line
+		size_t m_textScan;
+		/// the bytes decoded to UTF-16 before converted to the multi-byte characters, if not the unicode build
+		std::vector<wchar_t> m_wideBuffer;
+	};
+}
+
+#endif //__EP_TEXT_LINE_READER_H__
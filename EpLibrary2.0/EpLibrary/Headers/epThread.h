@@ -42,6 +42,8 @@ A Frame Interface for Thread Class.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 
 namespace epl
 {
@@ -335,6 +337,28 @@ namespace epl
 		*/
 		bool SetPriority(ThreadPriority priority);
 
+		/*!
+		Set the processor affinity of the thread.
+		@param[in] affinityMask the affinity mask of the processors to run the thread on.
+		@param[in] processorGroup the processor group of the mask, or -1 for the current group of the thread.
+		@return true if successfully set otherwise false
+		@remark the affinity is kept, and applied again when the thread is started.
+		@remark processorGroup other than -1 requires Windows 7 or later.
+		*/
+		bool SetAffinityMask(ULONG_PTR affinityMask, int processorGroup=-1);
+
+		/*!
+		Return the processor affinity of the thread set by SetAffinityMask.
+		@return the affinity mask, or 0 if not set.
+		*/
+		ULONG_PTR GetAffinityMask() const;
+
+		/*!
+		Return the processor group of the thread set by SetAffinityMask.
+		@return the processor group, or -1 for the current group.
+		*/
+		int GetProcessorGroup() const;
+
 
 	protected:
 
@@ -386,6 +410,12 @@ namespace epl
 		*/
 		void resetThread();
 
+		/*!
+		Apply the affinity mask to the running thread.
+		@return true if successfully applied otherwise false
+		*/
+		bool applyAffinityMask();
+
 		/*!
 		Entry point for the thread created with _beginthreadex
 		@param[in] pthis The argument for the thread (this for current case)
@@ -408,6 +438,10 @@ namespace epl
 		ThreadHandle m_threadHandle;
 		/// ThreadPriority
 		ThreadPriority m_threadPriority;
+		/// Affinity Mask
+		ULONG_PTR m_affinityMask;
+		/// Processor Group
+		int m_processorGroup;
 		
 		/// Parent Thread ID
 		ThreadID m_parentThreadId;
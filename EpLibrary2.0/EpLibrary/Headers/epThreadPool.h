@@ -0,0 +1,356 @@
+/*!
+@file epThreadPool.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Work-Stealing Thread Pool Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Work-Stealing Thread Pool Class.
+
+*/
+#ifndef __EP_THREAD_POOL_H__
+#define __EP_THREAD_POOL_H__
+#include "epLib.h"
+#include <vector>
+#include <deque>
+#include "epBaseWorkerThread.h"
+#include "epBaseJobProcessor.h"
+#include "epLightSemaphore.h"
+
+namespace epl
+{
+	class ThreadPool;
+
+	/*!
+	@class ThreadPoolWorker epThreadPool.h
+	@brief A class that implements the worker thread owned by ThreadPool.
+
+	Each worker owns a local job deque.
+	The worker pops its own jobs from the back, and idle workers steal from the front.
+	*/
+	class EP_LIBRARY ThreadPoolWorker:public BaseWorkerThread
+	{
+	public:
+		friend class ThreadPool;
+
+		/*!
+		Default Constructor
+
+		Initializes the worker thread
+		@param[in] owner the thread pool which owns this worker.
+		@param[in] workerIdx the index of this worker within the owner.
+		@param[in] lockPolicyType The lock policy
+		*/
+		ThreadPoolWorker(ThreadPool *owner, unsigned int workerIdx, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the worker thread
+		*/
+		virtual ~ThreadPoolWorker();
+
+		/*!
+		Get job count in the local deque of this worker.
+		@return the job count in the local deque.
+		*/
+		size_t GetLocalJobCount() const;
+
+		/*!
+		Return the index of this worker within the owner.
+		@return the index of this worker.
+		*/
+		unsigned int GetWorkerIndex() const
+		{
+			return m_workerIdx;
+		}
+
+		/*!
+		Return the NUMA node this worker is placed on.
+		@return the NUMA node of this worker, or 0 if the worker is not placed.
+		@remark allocate the large job memory with System::NumaAlloc on this node to keep it local.
+		*/
+		unsigned long GetNumaNode() const
+		{
+			return m_numaNode;
+		}
+
+	protected:
+		/*!
+		Actual work-stealing Thread Code.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ThreadPoolWorker(const ThreadPoolWorker & b):BaseWorkerThread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ThreadPoolWorker &operator=(const ThreadPoolWorker & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Push the given job to the back of the local deque.
+		@param[in] job the job to push.
+		*/
+		void pushLocal(BaseJob * const job);
+
+		/*!
+		Pop the job from the back of the local deque.
+		@return the job popped, or NULL if the deque is empty.
+		*/
+		BaseJob *popLocal();
+
+		/*!
+		Steal the job from the front of the local deque.
+		@return the job stolen, or NULL if the deque is empty.
+		*/
+		BaseJob *stealLocal();
+
+		/// the owner of this worker
+		ThreadPool *m_owner;
+		/// the index of this worker
+		unsigned int m_workerIdx;
+		/// the NUMA node of this worker
+		unsigned long m_numaNode;
+		/// the local job deque
+		std::deque<BaseJob*> m_localQueue;
+		/// local deque lock
+		BaseLock *m_localLock;
+	};
+
+	/*!
+	@class ThreadPool epThreadPool.h
+	@brief A class that implements Work-Stealing Thread Pool.
+
+	The pool owns N workers, and each worker keeps its own job deque.
+	Jobs pushed from outside are distributed in round-robin, jobs pushed from a worker go to that worker,
+	and the idle worker steals the oldest job from the busy one.
+	*/
+	class EP_LIBRARY ThreadPool
+	{
+	public:
+		friend class ThreadPoolWorker;
+
+		/// Enumerator for Worker Placement Policy
+		enum PlacementPolicy
+		{
+			/// The workers are placed by the operating system.
+			PLACEMENT_POLICY_NONE=0,
+			/// Each worker is pinned to one physical core in round-robin.
+			PLACEMENT_POLICY_PHYSICAL_CORE,
+			/// Placement Policy Count
+			PLACEMENT_POLICY_COUNT,
+		};
+
+		/*!
+		Default Constructor
+
+		Initializes the thread pool
+		@param[in] jobProcessor the job processor for all workers in the pool.
+		@param[in] workerCount the number of workers. (0 means System::GetNumberOfCores())
+		@param[in] lockPolicyType The lock policy
+		*/
+		ThreadPool(BaseJobProcessor *jobProcessor, unsigned int workerCount=0, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Stop the workers and destroy the thread pool
+		*/
+		virtual ~ThreadPool();
+
+		/*!
+		Start all workers in the pool.
+		@return true if successfully started, otherwise false.
+		*/
+		bool Start();
+
+		/*!
+		Stop all workers in the pool.
+		@param[in] waitTimeInMilliSec the time-out interval for each worker, in milliseconds.
+		@remark the jobs still in the pool are reported as JOB_STATUS_INCOMPLETE.
+		*/
+		void Stop(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Set the placement policy of the workers.
+		@param[in] policy the placement policy.
+		@remark takes effect on the next Start.
+		@remark use System::GetNumberOfPhysicalCores() as the worker count to place one worker per physical core.
+		*/
+		void SetPlacementPolicy(PlacementPolicy policy);
+
+		/*!
+		Return the placement policy of the workers.
+		@return the placement policy.
+		*/
+		PlacementPolicy GetPlacementPolicy() const;
+
+		/*!
+		Push in the new job to the pool.
+		@param[in] job the new job to put into the pool.
+		@remark if called within the worker of this pool, the job goes to the worker's own deque.
+		*/
+		void Push(BaseJob * const job);
+
+		/*!
+		Push in the new job to the pool, and return its completion handle.
+		@param[in] job the new job to put into the pool.
+		@return the completion handle of the job.
+		@remark the returned handle is retained for the caller, so the caller must call ReleaseObj.
+		*/
+		JobHandle *Submit(BaseJob * const job);
+
+		/*!
+		Return the flag whether the pool is started.
+		@return true if the pool is started, otherwise false.
+		*/
+		bool IsStarted() const;
+
+		/*!
+		Return the number of workers in the pool.
+		@return the number of workers.
+		*/
+		unsigned int GetWorkerCount() const;
+
+		/*!
+		Return the worker with given index.
+		@param[in] workerIdx the index of the worker.
+		@return the worker with given index.
+		*/
+		ThreadPoolWorker *GetWorker(unsigned int workerIdx);
+
+		/*!
+		Get job count in the pool.
+		@return the job count in the pool.
+		*/
+		size_t GetJobCount() const;
+
+		/*!
+		Copy the metrics summed over all workers in the pool to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the metrics.
+		@remark can be called while the workers are running.
+		*/
+		void GetMetrics(WorkerMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Get Job Processor.
+		@return the Job Processor for this pool.
+		*/
+		BaseJobProcessor* GetJobProcessor();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		ThreadPool(const ThreadPool & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		ThreadPool &operator=(const ThreadPool & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Pin each worker according to the placement policy.
+		*/
+		void placeWorkers();
+
+		/*!
+		Find the worker of this pool running on the calling thread.
+		@return the worker running on the calling thread, or NULL if not found.
+		*/
+		ThreadPoolWorker *findCurrentWorker();
+
+		/*!
+		Steal the job from other workers.
+		@param[in] thiefIdx the index of the worker trying to steal.
+		@return the job stolen, or NULL if all workers are empty.
+		*/
+		BaseJob *steal(unsigned int thiefIdx);
+
+		/*!
+		Process the given job on the given worker.
+		@param[in] worker the worker to process the job.
+		@param[in] job the job to process.
+		*/
+		void processJob(ThreadPoolWorker *worker, BaseJob *job);
+
+		/*!
+		Wait for new job to be pushed.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		*/
+		void waitForJob(unsigned int waitTimeInMilliSec);
+
+		/*!
+		Return the flag whether the pool is stopping.
+		@return true if the pool is stopping, otherwise false.
+		*/
+		bool isStopping() const;
+
+		/// the workers
+		std::vector<ThreadPoolWorker*> m_workers;
+		/// the job processor
+		BaseJobProcessor *m_jobProcessor;
+		/// the job signal
+		LightSemaphore m_jobSignal;
+		/// next worker index for round-robin distribution
+		volatile long m_nextWorkerIdx;
+		/// the number of jobs in the pool
+		volatile long m_jobCount;
+		/// the flag for stopping
+		volatile long m_isStopping;
+		/// the flag for started
+		volatile long m_isStarted;
+		/// the placement policy of the workers
+		PlacementPolicy m_placementPolicy;
+		/// pool lock
+		BaseLock *m_poolLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+}
+
+#endif //__EP_THREAD_POOL_H__
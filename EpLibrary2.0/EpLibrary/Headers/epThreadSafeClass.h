@@ -42,6 +42,8 @@ An Interface for Thread Safe Class.
 #include "epCriticalSectionEx.h"
 #include "epMutex.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 /*!
 @def DECLARE_THREAD_SAFE_CLASS
 @brief Macro for declaring Thread Safe class
@@ -89,6 +91,12 @@ namespace epl
 			case LOCK_POLICY_NONE:
 				m_threadSafeLock=EP_NEW NoLock();
 				break;
+			case LOCK_POLICY_SPIN_PARK:
+				m_threadSafeLock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				m_threadSafeLock=EP_NEW ReaderWriterLock();
+				break;
 			default:
 				m_threadSafeLock=NULL;
 				break;
@@ -116,6 +124,12 @@ namespace epl
 			case LOCK_POLICY_NONE:
 				m_threadSafeLock=EP_NEW NoLock();
 				break;
+			case LOCK_POLICY_SPIN_PARK:
+				m_threadSafeLock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				m_threadSafeLock=EP_NEW ReaderWriterLock();
+				break;
 			default:
 				m_threadSafeLock=NULL;
 				break;
@@ -159,6 +173,12 @@ namespace epl
 				case LOCK_POLICY_NONE:
 					m_threadSafeLock=EP_NEW NoLock();
 					break;
+				case LOCK_POLICY_SPIN_PARK:
+					m_threadSafeLock=EP_NEW SpinParkLock();
+					break;
+				case LOCK_POLICY_READER_WRITER:
+					m_threadSafeLock=EP_NEW ReaderWriterLock();
+					break;
 				default:
 					m_threadSafeLock=NULL;
 					break;
@@ -0,0 +1,412 @@
+/*! 
+@file epThreadSafeHeapQueue.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Thread Safe Heap Queue Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Thread Safe d-ary Heap Priority Queue.
+
+*/
+#ifndef __EP_THREAD_SAFE_HEAP_QUEUE_H__
+#define __EP_THREAD_SAFE_HEAP_QUEUE_H__
+#include "epLib.h"
+#include "epThreadSafeQueue.h"
+
+namespace epl
+{
+	/*! 
+	@class ThreadSafeHeapQueue epThreadSafeHeapQueue.h
+	@brief A class for Thread Safe Priority Queue on the array-backed k-ary heap.
+
+	Push and Pop cost O(log(n)) instead of moving the half of the queue as ThreadSafePQueue,
+	and the items with equal priority are popped in the order of Push.
+	Unlike ThreadSafePQueue, the equal items are allowed.
+	Only Front is ordered, and Back, GetQueue and ForEach see the items in the heap order.
+	*/
+	template <typename DataType, typename Compare=CompClass<DataType>, size_t k=4, typename LockType=BaseLock >
+	class ThreadSafeHeapQueue:public ThreadSafeQueue<DataType,LockType>
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the heap queue
+		@param[in] lockPolicyType The lock policy
+		*/
+		ThreadSafeHeapQueue(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the heap queue
+		@param[in] b the second object
+		*/
+		ThreadSafeHeapQueue(const ThreadSafeHeapQueue& b);
+
+		/*!
+		Default Destructor
+
+		Destroy the heap queue
+		*/
+		virtual ~ThreadSafeHeapQueue();
+
+		/*!
+		Assignment Operator Overloading
+
+		the ThreadSafeHeapQueue set as given ThreadSafeHeapQueue b
+		@param[in] b right side of ThreadSafeHeapQueue
+		@return this object
+		*/
+		ThreadSafeHeapQueue & operator=(const ThreadSafeHeapQueue&b);
+
+		/*!
+		Insert the new item into the heap queue.
+		@param[in] data The inserting data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool Push(DataType const &data);
+
+		/*!
+		Insert the given items into the heap queue with a single lock acquisition.
+		@param[in] data The array of inserting data.
+		@param[in] count The number of items in the array.
+		@return the number of items taken from the front of the array.
+		*/
+		virtual size_t PushBatch(DataType const *data, size_t count);
+
+#if _MSC_VER>=MSVC100
+		/*!
+		Insert the new item into the heap queue by moving it.
+		@param[in] data The inserting data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool Push(DataType &&data);
+#endif //_MSC_VER>=MSVC100
+
+		/*!
+		Insert the new item into the heap queue by swapping it in.
+		@param[in,out] data The inserting data, left as default-constructed data if taken.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool PushSwap(DataType &data);
+
+	protected:
+		/*!
+		Drop the item with the lowest priority, the queue lock must be held.
+		@remark scans the leaves, so costs O(n), but only when the bounded queue overflows.
+		*/
+		virtual void dropOldest();
+
+		/*!
+		Remove up to given number of items in the priority order, the queue lock must be held.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@return the number of items removed.
+		*/
+		virtual size_t popFront(DataType *retData, size_t maxCount);
+
+		/*!
+		Remove the item at given index of the heap, the queue lock must be held.
+		@param[in] index The index of the item to remove.
+		*/
+		virtual void eraseAt(size_t index);
+
+		/*!
+		Remove all items from the heap, the queue lock must be held.
+		*/
+		virtual void clearItems();
+
+	private:
+		/*!
+		Copy the sequence numbers from the given heap queue.
+		@param[in] b the heap queue to copy from.
+		*/
+		void copySequence(const ThreadSafeHeapQueue &b);
+
+		/*!
+		Restore the heap order for the item just appended to the back, the queue lock must be held.
+		*/
+		void heapifyBack();
+
+		/*!
+		Check if the item at index a comes before the item at index b.
+		@param[in] a the index of the first item.
+		@param[in] b the index of the second item.
+		@return true if the item at index a has higher priority, or was pushed earlier with equal priority.
+		*/
+		bool isBefore(size_t a, size_t b) const;
+
+		/*!
+		Swap the items at given indices with their sequence numbers.
+		@param[in] a the index of the first item.
+		@param[in] b the index of the second item.
+		*/
+		void swapNode(size_t a, size_t b);
+
+		/*!
+		Move the item at given index up until its parent comes before it.
+		@param[in] idx The index of the item.
+		*/
+		void heapifyUp(size_t idx);
+
+		/*!
+		Move the item at given index down until it comes before its children.
+		@param[in] idx The index of the item.
+		*/
+		void heapifyDown(size_t idx);
+
+		/// the push sequence number of each item, in the same index as the item
+		std::vector<unsigned __int64> m_sequence;
+		/// the sequence number for the next push
+		unsigned __int64 m_nextSequence;
+	};
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	ThreadSafeHeapQueue<DataType,Compare,k,LockType>::ThreadSafeHeapQueue(LockPolicy lockPolicyType) :ThreadSafeQueue<DataType,LockType>(lockPolicyType)
+	{
+		EP_ASSERT_EXPR(k>1,_T("Template Declaration Error: k cannnot be less than 2"));
+		m_nextSequence=0;
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	ThreadSafeHeapQueue<DataType,Compare,k,LockType>::ThreadSafeHeapQueue(const ThreadSafeHeapQueue& b):ThreadSafeQueue<DataType,LockType>(b)
+	{
+		EP_ASSERT_EXPR(k>1,_T("Template Declaration Error: k cannnot be less than 2"));
+		copySequence(b);
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	ThreadSafeHeapQueue<DataType,Compare,k,LockType>::~ThreadSafeHeapQueue()
+	{
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	ThreadSafeHeapQueue<DataType,Compare,k,LockType> & ThreadSafeHeapQueue<DataType,Compare,k,LockType>::operator=(const ThreadSafeHeapQueue&b)
+	{
+		if(this != &b)
+		{
+			ThreadSafeQueue<DataType,LockType>::operator =(b);
+			copySequence(b);
+		}
+		return *this;
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::copySequence(const ThreadSafeHeapQueue &b)
+	{
+		InlineLockObj<LockType> lock(b.m_queueLock);
+		// the items were copied under a separate lock acquisition, so copy them again if b changed since
+		if(this->m_queue.size()!=b.m_sequence.size())
+			this->m_queue=b.m_queue;
+		m_sequence=b.m_sequence;
+		m_nextSequence=b.m_nextSequence;
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	bool ThreadSafeHeapQueue<DataType,Compare,k,LockType>::Push(DataType const & data)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		bool pushResult;
+		if(!this->admit(pushResult))
+			return pushResult;
+		this->m_queue.push_back(data);
+		heapifyBack();
+		this->notifyNotEmpty();
+		return true;
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	size_t ThreadSafeHeapQueue<DataType,Compare,k,LockType>::PushBatch(DataType const *data, size_t count)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		size_t dataTrav;
+		for(dataTrav=0;dataTrav<count;dataTrav++)
+		{
+			bool pushResult;
+			if(!this->admit(pushResult))
+			{
+				if(!pushResult)
+					break;
+				continue;
+			}
+			this->m_queue.push_back(data[dataTrav]);
+			heapifyBack();
+		}
+		if(dataTrav>0)
+			this->notifyNotEmpty();
+		return dataTrav;
+	}
+
+#if _MSC_VER>=MSVC100
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	bool ThreadSafeHeapQueue<DataType,Compare,k,LockType>::Push(DataType &&data)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		bool pushResult;
+		if(!this->admit(pushResult))
+			return pushResult;
+		this->m_queue.push_back(std::move(data));
+		heapifyBack();
+		this->notifyNotEmpty();
+		return true;
+	}
+#endif //_MSC_VER>=MSVC100
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	bool ThreadSafeHeapQueue<DataType,Compare,k,LockType>::PushSwap(DataType &data)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		bool pushResult;
+		if(!this->admit(pushResult))
+			return pushResult;
+		this->m_queue.push_back(DataType());
+		using std::swap;
+		swap(this->m_queue.back(),data);
+		heapifyBack();
+		this->notifyNotEmpty();
+		return true;
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::dropOldest()
+	{
+		size_t queueSize=this->m_queue.size();
+		if(queueSize==0)
+			return;
+		// the last item in the priority order is always a leaf, and the scan starts at or just before the first leaf
+		size_t dropIdx=(queueSize-1)/k;
+		for(size_t leafTrav=dropIdx+1;leafTrav<queueSize;leafTrav++)
+		{
+			if(isBefore(dropIdx,leafTrav))
+				dropIdx=leafTrav;
+		}
+		eraseAt(dropIdx);
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	size_t ThreadSafeHeapQueue<DataType,Compare,k,LockType>::popFront(DataType *retData, size_t maxCount)
+	{
+		size_t popCount=(this->m_queue.size()<maxCount)?this->m_queue.size():maxCount;
+		for(size_t popTrav=0;popTrav<popCount;popTrav++)
+		{
+			ThreadSafeQueue<DataType,LockType>::moveOut(this->m_queue.front(),retData[popTrav]);
+			eraseAt(0);
+		}
+		return popCount;
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::eraseAt(size_t index)
+	{
+		size_t lastIdx=this->m_queue.size()-1;
+		if(index!=lastIdx)
+			swapNode(index,lastIdx);
+		this->m_queue.pop_back();
+		m_sequence.pop_back();
+		if(index<lastIdx)
+		{
+			if(index>0 && isBefore(index,(index-1)/k))
+				heapifyUp(index);
+			else
+				heapifyDown(index);
+		}
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::clearItems()
+	{
+		this->m_queue.clear();
+		m_sequence.clear();
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::heapifyBack()
+	{
+		m_sequence.push_back(m_nextSequence++);
+		heapifyUp(this->m_queue.size()-1);
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	bool ThreadSafeHeapQueue<DataType,Compare,k,LockType>::isBefore(size_t a, size_t b) const
+	{
+		CompResultType result=Compare::CompFunc(&this->m_queue[a],&this->m_queue[b]);
+		if(result!=COMP_RESULT_EQUAL)
+			return result==COMP_RESULT_LESSTHAN;
+		return m_sequence[a]<m_sequence[b];
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::swapNode(size_t a, size_t b)
+	{
+		using std::swap;
+		swap(this->m_queue[a],this->m_queue[b]);
+		std::swap(m_sequence[a],m_sequence[b]);
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::heapifyUp(size_t idx)
+	{
+		while(idx>0)
+		{
+			size_t parentIdx=(idx-1)/k;
+			if(!isBefore(idx,parentIdx))
+				break;
+			swapNode(idx,parentIdx);
+			idx=parentIdx;
+		}
+	}
+
+	template <typename DataType, typename Compare, size_t k, typename LockType>
+	void ThreadSafeHeapQueue<DataType,Compare,k,LockType>::heapifyDown(size_t idx)
+	{
+		size_t queueSize=this->m_queue.size();
+		for(;;)
+		{
+			size_t firstChildIdx=idx*k+1;
+			if(firstChildIdx>=queueSize)
+				break;
+			size_t lastChildIdx=(firstChildIdx+k<queueSize)?firstChildIdx+k:queueSize;
+			size_t minChildIdx=firstChildIdx;
+			for(size_t childTrav=firstChildIdx+1;childTrav<lastChildIdx;childTrav++)
+			{
+				if(isBefore(childTrav,minChildIdx))
+					minChildIdx=childTrav;
+			}
+			if(!isBefore(minChildIdx,idx))
+				break;
+			swapNode(idx,minChildIdx);
+			idx=minChildIdx;
+		}
+	}
+}
+
+
+#endif //__EP_THREAD_SAFE_HEAP_QUEUE_H__
\ No newline at end of file
@@ -47,8 +47,8 @@ namespace epl
 	@class ThreadSafePQueue epThreadSafePQueue.h
 	@brief A class for Thread Safe Priority Queue.
 	*/
-	template <typename DataType, typename Compare=CompClass<DataType> >
-	class ThreadSafePQueue:public ThreadSafeQueue<DataType>
+	template <typename DataType, typename Compare=CompClass<DataType>, typename LockType=BaseLock >
+	class ThreadSafePQueue:public ThreadSafeQueue<DataType,LockType>
 	{
 	public:
 		/*!
@@ -86,51 +86,165 @@ namespace epl
 		/*!
 		Insert the new item into the priority queue.
 		@param[in] data The inserting data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
 		*/
-		virtual void Push(DataType const &data);
+		virtual bool Push(DataType const &data);
+
+		/*!
+		Insert the given items into the priority queue with a single lock acquisition.
+		@param[in] data The array of inserting data.
+		@param[in] count The number of items in the array.
+		@return the number of items taken from the front of the array.
+		*/
+		virtual size_t PushBatch(DataType const *data, size_t count);
+
+#if _MSC_VER>=MSVC100
+		/*!
+		Insert the new item into the priority queue by moving it.
+		@param[in] data The inserting data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool Push(DataType &&data);
+#endif //_MSC_VER>=MSVC100
+
+		/*!
+		Insert the new item into the priority queue by swapping it in.
+		@param[in,out] data The inserting data, left as default-constructed data if taken.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool PushSwap(DataType &data);
+
+	protected:
+		/*!
+		Drop the item with the lowest priority, the queue lock must be held.
+		*/
+		virtual void dropOldest();
+
+	private:
+		/*!
+		Insert the new item into the priority queue without locking.
+		@param[in] data The inserting data.
+		*/
+		void insertSorted(DataType const &data);
+
+		/*!
+		Find the position to insert the given item without locking.
+		@param[in] data The inserting data.
+		@return the index to insert the item at.
+		*/
+		size_t findInsertPos(DataType const &data) const;
 
 	};
 
-	template <typename DataType, typename Compare>
-	ThreadSafePQueue<DataType,Compare>::ThreadSafePQueue(LockPolicy lockPolicyType) :ThreadSafeQueue<DataType>(lockPolicyType)
+	template <typename DataType, typename Compare, typename LockType>
+	ThreadSafePQueue<DataType,Compare,LockType>::ThreadSafePQueue(LockPolicy lockPolicyType) :ThreadSafeQueue<DataType,LockType>(lockPolicyType)
 	{
 	}
-	template <typename DataType, typename Compare>
-	ThreadSafePQueue<DataType,Compare>::ThreadSafePQueue(const ThreadSafePQueue& b):ThreadSafeQueue<DataType>(b)
+	template <typename DataType, typename Compare, typename LockType>
+	ThreadSafePQueue<DataType,Compare,LockType>::ThreadSafePQueue(const ThreadSafePQueue& b):ThreadSafeQueue<DataType,LockType>(b)
 	{
 	}
-	template <typename DataType, typename Compare>
-	ThreadSafePQueue<DataType,Compare>::~ThreadSafePQueue()
+	template <typename DataType, typename Compare, typename LockType>
+	ThreadSafePQueue<DataType,Compare,LockType>::~ThreadSafePQueue()
 	{
 	}
 	
-	template <typename DataType, typename Compare>
-	ThreadSafePQueue<DataType,Compare> & ThreadSafePQueue<DataType,Compare>::operator=(const ThreadSafePQueue&b)
+	template <typename DataType, typename Compare, typename LockType>
+	ThreadSafePQueue<DataType,Compare,LockType> & ThreadSafePQueue<DataType,Compare,LockType>::operator=(const ThreadSafePQueue&b)
 	{
 		if(this != &b)
 		{
-			ThreadSafeQueue::operator =(b);
+			ThreadSafeQueue<DataType,LockType>::operator =(b);
 		}
 		return *this;
 	}
 
-	template <typename DataType, typename Compare>
-	void ThreadSafePQueue<DataType,Compare>::Push(DataType const & data)
+	template <typename DataType, typename Compare, typename LockType>
+	bool ThreadSafePQueue<DataType,Compare,LockType>::Push(DataType const & data)
 	{
-		LockObj lock(m_queueLock);
-		DataType* retVal=NULL;
-		if(m_queue.size())
-		{
-			size_t retIdx;
-			if(BinarySearch(data,&m_queue.at(0),m_queue.size(),Compare::CompFunc,retIdx))
-				EP_ASSERT_EXPR(0,_T("Same Object already in the Queue!!"));
-			m_queue.insert(m_queue.begin()+retIdx,data);
-		}
-		else
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		bool pushResult;
+		if(!this->admit(pushResult))
+			return pushResult;
+		insertSorted(data);
+		this->notifyNotEmpty();
+		return true;
+	}
+
+	template <typename DataType, typename Compare, typename LockType>
+	size_t ThreadSafePQueue<DataType,Compare,LockType>::PushBatch(DataType const *data, size_t count)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		size_t dataTrav;
+		for(dataTrav=0;dataTrav<count;dataTrav++)
 		{
-			m_queue.push_back(data);
+			bool pushResult;
+			if(!this->admit(pushResult))
+			{
+				if(!pushResult)
+					break;
+				continue;
+			}
+			insertSorted(data[dataTrav]);
 		}
+		if(dataTrav>0)
+			this->notifyNotEmpty();
+		return dataTrav;
+	}
+
+#if _MSC_VER>=MSVC100
+	template <typename DataType, typename Compare, typename LockType>
+	bool ThreadSafePQueue<DataType,Compare,LockType>::Push(DataType &&data)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		bool pushResult;
+		if(!this->admit(pushResult))
+			return pushResult;
+		size_t insertPos=findInsertPos(data);
+		this->m_queue.insert(this->m_queue.begin()+insertPos,std::move(data));
+		this->notifyNotEmpty();
+		return true;
+	}
+#endif //_MSC_VER>=MSVC100
 
+	template <typename DataType, typename Compare, typename LockType>
+	bool ThreadSafePQueue<DataType,Compare,LockType>::PushSwap(DataType &data)
+	{
+		InlineLockObj<LockType> lock(this->m_queueLock);
+		bool pushResult;
+		if(!this->admit(pushResult))
+			return pushResult;
+		size_t insertPos=findInsertPos(data);
+		this->m_queue.insert(this->m_queue.begin()+insertPos,DataType());
+		using std::swap;
+		swap(this->m_queue[insertPos],data);
+		this->notifyNotEmpty();
+		return true;
+	}
+
+	template <typename DataType, typename Compare, typename LockType>
+	void ThreadSafePQueue<DataType,Compare,LockType>::dropOldest()
+	{
+		if(!this->m_queue.empty())
+			this->m_queue.pop_back();
+	}
+
+	template <typename DataType, typename Compare, typename LockType>
+	void ThreadSafePQueue<DataType,Compare,LockType>::insertSorted(DataType const & data)
+	{
+		size_t insertPos=findInsertPos(data);
+		this->m_queue.insert(this->m_queue.begin()+insertPos,data);
+	}
+
+	template <typename DataType, typename Compare, typename LockType>
+	size_t ThreadSafePQueue<DataType,Compare,LockType>::findInsertPos(DataType const & data) const
+	{
+		if(this->m_queue.empty())
+			return 0;
+		size_t retIdx;
+		if(BinarySearch(data,&this->m_queue.at(0),this->m_queue.size(),Compare::CompFunc,retIdx))
+			EP_ASSERT_EXPR(0,_T("Same Object already in the Queue!!"));
+		return retIdx;
 	}
 }
 
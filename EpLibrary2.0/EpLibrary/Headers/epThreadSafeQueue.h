@@ -39,10 +39,11 @@ An Interface for Thread Safe Queue.
 #define __EP_THREAD_SAFE_QUEUE_H__
 #include "epLib.h"
 #include <vector>
-#include "epCriticalSectionEx.h"
-#include "epMutex.h"
-#include "epNoLock.h"
+#include <algorithm>
+#include "epInlineLock.h"
 #include "epException.h"
+#include "epEventEx.h"
+#include "epQueueBound.h"
 
 namespace epl
 {
@@ -50,8 +51,12 @@ namespace epl
 	/*! 
 	@class ThreadSafeQueue epThreadSafeQueue.h
 	@brief A class for Thread Safe Queue.
+
+	The lock is chosen by LockPolicy at runtime by default.
+	Give the lock type such as ThreadSafeQueue<DataType,CriticalSectionEx> to hold the lock within the queue,
+	so the lock calls are bound at compile time. (the lock policy given to the constructor is then ignored)
 	*/
-	template <typename DataType>
+	template <typename DataType, typename LockType=BaseLock>
 	class ThreadSafeQueue
 	{
 	public:
@@ -121,8 +126,65 @@ namespace epl
 		/*!
 		Insert the new item into the queue.
 		@param[in] data The inserting data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool Push(DataType const &data);
+
+		/*!
+		Insert the given items into the queue with a single lock acquisition.
+		@param[in] data The array of inserting data.
+		@param[in] count The number of items in the array.
+		@return the number of items taken from the front of the array.
+		@remark with OVERFLOW_POLICY_FAIL, the items from the first rejected one are not taken.
+		*/
+		virtual size_t PushBatch(DataType const *data, size_t count);
+
+#if _MSC_VER>=MSVC100
+		/*!
+		Insert the new item into the queue by moving it.
+		@param[in] data The inserting data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		*/
+		virtual bool Push(DataType &&data);
+#endif //_MSC_VER>=MSVC100
+
+		/*!
+		Insert the new item into the queue by swapping it in.
+		@param[in,out] data The inserting data, left as default-constructed data if taken.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark avoids the deep copy for the data with the cheap swap such as std::vector and std::string.
+		*/
+		virtual bool PushSwap(DataType &data);
+
+		/*!
+		Construct the new item from the given argument and insert it into the queue.
+		@param[in] arg1 The argument for the constructor of the data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark the data is constructed outside the lock, and moved or swapped in.
 		*/
-		virtual void Push(DataType const &data);
+		template <typename Arg1>
+		bool Emplace(Arg1 const &arg1);
+
+		/*!
+		Construct the new item from the given arguments and insert it into the queue.
+		@param[in] arg1 The first argument for the constructor of the data.
+		@param[in] arg2 The second argument for the constructor of the data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark the data is constructed outside the lock, and moved or swapped in.
+		*/
+		template <typename Arg1, typename Arg2>
+		bool Emplace(Arg1 const &arg1, Arg2 const &arg2);
+
+		/*!
+		Construct the new item from the given arguments and insert it into the queue.
+		@param[in] arg1 The first argument for the constructor of the data.
+		@param[in] arg2 The second argument for the constructor of the data.
+		@param[in] arg3 The third argument for the constructor of the data.
+		@return false if rejected by OVERFLOW_POLICY_FAIL, otherwise true.
+		@remark the data is constructed outside the lock, and moved or swapped in.
+		*/
+		template <typename Arg1, typename Arg2, typename Arg3>
+		bool Emplace(Arg1 const &arg1, Arg2 const &arg2, Arg3 const &arg3);
 
 		/*!
 		Erase the given item from the queue.
@@ -135,139 +197,282 @@ namespace epl
 		*/
 		virtual void Pop();
 
+		/*!
+		Remove up to given number of items from the front of the queue with a single lock acquisition.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@return the number of items removed.
+		*/
+		size_t PopBatch(DataType *retData, size_t maxCount);
+
+		/*!
+		Remove the first item from the queue if exists, with a single lock acquisition.
+		@param[out] retData The removed data.
+		@return true if removed, false if the queue is empty.
+		*/
+		bool TryPop(DataType &retData);
+
+		/*!
+		Remove the first item from the queue, and sleep while the queue is empty.
+		@param[out] retData The removed data.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return true if removed, false if timed out.
+		*/
+		bool PopWait(DataType &retData, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Remove up to given number of items from the front of the queue, and sleep while the queue is empty.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return the number of items removed, or 0 if timed out.
+		*/
+		size_t PopBatchWait(DataType *retData, size_t maxCount, unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Remove the first item from the queue if exists, by swapping it out.
+		@param[in,out] retData The removed data, its old content is left in the queue and destroyed.
+		@return true if removed, false if the queue is empty.
+		@remark avoids the deep copy for the data with the cheap swap such as std::vector and std::string.
+		*/
+		bool TryPopSwap(DataType &retData);
+
+		/*!
+		Call the given visitor for each item in the queue under the lock, from the front to the back.
+		@param[in] visitor The visitor called as visitor(DataType const &).
+		@return the visitor after visiting all items.
+		@remark the visitor must not access this queue.
+		*/
+		template <typename Visitor>
+		Visitor ForEach(Visitor visitor) const;
+
 		/*!
 		Clear the queue.
 		*/
 		void Clear();
 
+		/*!
+		Set the capacity of the queue and the policy when the queue is full.
+		@param[in] capacity the maximum number of items in the queue. (0 for unbounded)
+		@param[in] policy the overflow policy when the queue is full.
+		@remark with OVERFLOW_POLICY_BLOCK, the producer must not be the only consumer of this queue.
+		*/
+		void SetCapacity(size_t capacity, OverflowPolicy policy=OVERFLOW_POLICY_BLOCK);
+
+		/*!
+		Return the capacity of the queue.
+		@return the maximum number of items in the queue, or 0 if unbounded.
+		*/
+		size_t GetCapacity() const;
+
+		/*!
+		Return the policy when the queue is full.
+		@return the overflow policy.
+		*/
+		OverflowPolicy GetOverflowPolicy() const;
+
+		/*!
+		Return the highest number of items the queue held since the last reset.
+		@return the high-water mark.
+		*/
+		size_t GetHighWaterMark() const;
+
+		/*!
+		Reset the high-water mark to 0.
+		*/
+		void ResetHighWaterMark();
+
+		/*!
+		Return the number of items dropped or rejected by the overflow policy.
+		@return the number of items dropped or rejected.
+		*/
+		size_t GetDropCount() const;
+
+		/*!
+		Enable the contention profiling of the queue lock.
+		@param[in] name the name of the lock in the report.
+		@remark the statistics are reported by LOCK_PROFILE_INSTANCE.
+		@remark only the lock chosen by LockPolicy is recorded, not the one given as LockType.
+		*/
+		void SetLockProfileName(const TCHAR *name);
+
 		std::vector<DataType> GetQueue() const;
 
 	protected:
+		/*!
+		Update the high-water mark and wake the sleeping consumers after the push, the queue lock must be held.
+		*/
+		void notifyNotEmpty();
+
+		/*!
+		Apply the overflow policy before inserting the new item, the queue lock must be held.
+		@param[out] retPushResult the result for the producer if the new item is not to be inserted.
+		@return true if the new item is to be inserted, otherwise false.
+		@remark with OVERFLOW_POLICY_BLOCK, the queue lock is released while sleeping.
+		*/
+		bool admit(bool &retPushResult);
+
+		/*!
+		Drop the item to be removed the earliest, the queue lock must be held.
+		*/
+		virtual void dropOldest();
+
+		/*!
+		Remove up to given number of items from the front of the queue, the queue lock must be held.
+		@param[out] retData The array to receive the removed items.
+		@param[in] maxCount The maximum number of items to remove.
+		@return the number of items removed.
+		*/
+		virtual size_t popFront(DataType *retData, size_t maxCount);
+
+		/*!
+		Remove the item at given index of the queue, the queue lock must be held.
+		@param[in] index The index of the item to remove.
+		*/
+		virtual void eraseAt(size_t index);
+
+		/*!
+		Remove all items from the queue, the queue lock must be held.
+		*/
+		virtual void clearItems();
+
+		/*!
+		Sleep until the queue becomes non-empty or timed out, the queue lock must be held.
+		@param[in] startTick the tick count when the wait began.
+		@param[in] waitTimeInMilliSec the time-out interval from startTick, in milliseconds.
+		@return true if the queue is non-empty, false if timed out.
+		@remark the queue lock is released while sleeping, and held again when returned.
+		*/
+		bool waitNotEmpty(unsigned int startTick, unsigned int waitTimeInMilliSec);
+
+		/*!
+		Move out the given item to the destination, or copy when the move is not supported.
+		@param[in] src the source item.
+		@param[out] dst the destination.
+		*/
+		static void moveOut(DataType &src, DataType &dst);
+
+		/*!
+		Compact the popped items out of the front of the storage, the queue lock must be held.
+		@remark compacts only when the popped items outnumber the remaining ones, so Pop stays O(1) amortized.
+		*/
+		void compactFront();
+
+		/// the padding between the virtual table pointer and the members written by Push and Pop
+		EP_CACHE_LINE_PADDING(m_headPadding)
+
 		/// Actual queue structure
 		std::vector<DataType> m_queue;
 
+		/// the index of the first item in m_queue, the ones before it are already popped
+		/// (the derived class overriding popFront, eraseAt and clearItems keeps it 0)
+		size_t m_head;
+
+		/// not-empty event, created by the first consumer to sleep
+		EventEx *m_notEmptyEvent;
+
+		/// the number of consumers sleeping on the not-empty event
+		volatile long m_waiterCount;
+
+		/// the capacity bound
+		QueueBound m_bound;
+
 		/// lock
-		BaseLock *m_queueLock;
+		InlineLock<LockType> m_queueLock;
 
-		/// Lock Policy
-		LockPolicy m_lockPolicy;
+		/// the padding between the lock and the members of the subclass or the next object
+		EP_CACHE_LINE_PADDING(m_tailPadding)
 	};
 
 
-	template <typename DataType>
-	ThreadSafeQueue<DataType>::ThreadSafeQueue(LockPolicy lockPolicyType)
+	template <typename DataType, typename LockType>
+	ThreadSafeQueue<DataType,LockType>::ThreadSafeQueue(LockPolicy lockPolicyType) :m_queueLock(lockPolicyType)
 	{
-		m_lockPolicy=lockPolicyType;
-		switch(lockPolicyType)
-		{
-		case LOCK_POLICY_CRITICALSECTION:
-			m_queueLock=EP_NEW CriticalSectionEx();
-			break;
-		case LOCK_POLICY_MUTEX:
-			m_queueLock=EP_NEW Mutex();
-			break;
-		case LOCK_POLICY_NONE:
-			m_queueLock=EP_NEW NoLock();
-			break;
-		default:
-			m_queueLock=NULL;
-			break;
-		}
+		m_notEmptyEvent=NULL;
+		m_waiterCount=0;
+		m_head=0;
 	}
 
-	template <typename DataType>
-	ThreadSafeQueue<DataType>::ThreadSafeQueue(const ThreadSafeQueue& b)
+	template <typename DataType, typename LockType>
+	ThreadSafeQueue<DataType,LockType>::ThreadSafeQueue(const ThreadSafeQueue& b) :m_queueLock(b.m_queueLock)
 	{
-		m_queue=b.GetQueue();
-		m_lockPolicy=b.m_lockPolicy;
-		switch(m_lockPolicy)
-		{
-		case LOCK_POLICY_CRITICALSECTION:
-			m_queueLock=EP_NEW CriticalSectionEx();
-			break;
-		case LOCK_POLICY_MUTEX:
-			m_queueLock=EP_NEW Mutex();
-			break;
-		case LOCK_POLICY_NONE:
-			m_queueLock=EP_NEW NoLock();
-			break;
-		default:
-			m_queueLock=NULL;
-			break;
-		}
+		m_notEmptyEvent=NULL;
+		m_waiterCount=0;
+		b.m_queueLock.Lock();
+		m_queue.assign(b.m_queue.begin()+b.m_head,b.m_queue.end());
+		m_head=0;
+		m_bound=b.m_bound;
+		b.m_queueLock.Unlock();
 	}
 
-	template <typename DataType>
-	ThreadSafeQueue<DataType>::~ThreadSafeQueue()
+	template <typename DataType, typename LockType>
+	ThreadSafeQueue<DataType,LockType>::~ThreadSafeQueue()
 	{
-		m_queueLock->Lock();
+		m_queueLock.Lock();
 		m_queue.clear();
-		m_queueLock->Unlock();
-		if(m_queueLock)
-			EP_DELETE m_queueLock;
+		m_queueLock.Unlock();
+		if(m_notEmptyEvent)
+			EP_DELETE m_notEmptyEvent;
 	}
 
-	template <typename DataType>
-	std::vector<DataType> ThreadSafeQueue<DataType>::GetQueue() const
+	template <typename DataType, typename LockType>
+	std::vector<DataType> ThreadSafeQueue<DataType,LockType>::GetQueue() const
 	{
-		LockObj lock(m_queueLock);
-		return m_queue;
+		InlineSharedLockObj<LockType> lock(m_queueLock);
+		return std::vector<DataType>(m_queue.begin()+m_head,m_queue.end());
 	}
 
-	template <typename DataType>
-	bool ThreadSafeQueue<DataType>::IsEmpty() const
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::IsEmpty() const
 	{
-		LockObj lock(m_queueLock);
+		InlineSharedLockObj<LockType> lock(m_queueLock);
 		return m_queue.empty();
 	}
 	
-	template <typename DataType>
-	bool ThreadSafeQueue<DataType>::IsExist(DataType const &data) const
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::IsExist(DataType const &data) const
 	{
-		LockObj lock(m_queueLock);
-		if(m_queue.empty())
-			return false;
-
-		std::vector<DataType>::const_iterator iter;
-		for(iter=m_queue.begin();iter!=m_queue.end();iter++)
+		InlineSharedLockObj<LockType> lock(m_queueLock);
+		for(size_t queueTrav=m_head;queueTrav<m_queue.size();queueTrav++)
 		{
-			if((*iter)==data)
+			if(m_queue[queueTrav]==data)
 				return true;
 		}
 		return false;
 		
 	}
 
-	template <typename DataType>
-	void ThreadSafeQueue<DataType>::Clear()
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::Clear()
 	{
-		LockObj lock(m_queueLock);
-		m_queue.clear();
+		InlineLockObj<LockType> lock(m_queueLock);
+		clearItems();
+		m_bound.NotifyPopped();
 
 	}
 
-	template <typename DataType>
-	size_t ThreadSafeQueue<DataType>::Size() const
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::Size() const
 	{
-		LockObj lock(m_queueLock);
-		return m_queue.size();
+		InlineSharedLockObj<LockType> lock(m_queueLock);
+		return m_queue.size()-m_head;
 	}
 
-	template <typename DataType>
-	DataType &ThreadSafeQueue<DataType>::Front()
+	template <typename DataType, typename LockType>
+	DataType &ThreadSafeQueue<DataType,LockType>::Front()
 	{
-		LockObj lock(m_queueLock);
+		InlineLockObj<LockType> lock(m_queueLock);
 		if(m_queue.empty())
 		{
 			EP_ASSERT_EXPR(0,_T("Empty Queue"));
 		}
-		return m_queue.front();
+		return m_queue[m_head];
 	}
 
-	template <typename DataType>
-	DataType &ThreadSafeQueue<DataType>::Back()
+	template <typename DataType, typename LockType>
+	DataType &ThreadSafeQueue<DataType,LockType>::Back()
 	{
-		LockObj lock(m_queueLock);
+		InlineLockObj<LockType> lock(m_queueLock);
 		if(m_queue.empty())
 		{
 			EP_ASSERT_EXPR(0,_T("Empty Queue"));
@@ -275,67 +480,400 @@ namespace epl
 		return m_queue.back();
 	}
 
-	template <typename DataType>
-	void ThreadSafeQueue<DataType>::Push(DataType const & data)
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::Push(DataType const & data)
 	{
-		LockObj lock(m_queueLock);
+		InlineLockObj<LockType> lock(m_queueLock);
+		bool pushResult;
+		if(!admit(pushResult))
+			return pushResult;
 		m_queue.push_back(data);
+		notifyNotEmpty();
+		return true;
 	}
 
-	template <typename DataType>
-	bool ThreadSafeQueue<DataType>::Erase(DataType const &data)
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::PushBatch(DataType const *data, size_t count)
 	{
-		LockObj lock(m_queueLock);
-		std::vector<DataType>::iterator iter;
-		for(iter=m_queue.begin();iter!=m_queue.end();iter++)
+		InlineLockObj<LockType> lock(m_queueLock);
+		if(m_bound.GetCapacity()==0)
+		{
+			m_queue.insert(m_queue.end(),data,data+count);
+			if(count>0)
+				notifyNotEmpty();
+			return count;
+		}
+		size_t dataTrav;
+		for(dataTrav=0;dataTrav<count;dataTrav++)
 		{
-			if(*iter==data)
+			bool pushResult;
+			if(!admit(pushResult))
 			{
-				m_queue.erase(iter);
+				if(!pushResult)
+					break;
+				continue;
+			}
+			m_queue.push_back(data[dataTrav]);
+		}
+		if(dataTrav>0)
+			notifyNotEmpty();
+		return dataTrav;
+	}
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::Erase(DataType const &data)
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		for(size_t queueTrav=m_head;queueTrav<m_queue.size();queueTrav++)
+		{
+			if(m_queue[queueTrav]==data)
+			{
+				eraseAt(queueTrav-m_head);
+				m_bound.NotifyPopped();
 				return true;
 			}
 		}
 		return false;
 	}
 
-	template <typename DataType>
-	void ThreadSafeQueue<DataType>::Pop()
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::Pop()
 	{
-		LockObj lock(m_queueLock);
+		InlineLockObj<LockType> lock(m_queueLock);
 		if(m_queue.empty())
 		{
 			EP_ASSERT_EXPR(0,_T("Empty Queue"));
 		}
-		m_queue.erase(m_queue.begin());
+		eraseAt(0);
+		m_bound.NotifyPopped();
 	}
 
-	template <typename DataType>
-	ThreadSafeQueue<DataType> & ThreadSafeQueue<DataType>::operator=(const ThreadSafeQueue& b)
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::PopBatch(DataType *retData, size_t maxCount)
 	{
-		if(this != &b)
+		InlineLockObj<LockType> lock(m_queueLock);
+		size_t popCount=popFront(retData,maxCount);
+		m_bound.NotifyPopped();
+		return popCount;
+	}
+
+#if _MSC_VER>=MSVC100
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::Push(DataType &&data)
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		bool pushResult;
+		if(!admit(pushResult))
+			return pushResult;
+		m_queue.push_back(std::move(data));
+		notifyNotEmpty();
+		return true;
+	}
+#endif //_MSC_VER>=MSVC100
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::PushSwap(DataType &data)
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		bool pushResult;
+		if(!admit(pushResult))
+			return pushResult;
+		m_queue.push_back(DataType());
+		using std::swap;
+		swap(m_queue.back(),data);
+		notifyNotEmpty();
+		return true;
+	}
+
+	template <typename DataType, typename LockType>
+	template <typename Arg1>
+	bool ThreadSafeQueue<DataType,LockType>::Emplace(Arg1 const &arg1)
+	{
+		DataType data(arg1);
+#if _MSC_VER>=MSVC100
+		return Push(std::move(data));
+#else //_MSC_VER>=MSVC100
+		return PushSwap(data);
+#endif //_MSC_VER>=MSVC100
+	}
+
+	template <typename DataType, typename LockType>
+	template <typename Arg1, typename Arg2>
+	bool ThreadSafeQueue<DataType,LockType>::Emplace(Arg1 const &arg1, Arg2 const &arg2)
+	{
+		DataType data(arg1,arg2);
+#if _MSC_VER>=MSVC100
+		return Push(std::move(data));
+#else //_MSC_VER>=MSVC100
+		return PushSwap(data);
+#endif //_MSC_VER>=MSVC100
+	}
+
+	template <typename DataType, typename LockType>
+	template <typename Arg1, typename Arg2, typename Arg3>
+	bool ThreadSafeQueue<DataType,LockType>::Emplace(Arg1 const &arg1, Arg2 const &arg2, Arg3 const &arg3)
+	{
+		DataType data(arg1,arg2,arg3);
+#if _MSC_VER>=MSVC100
+		return Push(std::move(data));
+#else //_MSC_VER>=MSVC100
+		return PushSwap(data);
+#endif //_MSC_VER>=MSVC100
+	}
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::TryPop(DataType &retData)
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		if(m_queue.empty())
+			return false;
+		popFront(&retData,1);
+		m_bound.NotifyPopped();
+		return true;
+	}
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::PopWait(DataType &retData, unsigned int waitTimeInMilliSec)
+	{
+		unsigned int startTick=System::GetTickCount();
+		InlineLockObj<LockType> lock(m_queueLock);
+		if(!waitNotEmpty(startTick,waitTimeInMilliSec))
+			return false;
+		popFront(&retData,1);
+		m_bound.NotifyPopped();
+		return true;
+	}
+
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::PopBatchWait(DataType *retData, size_t maxCount, unsigned int waitTimeInMilliSec)
+	{
+		if(maxCount==0)
+			return 0;
+		unsigned int startTick=System::GetTickCount();
+		InlineLockObj<LockType> lock(m_queueLock);
+		if(!waitNotEmpty(startTick,waitTimeInMilliSec))
+			return 0;
+		size_t popCount=popFront(retData,maxCount);
+		m_bound.NotifyPopped();
+		return popCount;
+	}
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::TryPopSwap(DataType &retData)
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		if(m_queue.empty())
+			return false;
+		using std::swap;
+		swap(m_queue[m_head],retData);
+		eraseAt(0);
+		m_bound.NotifyPopped();
+		return true;
+	}
+
+	template <typename DataType, typename LockType>
+	template <typename Visitor>
+	Visitor ThreadSafeQueue<DataType,LockType>::ForEach(Visitor visitor) const
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		for(size_t visitTrav=m_head;visitTrav<m_queue.size();visitTrav++)
 		{
-			if(m_queueLock)
-			{
-				EP_DELETE m_queueLock;
-				m_queueLock=NULL;
-			}
-			m_lockPolicy=b.m_lockPolicy;
-			switch(m_lockPolicy)
+			visitor(m_queue[visitTrav]);
+		}
+		return visitor;
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::moveOut(DataType &src, DataType &dst)
+	{
+#if _MSC_VER>=MSVC100
+		dst=std::move(src);
+#else //_MSC_VER>=MSVC100
+		dst=src;
+#endif //_MSC_VER>=MSVC100
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::SetCapacity(size_t capacity, OverflowPolicy policy)
+	{
+		InlineLockObj<LockType> lock(m_queueLock);
+		m_bound.SetCapacity(capacity,policy);
+	}
+
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::GetCapacity() const
+	{
+		return m_bound.GetCapacity();
+	}
+
+	template <typename DataType, typename LockType>
+	OverflowPolicy ThreadSafeQueue<DataType,LockType>::GetOverflowPolicy() const
+	{
+		return m_bound.GetOverflowPolicy();
+	}
+
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::GetHighWaterMark() const
+	{
+		return m_bound.GetHighWaterMark();
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::ResetHighWaterMark()
+	{
+		m_bound.ResetHighWaterMark();
+	}
+
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::GetDropCount() const
+	{
+		return m_bound.GetDropCount();
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::SetLockProfileName(const TCHAR *name)
+	{
+		BaseLock *baseLock=m_queueLock.GetBaseLock();
+		if(baseLock)
+			baseLock->SetProfileName(name);
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::notifyNotEmpty()
+	{
+		m_bound.NotifyPushed(m_queue.size()-m_head);
+		// skip the kernel call when nobody sleeps, which is the common case
+		if(m_waiterCount>0)
+			m_notEmptyEvent->SetEvent();
+	}
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::admit(bool &retPushResult)
+	{
+		for(;;)
+		{
+			switch(m_bound.Admit(m_queue.size()-m_head))
 			{
-			case LOCK_POLICY_CRITICALSECTION:
-				m_queueLock=EP_NEW CriticalSectionEx();
-				break;
-			case LOCK_POLICY_MUTEX:
-				m_queueLock=EP_NEW Mutex();
-				break;
-			case LOCK_POLICY_NONE:
-				m_queueLock=EP_NEW NoLock();
+			case QueueBound::ADMISSION_ACCEPT:
+				return true;
+			case QueueBound::ADMISSION_WAIT:
+				// wake the consumers first, as the items of the unfinished batch may be the only ones queued
+				notifyNotEmpty();
+				m_bound.WaitNotFull(m_queueLock.GetBaseLock());
 				break;
+			case QueueBound::ADMISSION_DROP_OLDEST:
+				dropOldest();
+				return true;
+			case QueueBound::ADMISSION_REJECT:
+				retPushResult=false;
+				return false;
 			default:
-				m_queueLock=NULL;
-				break;
+				retPushResult=true;
+				return false;
 			}
-			m_queue=b.GetQueue();
+		}
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::dropOldest()
+	{
+		if(m_queue.size()>m_head)
+			eraseAt(0);
+	}
+
+	template <typename DataType, typename LockType>
+	size_t ThreadSafeQueue<DataType,LockType>::popFront(DataType *retData, size_t maxCount)
+	{
+		size_t itemCount=m_queue.size()-m_head;
+		size_t popCount=(itemCount<maxCount)?itemCount:maxCount;
+		for(size_t popTrav=0;popTrav<popCount;popTrav++)
+		{
+			moveOut(m_queue[m_head+popTrav],retData[popTrav]);
+#if _MSC_VER<MSVC100
+			// the copied-out item stays in the storage until the compaction, so free its content now
+			m_queue[m_head+popTrav]=DataType();
+#endif //_MSC_VER<MSVC100
+		}
+		m_head+=popCount;
+		compactFront();
+		return popCount;
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::eraseAt(size_t index)
+	{
+		if(index==0)
+		{
+			m_queue[m_head]=DataType();
+			m_head++;
+			compactFront();
+		}
+		else
+		{
+			m_queue.erase(m_queue.begin()+m_head+index);
+		}
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::clearItems()
+	{
+		m_queue.clear();
+		m_head=0;
+	}
+
+	template <typename DataType, typename LockType>
+	void ThreadSafeQueue<DataType,LockType>::compactFront()
+	{
+		if(m_head==m_queue.size())
+		{
+			// keep the capacity, so the drained queue refills without reallocation
+			m_queue.clear();
+			m_head=0;
+		}
+		else if(m_head*2>=m_queue.size())
+		{
+			m_queue.erase(m_queue.begin(),m_queue.begin()+m_head);
+			m_head=0;
+		}
+	}
+
+	template <typename DataType, typename LockType>
+	bool ThreadSafeQueue<DataType,LockType>::waitNotEmpty(unsigned int startTick, unsigned int waitTimeInMilliSec)
+	{
+		while(m_queue.empty())
+		{
+			unsigned int remainTime=WAITTIME_INIFINITE;
+			if(waitTimeInMilliSec!=WAITTIME_INIFINITE)
+			{
+				unsigned int elapsedTime=System::GetTickCount()-startTick;
+				if(elapsedTime>=waitTimeInMilliSec)
+					return false;
+				remainTime=waitTimeInMilliSec-elapsedTime;
+			}
+			if(!m_notEmptyEvent)
+				m_notEmptyEvent=EP_NEW EventEx(false,true);
+			// reset under the lock, so any push after this point raises it again
+			m_notEmptyEvent->ResetEvent();
+			m_waiterCount++;
+			m_queueLock.Unlock();
+			m_notEmptyEvent->WaitForEvent(remainTime);
+			m_queueLock.Lock();
+			m_waiterCount--;
+		}
+		return true;
+	}
+
+	template <typename DataType, typename LockType>
+	ThreadSafeQueue<DataType,LockType> & ThreadSafeQueue<DataType,LockType>::operator=(const ThreadSafeQueue& b)
+	{
+		if(this != &b)
+		{
+			m_queueLock=b.m_queueLock;
+			b.m_queueLock.Lock();
+			m_queue.assign(b.m_queue.begin()+b.m_head,b.m_queue.end());
+			m_head=0;
+			m_bound=b.m_bound;
+			b.m_queueLock.Unlock();
 		}
 		return *this;
 	}
@@ -0,0 +1,290 @@
+/*! 
+@file epTimerService.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Timer Service Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Timer Service.
+
+*/
+#ifndef __EP_TIMER_SERVICE_H__
+#define __EP_TIMER_SERVICE_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epBaseJob.h"
+#include "epBaseLock.h"
+#include "epKAryHeap.h"
+#include <vector>
+
+#ifndef TIMER_SERVICE_DEFAULT_RESOLUTION
+/// the default time in milliseconds of one tick of the timer wheel
+#define TIMER_SERVICE_DEFAULT_RESOLUTION 10
+#endif //TIMER_SERVICE_DEFAULT_RESOLUTION
+
+#ifndef TIMER_WHEEL_SLOT_BITS
+/// the number of bits of the slot index of each level of the timer wheel
+#define TIMER_WHEEL_SLOT_BITS 8
+#endif //TIMER_WHEEL_SLOT_BITS
+
+#ifndef TIMER_WHEEL_LEVEL_COUNT
+/// the number of the levels of the timer wheel, and the timers further than the last level are kept in the heap
+#define TIMER_WHEEL_LEVEL_COUNT 3
+#endif //TIMER_WHEEL_LEVEL_COUNT
+
+/// the number of the slots of each level of the timer wheel
+#define TIMER_WHEEL_SLOT_COUNT (1<<TIMER_WHEEL_SLOT_BITS)
+
+namespace epl
+{
+	class ThreadPool;
+	class TimerServiceThread;
+
+	/// the identifier of the timer scheduled, which is 0 if invalid
+	typedef unsigned __int64 TimerId;
+
+	/*! 
+	@class TimerService epTimerService.h
+	@brief A class that dispatches the jobs to the thread pool when their timers expire.
+
+	The timers are kept in the hierarchical timing wheel,
+	so scheduling and cancelling a timer are O(1) regardless of the number of the timers,
+	and only the timers further than the last level are kept in the K-ary heap until they come within the wheel.
+	The timer thread advances the wheel on every tick, and pushes the jobs of the expired timers to the pool.
+	@remark The timer expires on the first tick at or after its delay, so the accuracy is the resolution.
+	*/
+	class EP_LIBRARY TimerService
+	{
+		friend class TimerServiceThread;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the service and starts the timer thread
+		@param[in] pool the thread pool to push the jobs of the expired timers
+		@param[in] resolutionInMilliSec the time in milliseconds of one tick
+		*/
+		TimerService(ThreadPool *pool, unsigned int resolutionInMilliSec=TIMER_SERVICE_DEFAULT_RESOLUTION);
+
+		/*!
+		Default Destructor
+
+		Stops the timer thread, and releases the jobs of the timers not expired
+		*/
+		virtual ~TimerService();
+
+		/*!
+		Schedule the job to be pushed to the pool after given delay.
+		@param[in] job the job to push when the timer expires
+		@param[in] delayInMilliSec the delay in milliseconds
+		@return the identifier of the timer to cancel, or 0 if failed
+		@remark the job is retained until the timer expires or is cancelled.
+		*/
+		TimerId Schedule(BaseJob * const job, unsigned int delayInMilliSec);
+
+		/*!
+		Cancel the timer not expired yet.
+		@param[in] timerId the identifier of the timer
+		@return true if cancelled, false if already expired, cancelled or invalid
+		*/
+		bool Cancel(TimerId timerId);
+
+		/*!
+		Return the number of the timers not expired yet.
+		@return the number of the timers not expired yet
+		*/
+		size_t GetTimerCount() const;
+
+		/*!
+		Return the time of one tick.
+		@return the time in milliseconds of one tick
+		*/
+		unsigned int GetResolution() const;
+
+		/*!
+		Return the thread pool which the jobs are pushed to.
+		@return the thread pool
+		*/
+		ThreadPool *GetThreadPool() const;
+
+	private:
+		/// the location of the timer node
+		enum NodeLocation{
+			/// the node is free
+			NODE_LOCATION_FREE=0,
+			/// the node is in the slot of the wheel
+			NODE_LOCATION_WHEEL,
+			/// the node is in the heap
+			NODE_LOCATION_HEAP,
+		};
+
+		/*!
+		@struct TimerNode epTimerService.h
+		@brief The timer kept in the node array, linked in its slot by the node indices.
+		*/
+		struct TimerNode
+		{
+			/// the job to push when expired
+			BaseJob *job;
+			/// the tick when expired
+			__int64 expireTick;
+			/// the previous node in the slot, or the next free node
+			unsigned int prev;
+			/// the next node in the slot
+			unsigned int next;
+			/// the slot index within the whole wheel
+			unsigned int slot;
+			/// the generation of the node, increased whenever freed
+			unsigned int generation;
+			/// the location of the node
+			NodeLocation location;
+		};
+
+		/*!
+		@struct HeapKey epTimerService.h
+		@brief The key of the far timer in the heap, unique by the node index.
+		*/
+		struct HeapKey
+		{
+			/// the tick when expired
+			__int64 expireTick;
+			/// the node index
+			unsigned int nodeIdx;
+
+			bool operator==(const HeapKey &b) const
+			{
+				return expireTick==b.expireTick && nodeIdx==b.nodeIdx;
+			}
+			bool operator>(const HeapKey &b) const
+			{
+				return expireTick>b.expireTick || (expireTick==b.expireTick && nodeIdx>b.nodeIdx);
+			}
+			bool operator<(const HeapKey &b) const
+			{
+				return b>*this;
+			}
+		};
+
+		/*!
+		Return the current tick by the clock.
+		@return the current tick
+		*/
+		__int64 getClockTick() const;
+
+		/*!
+		Put the node into the wheel or the heap by its expire tick.
+		@param[in] nodeIdx the node index
+		*/
+		void place(unsigned int nodeIdx);
+
+		/*!
+		Remove the node from its slot.
+		@param[in] nodeIdx the node index
+		*/
+		void unlink(unsigned int nodeIdx);
+
+		/*!
+		Return the tick the timer thread should wake up at to process the timer given.
+		@param[in] nodeIdx the node index
+		@return the tick to wake up at
+		*/
+		__int64 getWakeTick(unsigned int nodeIdx) const;
+
+		/*!
+		Free the node.
+		@param[in] nodeIdx the node index
+		*/
+		void freeNode(unsigned int nodeIdx);
+
+		/*!
+		Advance the wheel up to the current tick by the clock.
+		@param[out] retJobList the jobs of the timers expired
+		@return the time in milliseconds to wait until the next tick to process
+		*/
+		unsigned int advance(std::vector<BaseJob*> &retJobList);
+
+		/*!
+		Advance the wheel by one tick.
+		@param[out] retJobList the jobs of the timers expired
+		*/
+		void tick(std::vector<BaseJob*> &retJobList);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the service
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		TimerService(const TimerService& b)
+		{
+			EP_ASSERT(0);
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		TimerService & operator=(const TimerService&b)
+		{
+			EP_ASSERT(0);
+			return *this;
+		}
+
+		/// the thread pool to push the jobs
+		ThreadPool *m_pool;
+		/// the time in milliseconds of one tick
+		unsigned int m_resolution;
+		/// the clock time in milliseconds when the service started
+		__int64 m_startMilliSec;
+		/// the last tick processed
+		__int64 m_currentTick;
+		/// the tick the timer thread wakes up at
+		__int64 m_wakeTick;
+		/// the timer nodes
+		std::vector<TimerNode> m_nodeList;
+		/// the first free node
+		unsigned int m_freeHead;
+		/// the first node of each slot of each level
+		std::vector<unsigned int> m_slotHeadList;
+		/// the number of the timers in the wheel
+		size_t m_wheelCount;
+		/// the far timers
+		KAryHeap<HeapKey,unsigned int,4> m_farHeap;
+		/// the lock for the timers
+		BaseLock *m_timerLock;
+		/// the timer thread
+		TimerServiceThread *m_thread;
+	};
+}
+
+#endif //__EP_TIMER_SERVICE_H__
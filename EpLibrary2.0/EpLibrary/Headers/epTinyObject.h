@@ -57,6 +57,11 @@ An Interface for Tiny Object.
 #include "epLib.h"
 #include "epSingletonHolder.h"
 #include "epThreadSafeClass.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 
 
 namespace epl {
@@ -76,6 +81,10 @@ namespace epl {
 #define MAX_TINY_OBJECT_SIZE 64
 #endif
 
+#ifndef TINY_OBJECT_MAGAZINE_SIZE
+#define TINY_OBJECT_MAGAZINE_SIZE 32
+#endif
+
 #ifndef UCHAR_MAX
 #define UCHAR_MAX     0xff      // maximum unsigned char value 
 #endif 
@@ -127,14 +136,41 @@ namespace epl {
 			return m_fragments.empty();
 		}
 	private:
+		/// the entry of the page map
+		struct PageEntry
+		{
+			/// the page number, or 0 if the entry is empty
+			size_t m_page;
+			/// the data of the fragment on the page
+			unsigned char *m_data;
+		};
+		/// the open-addressing hash table from the page to the fragments on it
+		typedef std::vector<PageEntry> PageMap;
+
 		void Release(void* p, CacheType type);
-		Fragment* VicinityFind(void* p);
+		// find the fragment owning the given block from the page map in constant time
+		Fragment* findFragment(void* p);
+		// record the index in the fragment, and map its pages to it
+		void registerFragment(size_t fragmentIdx);
+		void unregisterFragment(size_t fragmentIdx);
+		void setFragmentIndex(size_t fragmentIdx);
+		void insertPage(size_t page, unsigned char *data);
+		void removePage(size_t page, unsigned char *data);
+		void rehashPageMap(size_t capacity);
 		size_t m_blockSize;
 		unsigned char m_numBlocks;
 		typedef std::vector<Fragment> Fragments;
 		Fragments m_fragments;
 		Fragment* m_allocFragment;
 		Fragment* m_deallocFragment;
+		/// the shift of the page, whose size is the power of 2 not smaller than the fragment
+		size_t m_pageShift;
+		/// the page map
+		PageMap m_pageMap;
+		/// the number of the pages mapped
+		size_t m_pageCount;
+		/// the number of the entries mapped or deleted
+		size_t m_pageUsed;
 	};
 
 
@@ -143,24 +179,56 @@ namespace epl {
 	public:
 		TinyObjAllocator(
 			size_t fragmentSize, 
-			size_t maxObjectSize);
+			size_t maxObjectSize,
+			LockPolicy lockPolicyType=EP_LOCK_POLICY);
 		~TinyObjAllocator();
 
+		// the blocks are taken from and given to the magazine of the calling thread,
+		// and the pool lock is taken only to refill or flush the magazine in batch.
+		// the magazines only borrow the blocks from the shared pool, so any thread may deallocate the block.
 		void* Allocate(size_t numBytes);
 		void Deallocate(void* p, size_t size, CacheType type);
 		void Compress(CacheType type);
+		// call before the thread exits, otherwise its blocks stay cached until the allocator is destroyed.
+		void FlushThreadCache(CacheType type);
 
 
 	private:
 		TinyObjAllocator(const TinyObjAllocator&);
 		TinyObjAllocator& operator=(const TinyObjAllocator&);
 
+		/// the per-thread stack of the free blocks of one size
+		struct Magazine
+		{
+			/// the free blocks
+			void *m_blocks[TINY_OBJECT_MAGAZINE_SIZE];
+			/// the number of the free blocks
+			unsigned int m_count;
+		};
+		/// the magazines of one thread, indexed by the block size
+		typedef std::vector<Magazine> ThreadCache;
+
+		ThreadCache *getThreadCache();
+		void refill(Magazine &magazine, size_t numBytes);
+		void flush(Magazine &magazine, size_t numBytes, CacheType type, unsigned int flushCount);
+		void* allocateBlock(size_t numBytes);
+		void deallocateBlock(void* p, size_t numBytes, CacheType type);
+		void compressPool(CacheType type);
+
 		typedef std::vector<StaticAllocator> Pool;
 		Pool m_pool;
 		StaticAllocator* m_lastAlloc;
 		StaticAllocator* m_lastDealloc;
 		size_t m_fragmentSize;
 		size_t m_maxObjectSize;
+		/// the TLS index for the cache of the calling thread
+		unsigned long m_tlsIndex;
+		/// the caches of all threads
+		std::vector<ThreadCache*> m_threadCaches;
+		/// pool lock
+		BaseLock *m_poolLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
 	};
 
 	template
@@ -177,22 +245,19 @@ namespace epl {
 			MyTinyObjAllocator() : TinyObjAllocator(fragmentSize, maxTinyObjectSize)
 			{}
 		};
-		typedef ThreadSafeClass< MyTinyObjAllocator > MyThreadSafeClass;
 	public:
 		static void* operator new(size_t size)
 		{
-			typename MyThreadSafeClass::InstantLock lock;
 #if (MAX_TINY_OBJECT_SIZE != 0) && (DEFAULT_FRAGMENT_SIZE != 0)
-			return SingletonHolder<MyTinyObjAllocator>::Instance().Allocate(size);
+			return SingletonHolder<MyTinyObjAllocator,SINGLETON_LIFETIME_NEVER_DESTROY>::Instance().Allocate(size);
 #else
 			return ::operator new(size);
 #endif
 		}
 		static void operator delete(void* p, size_t size)
 		{
-			typename MyThreadSafeClass::InstantLock lock;
 #if (MAX_TINY_OBJECT_SIZE != 0) && (DEFAULT_FRAGMENT_SIZE != 0)
-			SingletonHolder<MyTinyObjAllocator>::Instance().Deallocate(p, size, cacheType);
+			SingletonHolder<MyTinyObjAllocator,SINGLETON_LIFETIME_NEVER_DESTROY>::Instance().Deallocate(p, size, cacheType);
 #else
 			::operator delete(p, size);
 #endif
@@ -200,9 +265,20 @@ namespace epl {
 
 		static void Compress()
 		{
-			typename MyThreadSafeClass::InstantLock lock;
 #if (MAX_TINY_OBJECT_SIZE != 0) && (DEFAULT_FRAGMENT_SIZE != 0)
-			SingletonHolder<MyTinyObjAllocator>::Instance().Compress(cacheType);
+			SingletonHolder<MyTinyObjAllocator,SINGLETON_LIFETIME_NEVER_DESTROY>::Instance().Compress(cacheType);
+#else
+#endif
+		}
+
+		/*!
+		Give back the blocks cached by the calling thread to the shared pool.
+		@remark call before the thread exits.
+		*/
+		static void FlushThreadCache()
+		{
+#if (MAX_TINY_OBJECT_SIZE != 0) && (DEFAULT_FRAGMENT_SIZE != 0)
+			SingletonHolder<MyTinyObjAllocator,SINGLETON_LIFETIME_NEVER_DESTROY>::Instance().FlushThreadCache(cacheType);
 #else
 #endif
 		}
@@ -0,0 +1,215 @@
+/*! 
+@file epUdsIpcClient.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Unix Domain Socket IPC Client Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Unix Domain Socket IPC Client.
+
+*/
+#ifndef __EP_UDS_IPC_CLIENT_H__
+#define __EP_UDS_IPC_CLIENT_H__
+#include "epLib.h"
+#include "epThread.h"
+#include "epIpcClientInterfaces.h"
+#include "epUdsIpcConf.h"
+
+#if defined(EP_PLATFORM_LINUX)
+
+namespace epl{
+	/*! 
+	@class UdsIpcClient epUdsIpcClient.h
+	@brief A class for IPC Client over the Unix domain socket.
+
+	The messages are read in place on the event loop of the thread of this instance,
+	and the write is sent directly from the caller unless the socket is full,
+	in which case it is queued and sent with the other queued messages by one send.
+	*/
+	class EP_LIBRARY UdsIpcClient:public Thread, public IpcClientInterface
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the IPC Client
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdsIpcClient(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Client
+		*/
+		virtual ~UdsIpcClient();
+
+		/*!
+		Get the pipe name of server
+		@return the pipe name in string
+		*/
+		virtual epl::EpTString GetFullPipeName() const;
+
+		/*!
+		Set the Callback Object for the server.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		virtual void SetCallbackObject(IpcClientCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object of server
+		@return the current Callback Object
+		*/
+		virtual IpcClientCallbackInterface *GetCallbackObject();
+
+		/*!
+		Connect to the server
+		@param[in] ops the client options
+		@param[in] waitTimeInMilliSec the wait time for the server to accept (0 for the wait time of the options)
+		@return the status of the connection
+		@remark the domain of the options is ignored.
+		*/
+		virtual ConnectStatus Connect(const IpcClientOps &ops=IpcClientOps::defaultIpcClientOps, unsigned int waitTimeInMilliSec=0);
+
+		/*!
+		Disconnect from the server
+		*/
+		virtual void Disconnect();
+
+		/*!
+		Check if the client is connected to server
+		@return true if connected, otherwise false
+		*/
+		virtual bool IsConnected() const;
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Get the maximum read data byte size
+		@return the maximum read data byte size
+		*/
+		virtual unsigned int GetMaxReadDataByteSize() const;
+
+		/*!
+		Write data to the pipe
+		@param[in] data the data to write
+		@param[in] dataByteSize byte size of the data
+		@remark the write is reported to OnWriteComplete once sent to the socket,
+		        which is before return unless the socket is full.
+		*/
+		virtual void Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@remark the segments are sent without the copy unless the message is queued.
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize the byte size of the data to write
+		@return the write element with m_dataSize set
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize);
+
+		/*!
+		Write the pooled write buffer to the pipe
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, and it is queued as it is when the socket is full.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem);
+
+	protected:
+		/*!
+		Handle the events of the socket until the connection is closed.
+		*/
+		virtual void execute();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		UdsIpcClient(const UdsIpcClient & b):Thread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		UdsIpcClient &operator=(const UdsIpcClient & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Connect the socket to the server
+		@param[in] waitTimeInMilliSec the wait time while the backlog of the server is full
+		@param[out] retStatus set to the status of the connection
+		@return the connected socket, or -1 if failed.
+		*/
+		int connectSocket(unsigned int waitTimeInMilliSec, ConnectStatus &retStatus);
+
+		/*!
+		Report the result of the send.
+		@param[in] status the status of the send.
+		@param[in] dataByteSize the byte size of the message.
+		*/
+		void reportSend(UdsIpcSendStatus status, unsigned int dataByteSize);
+
+		/*!
+		Wait for the thread of this instance and close the connection
+		*/
+		void closeConnection();
+
+		/// IPC client options
+		IpcClientOps m_options;
+		/// Name of the pipe
+		EpTString m_pipeName;
+		/// Lock policy
+		LockPolicy m_lockPolicy;
+		/// the connection
+		UdsIpcChannel m_channel;
+		/// the event loop
+		int m_epoll;
+		/// the pool set of the buffers (created at Connect)
+		IpcBufferPoolSet *m_bufferPoolSet;
+	};
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
+#endif //__EP_UDS_IPC_CLIENT_H__
@@ -0,0 +1,301 @@
+/*! 
+@file epUdsIpcConf.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Unix Domain Socket IPC Configuration Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Unix Domain Socket IPC Configuration.
+
+*/
+#ifndef __EP_UDS_IPC_CONF_H__
+#define __EP_UDS_IPC_CONF_H__
+#include "epLib.h"
+#include "epIpcConf.h"
+
+#if defined(EP_PLATFORM_LINUX)
+#include <deque>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+using namespace std;
+
+namespace epl
+{
+
+/// the prefix of the name of the abstract socket address of the server
+#define UDS_IPC_NAME_PREFIX _T("EpUdsIpc_")
+/// the maximum length of the name of the abstract socket address
+#define UDS_IPC_MAX_NAME_LENGTH 107
+/// the minimum byte size of the read buffer, so one receive takes many small messages
+#define UDS_IPC_MIN_READ_BUFFER_BYTE_SIZE 65536
+/// the maximum number of the queued messages gathered into one send
+#define UDS_IPC_SEND_BATCH_COUNT 64
+/// the maximum number of the segments sent directly without being gathered first
+#define UDS_IPC_MAX_SEGMENT_COUNT 15
+/// the number of the events taken by one wait of the event loop
+#define UDS_IPC_EPOLL_EVENT_COUNT 64
+/// the backlog of the listening socket
+#define UDS_IPC_LISTEN_BACKLOG 128
+
+#ifndef PIPE_UNLIMITED_INSTANCES
+/// the maximum instances meant to be unlimited
+#define PIPE_UNLIMITED_INSTANCES 255
+#endif //PIPE_UNLIMITED_INSTANCES
+
+	/// Enumeration for the result of the send
+	typedef enum _udsIpcSendStatus{
+		/// The message is sent to the socket
+		UDS_IPC_SEND_STATUS_COMPLETED=0,
+		/// The message is queued and sent when the socket is writable
+		UDS_IPC_SEND_STATUS_QUEUED,
+		/// The message is rejected since the queue is full
+		UDS_IPC_SEND_STATUS_QUEUE_FULL,
+		/// The message is not sent since the connection is closed
+		UDS_IPC_SEND_STATUS_FAILED,
+	}UdsIpcSendStatus;
+
+	/*! 
+	@struct UdsIpcSendItem epUdsIpcConf.h
+	@brief A struct for the message queued to be sent.
+	*/
+	struct UdsIpcSendItem{
+		/// the length header of the frame
+		unsigned int m_header;
+		/// the element holding the data
+		PipeWriteElem *m_elem;
+	};
+
+	/*! 
+	@class UdsIpcChannel epUdsIpcConf.h
+	@brief A class for one end of the Unix domain socket connection.
+
+	Each message is sent as the frame of the length header and the data over the stream socket.
+	The message is sent directly from the caller while nothing is queued,
+	and otherwise queued in the pooled buffer and gathered with the other queued messages into one send,
+	when the event loop finds the socket writable.
+	The receive reads as much as the buffer holds, and the messages are read in place,
+	except the message longer than the buffer, which is read into the buffer from the pool set.
+	*/
+	class EP_LIBRARY UdsIpcChannel{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the channel
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdsIpcChannel(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Close the channel
+		*/
+		virtual ~UdsIpcChannel();
+
+		/*!
+		Make the abstract socket address of the given name.
+		@param[in] name the name of the address.
+		@param[out] retAddress set to the address.
+		@param[out] retAddressByteSize set to the byte size of the address.
+		@return true if successful, false if the name is too long.
+		*/
+		static bool MakeAddress(const TCHAR *name, sockaddr_un &retAddress, socklen_t &retAddressByteSize);
+
+		/*!
+		Attach the channel to the connected socket.
+		@param[in] socket the non-blocking socket connected, owned by the channel.
+		@param[in] readByteSize the byte size of the message read in place.
+		@param[in] maxMessageByteSize the maximum byte size of the message read.
+		@param[in] writeQueueCapacity the maximum number of the queued messages (0 for unbounded).
+		@param[in] bufferPoolSet the pool set to acquire the buffers of the queued and the long messages from.
+		*/
+		void Attach(int socket, unsigned int readByteSize, unsigned int maxMessageByteSize, unsigned int writeQueueCapacity, IpcBufferPoolSet *bufferPoolSet);
+
+		/*!
+		Close the socket and release the buffers.
+		@remark the messages still queued are dropped without being reported.
+		*/
+		void Close();
+
+		/*!
+		Check if the channel is attached.
+		@return true if attached, otherwise false.
+		*/
+		bool IsOpened() const;
+
+		/*!
+		Return the socket of the channel.
+		@return the socket, or -1 if not attached.
+		*/
+		int GetSocket() const;
+
+		/*!
+		Send the segments as one message.
+		@param[in] segmentList the segments to gather.
+		@param[in] segmentCount the number of the segments.
+		@param[in] byteSize the byte size of all segments.
+		@return the status of the send.
+		@remark the segments are copied into the pooled buffer when queued.
+		*/
+		UdsIpcSendStatus Send(const IpcWriteSegment *segmentList, unsigned int segmentCount, unsigned int byteSize);
+
+		/*!
+		Send the element as one message.
+		@param[in] elem the element to send, whose ownership is taken.
+		@return the status of the send.
+		@remark the element is queued as it is, and released once sent or failed.
+		*/
+		UdsIpcSendStatus SendOwned(PipeWriteElem *elem);
+
+		/*!
+		Send the queued messages until the socket is full.
+		@param[out] retSentByteSizes the byte sizes of the messages sent are appended.
+		@return false if the connection failed, otherwise true.
+		*/
+		bool Flush(vector<unsigned int> &retSentByteSizes);
+
+		/*!
+		Drop all queued messages.
+		@param[out] retDroppedByteSizes the byte sizes of the messages dropped are appended.
+		*/
+		void DropQueue(vector<unsigned int> &retDroppedByteSizes);
+
+		/*!
+		Receive from the socket into the free space of the buffer.
+		@return the byte size received, 0 if nothing to receive, or -1 if the connection is closed.
+		*/
+		int Fill();
+
+		/*!
+		Return the message received without removing it.
+		@param[out] retData set to the data of the message in place, or NULL if the message exceeds the maximum byte size.
+		@param[out] retByteSize set to the byte size of the message.
+		@param[out] retStatus set to the status of the read.
+		@return true if the message is returned, false if more data is to be received.
+		*/
+		bool Peek(const char *&retData, unsigned int &retByteSize, ReadStatus &retStatus);
+
+		/*!
+		Remove the message returned by the last Peek.
+		*/
+		void Pop();
+
+		/*!
+		Shut down both directions of the connection, so the event loop is woken with the hang up.
+		*/
+		void Shutdown();
+
+		/*!
+		Check if the connection is shut down.
+		@return true if shut down, otherwise false.
+		*/
+		bool IsClosed() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		UdsIpcChannel(const UdsIpcChannel & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		UdsIpcChannel &operator=(const UdsIpcChannel & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Send the frame directly to the socket while nothing is queued.
+		@param[in] vectorList the vectors of the frame including the header.
+		@param[in] vectorCount the number of the vectors.
+		@param[in] frameByteSize the byte size of the frame.
+		@return the byte size sent, or -1 if the connection failed.
+		*/
+		int sendDirect(struct iovec *vectorList, unsigned int vectorCount, unsigned int frameByteSize);
+
+		/*!
+		Copy the segments into the element.
+		@param[in] elem the element to copy into.
+		@param[in] segmentList the segments to gather.
+		@param[in] segmentCount the number of the segments.
+		*/
+		void gather(PipeWriteElem *elem, const IpcWriteSegment *segmentList, unsigned int segmentCount);
+
+		/*!
+		Queue the element behind the messages queued.
+		@param[in] elem the element to queue.
+		@param[in] sentByteSize the byte size of the frame already sent directly.
+		*/
+		void queue(PipeWriteElem *elem, unsigned int sentByteSize);
+
+		/// the socket
+		int m_socket;
+		/// the flag whether the connection is shut down
+		volatile long m_isClosed;
+		/// the maximum byte size of the message read
+		unsigned int m_maxMessageByteSize;
+		/// the maximum number of the queued messages (0 for unbounded)
+		unsigned int m_writeQueueCapacity;
+		/// the pool set of the buffers
+		IpcBufferPoolSet *m_bufferPoolSet;
+
+		/// the messages queued
+		deque<UdsIpcSendItem> m_sendQueue;
+		/// the byte size of the frame at the front of the queue already sent
+		unsigned int m_sendOffset;
+		/// the lock for the send, so many threads can send
+		BaseLock *m_sendLock;
+
+		/// the read buffer
+		char *m_recvBuffer;
+		/// the byte size of the read buffer
+		unsigned int m_recvBufferByteSize;
+		/// the offset of the data not consumed in the read buffer
+		unsigned int m_recvHead;
+		/// the offset of the end of the data received in the read buffer
+		unsigned int m_recvTail;
+		/// the byte size of the frame returned by the last Peek
+		unsigned int m_peekByteSize;
+		/// the message longer than the read buffer being received
+		PipeWriteElem *m_longMessage;
+		/// the byte size of the long message received
+		unsigned int m_longByteSize;
+		/// the byte size of the message exceeding the maximum byte size left to discard
+		unsigned int m_skipByteSize;
+	};
+}
+#endif //defined(EP_PLATFORM_LINUX)
+#endif //__EP_UDS_IPC_CONF_H__
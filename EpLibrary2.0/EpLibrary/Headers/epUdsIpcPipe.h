@@ -0,0 +1,201 @@
+/*! 
+@file epUdsIpcPipe.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Unix Domain Socket IPC Pipe Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Unix Domain Socket IPC Pipe.
+
+*/
+#ifndef __EP_UDS_IPC_PIPE_H__
+#define __EP_UDS_IPC_PIPE_H__
+#include "epLib.h"
+#include "epSmartObject.h"
+#include "epIpcServerInterfaces.h"
+#include "epUdsIpcConf.h"
+
+#if defined(EP_PLATFORM_LINUX)
+
+namespace epl{
+
+	/*! 
+	@class UdsIpcPipe epUdsIpcPipe.h
+	@brief A class for the connection of the Unix domain socket IPC Server.
+
+	The pipe has no thread of its own, and is read and flushed on the event loop of the server.
+	*/
+	class EP_LIBRARY UdsIpcPipe:public IpcInterface, public SmartObject{
+		friend class UdsIpcServer;
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the Pipe
+		@param[in] socket the socket accepted, owned by the pipe
+		@param[in] options the options of the server
+		@param[in] bufferPoolSet the pool set of the buffers shared by all pipes
+		@param[in] lockPolicyType The lock policy
+		*/
+		UdsIpcPipe(int socket, const IpcServerOps &options, IpcBufferPoolSet *bufferPoolSet, epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Pipe
+		*/
+		virtual ~UdsIpcPipe();
+
+		/*!
+		Write data to the pipe
+		@param[in] data the data to write
+		@param[in] dataByteSize byte size of the data
+		@remark the write is reported to OnWriteComplete once sent to the socket,
+		        which is before return unless the socket is full.
+		*/
+		virtual void Write(char *data,unsigned int dataByteSize);
+
+		/*!
+		Write the segments to the pipe as one message
+		@param[in] segmentList the segments to gather
+		@param[in] segmentCount the number of the segments
+		@remark the segments are sent without the copy unless the message is queued.
+		*/
+		virtual void Write(const IpcWriteSegment *segmentList,unsigned int segmentCount);
+
+		/*!
+		Acquire the pooled write buffer to fill and pass to WriteOwned
+		@param[in] dataByteSize the byte size of the data to write
+		@return the write element with m_dataSize set
+		@remark the element is owned by the caller until passed to WriteOwned, or released by ReleaseObj.
+		*/
+		virtual PipeWriteElem *AcquireWriteBuffer(unsigned int dataByteSize);
+
+		/*!
+		Write the pooled write buffer to the pipe
+		@param[in] elem the write element acquired by AcquireWriteBuffer
+		@remark the ownership of the element is taken, and it is queued as it is when the socket is full.
+		*/
+		virtual void WriteOwned(PipeWriteElem *elem);
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Check if the connection is alive
+		@return true if the connection is alive otherwise false
+		*/
+		virtual bool IsConnectionAlive() const;
+
+		/*!
+		Kill the connection
+		@remark the connection is finished and reported to OnDisconnect on the event loop.
+		*/
+		virtual void KillConnection();
+
+		/*!
+		Set the Callback Object for the pipe.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		virtual void SetCallbackObject(IpcServerCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object of the pipe
+		@return the current Callback Object
+		*/
+		virtual IpcServerCallbackInterface *GetCallbackObject();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		UdsIpcPipe(const UdsIpcPipe & b):SmartObject(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		UdsIpcPipe &operator=(const UdsIpcPipe & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Handle the events of the socket on the event loop.
+		@param[in] events the events of the socket.
+		*/
+		void onEvent(unsigned int events);
+
+		/*!
+		Report the new connection and start receiving the events.
+		@param[in] epoll the event loop to register the socket to.
+		@return true if successful, otherwise false.
+		*/
+		bool accept(int epoll);
+
+		/*!
+		Report the result of the send.
+		@param[in] status the status of the send.
+		@param[in] dataByteSize the byte size of the message.
+		*/
+		void reportSend(UdsIpcSendStatus status, unsigned int dataByteSize);
+
+		/*!
+		Shut down the connection and report the disconnection.
+		@remark the messages still queued are reported as failed.
+		*/
+		void finish();
+
+		/*!
+		Check if the connection is finished.
+		@return true if finished, otherwise false
+		*/
+		bool isFinished() const;
+
+		/// IPC server options
+		IpcServerOps m_options;
+		/// the connection
+		UdsIpcChannel m_channel;
+		/// the pool set of the buffers
+		IpcBufferPoolSet *m_bufferPoolSet;
+		/// the byte sizes of the messages sent or dropped, reported by the event loop
+		vector<unsigned int> m_reportByteSizes;
+		/// the flag whether the connection is finished
+		volatile long m_isFinished;
+	};
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
+#endif //__EP_UDS_IPC_PIPE_H__
@@ -0,0 +1,202 @@
+/*! 
+@file epUdsIpcServer.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Unix Domain Socket IPC Server Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Unix Domain Socket IPC Server.
+
+*/
+#ifndef __EP_UDS_IPC_SERVER_H__
+#define __EP_UDS_IPC_SERVER_H__
+#include "epLib.h"
+#include "epThread.h"
+#include "epIpcServerInterfaces.h"
+#include "epUdsIpcConf.h"
+#include "epUdsIpcPipe.h"
+
+#if defined(EP_PLATFORM_LINUX)
+#include <vector>
+using namespace std;
+
+namespace epl{
+	/*! 
+	@class UdsIpcServer epUdsIpcServer.h
+	@brief A class for IPC Server over the Unix domain socket.
+
+	The server listens on the abstract socket address of the pipe name,
+	and one event loop on the thread of the server accepts, reads and flushes all connections by epoll.
+	The callbacks are made on the event loop, so the callback pool of the options is ignored.
+	The transport is local to the machine, so the domain of the options is ignored.
+	*/
+	class EP_LIBRARY UdsIpcServer:public Thread,public IpcServerInterface{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the IPC Server
+		@param[in] lockPolicyType lock policy
+		*/
+		UdsIpcServer(epl::LockPolicy lockPolicyType=epl::EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the Server
+		*/
+		virtual ~UdsIpcServer();
+
+		/*!
+		Get the pipe name of server
+		@return the pipe name in string
+		*/
+		virtual epl::EpTString GetFullPipeName() const;
+
+		/*!
+		Get the Maximum Instances of server
+		@return the Maximum Instances
+		*/
+		virtual unsigned int GetMaximumInstances() const;
+
+		/*!
+		Set the Callback Object for the server.
+		@param[in] callBackObj The Callback Object to set.
+		*/
+		virtual void SetCallbackObject(IpcServerCallbackInterface *callBackObj);
+
+		/*!
+		Get the Callback Object of server
+		@return the current Callback Object
+		*/
+		virtual IpcServerCallbackInterface *GetCallbackObject();
+
+		/*!
+		Start the server
+		@param[in] ops the server options
+		@return true if successfully started otherwise false
+		@remark the domain and the callback pools of the options are ignored.
+		*/
+		virtual bool StartServer(const IpcServerOps &ops=IpcServerOps::defaultIpcServerOps);
+
+		/*!
+		Stop the server
+		*/
+		virtual void StopServer();
+
+		/*!
+		Check if the server is started
+		@return true if the server is started otherwise false
+		*/
+		virtual bool IsServerStarted() const;
+
+		/*!
+		Terminate all clients' connection.
+		*/
+		virtual void ShutdownAllClient();
+
+		/*!
+		Get the maximum write data byte size
+		@return the maximum write data byte size
+		*/
+		virtual unsigned int GetMaxWriteDataByteSize() const;
+
+		/*!
+		Get the maximum read data byte size
+		@return the maximum read data byte size
+		*/
+		virtual unsigned int GetMaxReadDataByteSize() const;
+
+	private:
+		/*!
+		Event Loop Function
+		*/
+		virtual void execute();
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		UdsIpcServer(const UdsIpcServer & b):Thread(b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		UdsIpcServer &operator=(const UdsIpcServer & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Accept the connections waiting on the listening socket
+		*/
+		void acceptConnections();
+
+		/*!
+		Actually close the listening socket and the event loop
+		*/
+		void stopServer();
+
+		/*!
+		Remove and release the instances
+		@param[in] isAll the flag whether to remove all instances, otherwise only the finished instances are removed
+		*/
+		void removeInstances(bool isAll);
+
+	private:
+		/// pipe list
+		vector<UdsIpcPipe*> m_pipes; 
+		/// flag whether the server is started
+		bool m_started;
+		/// flag whether the server is stopping
+		volatile bool m_isStopping;
+		/// IPC server options
+		IpcServerOps m_options;
+		/// Name of the pipe
+		EpTString m_pipeName;
+		/// Lock policy
+		LockPolicy m_lockPolicy;
+		/// pipe list lock
+		BaseLock *m_pipesLock;
+		/// the listening socket
+		int m_listenSocket;
+		/// the event loop
+		int m_epoll;
+		/// the event to wake the event loop
+		int m_wakeEvent;
+		/// the pool set of the buffers shared by all instances
+		IpcBufferPoolSet *m_bufferPoolSet;
+	};
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
+#endif //__EP_UDS_IPC_SERVER_H__
@@ -0,0 +1,131 @@
+/*! 
+@file epUnicodeHelper.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Unicode Helper Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the Unicode Helper.
+
+*/
+#ifndef __EP_UNICODE_HELPER_H__
+#define __EP_UNICODE_HELPER_H__
+#include "epLib.h"
+#include "epLocale.h"
+
+namespace epl
+{
+	/*!
+	@class UnicodeHelper epUnicodeHelper.h
+	@brief A class for validating and transcoding between the UTF-8 and the UTF-16.
+
+	The runs of the ASCII characters are validated and transcoded with the SSE2 (or the AVX2 if supported),
+	and the other characters are decoded one by one.
+	Each byte of the invalid UTF-8 sequences and each unpaired surrogate are replaced with U+FFFD.
+	*/
+	class EP_LIBRARY UnicodeHelper
+	{
+	public:
+		/*!
+		Return the flag whether the given bytes are all ASCII characters
+		@param[in] src the bytes to check
+		@param[in] byteSize the byte size of the bytes
+		@return true if all ASCII characters, otherwise false
+		*/
+		static bool IsAscii(const char *src, size_t byteSize);
+
+		/*!
+		Return the flag whether the given UTF-16 characters are all ASCII characters
+		@param[in] src the characters to check
+		@param[in] charCount the number of the characters
+		@return true if all ASCII characters, otherwise false
+		*/
+		static bool IsAscii(const wchar_t *src, size_t charCount);
+
+		/*!
+		Return the flag whether the given bytes are the valid UTF-8
+		@param[in] src the bytes to check
+		@param[in] byteSize the byte size of the bytes
+		@return true if valid, otherwise false
+		@remark the overlong forms, the surrogates and the code points over U+10FFFF are invalid.
+		*/
+		static bool ValidateUtf8(const char *src, size_t byteSize);
+
+		/*!
+		Return the flag whether the given characters are the valid UTF-16
+		@param[in] src the characters to check
+		@param[in] charCount the number of the characters
+		@return true if no unpaired surrogate is found, otherwise false
+		*/
+		static bool ValidateUtf16(const wchar_t *src, size_t charCount);
+
+		/*!
+		Transcode the given UTF-8 bytes to the UTF-16
+		@param[in] src the UTF-8 bytes to transcode
+		@param[in] byteSize the byte size of the bytes
+		@param[out] retDest the buffer to write the UTF-16 characters, which must hold byteSize characters at least
+		@return the number of the UTF-16 characters written
+		@remark the characters are not null-terminated, and each invalid byte is written as U+FFFD.
+		*/
+		static size_t Utf8ToUtf16(const char *src, size_t byteSize, wchar_t *retDest);
+
+		/*!
+		Transcode the given UTF-16 characters to the UTF-8
+		@param[in] src the UTF-16 characters to transcode
+		@param[in] charCount the number of the characters
+		@param[out] retDest the buffer to write the UTF-8 bytes, which must hold charCount*3 bytes at least
+		@return the byte size of the UTF-8 bytes written
+		@remark the bytes are not null-terminated, and each unpaired surrogate is written as U+FFFD.
+		*/
+		static size_t Utf16ToUtf8(const wchar_t *src, size_t charCount, char *retDest);
+
+		/*!
+		Transcode the given UTF-8 string to the UTF-16
+		@param[in] src the UTF-8 string to transcode
+		@return the UTF-16 string
+		*/
+		static EpWString Utf8ToUtf16(const EpString &src);
+
+		/*!
+		Transcode the given UTF-16 string to the UTF-8
+		@param[in] src the UTF-16 string to transcode
+		@return the UTF-8 string
+		*/
+		static EpString Utf16ToUtf8(const EpWString &src);
+
+		/*!
+		Return the flag whether the ASCII runs are processed with the SIMD instructions.
+		@return true if the SIMD instructions are used, otherwise false.
+		*/
+		static bool IsHardwareAccelerated();
+	};
+}
+
+#endif //__EP_UNICODE_HELPER_H__
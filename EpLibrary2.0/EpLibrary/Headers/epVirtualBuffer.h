@@ -0,0 +1,193 @@
+/*! 
+@file epVirtualBuffer.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Virtual Memory Buffer Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Virtual Memory Buffer Class.
+
+*/
+#ifndef __EP_VIRTUAL_BUFFER_H__
+#define __EP_VIRTUAL_BUFFER_H__
+#include "epLib.h"
+#include "epSystem.h"
+
+namespace epl
+{
+	/// Enumerator for Virtual Buffer Flag
+	enum VirtualBufferFlag
+	{
+		/// The buffer is committed in normal pages.
+		VIRTUAL_BUFFER_FLAG_NONE=0x0,
+		/// The buffer is committed in large pages if the process has SeLockMemoryPrivilege.
+		VIRTUAL_BUFFER_FLAG_LARGE_PAGE=0x1,
+		/// The guard page is placed right after the committed region.
+		VIRTUAL_BUFFER_FLAG_GUARD_PAGE=0x2,
+	};
+
+	/*! 
+	@class VirtualBuffer epVirtualBuffer.h
+	@brief A class that implements the buffer over reserved virtual memory region.
+
+	The address range for the maximum size is reserved at once, and the pages are committed as the buffer grows.
+	Since the buffer never moves, growing the buffer does not copy the data already written.
+	*/
+	class EP_LIBRARY VirtualBuffer
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the buffer without reserving any region
+		*/
+		VirtualBuffer();
+
+		/*!
+		Default Destructor
+
+		Release the reserved region
+		*/
+		virtual ~VirtualBuffer();
+
+		/*!
+		Reserve the address range of given size.
+		@param[in] maxSize the maximum size of the buffer in bytes.
+		@param[in] flags the combination of VirtualBufferFlag.
+		@return true if successfully reserved, otherwise false.
+		@remark the region already reserved is released first.
+		@remark with large pages, the whole region is committed at once, and the guard page is not placed.
+		@remark falls back to normal pages if large pages are not available.
+		*/
+		bool Reserve(size_t maxSize, unsigned int flags=VIRTUAL_BUFFER_FLAG_NONE);
+
+		/*!
+		Commit the pages so that at least given size is accessible.
+		@param[in] size the size of the buffer to be accessible in bytes.
+		@return true if successfully committed, otherwise false.
+		@remark fails if the size is larger than the reserved size.
+		*/
+		bool Commit(size_t size);
+
+		/*!
+		Decommit the pages beyond given size.
+		@param[in] size the size of the buffer to keep accessible in bytes.
+		@remark does nothing with large pages.
+		*/
+		void Decommit(size_t size);
+
+		/*!
+		Release the reserved region.
+		*/
+		void Release();
+
+		/*!
+		Return the pointer to the start of the buffer.
+		@return the pointer to the start of the buffer, or NULL if not reserved.
+		*/
+		void *GetBuffer() const;
+
+		/*!
+		Return the size of the accessible part of the buffer.
+		@return the committed size in bytes.
+		*/
+		size_t GetCommittedSize() const;
+
+		/*!
+		Return the maximum size of the buffer.
+		@return the reserved size in bytes.
+		*/
+		size_t GetReservedSize() const;
+
+		/*!
+		Return the size of the page the buffer is committed in.
+		@return the page size in bytes.
+		*/
+		size_t GetPageSize() const;
+
+		/*!
+		Return the flag whether the buffer is committed in large pages.
+		@return true if the buffer is committed in large pages, otherwise false.
+		*/
+		bool IsLargePage() const;
+
+		/*!
+		Return the flag whether the region is reserved.
+		@return true if the region is reserved, otherwise false.
+		*/
+		bool IsReserved() const;
+
+		/*!
+		Return the size of the large page on running computer.
+		@return the large page size in bytes, or 0 if large pages are not available.
+		@remark returns 0 if the calling process cannot acquire SeLockMemoryPrivilege.
+		*/
+		static size_t GetLargePageSize();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		VirtualBuffer(const VirtualBuffer & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		VirtualBuffer &operator=(const VirtualBuffer & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Place the guard page at given offset.
+		@param[in] offset the offset of the guard page from the start of the buffer.
+		@return true if successfully placed, otherwise false.
+		*/
+		bool placeGuardPage(size_t offset);
+
+		/// the start of the reserved region
+		unsigned char *m_buffer;
+		/// the committed size
+		size_t m_committedSize;
+		/// the reserved size except the guard page
+		size_t m_reservedSize;
+		/// the page size
+		size_t m_pageSize;
+		/// the flag for large pages
+		bool m_isLargePage;
+		/// the flag for the guard page
+		bool m_isGuardPage;
+	};
+}
+
+#endif //__EP_VIRTUAL_BUFFER_H__
\ No newline at end of file
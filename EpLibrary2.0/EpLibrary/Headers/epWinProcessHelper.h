@@ -39,7 +39,9 @@ An Interface for the Window Processing Operation.
 #define __EP_WIN_PROCESS_HELPER_H__
 #include "epLib.h"
 #include "epSystem.h"
+#include "epBaseLock.h"
 #include <vector>
+#include <map>
 
 
 namespace epl
@@ -99,6 +101,128 @@ namespace epl
 #endif //(_MSC_VER >=MSVC90) && (WINVER>=WINDOWS_VISTA)
 	}ProcessPriority;
 
+	/*! 
+	@class ProcessSnapshot epWinProcessHelper.h
+	@brief This is a class for the snapshot of the running processes
+
+	Takes one capture of the process list, indexed by the name and the process ID,
+	so many queries are answered without walking the process list again.
+	The names are compared case-insensitively, with or without the ".exe" extension.
+	*/
+	class EP_LIBRARY ProcessSnapshot
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the snapshot
+		@param[in] isCapture flag whether to capture the process list at once
+		@param[in] lockPolicyType The lock policy
+		*/
+		ProcessSnapshot(bool isCapture=true, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroys the snapshot
+		*/
+		virtual ~ProcessSnapshot();
+
+		/*!
+		Capture the process list again.
+		@param[in] maxAgeInMilliSec the capture younger than this is kept as it is. (0 to always capture)
+		@return true if the snapshot is up to date, otherwise false
+		@remark Only the processes started or exited since the last capture are updated in the index.
+		*/
+		bool Refresh(unsigned int maxAgeInMilliSec=0);
+
+		/*!
+		Return the age of the capture.
+		@return the time in milliseconds since the last capture
+		*/
+		unsigned int GetAgeInMilliSec() const;
+
+		/*!
+		Return the set of process id with given name
+		@param[in] pProcessName the name of the window process
+		@param[out] retSetOfPID the set of process id with given name
+		*/
+		void GetProcessID(const TCHAR * pProcessName, std::vector<unsigned long>& retSetOfPID) const;
+
+		/*!
+		Get the number of process with the given name
+		@param[in] pProcessName the name of the window process
+		@return the number of process with the given name
+		*/
+		size_t GetNumberOfProcess(const TCHAR * pProcessName) const;
+
+		/*!
+		Get the name of the process with the given process ID
+		@param[in] processID the id of the window process
+		@param[out] retProcessName the executable name of the process
+		@return true if the process is found, otherwise false
+		*/
+		bool GetProcessName(unsigned long processID, EpTString &retProcessName) const;
+
+		/*!
+		Return whether the process with the given process ID is running
+		@param[in] processID the id of the window process
+		@return true if running, otherwise false
+		*/
+		bool IsProcessRunning(unsigned long processID) const;
+
+		/*!
+		Return the number of all processes
+		@return the number of all processes
+		*/
+		size_t GetProcessCount() const;
+
+	private:
+		/*!
+		Return the name as the key of the index.
+		@param[in] pProcessName the name of the window process
+		@return the name in lower case without the ".exe" extension
+		*/
+		static EpTString getNameKey(const TCHAR *pProcessName);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the snapshot
+		@param[in] b the second object
+		@remark Copy Constructor prohibited
+		*/
+		ProcessSnapshot(const ProcessSnapshot& b)
+		{
+			EP_ASSERT(0);
+		}
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		@remark Copy Operator prohibited
+		*/
+		ProcessSnapshot & operator=(const ProcessSnapshot&b)
+		{
+			EP_ASSERT(0);
+			return *this;
+		}
+
+		/// the executable name of each process ID
+		std::map<unsigned long,EpTString> m_nameMap;
+		/// the process IDs of each name key
+		std::map<EpTString,std::vector<unsigned long> > m_processIdMap;
+		/// the time of the last capture in milliseconds
+		__int64 m_captureTime;
+		/// the flag whether the process list is captured
+		bool m_isCaptured;
+		/// snapshot lock
+		BaseLock *m_snapshotLock;
+		/// Lock Policy
+		LockPolicy m_lockPolicy;
+	};
+
 	/*! 
 	@class WinProcessHelper epWinProcessHelper.h
 	@brief This is a class for Window Processing Class
@@ -113,8 +237,9 @@ namespace epl
 		Return the set of process id with given name
 		@param[in] pProcessName the name of the window process
 		@param[out] retSetOfPID the set of process id with given name
+		@param[in] snapshot the snapshot to query. (NULL to capture the process list)
 		*/
-		static void GetProcessID(const TCHAR * pProcessName, std::vector<unsigned long>& retSetOfPID);
+		static void GetProcessID(const TCHAR * pProcessName, std::vector<unsigned long>& retSetOfPID, const ProcessSnapshot *snapshot=NULL);
 
 		/*!
 		Return the set of process id with given handle
@@ -126,9 +251,10 @@ namespace epl
 		/*!
 		Terminate the all process with the given name
 		@param[in] pProcessName the name of the window process to terminate
+		@param[in] snapshot the snapshot to query. (NULL to capture the process list)
 		@return true if terminated, otherwise false
 		*/
-		static bool TerminateProcess(const TCHAR * pProcessName);
+		static bool TerminateProcess(const TCHAR * pProcessName, const ProcessSnapshot *snapshot=NULL);
 
 		/*!
 		Terminate the process with the given process ID
@@ -147,9 +273,10 @@ namespace epl
 		/*!
 		Switch the focus to the process with the given process ID
 		@param[in] pProcessName the name of the window process to switch
+		@param[in] snapshot the snapshot to query. (NULL to capture the process list)
 		@return true if switched, otherwise false
 		*/
-		static bool SwitchToProcess(const TCHAR *pProcessName);
+		static bool SwitchToProcess(const TCHAR *pProcessName, const ProcessSnapshot *snapshot=NULL);
 		
 		/*!
 		Switch the focus to the process with the given process ID
@@ -168,16 +295,18 @@ namespace epl
 		/*!
 		Get the number of process with the given name
 		@param[in] pProcessName the name of the window process
+		@param[in] snapshot the snapshot to query. (NULL to capture the process list)
 		@return the number of process with the given name
 		*/
-		static size_t GetNumberOfProcess(const TCHAR * pProcessName);
+		static size_t GetNumberOfProcess(const TCHAR * pProcessName, const ProcessSnapshot *snapshot=NULL);
 
 		/*!
 		Get the process handle by process name and input as parameter for function Func
 		@param[in] pProcessName the name of the window process
 		@param[in] Func the function pointer to get the found handle as its parameter
+		@param[in] snapshot the snapshot to query. (NULL to capture the process list)
 		*/
-		static void CommandOnProcess(const TCHAR *pProcessName, void (__cdecl *Func)(HANDLE) );
+		static void CommandOnProcess(const TCHAR *pProcessName, void (__cdecl *Func)(HANDLE), const ProcessSnapshot *snapshot=NULL);
 
 		/*!
 		Return the current Process Priority.
@@ -0,0 +1,212 @@
+/*! 
+@file epWorkerMetrics.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief Worker Metrics Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for Worker Metrics Class.
+
+*/
+#ifndef __EP_WORKER_METRICS_H__
+#define __EP_WORKER_METRICS_H__
+#include "epLib.h"
+#include "epSystem.h"
+
+/// the number of log2 buckets in the worker metrics histograms
+#define WORKER_METRICS_BUCKET_COUNT 32
+
+namespace epl
+{
+	/*! 
+	@struct WorkerMetricsSnapshot epWorkerMetrics.h
+	@brief A point-in-time copy of the worker metrics.
+
+	All times are in microseconds.
+	The bucket i of the histograms counts the jobs whose time was in [2^(i-1), 2^i) microseconds. (bucket 0 is under 1 microsecond)
+	*/
+	struct EP_LIBRARY WorkerMetricsSnapshot
+	{
+		/// the number of jobs processed
+		__int64 jobsProcessed;
+		/// the sum of the enqueue-to-start latency
+		__int64 totalWaitTime;
+		/// the sum of the execution time
+		__int64 totalServiceTime;
+		/// the sum of the idle time
+		__int64 totalIdleTime;
+		/// the longest enqueue-to-start latency
+		__int64 maxWaitTime;
+		/// the longest execution time
+		__int64 maxServiceTime;
+		/// the histogram of the enqueue-to-start latency
+		__int64 waitHistogram[WORKER_METRICS_BUCKET_COUNT];
+		/// the histogram of the execution time
+		__int64 serviceHistogram[WORKER_METRICS_BUCKET_COUNT];
+
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		*/
+		WorkerMetricsSnapshot();
+
+		/*!
+		Subtract the counters of the given earlier snapshot from this snapshot.
+		@param[in] b the earlier snapshot to subtract.
+		@remark the maximums are kept as they are.
+		*/
+		void Subtract(const WorkerMetricsSnapshot &b);
+
+		/*!
+		Add the counters of the given snapshot to this snapshot.
+		@param[in] b the snapshot to add.
+		@remark used to aggregate the metrics of the workers in a pool.
+		*/
+		void Add(const WorkerMetricsSnapshot &b);
+
+		/*!
+		Return the fraction of the time spent in executing jobs.
+		@return the utilization between 0.0 and 1.0.
+		*/
+		double GetUtilization() const;
+
+		/*!
+		Return the average enqueue-to-start latency.
+		@return the average wait time in microseconds.
+		*/
+		double GetMeanWaitTime() const;
+
+		/*!
+		Return the average execution time.
+		@return the average service time in microseconds.
+		*/
+		double GetMeanServiceTime() const;
+
+		/*!
+		Return the upper bound of the enqueue-to-start latency for the given percentile.
+		@param[in] percentile the percentile between 0.0 and 100.0.
+		@return the upper bound of the wait time in microseconds.
+		*/
+		__int64 GetWaitTimePercentile(double percentile) const;
+
+		/*!
+		Return the upper bound of the execution time for the given percentile.
+		@param[in] percentile the percentile between 0.0 and 100.0.
+		@return the upper bound of the service time in microseconds.
+		*/
+		__int64 GetServiceTimePercentile(double percentile) const;
+	};
+
+	/*! 
+	@class WorkerMetrics epWorkerMetrics.h
+	@brief A class that keeps the low-overhead counters of a worker.
+
+	Only the owning worker records to the counters, so the recording never takes a lock.
+	The counters are guarded by a sequence number, so GetSnapshot can be called from any thread while the worker runs,
+	and always returns the consistent counters.
+	*/
+	class EP_LIBRARY WorkerMetrics
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes all counters to zero
+		*/
+		WorkerMetrics();
+
+		/*!
+		Default Destructor
+
+		Destroy the metrics
+		*/
+		virtual ~WorkerMetrics();
+
+		/*!
+		Record the job processed.
+		@param[in] waitTime the enqueue-to-start latency in microseconds.
+		@param[in] serviceTime the execution time in microseconds.
+		@remark must be called only from the owning worker.
+		*/
+		void RecordJob(__int64 waitTime, __int64 serviceTime);
+
+		/*!
+		Record the time the worker spent idle.
+		@param[in] idleTime the idle time in microseconds.
+		@remark must be called only from the owning worker.
+		*/
+		void RecordIdle(__int64 idleTime);
+
+		/*!
+		Copy the current counters to the given snapshot.
+		@param[out] retSnapshot the snapshot to receive the counters.
+		@remark the counters are cumulative, so subtract the earlier snapshot to get the counters of an interval.
+		*/
+		void GetSnapshot(WorkerMetricsSnapshot &retSnapshot) const;
+
+		/*!
+		Return the current time of the high-resolution performance counter.
+		@return the current time in microseconds.
+		*/
+		static __int64 GetCurrentMicroSec();
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		WorkerMetrics(const WorkerMetrics & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		WorkerMetrics &operator=(const WorkerMetrics & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Return the log2 bucket of the given time.
+		@param[in] time the time in microseconds.
+		@return the bucket index.
+		*/
+		static unsigned int getBucket(__int64 time);
+
+		/// the sequence number which is odd while recording
+		volatile long m_sequence;
+		/// the counters
+		WorkerMetricsSnapshot m_counters;
+	};
+}
+
+#endif //__EP_WORKER_METRICS_H__
\ No newline at end of file
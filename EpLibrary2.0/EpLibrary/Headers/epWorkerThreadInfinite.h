@@ -41,7 +41,7 @@ A Interface for Infinite-looping Worker Thread Class.
 #include "epWorkerThreadFactory.h"
 #include "epCriticalSectionEx.h"
 #include "epBaseJobProcessor.h"
-#include "epEventEx.h"
+#include "epLightEvent.h"
 
 namespace epl
 {
@@ -52,13 +52,27 @@ namespace epl
 	class EP_LIBRARY WorkerThreadInfinite:public BaseWorkerThread
 	{
 	public:
+		/// Enumerator for Idle Wait Policy
+		enum IdleWaitPolicy
+		{
+			/// The idle thread yields with Sleep(0) and polls the work pool.
+			IDLE_WAIT_YIELD=0,
+			/// The idle thread blocks until the new work is pushed.
+			IDLE_WAIT_EVENT,
+			/// Idle Wait Policy Count
+			IDLE_WAIT_COUNT,
+		};
+
 		/*!
 		Default Constructor
 
 		Initializes the thread class
 		@param[in] policy the life policy of this worker thread.
+		@param[in] idlePolicy the idle wait policy of this worker thread.
+		@param[in] maxSpinCount the maximum number of spins before blocking when idlePolicy is IDLE_WAIT_EVENT.
+		@remark the spin count adapts between 0 and maxSpinCount depending on whether spinning found new work.
 		*/
-		WorkerThreadInfinite(const ThreadLifePolicy policy);
+		WorkerThreadInfinite(const ThreadLifePolicy policy, const IdleWaitPolicy idlePolicy=IDLE_WAIT_EVENT, unsigned int maxSpinCount=0);
 
 		/*!
 		Default Copy Constructor
@@ -85,10 +99,22 @@ namespace epl
 			if(this!=&b)
 			{
 				BaseWorkerThread::operator =(b);
+				m_idlePolicy=b.m_idlePolicy;
+				m_maxSpinCount=b.m_maxSpinCount;
+				m_spinCount=b.m_maxSpinCount;
 			}
 			return *this;
 		}
 
+		/*!
+		Return the idle wait policy of this worker thread.
+		@return the idle wait policy of this worker thread.
+		*/
+		IdleWaitPolicy GetIdleWaitPolicy() const
+		{
+			return m_idlePolicy;
+		}
+
 		/*!
 		Wait for worker thread to terminate, and if not terminated, then Terminate.
 		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
@@ -102,9 +128,27 @@ namespace epl
 		*/
 		virtual void execute();
 
+		/*!
+		Wake up the thread if it is waiting for the work pushed.
+		*/
+		virtual void signalWork();
+
 	private:
+		/*!
+		Wait until the new work is pushed or the thread is terminated.
+		*/
+		void waitForWork();
+
 		/// Terminate Signal Event
-		EventEx m_terminateEvent;
+		LightEvent m_terminateEvent;
+		/// Work Pushed Signal Event
+		LightEvent m_workEvent;
+		/// Idle Wait Policy
+		IdleWaitPolicy m_idlePolicy;
+		/// Maximum spin count before blocking
+		unsigned int m_maxSpinCount;
+		/// Current adaptive spin count
+		unsigned int m_spinCount;
 
 	};
 
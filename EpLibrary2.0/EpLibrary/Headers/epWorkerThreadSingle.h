@@ -40,6 +40,7 @@ A Interface for Single Job Worker Thread Class.
 #include "epLib.h"
 #include "epWorkerThreadFactory.h"
 #include "epBaseJobProcessor.h"
+#include "epLightEvent.h"
 
 namespace epl
 {
@@ -47,6 +48,9 @@ namespace epl
 	/*! 
 	@class WorkerThreadSingle epWorkerThreadSingle.h
 	@brief A class that implements single-job Worker Thread Class.
+
+	With the keep-alive time, the thread is parked after the work pool is empty instead of terminating,
+	and the work pushed within the keep-alive time runs on the same thread without creating a new one.
 	*/
 	class EP_LIBRARY WorkerThreadSingle:public BaseWorkerThread
 	{
@@ -57,9 +61,9 @@ namespace epl
 		Initializes the thread class
 		@param[in] policy the life policy of this worker thread.
 		@param[in] lockPolicyType The lock policy
+		@param[in] keepAliveInMilliSec the time to keep the thread parked after the work pool is empty, in milliseconds. (0 to terminate right away)
 		*/
-		WorkerThreadSingle(const ThreadLifePolicy policy,LockPolicy lockPolicyType=EP_LOCK_POLICY):BaseWorkerThread(policy,lockPolicyType)
-		{}
+		WorkerThreadSingle(const ThreadLifePolicy policy,LockPolicy lockPolicyType=EP_LOCK_POLICY,unsigned int keepAliveInMilliSec=0);
 
 		/*!
 		Default Copy Constructor
@@ -67,8 +71,7 @@ namespace epl
 		Initializes the Thread class
 		@param[in] b the second object
 		*/
-		WorkerThreadSingle(const WorkerThreadSingle & b):BaseWorkerThread(b)
-		{}
+		WorkerThreadSingle(const WorkerThreadSingle & b);
 		
 		/*!
 		Default Destructor
@@ -87,16 +90,67 @@ namespace epl
 			if(this!=&b)
 			{
 				BaseWorkerThread::operator =(b);
+				m_keepAliveTime=b.m_keepAliveTime;
 			}
 			return *this;
 		}
 
+		/*!
+		Start the thread, or wake the parked thread.
+		@param[in] opCode The operation code for creating thread.
+		@param[in] threadType The type of thread creation
+		@param[in] stackSize The stack size of the thread
+		@return true, if succeeded, otherwise false.
+		@remark if the thread is parked, no new thread is created and the parked one takes the work.
+		@remark push the work before calling this, so the thread woken finds it.
+		*/
+		bool Start(const ThreadOpCode opCode=THREAD_OPCODE_CREATE_START, const ThreadType threadType=THREAD_TYPE_BEGIN_THREAD, const int stackSize=0);
+
+		/*!
+		Wake the parked thread to terminate, and wait for it to terminate.
+		@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+		@return the terminate result of the thread
+		*/
+		virtual TerminateResult TerminateWorker(unsigned int waitTimeInMilliSec=WAITTIME_INIFINITE);
+
+		/*!
+		Set the time to keep the thread parked after the work pool is empty.
+		@param[in] keepAliveInMilliSec the keep-alive time in milliseconds. (0 to terminate right away)
+		*/
+		void SetKeepAliveTime(unsigned int keepAliveInMilliSec);
+
+		/*!
+		Return the time to keep the thread parked after the work pool is empty.
+		@return the keep-alive time in milliseconds.
+		*/
+		unsigned int GetKeepAliveTime() const;
+
+		/*!
+		Return the flag whether the thread is parked waiting for the work.
+		@return true if the thread is parked, otherwise false.
+		*/
+		bool IsParked() const;
+
 	protected:
 		/*!
 		Actual single-job Thread Code.
 		*/
 		virtual void execute();
-	
+
+		/*!
+		Wake the parked thread for the work pushed.
+		*/
+		virtual void signalWork();
+
+	private:
+		/// the time to keep the thread parked
+		volatile unsigned int m_keepAliveTime;
+		/// the flag whether the thread is parked
+		volatile long m_isParked;
+		/// the flag whether the worker is terminating
+		volatile long m_isTerminating;
+		/// the event to wake the parked thread
+		LightEvent m_workEvent;
 	};
 
 }
@@ -41,6 +41,7 @@ An Interface for the XML File Class.
 #include "epSystem.h"
 #include "epXMLite.h"
 #include "epBaseTextFile.h"
+#include "epXMLStreamWriter.h"
 #include <vector>
 
 using namespace std;
@@ -218,6 +219,42 @@ namespace epl
 
 		XMLInfo m_xmlInfo;
 
+	private:
+		/*!
+		@class FileWriter epXMLFile.h
+		@brief A class that flushes the XML written to the file of the XMLFile.
+		*/
+		class FileWriter:public XMLStreamWriter
+		{
+		public:
+			/*!
+			Default Constructor
+
+			Initializes the writer
+			@param[in] owner the XMLFile to write its file
+			*/
+			FileWriter(XMLFile *owner);
+
+			/*!
+			Default Destructor
+
+			Flush the characters buffered, and destroy the writer
+			*/
+			virtual ~FileWriter();
+
+		protected:
+			/*!
+			Write the characters flushed to the file
+			@param[in] chars the characters to write
+			@param[in] count the number of the characters
+			*/
+			virtual void flushChars(const TCHAR *chars, size_t count);
+
+		private:
+			/// the XMLFile to write its file
+			XMLFile *m_owner;
+		};
+
 	};
 }
 
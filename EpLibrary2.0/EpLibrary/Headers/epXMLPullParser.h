@@ -0,0 +1,380 @@
+/*! 
+@file epXMLPullParser.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief XML Pull Parser Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the XML Pull Parser.
+
+*/
+#ifndef __EP_XML_PULL_PARSER_H__
+#define __EP_XML_PULL_PARSER_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epXMLite.h"
+#include <vector>
+
+namespace epl
+{
+	/// Enumeration of the XML Pull Event
+	typedef enum _xmlPullEvent{
+		/// Nothing read yet
+		XML_PULL_EVENT_NONE=0,
+		/// Start tag <name ...> or <name .../>
+		XML_PULL_EVENT_START_ELEMENT,
+		/// End tag </name>, or the end of <name .../>
+		XML_PULL_EVENT_END_ELEMENT,
+		/// Text between the tags
+		XML_PULL_EVENT_TEXT,
+		/// <![CDATA[ ... ]]>
+		XML_PULL_EVENT_CDATA,
+		/// <!-- ... -->
+		XML_PULL_EVENT_COMMENT,
+		/// <?target ... ?>
+		XML_PULL_EVENT_PROCESSING_INSTRUCTION,
+		/// End of the document
+		XML_PULL_EVENT_END_DOCUMENT,
+		/// The document is not well-formed
+		XML_PULL_EVENT_ERROR,
+	}XMLPullEvent;
+
+	/*!
+	@struct XMLStringRef epXMLPullParser.h
+	@brief A structure of the characters in the buffer parsed, which is not null-terminated.
+	*/
+	typedef struct EP_LIBRARY _xmlStringRef
+	{
+		/// the first character
+		const TCHAR *m_begin;
+		/// the number of the characters
+		size_t m_length;
+
+		/*!
+		Default Constructor
+
+		Initializes the empty string
+		*/
+		_xmlStringRef() { m_begin=NULL; m_length=0; }
+
+		/*!
+		Return the flag whether the characters are the same as the given string
+		@param[in] str the null-terminated string to compare
+		@return true if the same, otherwise false
+		*/
+		bool Equals(const TCHAR *str) const;
+
+		/*!
+		Return the copy of the characters
+		@return the string copied
+		*/
+		EpTString ToString() const;
+	}XMLStringRef;
+
+	/*!
+	@struct XMLPullAttr epXMLPullParser.h
+	@brief A structure of the attribute of the start tag.
+	*/
+	typedef struct EP_LIBRARY _xmlPullAttr
+	{
+		/// the name of the attribute
+		XMLStringRef m_name;
+		/// the raw value of the attribute without the quotation marks, whose entities are not decoded
+		XMLStringRef m_value;
+	}XMLPullAttr;
+
+	class XMLSaxHandler;
+
+	/*!
+	@class XMLPullParser epXMLPullParser.h
+	@brief A class that reads the XML as the events, without building the nodes.
+
+	The names, the values and the texts refer to the buffer given, so nothing is copied or allocated per node,
+	and they are valid while the buffer is valid.
+	@remark the escape character of the XMLite is not supported, and the entities are decoded only by DecodeEntities.
+	*/
+	class EP_LIBRARY XMLPullParser
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the parser
+		@param[in] xml the XML to parse, which must outlive the parser
+		@param[in] length the number of the characters of the XML
+		@param[in] skipWhitespaceText the flag whether the texts of the whitespaces only are skipped
+		*/
+		XMLPullParser(const TCHAR *xml, size_t length, bool skipWhitespaceText=true);
+
+		/*!
+		Default Destructor
+
+		Destroy the parser
+		*/
+		virtual ~XMLPullParser();
+
+		/*!
+		Read the next event
+		@return the event read
+		@remark the parser stays at XML_PULL_EVENT_END_DOCUMENT or XML_PULL_EVENT_ERROR once reached.
+		*/
+		XMLPullEvent Next();
+
+		/*!
+		Return the current event
+		@return the current event
+		*/
+		XMLPullEvent GetEvent() const;
+
+		/*!
+		Return the name of the element or the target of the processing instruction
+		@return the name of the current event
+		*/
+		const XMLStringRef &GetName() const;
+
+		/*!
+		Return the raw value of the text, the CDATA, the comment or the processing instruction
+		@return the value of the current event
+		*/
+		const XMLStringRef &GetValue() const;
+
+		/*!
+		Return the number of the attributes of the start tag
+		@return the number of the attributes
+		*/
+		size_t GetAttrCount() const;
+
+		/*!
+		Return the attribute of the start tag at the given index
+		@param[in] attrIdx the index of the attribute
+		@return the attribute
+		*/
+		const XMLPullAttr &GetAttr(size_t attrIdx) const;
+
+		/*!
+		Find the raw value of the attribute of the start tag with the given name
+		@param[in] name the name of the attribute
+		@param[out] retValue the raw value of the attribute
+		@return true if found, otherwise false
+		*/
+		bool FindAttr(const TCHAR *name, XMLStringRef &retValue) const;
+
+		/*!
+		Return the flag whether the current start tag is closed by itself as <name .../>
+		@return true if closed by itself, otherwise false
+		@remark XML_PULL_EVENT_END_ELEMENT still follows the start tag closed by itself.
+		*/
+		bool IsEmptyElement() const;
+
+		/*!
+		Return the number of the elements open
+		@return the depth of the current event, which counts the element started.
+		*/
+		size_t GetDepth() const;
+
+		/*!
+		Return the error code of the document not well-formed
+		@return the error code
+		*/
+		PCODE GetErrorCode() const;
+
+		/*!
+		Return the offset of the character where the error found
+		@return the offset of the error from the start of the XML
+		*/
+		size_t GetErrorOffset() const;
+
+		/*!
+		Decode the entity references of the given raw value
+		@param[in] raw the raw value to decode
+		@return the value decoded
+		@remark &lt; &gt; &amp; &quot; &apos; and the character references are decoded, and the others are left as they are.
+		*/
+		static EpTString DecodeEntities(const XMLStringRef &raw);
+
+		/*!
+		Parse the given XML, and call the handler for each event
+		@param[in] xml the XML to parse
+		@param[in] length the number of the characters of the XML
+		@param[in] handler the handler to receive the events
+		@param[in] skipWhitespaceText the flag whether the texts of the whitespaces only are skipped
+		@return true if the whole document is parsed, otherwise false if not well-formed or stopped by the handler
+		*/
+		static bool ParseSax(const TCHAR *xml, size_t length, XMLSaxHandler *handler, bool skipWhitespaceText=true);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		XMLPullParser(const XMLPullParser & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XMLPullParser &operator=(const XMLPullParser & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Read the markup starting with '<'
+		@return the event read
+		*/
+		XMLPullEvent readMarkup();
+
+		/*!
+		Read the start tag
+		@return the event read
+		*/
+		XMLPullEvent readStartTag();
+
+		/*!
+		Read the end tag
+		@return the event read
+		*/
+		XMLPullEvent readEndTag();
+
+		/*!
+		Read the markup closed with the given string, such as the comment
+		@param[in] event the event of the markup
+		@param[in] openLength the number of the characters opening the markup
+		@param[in] close the string closing the markup
+		@return the event read
+		*/
+		XMLPullEvent readEnclosed(XMLPullEvent event, size_t openLength, const TCHAR *close);
+
+		/*!
+		Skip the declaration such as <!DOCTYPE ...> with its internal subset
+		@return true if skipped, otherwise false if not closed
+		*/
+		bool skipDeclaration();
+
+		/*!
+		Set the error, and return the error event
+		@param[in] errorCode the error code
+		@param[in] errorPos the position of the error
+		@return XML_PULL_EVENT_ERROR
+		*/
+		XMLPullEvent setError(PCODE errorCode, const TCHAR *errorPos);
+
+		/// the first character of the XML
+		const TCHAR *m_xml;
+		/// the end of the XML
+		const TCHAR *m_end;
+		/// the character to read next
+		const TCHAR *m_cur;
+		/// the flag whether the texts of the whitespaces only are skipped
+		bool m_skipWhitespaceText;
+		/// the current event
+		XMLPullEvent m_event;
+		/// the name of the current event
+		XMLStringRef m_name;
+		/// the value of the current event
+		XMLStringRef m_value;
+		/// the attributes of the current start tag, which are reused over the tags
+		std::vector<XMLPullAttr> m_attrs;
+		/// the number of the attributes of the current start tag
+		size_t m_attrCount;
+		/// the names of the elements open
+		std::vector<XMLStringRef> m_openNames;
+		/// the flag whether the current start tag is closed by itself
+		bool m_isEmptyElement;
+		/// the error code
+		PCODE m_errorCode;
+		/// the position of the error
+		const TCHAR *m_errorPos;
+	};
+
+	/*!
+	@class XMLSaxHandler epXMLPullParser.h
+	@brief A class that receives the events of XMLPullParser::ParseSax.
+
+	Each callback returns true to continue, or false to stop parsing, and the default ignores the event.
+	*/
+	class EP_LIBRARY XMLSaxHandler
+	{
+	public:
+		/*!
+		Default Destructor
+
+		Destroy the handler
+		*/
+		virtual ~XMLSaxHandler(){}
+
+		/*!
+		Receive the start tag
+		@param[in] parser the parser, which holds the name and the attributes of the start tag
+		@return true to continue, otherwise false to stop
+		*/
+		virtual bool OnStartElement(const XMLPullParser &parser){return true;}
+
+		/*!
+		Receive the end tag
+		@param[in] name the name of the element
+		@return true to continue, otherwise false to stop
+		*/
+		virtual bool OnEndElement(const XMLStringRef &name){return true;}
+
+		/*!
+		Receive the text or the CDATA
+		@param[in] text the raw text, whose entities are not decoded for the text
+		@param[in] isCData the flag whether the text is the CDATA
+		@return true to continue, otherwise false to stop
+		*/
+		virtual bool OnText(const XMLStringRef &text, bool isCData){return true;}
+
+		/*!
+		Receive the comment
+		@param[in] comment the comment
+		@return true to continue, otherwise false to stop
+		*/
+		virtual bool OnComment(const XMLStringRef &comment){return true;}
+
+		/*!
+		Receive the processing instruction
+		@param[in] target the target of the processing instruction
+		@param[in] data the rest of the processing instruction
+		@return true to continue, otherwise false to stop
+		*/
+		virtual bool OnProcessingInstruction(const XMLStringRef &target, const XMLStringRef &data){return true;}
+
+		/*!
+		Receive the error of the document not well-formed
+		@param[in] errorCode the error code
+		@param[in] errorOffset the offset of the error from the start of the XML
+		*/
+		virtual void OnError(PCODE errorCode, size_t errorOffset){}
+	};
+}
+
+#endif //__EP_XML_PULL_PARSER_H__
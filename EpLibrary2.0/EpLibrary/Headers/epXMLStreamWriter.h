@@ -0,0 +1,201 @@
+/*! 
+@file epXMLStreamWriter.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief XML Stream Writer Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the XML Stream Writer.
+
+*/
+#ifndef __EP_XML_STREAM_WRITER_H__
+#define __EP_XML_STREAM_WRITER_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epXMLite.h"
+#include "epStream.h"
+#include <vector>
+
+/// The default number of the characters buffered before flushed
+#define XML_STREAM_WRITER_DEFAULT_BUFFER_SIZE 16384
+
+namespace epl
+{
+	/*!
+	@class XMLStreamWriter epXMLStreamWriter.h
+	@brief A class that writes the XNode tree into the stream through the buffer.
+
+	The output is the same as XNode::GetXML, but the characters are appended to the buffer and flushed when full,
+	so the document is written without building the whole string or the string of each node.
+	The entities are found by the SIMD scan, and the indentations are written from the table.
+	@remark the sub class may override flushChars to write the characters to other than the stream.
+	*/
+	class EP_LIBRARY XMLStreamWriter
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the writer
+		@param[in] stream the stream to write, or NULL if flushChars is overridden
+		@param[in] encodingType the encoding type of the bytes written to the stream
+		@param[in] bufferSize the number of the characters buffered before flushed
+		*/
+		XMLStreamWriter(Stream *stream=NULL, FileEncodingType encodingType=FILE_ENCODING_TYPE_UTF16LE, size_t bufferSize=XML_STREAM_WRITER_DEFAULT_BUFFER_SIZE);
+
+		/*!
+		Default Destructor
+
+		Flush the characters buffered, and destroy the writer
+		@remark the sub class overriding flushChars must call Flush in its destructor.
+		*/
+		virtual ~XMLStreamWriter();
+
+		/*!
+		Write the given node and its descendants
+		@param[in] node the node to write
+		@param[in] opt the display option
+		*/
+		void WriteNode(LPXNode node, LPDISP_OPT opt=&DISP_OPT::optDefault);
+
+		/*!
+		Write the given characters
+		@param[in] str the characters to write
+		@param[in] length the number of the characters
+		*/
+		void Write(const TCHAR *str, size_t length);
+
+		/*!
+		Write the given string
+		@param[in] str the null-terminated string to write
+		*/
+		void Write(const TCHAR *str);
+
+		/*!
+		Write the given character
+		@param[in] ch the character to write
+		*/
+		void WriteChar(TCHAR ch);
+
+		/*!
+		Write the given characters replacing the entities with their references
+		@param[in] str the characters to write
+		@param[in] length the number of the characters
+		@param[in] entitys the entities to replace
+		*/
+		void WriteEscaped(const TCHAR *str, size_t length, LPXENTITYS entitys=&XENTITYS::entityDefault);
+
+		/*!
+		Write the new line and the given number of the tabs
+		@param[in] tabCount the number of the tabs
+		*/
+		void WriteNewLine(int tabCount);
+
+		/*!
+		Flush the characters buffered
+		*/
+		void Flush();
+
+		/*!
+		Return the number of the characters written including the characters buffered
+		@return the number of the characters written
+		*/
+		size_t GetWrittenCount() const;
+
+	protected:
+		/*!
+		Write the characters flushed from the buffer
+		@param[in] chars the characters to write
+		@param[in] count the number of the characters
+		@remark the default writes to the stream given in the encoding type given.
+		*/
+		virtual void flushChars(const TCHAR *chars, size_t count);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		XMLStreamWriter(const XMLStreamWriter & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XMLStreamWriter &operator=(const XMLStreamWriter & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Flush the characters buffered
+		@param[in] keepHighSurrogate the flag whether to keep the last high surrogate buffered for its pair
+		*/
+		void flushBuffer(bool keepHighSurrogate);
+
+		/*!
+		Write the given node and its descendants with the given number of the tabs
+		@param[in] node the node to write
+		@param[in] opt the display option
+		@param[in] tabBase the number of the tabs of the node
+		*/
+		void writeNode(LPXNode node, LPDISP_OPT opt, int tabBase);
+
+		/*!
+		Write the given attribute
+		@param[in] attr the attribute to write
+		@param[in] opt the display option
+		*/
+		void writeAttr(LPXAttr attr, LPDISP_OPT opt);
+
+		/*!
+		Write the given value, replacing the entities if the option says
+		@param[in] value the value to write
+		@param[in] opt the display option
+		*/
+		void writeValue(const CString &value, LPDISP_OPT opt);
+
+		/// the stream to write
+		Stream *m_stream;
+		/// the encoding type of the bytes written to the stream
+		FileEncodingType m_encodingType;
+		/// the characters buffered
+		std::vector<TCHAR> m_buffer;
+		/// the number of the characters buffered
+		size_t m_count;
+		/// the number of the characters flushed
+		size_t m_flushedCount;
+		/// the bytes encoded for the stream, which is reused over the flushes
+		std::vector<char> m_encodeBuffer;
+	};
+}
+
+#endif //__EP_XML_STREAM_WRITER_H__
@@ -0,0 +1,355 @@
+/*! 
+@file epXMLView.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief XML View Document Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the XML Document of the views into the buffer loaded.
+
+*/
+#ifndef __EP_XML_VIEW_H__
+#define __EP_XML_VIEW_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epXMLite.h"
+#include "epXMLPullParser.h"
+#include "epArena.h"
+
+namespace epl
+{
+	/*!
+	@struct XMLViewAttr epXMLView.h
+	@brief A structure of the attribute, which refers to the buffer loaded.
+	*/
+	typedef struct EP_LIBRARY _xmlViewAttr
+	{
+		/// the name of the attribute
+		XMLStringRef m_name;
+		/// the raw value of the attribute, whose entities are not decoded
+		XMLStringRef m_value;
+
+		/*!
+		Return the value of the attribute decoded
+		@return the value decoded
+		*/
+		EpTString GetValue() const;
+	}XMLViewAttr;
+
+	class XMLViewDocument;
+
+	/*!
+	@class XMLViewNode epXMLView.h
+	@brief A class of the node, which refers to the buffer loaded instead of copying the names and the values.
+
+	The nodes are allocated from the arena of the document, and valid until the document is cleared.
+	@remark like XNode, the value of the element is its first text.
+	*/
+	class EP_LIBRARY XMLViewNode
+	{
+	public:
+		/*!
+		Return the type of the node
+		@return the type of the node
+		*/
+		NODE_TYPE GetType() const;
+
+		/*!
+		Return the name of the node
+		@return the name of the node
+		*/
+		const XMLStringRef &GetName() const;
+
+		/*!
+		Return the raw value of the node, whose entities are not decoded
+		@return the raw value of the node
+		*/
+		const XMLStringRef &GetRawValue() const;
+
+		/*!
+		Return the value of the node
+		@return the value of the node, whose entities are decoded for the element
+		*/
+		EpTString GetValue() const;
+
+		/*!
+		Return the parent node
+		@return the parent node
+		*/
+		XMLViewNode *GetParent() const;
+
+		/*!
+		Return the first child node
+		@return the first child node, or NULL if no child
+		*/
+		XMLViewNode *GetFirstChild() const;
+
+		/*!
+		Return the next sibling node
+		@return the next sibling node, or NULL if the last
+		*/
+		XMLViewNode *GetNextSibling() const;
+
+		/*!
+		Return the number of the child nodes
+		@return the number of the child nodes
+		*/
+		size_t GetChildCount() const;
+
+		/*!
+		Return the child node at the given index
+		@param[in] childIdx the index of the child node
+		@return the child node, or NULL if out of range
+		@remark the child nodes are linked, so it takes the time linear to the index.
+		*/
+		XMLViewNode *GetChild(size_t childIdx) const;
+
+		/*!
+		Return the first child node with the given name
+		@param[in] name the name of the child node
+		@return the child node, or NULL if not found
+		*/
+		XMLViewNode *GetChild(const TCHAR *name) const;
+
+		/*!
+		Return the value of the first child node with the given name
+		@param[in] name the name of the child node
+		@return the value of the child node, or the empty string if not found
+		*/
+		EpTString GetChildValue(const TCHAR *name) const;
+
+		/*!
+		Return the number of the attributes
+		@return the number of the attributes
+		*/
+		size_t GetAttrCount() const;
+
+		/*!
+		Return the attribute at the given index
+		@param[in] attrIdx the index of the attribute
+		@return the attribute, or NULL if out of range
+		*/
+		const XMLViewAttr *GetAttr(size_t attrIdx) const;
+
+		/*!
+		Return the attribute with the given name
+		@param[in] attrName the name of the attribute
+		@return the attribute, or NULL if not found
+		*/
+		const XMLViewAttr *GetAttr(const TCHAR *attrName) const;
+
+		/*!
+		Return the value of the attribute with the given name
+		@param[in] attrName the name of the attribute
+		@return the value of the attribute decoded, or the empty string if not found
+		*/
+		EpTString GetAttrValue(const TCHAR *attrName) const;
+
+		/*!
+		Return the attribute of the first child node with the given name
+		@param[in] name the name of the child node
+		@param[in] attrName the name of the attribute
+		@return the attribute, or NULL if not found
+		*/
+		const XMLViewAttr *GetChildAttr(const TCHAR *name, const TCHAR *attrName) const;
+
+		/*!
+		Return the value of the attribute of the first child node with the given name
+		@param[in] name the name of the child node
+		@param[in] attrName the name of the attribute
+		@return the value of the attribute decoded, or the empty string if not found
+		*/
+		EpTString GetChildAttrValue(const TCHAR *name, const TCHAR *attrName) const;
+
+		/*!
+		Find the first descendant node with the given name in the depth-first order
+		@param[in] name the name of the node to find
+		@return the node found, or NULL if not found
+		*/
+		XMLViewNode *Find(const TCHAR *name) const;
+
+	private:
+		friend class XMLViewDocument;
+
+		/*!
+		Default Constructor
+
+		Initializes the empty node
+		*/
+		XMLViewNode();
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		XMLViewNode(const XMLViewNode & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XMLViewNode &operator=(const XMLViewNode & b){EP_ASSERT(0);return *this;}
+
+		/// the type of the node
+		NODE_TYPE m_type;
+		/// the name of the node
+		XMLStringRef m_name;
+		/// the raw value of the node
+		XMLStringRef m_value;
+		/// the parent node
+		XMLViewNode *m_parent;
+		/// the first child node
+		XMLViewNode *m_firstChild;
+		/// the last child node
+		XMLViewNode *m_lastChild;
+		/// the next sibling node
+		XMLViewNode *m_nextSibling;
+		/// the number of the child nodes
+		size_t m_childCount;
+		/// the attributes in the arena
+		XMLViewAttr *m_attrs;
+		/// the number of the attributes
+		size_t m_attrCount;
+	};
+
+	/*!
+	@class XMLViewDocument epXMLView.h
+	@brief A class of the XML document of the views into the buffer loaded.
+
+	The names and the values of the nodes are not copied but refer to the buffer, and decoded only when asked.
+	The nodes are allocated from the arena, and freed all together when cleared.
+	@remark the escape character of the XMLite is not supported as XMLPullParser.
+	*/
+	class EP_LIBRARY XMLViewDocument
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty document
+		@param[in] arenaBlockSize the size of the block of the arena for the nodes
+		*/
+		XMLViewDocument(size_t arenaBlockSize=ARENA_DEFAULT_BLOCK_SIZE);
+
+		/*!
+		Default Destructor
+
+		Destroy the document
+		*/
+		virtual ~XMLViewDocument();
+
+		/*!
+		Load the nodes from the given XML
+		@param[in] xml the XML to load, which must outlive the nodes
+		@param[in] length the number of the characters of the XML
+		@param[in] skipWhitespaceText the flag whether the texts of the whitespaces only are skipped
+		@return true if loaded, otherwise false if not well-formed
+		@remark the nodes loaded before are cleared.
+		*/
+		bool Load(const TCHAR *xml, size_t length, bool skipWhitespaceText=true);
+
+		/*!
+		Clear the nodes, and keep the blocks of the arena to reuse for the next load
+		*/
+		void Clear();
+
+		/*!
+		Return the internal virtual root node, whose children are the top-level nodes
+		@return the document node
+		*/
+		XMLViewNode *GetDocumentNode();
+
+		/*!
+		Return the first element of the top-level nodes
+		@return the root element, or NULL if not loaded
+		*/
+		XMLViewNode *GetRoot() const;
+
+		/*!
+		Return the number of the nodes loaded
+		@return the number of the nodes
+		*/
+		size_t GetNodeCount() const;
+
+		/*!
+		Return the error code of the last load
+		@return the error code
+		*/
+		PCODE GetErrorCode() const;
+
+		/*!
+		Return the offset of the character where the error found in the last load
+		@return the offset of the error from the start of the XML
+		*/
+		size_t GetErrorOffset() const;
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		XMLViewDocument(const XMLViewDocument & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XMLViewDocument &operator=(const XMLViewDocument & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Allocate the node from the arena, and append to the given parent
+		@param[in] type the type of the node
+		@param[in] parent the parent node
+		@return the node allocated
+		*/
+		XMLViewNode *newNode(NODE_TYPE type, XMLViewNode *parent);
+
+		/// the arena of the nodes and the attributes
+		Arena m_arena;
+		/// the internal virtual root node
+		XMLViewNode m_docNode;
+		/// the number of the nodes loaded
+		size_t m_nodeCount;
+		/// the error code of the last load
+		PCODE m_errorCode;
+		/// the offset of the error of the last load
+		size_t m_errorOffset;
+	};
+}
+
+#endif //__EP_XML_VIEW_H__
@@ -0,0 +1,129 @@
+/*! 
+@file epXMLViewFile.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief XML View File Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the XML View File.
+
+*/
+#ifndef __EP_XML_VIEW_FILE_H__
+#define __EP_XML_VIEW_FILE_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epXMLView.h"
+#include "epBaseTextFile.h"
+
+namespace epl
+{
+	/*!
+	@class XMLViewFile epXMLViewFile.h
+	@brief A class that loads the XML file into XMLViewDocument.
+
+	The text loaded is kept as the buffer, and the nodes refer to it,
+	so the file is loaded without copying the names and the values for each node.
+	@remark the nodes are read-only, and saving writes the text loaded as it is.
+	*/
+	class EP_LIBRARY XMLViewFile:public BaseTextFile
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the XML View File 
+		@param[in] encodingType the encoding type for this file
+		@param[in] lockPolicyType The lock policy
+		*/
+		XMLViewFile(FileEncodingType encodingType=FILE_ENCODING_TYPE_UTF16LE, LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the XML View File
+		*/
+		virtual ~XMLViewFile();
+
+		/*!
+		Return the document loaded
+		@return the document
+		@remark the nodes are valid until the next load.
+		*/
+		XMLViewDocument &GetDocument();
+
+		/*!
+		Return the root element of the document loaded
+		@return the root element, or NULL if not loaded
+		*/
+		XMLViewNode *GetRoot() const;
+
+	protected:
+		/*!
+		Loop Function that writes the text loaded to the file.
+		*/
+		virtual void writeLoop();
+
+		/*!
+		Actual load Function that loads the nodes from the file.
+		@param[in] lines the all data from the file
+		*/
+		virtual void loadFromFile(const EpTString &lines);
+
+		/*!
+		Load Function that reads the file into the buffer, and loads the nodes from the buffer.
+		@param[in] reader the reader of the file opened
+		*/
+		virtual void loadFromReader(TextLineReader &reader);
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		XMLViewFile(const XMLViewFile & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XMLViewFile &operator=(const XMLViewFile & b){EP_ASSERT(0);return *this;}
+
+		/// the text loaded, which the nodes refer to
+		EpTString m_buffer;
+		/// the document of the nodes
+		XMLViewDocument m_document;
+	};
+}
+
+#endif //__EP_XML_VIEW_FILE_H__
@@ -48,6 +48,7 @@ An Interface for XMLite Class.
 #include "epLib.h"
 #include "epSystem.h"
 #include "epMemory.h"
+#include "epArena.h"
 #include <vector>
 #include <deque>
 
@@ -148,6 +149,20 @@ namespace epl
 	}DISP_OPT, *LPDISP_OPT;
 	
 
+	// XNamePool : interns the names parsed, so the nodes of the same name share one string buffer
+	typedef struct EP_LIBRARY _tagXMLNamePool
+	{
+		CString Intern( const TCHAR * psz, int len );	// return the string shared for the given name
+		void Clear();
+		size_t GetCount() { return m_count; }
+
+		_tagXMLNamePool() { m_count = 0; }
+	private:
+		std::vector<CString> m_names;	// open addressing slots, empty if not used
+		std::vector<size_t> m_hashes;	// hash of the name in each slot
+		size_t m_count;					// number of the names interned
+	}XNAMEPOOL, *LPXNAMEPOOL;
+
 	// XAttr : Attribute Implementation
 	typedef struct EP_LIBRARY _tagXMLAttr
 	{
@@ -155,8 +170,11 @@ namespace epl
 		CString	m_value;
 		
 		_tagXMLNode*	m_parent;
+		Arena*	m_arena;		// arena the attribute is allocated from, or NULL
 
 		CString GetXML( LPDISP_OPT opt = &DISP_OPT::optDefault );
+
+		_tagXMLAttr() { m_parent = NULL; m_arena = NULL; }
 	}XAttr, *LPXAttr;
 
 	typedef enum
@@ -181,6 +199,7 @@ namespace epl
 		XAttrs	m_attrs;		// attributes
 		NODE_TYPE m_type;		// node type 
 		LPXDoc	m_doc;		// document
+		Arena*	m_arena;	// arena the node is allocated from, or NULL
 
 		// Load/Save XML
 		LPTSTR	Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi = &VALUEPARSEINFO::vpiDefault, LPPARSEINFO pi = &PARSEINFO::piDefault );
@@ -220,7 +239,7 @@ namespace epl
 		LPXNode	AppendChild( const TCHAR * name = NULL, const TCHAR * value = NULL );
 		LPXNode	AppendChild( LPXNode node );
 		bool	RemoveChild( LPXNode node );
-		LPXNode DetachChild( LPXNode node );
+		LPXNode DetachChild( LPXNode node );	// the node parsed with the arena must not be deleted by EP_DELETE
 
 		// node/branch copy
 		void	CopyNode( LPXNode node );
@@ -241,7 +260,7 @@ namespace epl
 		LPXNode operator [] ( int i ) { return GetChild(i); }
 		XNode& operator = ( XNode& node ) { CopyBranch(&node); return *this; }
 
-		_tagXMLNode() { m_parent = NULL; m_doc = NULL; m_type = XNODE_ELEMENT; }
+		_tagXMLNode() { m_parent = NULL; m_doc = NULL; m_arena = NULL; m_type = XNODE_ELEMENT; }
 		~_tagXMLNode();
 
 		void Close();
@@ -252,8 +271,10 @@ namespace epl
 	{
 		PARSEINFO	m_parse_info;
 		VALUEPARSEINFO m_valueParse_info;
+		Arena*	m_nodeArena;	// arena for the nodes and attributes parsed, or NULL to use the heap (must outlive the document)
+		LPXNAMEPOOL	m_namePool;	// pool to intern the names parsed, or NULL to copy each name (not thread safe)
 
-		_tagXMLDocument() { m_parent = NULL; m_doc = this; m_type = XNODE_DOC; }
+		_tagXMLDocument() { m_parent = NULL; m_doc = this; m_nodeArena = NULL; m_namePool = NULL; m_type = XNODE_DOC; }
 		
 		LPTSTR	Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi = NULL,LPPARSEINFO pi = NULL);
 		LPXNode	GetRoot();
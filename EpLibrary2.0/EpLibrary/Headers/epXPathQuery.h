@@ -0,0 +1,347 @@
+/*! 
+@file epXPathQuery.h
+@author Woong Gyu La a.k.a Chris. <juhgiyo@gmail.com>
+		<http://github.com/juhgiyo/eplibrary>
+@date October 14, 2026
+@brief XPath Query Interface
+@version 2.0
+
+@section LICENSE
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+@section DESCRIPTION
+
+An Interface for the XPath-like Query over the XNode Tree.
+
+*/
+#ifndef __EP_XPATH_QUERY_H__
+#define __EP_XPATH_QUERY_H__
+#include "epLib.h"
+#include "epSystem.h"
+#include "epXMLite.h"
+#include "epHashMap.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include <vector>
+
+namespace epl
+{
+	/*!
+	@class XNodeIndex epXPathQuery.h
+	@brief A class that indexes the child elements of the nodes by their names.
+
+	The index of the node is built when the node is looked up first,
+	so the repeated look-ups take the constant time instead of scanning the children.
+	@remark the index does not own the nodes, and must be invalidated when the children of the node indexed are modified.
+	*/
+	class EP_LIBRARY XNodeIndex
+	{
+	public:
+		friend class XPathQuery;
+
+		/*!
+		Default Constructor
+
+		Initializes the index
+		@param[in] lockPolicyType The lock policy
+		*/
+		XNodeIndex(LockPolicy lockPolicyType=EP_LOCK_POLICY);
+
+		/*!
+		Default Destructor
+
+		Destroy the index
+		*/
+		virtual ~XNodeIndex();
+
+		/*!
+		Return the first child element with the given name
+		@param[in] node the node to look up its children
+		@param[in] name the name of the child element
+		@return the child element, or NULL if not found
+		*/
+		LPXNode GetChild(LPXNode node, const TCHAR *name);
+
+		/*!
+		Return the child elements with the given name
+		@param[in] node the node to look up its children
+		@param[in] name the name of the child elements
+		@return the child elements in the document order
+		*/
+		XNodes GetChilds(LPXNode node, const TCHAR *name);
+
+		/*!
+		Remove the index of the given node, which is built again when looked up next
+		@param[in] node the node whose children are modified
+		*/
+		void Invalidate(LPXNode node);
+
+		/*!
+		Remove the indexes of all nodes
+		*/
+		void Clear();
+
+		/*!
+		Return the number of the nodes indexed
+		@return the number of the nodes indexed
+		*/
+		size_t GetIndexedNodeCount() const;
+
+	private:
+		/// type of the map from the name to the child elements
+		typedef HashMap<EpTString,XNodes> ChildNameMap;
+
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		XNodeIndex(const XNodeIndex & b){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XNodeIndex &operator=(const XNodeIndex & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Return the child elements with the given name, building the index of the node if not built
+		@param[in] node the node to look up its children
+		@param[in] name the name of the child elements
+		@return the child elements, or NULL if not found
+		@remark the lock must be held by the caller.
+		*/
+		const XNodes *findChilds(LPXNode node, const EpTString &name);
+
+		/// the map from the node to the index of its children
+		HashMap<LPXNode,ChildNameMap*> m_nodeMap;
+		/// the lock
+		BaseLock *m_indexLock;
+	};
+
+	/// Enumeration of the Axis of the XPath Step
+	typedef enum _xPathAxis{
+		/// the child elements, as "name"
+		XPATH_AXIS_CHILD=0,
+		/// the descendant elements, as "//name"
+		XPATH_AXIS_DESCENDANT,
+		/// the node itself, as "."
+		XPATH_AXIS_SELF,
+		/// the parent node, as ".."
+		XPATH_AXIS_PARENT,
+	}XPathAxis;
+
+	/// Enumeration of the XPath Predicate
+	typedef enum _xPathPredicateType{
+		/// [@attr] the attribute exists
+		XPATH_PREDICATE_TYPE_HAS_ATTR=0,
+		/// [@attr='value'] the attribute has the value
+		XPATH_PREDICATE_TYPE_ATTR_EQUALS,
+		/// [name] the child element exists
+		XPATH_PREDICATE_TYPE_HAS_CHILD,
+		/// [name='value'] the child element has the value
+		XPATH_PREDICATE_TYPE_CHILD_EQUALS,
+		/// [n] the n-th node of the step, starting from 1
+		XPATH_PREDICATE_TYPE_POSITION,
+	}XPathPredicateType;
+
+	/*!
+	@class XPathQuery epXPathQuery.h
+	@brief A class of the path query compiled, which selects the XNodes as the subset of the XPath.
+
+	The path is the steps separated by '/' or '//', and each step is a name, '*', '.' or '..' with the predicates such as
+	"/config/servers/server[@id]", "//server[@id='3']", "servers/server[2]" and "server[host='a']/port".
+	The path starting with '/' selects from the document of the context node, and the others select from the context node.
+	@remark the query is compiled once and may be selected from many threads, while XNodeIndex given is locked by itself.
+	*/
+	class EP_LIBRARY XPathQuery
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the empty query
+		*/
+		XPathQuery();
+
+		/*!
+		Default Constructor
+
+		Initializes the query compiled from the given path
+		@param[in] path the path to compile
+		*/
+		XPathQuery(const TCHAR *path);
+
+		/*!
+		Default Copy Constructor
+
+		Initializes the query
+		@param[in] b the second object
+		*/
+		XPathQuery(const XPathQuery& b);
+
+		/*!
+		Default Destructor
+
+		Destroy the query
+		*/
+		virtual ~XPathQuery();
+
+		/*!
+		Assignment operator overloading
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		XPathQuery & operator=(const XPathQuery&b);
+
+		/*!
+		Compile the given path
+		@param[in] path the path to compile
+		@return true if compiled, otherwise false if the path is not valid
+		*/
+		bool Compile(const TCHAR *path);
+
+		/*!
+		Return the flag whether the path is compiled
+		@return true if compiled, otherwise false
+		*/
+		bool IsValid() const;
+
+		/*!
+		Return the path compiled
+		@return the path
+		*/
+		const EpTString &GetPath() const;
+
+		/*!
+		Return the offset of the character where the path is not valid
+		@return the offset of the error from the start of the path
+		*/
+		size_t GetErrorOffset() const;
+
+		/*!
+		Select the nodes matched from the given context node
+		@param[in] context the context node
+		@param[in] index the index to look up the children, or NULL to scan the children
+		@return the nodes matched in the document order
+		*/
+		XNodes Select(LPXNode context, XNodeIndex *index=NULL) const;
+
+		/*!
+		Select the first node matched from the given context node
+		@param[in] context the context node
+		@param[in] index the index to look up the children, or NULL to scan the children
+		@return the first node matched, or NULL if nothing matched
+		*/
+		LPXNode SelectFirst(LPXNode context, XNodeIndex *index=NULL) const;
+
+	private:
+		/*!
+		@struct Predicate epXPathQuery.h
+		@brief A structure of the predicate compiled.
+		*/
+		struct Predicate
+		{
+			/// the type of the predicate
+			XPathPredicateType m_type;
+			/// the name of the attribute or the child element
+			EpTString m_name;
+			/// the value to compare
+			EpTString m_value;
+			/// the position starting from 1
+			size_t m_position;
+		};
+
+		/*!
+		@struct Step epXPathQuery.h
+		@brief A structure of the step compiled.
+		*/
+		struct Step
+		{
+			/// the axis of the step
+			XPathAxis m_axis;
+			/// the name of the elements, or empty for any
+			EpTString m_name;
+			/// the predicates of the step
+			std::vector<Predicate> m_predicates;
+		};
+
+		/*!
+		Select the nodes matched from the given step
+		@param[in] stepIdx the index of the step
+		@param[in] node the node to select from
+		@param[in] index the index to look up the children, or NULL
+		@param[in] firstOnly the flag whether to stop at the first node matched
+		@param[out] retNodes the nodes matched
+		*/
+		void select(size_t stepIdx, LPXNode node, XNodeIndex *index, bool firstOnly, XNodes &retNodes) const;
+
+		/*!
+		Collect the candidate nodes of the given step from the given node
+		@param[in] step the step
+		@param[in] node the node to select from
+		@param[in] index the index to look up the children, or NULL
+		@param[out] retNodes the candidate nodes
+		*/
+		static void collect(const Step &step, LPXNode node, XNodeIndex *index, XNodes &retNodes);
+
+		/*!
+		Return the flag whether the given node matches the given predicate
+		@param[in] predicate the predicate
+		@param[in] node the node to test
+		@param[in] index the index to look up the children, or NULL
+		@return true if matched, otherwise false
+		*/
+		static bool test(const Predicate &predicate, LPXNode node, XNodeIndex *index);
+
+		/*!
+		Set the error, and clear the steps compiled
+		@param[in] errorPos the position of the error
+		@param[in] path the path compiled
+		@return false
+		*/
+		bool setError(const TCHAR *errorPos, const TCHAR *path);
+
+		/// the path compiled
+		EpTString m_path;
+		/// the steps compiled
+		std::vector<Step> m_steps;
+		/// the flag whether the path starts from the document
+		bool m_isAbsolute;
+		/// the flag whether the path has the descendant or the parent step, which may select the same node twice
+		bool m_mayRepeat;
+		/// the flag whether the path is compiled
+		bool m_isValid;
+		/// the offset of the error
+		size_t m_errorOffset;
+	};
+}
+
+#endif //__EP_XPATH_QUERY_H__
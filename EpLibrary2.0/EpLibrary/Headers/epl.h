@@ -49,6 +49,8 @@ An Interface for EpLibrary Pre-compiled header
 #include "epInsertionSort.h"
 #include "epMergeSort.h"
 #include "epQuickSort.h"
+#include "epRadixSort.h"
+#include "epPartialSort.h"
 
 #include "epAlgorithm.h"
 
@@ -56,50 +58,100 @@ An Interface for EpLibrary Pre-compiled header
 #include "epFileStream.h"
 #include "epNetworkStream.h"
 #include "epStream.h"
+#include "epSerializer.h"
+#include "epFrameBatch.h"
+#include "epBlockCompress.h"
 
+#include "epQueueBound.h"
 #include "epThreadSafePQueue.h"
+#include "epThreadSafeHeapQueue.h"
 #include "epThreadSafeQueue.h"
+#include "epLockFreeQueue.h"
+#include "epSpscQueue.h"
+#include "epEpochReclaimer.h"
+#include "epObjectPool.h"
 
 #include "epCoroutine.h"
+#include "epCoroutineScheduler.h"
 #include "epCStringEx.h"
+#include "epStringView.h"
 #include "epDelegate.h"
 #include "epDynamicArray.h"
+#include "epHashMap.h"
+#include "epConcurrentHashMap.h"
+#include "epCache.h"
 
 //Debugger
 #include "epBaseOutputter.h"
+#include "epLatencyHistogram.h"
+#include "epMetrics.h"
 #include "epProfiler.h"
+#include "epLockProfiler.h"
+#include "epBenchmark.h"
+#include "epStreamBenchmark.h"
+#include "epIpcBenchmark.h"
+#include "epSyncBenchmark.h"
+#include "epContainerBenchmark.h"
+#include "epJobBenchmark.h"
 #include "epSimpleLogger.h"
 
 //File System
 #include "epBinaryFile.h"
+#include "epFileIoJob.h"
+#include "epRecordLog.h"
 #include "epBaseTextFile.h"
+#include "epTextLineReader.h"
+#include "epUnicodeHelper.h"
 #include "epFolderHelper.h"
 #include "epPropertiesFile.h"
 #include "epXMLFile.h"
 #include "epXMLite.h"
+#include "epXMLPullParser.h"
+#include "epXMLView.h"
+#include "epXMLViewFile.h"
+#include "epXPathQuery.h"
+#include "epXMLStreamWriter.h"
 #include "epTextFile.h"
 #include "epLogWriter.h"
 
 //IPC
 #include "epIpcClient.h"
+#include "epIpcClientPool.h"
+#include "epIpcCoroutineReader.h"
 #include "epIpcClientInterfaces.h"
 #include "epIpcConf.h"
+#include "epIpcMetrics.h"
 #include "epIpcPipe.h"
+#include "epIpcRpc.h"
 #include "epIpcServer.h"
 #include "epIpcServerInterfaces.h"
+#include "epShmIpcClient.h"
+#include "epShmIpcConf.h"
+#include "epShmIpcPipe.h"
+#include "epShmIpcServer.h"
+#include "epUdsIpcClient.h"
+#include "epUdsIpcConf.h"
+#include "epUdsIpcPipe.h"
+#include "epUdsIpcServer.h"
 
 //Frameworks
 #include "epBaseLock.h"
 #include "epCriticalSectionEx.h"
 #include "epEventEx.h"
+#include "epLightEvent.h"
 #include "epMutex.h"
 #include "epSemaphore.h"
+#include "epLightSemaphore.h"
 #include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include "epInlineLock.h"
 #include "epInterlockedEx.h"
 #include "epCmdLineOptions.h"
 
 #include "epSingletonHolder.h"
 #include "epSmartObject.h"
+#include "epSmartPtr.h"
 #include "epThreadSafeClass.h"
 
 //GUI
@@ -112,9 +164,15 @@ An Interface for EpLibrary Pre-compiled header
 #include "epLocale.h"
 #include "epConsoleHelper.h"
 #include "epDateTimeHelper.h"
+#include "epClock.h"
 #include "epEndian.h"
+#include "epCrc32c.h"
 #include "epMemory.h"
+#include "epArena.h"
+#include "epVirtualBuffer.h"
+#include "epMemoryTracker.h"
 #include "epPlatform.h"
+#include "epPlatformSync.h"
 #include "epRegistryHelper.h"
 #include "epSystem.h"
 #include "epTinyObject.h"
@@ -122,7 +180,11 @@ An Interface for EpLibrary Pre-compiled header
 
 //Thread System
 #include "epBaseJob.h"
+#include "epJobPool.h"
+#include "epCancellationToken.h"
 #include "epBaseJobProcessor.h"
+#include "epJobHandle.h"
+#include "epJobGraph.h"
 
 #include "epJobScheduleQueue.h"
 
@@ -130,8 +192,13 @@ An Interface for EpLibrary Pre-compiled header
 #include "epWorkerThreadSingle.h"
 
 #include "epBaseWorkerThread.h"
+#include "epWorkerMetrics.h"
 #include "epWorkerThreadDelegate.h"
 #include "epWorkerThreadFactory.h"
+#include "epThreadPool.h"
+#include "epTimerService.h"
+#include "epParallel.h"
+#include "epElasticWorkerPool.h"
 #include "epThread.h"
 
 #endif //__EP_EPL_H__
\ No newline at end of file
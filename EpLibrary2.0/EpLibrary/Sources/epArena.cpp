@@ -0,0 +1,227 @@
+/*! 
+Arena for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epArena.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the size of the block header, which keeps the data of the block aligned
+#define ARENA_BLOCK_HEADER_SIZE ((sizeof(Block)+15)&~static_cast<size_t>(15))
+
+Arena::Arena(size_t blockSize, LockPolicy lockPolicyType)
+{
+	EP_ASSERT_EXPR(blockSize>0,_T("The block size must be greater than 0."));
+	m_blockSize=blockSize;
+	m_currentBlock=NULL;
+	m_usedBlocks=NULL;
+	m_freeBlocks=NULL;
+	m_destructors=NULL;
+	m_usedSize=0;
+	m_reservedSize=0;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_arenaLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_arenaLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_arenaLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_arenaLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_arenaLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_arenaLock=NULL;
+		break;
+	}
+}
+
+Arena::~Arena()
+{
+	Release();
+	if(m_arenaLock)
+		EP_DELETE m_arenaLock;
+}
+
+void *Arena::Allocate(size_t size, size_t alignment)
+{
+	LockObj lock(m_arenaLock);
+	return allocate(size,alignment);
+}
+
+void Arena::Reset()
+{
+	LockObj lock(m_arenaLock);
+	destroyAll();
+	if(m_currentBlock)
+	{
+		m_currentBlock->m_next=m_usedBlocks;
+		m_usedBlocks=m_currentBlock;
+		m_currentBlock=NULL;
+	}
+	while(m_usedBlocks)
+	{
+		Block *block=m_usedBlocks;
+		m_usedBlocks=block->m_next;
+		if(block->m_size==m_blockSize)
+		{
+			block->m_used=0;
+			block->m_next=m_freeBlocks;
+			m_freeBlocks=block;
+		}
+		else
+		{
+			m_reservedSize-=block->m_size;
+			EP_Free(block);
+		}
+	}
+	m_usedSize=0;
+}
+
+void Arena::Release()
+{
+	Reset();
+	LockObj lock(m_arenaLock);
+	while(m_freeBlocks)
+	{
+		Block *block=m_freeBlocks;
+		m_freeBlocks=block->m_next;
+		m_reservedSize-=block->m_size;
+		EP_Free(block);
+	}
+}
+
+size_t Arena::GetUsedSize() const
+{
+	SharedLockObj lock(m_arenaLock);
+	return m_usedSize;
+}
+
+size_t Arena::GetReservedSize() const
+{
+	SharedLockObj lock(m_arenaLock);
+	return m_reservedSize;
+}
+
+size_t Arena::GetBlockSize() const
+{
+	return m_blockSize;
+}
+
+void Arena::registerDestructor(void *obj, size_t count, DestroyFunc destroyFunc)
+{
+	LockObj lock(m_arenaLock);
+	Destructor *destructor=reinterpret_cast<Destructor*>(allocate(sizeof(Destructor),__alignof(Destructor)));
+	destructor->m_destroyFunc=destroyFunc;
+	destructor->m_obj=obj;
+	destructor->m_count=count;
+	destructor->m_next=m_destructors;
+	m_destructors=destructor;
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+	EP_ASSERT_EXPR(alignment>0 && (alignment&(alignment-1))==0,_T("The alignment must be the power of 2."));
+	if(m_currentBlock)
+	{
+		size_t base=reinterpret_cast<size_t>(blockData(m_currentBlock));
+		size_t retAddr=(base+m_currentBlock->m_used+alignment-1)&~(alignment-1);
+		if(retAddr-base+size<=m_currentBlock->m_size)
+		{
+			m_currentBlock->m_used=retAddr-base+size;
+			m_usedSize+=size;
+			return reinterpret_cast<void*>(retAddr);
+		}
+	}
+
+	Block *block;
+	if(size+alignment>m_blockSize)
+	{
+		// the large memory gets its own block, and the current block keeps allocating
+		block=allocateBlock(size+alignment);
+		block->m_next=m_usedBlocks;
+		m_usedBlocks=block;
+	}
+	else
+	{
+		if(m_currentBlock)
+		{
+			m_currentBlock->m_next=m_usedBlocks;
+			m_usedBlocks=m_currentBlock;
+		}
+		if(m_freeBlocks)
+		{
+			block=m_freeBlocks;
+			m_freeBlocks=block->m_next;
+		}
+		else
+			block=allocateBlock(m_blockSize);
+		block->m_next=NULL;
+		m_currentBlock=block;
+	}
+	size_t base=reinterpret_cast<size_t>(blockData(block));
+	size_t retAddr=(base+alignment-1)&~(alignment-1);
+	block->m_used=retAddr-base+size;
+	m_usedSize+=size;
+	return reinterpret_cast<void*>(retAddr);
+}
+
+void Arena::destroyAll()
+{
+	while(m_destructors)
+	{
+		Destructor *destructor=m_destructors;
+		m_destructors=destructor->m_next;
+		destructor->m_destroyFunc(destructor->m_obj,destructor->m_count);
+	}
+}
+
+Arena::Block *Arena::allocateBlock(size_t dataSize)
+{
+	Block *retBlock=reinterpret_cast<Block*>(EP_Malloc(ARENA_BLOCK_HEADER_SIZE+dataSize));
+	EP_ASSERT_EXPR(retBlock,_T("Allocation Failed"));
+	retBlock->m_next=NULL;
+	retBlock->m_size=dataSize;
+	retBlock->m_used=0;
+	m_reservedSize+=dataSize;
+	return retBlock;
+}
+
+unsigned char *Arena::blockData(Block *block)
+{
+	return reinterpret_cast<unsigned char*>(block)+ARENA_BLOCK_HEADER_SIZE;
+}
\ No newline at end of file
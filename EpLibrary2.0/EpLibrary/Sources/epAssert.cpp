@@ -0,0 +1,92 @@
+/*! 
+Assert for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epAssert.h"
+#include <stdio.h>
+#include <stdarg.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/*!
+Report the failed assertion with the message formatted.
+@param[in] expression the expression failed
+@param[in] fileName the name of the source file of the assertion
+@param[in] lineNumber the line number of the assertion
+@param[in] message the message formatted
+*/
+static void reportFailure(const wchar_t *expression, const wchar_t *fileName, unsigned int lineNumber, const wchar_t *message)
+{
+	int len=_scwprintf(L"%s\r\n\r\nMessage: %s",expression,message)+1;
+	wchar_t *report=EP_NEW wchar_t[len];
+	swprintf_s(report,len,L"%s\r\n\r\nMessage: %s",expression,message);
+	(void)( (_wassert(report,fileName,lineNumber), 0) );
+	EP_DELETE[] report;
+}
+
+void Assert::Fail(const wchar_t *expression, const wchar_t *fileName, unsigned int lineNumber, const wchar_t *formatString, ...)
+{
+	va_list args;
+	va_start(args,formatString);
+	int len=_vscwprintf(formatString,args)+1;
+	va_end(args);
+	wchar_t *message=EP_NEW wchar_t[len];
+	va_start(args,formatString);
+	vswprintf_s(message,len,formatString,args);
+	va_end(args);
+	reportFailure(expression,fileName,lineNumber,message);
+	EP_DELETE[] message;
+}
+
+void Assert::Fail(const wchar_t *expression, const wchar_t *fileName, unsigned int lineNumber, const char *formatString, ...)
+{
+	va_list args;
+	va_start(args,formatString);
+	int len=_vscprintf(formatString,args)+1;
+	va_end(args);
+	char *message=EP_NEW char[len];
+	va_start(args,formatString);
+	vsprintf_s(message,len,formatString,args);
+	va_end(args);
+
+	wchar_t *wideMessage=EP_NEW wchar_t[len];
+	size_t convertedCount=0;
+	mbstowcs_s(&convertedCount,wideMessage,len,message,_TRUNCATE);
+	reportFailure(expression,fileName,lineNumber,wideMessage);
+	EP_DELETE[] wideMessage;
+	EP_DELETE[] message;
+}
+
+void Assert::Fatal(const char *message)
+{
+	fprintf(stderr,"%s\n",message);
+	fflush(stderr);
+	abort();
+}
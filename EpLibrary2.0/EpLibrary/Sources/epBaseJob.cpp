@@ -24,8 +24,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epBaseJob.h"
+#include "epJobHandle.h"
+#include "epJobGraph.h"
+#include "epWorkerMetrics.h"
+#include "epBaseJobProcessor.h"
+#include "epJobPool.h"
 #include "epSystem.h"
 #include "epSingletonHolder.h"
+#include "epClock.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -40,10 +46,29 @@ BaseJob::BaseJob(Priority priority,LockPolicy lockPolicyType):SmartObject(lockPo
 	//SingletonHolder<JobPool>::Instance().insert(this);	
 	m_status=JOB_STATUS_NONE;
 	m_priority=priority;
+	m_handle=NULL;
+	m_graph=NULL;
+	m_graphNodeIdx=0;
+	m_cancellationToken=NULL;
+	m_isCancelled=0;
+	m_deadlineStartTick=0;
+	m_deadlineTime=WAITTIME_INIFINITE;
+	m_enqueueTime=0;
+	m_jobProcessor=NULL;
+	m_pool=NULL;
 }
 
 BaseJob::~BaseJob(){
 	//SingletonHolder<JobPool>::Instance().remove(this);		
+	if(m_handle)
+	{
+		m_handle->complete(JOB_STATUS_INCOMPLETE);
+		m_handle->ReleaseObj();
+	}
+	if(m_cancellationToken)
+		m_cancellationToken->ReleaseObj();
+	if(m_jobProcessor)
+		m_jobProcessor->ReleaseObj();
 }
 
 BaseJob::JobStatus BaseJob::GetStatus() const
@@ -61,10 +86,157 @@ void BaseJob::SetPriority(Priority newPrio)
 	m_priority=newPrio;
 }
 
+JobHandle *BaseJob::GetHandle()
+{
+	JobHandle *handle=m_handle;
+	if(!handle)
+	{
+		JobHandle *newHandle=EP_NEW JobHandle();
+		handle=reinterpret_cast<JobHandle*>(InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(&m_handle),newHandle,NULL));
+		if(handle)
+			newHandle->ReleaseObj();
+		else
+			handle=newHandle;
+	}
+	handle->RetainObj();
+	// the job may have finished before the handle was published
+	JobStatus status=m_status;
+	if(isFinalStatus(status))
+		handle->complete(status);
+	return handle;
+}
+
+void BaseJob::SetJobProcessor(BaseJobProcessor *jobProcessor)
+{
+	if(jobProcessor)
+		jobProcessor->RetainObj();
+	if(m_jobProcessor)
+		m_jobProcessor->ReleaseObj();
+	m_jobProcessor=jobProcessor;
+}
+
+BaseJobProcessor *BaseJob::GetJobProcessor() const
+{
+	return m_jobProcessor;
+}
+
+void BaseJob::Cancel()
+{
+	InterlockedExchange(&m_isCancelled,1);
+}
+
+bool BaseJob::IsCancelled() const
+{
+	if(m_isCancelled)
+		return true;
+	CancellationToken *token=m_cancellationToken;
+	return token && token->IsCancelled();
+}
+
+void BaseJob::SetCancellationToken(CancellationToken *token)
+{
+	if(token)
+		token->RetainObj();
+	if(m_cancellationToken)
+		m_cancellationToken->ReleaseObj();
+	m_cancellationToken=token;
+}
+
+CancellationToken *BaseJob::GetCancellationToken() const
+{
+	return m_cancellationToken;
+}
+
+void BaseJob::SetDeadline(unsigned int timeoutInMilliSec)
+{
+	m_deadlineStartTick=Clock::GetMilliSec();
+	m_deadlineTime=timeoutInMilliSec;
+}
+
+bool BaseJob::IsExpired() const
+{
+	if(m_deadlineTime==WAITTIME_INIFINITE)
+		return false;
+	return Clock::GetMilliSec()-m_deadlineStartTick>=static_cast<__int64>(m_deadlineTime);
+}
+
+bool BaseJob::dropIfStale()
+{
+	if(IsCancelled())
+	{
+		JobReport(JOB_STATUS_CANCELLED);
+		return true;
+	}
+	if(IsExpired())
+	{
+		JobReport(JOB_STATUS_TIMEOUT);
+		return true;
+	}
+	return false;
+}
+
+bool BaseJob::recycleObj()
+{
+	BaseJobPool *pool=m_pool;
+	if(!pool)
+		return false;
+	if(m_handle)
+	{
+		m_handle->complete(JOB_STATUS_INCOMPLETE);
+		m_handle->ReleaseObj();
+		m_handle=NULL;
+	}
+	SetCancellationToken(NULL);
+	SetJobProcessor(NULL);
+	m_isCancelled=0;
+	m_deadlineStartTick=0;
+	m_deadlineTime=WAITTIME_INIFINITE;
+	m_enqueueTime=0;
+	m_graph=NULL;
+	m_graphNodeIdx=0;
+	m_status=JOB_STATUS_NONE;
+	m_priority=PRIORITY_NORMAL;
+	handleRecycle();
+	return pool->recycleJob(this);
+}
+
 void BaseJob::JobReport(const JobStatus status)
 {
 	handleReport(status);
 	m_status=status;
+	if(status==JOB_STATUS_IN_QUEUE)
+		m_enqueueTime=WorkerMetrics::GetCurrentMicroSec();
+	JobHandle *handle=reinterpret_cast<JobHandle*>(InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(&m_handle),NULL,NULL));
+	if(handle)
+	{
+		if(isFinalStatus(status))
+		{
+			handle->complete(status);
+		}
+		else if(status==JOB_STATUS_IN_QUEUE && handle->IsReady())
+		{
+			// queued again after completion, so detach the old handle for the new submission
+			if(InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(&m_handle),NULL,handle)==handle)
+				handle->ReleaseObj();
+		}
+	}
+	if(m_graph && isFinalStatus(status))
+		m_graph->onJobFinished(m_graphNodeIdx,status);
+}
+
+bool BaseJob::isFinalStatus(const JobStatus status)
+{
+	switch(status)
+	{
+	case JOB_STATUS_DONE:
+	case JOB_STATUS_INCOMPLETE:
+	case JOB_STATUS_JOB_PROCESSOR_TIMEOUT:
+	case JOB_STATUS_TIMEOUT:
+	case JOB_STATUS_CANCELLED:
+		return true;
+	default:
+		return false;
+	}
 }
 
 CompResultType BaseJob::CompFunc(const void *a,const void *b)
@@ -81,4 +253,9 @@ CompResultType BaseJob::CompFunc(const void *a,const void *b)
 void BaseJob::handleReport(const JobStatus status)
 {
 
+}
+
+void BaseJob::handleRecycle()
+{
+
 }
\ No newline at end of file
@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include "epBaseLock.h"
 #include "epSystem.h"
 #include "epException.h"
+#include "epLockProfiler.h"
+#include "epWorkerMetrics.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -38,11 +40,82 @@ using namespace epl;
 
 BaseLock::BaseLock()
 {
+	m_profileStat=NULL;
+}
 
+BaseLock::BaseLock(const BaseLock& b)
+{
+	m_profileStat=NULL;
 }
 
 BaseLock::~BaseLock()
 {
+	if(m_profileStat)
+		LOCK_PROFILE_INSTANCE.unregisterLock(this);
+}
+
+BaseLock & BaseLock::operator=(const BaseLock&b)
+{
+	return *this;
+}
+
+void BaseLock::SetProfileName(const TCHAR *name)
+{
+	EP_ASSERT_EXPR(name,_T("Name is NULL!"));
+	m_profileStat=LOCK_PROFILE_INSTANCE.registerLock(this,name);
+}
+
+bool BaseLock::ProfiledLock()
+{
+	LockProfileStat *profileStat=m_profileStat;
+	if(!profileStat)
+		return Lock();
+
+	__int64 waitTime=-1;
+	if(!TryLock())
+	{
+		__int64 startTime=WorkerMetrics::GetCurrentMicroSec();
+		if(!Lock())
+			return false;
+		waitTime=WorkerMetrics::GetCurrentMicroSec()-startTime;
+	}
+	// the statistics are serialized by this lock itself
+	profileStat->acquireCount++;
+	if(waitTime>=0)
+	{
+		profileStat->contendedCount++;
+		profileStat->totalWaitTime+=waitTime;
+	}
+	if(profileStat->holdDepth++==0)
+		profileStat->holdStartTime=WorkerMetrics::GetCurrentMicroSec();
+	return true;
+}
+
+void BaseLock::ProfiledUnlock()
+{
+	LockProfileStat *profileStat=m_profileStat;
+	if(profileStat && profileStat->holdDepth>0 && --profileStat->holdDepth==0)
+	{
+		__int64 holdTime=WorkerMetrics::GetCurrentMicroSec()-profileStat->holdStartTime;
+		if(holdTime>profileStat->maxHoldTime)
+			profileStat->maxHoldTime=holdTime;
+	}
+	Unlock();
+}
+
+bool BaseLock::LockShared()
+{
+	return Lock();
+}
+
+long BaseLock::TryLockShared()
+{
+	return TryLock();
+}
+
+void BaseLock::UnlockShared()
+{
+	Unlock();
 }
 
 BaseLock::BaseLockObj::BaseLockObj(BaseLock *lock)
@@ -50,14 +123,14 @@ BaseLock::BaseLockObj::BaseLockObj(BaseLock *lock)
 	EP_ASSERT_EXPR(lock,_T("Lock is NULL!"));
 	m_lock=lock;
 	if(m_lock)
-		m_lock->Lock();
+		m_lock->ProfiledLock();
 }
 
 BaseLock::BaseLockObj::~BaseLockObj()
 {
 	if(m_lock)
 	{
-		m_lock->Unlock();
+		m_lock->ProfiledUnlock();
 	}
 }
 BaseLock::BaseLockObj &BaseLock::BaseLockObj::operator=(const BaseLockObj & b)
@@ -66,7 +139,7 @@ BaseLock::BaseLockObj &BaseLock::BaseLockObj::operator=(const BaseLockObj & b)
 	{
 		if(m_lock)
 		{
-			m_lock->Unlock();
+			m_lock->ProfiledUnlock();
 			m_lock=NULL;
 		}
 		m_lock=b.m_lock;
@@ -80,3 +153,23 @@ BaseLock::BaseLockObj::BaseLockObj()
 	m_lock=NULL;
 }
 
+BaseLock::BaseSharedLockObj::BaseSharedLockObj(BaseLock *lock)
+{
+	EP_ASSERT_EXPR(lock,_T("Lock is NULL!"));
+	m_lock=lock;
+	if(m_lock)
+		m_lock->LockShared();
+}
+
+BaseLock::BaseSharedLockObj::~BaseSharedLockObj()
+{
+	if(m_lock)
+	{
+		m_lock->UnlockShared();
+	}
+}
+
+BaseLock::BaseSharedLockObj::BaseSharedLockObj()
+{
+	m_lock=NULL;
+}
@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 #include "epBaseOutputter.h"
 #include "epException.h"
+#include "epThread.h"
 using namespace epl;
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
@@ -35,6 +36,57 @@ static char THIS_FILE[] = __FILE__;
 
 DECLARE_THREAD_SAFE_CLASS(System);
 
+namespace epl
+{
+	/*! 
+	@class OutputterFlushThread epBaseOutputter.cpp
+	@brief A background thread calling FlushToFile of BaseOutputter periodically.
+	*/
+	class OutputterFlushThread:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] outputter the outputter to flush.
+		*/
+		OutputterFlushThread(BaseOutputter &outputter):Thread(),m_outputter(outputter)
+		{
+			m_isStopping=false;
+		}
+
+		/*!
+		Stop the thread, and wait until it ends.
+		*/
+		void Stop()
+		{
+			m_isStopping=true;
+			m_outputter.m_flushEvent.SetEvent();
+			WaitFor();
+		}
+
+	protected:
+		/*!
+		Flush the outputter on every flush interval until stopped.
+		*/
+		virtual void execute()
+		{
+			while(true)
+			{
+				WaitForSingleObject(m_outputter.m_flushEvent.GetEventHandle(),m_outputter.m_flushInterval);
+				if(m_isStopping)
+					break;
+				m_outputter.FlushToFile();
+			}
+		}
+
+	private:
+		/// the outputter to flush
+		BaseOutputter &m_outputter;
+		/// the flag whether the thread is stopping
+		volatile bool m_isStopping;
+	};
+}
+
 BaseOutputter::OutputNode::OutputNode()
 {}
 BaseOutputter::OutputNode::OutputNode(const OutputNode& b)
@@ -43,53 +95,88 @@ BaseOutputter::OutputNode::~OutputNode()
 {}
 
 
-BaseOutputter::BaseOutputter(LockPolicy lockPolicyType)
+BaseOutputter::BaseOutputter(LockPolicy lockPolicyType):m_flushEvent(false,false)
 {
 	m_lockPolicy=lockPolicyType;
 	switch(lockPolicyType)
 	{
 	case LOCK_POLICY_CRITICALSECTION:
 		m_nodeListLock=EP_NEW CriticalSectionEx();
+		m_flushLock=EP_NEW CriticalSectionEx();
 		break;
 	case LOCK_POLICY_MUTEX:
 		m_nodeListLock=EP_NEW Mutex();
+		m_flushLock=EP_NEW Mutex();
 		break;
 	case LOCK_POLICY_NONE:
 		m_nodeListLock=EP_NEW NoLock();
+		m_flushLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_nodeListLock=EP_NEW SpinParkLock();
+		m_flushLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_nodeListLock=EP_NEW ReaderWriterLock();
+		m_flushLock=EP_NEW ReaderWriterLock();
 		break;
 	default:
 		m_nodeListLock=NULL;
+		m_flushLock=NULL;
 		break;
 	}
+	m_isIncrementalFlush=false;
+	m_flushThread=NULL;
+	m_flushInterval=OUTPUTTER_DEFAULT_FLUSH_INTERVAL;
 }
-BaseOutputter::BaseOutputter(const BaseOutputter& b)
+BaseOutputter::BaseOutputter(const BaseOutputter& b):m_flushEvent(false,false)
 {
 	m_lockPolicy=b.m_lockPolicy;
 	switch(m_lockPolicy)
 	{
 	case LOCK_POLICY_CRITICALSECTION:
 		m_nodeListLock=EP_NEW CriticalSectionEx();
+		m_flushLock=EP_NEW CriticalSectionEx();
 		break;
 	case LOCK_POLICY_MUTEX:
 		m_nodeListLock=EP_NEW Mutex();
+		m_flushLock=EP_NEW Mutex();
 		break;
 	case LOCK_POLICY_NONE:
 		m_nodeListLock=EP_NEW NoLock();
+		m_flushLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_nodeListLock=EP_NEW SpinParkLock();
+		m_flushLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_nodeListLock=EP_NEW ReaderWriterLock();
+		m_flushLock=EP_NEW ReaderWriterLock();
 		break;
 	default:
 		m_nodeListLock=NULL;
+		m_flushLock=NULL;
 		break;
 	}
 	m_fileName=b.m_fileName;
+	// the background thread belongs to the original
+	m_flushThread=NULL;
+	m_flushInterval=b.m_flushInterval;
 	LockObj lock(b.m_nodeListLock);
+	m_isIncrementalFlush=b.m_isIncrementalFlush;
 	m_list=b.m_list;
 }
 BaseOutputter::~BaseOutputter()
 {
+	StopFlushThread();
 	Clear();
 	if(m_nodeListLock)
 		EP_DELETE m_nodeListLock;
 	m_nodeListLock=NULL;
+	if(m_flushLock)
+		EP_DELETE m_flushLock;
+	m_flushLock=NULL;
 }
 BaseOutputter & BaseOutputter::operator=(const BaseOutputter&b)
 {
@@ -112,12 +199,19 @@ BaseOutputter & BaseOutputter::operator=(const BaseOutputter&b)
 		case LOCK_POLICY_NONE:
 			m_nodeListLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_nodeListLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_nodeListLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_nodeListLock=NULL;
 			break;
 		}
 		m_fileName=b.m_fileName;
 		LockObj lock(b.m_nodeListLock);
+		m_isIncrementalFlush=b.m_isIncrementalFlush;
 		m_list=b.m_list;
 	}
 	return *this;
@@ -145,25 +239,101 @@ void BaseOutputter::Print() const
 }
 void BaseOutputter::FlushToFile()
 {
-	LockObj lock(m_nodeListLock);
+	if(!m_isIncrementalFlush)
+	{
+		LockObj lock(m_nodeListLock);
+		EpFile *file=NULL;
+		System::FTOpen(file,m_fileName.c_str(),_T("at"));
+		EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),m_fileName.c_str());
+		writeToFile(file,m_list);
+		System::FClose(file);
+		return;
+	}
+
+	// the flush lock keeps the batches in order, while the producers only wait for the swap
+	LockObj flushLock(m_flushLock);
+	std::vector<OutputNode*> nodeList;
+	EpTString fileName;
+	{
+		LockObj lock(m_nodeListLock);
+		nodeList.swap(m_list);
+		fileName=m_fileName;
+	}
+	if(!nodeList.size())
+		return;
 	EpFile *file=NULL;
-	System::FTOpen(file,m_fileName.c_str(),_T("at"));
-	EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),m_fileName.c_str());
-	writeToFile(file);
-	System::FClose(file);
+	System::FTOpen(file,fileName.c_str(),_T("at"));
+	EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),fileName.c_str());
+	writeToFile(file,nodeList);
+	if(file)
+		System::FClose(file);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=nodeList.begin();iter!=nodeList.end();iter++)
+	{
+		EP_DELETE (*iter);
+	}
+}
+
+void BaseOutputter::StartFlushThread(unsigned int flushInterval)
+{
+	LockObj lock(m_nodeListLock);
+	m_flushInterval=flushInterval;
+	if(!m_flushThread)
+	{
+		m_flushThread=EP_NEW OutputterFlushThread(*this);
+		m_flushThread->Start();
+	}
+	else
+	{
+		// wake the thread so the new interval takes effect at once
+		m_flushEvent.SetEvent();
+	}
+}
+
+void BaseOutputter::StopFlushThread()
+{
+	OutputterFlushThread *flushThread;
+	{
+		LockObj lock(m_nodeListLock);
+		flushThread=m_flushThread;
+		m_flushThread=NULL;
+	}
+	// the thread is stopped without the lock, since its flush takes the lock
+	if(flushThread)
+	{
+		flushThread->Stop();
+		EP_DELETE flushThread;
+	}
+}
+
+bool BaseOutputter::IsFlushThreadStarted() const
+{
+	LockObj lock(m_nodeListLock);
+	return m_flushThread!=NULL;
+}
+
+void BaseOutputter::setIncrementalFlush(bool isIncremental)
+{
+	LockObj lock(m_nodeListLock);
+	m_isIncrementalFlush=isIncremental;
 }
 void BaseOutputter::SetFileName(const TCHAR *fileName)
 {
 	LockObj lock(m_nodeListLock);
 	m_fileName=fileName;
 }
-void BaseOutputter::writeToFile(EpFile* const file)
+void BaseOutputter::SetLockProfileName(const TCHAR *name)
+{
+	if(m_nodeListLock)
+		m_nodeListLock->SetProfileName(name);
+}
+void BaseOutputter::writeToFile(EpFile* const file, const std::vector<OutputNode*> &nodeList)
 {
 	if(file)
 	{		
 		System::FTPrintf(file,_T("Log Starts...\n"));
-		std::vector<OutputNode*>::iterator iter;
-		for(iter=m_list.begin();iter!=m_list.end();iter++)
+		std::vector<OutputNode*>::const_iterator iter;
+		for(iter=nodeList.begin();iter!=nodeList.end();iter++)
 		{
 			(*iter)->Write(file);
 		}
@@ -24,6 +24,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epBaseTextFile.h"
+#include "epJobHandle.h"
+#include "epThreadPool.h"
+#include "epUnicodeHelper.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -33,6 +36,58 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+namespace epl
+{
+	/*! 
+	@class BaseTextFileIoJob epBaseTextFile.cpp
+	@brief A helper job which performs the file I/O of the BaseTextFile on the I/O pool.
+	*/
+	class BaseTextFileIoJob: public FileIoJob
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the job
+		@param[in] file the file object to perform the file I/O.
+		@param[in] ioType the type of the file I/O
+		@param[in] fileName the name of the file
+		@param[in] callBackObj the callback object to report the result.
+		*/
+		BaseTextFileIoJob(BaseTextFile *file, FileIoType ioType, const TCHAR *fileName, FileIoCallbackInterface *callBackObj):FileIoJob(ioType,fileName,callBackObj)
+		{
+			m_file=file;
+		}
+
+	protected:
+		/*!
+		Perform the file I/O on the file object.
+		@return true if the file I/O succeeded, otherwise false.
+		*/
+		virtual bool doIo()
+		{
+			switch(GetIoType())
+			{
+			case FILE_IO_TYPE_SAVE:
+				return m_file->SaveToFile(GetFileName());
+			case FILE_IO_TYPE_APPEND:
+				return m_file->AppendToFile(GetFileName());
+			case FILE_IO_TYPE_LOAD:
+				return m_file->LoadFromFile(GetFileName());
+			default:
+				return false;
+			}
+		}
+
+	private:
+		/// the file object
+		BaseTextFile *m_file;
+	};
+}
+
+/// the byte order mark of the UTF-8 file
+static const char s_utf8ByteOrderMark[]={'\xEF','\xBB','\xBF'};
+
 BaseTextFile::BaseTextFile(FileEncodingType encodingType,LockPolicy lockPolicyType)
 {
 	m_encodingType=encodingType;
@@ -49,6 +104,12 @@ BaseTextFile::BaseTextFile(FileEncodingType encodingType,LockPolicy lockPolicyTy
 	case LOCK_POLICY_NONE:
 		m_baseTextLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_baseTextLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_baseTextLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_baseTextLock=NULL;
 		break;
@@ -70,6 +131,12 @@ BaseTextFile::BaseTextFile(const BaseTextFile& b)
 	case LOCK_POLICY_NONE:
 		m_baseTextLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_baseTextLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_baseTextLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_baseTextLock=NULL;
 		break;
@@ -103,6 +170,12 @@ BaseTextFile & BaseTextFile::operator=(const BaseTextFile&b)
 		case LOCK_POLICY_NONE:
 			m_baseTextLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_baseTextLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_baseTextLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_baseTextLock=NULL;
 			break;
@@ -113,21 +186,32 @@ BaseTextFile & BaseTextFile::operator=(const BaseTextFile&b)
 
 void BaseTextFile::writeToFile(const TCHAR *toFileString)
 {
-	size_t strLength=System::TcsLen(toFileString);
+	writeToFile(toFileString,System::TcsLen(toFileString));
+}
+
+void BaseTextFile::writeToFile(const TCHAR *toFileString, size_t strLength)
+{
+	if(!strLength)
+		return;
 	if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
 	{	
 #if defined(_UNICODE) || defined(UNICODE)
-		size_t sizeNeeded= System::WideCharToMultiByte(toFileString,(char*)NULL);
-		char *multiByteToFile = EP_NEW char[sizeNeeded+1];
-		System::Memset(multiByteToFile,0,sizeNeeded+1);
-		System::WideCharToMultiByte(toFileString,multiByteToFile);
+		EpString multiByteToFile=System::WideCharToMultiByte(toFileString,static_cast<int>(strLength));
 		if(m_file)
-			System::FWrite(multiByteToFile,sizeof(char),sizeNeeded,m_file);
-		EP_DELETE[] multiByteToFile;
+			System::FWrite(multiByteToFile.c_str(),sizeof(char),multiByteToFile.size(),m_file);
 #else// defined(_UNICODE) || defined(UNICODE)
 		if(m_file)
 			System::FWrite(toFileString,sizeof(char),strLength,m_file);
 #endif// defined(_UNICODE) || defined(UNICODE)
+	}
+	else if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		writeUtf8ToFile(toFileString,strLength);
+#else //defined(_UNICODE) || defined(UNICODE)
+		EpWString wideToFile=System::MultiByteToWideChar(toFileString,static_cast<int>(strLength));
+		writeUtf8ToFile(wideToFile.c_str(),wideToFile.size());
+#endif //defined(_UNICODE) || defined(UNICODE)
 	}
 	else
 	{
@@ -135,17 +219,39 @@ void BaseTextFile::writeToFile(const TCHAR *toFileString)
 		if(m_file)
 			System::FWrite(toFileString,sizeof(wchar_t),strLength,m_file);
 #else //defined(_UNICODE) || defined(UNICODE)
-		size_t sizeNeeded=System::MultiByteToWideChar(toFileString,(wchar_t*)NULL);
-		wchar_t *wideCharToFile = EP_NEW wchar_t[sizeNeeded+1];
-
-		System::Memset(wideCharToFile,0,(sizeNeeded+1)*sizeof(wchar_t));
-		System::MultiByteToWideChar(toFileString,wideCharToFile);
+		EpWString wideCharToFile=System::MultiByteToWideChar(toFileString,static_cast<int>(strLength));
 		if(m_file)
-			System::FWrite(toFileString,sizeof(wchar_t),sizeNeeded,m_file);
-		EP_DELETE[] wideCharToFile;
+			System::FWrite(wideCharToFile.c_str(),sizeof(wchar_t),wideCharToFile.size(),m_file);
 #endif //defined(_UNICODE) || defined(UNICODE)
 	}
 }
+
+void BaseTextFile::writeUtf8ToFile(const wchar_t *wideString, size_t charCount)
+{
+	if(!charCount || !m_file)
+		return;
+	// each character takes 3 bytes at most, and each new line is written as "\r\n" like the text mode.
+	if(m_utf8Buffer.size()<charCount*4)
+		m_utf8Buffer.resize(charCount*4);
+	char *destBegin=&m_utf8Buffer[0];
+	char *destTrav=destBegin;
+	size_t charTrav=0;
+	while(charTrav<charCount)
+	{
+		const wchar_t *newLine=wmemchr(wideString+charTrav,L'\n',charCount-charTrav);
+		size_t lineEnd=newLine?newLine-wideString:charCount;
+		destTrav+=UnicodeHelper::Utf16ToUtf8(wideString+charTrav,lineEnd-charTrav,destTrav);
+		if(newLine)
+		{
+			*destTrav++='\r';
+			*destTrav++='\n';
+			lineEnd++;
+		}
+		charTrav=lineEnd;
+	}
+	System::FWrite(destBegin,sizeof(char),destTrav-destBegin,m_file);
+}
+
 FileEncodingType BaseTextFile::GetEncodingType()
 {
 	LockObj lock(m_baseTextLock);
@@ -169,8 +275,9 @@ bool BaseTextFile::SaveToFile(const TCHAR *filename)
 	Mutex fileLock=Mutex(filename);
 	fileLock.Lock();
 
+	// the UTF-8 is transcoded by writeUtf8ToFile instead of the CRT
 	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
-		e= System::FTOpen(m_file,filename,_T("wt,ccs=UTF-8"));
+		e= System::FTOpen(m_file,filename,_T("wb"));
 	else if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
 		e= System::FTOpen(m_file,filename,_T("wt,ccs=UTF-16LE"));
 	else if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
@@ -187,6 +294,8 @@ bool BaseTextFile::SaveToFile(const TCHAR *filename)
 		return false; // failed..
 	}
 
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+		System::FWrite(s_utf8ByteOrderMark,sizeof(char),sizeof(s_utf8ByteOrderMark),m_file);
 	writeLoop();
 	System::FClose(m_file);
 	fileLock.Unlock();
@@ -207,7 +316,7 @@ bool BaseTextFile::AppendToFile(const TCHAR *filename)
 	fileLock.Lock();
 
 	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
-		e= System::FTOpen(m_file,filename,_T("at,ccs=UTF-8"));
+		e= System::FTOpen(m_file,filename,_T("ab"));
 	else if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
 		e= System::FTOpen(m_file,filename,_T("at,ccs=UTF-16LE"));
 	else if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
@@ -224,6 +333,9 @@ bool BaseTextFile::AppendToFile(const TCHAR *filename)
 		return false; // failed..
 	}
 
+	// the byte order mark is written only at the start of the file
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF8 && System::FSize(m_file)==0)
+		System::FWrite(s_utf8ByteOrderMark,sizeof(char),sizeof(s_utf8ByteOrderMark),m_file);
 	writeLoop();
 	System::FClose(m_file);
 	fileLock.Unlock();
@@ -239,218 +351,68 @@ bool BaseTextFile::LoadFromFile(const TCHAR *filename)
 	if(strLength<=0)
 		return false;
 
-	int e;
+	if(m_encodingType!=FILE_ENCODING_TYPE_UTF8 && m_encodingType!=FILE_ENCODING_TYPE_UTF16LE && m_encodingType!=FILE_ENCODING_TYPE_ANSI)
+		return false;
+
 	Mutex fileLock=Mutex(filename);
 	fileLock.Lock();
 
-	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
-		e= System::FTOpen(m_file,filename,_T("rt,ccs=UTF-8"));
-	else if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
-		e= System::FTOpen(m_file,filename,_T("rt,ccs=UTF-16LE"));
-	else if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
-		e= System::FTOpen(m_file,filename,_T("rt"));
-	else
-	{
-		fileLock.Unlock();
-		return false;
-	}
-	if (e != 0) 
+	TextLineReader reader(m_encodingType);
+	if(!reader.Open(filename) || reader.GetFileSize()==0)
 	{
 		fileLock.Unlock();
 		return false; // failed..
 	}
-	EpTString rest;
-
-	//Find the actual length of file
-	size_t length= System::FSize(m_file);
-	if(length<=0)
-	{
-		fileLock.Unlock();
-		return false;
-	}
 
-#if defined(_UNICODE) || defined(UNICODE)
-
-	if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
-	{
-		char *cFileBuf=EP_NEW char[length+1];
-		//System::Memset(cFileBuf,0,length+1);
-		size_t read=System::FRead(cFileBuf,sizeof(char),length,m_file);
-		System::Memset(cFileBuf+read,0,(length+1-read)*sizeof(char));
-		System::FClose(m_file);
-		rest=System::MultiByteToWideChar(cFileBuf);
-		EP_DELETE[] cFileBuf;
-	}
-	else if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
-	{
-		wchar_t *wFileBuf=EP_NEW wchar_t[length+1];
-		//System::Memset(tFileBuf,0,(length+1)*sizeof(wchar_t));
-		size_t read=System::FRead(wFileBuf,sizeof(wchar_t),length,m_file);
-		System::Memset(wFileBuf+read,0,(length+1-read)*sizeof(wchar_t));
-		System::FClose(m_file);
-		int stringSize=length+1;
-		int stringTrav=0;
-		for(;stringTrav<stringSize;stringTrav++)
-		{
-			if(wFileBuf[stringTrav]!=0xFEFF) // BOM
-				break;
-		}
-		rest=wFileBuf+stringTrav;
-		EP_DELETE[] wFileBuf;
+	loadFromReader(reader);
+	reader.Close();
+	fileLock.Unlock();
+	return true;
+}
 
-	}
+void BaseTextFile::loadFromReader(TextLineReader &reader)
+{
+	EpTString lines;
+	// the decoded text is at most one character per byte, or per two bytes in UTF-16
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
+		lines.reserve(static_cast<size_t>(reader.GetFileSize()/sizeof(wchar_t)));
 	else
+		lines.reserve(static_cast<size_t>(reader.GetFileSize()));
+	const TCHAR *line;
+	size_t lineLength;
+	bool hasNewLine;
+	while(reader.ReadLine(line,lineLength,&hasNewLine))
 	{
-		wchar_t *wFileBuf=EP_NEW wchar_t[length/sizeof(wchar_t)+1];
-		//System::Memset(wFileBuf,0,length/sizeof(wchar_t)+1);
-		size_t read=System::FRead(wFileBuf,sizeof(wchar_t),length/sizeof(wchar_t),m_file);
-		System::Memset(wFileBuf+read,0,((length/sizeof(wchar_t)+1)-read)*sizeof(wchar_t));
-		System::FClose(m_file);
-		int stringSize=length/sizeof(wchar_t)+1;
-		int stringTrav=0;
-		for(;stringTrav<stringSize;stringTrav++)
-		{
-			if(wFileBuf[stringTrav]!=0xFEFF) // BOM
-				break;
-		}
-		rest=wFileBuf+stringTrav;
-		
-		EP_DELETE[] wFileBuf;
-	}
-	
-	
-#else //defined(_UNICODE) || defined(UNICODE)
-
-
-	if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
-	{
-
-		char *cFileBuf=EP_NEW char[length+1];
-		//System::Memset(cFileBuf,0,length+1);
-		size_t read=System::FRead(cFileBuf,sizeof(char),length,m_file);
-		System::Memset(cFileBuf+read,0,(length+1-read)*sizeof(char));
-		System::FClose(m_file);
-		rest=cFileBuf;
-		EP_DELETE[] cFileBuf;
+		lines.append(line,lineLength);
+		if(hasNewLine)
+			lines.append(_T("\n"));
 	}
-	else if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
-	{
-		wchar_t *wFileBuf=EP_NEW wchar_t[length+1];
-		//System::Memset(wFileBuf,0,(length+1)*sizeof(wchar_t));
-		size_t read=System::FRead(wFileBuf,sizeof(wchar_t),length,m_file);
-		System::Memset(wFileBuf+read,0,(length+1-read)*sizeof(wchar_t));
-		System::FClose(m_file);
-
-
-		int stringSize=length+1;
-		int stringTrav=0;
-		for(;stringTrav<stringSize;stringTrav++)
-		{
-			if(wFileBuf[stringTrav]!=0xFEFF) // BOM
-				break;
-		}
+	loadFromFile(lines);
+}
 
-		rest=System::WideCharToMultiByte(wFileBuf+stringTrav);
-		EP_DELETE[] wFileBuf;
-	}
-	else
-	{
-		wchar_t *wFileBuf=EP_NEW wchar_t[length/sizeof(wchar_t)+1];
-		//System::Memset(wFileBuf,0,length/sizeof(wchar_t)+1);
-		size_t read=System::FRead(wFileBuf,sizeof(wchar_t),length/sizeof(wchar_t),m_file);
-		System::Memset(wFileBuf+read,0,((length/sizeof(wchar_t)+1)-read)*sizeof(wchar_t));
-		System::FClose(m_file);
-
-		int stringSize=length/sizeof(wchar_t)+1;
-		int stringTrav=0;
-		for(;stringTrav<stringSize;stringTrav++)
-		{
-			if(wFileBuf[stringTrav]!=0xFEFF) // BOM
-				break;
-		}
-		rest=System::WideCharToMultiByte(wFileBuf+stringTrav);
 
-		EP_DELETE[] wFileBuf;
-		
-	}
-	
-	
-#endif //defined(_UNICODE) || defined(UNICODE)
-	
-	fileLock.Unlock();
-	loadFromFile(rest);
+JobHandle *BaseTextFile::SaveToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	return submitIo(FILE_IO_TYPE_SAVE,filename,ioPool,callBackObj);
+}
 
-	m_file=NULL;
-	return true;
+JobHandle *BaseTextFile::AppendToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	return submitIo(FILE_IO_TYPE_APPEND,filename,ioPool,callBackObj);
+}
 
-// 	if(m_encodingType==FILE_ENCODING_TYPE_UTF8||m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
-// 	{	
-// #if defined(_UNICODE) || defined(UNICODE)
-// 		//Find the actual length of file
-// 		size_t length= System::FSize(m_file);
-// 
-// 		char *cFileBuf=EP_NEW char[length+1];
-// 		System::Memset(cFileBuf,0,length+1);
-// 		System::FRead(cFileBuf,sizeof(char),length,m_file);
-// 		System::FClose(m_file);
-// 
-// 		wchar_t *tFileBuf=EP_NEW wchar_t[length+1];
-// 		System::Memset(tFileBuf,0,sizeof(wchar_t)*(length+1));
-// 		System::MultiByteToWideChar(cFileBuf,length,tFileBuf);
-// 		rest=tFileBuf;
-// 		EP_DELETE[] cFileBuf;
-// 		EP_DELETE[] tFileBuf;
-// #else //defined(_UNICODE) || defined(UNICODE)
-// 		//Find the actual length of file
-// 		size_t length= System::FSize(m_file);
-// 
-// 		char *cFileBuf=EP_NEW char[length+1];
-// 		System::Memset(cFileBuf,0,length+1);
-// 		System::FRead(cFileBuf,sizeof(char),length,m_file);
-// 		System::FClose(m_file);
-// 
-// 		rest=cFileBuf;
-// 		EP_DELETE[] cFileBuf;
-// #endif //defined(_UNICODE) || defined(UNICODE)
-// 	}
-// 	else
-// 	{
-// #if defined(_UNICODE) || defined(UNICODE)
-// 		//Find the actual length of file
-// 		size_t length= System::FSize(m_file)/sizeof(wchar_t) ;
-// 
-// 		wchar_t *tFileBuf=EP_NEW wchar_t[length+1];
-// 		System::Memset(tFileBuf,0,sizeof(wchar_t)*(length+1));
-// 		System::FRead(tFileBuf,sizeof(wchar_t),length,m_file);
-// 		System::FClose(m_file);
-// 
-// 		rest=tFileBuf;
-// 		EP_DELETE[] tFileBuf;
-// #else //defined(_UNICODE) || defined(UNICODE)
-// 		//Find the actual length of file
-// 		size_t length=System::FSize(m_file)/sizeof(wchar_t) ;
-// 
-// 		wchar_t *tFileBuf=EP_NEW wchar_t[length+1];
-// 		System::Memset(tFileBuf,0,sizeof(wchar_t)*(length+1));
-// 		System::FRead(tFileBuf,sizeof(TCHAR),length,m_file);
-// 		System::FClose(m_file);
-// 
-// 		char *cFileBuf=EP_NEW char[length+1];
-// 		System::Memset(cFileBuf,0,sizeof(char)*(length+1));
-// 		System::WideCharToMultiByte(tFileBuf,length,cFileBuf);
-// 		rest=cFileBuf;
-// 		EP_DELETE[] cFileBuf;
-// 		EP_DELETE[] tFileBuf;
-// #endif //defined(_UNICODE) || defined(UNICODE)
-// 	}
-// 
-// 
-// 	loadFromFile(rest);
-// 	
-// 	m_file=NULL;
-// 	return true;
+JobHandle *BaseTextFile::LoadFromFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	return submitIo(FILE_IO_TYPE_LOAD,filename,ioPool,callBackObj);
 }
 
+JobHandle *BaseTextFile::submitIo(FileIoType ioType, const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	BaseTextFileIoJob *job=EP_NEW BaseTextFileIoJob(this,ioType,filename,callBackObj);
+	JobHandle *handle=job->Submit(ioPool);
+	job->ReleaseObj();
+	return handle;
+}
 
 bool BaseTextFile::GetLine(const EpTString &buf,size_t startIdx, EpTString &retLine, size_t *retEndIdx, EpTString *retRest)
 {
@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "epSmartObject.h"
 #include "epWorkerThreadDelegate.h"
 #include "epBaseJobProcessor.h"
+#include "epJobHandle.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -40,6 +41,8 @@ BaseWorkerThread::BaseWorkerThread(const ThreadLifePolicy policy,LockPolicy lock
 {
 	m_lifePolicy=policy;
 	m_callBackClass=NULL;
+	m_jobProcessor=NULL;
+	m_dequeueBatchSize=1;
 	m_lockPolicy=lockPolicyType;
 	switch(lockPolicyType)
 	{
@@ -52,6 +55,12 @@ BaseWorkerThread::BaseWorkerThread(const ThreadLifePolicy policy,LockPolicy lock
 	case LOCK_POLICY_NONE:
 		m_callBackLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_callBackLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_callBackLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_callBackLock=NULL;
 		break;
@@ -72,6 +81,12 @@ BaseWorkerThread::BaseWorkerThread(const BaseWorkerThread & b):Thread(b)
 	case LOCK_POLICY_NONE:
 		m_callBackLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_callBackLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_callBackLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_callBackLock=NULL;
 		break;
@@ -83,6 +98,7 @@ BaseWorkerThread::BaseWorkerThread(const BaseWorkerThread & b):Thread(b)
 	m_jobProcessor=b.m_jobProcessor;
 	if(m_jobProcessor)
 		m_jobProcessor->RetainObj();
+	m_dequeueBatchSize=b.m_dequeueBatchSize;
 	m_workPool=b.m_workPool;
 	
 }
@@ -133,6 +149,12 @@ BaseWorkerThread &BaseWorkerThread::operator=(const BaseWorkerThread & b)
 		case LOCK_POLICY_NONE:
 			m_callBackLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_callBackLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_callBackLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_callBackLock=NULL;
 			break;
@@ -144,6 +166,7 @@ BaseWorkerThread &BaseWorkerThread::operator=(const BaseWorkerThread & b)
 		m_jobProcessor=b.m_jobProcessor;
 		if(m_jobProcessor)
 			m_jobProcessor->RetainObj();
+		m_dequeueBatchSize=b.m_dequeueBatchSize;
 		m_workPool=b.m_workPool;
 
 
@@ -152,11 +175,147 @@ BaseWorkerThread &BaseWorkerThread::operator=(const BaseWorkerThread & b)
 }
 void BaseWorkerThread::Push(BaseJob* const  work)
 {
-	m_workPool.Push(work);
+	if(!m_workPool.Push(work))
+	{
+		work->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+		return;
+	}
+	signalWork();
+}
+
+void BaseWorkerThread::PushOwned(SmartPtr<BaseJob> &work)
+{
+	EP_ASSERT_EXPR(!work.IsNull(),_T("Job is NULL!"));
+	if(!m_workPool.Push(work))
+	{
+		work->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+		work.Reset();
+		return;
+	}
+	signalWork();
+}
+
+void BaseWorkerThread::PushBatch(BaseJob * const *works, size_t count)
+{
+	if(count==0)
+		return;
+	if(m_workPool.GetCapacity()!=0)
+	{
+		// push one by one, so the worker is signalled before the producer blocks or gets rejected
+		for(size_t workTrav=0;workTrav<count;workTrav++)
+		{
+			Push(works[workTrav]);
+		}
+		return;
+	}
+	m_workPool.PushBatch(works,count);
+	signalWork();
+}
+
+void BaseWorkerThread::signalWork()
+{
 	if(m_lifePolicy==THREAD_LIFE_SUSPEND_AFTER_WORK)
 		Resume();
 }
 
+JobHandle *BaseWorkerThread::Submit(BaseJob * const  work)
+{
+	EP_ASSERT_EXPR(work,_T("Job is NULL!"));
+	if(!work)
+		return NULL;
+	Push(work);
+	return work->GetHandle();
+}
+
+void BaseWorkerThread::SetDequeueBatchSize(unsigned int batchSize)
+{
+	if(batchSize==0)
+		batchSize=1;
+	m_dequeueBatchSize=batchSize;
+}
+
+unsigned int BaseWorkerThread::GetDequeueBatchSize() const
+{
+	return m_dequeueBatchSize;
+}
+
+void BaseWorkerThread::SetMaxWaitTime(unsigned int maxWaitInMilliSec)
+{
+	m_workPool.SetMaxWaitTime(maxWaitInMilliSec);
+}
+
+unsigned int BaseWorkerThread::GetMaxWaitTime() const
+{
+	return m_workPool.GetMaxWaitTime();
+}
+
+void BaseWorkerThread::SetQueueCapacity(size_t capacity, OverflowPolicy policy)
+{
+	m_workPool.SetCapacity(capacity,policy);
+}
+
+size_t BaseWorkerThread::GetQueueCapacity() const
+{
+	return m_workPool.GetCapacity();
+}
+
+OverflowPolicy BaseWorkerThread::GetQueueOverflowPolicy() const
+{
+	return m_workPool.GetOverflowPolicy();
+}
+
+size_t BaseWorkerThread::GetQueueHighWaterMark() const
+{
+	return m_workPool.GetHighWaterMark();
+}
+
+void BaseWorkerThread::ResetQueueHighWaterMark()
+{
+	m_workPool.ResetHighWaterMark();
+}
+
+size_t BaseWorkerThread::GetQueueDropCount() const
+{
+	return m_workPool.GetDropCount();
+}
+
+size_t BaseWorkerThread::popJobBatch(std::vector<BaseJob*> &jobBatch)
+{
+	unsigned int batchSize=m_dequeueBatchSize;
+	if(jobBatch.size()<batchSize)
+		jobBatch.resize(batchSize);
+	return m_workPool.PopBatch(&jobBatch.at(0),batchSize);
+}
+
+void BaseWorkerThread::processJob(BaseJob *job)
+{
+	if(job->dropIfStale())
+	{
+		job->ReleaseObj();
+		return;
+	}
+	BaseJobProcessor *jobProcessor=job->m_jobProcessor;
+	if(!jobProcessor)
+		jobProcessor=m_jobProcessor;
+	__int64 startTime=WorkerMetrics::GetCurrentMicroSec();
+	job->JobReport(BaseJob::JOB_STATUS_IN_PROCESS);
+	jobProcessor->DoJob(this,job);
+	__int64 endTime=WorkerMetrics::GetCurrentMicroSec();
+	m_metrics.RecordJob(startTime-job->m_enqueueTime,endTime-startTime);
+	job->JobReport(BaseJob::JOB_STATUS_DONE);
+	job->ReleaseObj();
+}
+
+void BaseWorkerThread::recordIdle(__int64 idleStartTime)
+{
+	m_metrics.RecordIdle(WorkerMetrics::GetCurrentMicroSec()-idleStartTime);
+}
+
+void BaseWorkerThread::GetMetrics(WorkerMetricsSnapshot &retSnapshot) const
+{
+	m_metrics.GetSnapshot(retSnapshot);
+}
+
 BaseJob * &BaseWorkerThread::Front()
 {
 	return m_workPool.Front();
@@ -0,0 +1,336 @@
+/*! 
+Benchmark for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epBenchmark.h"
+#include "epFolderHelper.h"
+#include "epThread.h"
+#include <algorithm>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the header of the comma-separated values
+#define BENCHMARK_CSV_HEADER _T("suite,case,parameter,iterations,bytes,ns_per_op,mb_per_sec,threads,ops_per_sec\n")
+
+/// the percentiles reported by AddPercentiles
+static const double s_percentileList[]={50.0,90.0,99.0};
+
+/// the case name suffixes of the percentiles reported
+static const TCHAR *s_percentileNameList[]={_T("P50"),_T("P90"),_T("P99")};
+
+BenchmarkResult::BenchmarkResult()
+{
+	iterationCount=0;
+	byteSize=0;
+	nanoSecPerOp=0.0;
+	megaBytePerSec=0.0;
+	threadCount=1;
+	opPerSec=0.0;
+}
+
+namespace epl
+{
+	/*!
+	@class BenchmarkWorker epBenchmark.cpp
+	@brief A thread performing the operations of one thread of BenchmarkParallelCase.
+	*/
+	class BenchmarkWorker:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] benchCase the case to perform.
+		@param[in] threadIdx the index of the thread.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		BenchmarkWorker(BenchmarkParallelCase &benchCase, unsigned int threadIdx, unsigned int iterationCount):Thread(),m_benchCase(benchCase)
+		{
+			m_threadIdx=threadIdx;
+			m_iterationCount=iterationCount;
+		}
+
+	protected:
+		/*!
+		Wait for the case to release the threads, and perform the operations.
+		*/
+		virtual void execute()
+		{
+			m_benchCase.m_startEvent.WaitForEvent();
+			m_benchCase.RunThread(m_threadIdx,m_iterationCount);
+		}
+
+	private:
+		/// the case to perform
+		BenchmarkParallelCase &m_benchCase;
+		/// the index of the thread
+		unsigned int m_threadIdx;
+		/// the number of the operations of this thread
+		unsigned int m_iterationCount;
+	};
+}
+
+BenchmarkParallelCase::BenchmarkParallelCase(unsigned int threadCount):BenchmarkCase(),m_startEvent(false,true)
+{
+	EP_ASSERT_EXPR(threadCount>0,_T("The thread count is zero."));
+	m_threadCount=threadCount;
+}
+
+BenchmarkParallelCase::~BenchmarkParallelCase()
+{
+	if(m_workerList.size())
+	{
+		// the threads waiting are released to finish
+		m_startEvent.SetEvent();
+		TearDown();
+	}
+}
+
+void BenchmarkParallelCase::SetUp(unsigned int iterationCount)
+{
+	m_startEvent.ResetEvent();
+	for(unsigned int threadTrav=0;threadTrav<m_threadCount;threadTrav++)
+	{
+		// the remainder goes to the first threads, so the counts sum up to the operations
+		unsigned int threadIterationCount=iterationCount/m_threadCount+(threadTrav<iterationCount%m_threadCount?1:0);
+		BenchmarkWorker *worker=EP_NEW BenchmarkWorker(*this,threadTrav,threadIterationCount);
+		worker->Start();
+		m_workerList.push_back(worker);
+	}
+}
+
+void BenchmarkParallelCase::Run(unsigned int iterationCount)
+{
+	m_startEvent.SetEvent();
+	for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+		m_workerList[workerTrav]->WaitFor();
+}
+
+void BenchmarkParallelCase::TearDown()
+{
+	for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+	{
+		m_workerList[workerTrav]->WaitFor();
+		EP_DELETE m_workerList[workerTrav];
+	}
+	m_workerList.clear();
+}
+
+unsigned int BenchmarkParallelCase::GetThreadCount() const
+{
+	return m_threadCount;
+}
+
+BenchmarkManager::BenchmarkNode::BenchmarkNode(const BenchmarkResult &result):OutputNode()
+{
+	m_result=result;
+}
+
+BenchmarkManager::BenchmarkNode::~BenchmarkNode()
+{
+}
+
+void BenchmarkManager::BenchmarkNode::format(EpTString &retString) const
+{
+	System::STPrintf(retString,_T("%s,%s,%s,%u,%u,%.3f,%.3f,%u,%.1f\n"),m_result.suiteName.c_str(),m_result.caseName.c_str(),m_result.parameter.c_str(),m_result.iterationCount,static_cast<unsigned int>(m_result.byteSize),m_result.nanoSecPerOp,m_result.megaBytePerSec,m_result.threadCount,m_result.opPerSec);
+}
+
+void BenchmarkManager::BenchmarkNode::Print() const
+{
+	EpTString output;
+	format(output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void BenchmarkManager::BenchmarkNode::Write(EpFile* const file)
+{
+	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
+	EpTString output;
+	format(output);
+	System::FTPrintf(file,_T("%s"),output.c_str());
+}
+
+BenchmarkManager::BenchmarkManager(LockPolicy lockPolicyType):BaseOutputter(lockPolicyType)
+{
+	m_fileName=FolderHelper::GetModuleFileDirectory();
+	m_fileName.append(_T("benchmark.csv"));
+}
+
+BenchmarkManager::~BenchmarkManager()
+{
+}
+
+__int64 BenchmarkManager::measure(BenchmarkCase &benchCase, unsigned int iterationCount)
+{
+	benchCase.SetUp(iterationCount);
+	LARGE_INTEGER startTime=System::GetQueryPerformanceCounter();
+	benchCase.Run(iterationCount);
+	LARGE_INTEGER endTime=System::GetQueryPerformanceCounter();
+	benchCase.TearDown();
+	return endTime.QuadPart-startTime.QuadPart;
+}
+
+BenchmarkResult BenchmarkManager::Run(const TCHAR *suiteName, const TCHAR *caseName, const TCHAR *parameter, BenchmarkCase &benchCase, size_t byteSize, unsigned int minTime)
+{
+	LARGE_INTEGER frequency;
+	if(!QueryPerformanceFrequency(&frequency) || frequency.QuadPart==0)
+		frequency.QuadPart=1000;
+	__int64 minTick=frequency.QuadPart*minTime/1000;
+	if(minTick==0)
+		minTick=1;
+
+	// grow the iteration count until one measurement takes the minimum time.
+	unsigned int iterationCount=1;
+	__int64 elapsedTick=measure(benchCase,iterationCount);
+	while(elapsedTick<minTick && iterationCount<0x7FFFFFFF)
+	{
+		__int64 nextCount=static_cast<__int64>(iterationCount)*10;
+		if(elapsedTick>0)
+		{
+			// aim a little over the minimum time, so the next measurement rarely falls short again.
+			__int64 estimatedCount=static_cast<__int64>(iterationCount)*minTick*6/(elapsedTick*5)+1;
+			if(estimatedCount<nextCount)
+				nextCount=estimatedCount;
+		}
+		if(nextCount>0x7FFFFFFF)
+			nextCount=0x7FFFFFFF;
+		iterationCount=static_cast<unsigned int>(nextCount);
+		elapsedTick=measure(benchCase,iterationCount);
+	}
+
+	// the fastest measurement is the least disturbed by the other processes.
+	__int64 bestTick=elapsedTick;
+	for(int repeatTrav=1;repeatTrav<BENCHMARK_REPEAT_COUNT;repeatTrav++)
+	{
+		elapsedTick=measure(benchCase,iterationCount);
+		if(elapsedTick<bestTick)
+			bestTick=elapsedTick;
+	}
+	if(bestTick<=0)
+		bestTick=1;
+
+	BenchmarkResult result;
+	result.suiteName=suiteName;
+	result.caseName=caseName;
+	if(parameter)
+		result.parameter=parameter;
+	result.iterationCount=iterationCount;
+	result.byteSize=byteSize;
+	double elapsedSec=static_cast<double>(bestTick)/static_cast<double>(frequency.QuadPart);
+	result.nanoSecPerOp=elapsedSec*1000000000.0/static_cast<double>(iterationCount);
+	result.threadCount=benchCase.GetThreadCount();
+	result.opPerSec=static_cast<double>(iterationCount)/elapsedSec;
+	if(byteSize)
+		result.megaBytePerSec=static_cast<double>(byteSize)*static_cast<double>(iterationCount)/elapsedSec/(1024.0*1024.0);
+
+	AddResult(result);
+	return result;
+}
+
+void BenchmarkManager::AddResult(const BenchmarkResult &result)
+{
+	BenchmarkNode *node=EP_NEW BenchmarkNode(result);
+	LockObj lock(m_nodeListLock);
+	m_list.push_back(node);
+}
+
+void BenchmarkManager::AddPercentiles(const TCHAR *suiteName, const TCHAR *caseName, const TCHAR *parameter, std::vector<__int64> &sampleList)
+{
+	if(sampleList.empty())
+		return;
+	LARGE_INTEGER frequency;
+	if(!QueryPerformanceFrequency(&frequency) || frequency.QuadPart==0)
+		frequency.QuadPart=1000;
+	std::sort(sampleList.begin(),sampleList.end());
+
+	BenchmarkResult result;
+	result.suiteName=suiteName;
+	result.parameter=parameter;
+	result.iterationCount=static_cast<unsigned int>(sampleList.size());
+	for(size_t percentileTrav=0;percentileTrav<=sizeof(s_percentileList)/sizeof(double);percentileTrav++)
+	{
+		size_t sampleIdx=sampleList.size()-1;
+		result.caseName=caseName;
+		if(percentileTrav<sizeof(s_percentileList)/sizeof(double))
+		{
+			// the nearest rank, so the percentile is always one of the times measured
+			double rank=s_percentileList[percentileTrav]*static_cast<double>(sampleList.size())/100.0;
+			sampleIdx=static_cast<size_t>(rank);
+			if(static_cast<double>(sampleIdx)<rank)
+				sampleIdx++;
+			if(sampleIdx>0)
+				sampleIdx--;
+			result.caseName.append(s_percentileNameList[percentileTrav]);
+		}
+		else
+			result.caseName.append(_T("Max"));
+		result.nanoSecPerOp=static_cast<double>(sampleList[sampleIdx])*1000000000.0/static_cast<double>(frequency.QuadPart);
+		AddResult(result);
+	}
+}
+
+size_t BenchmarkManager::GetResultCount() const
+{
+	LockObj lock(m_nodeListLock);
+	return m_list.size();
+}
+
+BenchmarkResult BenchmarkManager::GetResult(size_t resultIdx) const
+{
+	LockObj lock(m_nodeListLock);
+	EP_ASSERT_EXPR(resultIdx<m_list.size(),_T("The index is out of range."));
+	return static_cast<BenchmarkNode*>(m_list[resultIdx])->m_result;
+}
+
+void BenchmarkManager::Print() const
+{
+	LockObj lock(m_nodeListLock);
+	System::TPrintf(BENCHMARK_CSV_HEADER);
+	std::vector<OutputNode*>::const_iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		(*iter)->Print();
+	}
+}
+
+void BenchmarkManager::FlushToFile()
+{
+	LockObj lock(m_nodeListLock);
+	EpFile *file=NULL;
+	System::FTOpen(file,m_fileName.c_str(),_T("wt"));
+	EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),m_fileName.c_str());
+	// the file holds the values only, so the tools can read it as is.
+	System::FTPrintf(file,BENCHMARK_CSV_HEADER);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		(*iter)->Write(file);
+	}
+	System::FClose(file);
+}
\ No newline at end of file
@@ -24,6 +24,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epBinaryFile.h"
+#include "epJobHandle.h"
+#include "epThreadPool.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -33,6 +35,55 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+namespace epl
+{
+	/*! 
+	@class BinaryFileIoJob epBinaryFile.cpp
+	@brief A helper job which performs the file I/O of the BinaryFile on the I/O pool.
+	*/
+	class BinaryFileIoJob: public FileIoJob
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the job
+		@param[in] file the file object to perform the file I/O.
+		@param[in] ioType the type of the file I/O
+		@param[in] fileName the name of the file
+		@param[in] callBackObj the callback object to report the result.
+		*/
+		BinaryFileIoJob(BinaryFile *file, FileIoType ioType, const TCHAR *fileName, FileIoCallbackInterface *callBackObj):FileIoJob(ioType,fileName,callBackObj)
+		{
+			m_file=file;
+		}
+
+	protected:
+		/*!
+		Perform the file I/O on the file object.
+		@return true if the file I/O succeeded, otherwise false.
+		*/
+		virtual bool doIo()
+		{
+			switch(GetIoType())
+			{
+			case FILE_IO_TYPE_SAVE:
+				return m_file->SaveToFile(GetFileName());
+			case FILE_IO_TYPE_APPEND:
+				return m_file->AppendToFile(GetFileName());
+			case FILE_IO_TYPE_LOAD:
+				return m_file->LoadFromFile(GetFileName());
+			default:
+				return false;
+			}
+		}
+
+	private:
+		/// the file object
+		BinaryFile *m_file;
+	};
+}
+
 BinaryFile::BinaryFile(LockPolicy lockPolicyType)
 {
 	m_file=NULL;
@@ -48,6 +99,12 @@ BinaryFile::BinaryFile(LockPolicy lockPolicyType)
 	case LOCK_POLICY_NONE:
 		m_baseTextLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_baseTextLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_baseTextLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_baseTextLock=NULL;
 		break;
@@ -69,6 +126,12 @@ BinaryFile::BinaryFile(const BinaryFile& b)
 	case LOCK_POLICY_NONE:
 		m_baseTextLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_baseTextLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_baseTextLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_baseTextLock=NULL;
 		break;
@@ -103,6 +166,12 @@ BinaryFile & BinaryFile::operator=(const BinaryFile&b)
 		case LOCK_POLICY_NONE:
 			m_baseTextLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_baseTextLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_baseTextLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_baseTextLock=NULL;
 			break;
@@ -202,18 +271,40 @@ bool BinaryFile::LoadFromFile(const TCHAR *filename)
 	unsigned char *cFileBuf=EP_NEW unsigned char[length];
 	size_t read=System::FRead(cFileBuf,sizeof(unsigned char),length,m_file);
 	System::FClose(m_file);
-	EP_DELETE[] cFileBuf;
 
 	fileLock.Unlock();
 	m_stream.Clear();
-	m_stream.WriteBytes(cFileBuf,length);
+	m_stream.WriteBytes(cFileBuf,read);
 	m_stream.SetSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET);
+	EP_DELETE[] cFileBuf;
 
 	m_file=NULL;
 	return true;
 
 }
 
+JobHandle *BinaryFile::SaveToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	return submitIo(FILE_IO_TYPE_SAVE,filename,ioPool,callBackObj);
+}
+
+JobHandle *BinaryFile::AppendToFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	return submitIo(FILE_IO_TYPE_APPEND,filename,ioPool,callBackObj);
+}
+
+JobHandle *BinaryFile::LoadFromFileAsync(const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	return submitIo(FILE_IO_TYPE_LOAD,filename,ioPool,callBackObj);
+}
+
+JobHandle *BinaryFile::submitIo(FileIoType ioType, const TCHAR *filename, ThreadPool *ioPool, FileIoCallbackInterface *callBackObj)
+{
+	BinaryFileIoJob *job=EP_NEW BinaryFileIoJob(this,ioType,filename,callBackObj);
+	JobHandle *handle=job->Submit(ioPool);
+	job->ReleaseObj();
+	return handle;
+}
 
 Stream &BinaryFile::GetStream()
 {
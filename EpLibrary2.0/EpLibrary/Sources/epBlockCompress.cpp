@@ -0,0 +1,829 @@
+/*! 
+BlockCompressWriter for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epBlockCompress.h"
+#include "epSystem.h"
+#include "epParallel.h"
+#include <algorithm>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the codec written in the header which marks the index instead of the block
+#define BLOCK_COMPRESS_END_MARKER 0xFF
+/// the magic number at the end of the compressed data
+#define BLOCK_COMPRESS_MAGIC 0x43425045
+/// the byte size of each index entry
+#define BLOCK_COMPRESS_ENTRY_SIZE 12
+/// the byte size of the footer
+#define BLOCK_COMPRESS_FOOTER_SIZE 16
+/// the number of the blocks compressed in parallel at once
+#define BLOCK_COMPRESS_PARALLEL_BLOCKS 64
+
+/// the bits of the LZ4 match hash table
+#define LZ4_HASH_LOG 12
+/// the minimum length of the LZ4 match
+#define LZ4_MIN_MATCH 4
+/// the number of the last bytes always written as the literals
+#define LZ4_LAST_LITERALS 5
+/// the number of the last bytes where no match can start
+#define LZ4_MF_LIMIT 12
+/// the maximum distance of the LZ4 match
+#define LZ4_MAX_DISTANCE 65535
+
+static unsigned int lz4Read32(const unsigned char *ptr)
+{
+	unsigned int value;
+	System::Memcpy(&value,ptr,sizeof(unsigned int));
+	return value;
+}
+
+static unsigned int lz4Hash(unsigned int sequence)
+{
+	return (sequence*2654435761U)>>(32-LZ4_HASH_LOG);
+}
+
+static unsigned char *lz4WriteLength(unsigned char *op, size_t length)
+{
+	for(;length>=255;length-=255)
+		*op++=255;
+	*op++=static_cast<unsigned char>(length);
+	return op;
+}
+
+static size_t lz4Compress(unsigned char *dest, size_t destByteSize, const unsigned char *src, size_t srcByteSize)
+{
+	const unsigned char *ip=src;
+	const unsigned char *anchor=src;
+	const unsigned char *iend=src+srcByteSize;
+	unsigned char *op=dest;
+	unsigned char *oend=dest+destByteSize;
+
+	if(srcByteSize>LZ4_MF_LIMIT)
+	{
+		const unsigned char *mfLimit=iend-LZ4_MF_LIMIT;
+		const unsigned char *matchLimit=iend-LZ4_LAST_LITERALS;
+		unsigned int hashTable[1<<LZ4_HASH_LOG];
+		System::Memset(hashTable,0,sizeof(hashTable));
+
+		while(ip<mfLimit)
+		{
+			unsigned int sequence=lz4Read32(ip);
+			unsigned int hash=lz4Hash(sequence);
+			const unsigned char *ref=src+hashTable[hash];
+			hashTable[hash]=static_cast<unsigned int>(ip-src);
+			if(ref>=ip || ip-ref>LZ4_MAX_DISTANCE || lz4Read32(ref)!=sequence)
+			{
+				// skip faster over the data which does not match
+				ip+=1+((ip-anchor)>>6);
+				continue;
+			}
+
+			while(ip>anchor && ref>src && ip[-1]==ref[-1])
+			{
+				ip--;
+				ref--;
+			}
+			const unsigned char *matchEnd=ip+LZ4_MIN_MATCH;
+			const unsigned char *refEnd=ref+LZ4_MIN_MATCH;
+			while(matchEnd<matchLimit && *matchEnd==*refEnd)
+			{
+				matchEnd++;
+				refEnd++;
+			}
+
+			size_t literalLength=ip-anchor;
+			size_t matchLength=matchEnd-ip-LZ4_MIN_MATCH;
+			if(static_cast<size_t>(oend-op)<1+literalLength/255+1+literalLength+2+matchLength/255+1)
+				return 0;
+
+			unsigned char *token=op++;
+			if(literalLength>=15)
+			{
+				*token=15<<4;
+				op=lz4WriteLength(op,literalLength-15);
+			}
+			else
+				*token=static_cast<unsigned char>(literalLength<<4);
+			System::Memcpy(op,anchor,literalLength);
+			op+=literalLength;
+
+			unsigned int distance=static_cast<unsigned int>(ip-ref);
+			*op++=static_cast<unsigned char>(distance&0xFF);
+			*op++=static_cast<unsigned char>(distance>>8);
+			if(matchLength>=15)
+			{
+				*token|=15;
+				op=lz4WriteLength(op,matchLength-15);
+			}
+			else
+				*token|=static_cast<unsigned char>(matchLength);
+
+			ip=matchEnd;
+			anchor=ip;
+		}
+	}
+
+	size_t literalLength=iend-anchor;
+	if(static_cast<size_t>(oend-op)<1+literalLength/255+1+literalLength)
+		return 0;
+	unsigned char *token=op++;
+	if(literalLength>=15)
+	{
+		*token=15<<4;
+		op=lz4WriteLength(op,literalLength-15);
+	}
+	else
+		*token=static_cast<unsigned char>(literalLength<<4);
+	System::Memcpy(op,anchor,literalLength);
+	op+=literalLength;
+	return op-dest;
+}
+
+static bool lz4ReadLength(const unsigned char *&ip, const unsigned char *iend, size_t &length)
+{
+	unsigned char byte;
+	do
+	{
+		if(ip>=iend)
+			return false;
+		byte=*ip++;
+		length+=byte;
+	}while(byte==255);
+	return true;
+}
+
+static bool lz4Decompress(unsigned char *dest, size_t destByteSize, const unsigned char *src, size_t srcByteSize)
+{
+	const unsigned char *ip=src;
+	const unsigned char *iend=src+srcByteSize;
+	unsigned char *op=dest;
+	unsigned char *oend=dest+destByteSize;
+
+	while(true)
+	{
+		if(ip>=iend)
+			return false;
+		unsigned char token=*ip++;
+
+		size_t literalLength=token>>4;
+		if(literalLength==15 && !lz4ReadLength(ip,iend,literalLength))
+			return false;
+		if(literalLength>static_cast<size_t>(iend-ip) || literalLength>static_cast<size_t>(oend-op))
+			return false;
+		System::Memcpy(op,ip,literalLength);
+		op+=literalLength;
+		ip+=literalLength;
+		// the last sequence has the literals only.
+		if(ip==iend)
+			break;
+
+		if(iend-ip<2)
+			return false;
+		size_t distance=ip[0]|(ip[1]<<8);
+		ip+=2;
+		if(distance==0 || distance>static_cast<size_t>(op-dest))
+			return false;
+
+		size_t matchLength=token&15;
+		if(matchLength==15 && !lz4ReadLength(ip,iend,matchLength))
+			return false;
+		matchLength+=LZ4_MIN_MATCH;
+		if(matchLength>static_cast<size_t>(oend-op))
+			return false;
+
+		const unsigned char *ref=op-distance;
+		if(distance>=matchLength)
+			System::Memcpy(op,ref,matchLength);
+		else
+		{
+			// the overlapped match repeats the bytes just written.
+			for(size_t byteTrav=0;byteTrav<matchLength;byteTrav++)
+				op[byteTrav]=ref[byteTrav];
+		}
+		op+=matchLength;
+	}
+	return op==oend;
+}
+
+size_t BlockCodec::GetMaxCompressedSize(BlockCodecType codecType, size_t rawByteSize)
+{
+	switch(codecType)
+	{
+	case BLOCK_CODEC_TYPE_LZ4:
+		return rawByteSize+rawByteSize/255+16;
+	default:
+		return rawByteSize;
+	}
+}
+
+size_t BlockCodec::Compress(BlockCodecType codecType, unsigned char *dest, size_t destByteSize, const unsigned char *src, size_t srcByteSize)
+{
+	switch(codecType)
+	{
+	case BLOCK_CODEC_TYPE_LZ4:
+		return lz4Compress(dest,destByteSize,src,srcByteSize);
+	case BLOCK_CODEC_TYPE_STORE:
+		if(destByteSize<srcByteSize)
+			return 0;
+		System::Memcpy(dest,src,srcByteSize);
+		return srcByteSize;
+	default:
+		return 0;
+	}
+}
+
+bool BlockCodec::Decompress(BlockCodecType codecType, unsigned char *dest, size_t destByteSize, const unsigned char *src, size_t srcByteSize)
+{
+	switch(codecType)
+	{
+	case BLOCK_CODEC_TYPE_LZ4:
+		return lz4Decompress(dest,destByteSize,src,srcByteSize);
+	case BLOCK_CODEC_TYPE_STORE:
+		if(destByteSize!=srcByteSize)
+			return false;
+		System::Memcpy(dest,src,srcByteSize);
+		return true;
+	default:
+		return false;
+	}
+}
+
+static void writeHeader(unsigned char *header, unsigned int rawSize, unsigned int storedSize, unsigned char codec)
+{
+	System::Memcpy(header,&rawSize,sizeof(unsigned int));
+	System::Memcpy(header+4,&storedSize,sizeof(unsigned int));
+	header[8]=codec;
+}
+
+static void readHeader(const unsigned char *header, unsigned int &retRawSize, unsigned int &retStoredSize, unsigned char &retCodec)
+{
+	System::Memcpy(&retRawSize,header,sizeof(unsigned int));
+	System::Memcpy(&retStoredSize,header+4,sizeof(unsigned int));
+	retCodec=header[8];
+}
+
+static size_t getBlockCapacity(BlockCodecType codecType, unsigned int blockSize)
+{
+	size_t compressedSize=BlockCodec::GetMaxCompressedSize(codecType,blockSize);
+	return BLOCK_COMPRESS_HEADER_SIZE+(compressedSize>blockSize?compressedSize:blockSize);
+}
+
+static size_t compressBlock(BlockCodecType codecType, unsigned char *dest, size_t destByteSize, const unsigned char *raw, unsigned int rawSize)
+{
+	size_t storedSize=BlockCodec::Compress(codecType,dest+BLOCK_COMPRESS_HEADER_SIZE,destByteSize-BLOCK_COMPRESS_HEADER_SIZE,raw,rawSize);
+	if(storedSize==0 || storedSize>=rawSize)
+	{
+		// the block which does not shrink is stored, so it never grows beyond the raw size.
+		codecType=BLOCK_CODEC_TYPE_STORE;
+		storedSize=rawSize;
+		System::Memcpy(dest+BLOCK_COMPRESS_HEADER_SIZE,raw,rawSize);
+	}
+	writeHeader(dest,rawSize,static_cast<unsigned int>(storedSize),static_cast<unsigned char>(codecType));
+	return BLOCK_COMPRESS_HEADER_SIZE+storedSize;
+}
+
+static bool writeIndex(Stream &target, unsigned __int64 endOffset, const std::vector<unsigned __int64> &offsetList, const std::vector<unsigned int> &rawSizeList)
+{
+	unsigned int blockCount=static_cast<unsigned int>(offsetList.size());
+	size_t indexByteSize=BLOCK_COMPRESS_HEADER_SIZE+blockCount*BLOCK_COMPRESS_ENTRY_SIZE+BLOCK_COMPRESS_FOOTER_SIZE;
+	unsigned char *index=reinterpret_cast<unsigned char*>(EP_MallocTag(indexByteSize,MEMORY_TAG_STREAM));
+	if(!index)
+		return false;
+
+	writeHeader(index,0,static_cast<unsigned int>(indexByteSize-BLOCK_COMPRESS_HEADER_SIZE),BLOCK_COMPRESS_END_MARKER);
+	unsigned char *entry=index+BLOCK_COMPRESS_HEADER_SIZE;
+	for(unsigned int blockTrav=0;blockTrav<blockCount;blockTrav++)
+	{
+		System::Memcpy(entry,&offsetList[blockTrav],sizeof(unsigned __int64));
+		System::Memcpy(entry+8,&rawSizeList[blockTrav],sizeof(unsigned int));
+		entry+=BLOCK_COMPRESS_ENTRY_SIZE;
+	}
+	unsigned int magic=BLOCK_COMPRESS_MAGIC;
+	System::Memcpy(entry,&endOffset,sizeof(unsigned __int64));
+	System::Memcpy(entry+8,&blockCount,sizeof(unsigned int));
+	System::Memcpy(entry+12,&magic,sizeof(unsigned int));
+
+	bool retVal=target.WriteBytes(index,indexByteSize);
+	EP_FreeTag(index,MEMORY_TAG_STREAM);
+	return retVal;
+}
+
+/*!
+@struct BlockCompressFunctor epBlockCompress.cpp
+@brief A functor which compresses the blocks of each chunk given to ParallelFor.
+*/
+struct BlockCompressFunctor
+{
+	/// the codec
+	BlockCodecType m_codecType;
+	/// the raw data of the first block
+	const unsigned char *m_data;
+	/// the byte size of the raw data from the first block
+	size_t m_byteSize;
+	/// the byte size of the raw block
+	unsigned int m_blockSize;
+	/// the buffers for the compressed blocks
+	unsigned char *m_compressed;
+	/// the byte size of the buffer for each block
+	size_t m_capacity;
+	/// the byte size of each compressed block
+	size_t *m_compressedSizeList;
+
+	/*!
+	Compress the blocks of the given chunk.
+	@param[in] chunkBegin the first block of the chunk.
+	@param[in] chunkEnd the block after the last of the chunk.
+	*/
+	void operator()(size_t chunkBegin, size_t chunkEnd) const
+	{
+		for(size_t blockTrav=chunkBegin;blockTrav<chunkEnd;blockTrav++)
+		{
+			size_t rawOffset=blockTrav*m_blockSize;
+			size_t rawSize=m_byteSize-rawOffset;
+			if(rawSize>m_blockSize)
+				rawSize=m_blockSize;
+			m_compressedSizeList[blockTrav]=compressBlock(m_codecType,m_compressed+blockTrav*m_capacity,m_capacity,m_data+rawOffset,static_cast<unsigned int>(rawSize));
+		}
+	}
+};
+
+/*!
+@struct BlockDecompressFunctor epBlockCompress.cpp
+@brief A functor which decompresses the blocks of each chunk given to ParallelFor.
+*/
+struct BlockDecompressFunctor
+{
+	/// the reader
+	const BlockCompressReader *m_reader;
+	/// the buffer to receive the whole raw data
+	unsigned char *m_dest;
+	/// the flag set if any block is corrupted
+	volatile long *m_isFailed;
+
+	/*!
+	Decompress the blocks of the given chunk.
+	@param[in] chunkBegin the first block of the chunk.
+	@param[in] chunkEnd the block after the last of the chunk.
+	*/
+	void operator()(size_t chunkBegin, size_t chunkEnd) const
+	{
+		for(size_t blockTrav=chunkBegin;blockTrav<chunkEnd;blockTrav++)
+		{
+			if(!m_reader->DecompressBlock(blockTrav,m_dest+static_cast<size_t>(m_reader->GetBlockRawOffset(blockTrav))))
+				*m_isFailed=1;
+		}
+	}
+};
+
+BlockCompressWriter::BlockCompressWriter(Stream &target, BlockCodecType codecType, unsigned int blockSize, LockPolicy lockPolicyType)
+{
+	EP_ASSERT_EXPR(blockSize>0,_T("The block size must be greater than 0."));
+	m_target=&target;
+	m_codecType=codecType;
+	m_blockSize=blockSize;
+	m_blockFill=0;
+	m_compressedCapacity=getBlockCapacity(codecType,blockSize);
+	m_block=reinterpret_cast<unsigned char*>(EP_MallocTag(blockSize,MEMORY_TAG_STREAM));
+	m_compressed=reinterpret_cast<unsigned char*>(EP_MallocTag(m_compressedCapacity,MEMORY_TAG_STREAM));
+	m_rawSize=0;
+	m_compressedSize=0;
+	m_isClosed=false;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_writerLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_writerLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_writerLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_writerLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_writerLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_writerLock=NULL;
+		break;
+	}
+}
+
+BlockCompressWriter::~BlockCompressWriter()
+{
+	Close();
+	if(m_block)
+		EP_FreeTag(m_block,MEMORY_TAG_STREAM);
+	if(m_compressed)
+		EP_FreeTag(m_compressed,MEMORY_TAG_STREAM);
+	if(m_writerLock)
+		EP_DELETE m_writerLock;
+}
+
+bool BlockCompressWriter::Write(const void *data, size_t byteSize)
+{
+	if(!data && byteSize)
+		return false;
+	LockObj lock(m_writerLock);
+	if(m_isClosed || !m_block || !m_compressed)
+		return false;
+
+	const unsigned char *src=reinterpret_cast<const unsigned char*>(data);
+	while(byteSize)
+	{
+		size_t copySize=m_blockSize-m_blockFill;
+		if(copySize>byteSize)
+			copySize=byteSize;
+		System::Memcpy(m_block+m_blockFill,src,copySize);
+		m_blockFill+=static_cast<unsigned int>(copySize);
+		m_rawSize+=copySize;
+		src+=copySize;
+		byteSize-=copySize;
+		if(m_blockFill==m_blockSize && !writeBlock())
+			return false;
+	}
+	return true;
+}
+
+bool BlockCompressWriter::writeBlock()
+{
+	size_t blockByteSize=compressBlock(m_codecType,m_compressed,m_compressedCapacity,m_block,m_blockFill);
+	if(!m_target->WriteBytes(m_compressed,blockByteSize))
+		return false;
+	m_offsetList.push_back(m_compressedSize);
+	m_rawSizeList.push_back(m_blockFill);
+	m_compressedSize+=blockByteSize;
+	m_blockFill=0;
+	return true;
+}
+
+bool BlockCompressWriter::Close()
+{
+	LockObj lock(m_writerLock);
+	if(m_isClosed)
+		return true;
+	m_isClosed=true;
+	if(!m_block || !m_compressed)
+		return false;
+	if(m_blockFill && !writeBlock())
+		return false;
+	if(!writeIndex(*m_target,m_compressedSize,m_offsetList,m_rawSizeList))
+		return false;
+	m_compressedSize+=BLOCK_COMPRESS_HEADER_SIZE+m_offsetList.size()*BLOCK_COMPRESS_ENTRY_SIZE+BLOCK_COMPRESS_FOOTER_SIZE;
+	return true;
+}
+
+bool BlockCompressWriter::IsClosed() const
+{
+	return m_isClosed;
+}
+
+unsigned __int64 BlockCompressWriter::GetRawSize() const
+{
+	return m_rawSize;
+}
+
+unsigned __int64 BlockCompressWriter::GetCompressedSize() const
+{
+	return m_compressedSize;
+}
+
+bool BlockCompressWriter::Compress(Stream &target, const void *data, size_t byteSize, BlockCodecType codecType, unsigned int blockSize, ThreadPool *pool)
+{
+	EP_ASSERT_EXPR(blockSize>0,_T("The block size must be greater than 0."));
+	if(!data && byteSize)
+		return false;
+
+	size_t capacity=getBlockCapacity(codecType,blockSize);
+	size_t blockCount=(byteSize+blockSize-1)/blockSize;
+	size_t batchCount=blockCount<BLOCK_COMPRESS_PARALLEL_BLOCKS?blockCount:BLOCK_COMPRESS_PARALLEL_BLOCKS;
+	unsigned char *compressed=NULL;
+	if(batchCount)
+	{
+		compressed=reinterpret_cast<unsigned char*>(EP_MallocTag(batchCount*capacity,MEMORY_TAG_STREAM));
+		if(!compressed)
+			return false;
+	}
+	std::vector<size_t> compressedSizeList(batchCount);
+	std::vector<unsigned __int64> offsetList;
+	std::vector<unsigned int> rawSizeList;
+	offsetList.reserve(blockCount);
+	rawSizeList.reserve(blockCount);
+
+	Stream::BatchLockObj lock(&target);
+	unsigned __int64 compressedSize=0;
+	bool retVal=true;
+	for(size_t firstBlock=0;retVal && firstBlock<blockCount;firstBlock+=batchCount)
+	{
+		size_t batchBlockCount=blockCount-firstBlock;
+		if(batchBlockCount>batchCount)
+			batchBlockCount=batchCount;
+
+		BlockCompressFunctor func;
+		func.m_codecType=codecType;
+		func.m_data=reinterpret_cast<const unsigned char*>(data)+firstBlock*blockSize;
+		func.m_byteSize=byteSize-firstBlock*blockSize;
+		func.m_blockSize=blockSize;
+		func.m_compressed=compressed;
+		func.m_capacity=capacity;
+		func.m_compressedSizeList=&compressedSizeList.at(0);
+		ParallelFor(pool,0,batchBlockCount,1,func);
+
+		// the blocks are written in order, so the result does not depend on the scheduling.
+		for(size_t blockTrav=0;blockTrav<batchBlockCount;blockTrav++)
+		{
+			if(!target.WriteBytes(compressed+blockTrav*capacity,compressedSizeList[blockTrav]))
+			{
+				retVal=false;
+				break;
+			}
+			size_t rawOffset=(firstBlock+blockTrav)*blockSize;
+			offsetList.push_back(compressedSize);
+			rawSizeList.push_back(static_cast<unsigned int>(byteSize-rawOffset<blockSize?byteSize-rawOffset:blockSize));
+			compressedSize+=compressedSizeList[blockTrav];
+		}
+	}
+	if(compressed)
+		EP_FreeTag(compressed,MEMORY_TAG_STREAM);
+	return retVal && writeIndex(target,compressedSize,offsetList,rawSizeList);
+}
+
+BlockCompressReader::BlockCompressReader()
+{
+	m_data=NULL;
+	m_byteSize=0;
+}
+
+BlockCompressReader::BlockCompressReader(const BlockCompressReader& b)
+{
+	m_data=b.m_data;
+	m_byteSize=b.m_byteSize;
+	m_offsetList=b.m_offsetList;
+	m_rawOffsetList=b.m_rawOffsetList;
+}
+
+BlockCompressReader::~BlockCompressReader()
+{
+}
+
+BlockCompressReader & BlockCompressReader::operator=(const BlockCompressReader&b)
+{
+	if(this!=&b)
+	{
+		m_data=b.m_data;
+		m_byteSize=b.m_byteSize;
+		m_offsetList=b.m_offsetList;
+		m_rawOffsetList=b.m_rawOffsetList;
+	}
+	return *this;
+}
+
+bool BlockCompressReader::Open(const unsigned char *data, size_t byteSize)
+{
+	Close();
+	if(!data || byteSize<BLOCK_COMPRESS_HEADER_SIZE+BLOCK_COMPRESS_FOOTER_SIZE)
+		return false;
+
+	const unsigned char *footer=data+byteSize-BLOCK_COMPRESS_FOOTER_SIZE;
+	unsigned __int64 endOffset;
+	unsigned int blockCount;
+	unsigned int magic;
+	System::Memcpy(&endOffset,footer,sizeof(unsigned __int64));
+	System::Memcpy(&blockCount,footer+8,sizeof(unsigned int));
+	System::Memcpy(&magic,footer+12,sizeof(unsigned int));
+	if(magic!=BLOCK_COMPRESS_MAGIC || blockCount>(byteSize-BLOCK_COMPRESS_HEADER_SIZE-BLOCK_COMPRESS_FOOTER_SIZE)/BLOCK_COMPRESS_ENTRY_SIZE)
+		return false;
+	size_t indexByteSize=BLOCK_COMPRESS_HEADER_SIZE+blockCount*BLOCK_COMPRESS_ENTRY_SIZE+BLOCK_COMPRESS_FOOTER_SIZE;
+	if(endOffset!=byteSize-indexByteSize)
+		return false;
+
+	unsigned int rawSize;
+	unsigned int storedSize;
+	unsigned char codec;
+	readHeader(data+static_cast<size_t>(endOffset),rawSize,storedSize,codec);
+	if(codec!=BLOCK_COMPRESS_END_MARKER || rawSize!=0 || storedSize!=indexByteSize-BLOCK_COMPRESS_HEADER_SIZE)
+		return false;
+
+	// each block is checked against its header once, so DecompressBlock can trust the index.
+	std::vector<size_t> offsetList;
+	std::vector<unsigned __int64> rawOffsetList;
+	offsetList.reserve(blockCount);
+	rawOffsetList.reserve(blockCount+1);
+	const unsigned char *entry=data+static_cast<size_t>(endOffset)+BLOCK_COMPRESS_HEADER_SIZE;
+	size_t blockOffset=0;
+	unsigned __int64 rawOffset=0;
+	for(unsigned int blockTrav=0;blockTrav<blockCount;blockTrav++)
+	{
+		unsigned __int64 offset;
+		unsigned int entryRawSize;
+		System::Memcpy(&offset,entry,sizeof(unsigned __int64));
+		System::Memcpy(&entryRawSize,entry+8,sizeof(unsigned int));
+		entry+=BLOCK_COMPRESS_ENTRY_SIZE;
+		if(offset!=blockOffset || endOffset-blockOffset<BLOCK_COMPRESS_HEADER_SIZE)
+			return false;
+
+		readHeader(data+blockOffset,rawSize,storedSize,codec);
+		if(rawSize!=entryRawSize || rawSize==0 || codec>=BLOCK_CODEC_TYPE_COUNT || storedSize>endOffset-blockOffset-BLOCK_COMPRESS_HEADER_SIZE)
+			return false;
+		offsetList.push_back(blockOffset);
+		rawOffsetList.push_back(rawOffset);
+		blockOffset+=BLOCK_COMPRESS_HEADER_SIZE+storedSize;
+		rawOffset+=rawSize;
+	}
+	if(blockOffset!=endOffset)
+		return false;
+	rawOffsetList.push_back(rawOffset);
+
+	m_data=data;
+	m_byteSize=byteSize;
+	m_offsetList.swap(offsetList);
+	m_rawOffsetList.swap(rawOffsetList);
+	return true;
+}
+
+bool BlockCompressReader::Open(const Stream &source)
+{
+	return Open(source.GetBuffer(),source.GetStreamSize());
+}
+
+void BlockCompressReader::Close()
+{
+	m_data=NULL;
+	m_byteSize=0;
+	m_offsetList.clear();
+	m_rawOffsetList.clear();
+}
+
+bool BlockCompressReader::IsOpened() const
+{
+	return m_data!=NULL;
+}
+
+size_t BlockCompressReader::GetBlockCount() const
+{
+	return m_offsetList.size();
+}
+
+unsigned __int64 BlockCompressReader::GetRawSize() const
+{
+	if(m_rawOffsetList.empty())
+		return 0;
+	return m_rawOffsetList.back();
+}
+
+unsigned __int64 BlockCompressReader::GetBlockRawOffset(size_t blockIdx) const
+{
+	EP_ASSERT_EXPR(blockIdx<m_offsetList.size(),_T("The block index is out of range."));
+	return m_rawOffsetList[blockIdx];
+}
+
+unsigned int BlockCompressReader::GetBlockRawSize(size_t blockIdx) const
+{
+	EP_ASSERT_EXPR(blockIdx<m_offsetList.size(),_T("The block index is out of range."));
+	return static_cast<unsigned int>(m_rawOffsetList[blockIdx+1]-m_rawOffsetList[blockIdx]);
+}
+
+bool BlockCompressReader::DecompressBlock(size_t blockIdx, unsigned char *dest) const
+{
+	if(blockIdx>=m_offsetList.size() || !dest)
+		return false;
+	unsigned int rawSize;
+	unsigned int storedSize;
+	unsigned char codec;
+	const unsigned char *header=m_data+m_offsetList[blockIdx];
+	readHeader(header,rawSize,storedSize,codec);
+	return BlockCodec::Decompress(static_cast<BlockCodecType>(codec),dest,rawSize,header+BLOCK_COMPRESS_HEADER_SIZE,storedSize);
+}
+
+bool BlockCompressReader::Read(unsigned __int64 rawOffset, void *dest, size_t byteSize) const
+{
+	if(!dest && byteSize)
+		return false;
+	if(rawOffset>GetRawSize() || byteSize>GetRawSize()-rawOffset)
+		return false;
+	if(byteSize==0)
+		return true;
+
+	size_t blockIdx=std::upper_bound(m_rawOffsetList.begin(),m_rawOffsetList.end(),rawOffset)-m_rawOffsetList.begin()-1;
+	unsigned char *out=reinterpret_cast<unsigned char*>(dest);
+	unsigned char *block=NULL;
+	size_t blockCapacity=0;
+	bool retVal=true;
+	while(byteSize)
+	{
+		size_t blockRawSize=GetBlockRawSize(blockIdx);
+		size_t inBlockOffset=static_cast<size_t>(rawOffset-m_rawOffsetList[blockIdx]);
+		size_t copySize=blockRawSize-inBlockOffset;
+		if(copySize>byteSize)
+			copySize=byteSize;
+
+		if(copySize==blockRawSize)
+			retVal=DecompressBlock(blockIdx,out);
+		else
+		{
+			// the block partially read is decompressed aside.
+			if(blockCapacity<blockRawSize)
+			{
+				if(block)
+					EP_FreeTag(block,MEMORY_TAG_STREAM);
+				block=reinterpret_cast<unsigned char*>(EP_MallocTag(blockRawSize,MEMORY_TAG_STREAM));
+				blockCapacity=block?blockRawSize:0;
+			}
+			retVal=block && DecompressBlock(blockIdx,block);
+			if(retVal)
+				System::Memcpy(out,block+inBlockOffset,copySize);
+		}
+		if(!retVal)
+			break;
+		out+=copySize;
+		rawOffset+=copySize;
+		byteSize-=copySize;
+		blockIdx++;
+	}
+	if(block)
+		EP_FreeTag(block,MEMORY_TAG_STREAM);
+	return retVal;
+}
+
+bool BlockCompressReader::DecompressAll(Stream &dest, ThreadPool *pool) const
+{
+	unsigned __int64 rawSize=GetRawSize();
+	if(rawSize!=static_cast<size_t>(rawSize))
+		return false;
+	unsigned char *out=dest.WriteUninitialized(static_cast<size_t>(rawSize));
+	if(!out && rawSize)
+		return false;
+
+	volatile long isFailed=0;
+	BlockDecompressFunctor func;
+	func.m_reader=this;
+	func.m_dest=out;
+	func.m_isFailed=&isFailed;
+	ParallelFor(pool,0,m_offsetList.size(),1,func);
+	return isFailed==0;
+}
+
+bool BlockCompressReader::DecompressNextBlock(NetworkStream &source, Stream &dest, bool &retIsEnd)
+{
+	Stream::BatchLockObj lock(&source);
+	size_t readSeek=source.GetReadSeek();
+	const unsigned char *header=source.ReadInPlace(BLOCK_COMPRESS_HEADER_SIZE);
+	if(!header)
+		return false;
+	unsigned int rawSize;
+	unsigned int storedSize;
+	unsigned char codec;
+	readHeader(header,rawSize,storedSize,codec);
+
+	const unsigned char *stored=source.ReadInPlace(storedSize);
+	if(!stored)
+	{
+		source.SetReadSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET,readSeek);
+		return false;
+	}
+	if(codec==BLOCK_COMPRESS_END_MARKER)
+	{
+		retIsEnd=true;
+		return true;
+	}
+	retIsEnd=false;
+
+	unsigned char *out=NULL;
+	if(rawSize==0 || codec>=BLOCK_CODEC_TYPE_COUNT || (out=dest.WriteUninitialized(rawSize))==NULL || !BlockCodec::Decompress(static_cast<BlockCodecType>(codec),out,rawSize,stored,storedSize))
+	{
+		source.SetReadSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET,readSeek);
+		return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -143,6 +143,42 @@ CStringEx CStringEx::SubStr(int begin, int len) const
 }
 
 
+StringView CStringEx::GetView() const
+{
+	return StringView(GetString(),GetLength());
+}
+
+
+StringView CStringEx::LeftView(TCHAR c, int n) const
+{
+	return GetView().Left(c,n);
+}
+
+
+StringView CStringEx::RightView(TCHAR c, int n) const
+{
+	return GetView().Right(c,n);
+}
+
+
+StringView CStringEx::RightmostView(TCHAR c) const
+{
+	return GetView().Rightmost(c);
+}
+
+
+StringView CStringEx::LeftOfRightmostView(TCHAR c) const
+{
+	return GetView().LeftOfRightmost(c);
+}
+
+
+StringView CStringEx::SubStrView(int begin, int len) const
+{
+	return GetView().SubStr(begin,len);
+}
+
+
 CStringEx CStringEx::CommaDelimitNumber(const TCHAR* s)
 {
 	CStringEx s2=s;										// convert to CStringEx
@@ -0,0 +1,325 @@
+/*! 
+Clock for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epClock.h"
+#include "epThread.h"
+#include "epEventEx.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#define EP_CLOCK_TSC
+#endif //defined(_M_IX86) || defined(_M_X64)
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// Enumerator for the calibration state
+enum ClockCalibrationState{
+	/// The clock is not calibrated yet.
+	CLOCK_CALIBRATION_STATE_NONE=0,
+	/// The clock is being calibrated.
+	CLOCK_CALIBRATION_STATE_CALIBRATING,
+	/// The clock is calibrated.
+	CLOCK_CALIBRATION_STATE_CALIBRATED,
+};
+
+/// the calibration state of the clock
+static volatile long s_calibrationState=CLOCK_CALIBRATION_STATE_NONE;
+/// the number of the ticks per second
+static __int64 s_frequency=1000;
+/// the flag whether the ticks are read from the time stamp counter
+static bool s_isTscBased=false;
+
+#if defined(EP_CLOCK_TSC)
+/*!
+Return the flag whether the time stamp counter runs at the constant rate on every core.
+@return true if the time stamp counter is invariant, otherwise false.
+*/
+static bool hasInvariantTsc()
+{
+	int cpuInfo[4];
+	__cpuid(cpuInfo,0x80000000);
+	if(static_cast<unsigned int>(cpuInfo[0])<0x80000007)
+		return false;
+	__cpuid(cpuInfo,0x80000007);
+	return (cpuInfo[3]&(1<<8))!=0;
+}
+#endif //defined(EP_CLOCK_TSC)
+
+/*!
+Calibrate the clock exactly once, and wait for the thread calibrating it.
+*/
+static void calibrateClock()
+{
+	if(InterlockedCompareExchange(&s_calibrationState,CLOCK_CALIBRATION_STATE_CALIBRATING,CLOCK_CALIBRATION_STATE_NONE)!=CLOCK_CALIBRATION_STATE_NONE)
+	{
+		while(s_calibrationState!=CLOCK_CALIBRATION_STATE_CALIBRATED)
+			Sleep(0);
+		return;
+	}
+
+	LARGE_INTEGER frequency;
+	if(!QueryPerformanceFrequency(&frequency) || frequency.QuadPart==0)
+		frequency.QuadPart=1000;
+	s_frequency=frequency.QuadPart;
+	s_isTscBased=false;
+#if defined(EP_CLOCK_TSC)
+	if(hasInvariantTsc())
+	{
+		// spin instead of sleeping, so the thread is not descheduled between the paired reads
+		LARGE_INTEGER startCounter,endCounter;
+		QueryPerformanceCounter(&startCounter);
+		unsigned __int64 startTsc=__rdtsc();
+		unsigned __int64 endTsc;
+		__int64 calibrationCount=frequency.QuadPart*CLOCK_CALIBRATION_TIME/1000;
+		do
+		{
+			QueryPerformanceCounter(&endCounter);
+			endTsc=__rdtsc();
+		}while(endCounter.QuadPart-startCounter.QuadPart<calibrationCount);
+		__int64 tscFrequency=static_cast<__int64>(static_cast<double>(endTsc-startTsc)*static_cast<double>(frequency.QuadPart)/static_cast<double>(endCounter.QuadPart-startCounter.QuadPart));
+		if(tscFrequency>0)
+		{
+			s_frequency=tscFrequency;
+			s_isTscBased=true;
+		}
+	}
+#endif //defined(EP_CLOCK_TSC)
+	InterlockedExchange(&s_calibrationState,CLOCK_CALIBRATION_STATE_CALIBRATED);
+}
+
+__int64 Clock::GetTick()
+{
+	if(s_calibrationState!=CLOCK_CALIBRATION_STATE_CALIBRATED)
+		calibrateClock();
+	// the flags are written before the state is published
+	_ReadWriteBarrier();
+#if defined(EP_CLOCK_TSC)
+	if(s_isTscBased)
+		return static_cast<__int64>(__rdtsc());
+#endif //defined(EP_CLOCK_TSC)
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+__int64 Clock::GetFrequency()
+{
+	if(s_calibrationState!=CLOCK_CALIBRATION_STATE_CALIBRATED)
+		calibrateClock();
+	_ReadWriteBarrier();
+	return s_frequency;
+}
+
+bool Clock::IsTscBased()
+{
+	if(s_calibrationState!=CLOCK_CALIBRATION_STATE_CALIBRATED)
+		calibrateClock();
+	_ReadWriteBarrier();
+	return s_isTscBased;
+}
+
+__int64 Clock::toUnit(__int64 tick, __int64 unitPerSec)
+{
+	__int64 frequency=GetFrequency();
+	// split the conversion so that tick*unitPerSec does not overflow
+	return (tick/frequency)*unitPerSec+(tick%frequency)*unitPerSec/frequency;
+}
+
+__int64 Clock::ToNanoSec(__int64 tick)
+{
+	return toUnit(tick,1000000000);
+}
+
+__int64 Clock::ToMicroSec(__int64 tick)
+{
+	return toUnit(tick,1000000);
+}
+
+__int64 Clock::ToMilliSec(__int64 tick)
+{
+	return toUnit(tick,1000);
+}
+
+__int64 Clock::FromNanoSec(__int64 nanoSec)
+{
+	__int64 frequency=GetFrequency();
+	return (nanoSec/1000000000)*frequency+(nanoSec%1000000000)*frequency/1000000000;
+}
+
+__int64 Clock::GetNanoSec()
+{
+	return ToNanoSec(GetTick());
+}
+
+__int64 Clock::GetMicroSec()
+{
+	return ToMicroSec(GetTick());
+}
+
+__int64 Clock::GetMilliSec()
+{
+	return ToMilliSec(GetTick());
+}
+
+namespace epl
+{
+	/*! 
+	@class CoarseClockThread epClock.cpp
+	@brief A background thread updating CoarseClock.
+	*/
+	class CoarseClockThread:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] clock the coarse clock to update.
+		*/
+		CoarseClockThread(CoarseClock &clock):Thread(),m_clock(clock),m_wakeEvent(false,false)
+		{
+			m_isStopping=false;
+		}
+
+		/*!
+		Stop the thread, and wait until it ends.
+		*/
+		void Stop()
+		{
+			m_isStopping=true;
+			m_wakeEvent.SetEvent();
+			WaitFor();
+		}
+
+	protected:
+		/*!
+		Update the clock on every update interval until stopped.
+		*/
+		virtual void execute()
+		{
+			while(!m_isStopping)
+			{
+				WaitForSingleObject(m_wakeEvent.GetEventHandle(),m_clock.m_updateInterval);
+				m_clock.update();
+			}
+		}
+
+	private:
+		/// the coarse clock to update
+		CoarseClock &m_clock;
+		/// the event waking the thread to stop
+		EventEx m_wakeEvent;
+		/// the flag whether the thread is stopping
+		volatile bool m_isStopping;
+	};
+}
+
+CoarseClock::CoarseClock()
+{
+	m_sequence=0;
+	m_updateInterval=COARSE_CLOCK_DEFAULT_UPDATE_INTERVAL;
+	update();
+	m_thread=EP_NEW CoarseClockThread(*this);
+	m_thread->Start();
+}
+
+CoarseClock::~CoarseClock()
+{
+	m_thread->Stop();
+	EP_DELETE m_thread;
+}
+
+void CoarseClock::update()
+{
+	__int64 milliSec=Clock::GetMilliSec();
+	SYSTEMTIME localTime;
+	::GetLocalTime(&localTime);
+	// only the timer thread writes, so the sequence is odd while the values are changed
+	InterlockedIncrement(&m_sequence);
+	m_milliSec=milliSec;
+	m_localTime=localTime;
+	InterlockedIncrement(&m_sequence);
+}
+
+__int64 CoarseClock::GetMilliSec() const
+{
+#if defined(_M_X64)
+	// the aligned 64-bit load is atomic, so the sequence is only needed for the local time
+	return *static_cast<const volatile __int64*>(&m_milliSec);
+#else //defined(_M_X64)
+	while(true)
+	{
+		long sequence=m_sequence;
+		if(sequence&1)
+		{
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		__int64 milliSec=m_milliSec;
+		MemoryBarrier();
+		if(m_sequence==sequence)
+			return milliSec;
+	}
+#endif //defined(_M_X64)
+}
+
+unsigned int CoarseClock::GetTickCount() const
+{
+	return static_cast<unsigned int>(GetMilliSec());
+}
+
+SYSTEMTIME CoarseClock::GetLocalTime() const
+{
+	while(true)
+	{
+		long sequence=m_sequence;
+		if(sequence&1)
+		{
+			// the timer thread is in the middle of updating
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		SYSTEMTIME localTime=m_localTime;
+		MemoryBarrier();
+		if(m_sequence==sequence)
+			return localTime;
+	}
+}
+
+void CoarseClock::SetUpdateInterval(unsigned int updateInterval)
+{
+	m_updateInterval=updateInterval;
+}
+
+unsigned int CoarseClock::GetUpdateInterval() const
+{
+	return m_updateInterval;
+}
@@ -58,6 +58,7 @@ Please refer to <http://www.codeproject.com/Articles/1205/CCmdLine-command-line-
 */
 
 #include "epCmdLineOptions.h"
+#include "epStringView.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -119,31 +120,34 @@ bool CmdLineOptions::HasOption(const TCHAR *option) const
 EpTString CmdLineOptions::GetArgument(const TCHAR *option,size_t idx, const TCHAR *defaultArg) const
 {
 	EpTString retString=_T("");
-	if(defaultArg!=NULL)
+	if(!findArgument(option,idx,retString) && defaultArg!=NULL)
 		retString=defaultArg;
-	try
-	{
-		retString=GetArgument(option,idx);
-	}
-	catch (...)
-	{
-	}
 	return retString;
 }
 
 EpTString CmdLineOptions::GetArgument(const TCHAR *option,size_t idx) const
+{
+	EpTString retString=_T("");
+	if(findArgument(option,idx,retString))
+		return retString;
+#if !defined(EP_NO_EXCEPTIONS)
+	throw (int)0;
+#endif //!defined(EP_NO_EXCEPTIONS)
+	return retString;
+}
+
+bool CmdLineOptions::findArgument(const TCHAR *option,size_t idx, EpTString &retArg) const
 {
 	CmdLineMap::const_iterator iter;
 	if((iter=find(option))!=end())
 	{
 		if(iter->second.m_args.size()>idx)
 		{
-			return iter->second.m_args.at(idx);
+			retArg=iter->second.m_args[idx];
+			return true;
 		}
 	}
-	throw (int)0;
-
-	return EpTString(_T(""));
+	return false;
 }
 
 int CmdLineOptions::GetArgumentCount(const TCHAR *option) const
@@ -160,18 +164,177 @@ int CmdLineOptions::GetArgumentCount(const TCHAR *option) const
 
 bool CmdLineOptions::isOption(const TCHAR *option) const
 {
-	if(option==NULL)
-		return false;
+	return CmdLineView::IsOption(option);
+}
+
+CmdLineView::CmdLineView()
+{
+}
+
+CmdLineView::CmdLineView(int argc, TCHAR **argv)
+{
+	Parse(argc,argv);
+}
+
+CmdLineView::CmdLineView(const CmdLineView& b)
+{
+	m_options=b.m_options;
+}
 
-	EpTString checkSectorString=option;
-	checkSectorString=Locale::Trim(checkSectorString);
+CmdLineView::~CmdLineView()
+{
+}
 
-	if(checkSectorString.size()>1)
+CmdLineView &CmdLineView::operator=(const CmdLineView & b)
+{
+	if(this!=&b)
 	{
-		if(checkSectorString.at(0)==_T('-'))
+		m_options=b.m_options;
+	}
+	return *this;
+}
+
+size_t CmdLineView::Parse(int argc, TCHAR **argv)
+{
+	m_options.clear();
+
+	int optionCount=0;
+	for(int argTrav=1;argTrav<argc;argTrav++)
+	{
+		if(IsOption(argv[argTrav]))
+			optionCount++;
+	}
+	m_options.reserve(optionCount);
+
+	for(int argTrav=1;argTrav<argc;argTrav++)
+	{
+		if(IsOption(argv[argTrav]))
 		{
-			return !Locale::IsDigit(checkSectorString.at(1));
+			OptionEntry entry;
+			entry.m_option=argv[argTrav];
+			entry.m_argvIdx=argTrav;
+			entry.m_args=argv+argTrav+1;
+			entry.m_argCount=0;
+			while(argTrav+1<argc && !IsOption(argv[argTrav+1]))
+			{
+				entry.m_argCount++;
+				argTrav++;
+			}
+			m_options.push_back(entry);
 		}
 	}
+
+	// sort by the strings, and keep the first of the same options as CmdLineOptions does
+	std::sort(m_options.begin(),m_options.end(),lessOption);
+	size_t uniqueCount=0;
+	for(size_t optionTrav=0;optionTrav<m_options.size();optionTrav++)
+	{
+		if(uniqueCount && _tcscmp(m_options[uniqueCount-1].m_option,m_options[optionTrav].m_option)==0)
+			continue;
+		m_options[uniqueCount++]=m_options[optionTrav];
+	}
+	m_options.resize(uniqueCount);
+	return m_options.size();
+}
+
+size_t CmdLineView::GetOptionCount() const
+{
+	return m_options.size();
+}
+
+int CmdLineView::FindOption(const TCHAR *option) const
+{
+	if(option==NULL)
+		return -1;
+	size_t low=0;
+	size_t high=m_options.size();
+	while(low<high)
+	{
+		size_t mid=low+(high-low)/2;
+		int compResult=_tcscmp(m_options[mid].m_option,option);
+		if(compResult==0)
+			return static_cast<int>(mid);
+		if(compResult<0)
+			low=mid+1;
+		else
+			high=mid;
+	}
+	return -1;
+}
+
+size_t CmdLineView::FindOptions(const TCHAR * const *options, size_t optionCount, int *retOptionIdxs) const
+{
+	size_t retCount=0;
+	for(size_t optionTrav=0;optionTrav<optionCount;optionTrav++)
+	{
+		retOptionIdxs[optionTrav]=FindOption(options[optionTrav]);
+		if(retOptionIdxs[optionTrav]>=0)
+			retCount++;
+	}
+	return retCount;
+}
+
+bool CmdLineView::HasOption(const TCHAR *option) const
+{
+	return FindOption(option)>=0;
+}
+
+const TCHAR *CmdLineView::GetOption(int optionIdx) const
+{
+	if(optionIdx<0 || static_cast<size_t>(optionIdx)>=m_options.size())
+		return NULL;
+	return m_options[optionIdx].m_option;
+}
+
+const TCHAR *CmdLineView::GetArgument(int optionIdx, size_t idx, const TCHAR *defaultArg) const
+{
+	if(optionIdx<0 || static_cast<size_t>(optionIdx)>=m_options.size())
+		return defaultArg;
+	const OptionEntry &entry=m_options[optionIdx];
+	if(idx>=entry.m_argCount)
+		return defaultArg;
+	return entry.m_args[idx];
+}
+
+const TCHAR *CmdLineView::GetArgument(const TCHAR *option, size_t idx, const TCHAR *defaultArg) const
+{
+	return GetArgument(FindOption(option),idx,defaultArg);
+}
+
+const TCHAR * const *CmdLineView::GetArguments(int optionIdx) const
+{
+	if(optionIdx<0 || static_cast<size_t>(optionIdx)>=m_options.size())
+		return NULL;
+	return m_options[optionIdx].m_args;
+}
+
+int CmdLineView::GetArgumentCount(int optionIdx) const
+{
+	if(optionIdx<0 || static_cast<size_t>(optionIdx)>=m_options.size())
+		return -1;
+	return static_cast<int>(m_options[optionIdx].m_argCount);
+}
+
+int CmdLineView::GetArgumentCount(const TCHAR *option) const
+{
+	return GetArgumentCount(FindOption(option));
+}
+
+bool CmdLineView::IsOption(const TCHAR *arg)
+{
+	if(arg==NULL)
+		return false;
+
+	StringView trimmed=StringView(arg).Trim();
+	if(trimmed.GetLength()>1 && trimmed[0]==_T('-'))
+		return !Locale::IsDigit(trimmed[1]);
 	return false;
-}
\ No newline at end of file
+}
+
+bool CmdLineView::lessOption(const OptionEntry &a, const OptionEntry &b)
+{
+	int compResult=_tcscmp(a.m_option,b.m_option);
+	if(compResult!=0)
+		return compResult<0;
+	return a.m_argvIdx<b.m_argvIdx;
+}
@@ -24,6 +24,13 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epConsoleHelper.h"
+#include "epBaseJobProcessor.h"
+#include "epJobHandle.h"
+#include "epThreadPool.h"
+#include "epStream.h"
+#include "epCriticalSectionEx.h"
+#include "epSingletonHolder.h"
+#include <vector>
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -33,42 +40,47 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
-EpTString ReadAndHandleOutput(HANDLE hPipeRead)
+namespace epl
 {
-	CHAR lpBuffer[256];
-	DWORD nBytesRead;
-	EpTString csOutput,csTemp;
-	csOutput=_T("");
-	while(TRUE)
+	/*!
+	@class ConsoleCommandJobProcessor epConsoleHelper.cpp
+	@brief A job processor which executes the command of the ConsoleCommandJob.
+	*/
+	class ConsoleCommandJobProcessor: public BaseJobProcessor
 	{
-		if (!ReadFile(hPipeRead,lpBuffer,sizeof(lpBuffer),
-			&nBytesRead,NULL) || !nBytesRead)
+	public:
+		/*!
+		Execute the command of the given ConsoleCommandJob.
+		@param[in] workerThread The worker thread which called the DoJob.
+		@param[in] data The ConsoleCommandJob given to this object.
+		*/
+		virtual void DoJob(BaseWorkerThread *workerThread, BaseJob* const data)
 		{
-			if (GetLastError() == ERROR_BROKEN_PIPE)
-				break; // pipe done - normal exit path.
-			else
-			{
-				csOutput+=_T("\n\n[Error]ConsoleHelper::ExecuteConsoleCommand:ReadFile Error\n\n"); // Something bad happened.
-				break;
-			}
+			ConsoleCommandJob *job=static_cast<ConsoleCommandJob*>(data);
+			job->m_result=job->execute();
 		}
-
-		// Display the character read on the screen.
-#if defined(_UNICODE) || defined(UNICODE)
-		csTemp=System::MultiByteToWideChar(lpBuffer,nBytesRead);
-		csOutput+=csTemp;
-#else // defined(_UNICODE) || defined(UNICODE)
-		csTemp=lpBuffer;
-		csOutput+=csTemp.substr(0,nBytesRead);
-#endif // defined(_UNICODE) || defined(UNICODE)
-	}
-	return csOutput;
+	};
 }
 
-EpTString ConsoleHelper::ExecuteConsoleCommand(const TCHAR * command, bool isDosCommand, bool isWaitForTerminate,bool isShowWindow, bool useStdOutput, ConsolePriority priority, HANDLE *retProcessHandle)
+/*!
+@class ProcessCreationLock epConsoleHelper.cpp
+@brief The lock held while the inheritable handles exist, so no other child inherits them.
+*/
+class ProcessCreationLock: public CriticalSectionEx
 {
-	EpTString csExecute,csOutput;
-	csOutput=_T("");
+};
+
+#define PROCESS_CREATION_LOCK SingletonHolder<ProcessCreationLock>::Instance()
+
+/*!
+Return the command line to create the process.
+@param[in] command the command to execute
+@param[in] isDosCommand flag whether the command is standard DOS command or not
+@return the command line
+*/
+static EpTString getCommandLine(const TCHAR *command, bool isDosCommand)
+{
+	EpTString csExecute;
 	if(isDosCommand)
 	{
 		csExecute=_T("cmd /c ");
@@ -76,53 +88,26 @@ EpTString ConsoleHelper::ExecuteConsoleCommand(const TCHAR * command, bool isDos
 	}
 	else
 		csExecute=command;
+	return csExecute;
+}
 
-	SECURITY_ATTRIBUTES secattr;
-	ZeroMemory(&secattr,sizeof(secattr));
-	secattr.nLength=sizeof(secattr);
-	secattr.bInheritHandle=TRUE;
-
-	HANDLE hOutputReadTmp,hOutputRead,hOutputWrite;
-	HANDLE hErrorWrite;
-
-	if(isWaitForTerminate && useStdOutput)
-	{
-
-		if(!CreatePipe(&hOutputReadTmp,&hOutputWrite,&secattr,0))
-		{
-			return _T("[Error]ConsoleHelper::ExecuteConsoleCommand:Creating Pipe (hOutputWrite)");
-
-		}
-
-		if (!DuplicateHandle(GetCurrentProcess(),hOutputWrite,GetCurrentProcess(),&hErrorWrite,0, TRUE,DUPLICATE_SAME_ACCESS))
-		{
-			CloseHandle(hOutputReadTmp);
-			CloseHandle(hOutputWrite);
-			return _T("[Error]ConsoleHelper::ExecuteConsoleCommand:Duplicate Handle (hErrorWrite)");
-		}
-		if (!DuplicateHandle(GetCurrentProcess(),hOutputReadTmp,GetCurrentProcess(),&hOutputRead,0,FALSE,DUPLICATE_SAME_ACCESS))
-		{
-			CloseHandle(hOutputWrite);
-			CloseHandle(hErrorWrite);
-			CloseHandle(hOutputReadTmp);
-			return _T("[Error]ConsoleHelper::ExecuteConsoleCommand:Duplicate Handle (hOutputRead)");
-		}
-		CloseHandle(hOutputReadTmp);
-	}
-
+/*!
+Create the process with given output handle as its standard output and error.
+@param[in] commandLine the command line to execute
+@param[in] isShowWindow flag for whether to show console window
+@param[in] priority the priority of the process executing
+@param[in] hOutputWrite the non-inheritable write end of the output pipe, or NULL to print to console
+@param[out] retInfo the process created
+@return true if the process is created, otherwise false
+@remark The handles are made inheritable only while creating the process,
+        so the processes created at once by other threads never hold the pipes of each other.
+*/
+static bool createProcess(EpTString &commandLine, bool isShowWindow, ConsolePriority priority, HANDLE hOutputWrite, PROCESS_INFORMATION &retInfo)
+{
 	STARTUPINFO sInfo;
 	ZeroMemory(&sInfo, sizeof(sInfo));
-	PROCESS_INFORMATION pInfo;
-	ZeroMemory(&pInfo,sizeof(pInfo));
+	ZeroMemory(&retInfo,sizeof(retInfo));
 	sInfo.cb=sizeof(sInfo);
-		
-	if(isWaitForTerminate && useStdOutput)
-	{
-		sInfo.dwFlags=STARTF_USESTDHANDLES;
-		sInfo.hStdInput=NULL;
-		sInfo.hStdOutput=hOutputWrite;
-		sInfo.hStdError=hErrorWrite;
-	}
 
 	DWORD creationFlag=priority;
 	if(isShowWindow)
@@ -136,22 +121,155 @@ EpTString ConsoleHelper::ExecuteConsoleCommand(const TCHAR * command, bool isDos
 		sInfo.wShowWindow=SW_HIDE;
 		creationFlag|=CREATE_NO_WINDOW;
 	}
-	
+
+	LockObj lock(&PROCESS_CREATION_LOCK);
+	HANDLE hStdOutput=NULL;
+	HANDLE hStdError=NULL;
+	if(hOutputWrite)
+	{
+		if(!DuplicateHandle(GetCurrentProcess(),hOutputWrite,GetCurrentProcess(),&hStdOutput,0,TRUE,DUPLICATE_SAME_ACCESS))
+			return false;
+		if(!DuplicateHandle(GetCurrentProcess(),hOutputWrite,GetCurrentProcess(),&hStdError,0,TRUE,DUPLICATE_SAME_ACCESS))
+		{
+			CloseHandle(hStdOutput);
+			return false;
+		}
+		sInfo.dwFlags|=STARTF_USESTDHANDLES;
+		sInfo.hStdInput=NULL;
+		sInfo.hStdOutput=hStdOutput;
+		sInfo.hStdError=hStdError;
+	}
 
 #if defined(_UNICODE) || defined(UNICODE)
-	if(!CreateProcess(0,reinterpret_cast<LPWSTR>(const_cast<wchar_t*>(csExecute.c_str())),0,0,TRUE,creationFlag,0,0,&sInfo,&pInfo))
-		//if(!CreateProcess(0,reinterpret_cast<LPWSTR>(const_cast<wchar_t*>(csExecute.c_str())),0,0,TRUE,priority|CREATE_NEW_CONSOLE,0,0,&sInfo,&pInfo))
+	BOOL isCreated=CreateProcess(0,reinterpret_cast<LPWSTR>(const_cast<wchar_t*>(commandLine.c_str())),0,0,TRUE,creationFlag,0,0,&sInfo,&retInfo);
 #else // defined(_UNICODE) || defined(UNICODE)
-	if(!CreateProcess(0,reinterpret_cast<LPSTR>(const_cast<char*>(csExecute.c_str())),0,0,TRUE,creationFlag,0,0,&sInfo,&pInfo))
-		//if(!CreateProcess(0,reinterpret_cast<LPSTR>(const_cast<char*>(csExecute.c_str())),0,0,TRUE,priority|CREATE_NEW_CONSOLE,0,0,&sInfo,&pInfo))
+	BOOL isCreated=CreateProcess(0,reinterpret_cast<LPSTR>(const_cast<char*>(commandLine.c_str())),0,0,TRUE,creationFlag,0,0,&sInfo,&retInfo);
 #endif // defined(_UNICODE) || defined(UNICODE)
+
+	if(hOutputWrite)
+	{
+		CloseHandle(hStdOutput);
+		CloseHandle(hStdError);
+	}
+	return isCreated!=FALSE;
+}
+
+/*!
+Create the output pipe whose read end supports the overlapped I/O.
+@param[out] retPipeRead the overlapped read end of the pipe
+@param[out] retPipeWrite the non-inheritable write end of the pipe
+@return true if the pipe is created, otherwise false
+@remark the anonymous pipe does not support the overlapped I/O, so the uniquely named pipe is used.
+*/
+static bool createOverlappedPipe(HANDLE &retPipeRead, HANDLE &retPipeWrite)
+{
+	static volatile long pipeSerial=0;
+	TCHAR pipeName[MAX_PATH];
+	System::STPrintf(pipeName,MAX_PATH,_T("\\\\.\\pipe\\EpConsoleHelper.%u.%d"),GetCurrentProcessId(),InterlockedIncrement(&pipeSerial));
+
+	DWORD pipeMode=PIPE_TYPE_BYTE|PIPE_READMODE_BYTE|PIPE_WAIT;
+#if defined(PIPE_REJECT_REMOTE_CLIENTS)
+	pipeMode|=PIPE_REJECT_REMOTE_CLIENTS;
+#endif //defined(PIPE_REJECT_REMOTE_CLIENTS)
+	retPipeRead=CreateNamedPipe(pipeName,PIPE_ACCESS_INBOUND|FILE_FLAG_OVERLAPPED|FILE_FLAG_FIRST_PIPE_INSTANCE,pipeMode,1,CONSOLE_HELPER_OUTPUT_BUFFER_SIZE,CONSOLE_HELPER_OUTPUT_BUFFER_SIZE,0,NULL);
+	if(retPipeRead==INVALID_HANDLE_VALUE)
+		return false;
+	retPipeWrite=CreateFile(pipeName,GENERIC_WRITE,0,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+	if(retPipeWrite==INVALID_HANDLE_VALUE)
 	{
-		if(isWaitForTerminate && useStdOutput)
+		CloseHandle(retPipeRead);
+		return false;
+	}
+	return true;
+}
+
+/*!
+Issue the overlapped read of the output pipe.
+@param[in] hPipeRead the overlapped read end of the output pipe
+@param[in] buffer the buffer of CONSOLE_HELPER_OUTPUT_BUFFER_SIZE bytes to read into
+@param[in] overlapped the overlapped structure of the read
+@param[out] retResult set to false if the read failed other than the pipe closed
+@return true if the read is issued, otherwise false
+*/
+static bool readPipe(HANDLE hPipeRead, char *buffer, OVERLAPPED &overlapped, bool &retResult)
+{
+	ResetEvent(overlapped.hEvent);
+	// the event is signaled even if the read completes at once
+	if(ReadFile(hPipeRead,buffer,CONSOLE_HELPER_OUTPUT_BUFFER_SIZE,NULL,&overlapped) || GetLastError()==ERROR_IO_PENDING)
+		return true;
+	if(GetLastError()!=ERROR_BROKEN_PIPE)
+		retResult=false;
+	return false;
+}
+
+/*!
+Terminate the cancelled command, and cancel the read of the output pipe pending.
+@param[in] hPipeRead the overlapped read end of the output pipe
+@param[in] hProcess the process of the command
+*/
+static void terminateCommand(HANDLE hPipeRead, HANDLE hProcess)
+{
+	TerminateProcess(hProcess,ERROR_CANCELLED);
+	CancelIo(hPipeRead);
+}
+
+EpTString ReadAndHandleOutput(HANDLE hPipeRead)
+{
+	// the bytes are kept as they are and converted at once, so no character is split over the reads
+	std::vector<CHAR> buffer(CONSOLE_HELPER_OUTPUT_BUFFER_SIZE);
+	std::string output;
+	DWORD nBytesRead;
+	bool isError=false;
+	while(TRUE)
+	{
+		if (!ReadFile(hPipeRead,&buffer[0],(DWORD)buffer.size(),
+			&nBytesRead,NULL) || !nBytesRead)
 		{
-			CloseHandle(hOutputWrite);
-			CloseHandle(hErrorWrite);
-			CloseHandle(hOutputRead);
+			if (GetLastError() != ERROR_BROKEN_PIPE)
+				isError=true; // Something bad happened.
+			break; // pipe done - normal exit path.
+		}
+		output.append(&buffer[0],nBytesRead);
+	}
+
+	EpTString csOutput;
+#if defined(_UNICODE) || defined(UNICODE)
+	if(output.size())
+		csOutput=System::MultiByteToWideChar(output.c_str(),(int)output.size());
+#else // defined(_UNICODE) || defined(UNICODE)
+	csOutput=output;
+#endif // defined(_UNICODE) || defined(UNICODE)
+	if(isError)
+		csOutput+=_T("\n\n[Error]ConsoleHelper::ExecuteConsoleCommand:ReadFile Error\n\n");
+	return csOutput;
+}
+
+EpTString ConsoleHelper::ExecuteConsoleCommand(const TCHAR * command, bool isDosCommand, bool isWaitForTerminate,bool isShowWindow, bool useStdOutput, ConsolePriority priority, HANDLE *retProcessHandle)
+{
+	EpTString csExecute,csOutput;
+	csOutput=_T("");
+	csExecute=getCommandLine(command,isDosCommand);
+
+	HANDLE hOutputRead=NULL;
+	HANDLE hOutputWrite=NULL;
+
+	if(isWaitForTerminate && useStdOutput)
+	{
+		if(!CreatePipe(&hOutputRead,&hOutputWrite,NULL,0))
+		{
+			return _T("[Error]ConsoleHelper::ExecuteConsoleCommand:Creating Pipe (hOutputWrite)");
 		}
+	}
+
+	PROCESS_INFORMATION pInfo;
+	bool isCreated=createProcess(csExecute,isShowWindow,priority,hOutputWrite,pInfo);
+	// the child holds its own copy, so the pipe is broken when the child exits
+	if(hOutputWrite)
+		CloseHandle(hOutputWrite);
+	if(!isCreated)
+	{
+		if(hOutputRead)
+			CloseHandle(hOutputRead);
 		return _T("[Error]ConsoleHelper::ExecuteConsoleCommand:Creating Process");
 	}
 	if(retProcessHandle)
@@ -162,11 +280,7 @@ EpTString ConsoleHelper::ExecuteConsoleCommand(const TCHAR * command, bool isDos
 	if(isWaitForTerminate)
 	{
 		if(useStdOutput)
-		{
-			CloseHandle(hOutputWrite);
-			CloseHandle(hErrorWrite);
 			csOutput=ReadAndHandleOutput(hOutputRead);
-		}
 		System::WaitForSingleObject(pInfo.hProcess,WAITTIME_INIFINITE);
 		if(useStdOutput)
 			CloseHandle(hOutputRead);
@@ -183,6 +297,175 @@ EpTString ConsoleHelper::ExecuteConsoleCommand(const TCHAR * command, bool isDos
 
 }
 
+ConsoleCommandJob::ConsoleCommandJob(const TCHAR *command, bool isDosCommand, ConsoleCallbackInterface *callBackObj, Stream *outputStream, ConsolePriority priority, LockPolicy lockPolicyType):BaseJob(PRIORITY_NORMAL,lockPolicyType)
+{
+	if(command)
+		m_command=command;
+	m_commandLine=getCommandLine(m_command.c_str(),isDosCommand);
+	m_priority=priority;
+	m_callBackObj=callBackObj;
+	m_outputStream=outputStream;
+	m_exitCode=0;
+	m_result=false;
+	m_isReported=0;
+}
+
+ConsoleCommandJob::~ConsoleCommandJob()
+{
+}
+
+const TCHAR *ConsoleCommandJob::GetCommand() const
+{
+	return m_command.c_str();
+}
+
+bool ConsoleCommandJob::GetResult() const
+{
+	return m_result;
+}
+
+unsigned long ConsoleCommandJob::GetExitCode() const
+{
+	return m_exitCode;
+}
+
+EpTString ConsoleCommandJob::GetOutput() const
+{
+#if defined(_UNICODE) || defined(UNICODE)
+	if(!m_output.size())
+		return EpTString();
+	return System::MultiByteToWideChar(m_output.c_str(),(int)m_output.size());
+#else // defined(_UNICODE) || defined(UNICODE)
+	return m_output;
+#endif // defined(_UNICODE) || defined(UNICODE)
+}
+
+JobHandle *ConsoleCommandJob::Submit(ThreadPool *pool)
+{
+	EP_ASSERT_EXPR(pool,_T("The thread pool is NULL."));
+	m_exitCode=0;
+	m_result=false;
+	m_isReported=0;
+	m_output.clear();
+	ConsoleCommandJobProcessor *jobProcessor=EP_NEW ConsoleCommandJobProcessor();
+	SetJobProcessor(jobProcessor);
+	jobProcessor->ReleaseObj();
+	return pool->Submit(this);
+}
+
+bool ConsoleCommandJob::execute()
+{
+	HANDLE hPipeRead,hPipeWrite;
+	if(!createOverlappedPipe(hPipeRead,hPipeWrite))
+		return false;
+
+	PROCESS_INFORMATION pInfo;
+	bool isCreated=createProcess(m_commandLine,false,m_priority,hPipeWrite,pInfo);
+	// the child holds its own copy, so the pipe is broken when the child exits
+	CloseHandle(hPipeWrite);
+	if(!isCreated)
+	{
+		CloseHandle(hPipeRead);
+		return false;
+	}
+
+	bool result=readOutput(hPipeRead,pInfo.hProcess);
+	CloseHandle(hPipeRead);
+
+	System::WaitForSingleObject(pInfo.hProcess,WAITTIME_INIFINITE);
+	DWORD exitCode=0;
+	GetExitCodeProcess(pInfo.hProcess,&exitCode);
+	m_exitCode=exitCode;
+	CloseHandle(pInfo.hProcess);
+	CloseHandle(pInfo.hThread);
+	return result;
+}
+
+bool ConsoleCommandJob::readOutput(HANDLE hPipeRead, HANDLE hProcess)
+{
+	OVERLAPPED overlapped;
+	ZeroMemory(&overlapped,sizeof(overlapped));
+	overlapped.hEvent=CreateEvent(NULL,TRUE,FALSE,NULL);
+	if(!overlapped.hEvent)
+		return false;
+
+	// one buffer is read into while the other is handled
+	std::vector<char> bufferList[2];
+	bufferList[0].resize(CONSOLE_HELPER_OUTPUT_BUFFER_SIZE);
+	bufferList[1].resize(CONSOLE_HELPER_OUTPUT_BUFFER_SIZE);
+	unsigned int readIdx=0;
+	bool result=true;
+	bool isPending=readPipe(hPipeRead,&bufferList[readIdx][0],overlapped,result);
+	while(isPending)
+	{
+		while(System::WaitForSingleObject(overlapped.hEvent,CONSOLE_HELPER_CANCEL_CHECK_INTERVAL)==WAIT_TIMEOUT)
+		{
+			if(IsCancelled())
+			{
+				terminateCommand(hPipeRead,hProcess);
+				result=false;
+				break;
+			}
+		}
+
+		DWORD bytesRead=0;
+		// waits for the cancelled read as well, so the buffer is not written after freed
+		if(!GetOverlappedResult(hPipeRead,&overlapped,&bytesRead,TRUE))
+		{
+			if(GetLastError()!=ERROR_BROKEN_PIPE)
+				result=false;
+			break;
+		}
+		if(!result)
+			break;
+		// the command writing without a pause never times out the wait, so check before every read as well
+		if(IsCancelled())
+		{
+			terminateCommand(hPipeRead,hProcess);
+			result=false;
+			break;
+		}
+
+		// the next read is issued before this output is handled
+		unsigned int handleIdx=readIdx;
+		readIdx^=1;
+		isPending=readPipe(hPipeRead,&bufferList[readIdx][0],overlapped,result);
+		if(bytesRead)
+			handleOutput(&bufferList[handleIdx][0],bytesRead);
+	}
+	CloseHandle(overlapped.hEvent);
+	return result;
+}
+
+void ConsoleCommandJob::handleOutput(const char *output, size_t outputSize)
+{
+	if(m_callBackObj)
+		m_callBackObj->OnConsoleOutput(m_command.c_str(),output,outputSize);
+	if(m_outputStream)
+		m_outputStream->WriteBytes(reinterpret_cast<const unsigned char*>(output),outputSize);
+	if(!m_callBackObj && !m_outputStream)
+		m_output.append(output,outputSize);
+}
+
+void ConsoleCommandJob::handleReport(const JobStatus status)
+{
+	switch(status)
+	{
+	case JOB_STATUS_DONE:
+	case JOB_STATUS_INCOMPLETE:
+	case JOB_STATUS_JOB_PROCESSOR_TIMEOUT:
+	case JOB_STATUS_TIMEOUT:
+	case JOB_STATUS_CANCELLED:
+		if(status!=JOB_STATUS_DONE)
+			m_result=false;
+		if(m_callBackObj && InterlockedExchange(&m_isReported,1)==0)
+			m_callBackObj->OnConsoleComplete(m_command.c_str(),m_exitCode,m_result);
+		break;
+	default:
+		break;
+	}
+}
+
 void ConsoleHelper::ExecuteProgram(const TCHAR * execFilePath, const TCHAR *parameters)
 {
 	ShellExecute(0,0,execFilePath,parameters,0,SW_SHOWNORMAL);
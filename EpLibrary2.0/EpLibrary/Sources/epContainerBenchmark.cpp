@@ -0,0 +1,1017 @@
+/*! 
+ContainerBenchmark for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epContainerBenchmark.h"
+#include "epSystem.h"
+#include "epKAryHeap.h"
+#include "epPatriciaTrie.h"
+#include "epDynamicArray.h"
+#include "epQuickSort.h"
+#include "epMergeSort.h"
+#include "epBinarySearch.h"
+#include <vector>
+#include <queue>
+#include <map>
+#include <set>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the number of the elements of the smallest container measured
+#define CONTAINER_BENCHMARK_MIN_SIZE 1024
+
+/// the largest multiple of the size the key held is raised by
+#define CONTAINER_BENCHMARK_HOLD_SPREAD 16
+
+/// the seed of the data generated
+#define CONTAINER_BENCHMARK_SEED 0x2545F491
+
+/// the number of the characters of the prefix searched by FindAll
+#define CONTAINER_BENCHMARK_PREFIX_LENGTH 3
+
+/// the letters of the words in the order of the English letter frequency
+static const char s_letterList[]="etaoinshrdlcumwfgypbvkjxqz";
+
+/// the cumulative English letter frequency in the tenth of percent, parallel to s_letterList
+static const unsigned int s_letterFrequencyList[]={127,218,300,375,442,509,572,633,693,736,776,804,832,856,880,902,922,942,961,976,986,994,996,998,999,1000};
+
+/// the directory names of the paths
+static const char *s_segmentList[]={"home","usr","var","lib","share","local","bin","src","include","doc","cache","log","tmp","data","config","image"};
+
+/// the names of the string corpora measured
+static const TCHAR *s_corpusNameList[]={_T("WORDS"),_T("PATHS")};
+
+/// the names of the list orders sorted
+static const TCHAR *s_orderNameList[]={_T("RANDOM"),_T("SORTED")};
+
+/// the sink of the results read, so the reads are not optimized away
+static volatile size_t s_sink=0;
+
+/*!
+Return the next random number of the xorshift generator.
+@param[in,out] state the state of the generator, which must not be 0.
+@return the random number.
+*/
+static unsigned int nextRandom(unsigned int &state)
+{
+	state^=state<<13;
+	state^=state>>17;
+	state^=state<<5;
+	return state;
+}
+
+/*!
+Generate the distinct random keys.
+@param[in] count the number of the keys.
+@param[out] retKeyList the keys generated.
+@remark each key is distinct in the lower bits by its index, so no key repeats.
+*/
+static void generateKeys(size_t count, std::vector<unsigned int> &retKeyList)
+{
+	unsigned int state=CONTAINER_BENCHMARK_SEED;
+	retKeyList.resize(count);
+	for(size_t keyTrav=0;keyTrav<count;keyTrav++)
+		retKeyList[keyTrav]=static_cast<unsigned int>(keyTrav);
+	for(size_t keyTrav=count;keyTrav>1;keyTrav--)
+		std::swap(retKeyList[keyTrav-1],retKeyList[nextRandom(state)%keyTrav]);
+}
+
+/*!
+Generate the distinct strings of given corpus.
+@param[in] corpusIdx the index of the corpus, 0 for the words and 1 for the paths.
+@param[in] count the number of the strings.
+@param[out] retStringList the strings generated, in the random order.
+*/
+static void generateStrings(size_t corpusIdx, size_t count, std::vector<std::string> &retStringList)
+{
+	unsigned int state=CONTAINER_BENCHMARK_SEED;
+	std::set<std::string> stringSet;
+	retStringList.clear();
+	retStringList.reserve(count);
+	while(retStringList.size()<count)
+	{
+		std::string str;
+		if(corpusIdx==0)
+		{
+			// 2 to 12 letters, mostly 4 to 8 as the English words
+			size_t length=2+nextRandom(state)%4+nextRandom(state)%4+nextRandom(state)%4;
+			for(size_t charTrav=0;charTrav<length;charTrav++)
+			{
+				unsigned int frequency=nextRandom(state)%1000;
+				size_t letterIdx=0;
+				while(s_letterFrequencyList[letterIdx]<=frequency)
+					letterIdx++;
+				str.push_back(s_letterList[letterIdx]);
+			}
+		}
+		else
+		{
+			// 2 to 4 directories and a numbered file, so the paths share the long prefixes
+			size_t depth=2+nextRandom(state)%3;
+			for(size_t depthTrav=0;depthTrav<depth;depthTrav++)
+			{
+				str.push_back('/');
+				str.append(s_segmentList[nextRandom(state)%(sizeof(s_segmentList)/sizeof(char*))]);
+			}
+			char fileName[32];
+			System::SPrintf(fileName,sizeof(fileName),"/file%u.dat",nextRandom(state)%100000);
+			str.append(fileName);
+		}
+		if(stringSet.insert(str).second)
+			retStringList.push_back(str);
+	}
+}
+
+namespace epl
+{
+	/// the key of the heaps, which is wide enough for the keys raised on every operation
+	typedef unsigned __int64 ContainerHeapKey;
+
+	/*!
+	@class ContainerHeapHoldCase epContainerBenchmark.cpp
+	@brief A template benchmark case popping the minimum from KAryHeap and pushing a larger key per operation.
+	*/
+	template<size_t k>
+	class ContainerHeapHoldCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] keyList the keys the heap holds.
+		*/
+		ContainerHeapHoldCase(const std::vector<unsigned int> &keyList):BenchmarkCase(),m_keyList(keyList),m_heap(KARY_HEAP_MODE_LOOP,LOCK_POLICY_NONE)
+		{
+		}
+
+		/*!
+		Fill the heap with the keys.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			// the heap is built at once, as Push checks the whole heap for the duplicate key
+			std::vector<ContainerHeapKey> heapKeyList(m_keyList.begin(),m_keyList.end());
+			m_heap.Assign(&heapKeyList[0],&m_keyList[0],m_keyList.size());
+		}
+
+		/*!
+		Pop and push.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			ContainerHeapKey key;
+			unsigned int data;
+			size_t size=m_keyList.size();
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				m_heap.Pop(key,data);
+				// the key stays the same modulo the size, so the new key is unique
+				key+=size*(1+m_keyList[opTrav%size]%CONTAINER_BENCHMARK_HOLD_SPREAD);
+				m_heap.Push(key,data);
+			}
+		}
+
+	private:
+		/// the keys the heap holds
+		const std::vector<unsigned int> &m_keyList;
+		/// the heap measured
+		KAryHeap<ContainerHeapKey,unsigned int,k> m_heap;
+	};
+
+	/*!
+	@class ContainerStdHeapHoldCase epContainerBenchmark.cpp
+	@brief A benchmark case popping the minimum from std::priority_queue and pushing a larger key per operation.
+	*/
+	class ContainerStdHeapHoldCase:public BenchmarkCase
+	{
+	public:
+		/// the ordered pair of the key and the data
+		typedef std::pair<ContainerHeapKey,unsigned int> KeyDataPair;
+
+		/*!
+		Default Constructor
+		@param[in] keyList the keys the heap holds.
+		*/
+		ContainerStdHeapHoldCase(const std::vector<unsigned int> &keyList):BenchmarkCase(),m_keyList(keyList)
+		{
+		}
+
+		/*!
+		Fill the heap with the keys.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_heap=std::priority_queue<KeyDataPair,std::vector<KeyDataPair>,std::greater<KeyDataPair> >();
+			for(size_t keyTrav=0;keyTrav<m_keyList.size();keyTrav++)
+				m_heap.push(KeyDataPair(m_keyList[keyTrav],m_keyList[keyTrav]));
+		}
+
+		/*!
+		Pop and push.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			size_t size=m_keyList.size();
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				KeyDataPair node=m_heap.top();
+				m_heap.pop();
+				node.first+=size*(1+m_keyList[opTrav%size]%CONTAINER_BENCHMARK_HOLD_SPREAD);
+				m_heap.push(node);
+			}
+		}
+
+	private:
+		/// the keys the heap holds
+		const std::vector<unsigned int> &m_keyList;
+		/// the heap measured
+		std::priority_queue<KeyDataPair,std::vector<KeyDataPair>,std::greater<KeyDataPair> > m_heap;
+	};
+
+	/*!
+	@class ContainerHeapChangeKeyCase epContainerBenchmark.cpp
+	@brief A template benchmark case raising the key of a random element of KAryHeap in KARY_HEAP_MODE_INDEXED per operation.
+	*/
+	template<size_t k>
+	class ContainerHeapChangeKeyCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] keyList the keys the heap holds, which are 0 to the size, shuffled.
+		*/
+		ContainerHeapChangeKeyCase(const std::vector<unsigned int> &keyList):BenchmarkCase(),m_keyList(keyList),m_heap(KARY_HEAP_MODE_INDEXED,LOCK_POLICY_NONE)
+		{
+		}
+
+		/*!
+		Fill the heap with the keys.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_currentKeyList.resize(m_keyList.size());
+			for(size_t keyTrav=0;keyTrav<m_keyList.size();keyTrav++)
+				m_currentKeyList[keyTrav]=keyTrav;
+			std::vector<ContainerHeapKey> heapKeyList(m_keyList.begin(),m_keyList.end());
+			m_heap.Assign(&heapKeyList[0],&m_keyList[0],m_keyList.size());
+		}
+
+		/*!
+		Raise the key.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			size_t size=m_keyList.size();
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				// the key stays the same modulo the size, so the new key is unique
+				ContainerHeapKey &key=m_currentKeyList[m_keyList[opTrav%size]];
+				m_heap.ChangeKey(key,key+size);
+				key+=size;
+			}
+		}
+
+	private:
+		/// the keys the heap holds
+		const std::vector<unsigned int> &m_keyList;
+		/// the current key of each element, indexed by the key modulo the size
+		std::vector<ContainerHeapKey> m_currentKeyList;
+		/// the heap measured
+		KAryHeap<ContainerHeapKey,unsigned int,k> m_heap;
+	};
+
+	/*!
+	@class ContainerStdChangeKeyCase epContainerBenchmark.cpp
+	@brief A benchmark case raising the key of a random element of std::map, by erasing and inserting, per operation.
+	*/
+	class ContainerStdChangeKeyCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] keyList the keys the map holds, which are 0 to the size, shuffled.
+		*/
+		ContainerStdChangeKeyCase(const std::vector<unsigned int> &keyList):BenchmarkCase(),m_keyList(keyList)
+		{
+		}
+
+		/*!
+		Fill the map with the keys.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_map.clear();
+			m_currentKeyList.resize(m_keyList.size());
+			for(size_t keyTrav=0;keyTrav<m_keyList.size();keyTrav++)
+				m_currentKeyList[keyTrav]=keyTrav;
+			for(size_t keyTrav=0;keyTrav<m_keyList.size();keyTrav++)
+				m_map[m_keyList[keyTrav]]=m_keyList[keyTrav];
+		}
+
+		/*!
+		Raise the key.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			size_t size=m_keyList.size();
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				ContainerHeapKey &key=m_currentKeyList[m_keyList[opTrav%size]];
+				std::map<ContainerHeapKey,unsigned int>::iterator iter=m_map.find(key);
+				unsigned int data=iter->second;
+				m_map.erase(iter);
+				key+=size;
+				m_map.insert(std::pair<ContainerHeapKey,unsigned int>(key,data));
+			}
+		}
+
+	private:
+		/// the keys the map holds
+		const std::vector<unsigned int> &m_keyList;
+		/// the current key of each element, indexed by the key modulo the size
+		std::vector<ContainerHeapKey> m_currentKeyList;
+		/// the map measured
+		std::map<ContainerHeapKey,unsigned int> m_map;
+	};
+
+	/*!
+	@class ContainerTrieInsertCase epContainerBenchmark.cpp
+	@brief A benchmark case inserting one string to PatriciaTrie per operation.
+
+	The trie is cleared each time all strings are inserted, so the cost of clearing is included.
+	*/
+	class ContainerTrieInsertCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] stringList the strings to insert.
+		*/
+		ContainerTrieInsertCase(const std::vector<std::string> &stringList):BenchmarkCase(),m_stringList(stringList),m_trie(PATRICIA_TRIE_MODE_LOOP,LOCK_POLICY_NONE)
+		{
+		}
+
+		/*!
+		Insert the strings.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			m_trie.Clear();
+			size_t stringIdx=0;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				if(stringIdx==m_stringList.size())
+				{
+					m_trie.Clear();
+					stringIdx=0;
+				}
+				m_trie.Insert(m_stringList[stringIdx].c_str(),static_cast<int>(stringIdx));
+				stringIdx++;
+			}
+		}
+
+	private:
+		/// the strings to insert
+		const std::vector<std::string> &m_stringList;
+		/// the trie measured
+		PatriciaTrie<char,int> m_trie;
+	};
+
+	/*!
+	@class ContainerStdInsertCase epContainerBenchmark.cpp
+	@brief A benchmark case inserting one string to std::map per operation.
+
+	The map is cleared each time all strings are inserted, so the cost of clearing is included.
+	*/
+	class ContainerStdInsertCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] stringList the strings to insert.
+		*/
+		ContainerStdInsertCase(const std::vector<std::string> &stringList):BenchmarkCase(),m_stringList(stringList)
+		{
+		}
+
+		/*!
+		Insert the strings.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			m_map.clear();
+			size_t stringIdx=0;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				if(stringIdx==m_stringList.size())
+				{
+					m_map.clear();
+					stringIdx=0;
+				}
+				m_map.insert(std::pair<std::string,int>(m_stringList[stringIdx],static_cast<int>(stringIdx)));
+				stringIdx++;
+			}
+		}
+
+	private:
+		/// the strings to insert
+		const std::vector<std::string> &m_stringList;
+		/// the map measured
+		std::map<std::string,int> m_map;
+	};
+
+	/*!
+	@class ContainerTrieFindCase epContainerBenchmark.cpp
+	@brief A benchmark case finding one string, or all strings with one prefix, from PatriciaTrie per operation.
+	*/
+	class ContainerTrieFindCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] stringList the strings the trie holds.
+		@param[in] keyList the shuffled indices of the strings to find.
+		@param[in] isPrefix the flag whether all strings with the prefix of the string are found.
+		*/
+		ContainerTrieFindCase(const std::vector<std::string> &stringList, const std::vector<unsigned int> &keyList, bool isPrefix):BenchmarkCase(),m_stringList(stringList),m_keyList(keyList),m_trie(PATRICIA_TRIE_MODE_LOOP,LOCK_POLICY_NONE)
+		{
+			m_isPrefix=isPrefix;
+			for(size_t stringTrav=0;stringTrav<m_stringList.size();stringTrav++)
+			{
+				m_trie.Insert(m_stringList[stringTrav].c_str(),static_cast<int>(stringTrav));
+				m_prefixList.push_back(m_stringList[stringTrav].substr(0,CONTAINER_BENCHMARK_PREFIX_LENGTH));
+			}
+		}
+
+		/*!
+		Find the strings.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			size_t foundCount=0;
+			int data;
+			vector<Pair<const char*,int> > pairList;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				unsigned int stringIdx=m_keyList[opTrav%m_keyList.size()];
+				if(m_isPrefix)
+				{
+					pairList.clear();
+					m_trie.FindAll(m_prefixList[stringIdx].c_str(),pairList);
+					foundCount+=pairList.size();
+				}
+				else if(m_trie.Find(m_stringList[stringIdx].c_str(),data))
+					foundCount++;
+			}
+			s_sink=foundCount;
+		}
+
+	private:
+		/// the strings the trie holds
+		const std::vector<std::string> &m_stringList;
+		/// the shuffled indices of the strings to find
+		const std::vector<unsigned int> &m_keyList;
+		/// the prefixes of the strings
+		std::vector<std::string> m_prefixList;
+		/// the flag whether all strings with the prefix are found
+		bool m_isPrefix;
+		/// the trie measured
+		PatriciaTrie<char,int> m_trie;
+	};
+
+	/*!
+	@class ContainerStdFindCase epContainerBenchmark.cpp
+	@brief A benchmark case finding one string, or all strings with one prefix, from std::map per operation.
+	*/
+	class ContainerStdFindCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] stringList the strings the map holds.
+		@param[in] keyList the shuffled indices of the strings to find.
+		@param[in] isPrefix the flag whether all strings with the prefix of the string are found.
+		*/
+		ContainerStdFindCase(const std::vector<std::string> &stringList, const std::vector<unsigned int> &keyList, bool isPrefix):BenchmarkCase(),m_stringList(stringList),m_keyList(keyList)
+		{
+			m_isPrefix=isPrefix;
+			for(size_t stringTrav=0;stringTrav<m_stringList.size();stringTrav++)
+			{
+				m_map[m_stringList[stringTrav]]=static_cast<int>(stringTrav);
+				m_prefixList.push_back(m_stringList[stringTrav].substr(0,CONTAINER_BENCHMARK_PREFIX_LENGTH));
+			}
+		}
+
+		/*!
+		Find the strings.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			size_t foundCount=0;
+			std::vector<std::pair<const char*,int> > pairList;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				unsigned int stringIdx=m_keyList[opTrav%m_keyList.size()];
+				if(m_isPrefix)
+				{
+					// the same list of the pairs as FindAll returns
+					const std::string &prefix=m_prefixList[stringIdx];
+					pairList.clear();
+					std::map<std::string,int>::const_iterator iter=m_map.lower_bound(prefix);
+					for(;iter!=m_map.end() && iter->first.compare(0,prefix.size(),prefix)==0;iter++)
+						pairList.push_back(std::pair<const char*,int>(iter->first.c_str(),iter->second));
+					foundCount+=pairList.size();
+				}
+				else if(m_map.find(m_stringList[stringIdx])!=m_map.end())
+					foundCount++;
+			}
+			s_sink=foundCount;
+		}
+
+	private:
+		/// the strings the map holds
+		const std::vector<std::string> &m_stringList;
+		/// the shuffled indices of the strings to find
+		const std::vector<unsigned int> &m_keyList;
+		/// the prefixes of the strings
+		std::vector<std::string> m_prefixList;
+		/// the flag whether all strings with the prefix are found
+		bool m_isPrefix;
+		/// the map measured
+		std::map<std::string,int> m_map;
+	};
+
+	/*!
+	@class ContainerAppendCase epContainerBenchmark.cpp
+	@brief A template benchmark case appending one element to the array per operation.
+
+	A new array is started each time the array reaches the size, so the cost of growing is included.
+	*/
+	template<typename ArrayType>
+	class ContainerAppendCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] size the number of the elements of each array.
+		*/
+		ContainerAppendCase(size_t size):BenchmarkCase()
+		{
+			m_size=size;
+		}
+
+		/*!
+		Append the elements.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			unsigned int opTrav=0;
+			while(opTrav<iterationCount)
+			{
+				ArrayType arr;
+				for(size_t elemTrav=0;elemTrav<m_size && opTrav<iterationCount;elemTrav++,opTrav++)
+					arr.push_back(static_cast<int>(elemTrav));
+				s_sink=arr.size();
+			}
+		}
+
+	private:
+		/// the number of the elements of each array
+		size_t m_size;
+	};
+
+	/*!
+	@class ContainerDynamicArray epContainerBenchmark.cpp
+	@brief A DynamicArray without the lock, with the interface of std::vector used by the benchmark cases.
+	*/
+	class ContainerDynamicArray:public DynamicArray<int>
+	{
+	public:
+		/*!
+		Default Constructor
+		*/
+		ContainerDynamicArray():DynamicArray<int>(0,LOCK_POLICY_NONE)
+		{
+		}
+
+		/*!
+		Append the element.
+		@param[in] data the element.
+		*/
+		void push_back(int data)
+		{
+			Append(data);
+		}
+
+		/*!
+		Return the number of the elements.
+		@return the number of the elements.
+		*/
+		size_t size() const
+		{
+			return Size();
+		}
+	};
+
+	/*!
+	@class ContainerAccessCase epContainerBenchmark.cpp
+	@brief A template benchmark case reading one element of the array in the random order per operation.
+	*/
+	template<typename ArrayType>
+	class ContainerAccessCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] keyList the shuffled indices to read, which are also the elements of the array.
+		*/
+		ContainerAccessCase(const std::vector<unsigned int> &keyList):BenchmarkCase(),m_keyList(keyList)
+		{
+			for(size_t keyTrav=0;keyTrav<m_keyList.size();keyTrav++)
+				m_arr.push_back(static_cast<int>(m_keyList[keyTrav]));
+		}
+
+		/*!
+		Read the elements.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			size_t sum=0;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+				sum+=static_cast<size_t>(m_arr[m_keyList[opTrav%m_keyList.size()]]);
+			s_sink=sum;
+		}
+
+	private:
+		/// the shuffled indices to read
+		const std::vector<unsigned int> &m_keyList;
+		/// the array measured
+		ArrayType m_arr;
+	};
+
+	/// Enumeration for the sort measured
+	enum ContainerSortKind{
+		/// QuickSort in QSORT_MODE_RECURSIVE
+		CONTAINER_SORT_QUICK_RECURSIVE=0,
+		/// QuickSort in QSORT_MODE_LOOP
+		CONTAINER_SORT_QUICK_LOOP,
+		/// MergeSort in MSORT_MODE_RECURSIVE
+		CONTAINER_SORT_MERGE_RECURSIVE,
+		/// MergeSort in MSORT_MODE_LOOP
+		CONTAINER_SORT_MERGE_LOOP,
+		/// MergeSort in MSORT_MODE_BOTTOM_UP
+		CONTAINER_SORT_MERGE_BOTTOM_UP,
+		/// MergeSort in MSORT_MODE_ADAPTIVE
+		CONTAINER_SORT_MERGE_ADAPTIVE,
+		/// std::sort
+		CONTAINER_SORT_STD_SORT,
+		/// std::stable_sort
+		CONTAINER_SORT_STD_STABLE_SORT,
+		/// Sort Count
+		CONTAINER_SORT_COUNT,
+	};
+
+	/*!
+	@class ContainerSortCase epContainerBenchmark.cpp
+	@brief A benchmark case copying the unsorted list in and sorting it per operation.
+	*/
+	class ContainerSortCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] sortKind the sort to measure.
+		@param[in] unsortedList the list to sort.
+		*/
+		ContainerSortCase(ContainerSortKind sortKind, const std::vector<unsigned int> &unsortedList):BenchmarkCase(),m_unsortedList(unsortedList),m_list(unsortedList.size())
+		{
+			m_sortKind=sortKind;
+		}
+
+		/*!
+		Copy and sort.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			unsigned int *sortList=&m_list[0];
+			size_t listSize=m_list.size();
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				System::Memcpy(sortList,&m_unsortedList[0],listSize*sizeof(unsigned int));
+				switch(m_sortKind)
+				{
+				case CONTAINER_SORT_QUICK_RECURSIVE:
+					QuickSort(sortList,listSize,CompFunctor<unsigned int>(),QSORT_MODE_RECURSIVE);
+					break;
+				case CONTAINER_SORT_QUICK_LOOP:
+					QuickSort(sortList,listSize,CompFunctor<unsigned int>(),QSORT_MODE_LOOP);
+					break;
+				case CONTAINER_SORT_MERGE_RECURSIVE:
+					MergeSort(sortList,listSize,CompFunctor<unsigned int>(),MSORT_MODE_RECURSIVE);
+					break;
+				case CONTAINER_SORT_MERGE_LOOP:
+					MergeSort(sortList,listSize,CompFunctor<unsigned int>(),MSORT_MODE_LOOP);
+					break;
+				case CONTAINER_SORT_MERGE_BOTTOM_UP:
+					MergeSort(sortList,listSize,CompFunctor<unsigned int>(),MSORT_MODE_BOTTOM_UP);
+					break;
+				case CONTAINER_SORT_MERGE_ADAPTIVE:
+					MergeSort(sortList,listSize,CompFunctor<unsigned int>(),MSORT_MODE_ADAPTIVE);
+					break;
+				case CONTAINER_SORT_STD_SORT:
+					std::sort(m_list.begin(),m_list.end());
+					break;
+				default:
+					std::stable_sort(m_list.begin(),m_list.end());
+					break;
+				}
+			}
+			s_sink=m_list[0];
+		}
+
+	private:
+		/// the sort measured
+		ContainerSortKind m_sortKind;
+		/// the list to sort
+		const std::vector<unsigned int> &m_unsortedList;
+		/// the list sorted
+		std::vector<unsigned int> m_list;
+	};
+
+	/// Enumeration for the search measured
+	enum ContainerSearchKind{
+		/// BinarySearch
+		CONTAINER_SEARCH_BINARY_SEARCH=0,
+		/// LowerBound
+		CONTAINER_SEARCH_LOWER_BOUND,
+		/// EytzingerSearch::LowerBound
+		CONTAINER_SEARCH_EYTZINGER,
+		/// std::lower_bound
+		CONTAINER_SEARCH_STD_LOWER_BOUND,
+		/// Search Count
+		CONTAINER_SEARCH_COUNT,
+	};
+
+	/*!
+	@class ContainerSearchCase epContainerBenchmark.cpp
+	@brief A benchmark case searching one key from the sorted list in the random order per operation.
+	*/
+	class ContainerSearchCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] searchKind the search to measure.
+		@param[in] keyList the shuffled keys to search, which are also the elements of the list.
+		*/
+		ContainerSearchCase(ContainerSearchKind searchKind, const std::vector<unsigned int> &keyList):BenchmarkCase(),m_keyList(keyList),m_sortedList(keyList)
+		{
+			m_searchKind=searchKind;
+			std::sort(m_sortedList.begin(),m_sortedList.end());
+			if(m_searchKind==CONTAINER_SEARCH_EYTZINGER)
+				m_eytzingerSearch.Build(&m_sortedList[0],m_sortedList.size());
+		}
+
+		/*!
+		Search the keys.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			const unsigned int *searchList=&m_sortedList[0];
+			size_t listSize=m_sortedList.size();
+			size_t sum=0;
+			size_t foundIdx=0;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				unsigned int key=m_keyList[opTrav%m_keyList.size()];
+				switch(m_searchKind)
+				{
+				case CONTAINER_SEARCH_BINARY_SEARCH:
+					BinarySearch(key,searchList,listSize,CompFunctor<unsigned int>(),foundIdx);
+					sum+=foundIdx;
+					break;
+				case CONTAINER_SEARCH_LOWER_BOUND:
+					sum+=LowerBound(key,searchList,listSize);
+					break;
+				case CONTAINER_SEARCH_EYTZINGER:
+					sum+=m_eytzingerSearch.LowerBound(key);
+					break;
+				default:
+					sum+=static_cast<size_t>(std::lower_bound(searchList,searchList+listSize,key)-searchList);
+					break;
+				}
+			}
+			s_sink=sum;
+		}
+
+	private:
+		/// the search measured
+		ContainerSearchKind m_searchKind;
+		/// the shuffled keys to search
+		const std::vector<unsigned int> &m_keyList;
+		/// the sorted list searched
+		std::vector<unsigned int> m_sortedList;
+		/// the list in Eytzinger layout (CONTAINER_SEARCH_EYTZINGER only)
+		EytzingerSearch<unsigned int> m_eytzingerSearch;
+	};
+}
+
+/// the names of the sorts measured
+static const TCHAR *s_sortNameList[CONTAINER_SORT_COUNT]={_T("QUICK_RECURSIVE"),_T("QUICK_LOOP"),_T("MERGE_RECURSIVE"),_T("MERGE_LOOP"),_T("MERGE_BOTTOM_UP"),_T("MERGE_ADAPTIVE"),_T("STD_SORT"),_T("STD_STABLE_SORT")};
+
+/// the names of the searches measured
+static const TCHAR *s_searchNameList[CONTAINER_SEARCH_COUNT]={_T("BINARY_SEARCH"),_T("LOWER_BOUND"),_T("EYTZINGER"),_T("STD_LOWER_BOUND")};
+
+/*!
+Run the KAryHeap cases of given k.
+@param[in] keyList the keys the heap holds.
+@param[in] minTime the time in milliseconds each measurement runs at least.
+*/
+template<size_t k>
+static void runKAryHeap(const std::vector<unsigned int> &keyList, unsigned int minTime)
+{
+	EpTString parameter;
+	System::STPrintf(parameter,_T("K%u/%u"),static_cast<unsigned int>(k),static_cast<unsigned int>(keyList.size()));
+	ContainerHeapHoldCase<k> holdCase(keyList);
+	BENCHMARK_INSTANCE.Run(_T("Container"),_T("HeapHold"),parameter.c_str(),holdCase,0,minTime);
+	ContainerHeapChangeKeyCase<k> changeKeyCase(keyList);
+	BENCHMARK_INSTANCE.Run(_T("Container"),_T("HeapChangeKey"),parameter.c_str(),changeKeyCase,0,minTime);
+}
+
+void ContainerBenchmark::Run(size_t maxSize, unsigned int minTime)
+{
+	RunKAryHeap(maxSize,minTime);
+	RunPatriciaTrie(maxSize,minTime);
+	RunDynamicArray(maxSize,minTime);
+	RunSort(maxSize,minTime);
+	RunSearch(maxSize,minTime);
+}
+
+void ContainerBenchmark::RunKAryHeap(size_t maxSize, unsigned int minTime)
+{
+	for(size_t size=CONTAINER_BENCHMARK_MIN_SIZE;size<=maxSize;size*=16)
+	{
+		std::vector<unsigned int> keyList;
+		generateKeys(size,keyList);
+		runKAryHeap<2>(keyList,minTime);
+		runKAryHeap<4>(keyList,minTime);
+		runKAryHeap<5>(keyList,minTime);
+		runKAryHeap<8>(keyList,minTime);
+
+		EpTString parameter;
+		System::STPrintf(parameter,_T("STD_PRIORITY_QUEUE/%u"),static_cast<unsigned int>(size));
+		ContainerStdHeapHoldCase stdHoldCase(keyList);
+		BENCHMARK_INSTANCE.Run(_T("Container"),_T("HeapHold"),parameter.c_str(),stdHoldCase,0,minTime);
+		System::STPrintf(parameter,_T("STD_MAP/%u"),static_cast<unsigned int>(size));
+		ContainerStdChangeKeyCase stdChangeKeyCase(keyList);
+		BENCHMARK_INSTANCE.Run(_T("Container"),_T("HeapChangeKey"),parameter.c_str(),stdChangeKeyCase,0,minTime);
+		if(size>maxSize/16)
+			break;
+	}
+}
+
+void ContainerBenchmark::RunPatriciaTrie(size_t maxSize, unsigned int minTime)
+{
+	for(size_t size=CONTAINER_BENCHMARK_MIN_SIZE;size<=maxSize;size*=16)
+	{
+		std::vector<unsigned int> keyList;
+		generateKeys(size,keyList);
+		for(size_t corpusTrav=0;corpusTrav<sizeof(s_corpusNameList)/sizeof(TCHAR*);corpusTrav++)
+		{
+			std::vector<std::string> stringList;
+			generateStrings(corpusTrav,size,stringList);
+			EpTString parameter;
+			EpTString stdParameter;
+			System::STPrintf(parameter,_T("%s/PATRICIA_TRIE/%u"),s_corpusNameList[corpusTrav],static_cast<unsigned int>(size));
+			System::STPrintf(stdParameter,_T("%s/STD_MAP/%u"),s_corpusNameList[corpusTrav],static_cast<unsigned int>(size));
+
+			ContainerTrieInsertCase insertCase(stringList);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("TrieInsert"),parameter.c_str(),insertCase,0,minTime);
+			ContainerStdInsertCase stdInsertCase(stringList);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("TrieInsert"),stdParameter.c_str(),stdInsertCase,0,minTime);
+
+			ContainerTrieFindCase findCase(stringList,keyList,false);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("TrieFind"),parameter.c_str(),findCase,0,minTime);
+			ContainerStdFindCase stdFindCase(stringList,keyList,false);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("TrieFind"),stdParameter.c_str(),stdFindCase,0,minTime);
+
+			ContainerTrieFindCase findAllCase(stringList,keyList,true);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("TrieFindAll"),parameter.c_str(),findAllCase,0,minTime);
+			ContainerStdFindCase stdFindAllCase(stringList,keyList,true);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("TrieFindAll"),stdParameter.c_str(),stdFindAllCase,0,minTime);
+		}
+		if(size>maxSize/16)
+			break;
+	}
+}
+
+void ContainerBenchmark::RunDynamicArray(size_t maxSize, unsigned int minTime)
+{
+	for(size_t size=CONTAINER_BENCHMARK_MIN_SIZE;size<=maxSize;size*=16)
+	{
+		std::vector<unsigned int> keyList;
+		generateKeys(size,keyList);
+		EpTString parameter;
+		EpTString stdParameter;
+		System::STPrintf(parameter,_T("DYNAMIC_ARRAY/%u"),static_cast<unsigned int>(size));
+		System::STPrintf(stdParameter,_T("STD_VECTOR/%u"),static_cast<unsigned int>(size));
+
+		ContainerAppendCase<ContainerDynamicArray> appendCase(size);
+		BENCHMARK_INSTANCE.Run(_T("Container"),_T("ArrayAppend"),parameter.c_str(),appendCase,sizeof(int),minTime);
+		ContainerAppendCase<std::vector<int> > stdAppendCase(size);
+		BENCHMARK_INSTANCE.Run(_T("Container"),_T("ArrayAppend"),stdParameter.c_str(),stdAppendCase,sizeof(int),minTime);
+
+		ContainerAccessCase<ContainerDynamicArray> accessCase(keyList);
+		BENCHMARK_INSTANCE.Run(_T("Container"),_T("ArrayAccess"),parameter.c_str(),accessCase,sizeof(int),minTime);
+		ContainerAccessCase<std::vector<int> > stdAccessCase(keyList);
+		BENCHMARK_INSTANCE.Run(_T("Container"),_T("ArrayAccess"),stdParameter.c_str(),stdAccessCase,sizeof(int),minTime);
+		if(size>maxSize/16)
+			break;
+	}
+}
+
+void ContainerBenchmark::RunSort(size_t maxSize, unsigned int minTime)
+{
+	for(size_t size=CONTAINER_BENCHMARK_MIN_SIZE;size<=maxSize;size*=16)
+	{
+		for(size_t orderTrav=0;orderTrav<sizeof(s_orderNameList)/sizeof(TCHAR*);orderTrav++)
+		{
+			std::vector<unsigned int> unsortedList;
+			generateKeys(size,unsortedList);
+			if(orderTrav==1)
+				std::sort(unsortedList.begin(),unsortedList.end());
+			for(int sortTrav=0;sortTrav<CONTAINER_SORT_COUNT;sortTrav++)
+			{
+				EpTString parameter;
+				System::STPrintf(parameter,_T("%s/%s/%u"),s_sortNameList[sortTrav],s_orderNameList[orderTrav],static_cast<unsigned int>(size));
+				ContainerSortCase sortCase(static_cast<ContainerSortKind>(sortTrav),unsortedList);
+				BENCHMARK_INSTANCE.Run(_T("Container"),_T("Sort"),parameter.c_str(),sortCase,size*sizeof(unsigned int),minTime);
+			}
+		}
+		if(size>maxSize/16)
+			break;
+	}
+}
+
+void ContainerBenchmark::RunSearch(size_t maxSize, unsigned int minTime)
+{
+	for(size_t size=CONTAINER_BENCHMARK_MIN_SIZE;size<=maxSize;size*=16)
+	{
+		std::vector<unsigned int> keyList;
+		generateKeys(size,keyList);
+		for(int searchTrav=0;searchTrav<CONTAINER_SEARCH_COUNT;searchTrav++)
+		{
+			EpTString parameter;
+			System::STPrintf(parameter,_T("%s/%u"),s_searchNameList[searchTrav],static_cast<unsigned int>(size));
+			ContainerSearchCase searchCase(static_cast<ContainerSearchKind>(searchTrav),keyList);
+			BENCHMARK_INSTANCE.Run(_T("Container"),_T("Search"),parameter.c_str(),searchCase,0,minTime);
+		}
+		if(size>maxSize/16)
+			break;
+	}
+}
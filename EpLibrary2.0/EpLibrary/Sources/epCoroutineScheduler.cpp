@@ -0,0 +1,585 @@
+/*! 
+CoroutineScheduler for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epCoroutineScheduler.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+namespace epl
+{
+	/*!
+	Create the lock of given lock policy.
+	@param[in] lockPolicyType the lock policy.
+	@return the new lock, or NULL if the lock policy is unknown.
+	*/
+	static BaseLock *createLock(LockPolicy lockPolicyType)
+	{
+		switch(lockPolicyType)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			return EP_NEW CriticalSectionEx();
+		case LOCK_POLICY_MUTEX:
+			return EP_NEW Mutex();
+		case LOCK_POLICY_NONE:
+			return EP_NEW NoLock();
+		case LOCK_POLICY_SPIN_PARK:
+			return EP_NEW SpinParkLock();
+		case LOCK_POLICY_READER_WRITER:
+			return EP_NEW ReaderWriterLock();
+		default:
+			return NULL;
+		}
+	}
+
+	/// the TLS index of the worker running on the thread, which is allocated once for the process
+	static volatile long s_workerTlsIndex=static_cast<long>(TLS_OUT_OF_INDEXES);
+
+	/*!
+	Return the TLS index of the worker running on the thread.
+	@return the TLS index.
+	*/
+	static DWORD workerTlsIndex()
+	{
+		if(s_workerTlsIndex==static_cast<long>(TLS_OUT_OF_INDEXES))
+		{
+			DWORD tlsIndex=TlsAlloc();
+			if(InterlockedCompareExchange(&s_workerTlsIndex,static_cast<long>(tlsIndex),static_cast<long>(TLS_OUT_OF_INDEXES))!=static_cast<long>(TLS_OUT_OF_INDEXES))
+				TlsFree(tlsIndex);
+		}
+		return static_cast<DWORD>(s_workerTlsIndex);
+	}
+
+	/*!
+	Return the worker running on the calling thread.
+	@return the worker, or NULL if the thread is not the worker.
+	*/
+	static CoroutineWorker *currentWorker()
+	{
+		return reinterpret_cast<CoroutineWorker*>(TlsGetValue(workerTlsIndex()));
+	}
+
+	/*!
+	@class CoroutineJobContinuation epCoroutineScheduler.cpp
+	@brief A class for the continuation which raises the event of the coroutine awaiting the job.
+	*/
+	class CoroutineJobContinuation: public JobContinuation
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the continuation
+		@param[in] completeEvent the event to raise when the job is completed
+		*/
+		CoroutineJobContinuation(CoroutineEvent *completeEvent):JobContinuation(LOCK_POLICY_NONE)
+		{
+			m_completeEvent=completeEvent;
+		}
+
+		/*!
+		Raise the event of the coroutine awaiting the job.
+		@param[in] handle the handle which became ready.
+		*/
+		virtual void Continue(JobHandle *handle)
+		{
+			m_completeEvent->SetEvent();
+		}
+
+	private:
+		/// the event to raise
+		CoroutineEvent *m_completeEvent;
+	};
+}
+
+BaseCoroutine::BaseCoroutine(LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_doneEvent(false,true)
+{
+	m_worker=NULL;
+	m_fiber=NULL;
+	m_fiberOwner=NULL;
+	m_resumeFiber=NULL;
+	m_status=COROUTINE_STATUS_NONE;
+	m_listIdx=0;
+}
+
+BaseCoroutine::~BaseCoroutine()
+{
+}
+
+CoroutineStatus BaseCoroutine::GetStatus() const
+{
+	return m_status;
+}
+
+bool BaseCoroutine::WaitFor(unsigned int waitTimeInMilliSec)
+{
+	return m_doneEvent.WaitForEvent(waitTimeInMilliSec);
+}
+
+BaseCoroutine *BaseCoroutine::GetCurrent()
+{
+	CoroutineWorker *worker=currentWorker();
+	if(worker==NULL)
+		return NULL;
+	return worker->m_current;
+}
+
+void BaseCoroutine::YieldExecution()
+{
+	EP_ASSERT_EXPR(GetCurrent()==this,_T("YieldExecution must be called within the coroutine itself."));
+	if(GetCurrent()!=this)
+		return;
+	resume();
+	suspend();
+}
+
+BaseJob::JobStatus BaseCoroutine::AwaitJob(JobHandle *handle)
+{
+	EP_ASSERT_EXPR(handle,_T("Handle is NULL!"));
+	if(handle==NULL)
+		return BaseJob::JOB_STATUS_INCOMPLETE;
+	if(GetCurrent()!=this)
+	{
+		handle->Wait();
+		return handle->GetStatus();
+	}
+
+	// the event lives on this stack, and is no longer touched once it resumed this coroutine
+	CoroutineEvent completeEvent(false,false,LOCK_POLICY_CRITICALSECTION);
+	CoroutineJobContinuation *continuation=EP_NEW CoroutineJobContinuation(&completeEvent);
+	JobHandle *nextHandle=handle->Then(continuation);
+	continuation->ReleaseObj();
+	nextHandle->ReleaseObj();
+	completeEvent.Wait();
+	return handle->GetStatus();
+}
+
+bool BaseCoroutine::MoveTo(CoroutineScheduler *scheduler)
+{
+	EP_ASSERT_EXPR(scheduler,_T("Scheduler is NULL!"));
+	if(scheduler==NULL || GetCurrent()!=this)
+		return false;
+	CoroutineWorker *worker=currentWorker();
+	CoroutineScheduler *oldScheduler=worker->m_owner;
+	if(scheduler==oldScheduler)
+		return true;
+
+	oldScheduler->removeCoroutine(this);
+	if(!scheduler->addCoroutine(this))
+	{
+		oldScheduler->addCoroutine(this);
+		m_worker=worker;
+		return false;
+	}
+	// the new worker must not pick up this coroutine until it paused here
+	worker->m_movingCoroutine=this;
+	suspend();
+	return true;
+}
+
+void BaseCoroutine::suspend()
+{
+	m_resumeFiber=GetCurrentFiber();
+	SwitchToFiber(currentWorker()->m_mainFiber);
+}
+
+void BaseCoroutine::resume()
+{
+	// the worker does not pop the coroutine until it switches back, so this is safe before suspend
+	m_status=COROUTINE_STATUS_READY;
+	m_worker->pushReady(this);
+}
+
+
+CoroutineEvent::CoroutineEvent(bool isInitialRaised, bool isManualReset, LockPolicy lockPolicyType)
+{
+	m_isRaised=isInitialRaised;
+	m_isManualReset=isManualReset;
+	m_lock=createLock(lockPolicyType);
+}
+
+CoroutineEvent::~CoroutineEvent()
+{
+	EP_ASSERT_EXPR(m_waitingList.empty(),_T("CoroutineEvent is destroyed while the coroutines wait for it."));
+	if(m_lock)
+		EP_DELETE m_lock;
+}
+
+void CoroutineEvent::SetEvent()
+{
+	std::deque<BaseCoroutine*> resumeList;
+	m_lock->Lock();
+	if(m_isManualReset)
+	{
+		m_isRaised=true;
+		resumeList.swap(m_waitingList);
+	}
+	else if(m_waitingList.empty())
+	{
+		m_isRaised=true;
+	}
+	else
+	{
+		resumeList.push_back(m_waitingList.front());
+		m_waitingList.pop_front();
+	}
+	m_lock->Unlock();
+
+	// the coroutine resumed may destroy this event, so this is not touched from here
+	for(size_t resumeTrav=0;resumeTrav<resumeList.size();resumeTrav++)
+		resumeList[resumeTrav]->resume();
+}
+
+void CoroutineEvent::ResetEvent()
+{
+	LockObj lock(m_lock);
+	m_isRaised=false;
+}
+
+bool CoroutineEvent::Wait()
+{
+	BaseCoroutine *current=BaseCoroutine::GetCurrent();
+	if(current==NULL)
+		return false;
+	{
+		LockObj lock(m_lock);
+		if(m_isRaised)
+		{
+			if(!m_isManualReset)
+				m_isRaised=false;
+			return true;
+		}
+		current->m_status=COROUTINE_STATUS_WAITING;
+		m_waitingList.push_back(current);
+	}
+	current->suspend();
+	return true;
+}
+
+size_t CoroutineEvent::GetWaitingCount() const
+{
+	LockObj lock(m_lock);
+	return m_waitingList.size();
+}
+
+
+CoroutineWorker::CoroutineWorker(CoroutineScheduler *owner, LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_readySignal(0L)
+{
+	m_owner=owner;
+	m_mainFiber=NULL;
+	m_current=NULL;
+	m_movingCoroutine=NULL;
+	m_readyLock=createLock(lockPolicyType);
+}
+
+CoroutineWorker::~CoroutineWorker()
+{
+	if(m_readyLock)
+		EP_DELETE m_readyLock;
+}
+
+size_t CoroutineWorker::GetReadyCount() const
+{
+	LockObj lock(m_readyLock);
+	return m_readyQueue.size();
+}
+
+void CoroutineWorker::pushReady(BaseCoroutine *coroutine)
+{
+	{
+		LockObj lock(m_readyLock);
+		m_readyQueue.push_back(coroutine);
+	}
+	m_readySignal.Release(1);
+}
+
+void CoroutineWorker::execute()
+{
+	TlsSetValue(workerTlsIndex(),this);
+	m_mainFiber=ConvertThreadToFiber(NULL);
+	EP_ASSERT_EXPR(m_mainFiber,_T("Failed to convert the worker thread to the fiber."));
+	while(m_mainFiber)
+	{
+		m_readySignal.Lock();
+		BaseCoroutine *coroutine;
+		{
+			LockObj lock(m_readyLock);
+			// the signals of the queue cleared by CoroutineScheduler::Stop may remain
+			if(m_readyQueue.empty())
+				continue;
+			coroutine=m_readyQueue.front();
+			m_readyQueue.pop_front();
+		}
+		if(coroutine==NULL)
+			break;
+
+		if(coroutine->m_fiber==NULL)
+		{
+			coroutine->m_fiber=m_owner->acquireFiber();
+			coroutine->m_fiberOwner=m_owner;
+			if(coroutine->m_fiber==NULL)
+			{
+				// no stack is available, so finish the coroutine without running it
+				coroutine->m_status=COROUTINE_STATUS_DONE;
+				m_owner->onCoroutineDone(coroutine);
+				continue;
+			}
+		}
+		LPVOID resumeFiber=coroutine->m_resumeFiber?coroutine->m_resumeFiber:coroutine->m_fiber;
+		coroutine->m_resumeFiber=NULL;
+		m_current=coroutine;
+		coroutine->m_status=COROUTINE_STATUS_RUNNING;
+		SwitchToFiber(resumeFiber);
+		m_current=NULL;
+
+		// otherwise the coroutine is ready again, waits for the event, or moves to the other worker
+		if(m_movingCoroutine)
+		{
+			m_movingCoroutine=NULL;
+			coroutine->resume();
+		}
+		else if(coroutine->m_status==COROUTINE_STATUS_DONE)
+		{
+			coroutine->m_fiberOwner->releaseFiber(coroutine->m_fiber);
+			coroutine->m_fiber=NULL;
+			coroutine->m_fiberOwner=NULL;
+			m_owner->onCoroutineDone(coroutine);
+		}
+	}
+	if(m_mainFiber)
+	{
+		ConvertFiberToThread();
+		m_mainFiber=NULL;
+	}
+	TlsSetValue(workerTlsIndex(),NULL);
+}
+
+void __stdcall CoroutineWorker::fiberFunc(LPVOID param)
+{
+	while(true)
+	{
+		BaseCoroutine *coroutine=currentWorker()->m_current;
+		coroutine->execute();
+		coroutine->m_status=COROUTINE_STATUS_DONE;
+		// the coroutine may have moved to the other worker, and the next coroutine given to this fiber starts from the loop
+		SwitchToFiber(currentWorker()->m_mainFiber);
+	}
+}
+
+
+CoroutineScheduler::CoroutineScheduler(unsigned int workerCount, size_t stackSize, size_t maxPooledFiberCount, LockPolicy lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	m_lock=createLock(lockPolicyType);
+	m_fiberLock=createLock(lockPolicyType);
+	if(workerCount==0)
+		workerCount=static_cast<unsigned int>(System::GetNumberOfCores());
+	if(workerCount==0)
+		workerCount=1;
+	for(unsigned int workerTrav=0;workerTrav<workerCount;workerTrav++)
+		m_workerList.push_back(EP_NEW CoroutineWorker(this,lockPolicyType));
+	m_stackSize=stackSize;
+	m_maxPooledFiberCount=maxPooledFiberCount;
+	m_spawnCount=0;
+	m_isStarted=false;
+}
+
+CoroutineScheduler::~CoroutineScheduler()
+{
+	Stop();
+	// the fibers may be put back by the coroutines moved to the other schedulers
+	clearFiberPool();
+	for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+		EP_DELETE m_workerList[workerTrav];
+	m_workerList.clear();
+	if(m_lock)
+		EP_DELETE m_lock;
+	if(m_fiberLock)
+		EP_DELETE m_fiberLock;
+}
+
+bool CoroutineScheduler::Start()
+{
+	LockObj lock(m_lock);
+	if(m_isStarted)
+		return true;
+	for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+	{
+		if(!m_workerList[workerTrav]->Start())
+		{
+			for(size_t stopTrav=0;stopTrav<workerTrav;stopTrav++)
+				m_workerList[stopTrav]->pushReady(NULL);
+			for(size_t stopTrav=0;stopTrav<workerTrav;stopTrav++)
+				m_workerList[stopTrav]->WaitFor();
+			return false;
+		}
+	}
+	m_isStarted=true;
+	return true;
+}
+
+void CoroutineScheduler::Stop()
+{
+	{
+		LockObj lock(m_lock);
+		if(!m_isStarted)
+			return;
+		m_isStarted=false;
+	}
+	size_t workerTrav;
+	for(workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+		m_workerList[workerTrav]->pushReady(NULL);
+	for(workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+	{
+		m_workerList[workerTrav]->WaitFor();
+		LockObj lock(m_workerList[workerTrav]->m_readyLock);
+		m_workerList[workerTrav]->m_readyQueue.clear();
+	}
+
+	std::vector<BaseCoroutine*> unfinishedList;
+	{
+		LockObj lock(m_lock);
+		unfinishedList.swap(m_coroutineList);
+	}
+	for(size_t coroutineTrav=0;coroutineTrav<unfinishedList.size();coroutineTrav++)
+	{
+		BaseCoroutine *coroutine=unfinishedList[coroutineTrav];
+		if(coroutine->m_fiber)
+		{
+			DeleteFiber(coroutine->m_fiber);
+			coroutine->m_fiber=NULL;
+			coroutine->m_fiberOwner=NULL;
+		}
+		coroutine->ReleaseObj();
+	}
+	clearFiberPool();
+}
+
+bool CoroutineScheduler::Spawn(BaseCoroutine *coroutine)
+{
+	if(coroutine==NULL)
+		return false;
+	if(coroutine->m_status!=COROUTINE_STATUS_NONE)
+		return false;
+	coroutine->RetainObj();
+	coroutine->m_doneEvent.ResetEvent();
+	if(!addCoroutine(coroutine))
+	{
+		coroutine->ReleaseObj();
+		return false;
+	}
+	coroutine->resume();
+	return true;
+}
+
+unsigned int CoroutineScheduler::GetWorkerCount() const
+{
+	return static_cast<unsigned int>(m_workerList.size());
+}
+
+size_t CoroutineScheduler::GetStackSize() const
+{
+	return m_stackSize;
+}
+
+size_t CoroutineScheduler::GetCoroutineCount() const
+{
+	LockObj lock(m_lock);
+	return m_coroutineList.size();
+}
+
+size_t CoroutineScheduler::GetPooledFiberCount() const
+{
+	LockObj lock(m_fiberLock);
+	return m_fiberPool.size();
+}
+
+LPVOID CoroutineScheduler::acquireFiber()
+{
+	{
+		LockObj lock(m_fiberLock);
+		if(!m_fiberPool.empty())
+		{
+			LPVOID fiber=m_fiberPool.back();
+			m_fiberPool.pop_back();
+			return fiber;
+		}
+	}
+	// only the stack size is reserved, and the pages are committed as the stack grows
+	return CreateFiberEx(0,m_stackSize,0,CoroutineWorker::fiberFunc,NULL);
+}
+
+void CoroutineScheduler::releaseFiber(LPVOID fiber)
+{
+	{
+		LockObj lock(m_fiberLock);
+		if(m_fiberPool.size()<m_maxPooledFiberCount)
+		{
+			m_fiberPool.push_back(fiber);
+			return;
+		}
+	}
+	DeleteFiber(fiber);
+}
+
+void CoroutineScheduler::onCoroutineDone(BaseCoroutine *coroutine)
+{
+	removeCoroutine(coroutine);
+	coroutine->m_doneEvent.SetEvent();
+	coroutine->ReleaseObj();
+}
+
+bool CoroutineScheduler::addCoroutine(BaseCoroutine *coroutine)
+{
+	LockObj lock(m_lock);
+	if(!m_isStarted)
+		return false;
+	coroutine->m_listIdx=m_coroutineList.size();
+	m_coroutineList.push_back(coroutine);
+	coroutine->m_worker=m_workerList[static_cast<unsigned long>(m_spawnCount++)%m_workerList.size()];
+	return true;
+}
+
+void CoroutineScheduler::removeCoroutine(BaseCoroutine *coroutine)
+{
+	LockObj lock(m_lock);
+	BaseCoroutine *lastCoroutine=m_coroutineList.back();
+	m_coroutineList[coroutine->m_listIdx]=lastCoroutine;
+	lastCoroutine->m_listIdx=coroutine->m_listIdx;
+	m_coroutineList.pop_back();
+}
+
+void CoroutineScheduler::clearFiberPool()
+{
+	LockObj lock(m_fiberLock);
+	for(size_t fiberTrav=0;fiberTrav<m_fiberPool.size();fiberTrav++)
+		DeleteFiber(m_fiberPool[fiberTrav]);
+	m_fiberPool.clear();
+}
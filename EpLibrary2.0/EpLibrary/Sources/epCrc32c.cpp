@@ -0,0 +1,184 @@
+/*! 
+Crc32c for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epCrc32c.h"
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define EP_CRC32C_SSE42
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the reversed polynomial of the CRC32C
+#define CRC32C_POLYNOMIAL 0x82F63B78
+
+/*!
+@class Crc32cTable epCrc32c.cpp
+@brief A class holding the slicing-by-8 tables built at the start up.
+*/
+class Crc32cTable
+{
+public:
+	/*!
+	Default Constructor
+
+	Build the tables
+	*/
+	Crc32cTable()
+	{
+		for(unsigned int byteTrav=0;byteTrav<256;byteTrav++)
+		{
+			unsigned int crc=byteTrav;
+			for(int bitTrav=0;bitTrav<8;bitTrav++)
+				crc=(crc&1)?(crc>>1)^CRC32C_POLYNOMIAL:crc>>1;
+			m_table[0][byteTrav]=crc;
+		}
+		for(unsigned int byteTrav=0;byteTrav<256;byteTrav++)
+		{
+			for(int sliceTrav=1;sliceTrav<8;sliceTrav++)
+				m_table[sliceTrav][byteTrav]=(m_table[sliceTrav-1][byteTrav]>>8)^m_table[0][m_table[sliceTrav-1][byteTrav]&0xFF];
+		}
+	}
+	/// the slicing-by-8 tables
+	unsigned int m_table[8][256];
+};
+
+/// the tables for the software checksum
+static Crc32cTable s_crc32cTable;
+
+/*!
+Compute the checksum with the slicing-by-8 tables.
+@param[in] data the data to compute the checksum of.
+@param[in] byteSize the byte size of the data.
+@param[in] crc the inverted checksum so far.
+@return the inverted checksum.
+*/
+static unsigned int computeSoftware(const unsigned char *data, size_t byteSize, unsigned int crc)
+{
+	const unsigned int (*table)[256]=s_crc32cTable.m_table;
+	while(byteSize && (reinterpret_cast<size_t>(data)&3))
+	{
+		crc=table[0][(crc^*data++)&0xFF]^(crc>>8);
+		byteSize--;
+	}
+	while(byteSize>=8)
+	{
+		// the words are read in the little endian, which is the only byte order of the Windows.
+		unsigned int low=*reinterpret_cast<const unsigned int*>(data)^crc;
+		unsigned int high=*reinterpret_cast<const unsigned int*>(data+4);
+		crc=table[7][low&0xFF]^table[6][(low>>8)&0xFF]^table[5][(low>>16)&0xFF]^table[4][low>>24]
+			^table[3][high&0xFF]^table[2][(high>>8)&0xFF]^table[1][(high>>16)&0xFF]^table[0][high>>24];
+		data+=8;
+		byteSize-=8;
+	}
+	while(byteSize)
+	{
+		crc=table[0][(crc^*data++)&0xFF]^(crc>>8);
+		byteSize--;
+	}
+	return crc;
+}
+
+#if defined(EP_CRC32C_SSE42)
+/*!
+Return the flag whether the processor supports SSE4.2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE42()
+{
+	static volatile int s_hasSSE42=-1;
+	if(s_hasSSE42<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE42=(cpuInfo[2]&(1<<20))?1:0;
+	}
+	return s_hasSSE42==1;
+}
+
+/*!
+Compute the checksum with the SSE4.2 CRC32 instruction.
+@param[in] data the data to compute the checksum of.
+@param[in] byteSize the byte size of the data.
+@param[in] crc the inverted checksum so far.
+@return the inverted checksum.
+*/
+static unsigned int computeHardware(const unsigned char *data, size_t byteSize, unsigned int crc)
+{
+	while(byteSize && (reinterpret_cast<size_t>(data)&7))
+	{
+		crc=_mm_crc32_u8(crc,*data++);
+		byteSize--;
+	}
+#if defined(_M_X64)
+	unsigned __int64 crc64=crc;
+	while(byteSize>=8)
+	{
+		crc64=_mm_crc32_u64(crc64,*reinterpret_cast<const unsigned __int64*>(data));
+		data+=8;
+		byteSize-=8;
+	}
+	crc=static_cast<unsigned int>(crc64);
+#endif //defined(_M_X64)
+	while(byteSize>=4)
+	{
+		crc=_mm_crc32_u32(crc,*reinterpret_cast<const unsigned int*>(data));
+		data+=4;
+		byteSize-=4;
+	}
+	while(byteSize)
+	{
+		crc=_mm_crc32_u8(crc,*data++);
+		byteSize--;
+	}
+	return crc;
+}
+#endif //defined(EP_CRC32C_SSE42)
+
+unsigned int Crc32c::Compute(const void *data, size_t byteSize, unsigned int crc)
+{
+	const unsigned char *bytes=reinterpret_cast<const unsigned char*>(data);
+#if defined(EP_CRC32C_SSE42)
+	if(hasSSE42())
+		return ~computeHardware(bytes,byteSize,~crc);
+#endif //defined(EP_CRC32C_SSE42)
+	return ~computeSoftware(bytes,byteSize,~crc);
+}
+
+bool Crc32c::IsHardwareAccelerated()
+{
+#if defined(EP_CRC32C_SSE42)
+	return hasSSE42();
+#else //defined(EP_CRC32C_SSE42)
+	return false;
+#endif //defined(EP_CRC32C_SSE42)
+}
\ No newline at end of file
@@ -464,4 +464,117 @@ __int64 DateTimeHelper::InMilliSec(const SYSTEMTIME &systemTime)
 __int64 DateTimeHelper::InSec(const SYSTEMTIME &systemTime)
 {
 	return InSec(SystemTimeToFileTime(systemTime));
-}
\ No newline at end of file
+}
+/*!
+Return the flag whether the given local times are in the same second.
+@param[in] time1 the first time to compare.
+@param[in] time2 the second time to compare.
+@return true if in the same second, otherwise false.
+*/
+static bool isSameSecond(const SYSTEMTIME &time1, const SYSTEMTIME &time2)
+{
+	return time1.wSecond==time2.wSecond && time1.wMinute==time2.wMinute && time1.wHour==time2.wHour
+		&& time1.wDay==time2.wDay && time1.wMonth==time2.wMonth && time1.wYear==time2.wYear;
+}
+
+TimestampFormatter::TimestampFormatter(TimestampLayout layout, unsigned int subSecondDigits)
+{
+	EP_ASSERT_EXPR(subSecondDigits<=TIMESTAMP_MAX_SUB_SECOND_DIGITS,_T("The number of the sub-second digits(%d) is too large!"),subSecondDigits);
+	m_layout=layout;
+	m_subSecondDigits=subSecondDigits<=TIMESTAMP_MAX_SUB_SECOND_DIGITS?subSecondDigits:TIMESTAMP_MAX_SUB_SECOND_DIGITS;
+	m_string[0]=_T('\0');
+	m_prefixLength=0;
+	m_length=0;
+	m_cachedSecond=-1;
+	System::Memset(&m_cachedTime,0,sizeof(SYSTEMTIME));
+}
+
+const TCHAR *TimestampFormatter::Format(const SYSTEMTIME &localTime)
+{
+	if(m_cachedTime.wYear==0 || !isSameSecond(localTime,m_cachedTime))
+	{
+		formatPrefix(localTime);
+		m_cachedTime=localTime;
+		m_cachedSecond=-1;
+	}
+	formatSubSecond(static_cast<unsigned int>(localTime.wMilliseconds)*10000);
+	return m_string;
+}
+
+const TCHAR *TimestampFormatter::Format(const FILETIME &fileTime)
+{
+	__int64 time=(static_cast<__int64>(fileTime.dwHighDateTime)<<32)|static_cast<__int64>(fileTime.dwLowDateTime);
+	__int64 second=time/10000000;
+	if(second!=m_cachedSecond)
+	{
+		// the time zone offsets are whole minutes, so the local time only changes its prefix on the same boundary
+		FILETIME localFileTime;
+		SYSTEMTIME localTime;
+		FileTimeToLocalFileTime(&fileTime,&localFileTime);
+		::FileTimeToSystemTime(&localFileTime,&localTime);
+		formatPrefix(localTime);
+		m_cachedSecond=second;
+		m_cachedTime.wYear=0;
+	}
+	formatSubSecond(static_cast<unsigned int>(time%10000000));
+	return m_string;
+}
+
+const TCHAR *TimestampFormatter::GetString() const
+{
+	return m_string;
+}
+
+size_t TimestampFormatter::GetLength() const
+{
+	return m_length;
+}
+
+TimestampLayout TimestampFormatter::GetLayout() const
+{
+	return m_layout;
+}
+
+unsigned int TimestampFormatter::GetSubSecondDigits() const
+{
+	return m_subSecondDigits;
+}
+
+void TimestampFormatter::formatPrefix(const SYSTEMTIME &localTime)
+{
+	int length;
+	switch(m_layout)
+	{
+	case TIMESTAMP_LAYOUT_LONG:
+		length=System::STPrintf(m_string,TIMESTAMP_MAX_LENGTH,_T("%02d/%02d/%04d, %02d:%02d:%02d"),localTime.wMonth,localTime.wDay,localTime.wYear,localTime.wHour,localTime.wMinute,localTime.wSecond);
+		break;
+	case TIMESTAMP_LAYOUT_ISO8601:
+		length=System::STPrintf(m_string,TIMESTAMP_MAX_LENGTH,_T("%04d-%02d-%02d %02d:%02d:%02d"),localTime.wYear,localTime.wMonth,localTime.wDay,localTime.wHour,localTime.wMinute,localTime.wSecond);
+		break;
+	default:
+		length=System::STPrintf(m_string,TIMESTAMP_MAX_LENGTH,_T("%02d/%02d/%02d %02d:%02d:%02d"),localTime.wMonth,localTime.wDay,localTime.wYear%100,localTime.wHour,localTime.wMinute,localTime.wSecond);
+		break;
+	}
+	m_prefixLength=length>0?static_cast<size_t>(length):0;
+	if(m_subSecondDigits)
+		m_string[m_prefixLength]=_T('.');
+}
+
+void TimestampFormatter::formatSubSecond(unsigned int subSecond)
+{
+	if(!m_subSecondDigits)
+	{
+		m_length=m_prefixLength;
+		m_string[m_length]=_T('\0');
+		return;
+	}
+	for(unsigned int digitTrav=m_subSecondDigits;digitTrav<TIMESTAMP_MAX_SUB_SECOND_DIGITS;digitTrav++)
+		subSecond/=10;
+	m_length=m_prefixLength+1+m_subSecondDigits;
+	m_string[m_length]=_T('\0');
+	for(size_t charIdx=m_length-1;charIdx>m_prefixLength;charIdx--)
+	{
+		m_string[charIdx]=static_cast<TCHAR>(_T('0')+subSecond%10);
+		subSecond/=10;
+	}
+}
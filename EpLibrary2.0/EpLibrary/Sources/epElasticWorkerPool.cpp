@@ -0,0 +1,323 @@
+/*! 
+ElasticWorkerPool for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epElasticWorkerPool.h"
+#include "epJobHandle.h"
+#include "epSystem.h"
+#include <limits.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+ElasticWorker::ElasticWorker(ElasticWorkerPool *owner, LockPolicy lockPolicyType):BaseWorkerThread(THREAD_LIFE_TERMINATE_AFTER_WORK,lockPolicyType)
+{
+	m_owner=owner;
+}
+
+ElasticWorker::~ElasticWorker()
+{
+}
+
+void ElasticWorker::execute()
+{
+	while(!m_owner->isStopping())
+	{
+		BaseJob *jobPtr=NULL;
+		if(m_owner->m_jobQueue.PopBatch(&jobPtr,1))
+		{
+			InterlockedExchange(&m_owner->m_lastDequeueTick,static_cast<long>(System::GetTickCount()));
+			processJob(jobPtr);
+			continue;
+		}
+
+		callCallBack();
+		InterlockedIncrement(&m_owner->m_idleCount);
+		__int64 idleStartTime=WorkerMetrics::GetCurrentMicroSec();
+		bool isSignaled=(m_owner->m_jobSignal.TryLockFor(m_owner->m_keepAliveTime)!=0);
+		recordIdle(idleStartTime);
+		InterlockedDecrement(&m_owner->m_idleCount);
+		if(!isSignaled && m_owner->tryRetire())
+		{
+			// a job may have arrived while retiring, so make sure someone picks it up
+			if(!m_owner->m_jobQueue.IsEmpty())
+				m_owner->growIfNeeded();
+			return;
+		}
+	}
+}
+
+
+ElasticWorkerPool::ElasticWorkerPool(BaseJobProcessor *jobProcessor, unsigned int minWorkerCount, unsigned int maxWorkerCount, unsigned int keepAliveInMilliSec, LockPolicy lockPolicyType):m_jobQueue(lockPolicyType),m_jobSignal(0L)
+{
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_poolLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_poolLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_poolLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_poolLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_poolLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_poolLock=NULL;
+		break;
+	}
+	m_jobProcessor=jobProcessor;
+	if(m_jobProcessor)
+		m_jobProcessor->RetainObj();
+
+	if(maxWorkerCount==0)
+		maxWorkerCount=static_cast<unsigned int>(System::GetNumberOfCores());
+	if(minWorkerCount==0)
+		minWorkerCount=1;
+	if(maxWorkerCount<minWorkerCount)
+		maxWorkerCount=minWorkerCount;
+	m_minWorkerCount=minWorkerCount;
+	m_maxWorkerCount=maxWorkerCount;
+	m_keepAliveTime=keepAliveInMilliSec;
+	m_growThreshold=1;
+	m_growLatency=WAITTIME_INIFINITE;
+	m_lastDequeueTick=static_cast<long>(System::GetTickCount());
+	m_activeCount=0;
+	m_idleCount=0;
+	m_isStopping=0;
+	m_isStarted=0;
+}
+
+ElasticWorkerPool::~ElasticWorkerPool()
+{
+	Stop();
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		EP_DELETE m_workers[workerTrav];
+	}
+	m_workers.clear();
+	if(m_jobProcessor)
+		m_jobProcessor->ReleaseObj();
+	if(m_poolLock)
+		EP_DELETE m_poolLock;
+}
+
+bool ElasticWorkerPool::Start()
+{
+	LockObj lock(m_poolLock);
+	EP_ASSERT_EXPR(m_jobProcessor,_T("Job Processor is NULL!"));
+	if(!m_jobProcessor || m_isStarted)
+		return false;
+	InterlockedExchange(&m_isStopping,0);
+	InterlockedExchange(&m_lastDequeueTick,static_cast<long>(System::GetTickCount()));
+	for(unsigned int workerTrav=0;workerTrav<m_minWorkerCount;workerTrav++)
+	{
+		if(!spawnWorker())
+			break;
+	}
+	InterlockedExchange(&m_isStarted,1);
+	return m_activeCount>0;
+}
+
+void ElasticWorkerPool::Stop(unsigned int waitTimeInMilliSec)
+{
+	// the workers take m_poolLock to retire or grow the pool, so they are joined after releasing it
+	std::vector<ElasticWorker*> workers;
+	{
+		LockObj lock(m_poolLock);
+		if(m_isStarted)
+		{
+			InterlockedExchange(&m_isStopping,1);
+			m_jobSignal.Release(static_cast<long>(m_workers.size()));
+			workers.swap(m_workers);
+			InterlockedExchange(&m_activeCount,0);
+			InterlockedExchange(&m_isStarted,0);
+		}
+	}
+	for(unsigned int workerTrav=0;workerTrav<workers.size();workerTrav++)
+	{
+		if(workers[workerTrav]->GetStatus()!=Thread::THREAD_STATUS_TERMINATED)
+			workers[workerTrav]->TerminateWorker(waitTimeInMilliSec);
+		EP_DELETE workers[workerTrav];
+	}
+
+	BaseJob *jobPtr=NULL;
+	while(m_jobQueue.PopBatch(&jobPtr,1))
+	{
+		jobPtr->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+		jobPtr->ReleaseObj();
+	}
+}
+
+void ElasticWorkerPool::Push(BaseJob * const job)
+{
+	EP_ASSERT_EXPR(job,_T("Job is NULL!"));
+	if(!job)
+		return;
+	m_jobQueue.Push(job);
+	m_jobSignal.Release(1);
+	growIfNeeded();
+}
+
+JobHandle *ElasticWorkerPool::Submit(BaseJob * const job)
+{
+	EP_ASSERT_EXPR(job,_T("Job is NULL!"));
+	if(!job)
+		return NULL;
+	Push(job);
+	return job->GetHandle();
+}
+
+size_t ElasticWorkerPool::GetJobCount() const
+{
+	return m_jobQueue.Size();
+}
+
+unsigned int ElasticWorkerPool::GetWorkerCount() const
+{
+	return static_cast<unsigned int>(m_activeCount);
+}
+
+unsigned int ElasticWorkerPool::GetIdleWorkerCount() const
+{
+	return static_cast<unsigned int>(m_idleCount);
+}
+
+void ElasticWorkerPool::GetMetrics(WorkerMetricsSnapshot &retSnapshot) const
+{
+	LockObj lock(m_poolLock);
+	retSnapshot=WorkerMetricsSnapshot();
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		WorkerMetricsSnapshot workerSnapshot;
+		m_workers[workerTrav]->GetMetrics(workerSnapshot);
+		retSnapshot.Add(workerSnapshot);
+	}
+}
+
+void ElasticWorkerPool::SetMaxWaitTime(unsigned int maxWaitInMilliSec)
+{
+	m_jobQueue.SetMaxWaitTime(maxWaitInMilliSec);
+}
+
+unsigned int ElasticWorkerPool::GetMaxWaitTime() const
+{
+	return m_jobQueue.GetMaxWaitTime();
+}
+
+void ElasticWorkerPool::SetGrowThreshold(unsigned int jobCountPerWorker)
+{
+	if(jobCountPerWorker==0)
+		jobCountPerWorker=1;
+	m_growThreshold=jobCountPerWorker;
+}
+
+unsigned int ElasticWorkerPool::GetGrowThreshold() const
+{
+	return m_growThreshold;
+}
+
+void ElasticWorkerPool::SetGrowLatency(unsigned int latencyInMilliSec)
+{
+	m_growLatency=latencyInMilliSec;
+}
+
+unsigned int ElasticWorkerPool::GetGrowLatency() const
+{
+	return m_growLatency;
+}
+
+bool ElasticWorkerPool::spawnWorker()
+{
+	if(static_cast<unsigned int>(m_activeCount)>=m_maxWorkerCount)
+		return false;
+	ElasticWorker *worker=NULL;
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		// reuse the worker object which has already retired
+		if(m_workers[workerTrav]->GetStatus()==Thread::THREAD_STATUS_TERMINATED)
+		{
+			worker=m_workers[workerTrav];
+			break;
+		}
+	}
+	if(!worker)
+	{
+		if(m_workers.size()>=m_maxWorkerCount)
+			return false;
+		worker=EP_NEW ElasticWorker(this,m_lockPolicy);
+		worker->SetJobProcessor(m_jobProcessor);
+		m_workers.push_back(worker);
+	}
+	if(!worker->Start())
+		return false;
+	InterlockedIncrement(&m_activeCount);
+	return true;
+}
+
+void ElasticWorkerPool::growIfNeeded()
+{
+	if(!m_isStarted || m_isStopping)
+		return;
+	unsigned int activeCount=static_cast<unsigned int>(m_activeCount);
+	if(activeCount>=m_maxWorkerCount)
+		return;
+	if(activeCount>=m_minWorkerCount && m_idleCount>0)
+		return;
+	size_t jobCount=m_jobQueue.Size();
+	bool isTooDeep=(jobCount>=static_cast<size_t>(m_growThreshold)*activeCount);
+	bool isTooSlow=(jobCount>0 && System::GetTickCount()-static_cast<unsigned int>(m_lastDequeueTick)>=m_growLatency);
+	if(activeCount>=m_minWorkerCount && !isTooDeep && !isTooSlow)
+		return;
+
+	LockObj lock(m_poolLock);
+	if(m_isStopping)
+		return;
+	spawnWorker();
+}
+
+bool ElasticWorkerPool::tryRetire()
+{
+	LockObj lock(m_poolLock);
+	if(m_isStopping || static_cast<unsigned int>(m_activeCount)<=m_minWorkerCount)
+		return false;
+	InterlockedDecrement(&m_activeCount);
+	return true;
+}
+
+bool ElasticWorkerPool::isStopping() const
+{
+	return m_isStopping!=0;
+}
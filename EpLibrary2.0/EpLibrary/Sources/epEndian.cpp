@@ -24,6 +24,14 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epEndian.h"
+#include "epSystem.h"
+#include <stdlib.h>
+#include <string.h>
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <tmmintrin.h>
+#define EP_ENDIAN_SSSE3
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -32,77 +40,167 @@ static char THIS_FILE[] = __FILE__;
 #endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 
 using namespace epl;
-short Endian::Swap(const short value)
+
+#if defined(EP_ENDIAN_SSSE3)
+/*!
+Return the flag whether the processor supports SSSE3.
+@return true if supported, otherwise false.
+*/
+static bool hasSSSE3()
 {
-	unsigned char b1, b2;
+	static volatile int s_hasSSSE3=-1;
+	if(s_hasSSSE3<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSSE3=(cpuInfo[2]&(1<<9))?1:0;
+	}
+	return s_hasSSSE3==1;
+}
+#endif //defined(EP_ENDIAN_SSSE3)
 
-	b1 = value & 255;
-	b2 = (value >> 8) & 255;
+Endian::EndianType Endian::GetSystemEndian()
+{
+	const unsigned short value=1;
+	if(*reinterpret_cast<const unsigned char*>(&value)==1)
+		return ENDIAN_TYPE_LITTLE;
+	return ENDIAN_TYPE_BIG;
+}
 
-	return (b1 << 8) + b2;
+short Endian::Swap(const short value)
+{
+	return static_cast<short>(_byteswap_ushort(static_cast<unsigned short>(value)));
 }
 unsigned short Endian::Swap(const unsigned short value)
 {
-	unsigned char b1, b2;
-
-	b1 = value & 255;
-	b2 = (value >> 8) & 255;
-
-	return (b1 << 8) + b2;
+	return _byteswap_ushort(value);
 }
 int Endian::Swap(const int value)
 {
-	unsigned char b1, b2, b3, b4;
-
-	b1 = value & 255;
-	b2 = ( value >> 8 ) & 255;
-	b3 = ( value>>16 ) & 255;
-	b4 = ( value>>24 ) & 255;
-
-	return (static_cast<int>(b1) << 24) + (static_cast<int>(b2) << 16) + (static_cast<int>(b3) << 8) + b4;
+	return static_cast<int>(_byteswap_ulong(static_cast<unsigned long>(value)));
 }
 unsigned int Endian::Swap(const unsigned int value)
 {
-	unsigned char b1, b2, b3, b4;
-
-	b1 = value & 255;
-	b2 = ( value >> 8 ) & 255;
-	b3 = ( value>>16 ) & 255;
-	b4 = ( value>>24 ) & 255;
-
-	return (static_cast<unsigned int>(b1) << 24) + (static_cast<unsigned int>(b2) << 16) + (static_cast<unsigned int>(b3) << 8) + b4;
+	return static_cast<unsigned int>(_byteswap_ulong(static_cast<unsigned long>(value)));
 }
 float Endian::Swap(const float value)
 {
-	union
-	{
-		float f;
-		unsigned char b[4];
-	} dat1, dat2;
-
-	dat1.f = value;
-	dat2.b[0] = dat1.b[3];
-	dat2.b[1] = dat1.b[2];
-	dat2.b[2] = dat1.b[1];
-	dat2.b[3] = dat1.b[0];
-	return dat2.f;
+	float retVal;
+	SwapBytes(&retVal,&value,sizeof(float),1);
+	return retVal;
 }
 double Endian::Swap(const double value)
 {
-	union
-	{
-		double d;
-		unsigned char b[8];
-	} dat1, dat2;
+	double retVal;
+	SwapBytes(&retVal,&value,sizeof(double),1);
+	return retVal;
+}
+__int64 Endian::Swap(const __int64 value)
+{
+	return static_cast<__int64>(_byteswap_uint64(static_cast<unsigned __int64>(value)));
+}
+unsigned __int64 Endian::Swap(const unsigned __int64 value)
+{
+	return _byteswap_uint64(value);
+}
 
-	dat1.d = value;
-	dat2.b[0] = dat1.b[7];
-	dat2.b[1] = dat1.b[6];
-	dat2.b[2] = dat1.b[5];
-	dat2.b[3] = dat1.b[4];
-	dat2.b[4] = dat1.b[3];
-	dat2.b[5] = dat1.b[2];
-	dat2.b[6] = dat1.b[1];
-	dat2.b[7] = dat1.b[0];
-	return dat2.d;
+void Endian::SwapArray(short *shortList, size_t listSize)
+{
+	SwapBytes(shortList,shortList,sizeof(short),listSize);
+}
+void Endian::SwapArray(unsigned short *ushortList, size_t listSize)
+{
+	SwapBytes(ushortList,ushortList,sizeof(unsigned short),listSize);
+}
+void Endian::SwapArray(int *intList, size_t listSize)
+{
+	SwapBytes(intList,intList,sizeof(int),listSize);
+}
+void Endian::SwapArray(unsigned int *uintList, size_t listSize)
+{
+	SwapBytes(uintList,uintList,sizeof(unsigned int),listSize);
+}
+void Endian::SwapArray(float *floatList, size_t listSize)
+{
+	SwapBytes(floatList,floatList,sizeof(float),listSize);
+}
+void Endian::SwapArray(double *doubleList, size_t listSize)
+{
+	SwapBytes(doubleList,doubleList,sizeof(double),listSize);
+}
+void Endian::SwapArray(__int64 *int64List, size_t listSize)
+{
+	SwapBytes(int64List,int64List,sizeof(__int64),listSize);
+}
+void Endian::SwapArray(unsigned __int64 *uint64List, size_t listSize)
+{
+	SwapBytes(uint64List,uint64List,sizeof(unsigned __int64),listSize);
+}
+
+void Endian::SwapBytes(void *retBuffer, const void *buffer, size_t elementSize, size_t count)
+{
+	EP_ASSERT_EXPR(elementSize==2 || elementSize==4 || elementSize==8,_T("Element size must be 2, 4 or 8!"));
+	unsigned char *dest=reinterpret_cast<unsigned char*>(retBuffer);
+	const unsigned char *src=reinterpret_cast<const unsigned char*>(buffer);
+	size_t byteSize=elementSize*count;
+	size_t byteTrav=0;
+
+#if defined(EP_ENDIAN_SSSE3)
+	if(hasSSSE3())
+	{
+		// one shuffle reverses every element within 16 bytes.
+		__m128i mask;
+		if(elementSize==2)
+			mask=_mm_set_epi8(14,15,12,13,10,11,8,9,6,7,4,5,2,3,0,1);
+		else if(elementSize==4)
+			mask=_mm_set_epi8(12,13,14,15,8,9,10,11,4,5,6,7,0,1,2,3);
+		else
+			mask=_mm_set_epi8(8,9,10,11,12,13,14,15,0,1,2,3,4,5,6,7);
+		for(;byteTrav+32<=byteSize;byteTrav+=32)
+		{
+			__m128i first=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+byteTrav));
+			__m128i second=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+byteTrav+16));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+byteTrav),_mm_shuffle_epi8(first,mask));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+byteTrav+16),_mm_shuffle_epi8(second,mask));
+		}
+		if(byteTrav+16<=byteSize)
+		{
+			__m128i first=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+byteTrav));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+byteTrav),_mm_shuffle_epi8(first,mask));
+			byteTrav+=16;
+		}
+	}
+#endif //defined(EP_ENDIAN_SSSE3)
+
+	// the rest is swapped one by one, and memcpy keeps the unaligned access safe.
+	switch(elementSize)
+	{
+	case 2:
+		for(;byteTrav<byteSize;byteTrav+=2)
+		{
+			unsigned short value;
+			memcpy(&value,src+byteTrav,2);
+			value=_byteswap_ushort(value);
+			memcpy(dest+byteTrav,&value,2);
+		}
+		break;
+	case 4:
+		for(;byteTrav<byteSize;byteTrav+=4)
+		{
+			unsigned int value;
+			memcpy(&value,src+byteTrav,4);
+			value=static_cast<unsigned int>(_byteswap_ulong(value));
+			memcpy(dest+byteTrav,&value,4);
+		}
+		break;
+	case 8:
+		for(;byteTrav<byteSize;byteTrav+=8)
+		{
+			unsigned __int64 value;
+			memcpy(&value,src+byteTrav,8);
+			value=_byteswap_uint64(value);
+			memcpy(dest+byteTrav,&value,8);
+		}
+		break;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,268 @@
+/*! 
+EpochReclaimer for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epEpochReclaimer.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+EpochReclaimer::EpochGuard::EpochGuard(EpochReclaimer &reclaimer):m_reclaimer(reclaimer)
+{
+	m_reclaimer.Enter();
+}
+
+EpochReclaimer::EpochGuard::~EpochGuard()
+{
+	m_reclaimer.Leave();
+}
+
+EpochReclaimer::EpochReclaimer(unsigned int maxThreadCount, unsigned int reclaimThreshold, LockPolicy lockPolicyType)
+{
+	EP_ASSERT_EXPR(maxThreadCount>0,_T("The maximum thread count must be greater than 0!"));
+	if(maxThreadCount==0)
+		maxThreadCount=1;
+	if(reclaimThreshold==0)
+		reclaimThreshold=1;
+	m_globalEpoch=0;
+	m_slotCount=maxThreadCount;
+	m_reclaimThreshold=reclaimThreshold;
+	m_slots=EP_NEW ThreadSlot[m_slotCount];
+	for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+	{
+		m_slots[slotTrav].m_state=0;
+		m_slots[slotTrav].m_ownerThreadId=0;
+		m_slots[slotTrav].m_nestCount=0;
+		m_slots[slotTrav].m_pendingCount=0;
+	}
+	m_tlsIndex=TlsAlloc();
+	EP_ASSERT_EXPR(m_tlsIndex!=TLS_OUT_OF_INDEXES,_T("Failed to allocate the TLS index!"));
+	m_orphanCount=0;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_orphanLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_orphanLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_orphanLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_orphanLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_orphanLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_orphanLock=NULL;
+		break;
+	}
+}
+
+EpochReclaimer::~EpochReclaimer()
+{
+	for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+	{
+		EP_ASSERT_EXPR(!(m_slots[slotTrav].m_state&1),_T("The thread is still in the critical region!"));
+		std::vector<RetiredNode> &retireList=m_slots[slotTrav].m_retireList;
+		for(size_t nodeTrav=0;nodeTrav<retireList.size();nodeTrav++)
+		{
+			retireList[nodeTrav].m_reclaimFunc(retireList[nodeTrav].m_ptr);
+		}
+	}
+	for(size_t nodeTrav=0;nodeTrav<m_orphanList.size();nodeTrav++)
+	{
+		m_orphanList[nodeTrav].m_reclaimFunc(m_orphanList[nodeTrav].m_ptr);
+	}
+	EP_DELETE[] m_slots;
+	if(m_tlsIndex!=TLS_OUT_OF_INDEXES)
+		TlsFree(m_tlsIndex);
+	if(m_orphanLock)
+		EP_DELETE m_orphanLock;
+}
+
+void EpochReclaimer::Enter()
+{
+	ThreadSlot *slot=getSlot();
+	if(slot->m_nestCount++>0)
+		return;
+	// announce the epoch, and make sure it did not advance before the announcement became visible
+	long epoch;
+	do{
+		epoch=m_globalEpoch;
+		InterlockedExchange(&slot->m_state,epoch|1);
+	}while(epoch!=m_globalEpoch);
+}
+
+void EpochReclaimer::Leave()
+{
+	ThreadSlot *slot=reinterpret_cast<ThreadSlot*>(TlsGetValue(m_tlsIndex));
+	EP_ASSERT_EXPR(slot && slot->m_nestCount>0,_T("Leave is called without Enter!"));
+	if(!slot || slot->m_nestCount==0)
+		return;
+	if(--slot->m_nestCount==0)
+		InterlockedExchange(&slot->m_state,0);
+}
+
+void EpochReclaimer::Retire(void *ptr, ReclaimFunc reclaimFunc)
+{
+	if(!ptr)
+		return;
+	ThreadSlot *slot=getSlot();
+	RetiredNode node;
+	node.m_ptr=ptr;
+	node.m_reclaimFunc=reclaimFunc;
+	node.m_epoch=m_globalEpoch;
+	slot->m_retireList.push_back(node);
+	slot->m_pendingCount=static_cast<long>(slot->m_retireList.size());
+	if(slot->m_retireList.size()<m_reclaimThreshold)
+		return;
+	reclaimSlot(slot);
+	// the thread in the critical region holds the epoch itself, so waiting there would never end
+	while(slot->m_nestCount==0 && slot->m_retireList.size()>=static_cast<size_t>(m_reclaimThreshold)*4)
+	{
+		Sleep(0);
+		reclaimSlot(slot);
+	}
+}
+
+bool EpochReclaimer::TryReclaim()
+{
+	ThreadSlot *slot=getSlot();
+	long epoch=m_globalEpoch;
+	reclaimSlot(slot);
+	return epoch!=m_globalEpoch;
+}
+
+void EpochReclaimer::UnregisterThread()
+{
+	ThreadSlot *slot=reinterpret_cast<ThreadSlot*>(TlsGetValue(m_tlsIndex));
+	if(!slot)
+		return;
+	EP_ASSERT_EXPR(slot->m_nestCount==0,_T("The thread is still in the critical region!"));
+	slot->m_nestCount=0;
+	InterlockedExchange(&slot->m_state,0);
+	tryAdvance();
+	reclaimList(slot->m_retireList,m_globalEpoch);
+	if(!slot->m_retireList.empty())
+	{
+		m_orphanLock->Lock();
+		m_orphanList.insert(m_orphanList.end(),slot->m_retireList.begin(),slot->m_retireList.end());
+		m_orphanCount=static_cast<long>(m_orphanList.size());
+		m_orphanLock->Unlock();
+		slot->m_retireList.clear();
+	}
+	slot->m_pendingCount=0;
+	TlsSetValue(m_tlsIndex,NULL);
+	InterlockedExchange(&slot->m_ownerThreadId,0);
+}
+
+size_t EpochReclaimer::GetPendingCount() const
+{
+	size_t retCount=static_cast<size_t>(m_orphanCount);
+	for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+	{
+		retCount+=static_cast<size_t>(m_slots[slotTrav].m_pendingCount);
+	}
+	return retCount;
+}
+
+EpochReclaimer::ThreadSlot *EpochReclaimer::getSlot()
+{
+	ThreadSlot *slot=reinterpret_cast<ThreadSlot*>(TlsGetValue(m_tlsIndex));
+	if(slot)
+		return slot;
+	long threadId=static_cast<long>(GetCurrentThreadId());
+	while(true)
+	{
+		for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+		{
+			if(m_slots[slotTrav].m_ownerThreadId==0 && InterlockedCompareExchange(&m_slots[slotTrav].m_ownerThreadId,threadId,0)==0)
+			{
+				slot=&m_slots[slotTrav];
+				TlsSetValue(m_tlsIndex,slot);
+				return slot;
+			}
+		}
+		// all slots are taken, so wait for a thread to unregister
+		EP_ASSERT_EXPR(0,_T("More than %d threads are registered to the reclaimer!"),m_slotCount);
+		Sleep(1);
+	}
+}
+
+bool EpochReclaimer::tryAdvance()
+{
+	long epoch=m_globalEpoch;
+	for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+	{
+		long state=m_slots[slotTrav].m_state;
+		if((state&1) && (state&~1)!=epoch)
+			return false;
+	}
+	// the epoch is kept even, so the lowest bit of the slot state is free for the active flag
+	long nextEpoch=static_cast<long>(static_cast<unsigned long>(epoch)+2);
+	return InterlockedCompareExchange(&m_globalEpoch,nextEpoch,epoch)==epoch;
+}
+
+size_t EpochReclaimer::reclaimList(std::vector<RetiredNode> &retireList, long globalEpoch)
+{
+	size_t keepCount=0;
+	for(size_t nodeTrav=0;nodeTrav<retireList.size();nodeTrav++)
+	{
+		// safe after two advances, since no thread in the critical region can still see it
+		if(static_cast<unsigned long>(globalEpoch)-static_cast<unsigned long>(retireList[nodeTrav].m_epoch)>=4)
+			retireList[nodeTrav].m_reclaimFunc(retireList[nodeTrav].m_ptr);
+		else
+			retireList[keepCount++]=retireList[nodeTrav];
+	}
+	size_t reclaimCount=retireList.size()-keepCount;
+	retireList.resize(keepCount);
+	return reclaimCount;
+}
+
+void EpochReclaimer::reclaimSlot(ThreadSlot *slot)
+{
+	tryAdvance();
+	reclaimList(slot->m_retireList,m_globalEpoch);
+	slot->m_pendingCount=static_cast<long>(slot->m_retireList.size());
+	if(m_orphanCount>0)
+		reclaimOrphans();
+}
+
+void EpochReclaimer::reclaimOrphans()
+{
+	if(!m_orphanLock->TryLock())
+		return;
+	reclaimList(m_orphanList,m_globalEpoch);
+	m_orphanCount=static_cast<long>(m_orphanList.size());
+	m_orphanLock->Unlock();
+}
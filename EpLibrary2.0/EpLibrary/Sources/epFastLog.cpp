@@ -26,6 +26,16 @@ THE SOFTWARE.
 
 #include "epFastLog.h"
 
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_FAST_LOG_SSE2
+#if _MSC_VER>=MSVC110
+#include <immintrin.h>
+#define EP_FAST_LOG_AVX2
+#endif //_MSC_VER>=MSVC110
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
 #undef THIS_FILE
@@ -34,137 +44,201 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
-#define TYPE_SIGNED      2
-#define TYPE_UNSIGNED    1
-#define NUM_BITS_IN_BYTE 8
-
 #define FLOAT_INPUT_MIN_VAL    1
 
 #define UPPER 1
 #define LOWER 0
 
-unsigned int fastLog(unsigned int input, unsigned int shift_init, int bound)
+/*!
+Return the log of the given value
+@param[in] input the value for log (must be greater than 0)
+@param[in] bound UPPER to round up, LOWER to round down
+@return the log of the given value
+*/
+static unsigned int fastLog(unsigned int input, int bound)
 {
-	if(input==1)
-		return 0;
+	unsigned long bit;
+#if defined(EP_FAST_LOG_SSE2)
+	_BitScanReverse(&bit,input);
+#else //defined(EP_FAST_LOG_SSE2)
+	bit=0;
+	for(unsigned int shift=16;shift>0;shift>>=1)
+	{
+		if(input>>(bit+shift))
+			bit+=shift;
+	}
+#endif //defined(EP_FAST_LOG_SSE2)
+	// rounds up unless the value is the power of two
+	if(bound==UPPER && (input&(input-1)))
+		bit++;
+	return static_cast<unsigned int>(bit);
+}
 
-	unsigned int cal_Input = input;
-	unsigned int calTest;
-	unsigned int finalvalue=0;
-	unsigned int shifter;
-	for(shifter = shift_init; shifter>0; shifter--)
+#if defined(EP_FAST_LOG_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
+{
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
 	{
-		calTest=(cal_Input>>shifter);
-		if(calTest)
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
+}
+
+/*!
+Return the logs of the given four values
+@param[in] value the values for log.
+@param[in] bound UPPER to round up, LOWER to round down
+@return the logs of the values, or FLOG_ERROR for 0
+*/
+static inline __m128i fastLogSSE2(__m128i value, int bound)
+{
+	// smear the highest bit down, and keep only the highest bit
+	__m128i smeared=_mm_or_si128(value,_mm_srli_epi32(value,1));
+	smeared=_mm_or_si128(smeared,_mm_srli_epi32(smeared,2));
+	smeared=_mm_or_si128(smeared,_mm_srli_epi32(smeared,4));
+	smeared=_mm_or_si128(smeared,_mm_srli_epi32(smeared,8));
+	smeared=_mm_or_si128(smeared,_mm_srli_epi32(smeared,16));
+	__m128i highest=_mm_xor_si128(smeared,_mm_srli_epi32(smeared,1));
+	// the power of two converts to the float exactly, and its exponent is the log
+	__m128i exponent=_mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(highest)),23);
+	__m128i result=_mm_sub_epi32(_mm_and_si128(exponent,_mm_set1_epi32(0xFF)),_mm_set1_epi32(127));
+	if(bound==UPPER)
+	{
+		// the comparison gives -1 for the power of two, which cancels the round up
+		__m128i isPowerOfTwo=_mm_cmpeq_epi32(_mm_and_si128(value,_mm_sub_epi32(value,_mm_set1_epi32(1))),_mm_setzero_si128());
+		result=_mm_add_epi32(result,_mm_add_epi32(isPowerOfTwo,_mm_set1_epi32(1)));
+	}
+	__m128i isZero=_mm_cmpeq_epi32(value,_mm_setzero_si128());
+	return _mm_or_si128(_mm_andnot_si128(isZero,result),_mm_and_si128(isZero,_mm_set1_epi32(FLOG_ERROR)));
+}
+#endif //defined(EP_FAST_LOG_SSE2)
+
+#if defined(EP_FAST_LOG_AVX2)
+/*!
+Return the flag whether the processor and the OS support AVX2.
+@return true if supported, otherwise false.
+*/
+static bool hasAVX2()
+{
+	static volatile int s_hasAVX2=-1;
+	if(s_hasAVX2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,0);
+		bool isSupported=false;
+		if(cpuInfo[0]>=7)
 		{
-			unsigned int checkAbs= calTest<<shifter;
-			if(checkAbs ^ input)
-			{
-				finalvalue=checkAbs<<bound;
-			}
-			else
+			__cpuid(cpuInfo,1);
+			// the OS must save the YMM registers as well
+			if((cpuInfo[2]&(1<<27)) && (cpuInfo[2]&(1<<28)) && (_xgetbv(0)&0x6)==0x6)
 			{
-				finalvalue=checkAbs;
+				__cpuidex(cpuInfo,7,0);
+				isSupported=(cpuInfo[1]&(1<<5))!=0;
 			}
-			break;
+		}
+		s_hasAVX2=isSupported?1:0;
+	}
+	return s_hasAVX2==1;
+}
 
+/*!
+Return the logs of the given eight values
+@param[in] value the values for log.
+@param[in] bound UPPER to round up, LOWER to round down
+@return the logs of the values, or FLOG_ERROR for 0
+*/
+static inline __m256i fastLogAVX2(__m256i value, int bound)
+{
+	__m256i smeared=_mm256_or_si256(value,_mm256_srli_epi32(value,1));
+	smeared=_mm256_or_si256(smeared,_mm256_srli_epi32(smeared,2));
+	smeared=_mm256_or_si256(smeared,_mm256_srli_epi32(smeared,4));
+	smeared=_mm256_or_si256(smeared,_mm256_srli_epi32(smeared,8));
+	smeared=_mm256_or_si256(smeared,_mm256_srli_epi32(smeared,16));
+	__m256i highest=_mm256_xor_si256(smeared,_mm256_srli_epi32(smeared,1));
+	__m256i exponent=_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(highest)),23);
+	__m256i result=_mm256_sub_epi32(_mm256_and_si256(exponent,_mm256_set1_epi32(0xFF)),_mm256_set1_epi32(127));
+	if(bound==UPPER)
+	{
+		__m256i isPowerOfTwo=_mm256_cmpeq_epi32(_mm256_and_si256(value,_mm256_sub_epi32(value,_mm256_set1_epi32(1))),_mm256_setzero_si256());
+		result=_mm256_add_epi32(result,_mm256_add_epi32(isPowerOfTwo,_mm256_set1_epi32(1)));
+	}
+	__m256i isZero=_mm256_cmpeq_epi32(value,_mm256_setzero_si256());
+	return _mm256_blendv_epi8(result,_mm256_set1_epi32(FLOG_ERROR),isZero);
+}
+#endif //defined(EP_FAST_LOG_AVX2)
+
+/*!
+Return the logs of the given values
+@param[in] input the values for log.
+@param[out] retOutput the logs of the values, or FLOG_ERROR for 0
+@param[in] count the number of values
+@param[in] bound UPPER to round up, LOWER to round down
+*/
+static void fastLogArray(const unsigned int *input, unsigned int *retOutput, size_t count, int bound)
+{
+	size_t valTrav=0;
+#if defined(EP_FAST_LOG_AVX2)
+	if(hasAVX2())
+	{
+		for(;valTrav+8<=count;valTrav+=8)
+		{
+			__m256i value=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(input+valTrav));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(retOutput+valTrav),fastLogAVX2(value,bound));
 		}
+		_mm256_zeroupper();
 	}
-	switch(finalvalue)
+#endif //defined(EP_FAST_LOG_AVX2)
+#if defined(EP_FAST_LOG_SSE2)
+	if(hasSSE2())
 	{
-	case 0x00000002:
-		return 1;
-	case 0x00000004:
-		return 2;
-	case 0x00000008:
-		return 3;
-	case 0x00000010:
-		return 4;
-	case 0x00000020:
-		return 5;
-	case 0x00000040:
-		return 6;
-	case 0x00000080:
-		return 7;
-	case 0x00000100:
-		return 8;
-	case 0x00000200:
-		return 9;
-	case 0x00000400:
-		return 10;
-	case 0x00000800:
-		return 11;
-	case 0x00001000:
-		return 12;
-	case 0x00002000:
-		return 13;
-	case 0x00004000:
-		return 14;
-	case 0x00008000:
-		return 15;
-	case 0x00010000:
-		return 16;
-	case 0x00020000:
-		return 17;
-	case 0x00040000:
-		return 18;
-	case 0x00080000:
-		return 19;
-	case 0x00100000:
-		return 20;
-	case 0x00200000:
-		return 21;
-	case 0x00400000:
-		return 22;
-	case 0x00800000:
-		return 23;
-	case 0x01000000:
-		return 24;
-	case 0x02000000:
-		return 25;
-	case 0x04000000:
-		return 26;
-	case 0x08000000:
-		return 27;
-	case 0x10000000:
-		return 28;
-	case 0x20000000:
-		return 29;
-	case 0x40000000:
-		return 30;
-	case 0x80000000:
-		return 31;
-	default:
-		return 32;
+		for(;valTrav+4<=count;valTrav+=4)
+		{
+			__m128i value=_mm_loadu_si128(reinterpret_cast<const __m128i*>(input+valTrav));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(retOutput+valTrav),fastLogSSE2(value,bound));
+		}
 	}
+#endif //defined(EP_FAST_LOG_SSE2)
+	for(;valTrav<count;valTrav++)
+		retOutput[valTrav]=input[valTrav]<FLOAT_INPUT_MIN_VAL?FLOG_ERROR:fastLog(input[valTrav],bound);
 }
 
 unsigned int FastLog::FLogU(unsigned int input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return fastLog(input,sizeof(unsigned int)*NUM_BITS_IN_BYTE-TYPE_UNSIGNED, UPPER );
+	return fastLog(input,UPPER);
 }
 
 int FastLog::FLogU(int input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return static_cast<int>(fastLog(static_cast<unsigned int>(input),sizeof(int)*NUM_BITS_IN_BYTE-TYPE_SIGNED, UPPER));
+	return static_cast<int>(fastLog(static_cast<unsigned int>(input),UPPER));
 }
 
 unsigned short FastLog::FLogU(unsigned short input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return static_cast<unsigned short>(fastLog(static_cast<unsigned int>(input), sizeof(unsigned short)*NUM_BITS_IN_BYTE-TYPE_UNSIGNED, UPPER) );
+	return static_cast<unsigned short>(fastLog(static_cast<unsigned int>(input),UPPER) );
 }
 
 short FastLog::FLogU(short input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return static_cast<short>( fastLog(static_cast<unsigned int>(input), sizeof(short)*NUM_BITS_IN_BYTE-TYPE_SIGNED, UPPER) );
+	return static_cast<short>( fastLog(static_cast<unsigned int>(input),UPPER) );
 }
 
 
@@ -172,27 +246,36 @@ unsigned int FastLog::FLogL(unsigned int input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return fastLog(input,sizeof(unsigned int)*NUM_BITS_IN_BYTE-TYPE_UNSIGNED, LOWER );
+	return fastLog(input,LOWER);
 }
 
 int FastLog::FLogL(int input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return static_cast<int>( fastLog(static_cast<unsigned int>(input),sizeof(int)*NUM_BITS_IN_BYTE-TYPE_SIGNED, LOWER) );
+	return static_cast<int>( fastLog(static_cast<unsigned int>(input),LOWER) );
 }
 
 unsigned short FastLog::FLogL(unsigned short input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return static_cast<unsigned short>( fastLog(static_cast<unsigned int>(input), sizeof(unsigned short)*NUM_BITS_IN_BYTE-TYPE_UNSIGNED, LOWER) );
+	return static_cast<unsigned short>( fastLog(static_cast<unsigned int>(input),LOWER) );
 }
 
 short FastLog::FLogL(short input)
 {
 	if(input<FLOAT_INPUT_MIN_VAL)
 		return FLOG_ERROR;
-	return static_cast<short>( fastLog(static_cast<unsigned int>(input), sizeof(short)*NUM_BITS_IN_BYTE-TYPE_SIGNED, LOWER) );
+	return static_cast<short>( fastLog(static_cast<unsigned int>(input),LOWER) );
 }
 
+void FastLog::FLogU(const unsigned int *input, unsigned int *retOutput, size_t count)
+{
+	fastLogArray(input,retOutput,count,UPPER);
+}
+
+void FastLog::FLogL(const unsigned int *input, unsigned int *retOutput, size_t count)
+{
+	fastLogArray(input,retOutput,count,LOWER);
+}
@@ -48,6 +48,17 @@ Contact: castor.vulgaris@gmail.com
 */
 
 #include "epFastSqrt.h"
+#include <math.h>
+
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_FAST_SQRT_SSE2
+#if _MSC_VER>=MSVC110
+#include <immintrin.h>
+#define EP_FAST_SQRT_AVX
+#endif //_MSC_VER>=MSVC110
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -200,4 +211,118 @@ unsigned int FastSqrt::Sqrt(const unsigned int val)
 	return g_sqrt_table[t] >> shift;
 }
 
+#if defined(EP_FAST_SQRT_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
+{
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
+}
+
+/*!
+Convert the unsigned integers in the low two lanes to the double exactly.
+@param[in] value the unsigned integers
+@return the doubles converted
+*/
+static inline __m128d toDoubleSSE2(__m128i value)
+{
+	// the signed conversion is exact after moving the range by 2^31
+	__m128d converted=_mm_cvtepi32_pd(_mm_xor_si128(value,_mm_set1_epi32(static_cast<int>(0x80000000))));
+	return _mm_add_pd(converted,_mm_set1_pd(2147483648.0));
+}
+#endif //defined(EP_FAST_SQRT_SSE2)
+
+#if defined(EP_FAST_SQRT_AVX)
+/*!
+Return the flag whether the processor and the OS support AVX.
+@return true if supported, otherwise false.
+*/
+static bool hasAVX()
+{
+	static volatile int s_hasAVX=-1;
+	if(s_hasAVX<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		// the OS must save the YMM registers as well
+		bool isSupported=(cpuInfo[2]&(1<<27)) && (cpuInfo[2]&(1<<28)) && (_xgetbv(0)&0x6)==0x6;
+		s_hasAVX=isSupported?1:0;
+	}
+	return s_hasAVX==1;
+}
+#endif //defined(EP_FAST_SQRT_AVX)
+
+unsigned int FastSqrt::ISqrt(const unsigned int val)
+{
+	// the double keeps every 32-bit value exactly, so the truncation gives the exact floor
+	return static_cast<unsigned int>(sqrt(static_cast<double>(val)));
+}
+
+void FastSqrt::ISqrt(const unsigned int *input, unsigned int *retOutput, size_t count)
+{
+	size_t valTrav=0;
+#if defined(EP_FAST_SQRT_AVX)
+	if(hasAVX())
+	{
+		__m256d offset=_mm256_set1_pd(2147483648.0);
+		__m128i signFlip=_mm_set1_epi32(static_cast<int>(0x80000000));
+		for(;valTrav+4<=count;valTrav+=4)
+		{
+			__m128i value=_mm_loadu_si128(reinterpret_cast<const __m128i*>(input+valTrav));
+			__m256d converted=_mm256_add_pd(_mm256_cvtepi32_pd(_mm_xor_si128(value,signFlip)),offset);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(retOutput+valTrav),_mm256_cvttpd_epi32(_mm256_sqrt_pd(converted)));
+		}
+		_mm256_zeroupper();
+	}
+#endif //defined(EP_FAST_SQRT_AVX)
+#if defined(EP_FAST_SQRT_SSE2)
+	if(hasSSE2())
+	{
+		for(;valTrav+4<=count;valTrav+=4)
+		{
+			__m128i value=_mm_loadu_si128(reinterpret_cast<const __m128i*>(input+valTrav));
+			__m128i low=_mm_cvttpd_epi32(_mm_sqrt_pd(toDoubleSSE2(value)));
+			__m128i high=_mm_cvttpd_epi32(_mm_sqrt_pd(toDoubleSSE2(_mm_shuffle_epi32(value,_MM_SHUFFLE(1,0,3,2)))));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(retOutput+valTrav),_mm_unpacklo_epi64(low,high));
+		}
+	}
+#endif //defined(EP_FAST_SQRT_SSE2)
+	for(;valTrav<count;valTrav++)
+		retOutput[valTrav]=ISqrt(input[valTrav]);
+}
+
+void FastSqrt::Sqrt(const float *input, float *retOutput, size_t count)
+{
+	size_t valTrav=0;
+#if defined(EP_FAST_SQRT_AVX)
+	if(hasAVX())
+	{
+		for(;valTrav+8<=count;valTrav+=8)
+			_mm256_storeu_ps(retOutput+valTrav,_mm256_sqrt_ps(_mm256_loadu_ps(input+valTrav)));
+		_mm256_zeroupper();
+	}
+#endif //defined(EP_FAST_SQRT_AVX)
+#if defined(EP_FAST_SQRT_SSE2)
+	if(hasSSE2())
+	{
+		for(;valTrav+4<=count;valTrav+=4)
+			_mm_storeu_ps(retOutput+valTrav,_mm_sqrt_ps(_mm_loadu_ps(input+valTrav)));
+	}
+#endif //defined(EP_FAST_SQRT_SSE2)
+	for(;valTrav<count;valTrav++)
+		retOutput[valTrav]=sqrtf(input[valTrav]);
+}
 
@@ -0,0 +1,119 @@
+/*! 
+FileIoJob for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epFileIoJob.h"
+#include "epSystem.h"
+#include "epBaseJobProcessor.h"
+#include "epJobHandle.h"
+#include "epThreadPool.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+namespace epl
+{
+	/*!
+	@class FileIoJobProcessor epFileIoJob.cpp
+	@brief A job processor which performs the file I/O of the FileIoJob.
+	*/
+	class FileIoJobProcessor: public BaseJobProcessor
+	{
+	public:
+		/*!
+		Perform the file I/O of the given FileIoJob.
+		@param[in] workerThread The worker thread which called the DoJob.
+		@param[in] data The FileIoJob given to this object.
+		*/
+		virtual void DoJob(BaseWorkerThread *workerThread, BaseJob* const data)
+		{
+			FileIoJob *job=static_cast<FileIoJob*>(data);
+			job->m_result=job->doIo();
+		}
+	};
+}
+
+FileIoJob::FileIoJob(FileIoType ioType, const TCHAR *fileName, FileIoCallbackInterface *callBackObj, LockPolicy lockPolicyType):BaseJob(PRIORITY_NORMAL,lockPolicyType)
+{
+	m_ioType=ioType;
+	if(fileName)
+		m_fileName=fileName;
+	m_callBackObj=callBackObj;
+	m_result=false;
+	m_isReported=0;
+}
+
+FileIoJob::~FileIoJob()
+{
+}
+
+FileIoType FileIoJob::GetIoType() const
+{
+	return m_ioType;
+}
+
+const TCHAR *FileIoJob::GetFileName() const
+{
+	return m_fileName.c_str();
+}
+
+bool FileIoJob::GetResult() const
+{
+	return m_result;
+}
+
+JobHandle *FileIoJob::Submit(ThreadPool *ioPool)
+{
+	EP_ASSERT_EXPR(ioPool,_T("The I/O pool is NULL."));
+	m_result=false;
+	m_isReported=0;
+	FileIoJobProcessor *jobProcessor=EP_NEW FileIoJobProcessor();
+	SetJobProcessor(jobProcessor);
+	jobProcessor->ReleaseObj();
+	return ioPool->Submit(this);
+}
+
+void FileIoJob::handleReport(const JobStatus status)
+{
+	switch(status)
+	{
+	case JOB_STATUS_DONE:
+	case JOB_STATUS_INCOMPLETE:
+	case JOB_STATUS_JOB_PROCESSOR_TIMEOUT:
+	case JOB_STATUS_TIMEOUT:
+	case JOB_STATUS_CANCELLED:
+		if(status!=JOB_STATUS_DONE)
+			m_result=false;
+		if(m_callBackObj && InterlockedExchange(&m_isReported,1)==0)
+			m_callBackObj->OnFileIoComplete(m_ioType,m_fileName.c_str(),m_result);
+		break;
+	default:
+		break;
+	}
+}
\ No newline at end of file
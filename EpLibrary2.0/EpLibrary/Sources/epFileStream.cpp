@@ -37,32 +37,78 @@ using namespace epl;
 FileStream::FileStream(const TCHAR *fileName,LockPolicy lockPolicyType) :Stream(lockPolicyType)
 {
 	m_fileName=fileName;
+	m_fileHandle=INVALID_HANDLE_VALUE;
+	m_mappingHandle=NULL;
+	m_mapType=FILE_STREAM_MAP_TYPE_READ_ONLY;
+	m_view=NULL;
+	m_viewBase=0;
+	m_viewSize=0;
+	m_windowSize=0;
+	m_mappedSize=0;
+	m_mappedCapacity=0;
+	m_chunkHandle=INVALID_HANDLE_VALUE;
+	m_chunkType=FILE_STREAM_CHUNK_TYPE_READ;
+	m_chunkSize=0;
+	m_isUnbuffered=false;
+	m_pendingMemory=NULL;
+	m_pendingChunk=NULL;
+	m_pendingCapacity=0;
+	m_isPending=false;
+	m_chunkOffset=0;
+	m_chunkBase=0;
 }
 
 FileStream::FileStream(const FileStream& b):Stream(b)
 {
 	m_fileName=b.m_fileName;
+	m_fileHandle=INVALID_HANDLE_VALUE;
+	m_mappingHandle=NULL;
+	m_mapType=FILE_STREAM_MAP_TYPE_READ_ONLY;
+	m_view=NULL;
+	m_viewBase=0;
+	m_viewSize=0;
+	m_windowSize=0;
+	m_mappedSize=0;
+	m_mappedCapacity=0;
+	m_chunkHandle=INVALID_HANDLE_VALUE;
+	m_chunkType=FILE_STREAM_CHUNK_TYPE_READ;
+	m_chunkSize=0;
+	m_isUnbuffered=false;
+	m_pendingMemory=NULL;
+	m_pendingChunk=NULL;
+	m_pendingCapacity=0;
+	m_isPending=false;
+	m_chunkOffset=0;
+	m_chunkBase=0;
+	// move the borrowed window of the mapped stream to the own memory.
+	if(m_stream.IsBorrowed())
+		m_stream.Reserve(m_stream.GetSize()+1);
 }
 
 FileStream & FileStream::operator=(const FileStream&b)
 {
 	if(this!=&b)
 	{
+		UnmapStream();
+		CloseChunkedStream();
 		Stream::operator =(b);
-		LockObj lock(b.m_streamLock);
+		StreamLockObj lock(&b);
 		m_fileName=b.m_fileName;
-		
+		if(m_stream.IsBorrowed())
+			m_stream.Reserve(m_stream.GetSize()+1);
 	}
 	return *this;
 }
 
 FileStream::~FileStream()
 {
+	closeMapping();
+	closeChunked();
 }
 
 void FileStream::SetFileName(const TCHAR *fileName)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	m_fileName=fileName;
 }
 EpTString FileStream::GetFileName() const
@@ -72,8 +118,10 @@ EpTString FileStream::GetFileName() const
 
 bool FileStream::LoadStreamFromFile()
 {
-	LockObj lock(m_streamLock);
-	m_stream.clear();
+	StreamLockObj lock(this);
+	closeMapping();
+	closeChunked();
+	m_stream.Clear();
 
 	if(m_fileName.length()==0)
 	{
@@ -84,55 +132,569 @@ bool FileStream::LoadStreamFromFile()
 	int fileSize;
 	System::FTOpen(file,m_fileName.c_str(),_T("rb"));
 	fileSize=System::FSize(file);
-	m_stream.resize(fileSize);
-	size_t read=System::FRead(&m_stream.at(0),sizeof(unsigned char), fileSize,file);
-	m_stream.erase(m_stream.begin()+read,m_stream.end());
+	if(!m_stream.ResizeUninitialized(fileSize))
+	{
+		System::FClose(file);
+		LOG_THIS_MSG(_T("File is larger than the stream can hold!"));
+		return false;
+	}
+	size_t read=System::FRead(m_stream.GetData(),sizeof(unsigned char), fileSize,file);
+	m_stream.ResizeUninitialized(read);
 	System::FClose(file);
-	m_offset=m_stream.size();
+	m_offset=m_stream.GetSize();
 	return true;
 }
 bool FileStream::WriteStreamToFile()
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	if(m_fileName.length()==0)
 	{
 		LOG_THIS_MSG(_T("File Name Not Set!"));
 		return false;
 	}
-	if(m_stream.empty())
+	if(m_fileHandle!=INVALID_HANDLE_VALUE)
+	{
+		// the mapped stream is already written in the file.
+		if(m_view && m_mapType==FILE_STREAM_MAP_TYPE_READ_WRITE)
+			FlushViewOfFile(m_view,0);
+		return true;
+	}
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE)
+	{
+		// push the data written so far to the file.
+		if(m_chunkType==FILE_STREAM_CHUNK_TYPE_WRITE && !writeBehind())
+			return false;
+		waitChunk();
+		return true;
+	}
+	if(m_stream.IsEmpty())
 	{
 		LOG_THIS_MSG(_T("There is no stream data!"));
 		return false;
 	}
 	EpFile *file;
 	System::FTOpen(file,m_fileName.c_str(),_T("wb"));
-	System::FWrite(&m_stream.at(0),sizeof(unsigned char),m_stream.size(),file);
+	System::FWrite(m_stream.GetData(),sizeof(unsigned char),m_stream.GetSize(),file);
 	System::FClose(file);
 	return true;
 }
 
+bool FileStream::MapStreamFromFile(FileStreamMapType mapType, size_t windowSize)
+{
+	StreamLockObj lock(this);
+	closeMapping();
+	closeChunked();
+
+	if(m_fileName.length()==0)
+	{
+		LOG_THIS_MSG(_T("File Name Not Set!"));
+		return false;
+	}
+	bool isWritable=(mapType==FILE_STREAM_MAP_TYPE_READ_WRITE);
+	if(isWritable)
+		m_fileHandle=CreateFile(m_fileName.c_str(),GENERIC_READ|GENERIC_WRITE,FILE_SHARE_READ,NULL,OPEN_ALWAYS,FILE_ATTRIBUTE_NORMAL,NULL);
+	else
+		m_fileHandle=CreateFile(m_fileName.c_str(),GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,NULL);
+	if(m_fileHandle==INVALID_HANDLE_VALUE)
+	{
+		LOG_THIS_MSG(_T("Cannot open the file to map!"));
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(m_fileHandle,&fileSize))
+	{
+		closeMapping();
+		LOG_THIS_MSG(_T("Cannot get the size of the file to map!"));
+		return false;
+	}
+	m_mapType=mapType;
+	m_mappedSize=static_cast<unsigned __int64>(fileSize.QuadPart);
+	m_mappedCapacity=m_mappedSize;
+
+	if(windowSize==0)
+	{
+#if defined(_WIN64)
+		m_windowSize=0;
+#else //defined(_WIN64)
+		m_windowSize=FILE_STREAM_MAP_WINDOW_SIZE;
+#endif //defined(_WIN64)
+	}
+	else
+		m_windowSize=windowSize;
+	// the window starts at the allocation granularity, so it must span at least one granularity.
+	size_t granularity=System::GetSystemInfo().dwAllocationGranularity;
+	if(m_windowSize)
+		m_windowSize=(m_windowSize+granularity-1)/granularity*granularity;
+
+	// the empty file cannot be mapped until written.
+	if(m_mappedCapacity)
+	{
+		m_mappingHandle=CreateFileMapping(m_fileHandle,NULL,isWritable?PAGE_READWRITE:PAGE_READONLY,0,0,NULL);
+		if(!m_mappingHandle || !slide(0))
+		{
+			closeMapping();
+			LOG_THIS_MSG(_T("Cannot map the file!"));
+			return false;
+		}
+	}
+	return true;
+}
+
+void FileStream::UnmapStream()
+{
+	StreamLockObj lock(this);
+	closeMapping();
+}
+
+bool FileStream::IsMapped() const
+{
+	return m_fileHandle!=INVALID_HANDLE_VALUE;
+}
+
+unsigned __int64 FileStream::GetMappedSize() const
+{
+	return m_mappedSize;
+}
+
+void FileStream::SetMappedSeek(unsigned __int64 offset)
+{
+	StreamLockObj lock(this);
+	// the seek over the end keeps the current window.
+	if(!slide(offset) && offset>=m_viewBase)
+		m_offset=static_cast<size_t>(offset-m_viewBase);
+}
+
+unsigned __int64 FileStream::GetMappedSeek() const
+{
+	return m_viewBase+m_offset;
+}
+
+void FileStream::SetSeek(const StreamSeekType seekType,size_t offset)
+{
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE)
+		return;
+	if(m_fileHandle==INVALID_HANDLE_VALUE)
+	{
+		Stream::SetSeek(seekType,offset);
+		return;
+	}
+	switch(seekType)
+	{
+	case STREAM_SEEK_TYPE_SEEK_SET:
+		SetMappedSeek(offset);
+		break;
+	case STREAM_SEEK_TYPE_SEEK_CUR:
+		SetMappedSeek(GetMappedSeek()+offset);
+		break;
+	case STREAM_SEEK_TYPE_SEEK_END:
+		SetMappedSeek(m_mappedSize);
+	}
+}
+
+size_t FileStream::GetSeek() const
+{
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE)
+		return static_cast<size_t>(GetChunkedSeek());
+	if(m_fileHandle==INVALID_HANDLE_VALUE)
+		return Stream::GetSeek();
+	return static_cast<size_t>(GetMappedSeek());
+}
+
+size_t &FileStream::readOffset()
+{
+	// keep at least a chunk after the seek, so the scan of the string does not stop at the end of the chunk.
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE && m_chunkType==FILE_STREAM_CHUNK_TYPE_READ && m_stream.GetSize()-m_offset<m_chunkSize)
+		appendChunk();
+	// move the window to start at the seek, so the scan of the string sees the whole window.
+	if(m_fileHandle!=INVALID_HANDLE_VALUE && m_offset>m_viewSize/2 && m_viewBase+m_viewSize<m_mappedCapacity)
+	{
+		unsigned __int64 offset=m_viewBase+m_offset;
+		unmapWindow();
+		slide(offset);
+	}
+	return m_offset;
+}
+
+bool FileStream::slide(unsigned __int64 offset)
+{
+	if(m_view && offset>=m_viewBase && offset<m_viewBase+m_viewSize)
+	{
+		m_offset=static_cast<size_t>(offset-m_viewBase);
+		return true;
+	}
+	if(offset>=m_mappedCapacity)
+		return false;
+	unmapWindow();
+
+	unsigned __int64 granularity=System::GetSystemInfo().dwAllocationGranularity;
+	unsigned __int64 viewBase=offset-offset%granularity;
+	unsigned __int64 viewSize=m_mappedCapacity-viewBase;
+	if(m_windowSize && viewSize>m_windowSize)
+		viewSize=m_windowSize;
+	DWORD access=(m_mapType==FILE_STREAM_MAP_TYPE_READ_WRITE)?FILE_MAP_WRITE:FILE_MAP_READ;
+	m_view=reinterpret_cast<unsigned char*>(MapViewOfFile(m_mappingHandle,access,static_cast<DWORD>(viewBase>>32),static_cast<DWORD>(viewBase&0xFFFFFFFF),static_cast<SIZE_T>(viewSize)));
+	if(!m_view)
+		return false;
+	m_viewBase=viewBase;
+	m_viewSize=static_cast<size_t>(viewSize);
+	m_offset=static_cast<size_t>(offset-viewBase);
+	borrowWindow();
+	return true;
+}
+
+bool FileStream::growMapping(unsigned __int64 byteSize)
+{
+	// double the mapping as the stream buffer does, and trim the file when closed.
+	unsigned __int64 capacity=m_mappedCapacity*2;
+	if(capacity<byteSize)
+		capacity=byteSize;
+	unmapWindow();
+	if(m_mappingHandle)
+		CloseHandle(m_mappingHandle);
+	m_mappingHandle=CreateFileMapping(m_fileHandle,NULL,PAGE_READWRITE,static_cast<DWORD>(capacity>>32),static_cast<DWORD>(capacity&0xFFFFFFFF),NULL);
+	if(!m_mappingHandle)
+	{
+		if(m_mappedCapacity)
+			m_mappingHandle=CreateFileMapping(m_fileHandle,NULL,PAGE_READWRITE,static_cast<DWORD>(m_mappedCapacity>>32),static_cast<DWORD>(m_mappedCapacity&0xFFFFFFFF),NULL);
+		if(!m_mappingHandle)
+			m_mappedCapacity=0;
+		return false;
+	}
+	m_mappedCapacity=capacity;
+	return true;
+}
+
+void FileStream::borrowWindow()
+{
+	size_t validSize=0;
+	if(m_mappedSize>m_viewBase)
+	{
+		validSize=m_viewSize;
+		if(m_mappedSize-m_viewBase<validSize)
+			validSize=static_cast<size_t>(m_mappedSize-m_viewBase);
+	}
+	m_stream.Borrow(m_view,validSize);
+}
+
+void FileStream::unmapWindow()
+{
+	if(m_view)
+		UnmapViewOfFile(m_view);
+	m_view=NULL;
+	m_viewSize=0;
+	m_stream.Clear();
+}
+
+void FileStream::closeMapping()
+{
+	if(m_fileHandle==INVALID_HANDLE_VALUE)
+		return;
+	unmapWindow();
+	if(m_mappingHandle)
+		CloseHandle(m_mappingHandle);
+	if(m_mapType==FILE_STREAM_MAP_TYPE_READ_WRITE && m_mappedCapacity>m_mappedSize)
+	{
+		LARGE_INTEGER fileSize;
+		fileSize.QuadPart=static_cast<LONGLONG>(m_mappedSize);
+		if(SetFilePointerEx(m_fileHandle,fileSize,NULL,FILE_BEGIN))
+			SetEndOfFile(m_fileHandle);
+	}
+	CloseHandle(m_fileHandle);
+	m_fileHandle=INVALID_HANDLE_VALUE;
+	m_mappingHandle=NULL;
+	m_viewBase=0;
+	m_mappedSize=0;
+	m_mappedCapacity=0;
+	m_offset=0;
+}
+
+bool FileStream::OpenChunkedStream(FileStreamChunkType chunkType, size_t chunkSize, bool isUnbuffered)
+{
+	StreamLockObj lock(this);
+	closeMapping();
+	closeChunked();
+	m_stream.Clear();
+	m_offset=0;
+
+	if(m_fileName.length()==0)
+	{
+		LOG_THIS_MSG(_T("File Name Not Set!"));
+		return false;
+	}
+	if(chunkSize==0)
+		chunkSize=FILE_STREAM_CHUNK_SIZE;
+	// the unbuffered I/O must start at and span the whole sectors.
+	DWORD bufferFlag=0;
+	if(isUnbuffered)
+	{
+		chunkSize=(chunkSize+FILE_STREAM_SECTOR_SIZE-1)/FILE_STREAM_SECTOR_SIZE*FILE_STREAM_SECTOR_SIZE;
+		bufferFlag=FILE_FLAG_NO_BUFFERING;
+	}
+	if(chunkType==FILE_STREAM_CHUNK_TYPE_WRITE)
+		m_chunkHandle=CreateFile(m_fileName.c_str(),GENERIC_WRITE,0,NULL,CREATE_ALWAYS,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_OVERLAPPED|bufferFlag,NULL);
+	else
+		m_chunkHandle=CreateFile(m_fileName.c_str(),GENERIC_READ,FILE_SHARE_READ,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_OVERLAPPED|FILE_FLAG_SEQUENTIAL_SCAN|bufferFlag,NULL);
+	if(m_chunkHandle==INVALID_HANDLE_VALUE)
+	{
+		LOG_THIS_MSG(_T("Cannot open the file as the chunked stream!"));
+		return false;
+	}
+	System::Memset(&m_overlapped,0,sizeof(OVERLAPPED));
+	m_overlapped.hEvent=CreateEvent(NULL,TRUE,FALSE,NULL);
+	m_isUnbuffered=isUnbuffered;
+	if(!m_overlapped.hEvent || !allocChunk(chunkSize) || !m_stream.Reserve(chunkSize*2))
+	{
+		closeChunked();
+		LOG_THIS_MSG(_T("Cannot allocate the chunked stream!"));
+		return false;
+	}
+	m_chunkType=chunkType;
+	m_chunkSize=chunkSize;
+	if(m_chunkType==FILE_STREAM_CHUNK_TYPE_READ)
+		readAhead();
+	return true;
+}
+
+void FileStream::CloseChunkedStream()
+{
+	StreamLockObj lock(this);
+	closeChunked();
+}
+
+bool FileStream::IsChunked() const
+{
+	return m_chunkHandle!=INVALID_HANDLE_VALUE;
+}
+
+unsigned __int64 FileStream::GetChunkedSeek() const
+{
+	return m_chunkBase+m_offset;
+}
+
+bool FileStream::allocChunk(size_t byteSize)
+{
+	if(m_pendingMemory)
+		EP_FreeTag(m_pendingMemory,MEMORY_TAG_STREAM);
+	m_pendingChunk=NULL;
+	m_pendingCapacity=0;
+	size_t alignment=m_isUnbuffered?FILE_STREAM_SECTOR_SIZE:1;
+	m_pendingMemory=EP_MallocTag(byteSize+alignment-1,MEMORY_TAG_STREAM);
+	if(!m_pendingMemory)
+		return false;
+	m_pendingChunk=reinterpret_cast<unsigned char*>((reinterpret_cast<size_t>(m_pendingMemory)+alignment-1)&~(alignment-1));
+	m_pendingCapacity=byteSize;
+	return true;
+}
+
+void FileStream::readAhead()
+{
+	// the unbuffered read after the partial sector is at the end of the file, and cannot start off the sector.
+	if(m_isUnbuffered && m_chunkOffset%FILE_STREAM_SECTOR_SIZE)
+		return;
+	m_overlapped.Offset=static_cast<DWORD>(m_chunkOffset&0xFFFFFFFF);
+	m_overlapped.OffsetHigh=static_cast<DWORD>(m_chunkOffset>>32);
+	// the read over the end of the file fails at once with ERROR_HANDLE_EOF, and nothing is pending.
+	if(ReadFile(m_chunkHandle,m_pendingChunk,static_cast<DWORD>(m_chunkSize),NULL,&m_overlapped) || GetLastError()==ERROR_IO_PENDING)
+		m_isPending=true;
+}
+
+bool FileStream::appendChunk()
+{
+	if(!m_isPending)
+		return false;
+	DWORD readSize=waitChunk();
+	if(readSize==0)
+		return false;
+
+	// drop the bytes already read, and append the chunk after the rest.
+	size_t restSize=0;
+	if(m_offset<m_stream.GetSize())
+	{
+		restSize=m_stream.GetSize()-m_offset;
+		memmove(m_stream.GetData(),m_stream.GetData()+m_offset,restSize);
+	}
+	m_chunkBase+=m_offset;
+	m_offset=0;
+	if(!m_stream.ResizeUninitialized(restSize+readSize))
+		return false;
+	System::Memcpy(m_stream.GetData()+restSize,m_pendingChunk,readSize);
+	m_chunkOffset+=readSize;
+	readAhead();
+	return true;
+}
+
+bool FileStream::writeBehind(bool isLast)
+{
+	// the buffer is reused after the previous write is done.
+	waitChunk();
+	size_t writeSize=m_stream.GetSize();
+	size_t ioSize=writeSize;
+	if(m_isUnbuffered)
+	{
+		// the partial sector waits for the next data, or is padded at the end of the file.
+		if(isLast)
+			ioSize=(writeSize+FILE_STREAM_SECTOR_SIZE-1)/FILE_STREAM_SECTOR_SIZE*FILE_STREAM_SECTOR_SIZE;
+		else
+		{
+			writeSize-=writeSize%FILE_STREAM_SECTOR_SIZE;
+			ioSize=writeSize;
+		}
+	}
+	if(writeSize==0)
+		return true;
+	if(ioSize>m_pendingCapacity && !allocChunk(ioSize))
+		return false;
+	System::Memcpy(m_pendingChunk,m_stream.GetData(),writeSize);
+	if(ioSize>writeSize)
+		System::Memset(m_pendingChunk+writeSize,0,ioSize-writeSize);
+	m_overlapped.Offset=static_cast<DWORD>(m_chunkOffset&0xFFFFFFFF);
+	m_overlapped.OffsetHigh=static_cast<DWORD>(m_chunkOffset>>32);
+	if(!WriteFile(m_chunkHandle,m_pendingChunk,static_cast<DWORD>(ioSize),NULL,&m_overlapped) && GetLastError()!=ERROR_IO_PENDING)
+	{
+		LOG_THIS_MSG(_T("Cannot write the chunk behind!"));
+		return false;
+	}
+	m_isPending=true;
+	m_chunkOffset+=ioSize;
+	m_chunkBase+=writeSize;
+	size_t restSize=m_stream.GetSize()-writeSize;
+	if(restSize)
+		memmove(m_stream.GetData(),m_stream.GetData()+writeSize,restSize);
+	m_stream.ResizeUninitialized(restSize);
+	m_offset=restSize;
+	return true;
+}
+
+DWORD FileStream::waitChunk()
+{
+	if(!m_isPending)
+		return 0;
+	m_isPending=false;
+	DWORD transferredSize=0;
+	if(!GetOverlappedResult(m_chunkHandle,&m_overlapped,&transferredSize,TRUE))
+		return 0;
+	return transferredSize;
+}
+
+void FileStream::closeChunked()
+{
+	if(m_chunkHandle==INVALID_HANDLE_VALUE)
+		return;
+	if(m_chunkType==FILE_STREAM_CHUNK_TYPE_WRITE)
+		writeBehind(true);
+	// the buffer cannot be freed while the I/O is pending.
+	waitChunk();
+	if(m_chunkType==FILE_STREAM_CHUNK_TYPE_WRITE && m_chunkOffset>m_chunkBase)
+	{
+		// cut the padding of the last sector off.
+		LARGE_INTEGER fileSize;
+		fileSize.QuadPart=static_cast<LONGLONG>(m_chunkBase);
+		if(!SetFilePointerEx(m_chunkHandle,fileSize,NULL,FILE_BEGIN) || !SetEndOfFile(m_chunkHandle))
+			LOG_THIS_MSG(_T("Cannot cut the padding of the unbuffered stream!"));
+	}
+	if(m_overlapped.hEvent)
+		CloseHandle(m_overlapped.hEvent);
+	CloseHandle(m_chunkHandle);
+	if(m_pendingMemory)
+		EP_FreeTag(m_pendingMemory,MEMORY_TAG_STREAM);
+	m_chunkHandle=INVALID_HANDLE_VALUE;
+	m_isUnbuffered=false;
+	m_pendingMemory=NULL;
+	m_pendingChunk=NULL;
+	m_pendingCapacity=0;
+	m_chunkOffset=0;
+	m_chunkBase=0;
+	m_stream.Clear();
+	m_offset=0;
+}
+
 bool FileStream::write(const void *value,size_t byteSize)
 {
 	if(!value)
 		return false;
-	if(m_stream.size()<m_offset+byteSize)
+	if(m_fileHandle!=INVALID_HANDLE_VALUE)
 	{
-		m_stream.resize(m_offset+byteSize);
+		if(m_mapType!=FILE_STREAM_MAP_TYPE_READ_WRITE)
+			return false;
+		unsigned __int64 offset=m_viewBase+m_offset;
+		if(offset+byteSize>m_mappedCapacity && !growMapping(offset+byteSize))
+			return false;
+		const unsigned char *source=reinterpret_cast<const unsigned char*>(value);
+		while(byteSize)
+		{
+			if(!slide(offset))
+				return false;
+			size_t copySize=m_viewSize-m_offset;
+			if(copySize>byteSize)
+				copySize=byteSize;
+			System::Memcpy(m_view+m_offset,source,copySize);
+			source+=copySize;
+			offset+=copySize;
+			byteSize-=copySize;
+			m_offset+=copySize;
+		}
+		if(offset>m_mappedSize)
+		{
+			m_mappedSize=offset;
+			borrowWindow();
+		}
+		return true;
 	}
-	System::Memcpy(&m_stream.at(m_offset), value, byteSize);
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE && m_chunkType!=FILE_STREAM_CHUNK_TYPE_WRITE)
+		return false;
+	if(!extend(byteSize))
+		return false;
+	System::Memcpy(m_stream.GetData()+m_offset, value, byteSize);
 	m_offset+=byteSize;
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE && m_stream.GetSize()>=m_chunkSize)
+		return writeBehind();
 
 	return true;
 }
 
 bool FileStream::read(void *value,size_t byteSize)
 {
-	if(m_stream.empty() || !value)
+	if(m_fileHandle!=INVALID_HANDLE_VALUE)
+	{
+		unsigned __int64 offset=m_viewBase+m_offset;
+		if(!value || offset+byteSize>m_mappedSize)
+			return false;
+		unsigned char *dest=reinterpret_cast<unsigned char*>(value);
+		while(byteSize)
+		{
+			if(!slide(offset))
+				return false;
+			size_t copySize=m_viewSize-m_offset;
+			if(copySize>byteSize)
+				copySize=byteSize;
+			System::Memcpy(dest,m_view+m_offset,copySize);
+			dest+=copySize;
+			offset+=copySize;
+			byteSize-=copySize;
+			m_offset+=copySize;
+		}
+		return true;
+	}
+	if(m_chunkHandle!=INVALID_HANDLE_VALUE)
+	{
+		if(m_chunkType!=FILE_STREAM_CHUNK_TYPE_READ || !value)
+			return false;
+		while(m_stream.GetSize()-m_offset<byteSize)
+		{
+			if(!appendChunk())
+				return false;
+		}
+		System::Memcpy(value,m_stream.GetData()+m_offset,byteSize);
+		m_offset+=byteSize;
+		return true;
+	}
+
+	if(m_stream.IsEmpty() || !value)
 		return false;
 
-	if(m_stream.size()>m_offset+byteSize)
+	if(m_stream.GetSize()>=m_offset+byteSize)
 	{
-		System::Memcpy(value,&m_stream.at(m_offset) , byteSize);
+		System::Memcpy(value,m_stream.GetData()+m_offset , byteSize);
 		m_offset+=byteSize;
 		return true;
 	}
@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epFolderHelper.h"
+#include "epParallel.h"
 #include <Shlwapi.h>
 #include <io.h>
 
@@ -72,39 +73,373 @@ bool FolderHelper::ChooseFolder(HWND hParent, const TCHAR * title, EpTString &re
 	return success;
 }
 
-void FolderHelper::removeDir( const TCHAR * strPath)  
+/*!
+@struct FolderListing epFolderHelper.cpp
+@brief The files and the folders directly under one folder.
+*/
+struct FolderListing
+{
+	/// the full paths of the files
+	std::vector<EpTString> fileList;
+	/// the byte sizes of the files
+	std::vector<unsigned __int64> fileSizeList;
+	/// the full paths of the folders ending with "\"
+	std::vector<EpTString> folderList;
+	/// the full paths of the junctions and the symbolic links to the folders ending with "\", which are not followed
+	std::vector<EpTString> linkList;
+};
+
+/*!
+List the files and the folders directly under given folder.
+@param[in] folderPath the folder path to list ending with "\"
+@param[out] retListing the files and the folders found
+*/
+static void listFolder(const EpTString &folderPath, FolderListing &retListing)
+{
+	EpTString pattern=folderPath;
+	pattern.append(_T("*"));
+	WIN32_FIND_DATA findData;
+#if (_MSC_VER>=MSVC100) && (WINVER>=WINDOWS_7)
+	// the short names are not needed, and the larger buffer saves the calls into the file system per entry
+	HANDLE findHandle=FindFirstFileEx(pattern.c_str(),FindExInfoBasic,&findData,FindExSearchNameMatch,NULL,FIND_FIRST_EX_LARGE_FETCH);
+#else //(_MSC_VER>=MSVC100) && (WINVER>=WINDOWS_7)
+	HANDLE findHandle=FindFirstFileEx(pattern.c_str(),FindExInfoStandard,&findData,FindExSearchNameMatch,NULL,0);
+#endif //(_MSC_VER>=MSVC100) && (WINVER>=WINDOWS_7)
+	if(findHandle==INVALID_HANDLE_VALUE)
+		return;
+	do
+	{
+		const TCHAR *name=findData.cFileName;
+		if(name[0]==_T('.') && (name[1]==_T('\0') || (name[1]==_T('.') && name[2]==_T('\0'))))
+			continue;
+		EpTString path=folderPath;
+		path.append(name);
+		if(findData.dwFileAttributes&FILE_ATTRIBUTE_DIRECTORY)
+		{
+			path.append(_T("\\"));
+			if(findData.dwFileAttributes&FILE_ATTRIBUTE_REPARSE_POINT)
+				retListing.linkList.push_back(path);
+			else
+				retListing.folderList.push_back(path);
+		}
+		else
+		{
+			retListing.fileList.push_back(path);
+			retListing.fileSizeList.push_back((static_cast<unsigned __int64>(findData.nFileSizeHigh)<<32)|static_cast<unsigned __int64>(findData.nFileSizeLow));
+		}
+	}while(FindNextFile(findHandle,&findData));
+	FindClose(findHandle);
+}
+
+/*!
+@class FolderListFunc epFolderHelper.cpp
+@brief A functor which lists the folders of one depth for ParallelFor.
+*/
+class FolderListFunc
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the functor
+	@param[in] folderList the folders to list
+	@param[out] retListingList the listing of each folder
+	*/
+	FolderListFunc(const std::vector<EpTString> *folderList, std::vector<FolderListing> *retListingList)
+	{
+		m_folderList=folderList;
+		m_listingList=retListingList;
+	}
+
+	/*!
+	List the given folders.
+	@param[in] folderBegin the first folder.
+	@param[in] folderEnd the folder after the last.
+	*/
+	void operator()(size_t folderBegin, size_t folderEnd) const
+	{
+		for(size_t folderTrav=folderBegin;folderTrav<folderEnd;folderTrav++)
+			listFolder((*m_folderList)[folderTrav],(*m_listingList)[folderTrav]);
+	}
+
+private:
+	/// the folders to list
+	const std::vector<EpTString> *m_folderList;
+	/// the listing of each folder
+	std::vector<FolderListing> *m_listingList;
+};
+
+/*!
+Delete given file, clearing its read-only attribute if needed.
+@param[in] filePath the file path to delete
+@return true if deleted, otherwise false
+*/
+static bool deleteFile(const EpTString &filePath)
+{
+	if(DeleteFile(filePath.c_str()))
+		return true;
+	if(GetLastError()!=ERROR_ACCESS_DENIED)
+		return false;
+	SetFileAttributes(filePath.c_str(),FILE_ATTRIBUTE_NORMAL);
+	return DeleteFile(filePath.c_str())!=FALSE;
+}
+
+/*!
+@class FileDeleteFunc epFolderHelper.cpp
+@brief A functor which deletes the batches of the files for ParallelFor.
+*/
+class FileDeleteFunc
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the functor
+	@param[in] fileList the files to delete
+	*/
+	FileDeleteFunc(const std::vector<EpTString> *fileList)
+	{
+		m_fileList=fileList;
+	}
+
+	/*!
+	Delete the given files.
+	@param[in] fileBegin the first file.
+	@param[in] fileEnd the file after the last.
+	*/
+	void operator()(size_t fileBegin, size_t fileEnd) const
+	{
+		for(size_t fileTrav=fileBegin;fileTrav<fileEnd;fileTrav++)
+			deleteFile((*m_fileList)[fileTrav]);
+	}
 
-{  
+private:
+	/// the files to delete
+	const std::vector<EpTString> *m_fileList;
+};
 
-	CFileFind searchFile;  
-	EpTString strFile;  
-	long bRet;  
-	EpTString inputPath=strPath;
-	if(_taccess(inputPath.c_str(),00) != 0)
-		return;  
+/*!
+@class FolderRemoveFunc epFolderHelper.cpp
+@brief A functor which removes the empty folders of one depth for ParallelFor.
+*/
+class FolderRemoveFunc
+{
+public:
+	/*!
+	Default Constructor
 
-	strFile.append(inputPath);
-	strFile.append(_T("*.*"));  
+	Initializes the functor
+	@param[in] folderList the folders to remove
+	*/
+	FolderRemoveFunc(const std::vector<EpTString> *folderList)
+	{
+		m_folderList=folderList;
+	}
+
+	/*!
+	Remove the given folders.
+	@param[in] folderBegin the first folder.
+	@param[in] folderEnd the folder after the last.
+	*/
+	void operator()(size_t folderBegin, size_t folderEnd) const
+	{
+		for(size_t folderTrav=folderBegin;folderTrav<folderEnd;folderTrav++)
+			RemoveDirectory((*m_folderList)[folderTrav].c_str());
+	}
+
+private:
+	/// the folders to remove
+	const std::vector<EpTString> *m_folderList;
+};
+
+/*!
+Copy the source file to the destination file, without the system cache if large.
+@param[in] fromFile the source file path
+@param[in] toFile the destination file path
+@param[in] failIfExist if this is true and the destination file exist then fail copy
+@param[in] fileSize the byte size of the source file
+@return true if the copied successfully, otherwise false
+*/
+static bool copyFile(const TCHAR *fromFile, const TCHAR *toFile, bool failIfExist, unsigned __int64 fileSize)
+{
+	DWORD copyFlags=failIfExist?COPY_FILE_FAIL_IF_EXISTS:0;
+#if defined(COPY_FILE_NO_BUFFERING)
+	// the large files would only evict the cache, as they are not read again soon
+	if(fileSize>=FOLDER_HELPER_UNBUFFERED_COPY_SIZE)
+		copyFlags|=COPY_FILE_NO_BUFFERING;
+#endif //defined(COPY_FILE_NO_BUFFERING)
+	return CopyFileEx(fromFile,toFile,NULL,NULL,NULL,copyFlags)!=FALSE;
+}
+
+/*!
+@class FileCopyFunc epFolderHelper.cpp
+@brief A functor which copies the batches of the files for ParallelFor.
+*/
+class FileCopyFunc
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the functor
+	@param[in] fileList the source files to copy
+	@param[in] fileSizeList the byte sizes of the source files
+	@param[in] fromPathLength the length of the source folder path, which is replaced
+	@param[in] toPath the destination folder path ending with "\"
+	@param[in] failIfExist if this is true and a destination file exist then fail to copy that file
+	@param[out] retFailCount the number of the files failed to copy
+	*/
+	FileCopyFunc(const std::vector<EpTString> *fileList, const std::vector<unsigned __int64> *fileSizeList, size_t fromPathLength, const EpTString *toPath, bool failIfExist, volatile long *retFailCount)
+	{
+		m_fileList=fileList;
+		m_fileSizeList=fileSizeList;
+		m_fromPathLength=fromPathLength;
+		m_toPath=toPath;
+		m_failIfExist=failIfExist;
+		m_failCount=retFailCount;
+	}
 
-	bRet = searchFile.FindFile(strFile.c_str());  
+	/*!
+	Copy the given files.
+	@param[in] fileBegin the first file.
+	@param[in] fileEnd the file after the last.
+	*/
+	void operator()(size_t fileBegin, size_t fileEnd) const
+	{
+		EpTString toFile;
+		for(size_t fileTrav=fileBegin;fileTrav<fileEnd;fileTrav++)
+		{
+			const EpTString &fromFile=(*m_fileList)[fileTrav];
+			toFile=*m_toPath;
+			toFile.append(fromFile,m_fromPathLength,EpTString::npos);
+			if(!copyFile(fromFile.c_str(),toFile.c_str(),m_failIfExist,(*m_fileSizeList)[fileTrav]))
+				InterlockedIncrement(m_failCount);
+		}
+	}
 
-	while(bRet)  
-	{  
-		bRet = searchFile.FindNextFile();  
-		if(searchFile.IsDots())  
-			continue;  
+private:
+	/// the source files to copy
+	const std::vector<EpTString> *m_fileList;
+	/// the byte sizes of the source files
+	const std::vector<unsigned __int64> *m_fileSizeList;
+	/// the length of the source folder path
+	size_t m_fromPathLength;
+	/// the destination folder path
+	const EpTString *m_toPath;
+	/// the flag whether to fail if a destination file exists
+	bool m_failIfExist;
+	/// the number of the files failed to copy
+	volatile long *m_failCount;
+};
+
+/*!
+@class FolderCreateFunc epFolderHelper.cpp
+@brief A functor which creates the destination folders of one depth for ParallelFor.
+*/
+class FolderCreateFunc
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the functor
+	@param[in] folderList the source folders
+	@param[in] fromPathLength the length of the source folder path, which is replaced
+	@param[in] toPath the destination folder path ending with "\"
+	*/
+	FolderCreateFunc(const std::vector<EpTString> *folderList, size_t fromPathLength, const EpTString *toPath)
+	{
+		m_folderList=folderList;
+		m_fromPathLength=fromPathLength;
+		m_toPath=toPath;
+	}
 
-		if(searchFile.IsDirectory())  
+	/*!
+	Create the given folders.
+	@param[in] folderBegin the first folder.
+	@param[in] folderEnd the folder after the last.
+	*/
+	void operator()(size_t folderBegin, size_t folderEnd) const
+	{
+		EpTString toFolder;
+		for(size_t folderTrav=folderBegin;folderTrav<folderEnd;folderTrav++)
 		{
-			EpTString deleteFolder=searchFile.GetFilePath().GetString();
-			deleteFolder.append(_T("\\"));
-			removeDir(deleteFolder.c_str());  
+			toFolder=*m_toPath;
+			toFolder.append((*m_folderList)[folderTrav],m_fromPathLength,EpTString::npos);
+			CreateDirectory(toFolder.c_str(),NULL);
+		}
+	}
 
+private:
+	/// the source folders
+	const std::vector<EpTString> *m_folderList;
+	/// the length of the source folder path
+	size_t m_fromPathLength;
+	/// the destination folder path
+	const EpTString *m_toPath;
+};
+
+/*!
+Return given path ending with "\".
+@param[in] strPath the path to append
+@return the path ending with "\"
+*/
+static EpTString toFolderPath(const TCHAR *strPath)
+{
+	EpTString path=strPath;
+	path=Locale::Trim(path);
+	if(path.length() && path.at(path.length()-1)!=_T('\\'))
+		path.append(_T("\\"));
+	return path;
+}
+
+void FolderHelper::scanTree(const EpTString &strPath, std::vector<EpTString> &retFileList, std::vector<unsigned __int64> &retFileSizeList, std::vector<std::vector<EpTString> > &retFolderLevelList, ThreadPool *pool)
+{
+	retFileList.clear();
+	retFileSizeList.clear();
+	retFolderLevelList.clear();
+	std::vector<EpTString> folderList(1,strPath);
+	// each depth is listed in parallel, so no folder waits for its sibling
+	while(folderList.size())
+	{
+		std::vector<FolderListing> listingList(folderList.size());
+		ParallelFor(folderList.size()>1?pool:NULL,0,folderList.size(),1,FolderListFunc(&folderList,&listingList));
+
+		std::vector<EpTString> nextFolderList;
+		std::vector<EpTString> levelFolderList;
+		for(size_t listingTrav=0;listingTrav<listingList.size();listingTrav++)
+		{
+			FolderListing &listing=listingList[listingTrav];
+			retFileList.insert(retFileList.end(),listing.fileList.begin(),listing.fileList.end());
+			retFileSizeList.insert(retFileSizeList.end(),listing.fileSizeList.begin(),listing.fileSizeList.end());
+			nextFolderList.insert(nextFolderList.end(),listing.folderList.begin(),listing.folderList.end());
+			levelFolderList.insert(levelFolderList.end(),listing.folderList.begin(),listing.folderList.end());
+			// the links are removed or created as they are, but not followed
+			levelFolderList.insert(levelFolderList.end(),listing.linkList.begin(),listing.linkList.end());
 		}
-		else  
-			DeleteFile(searchFile.GetFilePath());  
-	}  
-	RemoveDirectory(searchFile.GetFilePath());
+		if(levelFolderList.size())
+			retFolderLevelList.push_back(levelFolderList);
+		folderList.swap(nextFolderList);
+	}
+}
+
+void FolderHelper::removeDir( const TCHAR * strPath, ThreadPool *pool)
+{
+	if(_taccess(strPath,00) != 0)
+		return;
+	std::vector<EpTString> fileList;
+	std::vector<unsigned __int64> fileSizeList;
+	std::vector<std::vector<EpTString> > folderLevelList;
+	scanTree(strPath,fileList,fileSizeList,folderLevelList,pool);
+
+	ParallelFor(fileList.size()>FOLDER_HELPER_BATCH_SIZE?pool:NULL,0,fileList.size(),FOLDER_HELPER_BATCH_SIZE,FileDeleteFunc(&fileList));
+	// the folders are emptied from the deepest, so every folder is empty when removed
+	for(size_t levelTrav=folderLevelList.size();levelTrav>0;levelTrav--)
+	{
+		const std::vector<EpTString> &folderList=folderLevelList[levelTrav-1];
+		ParallelFor(folderList.size()>1?pool:NULL,0,folderList.size(),FOLDER_HELPER_BATCH_SIZE,FolderRemoveFunc(&folderList));
+	}
+	RemoveDirectory(strPath);
 }
 bool FolderHelper::CreateFolder(const TCHAR * strPath)
 {
@@ -117,19 +452,50 @@ bool FolderHelper::CreateFolder(const TCHAR * strPath)
 	return false;
 }
 
-void FolderHelper::DeleteFolder(const TCHAR * strPath)
+void FolderHelper::DeleteFolder(const TCHAR * strPath, ThreadPool *pool)
 {
 	if(!System::TcsLen(strPath))
 		return;
-	EpTString path=strPath;
-	path=Locale::Trim(path);
-	size_t length=path.length();
-	if(path.at(length-1)!=_T('\\'))
+	EpTString path=toFolderPath(strPath);
+	if(!path.length())
+		return;
+	removeDir(path.c_str(),pool);
+
+}
+
+void FolderHelper::ScanFolder(const TCHAR *strPath, std::vector<EpTString> &retFileList, std::vector<EpTString> &retFolderList, ThreadPool *pool)
+{
+	retFolderList.clear();
+	std::vector<unsigned __int64> fileSizeList;
+	std::vector<std::vector<EpTString> > folderLevelList;
+	scanTree(toFolderPath(strPath),retFileList,fileSizeList,folderLevelList,pool);
+	for(size_t levelTrav=0;levelTrav<folderLevelList.size();levelTrav++)
+		retFolderList.insert(retFolderList.end(),folderLevelList[levelTrav].begin(),folderLevelList[levelTrav].end());
+}
+
+bool FolderHelper::CopyFolder(const TCHAR *strFromPath, const TCHAR *strToPath, bool failIfExist, ThreadPool *pool)
+{
+	EpTString fromPath=toFolderPath(strFromPath);
+	EpTString toPath=toFolderPath(strToPath);
+	if(!fromPath.length() || !toPath.length() || _taccess(fromPath.c_str(),00) != 0)
+		return false;
+	if(!IsPathExist(toPath.c_str()) && !CreateFolder(toPath.c_str()))
+		return false;
+
+	std::vector<EpTString> fileList;
+	std::vector<unsigned __int64> fileSizeList;
+	std::vector<std::vector<EpTString> > folderLevelList;
+	scanTree(fromPath,fileList,fileSizeList,folderLevelList,pool);
+
+	// the parents are created before their children, as each depth is created after the previous one
+	for(size_t levelTrav=0;levelTrav<folderLevelList.size();levelTrav++)
 	{
-		path.append(_T("\\"));
+		const std::vector<EpTString> &folderList=folderLevelList[levelTrav];
+		ParallelFor(folderList.size()>1?pool:NULL,0,folderList.size(),FOLDER_HELPER_BATCH_SIZE,FolderCreateFunc(&folderList,fromPath.length(),&toPath));
 	}
-	removeDir(path.c_str());
-
+	volatile long failCount=0;
+	ParallelFor(fileList.size()>1?pool:NULL,0,fileList.size(),FOLDER_HELPER_BATCH_SIZE,FileCopyFunc(&fileList,&fileSizeList,fromPath.length(),&toPath,failIfExist,&failCount));
+	return failCount==0;
 }
 
 bool FolderHelper::IsPathExist(const TCHAR * path)
@@ -150,9 +516,11 @@ bool FolderHelper::GetSpecialFolderPath(int csidl,bool isCreateIfNotExist,EpTStr
 
 bool FolderHelper::CopyFile(const TCHAR *strFromFile, const TCHAR * strToFile,bool failIfExist)
 {
-	if(::CopyFile(strFromFile,strToFile,failIfExist))
-		return true;
-	return false;
+	WIN32_FILE_ATTRIBUTE_DATA attributeData;
+	if(!GetFileAttributesEx(strFromFile,GetFileExInfoStandard,&attributeData))
+		return false;
+	unsigned __int64 fileSize=(static_cast<unsigned __int64>(attributeData.nFileSizeHigh)<<32)|static_cast<unsigned __int64>(attributeData.nFileSizeLow);
+	return copyFile(strFromFile,strToFile,failIfExist,fileSize);
 }
 
 size_t FolderHelper::GetActualFileLength(CFile &file)
@@ -0,0 +1,305 @@
+/*! 
+FrameBatch for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epFrameBatch.h"
+#include "epSystem.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+FrameBatch::FrameBatch(LockPolicy lockPolicyType)
+{
+	m_byteSize=0;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_batchLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_batchLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_batchLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_batchLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_batchLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_batchLock=NULL;
+		break;
+	}
+}
+
+FrameBatch::FrameBatch(const FrameBatch& b)
+{
+	LockObj lock(b.m_batchLock);
+	m_buffer=b.m_buffer;
+	m_frameList=b.m_frameList;
+	m_byteSize=b.m_byteSize;
+	m_lockPolicy=b.m_lockPolicy;
+	switch(m_lockPolicy)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_batchLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_batchLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_batchLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_batchLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_batchLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_batchLock=NULL;
+		break;
+	}
+}
+
+FrameBatch::~FrameBatch()
+{
+	if(m_batchLock)
+		EP_DELETE m_batchLock;
+}
+
+FrameBatch & FrameBatch::operator=(const FrameBatch&b)
+{
+	if(this!=&b)
+	{
+		LockObj lock(m_batchLock);
+		LockObj lockB(b.m_batchLock);
+		m_buffer=b.m_buffer;
+		m_frameList=b.m_frameList;
+		m_byteSize=b.m_byteSize;
+	}
+	return *this;
+}
+
+bool FrameBatch::AddFrame(const void *data, unsigned int dataByteSize)
+{
+	return addFrame(data,dataByteSize,false);
+}
+
+bool FrameBatch::AddFrameReference(const void *data, unsigned int dataByteSize)
+{
+	return addFrame(data,dataByteSize,dataByteSize>=FRAME_BATCH_COPY_THRESHOLD);
+}
+
+bool FrameBatch::addFrame(const void *data, unsigned int dataByteSize, bool isReferenced)
+{
+	if(!data && dataByteSize)
+		return false;
+
+	LockObj lock(m_batchLock);
+	Frame frame;
+	frame.m_offset=m_buffer.GetSize();
+	frame.m_byteSize=sizeof(unsigned int);
+	frame.m_reference=NULL;
+	frame.m_referenceSize=0;
+	if(isReferenced)
+	{
+		frame.m_reference=data;
+		frame.m_referenceSize=dataByteSize;
+	}
+	else
+		frame.m_byteSize+=dataByteSize;
+
+	if(!m_buffer.ResizeUninitialized(frame.m_offset+frame.m_byteSize))
+		return false;
+	unsigned char *dest=m_buffer.GetData()+frame.m_offset;
+	System::Memcpy(dest,&dataByteSize,sizeof(unsigned int));
+	if(!isReferenced && dataByteSize)
+		System::Memcpy(dest+sizeof(unsigned int),data,dataByteSize);
+
+	m_frameList.push_back(frame);
+	m_byteSize+=sizeof(unsigned int)+dataByteSize;
+	return true;
+}
+
+size_t FrameBatch::GetFrameCount() const
+{
+	return m_frameList.size();
+}
+
+size_t FrameBatch::GetByteSize() const
+{
+	return m_byteSize;
+}
+
+void FrameBatch::Clear()
+{
+	LockObj lock(m_batchLock);
+	m_buffer.Clear();
+	m_frameList.clear();
+	m_byteSize=0;
+}
+
+bool FrameBatch::gather(unsigned int maxWriteByteSize, std::vector<IpcWriteSegment> &retSegmentList, std::vector<unsigned int> &retWriteList) const
+{
+	unsigned int writeByteSize=0;
+	unsigned int writeSegmentCount=0;
+	const unsigned char *bufferEnd=NULL;
+	retSegmentList.reserve(m_frameList.size()*2);
+	for(size_t frameTrav=0;frameTrav<m_frameList.size();frameTrav++)
+	{
+		const Frame &frame=m_frameList[frameTrav];
+		if(frame.m_byteSize>maxWriteByteSize || frame.m_referenceSize>maxWriteByteSize-frame.m_byteSize)
+			return false;
+		unsigned int frameByteSize=frame.m_byteSize+frame.m_referenceSize;
+		if(frameByteSize>maxWriteByteSize-writeByteSize)
+		{
+			retWriteList.push_back(writeSegmentCount);
+			writeByteSize=0;
+			writeSegmentCount=0;
+			bufferEnd=NULL;
+		}
+
+		// the copied frames are contiguous within the buffer, so they are merged into one segment.
+		const unsigned char *bufferData=m_buffer.GetData()+frame.m_offset;
+		if(bufferEnd==bufferData)
+			retSegmentList.back().m_dataSize+=frame.m_byteSize;
+		else
+		{
+			IpcWriteSegment segment;
+			segment.m_data=bufferData;
+			segment.m_dataSize=frame.m_byteSize;
+			retSegmentList.push_back(segment);
+			writeSegmentCount++;
+		}
+		bufferEnd=bufferData+frame.m_byteSize;
+
+		if(frame.m_reference)
+		{
+			IpcWriteSegment segment;
+			segment.m_data=frame.m_reference;
+			segment.m_dataSize=frame.m_referenceSize;
+			retSegmentList.push_back(segment);
+			writeSegmentCount++;
+			bufferEnd=NULL;
+		}
+		writeByteSize+=frameByteSize;
+	}
+	if(writeSegmentCount)
+		retWriteList.push_back(writeSegmentCount);
+	return true;
+}
+
+bool FrameBatch::Flush(IpcInterface *pipe)
+{
+	EP_ASSERT_EXPR(pipe,_T("The pipe is NULL."));
+	LockObj lock(m_batchLock);
+	std::vector<IpcWriteSegment> segmentList;
+	std::vector<unsigned int> writeList;
+	if(!gather(pipe->GetMaxWriteDataByteSize(),segmentList,writeList))
+		return false;
+
+	size_t segmentIdx=0;
+	for(size_t writeTrav=0;writeTrav<writeList.size();writeTrav++)
+	{
+		pipe->Write(&segmentList[segmentIdx],writeList[writeTrav]);
+		segmentIdx+=writeList[writeTrav];
+	}
+	m_buffer.Clear();
+	m_frameList.clear();
+	m_byteSize=0;
+	return true;
+}
+
+bool FrameBatch::Flush(IpcClientInterface *client)
+{
+	EP_ASSERT_EXPR(client,_T("The client is NULL."));
+	LockObj lock(m_batchLock);
+	std::vector<IpcWriteSegment> segmentList;
+	std::vector<unsigned int> writeList;
+	if(!gather(client->GetMaxWriteDataByteSize(),segmentList,writeList))
+		return false;
+
+	size_t segmentIdx=0;
+	for(size_t writeTrav=0;writeTrav<writeList.size();writeTrav++)
+	{
+		client->Write(&segmentList[segmentIdx],writeList[writeTrav]);
+		segmentIdx+=writeList[writeTrav];
+	}
+	m_buffer.Clear();
+	m_frameList.clear();
+	m_byteSize=0;
+	return true;
+}
+
+bool FrameBatch::Flush(Stream &stream)
+{
+	LockObj lock(m_batchLock);
+	std::vector<IpcWriteSegment> segmentList;
+	std::vector<unsigned int> writeList;
+	// the stream has no limit of the write size, so the segments are written one after another.
+	if(!gather(0xFFFFFFFF,segmentList,writeList))
+		return false;
+
+	Stream::BatchLockObj streamLock(&stream);
+	for(size_t segmentTrav=0;segmentTrav<segmentList.size();segmentTrav++)
+	{
+		if(!stream.WriteBytes(reinterpret_cast<const unsigned char*>(segmentList[segmentTrav].m_data),segmentList[segmentTrav].m_dataSize))
+			return false;
+	}
+	m_buffer.Clear();
+	m_frameList.clear();
+	m_byteSize=0;
+	return true;
+}
+
+bool FrameBatch::ReadFrame(NetworkStream &stream, const unsigned char *&retFrame, unsigned int &retFrameByteSize)
+{
+	Stream::BatchLockObj lock(&stream);
+	// the prefix is read in place too, so the auto flush never erases the incomplete frame.
+	size_t readSeek=stream.GetReadSeek();
+	const unsigned char *prefix=stream.ReadInPlace(sizeof(unsigned int));
+	if(!prefix)
+		return false;
+	unsigned int frameByteSize=0;
+	System::Memcpy(&frameByteSize,prefix,sizeof(unsigned int));
+
+	const unsigned char *frame=stream.ReadInPlace(frameByteSize);
+	if(!frame)
+	{
+		stream.SetReadSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET,readSeek);
+		return false;
+	}
+	retFrame=frame;
+	retFrameByteSize=frameByteSize;
+	return true;
+}
\ No newline at end of file
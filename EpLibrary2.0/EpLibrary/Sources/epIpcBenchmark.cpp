@@ -0,0 +1,653 @@
+/*! 
+IpcBenchmark for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epIpcBenchmark.h"
+#include "epSystem.h"
+#include "epThread.h"
+#include "epEventEx.h"
+#include "epSemaphore.h"
+#include "epIpcServer.h"
+#include "epIpcClient.h"
+#include "epShmIpcServer.h"
+#include "epShmIpcClient.h"
+#include <vector>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the byte size of the smallest message measured
+#define IPC_BENCHMARK_MIN_MESSAGE_SIZE 16
+
+/// the byte size of the messages a writing client may have in flight
+#define IPC_BENCHMARK_WINDOW_BYTE_SIZE (512*1024)
+
+/// the maximum number of the messages a writing client may have in flight
+#define IPC_BENCHMARK_MAX_WINDOW_COUNT 64
+
+/// the byte size of the batched write of IPC_BENCHMARK_TRANSPORT_PIPE_BATCH
+#define IPC_BENCHMARK_WRITE_BATCH_BYTE_SIZE (64*1024)
+
+/// the time in milliseconds to wait for the connection, the reply or the window before the case is failed
+#define IPC_BENCHMARK_WAIT_TIME 10000
+
+/// the names of the transports measured
+static const TCHAR *s_transportNameList[IPC_BENCHMARK_TRANSPORT_COUNT]={_T("PIPE"),_T("COMPLETION_PORT"),_T("BATCH"),_T("SHM")};
+
+namespace epl
+{
+	/*!
+	@class IpcBenchmarkSession epIpcBenchmark.cpp
+	@brief A class for the server and the clients of one transport connected for the benchmark cases.
+
+	The server echoes each message back in the ping-pong session, and counts the messages otherwise.
+	*/
+	class IpcBenchmarkSession:public IpcServerCallbackInterface, public IpcClientCallbackInterface
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] transport the transport to measure.
+		@param[in] isEcho the flag whether the server echoes the messages back.
+		@param[in] messageSize the byte size of the message.
+		*/
+		IpcBenchmarkSession(IpcBenchmarkTransport transport, bool isEcho, unsigned int messageSize):m_replyEvent(false,false),m_doneEvent(false,true),m_window(getWindowCount(messageSize),getWindowCount(messageSize))
+		{
+			m_transport=transport;
+			m_isEcho=isEcho;
+			m_messageSize=messageSize;
+			m_server=NULL;
+			m_isFailed=false;
+			m_isClosing=false;
+			m_receivedCount=0;
+			m_expectedCount=0;
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcBenchmarkSession()
+		{
+			Close();
+		}
+
+		/*!
+		Start the server, and connect the clients to it.
+		@param[in] pipeName the name of the pipe to serve.
+		@param[in] clientCount the number of the clients.
+		@return true if the server is started and all clients are connected, otherwise false.
+		*/
+		bool Open(const TCHAR *pipeName, unsigned int clientCount)
+		{
+			m_pipeName=pipeName;
+			IpcServerOps serverOps;
+			serverOps.callBackObj=this;
+			serverOps.pipeName=const_cast<TCHAR*>(m_pipeName.c_str());
+			serverOps.maximumInstances=clientCount;
+			IpcClientOps clientOps;
+			clientOps.callBackObj=this;
+			clientOps.pipeName=const_cast<TCHAR*>(m_pipeName.c_str());
+
+			switch(m_transport)
+			{
+			case IPC_BENCHMARK_TRANSPORT_PIPE_BATCH:
+				serverOps.writeBatchByteSize=IPC_BENCHMARK_WRITE_BATCH_BYTE_SIZE;
+				clientOps.writeBatchByteSize=IPC_BENCHMARK_WRITE_BATCH_BYTE_SIZE;
+				serverOps.serverMode=IPC_SERVER_MODE_COMPLETION_PORT;
+				break;
+			case IPC_BENCHMARK_TRANSPORT_PIPE_COMPLETION_PORT:
+				serverOps.serverMode=IPC_SERVER_MODE_COMPLETION_PORT;
+				break;
+			case IPC_BENCHMARK_TRANSPORT_SHM:
+				// the ring holds the whole message, so the buffers are sized for it
+				serverOps.numOfReadBytes=serverOps.numOfWriteBytes=m_messageSize;
+				clientOps.numOfReadBytes=clientOps.numOfWriteBytes=m_messageSize;
+				break;
+			default:
+				break;
+			}
+
+			if(m_transport==IPC_BENCHMARK_TRANSPORT_SHM)
+				m_server=EP_NEW ShmIpcServer(LOCK_POLICY_CRITICALSECTION);
+			else
+				m_server=EP_NEW IpcServer(LOCK_POLICY_CRITICALSECTION);
+			if(!m_server->StartServer(serverOps))
+				return false;
+			for(unsigned int clientTrav=0;clientTrav<clientCount;clientTrav++)
+			{
+				IpcClientInterface *client;
+				if(m_transport==IPC_BENCHMARK_TRANSPORT_SHM)
+					client=EP_NEW ShmIpcClient(LOCK_POLICY_CRITICALSECTION);
+				else
+					client=EP_NEW IpcClient(LOCK_POLICY_CRITICALSECTION);
+				m_clientList.push_back(client);
+				if(client->Connect(clientOps,IPC_BENCHMARK_WAIT_TIME)!=CONNECT_STATUS_SUCCESS)
+					return false;
+			}
+			return true;
+		}
+
+		/*!
+		Disconnect the clients, and stop the server.
+		*/
+		void Close()
+		{
+			m_isClosing=true;
+			for(size_t clientTrav=0;clientTrav<m_clientList.size();clientTrav++)
+			{
+				m_clientList[clientTrav]->Disconnect();
+				EP_DELETE m_clientList[clientTrav];
+			}
+			m_clientList.clear();
+			if(m_server)
+			{
+				m_server->StopServer();
+				EP_DELETE m_server;
+				m_server=NULL;
+			}
+		}
+
+		/*!
+		Return the client connected.
+		@param[in] clientIdx the index of the client.
+		@return the client.
+		*/
+		IpcClientInterface *GetClient(size_t clientIdx)
+		{
+			return m_clientList[clientIdx];
+		}
+
+		/*!
+		Return the number of the clients connected.
+		@return the number of the clients.
+		*/
+		size_t GetClientCount() const
+		{
+			return m_clientList.size();
+		}
+
+		/*!
+		Return the byte size of the message.
+		@return the byte size of the message.
+		*/
+		unsigned int GetMessageSize() const
+		{
+			return m_messageSize;
+		}
+
+		/*!
+		Check if any read, write or wait failed.
+		@return true if failed, otherwise false.
+		*/
+		bool IsFailed() const
+		{
+			return m_isFailed;
+		}
+
+		/*!
+		Start counting the messages the server receives.
+		@param[in] expectedCount the number of the messages to wait for.
+		*/
+		void Begin(unsigned int expectedCount)
+		{
+			m_doneEvent.ResetEvent();
+			m_receivedCount=0;
+			m_expectedCount=static_cast<long>(expectedCount);
+		}
+
+		/*!
+		Write the message from the client once the window has room for it.
+		@param[in] client the client to write from.
+		@param[in] data the message.
+		@return true if the message is written, otherwise false.
+		*/
+		bool Write(IpcClientInterface *client, char *data)
+		{
+			if(m_isFailed)
+				return false;
+			if(!m_window.TryLockFor(IPC_BENCHMARK_WAIT_TIME))
+			{
+				fail();
+				return false;
+			}
+			client->Write(data,m_messageSize);
+			return !m_isFailed;
+		}
+
+		/*!
+		Write the message from the client, and wait for the server to echo it back.
+		@param[in] client the client to write from.
+		@param[in] data the message.
+		@return true if the message came back, otherwise false.
+		*/
+		bool Ping(IpcClientInterface *client, char *data)
+		{
+			if(m_isFailed)
+				return false;
+			client->Write(data,m_messageSize);
+			if(!m_replyEvent.WaitForEvent(IPC_BENCHMARK_WAIT_TIME))
+				fail();
+			return !m_isFailed;
+		}
+
+		/*!
+		Wait for the server to receive all messages given to Begin.
+		@return true if all messages are received, otherwise false.
+		*/
+		bool WaitForDone()
+		{
+			if(!m_doneEvent.WaitForEvent(IPC_BENCHMARK_WAIT_TIME))
+				fail();
+			return !m_isFailed;
+		}
+
+		/*!
+		Echo the message back, or count it.
+		@param[in] pipe the pipe which received the packet
+		@param[in] receivedData the received data
+		@param[in] receivedDataByteSize the received data byte size
+		@param[in] status the status of read
+		@param[in] errCode the error code
+		*/
+		virtual void OnReadComplete(IpcInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode)
+		{
+			if(status!=READ_STATUS_SUCCESS)
+			{
+				fail();
+				return;
+			}
+			if(m_isEcho)
+			{
+				pipe->Write(const_cast<char*>(receivedData),receivedDataByteSize);
+				return;
+			}
+			m_window.Release(1);
+			if(InterlockedIncrement(&m_receivedCount)==m_expectedCount)
+				m_doneEvent.SetEvent();
+		}
+
+		/*!
+		Fail the case if the echo is not written.
+		@param[in] pipe the pipe which wrote the packet
+		@param[in] writtenDataByteSize the byte size of data written
+		@param[in] status the status of write
+		@param[in] errCode the error code
+		*/
+		virtual void OnWriteComplete(IpcInterface *pipe,unsigned int writtenDataByteSize, WriteStatus status, unsigned long errCode)
+		{
+			if(status!=WRITE_STATUS_SUCCESS)
+				fail();
+		}
+
+		/*!
+		Wake up the client waiting for the echo.
+		@param[in] pipe the pipe which received the packet
+		@param[in] receivedData the received data
+		@param[in] receivedDataByteSize the received data byte size
+		@param[in] status the status of read
+		@param[in] errCode the error code
+		*/
+		virtual void OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode)
+		{
+			if(status!=READ_STATUS_SUCCESS)
+				fail();
+			else
+				m_replyEvent.SetEvent();
+		}
+
+		/*!
+		Fail the case if the message is not written.
+		@param[in] pipe the pipe which wrote the packet
+		@param[in] writtenDataByteSize the byte size of data written
+		@param[in] status the status of write
+		@param[in] errCode the error code
+		*/
+		virtual void OnWriteComplete(IpcClientInterface *pipe,unsigned int writtenDataByteSize, WriteStatus status, unsigned long errCode)
+		{
+			if(status!=WRITE_STATUS_SUCCESS)
+				fail();
+		}
+
+	private:
+		/*!
+		Default Copy Constructor
+
+		*Cannot be Used.
+		*/
+		IpcBenchmarkSession(const IpcBenchmarkSession & b):m_replyEvent(false,false),m_doneEvent(false,true){EP_ASSERT(0);}
+
+		/*!
+		Assignment operator overloading
+
+		*Cannot be Used.
+		@param[in] b the second object
+		@return the new copied object
+		*/
+		IpcBenchmarkSession &operator=(const IpcBenchmarkSession & b){EP_ASSERT(0);return *this;}
+
+		/*!
+		Return the number of the messages a writing client may have in flight.
+		@param[in] messageSize the byte size of the message.
+		@return the number of the messages.
+		@remark the window also keeps the shared memory ring, which holds at least two messages, from overflowing.
+		*/
+		static long getWindowCount(unsigned int messageSize)
+		{
+			long windowCount=static_cast<long>(IPC_BENCHMARK_WINDOW_BYTE_SIZE/messageSize);
+			if(windowCount<1)
+				windowCount=1;
+			if(windowCount>IPC_BENCHMARK_MAX_WINDOW_COUNT)
+				windowCount=IPC_BENCHMARK_MAX_WINDOW_COUNT;
+			return windowCount;
+		}
+
+		/*!
+		Mark the case failed, and wake up all waiting threads.
+		@remark the failures while closing are the disconnections, so they are ignored.
+		*/
+		void fail()
+		{
+			if(m_isClosing)
+				return;
+			m_isFailed=true;
+			m_replyEvent.SetEvent();
+			m_doneEvent.SetEvent();
+		}
+
+		/// the transport measured
+		IpcBenchmarkTransport m_transport;
+		/// the flag whether the server echoes the messages back
+		bool m_isEcho;
+		/// the byte size of the message
+		unsigned int m_messageSize;
+		/// the name of the pipe
+		EpTString m_pipeName;
+		/// the server
+		IpcServerInterface *m_server;
+		/// the clients
+		std::vector<IpcClientInterface*> m_clientList;
+		/// the event raised when the echo is received
+		EventEx m_replyEvent;
+		/// the event raised when the server received all messages expected
+		EventEx m_doneEvent;
+		/// the slots of the messages in flight
+		Semaphore m_window;
+		/// the flag whether any read, write or wait failed
+		volatile bool m_isFailed;
+		/// the flag whether the session is closing
+		volatile bool m_isClosing;
+		/// the number of the messages the server received
+		volatile long m_receivedCount;
+		/// the number of the messages to wait for
+		volatile long m_expectedCount;
+	};
+
+	/*!
+	@class IpcPingPongCase epIpcBenchmark.cpp
+	@brief A benchmark case writing one message and waiting for its echo per operation.
+	*/
+	class IpcPingPongCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the echoing session to measure.
+		*/
+		IpcPingPongCase(IpcBenchmarkSession &session):m_session(session),m_message(session.GetMessageSize())
+		{
+			for(size_t byteTrav=0;byteTrav<m_message.size();byteTrav++)
+				m_message[byteTrav]=static_cast<char>(byteTrav);
+		}
+
+		/*!
+		Reserve the round trip times for the measurement.
+		@param[in] iterationCount the number of the round trips.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_sampleList.clear();
+			m_sampleList.reserve(iterationCount);
+		}
+
+		/*!
+		Make the round trips, and record the time of each.
+		@param[in] iterationCount the number of the round trips.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			IpcClientInterface *client=m_session.GetClient(0);
+			for(unsigned int pingTrav=0;pingTrav<iterationCount;pingTrav++)
+			{
+				LARGE_INTEGER startTime=System::GetQueryPerformanceCounter();
+				if(!m_session.Ping(client,&m_message[0]))
+					break;
+				LARGE_INTEGER endTime=System::GetQueryPerformanceCounter();
+				m_sampleList.push_back(endTime.QuadPart-startTime.QuadPart);
+			}
+		}
+
+		/*!
+		Return the round trip times of the last measurement in the performance counter ticks.
+		@return the round trip times.
+		*/
+		std::vector<__int64> &GetSampleList()
+		{
+			return m_sampleList;
+		}
+
+	private:
+		/// the session measured
+		IpcBenchmarkSession &m_session;
+		/// the message written
+		std::vector<char> m_message;
+		/// the round trip times of the last measurement
+		std::vector<__int64> m_sampleList;
+	};
+
+	/*!
+	@class IpcStreamWriter epIpcBenchmark.cpp
+	@brief A thread writing the messages from one client of the fan-in benchmark.
+	*/
+	class IpcStreamWriter:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the session to write to.
+		@param[in] client the client to write from.
+		@param[in] message the message to write.
+		@param[in] messageCount the number of the messages to write.
+		*/
+		IpcStreamWriter(IpcBenchmarkSession &session, IpcClientInterface *client, char *message, unsigned int messageCount):Thread(),m_session(session)
+		{
+			m_client=client;
+			m_message=message;
+			m_messageCount=messageCount;
+		}
+
+	protected:
+		/*!
+		Write the messages.
+		*/
+		virtual void execute()
+		{
+			for(unsigned int messageTrav=0;messageTrav<m_messageCount;messageTrav++)
+			{
+				if(!m_session.Write(m_client,m_message))
+					break;
+			}
+		}
+
+	private:
+		/// the session to write to
+		IpcBenchmarkSession &m_session;
+		/// the client to write from
+		IpcClientInterface *m_client;
+		/// the message to write
+		char *m_message;
+		/// the number of the messages to write
+		unsigned int m_messageCount;
+	};
+
+	/*!
+	@class IpcStreamCase epIpcBenchmark.cpp
+	@brief A benchmark case writing one message to the server per operation, from all clients of the session.
+
+	With one client, the messages are written on the calling thread,
+	otherwise the operations are divided among the clients, each writing on its own thread.
+	*/
+	class IpcStreamCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the counting session to measure.
+		*/
+		IpcStreamCase(IpcBenchmarkSession &session):m_session(session),m_message(session.GetMessageSize())
+		{
+			for(size_t byteTrav=0;byteTrav<m_message.size();byteTrav++)
+				m_message[byteTrav]=static_cast<char>(byteTrav);
+		}
+
+		/*!
+		Write the messages, and wait for the server to receive all of them.
+		@param[in] iterationCount the number of the messages.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			m_session.Begin(iterationCount);
+			size_t clientCount=m_session.GetClientCount();
+			if(clientCount==1)
+			{
+				IpcClientInterface *client=m_session.GetClient(0);
+				for(unsigned int messageTrav=0;messageTrav<iterationCount;messageTrav++)
+				{
+					if(!m_session.Write(client,&m_message[0]))
+						return;
+				}
+			}
+			else
+			{
+				std::vector<IpcStreamWriter*> writerList;
+				for(size_t clientTrav=0;clientTrav<clientCount;clientTrav++)
+				{
+					// the remainder goes to the first clients, so the counts sum up to the operations
+					unsigned int messageCount=static_cast<unsigned int>(iterationCount/clientCount+(clientTrav<iterationCount%clientCount?1:0));
+					IpcStreamWriter *writer=EP_NEW IpcStreamWriter(m_session,m_session.GetClient(clientTrav),&m_message[0],messageCount);
+					writer->Start();
+					writerList.push_back(writer);
+				}
+				for(size_t writerTrav=0;writerTrav<writerList.size();writerTrav++)
+				{
+					writerList[writerTrav]->WaitFor();
+					EP_DELETE writerList[writerTrav];
+				}
+			}
+			m_session.WaitForDone();
+		}
+
+	private:
+		/// the session measured
+		IpcBenchmarkSession &m_session;
+		/// the message written
+		std::vector<char> m_message;
+	};
+}
+
+void IpcBenchmark::Run(const TCHAR *pipeName, unsigned int maxMessageSize, unsigned int clientCount, unsigned int minTime)
+{
+	for(int transportTrav=0;transportTrav<IPC_BENCHMARK_TRANSPORT_COUNT;transportTrav++)
+	{
+		IpcBenchmarkTransport transport=static_cast<IpcBenchmarkTransport>(transportTrav);
+		RunPingPong(transport,pipeName,maxMessageSize,minTime);
+		RunStreaming(transport,pipeName,maxMessageSize,minTime);
+		RunFanIn(transport,pipeName,maxMessageSize,clientCount,minTime);
+	}
+}
+
+void IpcBenchmark::RunPingPong(IpcBenchmarkTransport transport, const TCHAR *pipeName, unsigned int maxMessageSize, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(pipeName,_T("The pipe name is NULL."));
+	for(unsigned int messageSize=IPC_BENCHMARK_MIN_MESSAGE_SIZE;messageSize<=maxMessageSize;messageSize*=16)
+	{
+		IpcBenchmarkSession session(transport,true,messageSize);
+		// the transport which cannot be opened or fails is given up, as the larger messages would fail as well
+		if(!session.Open(pipeName,1))
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u"),s_transportNameList[transport],messageSize);
+		IpcPingPongCase pingPongCase(session);
+		// the message travels both ways in one operation
+		BENCHMARK_INSTANCE.Run(_T("Ipc"),_T("PingPong"),parameter.c_str(),pingPongCase,static_cast<size_t>(messageSize)*2,minTime);
+		if(session.IsFailed())
+			break;
+		BENCHMARK_INSTANCE.AddPercentiles(_T("Ipc"),_T("PingPong"),parameter.c_str(),pingPongCase.GetSampleList());
+		if(messageSize>maxMessageSize/16)
+			break;
+	}
+}
+
+void IpcBenchmark::RunStreaming(IpcBenchmarkTransport transport, const TCHAR *pipeName, unsigned int maxMessageSize, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(pipeName,_T("The pipe name is NULL."));
+	for(unsigned int messageSize=IPC_BENCHMARK_MIN_MESSAGE_SIZE;messageSize<=maxMessageSize;messageSize*=16)
+	{
+		IpcBenchmarkSession session(transport,false,messageSize);
+		if(!session.Open(pipeName,1))
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u"),s_transportNameList[transport],messageSize);
+		IpcStreamCase streamCase(session);
+		BENCHMARK_INSTANCE.Run(_T("Ipc"),_T("Streaming"),parameter.c_str(),streamCase,messageSize,minTime);
+		if(session.IsFailed())
+			break;
+		if(messageSize>maxMessageSize/16)
+			break;
+	}
+}
+
+void IpcBenchmark::RunFanIn(IpcBenchmarkTransport transport, const TCHAR *pipeName, unsigned int maxMessageSize, unsigned int clientCount, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(pipeName,_T("The pipe name is NULL."));
+	EP_ASSERT_EXPR(clientCount>0,_T("The client count is zero."));
+	for(unsigned int messageSize=IPC_BENCHMARK_MIN_MESSAGE_SIZE;messageSize<=maxMessageSize;messageSize*=16)
+	{
+		IpcBenchmarkSession session(transport,false,messageSize);
+		if(!session.Open(pipeName,clientCount))
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u/%u"),s_transportNameList[transport],messageSize,clientCount);
+		IpcStreamCase fanInCase(session);
+		BENCHMARK_INSTANCE.Run(_T("Ipc"),_T("FanIn"),parameter.c_str(),fanInCase,messageSize,minTime);
+		if(session.IsFailed())
+			break;
+		if(messageSize>maxMessageSize/16)
+			break;
+	}
+}
\ No newline at end of file
@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epIpcClient.h"
+#include "epWorkerMetrics.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -34,10 +35,12 @@ static char THIS_FILE[] = __FILE__;
 using namespace epl;
 
 
-IpcClient::IpcClient(epl::LockPolicy lockPolicyType)
+IpcClient::IpcClient(epl::LockPolicy lockPolicyType):m_metrics(lockPolicyType)
 {
 	m_lockPolicy=lockPolicyType;
-	m_readBuffer=NULL;
+	m_writeBufferPool=NULL;
+	m_bufferPoolSet=NULL;
+	m_isMetricsRegistered=false;
 
 	switch(lockPolicyType)
 	{
@@ -50,6 +53,12 @@ IpcClient::IpcClient(epl::LockPolicy lockPolicyType)
 	case LOCK_POLICY_NONE:
 		m_writeQueueLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_writeQueueLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_writeQueueLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_writeQueueLock=NULL;
 		break;
@@ -59,11 +68,15 @@ IpcClient::IpcClient(epl::LockPolicy lockPolicyType)
 
 IpcClient::~IpcClient()
 {
+	if(m_isMetricsRegistered)
+		IPC_METRICS_INSTANCE.Unregister(this);
 	Disconnect();
-	if(m_readBuffer)
-		EP_DELETE m_readBuffer;
 	if(m_writeQueueLock)
 		EP_DELETE m_writeQueueLock;
+	if(m_writeBufferPool)
+		m_writeBufferPool->ReleaseObj();
+	if(m_bufferPoolSet)
+		m_bufferPoolSet->ReleaseObj();
 }
 
 epl::EpTString IpcClient::GetFullPipeName() const
@@ -83,6 +96,8 @@ IpcClientCallbackInterface *IpcClient::GetCallbackObject()
 ConnectStatus IpcClient::Connect(const IpcClientOps &ops, unsigned int waitTimeInMilliSec)
 {
 	EP_ASSERT(ops.callBackObj);
+	EP_ASSERT(ops.writeBatchByteSize==0 || ops.writeBatchByteSize>IPC_FRAME_HEADER_SIZE);
+	EP_ASSERT(ops.writeBatchByteSize==0 || ops.maxMessageByteSize==0 || ops.maxMessageByteSize>IPC_FRAME_HEADER_SIZE);
 	if(ops.pipeName)
 	{
 		m_pipeName=_T("\\\\");
@@ -95,8 +110,25 @@ ConnectStatus IpcClient::Connect(const IpcClientOps &ops, unsigned int waitTimeI
 		m_options.numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
 	if(ops.numOfReadBytes==0)
 		m_options.numOfReadBytes=DEFAULT_READ_BUF_SIZE;
+	if(ops.maxMessageByteSize==0)
+		m_options.maxMessageByteSize=IPC_MESSAGE_BYTE_SIZE_UNLIMITED;
+	if(!m_writeBufferPool || m_writeBufferPool->GetBufferByteSize()!=m_options.numOfWriteBytes)
+	{
+		// the elements still acquired keep the old pool alive until released
+		if(m_writeBufferPool)
+			m_writeBufferPool->ReleaseObj();
+		m_writeBufferPool=EP_NEW IpcWriteBufferPool(m_options.numOfWriteBytes,IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT,m_lockPolicy);
+	}
 
-	m_readBuffer=EP_NEW char[m_options.numOfReadBytes]; 
+	unsigned int minBufferByteSize=m_options.numOfReadBytes>m_options.numOfWriteBytes?m_options.numOfReadBytes:m_options.numOfWriteBytes;
+	if(!m_bufferPoolSet || m_bufferPoolSet->GetMinBufferByteSize()!=minBufferByteSize)
+	{
+		if(m_bufferPoolSet)
+			m_bufferPoolSet->ReleaseObj();
+		m_bufferPoolSet=EP_NEW IpcBufferPoolSet(minBufferByteSize,IPC_BUFFER_POOL_SET_MAX_FREE_COUNT,m_lockPolicy);
+	}
+
+	m_readBuffer.Initialize(m_options.numOfReadBytes,m_options.maxMessageByteSize,m_bufferPoolSet);
 	while(1)
 	{
 		m_pipeHandle= CreateFile( 
@@ -141,12 +173,15 @@ ConnectStatus IpcClient::Connect(const IpcClientOps &ops, unsigned int waitTimeI
 	
 	m_connected= ReadFileEx( 
 		m_pipeHandle, 
-		m_readBuffer, 
-		m_options.numOfReadBytes, 
+		m_readBuffer.GetReadPosition(), 
+		m_readBuffer.GetReadByteSize(), 
 		(LPOVERLAPPED) this, 
 		(LPOVERLAPPED_COMPLETION_ROUTINE) OnReadComplete); 
 	if(m_connected)
+	{
+		m_metrics.RecordConnect();
 		return CONNECT_STATUS_SUCCESS;
+	}
 	else
 		return CONNECT_STATUS_FAIL_READ_FAILED;
 
@@ -157,12 +192,13 @@ void IpcClient::Disconnect()
 	{
 		CloseHandle(m_pipeHandle); 
 		m_connected=false;
+		m_metrics.RecordDisconnect();
 		m_options.callBackObj->OnDisconnect(this);
 		LockObj lock(m_writeQueueLock);
 		while(m_writeQueue.size())
 		{
 			PipeWriteElem *elem=m_writeQueue.front();
-			m_writeQueue.pop();
+			m_writeQueue.pop_front();
 			elem->ReleaseObj();
 		}
 	}
@@ -170,21 +206,65 @@ void IpcClient::Disconnect()
 }
 void IpcClient::Write(char *data,unsigned int dataByteSize)
 {
-	EP_ASSERT(dataByteSize<=m_options.numOfWriteBytes);
-
-	PipeWriteElem *elem=EP_NEW PipeWriteElem(dataByteSize,m_lockPolicy);
+	PipeWriteElem *elem=acquireWriteElem(dataByteSize);
 	System::Memcpy(elem->m_data,data, dataByteSize );
+	queueWrite(elem);
+}
+
+void IpcClient::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	unsigned int dataByteSize=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		dataByteSize+=segmentList[segmentTrav].m_dataSize;
+
+	PipeWriteElem *elem=acquireWriteElem(dataByteSize);
+	char *dest=elem->m_data;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+	{
+		System::Memcpy(dest,segmentList[segmentTrav].m_data,segmentList[segmentTrav].m_dataSize);
+		dest+=segmentList[segmentTrav].m_dataSize;
+	}
+	queueWrite(elem);
+}
+
+PipeWriteElem *IpcClient::AcquireWriteBuffer(unsigned int dataByteSize)
+{
+	EP_ASSERT_EXPR(m_writeBufferPool,_T("The write buffer is acquired before Connect."));
+	return acquireWriteElem(dataByteSize);
+}
+
+void IpcClient::WriteOwned(PipeWriteElem *elem)
+{
+	EP_ASSERT(elem);
+	queueWrite(elem);
+}
 
+void IpcClient::queueWrite(PipeWriteElem *elem)
+{
 	BOOL fWrite = FALSE; 
 
+	elem->m_queueTime=WorkerMetrics::GetCurrentMicroSec();
+	// the message over the maximum message byte size is never written
+	if(elem->m_dataSize>GetMaxWriteDataByteSize())
+	{
+		m_metrics.RecordWriteFailure();
+		m_options.callBackObj->OnWriteComplete(this,0,WRITE_STATUS_FAIL_WRITE_FAILED,0);
+		elem->ReleaseObj();
+		return;
+	}
+
 	LockObj lock(m_writeQueueLock);
 	if(m_writeQueue.size())
 	{
-		m_writeQueue.push(elem);
+		m_writeQueue.push_back(elem);
+		m_metrics.RecordWriteQueueDepth(m_writeQueue.size());
 	}
 	else
 	{
-		m_writeQueue.push(elem);
+		m_writeQueue.push_back(elem);
+		m_metrics.RecordWriteQueueDepth(m_writeQueue.size());
+		coalesceWrites();
+		elem=m_writeQueue.front();
 		fWrite = WriteFileEx( 
 			m_pipeHandle, 
 			elem->m_data, 
@@ -199,6 +279,19 @@ void IpcClient::Write(char *data,unsigned int dataByteSize)
 	//System::Memcpy(m_writeBuffer,data, dataByteSize );
 
 }
+void IpcClient::GetMetrics(IpcMetricsSnapshot &retSnapshot) const
+{
+	m_metrics.GetSnapshot(retSnapshot);
+	LockObj lock(m_writeQueueLock);
+	retSnapshot.writeQueueDepth=static_cast<__int64>(m_writeQueue.size());
+}
+
+void IpcClient::SetMetricsName(const TCHAR *name)
+{
+	IPC_METRICS_INSTANCE.Register(this,name);
+	m_isMetricsRegistered=true;
+}
+
 bool IpcClient::IsConnected() const
 {
 	return m_connected;
@@ -206,11 +299,13 @@ bool IpcClient::IsConnected() const
 
 unsigned int IpcClient::GetMaxReadDataByteSize() const
 {
-	return m_options.numOfReadBytes;
+	return m_options.maxMessageByteSize;
 }
 unsigned int IpcClient::GetMaxWriteDataByteSize() const
 {
-	return m_options.numOfWriteBytes;
+	if(getWriteBatchByteSize())
+		return m_options.maxMessageByteSize-IPC_FRAME_HEADER_SIZE;
+	return m_options.maxMessageByteSize;
 }
 
 
@@ -232,18 +327,19 @@ void IpcClient::OnWriteComplete(DWORD dwErr, DWORD cbWritten, LPOVERLAPPED lpOve
 	if(pipeInst->m_writeQueue.size())
 	{
 		PipeWriteElem *elem=pipeInst->m_writeQueue.front();
-		pipeInst->m_writeQueue.pop();
+		pipeInst->m_writeQueue.pop_front();
 
 		// The write operation has finished, so read the next request (if 
 		// there is no error). 
 
 		if ((dwErr == 0) && (cbWritten == elem->m_dataSize)) 
 		{
-			pipeInst->m_options.callBackObj->OnWriteComplete(pipeInst,cbWritten,WRITE_STATUS_SUCCESS,dwErr); 
+			pipeInst->reportWrite(elem,WRITE_STATUS_SUCCESS,dwErr,cbWritten); 
 			if(pipeInst->IsConnected())
 			{
 				if(pipeInst->m_writeQueue.size())
 				{
+					pipeInst->coalesceWrites();
 					PipeWriteElem *nextElem=pipeInst->m_writeQueue.front();
 					fWrite = WriteFileEx( 
 						pipeInst->m_pipeHandle, 
@@ -256,7 +352,7 @@ void IpcClient::OnWriteComplete(DWORD dwErr, DWORD cbWritten, LPOVERLAPPED lpOve
 		}
 		else
 		{
-			pipeInst->m_options.callBackObj->OnWriteComplete(pipeInst,cbWritten,WRITE_STATUS_FAIL_WRITE_FAILED,dwErr); 
+			pipeInst->reportWrite(elem,WRITE_STATUS_FAIL_WRITE_FAILED,dwErr,cbWritten); 
 		}
 		elem->ReleaseObj();
 
@@ -306,23 +402,33 @@ void IpcClient::OnReadComplete(DWORD dwErr, DWORD cbBytesRead, LPOVERLAPPED lpOv
 	// The read operation has finished, so write a response (if no 
 	// error occurred). 
 	BOOL fRead = FALSE;
+	bool isReading=false;
 	if ((dwErr == 0) && (cbBytesRead != 0)) 
 	{ 
-		pipeInst->m_options.callBackObj->OnReadComplete(pipeInst,pipeInst->m_readBuffer,cbBytesRead,READ_STATUS_SUCCESS,dwErr); 
-		if(pipeInst->IsConnected())
-		{
-			fRead = ReadFileEx( 
-				pipeInst->m_pipeHandle, 
-				pipeInst->m_readBuffer, 
-				pipeInst->m_options.numOfReadBytes, 
-				(LPOVERLAPPED) pipeInst, 
-				(LPOVERLAPPED_COMPLETION_ROUTINE) OnReadComplete); 
-
-		}
+		pipeInst->reportRead(dwErr,cbBytesRead); 
+		isReading=true;
 	} 
+	else if(dwErr==ERROR_MORE_DATA && pipeInst->growRead(cbBytesRead))
+	{
+		// the rest of the message is read after the part already read
+		isReading=true;
+	}
 	else
 	{
-		pipeInst->m_options.callBackObj->OnReadComplete(pipeInst,pipeInst->m_readBuffer,cbBytesRead,READ_STATUS_FAIL_READ_FAILED,dwErr); 
+		unsigned int byteSize=pipeInst->m_readBuffer.Complete(cbBytesRead);
+		pipeInst->m_metrics.RecordReadFailure();
+		pipeInst->m_options.callBackObj->OnReadComplete(pipeInst,pipeInst->m_readBuffer.GetData(),byteSize,READ_STATUS_FAIL_READ_FAILED,dwErr); 
+		pipeInst->m_readBuffer.Reset();
+	}
+
+	if(isReading && pipeInst->IsConnected())
+	{
+		fRead = ReadFileEx( 
+			pipeInst->m_pipeHandle, 
+			pipeInst->m_readBuffer.GetReadPosition(), 
+			pipeInst->m_readBuffer.GetReadByteSize(), 
+			(LPOVERLAPPED) pipeInst, 
+			(LPOVERLAPPED_COMPLETION_ROUTINE) OnReadComplete); 
 	}
 
 	if (pipeInst->IsConnected() && ! fRead) 
@@ -347,4 +453,116 @@ void IpcClient::OnReadComplete(DWORD dwErr, DWORD cbBytesRead, LPOVERLAPPED lpOv
 	// 	} 
 	// 	if (pipeInst->IsConnected() && ! fWrite) 
 	// 		pipeInst->Disconnect();
-} 
\ No newline at end of file
+} 
+
+PipeWriteElem *IpcClient::acquireWriteElem(unsigned int dataByteSize)
+{
+	if(dataByteSize<=m_writeBufferPool->GetBufferByteSize())
+		return m_writeBufferPool->Acquire(dataByteSize);
+	return m_bufferPoolSet->Acquire(dataByteSize);
+}
+
+unsigned int IpcClient::getWriteBatchByteSize() const
+{
+	if(m_options.writeBatchByteSize>m_options.numOfWriteBytes)
+		return m_options.numOfWriteBytes;
+	return m_options.writeBatchByteSize;
+}
+
+void IpcClient::coalesceWrites()
+{
+	unsigned int batchByteSize=getWriteBatchByteSize();
+	if(!batchByteSize || m_writeQueue.empty())
+		return;
+
+	PipeWriteElem *front=m_writeQueue.front();
+	if(front->m_dataSize>batchByteSize-IPC_FRAME_HEADER_SIZE)
+	{
+		// the message longer than the batch goes out alone in its own frame
+		PipeWriteElem *frame=acquireWriteElem(front->m_dataSize+IPC_FRAME_HEADER_SIZE);
+		frame->m_dataSize=0;
+		frame->m_queueTime=front->m_queueTime;
+		IpcFrame::AppendFrame(frame,front->m_dataSize+IPC_FRAME_HEADER_SIZE,front);
+		m_writeQueue.pop_front();
+		front->ReleaseObj();
+		m_writeQueue.push_front(frame);
+		return;
+	}
+
+	// the writes queued while the previous one was in progress go out together
+	PipeWriteElem *batch=m_writeBufferPool->Acquire(0);
+	// the latency of the batch is measured from its oldest write
+	batch->m_queueTime=front->m_queueTime;
+	while(m_writeQueue.size())
+	{
+		PipeWriteElem *elem=m_writeQueue.front();
+		if(!IpcFrame::AppendFrame(batch,batchByteSize,elem))
+			break;
+		m_writeQueue.pop_front();
+		elem->ReleaseObj();
+	}
+	m_writeQueue.push_front(batch);
+}
+
+void IpcClient::reportWrite(const PipeWriteElem *elem, WriteStatus status, unsigned long errCode, unsigned int cbWritten)
+{
+	__int64 latency=WorkerMetrics::GetCurrentMicroSec()-elem->m_queueTime;
+	if(!getWriteBatchByteSize())
+	{
+		if(status==WRITE_STATUS_SUCCESS)
+			m_metrics.RecordWrite(cbWritten,latency);
+		else
+			m_metrics.RecordWriteFailure();
+		m_options.callBackObj->OnWriteComplete(this,cbWritten,status,errCode);
+		return;
+	}
+	unsigned int offset=0;
+	const char *frame=NULL;
+	unsigned int frameSize=0;
+	while(IpcFrame::NextFrame(elem->m_data,elem->m_dataSize,offset,frame,frameSize))
+	{
+		if(status==WRITE_STATUS_SUCCESS)
+			m_metrics.RecordWrite(frameSize,latency);
+		else
+			m_metrics.RecordWriteFailure();
+		m_options.callBackObj->OnWriteComplete(this,frameSize,status,errCode);
+	}
+}
+
+void IpcClient::reportRead(unsigned long errCode, unsigned int cbBytesRead)
+{
+	unsigned int byteSize=m_readBuffer.Complete(cbBytesRead);
+	const char *data=m_readBuffer.GetData();
+	if(!getWriteBatchByteSize())
+	{
+		m_metrics.RecordRead(byteSize);
+		m_options.callBackObj->OnReadComplete(this,data,byteSize,READ_STATUS_SUCCESS,errCode);
+	}
+	else
+	{
+		unsigned int offset=0;
+		const char *frame=NULL;
+		unsigned int frameSize=0;
+		while(IpcFrame::NextFrame(data,byteSize,offset,frame,frameSize))
+		{
+			m_metrics.RecordRead(frameSize);
+			m_options.callBackObj->OnReadComplete(this,frame,frameSize,READ_STATUS_SUCCESS,errCode);
+		}
+		if(offset!=byteSize)
+		{
+			m_metrics.RecordReadFailure();
+			m_options.callBackObj->OnReadComplete(this,data+offset,byteSize-offset,READ_STATUS_FAIL_READ_FAILED,errCode);
+		}
+	}
+	// the callbacks are done with the data, so the buffer of the long message goes back to the pool set
+	m_readBuffer.Reset();
+}
+
+bool IpcClient::growRead(unsigned int cbBytesRead)
+{
+	// the byte size left in the message lets the buffer grow once
+	DWORD leftByteSize=0;
+	if(!PeekNamedPipe(m_pipeHandle,NULL,0,NULL,NULL,&leftByteSize))
+		leftByteSize=0;
+	return m_readBuffer.Grow(cbBytesRead,leftByteSize);
+}
@@ -0,0 +1,280 @@
+/*! 
+IpcClientPool for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epIpcClientPool.h"
+#include "epIpcClient.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+IpcClientPoolOps IpcClientPoolOps::defaultIpcClientPoolOps;
+
+IpcClientPool::IpcClientPool(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_wakeEvent(false,false)
+{
+	m_lockPolicy=lockPolicyType;
+	m_callBackObj=NULL;
+	m_isOpened=false;
+	m_isClosing=false;
+	m_nextIdx=0;
+}
+
+IpcClientPool::~IpcClientPool()
+{
+	Close();
+}
+
+bool IpcClientPool::Open(const IpcClientPoolOps &ops)
+{
+	EP_ASSERT(ops.connectionCount>0);
+	if(m_isOpened)
+		return true;
+	m_options=ops;
+	if(ops.clientOps.callBackObj)
+		m_callBackObj=ops.clientOps.callBackObj;
+	// the pool receives the callbacks of the connections, and forwards them
+	m_options.clientOps.callBackObj=this;
+
+	for(unsigned int connectionTrav=0;connectionTrav<m_options.connectionCount;connectionTrav++)
+	{
+		Connection connection;
+		connection.m_client=createConnection();
+		connection.m_inFlightCount=0;
+		connection.m_connectCount=0;
+		connection.m_lastConnectStatus=CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+		m_connections.push_back(connection);
+	}
+
+	m_isClosing=false;
+	m_wakeEvent.ResetEvent();
+	if(!Start())
+	{
+		Close();
+		return false;
+	}
+	m_isOpened=true;
+	return true;
+}
+
+void IpcClientPool::Close()
+{
+	if(m_isOpened)
+	{
+		m_isClosing=true;
+		m_wakeEvent.SetEvent();
+		WaitFor(m_options.clientOps.waitTimeInMilliSec);
+		m_isOpened=false;
+	}
+	for(size_t connectionTrav=0;connectionTrav<m_connections.size();connectionTrav++)
+	{
+		m_connections[connectionTrav].m_client->Disconnect();
+		destroyConnection(m_connections[connectionTrav].m_client);
+	}
+	m_connections.clear();
+}
+
+bool IpcClientPool::IsOpened() const
+{
+	return m_isOpened;
+}
+
+IpcClientInterface *IpcClientPool::createConnection()
+{
+	return EP_NEW IpcClient(m_lockPolicy);
+}
+
+void IpcClientPool::destroyConnection(IpcClientInterface *connection)
+{
+	EP_DELETE connection;
+}
+
+void IpcClientPool::execute()
+{
+	while(!m_isClosing)
+	{
+		connectAll();
+		// waits alertably, so the completion routines of the connections made on this thread are run here
+		WaitForSingleObjectEx(m_wakeEvent.GetEventHandle(),m_options.reconnectIntervalInMilliSec,TRUE);
+	}
+}
+
+void IpcClientPool::connectAll()
+{
+	for(size_t connectionTrav=0;connectionTrav<m_connections.size() && !m_isClosing;connectionTrav++)
+	{
+		Connection &connection=m_connections[connectionTrav];
+		if(connection.m_client->IsConnected())
+			continue;
+		connection.m_lastConnectStatus=connection.m_client->Connect(m_options.clientOps,m_options.connectWaitTimeInMilliSec);
+		if(connection.m_lastConnectStatus==CONNECT_STATUS_SUCCESS)
+			InterlockedIncrement(&connection.m_connectCount);
+	}
+}
+
+int IpcClientPool::findConnection(const IpcClientInterface *pipe) const
+{
+	for(size_t connectionTrav=0;connectionTrav<m_connections.size();connectionTrav++)
+	{
+		if(m_connections[connectionTrav].m_client==pipe)
+			return static_cast<int>(connectionTrav);
+	}
+	return -1;
+}
+
+int IpcClientPool::pickConnection()
+{
+	if(m_connections.empty())
+		return -1;
+	int retIdx=-1;
+	long minInFlightCount=0;
+	size_t connectionCount=m_connections.size();
+	// the scan starts from the next connection each time, so the ties are spread round-robin
+	size_t startIdx=static_cast<unsigned long>(InterlockedIncrement(&m_nextIdx))%connectionCount;
+	for(size_t connectionTrav=0;connectionTrav<connectionCount;connectionTrav++)
+	{
+		size_t idx=(startIdx+connectionTrav)%connectionCount;
+		Connection &connection=m_connections[idx];
+		if(!connection.m_client->IsConnected())
+			continue;
+		if(retIdx==-1 || connection.m_inFlightCount<minInFlightCount)
+		{
+			retIdx=static_cast<int>(idx);
+			minInFlightCount=connection.m_inFlightCount;
+		}
+	}
+	if(retIdx!=-1)
+		InterlockedIncrement(&m_connections[retIdx].m_inFlightCount);
+	return retIdx;
+}
+
+bool IpcClientPool::Write(char *data,unsigned int dataByteSize)
+{
+	int idx=pickConnection();
+	if(idx==-1)
+		return false;
+	m_connections[idx].m_client->Write(data,dataByteSize);
+	return true;
+}
+
+bool IpcClientPool::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	int idx=pickConnection();
+	if(idx==-1)
+		return false;
+	m_connections[idx].m_client->Write(segmentList,segmentCount);
+	return true;
+}
+
+unsigned int IpcClientPool::GetConnectionCount() const
+{
+	return static_cast<unsigned int>(m_connections.size());
+}
+
+unsigned int IpcClientPool::GetAliveConnectionCount() const
+{
+	unsigned int retCount=0;
+	for(size_t connectionTrav=0;connectionTrav<m_connections.size();connectionTrav++)
+	{
+		if(m_connections[connectionTrav].m_client->IsConnected())
+			retCount++;
+	}
+	return retCount;
+}
+
+IpcClientInterface *IpcClientPool::GetConnection(unsigned int idx) const
+{
+	EP_ASSERT(idx<m_connections.size());
+	return m_connections[idx].m_client;
+}
+
+bool IpcClientPool::IsConnectionAlive(unsigned int idx) const
+{
+	EP_ASSERT(idx<m_connections.size());
+	return m_connections[idx].m_client->IsConnected();
+}
+
+unsigned int IpcClientPool::GetInFlightCount(unsigned int idx) const
+{
+	EP_ASSERT(idx<m_connections.size());
+	return static_cast<unsigned int>(m_connections[idx].m_inFlightCount);
+}
+
+unsigned int IpcClientPool::GetConnectCount(unsigned int idx) const
+{
+	EP_ASSERT(idx<m_connections.size());
+	return static_cast<unsigned int>(m_connections[idx].m_connectCount);
+}
+
+ConnectStatus IpcClientPool::GetLastConnectStatus(unsigned int idx) const
+{
+	EP_ASSERT(idx<m_connections.size());
+	return m_connections[idx].m_lastConnectStatus;
+}
+
+void IpcClientPool::SetCallbackObject(IpcClientCallbackInterface *callBackObj)
+{
+	m_callBackObj=callBackObj;
+}
+
+IpcClientCallbackInterface *IpcClientPool::GetCallbackObject()
+{
+	return m_callBackObj;
+}
+
+void IpcClientPool::OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode)
+{
+	if(m_callBackObj)
+		m_callBackObj->OnReadComplete(pipe,receivedData,receivedDataByteSize,status,errCode);
+}
+
+void IpcClientPool::OnWriteComplete(IpcClientInterface *pipe,unsigned int writtenDataByteSize, WriteStatus status, unsigned long errCode)
+{
+	int idx=findConnection(pipe);
+	if(idx!=-1)
+	{
+		// the count is reset at the disconnect, so the writes completed after never take it below zero
+		volatile long *inFlightCount=&m_connections[idx].m_inFlightCount;
+		long count;
+		while((count=*inFlightCount)>0 && InterlockedCompareExchange(inFlightCount,count-1,count)!=count)
+			;
+	}
+	if(m_callBackObj)
+		m_callBackObj->OnWriteComplete(pipe,writtenDataByteSize,status,errCode);
+}
+
+void IpcClientPool::OnDisconnect(IpcClientInterface *pipe)
+{
+	int idx=findConnection(pipe);
+	if(idx!=-1)
+		InterlockedExchange(&m_connections[idx].m_inFlightCount,0);
+	if(m_callBackObj)
+		m_callBackObj->OnDisconnect(pipe);
+	if(!m_isClosing)
+		m_wakeEvent.SetEvent();
+}
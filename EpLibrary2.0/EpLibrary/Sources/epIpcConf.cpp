@@ -40,14 +40,307 @@ PipeWriteElem::PipeWriteElem(epl::LockPolicy lockPolicyType):SmartObject(lockPol
 {
 	m_dataSize=0;
 	m_data=NULL;
+	m_queueTime=0;
+	m_pool=NULL;
 }
 PipeWriteElem::PipeWriteElem(unsigned int dataSize,epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType)
 {
 	m_dataSize=dataSize;
-	m_data=EP_NEW char[m_dataSize];
+	m_data=reinterpret_cast<char*>(EP_MallocTag(m_dataSize,MEMORY_TAG_IPC));
+	m_queueTime=0;
+	m_pool=NULL;
 }
 PipeWriteElem::~PipeWriteElem()
 {
 	if(m_data)
-		EP_DELETE m_data;
-}
\ No newline at end of file
+		EP_FreeTag(m_data,MEMORY_TAG_IPC);
+}
+bool PipeWriteElem::recycleObj()
+{
+	IpcWriteBufferPool *pool=m_pool;
+	if(!pool)
+		return false;
+	m_pool=NULL;
+	bool isRecycled=pool->recycleElem(this);
+	// the pool may delete this element with itself, so nothing is touched after the release
+	pool->ReleaseObj();
+	return isRecycled;
+}
+
+IpcWriteBufferPool::IpcWriteBufferPool(unsigned int bufferByteSize,unsigned int maxFreeCount,epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType)
+{
+	m_bufferByteSize=bufferByteSize;
+	m_maxFreeCount=maxFreeCount;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_poolLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_poolLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_poolLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_poolLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_poolLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_poolLock=NULL;
+		break;
+	}
+}
+
+IpcWriteBufferPool::~IpcWriteBufferPool()
+{
+	for(size_t freeTrav=0;freeTrav<m_freeList.size();freeTrav++)
+		EP_DELETE m_freeList[freeTrav];
+	m_freeList.clear();
+	if(m_poolLock)
+		EP_DELETE m_poolLock;
+}
+
+PipeWriteElem *IpcWriteBufferPool::Acquire(unsigned int dataByteSize)
+{
+	EP_ASSERT_EXPR(dataByteSize<=m_bufferByteSize,_T("The data byte size (%d) exceeds the buffer byte size (%d)."),dataByteSize,m_bufferByteSize);
+	PipeWriteElem *elem=NULL;
+	{
+		LockObj lock(m_poolLock);
+		if(m_freeList.size())
+		{
+			elem=m_freeList.back();
+			m_freeList.pop_back();
+		}
+	}
+	if(!elem)
+		elem=EP_NEW PipeWriteElem(m_bufferByteSize,m_lockPolicy);
+	elem->m_dataSize=dataByteSize;
+	elem->m_pool=this;
+	RetainObj();
+	return elem;
+}
+
+unsigned int IpcWriteBufferPool::GetBufferByteSize() const
+{
+	return m_bufferByteSize;
+}
+
+size_t IpcWriteBufferPool::GetFreeCount() const
+{
+	LockObj lock(m_poolLock);
+	return m_freeList.size();
+}
+
+bool IpcWriteBufferPool::recycleElem(PipeWriteElem *elem)
+{
+	LockObj lock(m_poolLock);
+	if(m_freeList.size()>=m_maxFreeCount)
+		return false;
+	m_freeList.push_back(elem);
+	return true;
+}
+
+IpcBufferPoolSet::IpcBufferPoolSet(unsigned int minBufferByteSize,unsigned int maxFreeCount,epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType)
+{
+	EP_ASSERT(minBufferByteSize);
+	m_minBufferByteSize=minBufferByteSize;
+	m_maxFreeCount=maxFreeCount;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_poolLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_poolLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_poolLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_poolLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_poolLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_poolLock=NULL;
+		break;
+	}
+}
+
+IpcBufferPoolSet::~IpcBufferPoolSet()
+{
+	// the elements still acquired keep their pools alive until released
+	for(size_t poolTrav=0;poolTrav<m_poolList.size();poolTrav++)
+	{
+		if(m_poolList[poolTrav])
+			m_poolList[poolTrav]->ReleaseObj();
+	}
+	m_poolList.clear();
+	if(m_poolLock)
+		EP_DELETE m_poolLock;
+}
+
+PipeWriteElem *IpcBufferPoolSet::Acquire(unsigned int dataByteSize)
+{
+	size_t classIdx=0;
+	unsigned int classByteSize=m_minBufferByteSize;
+	while(classByteSize<dataByteSize && classByteSize<=0x7FFFFFFF)
+	{
+		classByteSize<<=1;
+		classIdx++;
+	}
+	if(classByteSize<dataByteSize)
+		return EP_NEW PipeWriteElem(dataByteSize,m_lockPolicy);
+
+	IpcWriteBufferPool *pool=NULL;
+	{
+		LockObj lock(m_poolLock);
+		if(m_poolList.size()<=classIdx)
+			m_poolList.resize(classIdx+1,NULL);
+		if(!m_poolList[classIdx])
+			m_poolList[classIdx]=EP_NEW IpcWriteBufferPool(classByteSize,m_maxFreeCount,m_lockPolicy);
+		pool=m_poolList[classIdx];
+	}
+	return pool->Acquire(dataByteSize);
+}
+
+unsigned int IpcBufferPoolSet::GetMinBufferByteSize() const
+{
+	return m_minBufferByteSize;
+}
+
+IpcReadBuffer::IpcReadBuffer()
+{
+	m_defaultBuffer=NULL;
+	m_defaultByteSize=0;
+	m_largeElem=NULL;
+	m_buffer=NULL;
+	m_bufferByteSize=0;
+	m_readByteSize=0;
+	m_maxMessageByteSize=0;
+	m_bufferPoolSet=NULL;
+}
+
+IpcReadBuffer::~IpcReadBuffer()
+{
+	Reset();
+	if(m_defaultBuffer)
+		EP_FreeTag(m_defaultBuffer,MEMORY_TAG_IPC);
+	if(m_bufferPoolSet)
+		m_bufferPoolSet->ReleaseObj();
+}
+
+void IpcReadBuffer::Initialize(unsigned int defaultByteSize, unsigned int maxMessageByteSize, IpcBufferPoolSet *bufferPoolSet)
+{
+	EP_ASSERT(bufferPoolSet);
+	Reset();
+	if(!m_defaultBuffer || m_defaultByteSize!=defaultByteSize)
+	{
+		if(m_defaultBuffer)
+			EP_FreeTag(m_defaultBuffer,MEMORY_TAG_IPC);
+		m_defaultBuffer=reinterpret_cast<char*>(EP_MallocTag(defaultByteSize,MEMORY_TAG_IPC));
+		m_defaultByteSize=defaultByteSize;
+	}
+	bufferPoolSet->RetainObj();
+	if(m_bufferPoolSet)
+		m_bufferPoolSet->ReleaseObj();
+	m_bufferPoolSet=bufferPoolSet;
+	m_maxMessageByteSize=maxMessageByteSize;
+	m_buffer=m_defaultBuffer;
+	m_bufferByteSize=m_defaultByteSize;
+}
+
+char *IpcReadBuffer::GetReadPosition() const
+{
+	return m_buffer+m_readByteSize;
+}
+
+unsigned int IpcReadBuffer::GetReadByteSize() const
+{
+	return m_bufferByteSize-m_readByteSize;
+}
+
+bool IpcReadBuffer::Grow(unsigned int readByteSize, unsigned int leftByteSize)
+{
+	m_readByteSize+=readByteSize;
+	unsigned int newByteSize=0;
+	if(leftByteSize)
+	{
+		if(leftByteSize>m_maxMessageByteSize-m_readByteSize)
+			return false;
+		newByteSize=m_readByteSize+leftByteSize;
+	}
+	else
+	{
+		// the size left is unknown, so the buffer doubles until the message fits
+		if(m_readByteSize>=m_maxMessageByteSize)
+			return false;
+		newByteSize=m_bufferByteSize<=m_maxMessageByteSize/2?m_bufferByteSize*2:m_maxMessageByteSize;
+	}
+	if(newByteSize<=m_bufferByteSize)
+		return true;
+
+	PipeWriteElem *largeElem=m_bufferPoolSet->Acquire(newByteSize);
+	System::Memcpy(largeElem->m_data,m_buffer,m_readByteSize);
+	if(m_largeElem)
+		m_largeElem->ReleaseObj();
+	m_largeElem=largeElem;
+	m_buffer=m_largeElem->m_data;
+	m_bufferByteSize=newByteSize;
+	return true;
+}
+
+unsigned int IpcReadBuffer::Complete(unsigned int readByteSize)
+{
+	m_readByteSize+=readByteSize;
+	return m_readByteSize;
+}
+
+char *IpcReadBuffer::GetData() const
+{
+	return m_buffer;
+}
+
+void IpcReadBuffer::Reset()
+{
+	if(m_largeElem)
+	{
+		m_largeElem->ReleaseObj();
+		m_largeElem=NULL;
+	}
+	m_buffer=m_defaultBuffer;
+	m_bufferByteSize=m_defaultByteSize;
+	m_readByteSize=0;
+}
+
+bool IpcFrame::AppendFrame(PipeWriteElem *batch, unsigned int batchByteSize, const PipeWriteElem *elem)
+{
+	if(batch->m_dataSize+IPC_FRAME_HEADER_SIZE+elem->m_dataSize>batchByteSize)
+		return false;
+	unsigned int frameSize=elem->m_dataSize;
+	System::Memcpy(batch->m_data+batch->m_dataSize,&frameSize,IPC_FRAME_HEADER_SIZE);
+	batch->m_dataSize+=IPC_FRAME_HEADER_SIZE;
+	System::Memcpy(batch->m_data+batch->m_dataSize,elem->m_data,elem->m_dataSize);
+	batch->m_dataSize+=elem->m_dataSize;
+	return true;
+}
+
+bool IpcFrame::NextFrame(const char *data, unsigned int byteSize, unsigned int &offset, const char *&retFrame, unsigned int &retFrameSize)
+{
+	if(offset+IPC_FRAME_HEADER_SIZE>byteSize)
+		return false;
+	unsigned int frameSize=0;
+	System::Memcpy(&frameSize,data+offset,IPC_FRAME_HEADER_SIZE);
+	if(frameSize>byteSize-offset-IPC_FRAME_HEADER_SIZE)
+		return false;
+	retFrame=data+offset+IPC_FRAME_HEADER_SIZE;
+	retFrameSize=frameSize;
+	offset+=IPC_FRAME_HEADER_SIZE+frameSize;
+	return true;
+}
@@ -0,0 +1,129 @@
+/*! 
+IpcCoroutineReader for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epIpcCoroutineReader.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+IpcCoroutineReader::IpcCoroutineReader(LockPolicy lockPolicyType):m_readEvent(false,true,lockPolicyType)
+{
+	m_isDisconnected=false;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_lock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_lock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_lock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_lock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_lock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_lock=NULL;
+		break;
+	}
+}
+
+IpcCoroutineReader::~IpcCoroutineReader()
+{
+	if(m_lock)
+		EP_DELETE m_lock;
+}
+
+bool IpcCoroutineReader::Read(std::vector<char> &retData, ReadStatus *retStatus)
+{
+	while(true)
+	{
+		{
+			LockObj lock(m_lock);
+			if(!m_pendingList.empty())
+			{
+				retData.swap(m_pendingList.front().m_data);
+				if(retStatus)
+					*retStatus=m_pendingList.front().m_status;
+				m_pendingList.pop_front();
+				// the event is raised again with the lock held whenever the data arrives
+				if(m_pendingList.empty() && !m_isDisconnected)
+					m_readEvent.ResetEvent();
+				return true;
+			}
+			if(m_isDisconnected)
+				return false;
+		}
+		if(!m_readEvent.Wait())
+			return false;
+	}
+}
+
+size_t IpcCoroutineReader::GetPendingCount() const
+{
+	LockObj lock(m_lock);
+	return m_pendingList.size();
+}
+
+bool IpcCoroutineReader::IsDisconnected() const
+{
+	LockObj lock(m_lock);
+	return m_isDisconnected;
+}
+
+void IpcCoroutineReader::Reset()
+{
+	LockObj lock(m_lock);
+	m_pendingList.clear();
+	m_isDisconnected=false;
+	m_readEvent.ResetEvent();
+}
+
+void IpcCoroutineReader::OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode)
+{
+	LockObj lock(m_lock);
+	m_pendingList.push_back(ReadResult());
+	ReadResult &result=m_pendingList.back();
+	if(receivedData && receivedDataByteSize)
+		result.m_data.assign(receivedData,receivedData+receivedDataByteSize);
+	result.m_status=status;
+	m_readEvent.SetEvent();
+}
+
+void IpcCoroutineReader::OnDisconnect(IpcClientInterface *pipe)
+{
+	LockObj lock(m_lock);
+	m_isDisconnected=true;
+	m_readEvent.SetEvent();
+}
@@ -0,0 +1,368 @@
+/*! 
+IpcMetrics for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epIpcMetrics.h"
+#include "epFolderHelper.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+IpcMetricsSnapshot::IpcMetricsSnapshot()
+{
+	messagesIn=0;
+	bytesIn=0;
+	messagesOut=0;
+	bytesOut=0;
+	failedReads=0;
+	failedWrites=0;
+	droppedWrites=0;
+	connectCount=0;
+	disconnectCount=0;
+	writeQueueDepth=0;
+	maxWriteQueueDepth=0;
+	totalWriteLatency=0;
+	maxWriteLatency=0;
+	for(unsigned int bucketTrav=0;bucketTrav<IPC_METRICS_BUCKET_COUNT;bucketTrav++)
+		writeLatencyHistogram[bucketTrav]=0;
+}
+
+void IpcMetricsSnapshot::Subtract(const IpcMetricsSnapshot &b)
+{
+	messagesIn-=b.messagesIn;
+	bytesIn-=b.bytesIn;
+	messagesOut-=b.messagesOut;
+	bytesOut-=b.bytesOut;
+	failedReads-=b.failedReads;
+	failedWrites-=b.failedWrites;
+	droppedWrites-=b.droppedWrites;
+	connectCount-=b.connectCount;
+	disconnectCount-=b.disconnectCount;
+	totalWriteLatency-=b.totalWriteLatency;
+	for(unsigned int bucketTrav=0;bucketTrav<IPC_METRICS_BUCKET_COUNT;bucketTrav++)
+		writeLatencyHistogram[bucketTrav]-=b.writeLatencyHistogram[bucketTrav];
+}
+
+void IpcMetricsSnapshot::Add(const IpcMetricsSnapshot &b)
+{
+	messagesIn+=b.messagesIn;
+	bytesIn+=b.bytesIn;
+	messagesOut+=b.messagesOut;
+	bytesOut+=b.bytesOut;
+	failedReads+=b.failedReads;
+	failedWrites+=b.failedWrites;
+	droppedWrites+=b.droppedWrites;
+	connectCount+=b.connectCount;
+	disconnectCount+=b.disconnectCount;
+	writeQueueDepth+=b.writeQueueDepth;
+	totalWriteLatency+=b.totalWriteLatency;
+	if(b.maxWriteQueueDepth>maxWriteQueueDepth)
+		maxWriteQueueDepth=b.maxWriteQueueDepth;
+	if(b.maxWriteLatency>maxWriteLatency)
+		maxWriteLatency=b.maxWriteLatency;
+	for(unsigned int bucketTrav=0;bucketTrav<IPC_METRICS_BUCKET_COUNT;bucketTrav++)
+		writeLatencyHistogram[bucketTrav]+=b.writeLatencyHistogram[bucketTrav];
+}
+
+double IpcMetricsSnapshot::GetMeanWriteLatency() const
+{
+	if(messagesOut<=0)
+		return 0.0;
+	return static_cast<double>(totalWriteLatency)/static_cast<double>(messagesOut);
+}
+
+__int64 IpcMetricsSnapshot::GetWriteLatencyPercentile(double percentile) const
+{
+	__int64 totalCount=0;
+	for(unsigned int bucketTrav=0;bucketTrav<IPC_METRICS_BUCKET_COUNT;bucketTrav++)
+		totalCount+=writeLatencyHistogram[bucketTrav];
+	if(totalCount==0)
+		return 0;
+	double targetCount=static_cast<double>(totalCount)*percentile/100.0;
+	__int64 accCount=0;
+	for(unsigned int bucketTrav=0;bucketTrav<IPC_METRICS_BUCKET_COUNT;bucketTrav++)
+	{
+		accCount+=writeLatencyHistogram[bucketTrav];
+		if(static_cast<double>(accCount)>=targetCount)
+		{
+			__int64 upperBound=static_cast<__int64>(1)<<bucketTrav;
+			return (upperBound<maxWriteLatency)?upperBound:maxWriteLatency;
+		}
+	}
+	return maxWriteLatency;
+}
+
+
+IpcMetrics::IpcMetrics(LockPolicy lockPolicyType)
+{
+	m_parent=NULL;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_metricsLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_metricsLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_metricsLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_metricsLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_metricsLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_metricsLock=NULL;
+		break;
+	}
+}
+
+IpcMetrics::~IpcMetrics()
+{
+	if(m_metricsLock)
+		EP_DELETE m_metricsLock;
+}
+
+void IpcMetrics::SetParent(IpcMetrics *parent)
+{
+	EP_ASSERT(parent!=this);
+	m_parent=parent;
+}
+
+void IpcMetrics::RecordRead(unsigned int byteSize)
+{
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.messagesIn++;
+		m_counters.bytesIn+=byteSize;
+	}
+	if(m_parent)
+		m_parent->RecordRead(byteSize);
+}
+
+void IpcMetrics::RecordReadFailure()
+{
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.failedReads++;
+	}
+	if(m_parent)
+		m_parent->RecordReadFailure();
+}
+
+void IpcMetrics::RecordWrite(unsigned int byteSize, __int64 latency)
+{
+	if(latency<0)
+		latency=0;
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.messagesOut++;
+		m_counters.bytesOut+=byteSize;
+		m_counters.totalWriteLatency+=latency;
+		m_counters.writeLatencyHistogram[getBucket(latency)]++;
+		if(latency>m_counters.maxWriteLatency)
+			m_counters.maxWriteLatency=latency;
+	}
+	if(m_parent)
+		m_parent->RecordWrite(byteSize,latency);
+}
+
+void IpcMetrics::RecordWriteFailure()
+{
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.failedWrites++;
+	}
+	if(m_parent)
+		m_parent->RecordWriteFailure();
+}
+
+void IpcMetrics::RecordDroppedWrite()
+{
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.droppedWrites++;
+	}
+	if(m_parent)
+		m_parent->RecordDroppedWrite();
+}
+
+void IpcMetrics::RecordConnect()
+{
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.connectCount++;
+	}
+	if(m_parent)
+		m_parent->RecordConnect();
+}
+
+void IpcMetrics::RecordDisconnect()
+{
+	{
+		LockObj lock(m_metricsLock);
+		m_counters.disconnectCount++;
+	}
+	if(m_parent)
+		m_parent->RecordDisconnect();
+}
+
+void IpcMetrics::RecordWriteQueueDepth(size_t depth)
+{
+	{
+		LockObj lock(m_metricsLock);
+		if(static_cast<__int64>(depth)>m_counters.maxWriteQueueDepth)
+			m_counters.maxWriteQueueDepth=static_cast<__int64>(depth);
+	}
+	if(m_parent)
+		m_parent->RecordWriteQueueDepth(depth);
+}
+
+void IpcMetrics::GetSnapshot(IpcMetricsSnapshot &retSnapshot) const
+{
+	LockObj lock(m_metricsLock);
+	retSnapshot=m_counters;
+}
+
+void IpcMetrics::Reset()
+{
+	LockObj lock(m_metricsLock);
+	m_counters=IpcMetricsSnapshot();
+}
+
+unsigned int IpcMetrics::getBucket(__int64 time)
+{
+	unsigned int bucket=0;
+	while(time>0 && bucket<IPC_METRICS_BUCKET_COUNT-1)
+	{
+		time>>=1;
+		bucket++;
+	}
+	return bucket;
+}
+
+
+IpcMetricsManager::IpcMetricsNode::IpcMetricsNode(const IpcMetricsSourceInterface *source, const TCHAR *name):OutputNode()
+{
+	m_source=source;
+	m_name=name;
+}
+
+IpcMetricsManager::IpcMetricsNode::~IpcMetricsNode()
+{
+}
+
+void IpcMetricsManager::IpcMetricsNode::format(EpTString &retString) const
+{
+	IpcMetricsSnapshot snapshot=m_lastSnapshot;
+	if(m_source)
+		m_source->GetMetrics(snapshot);
+	System::STPrintf(retString,_T("%s In : %I64d msgs %I64d bytes Out : %I64d msgs %I64d bytes Failed Read : %I64d Failed Write : %I64d Dropped Write : %I64d Connect : %I64d Disconnect : %I64d Queue : %I64d (Max %I64d) Write Latency Avg : %I64d us P99 : %I64d us Max : %I64d us%s\n"),
+		m_name.c_str(),snapshot.messagesIn,snapshot.bytesIn,snapshot.messagesOut,snapshot.bytesOut,snapshot.failedReads,snapshot.failedWrites,snapshot.droppedWrites,
+		snapshot.connectCount,snapshot.disconnectCount,snapshot.writeQueueDepth,snapshot.maxWriteQueueDepth,
+		static_cast<__int64>(snapshot.GetMeanWriteLatency()),snapshot.GetWriteLatencyPercentile(99.0),snapshot.maxWriteLatency,m_source?_T(""):_T(" (destroyed)"));
+}
+
+void IpcMetricsManager::IpcMetricsNode::Print() const
+{
+	EpTString output;
+	format(output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void IpcMetricsManager::IpcMetricsNode::Write(EpFile* const file)
+{
+	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
+	EpTString output;
+	format(output);
+	System::FTPrintf(file,_T("%s"),output.c_str());
+}
+
+IpcMetricsManager::IpcMetricsManager(LockPolicy lockPolicyType):BaseOutputter(lockPolicyType)
+{
+	m_fileName=FolderHelper::GetModuleFileDirectory();
+	m_fileName.append(_T("ipcmetrics.dat"));
+}
+
+IpcMetricsManager::~IpcMetricsManager()
+{
+}
+
+void IpcMetricsManager::Register(const IpcMetricsSourceInterface *source, const TCHAR *name)
+{
+	EP_ASSERT(source);
+	LockObj lock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		IpcMetricsNode *node=static_cast<IpcMetricsNode*>(*iter);
+		if(node->m_source==source)
+		{
+			node->m_name=name;
+			return;
+		}
+	}
+	m_list.push_back(EP_NEW IpcMetricsNode(source,name));
+}
+
+void IpcMetricsManager::Unregister(const IpcMetricsSourceInterface *source)
+{
+	LockObj lock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		IpcMetricsNode *node=static_cast<IpcMetricsNode*>(*iter);
+		if(node->m_source==source)
+		{
+			// the report keeps the last metrics, as the object is gone
+			source->GetMetrics(node->m_lastSnapshot);
+			node->m_source=NULL;
+			return;
+		}
+	}
+}
+
+void IpcMetricsManager::Clear()
+{
+	LockObj lock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter=m_list.begin();
+	while(iter!=m_list.end())
+	{
+		IpcMetricsNode *node=static_cast<IpcMetricsNode*>(*iter);
+		if(node->m_source)
+			iter++;
+		else
+		{
+			EP_DELETE node;
+			iter=m_list.erase(iter);
+		}
+	}
+}
@@ -24,6 +24,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epIpcPipe.h"
+#include "epWorkerMetrics.h"
+#include "epIpcServer.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -35,42 +37,104 @@ using namespace epl;
 
 
 
-IpcPipe::IpcPipe(EpTString pipeName, IpcServerOps options,epl::LockPolicy lockPolicyType): SmartObject(lockPolicyType)
+IpcPipe::IpcPipe(EpTString pipeName, IpcServerOps options,epl::LockPolicy lockPolicyType,IpcWriteBufferPool *writeBufferPool,IpcBufferPoolSet *bufferPoolSet): SmartObject(lockPolicyType),m_metrics(lockPolicyType)
 {
 	m_pipeName=pipeName;
 	m_options=options;
+	if(options.maxMessageByteSize==0)
+		m_options.maxMessageByteSize=IPC_MESSAGE_BYTE_SIZE_UNLIMITED;
 
 	m_pipeEvent=EventEx(true,true);
 
 	m_overlap.hEvent=m_pipeEvent.GetEventHandle();
+	m_pipeHandle=INVALID_HANDLE_VALUE;
+	m_pipeState=PIPE_STATE_CONNECTING;
+	m_pendingIO=false;
 
-	m_readBuffer=EP_NEW char[options.numOfReadBytes]; 
+	m_server=NULL;
+	m_isMetricsRegistered=false;
+	System::Memset(&m_readOverlap,0,sizeof(IpcPipeOverlapped));
+	m_readOverlap.m_pipe=this;
+	System::Memset(&m_writeOverlap,0,sizeof(IpcPipeOverlapped));
+	m_writeOverlap.m_pipe=this;
 
 	switch(lockPolicyType)
 	{
 	case LOCK_POLICY_CRITICALSECTION:
 		m_writeQueueLock=EP_NEW CriticalSectionEx();
+		m_callbackLock=EP_NEW CriticalSectionEx();
 		break;
 	case LOCK_POLICY_MUTEX:
 		m_writeQueueLock=EP_NEW Mutex();
+		m_callbackLock=EP_NEW Mutex();
 		break;
 	case LOCK_POLICY_NONE:
 		m_writeQueueLock=EP_NEW NoLock();
+		m_callbackLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_writeQueueLock=EP_NEW SpinParkLock();
+		m_callbackLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_writeQueueLock=EP_NEW ReaderWriterLock();
+		m_callbackLock=EP_NEW ReaderWriterLock();
 		break;
 	default:
 		m_writeQueueLock=NULL;
+		m_callbackLock=NULL;
 		break;
 	}
 	m_lockPolicy=lockPolicyType;
+	m_isCallbackScheduled=false;
+
+	if(writeBufferPool)
+	{
+		m_writeBufferPool=writeBufferPool;
+		m_writeBufferPool->RetainObj();
+	}
+	else
+		m_writeBufferPool=EP_NEW IpcWriteBufferPool(options.numOfWriteBytes,IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT,lockPolicyType);
 
+	if(bufferPoolSet)
+	{
+		m_bufferPoolSet=bufferPoolSet;
+		m_bufferPoolSet->RetainObj();
+	}
+	else
+		m_bufferPoolSet=EP_NEW IpcBufferPoolSet(options.numOfReadBytes>options.numOfWriteBytes?options.numOfReadBytes:options.numOfWriteBytes,IPC_BUFFER_POOL_SET_MAX_FREE_COUNT,lockPolicyType);
+	m_readBuffer.Initialize(options.numOfReadBytes,m_options.maxMessageByteSize,m_bufferPoolSet);
+
+	// the write completes on the pipe thread, so blocking the writer may never be released
+	OverflowPolicy writeQueuePolicy=options.writeQueueOverflowPolicy;
+	if(writeQueuePolicy==OVERFLOW_POLICY_BLOCK)
+		writeQueuePolicy=OVERFLOW_POLICY_FAIL;
+	m_writeQueueBound.SetCapacity(options.writeQueueCapacity,writeQueuePolicy);
 }
 IpcPipe::~IpcPipe()
 {
+	if(m_isMetricsRegistered)
+		IPC_METRICS_INSTANCE.Unregister(this);
 	KillConnection();
-	if(m_readBuffer)
-		EP_DELETE m_readBuffer;
+	if(m_options.serverMode==IPC_SERVER_MODE_COMPLETION_PORT && m_pipeHandle!=INVALID_HANDLE_VALUE)
+		CloseHandle(m_pipeHandle);
+	while(m_writeQueue.size())
+	{
+		m_writeQueue.front()->ReleaseObj();
+		m_writeQueue.pop_front();
+	}
 	if(m_writeQueueLock)
 		EP_DELETE m_writeQueueLock;
+	while(m_callbackQueue.size())
+	{
+		if(m_callbackQueue.front().m_data)
+			EP_FreeTag(m_callbackQueue.front().m_data,MEMORY_TAG_IPC);
+		m_callbackQueue.pop_front();
+	}
+	if(m_callbackLock)
+		EP_DELETE m_callbackLock;
+	m_writeBufferPool->ReleaseObj();
+	m_bufferPoolSet->ReleaseObj();
 }
 bool IpcPipe::Create()
 {
@@ -88,6 +152,18 @@ bool IpcPipe::Create()
 		epl::System::OutputDebugString(_T("CreateNamedPipe failed with %d.\r\n"), GetLastError());
 		return false;
 	}
+	if(m_options.serverMode==IPC_SERVER_MODE_COMPLETION_PORT)
+	{
+		EP_ASSERT_EXPR(m_server,_T("The pipe in the completion port mode must be created by the server."));
+		if(!CreateIoCompletionPort(m_pipeHandle,m_server->m_completionPort,reinterpret_cast<ULONG_PTR>(this),0))
+		{
+			epl::System::OutputDebugString(_T("CreateIoCompletionPort failed with %d.\r\n"), GetLastError());
+			CloseHandle(m_pipeHandle);
+			m_pipeHandle=INVALID_HANDLE_VALUE;
+			return false;
+		}
+		return listen();
+	}
 	m_pendingIO=connectToNewClient(m_pipeHandle,&(m_overlap));
 	m_pipeState = m_pendingIO ? 
 		PIPE_STATE_CONNECTING : // still connecting 
@@ -98,13 +174,18 @@ bool IpcPipe::Create()
 
 bool IpcPipe::IsConnectionAlive() const
 {
-	return (m_pipeState!=PIPE_STATE_CONNECTING);
+	return (m_pipeState!=PIPE_STATE_CONNECTING && m_pipeState!=PIPE_STATE_CLOSED);
 		
 }
 void IpcPipe::KillConnection()
 {
 	if(IsConnectionAlive())
-		disconnect();
+	{
+		if(m_options.serverMode==IPC_SERVER_MODE_COMPLETION_PORT)
+			closeInstance();
+		else
+			disconnect();
+	}
 }
 
 void IpcPipe::SetCallbackObject(IpcServerCallbackInterface *callBackObj)
@@ -166,15 +247,16 @@ void IpcPipe::disconnect()
 		return;
 	}
 	m_pipeState=PIPE_STATE_CONNECTING;
-	m_options.callBackObj->OnDisconnect(this);
+	reportCallback(PIPE_CALLBACK_TYPE_DISCONNECT);
 
 	LockObj lock(m_writeQueueLock);
 	while(m_writeQueue.size())
 	{
 		PipeWriteElem *elem=m_writeQueue.front();
-		m_writeQueue.pop();
+		m_writeQueue.pop_front();
 		elem->ReleaseObj();
 	}
+	m_writeQueueBound.ResetHighWaterMark();
 }
 
 void IpcPipe::reconnect()
@@ -196,30 +278,121 @@ void IpcPipe::DisconnectAndReconnect(IpcPipe *pipeInst)
 
 void IpcPipe::Write(char *data,unsigned int dataByteSize)
 {
-	EP_ASSERT(dataByteSize<=m_options.numOfWriteBytes);
-
-	PipeWriteElem *elem=EP_NEW PipeWriteElem(dataByteSize,m_lockPolicy);
+	PipeWriteElem *elem=acquireWriteElem(dataByteSize);
 	System::Memcpy(elem->m_data,data, dataByteSize );
-	
+	queueWrite(elem);
+}
+
+void IpcPipe::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	unsigned int dataByteSize=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		dataByteSize+=segmentList[segmentTrav].m_dataSize;
+
+	PipeWriteElem *elem=acquireWriteElem(dataByteSize);
+	char *dest=elem->m_data;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+	{
+		System::Memcpy(dest,segmentList[segmentTrav].m_data,segmentList[segmentTrav].m_dataSize);
+		dest+=segmentList[segmentTrav].m_dataSize;
+	}
+	queueWrite(elem);
+}
+
+PipeWriteElem *IpcPipe::AcquireWriteBuffer(unsigned int dataByteSize)
+{
+	return acquireWriteElem(dataByteSize);
+}
+
+void IpcPipe::WriteOwned(PipeWriteElem *elem)
+{
+	EP_ASSERT(elem);
+	queueWrite(elem);
+}
+
+unsigned int IpcPipe::GetMaxWriteDataByteSize() const
+{
+	if(getWriteBatchByteSize())
+		return m_options.maxMessageByteSize-IPC_FRAME_HEADER_SIZE;
+	return m_options.maxMessageByteSize;
+}
+
+void IpcPipe::queueWrite(PipeWriteElem *elem)
+{
 	BOOL fWrite = FALSE; 
+	bool isWriteFailed=false;
+	PipeWriteElem *droppedElem=NULL;
+	elem->m_queueTime=WorkerMetrics::GetCurrentMicroSec();
 
-	LockObj lock(m_writeQueueLock);
-	if(m_writeQueue.size())
+	// the message over the maximum message byte size is never written
+	if(elem->m_dataSize>GetMaxWriteDataByteSize())
 	{
-		m_writeQueue.push(elem);
+		reportCallback(PIPE_CALLBACK_TYPE_WRITE,WRITE_STATUS_FAIL_WRITE_FAILED);
+		elem->ReleaseObj();
+		return;
 	}
-	else
+
+	m_writeQueueLock->Lock();
+	switch(m_writeQueueBound.Admit(m_writeQueue.size()))
+	{
+	case QueueBound::ADMISSION_ACCEPT:
+		break;
+	case QueueBound::ADMISSION_DROP_OLDEST:
+		// the front is in progress, so drop the oldest one waiting behind it
+		if(m_writeQueue.size()>1)
+		{
+			droppedElem=m_writeQueue[1];
+			m_writeQueue.erase(m_writeQueue.begin()+1);
+			break;
+		}
+		// fall through, the only one queued is in progress
+	default:
+		droppedElem=elem;
+		elem=NULL;
+		break;
+	}
+	if(elem)
 	{
-		m_writeQueue.push(elem);
-		fWrite = WriteFileEx( 
-			m_pipeHandle, 
-			elem->m_data, 
-			elem->m_dataSize, 
-			(LPOVERLAPPED) this, 
-			(LPOVERLAPPED_COMPLETION_ROUTINE) OnWriteComplete); 
+		if(m_writeQueue.size())
+		{
+			m_writeQueue.push_back(elem);
+		}
+		else
+		{
+			m_writeQueue.push_back(elem);
+			coalesceWrites();
+			elem=m_writeQueue.front();
+			if(m_options.serverMode==IPC_SERVER_MODE_COMPLETION_PORT)
+			{
+				isWriteFailed=!issueWrite();
+			}
+			else
+			{
+				fWrite = WriteFileEx( 
+					m_pipeHandle, 
+					elem->m_data, 
+					elem->m_dataSize, 
+					(LPOVERLAPPED) this, 
+					(LPOVERLAPPED_COMPLETION_ROUTINE) OnWriteComplete); 
+
+				if (IsConnectionAlive() && ! fWrite) 
+					DisconnectAndReconnect(this); 
+			}
+		}
+		m_writeQueueBound.NotifyPushed(m_writeQueue.size());
+		m_metrics.RecordWriteQueueDepth(m_writeQueue.size());
+	}
+	m_writeQueueLock->Unlock();
 
-		if (IsConnectionAlive() && ! fWrite) 
-			DisconnectAndReconnect(this); 
+	if(droppedElem)
+	{
+		reportCallback(PIPE_CALLBACK_TYPE_WRITE,WRITE_STATUS_FAIL_QUEUE_FULL);
+		droppedElem->ReleaseObj();
+	}
+	if(isWriteFailed)
+	{
+		reportCallback(PIPE_CALLBACK_TYPE_WRITE,WRITE_STATUS_FAIL_WRITE_FAILED);
+		KillConnection();
 	}
 
 	//System::Memcpy(m_writeBuffer,data, dataByteSize );
@@ -231,6 +404,34 @@ void IpcPipe::Write(char *data,unsigned int dataByteSize)
 // the pipe, or when a new client has connected to a pipe instance.
 // It starts another read operation. 
 
+void IpcPipe::GetMetrics(IpcMetricsSnapshot &retSnapshot) const
+{
+	m_metrics.GetSnapshot(retSnapshot);
+	retSnapshot.writeQueueDepth=static_cast<__int64>(GetWriteQueueSize());
+}
+
+void IpcPipe::SetMetricsName(const TCHAR *name)
+{
+	IPC_METRICS_INSTANCE.Register(this,name);
+	m_isMetricsRegistered=true;
+}
+
+size_t IpcPipe::GetWriteQueueSize() const
+{
+	LockObj lock(m_writeQueueLock);
+	return m_writeQueue.size();
+}
+
+size_t IpcPipe::GetWriteQueueHighWaterMark() const
+{
+	return m_writeQueueBound.GetHighWaterMark();
+}
+
+size_t IpcPipe::GetWriteQueueDropCount() const
+{
+	return m_writeQueueBound.GetDropCount();
+}
+
 void IpcPipe::OnWriteComplete(DWORD dwErr, DWORD cbWritten, LPOVERLAPPED lpOverLap) 
 { 
 	IpcPipe *pipeInst; 
@@ -244,18 +445,19 @@ void IpcPipe::OnWriteComplete(DWORD dwErr, DWORD cbWritten, LPOVERLAPPED lpOverL
 	if(pipeInst->m_writeQueue.size())
 	{
 		PipeWriteElem *elem=pipeInst->m_writeQueue.front();
-		pipeInst->m_writeQueue.pop();
+		pipeInst->m_writeQueue.pop_front();
 
 		// The write operation has finished, so read the next request (if 
 		// there is no error). 
 
 		if ((dwErr == 0) && (cbWritten == elem->m_dataSize)) 
 		{
-			pipeInst->m_options.callBackObj->OnWriteComplete(pipeInst,cbWritten,WRITE_STATUS_SUCCESS,dwErr); 
+			pipeInst->reportWrite(elem,WRITE_STATUS_SUCCESS,dwErr,cbWritten); 
 			if(pipeInst->IsConnectionAlive())
 			{
 				if(pipeInst->m_writeQueue.size())
 				{
+					pipeInst->coalesceWrites();
 					PipeWriteElem *nextElem=pipeInst->m_writeQueue.front();
 					fWrite = WriteFileEx( 
 						pipeInst->m_pipeHandle, 
@@ -268,7 +470,7 @@ void IpcPipe::OnWriteComplete(DWORD dwErr, DWORD cbWritten, LPOVERLAPPED lpOverL
 		}
 		else
 		{
-			pipeInst->m_options.callBackObj->OnWriteComplete(pipeInst,cbWritten,WRITE_STATUS_FAIL_WRITE_FAILED,dwErr); 
+			pipeInst->reportWrite(elem,WRITE_STATUS_FAIL_WRITE_FAILED,dwErr,cbWritten); 
 		}
 		elem->ReleaseObj();
 
@@ -318,23 +520,32 @@ void IpcPipe::OnReadComplete(DWORD dwErr, DWORD cbBytesRead, LPOVERLAPPED lpOver
 	// The read operation has finished, so write a response (if no 
 	// error occurred). 
 	BOOL fRead = FALSE;
+	bool isReading=false;
 	if ((dwErr == 0) && (cbBytesRead != 0)) 
 	{ 
-		pipeInst->m_options.callBackObj->OnReadComplete(pipeInst,pipeInst->m_readBuffer,cbBytesRead,READ_STATUS_SUCCESS,dwErr); 
-		if(pipeInst->IsConnectionAlive())
-		{
-			fRead = ReadFileEx( 
-				pipeInst->m_pipeHandle, 
-				pipeInst->m_readBuffer, 
-				pipeInst->m_options.numOfReadBytes, 
-				(LPOVERLAPPED) pipeInst, 
-				(LPOVERLAPPED_COMPLETION_ROUTINE) OnReadComplete); 
-
-		}
+		pipeInst->reportRead(dwErr,cbBytesRead); 
+		isReading=true;
 	} 
+	else if(dwErr==ERROR_MORE_DATA && pipeInst->growRead(cbBytesRead))
+	{
+		// the rest of the message is read after the part already read
+		isReading=true;
+	}
 	else
 	{
-		pipeInst->m_options.callBackObj->OnReadComplete(pipeInst,pipeInst->m_readBuffer,cbBytesRead,READ_STATUS_FAIL_READ_FAILED,dwErr); 
+		unsigned int byteSize=pipeInst->m_readBuffer.Complete(cbBytesRead);
+		pipeInst->reportCallback(PIPE_CALLBACK_TYPE_READ,READ_STATUS_FAIL_READ_FAILED,dwErr,byteSize,pipeInst->m_readBuffer.GetData()); 
+		pipeInst->m_readBuffer.Reset();
+	}
+
+	if(isReading && pipeInst->IsConnectionAlive())
+	{
+		fRead = ReadFileEx( 
+			pipeInst->m_pipeHandle, 
+			pipeInst->m_readBuffer.GetReadPosition(), 
+			pipeInst->m_readBuffer.GetReadByteSize(), 
+			(LPOVERLAPPED) pipeInst, 
+			(LPOVERLAPPED_COMPLETION_ROUTINE) OnReadComplete); 
 	}
 
 	if (pipeInst->IsConnectionAlive() && ! fRead) 
@@ -362,3 +573,353 @@ void IpcPipe::OnReadComplete(DWORD dwErr, DWORD cbBytesRead, LPOVERLAPPED lpOver
 
 } 
 
+
+void IpcPipe::retainIo(IpcPipeOverlapped &io, PipeIoType ioType)
+{
+	System::Memset(&io.m_overlap,0,sizeof(OVERLAPPED));
+	io.m_ioType=ioType;
+	RetainObj();
+	InterlockedIncrement(&m_server->m_ioCount);
+}
+
+void IpcPipe::releaseIo()
+{
+	m_server->releaseIo(this);
+}
+
+bool IpcPipe::listen()
+{
+	LockObj lock(m_writeQueueLock);
+	m_pipeState=PIPE_STATE_CONNECTING;
+	retainIo(m_readOverlap,PIPE_IO_TYPE_CONNECT);
+	if(ConnectNamedPipe(m_pipeHandle,&m_readOverlap.m_overlap))
+		return true;
+
+	switch(GetLastError())
+	{
+	case ERROR_IO_PENDING:
+		return true;
+	case ERROR_PIPE_CONNECTED:
+		// the client connected before the connect is issued, so the completion is queued manually.
+		if(PostQueuedCompletionStatus(m_server->m_completionPort,0,reinterpret_cast<ULONG_PTR>(this),&m_readOverlap.m_overlap))
+			return true;
+		break;
+	default:
+		break;
+	}
+	epl::System::OutputDebugString(_T("ConnectNamedPipe failed with %d.\r\n"), GetLastError());
+	releaseIo();
+	return false;
+}
+
+bool IpcPipe::startRead()
+{
+	LockObj lock(m_writeQueueLock);
+	if(!IsConnectionAlive())
+		return false;
+	retainIo(m_readOverlap,PIPE_IO_TYPE_READ);
+	if(ReadFile(m_pipeHandle,m_readBuffer.GetReadPosition(),m_readBuffer.GetReadByteSize(),NULL,&m_readOverlap.m_overlap))
+		return true;
+
+	// the message longer than the read buffer is still completed through the port with ERROR_MORE_DATA.
+	unsigned long errCode=GetLastError();
+	if(errCode==ERROR_IO_PENDING || errCode==ERROR_MORE_DATA)
+		return true;
+	releaseIo();
+	return false;
+}
+
+bool IpcPipe::issueWrite()
+{
+	PipeWriteElem *elem=m_writeQueue.front();
+	if(IsConnectionAlive())
+	{
+		retainIo(m_writeOverlap,PIPE_IO_TYPE_WRITE);
+		if(WriteFile(m_pipeHandle,elem->m_data,elem->m_dataSize,NULL,&m_writeOverlap.m_overlap) || GetLastError()==ERROR_IO_PENDING)
+			return true;
+		releaseIo();
+	}
+	m_writeQueue.pop_front();
+	elem->ReleaseObj();
+	return false;
+}
+
+bool IpcPipe::onConnectCompletion(bool success)
+{
+	LockObj lock(m_writeQueueLock);
+	if(!success || m_pipeState!=PIPE_STATE_CONNECTING)
+		return false;
+	m_pipeState=PIPE_STATE_READING;
+	return true;
+}
+
+void IpcPipe::onWriteCompletion(bool success, DWORD cbWritten, DWORD dwErr)
+{
+	PipeWriteElem *elem=NULL;
+	bool isNextWriteFailed=false;
+
+	m_writeQueueLock->Lock();
+	if(m_writeQueue.size())
+	{
+		elem=m_writeQueue.front();
+		m_writeQueue.pop_front();
+		success=success && (cbWritten==elem->m_dataSize);
+		// the next write is issued before the report, so the queue always has the write in progress at the front.
+		if(success && m_writeQueue.size())
+		{
+			coalesceWrites();
+			isNextWriteFailed=!issueWrite();
+		}
+	}
+	m_writeQueueLock->Unlock();
+
+	if(!elem)
+		return;
+	if(success)
+		reportWrite(elem,WRITE_STATUS_SUCCESS,dwErr,cbWritten);
+	else
+		reportWrite(elem,WRITE_STATUS_FAIL_WRITE_FAILED,dwErr,cbWritten);
+	if(isNextWriteFailed)
+		reportCallback(PIPE_CALLBACK_TYPE_WRITE,WRITE_STATUS_FAIL_WRITE_FAILED);
+	elem->ReleaseObj();
+
+	if(!success || isNextWriteFailed)
+		KillConnection();
+}
+
+void IpcPipe::closeInstance()
+{
+	m_writeQueueLock->Lock();
+	if(m_pipeState==PIPE_STATE_CLOSED)
+	{
+		m_writeQueueLock->Unlock();
+		return;
+	}
+	bool isConnected=IsConnectionAlive();
+	m_pipeState=PIPE_STATE_CLOSED;
+	if(isConnected)
+		DisconnectNamedPipe(m_pipeHandle);
+	// closing the handle completes the pending I/O with the failure.
+	CloseHandle(m_pipeHandle);
+	m_pipeHandle=INVALID_HANDLE_VALUE;
+
+	// the front is in progress, so it is released when its write completes.
+	while(m_writeQueue.size()>1)
+	{
+		PipeWriteElem *elem=m_writeQueue.back();
+		m_writeQueue.pop_back();
+		elem->ReleaseObj();
+	}
+	m_writeQueueBound.ResetHighWaterMark();
+	m_writeQueueLock->Unlock();
+
+	if(isConnected)
+		reportCallback(PIPE_CALLBACK_TYPE_DISCONNECT);
+}
+
+PipeWriteElem *IpcPipe::acquireWriteElem(unsigned int dataByteSize)
+{
+	if(dataByteSize<=m_writeBufferPool->GetBufferByteSize())
+		return m_writeBufferPool->Acquire(dataByteSize);
+	return m_bufferPoolSet->Acquire(dataByteSize);
+}
+
+unsigned int IpcPipe::getWriteBatchByteSize() const
+{
+	if(m_options.writeBatchByteSize>m_options.numOfWriteBytes)
+		return m_options.numOfWriteBytes;
+	return m_options.writeBatchByteSize;
+}
+
+void IpcPipe::coalesceWrites()
+{
+	unsigned int batchByteSize=getWriteBatchByteSize();
+	if(!batchByteSize || m_writeQueue.empty())
+		return;
+
+	PipeWriteElem *front=m_writeQueue.front();
+	if(front->m_dataSize>batchByteSize-IPC_FRAME_HEADER_SIZE)
+	{
+		// the message longer than the batch goes out alone in its own frame
+		PipeWriteElem *frame=acquireWriteElem(front->m_dataSize+IPC_FRAME_HEADER_SIZE);
+		frame->m_dataSize=0;
+		frame->m_queueTime=front->m_queueTime;
+		IpcFrame::AppendFrame(frame,front->m_dataSize+IPC_FRAME_HEADER_SIZE,front);
+		m_writeQueue.pop_front();
+		front->ReleaseObj();
+		m_writeQueue.push_front(frame);
+		return;
+	}
+
+	// the writes queued while the previous one was in progress go out together
+	PipeWriteElem *batch=m_writeBufferPool->Acquire(0);
+	// the latency of the batch is measured from its oldest write
+	batch->m_queueTime=front->m_queueTime;
+	while(m_writeQueue.size())
+	{
+		PipeWriteElem *elem=m_writeQueue.front();
+		if(!IpcFrame::AppendFrame(batch,batchByteSize,elem))
+			break;
+		m_writeQueue.pop_front();
+		elem->ReleaseObj();
+	}
+	m_writeQueue.push_front(batch);
+}
+
+void IpcPipe::reportWrite(const PipeWriteElem *elem, WriteStatus status, unsigned long errCode, unsigned int cbWritten)
+{
+	__int64 latency=WorkerMetrics::GetCurrentMicroSec()-elem->m_queueTime;
+	if(!getWriteBatchByteSize())
+	{
+		if(status==WRITE_STATUS_SUCCESS)
+			m_metrics.RecordWrite(cbWritten,latency);
+		reportCallback(PIPE_CALLBACK_TYPE_WRITE,status,errCode,cbWritten);
+		return;
+	}
+	unsigned int offset=0;
+	const char *frame=NULL;
+	unsigned int frameSize=0;
+	while(IpcFrame::NextFrame(elem->m_data,elem->m_dataSize,offset,frame,frameSize))
+	{
+		if(status==WRITE_STATUS_SUCCESS)
+			m_metrics.RecordWrite(frameSize,latency);
+		reportCallback(PIPE_CALLBACK_TYPE_WRITE,status,errCode,frameSize);
+	}
+}
+
+void IpcPipe::reportRead(unsigned long errCode, unsigned int cbBytesRead)
+{
+	unsigned int byteSize=m_readBuffer.Complete(cbBytesRead);
+	const char *data=m_readBuffer.GetData();
+	if(!getWriteBatchByteSize())
+		reportCallback(PIPE_CALLBACK_TYPE_READ,READ_STATUS_SUCCESS,errCode,byteSize,data);
+	else
+	{
+		unsigned int offset=0;
+		const char *frame=NULL;
+		unsigned int frameSize=0;
+		while(IpcFrame::NextFrame(data,byteSize,offset,frame,frameSize))
+			reportCallback(PIPE_CALLBACK_TYPE_READ,READ_STATUS_SUCCESS,errCode,frameSize,frame);
+		if(offset!=byteSize)
+			reportCallback(PIPE_CALLBACK_TYPE_READ,READ_STATUS_FAIL_READ_FAILED,errCode,byteSize-offset,data+offset);
+	}
+	// the callbacks are delivered or copied already, so the buffer of the long message goes back to the pool set
+	m_readBuffer.Reset();
+}
+
+bool IpcPipe::growRead(unsigned int cbBytesRead)
+{
+	// the byte size left in the message lets the buffer grow once
+	DWORD leftByteSize=0;
+	if(!PeekNamedPipe(m_pipeHandle,NULL,0,NULL,NULL,&leftByteSize))
+		leftByteSize=0;
+	return m_readBuffer.Grow(cbBytesRead,leftByteSize);
+}
+
+void IpcPipe::reportCallback(PipeCallbackType type, int status, unsigned long errCode, unsigned int byteSize, const char *data)
+{
+	switch(type)
+	{
+	case PIPE_CALLBACK_TYPE_NEW_CONNECTION:
+		m_metrics.RecordConnect();
+		break;
+	case PIPE_CALLBACK_TYPE_READ:
+		if(status==READ_STATUS_SUCCESS)
+			m_metrics.RecordRead(byteSize);
+		else
+			m_metrics.RecordReadFailure();
+		break;
+	case PIPE_CALLBACK_TYPE_WRITE:
+		// the successful write is recorded with its latency by reportWrite
+		if(status==WRITE_STATUS_FAIL_QUEUE_FULL)
+			m_metrics.RecordDroppedWrite();
+		else if(status!=WRITE_STATUS_SUCCESS)
+			m_metrics.RecordWriteFailure();
+		break;
+	case PIPE_CALLBACK_TYPE_DISCONNECT:
+		m_metrics.RecordDisconnect();
+		break;
+	default:
+		break;
+	}
+
+	IpcPipeCallback callback;
+	callback.m_type=type;
+	callback.m_status=status;
+	callback.m_errCode=errCode;
+	callback.m_byteSize=byteSize;
+	callback.m_data=const_cast<char*>(data);
+	if(!m_server || (!m_options.callbackPool && !m_options.callbackWorkerPool))
+	{
+		deliverCallback(callback);
+		return;
+	}
+
+	// the read buffer is reused by the next read, so the data is copied for the dispatch.
+	callback.m_data=NULL;
+	if(data && byteSize)
+	{
+		callback.m_data=reinterpret_cast<char*>(EP_MallocTag(byteSize,MEMORY_TAG_IPC));
+		System::Memcpy(callback.m_data,data,byteSize);
+	}
+
+	m_callbackLock->Lock();
+	m_callbackQueue.push_back(callback);
+	bool isScheduled=m_isCallbackScheduled;
+	m_isCallbackScheduled=true;
+	m_callbackLock->Unlock();
+
+	// only one dispatch job runs for this instance at a time, so the callbacks are delivered in order.
+	if(!isScheduled)
+		m_server->scheduleCallbacks(this);
+}
+
+void IpcPipe::deliverCallback(const IpcPipeCallback &callback)
+{
+	switch(callback.m_type)
+	{
+	case PIPE_CALLBACK_TYPE_NEW_CONNECTION:
+		m_options.callBackObj->OnNewConnection(this);
+		break;
+	case PIPE_CALLBACK_TYPE_READ:
+		m_options.callBackObj->OnReadComplete(this,callback.m_data,callback.m_byteSize,static_cast<ReadStatus>(callback.m_status),callback.m_errCode);
+		break;
+	case PIPE_CALLBACK_TYPE_WRITE:
+		m_options.callBackObj->OnWriteComplete(this,callback.m_byteSize,static_cast<WriteStatus>(callback.m_status),callback.m_errCode);
+		break;
+	case PIPE_CALLBACK_TYPE_DISCONNECT:
+		m_options.callBackObj->OnDisconnect(this);
+		break;
+	default:
+		break;
+	}
+}
+
+bool IpcPipe::deliverQueuedCallbacks(unsigned int maxCount)
+{
+	for(unsigned int callbackTrav=0;callbackTrav<maxCount;callbackTrav++)
+	{
+		m_callbackLock->Lock();
+		if(m_callbackQueue.empty())
+		{
+			m_isCallbackScheduled=false;
+			m_callbackLock->Unlock();
+			return false;
+		}
+		IpcPipeCallback callback=m_callbackQueue.front();
+		m_callbackQueue.pop_front();
+		m_callbackLock->Unlock();
+
+		deliverCallback(callback);
+		if(callback.m_data)
+			EP_FreeTag(callback.m_data,MEMORY_TAG_IPC);
+	}
+
+	LockObj lock(m_callbackLock);
+	if(m_callbackQueue.empty())
+	{
+		m_isCallbackScheduled=false;
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,373 @@
+/*! 
+IpcRpc for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epIpcRpc.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+namespace epl
+{
+	/*!
+	Create the lock of given lock policy.
+	@param[in] lockPolicyType the lock policy.
+	@return the new lock, or NULL if the lock policy is unknown.
+	*/
+	static BaseLock *createLock(LockPolicy lockPolicyType)
+	{
+		switch(lockPolicyType)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			return EP_NEW CriticalSectionEx();
+		case LOCK_POLICY_MUTEX:
+			return EP_NEW Mutex();
+		case LOCK_POLICY_NONE:
+			return EP_NEW NoLock();
+		case LOCK_POLICY_SPIN_PARK:
+			return EP_NEW SpinParkLock();
+		case LOCK_POLICY_READER_WRITER:
+			return EP_NEW ReaderWriterLock();
+		default:
+			return NULL;
+		}
+	}
+}
+
+IpcRpcFuture::IpcRpcFuture(unsigned int correlationId, LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_readyEvent(false,true)
+{
+	m_correlationId=correlationId;
+	m_isReady=0;
+	m_waiterCount=0;
+	m_status=IPC_RPC_STATUS_NONE;
+}
+
+IpcRpcFuture::~IpcRpcFuture()
+{
+}
+
+unsigned int IpcRpcFuture::GetCorrelationId() const
+{
+	return m_correlationId;
+}
+
+bool IpcRpcFuture::IsReady() const
+{
+	return m_isReady!=0;
+}
+
+bool IpcRpcFuture::Wait(unsigned int waitTimeInMilliSec)
+{
+	if(m_isReady)
+		return true;
+	if(waitTimeInMilliSec==0)
+		return false;
+	InterlockedIncrement(&m_waiterCount);
+	bool retVal=true;
+	if(!m_isReady)
+		retVal=m_readyEvent.WaitForEvent(waitTimeInMilliSec);
+	InterlockedDecrement(&m_waiterCount);
+	return retVal;
+}
+
+IpcRpcStatus IpcRpcFuture::GetStatus() const
+{
+	if(!m_isReady)
+		return IPC_RPC_STATUS_NONE;
+	return m_status;
+}
+
+const char *IpcRpcFuture::GetResponse() const
+{
+	if(!m_isReady || m_response.empty())
+		return NULL;
+	return &m_response[0];
+}
+
+unsigned int IpcRpcFuture::GetResponseByteSize() const
+{
+	if(!m_isReady)
+		return 0;
+	return static_cast<unsigned int>(m_response.size());
+}
+
+void IpcRpcFuture::complete(IpcRpcStatus status, const char *response, unsigned int responseByteSize)
+{
+	EP_ASSERT_EXPR(!m_isReady,_T("The future is already completed."));
+	if(response && responseByteSize)
+		m_response.assign(response,response+responseByteSize);
+	m_status=status;
+	InterlockedExchange(&m_isReady,1);
+	// only touch the kernel event when someone is actually blocked on it
+	if(m_waiterCount>0)
+		m_readyEvent.SetEvent();
+}
+
+IpcRpcClient::IpcRpcClient(IpcClientInterface *client, unsigned int maxInFlightCount, LockPolicy lockPolicyType):m_window(maxInFlightCount)
+{
+	EP_ASSERT_EXPR(client,_T("The IPC client is NULL."));
+	EP_ASSERT_EXPR(maxInFlightCount>0,_T("The maximum number of the calls in flight must be greater than 0."));
+	m_client=client;
+	m_maxInFlightCount=maxInFlightCount;
+	m_lastCorrelationId=0;
+	m_lockPolicy=lockPolicyType;
+	m_pendingLock=createLock(lockPolicyType);
+	m_writeOrderLock=createLock(lockPolicyType);
+	m_writeLock=createLock(lockPolicyType);
+}
+
+IpcRpcClient::~IpcRpcClient()
+{
+	CancelAll();
+	if(m_pendingLock)
+		EP_DELETE m_pendingLock;
+	if(m_writeOrderLock)
+		EP_DELETE m_writeOrderLock;
+	if(m_writeLock)
+		EP_DELETE m_writeLock;
+}
+
+IpcRpcFuture *IpcRpcClient::Call(const char *request, unsigned int requestByteSize, unsigned int waitTimeInMilliSec)
+{
+	unsigned int correlationId=static_cast<unsigned int>(InterlockedIncrement(&m_lastCorrelationId));
+	IpcRpcFuture *future=EP_NEW IpcRpcFuture(correlationId,m_lockPolicy);
+	if(!m_client->IsConnected())
+	{
+		future->complete(IPC_RPC_STATUS_FAIL_DISCONNECTED);
+		return future;
+	}
+	if(requestByteSize>GetMaxRequestByteSize())
+	{
+		future->complete(IPC_RPC_STATUS_FAIL_WRITE_FAILED);
+		return future;
+	}
+	if(!m_window.TryLockFor(waitTimeInMilliSec))
+	{
+		future->complete(IPC_RPC_STATUS_FAIL_BUSY);
+		return future;
+	}
+
+	m_pendingLock->Lock();
+	future->RetainObj();
+	m_pendingMap[correlationId]=future;
+	m_pendingLock->Unlock();
+
+	IpcRpcHeader header;
+	header.m_correlationId=correlationId;
+	header.m_messageType=IPC_RPC_MESSAGE_TYPE_REQUEST;
+	IpcWriteSegment segmentList[2];
+	segmentList[0].m_data=&header;
+	segmentList[0].m_dataSize=sizeof(IpcRpcHeader);
+	segmentList[1].m_data=request;
+	segmentList[1].m_dataSize=requestByteSize;
+
+	// the write completions come in the order written, so the order is recorded with the write
+	LockObj lock(m_writeLock);
+	m_writeOrderLock->Lock();
+	m_writeOrder.push_back(correlationId);
+	m_writeOrderLock->Unlock();
+	m_client->Write(segmentList,2);
+	return future;
+}
+
+bool IpcRpcClient::Cancel(IpcRpcFuture *future)
+{
+	EP_ASSERT(future);
+	return finish(future->GetCorrelationId(),IPC_RPC_STATUS_CANCELLED);
+}
+
+void IpcRpcClient::CancelAll()
+{
+	finishAll(IPC_RPC_STATUS_CANCELLED);
+}
+
+unsigned int IpcRpcClient::GetInFlightCount() const
+{
+	LockObj lock(m_pendingLock);
+	return static_cast<unsigned int>(m_pendingMap.size());
+}
+
+unsigned int IpcRpcClient::GetMaxInFlightCount() const
+{
+	return m_maxInFlightCount;
+}
+
+unsigned int IpcRpcClient::GetMaxRequestByteSize() const
+{
+	unsigned int maxWriteDataByteSize=m_client->GetMaxWriteDataByteSize();
+	if(maxWriteDataByteSize<sizeof(IpcRpcHeader))
+		return 0;
+	return maxWriteDataByteSize-sizeof(IpcRpcHeader);
+}
+
+bool IpcRpcClient::finish(unsigned int correlationId, IpcRpcStatus status, const char *response, unsigned int responseByteSize)
+{
+	m_pendingLock->Lock();
+	std::map<unsigned int,IpcRpcFuture*>::iterator iter=m_pendingMap.find(correlationId);
+	if(iter==m_pendingMap.end())
+	{
+		m_pendingLock->Unlock();
+		return false;
+	}
+	IpcRpcFuture *future=iter->second;
+	m_pendingMap.erase(iter);
+	m_pendingLock->Unlock();
+
+	future->complete(status,response,responseByteSize);
+	future->ReleaseObj();
+	m_window.Unlock();
+	return true;
+}
+
+void IpcRpcClient::finishAll(IpcRpcStatus status)
+{
+	std::map<unsigned int,IpcRpcFuture*> pendingMap;
+	m_pendingLock->Lock();
+	pendingMap.swap(m_pendingMap);
+	m_pendingLock->Unlock();
+
+	std::map<unsigned int,IpcRpcFuture*>::iterator iter;
+	for(iter=pendingMap.begin();iter!=pendingMap.end();iter++)
+	{
+		iter->second->complete(status);
+		iter->second->ReleaseObj();
+		m_window.Unlock();
+	}
+}
+
+void IpcRpcClient::OnReadComplete(IpcClientInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode)
+{
+	if(status!=READ_STATUS_SUCCESS || receivedDataByteSize<sizeof(IpcRpcHeader))
+		return;
+	IpcRpcHeader header;
+	System::Memcpy(&header,receivedData,sizeof(IpcRpcHeader));
+	const char *response=receivedData+sizeof(IpcRpcHeader);
+	unsigned int responseByteSize=receivedDataByteSize-sizeof(IpcRpcHeader);
+	switch(header.m_messageType)
+	{
+	case IPC_RPC_MESSAGE_TYPE_RESPONSE:
+		finish(header.m_correlationId,IPC_RPC_STATUS_SUCCESS,response,responseByteSize);
+		break;
+	case IPC_RPC_MESSAGE_TYPE_FAULT:
+		finish(header.m_correlationId,IPC_RPC_STATUS_FAULT,response,responseByteSize);
+		break;
+	default:
+		// the response of the call already cancelled, or unknown message
+		break;
+	}
+}
+
+void IpcRpcClient::OnWriteComplete(IpcClientInterface *pipe,unsigned int writtenDataByteSize, WriteStatus status, unsigned long errCode)
+{
+	m_writeOrderLock->Lock();
+	if(m_writeOrder.empty())
+	{
+		m_writeOrderLock->Unlock();
+		return;
+	}
+	unsigned int correlationId=m_writeOrder.front();
+	m_writeOrder.pop_front();
+	m_writeOrderLock->Unlock();
+
+	if(status!=WRITE_STATUS_SUCCESS)
+		finish(correlationId,IPC_RPC_STATUS_FAIL_WRITE_FAILED);
+}
+
+void IpcRpcClient::OnDisconnect(IpcClientInterface *pipe)
+{
+	m_writeOrderLock->Lock();
+	m_writeOrder.clear();
+	m_writeOrderLock->Unlock();
+	finishAll(IPC_RPC_STATUS_FAIL_DISCONNECTED);
+}
+
+IpcRpcServer::IpcRpcServer(IpcRpcRequestHandlerInterface *handler)
+{
+	EP_ASSERT_EXPR(handler,_T("The request handler is NULL."));
+	m_handler=handler;
+}
+
+IpcRpcServer::~IpcRpcServer()
+{
+}
+
+void IpcRpcServer::Respond(IpcInterface *pipe, unsigned int correlationId, const char *response, unsigned int responseByteSize)
+{
+	send(pipe,correlationId,IPC_RPC_MESSAGE_TYPE_RESPONSE,response,responseByteSize);
+}
+
+void IpcRpcServer::RespondFault(IpcInterface *pipe, unsigned int correlationId, const char *reason, unsigned int reasonByteSize)
+{
+	send(pipe,correlationId,IPC_RPC_MESSAGE_TYPE_FAULT,reason,reasonByteSize);
+}
+
+unsigned int IpcRpcServer::GetMaxResponseByteSize(const IpcInterface *pipe)
+{
+	EP_ASSERT(pipe);
+	unsigned int maxWriteDataByteSize=pipe->GetMaxWriteDataByteSize();
+	if(maxWriteDataByteSize<sizeof(IpcRpcHeader))
+		return 0;
+	return maxWriteDataByteSize-sizeof(IpcRpcHeader);
+}
+
+void IpcRpcServer::send(IpcInterface *pipe, unsigned int correlationId, IpcRpcMessageType messageType, const char *data, unsigned int dataByteSize)
+{
+	EP_ASSERT(pipe);
+	EP_ASSERT(dataByteSize<=GetMaxResponseByteSize(pipe));
+	IpcRpcHeader header;
+	header.m_correlationId=correlationId;
+	header.m_messageType=messageType;
+	IpcWriteSegment segmentList[2];
+	segmentList[0].m_data=&header;
+	segmentList[0].m_dataSize=sizeof(IpcRpcHeader);
+	segmentList[1].m_data=data;
+	segmentList[1].m_dataSize=data?dataByteSize:0;
+	pipe->Write(segmentList,2);
+}
+
+void IpcRpcServer::OnNewConnection(IpcInterface *pipe)
+{
+	m_handler->OnNewConnection(pipe);
+}
+
+void IpcRpcServer::OnReadComplete(IpcInterface *pipe,const char*receivedData, unsigned int receivedDataByteSize, ReadStatus status, unsigned long errCode)
+{
+	if(status!=READ_STATUS_SUCCESS || receivedDataByteSize<sizeof(IpcRpcHeader))
+		return;
+	IpcRpcHeader header;
+	System::Memcpy(&header,receivedData,sizeof(IpcRpcHeader));
+	if(header.m_messageType!=IPC_RPC_MESSAGE_TYPE_REQUEST)
+		return;
+	m_handler->OnRequest(pipe,header.m_correlationId,receivedData+sizeof(IpcRpcHeader),receivedDataByteSize-sizeof(IpcRpcHeader));
+}
+
+void IpcRpcServer::OnDisconnect(IpcInterface *pipe)
+{
+	m_handler->OnDisconnect(pipe);
+}
@@ -24,6 +24,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epIpcServer.h"
+#include "epThreadPool.h"
+#include "epElasticWorkerPool.h"
+#include <algorithm>
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -33,7 +36,125 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
-IpcServer::IpcServer(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+namespace epl
+{
+	/*!
+	@class IpcCompletionThread epIpcServer.cpp
+	@brief A thread which serves the completion port of the IPC Server.
+	*/
+	class IpcCompletionThread:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the thread
+		@param[in] server the server to serve
+		@param[in] lockPolicyType lock policy
+		*/
+		IpcCompletionThread(IpcServer *server,LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+		{
+			m_server=server;
+		}
+	protected:
+		/*!
+		Dequeue and handle the completions until the server stops
+		*/
+		virtual void execute()
+		{
+			m_server->processCompletions();
+		}
+	private:
+		/// the server to serve
+		IpcServer *m_server;
+	};
+
+	/*!
+	@class IpcCallbackJob epIpcServer.cpp
+	@brief A job which delivers the queued callbacks of one pipe on the callback pool.
+	*/
+	class IpcCallbackJob:public BaseJob
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the job
+		@param[in] server the server owning the pipe
+		@param[in] pipeInst the pipe whose callbacks are queued
+		@param[in] lockPolicyType lock policy
+		*/
+		IpcCallbackJob(IpcServer *server,IpcPipe *pipeInst,LockPolicy lockPolicyType):BaseJob(PRIORITY_NORMAL,lockPolicyType)
+		{
+			m_server=server;
+			m_pipe=pipeInst;
+			m_pipe->RetainObj();
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~IpcCallbackJob()
+		{
+			m_pipe->ReleaseObj();
+		}
+
+		/// the server owning the pipe
+		IpcServer *m_server;
+		/// the pipe whose callbacks are queued
+		IpcPipe *m_pipe;
+	protected:
+		/*!
+		Deliver the callbacks on the reporting thread if the job is dropped, so they are never lost.
+		@param[in] status The Status of the Job
+		*/
+		virtual void handleReport(const JobStatus status)
+		{
+			switch(status)
+			{
+			case JOB_STATUS_INCOMPLETE:
+			case JOB_STATUS_JOB_PROCESSOR_TIMEOUT:
+			case JOB_STATUS_TIMEOUT:
+			case JOB_STATUS_CANCELLED:
+				m_server->dispatchCallbacks(m_pipe,true);
+				break;
+			default:
+				break;
+			}
+		}
+	};
+
+	/*!
+	@class IpcCallbackJobProcessor epIpcServer.cpp
+	@brief A job processor which delivers the queued callbacks of the IpcCallbackJob.
+	*/
+	class IpcCallbackJobProcessor:public BaseJobProcessor
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the job processor
+		@param[in] lockPolicyType lock policy
+		*/
+		IpcCallbackJobProcessor(LockPolicy lockPolicyType):BaseJobProcessor(lockPolicyType)
+		{
+		}
+
+		/*!
+		Deliver the queued callbacks of the IpcCallbackJob.
+		@param[in] workerThread The worker thread which called the DoJob.
+		@param[in] data The IpcCallbackJob given to this object.
+		*/
+		virtual void DoJob(BaseWorkerThread *workerThread, BaseJob* const data)
+		{
+			IpcCallbackJob *job=static_cast<IpcCallbackJob*>(data);
+			job->m_server->dispatchCallbacks(job->m_pipe);
+		}
+	};
+}
+
+IpcServer::IpcServer(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_metrics(lockPolicyType)
 {
 	m_lockPolicy=lockPolicyType;
 	switch(m_lockPolicy)
@@ -47,18 +168,42 @@ IpcServer::IpcServer(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_N
 	case LOCK_POLICY_NONE:
 		m_pipesLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_pipesLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_pipesLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_pipesLock=NULL;
 		break;
 	}
 	m_serverThreadEvent=EventEx(false,false);
+	m_started=false;
+	m_completionPort=NULL;
+	m_listeningCount=0;
+	m_ioCount=0;
+	m_ioDrainedEvent=EventEx(false,true);
+	m_callbackProcessor=EP_NEW IpcCallbackJobProcessor(lockPolicyType);
+	m_writeBufferPool=NULL;
+	m_bufferPoolSet=NULL;
+	m_isMetricsRegistered=false;
+	m_callbackJobCount=0;
+	m_callbackDrainedEvent=EventEx(false,true);
 }
 
 IpcServer::~IpcServer()
 {
+	if(m_isMetricsRegistered)
+		IPC_METRICS_INSTANCE.Unregister(this);
 	StopServer();
 	if(m_pipesLock)
 		EP_DELETE m_pipesLock;
+	m_callbackProcessor->ReleaseObj();
+	if(m_writeBufferPool)
+		m_writeBufferPool->ReleaseObj();
+	if(m_bufferPoolSet)
+		m_bufferPoolSet->ReleaseObj();
 }
 
 epl::EpTString IpcServer::GetFullPipeName() const
@@ -82,6 +227,8 @@ bool IpcServer::StartServer(const IpcServerOps &ops)
 {
 	EP_ASSERT(ops.maximumInstances<=PIPE_UNLIMITED_INSTANCES);
 	EP_ASSERT(ops.callBackObj);
+	EP_ASSERT(ops.writeBatchByteSize==0 || ops.writeBatchByteSize>IPC_FRAME_HEADER_SIZE);
+	EP_ASSERT(ops.writeBatchByteSize==0 || ops.maxMessageByteSize==0 || ops.maxMessageByteSize>IPC_FRAME_HEADER_SIZE);
 	if(ops.pipeName)
 	{
 		m_pipeName=_T("\\\\");
@@ -95,13 +242,39 @@ bool IpcServer::StartServer(const IpcServerOps &ops)
 		m_options.numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
 	if(ops.numOfReadBytes==0)
 		m_options.numOfReadBytes=DEFAULT_READ_BUF_SIZE;
+	if(ops.maxMessageByteSize==0)
+		m_options.maxMessageByteSize=IPC_MESSAGE_BYTE_SIZE_UNLIMITED;
 
-	
+	if(!m_writeBufferPool || m_writeBufferPool->GetBufferByteSize()!=m_options.numOfWriteBytes)
+	{
+		// the instances still alive keep the old pool until destroyed
+		if(m_writeBufferPool)
+			m_writeBufferPool->ReleaseObj();
+		m_writeBufferPool=EP_NEW IpcWriteBufferPool(m_options.numOfWriteBytes,IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT,m_lockPolicy);
+	}
+	unsigned int minBufferByteSize=m_options.numOfReadBytes>m_options.numOfWriteBytes?m_options.numOfReadBytes:m_options.numOfWriteBytes;
+	if(!m_bufferPoolSet || m_bufferPoolSet->GetMinBufferByteSize()!=minBufferByteSize)
+	{
+		if(m_bufferPoolSet)
+			m_bufferPoolSet->ReleaseObj();
+		m_bufferPoolSet=EP_NEW IpcBufferPoolSet(minBufferByteSize,IPC_BUFFER_POOL_SET_MAX_FREE_COUNT,m_lockPolicy);
+	}
+
+	m_callbackDrainedEvent.ResetEvent();
+	if(m_options.serverMode==IPC_SERVER_MODE_COMPLETION_PORT)
+		return startCompletionServer();
+
+	// the server thread waits on the events of all instances, so they are limited to MAXIMUM_WAIT_OBJECTS
+	unsigned int instanceCount=m_options.maximumInstances;
+	if(instanceCount>MAXIMUM_WAIT_OBJECTS)
+		instanceCount=MAXIMUM_WAIT_OBJECTS;
 
 	m_pipesLock->Lock();
-	for(unsigned int trav=0;trav<m_options.maximumInstances;trav++)
+	for(unsigned int trav=0;trav<instanceCount;trav++)
 	{
-		IpcPipe *pipeInst=EP_NEW IpcPipe(m_pipeName,m_options,m_lockPolicy);
+		IpcPipe *pipeInst=EP_NEW IpcPipe(m_pipeName,m_options,m_lockPolicy,m_writeBufferPool,m_bufferPoolSet);
+		pipeInst->m_server=this;
+		pipeInst->m_metrics.SetParent(&m_metrics);
 		if(pipeInst->Create())
 		{
 			
@@ -139,7 +312,7 @@ void IpcServer::execute()
 		// routine to be queued for execution. 
 
 		waitResult = WaitForMultipleObjects( 
-			m_options.maximumInstances,    // number of event objects 
+			m_events.size(),    // number of event objects 
 			&m_events.at(0),      // array of event objects 
 			FALSE,        // does not wait for all 
 			INFINITE);    // waits indefinitely 
@@ -161,7 +334,7 @@ void IpcServer::execute()
 			// If an operation is pending, get the result of the 
 			// connect operation. 
 			index = waitResult - WAIT_OBJECT_0;  // determines which pipe 
-			if (index < 0 || index > (m_options.maximumInstances - 1)) 
+			if (index < 0 || index > (m_events.size() - 1)) 
 			{
 				printf("Index out of range.\n"); 
 				stopServer();
@@ -184,11 +357,11 @@ void IpcServer::execute()
 					return;
 				}
 			} 
-			m_options.callBackObj->OnNewConnection(m_pipes.at(index));
+			m_pipes.at(index)->reportCallback(PIPE_CALLBACK_TYPE_NEW_CONNECTION);
 			ReadFileEx( 
 				m_pipes.at(index)->m_pipeHandle, 
-				m_pipes.at(index)->m_readBuffer, 
-				m_pipes.at(index)->m_options.numOfReadBytes, 
+				m_pipes.at(index)->m_readBuffer.GetReadPosition(), 
+				m_pipes.at(index)->m_readBuffer.GetReadByteSize(), 
 				(LPOVERLAPPED) m_pipes.at(index), 
 				(LPOVERLAPPED_COMPLETION_ROUTINE) IpcPipe::OnReadComplete); 
 			//Pipe::OnWriteComplete(0, 0, (LPOVERLAPPED) m_pipes.at(index)); 
@@ -200,9 +373,18 @@ void IpcServer::execute()
 }
 void IpcServer::StopServer()
 {
-	m_serverThreadEvent.SetEvent();
-	WaitFor(m_options.waitTimeInMilliSec);
-	m_serverThreadEvent.ResetEvent();
+	if(m_completionPort)
+		stopCompletionServer();
+	else
+	{
+		m_serverThreadEvent.SetEvent();
+		WaitFor(m_options.waitTimeInMilliSec);
+		m_serverThreadEvent.ResetEvent();
+	}
+
+	// the callbacks already queued are delivered before the server is stopped
+	if(m_callbackJobCount)
+		m_callbackDrainedEvent.WaitForEvent(m_options.waitTimeInMilliSec);
 }
 
 void IpcServer::stopServer()
@@ -227,16 +409,252 @@ void IpcServer::ShutdownAllClient()
 	LockObj lock(m_pipesLock);
 	for(int trav=0;trav<m_pipes.size();trav++)
 	{
-		IpcPipe::DisconnectAndReconnect(m_pipes.at(trav));
+		// the closed instance is removed when its pending read completes
+		if(m_completionPort)
+			m_pipes.at(trav)->KillConnection();
+		else
+			IpcPipe::DisconnectAndReconnect(m_pipes.at(trav));
 	}
 	
 }
 
 unsigned int IpcServer::GetMaxReadDataByteSize() const
 {
-	return m_options.numOfReadBytes;
+	return m_options.maxMessageByteSize;
 }
 unsigned int IpcServer::GetMaxWriteDataByteSize() const
 {
-	return m_options.numOfWriteBytes;
-}
\ No newline at end of file
+	if(m_options.writeBatchByteSize)
+		return m_options.maxMessageByteSize-IPC_FRAME_HEADER_SIZE;
+	return m_options.maxMessageByteSize;
+}
+
+void IpcServer::GetMetrics(IpcMetricsSnapshot &retSnapshot) const
+{
+	m_metrics.GetSnapshot(retSnapshot);
+	retSnapshot.writeQueueDepth=0;
+	LockObj lock(m_pipesLock);
+	for(size_t pipeTrav=0;pipeTrav<m_pipes.size();pipeTrav++)
+		retSnapshot.writeQueueDepth+=static_cast<__int64>(m_pipes[pipeTrav]->GetWriteQueueSize());
+}
+
+void IpcServer::SetMetricsName(const TCHAR *name)
+{
+	IPC_METRICS_INSTANCE.Register(this,name);
+	m_isMetricsRegistered=true;
+}
+
+bool IpcServer::startCompletionServer()
+{
+	unsigned int threadCount=m_options.completionThreadCount;
+	if(threadCount==0)
+		threadCount=System::GetNumberOfCores();
+	m_completionPort=CreateIoCompletionPort(INVALID_HANDLE_VALUE,NULL,0,threadCount);
+	if(!m_completionPort)
+	{
+		epl::System::OutputDebugString(_T("CreateIoCompletionPort failed with %d.\r\n"), GetLastError());
+		return false;
+	}
+	m_ioCount=0;
+	m_ioDrainedEvent.ResetEvent();
+	m_started=true;
+	for(unsigned int threadTrav=0;threadTrav<threadCount;threadTrav++)
+	{
+		IpcCompletionThread *completionThread=EP_NEW IpcCompletionThread(this,m_lockPolicy);
+		m_completionThreads.push_back(completionThread);
+		completionThread->Start();
+	}
+
+	m_pipesLock->Lock();
+	addListeningInstances();
+	bool isListening=(m_listeningCount!=0);
+	m_pipesLock->Unlock();
+	if(!isListening)
+	{
+		stopCompletionServer();
+		return false;
+	}
+	return true;
+}
+
+void IpcServer::stopCompletionServer()
+{
+	vector<IpcPipe*> pipes;
+	m_pipesLock->Lock();
+	m_started=false;
+	pipes.swap(m_pipes);
+	m_listeningCount=0;
+	m_pipesLock->Unlock();
+
+	for(size_t pipeTrav=0;pipeTrav<pipes.size();pipeTrav++)
+	{
+		pipes.at(pipeTrav)->closeInstance();
+		pipes.at(pipeTrav)->ReleaseObj();
+	}
+
+	// the pending I/O completes with the failure since the instances are closed
+	if(m_ioCount)
+		m_ioDrainedEvent.WaitForEvent(m_options.waitTimeInMilliSec);
+
+	// the completion without the overlapped I/O stops one thread
+	for(size_t threadTrav=0;threadTrav<m_completionThreads.size();threadTrav++)
+		PostQueuedCompletionStatus(m_completionPort,0,0,NULL);
+	for(size_t threadTrav=0;threadTrav<m_completionThreads.size();threadTrav++)
+	{
+		m_completionThreads.at(threadTrav)->WaitFor(m_options.waitTimeInMilliSec);
+		EP_DELETE m_completionThreads.at(threadTrav);
+	}
+	m_completionThreads.clear();
+	CloseHandle(m_completionPort);
+	m_completionPort=NULL;
+}
+
+void IpcServer::addListeningInstances()
+{
+	unsigned int listeningInstances=m_options.listeningInstances;
+	if(listeningInstances==0)
+		listeningInstances=1;
+	while(m_listeningCount<listeningInstances)
+	{
+		if(m_options.maximumInstances!=PIPE_UNLIMITED_INSTANCES && m_pipes.size()>=m_options.maximumInstances)
+			break;
+		IpcPipe *pipeInst=EP_NEW IpcPipe(m_pipeName,m_options,m_lockPolicy,m_writeBufferPool,m_bufferPoolSet);
+		pipeInst->m_server=this;
+		pipeInst->m_metrics.SetParent(&m_metrics);
+		if(!pipeInst->Create())
+		{
+			pipeInst->ReleaseObj();
+			break;
+		}
+		m_pipes.push_back(pipeInst);
+		m_listeningCount++;
+	}
+}
+
+void IpcServer::removeInstance(IpcPipe *pipeInst, bool isListening)
+{
+	LockObj lock(m_pipesLock);
+	vector<IpcPipe*>::iterator iter=std::find(m_pipes.begin(),m_pipes.end(),pipeInst);
+	if(iter==m_pipes.end())
+		return;
+	// the order of the instances does not matter, so the last one fills the hole
+	*iter=m_pipes.back();
+	m_pipes.pop_back();
+	if(isListening && m_listeningCount)
+		m_listeningCount--;
+	pipeInst->ReleaseObj();
+	if(m_started)
+		addListeningInstances();
+}
+
+void IpcServer::processCompletions()
+{
+	while(1)
+	{
+		DWORD bytesTransferred=0;
+		ULONG_PTR completionKey=0;
+		OVERLAPPED *overlap=NULL;
+		BOOL success=GetQueuedCompletionStatus(m_completionPort,&bytesTransferred,&completionKey,&overlap,INFINITE);
+		// the completion without the overlapped I/O is the stop request
+		if(!overlap)
+			break;
+		unsigned long errCode=success?0:GetLastError();
+		handleCompletion(reinterpret_cast<IpcPipeOverlapped*>(overlap),success!=FALSE,bytesTransferred,errCode);
+	}
+}
+
+void IpcServer::handleCompletion(IpcPipeOverlapped *io, bool success, unsigned long bytesTransferred, unsigned long errCode)
+{
+	IpcPipe *pipeInst=io->m_pipe;
+	switch(io->m_ioType)
+	{
+	case PIPE_IO_TYPE_CONNECT:
+		if(pipeInst->onConnectCompletion(success))
+		{
+			m_pipesLock->Lock();
+			if(m_listeningCount)
+				m_listeningCount--;
+			if(m_started)
+				addListeningInstances();
+			m_pipesLock->Unlock();
+
+			pipeInst->reportCallback(PIPE_CALLBACK_TYPE_NEW_CONNECTION);
+			if(!pipeInst->startRead())
+			{
+				pipeInst->KillConnection();
+				removeInstance(pipeInst,false);
+			}
+		}
+		else
+		{
+			pipeInst->closeInstance();
+			removeInstance(pipeInst,true);
+		}
+		break;
+	case PIPE_IO_TYPE_READ:
+		if(success && bytesTransferred)
+		{
+			pipeInst->reportRead(errCode,bytesTransferred);
+			if(pipeInst->startRead())
+				break;
+		}
+		else if(!success && errCode==ERROR_MORE_DATA && pipeInst->growRead(bytesTransferred))
+		{
+			// the rest of the message is read after the part already read
+			if(pipeInst->startRead())
+				break;
+		}
+		else if(pipeInst->IsConnectionAlive())
+		{
+			unsigned int byteSize=pipeInst->m_readBuffer.Complete(bytesTransferred);
+			pipeInst->reportCallback(PIPE_CALLBACK_TYPE_READ,READ_STATUS_FAIL_READ_FAILED,errCode,byteSize,pipeInst->m_readBuffer.GetData());
+			pipeInst->m_readBuffer.Reset();
+		}
+		pipeInst->KillConnection();
+		removeInstance(pipeInst,false);
+		break;
+	case PIPE_IO_TYPE_WRITE:
+		pipeInst->onWriteCompletion(success,bytesTransferred,errCode);
+		break;
+	default:
+		break;
+	}
+	releaseIo(pipeInst);
+}
+
+void IpcServer::releaseIo(IpcPipe *pipeInst)
+{
+	pipeInst->ReleaseObj();
+	if(InterlockedDecrement(&m_ioCount)==0 && !m_started)
+		m_ioDrainedEvent.SetEvent();
+}
+
+void IpcServer::scheduleCallbacks(IpcPipe *pipeInst)
+{
+	InterlockedIncrement(&m_callbackJobCount);
+	IpcCallbackJob *job=EP_NEW IpcCallbackJob(this,pipeInst,m_lockPolicy);
+	job->SetJobProcessor(m_callbackProcessor);
+	if(m_options.callbackPool)
+		m_options.callbackPool->Push(job);
+	else
+		m_options.callbackWorkerPool->Push(job);
+	job->ReleaseObj();
+}
+
+void IpcServer::dispatchCallbacks(IpcPipe *pipeInst, bool isDropped)
+{
+	if(isDropped)
+	{
+		while(pipeInst->deliverQueuedCallbacks(IPC_CALLBACK_BATCH_SIZE))
+		{
+		}
+	}
+	else if(pipeInst->deliverQueuedCallbacks(IPC_CALLBACK_BATCH_SIZE))
+	{
+		// the job yields to the other pipes, and continues with the new job
+		scheduleCallbacks(pipeInst);
+	}
+
+	if(InterlockedDecrement(&m_callbackJobCount)==0 && !m_started)
+		m_callbackDrainedEvent.SetEvent();
+}
@@ -0,0 +1,669 @@
+/*! 
+JobBenchmark for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epJobBenchmark.h"
+#include "epBaseJob.h"
+#include "epBaseJobProcessor.h"
+#include "epWorkerThreadFactory.h"
+#include "epThreadPool.h"
+#include "epJobPool.h"
+#include "epEventEx.h"
+#include "epSemaphore.h"
+#include <vector>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the largest number of the jobs in flight while measuring the throughput
+#define JOB_BENCHMARK_WINDOW_COUNT 1024
+
+/// the time in milliseconds waited for the jobs before nudging the suspended workers
+#define JOB_BENCHMARK_WAIT_SLICE 10
+
+/// the priority of the job pushed behind the load, above the PRIORITY_NORMAL of the load
+#define JOB_BENCHMARK_HIGH_PRIORITY (PRIORITY_NORMAL+1)
+
+/// the names of the targets measured
+static const TCHAR *s_targetNameList[JOB_BENCHMARK_TARGET_COUNT]={_T("INFINITE"),_T("SUSPEND_AFTER_WORK"),_T("THREAD_POOL")};
+
+/*!
+Do the work of the job, which touches no shared memory.
+@param[in] workCount the number of the loop iterations.
+*/
+static void doWork(unsigned int workCount)
+{
+	volatile unsigned int work=0;
+	for(unsigned int workTrav=0;workTrav<workCount;workTrav++)
+		work=work+workTrav;
+}
+
+/*!
+Return the worker counts to measure, doubling from 1 and ending with the largest.
+@param[in] maxWorkerCount the largest number of the workers, or 0 for the number of the cores.
+@param[out] retWorkerCountList the worker counts to measure.
+*/
+static void getWorkerCountList(unsigned int maxWorkerCount, std::vector<unsigned int> &retWorkerCountList)
+{
+	if(maxWorkerCount==0)
+		maxWorkerCount=static_cast<unsigned int>(System::GetNumberOfCores());
+	if(maxWorkerCount==0)
+		maxWorkerCount=1;
+	retWorkerCountList.clear();
+	for(unsigned int workerCount=1;workerCount<maxWorkerCount;workerCount*=2)
+		retWorkerCountList.push_back(workerCount);
+	retWorkerCountList.push_back(maxWorkerCount);
+}
+
+namespace epl
+{
+	class JobBenchmarkSession;
+
+	/*!
+	@class JobBenchmarkJob epJobBenchmark.cpp
+	@brief A job doing the given work, and reporting the time it waited to the session.
+	*/
+	class JobBenchmarkJob:public BaseJob
+	{
+	public:
+		/*!
+		Default Constructor, which is called by JobPool
+		*/
+		JobBenchmarkJob():BaseJob()
+		{
+			reset();
+		}
+
+		/*!
+		Prepare the job to push.
+		@param[in] session the session the job reports to.
+		@param[in] workCount the number of the loop iterations of the work.
+		@param[in] isMarked the flag whether the time the job waited is recorded by the session.
+		*/
+		void Prepare(JobBenchmarkSession *session, unsigned int workCount, bool isMarked)
+		{
+			m_session=session;
+			m_workCount=workCount;
+			m_isMarked=isMarked;
+			m_pushTime=System::GetQueryPerformanceCounter().QuadPart;
+		}
+
+		/*!
+		Do the work, and report to the session.
+		*/
+		void Process();
+
+	protected:
+		/*!
+		Reset the members, when the job is recycled.
+		*/
+		virtual void handleRecycle()
+		{
+			reset();
+		}
+
+	private:
+		/*!
+		Reset the members.
+		*/
+		void reset()
+		{
+			m_session=NULL;
+			m_workCount=0;
+			m_isMarked=false;
+			m_pushTime=0;
+		}
+
+		/// the session the job reports to
+		JobBenchmarkSession *m_session;
+		/// the number of the loop iterations of the work
+		unsigned int m_workCount;
+		/// the flag whether the time the job waited is recorded
+		bool m_isMarked;
+		/// the performance counter when the job is pushed
+		__int64 m_pushTime;
+	};
+
+	/*!
+	@class JobBenchmarkProcessor epJobBenchmark.cpp
+	@brief A job processor which processes JobBenchmarkJob.
+	*/
+	class JobBenchmarkProcessor:public BaseJobProcessor
+	{
+	public:
+		/*!
+		Process the given JobBenchmarkJob.
+		@param[in] workerThread The worker thread which called the DoJob.
+		@param[in] data The JobBenchmarkJob given to this object.
+		*/
+		virtual void DoJob(BaseWorkerThread *workerThread, BaseJob* const data)
+		{
+			static_cast<JobBenchmarkJob*>(data)->Process();
+		}
+	};
+
+	/*!
+	@class JobBenchmarkSession epJobBenchmark.cpp
+	@brief A class owning the workers of one target, and counting the jobs processed.
+
+	The workers with THREAD_LIFE_SUSPEND_AFTER_WORK can miss the resume pushed
+	while they are between finding the queue empty and suspending themselves,
+	so the session resumes them again whenever the wait for the jobs times out.
+	*/
+	class JobBenchmarkSession
+	{
+	public:
+		friend class JobBenchmarkJob;
+
+		/*!
+		Default Constructor
+		@param[in] target the job system to measure.
+		@param[in] workerCount the number of the workers.
+		*/
+		JobBenchmarkSession(JobBenchmarkTarget target, unsigned int workerCount):m_doneEvent(false,false),m_window(JOB_BENCHMARK_WINDOW_COUNT,JOB_BENCHMARK_WINDOW_COUNT)
+		{
+			m_target=target;
+			m_workerCount=workerCount;
+			m_jobProcessor=NULL;
+			m_threadPool=NULL;
+			m_nextWorkerIdx=0;
+			m_pendingCount=0;
+			m_markedWaitTime=0;
+			m_isWindowed=false;
+		}
+
+		/*!
+		Default Destructor
+
+		Stop the workers
+		*/
+		~JobBenchmarkSession()
+		{
+			Close();
+		}
+
+		/*!
+		Start the workers.
+		@return true if all workers are started, otherwise false.
+		*/
+		bool Open()
+		{
+			m_jobProcessor=EP_NEW JobBenchmarkProcessor();
+			if(m_target==JOB_BENCHMARK_TARGET_THREAD_POOL)
+			{
+				m_threadPool=EP_NEW ThreadPool(m_jobProcessor,m_workerCount);
+				return m_threadPool->Start();
+			}
+			BaseWorkerThread::ThreadLifePolicy policy=BaseWorkerThread::THREAD_LIFE_INFINITE;
+			if(m_target==JOB_BENCHMARK_TARGET_SUSPEND_AFTER_WORK)
+				policy=BaseWorkerThread::THREAD_LIFE_SUSPEND_AFTER_WORK;
+			for(unsigned int workerTrav=0;workerTrav<m_workerCount;workerTrav++)
+			{
+				BaseWorkerThread *worker=WorkerThreadFactory::GetWorkerThread(policy);
+				m_workerList.push_back(worker);
+				worker->SetJobProcessor(m_jobProcessor);
+				if(!worker->Start())
+					return false;
+			}
+			return true;
+		}
+
+		/*!
+		Stop and delete the workers.
+		*/
+		void Close()
+		{
+			for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+			{
+				m_workerList[workerTrav]->TerminateWorker();
+				EP_DELETE m_workerList[workerTrav];
+			}
+			m_workerList.clear();
+			if(m_threadPool)
+			{
+				m_threadPool->Stop();
+				EP_DELETE m_threadPool;
+				m_threadPool=NULL;
+			}
+			if(m_jobProcessor)
+			{
+				m_jobProcessor->ReleaseObj();
+				m_jobProcessor=NULL;
+			}
+		}
+
+		/*!
+		Set the number of the jobs to wait for by WaitForDone.
+		@param[in] jobCount the number of the jobs.
+		@param[in] isWindowed the flag whether at most JOB_BENCHMARK_WINDOW_COUNT jobs are in flight.
+		@remark must be called before the jobs are pushed.
+		*/
+		void Expect(unsigned int jobCount, bool isWindowed)
+		{
+			m_doneEvent.ResetEvent();
+			m_isWindowed=isWindowed;
+			m_pendingCount=static_cast<LONG>(jobCount);
+			if(jobCount==0)
+				m_doneEvent.SetEvent();
+		}
+
+		/*!
+		Push the job to the next worker in round-robin.
+		@param[in] workCount the number of the loop iterations of the work of the job.
+		@param[in] priority the priority of the job.
+		@param[in] isMarked the flag whether the time the job waited is recorded.
+		*/
+		void Push(unsigned int workCount, Priority priority, bool isMarked)
+		{
+			if(m_isWindowed)
+			{
+				while(!m_window.TryLockFor(JOB_BENCHMARK_WAIT_SLICE))
+					resumeWorkers();
+			}
+			JobBenchmarkJob *job=m_jobPool.Acquire();
+			job->SetPriority(priority);
+			job->Prepare(this,workCount,isMarked);
+			if(m_threadPool)
+				m_threadPool->Push(job);
+			else
+			{
+				m_workerList[m_nextWorkerIdx]->Push(job);
+				m_nextWorkerIdx=(m_nextWorkerIdx+1)%m_workerList.size();
+			}
+			job->ReleaseObj();
+		}
+
+		/*!
+		Wait until all jobs expected are processed.
+		*/
+		void WaitForDone()
+		{
+			while(!m_doneEvent.WaitForEvent(JOB_BENCHMARK_WAIT_SLICE))
+				resumeWorkers();
+		}
+
+		/*!
+		Return the time the last marked job waited from the push until it started.
+		@return the time in the performance counter ticks.
+		*/
+		__int64 GetMarkedWaitTime() const
+		{
+			return m_markedWaitTime;
+		}
+
+		/*!
+		Return the number of the workers.
+		@return the number of the workers.
+		*/
+		unsigned int GetWorkerCount() const
+		{
+			return m_workerCount;
+		}
+
+	private:
+		/*!
+		Called by the job when it is processed.
+		@param[in] isMarked the flag whether the job is marked.
+		@param[in] waitTime the time the job waited from the push until it started, in the performance counter ticks.
+		*/
+		void onJobDone(bool isMarked, __int64 waitTime)
+		{
+			if(isMarked)
+				m_markedWaitTime=waitTime;
+			if(m_isWindowed)
+				m_window.Release(1);
+			if(InterlockedDecrement(&m_pendingCount)==0)
+				m_doneEvent.SetEvent();
+		}
+
+		/*!
+		Resume the suspended workers, which may have missed the resume of the push.
+		*/
+		void resumeWorkers()
+		{
+			if(m_target!=JOB_BENCHMARK_TARGET_SUSPEND_AFTER_WORK)
+				return;
+			for(size_t workerTrav=0;workerTrav<m_workerList.size();workerTrav++)
+				m_workerList[workerTrav]->Resume();
+		}
+
+		/// the job system measured
+		JobBenchmarkTarget m_target;
+		/// the number of the workers
+		unsigned int m_workerCount;
+		/// the job processor of all workers
+		JobBenchmarkProcessor *m_jobProcessor;
+		/// the workers of WorkerThreadFactory
+		std::vector<BaseWorkerThread*> m_workerList;
+		/// the thread pool
+		ThreadPool *m_threadPool;
+		/// the index of the worker the next job is pushed to
+		size_t m_nextWorkerIdx;
+		/// the free list of the jobs
+		JobPool<JobBenchmarkJob> m_jobPool;
+		/// the event raised when all jobs expected are processed
+		EventEx m_doneEvent;
+		/// the slots of the jobs in flight
+		Semaphore m_window;
+		/// the flag whether the jobs in flight are limited by the window
+		volatile bool m_isWindowed;
+		/// the number of the jobs expected and not processed yet
+		volatile LONG m_pendingCount;
+		/// the time the last marked job waited
+		volatile __int64 m_markedWaitTime;
+	};
+
+	void JobBenchmarkJob::Process()
+	{
+		__int64 startTime=System::GetQueryPerformanceCounter().QuadPart;
+		doWork(m_workCount);
+		m_session->onJobDone(m_isMarked,startTime-m_pushTime);
+	}
+
+	/*!
+	@class JobThroughputCase epJobBenchmark.cpp
+	@brief A benchmark case pushing the empty jobs as fast as they are processed.
+	*/
+	class JobThroughputCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the session to measure.
+		*/
+		JobThroughputCase(JobBenchmarkSession &session):m_session(session)
+		{
+		}
+
+		/*!
+		Push the empty jobs, and wait until all are processed.
+		@param[in] iterationCount the number of the jobs.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			m_session.Expect(iterationCount,true);
+			for(unsigned int jobTrav=0;jobTrav<iterationCount;jobTrav++)
+				m_session.Push(0,PRIORITY_NORMAL,false);
+			m_session.WaitForDone();
+		}
+
+		/*!
+		Return the number of the workers processing the jobs.
+		@return the number of the workers.
+		*/
+		virtual unsigned int GetThreadCount() const
+		{
+			return m_session.GetWorkerCount();
+		}
+
+	private:
+		/// the session measured
+		JobBenchmarkSession &m_session;
+	};
+
+	/*!
+	@class JobLatencyCase epJobBenchmark.cpp
+	@brief A benchmark case pushing one empty job at a time, and recording the time until it starts.
+	*/
+	class JobLatencyCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the session to measure.
+		*/
+		JobLatencyCase(JobBenchmarkSession &session):m_session(session)
+		{
+		}
+
+		/*!
+		Reserve the times for the measurement.
+		@param[in] iterationCount the number of the jobs.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_sampleList.clear();
+			m_sampleList.reserve(iterationCount);
+		}
+
+		/*!
+		Push one job at a time, and record the time each waited.
+		@param[in] iterationCount the number of the jobs.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int jobTrav=0;jobTrav<iterationCount;jobTrav++)
+			{
+				m_session.Expect(1,false);
+				m_session.Push(0,PRIORITY_NORMAL,true);
+				m_session.WaitForDone();
+				m_sampleList.push_back(m_session.GetMarkedWaitTime());
+			}
+		}
+
+		/*!
+		Return the times the jobs of the last measurement waited in the performance counter ticks.
+		@return the times waited.
+		*/
+		std::vector<__int64> &GetSampleList()
+		{
+			return m_sampleList;
+		}
+
+	private:
+		/// the session measured
+		JobBenchmarkSession &m_session;
+		/// the times the jobs of the last measurement waited
+		std::vector<__int64> m_sampleList;
+	};
+
+	/*!
+	@class JobFanOutInCase epJobBenchmark.cpp
+	@brief A benchmark case spreading JOB_BENCHMARK_FAN_COUNT jobs to the workers, and waiting for all of them per operation.
+	*/
+	class JobFanOutInCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the session to measure.
+		*/
+		JobFanOutInCase(JobBenchmarkSession &session):m_session(session)
+		{
+		}
+
+		/*!
+		Spread the jobs and wait for them, once per operation.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int fanTrav=0;fanTrav<iterationCount;fanTrav++)
+			{
+				m_session.Expect(JOB_BENCHMARK_FAN_COUNT,false);
+				for(unsigned int jobTrav=0;jobTrav<JOB_BENCHMARK_FAN_COUNT;jobTrav++)
+					m_session.Push(JOB_BENCHMARK_WORK_COUNT,PRIORITY_NORMAL,false);
+				m_session.WaitForDone();
+			}
+		}
+
+		/*!
+		Return the number of the workers processing the jobs.
+		@return the number of the workers.
+		*/
+		virtual unsigned int GetThreadCount() const
+		{
+			return m_session.GetWorkerCount();
+		}
+
+	private:
+		/// the session measured
+		JobBenchmarkSession &m_session;
+	};
+
+	/*!
+	@class JobPriorityInversionCase epJobBenchmark.cpp
+	@brief A benchmark case pushing one high priority job behind JOB_BENCHMARK_LOAD_COUNT low priority jobs per operation.
+	*/
+	class JobPriorityInversionCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] session the session to measure.
+		*/
+		JobPriorityInversionCase(JobBenchmarkSession &session):m_session(session)
+		{
+		}
+
+		/*!
+		Reserve the times for the measurement.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_sampleList.clear();
+			m_sampleList.reserve(iterationCount);
+		}
+
+		/*!
+		Push the load and the high priority job, and record the time the high priority job waited.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int loadTrav=0;loadTrav<iterationCount;loadTrav++)
+			{
+				m_session.Expect(JOB_BENCHMARK_LOAD_COUNT+1,false);
+				for(unsigned int jobTrav=0;jobTrav<JOB_BENCHMARK_LOAD_COUNT;jobTrav++)
+					m_session.Push(JOB_BENCHMARK_WORK_COUNT,PRIORITY_NORMAL,false);
+				m_session.Push(0,JOB_BENCHMARK_HIGH_PRIORITY,true);
+				m_session.WaitForDone();
+				m_sampleList.push_back(m_session.GetMarkedWaitTime());
+			}
+		}
+
+		/*!
+		Return the times the high priority jobs of the last measurement waited in the performance counter ticks.
+		@return the times waited.
+		*/
+		std::vector<__int64> &GetSampleList()
+		{
+			return m_sampleList;
+		}
+
+	private:
+		/// the session measured
+		JobBenchmarkSession &m_session;
+		/// the times the high priority jobs of the last measurement waited
+		std::vector<__int64> m_sampleList;
+	};
+}
+
+void JobBenchmark::Run(unsigned int maxWorkerCount, unsigned int minTime)
+{
+	for(int targetTrav=0;targetTrav<JOB_BENCHMARK_TARGET_COUNT;targetTrav++)
+	{
+		JobBenchmarkTarget target=static_cast<JobBenchmarkTarget>(targetTrav);
+		RunThroughput(target,maxWorkerCount,minTime);
+		RunLatency(target,maxWorkerCount,minTime);
+		RunFanOutIn(target,maxWorkerCount,minTime);
+		RunPriorityInversion(target,maxWorkerCount,minTime);
+	}
+}
+
+void JobBenchmark::RunThroughput(JobBenchmarkTarget target, unsigned int maxWorkerCount, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(target<JOB_BENCHMARK_TARGET_COUNT,_T("The target is out of range."));
+	std::vector<unsigned int> workerCountList;
+	getWorkerCountList(maxWorkerCount,workerCountList);
+	for(size_t workerTrav=0;workerTrav<workerCountList.size();workerTrav++)
+	{
+		JobBenchmarkSession session(target,workerCountList[workerTrav]);
+		if(!session.Open())
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u"),s_targetNameList[target],workerCountList[workerTrav]);
+		JobThroughputCase throughputCase(session);
+		BENCHMARK_INSTANCE.Run(_T("Job"),_T("Throughput"),parameter.c_str(),throughputCase,0,minTime);
+	}
+}
+
+void JobBenchmark::RunLatency(JobBenchmarkTarget target, unsigned int maxWorkerCount, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(target<JOB_BENCHMARK_TARGET_COUNT,_T("The target is out of range."));
+	std::vector<unsigned int> workerCountList;
+	getWorkerCountList(maxWorkerCount,workerCountList);
+	for(size_t workerTrav=0;workerTrav<workerCountList.size();workerTrav++)
+	{
+		JobBenchmarkSession session(target,workerCountList[workerTrav]);
+		if(!session.Open())
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u"),s_targetNameList[target],workerCountList[workerTrav]);
+		JobLatencyCase latencyCase(session);
+		BENCHMARK_INSTANCE.Run(_T("Job"),_T("Latency"),parameter.c_str(),latencyCase,0,minTime);
+		BENCHMARK_INSTANCE.AddPercentiles(_T("Job"),_T("Latency"),parameter.c_str(),latencyCase.GetSampleList());
+	}
+}
+
+void JobBenchmark::RunFanOutIn(JobBenchmarkTarget target, unsigned int maxWorkerCount, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(target<JOB_BENCHMARK_TARGET_COUNT,_T("The target is out of range."));
+	std::vector<unsigned int> workerCountList;
+	getWorkerCountList(maxWorkerCount,workerCountList);
+	for(size_t workerTrav=0;workerTrav<workerCountList.size();workerTrav++)
+	{
+		JobBenchmarkSession session(target,workerCountList[workerTrav]);
+		if(!session.Open())
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u"),s_targetNameList[target],workerCountList[workerTrav]);
+		JobFanOutInCase fanOutInCase(session);
+		BENCHMARK_INSTANCE.Run(_T("Job"),_T("FanOutIn"),parameter.c_str(),fanOutInCase,0,minTime);
+	}
+}
+
+void JobBenchmark::RunPriorityInversion(JobBenchmarkTarget target, unsigned int maxWorkerCount, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(target<JOB_BENCHMARK_TARGET_COUNT,_T("The target is out of range."));
+	std::vector<unsigned int> workerCountList;
+	getWorkerCountList(maxWorkerCount,workerCountList);
+	for(size_t workerTrav=0;workerTrav<workerCountList.size();workerTrav++)
+	{
+		JobBenchmarkSession session(target,workerCountList[workerTrav]);
+		if(!session.Open())
+			break;
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%s/%u"),s_targetNameList[target],workerCountList[workerTrav]);
+		JobPriorityInversionCase priorityInversionCase(session);
+		BENCHMARK_INSTANCE.Run(_T("Job"),_T("PriorityInversion"),parameter.c_str(),priorityInversionCase,0,minTime);
+		BENCHMARK_INSTANCE.AddPercentiles(_T("Job"),_T("PriorityInversion"),parameter.c_str(),priorityInversionCase.GetSampleList());
+	}
+}
@@ -0,0 +1,282 @@
+/*! 
+JobGraph for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epJobGraph.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+JobGraph::JobGraph(bool useCriticalPathPriority, LockPolicy lockPolicyType):m_finishEvent(true,true)
+{
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_graphLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_graphLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_graphLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_graphLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_graphLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_graphLock=NULL;
+		break;
+	}
+	m_useCriticalPathPriority=useCriticalPathPriority;
+	m_isDirty=false;
+	m_remainingCount=0;
+	m_incompleteCount=0;
+	m_isRunning=0;
+	m_workerThread=NULL;
+	m_threadPool=NULL;
+}
+
+JobGraph::~JobGraph()
+{
+	EP_ASSERT_EXPR(!m_isRunning,_T("JobGraph is destroyed while running!"));
+	Clear();
+	if(m_graphLock)
+		EP_DELETE m_graphLock;
+}
+
+JobGraph::NodeIndex JobGraph::AddJob(BaseJob * const job)
+{
+	LockObj lock(m_graphLock);
+	EP_ASSERT_EXPR(job,_T("Job is NULL!"));
+	EP_ASSERT_EXPR(!m_isRunning,_T("Cannot add the job while the graph is running!"));
+	EP_ASSERT_EXPR(job->m_graph==NULL,_T("The job already belongs to a graph!"));
+	job->RetainObj();
+	job->m_graph=this;
+	job->m_graphNodeIdx=static_cast<NodeIndex>(m_nodeList.size());
+
+	JobNode node;
+	node.m_job=job;
+	node.m_predecessorCount=0;
+	node.m_pendingCount=0;
+	node.m_isFailed=0;
+	node.m_pathLength=1;
+	m_nodeList.push_back(node);
+	m_isDirty=true;
+	return job->m_graphNodeIdx;
+}
+
+bool JobGraph::AddDependency(NodeIndex beforeIdx, NodeIndex afterIdx)
+{
+	LockObj lock(m_graphLock);
+	EP_ASSERT_EXPR(!m_isRunning,_T("Cannot add the dependency while the graph is running!"));
+	if(m_isRunning || beforeIdx>=m_nodeList.size() || afterIdx>=m_nodeList.size() || beforeIdx==afterIdx)
+	{
+		EP_ASSERT_EXPR(0,_T("Invalid Dependency! (before: %d, after: %d, job count: %d)"),beforeIdx,afterIdx,m_nodeList.size());
+		return false;
+	}
+	m_nodeList[beforeIdx].m_successorList.push_back(afterIdx);
+	m_nodeList[afterIdx].m_predecessorCount++;
+	m_isDirty=true;
+	return true;
+}
+
+void JobGraph::Clear()
+{
+	LockObj lock(m_graphLock);
+	EP_ASSERT_EXPR(!m_isRunning,_T("Cannot clear the graph while running!"));
+	for(size_t nodeTrav=0;nodeTrav<m_nodeList.size();nodeTrav++)
+	{
+		m_nodeList[nodeTrav].m_job->m_graph=NULL;
+		m_nodeList[nodeTrav].m_job->ReleaseObj();
+	}
+	m_nodeList.clear();
+	m_isDirty=false;
+}
+
+bool JobGraph::Run(BaseWorkerThread *workerThread)
+{
+	LockObj lock(m_graphLock);
+	EP_ASSERT_EXPR(workerThread,_T("Worker Thread is NULL!"));
+	if(!workerThread || m_isRunning)
+		return false;
+	m_workerThread=workerThread;
+	m_threadPool=NULL;
+	return start();
+}
+
+bool JobGraph::Run(ThreadPool *threadPool)
+{
+	LockObj lock(m_graphLock);
+	EP_ASSERT_EXPR(threadPool,_T("Thread Pool is NULL!"));
+	if(!threadPool || m_isRunning)
+		return false;
+	m_workerThread=NULL;
+	m_threadPool=threadPool;
+	return start();
+}
+
+bool JobGraph::Wait(unsigned int waitTimeInMilliSec)
+{
+	return m_finishEvent.WaitForEvent(waitTimeInMilliSec);
+}
+
+bool JobGraph::IsRunning() const
+{
+	return m_isRunning!=0;
+}
+
+size_t JobGraph::GetJobCount() const
+{
+	LockObj lock(m_graphLock);
+	return m_nodeList.size();
+}
+
+size_t JobGraph::GetIncompleteCount() const
+{
+	return static_cast<size_t>(m_incompleteCount);
+}
+
+bool JobGraph::build()
+{
+	size_t nodeCount=m_nodeList.size();
+	std::vector<long> inDegreeList(nodeCount);
+	std::vector<NodeIndex> orderList;
+	orderList.reserve(nodeCount);
+	for(size_t nodeTrav=0;nodeTrav<nodeCount;nodeTrav++)
+	{
+		inDegreeList[nodeTrav]=m_nodeList[nodeTrav].m_predecessorCount;
+		if(inDegreeList[nodeTrav]==0)
+			orderList.push_back(static_cast<NodeIndex>(nodeTrav));
+	}
+	for(size_t orderTrav=0;orderTrav<orderList.size();orderTrav++)
+	{
+		JobNode &node=m_nodeList[orderList[orderTrav]];
+		for(size_t succTrav=0;succTrav<node.m_successorList.size();succTrav++)
+		{
+			if(--inDegreeList[node.m_successorList[succTrav]]==0)
+				orderList.push_back(node.m_successorList[succTrav]);
+		}
+	}
+	if(orderList.size()!=nodeCount)
+	{
+		EP_ASSERT_EXPR(0,_T("JobGraph has a cycle!"));
+		return false;
+	}
+
+	// walk in reverse topological order, so every successor is measured before its predecessors
+	for(size_t orderTrav=nodeCount;orderTrav>0;orderTrav--)
+	{
+		JobNode &node=m_nodeList[orderList[orderTrav-1]];
+		Priority maxLength=0;
+		for(size_t succTrav=0;succTrav<node.m_successorList.size();succTrav++)
+		{
+			Priority succLength=m_nodeList[node.m_successorList[succTrav]].m_pathLength;
+			if(succLength>maxLength)
+				maxLength=succLength;
+		}
+		node.m_pathLength=maxLength+1;
+	}
+	m_isDirty=false;
+	return true;
+}
+
+bool JobGraph::start()
+{
+	if(m_isDirty && !build())
+		return false;
+
+	size_t nodeCount=m_nodeList.size();
+	m_incompleteCount=0;
+	if(nodeCount==0)
+	{
+		m_finishEvent.SetEvent();
+		return true;
+	}
+
+	m_finishEvent.ResetEvent();
+	for(size_t nodeTrav=0;nodeTrav<nodeCount;nodeTrav++)
+	{
+		JobNode &node=m_nodeList[nodeTrav];
+		node.m_pendingCount=node.m_predecessorCount;
+		node.m_isFailed=0;
+		if(m_useCriticalPathPriority)
+			node.m_job->SetPriority(node.m_pathLength);
+	}
+	InterlockedExchange(&m_remainingCount,static_cast<long>(nodeCount));
+	InterlockedExchange(&m_isRunning,1);
+
+	for(size_t nodeTrav=0;nodeTrav<nodeCount;nodeTrav++)
+	{
+		if(m_nodeList[nodeTrav].m_predecessorCount==0)
+			dispatch(m_nodeList[nodeTrav].m_job);
+	}
+	return true;
+}
+
+void JobGraph::dispatch(BaseJob *job)
+{
+	if(m_threadPool)
+		m_threadPool->Push(job);
+	else
+		m_workerThread->Push(job);
+}
+
+void JobGraph::onJobFinished(NodeIndex nodeIdx, const BaseJob::JobStatus status)
+{
+	if(!m_isRunning)
+		return;
+	JobNode &node=m_nodeList[nodeIdx];
+	bool isFailed=(status!=BaseJob::JOB_STATUS_DONE);
+	if(isFailed)
+		InterlockedIncrement(&m_incompleteCount);
+
+	for(size_t succTrav=0;succTrav<node.m_successorList.size();succTrav++)
+	{
+		JobNode &succNode=m_nodeList[node.m_successorList[succTrav]];
+		if(isFailed)
+			InterlockedExchange(&succNode.m_isFailed,1);
+		if(InterlockedDecrement(&succNode.m_pendingCount)==0)
+		{
+			if(succNode.m_isFailed)
+				succNode.m_job->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+			else
+				dispatch(succNode.m_job);
+		}
+	}
+
+	if(InterlockedDecrement(&m_remainingCount)==0)
+	{
+		InterlockedExchange(&m_isRunning,0);
+		m_finishEvent.SetEvent();
+	}
+}
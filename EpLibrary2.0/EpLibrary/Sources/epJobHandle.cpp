@@ -0,0 +1,157 @@
+/*! 
+JobHandle for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epJobHandle.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+JobHandle::JobHandle(LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_readyEvent(false,true)
+{
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_handleLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_handleLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_handleLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_handleLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_handleLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_handleLock=NULL;
+		break;
+	}
+	m_isReady=0;
+	m_waiterCount=0;
+	m_resultStatus=BaseJob::JOB_STATUS_NONE;
+}
+
+JobHandle::~JobHandle()
+{
+	for(size_t nodeTrav=0;nodeTrav<m_continuationList.size();nodeTrav++)
+	{
+		m_continuationList[nodeTrav].m_continuation->ReleaseObj();
+		m_continuationList[nodeTrav].m_nextHandle->ReleaseObj();
+	}
+	m_continuationList.clear();
+	if(m_handleLock)
+		EP_DELETE m_handleLock;
+}
+
+bool JobHandle::IsReady() const
+{
+	return m_isReady!=0;
+}
+
+bool JobHandle::Wait(unsigned int waitTimeInMilliSec)
+{
+	if(m_isReady)
+		return true;
+	if(waitTimeInMilliSec==0)
+		return false;
+	InterlockedIncrement(&m_waiterCount);
+	bool retVal=true;
+	if(!m_isReady)
+		retVal=m_readyEvent.WaitForEvent(waitTimeInMilliSec);
+	InterlockedDecrement(&m_waiterCount);
+	return retVal;
+}
+
+BaseJob::JobStatus JobHandle::GetStatus() const
+{
+	if(!m_isReady)
+		return BaseJob::JOB_STATUS_NONE;
+	return m_resultStatus;
+}
+
+JobHandle *JobHandle::Then(JobContinuation *continuation)
+{
+	EP_ASSERT_EXPR(continuation,_T("Continuation is NULL!"));
+	JobHandle *nextHandle=EP_NEW JobHandle(m_lockPolicy);
+	if(!continuation)
+	{
+		nextHandle->complete(BaseJob::JOB_STATUS_INCOMPLETE);
+		return nextHandle;
+	}
+
+	m_handleLock->Lock();
+	if(!m_isReady)
+	{
+		ContinuationNode node;
+		node.m_continuation=continuation;
+		node.m_nextHandle=nextHandle;
+		continuation->RetainObj();
+		nextHandle->RetainObj();
+		m_continuationList.push_back(node);
+		m_handleLock->Unlock();
+		return nextHandle;
+	}
+	m_handleLock->Unlock();
+
+	continuation->Continue(this);
+	nextHandle->complete(m_resultStatus);
+	return nextHandle;
+}
+
+void JobHandle::complete(const BaseJob::JobStatus status)
+{
+	std::vector<ContinuationNode> continuationList;
+	m_handleLock->Lock();
+	if(m_isReady)
+	{
+		m_handleLock->Unlock();
+		return;
+	}
+	m_resultStatus=status;
+	InterlockedExchange(&m_isReady,1);
+	continuationList.swap(m_continuationList);
+	m_handleLock->Unlock();
+
+	// only touch the kernel event when someone is actually blocked on it
+	if(m_waiterCount>0)
+		m_readyEvent.SetEvent();
+
+	for(size_t nodeTrav=0;nodeTrav<continuationList.size();nodeTrav++)
+	{
+		continuationList[nodeTrav].m_continuation->Continue(this);
+		continuationList[nodeTrav].m_nextHandle->complete(status);
+		continuationList[nodeTrav].m_continuation->ReleaseObj();
+		continuationList[nodeTrav].m_nextHandle->ReleaseObj();
+	}
+}
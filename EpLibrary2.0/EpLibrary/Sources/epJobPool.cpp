@@ -0,0 +1,136 @@
+/*! 
+JobPool for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epJobPool.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+BaseJobPool::BaseJobPool(size_t maxFreeCount, LockPolicy lockPolicyType)
+{
+	m_maxFreeCount=maxFreeCount;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_poolLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_poolLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_poolLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_poolLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_poolLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_poolLock=NULL;
+		break;
+	}
+}
+
+BaseJobPool::~BaseJobPool()
+{
+	std::vector<BaseJob*> freeList;
+	{
+		LockObj lock(m_poolLock);
+		std::set<BaseJob*>::iterator iter;
+		for(iter=m_jobSet.begin();iter!=m_jobSet.end();iter++)
+		{
+			(*iter)->m_pool=NULL;
+		}
+		m_jobSet.clear();
+		freeList.swap(m_freeList);
+	}
+	for(size_t jobTrav=0;jobTrav<freeList.size();jobTrav++)
+	{
+		// detached above, so this deletes the job
+		freeList[jobTrav]->ReleaseObj();
+	}
+	if(m_poolLock)
+		EP_DELETE m_poolLock;
+}
+
+void BaseJobPool::Reserve(size_t count)
+{
+	LockObj lock(m_poolLock);
+	m_freeList.reserve(count);
+	while(m_freeList.size()<count)
+	{
+		m_freeList.push_back(newJob());
+	}
+}
+
+size_t BaseJobPool::GetFreeCount() const
+{
+	LockObj lock(m_poolLock);
+	return m_freeList.size();
+}
+
+size_t BaseJobPool::GetJobCount() const
+{
+	LockObj lock(m_poolLock);
+	return m_jobSet.size();
+}
+
+BaseJob *BaseJobPool::acquireJob()
+{
+	LockObj lock(m_poolLock);
+	if(m_freeList.empty())
+		return newJob();
+	BaseJob *retJob=m_freeList.back();
+	m_freeList.pop_back();
+	return retJob;
+}
+
+BaseJob *BaseJobPool::newJob()
+{
+	BaseJob *job=createJob();
+	job->m_pool=this;
+	m_jobSet.insert(job);
+	return job;
+}
+
+bool BaseJobPool::recycleJob(BaseJob *job)
+{
+	LockObj lock(m_poolLock);
+	if(m_maxFreeCount==0 || m_freeList.size()<m_maxFreeCount)
+	{
+		m_freeList.push_back(job);
+		return true;
+	}
+	job->m_pool=NULL;
+	m_jobSet.erase(job);
+	return false;
+}
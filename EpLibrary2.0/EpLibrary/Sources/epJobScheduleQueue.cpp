@@ -25,6 +25,7 @@ THE SOFTWARE.
 */
 #include "epJobScheduleQueue.h"
 #include "epQuickSort.h"
+#include "epWorkerMetrics.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -33,63 +34,466 @@ static char THIS_FILE[] = __FILE__;
 #endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 
 using namespace epl;
-JobScheduleQueue::JobScheduleQueue(LockPolicy lockPolicyType) :ThreadSafePQueue<BaseJob*, BaseJob>(lockPolicyType)
+JobScheduleQueue::JobScheduleQueue(LockPolicy lockPolicyType)
 {
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_queueLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_queueLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_queueLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_queueLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_queueLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_queueLock=NULL;
+		break;
+	}
+	m_jobCount=0;
+	m_maxWaitTime=WAITTIME_INIFINITE;
+}
+
+JobScheduleQueue::JobScheduleQueue(const JobScheduleQueue& b)
+{
+	m_lockPolicy=b.m_lockPolicy;
+	switch(m_lockPolicy)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_queueLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_queueLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_queueLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_queueLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_queueLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_queueLock=NULL;
+		break;
+	}
+	m_jobCount=0;
+	m_maxWaitTime=b.m_maxWaitTime;
+	copyFrom(b);
 }
 
 JobScheduleQueue::~JobScheduleQueue()
 {
-	while(!IsEmpty())
+	releaseAll();
+	if(m_queueLock)
+		EP_DELETE m_queueLock;
+}
+
+JobScheduleQueue & JobScheduleQueue::operator=(const JobScheduleQueue&b)
+{
+	if(this!=&b)
+	{
+		releaseAll();
+		m_maxWaitTime=b.m_maxWaitTime;
+		copyFrom(b);
+	}
+	return *this;
+}
+
+void JobScheduleQueue::copyFrom(const JobScheduleQueue &b)
+{
+	LockObj srcLock(b.m_queueLock);
+	LockObj lock(m_queueLock);
+	m_bandMap=b.m_bandMap;
+	m_bound=b.m_bound;
+	JobBandMap::iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
+	{
+		JobBand::iterator jobIter;
+		for(jobIter=bandIter->second.begin();jobIter!=bandIter->second.end();jobIter++)
+		{
+			(*jobIter)->RetainObj();
+		}
+	}
+	InterlockedExchange(&m_jobCount,b.m_jobCount);
+}
+
+void JobScheduleQueue::releaseAll()
+{
+	LockObj lock(m_queueLock);
+	JobBandMap::iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
+	{
+		JobBand::iterator jobIter;
+		for(jobIter=bandIter->second.begin();jobIter!=bandIter->second.end();jobIter++)
+		{
+			(*jobIter)->ReleaseObj();
+		}
+	}
+	m_bandMap.clear();
+	InterlockedExchange(&m_jobCount,0);
+	m_bound.NotifyPopped();
+}
+
+JobScheduleQueue::JobBand *JobScheduleQueue::frontBand()
+{
+	// empty bands are kept to avoid reallocating them, so skip them here
+	JobBandMap::iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
+	{
+		if(!bandIter->second.empty())
+			return &bandIter->second;
+	}
+	return NULL;
+}
+
+JobScheduleQueue::JobBand *JobScheduleQueue::nextBand(__int64 curTime)
+{
+	unsigned int maxWaitTime=m_maxWaitTime;
+	if(maxWaitTime==WAITTIME_INIFINITE)
+		return frontBand();
+	// the front of each band is its oldest job, so only the fronts need to be compared
+	JobBand *retBand=NULL;
+	JobBand *oldestBand=NULL;
+	JobBandMap::iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
+	{
+		JobBand &band=bandIter->second;
+		if(band.empty())
+			continue;
+		if(!retBand)
+			retBand=&band;
+		if(!oldestBand || band.front()->m_enqueueTime<oldestBand->front()->m_enqueueTime)
+			oldestBand=&band;
+	}
+	if(oldestBand && curTime-oldestBand->front()->m_enqueueTime>=static_cast<__int64>(maxWaitTime)*1000)
+		return oldestBand;
+	return retBand;
+}
+
+void JobScheduleQueue::SetMaxWaitTime(unsigned int maxWaitInMilliSec)
+{
+	m_maxWaitTime=maxWaitInMilliSec;
+}
+
+unsigned int JobScheduleQueue::GetMaxWaitTime() const
+{
+	return m_maxWaitTime;
+}
+
+void JobScheduleQueue::SetCapacity(size_t capacity, OverflowPolicy policy)
+{
+	LockObj lock(m_queueLock);
+	m_bound.SetCapacity(capacity,policy);
+}
+
+size_t JobScheduleQueue::GetCapacity() const
+{
+	return m_bound.GetCapacity();
+}
+
+OverflowPolicy JobScheduleQueue::GetOverflowPolicy() const
+{
+	return m_bound.GetOverflowPolicy();
+}
+
+size_t JobScheduleQueue::GetHighWaterMark() const
+{
+	return m_bound.GetHighWaterMark();
+}
+
+void JobScheduleQueue::ResetHighWaterMark()
+{
+	m_bound.ResetHighWaterMark();
+}
+
+size_t JobScheduleQueue::GetDropCount() const
+{
+	return m_bound.GetDropCount();
+}
+
+QueueBound::Admission JobScheduleQueue::admit(BaseJob *&retDroppedJob)
+{
+	for(;;)
+	{
+		QueueBound::Admission admission=m_bound.Admit(static_cast<size_t>(m_jobCount));
+		if(admission==QueueBound::ADMISSION_WAIT)
+		{
+			m_bound.WaitNotFull(m_queueLock);
+			continue;
+		}
+		if(admission==QueueBound::ADMISSION_DROP_OLDEST)
+			retDroppedJob=dropLowest();
+		return admission;
+	}
+}
+
+BaseJob *JobScheduleQueue::dropLowest()
+{
+	JobBandMap::reverse_iterator bandIter;
+	for(bandIter=m_bandMap.rbegin();bandIter!=m_bandMap.rend();bandIter++)
+	{
+		JobBand &band=bandIter->second;
+		if(!band.empty())
+		{
+			BaseJob *jobObj=band.front();
+			band.pop_front();
+			InterlockedDecrement(&m_jobCount);
+			return jobObj;
+		}
+	}
+	return NULL;
+}
+
+void JobScheduleQueue::reportDropped(BaseJob *job)
+{
+	job->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+	job->ReleaseObj();
+}
+
+bool JobScheduleQueue::IsEmpty() const
+{
+	return m_jobCount==0;
+}
+
+bool JobScheduleQueue::IsExist(BaseJob* const &data) const
+{
+	LockObj lock(m_queueLock);
+	JobBandMap::const_iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
 	{
-		Pop();
+		JobBand::const_iterator jobIter;
+		for(jobIter=bandIter->second.begin();jobIter!=bandIter->second.end();jobIter++)
+		{
+			if(*jobIter==data)
+				return true;
+		}
 	}
+	return false;
 }
 
-void JobScheduleQueue::Push(BaseJob* const &data, BaseJob::JobStatus status)
+size_t JobScheduleQueue::Size() const
+{
+	long jobCount=m_jobCount;
+	return static_cast<size_t>(jobCount);
+}
+
+BaseJob* &JobScheduleQueue::Front()
+{
+	LockObj lock(m_queueLock);
+	JobBand *band=frontBand();
+	if(!band)
+	{
+		EP_ASSERT_EXPR(0,_T("Empty Queue"));
+	}
+	return band->front();
+}
+
+bool JobScheduleQueue::Push(BaseJob* const &data, BaseJob::JobStatus status)
 {
 	data->RetainObj();
-	ThreadSafePQueue::Push(data);
-	if(status!=BaseJob::JOB_STATUS_NONE)
+	if(!pushRetained(data,status))
 	{
-		data->JobReport(status);
+		data->ReleaseObj();
+		return false;
 	}
+	return true;
 }
+
+bool JobScheduleQueue::Push(SmartPtr<BaseJob> &data, BaseJob::JobStatus status)
+{
+	EP_ASSERT_EXPR(!data.IsNull(),_T("The job is NULL!"));
+	if(!pushRetained(data.Get(),status))
+		return false;
+	data.Detach();
+	return true;
+}
+
+bool JobScheduleQueue::pushRetained(BaseJob *data, BaseJob::JobStatus status)
+{
+	data->m_enqueueTime=WorkerMetrics::GetCurrentMicroSec();
+	BaseJob *droppedJob=NULL;
+	m_queueLock->Lock();
+	QueueBound::Admission admission=admit(droppedJob);
+	if(admission==QueueBound::ADMISSION_ACCEPT || admission==QueueBound::ADMISSION_DROP_OLDEST)
+	{
+		// report before publishing, since a worker can pop, run and release the job once the lock is released
+		if(status!=BaseJob::JOB_STATUS_NONE)
+			data->JobReport(status);
+		m_bandMap[data->GetPriority()].push_back(data);
+		InterlockedIncrement(&m_jobCount);
+		m_bound.NotifyPushed(static_cast<size_t>(m_jobCount));
+	}
+	m_queueLock->Unlock();
+	if(droppedJob)
+		reportDropped(droppedJob);
+	if(admission==QueueBound::ADMISSION_REJECT)
+		return false;
+	if(admission==QueueBound::ADMISSION_DROP_NEWEST)
+		reportDropped(data);
+	return true;
+}
+
+size_t JobScheduleQueue::PushBatch(BaseJob* const *data, size_t count, BaseJob::JobStatus status)
+{
+	if(m_bound.GetCapacity()!=0)
+	{
+		// the overflow policy decides per job, so take the lock per job
+		size_t dataTrav;
+		for(dataTrav=0;dataTrav<count;dataTrav++)
+		{
+			if(!Push(data[dataTrav],status))
+				break;
+		}
+		return dataTrav;
+	}
+	__int64 curTime=WorkerMetrics::GetCurrentMicroSec();
+	for(size_t dataTrav=0;dataTrav<count;dataTrav++)
+	{
+		data[dataTrav]->RetainObj();
+		data[dataTrav]->m_enqueueTime=curTime;
+	}
+	m_queueLock->Lock();
+	JobBand *band=NULL;
+	Priority bandPriority=0;
+	for(size_t dataTrav=0;dataTrav<count;dataTrav++)
+	{
+		Priority dataPriority=data[dataTrav]->GetPriority();
+		// batches usually share one priority, so skip the map lookup when it repeats
+		if(!band || dataPriority!=bandPriority)
+		{
+			band=&m_bandMap[dataPriority];
+			bandPriority=dataPriority;
+		}
+		// report before publishing, since a worker can pop, run and release the job once the lock is released
+		if(status!=BaseJob::JOB_STATUS_NONE)
+			data[dataTrav]->JobReport(status);
+		band->push_back(data[dataTrav]);
+	}
+	InterlockedExchangeAdd(&m_jobCount,static_cast<long>(count));
+	m_bound.NotifyPushed(static_cast<size_t>(m_jobCount));
+	m_queueLock->Unlock();
+	return count;
+}
+
 void JobScheduleQueue::Pop()
 {
-	BaseJob* jobObj=Front();
+	m_queueLock->Lock();
+	JobBand *band=frontBand();
+	if(!band)
+	{
+		m_queueLock->Unlock();
+		EP_ASSERT_EXPR(0,_T("Empty Queue"));
+		return;
+	}
+	BaseJob* jobObj=band->front();
+	band->pop_front();
+	InterlockedDecrement(&m_jobCount);
+	m_bound.NotifyPopped();
+	m_queueLock->Unlock();
 	jobObj->ReleaseObj();
-	ThreadSafePQueue::Pop();
+}
+
+size_t JobScheduleQueue::PopBatch(BaseJob** retData, size_t maxCount)
+{
+	LockObj lock(m_queueLock);
+	size_t popCount=0;
+	if(m_maxWaitTime==WAITTIME_INIFINITE)
+	{
+		JobBandMap::iterator bandIter;
+		for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end() && popCount<maxCount;bandIter++)
+		{
+			JobBand &band=bandIter->second;
+			while(!band.empty() && popCount<maxCount)
+			{
+				retData[popCount]=band.front();
+				band.pop_front();
+				popCount++;
+			}
+		}
+	}
+	else
+	{
+		__int64 curTime=WorkerMetrics::GetCurrentMicroSec();
+		JobBand *band;
+		while(popCount<maxCount && (band=nextBand(curTime))!=NULL)
+		{
+			retData[popCount]=band->front();
+			band->pop_front();
+			popCount++;
+		}
+	}
+	InterlockedExchangeAdd(&m_jobCount,-static_cast<long>(popCount));
+	if(popCount>0)
+		m_bound.NotifyPopped();
+	return popCount;
+}
 
+bool JobScheduleQueue::eraseFromBand(JobBand &band, BaseJob * const object)
+{
+	JobBand::iterator jobIter;
+	for(jobIter=band.begin();jobIter!=band.end();jobIter++)
+	{
+		if(*jobIter==object)
+		{
+			(*jobIter)->JobReport(BaseJob::JOB_STATUS_TIMEOUT);
+			(*jobIter)->ReleaseObj();
+			band.erase(jobIter);
+			InterlockedDecrement(&m_jobCount);
+			m_bound.NotifyPopped();
+			return true;
+		}
+	}
+	return false;
 }
 
 bool JobScheduleQueue::Erase(BaseJob * const object)
 {
 	LockObj lock(m_queueLock);
-	if(m_queue.empty())
+	if(m_jobCount==0)
 		return false;
-	std::vector<BaseJob*>::iterator iter;
-	for(iter=m_queue.begin();iter!=m_queue.end();iter++)
+	// look in the band of the current priority first, since the priority may have changed after Push
+	JobBandMap::iterator priorityIter=m_bandMap.find(object->GetPriority());
+	if(priorityIter!=m_bandMap.end() && eraseFromBand(priorityIter->second,object))
+		return true;
+	JobBandMap::iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
 	{
-		if(*iter==object)
-		{
-			(*iter)->JobReport(BaseJob::JOB_STATUS_TIMEOUT);
-			(*iter)->ReleaseObj();
-			m_queue.erase(iter);
+		if(bandIter!=priorityIter && eraseFromBand(bandIter->second,object))
 			return true;
-		}
 	}
 	return false;
 }
 
 void JobScheduleQueue::ReportAllJob(const BaseJob::JobStatus status)
 {
+	std::vector<BaseJob *> queue=GetQueue();
 	std::vector<BaseJob *>::iterator iter;
-	m_queueLock->Lock();
-	std::vector<BaseJob *> queue=m_queue;
-	m_queueLock->Unlock();
 	for(iter=queue.begin();iter!=queue.end();iter++)
 	{
-		(*iter)->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+		(*iter)->JobReport(status);
 	}
 
+}
+
+std::vector<BaseJob*> JobScheduleQueue::GetQueue() const
+{
+	LockObj lock(m_queueLock);
+	std::vector<BaseJob*> retQueue;
+	retQueue.reserve(m_jobCount);
+	JobBandMap::const_iterator bandIter;
+	for(bandIter=m_bandMap.begin();bandIter!=m_bandMap.end();bandIter++)
+	{
+		retQueue.insert(retQueue.end(),bandIter->second.begin(),bandIter->second.end());
+	}
+	return retQueue;
 }
\ No newline at end of file
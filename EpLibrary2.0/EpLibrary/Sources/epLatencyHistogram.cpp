@@ -0,0 +1,149 @@
+/*! 
+LatencyHistogram for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epLatencyHistogram.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+LatencyHistogram::LatencyHistogram()
+{
+	Clear();
+}
+
+void LatencyHistogram::Record(__int64 value)
+{
+	if(value<0)
+		value=0;
+	m_counts[GetBucketIndex(value)]++;
+	m_totalCount++;
+	if(value>m_maxValue)
+		m_maxValue=value;
+}
+
+void LatencyHistogram::RecordConcurrent(__int64 value)
+{
+	if(value<0)
+		value=0;
+	InterlockedIncrement64(&m_counts[GetBucketIndex(value)]);
+	InterlockedIncrement64(&m_totalCount);
+	// the maximum is raised only by the larger value, so the loop is rarely taken
+	__int64 maxValue=m_maxValue;
+	while(value>maxValue)
+	{
+		__int64 prevValue=InterlockedCompareExchange64(&m_maxValue,value,maxValue);
+		if(prevValue==maxValue)
+			break;
+		maxValue=prevValue;
+	}
+}
+
+void LatencyHistogram::Add(const LatencyHistogram &b)
+{
+	for(unsigned int bucketTrav=0;bucketTrav<LATENCY_HISTOGRAM_BUCKET_COUNT;bucketTrav++)
+		m_counts[bucketTrav]+=b.m_counts[bucketTrav];
+	m_totalCount+=b.m_totalCount;
+	if(b.m_maxValue>m_maxValue)
+		m_maxValue=b.m_maxValue;
+}
+
+void LatencyHistogram::Subtract(const LatencyHistogram &b)
+{
+	for(unsigned int bucketTrav=0;bucketTrav<LATENCY_HISTOGRAM_BUCKET_COUNT;bucketTrav++)
+		m_counts[bucketTrav]-=b.m_counts[bucketTrav];
+	m_totalCount-=b.m_totalCount;
+}
+
+void LatencyHistogram::Clear()
+{
+	for(unsigned int bucketTrav=0;bucketTrav<LATENCY_HISTOGRAM_BUCKET_COUNT;bucketTrav++)
+		m_counts[bucketTrav]=0;
+	m_totalCount=0;
+	m_maxValue=0;
+}
+
+__int64 LatencyHistogram::GetTotalCount() const
+{
+	return m_totalCount;
+}
+
+__int64 LatencyHistogram::GetMaxValue() const
+{
+	return m_maxValue;
+}
+
+__int64 LatencyHistogram::GetValueAtPercentile(double percentile) const
+{
+	if(m_totalCount<=0)
+		return 0;
+	double targetCount=static_cast<double>(m_totalCount)*percentile/100.0;
+	__int64 accCount=0;
+	for(unsigned int bucketTrav=0;bucketTrav<LATENCY_HISTOGRAM_BUCKET_COUNT;bucketTrav++)
+	{
+		accCount+=m_counts[bucketTrav];
+		if(accCount>0 && static_cast<double>(accCount)>=targetCount)
+		{
+			__int64 highestValue=GetBucketHighestValue(bucketTrav);
+			return (highestValue<m_maxValue)?highestValue:m_maxValue;
+		}
+	}
+	return m_maxValue;
+}
+
+unsigned int LatencyHistogram::GetBucketIndex(__int64 value)
+{
+	if(value<LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+		return static_cast<unsigned int>(value);
+	unsigned __int64 remain=static_cast<unsigned __int64>(value);
+	unsigned int highestBit=0;
+	for(unsigned int shift=32;shift>0;shift>>=1)
+	{
+		if(remain>>shift)
+		{
+			remain>>=shift;
+			highestBit+=shift;
+		}
+	}
+	// the range [2^highestBit, 2^(highestBit+1)) is split linearly by the bits below the highest bit
+	unsigned int subShift=highestBit-(LATENCY_HISTOGRAM_SUB_BUCKET_BITS-1);
+	unsigned int subIdx=static_cast<unsigned int>(value>>subShift)-LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2;
+	return LATENCY_HISTOGRAM_SUB_BUCKET_COUNT+(highestBit-LATENCY_HISTOGRAM_SUB_BUCKET_BITS)*(LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2)+subIdx;
+}
+
+__int64 LatencyHistogram::GetBucketHighestValue(unsigned int bucketIdx)
+{
+	if(bucketIdx<LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)
+		return static_cast<__int64>(bucketIdx);
+	unsigned int rangeIdx=(bucketIdx-LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)/(LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2);
+	unsigned int subIdx=(bucketIdx-LATENCY_HISTOGRAM_SUB_BUCKET_COUNT)%(LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2);
+	unsigned int subShift=rangeIdx+1;
+	__int64 lowestValue=static_cast<__int64>(LATENCY_HISTOGRAM_SUB_BUCKET_COUNT/2+subIdx)<<subShift;
+	return lowestValue+((static_cast<__int64>(1)<<subShift)-1);
+}
@@ -0,0 +1,172 @@
+/*! 
+LightEvent for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epLightEvent.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+
+LightEvent::LightEvent(bool isInitialRaised, bool isManualReset) :BaseLock()
+{
+	m_isInitialRaised=isInitialRaised;
+	m_isManualReset=isManualReset;
+	m_state=(m_isInitialRaised)?1:0;
+}
+
+LightEvent::LightEvent(const LightEvent& b) :BaseLock()
+{
+	m_isInitialRaised=b.m_isInitialRaised;
+	m_isManualReset=b.m_isManualReset;
+	m_state=(m_isInitialRaised)?1:0;
+}
+
+LightEvent::~LightEvent()
+{
+}
+
+LightEvent & LightEvent::operator=(const LightEvent&b)
+{
+	if(this != &b)
+	{
+		EP_ASSERT_EXPR(m_state>=0,_T("The thread is waiting on the event!"));
+		m_isInitialRaised=b.m_isInitialRaised;
+		m_isManualReset=b.m_isManualReset;
+		m_state=(m_isInitialRaised)?1:0;
+	}
+	return *this;
+}
+
+bool LightEvent::Lock()
+{
+	return WaitForEvent(WAITTIME_INIFINITE);
+}
+
+long LightEvent::TryLock()
+{
+	if(tryTake())
+		return 1;
+	return 0;
+}
+
+long LightEvent::TryLockFor(const unsigned int dwMilliSecond)
+{
+	if(WaitForEvent(dwMilliSecond))
+		return 1;
+	return 0;
+}
+
+void LightEvent::Unlock()
+{
+	SetEvent();
+}
+
+bool LightEvent::IsManualReset() const
+{
+	return m_isManualReset;
+}
+
+bool LightEvent::ResetEvent()
+{
+	// only the raised state is reset, the waiting threads stay counted
+	InterlockedCompareExchange(&m_state,0,1);
+	return true;
+}
+
+bool LightEvent::SetEvent()
+{
+	if(m_isManualReset)
+	{
+		// wake up all waiting threads, and stay raised
+		long prevState=InterlockedExchange(&m_state,1);
+		if(prevState<0)
+			return m_sem.Post(-prevState);
+		return true;
+	}
+	long state=m_state;
+	while(state!=1)
+	{
+		// wake up one waiting thread, or raise if none is waiting
+		long prevState=InterlockedCompareExchange(&m_state,state+1,state);
+		if(prevState==state)
+		{
+			if(state<0)
+				return m_sem.Post(1);
+			return true;
+		}
+		state=prevState;
+	}
+	return true;
+}
+
+bool LightEvent::WaitForEvent(const unsigned int dwMilliSecond)
+{
+	if(tryTake())
+		return true;
+	if(dwMilliSecond==0)
+		return false;
+	// count this thread as waiting, unless the event got raised meanwhile
+	long state=m_state;
+	while(true)
+	{
+		if(state==1)
+		{
+			if(tryTake())
+				return true;
+			state=m_state;
+			continue;
+		}
+		long prevState=InterlockedCompareExchange(&m_state,state-1,state);
+		if(prevState==state)
+			break;
+		state=prevState;
+	}
+	if(m_sem.Wait(dwMilliSecond))
+		return true;
+	// timed out, so stop counting this thread as waiting, unless SetEvent already counted it
+	while(true)
+	{
+		state=m_state;
+		if(state>=0)
+		{
+			m_sem.Wait();
+			return true;
+		}
+		if(InterlockedCompareExchange(&m_state,state+1,state)==state)
+			return false;
+	}
+}
+
+bool LightEvent::tryTake()
+{
+	if(m_isManualReset)
+		return m_state==1;
+	return InterlockedCompareExchange(&m_state,0,1)==1;
+}
@@ -0,0 +1,159 @@
+/*! 
+LightSemaphore for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epLightSemaphore.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+
+LightSemaphore::LightSemaphore(long initialCount, unsigned int spinCount) :BaseLock()
+{
+	EP_ASSERT_EXPR(initialCount>=0,_T("The initial count must be greater than or equal to 0!"));
+	m_initialCount=initialCount;
+	m_count=initialCount;
+	// the releasing thread cannot make progress while this thread spins on the single core
+	if(System::GetNumberOfCores()<=1)
+		spinCount=0;
+	m_spinCount=spinCount;
+}
+
+LightSemaphore::LightSemaphore(const LightSemaphore& b) :BaseLock()
+{
+	m_initialCount=b.m_initialCount;
+	m_count=b.m_initialCount;
+	m_spinCount=b.m_spinCount;
+}
+
+LightSemaphore::~LightSemaphore()
+{
+}
+
+LightSemaphore & LightSemaphore::operator=(const LightSemaphore&b)
+{
+	if(this != &b)
+	{
+		EP_ASSERT_EXPR(m_count>=0,_T("The thread is waiting on the semaphore!"));
+		m_initialCount=b.m_initialCount;
+		m_count=b.m_initialCount;
+		m_spinCount=b.m_spinCount;
+	}
+	return *this;
+}
+
+bool LightSemaphore::Lock()
+{
+	return take(WAITTIME_INIFINITE);
+}
+
+long LightSemaphore::TryLock()
+{
+	if(tryTake())
+		return 1;
+	return 0;
+}
+
+long LightSemaphore::TryLockFor(const unsigned int dwMilliSecond)
+{
+	if(tryTake())
+		return 1;
+	if(dwMilliSecond==0)
+		return 0;
+	if(take(dwMilliSecond))
+		return 1;
+	return 0;
+}
+
+void LightSemaphore::Unlock()
+{
+	Release(1);
+}
+
+long LightSemaphore::Release(long releaseCount, long * retPreviousCount)
+{
+	EP_ASSERT_EXPR(releaseCount>0,_T("The release count must be greater than 0!"));
+	if(releaseCount<=0)
+		return 0;
+	long prevCount=InterlockedExchangeAdd(&m_count,releaseCount);
+	if(retPreviousCount)
+		*retPreviousCount=(prevCount>0)?prevCount:0;
+	if(prevCount<0)
+	{
+		// wake up only the threads actually waiting
+		long wakeCount=(-prevCount<releaseCount)?-prevCount:releaseCount;
+		return m_sem.Post(wakeCount)?1:0;
+	}
+	return 1;
+}
+
+long LightSemaphore::GetCount() const
+{
+	long count=m_count;
+	return (count>0)?count:0;
+}
+
+bool LightSemaphore::tryTake()
+{
+	long count=m_count;
+	while(count>0)
+	{
+		long prevCount=InterlockedCompareExchange(&m_count,count-1,count);
+		if(prevCount==count)
+			return true;
+		count=prevCount;
+	}
+	return false;
+}
+
+bool LightSemaphore::take(const unsigned int dwMilliSecond)
+{
+	for(unsigned int spinTrav=0;spinTrav<m_spinCount;spinTrav++)
+	{
+		if(tryTake())
+			return true;
+		YieldProcessor();
+	}
+	if(InterlockedDecrement(&m_count)>=0)
+		return true;
+	if(m_sem.Wait(dwMilliSecond))
+		return true;
+	// timed out, so stop counting this thread as waiting, unless the release already counted it
+	while(true)
+	{
+		long count=m_count;
+		if(count>=0)
+		{
+			m_sem.Wait();
+			return true;
+		}
+		if(InterlockedCompareExchange(&m_count,count+1,count)==count)
+			return false;
+	}
+}
@@ -26,9 +26,14 @@ THE SOFTWARE.
 #include "epLocale.h"
 
 #include <locale>
-#include <functional>
 #include <algorithm>
 
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_LOCALE_SSE2
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
 #undef THIS_FILE
@@ -37,273 +42,300 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
-bool Locale::IsCAlnum(char c)
-{
-	std::locale loc;
-	return std::isalnum(c,loc);
-}
-bool Locale::IsCAlpha(char c)
-{
-	std::locale loc;
-	return std::isalpha(c,loc);
-}
-bool Locale::IsCCntrl(char c)
-{
-	std::locale loc;
-	return std::iscntrl(c,loc);
-}
-bool Locale::IsCDigit(char c)
-{
-	std::locale loc;
-	return std::isdigit(c,loc);
-}
-bool Locale::IsCGraph(char c)
-{
-	std::locale loc;
-	return std::isgraph(c,loc);
-}
-bool Locale::IsCLower(char c)
+bool Locale::isLocaleClass(char c, std::ctype_base::mask mask)
 {
 	std::locale loc;
-	return std::islower(c,loc);
+	return std::use_facet<std::ctype<char> >(loc).is(mask,c);
 }
-bool Locale::IsCPunct(char c)
+bool Locale::isLocaleClass(wchar_t c, std::ctype_base::mask mask)
 {
 	std::locale loc;
-	return std::ispunct(c,loc);
+	return std::use_facet<std::ctype<wchar_t> >(loc).is(mask,c);
 }
-bool Locale::IsCUpper(char c)
-{
-	std::locale loc;
-	return std::isupper(c,loc);
-}
-bool Locale::IsCXdigit(char c)
-{
-	std::locale loc;
-	return std::isxdigit(c,loc);
-}
-char Locale::ToCLower(char c)
+char Locale::toLocaleLower(char c)
 {
 	std::locale loc;
 	return std::tolower(c,loc);
 }
-char Locale::ToCUpper(char c)
-{
-	std::locale loc;
-	return std::toupper(c,loc);
-}
-bool Locale::IsCPrint(char c)
-{
-	std::locale loc;
-	return std::isprint(c,loc);
-}
-bool Locale::IsCSpace(char c)
-{
-	std::locale loc;
-	return std::isspace(c,loc);	
-}
-
-
-bool Locale::IsWAlnum(wchar_t c)
-{
-	std::locale loc;
-	return std::isalnum(c,loc);
-}
-bool Locale::IsWAlpha(wchar_t c)
-{
-	std::locale loc;
-	return std::isalpha(c,loc);
-}
-bool Locale::IsWCntrl(wchar_t c)
-{
-	std::locale loc;
-	return std::iscntrl(c,loc);
-}
-bool Locale::IsWDigit(wchar_t c)
-{
-	std::locale loc;
-	return std::isdigit(c,loc);
-}
-bool Locale::IsWGraph(wchar_t c)
-{
-	std::locale loc;
-	return std::isgraph(c,loc);
-}
-bool Locale::IsWLower(wchar_t c)
-{
-	std::locale loc;
-	return std::islower(c,loc);
-}
-bool Locale::IsWPunct(wchar_t c)
-{
-	std::locale loc;
-	return std::ispunct(c,loc);
-}
-bool Locale::IsWUpper(wchar_t c)
-{
-	std::locale loc;
-	return std::isupper(c,loc);
-}
-bool Locale::IsWXdigit(wchar_t c)
-{
-	std::locale loc;
-	return std::isxdigit(c,loc);
-}
-wchar_t Locale::ToWLower(wchar_t c)
+wchar_t Locale::toLocaleLower(wchar_t c)
 {
 	std::locale loc;
 	return std::tolower(c,loc);
 }
-wchar_t Locale::ToWUpper(wchar_t c)
+char Locale::toLocaleUpper(char c)
 {
 	std::locale loc;
 	return std::toupper(c,loc);
 }
-bool Locale::IsWPrint(wchar_t c)
-{
-	std::locale loc;
-	return std::isprint(c,loc);
-}
-bool Locale::IsWSpace(wchar_t c)
+wchar_t Locale::toLocaleUpper(wchar_t c)
 {
 	std::locale loc;
-	return std::isspace(c,loc);
+	return std::toupper(c,loc);
 }
 
-
-bool Locale::IsAlnum(TCHAR c)
-{
-	std::locale loc;
-	return std::isalnum(c,loc);
-}
-bool Locale::IsAlpha(TCHAR c)
-{
-	std::locale loc;
-	return std::isalpha(c,loc);
-}
-bool Locale::IsCntrl(TCHAR c)
+/*!
+Check whether given character is printable
+@param[in] c the character to check
+@return true if printable otherwise false
+*/
+static bool isPrintChar(char c)
 {
-	std::locale loc;
-	return std::iscntrl(c,loc);
+	return Locale::IsCPrint(c);
 }
-bool Locale::IsDigit(TCHAR c)
+
+/*!
+Check whether given character is printable
+@param[in] c the character to check
+@return true if printable otherwise false
+*/
+static bool isPrintChar(wchar_t c)
 {
-	std::locale loc;
-	return std::isdigit(c,loc);
+	return Locale::IsWPrint(c);
 }
-bool Locale::IsGraph(TCHAR c)
+
+/*!
+Check whether given character is a space
+@param[in] c the character to check
+@return true if given character is a space otherwise false
+*/
+static bool isSpaceChar(char c)
 {
-	std::locale loc;
-	return std::isgraph(c,loc);
+	return Locale::IsCSpace(c);
 }
-bool Locale::IsLower(TCHAR c)
+
+/*!
+Check whether given character is a space
+@param[in] c the character to check
+@return true if given character is a space otherwise false
+*/
+static bool isSpaceChar(wchar_t c)
 {
-	std::locale loc;
-	return std::islower(c,loc);
+	return Locale::IsWSpace(c);
 }
-bool Locale::IsPunct(TCHAR c)
+
+#if defined(EP_LOCALE_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
 {
-	std::locale loc;
-	return std::ispunct(c,loc);
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
 }
-bool Locale::IsUpper(TCHAR c)
+
+/*!
+Return the byte mask of the characters of given 16 byte block, which are trimmed.
+@param[in] block the 16 byte block of the characters.
+@param[in] isSpace true to find the ASCII spaces, false to find the ASCII control characters.
+@return the byte mask of the characters trimmed.
+*/
+static int trimMaskSSE2(const char *block, bool isSpace)
 {
-	std::locale loc;
-	return std::isupper(c,loc);
+	__m128i chars=_mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+	__m128i zero=_mm_setzero_si128();
+	__m128i matched;
+	if(isSpace)
+	{
+		// ' ' or '\t','\n','\v','\f','\r'
+		matched=_mm_cmpeq_epi8(chars,_mm_set1_epi8(0x20));
+		__m128i ranged=_mm_subs_epu8(_mm_sub_epi8(chars,_mm_set1_epi8(0x09)),_mm_set1_epi8(0x04));
+		matched=_mm_or_si128(matched,_mm_cmpeq_epi8(ranged,zero));
+	}
+	else
+	{
+		// 0x00-0x1F or 0x7F
+		matched=_mm_cmpeq_epi8(_mm_subs_epu8(chars,_mm_set1_epi8(0x1F)),zero);
+		matched=_mm_or_si128(matched,_mm_cmpeq_epi8(chars,_mm_set1_epi8(0x7F)));
+	}
+	return _mm_movemask_epi8(matched);
 }
-bool Locale::IsXdigit(TCHAR c)
+
+/*!
+Return the byte mask of the characters of given 16 byte block, which are trimmed.
+@param[in] block the 16 byte block of the characters.
+@param[in] isSpace true to find the ASCII spaces, false to find the ASCII control characters.
+@return the byte mask of the characters trimmed.
+*/
+static int trimMaskSSE2(const wchar_t *block, bool isSpace)
 {
-	std::locale loc;
-	return std::isxdigit(c,loc);
+	__m128i chars=_mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+	__m128i zero=_mm_setzero_si128();
+	__m128i matched;
+	if(isSpace)
+	{
+		// ' ' or '\t','\n','\v','\f','\r'
+		matched=_mm_cmpeq_epi16(chars,_mm_set1_epi16(0x20));
+		__m128i ranged=_mm_subs_epu16(_mm_sub_epi16(chars,_mm_set1_epi16(0x09)),_mm_set1_epi16(0x04));
+		matched=_mm_or_si128(matched,_mm_cmpeq_epi16(ranged,zero));
+	}
+	else
+	{
+		// 0x00-0x1F or 0x7F
+		matched=_mm_cmpeq_epi16(_mm_subs_epu16(chars,_mm_set1_epi16(0x1F)),zero);
+		matched=_mm_or_si128(matched,_mm_cmpeq_epi16(chars,_mm_set1_epi16(0x7F)));
+	}
+	return _mm_movemask_epi8(matched);
 }
-TCHAR Locale::ToLower(TCHAR c)
+
+/*!
+Skip the whole 16 byte blocks of the trimmed characters forward.
+@param[in] str the characters to scan.
+@param[in] charTrav the index to start from.
+@param[in] end the end index of the characters.
+@param[in] isSpace true to skip the ASCII spaces, false to skip the ASCII control characters.
+@return the index of the first block which is not skipped.
+*/
+template<typename CharType>
+static size_t skipForwardSSE2(const CharType *str, size_t charTrav, size_t end, bool isSpace)
 {
-	std::locale loc;
-	return std::tolower(c,loc);
+	const size_t blockLength=16/sizeof(CharType);
+	while(charTrav+blockLength<=end && trimMaskSSE2(str+charTrav,isSpace)==0xFFFF)
+		charTrav+=blockLength;
+	return charTrav;
 }
-TCHAR Locale::ToUpper(TCHAR c)
+
+/*!
+Skip the whole 16 byte blocks of the trimmed characters backward.
+@param[in] str the characters to scan.
+@param[in] begin the begin index of the characters.
+@param[in] charTrav the end index to start from.
+@param[in] isSpace true to skip the ASCII spaces, false to skip the ASCII control characters.
+@return the end index of the last block which is not skipped.
+*/
+template<typename CharType>
+static size_t skipBackwardSSE2(const CharType *str, size_t begin, size_t charTrav, bool isSpace)
 {
-	std::locale loc;
-	return std::toupper(c,loc);
+	const size_t blockLength=16/sizeof(CharType);
+	while(charTrav>=begin+blockLength && trimMaskSSE2(str+charTrav-blockLength,isSpace)==0xFFFF)
+		charTrav-=blockLength;
+	return charTrav;
 }
-bool Locale::IsPrint(TCHAR c)
-{
-	std::locale loc;
-	return std::isprint(c,loc);
+#endif //defined(EP_LOCALE_SSE2)
+
+/*!
+Find the begin index of the trimmed string.
+@param[in] str the characters to trim.
+@param[in] begin the begin index of the characters.
+@param[in] end the end index of the characters.
+@return the index of the first character after the non-printable characters and the following spaces.
+*/
+template<typename CharType>
+static size_t trimLeftIndex(const CharType *str, size_t begin, size_t end)
+{
+	size_t charTrav=begin;
+#if defined(EP_LOCALE_SSE2)
+	bool useSSE2=hasSSE2();
+	if(useSSE2)
+		charTrav=skipForwardSSE2(str,charTrav,end,false);
+#endif //defined(EP_LOCALE_SSE2)
+	while(charTrav<end && !isPrintChar(str[charTrav]))
+		charTrav++;
+#if defined(EP_LOCALE_SSE2)
+	if(useSSE2)
+		charTrav=skipForwardSSE2(str,charTrav,end,true);
+#endif //defined(EP_LOCALE_SSE2)
+	while(charTrav<end && isSpaceChar(str[charTrav]))
+		charTrav++;
+	return charTrav;
 }
-bool Locale::IsSpace(TCHAR c)
-{
-	std::locale loc;
-	return std::isspace(c,loc);
+
+/*!
+Find the end index of the trimmed string.
+@param[in] str the characters to trim.
+@param[in] begin the begin index of the characters.
+@param[in] end the end index of the characters.
+@return the index after the last character before the spaces and the following non-printable characters.
+*/
+template<typename CharType>
+static size_t trimRightIndex(const CharType *str, size_t begin, size_t end)
+{
+	size_t charTrav=end;
+#if defined(EP_LOCALE_SSE2)
+	bool useSSE2=hasSSE2();
+	if(useSSE2)
+		charTrav=skipBackwardSSE2(str,begin,charTrav,false);
+#endif //defined(EP_LOCALE_SSE2)
+	while(charTrav>begin && !isPrintChar(str[charTrav-1]))
+		charTrav--;
+#if defined(EP_LOCALE_SSE2)
+	if(useSSE2)
+		charTrav=skipBackwardSSE2(str,begin,charTrav,true);
+#endif //defined(EP_LOCALE_SSE2)
+	while(charTrav>begin && isSpaceChar(str[charTrav-1]))
+		charTrav--;
+	return charTrav;
 }
 
 EpString Locale::CTrimLeft(const EpString& str) 
 { 
-	EpString middleString;
-	EpString::const_iterator it = find_if(str.begin(), str.end(), std::ptr_fun(Locale::IsCPrint));
-	middleString=EpString(it, str.end());
-	it = find_if(middleString.begin(), middleString.end(), std::not1(std::ptr_fun(Locale::IsCSpace)));
-	return EpString(it, middleString.end());
+	return str.substr(trimLeftIndex(str.c_str(),0,str.length()));
 } 
 
 EpString Locale::CTrimRight(const EpString& str) 
 { 
-	EpString middleString;
-	EpString::const_reverse_iterator it = find_if(str.rbegin(), str.rend(), std::ptr_fun(Locale::IsCPrint));
-	middleString=EpString(str.begin(), it.base());
-	it = find_if(middleString.rbegin(), middleString.rend(), std::not1(std::ptr_fun(Locale::IsCSpace)));
-	return EpString(middleString.begin(), it.base());
+	return str.substr(0,trimRightIndex(str.c_str(),0,str.length()));
 } 
 
 EpString Locale::CTrim(const EpString& str)
 {
-	return CTrimLeft(CTrimRight(str));
+	size_t end=trimRightIndex(str.c_str(),0,str.length());
+	size_t begin=trimLeftIndex(str.c_str(),0,end);
+	return str.substr(begin,end-begin);
 }
+
 EpWString Locale::WTrimLeft(const EpWString& str) 
 { 
-	EpWString middleString;
-	EpWString::const_iterator it = find_if(str.begin(), str.end(), std::ptr_fun(Locale::IsWPrint));
-	middleString=EpWString(it, str.end());
-	it = find_if(middleString.begin(), middleString.end(), std::not1(std::ptr_fun(Locale::IsWSpace)));
-	return EpWString(it, middleString.end());
+	return str.substr(trimLeftIndex(str.c_str(),0,str.length()));
 } 
 
 EpWString Locale::WTrimRight(const EpWString& str) 
 { 
-	EpWString middleString;
-	EpWString::const_reverse_iterator it = find_if(str.rbegin(), str.rend(), std::ptr_fun(Locale::IsWPrint));
-	middleString=EpWString(str.begin(), it.base());
-	it = find_if(middleString.rbegin(), middleString.rend(), std::not1(std::ptr_fun(Locale::IsWSpace)));
-	return EpWString(middleString.begin(), it.base());
+	return str.substr(0,trimRightIndex(str.c_str(),0,str.length()));
 } 
 
 EpWString Locale::WTrim(const EpWString& str)
 {
-	return WTrimLeft(WTrimRight(str));
+	size_t end=trimRightIndex(str.c_str(),0,str.length());
+	size_t begin=trimLeftIndex(str.c_str(),0,end);
+	return str.substr(begin,end-begin);
 }
 
-
 EpTString Locale::TrimLeft(const EpTString& str) 
 { 
-	EpTString middleString;
-	EpTString::const_iterator it = find_if(str.begin(), str.end(), std::ptr_fun(Locale::IsPrint));
-	middleString=EpTString(it, str.end());
-	it = find_if(middleString.begin(), middleString.end(), std::not1(std::ptr_fun(Locale::IsSpace)));
-	return EpTString(it, middleString.end());
+	return str.substr(trimLeftIndex(str.c_str(),0,str.length()));
 } 
 
 EpTString Locale::TrimRight(const EpTString& str) 
 { 
-	EpTString middleString;
-	EpTString::const_reverse_iterator it = find_if(str.rbegin(), str.rend(), std::ptr_fun(Locale::IsPrint));
-	middleString=EpTString(str.begin(), it.base());
-	it = find_if(middleString.rbegin(), middleString.rend(), std::not1(std::ptr_fun(Locale::IsSpace)));
-	return EpTString(middleString.begin(), it.base());
+	return str.substr(0,trimRightIndex(str.c_str(),0,str.length()));
 } 
 
 EpTString Locale::Trim(const EpTString& str)
 {
-	return TrimLeft(TrimRight(str));
+	size_t end=trimRightIndex(str.c_str(),0,str.length());
+	size_t begin=trimLeftIndex(str.c_str(),0,end);
+	return str.substr(begin,end-begin);
+}
+
+size_t Locale::TrimLeftIndex(const TCHAR *str, size_t length)
+{
+	return trimLeftIndex(str,0,length);
+}
+
+size_t Locale::TrimRightIndex(const TCHAR *str, size_t length)
+{
+	return trimRightIndex(str,0,length);
 }
 
 
@@ -313,7 +345,7 @@ EpString Locale::ToCUpper(const EpString& str)
 	int stringTrav;
 	for(stringTrav=0;stringTrav!=retString.length();stringTrav++)
 	{
-		Locale::ToCUpper(retString.at(stringTrav));
+		retString.at(stringTrav)=Locale::ToCUpper(retString.at(stringTrav));
 	}
 	return retString;
 }
@@ -323,7 +355,7 @@ EpString Locale::ToCLower(const EpString& str)
 	int stringTrav;
 	for(stringTrav=0;stringTrav!=retString.length();stringTrav++)
 	{
-		Locale::ToCLower(retString.at(stringTrav));
+		retString.at(stringTrav)=Locale::ToCLower(retString.at(stringTrav));
 	}
 	return retString;
 }
@@ -333,7 +365,7 @@ EpWString Locale::ToWUpper(const EpWString& str)
 	int stringTrav;
 	for(stringTrav=0;stringTrav!=retString.length();stringTrav++)
 	{
-		Locale::ToWUpper(retString.at(stringTrav));
+		retString.at(stringTrav)=Locale::ToWUpper(retString.at(stringTrav));
 	}
 	return retString;
 }
@@ -343,7 +375,7 @@ EpWString Locale::ToWLower(const EpWString& str)
 	int stringTrav;
 	for(stringTrav=0;stringTrav!=retString.length();stringTrav++)
 	{
-		Locale::ToWLower(retString.at(stringTrav));
+		retString.at(stringTrav)=Locale::ToWLower(retString.at(stringTrav));
 	}
 	return retString;
 }
@@ -353,7 +385,7 @@ EpTString Locale::ToUpper(const EpTString& str)
 	int stringTrav;
 	for(stringTrav=0;stringTrav!=retString.length();stringTrav++)
 	{
-		Locale::ToUpper(retString.at(stringTrav));
+		retString.at(stringTrav)=Locale::ToUpper(retString.at(stringTrav));
 	}
 	return retString;
 }
@@ -363,7 +395,7 @@ EpTString Locale::ToLower(const EpTString& str)
 	int stringTrav;
 	for(stringTrav=0;stringTrav!=retString.length();stringTrav++)
 	{
-		Locale::ToLower(retString.at(stringTrav));
+		retString.at(stringTrav)=Locale::ToLower(retString.at(stringTrav));
 	}
 	return retString;
 }
@@ -0,0 +1,161 @@
+/*! 
+LockProfileManager for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epLockProfiler.h"
+#include "epFolderHelper.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+LockProfileStat::LockProfileStat()
+{
+	acquireCount=0;
+	contendedCount=0;
+	totalWaitTime=0;
+	maxHoldTime=0;
+	holdStartTime=0;
+	holdDepth=0;
+}
+
+LockProfileManager::LockProfileNode::LockProfileNode(BaseLock *lock, const TCHAR *name):OutputNode()
+{
+	m_lock=lock;
+	m_name=name;
+}
+
+LockProfileManager::LockProfileNode::~LockProfileNode()
+{
+}
+
+void LockProfileManager::LockProfileNode::format(EpTString &retString) const
+{
+	// read without the profiled lock, so the values may be slightly behind
+	__int64 acquireCount=m_stat.acquireCount;
+	__int64 contendedCount=m_stat.contendedCount;
+	__int64 totalWaitTime=m_stat.totalWaitTime;
+	__int64 contendedPercent=0;
+	__int64 averageWaitTime=0;
+	if(acquireCount)
+		contendedPercent=contendedCount*100/acquireCount;
+	if(contendedCount)
+		averageWaitTime=totalWaitTime/contendedCount;
+	System::STPrintf(retString,_T("%s Acquire : %I64d Contended : %I64d (%I64d%%) Total Wait : %I64d us Average Wait : %I64d us Max Hold : %I64d us%s\n"),m_name.c_str(),acquireCount,contendedCount,contendedPercent,totalWaitTime,averageWaitTime,m_stat.maxHoldTime,m_lock?_T(""):_T(" (destroyed)"));
+}
+
+void LockProfileManager::LockProfileNode::Print() const
+{
+	EpTString output;
+	format(output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void LockProfileManager::LockProfileNode::Write(EpFile* const file)
+{
+	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
+	EpTString output;
+	format(output);
+	System::FTPrintf(file,_T("%s"),output.c_str());
+}
+
+LockProfileManager::LockProfileManager(LockPolicy lockPolicyType):BaseOutputter(lockPolicyType)
+{
+	m_fileName=FolderHelper::GetModuleFileDirectory();
+	m_fileName.append(_T("lockprofile.dat"));
+}
+
+LockProfileManager::~LockProfileManager()
+{
+	LockObj lock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		// detach the live locks, so they do not unregister after this manager is gone
+		LockProfileNode *node=static_cast<LockProfileNode*>(*iter);
+		if(node->m_lock)
+			node->m_lock->m_profileStat=NULL;
+		node->m_lock=NULL;
+	}
+}
+
+void LockProfileManager::Clear()
+{
+	LockObj lock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter=m_list.begin();
+	while(iter!=m_list.end())
+	{
+		LockProfileNode *node=static_cast<LockProfileNode*>(*iter);
+		if(node->m_lock)
+		{
+			node->m_stat.acquireCount=0;
+			node->m_stat.contendedCount=0;
+			node->m_stat.totalWaitTime=0;
+			node->m_stat.maxHoldTime=0;
+			iter++;
+		}
+		else
+		{
+			EP_DELETE node;
+			iter=m_list.erase(iter);
+		}
+	}
+}
+
+LockProfileStat *LockProfileManager::registerLock(BaseLock *lock, const TCHAR *name)
+{
+	LockObj listLock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		LockProfileNode *node=static_cast<LockProfileNode*>(*iter);
+		if(node->m_lock==lock)
+		{
+			node->m_name=name;
+			return &node->m_stat;
+		}
+	}
+	LockProfileNode *node=EP_NEW LockProfileNode(lock,name);
+	m_list.push_back(node);
+	return &node->m_stat;
+}
+
+void LockProfileManager::unregisterLock(BaseLock *lock)
+{
+	LockObj listLock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		LockProfileNode *node=static_cast<LockProfileNode*>(*iter);
+		if(node->m_lock==lock)
+		{
+			node->m_lock=NULL;
+			return;
+		}
+	}
+}
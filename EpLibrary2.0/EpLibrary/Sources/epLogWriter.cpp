@@ -25,11 +25,63 @@ THE SOFTWARE.
 */
 #include "epLogWriter.h"
 #include "epFolderHelper.h"
+#include "epThread.h"
+#include "epClock.h"
 using namespace epl;
+
+namespace epl
+{
+	/*!
+	@class LogFlushThread epLogWriter.cpp
+	@brief A background thread writing the buffered logs of LogWriter.
+	*/
+	class LogFlushThread:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] writer the log writer to flush.
+		*/
+		LogFlushThread(LogWriter &writer):Thread(),m_writer(writer)
+		{
+			m_isStopping=false;
+		}
+
+		/*!
+		Stop the thread, and wait until it ends.
+		*/
+		void Stop()
+		{
+			m_isStopping=true;
+			m_writer.m_flushEvent.SetEvent();
+			WaitFor();
+		}
+
+	protected:
+		/*!
+		Flush the logs on every flush interval, or when woken, until stopped.
+		*/
+		virtual void execute()
+		{
+			while(!m_isStopping)
+			{
+				WaitForSingleObject(m_writer.m_flushEvent.GetEventHandle(),m_writer.m_flushInterval);
+				m_writer.flushLogs();
+			}
+		}
+
+	private:
+		/// the log writer to flush
+		LogWriter &m_writer;
+		/// the flag whether the thread is stopping
+		volatile bool m_isStopping;
+	};
+}
+
 #if  defined(_UNICODE) || defined(UNICODE)
-LogWriter::LogWriter(LockPolicy lockPolicyType):BaseTextFile(FILE_ENCODING_TYPE_UTF16LE,lockPolicyType)
+LogWriter::LogWriter(LockPolicy lockPolicyType):BaseTextFile(FILE_ENCODING_TYPE_UTF16LE,lockPolicyType),m_flushEvent(false,false),m_commitEvent(false,true),m_timestampFormatter(TIMESTAMP_LAYOUT_LONG)
 #else // defined(_UNICODE) || defined(UNICODE)
-LogWriter::LogWriter(LockPolicy lockPolicyType):BaseTextFile(FILE_ENCODING_TYPE_UTF8,lockPolicyType)
+LogWriter::LogWriter(LockPolicy lockPolicyType):BaseTextFile(FILE_ENCODING_TYPE_UTF8,lockPolicyType),m_flushEvent(false,false),m_commitEvent(false,true),m_timestampFormatter(TIMESTAMP_LAYOUT_LONG)
 #endif//  defined(_UNICODE) || defined(UNICODE)
 {
 	m_fileName=FolderHelper::GetModuleFileName().c_str();
@@ -46,19 +98,36 @@ LogWriter::LogWriter(LockPolicy lockPolicyType):BaseTextFile(FILE_ENCODING_TYPE_
 	case LOCK_POLICY_NONE:
 		m_logLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_logLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_logLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_logLock=NULL;
 		break;
 	}
+	initWriter();
 }
 
 LogWriter::~LogWriter()
 {
+	if(m_flushThread)
+	{
+		m_flushThread->Stop();
+		EP_DELETE m_flushThread;
+		m_flushThread=NULL;
+	}
+	flushLogs();
+	if(m_logFile)
+		System::FClose(m_logFile);
+	m_logFile=NULL;
 	if(m_logLock)
 		EP_DELETE m_logLock;
 }
 
-LogWriter::LogWriter(const LogWriter& b):BaseTextFile(b)
+LogWriter::LogWriter(const LogWriter& b):BaseTextFile(b),m_flushEvent(false,false),m_commitEvent(false,true),m_timestampFormatter(TIMESTAMP_LAYOUT_LONG)
 {
 	m_fileName=b.m_fileName;
 	m_lockPolicy=b.m_lockPolicy;
@@ -73,21 +142,230 @@ LogWriter::LogWriter(const LogWriter& b):BaseTextFile(b)
 	case LOCK_POLICY_NONE:
 		m_logLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_logLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_logLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_logLock=NULL;
 		break;
 	}
+	// the log file and the thread belong to the original, so the copy opens its own
+	initWriter();
+	m_flushInterval=b.m_flushInterval;
+	m_flushSize=b.m_flushSize;
+	m_isGroupCommit=b.m_isGroupCommit;
+	m_maxFileSize=b.m_maxFileSize;
+	m_maxFileAge=b.m_maxFileAge;
+	m_maxBackupCount=b.m_maxBackupCount;
+}
+
+void LogWriter::initWriter()
+{
+	m_logFile=NULL;
+	m_logFileSize=0;
+	m_logFileOpenTime=0;
+	m_flushThread=NULL;
+	m_logCount=0;
+	m_writtenCount=0;
+	m_flushInterval=LOG_WRITER_DEFAULT_FLUSH_INTERVAL;
+	m_flushSize=LOG_WRITER_DEFAULT_FLUSH_SIZE;
+	m_isGroupCommit=false;
+	m_maxFileSize=0;
+	m_maxFileAge=0;
+	m_maxBackupCount=LOG_WRITER_DEFAULT_MAX_BACKUP_COUNT;
 }
 
 void LogWriter::WriteLog(const  TCHAR* pMsg)
 {
 	// write error or other information into log file
-	LockObj lock(m_logLock);
-	SYSTEMTIME oT;
-	::GetLocalTime(&oT);
-	m_logString=_T("");
-	m_logString.AppendFormat(_T("%02d/%02d/%04d, %02d:%02d:%02d\n    %s\n"),oT.wMonth,oT.wDay,oT.wYear,oT.wHour,oT.wMinute,oT.wSecond,pMsg);
-	AppendToFile(m_fileName);
+	// the time is printed in seconds, so the cached time is accurate enough
+	SYSTEMTIME oT=COARSE_CLOCK_INSTANCE.GetLocalTime();
+
+	long logCount;
+	bool isFlushNeeded;
+	bool isGroupCommit=m_isGroupCommit;
+	{
+		LockObj lock(m_logLock);
+		if(!m_flushThread)
+		{
+			m_flushThread=EP_NEW LogFlushThread(*this);
+			m_flushThread->Start();
+		}
+		// the timestamp is rewritten only when the second changes
+		m_logString.Append(m_timestampFormatter.Format(oT),static_cast<int>(m_timestampFormatter.GetLength()));
+		m_logString.Append(_T("\n    "));
+		m_logString.Append(pMsg);
+		m_logString.Append(_T("\n"));
+		m_logCount++;
+		logCount=m_logCount;
+		isFlushNeeded=isGroupCommit || static_cast<unsigned int>(m_logString.GetLength())>=m_flushSize;
+	}
+	if(isFlushNeeded)
+		m_flushEvent.SetEvent();
+	if(isGroupCommit)
+	{
+		// the commit event is reset when the next logs are taken, so wait until the commit includes this log
+		while(m_writtenCount-logCount<0)
+			WaitForSingleObject(m_commitEvent.GetEventHandle(),m_flushInterval);
+	}
+}
+
+void LogWriter::Flush()
+{
+	flushLogs();
+}
+
+void LogWriter::SetFlushInterval(unsigned int flushInterval)
+{
+	m_flushInterval=flushInterval;
+}
+
+unsigned int LogWriter::GetFlushInterval() const
+{
+	return m_flushInterval;
+}
+
+void LogWriter::SetFlushSize(unsigned int flushSize)
+{
+	m_flushSize=flushSize;
+}
+
+unsigned int LogWriter::GetFlushSize() const
+{
+	return m_flushSize;
+}
+
+void LogWriter::SetGroupCommit(bool isGroupCommit)
+{
+	m_isGroupCommit=isGroupCommit;
+}
+
+bool LogWriter::IsGroupCommit() const
+{
+	return m_isGroupCommit;
+}
+
+void LogWriter::SetMaxFileSize(unsigned int maxFileSize)
+{
+	LockObj lock(m_baseTextLock);
+	m_maxFileSize=maxFileSize;
+}
+
+unsigned int LogWriter::GetMaxFileSize() const
+{
+	return m_maxFileSize;
+}
+
+void LogWriter::SetMaxFileAge(unsigned int maxFileAge)
+{
+	LockObj lock(m_baseTextLock);
+	m_maxFileAge=maxFileAge;
+}
+
+unsigned int LogWriter::GetMaxFileAge() const
+{
+	return m_maxFileAge;
+}
+
+void LogWriter::SetMaxBackupCount(unsigned int maxBackupCount)
+{
+	LockObj lock(m_baseTextLock);
+	m_maxBackupCount=maxBackupCount;
+}
+
+unsigned int LogWriter::GetMaxBackupCount() const
+{
+	return m_maxBackupCount;
+}
+
+void LogWriter::flushLogs()
+{
+	// the file lock is held from taking the logs to writing them, so the flushes never reorder the logs
+	LockObj fileLock(m_baseTextLock);
+	long logCount;
+	{
+		LockObj lock(m_logLock);
+		if(!m_logString.GetLength())
+			return;
+		m_writeString=m_logString;
+		m_logString.Empty();
+		logCount=m_logCount;
+		m_commitEvent.ResetEvent();
+	}
+
+	if(m_logFile)
+	{
+		bool isTooLarge=m_maxFileSize && m_logFileSize>=static_cast<__int64>(m_maxFileSize);
+		bool isTooOld=m_maxFileAge && System::GetTickCount()-m_logFileOpenTime>=m_maxFileAge*1000;
+		if(isTooLarge || isTooOld)
+			rotateLogFile();
+	}
+	if(openLogFile())
+	{
+		// writeToFile writes to m_file with the encoding conversion
+		EpFile *prevFile=m_file;
+		m_file=m_logFile;
+		writeToFile(m_writeString.GetString());
+		m_file=prevFile;
+		m_logFileSize+=static_cast<__int64>(m_writeString.GetLength())*sizeof(TCHAR);
+		if(m_isGroupCommit)
+			System::FCommit(m_logFile);
+		else
+			System::FFlush(m_logFile);
+	}
+	m_writeString.Empty();
+
+	// the waiting logs are released even when the log file cannot be opened
+	InterlockedExchange(&m_writtenCount,logCount);
+	m_commitEvent.SetEvent();
+}
+
+bool LogWriter::openLogFile()
+{
+	if(m_logFile)
+		return true;
+	int e;
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+		e= System::FTOpen(m_logFile,m_fileName,_T("at,ccs=UTF-8"));
+	else if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
+		e= System::FTOpen(m_logFile,m_fileName,_T("at,ccs=UTF-16LE"));
+	else if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
+		e= System::FTOpen(m_logFile,m_fileName,_T("at"));
+	else
+		return false;
+
+	if(e!=0 || !m_logFile)
+	{
+		m_logFile=NULL;
+		return false;
+	}
+	m_logFileSize=System::FSize(m_logFile);
+	m_logFileOpenTime=System::GetTickCount();
+	return true;
+}
+
+void LogWriter::rotateLogFile()
+{
+	System::FClose(m_logFile);
+	m_logFile=NULL;
+	if(!m_maxBackupCount)
+	{
+		DeleteFile(m_fileName);
+		return;
+	}
+	CString fromFileName;
+	CString toFileName;
+	for(unsigned int backupTrav=m_maxBackupCount-1;backupTrav>0;backupTrav--)
+	{
+		fromFileName.Format(_T("%s.%u"),m_fileName.GetString(),backupTrav);
+		toFileName.Format(_T("%s.%u"),m_fileName.GetString(),backupTrav+1);
+		MoveFileEx(fromFileName,toFileName,MOVEFILE_REPLACE_EXISTING);
+	}
+	toFileName.Format(_T("%s.1"),m_fileName.GetString());
+	MoveFileEx(m_fileName,toFileName,MOVEFILE_REPLACE_EXISTING);
 }
 
 void LogWriter::writeLoop()
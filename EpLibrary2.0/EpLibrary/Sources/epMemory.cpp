@@ -0,0 +1,65 @@
+/*! 
+Memory for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epMemory.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+BaseAllocator * volatile Memory::m_allocator=NULL;
+
+BaseAllocator *Memory::SetAllocator(BaseAllocator *allocator)
+{
+	return reinterpret_cast<BaseAllocator*>(InterlockedExchangePointer(reinterpret_cast<void* volatile*>(&m_allocator),allocator));
+}
+
+BaseAllocator *Memory::GetAllocator()
+{
+	return m_allocator;
+}
+
+const TCHAR *Memory::GetTagName(MemoryTag tag)
+{
+	switch(tag)
+	{
+	case MEMORY_TAG_GENERAL:
+		return _T("General");
+	case MEMORY_TAG_JOB:
+		return _T("Job");
+	case MEMORY_TAG_IPC:
+		return _T("IPC");
+	case MEMORY_TAG_STREAM:
+		return _T("Stream");
+	case MEMORY_TAG_XML:
+		return _T("XML");
+	default:
+		return _T("Unknown");
+	}
+}
\ No newline at end of file
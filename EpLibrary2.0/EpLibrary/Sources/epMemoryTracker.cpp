@@ -0,0 +1,381 @@
+/*! 
+MemoryTracker for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epMemoryTracker.h"
+#include "epFolderHelper.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the size reserved for the header in front of each memory tracked, which keeps the memory aligned
+#define MEMORY_TRACKER_HEADER_SIZE 16
+/// the magic number for the check value of the header
+#define MEMORY_TRACKER_MAGIC 0x4D454D54
+
+MemoryTagStat::MemoryTagStat()
+{
+	liveBytes=0;
+	peakBytes=0;
+	allocCount=0;
+	allocBytes=0;
+	freeCount=0;
+}
+
+MemoryTracker::MemoryTagNode::MemoryTagNode(const MemoryTracker *tracker, MemoryTag tag):OutputNode()
+{
+	m_tracker=tracker;
+	m_tag=tag;
+}
+
+MemoryTracker::MemoryTagNode::~MemoryTagNode()
+{
+}
+
+void MemoryTracker::MemoryTagNode::format(EpTString &retString) const
+{
+	MemoryTagStat stat;
+	m_tracker->GetTagStat(m_tag,stat);
+	unsigned long elapsedTime=GetTickCount()-m_tracker->m_startTick;
+	__int64 allocRate=0;
+	if(elapsedTime)
+		allocRate=stat.allocCount*1000/elapsedTime;
+	System::STPrintf(retString,_T("%s Live : %I64d bytes Peak : %I64d bytes Alloc : %I64d (%I64d/s) Allocated : %I64d bytes Free : %I64d\n"),Memory::GetTagName(m_tag),stat.liveBytes,stat.peakBytes,stat.allocCount,allocRate,stat.allocBytes,stat.freeCount);
+}
+
+void MemoryTracker::MemoryTagNode::Print() const
+{
+	EpTString output;
+	format(output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void MemoryTracker::MemoryTagNode::Write(EpFile* const file)
+{
+	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
+	EpTString output;
+	format(output);
+	System::FTPrintf(file,_T("%s"),output.c_str());
+}
+
+MemoryTracker::MemoryCallSiteNode::MemoryCallSiteNode(const MemoryTracker *tracker):OutputNode()
+{
+	m_tracker=tracker;
+}
+
+MemoryTracker::MemoryCallSiteNode::~MemoryCallSiteNode()
+{
+}
+
+void MemoryTracker::MemoryCallSiteNode::format(EpTString &retString) const
+{
+	CallSite topSites[MEMORY_TRACKER_REPORT_CALL_SITE_COUNT];
+	unsigned int topCount=0;
+	{
+		LockObj lock(m_tracker->m_statLock);
+		for(unsigned int siteTrav=0;siteTrav<MEMORY_TRACKER_MAX_CALL_SITE_COUNT;siteTrav++)
+		{
+			const CallSite &site=m_tracker->m_callSites[siteTrav];
+			if(!site.hash)
+				continue;
+			// keep the top sites sorted by the bytes sampled
+			unsigned int insertIdx=topCount;
+			while(insertIdx>0 && topSites[insertIdx-1].sampleBytes<site.sampleBytes)
+				insertIdx--;
+			if(insertIdx>=MEMORY_TRACKER_REPORT_CALL_SITE_COUNT)
+				continue;
+			unsigned int moveTrav=topCount<MEMORY_TRACKER_REPORT_CALL_SITE_COUNT?topCount:MEMORY_TRACKER_REPORT_CALL_SITE_COUNT-1;
+			for(;moveTrav>insertIdx;moveTrav--)
+				topSites[moveTrav]=topSites[moveTrav-1];
+			topSites[insertIdx]=site;
+			if(topCount<MEMORY_TRACKER_REPORT_CALL_SITE_COUNT)
+				topCount++;
+		}
+	}
+
+	retString=_T("");
+	for(unsigned int topTrav=0;topTrav<topCount;topTrav++)
+	{
+		EpTString line;
+		System::STPrintf(line,_T("Call Site #%u Sample : %I64d Bytes : %I64d Frames :"),topTrav+1,topSites[topTrav].sampleCount,topSites[topTrav].sampleBytes);
+		retString.append(line);
+		for(unsigned int frameTrav=0;frameTrav<MEMORY_TRACKER_CALL_STACK_DEPTH && topSites[topTrav].frames[frameTrav];frameTrav++)
+		{
+			System::STPrintf(line,_T(" %p"),topSites[topTrav].frames[frameTrav]);
+			retString.append(line);
+		}
+		retString.append(_T("\n"));
+	}
+}
+
+void MemoryTracker::MemoryCallSiteNode::Print() const
+{
+	EpTString output;
+	format(output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void MemoryTracker::MemoryCallSiteNode::Write(EpFile* const file)
+{
+	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
+	EpTString output;
+	format(output);
+	System::FTPrintf(file,_T("%s"),output.c_str());
+}
+
+MemoryTracker::MemoryTracker(LockPolicy lockPolicyType):BaseOutputter(lockPolicyType),BaseAllocator()
+{
+	m_fileName=FolderHelper::GetModuleFileDirectory();
+	m_fileName.append(_T("memoryreport.dat"));
+	m_allocator=NULL;
+	m_isInstalled=0;
+	m_sampleRate=0;
+	m_sampleCounter=0;
+	m_startTick=GetTickCount();
+	m_captureStack=NULL;
+	HMODULE kernel=GetModuleHandle(_T("kernel32.dll"));
+	if(kernel)
+		m_captureStack=(CaptureStackFunc)GetProcAddress(kernel,"RtlCaptureStackBackTrace");
+	m_callSites=reinterpret_cast<CallSite*>(EP_Malloc(sizeof(CallSite)*MEMORY_TRACKER_MAX_CALL_SITE_COUNT));
+	EP_ASSERT_EXPR(m_callSites,_T("Allocation Failed"));
+	System::Memset(m_callSites,0,sizeof(CallSite)*MEMORY_TRACKER_MAX_CALL_SITE_COUNT);
+
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_statLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_statLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_statLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_statLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_statLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_statLock=NULL;
+		break;
+	}
+
+	LockObj lock(m_nodeListLock);
+	for(int tagTrav=0;tagTrav<MEMORY_TAG_COUNT;tagTrav++)
+		m_list.push_back(EP_NEW MemoryTagNode(this,static_cast<MemoryTag>(tagTrav)));
+	m_list.push_back(EP_NEW MemoryCallSiteNode(this));
+}
+
+MemoryTracker::~MemoryTracker()
+{
+	EP_Free(m_callSites);
+	if(m_statLock)
+		EP_DELETE m_statLock;
+}
+
+void MemoryTracker::Install(unsigned int sampleRate)
+{
+	if(InterlockedCompareExchange(&m_isInstalled,1,0)!=0)
+		return;
+	m_sampleRate=sampleRate;
+	m_allocator=Memory::GetAllocator();
+	Memory::SetAllocator(this);
+}
+
+bool MemoryTracker::IsInstalled() const
+{
+	return m_isInstalled!=0;
+}
+
+void MemoryTracker::GetTagStat(MemoryTag tag, MemoryTagStat &retStat) const
+{
+	EP_ASSERT_EXPR(tag>=0 && tag<MEMORY_TAG_COUNT,_T("Invalid Memory Tag"));
+	LockObj lock(m_statLock);
+	retStat=m_tagStats[tag];
+}
+
+void MemoryTracker::Clear()
+{
+	LockObj lock(m_statLock);
+	for(int tagTrav=0;tagTrav<MEMORY_TAG_COUNT;tagTrav++)
+	{
+		m_tagStats[tagTrav].peakBytes=m_tagStats[tagTrav].liveBytes;
+		m_tagStats[tagTrav].allocCount=0;
+		m_tagStats[tagTrav].allocBytes=0;
+		m_tagStats[tagTrav].freeCount=0;
+	}
+	System::Memset(m_callSites,0,sizeof(CallSite)*MEMORY_TRACKER_MAX_CALL_SITE_COUNT);
+	m_startTick=GetTickCount();
+}
+
+void *MemoryTracker::Malloc(size_t size, MemoryTag tag)
+{
+	void *block;
+	if(m_allocator)
+		block=m_allocator->Malloc(MEMORY_TRACKER_HEADER_SIZE+size,tag);
+	else
+		block=malloc(MEMORY_TRACKER_HEADER_SIZE+size);
+	if(!block)
+		return NULL;
+	recordAlloc(size,tag);
+	return initBlock(block,size,tag);
+}
+
+void *MemoryTracker::Realloc(void *ptr, size_t size, MemoryTag tag)
+{
+	if(!ptr)
+		return Malloc(size,tag);
+	BlockHeader *header=headerOf(ptr);
+	if(!header)
+	{
+		// allocated before install
+		if(m_allocator)
+			return m_allocator->Realloc(ptr,size,tag);
+		return realloc(ptr,size);
+	}
+	size_t oldSize=header->size;
+	MemoryTag oldTag=static_cast<MemoryTag>(header->tag);
+	header->check=0;
+	void *block;
+	if(m_allocator)
+		block=m_allocator->Realloc(header,MEMORY_TRACKER_HEADER_SIZE+size,tag);
+	else
+		block=realloc(header,MEMORY_TRACKER_HEADER_SIZE+size);
+	if(!block)
+	{
+		initBlock(header,oldSize,oldTag);
+		return NULL;
+	}
+	recordFree(oldSize,oldTag);
+	recordAlloc(size,tag);
+	return initBlock(block,size,tag);
+}
+
+void MemoryTracker::Free(void *ptr, MemoryTag tag)
+{
+	if(!ptr)
+		return;
+	BlockHeader *header=headerOf(ptr);
+	if(!header)
+	{
+		// allocated before install
+		if(m_allocator)
+			m_allocator->Free(ptr,tag);
+		else
+			free(ptr);
+		return;
+	}
+	recordFree(header->size,static_cast<MemoryTag>(header->tag));
+	header->check=0;
+	if(m_allocator)
+		m_allocator->Free(header,tag);
+	else
+		free(header);
+}
+
+void MemoryTracker::recordAlloc(size_t size, MemoryTag tag)
+{
+	if(tag<0 || tag>=MEMORY_TAG_COUNT)
+		tag=MEMORY_TAG_GENERAL;
+	{
+		LockObj lock(m_statLock);
+		MemoryTagStat &stat=m_tagStats[tag];
+		stat.liveBytes+=size;
+		if(stat.liveBytes>stat.peakBytes)
+			stat.peakBytes=stat.liveBytes;
+		stat.allocCount++;
+		stat.allocBytes+=size;
+	}
+
+	if(m_sampleRate && m_captureStack && static_cast<unsigned long>(InterlockedIncrement(&m_sampleCounter))%m_sampleRate==0)
+		sampleCallSite(size);
+}
+
+void MemoryTracker::recordFree(size_t size, MemoryTag tag)
+{
+	if(tag<0 || tag>=MEMORY_TAG_COUNT)
+		tag=MEMORY_TAG_GENERAL;
+	LockObj lock(m_statLock);
+	MemoryTagStat &stat=m_tagStats[tag];
+	stat.liveBytes-=size;
+	stat.freeCount++;
+}
+
+void MemoryTracker::sampleCallSite(size_t size)
+{
+	void *frames[MEMORY_TRACKER_CALL_STACK_DEPTH];
+	System::Memset(frames,0,sizeof(frames));
+	unsigned long hash=0;
+	// skip this function, recordAlloc and Malloc/Realloc
+	unsigned short frameCount=m_captureStack(3,MEMORY_TRACKER_CALL_STACK_DEPTH,frames,&hash);
+	if(frameCount==0)
+		return;
+	if(hash==0)
+		hash=1;
+
+	LockObj lock(m_statLock);
+	for(unsigned int probeTrav=0;probeTrav<MEMORY_TRACKER_MAX_CALL_SITE_COUNT;probeTrav++)
+	{
+		CallSite &site=m_callSites[(hash+probeTrav)%MEMORY_TRACKER_MAX_CALL_SITE_COUNT];
+		if(site.hash==0)
+		{
+			site.hash=hash;
+			System::Memcpy(site.frames,sizeof(site.frames),frames,sizeof(frames));
+			site.sampleCount=1;
+			site.sampleBytes=size;
+			return;
+		}
+		if(site.hash==hash && memcmp(site.frames,frames,sizeof(frames))==0)
+		{
+			site.sampleCount++;
+			site.sampleBytes+=size;
+			return;
+		}
+	}
+	// the table is full, so the sample is dropped
+}
+
+void *MemoryTracker::initBlock(void *block, size_t size, MemoryTag tag)
+{
+	BlockHeader *header=reinterpret_cast<BlockHeader*>(block);
+	header->size=size;
+	header->tag=static_cast<unsigned int>(tag);
+	header->check=static_cast<unsigned int>(reinterpret_cast<size_t>(header)>>4)^static_cast<unsigned int>(size)^MEMORY_TRACKER_MAGIC;
+	return reinterpret_cast<unsigned char*>(block)+MEMORY_TRACKER_HEADER_SIZE;
+}
+
+MemoryTracker::BlockHeader *MemoryTracker::headerOf(void *ptr)
+{
+	BlockHeader *header=reinterpret_cast<BlockHeader*>(reinterpret_cast<unsigned char*>(ptr)-MEMORY_TRACKER_HEADER_SIZE);
+	if(header->check!=(static_cast<unsigned int>(reinterpret_cast<size_t>(header)>>4)^static_cast<unsigned int>(header->size)^MEMORY_TRACKER_MAGIC))
+		return NULL;
+	return header;
+}
\ No newline at end of file
@@ -0,0 +1,471 @@
+/*! 
+MetricsRegistry for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epMetrics.h"
+#include "epFolderHelper.h"
+#include "epStream.h"
+#include "epIpcClientInterfaces.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/*!
+Write the 64-bit integer to the stream as two 32-bit integers.
+@param[in] stream the stream to write.
+@param[in] value the value to write.
+@return true if successful, otherwise false.
+*/
+static bool writeMetricInt64(Stream &stream, __int64 value)
+{
+	return stream.WriteUInt(static_cast<unsigned int>(value&0xffffffff)) && stream.WriteUInt(static_cast<unsigned int>(static_cast<unsigned __int64>(value)>>32));
+}
+
+/*!
+Read the 64-bit integer written by writeMetricInt64 from the stream.
+@param[in] stream the stream to read.
+@param[out] retVal the value read.
+@return true if successful, otherwise false.
+*/
+static bool readMetricInt64(Stream &stream, __int64 &retVal)
+{
+	unsigned int lowValue;
+	unsigned int highValue;
+	if(!stream.ReadUInt(lowValue) || !stream.ReadUInt(highValue))
+		return false;
+	retVal=static_cast<__int64>((static_cast<unsigned __int64>(highValue)<<32)|lowValue);
+	return true;
+}
+
+
+MetricCounter::MetricCounter(const TCHAR *name)
+{
+	m_name=name;
+	for(unsigned int shardTrav=0;shardTrav<METRICS_SHARD_COUNT;shardTrav++)
+		m_shards[shardTrav].m_value=0;
+}
+
+__int64 MetricCounter::GetValue() const
+{
+	__int64 value=0;
+	for(unsigned int shardTrav=0;shardTrav<METRICS_SHARD_COUNT;shardTrav++)
+		value+=m_shards[shardTrav].m_value;
+	return value;
+}
+
+const TCHAR *MetricCounter::GetName() const
+{
+	return m_name.c_str();
+}
+
+
+MetricGauge::MetricGauge(const TCHAR *name)
+{
+	m_name=name;
+	m_value=0;
+}
+
+__int64 MetricGauge::GetValue() const
+{
+	return m_value;
+}
+
+const TCHAR *MetricGauge::GetName() const
+{
+	return m_name.c_str();
+}
+
+
+MetricHistogram::MetricHistogram(const TCHAR *name)
+{
+	m_name=name;
+}
+
+void MetricHistogram::GetHistogram(LatencyHistogram &retHistogram) const
+{
+	retHistogram.Clear();
+	for(unsigned int shardTrav=0;shardTrav<METRICS_HISTOGRAM_SHARD_COUNT;shardTrav++)
+		retHistogram.Add(m_shards[shardTrav].m_histogram);
+}
+
+const TCHAR *MetricHistogram::GetName() const
+{
+	return m_name.c_str();
+}
+
+
+MetricSample::MetricSample()
+{
+	type=METRIC_TYPE_COUNTER;
+	value=0;
+	delta=0;
+	maxValue=0;
+	p50=0;
+	p90=0;
+	p99=0;
+	p999=0;
+}
+
+
+MetricsSnapshot::MetricsSnapshot()
+{
+	tickCount=0;
+	interval=0;
+}
+
+bool MetricsSnapshot::Serialize(Stream &stream) const
+{
+	if(!stream.WriteUInt(METRICS_SNAPSHOT_MAGIC) || !stream.WriteUInt(METRICS_SNAPSHOT_VERSION)
+		|| !stream.WriteUInt(tickCount) || !stream.WriteUInt(interval) || !stream.WriteUInt(static_cast<unsigned int>(samples.size())))
+		return false;
+	std::vector<MetricSample>::const_iterator iter;
+	for(iter=samples.begin();iter!=samples.end();iter++)
+	{
+		if(!stream.WritePrefixedTString(iter->name) || !stream.WriteUInt(static_cast<unsigned int>(iter->type))
+			|| !writeMetricInt64(stream,iter->value) || !writeMetricInt64(stream,iter->delta))
+			return false;
+		if(iter->type!=METRIC_TYPE_HISTOGRAM)
+			continue;
+		if(!writeMetricInt64(stream,iter->maxValue) || !writeMetricInt64(stream,iter->p50) || !writeMetricInt64(stream,iter->p90)
+			|| !writeMetricInt64(stream,iter->p99) || !writeMetricInt64(stream,iter->p999))
+			return false;
+	}
+	return true;
+}
+
+bool MetricsSnapshot::Deserialize(Stream &stream)
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int sampleCount;
+	samples.clear();
+	if(!stream.ReadUInt(magic) || !stream.ReadUInt(version) || magic!=METRICS_SNAPSHOT_MAGIC || version!=METRICS_SNAPSHOT_VERSION
+		|| !stream.ReadUInt(tickCount) || !stream.ReadUInt(interval) || !stream.ReadUInt(sampleCount))
+		return false;
+	for(unsigned int sampleTrav=0;sampleTrav<sampleCount;sampleTrav++)
+	{
+		MetricSample sample;
+		unsigned int type;
+		if(!stream.ReadPrefixedTString(sample.name) || !stream.ReadUInt(type) || type>METRIC_TYPE_HISTOGRAM
+			|| !readMetricInt64(stream,sample.value) || !readMetricInt64(stream,sample.delta))
+			return false;
+		sample.type=static_cast<MetricType>(type);
+		if(sample.type==METRIC_TYPE_HISTOGRAM)
+		{
+			if(!readMetricInt64(stream,sample.maxValue) || !readMetricInt64(stream,sample.p50) || !readMetricInt64(stream,sample.p90)
+				|| !readMetricInt64(stream,sample.p99) || !readMetricInt64(stream,sample.p999))
+				return false;
+		}
+		samples.push_back(sample);
+	}
+	return true;
+}
+
+
+MetricsIpcExporter::MetricsIpcExporter(IpcClientInterface *client)
+{
+	EP_ASSERT(client);
+	m_client=client;
+}
+
+MetricsIpcExporter::~MetricsIpcExporter()
+{
+}
+
+void MetricsIpcExporter::OnMetricsSnapshot(const MetricsSnapshot &snapshot)
+{
+	if(!m_client->IsConnected())
+		return;
+	Stream stream(LOCK_POLICY_NONE);
+	if(!snapshot.Serialize(stream) || stream.GetStreamSize()>m_client->GetMaxWriteDataByteSize())
+		return;
+	m_client->Write(reinterpret_cast<char*>(const_cast<unsigned char*>(stream.GetBuffer())),static_cast<unsigned int>(stream.GetStreamSize()));
+}
+
+
+MetricsRegistry::MetricNode::MetricNode(const TCHAR *name, MetricType type):OutputNode()
+{
+	m_type=type;
+	m_counter=NULL;
+	m_gauge=NULL;
+	m_histogram=NULL;
+	m_lastHistogram=NULL;
+	m_lastValue=0;
+	switch(type)
+	{
+	case METRIC_TYPE_COUNTER:
+		m_counter=EP_NEW MetricCounter(name);
+		break;
+	case METRIC_TYPE_GAUGE:
+		m_gauge=EP_NEW MetricGauge(name);
+		break;
+	case METRIC_TYPE_HISTOGRAM:
+		m_histogram=EP_NEW MetricHistogram(name);
+		m_lastHistogram=EP_NEW LatencyHistogram();
+		break;
+	}
+}
+
+MetricsRegistry::MetricNode::~MetricNode()
+{
+	if(m_counter)
+		EP_DELETE m_counter;
+	if(m_gauge)
+		EP_DELETE m_gauge;
+	if(m_histogram)
+		EP_DELETE m_histogram;
+	if(m_lastHistogram)
+		EP_DELETE m_lastHistogram;
+}
+
+void MetricsRegistry::MetricNode::sample(MetricSample &retSample, bool isAdvancing)
+{
+	retSample.type=m_type;
+	switch(m_type)
+	{
+	case METRIC_TYPE_COUNTER:
+		retSample.name=m_counter->GetName();
+		retSample.value=m_counter->GetValue();
+		break;
+	case METRIC_TYPE_GAUGE:
+		retSample.name=m_gauge->GetName();
+		retSample.value=m_gauge->GetValue();
+		break;
+	case METRIC_TYPE_HISTOGRAM:
+		{
+			retSample.name=m_histogram->GetName();
+			LatencyHistogram histogram;
+			m_histogram->GetHistogram(histogram);
+			retSample.value=histogram.GetTotalCount();
+			retSample.maxValue=histogram.GetMaxValue();
+			// the percentiles are of the values recorded since the last snapshot
+			LatencyHistogram intervalHistogram=histogram;
+			intervalHistogram.Subtract(*m_lastHistogram);
+			if(isAdvancing)
+				*m_lastHistogram=histogram;
+			retSample.p50=intervalHistogram.GetValueAtPercentile(50.0);
+			retSample.p90=intervalHistogram.GetValueAtPercentile(90.0);
+			retSample.p99=intervalHistogram.GetValueAtPercentile(99.0);
+			retSample.p999=intervalHistogram.GetValueAtPercentile(99.9);
+		}
+		break;
+	}
+	retSample.delta=retSample.value-m_lastValue;
+	if(isAdvancing)
+		m_lastValue=retSample.value;
+}
+
+void MetricsRegistry::MetricNode::Print() const
+{
+	MetricSample nodeSample;
+	const_cast<MetricNode*>(this)->sample(nodeSample,false);
+	EpTString output;
+	MetricsRegistry::formatSample(nodeSample,output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void MetricsRegistry::MetricNode::Write(EpFile* const file)
+{
+	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
+	MetricSample nodeSample;
+	sample(nodeSample,false);
+	EpTString output;
+	MetricsRegistry::formatSample(nodeSample,output);
+	System::FTPrintf(file,_T("%s"),output.c_str());
+}
+
+
+MetricsRegistry::MetricsRegistry(LockPolicy lockPolicyType):BaseOutputter(lockPolicyType)
+{
+	m_fileName=FolderHelper::GetModuleFileDirectory();
+	m_fileName.append(_T("metrics.dat"));
+	m_lastSnapshotTick=System::GetTickCount();
+}
+
+MetricsRegistry::~MetricsRegistry()
+{
+	// the flush thread must be stopped before the nodes it reads are deleted
+	StopFlushThread();
+	LockObj lock(m_nodeListLock);
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		EP_DELETE (*iter);
+	}
+	m_list.clear();
+	m_nodeMap.clear();
+}
+
+MetricsRegistry::MetricNode *MetricsRegistry::getNode(const TCHAR *name, MetricType type)
+{
+	EP_ASSERT(name);
+	LockObj lock(m_nodeListLock);
+	std::map<EpTString,MetricNode*>::iterator iter=m_nodeMap.find(name);
+	if(iter!=m_nodeMap.end())
+	{
+		EP_ASSERT_EXPR(iter->second->m_type==type,_T("The metric(%s) is already registered with the other type!"),name);
+		if(iter->second->m_type!=type)
+			return NULL;
+		return iter->second;
+	}
+	MetricNode *node=EP_NEW MetricNode(name,type);
+	m_nodeMap[name]=node;
+	m_list.push_back(node);
+	return node;
+}
+
+MetricCounter *MetricsRegistry::GetCounter(const TCHAR *name)
+{
+	MetricNode *node=getNode(name,METRIC_TYPE_COUNTER);
+	if(!node)
+		return NULL;
+	return node->m_counter;
+}
+
+MetricGauge *MetricsRegistry::GetGauge(const TCHAR *name)
+{
+	MetricNode *node=getNode(name,METRIC_TYPE_GAUGE);
+	if(!node)
+		return NULL;
+	return node->m_gauge;
+}
+
+MetricHistogram *MetricsRegistry::GetHistogram(const TCHAR *name)
+{
+	MetricNode *node=getNode(name,METRIC_TYPE_HISTOGRAM);
+	if(!node)
+		return NULL;
+	return node->m_histogram;
+}
+
+void MetricsRegistry::TakeSnapshot(MetricsSnapshot &retSnapshot)
+{
+	LockObj lock(m_nodeListLock);
+	retSnapshot.tickCount=System::GetTickCount();
+	retSnapshot.interval=retSnapshot.tickCount-m_lastSnapshotTick;
+	m_lastSnapshotTick=retSnapshot.tickCount;
+	retSnapshot.samples.clear();
+	retSnapshot.samples.resize(m_list.size());
+	for(size_t nodeTrav=0;nodeTrav<m_list.size();nodeTrav++)
+	{
+		static_cast<MetricNode*>(m_list[nodeTrav])->sample(retSnapshot.samples[nodeTrav],true);
+	}
+}
+
+void MetricsRegistry::AddExporter(MetricsExporterInterface *exporter)
+{
+	EP_ASSERT(exporter);
+	LockObj lock(m_flushLock);
+	std::vector<MetricsExporterInterface*>::iterator iter;
+	for(iter=m_exporterList.begin();iter!=m_exporterList.end();iter++)
+	{
+		if(*iter==exporter)
+			return;
+	}
+	m_exporterList.push_back(exporter);
+}
+
+void MetricsRegistry::RemoveExporter(MetricsExporterInterface *exporter)
+{
+	// the flush lock is held while the exporters are called, so the exporter is not called after this returns
+	LockObj lock(m_flushLock);
+	std::vector<MetricsExporterInterface*>::iterator iter;
+	for(iter=m_exporterList.begin();iter!=m_exporterList.end();iter++)
+	{
+		if(*iter==exporter)
+		{
+			m_exporterList.erase(iter);
+			return;
+		}
+	}
+}
+
+void MetricsRegistry::FlushToFile()
+{
+	LockObj flushLock(m_flushLock);
+	MetricsSnapshot snapshot;
+	TakeSnapshot(snapshot);
+
+	EpTString fileName;
+	{
+		LockObj lock(m_nodeListLock);
+		fileName=m_fileName;
+	}
+	EpFile *file=NULL;
+	System::FTOpen(file,fileName.c_str(),_T("at"));
+	EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),fileName.c_str());
+	if(file)
+	{
+		System::FTPrintf(file,_T("Metrics Snapshot Starts... (Interval : %d ms)\n"),snapshot.interval);
+		std::vector<MetricSample>::const_iterator iter;
+		for(iter=snapshot.samples.begin();iter!=snapshot.samples.end();iter++)
+		{
+			EpTString output;
+			formatSample(*iter,output);
+			System::FTPrintf(file,_T("%s"),output.c_str());
+		}
+		System::FTPrintf(file,_T("Metrics Snapshot Ends...\n"));
+		System::FClose(file);
+	}
+
+	std::vector<MetricsExporterInterface*>::iterator iter;
+	for(iter=m_exporterList.begin();iter!=m_exporterList.end();iter++)
+	{
+		(*iter)->OnMetricsSnapshot(snapshot);
+	}
+}
+
+void MetricsRegistry::Clear()
+{
+	LockObj lock(m_nodeListLock);
+	m_lastSnapshotTick=System::GetTickCount();
+	std::vector<OutputNode*>::iterator iter;
+	for(iter=m_list.begin();iter!=m_list.end();iter++)
+	{
+		MetricSample nodeSample;
+		static_cast<MetricNode*>(*iter)->sample(nodeSample,true);
+	}
+}
+
+void MetricsRegistry::formatSample(const MetricSample &sample, EpTString &retString)
+{
+	switch(sample.type)
+	{
+	case METRIC_TYPE_COUNTER:
+		System::STPrintf(retString,_T("%s Counter : %I64d (+%I64d)\n"),sample.name.c_str(),sample.value,sample.delta);
+		break;
+	case METRIC_TYPE_GAUGE:
+		System::STPrintf(retString,_T("%s Gauge : %I64d\n"),sample.name.c_str(),sample.value);
+		break;
+	case METRIC_TYPE_HISTOGRAM:
+		System::STPrintf(retString,_T("%s Histogram : %I64d (+%I64d) P50 : %I64d P90 : %I64d P99 : %I64d P99.9 : %I64d Max : %I64d\n"),
+			sample.name.c_str(),sample.value,sample.delta,sample.p50,sample.p90,sample.p99,sample.p999,sample.maxValue);
+		break;
+	}
+}
@@ -50,7 +50,7 @@ NetworkStream & NetworkStream::operator=(const NetworkStream&b)
 	if(this!=&b)
 	{
 		Stream::operator =(b);
-		LockObj lock(b.m_streamLock);
+		StreamLockObj lock(&b);
 		m_flushType=b.m_flushType;
 		m_readOffset=b.m_readOffset;
 		
@@ -73,11 +73,16 @@ NetworkStream::NetworkStreamFlushType NetworkStream::GetFlushType() const
 
 void NetworkStream::Flush()
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
+	flush();
+}
+
+void NetworkStream::flush()
+{
 	if(m_readOffset==0)
 		return;
 
-	m_stream.erase(m_stream.begin(),m_stream.begin()+m_readOffset-1);
+	m_stream.Erase(0,m_readOffset);
 	m_offset-=m_readOffset;
 	m_readOffset=0;
 }
@@ -95,7 +100,7 @@ size_t NetworkStream::GetWriteSeek() const
 
 void NetworkStream::SetReadSeek(const StreamSeekType seekType,size_t offset)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	switch(seekType)
 	{
 	case STREAM_SEEK_TYPE_SEEK_SET:
@@ -105,7 +110,7 @@ void NetworkStream::SetReadSeek(const StreamSeekType seekType,size_t offset)
 		m_readOffset+=offset;
 		break;
 	case STREAM_SEEK_TYPE_SEEK_END:
-		m_readOffset=m_stream.size();
+		m_readOffset=m_stream.GetSize();
 	}
 }
 
@@ -124,18 +129,23 @@ size_t NetworkStream::GetSeek() const
 	return 0;
 }
 
+size_t &NetworkStream::readOffset()
+{
+	return m_readOffset;
+}
+
 bool NetworkStream::read(void *value,size_t byteSize)
 {
 	bool retVal=false;
 
-	if(!m_stream.empty() && value && m_stream.size()>=m_readOffset+byteSize)
+	if(!m_stream.IsEmpty() && value && m_stream.GetSize()>=m_readOffset+byteSize)
 	{
-		System::Memcpy(value,&m_stream.at(m_readOffset) , byteSize);
+		System::Memcpy(value,m_stream.GetData()+m_readOffset , byteSize);
 		m_readOffset+=byteSize;
 		retVal=true;
 	}
-	m_streamLock->Unlock();	
+	// the caller already holds the lock.
 	if(m_flushType==NETWORK_STREAM_FLUSH_TYPE_AUTO)
-		Flush();
+		flush();
 	return retVal;
 }
\ No newline at end of file
@@ -49,21 +49,3 @@ NoLock & NoLock::operator=(const NoLock&b)
 {
 	return *this;
 }
-
-bool NoLock::Lock()
-{
-	return true;
-}
-
-long NoLock::TryLock()
-{
-	return 1;
-}
-long NoLock::TryLockFor(const unsigned int dwMilliSecond)
-{
-	return 1;	
-}
-void NoLock::Unlock()
-{
-}
-
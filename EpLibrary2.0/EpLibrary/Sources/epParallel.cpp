@@ -0,0 +1,166 @@
+/*! 
+ParallelContext for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epParallel.h"
+#include "epBaseJob.h"
+#include "epBaseJobProcessor.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+namespace epl
+{
+	/*! 
+	@class ParallelJob epParallel.cpp
+	@brief A helper job which joins the parallel context on the pool worker.
+	*/
+	class ParallelJob: public BaseJob
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the job
+		@param[in] context the parallel context to join.
+		*/
+		ParallelJob(ParallelContext *context):BaseJob()
+		{
+			m_context=context;
+			m_context->RetainObj();
+		}
+
+		/*!
+		Default Destructor
+
+		Destroy the job
+		*/
+		virtual ~ParallelJob()
+		{
+			m_context->ReleaseObj();
+		}
+
+		/// the parallel context to join
+		ParallelContext *m_context;
+	};
+
+	/*! 
+	@class ParallelJobProcessor epParallel.cpp
+	@brief A job processor which runs the chunks of the ParallelJob.
+	*/
+	class ParallelJobProcessor: public BaseJobProcessor
+	{
+	public:
+		/*!
+		Run the chunks of the given ParallelJob.
+		@param[in] workerThread The worker thread which called the DoJob.
+		@param[in] data The ParallelJob given to this object.
+		*/
+		virtual void DoJob(BaseWorkerThread *workerThread, BaseJob* const data)
+		{
+			static_cast<ParallelJob*>(data)->m_context->runChunks();
+		}
+	};
+}
+
+ParallelContext::ParallelContext(size_t begin, size_t end, size_t grain, LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_doneEvent(false,true)
+{
+	if(grain==0)
+		grain=1;
+	m_begin=begin;
+	m_end=end;
+	m_grain=grain;
+	m_chunkCount=0;
+	if(end>begin)
+		m_chunkCount=(end-begin-1)/grain+1;
+	m_nextChunk=0;
+	m_doneChunkCount=0;
+}
+
+ParallelContext::~ParallelContext()
+{
+}
+
+size_t ParallelContext::GetChunkCount() const
+{
+	return m_chunkCount;
+}
+
+size_t ParallelContext::GetGrainSize(ThreadPool *pool, size_t begin, size_t end, size_t grain)
+{
+	if(grain>0)
+		return grain;
+	if(end<=begin)
+		return 1;
+	size_t participantCount=1;
+	if(pool)
+		participantCount+=pool->GetWorkerCount();
+	grain=(end-begin)/(participantCount*4);
+	if(grain==0)
+		grain=1;
+	return grain;
+}
+
+void ParallelContext::Run(ThreadPool *pool)
+{
+	if(m_chunkCount==0)
+		return;
+	if(m_chunkCount>1 && pool && pool->IsStarted())
+	{
+		size_t helperCount=static_cast<size_t>(pool->GetWorkerCount());
+		if(helperCount>m_chunkCount-1)
+			helperCount=m_chunkCount-1;
+		ParallelJobProcessor *jobProcessor=EP_NEW ParallelJobProcessor();
+		for(size_t helperTrav=0;helperTrav<helperCount;helperTrav++)
+		{
+			ParallelJob *job=EP_NEW ParallelJob(this);
+			job->SetJobProcessor(jobProcessor);
+			pool->Push(job);
+			job->ReleaseObj();
+		}
+		jobProcessor->ReleaseObj();
+	}
+	runChunks();
+	m_doneEvent.WaitForEvent();
+}
+
+void ParallelContext::runChunks()
+{
+	while(true)
+	{
+		__int64 chunkIdx=InterlockedIncrement64(&m_nextChunk)-1;
+		if(static_cast<unsigned __int64>(chunkIdx)>=m_chunkCount)
+			return;
+		size_t chunkBegin=m_begin+static_cast<size_t>(chunkIdx)*m_grain;
+		size_t chunkEnd=(m_end-chunkBegin>m_grain)?chunkBegin+m_grain:m_end;
+		processChunk(static_cast<size_t>(chunkIdx),chunkBegin,chunkEnd);
+		if(static_cast<unsigned __int64>(InterlockedIncrement64(&m_doneChunkCount))==m_chunkCount)
+			m_doneEvent.SetEvent();
+	}
+}
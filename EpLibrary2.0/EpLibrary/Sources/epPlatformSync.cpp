@@ -0,0 +1,336 @@
+/*! 
+PlatformSync for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epPlatformSync.h"
+#include <limits.h>
+#if !defined(EP_PLATFORM_WINDOWS)
+#include <errno.h>
+#include <time.h>
+#endif //!defined(EP_PLATFORM_WINDOWS)
+#if defined(EP_PLATFORM_LINUX)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif //defined(EP_PLATFORM_LINUX)
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+#if defined(EP_PLATFORM_WINDOWS)
+
+typedef BOOL (WINAPI *LPFN_WAITONADDRESS)(volatile void *, PVOID, SIZE_T, DWORD);
+typedef void (WINAPI *LPFN_WAKEBYADDRESS)(PVOID);
+
+static LPFN_WAITONADDRESS s_fnWaitOnAddress=NULL;
+static LPFN_WAKEBYADDRESS s_fnWakeByAddressSingle=NULL;
+static LPFN_WAKEBYADDRESS s_fnWakeByAddressAll=NULL;
+static volatile long s_isAddressWaitResolved=0;
+
+static void resolveAddressWait()
+{
+	if(s_isAddressWaitResolved)
+		return;
+	//WaitOnAddress, WakeByAddressSingle and WakeByAddressAll are not available before Windows 8.
+	HMODULE kernelBase=GetModuleHandle(TEXT("kernelbase"));
+	if(kernelBase)
+	{
+		LPFN_WAITONADDRESS fnWaitOnAddress=(LPFN_WAITONADDRESS)GetProcAddress(kernelBase,"WaitOnAddress");
+		LPFN_WAKEBYADDRESS fnWakeByAddressSingle=(LPFN_WAKEBYADDRESS)GetProcAddress(kernelBase,"WakeByAddressSingle");
+		LPFN_WAKEBYADDRESS fnWakeByAddressAll=(LPFN_WAKEBYADDRESS)GetProcAddress(kernelBase,"WakeByAddressAll");
+		// use them only together, so the waiting thread is always woken by the same method
+		if(fnWaitOnAddress && fnWakeByAddressSingle && fnWakeByAddressAll)
+		{
+			s_fnWaitOnAddress=fnWaitOnAddress;
+			s_fnWakeByAddressSingle=fnWakeByAddressSingle;
+			s_fnWakeByAddressAll=fnWakeByAddressAll;
+		}
+	}
+	InterlockedExchange(&s_isAddressWaitResolved,1);
+}
+
+bool PlatformSync::IsAddressWaitSupported()
+{
+	resolveAddressWait();
+	return s_fnWaitOnAddress!=NULL;
+}
+
+bool PlatformSync::WaitOnAddress(volatile long *address, long compareValue, unsigned int waitTimeInMilliSec)
+{
+	resolveAddressWait();
+	if(!s_fnWaitOnAddress)
+		return false;
+	return s_fnWaitOnAddress(address,&compareValue,sizeof(long),waitTimeInMilliSec)!=FALSE;
+}
+
+void PlatformSync::WakeByAddressSingle(volatile long *address)
+{
+	resolveAddressWait();
+	if(s_fnWakeByAddressSingle)
+		s_fnWakeByAddressSingle((PVOID)address);
+}
+
+void PlatformSync::WakeByAddressAll(volatile long *address)
+{
+	resolveAddressWait();
+	if(s_fnWakeByAddressAll)
+		s_fnWakeByAddressAll((PVOID)address);
+}
+
+PlatformSemaphore::PlatformSemaphore()
+{
+	m_sem=CreateSemaphore(NULL,0,LONG_MAX,NULL);
+}
+
+PlatformSemaphore::~PlatformSemaphore()
+{
+	CloseHandle(m_sem);
+	m_sem=NULL;
+}
+
+bool PlatformSemaphore::Wait(unsigned int waitTimeInMilliSec)
+{
+	return System::WaitForSingleObject(m_sem,waitTimeInMilliSec)==WAIT_OBJECT_0;
+}
+
+bool PlatformSemaphore::Post(long count)
+{
+	return ReleaseSemaphore(m_sem,count,NULL)!=0;
+}
+
+#else //defined(EP_PLATFORM_WINDOWS)
+
+/*!
+Return the monotonic time in milliseconds.
+@return the monotonic time in milliseconds
+*/
+static __int64 getMonotonicMilliSec()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return (__int64)now.tv_sec*1000+now.tv_nsec/1000000;
+}
+
+/*!
+Return the time remaining from the given start time.
+@param[in] startMilliSec the monotonic time the wait started
+@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+@param[out] retRemainTime the time remaining, in milliseconds.
+@return false if timed out otherwise true
+*/
+static bool getRemainTime(__int64 startMilliSec, unsigned int waitTimeInMilliSec, unsigned int &retRemainTime)
+{
+	retRemainTime=WAITTIME_INIFINITE;
+	if(waitTimeInMilliSec==WAITTIME_INIFINITE)
+		return true;
+	__int64 elapsedTime=getMonotonicMilliSec()-startMilliSec;
+	if(elapsedTime>=(__int64)waitTimeInMilliSec)
+		return false;
+	retRemainTime=waitTimeInMilliSec-(unsigned int)elapsedTime;
+	return true;
+}
+
+#if defined(EP_PLATFORM_LINUX)
+
+/*!
+Return the futex word of the given address.
+@param[in] address the address of the long value
+@return the futex word holding the lower 32 bits of the value
+*/
+static volatile int *getFutexWord(volatile long *address)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+	return reinterpret_cast<volatile int*>(address)+(sizeof(long)/sizeof(int)-1);
+#else
+	return reinterpret_cast<volatile int*>(address);
+#endif
+}
+
+/*!
+Wait on the futex word while equal to given value.
+@param[in] word the futex word
+@param[in] compareValue the value to wait while equal
+@param[in] waitTimeInMilliSec the time-out interval, in milliseconds.
+@return false if timed out otherwise true
+*/
+static bool futexWait(volatile int *word, int compareValue, unsigned int waitTimeInMilliSec)
+{
+	struct timespec timeout;
+	struct timespec *timeoutPtr=NULL;
+	if(waitTimeInMilliSec!=WAITTIME_INIFINITE)
+	{
+		timeout.tv_sec=waitTimeInMilliSec/1000;
+		timeout.tv_nsec=(long)(waitTimeInMilliSec%1000)*1000000;
+		timeoutPtr=&timeout;
+	}
+	// EAGAIN and EINTR are woken up, since the caller checks the value again
+	if(syscall(SYS_futex,word,FUTEX_WAIT_PRIVATE,compareValue,timeoutPtr,NULL,0)==-1 && errno==ETIMEDOUT)
+		return false;
+	return true;
+}
+
+/*!
+Wake the threads waiting on the futex word.
+@param[in] word the futex word
+@param[in] count the maximum number of the threads to wake
+*/
+static void futexWake(volatile int *word, int count)
+{
+	syscall(SYS_futex,word,FUTEX_WAKE_PRIVATE,count,NULL,NULL,0);
+}
+
+bool PlatformSync::IsAddressWaitSupported()
+{
+	return true;
+}
+
+bool PlatformSync::WaitOnAddress(volatile long *address, long compareValue, unsigned int waitTimeInMilliSec)
+{
+	return futexWait(getFutexWord(address),(int)compareValue,waitTimeInMilliSec);
+}
+
+void PlatformSync::WakeByAddressSingle(volatile long *address)
+{
+	futexWake(getFutexWord(address),1);
+}
+
+void PlatformSync::WakeByAddressAll(volatile long *address)
+{
+	futexWake(getFutexWord(address),INT_MAX);
+}
+
+PlatformSemaphore::PlatformSemaphore()
+{
+	m_count=0;
+}
+
+PlatformSemaphore::~PlatformSemaphore()
+{
+}
+
+bool PlatformSemaphore::Wait(unsigned int waitTimeInMilliSec)
+{
+	__int64 startMilliSec=getMonotonicMilliSec();
+	while(true)
+	{
+		int count=m_count;
+		while(count>0)
+		{
+			int prevCount=__sync_val_compare_and_swap(&m_count,count,count-1);
+			if(prevCount==count)
+				return true;
+			count=prevCount;
+		}
+		unsigned int remainTime;
+		if(!getRemainTime(startMilliSec,waitTimeInMilliSec,remainTime))
+			return false;
+		futexWait(&m_count,0,remainTime);
+	}
+}
+
+bool PlatformSemaphore::Post(long count)
+{
+	if(count<=0)
+		return false;
+	__sync_fetch_and_add(&m_count,(int)count);
+	futexWake(&m_count,(int)count);
+	return true;
+}
+
+#else //defined(EP_PLATFORM_LINUX)
+
+bool PlatformSync::IsAddressWaitSupported()
+{
+	return false;
+}
+
+bool PlatformSync::WaitOnAddress(volatile long *address, long compareValue, unsigned int waitTimeInMilliSec)
+{
+	return false;
+}
+
+void PlatformSync::WakeByAddressSingle(volatile long *address)
+{
+}
+
+void PlatformSync::WakeByAddressAll(volatile long *address)
+{
+}
+
+PlatformSemaphore::PlatformSemaphore()
+{
+	sem_init(&m_sem,0,0);
+}
+
+PlatformSemaphore::~PlatformSemaphore()
+{
+	sem_destroy(&m_sem);
+}
+
+bool PlatformSemaphore::Wait(unsigned int waitTimeInMilliSec)
+{
+	if(waitTimeInMilliSec==WAITTIME_INIFINITE)
+	{
+		while(sem_wait(&m_sem)==-1)
+		{
+			if(errno!=EINTR)
+				return false;
+		}
+		return true;
+	}
+	// sem_timedwait takes the absolute time of the realtime clock
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME,&deadline);
+	deadline.tv_sec+=waitTimeInMilliSec/1000;
+	deadline.tv_nsec+=(long)(waitTimeInMilliSec%1000)*1000000;
+	if(deadline.tv_nsec>=1000000000)
+	{
+		deadline.tv_sec++;
+		deadline.tv_nsec-=1000000000;
+	}
+	while(sem_timedwait(&m_sem,&deadline)==-1)
+	{
+		if(errno!=EINTR)
+			return false;
+	}
+	return true;
+}
+
+bool PlatformSemaphore::Post(long count)
+{
+	for(long countTrav=0;countTrav<count;countTrav++)
+	{
+		if(sem_post(&m_sem)==-1)
+			return false;
+	}
+	return count>0;
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
+#endif //defined(EP_PLATFORM_WINDOWS)
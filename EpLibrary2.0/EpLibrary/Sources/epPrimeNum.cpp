@@ -23,8 +23,14 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
-#include "epFastSqrt.h"
 #include "epPrimeNum.h"
+#include "epFastSqrt.h"
+#include "epParallel.h"
+#include <algorithm>
+
+#if _MSC_VER>=MSVC90 && defined(_M_X64)
+#include <intrin.h>
+#endif //_MSC_VER>=MSVC90 && defined(_M_X64)
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -34,28 +40,347 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
-bool PrimeNum::IsPrime(unsigned int x)
+/// the small primes to divide by before the Miller-Rabin test, which are also the bases for the 64-bit test
+static const unsigned int s_smallPrimes[]={2,3,5,7,11,13,17,19,23,29,31,37};
+/// the number of the small primes
+static const size_t s_smallPrimeCount=sizeof(s_smallPrimes)/sizeof(unsigned int);
+/// the bases which make the Miller-Rabin test deterministic below 2^32
+static const unsigned int s_bases32[]={2,7,61};
+/// the prime capacities, each about twice the previous and far from the powers of two
+static const unsigned int s_primeCapacities[]={
+	3,7,13,29,53,97,193,389,769,1543,3079,6151,12289,24593,49157,98317,196613,393241,786433,
+	1572869,3145739,6291469,12582917,25165843,50331653,100663319,201326611,402653189,805306457,
+	1610612741,3221225473u,4294967291u
+};
+/// the number of the prime capacities
+static const size_t s_primeCapacityCount=sizeof(s_primeCapacities)/sizeof(unsigned int);
+/// the largest 32-bit prime
+#define PRIME_NUM_MAX_PRIME32 4294967291u
+/// the largest 64-bit prime
+#define PRIME_NUM_MAX_PRIME64 18446744073709551557ULL
+
+/*!
+Divide the given number by the small primes.
+@param[in] x the value to check.
+@param[out] retIsPrime true if x is the small prime, false if x has the small factor or is less than 2.
+@return true if decided, false if x needs the Miller-Rabin test.
+*/
+static bool checkSmallPrimes(unsigned __int64 x, bool &retIsPrime)
+{
+	if(x<2)
+	{
+		retIsPrime=false;
+		return true;
+	}
+	for(size_t primeTrav=0;primeTrav<s_smallPrimeCount;primeTrav++)
+	{
+		if(x%s_smallPrimes[primeTrav]==0)
+		{
+			retIsPrime=(x==s_smallPrimes[primeTrav]);
+			return true;
+		}
+	}
+	if(x<37*37)
+	{
+		retIsPrime=true;
+		return true;
+	}
+	return false;
+}
+
+/*!
+Return the power of the given base modulo the 32-bit number.
+@param[in] base the base.
+@param[in] exponent the exponent.
+@param[in] mod the modulus.
+@return base^exponent mod mod
+*/
+static unsigned int powMod32(unsigned __int64 base, unsigned int exponent, unsigned int mod)
+{
+	unsigned __int64 result=1;
+	base%=mod;
+	while(exponent)
+	{
+		if(exponent&1)
+			result=result*base%mod;
+		base=base*base%mod;
+		exponent>>=1;
+	}
+	return static_cast<unsigned int>(result);
+}
+
+/*!
+Multiply the given 64-bit values into the 128-bit value
+@param[in] a the first value
+@param[in] b the second value
+@param[out] retHigh the high 64 bits of the product
+@return the low 64 bits of the product
+*/
+static inline unsigned __int64 multiply128(unsigned __int64 a, unsigned __int64 b, unsigned __int64 &retHigh)
+{
+#if _MSC_VER>=MSVC90 && defined(_M_X64)
+	return _umul128(a,b,&retHigh);
+#else //_MSC_VER>=MSVC90 && defined(_M_X64)
+	unsigned __int64 aLow=a&0xFFFFFFFF, aHigh=a>>32;
+	unsigned __int64 bLow=b&0xFFFFFFFF, bHigh=b>>32;
+	unsigned __int64 lowLow=aLow*bLow;
+	unsigned __int64 highLow=aHigh*bLow;
+	unsigned __int64 cross=(lowLow>>32)+(highLow&0xFFFFFFFF)+aLow*bHigh;
+	retHigh=aHigh*bHigh+(highLow>>32)+(cross>>32);
+	return (cross<<32)|(lowLow&0xFFFFFFFF);
+#endif //_MSC_VER>=MSVC90 && defined(_M_X64)
+}
+
+/*!
+@class Montgomery64 epPrimeNum.cpp
+@brief A class for the Montgomery multiplication modulo the odd 64-bit number, which needs no 128-bit division.
+*/
+class Montgomery64
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the Montgomery form of the given modulus
+	@param[in] mod the odd modulus
+	*/
+	Montgomery64(unsigned __int64 mod)
+	{
+		m_mod=mod;
+		// Newton iteration doubles the correct bits of the inverse each step
+		m_modInverse=mod;
+		for(int iterTrav=0;iterTrav<5;iterTrav++)
+			m_modInverse*=2-mod*m_modInverse;
+		m_one=(0-mod)%mod;
+		m_rSquare=m_one;
+		for(int bitTrav=0;bitTrav<64;bitTrav++)
+			m_rSquare=addMod(m_rSquare,m_rSquare);
+	}
+
+	/*!
+	Convert the given value into the Montgomery form
+	@param[in] value the value less than the modulus
+	@return the value in the Montgomery form
+	*/
+	unsigned __int64 ToMontgomery(unsigned __int64 value) const
+	{
+		return Multiply(value,m_rSquare);
+	}
+
+	/*!
+	Multiply the given values in the Montgomery form
+	@param[in] a the first value
+	@param[in] b the second value
+	@return a*b in the Montgomery form
+	*/
+	unsigned __int64 Multiply(unsigned __int64 a, unsigned __int64 b) const
+	{
+		unsigned __int64 high;
+		unsigned __int64 low=multiply128(a,b,high);
+		// the low halves of the product and m*mod cancel out, so only the high halves are subtracted
+		unsigned __int64 reduceHigh;
+		multiply128(low*m_modInverse,m_mod,reduceHigh);
+		return (high>=reduceHigh)?high-reduceHigh:high-reduceHigh+m_mod;
+	}
+
+	/*!
+	Return 1 in the Montgomery form
+	@return 1 in the Montgomery form
+	*/
+	unsigned __int64 GetOne() const
+	{
+		return m_one;
+	}
+
+	/*!
+	Return -1 in the Montgomery form
+	@return -1 in the Montgomery form
+	*/
+	unsigned __int64 GetMinusOne() const
+	{
+		return m_mod-m_one;
+	}
+
+private:
+	/*!
+	Add the given values modulo the modulus
+	@param[in] a the first value
+	@param[in] b the second value
+	@return a+b mod the modulus
+	*/
+	unsigned __int64 addMod(unsigned __int64 a, unsigned __int64 b) const
+	{
+		unsigned __int64 sum=a+b;
+		if(sum<a || sum>=m_mod)
+			sum-=m_mod;
+		return sum;
+	}
+
+	/// the modulus
+	unsigned __int64 m_mod;
+	/// the inverse of the modulus modulo 2^64
+	unsigned __int64 m_modInverse;
+	/// 2^64 mod the modulus, which is 1 in the Montgomery form
+	unsigned __int64 m_one;
+	/// 2^128 mod the modulus
+	unsigned __int64 m_rSquare;
+};
+
+/*!
+Run the Miller-Rabin test of the given base on the 64-bit number.
+@param[in] mont the Montgomery form of the number.
+@param[in] base the base.
+@param[in] oddPart the odd part of x-1.
+@param[in] twoCount the number of factors of two in x-1.
+@return true if x is probably prime for the base, false if x is composite.
+*/
+static bool millerRabin64(const Montgomery64 &mont, unsigned __int64 base, unsigned __int64 oddPart, int twoCount)
 {
-	if(x<=1)
-		return false;
-	if( x==2 || x==3)
+	unsigned __int64 result=mont.GetOne();
+	unsigned __int64 square=mont.ToMontgomery(base);
+	for(unsigned __int64 exponent=oddPart;exponent;exponent>>=1)
+	{
+		if(exponent&1)
+			result=mont.Multiply(result,square);
+		square=mont.Multiply(square,square);
+	}
+	if(result==mont.GetOne() || result==mont.GetMinusOne())
 		return true;
-	if(x%2==0 || x%3==0)
-		return false;
-	unsigned int sqrtValue=FastSqrt::Sqrt(x);
-	unsigned int trav=1;
-	unsigned int multP1=(trav*6)+1;
-	unsigned int multP2=(trav*6)-1;
-	while(multP2<=sqrtValue)
-	{
-		if(x%multP1==0 || x%multP2==0)
+	for(int squareTrav=1;squareTrav<twoCount;squareTrav++)
+	{
+		result=mont.Multiply(result,result);
+		if(result==mont.GetMinusOne())
+			return true;
+	}
+	return false;
+}
+
+/*!
+@class PrimeSieveFunc epPrimeNum.cpp
+@brief A functor which sieves the segments of the odd numbers for ParallelFor.
+*/
+class PrimeSieveFunc
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the functor
+	@param[in] basePrimes the odd primes up to the square root of the last odd number
+	@param[in] firstOdd the first odd number to sieve
+	@param[in] lastOdd the last odd number to sieve
+	@param[out] retSegmentPrimes the primes found per segment
+	*/
+	PrimeSieveFunc(const std::vector<unsigned int> *basePrimes, unsigned __int64 firstOdd, unsigned __int64 lastOdd, std::vector<std::vector<unsigned int> > *retSegmentPrimes)
+	{
+		m_basePrimes=basePrimes;
+		m_firstOdd=firstOdd;
+		m_lastOdd=lastOdd;
+		m_segmentPrimes=retSegmentPrimes;
+	}
+
+	/*!
+	Sieve the given segments.
+	@param[in] segmentBegin the first segment.
+	@param[in] segmentEnd the segment after the last.
+	*/
+	void operator()(size_t segmentBegin, size_t segmentEnd) const
+	{
+		std::vector<unsigned char> isComposite(PRIME_NUM_SIEVE_SEGMENT_SIZE);
+		for(size_t segmentTrav=segmentBegin;segmentTrav<segmentEnd;segmentTrav++)
+		{
+			unsigned __int64 low=m_firstOdd+static_cast<unsigned __int64>(segmentTrav)*PRIME_NUM_SIEVE_SEGMENT_SIZE*2;
+			unsigned __int64 high=low+(PRIME_NUM_SIEVE_SEGMENT_SIZE-1)*2;
+			if(high>m_lastOdd)
+				high=m_lastOdd;
+			size_t oddCount=static_cast<size_t>((high-low)/2+1);
+			std::fill(isComposite.begin(),isComposite.begin()+oddCount,0);
+			for(size_t primeTrav=0;primeTrav<m_basePrimes->size();primeTrav++)
+			{
+				unsigned __int64 prime=(*m_basePrimes)[primeTrav];
+				unsigned __int64 multiple=prime*prime;
+				if(multiple>high)
+					break;
+				if(multiple<low)
+				{
+					multiple=(low+prime-1)/prime*prime;
+					if((multiple&1)==0)
+						multiple+=prime;
+				}
+				// the odd multiples are prime*2 apart, which is prime apart in the odd indices
+				for(size_t oddTrav=static_cast<size_t>((multiple-low)/2);oddTrav<oddCount;oddTrav+=static_cast<size_t>(prime))
+					isComposite[oddTrav]=1;
+			}
+			std::vector<unsigned int> &primes=(*m_segmentPrimes)[segmentTrav];
+			for(size_t oddTrav=0;oddTrav<oddCount;oddTrav++)
+			{
+				if(!isComposite[oddTrav])
+					primes.push_back(static_cast<unsigned int>(low+oddTrav*2));
+			}
+		}
+	}
+private:
+	/// the odd primes up to the square root of the last odd number
+	const std::vector<unsigned int> *m_basePrimes;
+	/// the first odd number to sieve
+	unsigned __int64 m_firstOdd;
+	/// the last odd number to sieve
+	unsigned __int64 m_lastOdd;
+	/// the primes found per segment
+	std::vector<std::vector<unsigned int> > *m_segmentPrimes;
+};
+
+bool PrimeNum::IsPrime(unsigned int x)
+{
+	bool isPrime;
+	if(checkSmallPrimes(x,isPrime))
+		return isPrime;
+	unsigned int oddPart=x-1;
+	int twoCount=0;
+	while((oddPart&1)==0)
+	{
+		oddPart>>=1;
+		twoCount++;
+	}
+	for(size_t baseTrav=0;baseTrav<sizeof(s_bases32)/sizeof(unsigned int);baseTrav++)
+	{
+		unsigned __int64 result=powMod32(s_bases32[baseTrav],oddPart,x);
+		if(result==1 || result==x-1)
+			continue;
+		int squareTrav;
+		for(squareTrav=1;squareTrav<twoCount;squareTrav++)
+		{
+			result=result*result%x;
+			if(result==x-1)
+				break;
+		}
+		if(squareTrav==twoCount)
+			return false;
+	}
+	return true;
+}
+
+bool PrimeNum::IsPrime64(unsigned __int64 x)
+{
+	if(x<=0xFFFFFFFF)
+		return IsPrime(static_cast<unsigned int>(x));
+	bool isPrime;
+	if(checkSmallPrimes(x,isPrime))
+		return isPrime;
+	unsigned __int64 oddPart=x-1;
+	int twoCount=0;
+	while((oddPart&1)==0)
+	{
+		oddPart>>=1;
+		twoCount++;
+	}
+	// the first 12 primes as the bases make the test deterministic below 2^64
+	Montgomery64 mont(x);
+	for(size_t baseTrav=0;baseTrav<s_smallPrimeCount;baseTrav++)
+	{
+		if(!millerRabin64(mont,s_smallPrimes[baseTrav],oddPart,twoCount))
 			return false;
-		trav++;
-		multP1=(trav*6)+1;
-		multP2=(trav*6)-1;
 	}
-	if(multP1<=sqrtValue && x%multP1==0)
-		return false;
 	return true;
 }
 
@@ -63,23 +388,66 @@ unsigned int PrimeNum::NextPrime(unsigned int x)
 {
 	if(x<2)
 		return 2;
-	if(x==2)
-		return 3;
+	if(x>=PRIME_NUM_MAX_PRIME32)
+		return 0;
+	unsigned int candidate=(x+1)|1;
+	while(!IsPrime(candidate))
+		candidate+=2;
+	return candidate;
+}
 
-	int multIdx=x/6;
-	unsigned int check1;
-	unsigned int check2;
-	while(1)
+unsigned __int64 PrimeNum::NextPrime64(unsigned __int64 x)
+{
+	if(x<2)
+		return 2;
+	if(x>=PRIME_NUM_MAX_PRIME64)
+		return 0;
+	unsigned __int64 candidate=(x+1)|1;
+	while(!IsPrime64(candidate))
+		candidate+=2;
+	return candidate;
+}
+
+unsigned int PrimeNum::GetPrimeCapacity(unsigned int minCapacity)
+{
+	const unsigned int *capacity=std::lower_bound(s_primeCapacities,s_primeCapacities+s_primeCapacityCount,minCapacity);
+	if(capacity!=s_primeCapacities+s_primeCapacityCount)
+		return *capacity;
+	return NextPrime(minCapacity-1);
+}
+
+void PrimeNum::GetPrimes(unsigned int startNum, unsigned int endNum, std::vector<unsigned int> &retPrimes, ThreadPool *pool)
+{
+	if(startNum>endNum || endNum<2)
+		return;
+	if(startNum<=2)
+		retPrimes.push_back(2);
+	unsigned __int64 firstOdd=startNum<3?3:(startNum|1);
+	unsigned __int64 lastOdd=(endNum&1)?endNum:endNum-1;
+	if(firstOdd>lastOdd)
+		return;
+
+	// the odd primes up to the square root are enough to strike out every odd composite
+	unsigned int sqrtLast=FastSqrt::ISqrt(static_cast<unsigned int>(lastOdd));
+	std::vector<unsigned int> basePrimes;
+	std::vector<unsigned char> isBaseComposite(sqrtLast+1,0);
+	for(unsigned int numTrav=3;numTrav<=sqrtLast;numTrav+=2)
 	{
-		check1=multIdx*6-1;
-		if(check1>x && epl::PrimeNum::IsPrime(check1))
-		{
-			return check1;
-		}
-		check2=multIdx*6+1;
-		if(check2>x &&epl::PrimeNum::IsPrime(check2))
-			return check2;
-		multIdx++;
+		if(isBaseComposite[numTrav])
+			continue;
+		basePrimes.push_back(numTrav);
+		for(unsigned int multTrav=numTrav*numTrav;multTrav<=sqrtLast;multTrav+=numTrav*2)
+			isBaseComposite[multTrav]=1;
 	}
-}
 
+	size_t segmentCount=static_cast<size_t>(((lastOdd-firstOdd)/2)/PRIME_NUM_SIEVE_SEGMENT_SIZE+1);
+	std::vector<std::vector<unsigned int> > segmentPrimes(segmentCount);
+	ParallelFor(segmentCount>1?pool:NULL,0,segmentCount,1,PrimeSieveFunc(&basePrimes,firstOdd,lastOdd,&segmentPrimes));
+
+	size_t primeCount=retPrimes.size();
+	for(size_t segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		primeCount+=segmentPrimes[segmentTrav].size();
+	retPrimes.reserve(primeCount);
+	for(size_t segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		retPrimes.insert(retPrimes.end(),segmentPrimes[segmentTrav].begin(),segmentPrimes[segmentTrav].end());
+}
@@ -28,6 +28,10 @@ THE SOFTWARE.
 #include "epException.h"
 #include "epFolderHelper.h"
 #include "epDateTimeHelper.h"
+#include "epClock.h"
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#endif //defined(_M_IX86) || defined(_M_X64)
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -129,6 +133,7 @@ ProfileManager::ProfileNode::ProfileNode(const ProfileNode& b):OutputNode(b)
 	m_uniqueName=b.m_uniqueName;
 	m_cnt=b.m_cnt;
 	m_totalTime=b.m_totalTime;
+	m_histogram=b.m_histogram;
 }
 ProfileManager::ProfileNode::~ProfileNode()
 {
@@ -142,19 +147,22 @@ ProfileManager::ProfileNode & ProfileManager::ProfileNode::operator=(const Profi
 		m_uniqueName=b.m_uniqueName;
 		m_cnt=b.m_cnt;
 		m_totalTime=b.m_totalTime;
+		m_histogram=b.m_histogram;
 	}
 	return *this;
 }
 
 void ProfileManager::ProfileNode::Print() const
 {
-	System::TPrintf(_T("%s Average : %I64d ms Total : %I64d ms Call : %d\n"),m_uniqueName.c_str(),m_totalTime/m_cnt,m_totalTime,m_cnt);
+	System::TPrintf(_T("%s Average : %I64d ms Total : %I64d ms Call : %d P50 : %I64d ms P90 : %I64d ms P99 : %I64d ms P999 : %I64d ms Max : %I64d ms\n"),m_uniqueName.c_str(),m_totalTime/m_cnt,m_totalTime,m_cnt,
+		m_histogram.GetValueAtPercentile(50.0),m_histogram.GetValueAtPercentile(90.0),m_histogram.GetValueAtPercentile(99.0),m_histogram.GetValueAtPercentile(99.9),m_histogram.GetMaxValue());
 }
 
 void ProfileManager::ProfileNode::Write(EpFile* const file)
 {
 	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
-	System::FTPrintf(file,_T("%s Average : %I64d ms Total : %I64d ms Call : %d\n"),m_uniqueName.c_str(),m_totalTime/m_cnt,m_totalTime,m_cnt);
+	System::FTPrintf(file,_T("%s Average : %I64d ms Total : %I64d ms Call : %d P50 : %I64d ms P90 : %I64d ms P99 : %I64d ms P999 : %I64d ms Max : %I64d ms\n"),m_uniqueName.c_str(),m_totalTime/m_cnt,m_totalTime,m_cnt,
+		m_histogram.GetValueAtPercentile(50.0),m_histogram.GetValueAtPercentile(90.0),m_histogram.GetValueAtPercentile(99.0),m_histogram.GetValueAtPercentile(99.9),m_histogram.GetMaxValue());
 }
 
 CompResultType ProfileManager::ProfileNode::Compare(const void * a, const void * b)
@@ -169,27 +177,510 @@ CompResultType ProfileManager::ProfileNode::Compare(const void * a, const void *
 	else return COMP_RESULT_LESSTHAN;		
 }
 
+/*!
+Escape the string to put in the JSON string.
+@param[in] source the string to escape.
+@param[out] retString the escaped string.
+*/
+static void escapeJsonString(const EpTString &source, EpTString &retString)
+{
+	retString.clear();
+	for(size_t charTrav=0;charTrav<source.length();charTrav++)
+	{
+		TCHAR character=source[charTrav];
+		if(character==_T('\\') || character==_T('"'))
+			retString.push_back(_T('\\'));
+		if(character<_T(' '))
+			character=_T(' ');
+		retString.push_back(character);
+	}
+}
+
+ProfileSiteStat::ProfileSiteStat()
+{
+	callCount=0;
+	sampleCount=0;
+	totalTick=0;
+	counterSampleCount=0;
+	for(unsigned int counterTrav=0;counterTrav<PROFILE_MAX_COUNTER_COUNT;counterTrav++)
+		counterTotals[counterTrav]=0;
+}
+
+#if (_MSC_VER >=MSVC90) && (WINVER>=WINDOWS_VISTA) // Only for VS2008 and above and Windows Vista and above
+unsigned int ThreadCycleCounterSource::GetCounterCount() const
+{
+	return 1;
+}
+
+const TCHAR *ThreadCycleCounterSource::GetCounterName(unsigned int counterIdx) const
+{
+	return _T("Cycles");
+}
+
+void ThreadCycleCounterSource::ReadCounters(unsigned __int64 *retValues)
+{
+	retValues[0]=DateTimeHelper::GetThreadCPUCycleCount(GetCurrentThread());
+}
+#endif //(_MSC_VER >=MSVC90) && (WINVER>=WINDOWS_VISTA)
+
+#if defined(_M_IX86) || defined(_M_X64)
+PmcCounterSource::PmcCounterSource(const TCHAR * const *counterNames, const int *pmcIndices, unsigned int counterCount)
+{
+	EP_ASSERT_EXPR(counterCount<=PROFILE_MAX_COUNTER_COUNT,_T("More than %d counters are given!"),PROFILE_MAX_COUNTER_COUNT);
+	if(counterCount>PROFILE_MAX_COUNTER_COUNT)
+		counterCount=PROFILE_MAX_COUNTER_COUNT;
+	m_counterCount=counterCount;
+	for(unsigned int counterTrav=0;counterTrav<PROFILE_MAX_COUNTER_COUNT;counterTrav++)
+	{
+		if(counterTrav<counterCount)
+		{
+			m_counterNames[counterTrav]=counterNames[counterTrav];
+			m_pmcIndices[counterTrav]=pmcIndices[counterTrav];
+		}
+		else
+			m_pmcIndices[counterTrav]=0;
+	}
+}
+
+unsigned int PmcCounterSource::GetCounterCount() const
+{
+	return m_counterCount;
+}
+
+const TCHAR *PmcCounterSource::GetCounterName(unsigned int counterIdx) const
+{
+	EP_ASSERT_EXPR(counterIdx<m_counterCount,_T("The index is out of range."));
+	return m_counterNames[counterIdx].c_str();
+}
+
+void PmcCounterSource::ReadCounters(unsigned __int64 *retValues)
+{
+	for(unsigned int counterTrav=0;counterTrav<m_counterCount;counterTrav++)
+		retValues[counterTrav]=__readpmc(static_cast<unsigned long>(m_pmcIndices[counterTrav]));
+}
+#endif //defined(_M_IX86) || defined(_M_X64)
+
+ProfileManager::ProfileThreadSlot::ProfileThreadSlot()
+{
+	m_threadId=GetCurrentThreadId();
+	m_treeNodes=NULL;
+	m_treeNodeCount=0;
+	m_currentNodeIdx=0;
+	m_timeline=NULL;
+	m_timelineMask=0;
+	m_timelineCount=0;
+	for(unsigned int siteTrav=0;siteTrav<PROFILE_MAX_SITE_COUNT;siteTrav++)
+		m_histograms[siteTrav]=NULL;
+}
+
+ProfileManager::ProfileThreadSlot::~ProfileThreadSlot()
+{
+	if(m_treeNodes)
+		EP_DELETE[] m_treeNodes;
+	if(m_timeline)
+		EP_DELETE[] m_timeline;
+	for(unsigned int siteTrav=0;siteTrav<PROFILE_MAX_SITE_COUNT;siteTrav++)
+	{
+		if(m_histograms[siteTrav])
+			EP_DELETE m_histograms[siteTrav];
+	}
+}
+
 void ProfileManager::FlushToFile()
 {
 #if  defined(_DEBUG) && defined(EP_ENABLE_PROFILE)
 	BaseOutputter::FlushToFile();
 #endif// defined(_DEBUG) && defined(EP_ENABLE_PROFILE)
+#if defined(EP_ENABLE_SAMPLING_PROFILE)
+	LockObj lock(m_nodeListLock);
+	EpFile *file=NULL;
+	System::FTOpen(file,m_fileName.c_str(),_T("at"));
+	EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),m_fileName.c_str());
+	if(file)
+	{
+		System::FTPrintf(file,_T("Sample Profile Starts...\n"));
+		EpTString output;
+		for(size_t siteTrav=0;siteTrav<m_siteList.size();siteTrav++)
+		{
+			formatSite(siteTrav,output);
+			System::FTPrintf(file,_T("%s"),output.c_str());
+		}
+		formatCallTree(output);
+		System::FTPrintf(file,_T("%s"),output.c_str());
+		System::FTPrintf(file,_T("Sample Profile Ends...\n"));
+		System::FClose(file);
+	}
+#endif// defined(EP_ENABLE_SAMPLING_PROFILE)
+}
+
+void ProfileManager::Print() const
+{
+	BaseOutputter::Print();
+	LockObj lock(m_nodeListLock);
+	EpTString output;
+	for(size_t siteTrav=0;siteTrav<m_siteList.size();siteTrav++)
+	{
+		formatSite(siteTrav,output);
+		System::TPrintf(_T("%s"),output.c_str());
+	}
+	formatCallTree(output);
+	System::TPrintf(_T("%s"),output.c_str());
+}
+
+void ProfileManager::Clear()
+{
+	BaseOutputter::Clear();
+	LockObj lock(m_nodeListLock);
+	for(size_t siteTrav=0;siteTrav<m_siteList.size();siteTrav++)
+	{
+		ProfileSite &site=m_siteList[siteTrav];
+		if(!site.m_baseHistogram)
+			site.m_baseHistogram=EP_NEW LatencyHistogram();
+		mergeSite(siteTrav,site.m_baseStat,*site.m_baseHistogram);
+	}
+}
+
+void ProfileManager::SetSampleInterval(unsigned int sampleInterval)
+{
+	unsigned int interval=1;
+	while(interval<sampleInterval && interval<0x40000000)
+		interval<<=1;
+	InterlockedExchange(&m_sampleMask,static_cast<long>(interval-1));
+}
+
+unsigned int ProfileManager::GetSampleInterval() const
+{
+	return static_cast<unsigned int>(m_sampleMask)+1;
+}
+
+void ProfileManager::SetCallTreeEnabled(bool isEnabled)
+{
+	m_isCallTreeEnabled=isEnabled;
+}
+
+bool ProfileManager::IsCallTreeEnabled() const
+{
+	return m_isCallTreeEnabled;
+}
+
+void ProfileManager::SetTimelineCapacity(unsigned int capacity)
+{
+	unsigned int roundedCapacity=0;
+	if(capacity)
+	{
+		roundedCapacity=1;
+		while(roundedCapacity<capacity && roundedCapacity<0x40000000)
+			roundedCapacity<<=1;
+	}
+	InterlockedExchange(&m_timelineCapacity,static_cast<long>(roundedCapacity));
+}
+
+unsigned int ProfileManager::GetTimelineCapacity() const
+{
+	return static_cast<unsigned int>(m_timelineCapacity);
+}
+
+void ProfileManager::SetCounterSource(ProfileCounterSource *counterSource)
+{
+	EP_ASSERT_EXPR(!counterSource || counterSource->GetCounterCount()<=PROFILE_MAX_COUNTER_COUNT,_T("More than %d counters are given!"),PROFILE_MAX_COUNTER_COUNT);
+	LockObj lock(m_nodeListLock);
+	m_counterSource=counterSource;
+}
+
+ProfileCounterSource *ProfileManager::GetCounterSource() const
+{
+	return m_counterSource;
+}
+
+bool ProfileManager::WriteTimelineToFile(const TCHAR *fileName) const
+{
+	EP_ASSERT_EXPR(fileName,_T("The file name is NULL."));
+	LockObj lock(m_nodeListLock);
+	EpFile *file=NULL;
+	System::FTOpen(file,fileName,_T("wt"));
+	if(!file)
+		return false;
+	unsigned long processId=GetCurrentProcessId();
+	bool isFirst=true;
+	EpTString name;
+	System::FTPrintf(file,_T("{\"traceEvents\":[\n"));
+	for(size_t slotTrav=0;slotTrav<m_slotList.size();slotTrav++)
+	{
+		const ProfileThreadSlot *slot=m_slotList[slotTrav];
+		if(!slot->m_timeline)
+			continue;
+		unsigned long eventCount=static_cast<unsigned long>(slot->m_timelineCount);
+		unsigned long capacity=slot->m_timelineMask+1;
+		// the ring keeps the last calls only
+		unsigned long firstEvent=eventCount>capacity?eventCount-capacity:0;
+		for(unsigned long eventTrav=firstEvent;eventTrav!=eventCount;eventTrav++)
+		{
+			const ProfileTimelineEvent &event=slot->m_timeline[eventTrav&slot->m_timelineMask];
+			if(event.m_siteId<1 || static_cast<size_t>(event.m_siteId)>m_siteList.size())
+				continue;
+			escapeJsonString(m_siteList[event.m_siteId-1].m_uniqueName,name);
+			System::FTPrintf(file,_T("%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}"),isFirst?_T(""):_T(",\n"),name.c_str(),processId,slot->m_threadId,toMicroSec(event.m_startTick-m_originTick),toMicroSec(event.m_endTick-event.m_startTick));
+			isFirst=false;
+		}
+	}
+	System::FTPrintf(file,_T("\n]}\n"));
+	System::FClose(file);
+	return true;
 }
 
 ProfileManager::ProfileManager(LockPolicy lockPolicyType):BaseOutputter(lockPolicyType)
 {
 	m_fileName=FolderHelper::GetModuleFileDirectory();
 	m_fileName.append(_T("profile.dat"));
+	initSites();
 }
 ProfileManager::ProfileManager(const ProfileManager& b):BaseOutputter(b)
 {
 	LockObj lock(b.m_nodeListLock);
 	m_fileName=b.m_fileName;
+	// the thread slots belong to the original, so the copy starts without the sites
+	initSites();
+	m_sampleMask=b.m_sampleMask;
+	m_isCallTreeEnabled=b.m_isCallTreeEnabled;
+	m_timelineCapacity=b.m_timelineCapacity;
+	m_counterSource=b.m_counterSource;
 }
 
 ProfileManager::~ProfileManager()
 {
 	FlushToFile();
+	for(size_t slotTrav=0;slotTrav<m_slotList.size();slotTrav++)
+		EP_DELETE m_slotList[slotTrav];
+	m_slotList.clear();
+	for(size_t siteTrav=0;siteTrav<m_siteList.size();siteTrav++)
+	{
+		if(m_siteList[siteTrav].m_baseHistogram)
+			EP_DELETE m_siteList[siteTrav].m_baseHistogram;
+	}
+	m_siteList.clear();
+	if(m_tlsIndex!=TLS_OUT_OF_INDEXES)
+		TlsFree(m_tlsIndex);
+}
+
+void ProfileManager::initSites()
+{
+	m_tlsIndex=TlsAlloc();
+	EP_ASSERT_EXPR(m_tlsIndex!=TLS_OUT_OF_INDEXES,_T("Failed to allocate the TLS index!"));
+	m_sampleMask=PROFILE_DEFAULT_SAMPLE_INTERVAL-1;
+	m_tickFrequency=Clock::GetFrequency();
+	m_originTick=Clock::GetTick();
+	m_isCallTreeEnabled=false;
+	m_timelineCapacity=0;
+	m_counterSource=NULL;
+}
+
+long ProfileManager::registerSite(const TCHAR *fileName, const TCHAR *functionName, unsigned int lineNum)
+{
+	EpTString uniqueName=Profiler::GetNewUniqueName(const_cast<TCHAR*>(fileName),const_cast<TCHAR*>(functionName),lineNum);
+	LockObj lock(m_nodeListLock);
+	// the threads racing on the first call of the site get the same ID
+	for(size_t siteTrav=0;siteTrav<m_siteList.size();siteTrav++)
+	{
+		if(m_siteList[siteTrav].m_uniqueName==uniqueName)
+			return static_cast<long>(siteTrav+1);
+	}
+	if(m_siteList.size()>=PROFILE_MAX_SITE_COUNT)
+	{
+		EP_ASSERT_EXPR(0,_T("More than %d sites are profiled!"),PROFILE_MAX_SITE_COUNT);
+		return -1;
+	}
+	ProfileSite site;
+	site.m_uniqueName=uniqueName;
+	site.m_baseHistogram=NULL;
+	m_siteList.push_back(site);
+	return static_cast<long>(m_siteList.size());
+}
+
+ProfileSiteStat *ProfileManager::getSiteStat(long siteId)
+{
+	ProfileThreadSlot *slot=reinterpret_cast<ProfileThreadSlot*>(TlsGetValue(m_tlsIndex));
+	if(!slot)
+	{
+		slot=EP_NEW ProfileThreadSlot();
+		TlsSetValue(m_tlsIndex,slot);
+		LockObj lock(m_nodeListLock);
+		m_slotList.push_back(slot);
+	}
+	return &slot->m_stats[siteId-1];
+}
+
+LatencyHistogram *ProfileManager::getSiteHistogram(long siteId)
+{
+	ProfileThreadSlot *slot=reinterpret_cast<ProfileThreadSlot*>(TlsGetValue(m_tlsIndex));
+	LatencyHistogram *histogram=slot->m_histograms[siteId-1];
+	if(!histogram)
+	{
+		histogram=EP_NEW LatencyHistogram();
+		slot->m_histograms[siteId-1]=histogram;
+	}
+	return histogram;
+}
+
+long ProfileManager::enterTreeNode(long siteId)
+{
+	ProfileThreadSlot *slot=reinterpret_cast<ProfileThreadSlot*>(TlsGetValue(m_tlsIndex));
+	if(!slot->m_treeNodes)
+	{
+		ProfileTreeNode *nodes=EP_NEW ProfileTreeNode[PROFILE_MAX_CALL_TREE_NODE_COUNT];
+		System::Memset(&nodes[0],0,sizeof(ProfileTreeNode));
+		nodes[0].m_parentIdx=-1;
+		nodes[0].m_firstChildIdx=-1;
+		nodes[0].m_nextSiblingIdx=-1;
+		slot->m_currentNodeIdx=0;
+		slot->m_treeNodeCount=1;
+		slot->m_treeNodes=nodes;
+	}
+	ProfileTreeNode *nodes=slot->m_treeNodes;
+	long parentIdx=slot->m_currentNodeIdx;
+	long childIdx=nodes[parentIdx].m_firstChildIdx;
+	while(childIdx>=0 && nodes[childIdx].m_siteId!=siteId)
+		childIdx=nodes[childIdx].m_nextSiblingIdx;
+	if(childIdx<0)
+	{
+		if(slot->m_treeNodeCount>=PROFILE_MAX_CALL_TREE_NODE_COUNT)
+			return -1;
+		childIdx=slot->m_treeNodeCount;
+		ProfileTreeNode &child=nodes[childIdx];
+		child.m_siteId=siteId;
+		child.m_parentIdx=parentIdx;
+		child.m_firstChildIdx=-1;
+		child.m_nextSiblingIdx=nodes[parentIdx].m_firstChildIdx;
+		child.m_callCount=0;
+		child.m_inclusiveTick=0;
+		child.m_childTick=0;
+		// the node is complete before it is linked, so the formatting thread never follows to the uninitialized node
+		InterlockedExchange(&slot->m_treeNodeCount,childIdx+1);
+		nodes[parentIdx].m_firstChildIdx=childIdx;
+	}
+	slot->m_currentNodeIdx=childIdx;
+	return childIdx;
+}
+
+void ProfileManager::leaveTreeNode(long nodeIdx, __int64 elapsedTick)
+{
+	ProfileThreadSlot *slot=reinterpret_cast<ProfileThreadSlot*>(TlsGetValue(m_tlsIndex));
+	ProfileTreeNode *nodes=slot->m_treeNodes;
+	ProfileTreeNode &node=nodes[nodeIdx];
+	node.m_callCount++;
+	node.m_inclusiveTick+=elapsedTick;
+	nodes[node.m_parentIdx].m_childTick+=elapsedTick;
+	slot->m_currentNodeIdx=node.m_parentIdx;
+}
+
+void ProfileManager::recordTimeline(long siteId, __int64 startTick, __int64 endTick)
+{
+	ProfileThreadSlot *slot=reinterpret_cast<ProfileThreadSlot*>(TlsGetValue(m_tlsIndex));
+	if(!slot->m_timeline)
+	{
+		long capacity=m_timelineCapacity;
+		if(capacity<=0)
+			return;
+		slot->m_timelineMask=static_cast<unsigned long>(capacity-1);
+		slot->m_timeline=EP_NEW ProfileTimelineEvent[capacity];
+	}
+	ProfileTimelineEvent &event=slot->m_timeline[static_cast<unsigned long>(slot->m_timelineCount)&slot->m_timelineMask];
+	event.m_siteId=siteId;
+	event.m_startTick=startTick;
+	event.m_endTick=endTick;
+	InterlockedIncrement(&slot->m_timelineCount);
+}
+
+void ProfileManager::formatTreeNode(const ProfileThreadSlot *slot, long nodeIdx, unsigned int depth, EpTString &retString) const
+{
+	const ProfileTreeNode &node=slot->m_treeNodes[nodeIdx];
+	EpTString line;
+	System::STPrintf(line,_T("%*s%s Call : %I64d Inclusive : %.3f us Exclusive : %.3f us\n"),depth*2,_T(""),m_siteList[node.m_siteId-1].m_uniqueName.c_str(),node.m_callCount,toMicroSec(node.m_inclusiveTick),toMicroSec(node.m_inclusiveTick-node.m_childTick));
+	retString.append(line);
+	for(long childIdx=node.m_firstChildIdx;childIdx>=0;childIdx=slot->m_treeNodes[childIdx].m_nextSiblingIdx)
+		formatTreeNode(slot,childIdx,depth+1,retString);
+}
+
+void ProfileManager::formatCallTree(EpTString &retString) const
+{
+	retString.clear();
+	for(size_t slotTrav=0;slotTrav<m_slotList.size();slotTrav++)
+	{
+		const ProfileThreadSlot *slot=m_slotList[slotTrav];
+		if(!slot->m_treeNodes)
+			continue;
+		const ProfileTreeNode &root=slot->m_treeNodes[0];
+		EpTString line;
+		System::STPrintf(line,_T("Thread %u Call Tree Total : %.3f us\n"),slot->m_threadId,toMicroSec(root.m_childTick));
+		retString.append(line);
+		for(long childIdx=root.m_firstChildIdx;childIdx>=0;childIdx=slot->m_treeNodes[childIdx].m_nextSiblingIdx)
+			formatTreeNode(slot,childIdx,1,retString);
+	}
+}
+
+double ProfileManager::toMicroSec(__int64 tick) const
+{
+	return static_cast<double>(tick)*1000000.0/static_cast<double>(m_tickFrequency);
+}
+
+void ProfileManager::mergeSite(size_t siteIdx, ProfileSiteStat &retStat, LatencyHistogram &retHistogram) const
+{
+	retStat=ProfileSiteStat();
+	retHistogram.Clear();
+	for(size_t slotTrav=0;slotTrav<m_slotList.size();slotTrav++)
+	{
+		const ProfileSiteStat &stat=m_slotList[slotTrav]->m_stats[siteIdx];
+		retStat.callCount+=stat.callCount;
+		retStat.sampleCount+=stat.sampleCount;
+		retStat.totalTick+=stat.totalTick;
+		retStat.counterSampleCount+=stat.counterSampleCount;
+		for(unsigned int counterTrav=0;counterTrav<PROFILE_MAX_COUNTER_COUNT;counterTrav++)
+			retStat.counterTotals[counterTrav]+=stat.counterTotals[counterTrav];
+		const LatencyHistogram *histogram=m_slotList[slotTrav]->m_histograms[siteIdx];
+		if(histogram)
+			retHistogram.Add(*histogram);
+	}
+}
+
+void ProfileManager::formatSite(size_t siteIdx, EpTString &retString) const
+{
+	ProfileSiteStat stat;
+	LatencyHistogram histogram;
+	mergeSite(siteIdx,stat,histogram);
+	const ProfileSiteStat &baseStat=m_siteList[siteIdx].m_baseStat;
+	if(m_siteList[siteIdx].m_baseHistogram)
+		histogram.Subtract(*m_siteList[siteIdx].m_baseHistogram);
+	__int64 callCount=stat.callCount-baseStat.callCount;
+	__int64 sampleCount=stat.sampleCount-baseStat.sampleCount;
+	__int64 totalTick=stat.totalTick-baseStat.totalTick;
+	double averageTime=0.0;
+	__int64 totalTime=0;
+	if(sampleCount>0)
+	{
+		double averageTick=static_cast<double>(totalTick)/static_cast<double>(sampleCount);
+		averageTime=averageTick*1000000.0/static_cast<double>(m_tickFrequency);
+		// the calls not timed are estimated with the average of the calls timed
+		totalTime=static_cast<__int64>(averageTime*static_cast<double>(callCount));
+	}
+
+	// the counters are reported as the averages per call, with the names of the current source
+	EpTString counterString;
+	__int64 counterSampleCount=stat.counterSampleCount-baseStat.counterSampleCount;
+	ProfileCounterSource *counterSource=m_counterSource;
+	if(counterSource && counterSampleCount>0)
+	{
+		unsigned int counterCount=counterSource->GetCounterCount();
+		if(counterCount>PROFILE_MAX_COUNTER_COUNT)
+			counterCount=PROFILE_MAX_COUNTER_COUNT;
+		EpTString counterValueString;
+		for(unsigned int counterTrav=0;counterTrav<counterCount;counterTrav++)
+		{
+			double averageCount=static_cast<double>(stat.counterTotals[counterTrav]-baseStat.counterTotals[counterTrav])/static_cast<double>(counterSampleCount);
+			System::STPrintf(counterValueString,_T(" %s : %.1f"),counterSource->GetCounterName(counterTrav),averageCount);
+			counterString.append(counterValueString);
+		}
+	}
+	System::STPrintf(retString,_T("%s Average : %.3f us Total : %I64d us Call : %I64d Sampled : %I64d P50 : %.3f us P90 : %.3f us P99 : %.3f us P999 : %.3f us Max : %.3f us%s\n"),m_siteList[siteIdx].m_uniqueName.c_str(),averageTime,totalTime,callCount,sampleCount,
+		toMicroSec(histogram.GetValueAtPercentile(50.0)),toMicroSec(histogram.GetValueAtPercentile(90.0)),toMicroSec(histogram.GetValueAtPercentile(99.0)),toMicroSec(histogram.GetValueAtPercentile(99.9)),toMicroSec(histogram.GetMaxValue()),counterString.c_str());
 }
 ProfileManager & ProfileManager::operator=(const ProfileManager&b)
 {
@@ -242,12 +733,14 @@ void ProfileManager::addProfile(const TCHAR *uniqueName, const unsigned __int64
 	{
 		existStruct->m_totalTime+=time;
 		existStruct->m_cnt++;
+		existStruct->m_histogram.Record(static_cast<__int64>(time));
 	}
 	else
 	{
 		ProfileNode *profile=EP_NEW ProfileNode(uniqueName);
 		profile->m_totalTime=time;
 		profile->m_cnt=1;
+		profile->m_histogram.Record(static_cast<__int64>(time));
 		if(m_list.size() && retIdx!=-1)
 		{
 			std::vector<OutputNode*>::iterator iter=m_list.begin()+retIdx;
@@ -261,6 +754,65 @@ void ProfileManager::addProfile(const TCHAR *uniqueName, const unsigned __int64
 }
 
 
+ProfileSiteObj::ProfileSiteObj(volatile long &siteId, const TCHAR *fileName, const TCHAR *functionName, unsigned int lineNum)
+{
+	m_stat=NULL;
+	m_startTick=0;
+	m_siteId=0;
+	m_treeNodeIdx=-1;
+	m_isTimeline=false;
+	m_counterSource=NULL;
+	ProfileManager &manager=PROFILE_INSTANCE;
+	long id=siteId;
+	if(id==0)
+	{
+		id=manager.registerSite(fileName,functionName,lineNum);
+		InterlockedExchange(&siteId,id);
+	}
+	if(id<0)
+		return;
+	m_siteId=id;
+	m_stat=manager.getSiteStat(id);
+	m_stat->callCount++;
+	if(manager.m_isCallTreeEnabled)
+		m_treeNodeIdx=manager.enterTreeNode(id);
+	m_isTimeline=manager.m_timelineCapacity>0;
+	if(m_treeNodeIdx>=0 || m_isTimeline || (m_stat->callCount&manager.m_sampleMask)==0)
+	{
+		// the counters are read outside of the timed range, so reading them is not added to the time
+		m_counterSource=manager.m_counterSource;
+		if(m_counterSource)
+			m_counterSource->ReadCounters(m_startCounters);
+		m_startTick=Clock::GetTick();
+	}
+}
+
+ProfileSiteObj::~ProfileSiteObj()
+{
+	if(!m_startTick)
+		return;
+	__int64 endTick=Clock::GetTick();
+	if(m_counterSource)
+	{
+		unsigned __int64 endCounters[PROFILE_MAX_COUNTER_COUNT];
+		m_counterSource->ReadCounters(endCounters);
+		unsigned int counterCount=m_counterSource->GetCounterCount();
+		if(counterCount>PROFILE_MAX_COUNTER_COUNT)
+			counterCount=PROFILE_MAX_COUNTER_COUNT;
+		for(unsigned int counterTrav=0;counterTrav<counterCount;counterTrav++)
+			m_stat->counterTotals[counterTrav]+=static_cast<__int64>(endCounters[counterTrav]-m_startCounters[counterTrav]);
+		m_stat->counterSampleCount++;
+	}
+	m_stat->totalTick+=endTick-m_startTick;
+	m_stat->sampleCount++;
+	ProfileManager &manager=PROFILE_INSTANCE;
+	manager.getSiteHistogram(m_siteId)->Record(endTick-m_startTick);
+	if(m_treeNodeIdx>=0)
+		manager.leaveTreeNode(m_treeNodeIdx,endTick-m_startTick);
+	if(m_isTimeline)
+		manager.recordTimeline(m_siteId,m_startTick,endTick);
+}
+
 ProfileObj::ProfileObj(const TCHAR *uniqueName)
 {
 	m_profiler=Profiler(uniqueName);
@@ -25,6 +25,8 @@ THE SOFTWARE.
 */
 #include "epPropertiesFile.h"
 #include "epException.h"
+#include "epHashMap.h"
+#include "epStringView.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -37,6 +39,7 @@ using namespace epl;
 PropertiesFile::PropertiesFile(FileEncodingType encodingType, LockPolicy lockPolicyType):BaseTextFile(encodingType,lockPolicyType)
 {
 	m_nullString=_T("");
+	m_indexedCount=0;
 }
 
 PropertiesFile::PropertiesFile(const PropertiesFile& b):BaseTextFile(b)
@@ -44,6 +47,9 @@ PropertiesFile::PropertiesFile(const PropertiesFile& b):BaseTextFile(b)
 	m_nullString=_T("");
 	LockObj lock(b.m_baseTextLock);
 	m_propertyList=b.m_propertyList;
+	m_indexSlotList=b.m_indexSlotList;
+	m_indexHashList=b.m_indexHashList;
+	m_indexedCount=b.m_indexedCount;
 }
 
 PropertiesFile::~PropertiesFile()
@@ -57,6 +63,9 @@ PropertiesFile & PropertiesFile::operator=(const PropertiesFile&b)
 		m_nullString=_T("");
 		LockObj lock(b.m_baseTextLock);
 		m_propertyList=b.m_propertyList;
+		m_indexSlotList=b.m_indexSlotList;
+		m_indexHashList=b.m_indexHashList;
+		m_indexedCount=b.m_indexedCount;
 
 	}
 	return *this;
@@ -65,33 +74,23 @@ PropertiesFile & PropertiesFile::operator=(const PropertiesFile&b)
 bool PropertiesFile::SetProperty(const TCHAR *  key, const TCHAR * val)
 {
 	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			iter->second=Locale::Trim(val);
-			return true;
-		}
+		m_propertyList[propertyIdx].second=Locale::Trim(val);
+		return true;
 	}
 	return false;
 }
 
 bool PropertiesFile::GetProperty(const TCHAR * key,EpTString &retVal) const
 {
-	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::const_iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	SharedLockObj lock(m_baseTextLock);
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			retVal=iter->second;
-			return true;
-		}
+		retVal=m_propertyList[propertyIdx].second;
+		return true;
 	}
 	return false;
 }
@@ -99,15 +98,10 @@ bool PropertiesFile::GetProperty(const TCHAR * key,EpTString &retVal) const
 EpTString &PropertiesFile::GetProperty(const TCHAR * key)
 {
 	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			return iter->second;
-		}
+		return m_propertyList[propertyIdx].second;
 	}
 	EP_ASSERT_EXPR(0,_T("Given key does not exists in the list."));
 	return m_nullString;
@@ -115,16 +109,11 @@ EpTString &PropertiesFile::GetProperty(const TCHAR * key)
 
 const EpTString &PropertiesFile::GetProperty(const TCHAR * key) const
 {
-	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::const_iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	SharedLockObj lock(m_baseTextLock);
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			return iter->second;
-		}
+		return m_propertyList[propertyIdx].second;
 	}
 	EP_ASSERT_EXPR(0,_T("Given key does not exists in the list."));
 	return m_nullString;
@@ -133,36 +122,29 @@ const EpTString &PropertiesFile::GetProperty(const TCHAR * key) const
 bool PropertiesFile::AddProperty(const TCHAR * key, const TCHAR * val)
 {
 	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	if(findProperty(key)<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			return false;
-		}
+		return false;
 	}
 	Pair<EpTString,EpTString> insertPair;
-	insertPair.first=opKey;
+	insertPair.first=Locale::Trim(key);
+	insertPair.first.append(_T("="));
 	insertPair.second=Locale::Trim(val);
 	m_propertyList.push_back(insertPair);
+	indexProperty(m_propertyList.size()-1);
 	return true;
 }
 
 bool PropertiesFile::RemoveProperty(const TCHAR * key)
 {
 	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			m_propertyList.erase(iter);
-			return true;
-		}
+		m_propertyList.erase(m_propertyList.begin()+propertyIdx);
+		// the properties after the removed one are moved, and the duplicate key may be found now
+		rebuildIndex();
+		return true;
 	}
 	return false;
 }
@@ -171,6 +153,7 @@ void PropertiesFile::Clear()
 {
 	LockObj lock(m_baseTextLock);
 	m_propertyList.clear();
+	rebuildIndex();
 }
 void PropertiesFile::writeLoop()
 {
@@ -188,39 +171,101 @@ void PropertiesFile::writeLoop()
 EpTString& PropertiesFile::operator [](const TCHAR * key)
 {
 	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			return iter->second;
-		}
+		return m_propertyList[propertyIdx].second;
 	}
+	// the key is stored as the other properties, so it is found and written as "key=value"
 	Pair<EpTString,EpTString> insertPair;
-	insertPair.first=key;
+	insertPair.first=Locale::Trim(key);
+	insertPair.first.append(_T("="));
 	insertPair.second=_T("");
 	m_propertyList.push_back(insertPair);
+	indexProperty(m_propertyList.size()-1);
 	return m_propertyList.at(m_propertyList.size()-1).second;
 }
 
 const EpTString& PropertiesFile::operator [](const TCHAR * key) const
 {
-	LockObj lock(m_baseTextLock);
-	EpTString opKey=Locale::Trim(key);
-	opKey.append(_T("="));
-	vector<Pair<EpTString, EpTString> >::const_iterator iter;
-	for(iter=m_propertyList.begin();iter != m_propertyList.end();iter++)
+	SharedLockObj lock(m_baseTextLock);
+	size_t propertyIdx=findProperty(key);
+	if(propertyIdx<m_propertyList.size())
 	{
-		if(iter->first.compare(opKey)==0)
-		{
-			return iter->second;
-		}
+		return m_propertyList[propertyIdx].second;
 	}
 	EP_ASSERT(0);
 	return m_nullString;
 }
+
+void PropertiesFile::trimRange(const TCHAR *str, size_t strLength, const TCHAR *&retBegin, size_t &retLength)
+{
+	StringView trimmed=StringView(str,strLength).Trim();
+	retBegin=trimmed.GetString();
+	retLength=trimmed.GetLength();
+}
+
+size_t PropertiesFile::findProperty(const TCHAR *key) const
+{
+	if(m_indexSlotList.size()==0)
+		return m_propertyList.size();
+	const TCHAR *keyBegin;
+	size_t keyLength;
+	trimRange(key,_tcslen(key),keyBegin,keyLength);
+	size_t hash=HashBytes(keyBegin,keyLength*sizeof(TCHAR));
+	size_t mask=m_indexSlotList.size()-1;
+	for(size_t slotIdx=hash&mask;m_indexSlotList[slotIdx]!=0;slotIdx=(slotIdx+1)&mask)
+	{
+		if(m_indexHashList[slotIdx]!=hash)
+			continue;
+		const EpTString &propertyKey=m_propertyList[m_indexSlotList[slotIdx]-1].first;
+		// the key is stored with the '=' at the end
+		if(propertyKey.length()==keyLength+1 && propertyKey.compare(0,keyLength,keyBegin,keyLength)==0)
+			return m_indexSlotList[slotIdx]-1;
+	}
+	return m_propertyList.size();
+}
+
+void PropertiesFile::indexProperty(size_t propertyIdx)
+{
+	const EpTString &propertyKey=m_propertyList[propertyIdx].first;
+	if(propertyKey.length()==0 || propertyKey.at(propertyKey.length()-1)!=_T('='))
+		return;
+	if((m_indexedCount+1)*2>m_indexSlotList.size())
+	{
+		// grow to keep the index at most half full
+		size_t slotCount=16;
+		while(slotCount<(m_indexedCount+1)*4)
+			slotCount<<=1;
+		m_indexSlotList.assign(slotCount,0);
+		m_indexHashList.assign(slotCount,0);
+		m_indexedCount=0;
+		for(size_t propertyTrav=0;propertyTrav<propertyIdx;propertyTrav++)
+			indexProperty(propertyTrav);
+	}
+	size_t keyLength=propertyKey.length()-1;
+	size_t hash=HashBytes(propertyKey.c_str(),keyLength*sizeof(TCHAR));
+	size_t mask=m_indexSlotList.size()-1;
+	size_t slotIdx;
+	for(slotIdx=hash&mask;m_indexSlotList[slotIdx]!=0;slotIdx=(slotIdx+1)&mask)
+	{
+		if(m_indexHashList[slotIdx]==hash && m_propertyList[m_indexSlotList[slotIdx]-1].first.compare(propertyKey)==0)
+			return;
+	}
+	m_indexSlotList[slotIdx]=propertyIdx+1;
+	m_indexHashList[slotIdx]=hash;
+	m_indexedCount++;
+}
+
+void PropertiesFile::rebuildIndex()
+{
+	m_indexSlotList.clear();
+	m_indexHashList.clear();
+	m_indexedCount=0;
+	for(size_t propertyTrav=0;propertyTrav<m_propertyList.size();propertyTrav++)
+		indexProperty(propertyTrav);
+}
+
 void PropertiesFile::loadFromFile(const EpTString &lines)
 {
 	m_propertyList.clear();
@@ -228,49 +273,48 @@ void PropertiesFile::loadFromFile(const EpTString &lines)
 	size_t skipIdx=0;
 	while(BaseTextFile::GetLine(lines,skipIdx,line,&skipIdx))
 	{
-		EpTString key;
-		EpTString val;
-		if(getValueKeyFromLine(line,key,val))
-		{
-			Pair<EpTString,EpTString> inputPair;
-			inputPair.first=Locale::Trim(key);
-			inputPair.second=Locale::Trim(val);
-			m_propertyList.push_back(inputPair);
-		}
-		else
-		{
-			Pair<EpTString,EpTString> inputPair;
-			inputPair.first=Locale::Trim(line);
-			inputPair.second=_T("");
-			m_propertyList.push_back(inputPair);
-		}
+		addPropertyLine(line.c_str(),line.length());
 	}
-	
+	rebuildIndex();
 }
 
 
-bool PropertiesFile::getValueKeyFromLine(const EpTString &buf, EpTString &retKey, EpTString &retVal)
+void PropertiesFile::loadFromReader(TextLineReader &reader)
 {
-	TCHAR splitChar=0;
-	int bufTrav=0;
-	if(buf.length()<=0)
-		return false;
-
-	retKey=_T("");
-	retVal=_T("");
+	m_propertyList.clear();
+	const TCHAR *line;
+	size_t lineLength;
+	while(reader.ReadLine(line,lineLength))
+	{
+		addPropertyLine(line,lineLength);
+	}
+	rebuildIndex();
+}
 
-	EpTString trimmedBuf=Locale::Trim(buf);
-	if(trimmedBuf.at(0)==_T('#'))
-		return false;
-	
-	while(splitChar!=_T('=') && bufTrav<trimmedBuf.length())
+void PropertiesFile::addPropertyLine(const TCHAR *line, size_t lineLength)
+{
+	// the key is the trimmed line up to and including the first '=', and the value is the rest trimmed
+	const TCHAR *trimmedLine;
+	size_t trimmedLength;
+	trimRange(line,lineLength,trimmedLine,trimmedLength);
+	Pair<EpTString,EpTString> inputPair;
+	if(trimmedLength==0 || trimmedLine[0]==_T('#'))
 	{
-		splitChar=trimmedBuf.at(bufTrav);
-		retKey.append(&splitChar,1);
-		bufTrav++;
+		inputPair.first.assign(trimmedLine,trimmedLength);
+		m_propertyList.push_back(inputPair);
+		return;
 	}
-	retVal=trimmedBuf;
-	retVal.erase(0,bufTrav);
-	
-	return true;
+	size_t keyLength=0;
+	while(keyLength<trimmedLength && trimmedLine[keyLength]!=_T('='))
+		keyLength++;
+	if(keyLength<trimmedLength)
+		keyLength++;
+	// the key starts and ends with the printable characters already
+	inputPair.first.assign(trimmedLine,keyLength);
+	const TCHAR *val;
+	size_t valLength;
+	trimRange(trimmedLine+keyLength,trimmedLength-keyLength,val,valLength);
+	inputPair.second.assign(val,valLength);
+	m_propertyList.push_back(inputPair);
 }
+
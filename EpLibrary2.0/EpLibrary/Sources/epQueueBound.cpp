@@ -0,0 +1,151 @@
+/*! 
+QueueBound for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epQueueBound.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+QueueBound::QueueBound()
+{
+	m_capacity=0;
+	m_overflowPolicy=OVERFLOW_POLICY_BLOCK;
+	m_highWaterMark=0;
+	m_dropCount=0;
+	m_notFullEvent=NULL;
+	m_waiterCount=0;
+}
+
+QueueBound::QueueBound(const QueueBound& b)
+{
+	m_capacity=b.m_capacity;
+	m_overflowPolicy=b.m_overflowPolicy;
+	m_highWaterMark=0;
+	m_dropCount=0;
+	m_notFullEvent=NULL;
+	m_waiterCount=0;
+}
+
+QueueBound::~QueueBound()
+{
+	if(m_notFullEvent)
+		EP_DELETE m_notFullEvent;
+}
+
+QueueBound & QueueBound::operator=(const QueueBound&b)
+{
+	if(this!=&b)
+	{
+		SetCapacity(b.m_capacity,b.m_overflowPolicy);
+	}
+	return *this;
+}
+
+void QueueBound::SetCapacity(size_t capacity, OverflowPolicy policy)
+{
+	m_capacity=capacity;
+	m_overflowPolicy=policy;
+	if(m_notFullEvent)
+		m_notFullEvent->SetEvent();
+}
+
+size_t QueueBound::GetCapacity() const
+{
+	return m_capacity;
+}
+
+OverflowPolicy QueueBound::GetOverflowPolicy() const
+{
+	return m_overflowPolicy;
+}
+
+size_t QueueBound::GetHighWaterMark() const
+{
+	long highWaterMark=m_highWaterMark;
+	return static_cast<size_t>(highWaterMark);
+}
+
+void QueueBound::ResetHighWaterMark()
+{
+	InterlockedExchange(&m_highWaterMark,0);
+}
+
+size_t QueueBound::GetDropCount() const
+{
+	long dropCount=m_dropCount;
+	return static_cast<size_t>(dropCount);
+}
+
+QueueBound::Admission QueueBound::Admit(size_t curSize)
+{
+	size_t capacity=m_capacity;
+	if(capacity==0 || curSize<capacity)
+		return ADMISSION_ACCEPT;
+	switch(m_overflowPolicy)
+	{
+	case OVERFLOW_POLICY_BLOCK:
+		return ADMISSION_WAIT;
+	case OVERFLOW_POLICY_FAIL:
+		InterlockedIncrement(&m_dropCount);
+		return ADMISSION_REJECT;
+	case OVERFLOW_POLICY_DROP_OLDEST:
+		InterlockedIncrement(&m_dropCount);
+		return ADMISSION_DROP_OLDEST;
+	default:
+		InterlockedIncrement(&m_dropCount);
+		return ADMISSION_DROP_NEWEST;
+	}
+}
+
+void QueueBound::WaitNotFull(BaseLock *lock)
+{
+	if(!m_notFullEvent)
+		m_notFullEvent=EP_NEW EventEx(false,true);
+	// reset under the owner lock, so any removal after this point raises it again
+	m_notFullEvent->ResetEvent();
+	m_waiterCount++;
+	lock->Unlock();
+	m_notFullEvent->WaitForEvent();
+	lock->Lock();
+	m_waiterCount--;
+}
+
+void QueueBound::NotifyPushed(size_t newSize)
+{
+	if(static_cast<long>(newSize)>m_highWaterMark)
+		InterlockedExchange(&m_highWaterMark,static_cast<long>(newSize));
+}
+
+void QueueBound::NotifyPopped()
+{
+	// skip the kernel call when no producer sleeps, which is the common case
+	if(m_waiterCount>0)
+		m_notFullEvent->SetEvent();
+}
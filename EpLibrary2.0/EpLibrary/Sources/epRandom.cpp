@@ -29,6 +29,12 @@ THE SOFTWARE.
 #include "epSystem.h"
 #include "epException.h"
 
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_RANDOM_SSE2
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
 #undef THIS_FILE
@@ -37,20 +43,378 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+/// the jump polynomial of xoshiro256** for 2^128 steps
+static const unsigned __int64 s_xoshiroJumpTable[4]={0x180EC6D33CFD0ABAULL,0xD5A61266F0C9392CULL,0xA9582618E03FC9AAULL,0x39ABDC4529B1661CULL};
+/// the jump polynomial of xoshiro256** for 2^192 steps
+static const unsigned __int64 s_xoshiroLongJumpTable[4]={0x76E15D3EFEFDCBBFULL,0xC5004E441C522FB3ULL,0x77710069854EE241ULL,0x39109BB02ACBE635ULL};
+/// the high 64 bits of the PCG64 multiplier
+static const unsigned __int64 s_pcgMultiplierHigh=0x2360ED051FC65DA4ULL;
+/// the low 64 bits of the PCG64 multiplier
+static const unsigned __int64 s_pcgMultiplierLow=0x4385DF649FCCF645ULL;
+
+/*!
+Rotate the given value left
+@param[in] value the value to rotate
+@param[in] shift the number of bits to rotate
+@return the rotated value
+*/
+static inline unsigned __int64 rotateLeft(unsigned __int64 value, int shift)
+{
+	return (value<<shift)|(value>>(64-shift));
+}
+
+/*!
+Return the next value of the SplitMix64 sequence, to expand the seed
+@param[in,out] state the state of the sequence
+@return the next value
+*/
+static unsigned __int64 splitMix64(unsigned __int64 &state)
+{
+	unsigned __int64 value=(state+=0x9E3779B97F4A7C15ULL);
+	value=(value^(value>>30))*0xBF58476D1CE4E5B9ULL;
+	value=(value^(value>>27))*0x94D049BB133111EBULL;
+	return value^(value>>31);
+}
+
+/*!
+Multiply the given 64-bit values into the 128-bit value
+@param[in] a the first value
+@param[in] b the second value
+@param[out] retHigh the high 64 bits of the product
+@return the low 64 bits of the product
+*/
+static inline unsigned __int64 multiply128(unsigned __int64 a, unsigned __int64 b, unsigned __int64 &retHigh)
+{
+#if _MSC_VER>=MSVC90 && defined(_M_X64)
+	return _umul128(a,b,&retHigh);
+#else //_MSC_VER>=MSVC90 && defined(_M_X64)
+	unsigned __int64 aLow=a&0xFFFFFFFF, aHigh=a>>32;
+	unsigned __int64 bLow=b&0xFFFFFFFF, bHigh=b>>32;
+	unsigned __int64 lowLow=aLow*bLow;
+	unsigned __int64 highLow=aHigh*bLow;
+	unsigned __int64 cross=(lowLow>>32)+(highLow&0xFFFFFFFF)+aLow*bHigh;
+	retHigh=aHigh*bHigh+(highLow>>32)+(cross>>32);
+	return (cross<<32)|(lowLow&0xFFFFFFFF);
+#endif //_MSC_VER>=MSVC90 && defined(_M_X64)
+}
+
+/*!
+Compute a*b+c of the 128-bit values modulo 2^128
+@param[in] aHigh the high 64 bits of a
+@param[in] aLow the low 64 bits of a
+@param[in] bHigh the high 64 bits of b
+@param[in] bLow the low 64 bits of b
+@param[in] cHigh the high 64 bits of c
+@param[in] cLow the low 64 bits of c
+@param[out] retHigh the high 64 bits of the result
+@param[out] retLow the low 64 bits of the result
+*/
+static inline void multiplyAdd128(unsigned __int64 aHigh, unsigned __int64 aLow, unsigned __int64 bHigh, unsigned __int64 bLow, unsigned __int64 cHigh, unsigned __int64 cLow, unsigned __int64 &retHigh, unsigned __int64 &retLow)
+{
+	unsigned __int64 high;
+	unsigned __int64 low=multiply128(aLow,bLow,high);
+	high+=aHigh*bLow+aLow*bHigh;
+	retLow=low+cLow;
+	retHigh=high+cHigh+(retLow<low?1:0);
+}
+
+/*!
+Return the random number less than the given range without bias, by Lemire's multiply-and-reject method
+@param[in] engine the engine to draw from
+@param[in] range the number of the possible values
+@return the random number in [0, range), or 0 if the range is 0
+*/
+template<typename EngineType>
+static unsigned int boundedRandom(EngineType &engine, unsigned int range)
+{
+	if(range==0)
+		return 0;
+	unsigned __int64 product=static_cast<unsigned __int64>(engine.NextUInt())*range;
+	unsigned int low=static_cast<unsigned int>(product);
+	if(low<range)
+	{
+		// only the low values below 2^32 mod range are biased
+		unsigned int threshold=(0u-range)%range;
+		while(low<threshold)
+		{
+			product=static_cast<unsigned __int64>(engine.NextUInt())*range;
+			low=static_cast<unsigned int>(product);
+		}
+	}
+	return static_cast<unsigned int>(product>>32);
+}
+
+/*!
+Convert the given 64-bit random number to [0, 1)
+@param[in] value the random number
+@return the number in [0, 1)
+*/
+static inline double toUnitDouble(unsigned __int64 value)
+{
+	return static_cast<double>(value>>11)*(1.0/9007199254740992.0);
+}
+
+#if defined(EP_RANDOM_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
+{
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
+}
+
+/*!
+Rotate the 64-bit lanes of the given vector left
+@param[in] value the vector to rotate
+@param[in] shift the number of bits to rotate
+@return the rotated vector
+*/
+#define rotateLeftSSE2(value,shift) _mm_or_si128(_mm_slli_epi64(value,shift),_mm_srli_epi64(value,64-(shift)))
+#endif //defined(EP_RANDOM_SSE2)
+
+Xoshiro256Engine::Xoshiro256Engine(unsigned __int64 seed)
+{
+	Seed(seed);
+}
+
+void Xoshiro256Engine::Seed(unsigned __int64 seed)
+{
+	for(int stateTrav=0;stateTrav<4;stateTrav++)
+		m_state[stateTrav]=splitMix64(seed);
+}
+
+unsigned __int64 Xoshiro256Engine::Next()
+{
+	unsigned __int64 result=rotateLeft(m_state[1]*5,7)*9;
+	unsigned __int64 temp=m_state[1]<<17;
+	m_state[2]^=m_state[0];
+	m_state[3]^=m_state[1];
+	m_state[1]^=m_state[2];
+	m_state[0]^=m_state[3];
+	m_state[2]^=temp;
+	m_state[3]=rotateLeft(m_state[3],45);
+	return result;
+}
+
+unsigned int Xoshiro256Engine::NextUInt()
+{
+	return static_cast<unsigned int>(Next()>>32);
+}
+
+unsigned int Xoshiro256Engine::NextBounded(unsigned int range)
+{
+	return boundedRandom(*this,range);
+}
+
+double Xoshiro256Engine::NextDouble()
+{
+	return toUnitDouble(Next());
+}
+
+void Xoshiro256Engine::Jump()
+{
+	jump(s_xoshiroJumpTable);
+}
+
+void Xoshiro256Engine::LongJump()
+{
+	jump(s_xoshiroLongJumpTable);
+}
+
+void Xoshiro256Engine::jump(const unsigned __int64 *jumpTable)
+{
+	unsigned __int64 newState[4]={0,0,0,0};
+	for(int tableTrav=0;tableTrav<4;tableTrav++)
+	{
+		for(int bitTrav=0;bitTrav<64;bitTrav++)
+		{
+			if(jumpTable[tableTrav]&(1ULL<<bitTrav))
+			{
+				for(int stateTrav=0;stateTrav<4;stateTrav++)
+					newState[stateTrav]^=m_state[stateTrav];
+			}
+			Next();
+		}
+	}
+	for(int stateTrav=0;stateTrav<4;stateTrav++)
+		m_state[stateTrav]=newState[stateTrav];
+}
+
+void Xoshiro256Engine::Fill(unsigned __int64 *retBuffer, size_t count)
+{
+	size_t fillTrav=0;
+	if(count>=2)
+	{
+		// the odd numbers come from the stream 2^128 ahead, which continues where the previous fill left it
+		Xoshiro256Engine jumped(*this);
+		jumped.Jump();
+#if defined(EP_RANDOM_SSE2)
+		if(hasSSE2())
+		{
+			__m128i state0=_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m_state[0])),_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&jumped.m_state[0])));
+			__m128i state1=_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m_state[1])),_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&jumped.m_state[1])));
+			__m128i state2=_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m_state[2])),_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&jumped.m_state[2])));
+			__m128i state3=_mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&m_state[3])),_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&jumped.m_state[3])));
+			for(;fillTrav+2<=count;fillTrav+=2)
+			{
+				// SSE2 has no 64-bit multiply, so x*5 and x*9 are done by shift and add
+				__m128i times5=_mm_add_epi64(_mm_slli_epi64(state1,2),state1);
+				__m128i rotated=rotateLeftSSE2(times5,7);
+				__m128i result=_mm_add_epi64(_mm_slli_epi64(rotated,3),rotated);
+				__m128i temp=_mm_slli_epi64(state1,17);
+				state2=_mm_xor_si128(state2,state0);
+				state3=_mm_xor_si128(state3,state1);
+				state1=_mm_xor_si128(state1,state2);
+				state0=_mm_xor_si128(state0,state3);
+				state2=_mm_xor_si128(state2,temp);
+				state3=rotateLeftSSE2(state3,45);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(retBuffer+fillTrav),result);
+			}
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(&m_state[0]),state0);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(&m_state[1]),state1);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(&m_state[2]),state2);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(&m_state[3]),state3);
+		}
+#endif //defined(EP_RANDOM_SSE2)
+		for(;fillTrav+2<=count;fillTrav+=2)
+		{
+			retBuffer[fillTrav]=Next();
+			retBuffer[fillTrav+1]=jumped.Next();
+		}
+	}
+	for(;fillTrav<count;fillTrav++)
+		retBuffer[fillTrav]=Next();
+}
+
+Pcg64Engine::Pcg64Engine(unsigned __int64 seed, unsigned __int64 stream)
+{
+	Seed(seed,stream);
+}
+
+void Pcg64Engine::Seed(unsigned __int64 seed, unsigned __int64 stream)
+{
+	// the increment must be odd
+	m_incHigh=stream>>63;
+	m_incLow=(stream<<1)|1;
+	m_stateHigh=0;
+	m_stateLow=0;
+	Next();
+	unsigned __int64 oldLow=m_stateLow;
+	m_stateLow+=seed;
+	m_stateHigh+=(m_stateLow<oldLow?1:0);
+	Next();
+}
+
+unsigned __int64 Pcg64Engine::Next()
+{
+	multiplyAdd128(m_stateHigh,m_stateLow,s_pcgMultiplierHigh,s_pcgMultiplierLow,m_incHigh,m_incLow,m_stateHigh,m_stateLow);
+	unsigned __int64 value=m_stateHigh^m_stateLow;
+	int shift=static_cast<int>(m_stateHigh>>58);
+	return (value>>shift)|(value<<((64-shift)&63));
+}
+
+unsigned int Pcg64Engine::NextUInt()
+{
+	return static_cast<unsigned int>(Next()>>32);
+}
+
+unsigned int Pcg64Engine::NextBounded(unsigned int range)
+{
+	return boundedRandom(*this,range);
+}
+
+double Pcg64Engine::NextDouble()
+{
+	return toUnitDouble(Next());
+}
+
+void Pcg64Engine::Advance(unsigned __int64 delta)
+{
+	// Brown's algorithm: builds the multiplier and increment of delta steps by squaring
+	unsigned __int64 accMultHigh=0, accMultLow=1;
+	unsigned __int64 accPlusHigh=0, accPlusLow=0;
+	unsigned __int64 curMultHigh=s_pcgMultiplierHigh, curMultLow=s_pcgMultiplierLow;
+	unsigned __int64 curPlusHigh=m_incHigh, curPlusLow=m_incLow;
+	while(delta>0)
+	{
+		if(delta&1)
+		{
+			multiplyAdd128(accMultHigh,accMultLow,curMultHigh,curMultLow,0,0,accMultHigh,accMultLow);
+			multiplyAdd128(accPlusHigh,accPlusLow,curMultHigh,curMultLow,curPlusHigh,curPlusLow,accPlusHigh,accPlusLow);
+		}
+		unsigned __int64 multPlusOneLow=curMultLow+1;
+		unsigned __int64 multPlusOneHigh=curMultHigh+(multPlusOneLow==0?1:0);
+		multiplyAdd128(multPlusOneHigh,multPlusOneLow,curPlusHigh,curPlusLow,0,0,curPlusHigh,curPlusLow);
+		multiplyAdd128(curMultHigh,curMultLow,curMultHigh,curMultLow,0,0,curMultHigh,curMultLow);
+		delta>>=1;
+	}
+	multiplyAdd128(accMultHigh,accMultLow,m_stateHigh,m_stateLow,accPlusHigh,accPlusLow,m_stateHigh,m_stateLow);
+}
+
+void Pcg64Engine::Fill(unsigned __int64 *retBuffer, size_t count)
+{
+	for(size_t fillTrav=0;fillTrav<count;fillTrav++)
+		retBuffer[fillTrav]=Next();
+}
+
 int Random::GetRandom()
 {
-	return rand();
+	return static_cast<int>(GetThreadEngine().Next()>>33);
 }
 int Random::GetRandom(int startNum, int endNum)
 {
 	EP_ASSERT(endNum>=startNum);
-	return rand()%(endNum-startNum+1)+startNum;
+	// the range of 0 means the whole 32-bit range
+	unsigned int range=static_cast<unsigned int>(endNum)-static_cast<unsigned int>(startNum)+1;
+	Xoshiro256Engine &engine=GetThreadEngine();
+	unsigned int offset=range?engine.NextBounded(range):engine.NextUInt();
+	return static_cast<int>(static_cast<unsigned int>(startNum)+offset);
+}
+double Random::GetRandomDouble()
+{
+	return GetThreadEngine().NextDouble();
+}
+void Random::Fill(unsigned __int64 *retBuffer, size_t count)
+{
+	GetThreadEngine().Fill(retBuffer,count);
+}
+Xoshiro256Engine &Random::GetThreadEngine()
+{
+	Xoshiro256Engine *engine=reinterpret_cast<Xoshiro256Engine*>(TlsGetValue(m_tlsIndex));
+	if(engine)
+		return *engine;
+
+	LockObj lock(&m_engineLock);
+	engine=EP_NEW Xoshiro256Engine(m_baseEngine);
+	// the next thread starts 2^128 numbers later, so the streams never overlap
+	m_baseEngine.Jump();
+	m_engineList.push_back(engine);
+	TlsSetValue(m_tlsIndex,engine);
+	return *engine;
 }
 Random::Random()
 {
- srand(time(NULL));
+	m_baseEngine.Seed(static_cast<unsigned __int64>(time(NULL))^(static_cast<unsigned __int64>(System::GetTickCount())<<32));
+	m_tlsIndex=TlsAlloc();
+	EP_ASSERT_EXPR(m_tlsIndex!=TLS_OUT_OF_INDEXES,_T("Failed to allocate the TLS index!"));
 }
 Random::~Random()
 {
-
-}
\ No newline at end of file
+	if(m_tlsIndex!=TLS_OUT_OF_INDEXES)
+		TlsFree(m_tlsIndex);
+	for(size_t engineTrav=0;engineTrav<m_engineList.size();engineTrav++)
+		EP_DELETE m_engineList[engineTrav];
+	m_engineList.clear();
+}
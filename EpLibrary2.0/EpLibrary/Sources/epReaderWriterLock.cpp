@@ -0,0 +1,216 @@
+/*! 
+ReaderWriterLock for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epReaderWriterLock.h"
+#include "epException.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+typedef void (WINAPI *LPFN_SRWLOCKFUNC)(PVOID *);
+typedef BOOLEAN (WINAPI *LPFN_TRYSRWLOCKFUNC)(PVOID *);
+
+static LPFN_SRWLOCKFUNC s_fnAcquireSRWLockExclusive=NULL;
+static LPFN_SRWLOCKFUNC s_fnReleaseSRWLockExclusive=NULL;
+static LPFN_SRWLOCKFUNC s_fnAcquireSRWLockShared=NULL;
+static LPFN_SRWLOCKFUNC s_fnReleaseSRWLockShared=NULL;
+static LPFN_TRYSRWLOCKFUNC s_fnTryAcquireSRWLockExclusive=NULL;
+static LPFN_TRYSRWLOCKFUNC s_fnTryAcquireSRWLockShared=NULL;
+static volatile long s_isSRWLockResolved=0;
+
+static void resolveSRWLock()
+{
+	if(s_isSRWLockResolved)
+		return;
+	//TryAcquireSRWLockExclusive and TryAcquireSRWLockShared are not available before Windows 7.
+	HMODULE kernel32=GetModuleHandle(TEXT("kernel32"));
+	LPFN_SRWLOCKFUNC fnAcquireExclusive=(LPFN_SRWLOCKFUNC)GetProcAddress(kernel32,"AcquireSRWLockExclusive");
+	LPFN_SRWLOCKFUNC fnReleaseExclusive=(LPFN_SRWLOCKFUNC)GetProcAddress(kernel32,"ReleaseSRWLockExclusive");
+	LPFN_SRWLOCKFUNC fnAcquireShared=(LPFN_SRWLOCKFUNC)GetProcAddress(kernel32,"AcquireSRWLockShared");
+	LPFN_SRWLOCKFUNC fnReleaseShared=(LPFN_SRWLOCKFUNC)GetProcAddress(kernel32,"ReleaseSRWLockShared");
+	LPFN_TRYSRWLOCKFUNC fnTryExclusive=(LPFN_TRYSRWLOCKFUNC)GetProcAddress(kernel32,"TryAcquireSRWLockExclusive");
+	LPFN_TRYSRWLOCKFUNC fnTryShared=(LPFN_TRYSRWLOCKFUNC)GetProcAddress(kernel32,"TryAcquireSRWLockShared");
+	// use SRWLOCK only if all functions are available, so every lock uses the same method
+	if(fnAcquireExclusive && fnReleaseExclusive && fnAcquireShared && fnReleaseShared && fnTryExclusive && fnTryShared)
+	{
+		s_fnAcquireSRWLockExclusive=fnAcquireExclusive;
+		s_fnReleaseSRWLockExclusive=fnReleaseExclusive;
+		s_fnAcquireSRWLockShared=fnAcquireShared;
+		s_fnReleaseSRWLockShared=fnReleaseShared;
+		s_fnTryAcquireSRWLockExclusive=fnTryExclusive;
+		s_fnTryAcquireSRWLockShared=fnTryShared;
+	}
+	InterlockedExchange(&s_isSRWLockResolved,1);
+}
+
+bool ReaderWriterLock::IsSharedSupported()
+{
+	resolveSRWLock();
+	return s_fnAcquireSRWLockShared!=NULL;
+}
+
+ReaderWriterLock::ReaderWriterLock() :BaseLock()
+{
+	resolveSRWLock();
+	m_srwLock=NULL;
+	if(!s_fnAcquireSRWLockExclusive)
+		InitializeCriticalSection(&m_criticalSection);
+	m_ownerThreadId=0;
+	m_lockCounter=0;
+	m_sharedCounter=0;
+}
+
+ReaderWriterLock::ReaderWriterLock(const ReaderWriterLock& b) :BaseLock()
+{
+	resolveSRWLock();
+	m_srwLock=NULL;
+	if(!s_fnAcquireSRWLockExclusive)
+		InitializeCriticalSection(&m_criticalSection);
+	m_ownerThreadId=0;
+	m_lockCounter=0;
+	m_sharedCounter=0;
+}
+
+ReaderWriterLock::~ReaderWriterLock()
+{
+	EP_ASSERT_EXPR(m_lockCounter==0,_T("Lock Counter is not 0!"));
+	EP_ASSERT_EXPR(m_sharedCounter==0,_T("Shared Lock Counter is not 0!"));
+	if(!s_fnAcquireSRWLockExclusive)
+		DeleteCriticalSection(&m_criticalSection);
+}
+
+ReaderWriterLock & ReaderWriterLock::operator=(const ReaderWriterLock&b)
+{
+	if(this!=&b)
+	{
+		EP_ASSERT_EXPR(m_lockCounter==0,_T("Lock Counter is not 0!"));
+		EP_ASSERT_EXPR(m_sharedCounter==0,_T("Shared Lock Counter is not 0!"));
+	}
+	return *this;
+}
+
+bool ReaderWriterLock::Lock()
+{
+	DWORD threadId=GetCurrentThreadId();
+	if(m_ownerThreadId==threadId)
+	{
+		m_lockCounter++;
+		return true;
+	}
+	if(s_fnAcquireSRWLockExclusive)
+		s_fnAcquireSRWLockExclusive(&m_srwLock);
+	else
+		EnterCriticalSection(&m_criticalSection);
+	m_ownerThreadId=threadId;
+	m_lockCounter=1;
+	return true;
+}
+
+long ReaderWriterLock::TryLock()
+{
+	DWORD threadId=GetCurrentThreadId();
+	if(m_ownerThreadId==threadId)
+	{
+		m_lockCounter++;
+		return 1;
+	}
+	long ret;
+	if(s_fnTryAcquireSRWLockExclusive)
+		ret=s_fnTryAcquireSRWLockExclusive(&m_srwLock)?1:0;
+	else
+		ret=TryEnterCriticalSection(&m_criticalSection)?1:0;
+	if(ret)
+	{
+		m_ownerThreadId=threadId;
+		m_lockCounter=1;
+	}
+	return ret;
+}
+
+long ReaderWriterLock::TryLockFor(const unsigned int dwMilliSecond)
+{
+	if(TryLock())
+		return 1;
+	// SRWLOCK has no timed wait, so poll until the time-out
+	unsigned int startTick=System::GetTickCount();
+	while(dwMilliSecond==WAITTIME_INIFINITE || System::GetTickCount()-startTick<dwMilliSecond)
+	{
+		Sleep(1);
+		if(TryLock())
+			return 1;
+	}
+	return 0;
+}
+
+void ReaderWriterLock::Unlock()
+{
+	EP_ASSERT_EXPR(m_ownerThreadId==GetCurrentThreadId(),_T("Unlocked by the thread not owning the lock!"));
+	m_lockCounter--;
+	EP_ASSERT_EXPR(m_lockCounter>=0,_T("Lock Counter is less than 0!"));
+	if(m_lockCounter>0)
+		return;
+	m_ownerThreadId=0;
+	if(s_fnReleaseSRWLockExclusive)
+		s_fnReleaseSRWLockExclusive(&m_srwLock);
+	else
+		LeaveCriticalSection(&m_criticalSection);
+}
+
+bool ReaderWriterLock::LockShared()
+{
+	// the exclusive owner already excludes the writers
+	if(!s_fnAcquireSRWLockShared || m_ownerThreadId==GetCurrentThreadId())
+		return Lock();
+	s_fnAcquireSRWLockShared(&m_srwLock);
+	InterlockedIncrement(&m_sharedCounter);
+	return true;
+}
+
+long ReaderWriterLock::TryLockShared()
+{
+	if(!s_fnTryAcquireSRWLockShared || m_ownerThreadId==GetCurrentThreadId())
+		return TryLock();
+	if(!s_fnTryAcquireSRWLockShared(&m_srwLock))
+		return 0;
+	InterlockedIncrement(&m_sharedCounter);
+	return 1;
+}
+
+void ReaderWriterLock::UnlockShared()
+{
+	if(!s_fnReleaseSRWLockShared || m_ownerThreadId==GetCurrentThreadId())
+	{
+		Unlock();
+		return;
+	}
+	long sharedCounter=InterlockedDecrement(&m_sharedCounter);
+	EP_ASSERT_EXPR(sharedCounter>=0,_T("Shared Lock Counter is less than 0!"));
+	s_fnReleaseSRWLockShared(&m_srwLock);
+}
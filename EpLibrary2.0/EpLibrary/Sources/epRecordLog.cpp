@@ -0,0 +1,605 @@
+/*! 
+RecordLog for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epRecordLog.h"
+#include "epCrc32c.h"
+#include "epSystem.h"
+#include "epSimpleLogger.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the length written in place of the record length to mark the sync marker
+#define RECORD_LOG_MARKER_LENGTH 0xFFFFFFFF
+
+/// the byte size read from the file at once while scanning
+#define RECORD_LOG_READ_SIZE 65536
+
+namespace epl
+{
+	/*!
+	@class RecordLogScanner epRecordLog.cpp
+	@brief A class for reading the record log file through the window of the file.
+	*/
+	class RecordLogScanner
+	{
+	public:
+		/*!
+		Default Constructor
+
+		Initializes the scanner
+		@param[in] fileHandle the handle of the record log file.
+		@param[in] fileSize the byte size of the file.
+		*/
+		RecordLogScanner(HANDLE fileHandle, unsigned __int64 fileSize)
+		{
+			m_fileHandle=fileHandle;
+			m_fileSize=fileSize;
+			m_windowBase=0;
+		}
+
+		/*!
+		Return the byte size of the file.
+		@return the byte size of the file.
+		*/
+		unsigned __int64 GetFileSize() const
+		{
+			return m_fileSize;
+		}
+
+		/*!
+		Return the data of the file at given offset.
+		@param[in] offset the offset within the file.
+		@param[in] byteSize the byte size of the data, which must not be 0.
+		@return the data within the window, or NULL if out of the file or failed to read.
+		@remark the returned data is valid until the next Fetch.
+		*/
+		const unsigned char *Fetch(unsigned __int64 offset, size_t byteSize)
+		{
+			if(offset>m_fileSize || byteSize>m_fileSize-offset)
+				return NULL;
+			if(offset>=m_windowBase && offset+byteSize<=m_windowBase+m_window.size())
+				return &m_window[0]+static_cast<size_t>(offset-m_windowBase);
+
+			size_t readSize=byteSize;
+			if(readSize<RECORD_LOG_READ_SIZE)
+				readSize=static_cast<size_t>(m_fileSize-offset<RECORD_LOG_READ_SIZE?m_fileSize-offset:RECORD_LOG_READ_SIZE);
+			m_window.resize(readSize);
+			m_windowBase=offset;
+			LARGE_INTEGER position;
+			position.QuadPart=static_cast<LONGLONG>(offset);
+			if(!SetFilePointerEx(m_fileHandle,position,NULL,FILE_BEGIN))
+			{
+				m_window.clear();
+				return NULL;
+			}
+			size_t readTotal=0;
+			while(readTotal<readSize)
+			{
+				DWORD readByte=0;
+				if(!ReadFile(m_fileHandle,&m_window[readTotal],static_cast<DWORD>(readSize-readTotal),&readByte,NULL) || readByte==0)
+				{
+					m_window.clear();
+					return NULL;
+				}
+				readTotal+=readByte;
+			}
+			return &m_window[0];
+		}
+
+		/*!
+		Read the record or the sync marker at given offset.
+		@param[in] offset the offset of the record within the file.
+		@param[out] retNextOffset the offset right after the record.
+		@param[out] retIsMarker set to true if the sync marker is read instead of the record.
+		@param[out] retRecord the record within the window.
+		@param[out] retByteSize the byte size of the record.
+		@return true if the valid record or sync marker is read, otherwise false.
+		*/
+		bool ReadRecord(unsigned __int64 offset, unsigned __int64 &retNextOffset, bool &retIsMarker, const unsigned char *&retRecord, unsigned int &retByteSize)
+		{
+			const unsigned char *header=Fetch(offset,RECORD_LOG_HEADER_SIZE);
+			if(!header)
+				return false;
+			unsigned int length=0;
+			unsigned int crc=0;
+			System::Memcpy(&length,header,sizeof(unsigned int));
+			System::Memcpy(&crc,header+sizeof(unsigned int),sizeof(unsigned int));
+			if(length==RECORD_LOG_MARKER_LENGTH)
+			{
+				const unsigned char *marker=Fetch(offset,RECORD_LOG_MARKER_SIZE);
+				if(!marker || !IsMarker(marker,offset))
+					return false;
+				retNextOffset=offset+RECORD_LOG_MARKER_SIZE;
+				retIsMarker=true;
+				return true;
+			}
+			if(length>RECORD_LOG_MAX_RECORD_SIZE)
+				return false;
+
+			const unsigned char *record=Fetch(offset,RECORD_LOG_HEADER_SIZE+length);
+			if(!record)
+				return false;
+			record+=RECORD_LOG_HEADER_SIZE;
+			if(Crc32c::Compute(record,length,Crc32c::Compute(&length,sizeof(unsigned int)))!=crc)
+				return false;
+			retNextOffset=offset+RECORD_LOG_HEADER_SIZE+length;
+			retIsMarker=false;
+			retRecord=record;
+			retByteSize=length;
+			return true;
+		}
+
+		/*!
+		Find the last sync marker ending at or before given offset.
+		@param[in] endOffset the offset the sync marker must end at or before.
+		@param[out] retOffset the offset of the sync marker found.
+		@return true if found, otherwise false.
+		@remark the file is read backward, one window at a time.
+		*/
+		bool FindMarkerBefore(unsigned __int64 endOffset, unsigned __int64 &retOffset)
+		{
+			unsigned __int64 chunkEnd=endOffset;
+			while(chunkEnd>=RECORD_LOG_MARKER_SIZE)
+			{
+				unsigned __int64 chunkStart=chunkEnd>RECORD_LOG_READ_SIZE?chunkEnd-RECORD_LOG_READ_SIZE:0;
+				const unsigned char *chunk=Fetch(chunkStart,static_cast<size_t>(chunkEnd-chunkStart));
+				if(!chunk)
+					return false;
+				for(size_t posTrav=static_cast<size_t>(chunkEnd-chunkStart)-RECORD_LOG_MARKER_SIZE+1;posTrav>0;posTrav--)
+				{
+					const unsigned char *marker=chunk+posTrav-1;
+					if(marker[0]==0xFF && marker[1]==0xFF && marker[2]==0xFF && marker[3]==0xFF && IsMarker(marker,chunkStart+posTrav-1))
+					{
+						retOffset=chunkStart+posTrav-1;
+						return true;
+					}
+				}
+				if(chunkStart==0)
+					break;
+				// the next window overlaps so that the sync marker across the windows is found.
+				chunkEnd=chunkStart+RECORD_LOG_MARKER_SIZE-1;
+			}
+			return false;
+		}
+
+		/*!
+		Read the records from given offset while they are valid.
+		@param[in] offset the offset to start reading from.
+		@param[in] stopOffset the offset to stop reading at.
+		@param[in,out] retMarkerOffset the offset of the last sync marker read.
+		@return the offset right after the last valid record read.
+		*/
+		unsigned __int64 ScanRecords(unsigned __int64 offset, unsigned __int64 stopOffset, unsigned __int64 &retMarkerOffset)
+		{
+			while(offset<stopOffset)
+			{
+				unsigned __int64 nextOffset=0;
+				bool isMarker=false;
+				const unsigned char *record=NULL;
+				unsigned int byteSize=0;
+				if(!ReadRecord(offset,nextOffset,isMarker,record,byteSize))
+					break;
+				if(isMarker)
+					retMarkerOffset=offset;
+				offset=nextOffset;
+			}
+			return offset;
+		}
+
+		/*!
+		Return the byte size of the valid records in the file.
+		@param[out] retMarkerOffset the offset of the last sync marker within the valid records.
+		@return the byte size of the valid records.
+		@remark the records are validated from the sync marker before the last sync marker
+		        whose records up to the last sync marker are all valid, to the first torn record.
+		*/
+		unsigned __int64 FindValidSize(unsigned __int64 &retMarkerOffset)
+		{
+			unsigned __int64 startOffset=0;
+			unsigned __int64 markerOffset=0;
+			bool hasMarker=FindMarkerBefore(m_fileSize,markerOffset);
+			retMarkerOffset=RECORD_LOG_MARKER_LENGTH;
+			while(hasMarker)
+			{
+				// the marker is trusted only if the records from the previous marker reach it.
+				unsigned __int64 prevOffset=0;
+				bool hasPrev=FindMarkerBefore(markerOffset,prevOffset);
+				unsigned __int64 chainMarkerOffset=RECORD_LOG_MARKER_LENGTH;
+				if(ScanRecords(hasPrev?prevOffset:0,markerOffset,chainMarkerOffset)==markerOffset)
+				{
+					startOffset=markerOffset;
+					break;
+				}
+				hasMarker=hasPrev;
+				markerOffset=prevOffset;
+			}
+			return ScanRecords(startOffset,m_fileSize,retMarkerOffset);
+		}
+
+		/*!
+		Return the flag whether the data is the valid sync marker.
+		@param[in] marker the data of RECORD_LOG_MARKER_SIZE bytes.
+		@param[in] offset the offset of the data within the file.
+		@return true if the data is the valid sync marker at given offset, otherwise false.
+		*/
+		static bool IsMarker(const unsigned char *marker, unsigned __int64 offset)
+		{
+			unsigned int length=0;
+			unsigned int crc=0;
+			unsigned __int64 markerOffset=0;
+			System::Memcpy(&length,marker,sizeof(unsigned int));
+			System::Memcpy(&crc,marker+sizeof(unsigned int),sizeof(unsigned int));
+			System::Memcpy(&markerOffset,marker+RECORD_LOG_HEADER_SIZE,sizeof(unsigned __int64));
+			return length==RECORD_LOG_MARKER_LENGTH && markerOffset==offset && Crc32c::Compute(&markerOffset,sizeof(unsigned __int64))==crc;
+		}
+
+	private:
+		/// the handle of the file
+		HANDLE m_fileHandle;
+		/// the byte size of the file
+		unsigned __int64 m_fileSize;
+		/// the data read from the file
+		std::vector<unsigned char> m_window;
+		/// the offset of the window within the file
+		unsigned __int64 m_windowBase;
+	};
+}
+
+RecordLog::RecordLog(LockPolicy lockPolicyType):m_flushEvent(false,true)
+{
+	m_fileHandle=INVALID_HANDLE_VALUE;
+	m_appendedSequence=0;
+	m_writtenSequence=0;
+	m_durableSequence=0;
+	m_markerDistance=0;
+	m_truncatedSize=0;
+	m_isFlushing=false;
+	m_isFailed=false;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_logLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_logLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_logLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_logLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_logLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_logLock=NULL;
+		break;
+	}
+}
+
+RecordLog::~RecordLog()
+{
+	Close();
+	if(m_logLock)
+		EP_DELETE m_logLock;
+}
+
+bool RecordLog::Open(const TCHAR *fileName)
+{
+	Close();
+	LockObj lock(m_logLock);
+	m_fileHandle=CreateFile(fileName,GENERIC_READ|GENERIC_WRITE,FILE_SHARE_READ,NULL,OPEN_ALWAYS,FILE_ATTRIBUTE_NORMAL,NULL);
+	if(m_fileHandle==INVALID_HANDLE_VALUE)
+	{
+		LOG_THIS_MSG(_T("Cannot open the record log file!"));
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(m_fileHandle,&fileSize))
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle=INVALID_HANDLE_VALUE;
+		LOG_THIS_MSG(_T("Cannot get the size of the record log file!"));
+		return false;
+	}
+
+	RecordLogScanner scanner(m_fileHandle,static_cast<unsigned __int64>(fileSize.QuadPart));
+	unsigned __int64 markerOffset=0;
+	unsigned __int64 validSize=scanner.FindValidSize(markerOffset);
+	m_truncatedSize=scanner.GetFileSize()-validSize;
+
+	LARGE_INTEGER position;
+	position.QuadPart=static_cast<LONGLONG>(validSize);
+	if(!SetFilePointerEx(m_fileHandle,position,NULL,FILE_BEGIN) || (m_truncatedSize && (!SetEndOfFile(m_fileHandle) || !FlushFileBuffers(m_fileHandle))))
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle=INVALID_HANDLE_VALUE;
+		LOG_THIS_MSG(_T("Cannot truncate the torn records of the record log file!"));
+		return false;
+	}
+
+	m_buffer.clear();
+	m_flushBuffer.clear();
+	m_appendedSequence=validSize;
+	m_writtenSequence=validSize;
+	m_durableSequence=validSize;
+	// the file without the sync marker gets one before the first record appended.
+	if(markerOffset==RECORD_LOG_MARKER_LENGTH)
+		m_markerDistance=RECORD_LOG_SYNC_INTERVAL;
+	else
+		m_markerDistance=validSize-markerOffset;
+	m_isFlushing=false;
+	m_isFailed=false;
+	return true;
+}
+
+bool RecordLog::Close()
+{
+	unsigned __int64 sequence=GetAppendedSequence();
+	bool ret=true;
+	if(IsOpened())
+		ret=flush(sequence,false);
+
+	LockObj lock(m_logLock);
+	if(m_fileHandle!=INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle=INVALID_HANDLE_VALUE;
+	}
+	m_buffer.clear();
+	m_flushBuffer.clear();
+	return ret;
+}
+
+bool RecordLog::IsOpened() const
+{
+	return m_fileHandle!=INVALID_HANDLE_VALUE;
+}
+
+unsigned __int64 RecordLog::Append(const void *data, unsigned int byteSize)
+{
+	if((!data && byteSize) || byteSize>RECORD_LOG_MAX_RECORD_SIZE)
+		return 0;
+	// the checksum is computed before locking, so the appending threads only contend for the copy.
+	unsigned int crc=Crc32c::Compute(data,byteSize,Crc32c::Compute(&byteSize,sizeof(unsigned int)));
+
+	unsigned __int64 sequence=0;
+	bool isFull=false;
+	{
+		LockObj lock(m_logLock);
+		if(m_fileHandle==INVALID_HANDLE_VALUE || m_isFailed)
+			return 0;
+		if(m_markerDistance>=RECORD_LOG_SYNC_INTERVAL)
+			appendMarker();
+
+		size_t offset=m_buffer.size();
+		m_buffer.resize(offset+RECORD_LOG_HEADER_SIZE+byteSize);
+		unsigned char *dest=&m_buffer[offset];
+		System::Memcpy(dest,&byteSize,sizeof(unsigned int));
+		System::Memcpy(dest+sizeof(unsigned int),&crc,sizeof(unsigned int));
+		if(byteSize)
+			System::Memcpy(dest+RECORD_LOG_HEADER_SIZE,data,byteSize);
+		m_appendedSequence+=RECORD_LOG_HEADER_SIZE+byteSize;
+		m_markerDistance+=RECORD_LOG_HEADER_SIZE+byteSize;
+		sequence=m_appendedSequence;
+		// the full buffer waits for the flushing thread rather than blocking the appending thread.
+		isFull=m_buffer.size()>=RECORD_LOG_BUFFER_SIZE && !m_isFlushing;
+	}
+	if(isFull && !flush(sequence,false))
+		return 0;
+	return sequence;
+}
+
+void RecordLog::appendMarker()
+{
+	unsigned __int64 offset=m_appendedSequence;
+	unsigned int length=RECORD_LOG_MARKER_LENGTH;
+	unsigned int crc=Crc32c::Compute(&offset,sizeof(unsigned __int64));
+	size_t bufferOffset=m_buffer.size();
+	m_buffer.resize(bufferOffset+RECORD_LOG_MARKER_SIZE);
+	unsigned char *dest=&m_buffer[bufferOffset];
+	System::Memcpy(dest,&length,sizeof(unsigned int));
+	System::Memcpy(dest+sizeof(unsigned int),&crc,sizeof(unsigned int));
+	System::Memcpy(dest+RECORD_LOG_HEADER_SIZE,&offset,sizeof(unsigned __int64));
+	m_appendedSequence+=RECORD_LOG_MARKER_SIZE;
+	m_markerDistance=0;
+}
+
+bool RecordLog::Commit(unsigned __int64 sequence)
+{
+	return flush(sequence,true);
+}
+
+bool RecordLog::Sync()
+{
+	return flush(GetAppendedSequence(),true);
+}
+
+bool RecordLog::flush(unsigned __int64 sequence, bool isDurable)
+{
+	unsigned __int64 flushSequence=0;
+	while(true)
+	{
+		{
+			LockObj lock(m_logLock);
+			if(m_fileHandle==INVALID_HANDLE_VALUE || m_isFailed)
+				return false;
+			if((isDurable?m_durableSequence:m_writtenSequence)>=sequence)
+				return true;
+			if(!m_isFlushing)
+			{
+				// this thread writes all the records appended so far on behalf of the waiting threads.
+				m_isFlushing=true;
+				m_flushEvent.ResetEvent();
+				m_buffer.swap(m_flushBuffer);
+				flushSequence=m_appendedSequence;
+				break;
+			}
+		}
+		m_flushEvent.WaitForEvent();
+	}
+
+	bool isWritten=true;
+	size_t writeTotal=0;
+	while(isWritten && writeTotal<m_flushBuffer.size())
+	{
+		DWORD writeByte=0;
+		isWritten=WriteFile(m_fileHandle,&m_flushBuffer[writeTotal],static_cast<DWORD>(m_flushBuffer.size()-writeTotal),&writeByte,NULL) && writeByte>0;
+		writeTotal+=writeByte;
+	}
+	if(isWritten && isDurable)
+		isWritten=FlushFileBuffers(m_fileHandle)!=0;
+	m_flushBuffer.clear();
+
+	LockObj lock(m_logLock);
+	if(isWritten)
+	{
+		m_writtenSequence=flushSequence;
+		if(isDurable)
+			m_durableSequence=flushSequence;
+	}
+	else
+	{
+		// the file may hold the part of the records, so nothing can be appended after them.
+		m_isFailed=true;
+		LOG_THIS_MSG(_T("Cannot write the records to the record log file!"));
+	}
+	m_isFlushing=false;
+	m_flushEvent.SetEvent();
+	return isWritten;
+}
+
+unsigned __int64 RecordLog::GetAppendedSequence() const
+{
+	LockObj lock(m_logLock);
+	return m_appendedSequence;
+}
+
+unsigned __int64 RecordLog::GetDurableSequence() const
+{
+	LockObj lock(m_logLock);
+	return m_durableSequence;
+}
+
+unsigned __int64 RecordLog::GetTruncatedSize() const
+{
+	return m_truncatedSize;
+}
+
+RecordLogReader::RecordLogReader()
+{
+	m_fileHandle=INVALID_HANDLE_VALUE;
+	m_validSize=0;
+	m_offset=0;
+	m_scanner=NULL;
+}
+
+RecordLogReader::~RecordLogReader()
+{
+	Close();
+}
+
+bool RecordLogReader::Open(const TCHAR *fileName)
+{
+	Close();
+	// the file is shared for writing, so the record log being appended can be read.
+	m_fileHandle=CreateFile(fileName,GENERIC_READ,FILE_SHARE_READ|FILE_SHARE_WRITE,NULL,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN,NULL);
+	if(m_fileHandle==INVALID_HANDLE_VALUE)
+	{
+		LOG_THIS_MSG(_T("Cannot open the record log file!"));
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if(!GetFileSizeEx(m_fileHandle,&fileSize))
+	{
+		Close();
+		LOG_THIS_MSG(_T("Cannot get the size of the record log file!"));
+		return false;
+	}
+	m_scanner=EP_NEW RecordLogScanner(m_fileHandle,static_cast<unsigned __int64>(fileSize.QuadPart));
+	unsigned __int64 markerOffset=0;
+	m_validSize=m_scanner->FindValidSize(markerOffset);
+	m_offset=0;
+	return true;
+}
+
+void RecordLogReader::Close()
+{
+	if(m_scanner)
+		EP_DELETE m_scanner;
+	m_scanner=NULL;
+	if(m_fileHandle!=INVALID_HANDLE_VALUE)
+		CloseHandle(m_fileHandle);
+	m_fileHandle=INVALID_HANDLE_VALUE;
+	m_validSize=0;
+	m_offset=0;
+}
+
+bool RecordLogReader::IsOpened() const
+{
+	return m_fileHandle!=INVALID_HANDLE_VALUE;
+}
+
+const unsigned char *RecordLogReader::ReadRecord(unsigned int &retByteSize)
+{
+	while(m_scanner && m_offset<m_validSize)
+	{
+		unsigned __int64 nextOffset=0;
+		bool isMarker=false;
+		const unsigned char *record=NULL;
+		unsigned int byteSize=0;
+		if(!m_scanner->ReadRecord(m_offset,nextOffset,isMarker,record,byteSize))
+			return NULL;
+		m_offset=nextOffset;
+		if(isMarker)
+			continue;
+		retByteSize=byteSize;
+		return record;
+	}
+	return NULL;
+}
+
+unsigned __int64 RecordLogReader::GetSequence() const
+{
+	return m_offset;
+}
+
+unsigned __int64 RecordLogReader::GetValidSize() const
+{
+	return m_validSize;
+}
\ No newline at end of file
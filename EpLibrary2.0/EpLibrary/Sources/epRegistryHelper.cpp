@@ -25,6 +25,12 @@ THE SOFTWARE.
 */
 #include "epRegistryHelper.h"
 #include "epMemory.h"
+#include "epLocale.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 #include <Shlwapi.h>
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
@@ -116,4 +122,289 @@ HKEY RegistryHelper::GetRegistryMode(const TCHAR * strRegPath)
 		return HKEY_CLASSES_ROOT;
 	}
 	return 0;
-}
\ No newline at end of file
+}
+
+RegistryCache::RegistryCache(HKEY key,const TCHAR *subKey,bool isSubtree,LockPolicy lockPolicyType)
+{
+	m_rootKey=key;
+	if(subKey)
+		m_subKey=subKey;
+	m_isSubtree=isSubtree;
+	m_watchKey=NULL;
+	m_changeWait=NULL;
+	m_isChanged=1;
+	m_isLoaded=false;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_cacheLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_cacheLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_cacheLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_cacheLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_cacheLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_cacheLock=NULL;
+		break;
+	}
+
+	m_changeEvent=CreateEvent(NULL,FALSE,FALSE,NULL);
+	// the system thread pool marks the change, so the read only checks the flag
+	if(m_changeEvent && !RegisterWaitForSingleObject(&m_changeWait,m_changeEvent,onChange,this,INFINITE,WT_EXECUTEDEFAULT))
+		m_changeWait=NULL;
+	Reload();
+}
+
+RegistryCache::~RegistryCache()
+{
+	// waits for the running callback, so it never touches the destroyed object
+	if(m_changeWait)
+		UnregisterWaitEx(m_changeWait,INVALID_HANDLE_VALUE);
+	if(m_watchKey)
+		RegCloseKey(m_watchKey);
+	if(m_changeEvent)
+		CloseHandle(m_changeEvent);
+	if(m_cacheLock)
+		EP_DELETE m_cacheLock;
+}
+
+void CALLBACK RegistryCache::onChange(void *param, BOOLEAN isTimedOut)
+{
+	RegistryCache *cache=reinterpret_cast<RegistryCache*>(param);
+	InterlockedExchange(&cache->m_isChanged,1);
+}
+
+EpTString RegistryCache::getMapKey(const TCHAR *name,bool isPath)
+{
+	EpTString mapKey;
+	if(!name)
+		return mapKey;
+	mapKey=name;
+	for(size_t charTrav=0;charTrav<mapKey.length();charTrav++)
+		mapKey[charTrav]=Locale::ToLower(mapKey[charTrav]);
+	if(isPath)
+	{
+		size_t first=mapKey.find_first_not_of(_T('\\'));
+		if(first==EpTString::npos)
+			return EpTString();
+		mapKey=mapKey.substr(first,mapKey.find_last_not_of(_T('\\'))-first+1);
+	}
+	return mapKey;
+}
+
+void RegistryCache::refresh()
+{
+	if(!m_changeWait && m_changeEvent && WaitForSingleObject(m_changeEvent,0)==WAIT_OBJECT_0)
+		InterlockedExchange(&m_isChanged,1);
+	if(!m_isChanged)
+		return;
+	LockObj lock(m_cacheLock);
+	if(m_isChanged)
+		reload();
+}
+
+bool RegistryCache::Reload()
+{
+	LockObj lock(m_cacheLock);
+	return reload();
+}
+
+bool RegistryCache::reload()
+{
+	InterlockedExchange(&m_isChanged,0);
+	if(!m_watchKey && RegOpenKeyEx(m_rootKey,m_subKey.c_str(),0,KEY_READ|KEY_NOTIFY,&m_watchKey)!=ERROR_SUCCESS)
+		m_watchKey=NULL;
+
+	bool result=false;
+	std::map<EpTString,CachedKey> keyMap;
+	if(m_watchKey)
+	{
+		// armed before loading, so the change while loading is not missed
+		DWORD notifyFilter=REG_NOTIFY_CHANGE_NAME|REG_NOTIFY_CHANGE_LAST_SET;
+#if defined(REG_NOTIFY_THREAD_AGNOSTIC)
+		notifyFilter|=REG_NOTIFY_THREAD_AGNOSTIC;
+#endif //defined(REG_NOTIFY_THREAD_AGNOSTIC)
+		bool isWatched=m_changeEvent && RegNotifyChangeKeyValue(m_watchKey,m_isSubtree?TRUE:FALSE,notifyFilter,m_changeEvent,TRUE)==ERROR_SUCCESS;
+		result=loadKey(m_watchKey,EpTString(),keyMap);
+		if(!result)
+		{
+			// the key may be deleted, so opened again on the next load
+			RegCloseKey(m_watchKey);
+			m_watchKey=NULL;
+		}
+		// the change cannot be notified, so loaded again on the next read
+		if(!isWatched)
+			InterlockedExchange(&m_isChanged,1);
+	}
+	if(!result)
+		InterlockedExchange(&m_isChanged,1);
+	m_keyMap.swap(keyMap);
+	m_isLoaded=result;
+	return result;
+}
+
+bool RegistryCache::loadKey(HKEY hKey,const EpTString &path,std::map<EpTString,CachedKey> &retKeyMap)
+{
+	DWORD subKeyCount=0,maxSubKeyLength=0,valueCount=0,maxValueNameLength=0,maxValueDataSize=0;
+	if(RegQueryInfoKey(hKey,NULL,NULL,NULL,&subKeyCount,&maxSubKeyLength,NULL,&valueCount,&maxValueNameLength,&maxValueDataSize,NULL,NULL)!=ERROR_SUCCESS)
+		return false;
+
+	CachedKey &cachedKey=retKeyMap[path];
+	std::vector<TCHAR> nameBuffer((maxValueNameLength>maxSubKeyLength?maxValueNameLength:maxSubKeyLength)+1);
+	// the room for the null character after the data to expand
+	std::vector<unsigned char> dataBuffer(maxValueDataSize+2*sizeof(TCHAR));
+
+	// all values in one pass, instead of opening the key for each value
+	cachedKey.valueNameList.reserve(valueCount);
+	for(DWORD valueTrav=0;valueTrav<valueCount;valueTrav++)
+	{
+		DWORD nameLength=static_cast<DWORD>(nameBuffer.size());
+		DWORD dataSize=maxValueDataSize;
+		DWORD regType=REG_NONE;
+		LONG ret=RegEnumValue(hKey,valueTrav,&nameBuffer[0],&nameLength,NULL,&regType,&dataBuffer[0],&dataSize);
+		if(ret==ERROR_NO_MORE_ITEMS)
+			break;
+		// changed while loading, and loaded again as notified
+		if(ret!=ERROR_SUCCESS)
+			continue;
+
+		EpTString name(&nameBuffer[0],nameLength);
+		cachedKey.valueNameList.push_back(name);
+		CachedValue &value=cachedKey.valueMap[getMapKey(name.c_str(),false)];
+		value.regType=regType;
+		if(regType==REG_EXPAND_SZ)
+		{
+			// expanded as SHGetValue does
+			System::Memset(&dataBuffer[dataSize],0,2*sizeof(TCHAR));
+			const TCHAR *source=reinterpret_cast<const TCHAR*>(&dataBuffer[0]);
+			DWORD expandedLength=ExpandEnvironmentStrings(source,NULL,0);
+			if(expandedLength)
+			{
+				value.regType=REG_SZ;
+				value.data.resize(expandedLength*sizeof(TCHAR));
+				ExpandEnvironmentStrings(source,reinterpret_cast<TCHAR*>(&value.data[0]),expandedLength);
+				continue;
+			}
+		}
+		value.data.assign(dataBuffer.begin(),dataBuffer.begin()+dataSize);
+	}
+
+	cachedKey.subKeyNameList.reserve(subKeyCount);
+	for(DWORD subKeyTrav=0;subKeyTrav<subKeyCount;subKeyTrav++)
+	{
+		DWORD nameLength=static_cast<DWORD>(nameBuffer.size());
+		LONG ret=RegEnumKeyEx(hKey,subKeyTrav,&nameBuffer[0],&nameLength,NULL,NULL,NULL,NULL);
+		if(ret==ERROR_NO_MORE_ITEMS)
+			break;
+		if(ret!=ERROR_SUCCESS)
+			continue;
+		EpTString name(&nameBuffer[0],nameLength);
+		cachedKey.subKeyNameList.push_back(name);
+		if(!m_isSubtree)
+			continue;
+
+		HKEY hSubKey;
+		if(RegOpenKeyEx(hKey,name.c_str(),0,KEY_READ,&hSubKey)!=ERROR_SUCCESS)
+			continue;
+		EpTString subPath=path;
+		if(subPath.length())
+			subPath.append(_T("\\"));
+		subPath.append(getMapKey(name.c_str(),false));
+		loadKey(hSubKey,subPath,retKeyMap);
+		RegCloseKey(hSubKey);
+	}
+	return true;
+}
+
+const RegistryCache::CachedValue *RegistryCache::findValue(const TCHAR *subKey,const TCHAR *regName) const
+{
+	std::map<EpTString,CachedKey>::const_iterator keyIter=m_keyMap.find(getMapKey(subKey,true));
+	if(keyIter==m_keyMap.end())
+		return NULL;
+	std::map<EpTString,CachedValue>::const_iterator valueIter=keyIter->second.valueMap.find(getMapKey(regName,false));
+	if(valueIter==keyIter->second.valueMap.end())
+		return NULL;
+	return &valueIter->second;
+}
+
+bool RegistryCache::GetRegistryData(const TCHAR * subKey,const TCHAR * regName, EpTString &retString)
+{
+	refresh();
+	SharedLockObj lock(m_cacheLock);
+	retString=_T("");
+	const CachedValue *value=findValue(subKey,regName);
+	if(!value || value->data.size()<sizeof(TCHAR))
+		return false;
+	// up to the first null character as read into the buffer
+	const TCHAR *str=reinterpret_cast<const TCHAR*>(&value->data[0]);
+	size_t maxLength=value->data.size()/sizeof(TCHAR);
+	size_t length=0;
+	while(length<maxLength && str[length])
+		length++;
+	retString.assign(str,length);
+	return true;
+}
+
+bool RegistryCache::GetRegistryData(const TCHAR * subKey,const TCHAR * regName,unsigned long sizeInByte,void *retBuf, unsigned long &retSizeReadInByte, unsigned long &retRegType)
+{
+	refresh();
+	SharedLockObj lock(m_cacheLock);
+	const CachedValue *value=findValue(subKey,regName);
+	if(!value || (retBuf && value->data.size()>sizeInByte))
+		return false;
+	if(retBuf && value->data.size())
+		System::Memcpy(retBuf,&value->data[0],value->data.size());
+	retSizeReadInByte=static_cast<unsigned long>(value->data.size());
+	retRegType=value->regType;
+	return true;
+}
+
+unsigned long RegistryCache::GetRegistryDataSize(const TCHAR * subKey,const TCHAR * regName)
+{
+	refresh();
+	SharedLockObj lock(m_cacheLock);
+	const CachedValue *value=findValue(subKey,regName);
+	if(!value)
+		return 0;
+	return static_cast<unsigned long>(value->data.size());
+}
+
+bool RegistryCache::GetValueNames(const TCHAR * subKey, std::vector<EpTString> &retNameList)
+{
+	refresh();
+	SharedLockObj lock(m_cacheLock);
+	retNameList.clear();
+	std::map<EpTString,CachedKey>::const_iterator keyIter=m_keyMap.find(getMapKey(subKey,true));
+	if(keyIter==m_keyMap.end())
+		return false;
+	retNameList=keyIter->second.valueNameList;
+	return true;
+}
+
+bool RegistryCache::GetSubKeyNames(const TCHAR * subKey, std::vector<EpTString> &retNameList)
+{
+	refresh();
+	SharedLockObj lock(m_cacheLock);
+	retNameList.clear();
+	std::map<EpTString,CachedKey>::const_iterator keyIter=m_keyMap.find(getMapKey(subKey,true));
+	if(keyIter==m_keyMap.end())
+		return false;
+	retNameList=keyIter->second.subKeyNameList;
+	return true;
+}
+
+bool RegistryCache::IsLoaded()
+{
+	refresh();
+	SharedLockObj lock(m_cacheLock);
+	return m_isLoaded;
+}
@@ -0,0 +1,275 @@
+/*! 
+ShmIpcClient for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epShmIpcClient.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+volatile long ShmIpcClient::m_connectionCount=0;
+
+ShmIpcClient::ShmIpcClient(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_channel(lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	m_writeBufferPool=NULL;
+}
+
+ShmIpcClient::~ShmIpcClient()
+{
+	Disconnect();
+	closeConnection();
+	if(m_writeBufferPool)
+		m_writeBufferPool->ReleaseObj();
+}
+
+epl::EpTString ShmIpcClient::GetFullPipeName() const
+{
+	return m_pipeName;
+}
+
+void ShmIpcClient::SetCallbackObject(IpcClientCallbackInterface *callBackObj)
+{
+	m_options.callBackObj=callBackObj;
+}
+
+IpcClientCallbackInterface *ShmIpcClient::GetCallbackObject()
+{
+	return m_options.callBackObj;
+}
+
+ConnectStatus ShmIpcClient::Connect(const IpcClientOps &ops, unsigned int waitTimeInMilliSec)
+{
+	EP_ASSERT(ops.callBackObj);
+	if(IsConnected())
+		return CONNECT_STATUS_SUCCESS;
+	// the previous connection disconnected on the thread of this instance is closed here
+	closeConnection();
+
+	if(ops.pipeName)
+	{
+		m_pipeName=SHM_IPC_NAME_PREFIX;
+		m_pipeName.append(ops.pipeName);
+	}
+	m_options=ops;
+	if(ops.numOfWriteBytes==0)
+		m_options.numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
+	if(ops.numOfReadBytes==0)
+		m_options.numOfReadBytes=DEFAULT_READ_BUF_SIZE;
+	if(waitTimeInMilliSec==0)
+		waitTimeInMilliSec=m_options.waitTimeInMilliSec;
+
+	if(!m_writeBufferPool || m_writeBufferPool->GetBufferByteSize()!=m_options.numOfWriteBytes)
+	{
+		// the elements still acquired keep the old pool alive until released
+		if(m_writeBufferPool)
+			m_writeBufferPool->ReleaseObj();
+		m_writeBufferPool=EP_NEW IpcWriteBufferPool(m_options.numOfWriteBytes,IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT,m_lockPolicy);
+	}
+
+	EpTString connectionName;
+	System::STPrintf(connectionName,_T("%s_%u_%u"),m_pipeName.c_str(),GetCurrentProcessId(),static_cast<unsigned int>(InterlockedIncrement(&m_connectionCount)));
+	if(connectionName.length()>=SHM_IPC_MAX_NAME_LENGTH)
+	{
+		EP_ASSERT_EXPR(0,_T("The pipe name is too long.\n"));
+		return CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+	}
+	if(!m_channel.Create(connectionName.c_str(),ShmRing::GetCapacityFor(m_options.numOfWriteBytes),ShmRing::GetCapacityFor(m_options.numOfReadBytes)))
+		return CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+
+	unsigned int startTime=System::GetTickCount();
+	ConnectStatus status=request(connectionName.c_str(),waitTimeInMilliSec);
+	ShmIpcConnectionBlock *block=m_channel.GetBlock();
+	while(status==CONNECT_STATUS_SUCCESS && block->m_state==SHM_IPC_CONNECTION_STATE_REQUESTED)
+	{
+		unsigned int remainTime=WAITTIME_INIFINITE;
+		if(waitTimeInMilliSec!=WAITTIME_INIFINITE)
+		{
+			unsigned int elapsedTime=System::GetTickCount()-startTime;
+			remainTime=(elapsedTime<waitTimeInMilliSec)?waitTimeInMilliSec-elapsedTime:0;
+		}
+		if(!m_channel.WaitForNotify(remainTime) && block->m_state==SHM_IPC_CONNECTION_STATE_REQUESTED)
+			status=CONNECT_STATUS_FAIL_TIME_OUT;
+	}
+	if(status==CONNECT_STATUS_SUCCESS && block->m_state!=SHM_IPC_CONNECTION_STATE_CONNECTED)
+		status=CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+	if(status!=CONNECT_STATUS_SUCCESS)
+	{
+		// the server opening the connection later sees it closed
+		m_channel.Shutdown();
+		m_channel.Close();
+		return status;
+	}
+
+	m_channel.WatchPeer(block->m_serverProcessId);
+	if(!Start())
+	{
+		m_channel.Shutdown();
+		m_channel.Close();
+		return CONNECT_STATUS_FAIL_READ_FAILED;
+	}
+	return CONNECT_STATUS_SUCCESS;
+}
+
+ConnectStatus ShmIpcClient::request(const TCHAR *connectionName, unsigned int waitTimeInMilliSec)
+{
+	HANDLE controlMapping=OpenFileMapping(FILE_MAP_ALL_ACCESS,FALSE,m_pipeName.c_str());
+	if(!controlMapping)
+		return CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+	ShmIpcControlBlock *control=reinterpret_cast<ShmIpcControlBlock*>(MapViewOfFile(controlMapping,FILE_MAP_ALL_ACCESS,0,0,sizeof(ShmIpcControlBlock)));
+	EpTString acceptEventName=m_pipeName;
+	acceptEventName.append(SHM_IPC_ACCEPT_EVENT_SUFFIX);
+	HANDLE acceptEvent=OpenEvent(EVENT_MODIFY_STATE,FALSE,acceptEventName.c_str());
+
+	ConnectStatus status=CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+	unsigned int startTime=System::GetTickCount();
+	while(control && acceptEvent && control->m_isAccepting)
+	{
+		int slotTrav;
+		for(slotTrav=0;slotTrav<SHM_IPC_REQUEST_SLOT_COUNT;slotTrav++)
+		{
+			ShmIpcRequestSlot &slot=control->m_slots[slotTrav];
+			if(InterlockedCompareExchange(&slot.m_state,SHM_IPC_SLOT_STATE_CLAIMED,SHM_IPC_SLOT_STATE_FREE)!=SHM_IPC_SLOT_STATE_FREE)
+				continue;
+			System::Memcpy(slot.m_connectionName,sizeof(slot.m_connectionName),connectionName,(System::TcsLen(connectionName)+1)*sizeof(TCHAR));
+			InterlockedExchange(&slot.m_state,SHM_IPC_SLOT_STATE_REQUESTED);
+			SetEvent(acceptEvent);
+			break;
+		}
+		if(slotTrav<SHM_IPC_REQUEST_SLOT_COUNT)
+		{
+			status=CONNECT_STATUS_SUCCESS;
+			break;
+		}
+		// all slots are taken by the other clients, so wait for the server to take them
+		if(waitTimeInMilliSec!=WAITTIME_INIFINITE && System::GetTickCount()-startTime>=waitTimeInMilliSec)
+		{
+			status=CONNECT_STATUS_FAIL_TIME_OUT;
+			break;
+		}
+		Sleep(1);
+	}
+
+	if(acceptEvent)
+		CloseHandle(acceptEvent);
+	if(control)
+		UnmapViewOfFile(control);
+	CloseHandle(controlMapping);
+	return status;
+}
+
+void ShmIpcClient::Disconnect()
+{
+	if(!m_channel.IsOpened())
+		return;
+	m_channel.Shutdown();
+	// the connection is closed at the next Connect or the destruction when disconnected on the thread of this instance
+	if(GetID()!=GetCurrentThreadId())
+		closeConnection();
+}
+
+void ShmIpcClient::closeConnection()
+{
+	if(!m_channel.IsOpened())
+		return;
+	WaitFor(m_options.waitTimeInMilliSec);
+	m_channel.Close();
+}
+
+bool ShmIpcClient::IsConnected() const
+{
+	return m_channel.IsOpened() && !m_channel.IsClosed();
+}
+
+unsigned int ShmIpcClient::GetMaxWriteDataByteSize() const
+{
+	unsigned int maxSendByteSize=m_channel.GetMaxSendByteSize();
+	if(m_options.numOfWriteBytes<maxSendByteSize)
+		return m_options.numOfWriteBytes;
+	return maxSendByteSize;
+}
+
+unsigned int ShmIpcClient::GetMaxReadDataByteSize() const
+{
+	return m_options.numOfReadBytes;
+}
+
+void ShmIpcClient::execute()
+{
+	while(m_channel.WaitForData())
+	{
+		unsigned int byteSize=0;
+		const char *data=NULL;
+		while((data=m_channel.Peek(byteSize))!=NULL)
+		{
+			// the data is read in place, so the space is given back after the callback
+			m_options.callBackObj->OnReadComplete(this,data,byteSize,READ_STATUS_SUCCESS,0);
+			m_channel.Pop();
+		}
+	}
+	m_channel.Shutdown();
+	m_options.callBackObj->OnDisconnect(this);
+}
+
+void ShmIpcClient::Write(char *data,unsigned int dataByteSize)
+{
+	IpcWriteSegment segment;
+	segment.m_data=data;
+	segment.m_dataSize=dataByteSize;
+	Write(&segment,1);
+}
+
+void ShmIpcClient::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	unsigned int dataByteSize=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		dataByteSize+=segmentList[segmentTrav].m_dataSize;
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+
+	if(m_channel.Send(segmentList,segmentCount,dataByteSize))
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_SUCCESS,0);
+	else if(IsConnected() && dataByteSize<=GetMaxWriteDataByteSize())
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_QUEUE_FULL,0);
+	else
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_WRITE_FAILED,0);
+}
+
+PipeWriteElem *ShmIpcClient::AcquireWriteBuffer(unsigned int dataByteSize)
+{
+	EP_ASSERT(m_writeBufferPool);
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+	return m_writeBufferPool->Acquire(dataByteSize);
+}
+
+void ShmIpcClient::WriteOwned(PipeWriteElem *elem)
+{
+	EP_ASSERT(elem);
+	Write(elem->m_data,elem->m_dataSize);
+	elem->ReleaseObj();
+}
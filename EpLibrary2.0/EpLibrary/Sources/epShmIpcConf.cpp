@@ -0,0 +1,436 @@
+/*! 
+ShmIpcConf for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epShmIpcConf.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+namespace epl
+{
+	/*!
+	Round the byte size up to the given alignment.
+	@param[in] byteSize the byte size.
+	@param[in] alignment the alignment, which must be the power of two.
+	@return the aligned byte size.
+	*/
+	static size_t alignUp(size_t byteSize, size_t alignment)
+	{
+		return (byteSize+alignment-1)&~(alignment-1);
+	}
+}
+
+ShmRing::ShmRing()
+{
+	m_header=NULL;
+	m_data=NULL;
+	m_capacity=0;
+	m_peekRecordSize=0;
+}
+
+size_t ShmRing::GetRequiredByteSize(unsigned int capacity)
+{
+	return sizeof(ShmRingHeader)+capacity;
+}
+
+unsigned int ShmRing::GetCapacityFor(unsigned int maxMessageByteSize)
+{
+	// the message takes at most the half of the ring, so the record skipped at the end always leaves room for it
+	size_t recordSize=alignUp(sizeof(unsigned int)+maxMessageByteSize,SHM_RING_RECORD_ALIGNMENT);
+	unsigned int capacity=SHM_IPC_DEFAULT_RING_BYTE_SIZE;
+	while(capacity<recordSize*2 && capacity<0x40000000)
+		capacity<<=1;
+	return capacity;
+}
+
+void ShmRing::Attach(void *memory, unsigned int capacity, bool isInitialize)
+{
+	EP_ASSERT_EXPR(capacity && (capacity&(capacity-1))==0,_T("The capacity of the ring must be the power of two. (%d)"),capacity);
+	m_header=reinterpret_cast<ShmRingHeader*>(memory);
+	m_data=reinterpret_cast<char*>(memory)+sizeof(ShmRingHeader);
+	m_capacity=capacity;
+	m_peekRecordSize=0;
+	if(isInitialize)
+		System::Memset(m_header,0,sizeof(ShmRingHeader));
+}
+
+unsigned int ShmRing::GetMaxMessageByteSize() const
+{
+	return m_capacity/2-sizeof(unsigned int);
+}
+
+bool ShmRing::Push(const IpcWriteSegment *segmentList, unsigned int segmentCount, unsigned int byteSize)
+{
+	if(byteSize>GetMaxMessageByteSize())
+		return false;
+	unsigned int recordSize=static_cast<unsigned int>(alignUp(sizeof(unsigned int)+byteSize,SHM_RING_RECORD_ALIGNMENT));
+	unsigned long head=static_cast<unsigned long>(m_header->m_head);
+	unsigned long tail=static_cast<unsigned long>(m_header->m_tail);
+	unsigned int pos=head&(m_capacity-1);
+
+	// the record never wraps around, so the rest of the ring is skipped if too short
+	unsigned int skipSize=0;
+	if(m_capacity-pos<recordSize)
+		skipSize=m_capacity-pos;
+	if(head-tail+skipSize+recordSize>m_capacity)
+		return false;
+	if(skipSize)
+	{
+		unsigned int wrapMarker=SHM_RING_WRAP_MARKER;
+		System::Memcpy(m_data+pos,&wrapMarker,sizeof(unsigned int));
+		head+=skipSize;
+		pos=0;
+	}
+
+	System::Memcpy(m_data+pos,&byteSize,sizeof(unsigned int));
+	char *dest=m_data+pos+sizeof(unsigned int);
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+	{
+		System::Memcpy(dest,segmentList[segmentTrav].m_data,segmentList[segmentTrav].m_dataSize);
+		dest+=segmentList[segmentTrav].m_dataSize;
+	}
+	// the full barrier publishes the record before the head
+	InterlockedExchange(&m_header->m_head,static_cast<long>(head+recordSize));
+	return true;
+}
+
+const char *ShmRing::Peek(unsigned int &retByteSize)
+{
+	unsigned long tail=static_cast<unsigned long>(m_header->m_tail);
+	unsigned long head=static_cast<unsigned long>(m_header->m_head);
+	if(tail==head)
+		return NULL;
+	unsigned int pos=tail&(m_capacity-1);
+	unsigned int byteSize=0;
+	System::Memcpy(&byteSize,m_data+pos,sizeof(unsigned int));
+	if(byteSize==SHM_RING_WRAP_MARKER)
+	{
+		tail+=m_capacity-pos;
+		InterlockedExchange(&m_header->m_tail,static_cast<long>(tail));
+		if(tail==head)
+			return NULL;
+		pos=0;
+		System::Memcpy(&byteSize,m_data,sizeof(unsigned int));
+	}
+	m_peekRecordSize=static_cast<unsigned int>(alignUp(sizeof(unsigned int)+byteSize,SHM_RING_RECORD_ALIGNMENT));
+	retByteSize=byteSize;
+	return m_data+pos+sizeof(unsigned int);
+}
+
+void ShmRing::Pop()
+{
+	EP_ASSERT_EXPR(m_peekRecordSize,_T("Pop is called without Peek."));
+	// the full barrier finishes reading the record before the space is given back
+	InterlockedExchangeAdd(&m_header->m_tail,static_cast<long>(m_peekRecordSize));
+	m_peekRecordSize=0;
+}
+
+bool ShmRing::IsEmpty() const
+{
+	return m_header->m_tail==m_header->m_head;
+}
+
+void ShmRing::SetConsumerWaiting(bool isWaiting)
+{
+	InterlockedExchange(&m_header->m_isConsumerWaiting,isWaiting?1:0);
+}
+
+bool ShmRing::IsConsumerWaiting() const
+{
+	return m_header->m_isConsumerWaiting!=0;
+}
+
+ShmIpcChannel::ShmIpcChannel(LockPolicy lockPolicyType)
+{
+	m_mapping=NULL;
+	m_block=NULL;
+	m_sendEvent=NULL;
+	m_recvEvent=NULL;
+	m_peerProcess=NULL;
+	m_isSelfClosed=NULL;
+	m_isPeerClosed=NULL;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_sendLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_sendLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_sendLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_sendLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_sendLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_sendLock=NULL;
+		break;
+	}
+}
+
+ShmIpcChannel::~ShmIpcChannel()
+{
+	Close();
+	if(m_sendLock)
+		EP_DELETE m_sendLock;
+}
+
+bool ShmIpcChannel::Create(const TCHAR *connectionName, unsigned int clientToServerCapacity, unsigned int serverToClientCapacity)
+{
+	Close();
+	size_t clientToServerOffset=alignUp(sizeof(ShmIpcConnectionBlock),SHM_RING_CACHE_LINE_SIZE);
+	size_t serverToClientOffset=clientToServerOffset+alignUp(ShmRing::GetRequiredByteSize(clientToServerCapacity),SHM_RING_CACHE_LINE_SIZE);
+	size_t byteSize=serverToClientOffset+ShmRing::GetRequiredByteSize(serverToClientCapacity);
+
+	m_mapping=CreateFileMapping(INVALID_HANDLE_VALUE,NULL,PAGE_READWRITE,0,static_cast<DWORD>(byteSize),connectionName);
+	if(!m_mapping)
+		return false;
+	if(GetLastError()==ERROR_ALREADY_EXISTS)
+	{
+		Close();
+		return false;
+	}
+	m_block=reinterpret_cast<ShmIpcConnectionBlock*>(MapViewOfFile(m_mapping,FILE_MAP_ALL_ACCESS,0,0,byteSize));
+	if(!m_block)
+	{
+		Close();
+		return false;
+	}
+	System::Memset(m_block,0,sizeof(ShmIpcConnectionBlock));
+	m_block->m_state=SHM_IPC_CONNECTION_STATE_REQUESTED;
+	m_block->m_clientProcessId=GetCurrentProcessId();
+	m_block->m_clientToServerCapacity=clientToServerCapacity;
+	m_block->m_serverToClientCapacity=serverToClientCapacity;
+	if(!attach(connectionName,false,true))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool ShmIpcChannel::Open(const TCHAR *connectionName)
+{
+	Close();
+	m_mapping=OpenFileMapping(FILE_MAP_ALL_ACCESS,FALSE,connectionName);
+	if(!m_mapping)
+		return false;
+	m_block=reinterpret_cast<ShmIpcConnectionBlock*>(MapViewOfFile(m_mapping,FILE_MAP_ALL_ACCESS,0,0,0));
+	if(!m_block)
+	{
+		Close();
+		return false;
+	}
+
+	// the header is written by the other process, so the rings are checked to lie within the mapping
+	MEMORY_BASIC_INFORMATION memInfo;
+	System::Memset(&memInfo,0,sizeof(MEMORY_BASIC_INFORMATION));
+	VirtualQuery(m_block,&memInfo,sizeof(MEMORY_BASIC_INFORMATION));
+	unsigned int clientToServerCapacity=m_block->m_clientToServerCapacity;
+	unsigned int serverToClientCapacity=m_block->m_serverToClientCapacity;
+	size_t clientToServerOffset=alignUp(sizeof(ShmIpcConnectionBlock),SHM_RING_CACHE_LINE_SIZE);
+	size_t serverToClientOffset=clientToServerOffset+alignUp(ShmRing::GetRequiredByteSize(clientToServerCapacity),SHM_RING_CACHE_LINE_SIZE);
+	bool isValid=clientToServerCapacity && (clientToServerCapacity&(clientToServerCapacity-1))==0
+		&& serverToClientCapacity && (serverToClientCapacity&(serverToClientCapacity-1))==0
+		&& serverToClientOffset+ShmRing::GetRequiredByteSize(serverToClientCapacity)<=memInfo.RegionSize;
+	if(!isValid || !attach(connectionName,true,false))
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool ShmIpcChannel::attach(const TCHAR *connectionName, bool isServer, bool isInitialize)
+{
+	char *base=reinterpret_cast<char*>(m_block);
+	size_t clientToServerOffset=alignUp(sizeof(ShmIpcConnectionBlock),SHM_RING_CACHE_LINE_SIZE);
+	size_t serverToClientOffset=clientToServerOffset+alignUp(ShmRing::GetRequiredByteSize(m_block->m_clientToServerCapacity),SHM_RING_CACHE_LINE_SIZE);
+
+	EpTString clientToServerName=connectionName;
+	clientToServerName.append(_T("_c2s"));
+	EpTString serverToClientName=connectionName;
+	serverToClientName.append(_T("_s2c"));
+	HANDLE clientToServerEvent=CreateEvent(NULL,FALSE,FALSE,clientToServerName.c_str());
+	HANDLE serverToClientEvent=CreateEvent(NULL,FALSE,FALSE,serverToClientName.c_str());
+	if(!clientToServerEvent || !serverToClientEvent)
+	{
+		if(clientToServerEvent)
+			CloseHandle(clientToServerEvent);
+		if(serverToClientEvent)
+			CloseHandle(serverToClientEvent);
+		return false;
+	}
+
+	if(isServer)
+	{
+		m_recvRing.Attach(base+clientToServerOffset,m_block->m_clientToServerCapacity,isInitialize);
+		m_sendRing.Attach(base+serverToClientOffset,m_block->m_serverToClientCapacity,isInitialize);
+		m_recvEvent=clientToServerEvent;
+		m_sendEvent=serverToClientEvent;
+		m_isSelfClosed=&m_block->m_isServerClosed;
+		m_isPeerClosed=&m_block->m_isClientClosed;
+	}
+	else
+	{
+		m_sendRing.Attach(base+clientToServerOffset,m_block->m_clientToServerCapacity,isInitialize);
+		m_recvRing.Attach(base+serverToClientOffset,m_block->m_serverToClientCapacity,isInitialize);
+		m_sendEvent=clientToServerEvent;
+		m_recvEvent=serverToClientEvent;
+		m_isSelfClosed=&m_block->m_isClientClosed;
+		m_isPeerClosed=&m_block->m_isServerClosed;
+	}
+	return true;
+}
+
+void ShmIpcChannel::Close()
+{
+	if(m_block)
+		UnmapViewOfFile(m_block);
+	m_block=NULL;
+	if(m_mapping)
+		CloseHandle(m_mapping);
+	m_mapping=NULL;
+	if(m_sendEvent)
+		CloseHandle(m_sendEvent);
+	m_sendEvent=NULL;
+	if(m_recvEvent)
+		CloseHandle(m_recvEvent);
+	m_recvEvent=NULL;
+	if(m_peerProcess)
+		CloseHandle(m_peerProcess);
+	m_peerProcess=NULL;
+	m_isSelfClosed=NULL;
+	m_isPeerClosed=NULL;
+}
+
+bool ShmIpcChannel::IsOpened() const
+{
+	return m_block!=NULL;
+}
+
+ShmIpcConnectionBlock *ShmIpcChannel::GetBlock() const
+{
+	return m_block;
+}
+
+void ShmIpcChannel::WatchPeer(unsigned long processId)
+{
+	if(m_peerProcess)
+		CloseHandle(m_peerProcess);
+	m_peerProcess=OpenProcess(SYNCHRONIZE,FALSE,processId);
+}
+
+bool ShmIpcChannel::Send(const IpcWriteSegment *segmentList, unsigned int segmentCount, unsigned int byteSize)
+{
+	LockObj lock(m_sendLock);
+	if(IsClosed() || !m_sendRing.Push(segmentList,segmentCount,byteSize))
+		return false;
+	// the push is the full barrier, so the peer which set the waiting flag before checking the ring is always woken
+	if(m_sendRing.IsConsumerWaiting())
+		SetEvent(m_sendEvent);
+	return true;
+}
+
+unsigned int ShmIpcChannel::GetMaxSendByteSize() const
+{
+	if(!m_block)
+		return 0;
+	return m_sendRing.GetMaxMessageByteSize();
+}
+
+bool ShmIpcChannel::WaitForData()
+{
+	unsigned int spinCount=0;
+	while(true)
+	{
+		if(!m_recvRing.IsEmpty())
+			return true;
+		if(IsClosed())
+			return false;
+		if(spinCount<SHM_IPC_SPIN_COUNT)
+		{
+			spinCount++;
+			YieldProcessor();
+			continue;
+		}
+
+		m_recvRing.SetConsumerWaiting(true);
+		if(m_recvRing.IsEmpty() && !IsClosed())
+		{
+			HANDLE waitHandles[2]={m_recvEvent,m_peerProcess};
+			if(WaitForMultipleObjects(m_peerProcess?2:1,waitHandles,FALSE,INFINITE)==WAIT_OBJECT_0+1)
+			{
+				// the peer exited without closing
+				InterlockedExchange(m_isPeerClosed,1);
+			}
+		}
+		m_recvRing.SetConsumerWaiting(false);
+		spinCount=0;
+	}
+}
+
+const char *ShmIpcChannel::Peek(unsigned int &retByteSize)
+{
+	return m_recvRing.Peek(retByteSize);
+}
+
+void ShmIpcChannel::Pop()
+{
+	m_recvRing.Pop();
+}
+
+void ShmIpcChannel::Shutdown()
+{
+	if(!m_block)
+		return;
+	InterlockedExchange(m_isSelfClosed,1);
+	SetEvent(m_sendEvent);
+	SetEvent(m_recvEvent);
+}
+
+bool ShmIpcChannel::IsClosed() const
+{
+	return !m_block || *m_isSelfClosed || *m_isPeerClosed;
+}
+
+void ShmIpcChannel::NotifyPeer()
+{
+	SetEvent(m_sendEvent);
+}
+
+bool ShmIpcChannel::WaitForNotify(unsigned int waitTimeInMilliSec)
+{
+	return WaitForSingleObject(m_recvEvent,waitTimeInMilliSec)==WAIT_OBJECT_0;
+}
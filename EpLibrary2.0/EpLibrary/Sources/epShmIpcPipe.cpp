@@ -0,0 +1,168 @@
+/*! 
+ShmIpcPipe for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epShmIpcPipe.h"
+#include "epShmIpcServer.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+ShmIpcPipe::ShmIpcPipe(ShmIpcServer *server, const IpcServerOps &options, IpcWriteBufferPool *writeBufferPool, epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),SmartObject(lockPolicyType),m_channel(lockPolicyType)
+{
+	m_server=server;
+	m_options=options;
+	m_writeBufferPool=writeBufferPool;
+	m_writeBufferPool->RetainObj();
+	m_isFinished=0;
+}
+
+ShmIpcPipe::~ShmIpcPipe()
+{
+	KillConnection();
+	WaitFor(m_options.waitTimeInMilliSec);
+	m_channel.Close();
+	m_writeBufferPool->ReleaseObj();
+}
+
+bool ShmIpcPipe::open(const TCHAR *connectionName)
+{
+	return m_channel.Open(connectionName);
+}
+
+bool ShmIpcPipe::accept(bool isAccept)
+{
+	ShmIpcConnectionBlock *block=m_channel.GetBlock();
+	if(!isAccept)
+	{
+		InterlockedExchange(&block->m_state,SHM_IPC_CONNECTION_STATE_REJECTED);
+		m_channel.NotifyPeer();
+		return false;
+	}
+	m_channel.WatchPeer(block->m_clientProcessId);
+	m_options.callBackObj->OnNewConnection(this);
+	block->m_serverProcessId=GetCurrentProcessId();
+	InterlockedExchange(&block->m_state,SHM_IPC_CONNECTION_STATE_CONNECTED);
+	m_channel.NotifyPeer();
+	if(!Start())
+	{
+		m_channel.Shutdown();
+		return false;
+	}
+	return true;
+}
+
+bool ShmIpcPipe::isFinished() const
+{
+	return m_isFinished!=0;
+}
+
+void ShmIpcPipe::execute()
+{
+	while(m_channel.WaitForData())
+	{
+		unsigned int byteSize=0;
+		const char *data=NULL;
+		while((data=m_channel.Peek(byteSize))!=NULL)
+		{
+			// the data is read in place, so the space is given back after the callback
+			m_options.callBackObj->OnReadComplete(this,data,byteSize,READ_STATUS_SUCCESS,0);
+			m_channel.Pop();
+		}
+	}
+	m_channel.Shutdown();
+	m_options.callBackObj->OnDisconnect(this);
+	InterlockedExchange(&m_isFinished,1);
+	m_server->wakeUp();
+}
+
+void ShmIpcPipe::Write(char *data,unsigned int dataByteSize)
+{
+	IpcWriteSegment segment;
+	segment.m_data=data;
+	segment.m_dataSize=dataByteSize;
+	Write(&segment,1);
+}
+
+void ShmIpcPipe::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	unsigned int dataByteSize=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		dataByteSize+=segmentList[segmentTrav].m_dataSize;
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+
+	if(m_channel.Send(segmentList,segmentCount,dataByteSize))
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_SUCCESS,0);
+	else if(IsConnectionAlive() && dataByteSize<=GetMaxWriteDataByteSize())
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_QUEUE_FULL,0);
+	else
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_WRITE_FAILED,0);
+}
+
+PipeWriteElem *ShmIpcPipe::AcquireWriteBuffer(unsigned int dataByteSize)
+{
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+	return m_writeBufferPool->Acquire(dataByteSize);
+}
+
+void ShmIpcPipe::WriteOwned(PipeWriteElem *elem)
+{
+	EP_ASSERT(elem);
+	Write(elem->m_data,elem->m_dataSize);
+	elem->ReleaseObj();
+}
+
+unsigned int ShmIpcPipe::GetMaxWriteDataByteSize() const
+{
+	unsigned int maxSendByteSize=m_channel.GetMaxSendByteSize();
+	if(m_options.numOfWriteBytes<maxSendByteSize)
+		return m_options.numOfWriteBytes;
+	return maxSendByteSize;
+}
+
+bool ShmIpcPipe::IsConnectionAlive() const
+{
+	return !m_channel.IsClosed();
+}
+
+void ShmIpcPipe::KillConnection()
+{
+	m_channel.Shutdown();
+}
+
+void ShmIpcPipe::SetCallbackObject(IpcServerCallbackInterface *callBackObj)
+{
+	EP_ASSERT(callBackObj);
+	m_options.callBackObj=callBackObj;
+}
+
+IpcServerCallbackInterface *ShmIpcPipe::GetCallbackObject()
+{
+	return m_options.callBackObj;
+}
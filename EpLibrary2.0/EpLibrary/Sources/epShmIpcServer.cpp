@@ -0,0 +1,270 @@
+/*! 
+ShmIpcServer for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epShmIpcServer.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+ShmIpcServer::ShmIpcServer(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	switch(m_lockPolicy)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_pipesLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_pipesLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_pipesLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_pipesLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_pipesLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_pipesLock=NULL;
+		break;
+	}
+	m_started=false;
+	m_isStopping=false;
+	m_controlMapping=NULL;
+	m_control=NULL;
+	m_acceptEvent=NULL;
+	m_writeBufferPool=NULL;
+}
+
+ShmIpcServer::~ShmIpcServer()
+{
+	StopServer();
+	if(m_pipesLock)
+		EP_DELETE m_pipesLock;
+	if(m_writeBufferPool)
+		m_writeBufferPool->ReleaseObj();
+}
+
+epl::EpTString ShmIpcServer::GetFullPipeName() const
+{
+	return m_pipeName;
+}
+unsigned int ShmIpcServer::GetMaximumInstances() const
+{
+	return m_options.maximumInstances;
+}
+void ShmIpcServer::SetCallbackObject(IpcServerCallbackInterface *callBackObj)
+{
+	m_options.callBackObj=callBackObj;
+}
+IpcServerCallbackInterface *ShmIpcServer::GetCallbackObject()
+{
+	return m_options.callBackObj;
+}
+
+bool ShmIpcServer::StartServer(const IpcServerOps &ops)
+{
+	EP_ASSERT(ops.callBackObj);
+	if(m_started)
+		return true;
+	if(ops.pipeName)
+	{
+		m_pipeName=SHM_IPC_NAME_PREFIX;
+		m_pipeName.append(ops.pipeName);
+	}
+
+	m_options=ops;
+	if(ops.numOfWriteBytes==0)
+		m_options.numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
+	if(ops.numOfReadBytes==0)
+		m_options.numOfReadBytes=DEFAULT_READ_BUF_SIZE;
+
+	m_controlMapping=CreateFileMapping(INVALID_HANDLE_VALUE,NULL,PAGE_READWRITE,0,sizeof(ShmIpcControlBlock),m_pipeName.c_str());
+	if(!m_controlMapping)
+	{
+		EP_ASSERT_EXPR(0,_T("Create control block failed with %d.\n"),GetLastError());
+		return false;
+	}
+	if(GetLastError()==ERROR_ALREADY_EXISTS)
+	{
+		// another server is already listening with the same name
+		CloseHandle(m_controlMapping);
+		m_controlMapping=NULL;
+		return false;
+	}
+	m_control=reinterpret_cast<ShmIpcControlBlock*>(MapViewOfFile(m_controlMapping,FILE_MAP_ALL_ACCESS,0,0,sizeof(ShmIpcControlBlock)));
+	EpTString acceptEventName=m_pipeName;
+	acceptEventName.append(SHM_IPC_ACCEPT_EVENT_SUFFIX);
+	m_acceptEvent=CreateEvent(NULL,FALSE,FALSE,acceptEventName.c_str());
+	if(!m_control || !m_acceptEvent)
+	{
+		EP_ASSERT_EXPR(0,_T("Create control block failed with %d.\n"),GetLastError());
+		stopServer();
+		return false;
+	}
+	System::Memset(m_control,0,sizeof(ShmIpcControlBlock));
+	m_control->m_serverProcessId=GetCurrentProcessId();
+
+	if(!m_writeBufferPool || m_writeBufferPool->GetBufferByteSize()!=m_options.numOfWriteBytes)
+	{
+		// the instances still alive keep the old pool until destroyed
+		if(m_writeBufferPool)
+			m_writeBufferPool->ReleaseObj();
+		m_writeBufferPool=EP_NEW IpcWriteBufferPool(m_options.numOfWriteBytes,IPC_WRITE_BUFFER_POOL_MAX_FREE_COUNT,m_lockPolicy);
+	}
+
+	m_isStopping=false;
+	if(!Start())
+	{
+		stopServer();
+		return false;
+	}
+	InterlockedExchange(&m_control->m_isAccepting,1);
+	m_started=true;
+	return true;
+}
+
+void ShmIpcServer::StopServer()
+{
+	if(!m_started)
+		return;
+	InterlockedExchange(&m_control->m_isAccepting,0);
+	m_isStopping=true;
+	SetEvent(m_acceptEvent);
+	WaitFor(m_options.waitTimeInMilliSec);
+	removeInstances(true);
+	stopServer();
+	m_started=false;
+}
+
+void ShmIpcServer::stopServer()
+{
+	if(m_control)
+		UnmapViewOfFile(m_control);
+	m_control=NULL;
+	if(m_controlMapping)
+		CloseHandle(m_controlMapping);
+	m_controlMapping=NULL;
+	if(m_acceptEvent)
+		CloseHandle(m_acceptEvent);
+	m_acceptEvent=NULL;
+}
+
+bool ShmIpcServer::IsServerStarted() const
+{
+	return m_started;
+}
+
+void ShmIpcServer::ShutdownAllClient()
+{
+	LockObj lock(m_pipesLock);
+	// the closed instances are removed when their threads finish
+	for(int trav=0;trav<m_pipes.size();trav++)
+		m_pipes.at(trav)->KillConnection();
+}
+
+unsigned int ShmIpcServer::GetMaxWriteDataByteSize() const
+{
+	return m_options.numOfWriteBytes;
+}
+
+unsigned int ShmIpcServer::GetMaxReadDataByteSize() const
+{
+	return m_options.numOfReadBytes;
+}
+
+void ShmIpcServer::wakeUp()
+{
+	SetEvent(m_acceptEvent);
+}
+
+void ShmIpcServer::execute()
+{
+	while(WaitForSingleObject(m_acceptEvent,INFINITE)==WAIT_OBJECT_0 && !m_isStopping)
+	{
+		acceptRequests();
+		removeInstances(false);
+	}
+}
+
+void ShmIpcServer::acceptRequests()
+{
+	for(int slotTrav=0;slotTrav<SHM_IPC_REQUEST_SLOT_COUNT;slotTrav++)
+	{
+		ShmIpcRequestSlot &slot=m_control->m_slots[slotTrav];
+		if(slot.m_state!=SHM_IPC_SLOT_STATE_REQUESTED)
+			continue;
+		TCHAR connectionName[SHM_IPC_MAX_NAME_LENGTH];
+		System::Memcpy(connectionName,slot.m_connectionName,sizeof(connectionName));
+		connectionName[SHM_IPC_MAX_NAME_LENGTH-1]=_T('\0');
+		InterlockedExchange(&slot.m_state,SHM_IPC_SLOT_STATE_FREE);
+
+		ShmIpcPipe *pipeInst=EP_NEW ShmIpcPipe(this,m_options,m_writeBufferPool,m_lockPolicy);
+		if(!pipeInst->open(connectionName))
+		{
+			// the client gave up before the request is handled
+			pipeInst->ReleaseObj();
+			continue;
+		}
+		m_pipesLock->Lock();
+		bool isAccept=m_pipes.size()<m_options.maximumInstances;
+		m_pipesLock->Unlock();
+		// the thread is the only one adding the instances, so the count does not grow until pushed
+		if(!pipeInst->accept(isAccept))
+		{
+			pipeInst->ReleaseObj();
+			continue;
+		}
+		LockObj lock(m_pipesLock);
+		m_pipes.push_back(pipeInst);
+	}
+}
+
+void ShmIpcServer::removeInstances(bool isAll)
+{
+	vector<ShmIpcPipe*> removedPipes;
+	m_pipesLock->Lock();
+	for(int trav=static_cast<int>(m_pipes.size())-1;trav>=0;trav--)
+	{
+		if(isAll || m_pipes.at(trav)->isFinished())
+		{
+			m_pipes.at(trav)->KillConnection();
+			removedPipes.push_back(m_pipes.at(trav));
+			m_pipes.erase(m_pipes.begin()+trav);
+		}
+	}
+	m_pipesLock->Unlock();
+
+	// released out of the lock, since the destructor waits for the thread which may call back into the server
+	for(int trav=0;trav<removedPipes.size();trav++)
+		removedPipes.at(trav)->ReleaseObj();
+}
@@ -26,6 +26,12 @@ THE SOFTWARE.
 #include "epSimpleLogger.h"
 #include "epException.h"
 #include "epFolderHelper.h"
+#include "epThread.h"
+#include "epEventEx.h"
+#include "epFileStream.h"
+#include "epClock.h"
+#include "epDateTimeHelper.h"
+#include <algorithm>
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -35,11 +41,110 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+volatile long SimpleLogManager::m_categoryLevels[LOG_MAX_CATEGORY_COUNT];
+
+/// the names of the log levels indexed by the level
+static const TCHAR *s_logLevelNames[]={_T("TRACE"),_T("DEBUG"),_T("INFO"),_T("WARN"),_T("ERROR"),_T("FATAL"),_T("OFF")};
+
+/*!
+Write the 64-bit integer to the stream as two unsigned integers.
+@param[in] stream the stream to write.
+@param[in] value the value to write.
+@return true if successful, otherwise false.
+*/
+static bool writeBinaryInt64(Stream &stream, __int64 value)
+{
+	return stream.WriteUInt(static_cast<unsigned int>(value&0xffffffff)) && stream.WriteUInt(static_cast<unsigned int>(static_cast<unsigned __int64>(value)>>32));
+}
+
+/*!
+Read the 64-bit integer written by writeBinaryInt64 from the stream.
+@param[in] stream the stream to read.
+@param[out] retVal the value read.
+@return true if successful, otherwise false.
+*/
+static bool readBinaryInt64(Stream &stream, __int64 &retVal)
+{
+	unsigned int lowValue;
+	unsigned int highValue;
+	if(!stream.ReadUInt(lowValue) || !stream.ReadUInt(highValue))
+		return false;
+	retVal=static_cast<__int64>((static_cast<unsigned __int64>(highValue)<<32)|lowValue);
+	return true;
+}
+
+/*!
+@struct LogLevelInitializer epSimpleLogger.cpp
+@brief A static object setting the default log level before main.
+*/
+static struct LogLevelInitializer
+{
+	/*!
+	Default Constructor
+
+	Set the default log level for all categories
+	*/
+	LogLevelInitializer()
+	{
+		SimpleLogManager::SetLogLevel(static_cast<LogLevel>(LOG_DEFAULT_LEVEL));
+	}
+} s_logLevelInitializer;
+
+namespace epl
+{
+	/*!
+	@class AsyncLogWriter epSimpleLogger.cpp
+	@brief A background thread writing the asynchronous logs of SimpleLogManager.
+	*/
+	class AsyncLogWriter:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] manager the manager to write the logs of.
+		*/
+		AsyncLogWriter(SimpleLogManager &manager):Thread(),m_manager(manager),m_stopEvent(false,true)
+		{
+			m_isStopping=false;
+		}
+
+		/*!
+		Stop the thread, and wait until it ends.
+		*/
+		void Stop()
+		{
+			m_isStopping=true;
+			m_stopEvent.SetEvent();
+			WaitFor();
+		}
+
+	protected:
+		/*!
+		Write the logs on every flush interval until stopped.
+		*/
+		virtual void execute()
+		{
+			while(!m_isStopping)
+			{
+				WaitForSingleObject(m_stopEvent.GetEventHandle(),m_manager.m_asyncFlushInterval);
+				m_manager.writeAsyncLogs();
+			}
+		}
+
+	private:
+		/// the manager to write the logs of
+		SimpleLogManager &m_manager;
+		/// the flag whether the thread is stopping
+		volatile bool m_isStopping;
+		/// the event to wake the thread to stop
+		EventEx m_stopEvent;
+	};
+}
+
 SimpleLogManager::SimpleLogNode::SimpleLogNode() :OutputNode()
 {
 	m_lineNum=0;
-	System::Memset(m_dateStr,0,sizeof(TCHAR)*9);
-	System::Memset(m_timeStr,0,sizeof(TCHAR)*9);
+	System::Memset(m_timeStr,0,sizeof(TCHAR)*TIMESTAMP_MAX_LENGTH);
 	m_userStr=_T("");
 }
 SimpleLogManager::SimpleLogNode::SimpleLogNode(const SimpleLogNode& b):OutputNode(b)
@@ -48,8 +153,7 @@ SimpleLogManager::SimpleLogNode::SimpleLogNode(const SimpleLogNode& b):OutputNod
 	m_funcName=b.m_funcName;
 	m_lineNum=b.m_lineNum;
 	m_userStr=b.m_userStr;
-	System::Memcpy(m_dateStr,b.m_dateStr,sizeof(TCHAR)*9);
-	System::Memcpy(m_timeStr,b.m_timeStr,sizeof(TCHAR)*9);
+	System::Memcpy(m_timeStr,b.m_timeStr,sizeof(TCHAR)*TIMESTAMP_MAX_LENGTH);
 }
 SimpleLogManager::SimpleLogNode::~SimpleLogNode()
 {
@@ -64,8 +168,7 @@ SimpleLogManager::SimpleLogNode & SimpleLogManager::SimpleLogNode::operator=(con
 		m_funcName=b.m_funcName;
 		m_lineNum=b.m_lineNum;
 		m_userStr=b.m_userStr;
-		System::Memcpy(m_dateStr,b.m_dateStr,sizeof(TCHAR)*9);
-		System::Memcpy(m_timeStr,b.m_timeStr,sizeof(TCHAR)*9);
+		System::Memcpy(m_timeStr,b.m_timeStr,sizeof(TCHAR)*TIMESTAMP_MAX_LENGTH);
 	}
 	return *this;
 }
@@ -73,9 +176,9 @@ SimpleLogManager::SimpleLogNode & SimpleLogManager::SimpleLogNode::operator=(con
 void SimpleLogManager::SimpleLogNode::Print() const
 {
 	if(m_userStr.length())
-		System::TPrintf(_T("%s::%s(%d) %s %s - %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_dateStr,m_timeStr,m_userStr.c_str());
+		System::TPrintf(_T("%s::%s(%d) %s - %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_timeStr,m_userStr.c_str());
 	else
-		System::TPrintf(_T("%s::%s(%d) %s %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_dateStr,m_timeStr);
+		System::TPrintf(_T("%s::%s(%d) %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_timeStr);
 }
 
 void SimpleLogManager::SimpleLogNode::Write(EpFile* const file)
@@ -83,11 +186,11 @@ void SimpleLogManager::SimpleLogNode::Write(EpFile* const file)
 	EP_ASSERT_EXPR(file,_T("The File Pointer is NULL!"));
 	if(m_userStr.length())
 	{
-		System::FTPrintf(file,_T("%s::%s(%d) %s %s - %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_dateStr,m_timeStr,m_userStr.c_str());
+		System::FTPrintf(file,_T("%s::%s(%d) %s - %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_timeStr,m_userStr.c_str());
 	}
 	else
 	{
-		System::FTPrintf(file,_T("%s::%s(%d) %s %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_dateStr,m_timeStr);
+		System::FTPrintf(file,_T("%s::%s(%d) %s\n"),m_fileName.c_str(),m_funcName.c_str(),m_lineNum,m_timeStr);
 	}
 }
 
@@ -96,15 +199,37 @@ SimpleLogManager::SimpleLogManager(LockPolicy lockPolicyType):BaseOutputter(lock
 {
 	m_fileName=FolderHelper::GetModuleFileDirectory();
 	m_fileName.append(_T("simplelog.dat"));
+	// the logs are not changed after added, so each flush writes only the new logs
+	setIncrementalFlush(true);
+	initAsyncLog();
 }
 SimpleLogManager::SimpleLogManager(const SimpleLogManager& b):BaseOutputter(b)
 {
 	LockObj lock(b.m_nodeListLock);
 	m_fileName=b.m_fileName;
+	// the rings belong to the original, so the copy starts without the sites
+	initAsyncLog();
+	m_asyncFlushInterval=b.m_asyncFlushInterval;
 }
 SimpleLogManager::~SimpleLogManager()
 {	
+	StopFlushThread();
+	if(m_asyncWriter)
+	{
+		m_asyncWriter->Stop();
+		EP_DELETE m_asyncWriter;
+		m_asyncWriter=NULL;
+	}
 	FlushToFile();
+	closeBinaryLog();
+	for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+		EP_DELETE m_asyncSlotList[slotTrav];
+	m_asyncSlotList.clear();
+	for(long siteTrav=0;siteTrav<m_asyncSiteCount;siteTrav++)
+		EP_DELETE m_asyncSites[siteTrav];
+	m_asyncSiteCount=0;
+	if(m_asyncTlsIndex!=TLS_OUT_OF_INDEXES)
+		TlsFree(m_asyncTlsIndex);
 }
 SimpleLogManager & SimpleLogManager::operator=(const SimpleLogManager&b)
 {
@@ -145,16 +270,758 @@ void SimpleLogManager::AddSimpleLog(const TCHAR *fileName, const TCHAR *funcName
 	}
 	va_end(args); 
 
-	System::TcsDate(log->m_dateStr,9);
-	System::TcsTime(log->m_timeStr,9);
+	const TCHAR *timeStr=m_timestampFormatter.Format(COARSE_CLOCK_INSTANCE.GetLocalTime());
+	System::Memcpy(log->m_timeStr,timeStr,sizeof(TCHAR)*(m_timestampFormatter.GetLength()+1));
 	m_list.push_back(log);
 #endif// defined(_DEBUG) && defined(EP_ENABLE_LOG)
 }
 
+void SimpleLogManager::AddAsyncLog(volatile long &siteId, const TCHAR *fileName, const TCHAR *funcName,const int lineNum,const TCHAR *format,...)
+{
+#if defined(EP_ENABLE_ASYNC_LOG)
+	long id=siteId;
+	if(id==0)
+	{
+		id=registerAsyncSite(fileName,funcName,lineNum,format,LOG_LEVEL_OFF,LOG_CATEGORY_DEFAULT);
+		InterlockedExchange(&siteId,id);
+	}
+	if(id<0)
+		return;
+	va_list args; 
+	va_start(args, format); 
+	recordAsyncLog(id,format,args);
+	va_end(args); 
+#endif// defined(EP_ENABLE_ASYNC_LOG)
+}
+
+void SimpleLogManager::AddLevelLog(volatile long &siteId, LogLevel level, unsigned int category, const TCHAR *fileName, const TCHAR *funcName,const int lineNum,const TCHAR *format,...)
+{
+	long id=siteId;
+	if(id==0)
+	{
+		id=registerAsyncSite(fileName,funcName,lineNum,format,level,category&(LOG_MAX_CATEGORY_COUNT-1));
+		InterlockedExchange(&siteId,id);
+	}
+	if(id<0)
+		return;
+	va_list args; 
+	va_start(args, format); 
+	recordAsyncLog(id,format,args);
+	va_end(args); 
+}
+
+void SimpleLogManager::SetLogLevel(LogLevel level)
+{
+	for(unsigned int categoryTrav=0;categoryTrav<LOG_MAX_CATEGORY_COUNT;categoryTrav++)
+		InterlockedExchange(&m_categoryLevels[categoryTrav],static_cast<long>(level));
+}
+
+void SimpleLogManager::SetCategoryLogLevel(unsigned int category, LogLevel level)
+{
+	InterlockedExchange(&m_categoryLevels[category&(LOG_MAX_CATEGORY_COUNT-1)],static_cast<long>(level));
+}
+
+LogLevel SimpleLogManager::GetCategoryLogLevel(unsigned int category)
+{
+	return static_cast<LogLevel>(m_categoryLevels[category&(LOG_MAX_CATEGORY_COUNT-1)]);
+}
+
+void SimpleLogManager::SetCategoryName(unsigned int category, const TCHAR *name)
+{
+	LockObj lock(m_nodeListLock);
+	m_categoryNames[category&(LOG_MAX_CATEGORY_COUNT-1)]=name?name:_T("");
+}
+
+void SimpleLogManager::recordAsyncLog(long siteId, const TCHAR *format, va_list args)
+{
+	AsyncLogThreadSlot *slot=getAsyncSlot();
+	long writeCount=slot->m_writeCount;
+	if(writeCount-slot->m_readCount>=ASYNC_LOG_QUEUE_CAPACITY)
+	{
+		slot->m_droppedCount++;
+		return;
+	}
+	AsyncLogRecord &record=slot->m_records[writeCount&(ASYNC_LOG_QUEUE_CAPACITY-1)];
+	const AsyncLogSite *site=m_asyncSites[siteId-1];
+	record.m_siteId=siteId;
+	record.m_tick=Clock::GetTick();
+
+	if(site->m_isPreformatted)
+	{
+		// the message is truncated to the record
+		int len=System::TcsLen_V(format,args);
+		if(len<ASYNC_LOG_STRING_LENGTH)
+		{
+			System::STPrintf_V(record.m_strings,ASYNC_LOG_STRING_LENGTH,format,args);
+		}
+		else
+		{
+			EpTString userStr;
+			System::STPrintf_V(userStr,format,args);
+			System::TcsNCpy(record.m_strings,ASYNC_LOG_STRING_LENGTH,userStr.c_str(),ASYNC_LOG_STRING_LENGTH-1);
+		}
+	}
+	else
+	{
+		int stringOffset=0;
+		for(unsigned int argTrav=0;argTrav<site->m_argCount;argTrav++)
+		{
+			AsyncLogArg &arg=record.m_args[argTrav];
+			switch(site->m_segments[argTrav].m_argType)
+			{
+			case ASYNC_LOG_ARG_TYPE_INT:
+				arg.m_intValue=va_arg(args,int);
+				break;
+			case ASYNC_LOG_ARG_TYPE_INT64:
+				arg.m_intValue=va_arg(args,__int64);
+				break;
+			case ASYNC_LOG_ARG_TYPE_DOUBLE:
+				arg.m_doubleValue=va_arg(args,double);
+				break;
+			case ASYNC_LOG_ARG_TYPE_POINTER:
+				arg.m_intValue=static_cast<__int64>(reinterpret_cast<INT_PTR>(va_arg(args,void*)));
+				break;
+			case ASYNC_LOG_ARG_TYPE_STRING:
+				{
+					const TCHAR *str=va_arg(args,const TCHAR*);
+					if(!str)
+						str=_T("(null)");
+					// the strings after the room is used up point to the last terminator
+					if(stringOffset>=ASYNC_LOG_STRING_LENGTH)
+					{
+						arg.m_intValue=ASYNC_LOG_STRING_LENGTH-1;
+						break;
+					}
+					arg.m_intValue=stringOffset;
+					while(*str && stringOffset<ASYNC_LOG_STRING_LENGTH-1)
+					{
+						record.m_strings[stringOffset]=*str;
+						stringOffset++;
+						str++;
+					}
+					record.m_strings[stringOffset]=_T('\0');
+					stringOffset++;
+				}
+				break;
+			}
+		}
+	}
+
+	// the record is complete before it is counted, so the background thread never reads the record being written
+	InterlockedExchange(&slot->m_writeCount,writeCount+1);
+}
+
+void SimpleLogManager::SetAsyncFlushInterval(unsigned int flushInterval)
+{
+	m_asyncFlushInterval=flushInterval;
+}
+
+unsigned int SimpleLogManager::GetAsyncFlushInterval() const
+{
+	return m_asyncFlushInterval;
+}
+
+__int64 SimpleLogManager::GetAsyncDroppedCount() const
+{
+	LockObj lock(m_nodeListLock);
+	__int64 droppedCount=0;
+	for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+		droppedCount+=m_asyncSlotList[slotTrav]->m_droppedCount;
+	return droppedCount;
+}
+
+bool SimpleLogManager::SetBinaryFileName(const TCHAR *fileName)
+{
+	// the logs recorded so far go to the previous file
+	writeAsyncLogs();
+	LockObj lock(m_nodeListLock);
+	closeBinaryLog();
+	if(!fileName || !System::TcsLen(fileName))
+		return true;
+
+	m_binaryStream=EP_NEW FileStream(fileName,LOCK_POLICY_NONE);
+	if(!m_binaryStream->OpenChunkedStream(FileStream::FILE_STREAM_CHUNK_TYPE_WRITE))
+	{
+		EP_DELETE m_binaryStream;
+		m_binaryStream=NULL;
+		return false;
+	}
+	m_binaryFileName=fileName;
+	// the new file holds no site yet
+	for(long siteTrav=0;siteTrav<m_asyncSiteCount;siteTrav++)
+		m_asyncSites[siteTrav]->m_isBinaryWritten=false;
+	m_binaryStream->WriteUInt(BINARY_LOG_MAGIC);
+	m_binaryStream->WriteUInt(BINARY_LOG_VERSION);
+	m_binaryStream->WriteByte(static_cast<unsigned char>(sizeof(TCHAR)));
+	writeBinaryInt64(*m_binaryStream,m_asyncTickFrequency);
+	writeBinaryInt64(*m_binaryStream,m_asyncOriginTick);
+	writeBinaryInt64(*m_binaryStream,m_asyncOriginTime);
+	return true;
+}
+
+EpTString SimpleLogManager::GetBinaryFileName() const
+{
+	LockObj lock(m_nodeListLock);
+	return m_binaryFileName;
+}
+
+bool SimpleLogManager::DecodeBinaryLog(const TCHAR *binaryFileName, const TCHAR *textFileName)
+{
+	FileStream stream(binaryFileName,LOCK_POLICY_NONE);
+	if(!stream.OpenChunkedStream(FileStream::FILE_STREAM_CHUNK_TYPE_READ))
+		return false;
+	unsigned int magic=0;
+	unsigned int version=0;
+	unsigned char charSize=0;
+	__int64 tickFrequency=0;
+	__int64 originTick=0;
+	__int64 originTime=0;
+	if(!stream.ReadUInt(magic) || !stream.ReadUInt(version) || !stream.ReadByte(charSize) 
+		|| !readBinaryInt64(stream,tickFrequency) || !readBinaryInt64(stream,originTick) || !readBinaryInt64(stream,originTime))
+		return false;
+	if(magic!=BINARY_LOG_MAGIC || version!=BINARY_LOG_VERSION || charSize!=sizeof(TCHAR) || tickFrequency<=0)
+		return false;
+
+	EpFile *file=NULL;
+	System::FTOpen(file,textFileName,_T("wt"));
+	if(!file)
+		return false;
+
+	// the sites indexed by their IDs, with the category names written with them
+	std::vector<AsyncLogSite*> siteList;
+	std::vector<EpTString> categoryNameList;
+	AsyncLogRecord record;
+	EpTString line;
+	TimestampFormatter formatter;
+	bool isComplete=true;
+	unsigned char chunkType;
+	while(isComplete && stream.ReadByte(chunkType))
+	{
+		switch(chunkType)
+		{
+		case BINARY_LOG_CHUNK_TYPE_SITE:
+			{
+				unsigned int siteId;
+				int lineNum;
+				unsigned char level;
+				unsigned int category;
+				EpTString categoryName;
+				AsyncLogSite *site=EP_NEW AsyncLogSite();
+				if(!stream.ReadUInt(siteId) || !stream.ReadInt(lineNum) || !stream.ReadByte(level) || !stream.ReadUInt(category) 
+					|| !stream.ReadPrefixedTString(site->m_fileName) || !stream.ReadPrefixedTString(site->m_funcName) 
+					|| !stream.ReadPrefixedTString(site->m_format) || !stream.ReadPrefixedTString(categoryName)
+					|| siteId==0 || siteId>ASYNC_LOG_MAX_SITE_COUNT || level>LOG_LEVEL_OFF)
+				{
+					EP_DELETE site;
+					isComplete=false;
+					break;
+				}
+				site->m_lineNum=lineNum;
+				site->m_level=static_cast<LogLevel>(level);
+				site->m_category=category&(LOG_MAX_CATEGORY_COUNT-1);
+				parseAsyncFormat(site->m_format.c_str(),*site);
+				if(siteList.size()<siteId)
+				{
+					siteList.resize(siteId,NULL);
+					categoryNameList.resize(siteId);
+				}
+				if(siteList[siteId-1])
+					EP_DELETE siteList[siteId-1];
+				siteList[siteId-1]=site;
+				categoryNameList[siteId-1]=categoryName;
+			}
+			break;
+		case BINARY_LOG_CHUNK_TYPE_RECORD:
+			{
+				unsigned int siteId;
+				if(!stream.ReadUInt(siteId) || siteId==0 || siteId>siteList.size() || !siteList[siteId-1] || !readBinaryInt64(stream,record.m_tick))
+				{
+					isComplete=false;
+					break;
+				}
+				const AsyncLogSite *site=siteList[siteId-1];
+				record.m_siteId=siteId;
+				record.m_strings[0]=_T('\0');
+				size_t stringOffset=0;
+				if(site->m_isPreformatted)
+					isComplete=readBinaryString(stream,record,stringOffset);
+				for(size_t segmentTrav=0;isComplete && !site->m_isPreformatted && segmentTrav<site->m_segments.size();segmentTrav++)
+				{
+					const AsyncLogSegment &segment=site->m_segments[segmentTrav];
+					if(!segment.m_spec.length())
+						continue;
+					AsyncLogArg &arg=record.m_args[segmentTrav];
+					if(segment.m_argType==ASYNC_LOG_ARG_TYPE_STRING)
+					{
+						arg.m_intValue=static_cast<__int64>(stringOffset);
+						isComplete=readBinaryString(stream,record,stringOffset);
+					}
+					else if(segment.m_argType==ASYNC_LOG_ARG_TYPE_DOUBLE)
+					{
+						if(!stream.ReadDouble(arg.m_doubleValue))
+							isComplete=false;
+					}
+					else if(segment.m_argType==ASYNC_LOG_ARG_TYPE_INT)
+					{
+						int intValue;
+						if(!stream.ReadInt(intValue))
+							isComplete=false;
+						else
+							arg.m_intValue=intValue;
+					}
+					else if(!readBinaryInt64(stream,arg.m_intValue))
+					{
+						isComplete=false;
+					}
+				}
+				if(!isComplete)
+					break;
+				formatAsyncRecord(*site,record,categoryNameList[siteId-1],originTick,originTime,tickFrequency,formatter,line);
+				System::FTPrintf(file,_T("%s"),line.c_str());
+			}
+			break;
+		case BINARY_LOG_CHUNK_TYPE_DROPPED:
+			{
+				unsigned int threadId;
+				int droppedCount;
+				if(!stream.ReadUInt(threadId) || !stream.ReadInt(droppedCount))
+				{
+					isComplete=false;
+					break;
+				}
+				System::FTPrintf(file,_T("%d asynchronous logs dropped on the thread %u\n"),droppedCount,threadId);
+			}
+			break;
+		default:
+			isComplete=false;
+			break;
+		}
+	}
+	System::FClose(file);
+	for(size_t siteTrav=0;siteTrav<siteList.size();siteTrav++)
+	{
+		if(siteList[siteTrav])
+			EP_DELETE siteList[siteTrav];
+	}
+	return isComplete;
+}
+
 void SimpleLogManager::FlushToFile()
 {
 #if  defined(_DEBUG) && defined(EP_ENABLE_LOG)
 	BaseOutputter::FlushToFile();
 #endif// defined(_DEBUG) && defined(EP_ENABLE_LOG)
+	writeAsyncLogs();
+}
+
+void SimpleLogManager::initAsyncLog()
+{
+	m_asyncTlsIndex=TlsAlloc();
+	EP_ASSERT_EXPR(m_asyncTlsIndex!=TLS_OUT_OF_INDEXES,_T("Failed to allocate the TLS index!"));
+	for(unsigned int siteTrav=0;siteTrav<ASYNC_LOG_MAX_SITE_COUNT;siteTrav++)
+		m_asyncSites[siteTrav]=NULL;
+	m_asyncSiteCount=0;
+	m_asyncWriter=NULL;
+	m_binaryStream=NULL;
+	m_asyncFlushInterval=ASYNC_LOG_DEFAULT_FLUSH_INTERVAL;
+	m_asyncTickFrequency=Clock::GetFrequency();
+	m_asyncOriginTick=Clock::GetTick();
+	FILETIME fileTime;
+	GetSystemTimeAsFileTime(&fileTime);
+	m_asyncOriginTime=(static_cast<__int64>(fileTime.dwHighDateTime)<<32)|static_cast<__int64>(fileTime.dwLowDateTime);
+}
+
+long SimpleLogManager::registerAsyncSite(const TCHAR *fileName, const TCHAR *funcName, const int lineNum, const TCHAR *format, LogLevel level, unsigned int category)
+{
+	LockObj lock(m_nodeListLock);
+	// the threads racing on the first call of the site get the same ID, while the other logs on the same line get their own
+	for(long siteTrav=0;siteTrav<m_asyncSiteCount;siteTrav++)
+	{
+		const AsyncLogSite *site=m_asyncSites[siteTrav];
+		if(site->m_lineNum==lineNum && site->m_level==level && site->m_category==category && site->m_format==format && site->m_fileName==fileName && site->m_funcName==funcName)
+			return siteTrav+1;
+	}
+	if(m_asyncSiteCount>=ASYNC_LOG_MAX_SITE_COUNT)
+	{
+		EP_ASSERT_EXPR(0,_T("More than %d sites are logged asynchronously!"),ASYNC_LOG_MAX_SITE_COUNT);
+		return -1;
+	}
+	AsyncLogSite *site=EP_NEW AsyncLogSite();
+	site->m_fileName=fileName;
+	site->m_funcName=funcName;
+	site->m_lineNum=lineNum;
+	site->m_level=level;
+	site->m_category=category;
+	site->m_format=format;
+	site->m_isBinaryWritten=false;
+	parseAsyncFormat(format,*site);
+	m_asyncSites[m_asyncSiteCount]=site;
+	m_asyncSiteCount++;
+	return m_asyncSiteCount;
+}
+
+void SimpleLogManager::parseAsyncFormat(const TCHAR *format, AsyncLogSite &site)
+{
+	site.m_segments.clear();
+	site.m_argCount=0;
+	site.m_isPreformatted=false;
+	AsyncLogSegment segment;
+	segment.m_argType=ASYNC_LOG_ARG_TYPE_INT;
+	const TCHAR *formatTrav=format;
+	while(*formatTrav)
+	{
+		if(*formatTrav!=_T('%'))
+		{
+			segment.m_literal.push_back(*formatTrav);
+			formatTrav++;
+			continue;
+		}
+		if(formatTrav[1]==_T('%'))
+		{
+			segment.m_literal.push_back(_T('%'));
+			formatTrav+=2;
+			continue;
+		}
+		const TCHAR *specStart=formatTrav;
+		formatTrav++;
+		while(*formatTrav==_T('-') || *formatTrav==_T('+') || *formatTrav==_T(' ') || *formatTrav==_T('#') || *formatTrav==_T('0'))
+			formatTrav++;
+		while(*formatTrav>=_T('0') && *formatTrav<=_T('9'))
+			formatTrav++;
+		if(*formatTrav==_T('.'))
+		{
+			formatTrav++;
+			while(*formatTrav>=_T('0') && *formatTrav<=_T('9'))
+				formatTrav++;
+		}
+		bool isInt64=false;
+		bool hasSize=false;
+		if(formatTrav[0]==_T('I') && formatTrav[1]==_T('6') && formatTrav[2]==_T('4'))
+		{
+			isInt64=true;
+			hasSize=true;
+			formatTrav+=3;
+		}
+		else if(formatTrav[0]==_T('I') && formatTrav[1]==_T('3') && formatTrav[2]==_T('2'))
+		{
+			hasSize=true;
+			formatTrav+=3;
+		}
+		else if(formatTrav[0]==_T('l') && formatTrav[1]==_T('l'))
+		{
+			isInt64=true;
+			hasSize=true;
+			formatTrav+=2;
+		}
+		else if(formatTrav[0]==_T('I'))
+		{
+			isInt64=(sizeof(INT_PTR)==sizeof(__int64));
+			hasSize=true;
+			formatTrav++;
+		}
+		else if(formatTrav[0]==_T('h') && formatTrav[1]==_T('h'))
+		{
+			hasSize=true;
+			formatTrav+=2;
+		}
+		else if(formatTrav[0]==_T('h') || formatTrav[0]==_T('l') || formatTrav[0]==_T('L') || formatTrav[0]==_T('w'))
+		{
+			hasSize=true;
+			formatTrav++;
+		}
+
+		bool isSupported=true;
+		switch(*formatTrav)
+		{
+		case _T('d'):
+		case _T('i'):
+		case _T('u'):
+		case _T('o'):
+		case _T('x'):
+		case _T('X'):
+		case _T('c'):
+			segment.m_argType=isInt64?ASYNC_LOG_ARG_TYPE_INT64:ASYNC_LOG_ARG_TYPE_INT;
+			break;
+		case _T('e'):
+		case _T('E'):
+		case _T('f'):
+		case _T('g'):
+		case _T('G'):
+		case _T('a'):
+		case _T('A'):
+			segment.m_argType=ASYNC_LOG_ARG_TYPE_DOUBLE;
+			break;
+		case _T('p'):
+			segment.m_argType=ASYNC_LOG_ARG_TYPE_POINTER;
+			break;
+		case _T('s'):
+			// the string of the other character type cannot be copied as TCHAR
+			segment.m_argType=ASYNC_LOG_ARG_TYPE_STRING;
+			isSupported=!hasSize;
+			break;
+		default:
+			// '*', %n, %S and the broken conversion
+			isSupported=false;
+			break;
+		}
+		if(!isSupported || site.m_argCount>=ASYNC_LOG_MAX_ARG_COUNT)
+		{
+			site.m_segments.clear();
+			site.m_argCount=0;
+			site.m_isPreformatted=true;
+			return;
+		}
+		formatTrav++;
+		segment.m_spec.assign(specStart,formatTrav-specStart);
+		site.m_segments.push_back(segment);
+		site.m_argCount++;
+		segment.m_literal.clear();
+		segment.m_spec.clear();
+	}
+	site.m_segments.push_back(segment);
+}
+
+SimpleLogManager::AsyncLogThreadSlot *SimpleLogManager::getAsyncSlot()
+{
+	AsyncLogThreadSlot *slot=reinterpret_cast<AsyncLogThreadSlot*>(TlsGetValue(m_asyncTlsIndex));
+	if(!slot)
+	{
+		slot=EP_NEW AsyncLogThreadSlot();
+		slot->m_threadId=GetCurrentThreadId();
+		slot->m_writeCount=0;
+		slot->m_readCount=0;
+		slot->m_droppedCount=0;
+		slot->m_reportedDroppedCount=0;
+		TlsSetValue(m_asyncTlsIndex,slot);
+		LockObj lock(m_nodeListLock);
+		m_asyncSlotList.push_back(slot);
+		if(!m_asyncWriter)
+		{
+			m_asyncWriter=EP_NEW AsyncLogWriter(*this);
+			m_asyncWriter->Start();
+		}
+	}
+	return slot;
+}
+
+void SimpleLogManager::writeAsyncLogs()
+{
+	LockObj lock(m_nodeListLock);
+	std::vector<AsyncLogEntry> entryList;
+	std::vector<long> writeCountList;
+	bool isDropped=false;
+	for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+	{
+		const AsyncLogThreadSlot *slot=m_asyncSlotList[slotTrav];
+		long writeCount=slot->m_writeCount;
+		writeCountList.push_back(writeCount);
+		for(long recordTrav=slot->m_readCount;recordTrav!=writeCount;recordTrav++)
+		{
+			AsyncLogEntry entry;
+			entry.m_record=&slot->m_records[recordTrav&(ASYNC_LOG_QUEUE_CAPACITY-1)];
+			entry.m_tick=entry.m_record->m_tick;
+			entryList.push_back(entry);
+		}
+		if(slot->m_droppedCount!=slot->m_reportedDroppedCount)
+			isDropped=true;
+	}
+	if(!entryList.size() && !isDropped)
+		return;
+	std::sort(entryList.begin(),entryList.end());
+
+	if(m_binaryStream)
+	{
+		for(size_t entryTrav=0;entryTrav<entryList.size();entryTrav++)
+			writeBinaryRecord(*entryList[entryTrav].m_record);
+		for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+		{
+			AsyncLogThreadSlot *slot=m_asyncSlotList[slotTrav];
+			long droppedCount=slot->m_droppedCount;
+			if(droppedCount!=slot->m_reportedDroppedCount)
+			{
+				m_binaryStream->WriteByte(BINARY_LOG_CHUNK_TYPE_DROPPED);
+				m_binaryStream->WriteUInt(slot->m_threadId);
+				m_binaryStream->WriteInt(droppedCount-slot->m_reportedDroppedCount);
+				slot->m_reportedDroppedCount=droppedCount;
+			}
+		}
+		m_binaryStream->WriteStreamToFile();
+		for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+			InterlockedExchange(&m_asyncSlotList[slotTrav]->m_readCount,writeCountList[slotTrav]);
+		return;
+	}
+
+	EpFile *file=NULL;
+	System::FTOpen(file,m_fileName.c_str(),_T("at"));
+	EP_ASSERT_EXPR(file,_T("Cannot open the file(%s)!"),m_fileName.c_str());
+	if(file)
+	{
+		EpTString line;
+		TimestampFormatter formatter;
+		for(size_t entryTrav=0;entryTrav<entryList.size();entryTrav++)
+		{
+			const AsyncLogRecord &record=*entryList[entryTrav].m_record;
+			const AsyncLogSite *site=m_asyncSites[record.m_siteId-1];
+			formatAsyncRecord(*site,record,m_categoryNames[site->m_category],m_asyncOriginTick,m_asyncOriginTime,m_asyncTickFrequency,formatter,line);
+			System::FTPrintf(file,_T("%s"),line.c_str());
+		}
+		for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+		{
+			AsyncLogThreadSlot *slot=m_asyncSlotList[slotTrav];
+			long droppedCount=slot->m_droppedCount;
+			if(droppedCount!=slot->m_reportedDroppedCount)
+			{
+				System::FTPrintf(file,_T("%d asynchronous logs dropped on the thread %u\n"),droppedCount-slot->m_reportedDroppedCount,slot->m_threadId);
+				slot->m_reportedDroppedCount=droppedCount;
+			}
+		}
+		System::FClose(file);
+	}
+	// the records are released even when the file cannot be opened, so the rings keep taking the new logs
+	for(size_t slotTrav=0;slotTrav<m_asyncSlotList.size();slotTrav++)
+		InterlockedExchange(&m_asyncSlotList[slotTrav]->m_readCount,writeCountList[slotTrav]);
+}
+
+void SimpleLogManager::writeBinaryRecord(const AsyncLogRecord &record)
+{
+	AsyncLogSite *site=m_asyncSites[record.m_siteId-1];
+	if(!site->m_isBinaryWritten)
+	{
+		m_binaryStream->WriteByte(BINARY_LOG_CHUNK_TYPE_SITE);
+		m_binaryStream->WriteUInt(static_cast<unsigned int>(record.m_siteId));
+		m_binaryStream->WriteInt(site->m_lineNum);
+		m_binaryStream->WriteByte(static_cast<unsigned char>(site->m_level));
+		m_binaryStream->WriteUInt(site->m_category);
+		m_binaryStream->WritePrefixedTString(site->m_fileName);
+		m_binaryStream->WritePrefixedTString(site->m_funcName);
+		m_binaryStream->WritePrefixedTString(site->m_format);
+		m_binaryStream->WritePrefixedTString(m_categoryNames[site->m_category]);
+		site->m_isBinaryWritten=true;
+	}
+	m_binaryStream->WriteByte(BINARY_LOG_CHUNK_TYPE_RECORD);
+	m_binaryStream->WriteUInt(static_cast<unsigned int>(record.m_siteId));
+	writeBinaryInt64(*m_binaryStream,record.m_tick);
+	if(site->m_isPreformatted)
+	{
+		m_binaryStream->WritePrefixedTString(EpTString(record.m_strings));
+		return;
+	}
+	for(size_t segmentTrav=0;segmentTrav<site->m_segments.size();segmentTrav++)
+	{
+		const AsyncLogSegment &segment=site->m_segments[segmentTrav];
+		if(!segment.m_spec.length())
+			continue;
+		const AsyncLogArg &arg=record.m_args[segmentTrav];
+		switch(segment.m_argType)
+		{
+		case ASYNC_LOG_ARG_TYPE_INT:
+			m_binaryStream->WriteInt(static_cast<int>(arg.m_intValue));
+			break;
+		case ASYNC_LOG_ARG_TYPE_INT64:
+		case ASYNC_LOG_ARG_TYPE_POINTER:
+			writeBinaryInt64(*m_binaryStream,arg.m_intValue);
+			break;
+		case ASYNC_LOG_ARG_TYPE_DOUBLE:
+			m_binaryStream->WriteDouble(arg.m_doubleValue);
+			break;
+		case ASYNC_LOG_ARG_TYPE_STRING:
+			m_binaryStream->WritePrefixedTString(EpTString(record.m_strings+arg.m_intValue));
+			break;
+		}
+	}
+}
+
+bool SimpleLogManager::readBinaryString(Stream &stream, AsyncLogRecord &record, size_t &stringOffset)
+{
+	EpTString stringArg;
+	if(!stream.ReadPrefixedTString(stringArg))
+		return false;
+	// the strings are cut to fit in the record as they were in the ring
+	size_t length=stringArg.length();
+	if(stringOffset+length>=ASYNC_LOG_STRING_LENGTH)
+		length=ASYNC_LOG_STRING_LENGTH-1-stringOffset;
+	System::Memcpy(record.m_strings+stringOffset,stringArg.c_str(),length*sizeof(TCHAR));
+	record.m_strings[stringOffset+length]=_T('\0');
+	stringOffset+=length;
+	if(stringOffset<ASYNC_LOG_STRING_LENGTH-1)
+		stringOffset++;
+	return true;
+}
+
+void SimpleLogManager::closeBinaryLog()
+{
+	if(m_binaryStream)
+	{
+		m_binaryStream->CloseChunkedStream();
+		EP_DELETE m_binaryStream;
+		m_binaryStream=NULL;
+	}
+	m_binaryFileName=_T("");
+}
+
+void SimpleLogManager::formatAsyncRecord(const AsyncLogSite &site, const AsyncLogRecord &record, const EpTString &categoryName, __int64 originTick, __int64 originTime, __int64 tickFrequency, TimestampFormatter &formatter, EpTString &retString)
+{
+	EpTString userStr;
+	if(site.m_isPreformatted)
+	{
+		userStr=record.m_strings;
+	}
+	else
+	{
+		EpTString argStr;
+		for(size_t segmentTrav=0;segmentTrav<site.m_segments.size();segmentTrav++)
+		{
+			const AsyncLogSegment &segment=site.m_segments[segmentTrav];
+			userStr.append(segment.m_literal);
+			if(!segment.m_spec.length())
+				continue;
+			const AsyncLogArg &arg=record.m_args[segmentTrav];
+			switch(segment.m_argType)
+			{
+			case ASYNC_LOG_ARG_TYPE_INT:
+				System::STPrintf(argStr,segment.m_spec.c_str(),static_cast<int>(arg.m_intValue));
+				break;
+			case ASYNC_LOG_ARG_TYPE_INT64:
+				System::STPrintf(argStr,segment.m_spec.c_str(),arg.m_intValue);
+				break;
+			case ASYNC_LOG_ARG_TYPE_DOUBLE:
+				System::STPrintf(argStr,segment.m_spec.c_str(),arg.m_doubleValue);
+				break;
+			case ASYNC_LOG_ARG_TYPE_POINTER:
+				System::STPrintf(argStr,segment.m_spec.c_str(),reinterpret_cast<void*>(static_cast<INT_PTR>(arg.m_intValue)));
+				break;
+			case ASYNC_LOG_ARG_TYPE_STRING:
+				System::STPrintf(argStr,segment.m_spec.c_str(),record.m_strings+arg.m_intValue);
+				break;
+			}
+			userStr.append(argStr);
+		}
+	}
+
+	// the time is rebuilt from the performance counter, so the calling thread reads the clock only once
+	__int64 time=originTime+static_cast<__int64>(static_cast<double>(record.m_tick-originTick)*10000000.0/static_cast<double>(tickFrequency));
+	FILETIME fileTime;
+	fileTime.dwLowDateTime=static_cast<DWORD>(time&0xffffffff);
+	fileTime.dwHighDateTime=static_cast<DWORD>(time>>32);
+	// the records are formatted in order, so the local time is converted only when the second changes
+	const TCHAR *timeStr=formatter.Format(fileTime);
+
+	if(site.m_level!=LOG_LEVEL_OFF)
+	{
+		// the level and the category are written in place of the empty message
+		EpTString categoryStr=categoryName;
+		if(!categoryStr.length())
+			System::STPrintf(categoryStr,_T("%u"),site.m_category);
+		EpTString prefixStr;
+		System::STPrintf(prefixStr,_T("[%s][%s]"),s_logLevelNames[site.m_level],categoryStr.c_str());
+		if(userStr.length())
+			prefixStr.append(_T(" "));
+		userStr.insert(0,prefixStr);
+	}
+
+	if(userStr.length())
+		System::STPrintf(retString,_T("%s::%s(%d) %s - %s\n"),site.m_fileName.c_str(),site.m_funcName.c_str(),site.m_lineNum,timeStr,userStr.c_str());
+	else
+		System::STPrintf(retString,_T("%s::%s(%d) %s\n"),site.m_fileName.c_str(),site.m_funcName.c_str(),site.m_lineNum,timeStr);
 }
 
@@ -0,0 +1,189 @@
+/*! 
+SpinParkLock for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epSpinParkLock.h"
+#include "epException.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the lock state values
+#define SPIN_PARK_STATE_UNLOCKED 0
+#define SPIN_PARK_STATE_LOCKED 1
+#define SPIN_PARK_STATE_PARKED 2
+
+SpinParkLock::SpinParkLock(unsigned int spinCount) :BaseLock()
+{
+	m_state=SPIN_PARK_STATE_UNLOCKED;
+	m_ownerThreadId=0;
+	m_lockCounter=0;
+	m_parkSem=NULL;
+	SetSpinCount(spinCount);
+}
+
+SpinParkLock::SpinParkLock(const SpinParkLock& b) :BaseLock()
+{
+	m_state=SPIN_PARK_STATE_UNLOCKED;
+	m_ownerThreadId=0;
+	m_lockCounter=0;
+	m_parkSem=NULL;
+	m_spinCount=b.m_spinCount;
+}
+
+SpinParkLock::~SpinParkLock()
+{
+	EP_ASSERT_EXPR(m_lockCounter==0,_T("Lock Counter is not 0!"));
+	if(m_parkSem)
+		EP_DELETE m_parkSem;
+}
+
+SpinParkLock & SpinParkLock::operator=(const SpinParkLock&b)
+{
+	if(this!=&b)
+	{
+		EP_ASSERT_EXPR(m_lockCounter==0,_T("Lock Counter is not 0!"));
+		m_spinCount=b.m_spinCount;
+	}
+	return *this;
+}
+
+void SpinParkLock::SetSpinCount(unsigned int spinCount)
+{
+	// the owner cannot make progress while this thread spins on the single core
+	if(System::GetNumberOfCores()<=1)
+		spinCount=0;
+	m_spinCount=spinCount;
+}
+
+unsigned int SpinParkLock::GetSpinCount() const
+{
+	return m_spinCount;
+}
+
+bool SpinParkLock::Lock()
+{
+	return acquire(WAITTIME_INIFINITE);
+}
+
+long SpinParkLock::TryLock()
+{
+	DWORD threadId=GetCurrentThreadId();
+	if(m_ownerThreadId==threadId)
+	{
+		m_lockCounter++;
+		return 1;
+	}
+	if(InterlockedCompareExchange(&m_state,SPIN_PARK_STATE_LOCKED,SPIN_PARK_STATE_UNLOCKED)!=SPIN_PARK_STATE_UNLOCKED)
+		return 0;
+	m_ownerThreadId=threadId;
+	m_lockCounter=1;
+	return 1;
+}
+
+long SpinParkLock::TryLockFor(const unsigned int dwMilliSecond)
+{
+	return acquire(dwMilliSecond)?1:0;
+}
+
+void SpinParkLock::Unlock()
+{
+	EP_ASSERT_EXPR(m_ownerThreadId==GetCurrentThreadId(),_T("Unlocked by the thread not owning the lock!"));
+	m_lockCounter--;
+	EP_ASSERT_EXPR(m_lockCounter>=0,_T("Lock Counter is less than 0!"));
+	if(m_lockCounter>0)
+		return;
+	m_ownerThreadId=0;
+	if(InterlockedExchange(&m_state,SPIN_PARK_STATE_UNLOCKED)==SPIN_PARK_STATE_PARKED)
+		unpark();
+}
+
+bool SpinParkLock::acquire(unsigned int waitTimeInMilliSec)
+{
+	if(TryLock())
+		return true;
+
+	DWORD threadId=GetCurrentThreadId();
+	for(unsigned int spinTrav=0;spinTrav<m_spinCount;spinTrav++)
+	{
+		// read before the interlocked operation, so the spinning does not bounce the cache line
+		if(m_state==SPIN_PARK_STATE_UNLOCKED && InterlockedCompareExchange(&m_state,SPIN_PARK_STATE_LOCKED,SPIN_PARK_STATE_UNLOCKED)==SPIN_PARK_STATE_UNLOCKED)
+		{
+			m_ownerThreadId=threadId;
+			m_lockCounter=1;
+			return true;
+		}
+		YieldProcessor();
+	}
+
+	unsigned int startTick=System::GetTickCount();
+	// mark as parked, so the owner wakes a thread on Unlock
+	while(InterlockedExchange(&m_state,SPIN_PARK_STATE_PARKED)!=SPIN_PARK_STATE_UNLOCKED)
+	{
+		unsigned int remainTime=WAITTIME_INIFINITE;
+		if(waitTimeInMilliSec!=WAITTIME_INIFINITE)
+		{
+			unsigned int elapsedTime=System::GetTickCount()-startTick;
+			if(elapsedTime>=waitTimeInMilliSec)
+				return false;
+			remainTime=waitTimeInMilliSec-elapsedTime;
+		}
+		park(remainTime);
+	}
+	m_ownerThreadId=threadId;
+	m_lockCounter=1;
+	return true;
+}
+
+void SpinParkLock::park(unsigned int waitTimeInMilliSec)
+{
+	if(PlatformSync::IsAddressWaitSupported())
+		PlatformSync::WaitOnAddress(&m_state,SPIN_PARK_STATE_PARKED,waitTimeInMilliSec);
+	else
+		getParkSemaphore()->Wait(waitTimeInMilliSec);
+}
+
+void SpinParkLock::unpark()
+{
+	if(PlatformSync::IsAddressWaitSupported())
+		PlatformSync::WakeByAddressSingle(&m_state);
+	else
+		getParkSemaphore()->Post();
+}
+
+PlatformSemaphore *SpinParkLock::getParkSemaphore()
+{
+	if(!m_parkSem)
+	{
+		PlatformSemaphore *parkSem=EP_NEW PlatformSemaphore();
+		if(InterlockedCompareExchangePointer((PVOID volatile *)&m_parkSem,parkSem,NULL)!=NULL)
+			EP_DELETE parkSem;
+	}
+	return m_parkSem;
+}
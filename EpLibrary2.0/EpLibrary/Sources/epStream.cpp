@@ -25,6 +25,8 @@ THE SOFTWARE.
 */
 #include "epStream.h"
 #include "epSimpleLogger.h"
+#include "epUnicodeHelper.h"
+#include <wchar.h>
 
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
@@ -36,10 +38,291 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+StreamBuffer::StreamBuffer()
+{
+	m_data=NULL;
+	m_size=0;
+	m_capacity=0;
+	m_virtualBuffer=NULL;
+	m_virtualFlags=VIRTUAL_BUFFER_FLAG_NONE;
+	m_isBorrowed=false;
+}
+
+StreamBuffer::StreamBuffer(const StreamBuffer& b)
+{
+	m_data=NULL;
+	m_size=0;
+	m_capacity=0;
+	m_virtualBuffer=NULL;
+	m_virtualFlags=VIRTUAL_BUFFER_FLAG_NONE;
+	m_isBorrowed=false;
+	copyFrom(b);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	release();
+}
+
+StreamBuffer & StreamBuffer::operator=(const StreamBuffer&b)
+{
+	if(this!=&b)
+	{
+		release();
+		copyFrom(b);
+	}
+	return *this;
+}
+
+void StreamBuffer::copyFrom(const StreamBuffer &b)
+{
+	// the copy of the borrowing buffer borrows the same memory.
+	if(b.m_isBorrowed)
+	{
+		Borrow(b.m_data,b.m_size);
+		return;
+	}
+	if(b.m_virtualBuffer)
+		ReserveVirtual(b.m_virtualBuffer->GetReservedSize(),b.m_virtualFlags);
+	if(Reserve(b.m_size) && ResizeUninitialized(b.m_size) && b.m_size)
+		System::Memcpy(m_data,b.m_data,b.m_size);
+}
+
+void StreamBuffer::release()
+{
+	if(m_virtualBuffer)
+		EP_DELETE m_virtualBuffer;
+	else if(m_data && !m_isBorrowed)
+		EP_FreeTag(m_data,MEMORY_TAG_STREAM);
+	m_data=NULL;
+	m_size=0;
+	m_capacity=0;
+	m_virtualBuffer=NULL;
+	m_virtualFlags=VIRTUAL_BUFFER_FLAG_NONE;
+	m_isBorrowed=false;
+}
+
+bool StreamBuffer::ReserveVirtual(size_t maxSize, unsigned int flags)
+{
+	if(maxSize<m_size)
+		return false;
+	VirtualBuffer *virtualBuffer=EP_NEW VirtualBuffer();
+	if(!virtualBuffer->Reserve(maxSize,flags) || !virtualBuffer->Commit(m_size))
+	{
+		EP_DELETE virtualBuffer;
+		return false;
+	}
+	unsigned char *data=reinterpret_cast<unsigned char*>(virtualBuffer->GetBuffer());
+	size_t size=m_size;
+	if(size)
+		System::Memcpy(data,m_data,size);
+	release();
+	m_data=data;
+	m_size=size;
+	m_capacity=virtualBuffer->GetCommittedSize();
+	m_virtualBuffer=virtualBuffer;
+	m_virtualFlags=flags;
+	return true;
+}
+
+bool StreamBuffer::IsVirtual() const
+{
+	return m_virtualBuffer!=NULL;
+}
+
+void StreamBuffer::Borrow(const unsigned char *data, size_t size)
+{
+	release();
+	m_data=const_cast<unsigned char*>(data);
+	m_size=size;
+	m_capacity=size;
+	m_isBorrowed=true;
+}
+
+bool StreamBuffer::IsBorrowed() const
+{
+	return m_isBorrowed;
+}
+
+unsigned char *StreamBuffer::Detach(size_t &retSize)
+{
+	retSize=0;
+	if(m_virtualBuffer || m_isBorrowed || m_size==0)
+		return NULL;
+	unsigned char *retData=m_data;
+	retSize=m_size;
+	m_data=NULL;
+	m_size=0;
+	m_capacity=0;
+	return retData;
+}
+
+bool StreamBuffer::reallocate(size_t capacity)
+{
+	if(m_virtualBuffer)
+	{
+		if(capacity>m_virtualBuffer->GetReservedSize())
+			return false;
+		if(!m_virtualBuffer->Commit(capacity))
+			return false;
+		m_capacity=m_virtualBuffer->GetCommittedSize();
+	}
+	else if(m_isBorrowed)
+	{
+		// the borrowed memory is never written, so move the data to the own memory.
+		unsigned char *data=reinterpret_cast<unsigned char*>(EP_MallocTag(capacity,MEMORY_TAG_STREAM));
+		if(!data)
+			return false;
+		if(m_size)
+			System::Memcpy(data,m_data,m_size);
+		m_data=data;
+		m_capacity=capacity;
+		m_isBorrowed=false;
+	}
+	else
+	{
+		unsigned char *data=reinterpret_cast<unsigned char*>(EP_ReallocTag(m_data,capacity,MEMORY_TAG_STREAM));
+		if(!data)
+			return false;
+		m_data=data;
+		m_capacity=capacity;
+	}
+	return true;
+}
+
+bool StreamBuffer::grow(size_t size)
+{
+	if(size<=m_capacity)
+		return true;
+	// double the capacity, so appending n bytes copies O(n) bytes in total.
+	size_t capacity=m_capacity*2;
+	if(capacity<STREAM_MIN_CAPACITY)
+		capacity=STREAM_MIN_CAPACITY;
+	if(capacity<size)
+		capacity=size;
+	if(m_virtualBuffer && capacity>m_virtualBuffer->GetReservedSize())
+	{
+		if(size>m_virtualBuffer->GetReservedSize())
+			return false;
+		capacity=m_virtualBuffer->GetReservedSize();
+	}
+	return reallocate(capacity);
+}
+
+bool StreamBuffer::Resize(size_t size)
+{
+	if(!grow(size))
+		return false;
+	if(size>m_size)
+		System::Memset(m_data+m_size,0,size-m_size);
+	m_size=size;
+	return true;
+}
+
+bool StreamBuffer::ResizeUninitialized(size_t size)
+{
+	if(!grow(size))
+		return false;
+	m_size=size;
+	return true;
+}
+
+bool StreamBuffer::Reserve(size_t capacity)
+{
+	if(capacity<=m_capacity)
+		return true;
+	return reallocate(capacity);
+}
+
+size_t StreamBuffer::GetCapacity() const
+{
+	return m_capacity;
+}
+
+void StreamBuffer::Clear()
+{
+	if(m_isBorrowed)
+		release();
+	m_size=0;
+}
+
+void StreamBuffer::Erase(size_t startIdx, size_t count)
+{
+	if(startIdx>=m_size || count==0)
+		return;
+	if(count>m_size-startIdx)
+		count=m_size-startIdx;
+	if(m_isBorrowed && !reallocate(m_size))
+		return;
+	memmove(m_data+startIdx,m_data+startIdx+count,m_size-startIdx-count);
+	m_size-=count;
+}
+
+size_t StreamBuffer::GetSize() const
+{
+	return m_size;
+}
+
+bool StreamBuffer::IsEmpty() const
+{
+	return m_size==0;
+}
+
+unsigned char *StreamBuffer::GetData()
+{
+	return m_data;
+}
+
+const unsigned char *StreamBuffer::GetData() const
+{
+	return m_data;
+}
+
+
+Stream::BatchLockObj::BatchLockObj(Stream *stream)
+{
+	EP_ASSERT_EXPR(stream,_T("Stream is NULL!"));
+	m_stream=stream;
+	m_isOwner=false;
+	// only this thread can set its own id, so the nested object sees it without the lock.
+	if(m_stream->m_streamLock && m_stream->m_batchOwnerId!=GetCurrentThreadId())
+	{
+		m_stream->m_streamLock->ProfiledLock();
+		m_stream->m_batchOwnerId=GetCurrentThreadId();
+		m_isOwner=true;
+	}
+}
+
+Stream::BatchLockObj::~BatchLockObj()
+{
+	if(m_isOwner)
+	{
+		m_stream->m_batchOwnerId=0;
+		m_stream->m_streamLock->ProfiledUnlock();
+	}
+}
+
+Stream::StreamLockObj::StreamLockObj(const Stream *stream)
+{
+	m_lock=NULL;
+	if(stream->m_streamLock && stream->m_batchOwnerId!=GetCurrentThreadId())
+	{
+		m_lock=stream->m_streamLock;
+		m_lock->ProfiledLock();
+	}
+}
+
+Stream::StreamLockObj::~StreamLockObj()
+{
+	if(m_lock)
+		m_lock->ProfiledUnlock();
+}
 
 Stream::Stream(LockPolicy lockPolicyType)
 {
 	m_offset=0;
+	m_batchOwnerId=0;
+	m_isSwapped=false;
 	m_lockPolicy=lockPolicyType;
 	switch(lockPolicyType)
 	{
@@ -50,7 +333,14 @@ Stream::Stream(LockPolicy lockPolicyType)
 		m_streamLock=EP_NEW Mutex();
 		break;
 	case LOCK_POLICY_NONE:
-		m_streamLock=EP_NEW NoLock();
+		// the stream owned by single thread needs no lock.
+		m_streamLock=NULL;
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_streamLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_streamLock=EP_NEW ReaderWriterLock();
 		break;
 	default:
 		m_streamLock=NULL;
@@ -62,6 +352,8 @@ Stream::Stream(const Stream& b)
 {
 	m_stream=b.m_stream;
 	m_offset=b.m_offset;
+	m_batchOwnerId=0;
+	m_isSwapped=b.m_isSwapped;
 	m_lockPolicy=b.m_lockPolicy;
 	switch(m_lockPolicy)
 	{
@@ -72,7 +364,14 @@ Stream::Stream(const Stream& b)
 		m_streamLock=EP_NEW Mutex();
 		break;
 	case LOCK_POLICY_NONE:
-		m_streamLock=EP_NEW NoLock();
+		// the stream owned by single thread needs no lock.
+		m_streamLock=NULL;
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_streamLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_streamLock=EP_NEW ReaderWriterLock();
 		break;
 	default:
 		m_streamLock=NULL;
@@ -84,9 +383,10 @@ Stream & Stream::operator=(const Stream&b)
 {
 	if(this!=&b)
 	{
-		LockObj lock(b.m_streamLock);
+		StreamLockObj lock(&b);
 		m_stream=b.m_stream;
 		m_offset=b.m_offset;
+		m_isSwapped=b.m_isSwapped;
 	}
 	return *this;
 }
@@ -100,26 +400,93 @@ Stream::~Stream()
 
 void Stream::Clear()
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	m_offset=0;
-	m_stream.clear();
+	m_stream.Clear();
 }
 
 size_t Stream::GetStreamSize() const
 {
-	return m_stream.size();
+	return m_stream.GetSize();
 }
 
 const unsigned char *Stream::GetBuffer() const
 {
-	if(m_stream.size())
-		return &m_stream.at(0);
+	if(m_stream.GetSize())
+		return m_stream.GetData();
 	return NULL;
 }
 
+bool Stream::ReserveVirtualBuffer(size_t maxSize, unsigned int flags)
+{
+	StreamLockObj lock(this);
+	if(m_stream.IsBorrowed())
+		return false;
+	return m_stream.ReserveVirtual(maxSize,flags);
+}
+
+bool Stream::Reserve(size_t byteSize)
+{
+	StreamLockObj lock(this);
+	if(m_stream.IsBorrowed())
+		return false;
+	return m_stream.Reserve(byteSize);
+}
+
+size_t Stream::GetCapacity() const
+{
+	return m_stream.GetCapacity();
+}
+
+unsigned char *Stream::WriteUninitialized(size_t byteSize)
+{
+	StreamLockObj lock(this);
+	if(!extend(byteSize))
+		return NULL;
+	unsigned char *retData=m_stream.GetData()+m_offset;
+	m_offset+=byteSize;
+	return retData;
+}
+
+bool Stream::AttachBuffer(const unsigned char *buffer, size_t byteSize)
+{
+	if(!buffer && byteSize)
+		return false;
+	StreamLockObj lock(this);
+	m_stream.Borrow(buffer,byteSize);
+	m_offset=0;
+	return true;
+}
+
+bool Stream::IsReadOnly() const
+{
+	return m_stream.IsBorrowed();
+}
+
+unsigned char *Stream::DetachBuffer(size_t &retByteSize)
+{
+	StreamLockObj lock(this);
+	unsigned char *retBuffer=m_stream.Detach(retByteSize);
+	if(retBuffer)
+		m_offset=0;
+	return retBuffer;
+}
+
+const unsigned char *Stream::ReadInPlace(size_t byteSize)
+{
+	StreamLockObj lock(this);
+	size_t &offset=readOffset();
+	size_t streamSize=m_stream.GetSize();
+	if(offset>streamSize || byteSize>streamSize-offset)
+		return NULL;
+	const unsigned char *retData=m_stream.GetData()+offset;
+	offset+=byteSize;
+	return retData;
+}
+
 void Stream::SetSeek(const StreamSeekType seekType,size_t offset)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	switch(seekType)
 	{
 	case STREAM_SEEK_TYPE_SEEK_SET:
@@ -129,7 +496,7 @@ void Stream::SetSeek(const StreamSeekType seekType,size_t offset)
 		m_offset+=offset;
 		break;
 	case STREAM_SEEK_TYPE_SEEK_END:
-		m_offset=m_stream.size();
+		m_offset=m_stream.GetSize();
 	}
 }
 size_t Stream::GetSeek() const
@@ -137,15 +504,42 @@ size_t Stream::GetSeek() const
 	return m_offset;
 }
 
-bool Stream::write(const void *value,size_t byteSize)
+void Stream::SetByteOrder(Endian::EndianType byteOrder)
 {
-	if(!value)
+	StreamLockObj lock(this);
+	m_isSwapped=(byteOrder!=Endian::GetSystemEndian());
+}
+
+Endian::EndianType Stream::GetByteOrder() const
+{
+	Endian::EndianType systemEndian=Endian::GetSystemEndian();
+	if(!m_isSwapped)
+		return systemEndian;
+	return (systemEndian==Endian::ENDIAN_TYPE_LITTLE)?Endian::ENDIAN_TYPE_BIG:Endian::ENDIAN_TYPE_LITTLE;
+}
+
+bool Stream::extend(size_t byteSize)
+{
+	if(m_stream.IsBorrowed())
 		return false;
-	if(m_stream.size()<m_offset+byteSize)
+	size_t streamSize=m_stream.GetSize();
+	if(streamSize<m_offset+byteSize)
 	{
-		m_stream.resize(m_offset+byteSize);
+		if(!m_stream.ResizeUninitialized(m_offset+byteSize))
+			return false;
+		if(m_offset>streamSize)
+			System::Memset(m_stream.GetData()+streamSize,0,m_offset-streamSize);
 	}
-	System::Memcpy(&m_stream.at(m_offset), value, byteSize);
+	return true;
+}
+
+bool Stream::write(const void *value,size_t byteSize)
+{
+	if(!value)
+		return false;
+	if(!extend(byteSize))
+		return false;
+	System::Memcpy(m_stream.GetData()+m_offset, value, byteSize);
 	m_offset+=byteSize;
 
 	return true;
@@ -153,12 +547,14 @@ bool Stream::write(const void *value,size_t byteSize)
 
 bool Stream::read(void *value,size_t byteSize)
 {
-	if(m_stream.empty() || !value)
+	if(m_stream.IsEmpty() || !value)
 		return false;
 
-	if(m_stream.size()>=m_offset+byteSize)
+	// compare without adding, so the huge byte size from the untrusted buffer does not wrap around.
+	size_t streamSize=m_stream.GetSize();
+	if(m_offset<=streamSize && byteSize<=streamSize-m_offset)
 	{
-		System::Memcpy(value,&m_stream.at(m_offset) , byteSize);
+		System::Memcpy(value,m_stream.GetData()+m_offset , byteSize);
 		m_offset+=byteSize;
 		return true;
 	}
@@ -169,78 +565,78 @@ bool Stream::read(void *value,size_t byteSize)
 
 bool Stream::WriteShort(const short value)
 {
-	LockObj lock(m_streamLock);
-	return write(&value,sizeof(short));
+	StreamLockObj lock(this);
+	return writeOrdered(&value,sizeof(short),1);
 }
 
 bool Stream::WriteUShort(const unsigned short value)
 {
-	LockObj lock(m_streamLock);
-	return write(&value,sizeof(unsigned short));
+	StreamLockObj lock(this);
+	return writeOrdered(&value,sizeof(unsigned short),1);
 }
 
 bool Stream::WriteInt(const int value)
 {
-	LockObj lock(m_streamLock);
-	return write(&value,sizeof(int));
+	StreamLockObj lock(this);
+	return writeOrdered(&value,sizeof(int),1);
 }
 
 bool Stream::WriteUInt(const unsigned int value)
 {
-	LockObj lock(m_streamLock);
-	return write(&value,sizeof(unsigned int));
+	StreamLockObj lock(this);
+	return writeOrdered(&value,sizeof(unsigned int),1);
 }
 
 bool Stream::WriteFloat(const float value)
 {
-	LockObj lock(m_streamLock);
-	return write(&value,sizeof(float));
+	StreamLockObj lock(this);
+	return writeOrdered(&value,sizeof(float),1);
 }
 
 bool Stream::WriteDouble(const double value)
 {
-	LockObj lock(m_streamLock);
-	return write(&value,sizeof(double));
+	StreamLockObj lock(this);
+	return writeOrdered(&value,sizeof(double),1);
 }
 bool Stream::WriteByte(const unsigned char value)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	return write(&value,sizeof(unsigned char));
 }
 
 bool Stream::WriteShorts(const short *shortList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return write(shortList,sizeof(short)*listSize);
+	StreamLockObj lock(this);
+	return writeOrdered(shortList,sizeof(short),listSize);
 }
 bool Stream::WriteUShorts(const unsigned short *ushortList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return write(ushortList,sizeof(unsigned short)*listSize);
+	StreamLockObj lock(this);
+	return writeOrdered(ushortList,sizeof(unsigned short),listSize);
 }
 bool Stream::WriteInts(const int *intList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return write(intList,sizeof(int)*listSize);
+	StreamLockObj lock(this);
+	return writeOrdered(intList,sizeof(int),listSize);
 }
 bool Stream::WriteUInts(const unsigned int *uintList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return write(uintList,sizeof(unsigned int)*listSize);
+	StreamLockObj lock(this);
+	return writeOrdered(uintList,sizeof(unsigned int),listSize);
 }
 bool Stream::WriteFloats(const float *floatList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return write(floatList,sizeof(float)*listSize);
+	StreamLockObj lock(this);
+	return writeOrdered(floatList,sizeof(float),listSize);
 }
 bool Stream::WriteDoubles(const double *doubleList,size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return write(doubleList,sizeof(double)*listSize);
+	StreamLockObj lock(this);
+	return writeOrdered(doubleList,sizeof(double),listSize);
 }
 bool Stream::WriteBytes(const unsigned char* byteList,size_t listSize)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	return write(byteList,sizeof(unsigned char)*listSize);
 }
 
@@ -248,23 +644,20 @@ bool Stream::WriteString(const char *str)
 {
 	if(!str)
 		return false;
-	EpString convString=str;
-	return WriteBytes(reinterpret_cast<const unsigned char*>(convString.c_str()),convString.size()+1);
+	return WriteBytes(reinterpret_cast<const unsigned char*>(str),(strlen(str)+1)*sizeof(char));
 }
 
 bool Stream::WriteWString(const wchar_t *str)
 {
 	if(!str)
 		return false;
-	EpWString convString=str;
-	return WriteBytes(reinterpret_cast<const unsigned char*>(convString.c_str()),(convString.size()+1)*sizeof(wchar_t));
+	return WriteBytes(reinterpret_cast<const unsigned char*>(str),(wcslen(str)+1)*sizeof(wchar_t));
 }
 bool Stream::WriteTString(const TCHAR *str)
 {
 	if(!str)
 		return false;
-	EpTString convString=str;
-	return WriteBytes(reinterpret_cast<const unsigned char*>(convString.c_str()),(convString.size()+1)*sizeof(TCHAR));
+	return WriteBytes(reinterpret_cast<const unsigned char*>(str),(_tcslen(str)+1)*sizeof(TCHAR));
 }
 
 
@@ -282,133 +675,356 @@ bool Stream::WriteTString(const EpTString &str)
 	return WriteBytes(reinterpret_cast<const unsigned char*>(str.c_str()),(str.size()+1)*sizeof(TCHAR));
 }
 
+bool Stream::WritePrefixedString(const EpString &str)
+{
+	StreamLockObj lock(this);
+	unsigned int charCount=static_cast<unsigned int>(str.size());
+	if(charCount!=str.size())
+		return false;
+	return write(&charCount,sizeof(unsigned int)) && write(str.c_str(),str.size()*sizeof(char));
+}
+
+bool Stream::WritePrefixedWString(const EpWString &str)
+{
+	StreamLockObj lock(this);
+	unsigned int charCount=static_cast<unsigned int>(str.size());
+	if(charCount!=str.size())
+		return false;
+	return write(&charCount,sizeof(unsigned int)) && write(str.c_str(),str.size()*sizeof(wchar_t));
+}
+
+bool Stream::WritePrefixedTString(const EpTString &str)
+{
+	StreamLockObj lock(this);
+	unsigned int charCount=static_cast<unsigned int>(str.size());
+	if(charCount!=str.size())
+		return false;
+	return write(&charCount,sizeof(unsigned int)) && write(str.c_str(),str.size()*sizeof(TCHAR));
+}
+
+bool Stream::WritePrefixedUtf8String(const EpTString &str)
+{
+#if defined(_UNICODE) || defined(UNICODE)
+	EpString utf8String=UnicodeHelper::Utf16ToUtf8(str);
+#else //defined(_UNICODE) || defined(UNICODE)
+	EpString utf8String;
+	if(!str.empty())
+		utf8String=UnicodeHelper::Utf16ToUtf8(System::MultiByteToWideChar(str.c_str(),static_cast<int>(str.size())));
+#endif //defined(_UNICODE) || defined(UNICODE)
+	StreamLockObj lock(this);
+	unsigned int byteCount=static_cast<unsigned int>(utf8String.size());
+	if(byteCount!=utf8String.size())
+		return false;
+	return write(&byteCount,sizeof(unsigned int)) && write(utf8String.c_str(),utf8String.size()*sizeof(char));
+}
+
 
 bool Stream::ReadShort(short &retVal)
 {
-	LockObj lock(m_streamLock);
-	return read(&retVal,sizeof(short));
+	StreamLockObj lock(this);
+	return readOrdered(&retVal,sizeof(short),1);
 }
 bool Stream::ReadUShort(unsigned short &retVal)
 {
-	LockObj lock(m_streamLock);
-	return read(&retVal,sizeof(unsigned short));
+	StreamLockObj lock(this);
+	return readOrdered(&retVal,sizeof(unsigned short),1);
 }
 bool Stream::ReadInt(int &retVal)
 {
-	LockObj lock(m_streamLock);
-	return read(&retVal,sizeof(int));
+	StreamLockObj lock(this);
+	return readOrdered(&retVal,sizeof(int),1);
 }
 bool Stream::ReadUInt(unsigned int &retVal)
 {
-	LockObj lock(m_streamLock);
-	return read(&retVal,sizeof(unsigned int));
+	StreamLockObj lock(this);
+	return readOrdered(&retVal,sizeof(unsigned int),1);
 }
 bool Stream::ReadFloat(float &retVal)
 {
-	LockObj lock(m_streamLock);
-	return read(&retVal,sizeof(float));
+	StreamLockObj lock(this);
+	return readOrdered(&retVal,sizeof(float),1);
 }
 bool Stream::ReadDouble(double &retVal)
 {
-	LockObj lock(m_streamLock);
-	return read(&retVal,sizeof(double));
+	StreamLockObj lock(this);
+	return readOrdered(&retVal,sizeof(double),1);
 }
 bool Stream::ReadByte(unsigned char &retVal)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	return read(&retVal,sizeof(unsigned char));
 }
 
 bool Stream::ReadShorts(short *retShortList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return read(retShortList,sizeof(short)*listSize);
+	StreamLockObj lock(this);
+	return readOrdered(retShortList,sizeof(short),listSize);
 }
 bool Stream::ReadUShorts(unsigned short *retUshortList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return read(retUshortList,sizeof(unsigned short)*listSize);
+	StreamLockObj lock(this);
+	return readOrdered(retUshortList,sizeof(unsigned short),listSize);
 }
 bool Stream::ReadInts(int *retIntList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return read(retIntList,sizeof(int)*listSize);
+	StreamLockObj lock(this);
+	return readOrdered(retIntList,sizeof(int),listSize);
 }
 bool Stream::ReadUInts(unsigned int *retUintList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return read(retUintList,sizeof(unsigned int)*listSize);
+	StreamLockObj lock(this);
+	return readOrdered(retUintList,sizeof(unsigned int),listSize);
 }
 bool Stream::ReadFloats(float *retFloatList,size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return read(retFloatList,sizeof(float)*listSize);
+	StreamLockObj lock(this);
+	return readOrdered(retFloatList,sizeof(float),listSize);
 }
 bool Stream::ReadDoubles(double *retDoubleList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
-	return read(retDoubleList,sizeof(float)*listSize);
+	StreamLockObj lock(this);
+	return readOrdered(retDoubleList,sizeof(double),listSize);
 }
 bool Stream::ReadBytes(unsigned char* retByteList, size_t listSize)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	return read(retByteList,sizeof(unsigned char)*listSize);
 }
 
 bool Stream::ReadString(EpString &retString)
 {
-	LockObj lock(m_streamLock);
-	char retChar;
-	retString="";
-	bool status=false;
-	while((status=read(&retChar,sizeof(char))) && (char)retChar!='\0')
+	StreamLockObj lock(this);
+	size_t charCount;
+	bool isTerminated=scanString(sizeof(char),charCount);
+	// read the characters with the terminator in one copy, and drop the terminator.
+	size_t readCount=isTerminated?charCount+1:charCount;
+	retString.resize(readCount);
+	if(readCount && !read(&retString[0],readCount*sizeof(char)))
 	{
-		retString=retString.append(1,retChar);
+		retString="";
+		return false;
 	}
-	return status;
+	retString.resize(charCount);
+	return isTerminated;
 }
 bool Stream::ReadWString(EpWString &retString)
 {
-	LockObj lock(m_streamLock);
-	wchar_t retChar;
-	retString=WIDEN("");
-	bool status=false;
-	while((status=read(&retChar,sizeof(wchar_t))) && (wchar_t)retChar!=WIDEN('\0'))
+	StreamLockObj lock(this);
+	size_t charCount;
+	bool isTerminated=scanString(sizeof(wchar_t),charCount);
+	size_t readCount=isTerminated?charCount+1:charCount;
+	retString.resize(readCount);
+	if(readCount && !read(&retString[0],readCount*sizeof(wchar_t)))
 	{
-		retString=retString.append(1,retChar);
+		retString=WIDEN("");
+		return false;
 	}
-	return status;
+	retString.resize(charCount);
+	return isTerminated;
 }
 bool Stream::ReadTString(EpTString &retString)
 {
-	LockObj lock(m_streamLock);
-	TCHAR retChar;
-	retString=_T("");
-	bool status=false;
-	while((status=read(&retChar,sizeof(TCHAR))) && (TCHAR)retChar!=_T('\0'))
+	StreamLockObj lock(this);
+	size_t charCount;
+	bool isTerminated=scanString(sizeof(TCHAR),charCount);
+	size_t readCount=isTerminated?charCount+1:charCount;
+	retString.resize(readCount);
+	if(readCount && !read(&retString[0],readCount*sizeof(TCHAR)))
+	{
+		retString=_T("");
+		return false;
+	}
+	retString.resize(charCount);
+	return isTerminated;
+}
+
+bool Stream::ReadPrefixedString(EpString &retString)
+{
+	StreamLockObj lock(this);
+	size_t charCount;
+	unsigned int prefix;
+	if(!scanPrefixedString(sizeof(char),charCount) || !read(&prefix,sizeof(unsigned int)))
+		return false;
+	retString.resize(charCount);
+	if(charCount && !read(&retString[0],charCount*sizeof(char)))
+	{
+		retString="";
+		return false;
+	}
+	return true;
+}
+bool Stream::ReadPrefixedWString(EpWString &retString)
+{
+	StreamLockObj lock(this);
+	size_t charCount;
+	unsigned int prefix;
+	if(!scanPrefixedString(sizeof(wchar_t),charCount) || !read(&prefix,sizeof(unsigned int)))
+		return false;
+	retString.resize(charCount);
+	if(charCount && !read(&retString[0],charCount*sizeof(wchar_t)))
+	{
+		retString=WIDEN("");
+		return false;
+	}
+	return true;
+}
+bool Stream::ReadPrefixedTString(EpTString &retString)
+{
+	StreamLockObj lock(this);
+	size_t charCount;
+	unsigned int prefix;
+	if(!scanPrefixedString(sizeof(TCHAR),charCount) || !read(&prefix,sizeof(unsigned int)))
+		return false;
+	retString.resize(charCount);
+	if(charCount && !read(&retString[0],charCount*sizeof(TCHAR)))
+	{
+		retString=_T("");
+		return false;
+	}
+	return true;
+}
+bool Stream::ReadPrefixedUtf8String(EpTString &retString)
+{
+	StreamLockObj lock(this);
+	size_t byteCount;
+	unsigned int prefix;
+	if(!scanPrefixedString(sizeof(char),byteCount) || !read(&prefix,sizeof(unsigned int)))
+		return false;
+	EpString utf8String;
+	utf8String.resize(byteCount);
+	if(byteCount && !read(&utf8String[0],byteCount*sizeof(char)))
+	{
+		retString=_T("");
+		return false;
+	}
+#if defined(_UNICODE) || defined(UNICODE)
+	retString=UnicodeHelper::Utf8ToUtf16(utf8String);
+#else //defined(_UNICODE) || defined(UNICODE)
+	EpWString wideString=UnicodeHelper::Utf8ToUtf16(utf8String);
+	if(wideString.empty())
+		retString="";
+	else
+		retString=System::WideCharToMultiByte(wideString.c_str(),static_cast<int>(wideString.size()));
+#endif //defined(_UNICODE) || defined(UNICODE)
+	return true;
+}
+
+size_t &Stream::readOffset()
+{
+	return m_offset;
+}
+
+bool Stream::scanString(size_t charSize, size_t &retCharCount)
+{
+	retCharCount=0;
+	size_t offset=readOffset();
+	size_t streamSize=m_stream.GetSize();
+	if(offset>=streamSize)
+		return false;
+	const unsigned char *data=m_stream.GetData()+offset;
+	size_t charCount=(streamSize-offset)/charSize;
+	if(charSize==sizeof(char))
+	{
+		const unsigned char *terminator=reinterpret_cast<const unsigned char*>(memchr(data,'\0',charCount));
+		if(terminator)
+		{
+			retCharCount=terminator-data;
+			return true;
+		}
+	}
+	else if(charSize==sizeof(wchar_t) && reinterpret_cast<size_t>(data)%sizeof(wchar_t)==0)
 	{
-		retString=retString.append(1,static_cast<TCHAR>(retChar));
+		const wchar_t *wideData=reinterpret_cast<const wchar_t*>(data);
+		const wchar_t *terminator=wmemchr(wideData,L'\0',charCount);
+		if(terminator)
+		{
+			retCharCount=terminator-wideData;
+			return true;
+		}
 	}
-	return status;
+	else
+	{
+		// the unaligned characters are checked byte by byte.
+		for(size_t charTrav=0;charTrav<charCount;charTrav++)
+		{
+			const unsigned char *character=data+charTrav*charSize;
+			size_t byteTrav;
+			for(byteTrav=0;byteTrav<charSize && character[byteTrav]==0;byteTrav++);
+			if(byteTrav==charSize)
+			{
+				retCharCount=charTrav;
+				return true;
+			}
+		}
+	}
+	retCharCount=charCount;
+	return false;
+}
+
+bool Stream::writeOrdered(const void *value, size_t elementSize, size_t count)
+{
+	if(!m_isSwapped || elementSize==1)
+		return write(value,elementSize*count);
+	if(!value)
+		return false;
+
+	// swap through the buffer on the stack, so the derived write still holds the data.
+	unsigned char swapBuffer[STREAM_SWAP_BUFFER_SIZE];
+	size_t bufferCount=STREAM_SWAP_BUFFER_SIZE/elementSize;
+	const unsigned char *source=reinterpret_cast<const unsigned char*>(value);
+	while(count)
+	{
+		size_t swapCount=(count<bufferCount)?count:bufferCount;
+		Endian::SwapBytes(swapBuffer,source,elementSize,swapCount);
+		if(!write(swapBuffer,elementSize*swapCount))
+			return false;
+		source+=elementSize*swapCount;
+		count-=swapCount;
+	}
+	return true;
+}
+
+bool Stream::readOrdered(void *retValue, size_t elementSize, size_t count)
+{
+	if(!read(retValue,elementSize*count))
+		return false;
+	if(m_isSwapped && elementSize>1)
+		Endian::SwapBytes(retValue,retValue,elementSize,count);
+	return true;
+}
+
+bool Stream::scanPrefixedString(size_t charSize, size_t &retCharCount)
+{
+	retCharCount=0;
+	size_t offset=readOffset();
+	size_t streamSize=m_stream.GetSize();
+	if(offset>streamSize || streamSize-offset<sizeof(unsigned int))
+		return false;
+	unsigned int charCount;
+	System::Memcpy(&charCount,m_stream.GetData()+offset,sizeof(unsigned int));
+	if(charCount>(streamSize-offset-sizeof(unsigned int))/charSize)
+		return false;
+	retCharCount=charCount;
+	return true;
 }
 
 
 bool Stream::WriteStreamToFile(const TCHAR *fileName)
 {
-	LockObj lock(m_streamLock);
+	StreamLockObj lock(this);
 	if(System::TcsLen(fileName)==0)
 	{
 		LOG_THIS_MSG(_T("File Name Not Set!"));
 		return false;
 	}
-	if(m_stream.empty())
+	if(m_stream.IsEmpty())
 	{
 		LOG_THIS_MSG(_T("There is no stream data!"));
 		return false;
 	}
 	EpFile *file;
 	System::FTOpen(file,fileName,_T("wt"));
-	System::FWrite(&m_stream.at(0),sizeof(unsigned char),m_stream.size(),file);
+	System::FWrite(m_stream.GetData(),sizeof(unsigned char),m_stream.GetSize(),file);
 	System::FClose(file);
 	return true;
 }
@@ -0,0 +1,617 @@
+/*! 
+StreamBenchmark for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epStreamBenchmark.h"
+#include "epSystem.h"
+#include "epStream.h"
+#include "epNetworkStream.h"
+#include "epFileStream.h"
+#include "epBinaryFile.h"
+#include <vector>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the byte size of the smallest file measured
+#define STREAM_BENCHMARK_MIN_FILE_SIZE (64*1024)
+
+/// the byte size written or read by one call in the file benchmarks
+#define STREAM_BENCHMARK_IO_SIZE (64*1024)
+
+/// the number of the values written or read by one call in the bulk benchmarks
+#define STREAM_BENCHMARK_BULK_COUNT 256
+
+/// the byte size of the packet in the network stream benchmarks
+#define STREAM_BENCHMARK_PACKET_SIZE 64
+
+/// the number of the packets read between the flushes of the manual network stream
+#define STREAM_BENCHMARK_FLUSH_BATCH 64
+
+/// the lock policies measured
+static const LockPolicy s_lockPolicyList[]={LOCK_POLICY_NONE,LOCK_POLICY_CRITICALSECTION,LOCK_POLICY_MUTEX,LOCK_POLICY_SPIN_PARK,LOCK_POLICY_READER_WRITER};
+
+/// the names of the lock policies measured
+static const TCHAR *s_lockPolicyNameList[]={_T("NONE"),_T("CRITICALSECTION"),_T("MUTEX"),_T("SPIN_PARK"),_T("READER_WRITER")};
+
+static bool writeValue(Stream &stream, unsigned char value){return stream.WriteByte(value);}
+static bool writeValue(Stream &stream, short value){return stream.WriteShort(value);}
+static bool writeValue(Stream &stream, int value){return stream.WriteInt(value);}
+static bool writeValue(Stream &stream, float value){return stream.WriteFloat(value);}
+static bool writeValue(Stream &stream, double value){return stream.WriteDouble(value);}
+static bool readValue(Stream &stream, unsigned char &retValue){return stream.ReadByte(retValue);}
+static bool readValue(Stream &stream, short &retValue){return stream.ReadShort(retValue);}
+static bool readValue(Stream &stream, int &retValue){return stream.ReadInt(retValue);}
+static bool readValue(Stream &stream, float &retValue){return stream.ReadFloat(retValue);}
+static bool readValue(Stream &stream, double &retValue){return stream.ReadDouble(retValue);}
+
+namespace epl
+{
+	/*!
+	@class StreamValueCase epStreamBenchmark.cpp
+	@brief A benchmark case writing or reading one primitive per operation.
+	*/
+	template<typename ValueType>
+	class StreamValueCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] isRead the flag whether to measure reading instead of writing.
+		@param[in] lockPolicyType the lock policy of the stream.
+		*/
+		StreamValueCase(bool isRead, LockPolicy lockPolicyType):m_stream(lockPolicyType)
+		{
+			m_isRead=isRead;
+			m_sink=ValueType();
+		}
+
+		/*!
+		Reserve the stream for writing, or write the values to read.
+		@param[in] iterationCount the number of the values.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_stream.Clear();
+			m_stream.Reserve(static_cast<size_t>(iterationCount)*sizeof(ValueType));
+			if(m_isRead)
+			{
+				for(unsigned int valueTrav=0;valueTrav<iterationCount;valueTrav++)
+					writeValue(m_stream,static_cast<ValueType>(valueTrav));
+				m_stream.SetSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET,0);
+			}
+		}
+
+		/*!
+		Write or read the values.
+		@param[in] iterationCount the number of the values.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			if(m_isRead)
+			{
+				ValueType value=ValueType();
+				for(unsigned int valueTrav=0;valueTrav<iterationCount;valueTrav++)
+				{
+					readValue(m_stream,value);
+					m_sink+=value;
+				}
+			}
+			else
+			{
+				for(unsigned int valueTrav=0;valueTrav<iterationCount;valueTrav++)
+					writeValue(m_stream,static_cast<ValueType>(valueTrav));
+			}
+		}
+
+		/*!
+		Free the stream.
+		*/
+		virtual void TearDown()
+		{
+			m_stream.Clear();
+		}
+
+	private:
+		/// the stream measured
+		Stream m_stream;
+		/// the flag whether to measure reading
+		bool m_isRead;
+		/// the sum of the values read, so the reads are not optimized out
+		ValueType m_sink;
+	};
+
+	/*!
+	@class StreamBulkCase epStreamBenchmark.cpp
+	@brief A benchmark case writing or reading STREAM_BENCHMARK_BULK_COUNT integers per operation.
+	*/
+	class StreamBulkCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] isRead the flag whether to measure reading instead of writing.
+		@param[in] lockPolicyType the lock policy of the stream.
+		*/
+		StreamBulkCase(bool isRead, LockPolicy lockPolicyType):m_stream(lockPolicyType),m_valueList(STREAM_BENCHMARK_BULK_COUNT)
+		{
+			m_isRead=isRead;
+			for(unsigned int valueTrav=0;valueTrav<STREAM_BENCHMARK_BULK_COUNT;valueTrav++)
+				m_valueList[valueTrav]=static_cast<int>(valueTrav);
+		}
+
+		/*!
+		Reserve the stream for writing, or write the values to read.
+		@param[in] iterationCount the number of the bulks.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_stream.Clear();
+			m_stream.Reserve(static_cast<size_t>(iterationCount)*STREAM_BENCHMARK_BULK_COUNT*sizeof(int));
+			if(m_isRead)
+			{
+				for(unsigned int bulkTrav=0;bulkTrav<iterationCount;bulkTrav++)
+					m_stream.WriteInts(&m_valueList[0],STREAM_BENCHMARK_BULK_COUNT);
+				m_stream.SetSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET,0);
+			}
+		}
+
+		/*!
+		Write or read the bulks.
+		@param[in] iterationCount the number of the bulks.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int bulkTrav=0;bulkTrav<iterationCount;bulkTrav++)
+			{
+				if(m_isRead)
+					m_stream.ReadInts(&m_valueList[0],STREAM_BENCHMARK_BULK_COUNT);
+				else
+					m_stream.WriteInts(&m_valueList[0],STREAM_BENCHMARK_BULK_COUNT);
+			}
+		}
+
+		/*!
+		Free the stream.
+		*/
+		virtual void TearDown()
+		{
+			m_stream.Clear();
+		}
+
+	private:
+		/// the stream measured
+		Stream m_stream;
+		/// the flag whether to measure reading
+		bool m_isRead;
+		/// the values written or read
+		std::vector<int> m_valueList;
+	};
+
+	/*!
+	@class StreamStringCase epStreamBenchmark.cpp
+	@brief A benchmark case writing or reading one string per operation.
+	*/
+	class StreamStringCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] isRead the flag whether to measure reading instead of writing.
+		@param[in] isPrefixed the flag whether the string is prefixed with its length instead of terminated.
+		@param[in] length the length of the string.
+		@param[in] lockPolicyType the lock policy of the stream.
+		*/
+		StreamStringCase(bool isRead, bool isPrefixed, size_t length, LockPolicy lockPolicyType):m_stream(lockPolicyType)
+		{
+			m_isRead=isRead;
+			m_isPrefixed=isPrefixed;
+			for(size_t charTrav=0;charTrav<length;charTrav++)
+				m_string.push_back(static_cast<char>('a'+charTrav%26));
+		}
+
+		/*!
+		Return the byte size of one string in the stream.
+		@return the byte size of one string.
+		*/
+		size_t GetByteSize() const
+		{
+			return m_string.length()+(m_isPrefixed?sizeof(unsigned int):sizeof(char));
+		}
+
+		/*!
+		Reserve the stream for writing, or write the strings to read.
+		@param[in] iterationCount the number of the strings.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_stream.Clear();
+			m_stream.Reserve(static_cast<size_t>(iterationCount)*GetByteSize());
+			if(m_isRead)
+			{
+				for(unsigned int stringTrav=0;stringTrav<iterationCount;stringTrav++)
+					write();
+				m_stream.SetSeek(Stream::STREAM_SEEK_TYPE_SEEK_SET,0);
+			}
+		}
+
+		/*!
+		Write or read the strings.
+		@param[in] iterationCount the number of the strings.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			EpString value;
+			for(unsigned int stringTrav=0;stringTrav<iterationCount;stringTrav++)
+			{
+				if(!m_isRead)
+					write();
+				else if(m_isPrefixed)
+					m_stream.ReadPrefixedString(value);
+				else
+					m_stream.ReadString(value);
+			}
+		}
+
+		/*!
+		Free the stream.
+		*/
+		virtual void TearDown()
+		{
+			m_stream.Clear();
+		}
+
+	private:
+		/*!
+		Write the string to the stream.
+		*/
+		void write()
+		{
+			if(m_isPrefixed)
+				m_stream.WritePrefixedString(m_string);
+			else
+				m_stream.WriteString(m_string);
+		}
+
+		/// the stream measured
+		Stream m_stream;
+		/// the flag whether to measure reading
+		bool m_isRead;
+		/// the flag whether the string is prefixed
+		bool m_isPrefixed;
+		/// the string written
+		EpString m_string;
+	};
+
+	/*!
+	@class NetworkStreamCase epStreamBenchmark.cpp
+	@brief A benchmark case writing and reading one packet per operation through the network stream.
+	*/
+	class NetworkStreamCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] flushType the flush type of the network stream.
+		*/
+		NetworkStreamCase(NetworkStream::NetworkStreamFlushType flushType):m_stream(flushType,LOCK_POLICY_NONE)
+		{
+			for(unsigned int byteTrav=0;byteTrav<STREAM_BENCHMARK_PACKET_SIZE;byteTrav++)
+				m_packet[byteTrav]=static_cast<unsigned char>(byteTrav);
+		}
+
+		/*!
+		Write and read the packets.
+		@param[in] iterationCount the number of the packets.
+		@remark the manual stream is flushed every STREAM_BENCHMARK_FLUSH_BATCH packets.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			bool isManual=m_stream.GetFlushType()==NetworkStream::NETWORK_STREAM_FLUSH_TYPE_MANUAL;
+			for(unsigned int packetTrav=0;packetTrav<iterationCount;packetTrav++)
+			{
+				m_stream.WriteBytes(m_packet,STREAM_BENCHMARK_PACKET_SIZE);
+				m_stream.ReadBytes(m_packet,STREAM_BENCHMARK_PACKET_SIZE);
+				if(isManual && packetTrav%STREAM_BENCHMARK_FLUSH_BATCH==STREAM_BENCHMARK_FLUSH_BATCH-1)
+					m_stream.Flush();
+			}
+		}
+
+		/*!
+		Empty the stream.
+		*/
+		virtual void TearDown()
+		{
+			m_stream.Clear();
+		}
+
+	private:
+		/// the stream measured
+		NetworkStream m_stream;
+		/// the packet written and read
+		unsigned char m_packet[STREAM_BENCHMARK_PACKET_SIZE];
+	};
+
+	/// Enumeration for the file operation measured
+	enum StreamBenchmarkFileOp{
+		/// FileStream::WriteStreamToFile
+		STREAM_BENCHMARK_FILE_OP_SAVE=0,
+		/// FileStream::LoadStreamFromFile
+		STREAM_BENCHMARK_FILE_OP_LOAD,
+		/// FileStream chunked write
+		STREAM_BENCHMARK_FILE_OP_CHUNKED_WRITE,
+		/// FileStream chunked read
+		STREAM_BENCHMARK_FILE_OP_CHUNKED_READ,
+		/// FileStream unbuffered chunked write
+		STREAM_BENCHMARK_FILE_OP_UNBUFFERED_WRITE,
+		/// FileStream unbuffered chunked read
+		STREAM_BENCHMARK_FILE_OP_UNBUFFERED_READ,
+		/// FileStream mapped read
+		STREAM_BENCHMARK_FILE_OP_MAPPED_READ,
+		/// BinaryFile::SaveToFile
+		STREAM_BENCHMARK_FILE_OP_BINARY_SAVE,
+		/// BinaryFile::LoadFromFile
+		STREAM_BENCHMARK_FILE_OP_BINARY_LOAD,
+		/// File Operation Count
+		STREAM_BENCHMARK_FILE_OP_COUNT,
+	};
+
+	/// the names of the file operations
+	static const TCHAR *s_fileOpNameList[STREAM_BENCHMARK_FILE_OP_COUNT]={_T("FileStreamSave"),_T("FileStreamLoad"),_T("FileStreamChunkedWrite"),_T("FileStreamChunkedRead"),_T("FileStreamUnbufferedWrite"),_T("FileStreamUnbufferedRead"),_T("FileStreamMappedRead"),_T("BinaryFileSave"),_T("BinaryFileLoad")};
+
+	/*!
+	@class FileCase epStreamBenchmark.cpp
+	@brief A benchmark case saving or loading the whole file per operation.
+	*/
+	class FileCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] fileOp the file operation to measure.
+		@param[in] fileName the name of the file to write and read.
+		@param[in] byteSize the byte size of the file.
+		*/
+		FileCase(StreamBenchmarkFileOp fileOp, const TCHAR *fileName, size_t byteSize):m_stream(fileName,LOCK_POLICY_NONE),m_binaryFile(LOCK_POLICY_NONE),m_buffer(STREAM_BENCHMARK_IO_SIZE)
+		{
+			m_fileOp=fileOp;
+			m_fileName=fileName;
+			m_byteSize=byteSize;
+			for(size_t byteTrav=0;byteTrav<m_buffer.size();byteTrav++)
+				m_buffer[byteTrav]=static_cast<unsigned char>(byteTrav*7);
+		}
+
+		/*!
+		Prepare the stream to save, or the file to load.
+		@param[in] iterationCount the number of the files.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			switch(m_fileOp)
+			{
+			case STREAM_BENCHMARK_FILE_OP_SAVE:
+			case STREAM_BENCHMARK_FILE_OP_LOAD:
+			case STREAM_BENCHMARK_FILE_OP_CHUNKED_READ:
+			case STREAM_BENCHMARK_FILE_OP_UNBUFFERED_READ:
+			case STREAM_BENCHMARK_FILE_OP_MAPPED_READ:
+			case STREAM_BENCHMARK_FILE_OP_BINARY_LOAD:
+				fill(m_stream);
+				m_stream.WriteStreamToFile();
+				if(m_fileOp!=STREAM_BENCHMARK_FILE_OP_SAVE)
+					m_stream.Clear();
+				break;
+			case STREAM_BENCHMARK_FILE_OP_BINARY_SAVE:
+				fill(m_binaryFile.GetStream());
+				break;
+			default:
+				break;
+			}
+		}
+
+		/*!
+		Save or load the file.
+		@param[in] iterationCount the number of the files.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int fileTrav=0;fileTrav<iterationCount;fileTrav++)
+			{
+				switch(m_fileOp)
+				{
+				case STREAM_BENCHMARK_FILE_OP_SAVE:
+					m_stream.WriteStreamToFile();
+					break;
+				case STREAM_BENCHMARK_FILE_OP_LOAD:
+					m_stream.LoadStreamFromFile();
+					break;
+				case STREAM_BENCHMARK_FILE_OP_CHUNKED_WRITE:
+				case STREAM_BENCHMARK_FILE_OP_UNBUFFERED_WRITE:
+					m_stream.OpenChunkedStream(FileStream::FILE_STREAM_CHUNK_TYPE_WRITE,FILE_STREAM_CHUNK_SIZE,m_fileOp==STREAM_BENCHMARK_FILE_OP_UNBUFFERED_WRITE);
+					fill(m_stream);
+					m_stream.CloseChunkedStream();
+					break;
+				case STREAM_BENCHMARK_FILE_OP_CHUNKED_READ:
+				case STREAM_BENCHMARK_FILE_OP_UNBUFFERED_READ:
+					m_stream.OpenChunkedStream(FileStream::FILE_STREAM_CHUNK_TYPE_READ,FILE_STREAM_CHUNK_SIZE,m_fileOp==STREAM_BENCHMARK_FILE_OP_UNBUFFERED_READ);
+					drain(m_stream);
+					m_stream.CloseChunkedStream();
+					break;
+				case STREAM_BENCHMARK_FILE_OP_MAPPED_READ:
+					m_stream.MapStreamFromFile(FileStream::FILE_STREAM_MAP_TYPE_READ_ONLY);
+					drain(m_stream);
+					m_stream.UnmapStream();
+					break;
+				case STREAM_BENCHMARK_FILE_OP_BINARY_SAVE:
+					m_binaryFile.SaveToFile(m_fileName.c_str());
+					break;
+				case STREAM_BENCHMARK_FILE_OP_BINARY_LOAD:
+					m_binaryFile.LoadFromFile(m_fileName.c_str());
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		/*!
+		Free the streams.
+		*/
+		virtual void TearDown()
+		{
+			m_stream.Clear();
+			m_binaryFile.GetStream().Clear();
+		}
+
+	private:
+		/*!
+		Write the data of the file size to the stream.
+		@param[in] stream the stream to write to.
+		*/
+		void fill(Stream &stream)
+		{
+			for(size_t offset=0;offset<m_byteSize;offset+=m_buffer.size())
+			{
+				size_t writeSize=m_byteSize-offset<m_buffer.size()?m_byteSize-offset:m_buffer.size();
+				stream.WriteBytes(&m_buffer[0],writeSize);
+			}
+		}
+
+		/*!
+		Read the data of the file size from the stream.
+		@param[in] stream the stream to read from.
+		*/
+		void drain(Stream &stream)
+		{
+			for(size_t offset=0;offset<m_byteSize;offset+=m_buffer.size())
+			{
+				size_t readSize=m_byteSize-offset<m_buffer.size()?m_byteSize-offset:m_buffer.size();
+				stream.ReadBytes(&m_buffer[0],readSize);
+			}
+		}
+
+		/// the file operation measured
+		StreamBenchmarkFileOp m_fileOp;
+		/// the name of the file
+		EpTString m_fileName;
+		/// the byte size of the file
+		size_t m_byteSize;
+		/// the file stream measured
+		FileStream m_stream;
+		/// the binary file measured
+		BinaryFile m_binaryFile;
+		/// the data written or read by one call
+		std::vector<unsigned char> m_buffer;
+	};
+}
+
+/*!
+Measure the case writing and reading the primitive, for both directions.
+@param[in] valueName the name of the primitive.
+@param[in] policyIdx the index of the lock policy.
+@param[in] minTime the time in milliseconds each measurement runs at least.
+*/
+template<typename ValueType>
+static void runValueCase(const TCHAR *valueName, size_t policyIdx, unsigned int minTime)
+{
+	EpTString caseName;
+	StreamValueCase<ValueType> writeCase(false,s_lockPolicyList[policyIdx]);
+	System::STPrintf(caseName,_T("Write%s"),valueName);
+	BENCHMARK_INSTANCE.Run(_T("Stream"),caseName.c_str(),s_lockPolicyNameList[policyIdx],writeCase,sizeof(ValueType),minTime);
+	StreamValueCase<ValueType> readCase(true,s_lockPolicyList[policyIdx]);
+	System::STPrintf(caseName,_T("Read%s"),valueName);
+	BENCHMARK_INSTANCE.Run(_T("Stream"),caseName.c_str(),s_lockPolicyNameList[policyIdx],readCase,sizeof(ValueType),minTime);
+}
+
+void StreamBenchmark::Run(const TCHAR *workFileName, size_t maxFileSize, unsigned int minTime)
+{
+	RunStream(minTime);
+	RunNetworkStream(minTime);
+	RunFile(workFileName,maxFileSize,minTime);
+}
+
+void StreamBenchmark::RunStream(unsigned int minTime)
+{
+	for(size_t policyTrav=0;policyTrav<sizeof(s_lockPolicyList)/sizeof(LockPolicy);policyTrav++)
+	{
+		const TCHAR *policyName=s_lockPolicyNameList[policyTrav];
+		runValueCase<unsigned char>(_T("Byte"),policyTrav,minTime);
+		runValueCase<short>(_T("Short"),policyTrav,minTime);
+		runValueCase<int>(_T("Int"),policyTrav,minTime);
+		runValueCase<float>(_T("Float"),policyTrav,minTime);
+		runValueCase<double>(_T("Double"),policyTrav,minTime);
+
+		StreamBulkCase bulkWriteCase(false,s_lockPolicyList[policyTrav]);
+		BENCHMARK_INSTANCE.Run(_T("Stream"),_T("WriteInts"),policyName,bulkWriteCase,STREAM_BENCHMARK_BULK_COUNT*sizeof(int),minTime);
+		StreamBulkCase bulkReadCase(true,s_lockPolicyList[policyTrav]);
+		BENCHMARK_INSTANCE.Run(_T("Stream"),_T("ReadInts"),policyName,bulkReadCase,STREAM_BENCHMARK_BULK_COUNT*sizeof(int),minTime);
+
+		// the short strings stress the per call cost, and the long strings the scan for the terminator.
+		static const size_t s_lengthList[]={16,256};
+		for(size_t lengthTrav=0;lengthTrav<sizeof(s_lengthList)/sizeof(size_t);lengthTrav++)
+		{
+			EpTString caseName;
+			for(int prefixTrav=0;prefixTrav<2;prefixTrav++)
+			{
+				bool isPrefixed=prefixTrav==1;
+				StreamStringCase writeCase(false,isPrefixed,s_lengthList[lengthTrav],s_lockPolicyList[policyTrav]);
+				System::STPrintf(caseName,isPrefixed?_T("WritePrefixedString%u"):_T("WriteString%u"),static_cast<unsigned int>(s_lengthList[lengthTrav]));
+				BENCHMARK_INSTANCE.Run(_T("Stream"),caseName.c_str(),policyName,writeCase,writeCase.GetByteSize(),minTime);
+				StreamStringCase readCase(true,isPrefixed,s_lengthList[lengthTrav],s_lockPolicyList[policyTrav]);
+				System::STPrintf(caseName,isPrefixed?_T("ReadPrefixedString%u"):_T("ReadString%u"),static_cast<unsigned int>(s_lengthList[lengthTrav]));
+				BENCHMARK_INSTANCE.Run(_T("Stream"),caseName.c_str(),policyName,readCase,readCase.GetByteSize(),minTime);
+			}
+		}
+	}
+}
+
+void StreamBenchmark::RunNetworkStream(unsigned int minTime)
+{
+	NetworkStreamCase manualCase(NetworkStream::NETWORK_STREAM_FLUSH_TYPE_MANUAL);
+	BENCHMARK_INSTANCE.Run(_T("NetworkStream"),_T("WriteReadPacket"),_T("MANUAL"),manualCase,STREAM_BENCHMARK_PACKET_SIZE,minTime);
+	NetworkStreamCase autoCase(NetworkStream::NETWORK_STREAM_FLUSH_TYPE_AUTO);
+	BENCHMARK_INSTANCE.Run(_T("NetworkStream"),_T("WriteReadPacket"),_T("AUTO"),autoCase,STREAM_BENCHMARK_PACKET_SIZE,minTime);
+}
+
+void StreamBenchmark::RunFile(const TCHAR *workFileName, size_t maxFileSize, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(workFileName,_T("The work file name is NULL."));
+	for(size_t fileSize=STREAM_BENCHMARK_MIN_FILE_SIZE;fileSize<=maxFileSize;fileSize*=16)
+	{
+		EpTString parameter;
+		System::STPrintf(parameter,_T("%u"),static_cast<unsigned int>(fileSize));
+		for(int opTrav=0;opTrav<STREAM_BENCHMARK_FILE_OP_COUNT;opTrav++)
+		{
+			FileCase fileCase(static_cast<StreamBenchmarkFileOp>(opTrav),workFileName,fileSize);
+			BENCHMARK_INSTANCE.Run(_T("File"),s_fileOpNameList[opTrav],parameter.c_str(),fileCase,fileSize,minTime);
+		}
+		if(fileSize>maxFileSize/16)
+			break;
+	}
+	DeleteFile(workFileName);
+}
\ No newline at end of file
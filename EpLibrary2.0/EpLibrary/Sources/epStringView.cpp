@@ -0,0 +1,164 @@
+/*! 
+StringView for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epStringView.h"
+#include <string.h>
+#include <wchar.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/*!
+Find the given character in the given characters by memchr.
+@param[in] str the characters to scan.
+@param[in] c the character to find.
+@param[in] length the number of the characters.
+@return the pointer to the character found, or NULL if not found.
+*/
+static const TCHAR *findChar(const TCHAR *str, TCHAR c, size_t length)
+{
+#if defined(_UNICODE) || defined(UNICODE)
+	return wmemchr(str,c,length);
+#else //defined(_UNICODE) || defined(UNICODE)
+	return reinterpret_cast<const TCHAR*>(memchr(str,c,length));
+#endif //defined(_UNICODE) || defined(UNICODE)
+}
+
+StringView::StringView(const TCHAR *str)
+{
+	if(str==NULL)
+		str=_T("");
+	m_begin=str;
+	m_length=_tcslen(str);
+}
+
+int StringView::Find(TCHAR c, int start) const
+{
+	if(start<0)
+		start=0;
+	if(static_cast<size_t>(start)>=m_length)
+		return -1;
+	const TCHAR *found=findChar(m_begin+start,c,m_length-start);
+	if(found==NULL)
+		return -1;
+	return static_cast<int>(found-m_begin);
+}
+
+int StringView::ReverseFind(TCHAR c) const
+{
+	for(size_t charTrav=m_length;charTrav>0;charTrav--)
+	{
+		if(m_begin[charTrav-1]==c)
+			return static_cast<int>(charTrav-1);
+	}
+	return -1;
+}
+
+StringView StringView::Left(TCHAR c, int n) const
+{
+	int idx=-1;
+	while(n>0)
+	{
+		idx=Find(c,idx+1);
+		if(idx==-1)
+			return *this;
+		--n;
+	}
+	if(idx<0)
+		return StringView(m_begin,0);
+	return StringView(m_begin,idx);
+}
+
+StringView StringView::Right(TCHAR c, int n) const
+{
+	int idx=-1;
+	while(n>0)
+	{
+		idx=Find(c,idx+1);
+		if(idx==-1)
+			return StringView(m_begin+m_length,0);
+		--n;
+	}
+	return StringView(m_begin+idx+1,m_length-idx-1);
+}
+
+StringView StringView::Rightmost(TCHAR c) const
+{
+	int idx=ReverseFind(c);
+	if(idx==-1)
+		return StringView(m_begin+m_length,0);
+	return StringView(m_begin+idx+1,m_length-idx-1);
+}
+
+StringView StringView::LeftOfRightmost(TCHAR c) const
+{
+	int idx=ReverseFind(c);
+	if(idx==-1)
+		return StringView(m_begin,0);
+	return StringView(m_begin,idx);
+}
+
+StringView StringView::SubStr(int begin, int len) const
+{
+	if(begin<0)
+		begin=0;
+	if(len<0)
+		len=0;
+	if(static_cast<size_t>(begin)>m_length)
+		begin=static_cast<int>(m_length);
+	if(static_cast<size_t>(len)>m_length-begin)
+		len=static_cast<int>(m_length-begin);
+	return StringView(m_begin+begin,len);
+}
+
+StringView StringView::TrimLeft() const
+{
+	size_t begin=Locale::TrimLeftIndex(m_begin,m_length);
+	return StringView(m_begin+begin,m_length-begin);
+}
+
+StringView StringView::TrimRight() const
+{
+	return StringView(m_begin,Locale::TrimRightIndex(m_begin,m_length));
+}
+
+StringView StringView::Trim() const
+{
+	size_t end=Locale::TrimRightIndex(m_begin,m_length);
+	size_t begin=Locale::TrimLeftIndex(m_begin,end);
+	return StringView(m_begin+begin,end-begin);
+}
+
+bool StringView::Equals(const StringView &str) const
+{
+	if(m_length!=str.m_length)
+		return false;
+	return m_length==0 || memcmp(m_begin,str.m_begin,m_length*sizeof(TCHAR))==0;
+}
@@ -0,0 +1,738 @@
+/*! 
+SyncBenchmark for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epSyncBenchmark.h"
+#include "epSystem.h"
+#include "epThread.h"
+#include "epEventEx.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epSemaphore.h"
+#include "epInterlockedEx.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
+#include "epThreadSafeQueue.h"
+#include "epThreadSafePQueue.h"
+#include "epSmartObject.h"
+#include "epTinyObject.h"
+#include <vector>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the byte size of the cache line each object of the threads is padded to
+#define SYNC_BENCHMARK_CACHE_LINE_SIZE 64
+
+/// the number of the lock policies measured for the queues
+#define SYNC_BENCHMARK_LOCK_POLICY_COUNT 4
+
+/// the names of the locks measured
+static const TCHAR *s_lockNameList[SYNC_BENCHMARK_LOCK_COUNT]={_T("CRITICALSECTION"),_T("MUTEX"),_T("SEMAPHORE"),_T("INTERLOCKED"),_T("SPIN_PARK"),_T("READER_WRITER")};
+
+/// the names of the contentions measured
+static const TCHAR *s_contentionNameList[SYNC_BENCHMARK_CONTENTION_COUNT]={_T("NONE"),_T("LOW"),_T("HIGH")};
+
+/// the lock policies guarding the queues measured
+static const LockPolicy s_lockPolicyList[SYNC_BENCHMARK_LOCK_POLICY_COUNT]={LOCK_POLICY_CRITICALSECTION,LOCK_POLICY_MUTEX,LOCK_POLICY_SPIN_PARK,LOCK_POLICY_READER_WRITER};
+
+/// the names of the lock policies guarding the queues measured
+static const TCHAR *s_lockPolicyNameList[SYNC_BENCHMARK_LOCK_POLICY_COUNT]={_T("CRITICALSECTION"),_T("MUTEX"),_T("SPIN_PARK"),_T("READER_WRITER")};
+
+/*!
+Do the work between the operations of the low contention, which touches no shared memory.
+*/
+static void doWork()
+{
+	volatile unsigned int work=0;
+	for(unsigned int workTrav=0;workTrav<SYNC_BENCHMARK_WORK_COUNT;workTrav++)
+		work=work+workTrav;
+}
+
+/*!
+Return the thread counts to measure, doubling from 1 and ending with the largest.
+@param[in] maxThreadCount the largest number of the threads, or 0 for the number of the cores.
+@param[out] retThreadCountList the thread counts to measure.
+*/
+static void getThreadCountList(unsigned int maxThreadCount, std::vector<unsigned int> &retThreadCountList)
+{
+	if(maxThreadCount==0)
+		maxThreadCount=static_cast<unsigned int>(System::GetNumberOfCores());
+	if(maxThreadCount==0)
+		maxThreadCount=1;
+	retThreadCountList.clear();
+	for(unsigned int threadCount=1;threadCount<maxThreadCount;threadCount*=2)
+		retThreadCountList.push_back(threadCount);
+	retThreadCountList.push_back(maxThreadCount);
+}
+
+namespace epl
+{
+	/*!
+	@class SyncBenchmarkSlot epSyncBenchmark.cpp
+	@brief A template class for the object the threads operate on, padded so the objects of the threads do not share the cache line.
+	*/
+	template<typename ObjectType>
+	class SyncBenchmarkSlot
+	{
+	public:
+		/*!
+		Default Constructor
+		*/
+		SyncBenchmarkSlot()
+		{
+			m_object=NULL;
+			m_value=0;
+		}
+
+		/// the object operated on
+		ObjectType *m_object;
+		/// the value guarded by the object
+		volatile long m_value;
+		/// the padding to the next slot
+		char m_padding[SYNC_BENCHMARK_CACHE_LINE_SIZE];
+	};
+
+	/*!
+	@class SyncContentionCase epSyncBenchmark.cpp
+	@brief A template class for the case whose threads operate on their own objects, or all on the first object, by the contention.
+	*/
+	template<typename ObjectType>
+	class SyncContentionCase:public BenchmarkParallelCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] threadCount the number of the threads.
+		@param[in] contention the contention of the threads.
+		*/
+		SyncContentionCase(unsigned int threadCount, SyncBenchmarkContention contention):BenchmarkParallelCase(threadCount)
+		{
+			m_contention=contention;
+			m_slotCount=(contention==SYNC_BENCHMARK_CONTENTION_NONE)?threadCount:1;
+			m_slotList=EP_NEW SyncBenchmarkSlot<ObjectType>[m_slotCount];
+		}
+
+		/*!
+		Default Destructor
+		@remark the derived class deletes the objects of the slots.
+		*/
+		virtual ~SyncContentionCase()
+		{
+			EP_DELETE[] m_slotList;
+		}
+
+	protected:
+		/*!
+		Return the slot the given thread operates on.
+		@param[in] threadIdx the index of the thread.
+		@return the slot of the thread.
+		*/
+		SyncBenchmarkSlot<ObjectType> &getSlot(unsigned int threadIdx)
+		{
+			return m_slotList[m_contention==SYNC_BENCHMARK_CONTENTION_NONE?threadIdx:0];
+		}
+
+		/// the contention of the threads
+		SyncBenchmarkContention m_contention;
+		/// the number of the slots
+		unsigned int m_slotCount;
+		/// the slots operated on
+		SyncBenchmarkSlot<ObjectType> *m_slotList;
+	};
+
+	/*!
+	@class SyncLockCase epSyncBenchmark.cpp
+	@brief A benchmark case locking, incrementing the value guarded and unlocking per operation.
+	*/
+	class SyncLockCase:public SyncContentionCase<BaseLock>
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] lockType the lock to measure.
+		@param[in] threadCount the number of the threads.
+		@param[in] contention the contention of the threads.
+		*/
+		SyncLockCase(SyncBenchmarkLock lockType, unsigned int threadCount, SyncBenchmarkContention contention):SyncContentionCase<BaseLock>(threadCount,contention)
+		{
+			for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+			{
+				switch(lockType)
+				{
+				case SYNC_BENCHMARK_LOCK_CRITICALSECTION:
+					m_slotList[slotTrav].m_object=EP_NEW CriticalSectionEx();
+					break;
+				case SYNC_BENCHMARK_LOCK_MUTEX:
+					m_slotList[slotTrav].m_object=EP_NEW Mutex();
+					break;
+				case SYNC_BENCHMARK_LOCK_SEMAPHORE:
+					m_slotList[slotTrav].m_object=EP_NEW Semaphore(1);
+					break;
+				case SYNC_BENCHMARK_LOCK_INTERLOCKED:
+					m_slotList[slotTrav].m_object=EP_NEW InterlockedEx();
+					break;
+				case SYNC_BENCHMARK_LOCK_SPIN_PARK:
+					m_slotList[slotTrav].m_object=EP_NEW SpinParkLock();
+					break;
+				default:
+					m_slotList[slotTrav].m_object=EP_NEW ReaderWriterLock();
+					break;
+				}
+			}
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~SyncLockCase()
+		{
+			for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+				EP_DELETE m_slotList[slotTrav].m_object;
+		}
+
+		/*!
+		Lock, increment and unlock.
+		@param[in] threadIdx the index of the thread.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		virtual void RunThread(unsigned int threadIdx, unsigned int iterationCount)
+		{
+			SyncBenchmarkSlot<BaseLock> &slot=getSlot(threadIdx);
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				slot.m_object->Lock();
+				slot.m_value++;
+				slot.m_object->Unlock();
+				if(m_contention==SYNC_BENCHMARK_CONTENTION_LOW)
+					doWork();
+			}
+		}
+	};
+
+	/*!
+	@class SyncQueueCase epSyncBenchmark.cpp
+	@brief A template benchmark case pushing an item to and popping an item from the queue per operation.
+
+	Each queue holds SYNC_BENCHMARK_QUEUE_DEPTH items before the measurement, so the pop always finds an item.
+	*/
+	template<typename QueueType>
+	class SyncQueueCase:public SyncContentionCase<QueueType>
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] lockPolicyType the lock policy guarding the queue.
+		@param[in] threadCount the number of the threads.
+		@param[in] contention the contention of the threads.
+		*/
+		SyncQueueCase(LockPolicy lockPolicyType, unsigned int threadCount, SyncBenchmarkContention contention):SyncContentionCase<QueueType>(threadCount,contention)
+		{
+			for(unsigned int slotTrav=0;slotTrav<this->m_slotCount;slotTrav++)
+			{
+				this->m_slotList[slotTrav].m_object=EP_NEW QueueType(lockPolicyType);
+				for(int itemTrav=0;itemTrav<SYNC_BENCHMARK_QUEUE_DEPTH;itemTrav++)
+					this->m_slotList[slotTrav].m_object->Push(itemTrav);
+			}
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~SyncQueueCase()
+		{
+			for(unsigned int slotTrav=0;slotTrav<this->m_slotCount;slotTrav++)
+				EP_DELETE this->m_slotList[slotTrav].m_object;
+		}
+
+		/*!
+		Push and pop.
+		@param[in] threadIdx the index of the thread.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		virtual void RunThread(unsigned int threadIdx, unsigned int iterationCount)
+		{
+			QueueType *queue=this->getSlot(threadIdx).m_object;
+			int item=0;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				// the items vary, so the priority queue does not always push to the end
+				queue->Push(static_cast<int>(opTrav%SYNC_BENCHMARK_QUEUE_DEPTH));
+				queue->TryPop(item);
+				if(this->m_contention==SYNC_BENCHMARK_CONTENTION_LOW)
+					doWork();
+			}
+		}
+	};
+
+	/*!
+	@class SyncSharedObject epSyncBenchmark.cpp
+	@brief A SmartObject retained and released by the threads.
+	*/
+	class SyncSharedObject:public SmartObject
+	{
+	public:
+		/*!
+		Default Constructor
+		*/
+		SyncSharedObject():SmartObject(LOCK_POLICY_NONE)
+		{
+		}
+	protected:
+		/*!
+		Default Destructor
+		*/
+		virtual ~SyncSharedObject()
+		{
+		}
+	};
+
+	/*!
+	@class SyncSmartObjectCase epSyncBenchmark.cpp
+	@brief A benchmark case retaining and releasing the SmartObject per operation.
+	*/
+	class SyncSmartObjectCase:public SyncContentionCase<SyncSharedObject>
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] threadCount the number of the threads.
+		@param[in] contention the contention of the threads.
+		*/
+		SyncSmartObjectCase(unsigned int threadCount, SyncBenchmarkContention contention):SyncContentionCase<SyncSharedObject>(threadCount,contention)
+		{
+			for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+				m_slotList[slotTrav].m_object=EP_NEW SyncSharedObject();
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~SyncSmartObjectCase()
+		{
+			for(unsigned int slotTrav=0;slotTrav<m_slotCount;slotTrav++)
+				m_slotList[slotTrav].m_object->ReleaseObj();
+		}
+
+		/*!
+		Retain and release.
+		@param[in] threadIdx the index of the thread.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		virtual void RunThread(unsigned int threadIdx, unsigned int iterationCount)
+		{
+			SyncSharedObject *object=getSlot(threadIdx).m_object;
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				object->RetainObj();
+				object->ReleaseObj();
+				if(m_contention==SYNC_BENCHMARK_CONTENTION_LOW)
+					doWork();
+			}
+		}
+	};
+
+	/*!
+	@class SyncFalseSharingCase epSyncBenchmark.cpp
+	@brief A benchmark case where each thread increments its own counter per operation.
+
+	The counters are packed next to each other, or padded to their own cache lines by SyncBenchmarkSlot.
+	*/
+	class SyncFalseSharingCase:public BenchmarkParallelCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] threadCount the number of the threads.
+		@param[in] isPadded true to pad the counters to their own cache lines, otherwise false.
+		*/
+		SyncFalseSharingCase(unsigned int threadCount, bool isPadded):BenchmarkParallelCase(threadCount)
+		{
+			m_isPadded=isPadded;
+			m_packedList=EP_NEW volatile long[threadCount];
+			for(unsigned int counterTrav=0;counterTrav<threadCount;counterTrav++)
+				m_packedList[counterTrav]=0;
+			m_paddedList=EP_NEW SyncBenchmarkSlot<void>[threadCount];
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~SyncFalseSharingCase()
+		{
+			EP_DELETE[] m_packedList;
+			EP_DELETE[] m_paddedList;
+		}
+
+		/*!
+		Increment the counter of the thread.
+		@param[in] threadIdx the index of the thread.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		virtual void RunThread(unsigned int threadIdx, unsigned int iterationCount)
+		{
+			volatile long *counter=m_isPadded?&m_paddedList[threadIdx].m_value:&m_packedList[threadIdx];
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+				InterlockedIncrement(counter);
+		}
+
+	private:
+		/// the flag whether the counters are padded
+		bool m_isPadded;
+		/// the counters packed next to each other
+		volatile long *m_packedList;
+		/// the counters padded to their own cache lines
+		SyncBenchmarkSlot<void> *m_paddedList;
+	};
+
+	/*!
+	@class SyncHeapObject epSyncBenchmark.cpp
+	@brief A small object allocated from the heap, as the baseline of SyncTinyObject.
+	*/
+	class SyncHeapObject
+	{
+	public:
+		/// the data of the object
+		long m_data[4];
+	};
+
+	/*!
+	@class SyncTinyObject epSyncBenchmark.cpp
+	@brief A small object of the same size as SyncHeapObject, allocated by TinyObject.
+	*/
+	class SyncTinyObject:public TinyObject<>
+	{
+	public:
+		/// the data of the object
+		long m_data[4];
+	};
+
+	/*!
+	@class SyncAllocCase epSyncBenchmark.cpp
+	@brief A template benchmark case allocating and freeing the object per operation, each thread its own.
+	*/
+	template<typename ObjectType>
+	class SyncAllocCase:public BenchmarkParallelCase
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] threadCount the number of the threads.
+		*/
+		SyncAllocCase(unsigned int threadCount):BenchmarkParallelCase(threadCount)
+		{
+		}
+
+		/*!
+		Allocate, touch and free.
+		@param[in] threadIdx the index of the thread.
+		@param[in] iterationCount the number of the operations of this thread.
+		*/
+		virtual void RunThread(unsigned int threadIdx, unsigned int iterationCount)
+		{
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				// the object is touched through the volatile, so the allocation is not optimized away
+				ObjectType * volatile object=EP_NEW ObjectType();
+				object->m_data[0]=static_cast<long>(opTrav);
+				EP_DELETE object;
+			}
+		}
+	};
+
+	/*!
+	@class SyncSetWaitCase epSyncBenchmark.cpp
+	@brief A benchmark case setting the event and waiting on it on the same thread per operation.
+	*/
+	class SyncSetWaitCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		*/
+		SyncSetWaitCase():BenchmarkCase(),m_event(false,false)
+		{
+		}
+
+		/*!
+		Set and wait.
+		@param[in] iterationCount the number of the operations.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				m_event.SetEvent();
+				m_event.WaitForEvent();
+			}
+		}
+
+	private:
+		/// the event set and waited on
+		EventEx m_event;
+	};
+
+	/*!
+	@class SyncPongThread epSyncBenchmark.cpp
+	@brief A thread raising the pong event for each ping event, until stopped.
+	*/
+	class SyncPongThread:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] pingEvent the event waited on.
+		@param[in] pongEvent the event raised back.
+		*/
+		SyncPongThread(EventEx &pingEvent, EventEx &pongEvent):Thread(),m_pingEvent(pingEvent),m_pongEvent(pongEvent)
+		{
+			m_isStopped=false;
+		}
+
+		/*!
+		Stop the thread, and wait for it to finish.
+		*/
+		void Stop()
+		{
+			m_isStopped=true;
+			m_pingEvent.SetEvent();
+			WaitFor();
+		}
+
+	protected:
+		/*!
+		Answer the ping events.
+		*/
+		virtual void execute()
+		{
+			while(true)
+			{
+				m_pingEvent.WaitForEvent();
+				if(m_isStopped)
+					break;
+				m_pongEvent.SetEvent();
+			}
+		}
+
+	private:
+		/// the event waited on
+		EventEx &m_pingEvent;
+		/// the event raised back
+		EventEx &m_pongEvent;
+		/// the flag whether the thread is stopped
+		volatile bool m_isStopped;
+	};
+
+	/*!
+	@class SyncPingPongCase epSyncBenchmark.cpp
+	@brief A benchmark case raising the event for the other thread and waiting for its answer per operation.
+	*/
+	class SyncPingPongCase:public BenchmarkCase
+	{
+	public:
+		/*!
+		Default Constructor
+		*/
+		SyncPingPongCase():BenchmarkCase(),m_pingEvent(false,false),m_pongEvent(false,false)
+		{
+			m_pongThread=NULL;
+		}
+
+		/*!
+		Default Destructor
+		*/
+		virtual ~SyncPingPongCase()
+		{
+			TearDown();
+		}
+
+		/*!
+		Start the answering thread.
+		@param[in] iterationCount the number of the round trips.
+		*/
+		virtual void SetUp(unsigned int iterationCount)
+		{
+			m_pingEvent.ResetEvent();
+			m_pongEvent.ResetEvent();
+			m_pongThread=EP_NEW SyncPongThread(m_pingEvent,m_pongEvent);
+			m_pongThread->Start();
+		}
+
+		/*!
+		Make the round trips.
+		@param[in] iterationCount the number of the round trips.
+		*/
+		virtual void Run(unsigned int iterationCount)
+		{
+			for(unsigned int opTrav=0;opTrav<iterationCount;opTrav++)
+			{
+				m_pingEvent.SetEvent();
+				m_pongEvent.WaitForEvent();
+			}
+		}
+
+		/*!
+		Stop the answering thread.
+		*/
+		virtual void TearDown()
+		{
+			if(m_pongThread)
+			{
+				m_pongThread->Stop();
+				EP_DELETE m_pongThread;
+				m_pongThread=NULL;
+			}
+		}
+
+		/*!
+		Return the number of the threads signaling.
+		@return the number of the threads.
+		*/
+		virtual unsigned int GetThreadCount() const
+		{
+			return 2;
+		}
+
+	private:
+		/// the event raised for the answering thread
+		EventEx m_pingEvent;
+		/// the event raised by the answering thread
+		EventEx m_pongEvent;
+		/// the answering thread
+		SyncPongThread *m_pongThread;
+	};
+}
+
+void SyncBenchmark::Run(unsigned int maxThreadCount, unsigned int minTime)
+{
+	for(int lockTrav=0;lockTrav<SYNC_BENCHMARK_LOCK_COUNT;lockTrav++)
+		RunLock(static_cast<SyncBenchmarkLock>(lockTrav),maxThreadCount,minTime);
+	RunEvent(minTime);
+	RunQueue(maxThreadCount,minTime);
+	RunSmartObject(maxThreadCount,minTime);
+	RunTinyObject(maxThreadCount,minTime);
+	RunFalseSharing(maxThreadCount,minTime);
+}
+
+void SyncBenchmark::RunLock(SyncBenchmarkLock lockType, unsigned int maxThreadCount, unsigned int minTime)
+{
+	EP_ASSERT_EXPR(lockType<SYNC_BENCHMARK_LOCK_COUNT,_T("The lock type is out of range."));
+	std::vector<unsigned int> threadCountList;
+	getThreadCountList(maxThreadCount,threadCountList);
+	for(size_t threadTrav=0;threadTrav<threadCountList.size();threadTrav++)
+	{
+		for(int contentionTrav=0;contentionTrav<SYNC_BENCHMARK_CONTENTION_COUNT;contentionTrav++)
+		{
+			SyncBenchmarkContention contention=static_cast<SyncBenchmarkContention>(contentionTrav);
+			EpTString parameter;
+			System::STPrintf(parameter,_T("%s/%u/%s"),s_lockNameList[lockType],threadCountList[threadTrav],s_contentionNameList[contention]);
+			SyncLockCase lockCase(lockType,threadCountList[threadTrav],contention);
+			BENCHMARK_INSTANCE.Run(_T("Sync"),_T("Lock"),parameter.c_str(),lockCase,0,minTime);
+		}
+	}
+}
+
+void SyncBenchmark::RunEvent(unsigned int minTime)
+{
+	SyncSetWaitCase setWaitCase;
+	BENCHMARK_INSTANCE.Run(_T("Sync"),_T("EventSetWait"),_T(""),setWaitCase,0,minTime);
+	SyncPingPongCase pingPongCase;
+	BENCHMARK_INSTANCE.Run(_T("Sync"),_T("EventPingPong"),_T(""),pingPongCase,0,minTime);
+}
+
+void SyncBenchmark::RunQueue(unsigned int maxThreadCount, unsigned int minTime)
+{
+	std::vector<unsigned int> threadCountList;
+	getThreadCountList(maxThreadCount,threadCountList);
+	for(int policyTrav=0;policyTrav<SYNC_BENCHMARK_LOCK_POLICY_COUNT;policyTrav++)
+	{
+		for(size_t threadTrav=0;threadTrav<threadCountList.size();threadTrav++)
+		{
+			for(int contentionTrav=0;contentionTrav<SYNC_BENCHMARK_CONTENTION_COUNT;contentionTrav++)
+			{
+				SyncBenchmarkContention contention=static_cast<SyncBenchmarkContention>(contentionTrav);
+				EpTString parameter;
+				System::STPrintf(parameter,_T("%s/%u/%s"),s_lockPolicyNameList[policyTrav],threadCountList[threadTrav],s_contentionNameList[contention]);
+				SyncQueueCase<ThreadSafeQueue<int> > queueCase(s_lockPolicyList[policyTrav],threadCountList[threadTrav],contention);
+				BENCHMARK_INSTANCE.Run(_T("Sync"),_T("Queue"),parameter.c_str(),queueCase,0,minTime);
+				SyncQueueCase<ThreadSafePQueue<int> > pQueueCase(s_lockPolicyList[policyTrav],threadCountList[threadTrav],contention);
+				BENCHMARK_INSTANCE.Run(_T("Sync"),_T("PQueue"),parameter.c_str(),pQueueCase,0,minTime);
+			}
+		}
+	}
+}
+
+void SyncBenchmark::RunSmartObject(unsigned int maxThreadCount, unsigned int minTime)
+{
+	std::vector<unsigned int> threadCountList;
+	getThreadCountList(maxThreadCount,threadCountList);
+	for(size_t threadTrav=0;threadTrav<threadCountList.size();threadTrav++)
+	{
+		for(int contentionTrav=0;contentionTrav<SYNC_BENCHMARK_CONTENTION_COUNT;contentionTrav++)
+		{
+			SyncBenchmarkContention contention=static_cast<SyncBenchmarkContention>(contentionTrav);
+			EpTString parameter;
+			System::STPrintf(parameter,_T("%u/%s"),threadCountList[threadTrav],s_contentionNameList[contention]);
+			SyncSmartObjectCase smartObjectCase(threadCountList[threadTrav],contention);
+			BENCHMARK_INSTANCE.Run(_T("Sync"),_T("SmartObject"),parameter.c_str(),smartObjectCase,0,minTime);
+		}
+	}
+}
+
+void SyncBenchmark::RunTinyObject(unsigned int maxThreadCount, unsigned int minTime)
+{
+	std::vector<unsigned int> threadCountList;
+	getThreadCountList(maxThreadCount,threadCountList);
+	for(size_t threadTrav=0;threadTrav<threadCountList.size();threadTrav++)
+	{
+		EpTString parameter;
+		System::STPrintf(parameter,_T("TINY/%u"),threadCountList[threadTrav]);
+		SyncAllocCase<SyncTinyObject> tinyCase(threadCountList[threadTrav]);
+		BENCHMARK_INSTANCE.Run(_T("Sync"),_T("Alloc"),parameter.c_str(),tinyCase,0,minTime);
+		System::STPrintf(parameter,_T("HEAP/%u"),threadCountList[threadTrav]);
+		SyncAllocCase<SyncHeapObject> heapCase(threadCountList[threadTrav]);
+		BENCHMARK_INSTANCE.Run(_T("Sync"),_T("Alloc"),parameter.c_str(),heapCase,0,minTime);
+	}
+}
+
+void SyncBenchmark::RunFalseSharing(unsigned int maxThreadCount, unsigned int minTime)
+{
+	std::vector<unsigned int> threadCountList;
+	getThreadCountList(maxThreadCount,threadCountList);
+	for(size_t threadTrav=0;threadTrav<threadCountList.size();threadTrav++)
+	{
+		EpTString parameter;
+		System::STPrintf(parameter,_T("PACKED/%u"),threadCountList[threadTrav]);
+		SyncFalseSharingCase packedCase(threadCountList[threadTrav],false);
+		BENCHMARK_INSTANCE.Run(_T("Sync"),_T("FalseSharing"),parameter.c_str(),packedCase,0,minTime);
+		System::STPrintf(parameter,_T("PADDED/%u"),threadCountList[threadTrav]);
+		SyncFalseSharingCase paddedCase(threadCountList[threadTrav],true);
+		BENCHMARK_INSTANCE.Run(_T("Sync"),_T("FalseSharing"),parameter.c_str(),paddedCase,0,minTime);
+	}
+}
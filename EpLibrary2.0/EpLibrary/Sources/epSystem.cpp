@@ -26,6 +26,18 @@ THE SOFTWARE.
 #include "epSystem.h"
 #include "epCriticalSectionEx.h"
 #include <sys/timeb.h>
+#include <io.h>
+
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_SYSTEM_SSE2
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
+#if _MSC_VER>=MSVC110 && (defined(_M_IX86) || defined(_M_X64))
+#include <immintrin.h>
+#define EP_SYSTEM_AVX2
+#endif //_MSC_VER>=MSVC110 && (defined(_M_IX86) || defined(_M_X64))
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -50,6 +62,86 @@ unsigned long System::GetNumberOfCores()
 	return sysinfo.dwNumberOfProcessors;
 }
 
+/// Function pointer type for GetLogicalProcessorInformation
+typedef BOOL (WINAPI *LPFN_GETLOGICALPROCESSORINFORMATION)(PSYSTEM_LOGICAL_PROCESSOR_INFORMATION, PDWORD);
+/// Function pointer type for VirtualAllocExNuma
+typedef LPVOID (WINAPI *LPFN_VIRTUALALLOCEXNUMA)(HANDLE, LPVOID, SIZE_T, DWORD, DWORD, DWORD);
+
+unsigned long System::GetNumberOfPhysicalCores()
+{
+	std::vector<ULONG_PTR> maskList;
+	GetPhysicalCoreAffinityMasks(maskList);
+	return static_cast<unsigned long>(maskList.size());
+}
+
+void System::GetPhysicalCoreAffinityMasks(std::vector<ULONG_PTR> &retMaskList)
+{
+	retMaskList.clear();
+
+	//GetLogicalProcessorInformation is not available on all supported versions of Windows.
+	LPFN_GETLOGICALPROCESSORINFORMATION fnGetLogicalProcessorInformation = (LPFN_GETLOGICALPROCESSORINFORMATION) GetProcAddress(
+		GetModuleHandle(TEXT("kernel32")),"GetLogicalProcessorInformation");
+	if(fnGetLogicalProcessorInformation)
+	{
+		DWORD bufferSize=0;
+		fnGetLogicalProcessorInformation(NULL,&bufferSize);
+		size_t infoCount=bufferSize/sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+		if(infoCount)
+		{
+			std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infoList(infoCount);
+			if(fnGetLogicalProcessorInformation(&infoList.at(0),&bufferSize))
+			{
+				for(size_t infoTrav=0;infoTrav<infoCount;infoTrav++)
+				{
+					if(infoList[infoTrav].Relationship==RelationProcessorCore)
+						retMaskList.push_back(infoList[infoTrav].ProcessorMask);
+				}
+			}
+		}
+	}
+
+	if(retMaskList.empty())
+	{
+		unsigned long coreCount=GetNumberOfCores();
+		for(unsigned long coreTrav=0;coreTrav<coreCount && coreTrav<sizeof(ULONG_PTR)*8;coreTrav++)
+		{
+			retMaskList.push_back(static_cast<ULONG_PTR>(1)<<coreTrav);
+		}
+	}
+}
+
+unsigned long System::GetNumberOfNumaNodes()
+{
+	ULONG highestNode=0;
+	if(!GetNumaHighestNodeNumber(&highestNode))
+		return 1;
+	return highestNode+1;
+}
+
+unsigned long System::GetNumaNodeOfProcessor(unsigned long processorNumber)
+{
+	UCHAR nodeNumber=0;
+	if(processorNumber>0xFF || !GetNumaProcessorNode(static_cast<UCHAR>(processorNumber),&nodeNumber) || nodeNumber==0xFF)
+		return 0;
+	return nodeNumber;
+}
+
+void *System::NumaAlloc(size_t size, unsigned long numaNode)
+{
+	//VirtualAllocExNuma is not available before Windows Vista.
+	LPFN_VIRTUALALLOCEXNUMA fnVirtualAllocExNuma = (LPFN_VIRTUALALLOCEXNUMA) GetProcAddress(
+		GetModuleHandle(TEXT("kernel32")),"VirtualAllocExNuma");
+	if(fnVirtualAllocExNuma)
+		return fnVirtualAllocExNuma(GetCurrentProcess(),NULL,size,MEM_RESERVE|MEM_COMMIT,PAGE_READWRITE,numaNode);
+	return VirtualAlloc(NULL,size,MEM_RESERVE|MEM_COMMIT,PAGE_READWRITE);
+}
+
+void System::NumaFree(void *memory)
+{
+	if(memory)
+		VirtualFree(memory,0,MEM_RELEASE);
+}
+
 EpTime System::GetTime()
 {
 	static long s_lInitialSec = 0;
@@ -107,33 +199,345 @@ LARGE_INTEGER System::GetQueryPerformanceCounter()
 	return retVal;
 }
 
-void* System::Memcpy (void* dest, size_t dstSizeInByte, const void* source, size_t srcSizeInByte)
+#if defined(EP_SYSTEM_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
 {
-	if(dstSizeInByte<srcSizeInByte)
-		return 0;
-	int err = memcpy_s(dest,dstSizeInByte,source,srcSizeInByte);
-	if (err == 0)
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
 	{
-		return dest;
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
+}
+
+/*!
+Return the flag whether the processor supports the enhanced REP MOVSB/STOSB.
+@return true if supported, otherwise false.
+*/
+static bool hasERMS()
+{
+	static volatile int s_hasERMS=-1;
+	if(s_hasERMS<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,0);
+		bool isSupported=false;
+		if(cpuInfo[0]>=7)
+		{
+			__cpuidex(cpuInfo,7,0);
+			isSupported=(cpuInfo[1]&(1<<9))!=0;
+		}
+		s_hasERMS=isSupported?1:0;
+	}
+	return s_hasERMS==1;
+}
+
+/*!
+Copy the buffer of at least 16 bytes with unaligned SSE2 moves.
+@param[in] dest The destination for copying.
+@param[in] source The source buffer to be copied.
+@param[in] size the size of source to copy.
+@remark The last block overlaps the previous one instead of falling back to the bytes.
+*/
+static void copySSE2(unsigned char *dest, const unsigned char *source, size_t size)
+{
+	__m128i tail=_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+size-16));
+	for(size_t byteTrav=0;byteTrav+16<size;byteTrav+=16)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+byteTrav),_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+byteTrav)));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+size-16),tail);
+}
+
+/*!
+Copy the buffer of at least 16 bytes with the non-temporal SSE2 stores.
+@param[in] dest The destination for copying.
+@param[in] source The source buffer to be copied.
+@param[in] size the size of source to copy.
+*/
+static void streamCopySSE2(unsigned char *dest, const unsigned char *source, size_t size)
+{
+	__m128i head=_mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+	__m128i tail=_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+size-16));
+	size_t byteTrav=16-(reinterpret_cast<size_t>(dest)&15);
+	for(;byteTrav+16<=size;byteTrav+=16)
+		_mm_stream_si128(reinterpret_cast<__m128i*>(dest+byteTrav),_mm_loadu_si128(reinterpret_cast<const __m128i*>(source+byteTrav)));
+	_mm_sfence();
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest),head);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+size-16),tail);
+}
+
+/*!
+Set the buffer of at least 16 bytes with unaligned SSE2 moves.
+@param[in] dest The buffer to be set.
+@param[in] val The value to set.
+@param[in] size the size of buffer.
+@param[in] isNonTemporal true to write the aligned body with the non-temporal stores.
+*/
+static void setSSE2(unsigned char *dest, unsigned char val, size_t size, bool isNonTemporal)
+{
+	__m128i value=_mm_set1_epi8(static_cast<char>(val));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest),value);
+	size_t byteTrav=16-(reinterpret_cast<size_t>(dest)&15);
+	if(isNonTemporal)
+	{
+		for(;byteTrav+16<=size;byteTrav+=16)
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dest+byteTrav),value);
+		_mm_sfence();
 	}
 	else
 	{
-		return 0;
+		for(;byteTrav+16<=size;byteTrav+=16)
+			_mm_store_si128(reinterpret_cast<__m128i*>(dest+byteTrav),value);
 	}
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest+size-16),value);
 }
 
-void* System::Memcpy (void* dest, const void* source, size_t srcSizeInByte)
+/*!
+Find the first mismatch of the buffers of at least 16 bytes with SSE2.
+@param[in] first The first buffer to compare.
+@param[in] second The second buffer to compare
+@param[in] size the size of buffer to compare.
+@return the difference of the first mismatching bytes, or 0 if equal.
+*/
+static int compareSSE2(const unsigned char *first, const unsigned char *second, size_t size)
 {
-	return System::Memcpy(dest,srcSizeInByte,source,srcSizeInByte);
+	size_t byteTrav=0;
+	while(true)
+	{
+		// the last block is moved back to overlap the previous one
+		if(byteTrav+16>size)
+			byteTrav=size-16;
+		__m128i equal=_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first+byteTrav)),_mm_loadu_si128(reinterpret_cast<const __m128i*>(second+byteTrav)));
+		unsigned int mask=static_cast<unsigned int>(_mm_movemask_epi8(equal))^0xFFFF;
+		if(mask)
+		{
+			unsigned long bitIdx;
+			_BitScanForward(&bitIdx,mask);
+			return static_cast<int>(first[byteTrav+bitIdx])-static_cast<int>(second[byteTrav+bitIdx]);
+		}
+		byteTrav+=16;
+		if(byteTrav>=size)
+			return 0;
+	}
+}
+#endif //defined(EP_SYSTEM_SSE2)
+
+#if defined(EP_SYSTEM_AVX2)
+/*!
+Return the flag whether the processor and the OS support AVX2.
+@return true if supported, otherwise false.
+*/
+static bool hasAVX2()
+{
+	static volatile int s_hasAVX2=-1;
+	if(s_hasAVX2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,0);
+		bool isSupported=false;
+		if(cpuInfo[0]>=7)
+		{
+			__cpuid(cpuInfo,1);
+			// the OS must save the YMM registers as well
+			if((cpuInfo[2]&(1<<27)) && (cpuInfo[2]&(1<<28)) && (_xgetbv(0)&0x6)==0x6)
+			{
+				__cpuidex(cpuInfo,7,0);
+				isSupported=(cpuInfo[1]&(1<<5))!=0;
+			}
+		}
+		s_hasAVX2=isSupported?1:0;
+	}
+	return s_hasAVX2==1;
+}
+
+/*!
+Copy the buffer of at least 32 bytes with unaligned AVX moves.
+@param[in] dest The destination for copying.
+@param[in] source The source buffer to be copied.
+@param[in] size the size of source to copy.
+*/
+static void copyAVX2(unsigned char *dest, const unsigned char *source, size_t size)
+{
+	__m256i tail=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source+size-32));
+	for(size_t byteTrav=0;byteTrav+32<size;byteTrav+=32)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest+byteTrav),_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source+byteTrav)));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest+size-32),tail);
+	_mm256_zeroupper();
+}
+
+/*!
+Copy the buffer of at least 32 bytes with the non-temporal AVX stores.
+@param[in] dest The destination for copying.
+@param[in] source The source buffer to be copied.
+@param[in] size the size of source to copy.
+*/
+static void streamCopyAVX2(unsigned char *dest, const unsigned char *source, size_t size)
+{
+	__m256i head=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+	__m256i tail=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source+size-32));
+	size_t byteTrav=32-(reinterpret_cast<size_t>(dest)&31);
+	for(;byteTrav+32<=size;byteTrav+=32)
+		_mm256_stream_si256(reinterpret_cast<__m256i*>(dest+byteTrav),_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source+byteTrav)));
+	_mm_sfence();
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),head);
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest+size-32),tail);
+	_mm256_zeroupper();
+}
+
+/*!
+Set the buffer of at least 32 bytes with AVX moves.
+@param[in] dest The buffer to be set.
+@param[in] val The value to set.
+@param[in] size the size of buffer.
+@param[in] isNonTemporal true to write the aligned body with the non-temporal stores.
+*/
+static void setAVX2(unsigned char *dest, unsigned char val, size_t size, bool isNonTemporal)
+{
+	__m256i value=_mm256_set1_epi8(static_cast<char>(val));
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest),value);
+	size_t byteTrav=32-(reinterpret_cast<size_t>(dest)&31);
+	if(isNonTemporal)
+	{
+		for(;byteTrav+32<=size;byteTrav+=32)
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(dest+byteTrav),value);
+		_mm_sfence();
+	}
+	else
+	{
+		for(;byteTrav+32<=size;byteTrav+=32)
+			_mm256_store_si256(reinterpret_cast<__m256i*>(dest+byteTrav),value);
+	}
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dest+size-32),value);
+	_mm256_zeroupper();
+}
+
+/*!
+Find the first mismatch of the buffers of at least 32 bytes with AVX2.
+@param[in] first The first buffer to compare.
+@param[in] second The second buffer to compare
+@param[in] size the size of buffer to compare.
+@return the difference of the first mismatching bytes, or 0 if equal.
+*/
+static int compareAVX2(const unsigned char *first, const unsigned char *second, size_t size)
+{
+	size_t byteTrav=0;
+	int retVal=0;
+	while(true)
+	{
+		if(byteTrav+32>size)
+			byteTrav=size-32;
+		__m256i equal=_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(first+byteTrav)),_mm256_loadu_si256(reinterpret_cast<const __m256i*>(second+byteTrav)));
+		unsigned int mask=~static_cast<unsigned int>(_mm256_movemask_epi8(equal));
+		if(mask)
+		{
+			unsigned long bitIdx;
+			_BitScanForward(&bitIdx,mask);
+			retVal=static_cast<int>(first[byteTrav+bitIdx])-static_cast<int>(second[byteTrav+bitIdx]);
+			break;
+		}
+		byteTrav+=32;
+		if(byteTrav>=size)
+			break;
+	}
+	_mm256_zeroupper();
+	return retVal;
 }
+#endif //defined(EP_SYSTEM_AVX2)
+
+/*!
+@def SYSTEM_MEMORY_ERMS_SIZE
+@brief the byte size from which REP MOVSB/STOSB outruns the vector loops
+
+Macro for the byte size from which the enhanced REP MOVSB/STOSB is used.
+*/
+#define SYSTEM_MEMORY_ERMS_SIZE 2048
 
-int System::Memcmp (void* buf1, const void* buf2, size_t compSizeInByte)
+void* System::copyMemory(void* dest, const void* source, size_t srcSizeInByte)
 {
+	if(!dest || !source)
+		return 0;
+	unsigned char *destBytes=static_cast<unsigned char*>(dest);
+	const unsigned char *sourceBytes=static_cast<const unsigned char*>(source);
+#if defined(EP_SYSTEM_AVX2)
+	if(hasAVX2())
+	{
+		if(srcSizeInByte>=SYSTEM_MEMORY_NON_TEMPORAL_SIZE)
+			streamCopyAVX2(destBytes,sourceBytes,srcSizeInByte);
+		else if(srcSizeInByte>=SYSTEM_MEMORY_ERMS_SIZE && hasERMS())
+			__movsb(destBytes,sourceBytes,srcSizeInByte);
+		else if(srcSizeInByte>=32)
+			copyAVX2(destBytes,sourceBytes,srcSizeInByte);
+		else
+			copySSE2(destBytes,sourceBytes,srcSizeInByte);
+		return dest;
+	}
+#endif //defined(EP_SYSTEM_AVX2)
+#if defined(EP_SYSTEM_SSE2)
+	if(hasSSE2())
+	{
+		if(srcSizeInByte>=SYSTEM_MEMORY_NON_TEMPORAL_SIZE)
+			streamCopySSE2(destBytes,sourceBytes,srcSizeInByte);
+		else if(srcSizeInByte>=SYSTEM_MEMORY_ERMS_SIZE && hasERMS())
+			__movsb(destBytes,sourceBytes,srcSizeInByte);
+		else
+			copySSE2(destBytes,sourceBytes,srcSizeInByte);
+		return dest;
+	}
+#endif //defined(EP_SYSTEM_SSE2)
+	return memcpy(dest,source,srcSizeInByte);
+}
+
+int System::compareMemory(const void* buf1, const void* buf2, size_t compSizeInByte)
+{
+	const unsigned char *first=static_cast<const unsigned char*>(buf1);
+	const unsigned char *second=static_cast<const unsigned char*>(buf2);
+#if defined(EP_SYSTEM_AVX2)
+	if(compSizeInByte>=32 && hasAVX2())
+		return compareAVX2(first,second,compSizeInByte);
+#endif //defined(EP_SYSTEM_AVX2)
+#if defined(EP_SYSTEM_SSE2)
+	if(hasSSE2())
+		return compareSSE2(first,second,compSizeInByte);
+#endif //defined(EP_SYSTEM_SSE2)
 	return memcmp(buf1,buf2,compSizeInByte);
 }
 
-void* System::Memset(void* source,int val,size_t srcSizeInByte)
+void* System::setMemory(void* source,int val,size_t srcSizeInByte)
 {
+	unsigned char *destBytes=static_cast<unsigned char*>(source);
+	unsigned char byteVal=static_cast<unsigned char>(val);
+	bool isNonTemporal=srcSizeInByte>=SYSTEM_MEMORY_NON_TEMPORAL_SIZE;
+#if defined(EP_SYSTEM_AVX2)
+	if(hasAVX2())
+	{
+		if(!isNonTemporal && srcSizeInByte>=SYSTEM_MEMORY_ERMS_SIZE && hasERMS())
+			__stosb(destBytes,byteVal,srcSizeInByte);
+		else if(srcSizeInByte>=32)
+			setAVX2(destBytes,byteVal,srcSizeInByte,isNonTemporal);
+		else
+			setSSE2(destBytes,byteVal,srcSizeInByte,false);
+		return source;
+	}
+#endif //defined(EP_SYSTEM_AVX2)
+#if defined(EP_SYSTEM_SSE2)
+	if(hasSSE2())
+	{
+		if(!isNonTemporal && srcSizeInByte>=SYSTEM_MEMORY_ERMS_SIZE && hasERMS())
+			__stosb(destBytes,byteVal,srcSizeInByte);
+		else
+			setSSE2(destBytes,byteVal,srcSizeInByte,isNonTemporal);
+		return source;
+	}
+#endif //defined(EP_SYSTEM_SSE2)
 	return memset(source,val,srcSizeInByte);
 }
 
@@ -678,6 +1082,19 @@ int System::FClose(EpFile * const fileStream)
 	return fclose(fileStream);
 }
 
+int System::FFlush(EpFile * const fileStream)
+{
+	return fflush(fileStream);
+}
+
+int System::FCommit(EpFile * const fileStream)
+{
+	int e=fflush(fileStream);
+	if(e!=0)
+		return e;
+	return _commit(_fileno(fileStream));
+}
+
 unsigned int System::FWrite(const void* buffer,size_t sizeInByte, size_t count, EpFile * const fileStream)
 {
 	return fwrite(buffer,sizeInByte,count,fileStream);
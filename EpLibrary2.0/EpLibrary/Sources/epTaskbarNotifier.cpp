@@ -32,6 +32,10 @@ Copyright (c) 2002 John O'Byrne
 Please refer to <http://www.codeproject.com/Articles/2562/Taskbar-Notification-dialog> for the license.
 */
 #include "epTaskbarNotifier.h"
+#include "epCriticalSectionEx.h"
+#include "epSingletonHolder.h"
+#include <vector>
+#include <map>
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -51,6 +55,141 @@ using namespace epl;
 #define TASKBAR_ON_RIGHT	3
 #define TASKBAR_ON_BOTTOM	4
 
+/*!
+@struct SkinRegionKey epTaskbarNotifier.cpp
+@brief The skin and the color key which a region is generated for.
+*/
+struct SkinRegionKey
+{
+	/// the module of the skin resource
+	HINSTANCE hInstance;
+	/// the resource ID of the skin
+	UINT nBitmapID;
+	/// the file name of the skin
+	EpTString strFileName;
+	/// the last write time of the skin file
+	__int64 lastWriteTime;
+	/// the transparent color
+	COLORREF crColorKey;
+
+	bool operator<(const SkinRegionKey &b) const
+	{
+		if(hInstance!=b.hInstance)
+			return hInstance<b.hInstance;
+		if(nBitmapID!=b.nBitmapID)
+			return nBitmapID<b.nBitmapID;
+		if(lastWriteTime!=b.lastWriteTime)
+			return lastWriteTime<b.lastWriteTime;
+		if(crColorKey!=b.crColorKey)
+			return crColorKey<b.crColorKey;
+		return strFileName<b.strFileName;
+	}
+};
+
+/*!
+@class SkinRegionCache epTaskbarNotifier.cpp
+@brief A cache of the regions generated for each skin and color key, shared by all notifiers.
+*/
+class SkinRegionCache
+{
+public:
+	/*!
+	Default Constructor
+
+	Initializes the cache
+	*/
+	SkinRegionCache():m_lock()
+	{
+	}
+
+	/*!
+	Default Destructor
+
+	Deletes the cached regions
+	*/
+	~SkinRegionCache()
+	{
+		std::map<SkinRegionKey,HRGN>::iterator iter;
+		for(iter=m_regionMap.begin();iter!=m_regionMap.end();iter++)
+			DeleteObject(iter->second);
+	}
+
+	/*!
+	Get the copy of the region cached for given key.
+	@param[in] key the skin and the color key
+	@return the new copy of the region, or NULL if not cached
+	*/
+	HRGN Find(const SkinRegionKey &key)
+	{
+		LockObj lock(&m_lock);
+		std::map<SkinRegionKey,HRGN>::iterator iter=m_regionMap.find(key);
+		if(iter==m_regionMap.end())
+			return NULL;
+		return copyRegion(iter->second);
+	}
+
+	/*!
+	Cache the copy of given region for given key.
+	@param[in] key the skin and the color key
+	@param[in] hRgn the region to cache, which the caller still owns
+	*/
+	void Insert(const SkinRegionKey &key, HRGN hRgn)
+	{
+		LockObj lock(&m_lock);
+		if(m_regionMap.find(key)!=m_regionMap.end())
+			return;
+		HRGN copy=copyRegion(hRgn);
+		if(copy)
+			m_regionMap[key]=copy;
+	}
+
+private:
+	/*!
+	Return the copy of given region.
+	@param[in] hRgn the region to copy
+	@return the new copy of the region, or NULL if failed
+	*/
+	static HRGN copyRegion(HRGN hRgn)
+	{
+		HRGN copy=CreateRectRgn(0,0,0,0);
+		if(copy && CombineRgn(copy,hRgn,NULL,RGN_COPY)==ERROR)
+		{
+			DeleteObject(copy);
+			return NULL;
+		}
+		return copy;
+	}
+
+	/*!
+	Default Copy Constructor
+
+	Initializes the cache
+	@param[in] b the second object
+	@remark Copy Constructor prohibited
+	*/
+	SkinRegionCache(const SkinRegionCache & b)
+	{
+		EP_ASSERT(0);
+	}
+
+	/*!
+	Assignment operator overloading
+	@param[in] b the second object
+	@return the new copied object
+	@remark Copy Operator prohibited
+	*/
+	SkinRegionCache & operator=(const SkinRegionCache&b)
+	{
+		EP_ASSERT(0);
+		return *this;
+	}
+
+	/// the regions for each skin and color key
+	std::map<SkinRegionKey,HRGN> m_regionMap;
+	/// the lock for the regions
+	CriticalSectionEx m_lock;
+};
+
 // CTaskbarNotifier
 
 IMPLEMENT_DYNAMIC(CTaskbarNotifier, CWnd)
@@ -167,7 +306,7 @@ BOOL CTaskbarNotifier::SetSkin(UINT nBitmapID,short red,short green,short blue)
 	if (red!=-1 && green!=-1 && blue!=-1)
 	{
 		// No need to delete the HRGN,  SetWindowRgn() owns it after being called
-		m_hSkinRegion=GenerateRegion((HBITMAP)m_biSkinBackground.GetSafeHandle(),(unsigned char) red,(unsigned char) green,(unsigned char) blue);
+		m_hSkinRegion=GetSkinRegion(AfxGetResourceHandle(),nBitmapID,NULL,(unsigned char) red,(unsigned char) green,(unsigned char) blue);
 		SetWindowRgn(m_hSkinRegion, true);
 	}
 
@@ -193,7 +332,7 @@ BOOL CTaskbarNotifier::SetSkin(const TCHAR * szFileName,short red,short green,sh
 	if (red!=-1 && green!=-1 && blue!=-1)
 	{
 		// No need to delete the HRGN,  SetWindowRgn() owns it after being called
-		m_hSkinRegion=GenerateRegion((HBITMAP)m_biSkinBackground.GetSafeHandle(),(unsigned char) red,(unsigned char) green,(unsigned char) blue);
+		m_hSkinRegion=GetSkinRegion(NULL,0,szFileName,(unsigned char) red,(unsigned char) green,(unsigned char) blue);
 		SetWindowRgn(m_hSkinRegion, true);
 	}
 
@@ -318,42 +457,104 @@ void CTaskbarNotifier::Hide()
 HRGN CTaskbarNotifier::GenerateRegion(HBITMAP hBitmap, unsigned char red, unsigned char green, unsigned char blue)
 {
 	WORD wBmpWidth,wBmpHeight;
-	HRGN hRgn, hTmpRgn;
 
 	// 24bit pixels from the bitmap
 	unsigned char *pPixels = Get24BitPixels(hBitmap, &wBmpWidth, &wBmpHeight);
 	if (!pPixels) return NULL;
 
-	// create our working region
-	hRgn = CreateRectRgn(0,0,wBmpWidth,wBmpHeight);
-	if (!hRgn) { EP_DELETE pPixels; return NULL; }
-
+	// one rectangle for each run of the opaque pixels in a scanline,
+	// so the region is created at once instead of merging a region for each transparent pixel
+	std::vector<RECT> runList;
+	size_t prevRowBegin=0;
+	size_t prevRowEnd=0;
 	unsigned long p=0;
 	for (WORD y=0; y<wBmpHeight; y++)
 	{
-		for (WORD x=0; x<wBmpWidth; x++)
+		size_t rowBegin=runList.size();
+		WORD x=0;
+		while (x<wBmpWidth)
 		{
-			unsigned char jRed   = pPixels[p+2];
-			unsigned char jGreen = pPixels[p+1];
-			unsigned char jBlue  = pPixels[p+0];
+			// skip the transparent pixels
+			while (x<wBmpWidth && pPixels[p+2]==red && pPixels[p+1]==green && pPixels[p+0]==blue)
+			{
+				x++;
+				p+=3;
+			}
+			if (x==wBmpWidth)
+				break;
 
-			if (jRed==red && jGreen==green && jBlue==blue)
+			WORD runStart=x;
+			while (x<wBmpWidth && !(pPixels[p+2]==red && pPixels[p+1]==green && pPixels[p+0]==blue))
 			{
-				// remove transparent color from region
-				hTmpRgn = CreateRectRgn(x,y,x+1,y+1);
-				CombineRgn(hRgn, hRgn, hTmpRgn, RGN_XOR);
-				DeleteObject(hTmpRgn);
+				x++;
+				p+=3;
 			}
+			RECT run={runStart,y,x,y+1};
+			runList.push_back(run);
+		}
 
-			// next pixel
-			p+=3;
+		// extend the previous rows instead, if the runs are the same
+		size_t rowEnd=runList.size();
+		bool isSameRow=(rowEnd-rowBegin==prevRowEnd-prevRowBegin) && rowEnd>rowBegin;
+		for (size_t runTrav=0; isSameRow && runTrav<rowEnd-rowBegin; runTrav++)
+		{
+			isSameRow=runList[rowBegin+runTrav].left==runList[prevRowBegin+runTrav].left
+				&& runList[rowBegin+runTrav].right==runList[prevRowBegin+runTrav].right;
+		}
+		if (isSameRow)
+		{
+			for (size_t runTrav=prevRowBegin; runTrav<prevRowEnd; runTrav++)
+				runList[runTrav].bottom=y+1;
+			runList.resize(rowBegin);
+		}
+		else
+		{
+			prevRowBegin=rowBegin;
+			prevRowEnd=rowEnd;
 		}
 	}
 
 	// release pixels
-	EP_DELETE pPixels;
+	EP_DELETE [] pPixels;
+
+	// the header followed by the rectangles
+	std::vector<unsigned char> rgnBuffer(sizeof(RGNDATAHEADER)+runList.size()*sizeof(RECT));
+	RGNDATA *pRgnData=reinterpret_cast<RGNDATA*>(&rgnBuffer[0]);
+	pRgnData->rdh.dwSize=sizeof(RGNDATAHEADER);
+	pRgnData->rdh.iType=RDH_RECTANGLES;
+	pRgnData->rdh.nCount=(DWORD)runList.size();
+	pRgnData->rdh.nRgnSize=(DWORD)(runList.size()*sizeof(RECT));
+	SetRect(&pRgnData->rdh.rcBound,0,0,wBmpWidth,wBmpHeight);
+	if (runList.size())
+		System::Memcpy(pRgnData->Buffer,&runList[0],runList.size()*sizeof(RECT));
 
 	// return the region
+	return ExtCreateRegion(NULL,(DWORD)rgnBuffer.size(),pRgnData);
+}
+
+HRGN CTaskbarNotifier::GetSkinRegion(HINSTANCE hInstance, UINT nBitmapID, const TCHAR *szFileName, unsigned char red, unsigned char green, unsigned char blue)
+{
+	SkinRegionKey key;
+	key.hInstance=hInstance;
+	key.nBitmapID=nBitmapID;
+	key.lastWriteTime=0;
+	key.crColorKey=RGB(red,green,blue);
+	if (szFileName)
+	{
+		// the region is generated again, if the skin file is changed
+		WIN32_FILE_ATTRIBUTE_DATA attributeData;
+		key.strFileName=szFileName;
+		if (GetFileAttributesEx(szFileName,GetFileExInfoStandard,&attributeData))
+			key.lastWriteTime=(static_cast<__int64>(attributeData.ftLastWriteTime.dwHighDateTime)<<32)|static_cast<__int64>(attributeData.ftLastWriteTime.dwLowDateTime);
+	}
+
+	SkinRegionCache &cache=SingletonHolder<SkinRegionCache>::Instance();
+	HRGN hRgn=cache.Find(key);
+	if (hRgn)
+		return hRgn;
+	hRgn=GenerateRegion((HBITMAP)m_biSkinBackground.GetSafeHandle(),red,green,blue);
+	if (hRgn)
+		cache.Insert(key,hRgn);
 	return hRgn;
 }
 
@@ -400,7 +601,7 @@ unsigned char* CTaskbarNotifier::Get24BitPixels(HBITMAP pBitmap, WORD *pwWidth,
 	// if failed, cancel the operation.
 	if (!iRes)
 	{
-		EP_DELETE pPixels;
+		EP_DELETE [] pPixels;
 		return NULL;
 	};
 
@@ -0,0 +1,284 @@
+/*! 
+TextLineReader for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epTextLineReader.h"
+#include "epFileStream.h"
+#include "epUnicodeHelper.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+TextLineReader::TextLineReader(FileEncodingType encodingType, size_t bufferSize)
+{
+	if(bufferSize<sizeof(wchar_t)*2)
+		bufferSize=sizeof(wchar_t)*2;
+	m_encodingType=encodingType;
+	m_stream=NULL;
+	m_fileSize=0;
+	m_readOffset=0;
+	m_rawBuffer.resize(bufferSize);
+	m_rawSize=0;
+	// every encoding decodes into at most one character per byte
+	m_textBuffer.resize(bufferSize);
+	m_textBegin=0;
+	m_textEnd=0;
+	m_textScan=0;
+}
+
+TextLineReader::~TextLineReader()
+{
+	Close();
+}
+
+bool TextLineReader::Open(const TCHAR *fileName)
+{
+	Close();
+	m_stream=EP_NEW FileStream(fileName,LOCK_POLICY_NONE);
+	if(!m_stream->MapStreamFromFile(FileStream::FILE_STREAM_MAP_TYPE_READ_ONLY))
+	{
+		EP_DELETE m_stream;
+		m_stream=NULL;
+		return false;
+	}
+	m_fileSize=m_stream->GetMappedSize();
+
+	// skip the byte order mark
+	unsigned char byteOrderMark[3];
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+	{
+		if(m_fileSize>=3 && m_stream->ReadBytes(byteOrderMark,3) && byteOrderMark[0]==0xEF && byteOrderMark[1]==0xBB && byteOrderMark[2]==0xBF)
+			m_readOffset=3;
+	}
+	else if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
+	{
+		if(m_fileSize>=2 && m_stream->ReadBytes(byteOrderMark,2) && byteOrderMark[0]==0xFF && byteOrderMark[1]==0xFE)
+			m_readOffset=2;
+	}
+	return true;
+}
+
+void TextLineReader::Close()
+{
+	if(m_stream)
+	{
+		m_stream->UnmapStream();
+		EP_DELETE m_stream;
+	}
+	m_stream=NULL;
+	m_fileSize=0;
+	m_readOffset=0;
+	m_rawSize=0;
+	m_textBegin=0;
+	m_textEnd=0;
+	m_textScan=0;
+}
+
+bool TextLineReader::IsOpened() const
+{
+	return m_stream!=NULL;
+}
+
+unsigned __int64 TextLineReader::GetFileSize() const
+{
+	return m_fileSize;
+}
+
+bool TextLineReader::ReadLine(const TCHAR *&retLine, size_t &retLength, bool *retHasNewLine)
+{
+	while(true)
+	{
+		for(;m_textScan<m_textEnd;m_textScan++)
+		{
+			if(m_textBuffer[m_textScan]==_T('\n'))
+			{
+				retLine=&m_textBuffer[0]+m_textBegin;
+				retLength=m_textScan-m_textBegin;
+				if(retLength>0 && retLine[retLength-1]==_T('\r'))
+					retLength--;
+				m_textScan++;
+				m_textBegin=m_textScan;
+				if(retHasNewLine)
+					*retHasNewLine=true;
+				return true;
+			}
+		}
+		if(!fill())
+			break;
+	}
+
+	if(m_textBegin==m_textEnd)
+		return false;
+	// the last line without the new line
+	retLine=&m_textBuffer[0]+m_textBegin;
+	retLength=m_textEnd-m_textBegin;
+	if(retLength>0 && retLine[retLength-1]==_T('\r'))
+		retLength--;
+	m_textBegin=m_textEnd;
+	m_textScan=m_textEnd;
+	if(retHasNewLine)
+		*retHasNewLine=false;
+	return true;
+}
+
+bool TextLineReader::fill()
+{
+	if(!m_stream)
+		return false;
+
+	// move the text not returned yet to the front, so the text buffer holds about one block
+	if(m_textBegin>0)
+	{
+		memmove(&m_textBuffer[0],&m_textBuffer[0]+m_textBegin,(m_textEnd-m_textBegin)*sizeof(TCHAR));
+		m_textEnd-=m_textBegin;
+		m_textScan-=m_textBegin;
+		m_textBegin=0;
+	}
+
+	if(m_readOffset>=m_fileSize && m_rawSize==0)
+		return false;
+
+	// the block is full of one line, so grow it to find the end of the line
+	if(m_rawSize==m_rawBuffer.size())
+		m_rawBuffer.resize(m_rawBuffer.size()*2);
+
+	size_t readSize=m_rawBuffer.size()-m_rawSize;
+	if(static_cast<unsigned __int64>(readSize)>m_fileSize-m_readOffset)
+		readSize=static_cast<size_t>(m_fileSize-m_readOffset);
+	if(readSize)
+	{
+		m_stream->SetMappedSeek(m_readOffset);
+		if(m_stream->ReadBytes(reinterpret_cast<unsigned char*>(&m_rawBuffer[0]+m_rawSize),readSize))
+		{
+			m_readOffset+=readSize;
+			m_rawSize+=readSize;
+		}
+		else
+		{
+			// the rest of the file cannot be read, so decode what is read as the end
+			m_readOffset=m_fileSize;
+		}
+	}
+
+	bool isEnd=(m_readOffset>=m_fileSize);
+	size_t decodeSize=m_rawSize;
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
+	{
+		decodeSize&=~static_cast<size_t>(1);
+		if(!isEnd && decodeSize>=2)
+		{
+			// keep the high surrogate with its low surrogate in the next block
+			unsigned int lastUnit=static_cast<unsigned char>(m_rawBuffer[decodeSize-2])|(static_cast<unsigned char>(m_rawBuffer[decodeSize-1])<<8);
+			if(lastUnit>=0xD800 && lastUnit<=0xDBFF)
+				decodeSize-=2;
+		}
+	}
+	else if(!isEnd)
+	{
+		// the new line byte is never a part of the multi-byte character, so the block is cut after the last one
+		while(decodeSize>0 && m_rawBuffer[decodeSize-1]!='\n')
+			decodeSize--;
+	}
+
+	if(decodeSize)
+		decode(&m_rawBuffer[0],decodeSize);
+	if(isEnd)
+	{
+		// the odd byte at the end of the UTF-16 file is dropped
+		m_rawSize=0;
+	}
+	else
+	{
+		memmove(&m_rawBuffer[0],&m_rawBuffer[0]+decodeSize,m_rawSize-decodeSize);
+		m_rawSize-=decodeSize;
+	}
+	return true;
+}
+
+void TextLineReader::decode(const char *bytes, size_t byteSize)
+{
+#if defined(_UNICODE) || defined(UNICODE)
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
+	{
+		size_t charCount=byteSize/sizeof(wchar_t);
+		if(m_textEnd+charCount>m_textBuffer.size())
+			m_textBuffer.resize(m_textEnd+charCount);
+		System::Memcpy(&m_textBuffer[0]+m_textEnd,bytes,charCount*sizeof(wchar_t));
+		m_textEnd+=charCount;
+	}
+	else if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+	{
+		// the UTF-8 takes one byte per character at least
+		if(m_textEnd+byteSize>m_textBuffer.size())
+			m_textBuffer.resize(m_textEnd+byteSize);
+		m_textEnd+=UnicodeHelper::Utf8ToUtf16(bytes,byteSize,&m_textBuffer[0]+m_textEnd);
+	}
+	else
+	{
+		int charCount=::MultiByteToWideChar(CP_ACP,0,bytes,static_cast<int>(byteSize),NULL,0);
+		if(charCount<=0)
+			return;
+		if(m_textEnd+charCount>m_textBuffer.size())
+			m_textBuffer.resize(m_textEnd+charCount);
+		m_textEnd+=::MultiByteToWideChar(CP_ACP,0,bytes,static_cast<int>(byteSize),&m_textBuffer[0]+m_textEnd,charCount);
+	}
+#else //defined(_UNICODE) || defined(UNICODE)
+	if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
+	{
+		if(m_textEnd+byteSize>m_textBuffer.size())
+			m_textBuffer.resize(m_textEnd+byteSize);
+		System::Memcpy(&m_textBuffer[0]+m_textEnd,bytes,byteSize);
+		m_textEnd+=byteSize;
+		return;
+	}
+
+	const wchar_t *wideChars;
+	int wideCount;
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+	{
+		if(byteSize>m_wideBuffer.size())
+			m_wideBuffer.resize(byteSize);
+		wideCount=static_cast<int>(UnicodeHelper::Utf8ToUtf16(bytes,byteSize,&m_wideBuffer[0]));
+		if(wideCount<=0)
+			return;
+		wideChars=&m_wideBuffer[0];
+	}
+	else
+	{
+		wideChars=reinterpret_cast<const wchar_t*>(bytes);
+		wideCount=static_cast<int>(byteSize/sizeof(wchar_t));
+	}
+	int charCount=::WideCharToMultiByte(CP_ACP,0,wideChars,wideCount,NULL,0,NULL,NULL);
+	if(charCount<=0)
+		return;
+	if(m_textEnd+charCount>m_textBuffer.size())
+		m_textBuffer.resize(m_textEnd+charCount);
+	m_textEnd+=::WideCharToMultiByte(CP_ACP,0,wideChars,wideCount,&m_textBuffer[0]+m_textEnd,charCount,NULL,NULL);
+#endif //defined(_UNICODE) || defined(UNICODE)
+}
@@ -34,6 +34,9 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+/// the number of the retries of Resume waiting for the thread to be actually suspended
+#define THREAD_RESUME_RETRY_COUNT 1000
+
 HANDLE Thread::CreateThread(LPTHREAD_START_ROUTINE routineFunc,LPVOID param, ThreadPriority priority)
 {
 	unsigned long threadID=0;
@@ -72,6 +75,8 @@ Thread::Thread(ThreadPriority priority,LockPolicy lockPolicyType)
 	m_threadId=0;
 	m_threadHandle=0;
 	m_threadPriority=priority;
+	m_affinityMask=0;
+	m_processorGroup=-1;
 	m_parentThreadHandle=0;
 	m_parentThreadId=0;
 	m_type=THREAD_TYPE_UNKNOWN;
@@ -90,6 +95,12 @@ Thread::Thread(ThreadPriority priority,LockPolicy lockPolicyType)
 	case LOCK_POLICY_NONE:
 		m_threadLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_threadLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_threadLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_threadLock=NULL;
 		break;
@@ -102,6 +113,8 @@ Thread::Thread(void (__cdecl *threadFunc)(), ThreadPriority priority,LockPolicy
 	m_threadId=0;
 	m_threadHandle=0;
 	m_threadPriority=priority;
+	m_affinityMask=0;
+	m_processorGroup=-1;
 	m_parentThreadHandle=0;
 	m_parentThreadId=0;
 	m_status=THREAD_STATUS_TERMINATED;
@@ -119,6 +132,12 @@ Thread::Thread(void (__cdecl *threadFunc)(), ThreadPriority priority,LockPolicy
 	case LOCK_POLICY_NONE:
 		m_threadLock=EP_NEW NoLock();
 		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_threadLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_threadLock=EP_NEW ReaderWriterLock();
+		break;
 	default:
 		m_threadLock=NULL;
 		break;
@@ -155,6 +174,8 @@ Thread::Thread(const Thread & b)
 		m_parentThreadId=b.m_parentThreadId;
 		m_threadHandle=b.m_threadHandle;
 		m_threadPriority=b.m_threadPriority;
+		m_affinityMask=b.m_affinityMask;
+		m_processorGroup=b.m_processorGroup;
 		m_threadId=b.m_threadId;
 		m_status=b.m_status;
 		m_exitCode=b.m_exitCode;
@@ -175,6 +196,8 @@ Thread::Thread(const Thread & b)
 		m_threadId=0;
 		m_threadHandle=0;
 		m_threadPriority=b.m_threadPriority;
+		m_affinityMask=b.m_affinityMask;
+		m_processorGroup=b.m_processorGroup;
 		m_parentThreadHandle=0;
 		m_parentThreadId=0;
 		m_type=THREAD_TYPE_UNKNOWN;
@@ -193,6 +216,12 @@ Thread::Thread(const Thread & b)
 		case LOCK_POLICY_NONE:
 			m_threadLock=EP_NEW NoLock();
 			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_threadLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_threadLock=EP_NEW ReaderWriterLock();
+			break;
 		default:
 			m_threadLock=NULL;
 			break;
@@ -222,6 +251,8 @@ Thread &Thread::operator=(const Thread & b)
 			m_parentThreadId=b.m_parentThreadId;
 			m_threadHandle=b.m_threadHandle;
 			m_threadPriority=b.m_threadPriority;
+			m_affinityMask=b.m_affinityMask;
+			m_processorGroup=b.m_processorGroup;
 			m_threadId=b.m_threadId;
 			m_status=b.m_status;
 			m_exitCode=b.m_exitCode;
@@ -243,6 +274,8 @@ Thread &Thread::operator=(const Thread & b)
 			m_threadId=0;
 			m_threadHandle=0;
 			m_threadPriority=b.m_threadPriority;
+			m_affinityMask=b.m_affinityMask;
+			m_processorGroup=b.m_processorGroup;
 			m_parentThreadHandle=0;
 			m_parentThreadId=0;
 			m_type=THREAD_TYPE_UNKNOWN;
@@ -261,6 +294,12 @@ Thread &Thread::operator=(const Thread & b)
 			case LOCK_POLICY_NONE:
 				m_threadLock=EP_NEW NoLock();
 				break;
+			case LOCK_POLICY_SPIN_PARK:
+				m_threadLock=EP_NEW SpinParkLock();
+				break;
+			case LOCK_POLICY_READER_WRITER:
+				m_threadLock=EP_NEW ReaderWriterLock();
+				break;
 			default:
 				m_threadLock=NULL;
 				break;
@@ -329,6 +368,7 @@ bool Thread::Start(const ThreadOpCode opCode, const ThreadType threadType, const
 			m_status=THREAD_STATUS_SUSPENDED;
 		}
 		SetPriority(m_threadPriority);
+		applyAffinityMask();
 		return true;
 	}
 	else
@@ -346,7 +386,14 @@ bool Thread::Resume()
 	LockObj lock(m_threadLock);
 	if(m_status==THREAD_STATUS_SUSPENDED && m_threadHandle)	
 	{
-		ResumeThread(m_threadHandle);
+		// Suspend marks the status before the thread is actually suspended, so retry until the thread was suspended,
+		// otherwise the resume is lost. Give up once the thread is gone, or the suspend seems to have failed.
+		for(unsigned int retryTrav=0;retryTrav<THREAD_RESUME_RETRY_COUNT;retryTrav++)
+		{
+			if(ResumeThread(m_threadHandle)!=0 || System::WaitForSingleObject(m_threadHandle,0)!=WAIT_TIMEOUT)
+				break;
+			Sleep(0);
+		}
 		m_status=THREAD_STATUS_STARTED;
 		return true;
 	}
@@ -537,6 +584,53 @@ bool Thread::SetPriority(ThreadPriority priority)
 	return ret;
 
 }
+bool Thread::SetAffinityMask(ULONG_PTR affinityMask, int processorGroup)
+{
+	LockObj lock(m_threadLock);
+	m_affinityMask=affinityMask;
+	m_processorGroup=processorGroup;
+	if(m_threadHandle==0)
+		return true;
+	return applyAffinityMask();
+}
+
+ULONG_PTR Thread::GetAffinityMask() const
+{
+	LockObj lock(m_threadLock);
+	return m_affinityMask;
+}
+
+int Thread::GetProcessorGroup() const
+{
+	LockObj lock(m_threadLock);
+	return m_processorGroup;
+}
+
+bool Thread::applyAffinityMask()
+{
+	if(m_threadHandle==0 || m_affinityMask==0)
+		return false;
+	if(m_processorGroup<0)
+		return ::SetThreadAffinityMask(m_threadHandle,m_affinityMask)!=0;
+#if _MSC_VER>=MSVC100
+	//SetThreadGroupAffinity is not available before Windows 7.
+	typedef BOOL (WINAPI *LPFN_SETTHREADGROUPAFFINITY)(HANDLE, const GROUP_AFFINITY *, PGROUP_AFFINITY);
+	LPFN_SETTHREADGROUPAFFINITY fnSetThreadGroupAffinity = (LPFN_SETTHREADGROUPAFFINITY) GetProcAddress(
+		GetModuleHandle(TEXT("kernel32")),"SetThreadGroupAffinity");
+	if(fnSetThreadGroupAffinity)
+	{
+		GROUP_AFFINITY groupAffinity;
+		memset(&groupAffinity,0,sizeof(GROUP_AFFINITY));
+		groupAffinity.Mask=m_affinityMask;
+		groupAffinity.Group=static_cast<WORD>(m_processorGroup);
+		return fnSetThreadGroupAffinity(m_threadHandle,&groupAffinity,NULL)!=0;
+	}
+#endif //_MSC_VER>=MSVC100
+	if(m_processorGroup==0)
+		return ::SetThreadAffinityMask(m_threadHandle,m_affinityMask)!=0;
+	return false;
+}
+
 ThreadPriority Thread::GetPriority()
 {
 	LockObj lock(m_threadLock);
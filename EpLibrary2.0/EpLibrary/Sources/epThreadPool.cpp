@@ -0,0 +1,381 @@
+/*!
+ThreadPool for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epThreadPool.h"
+#include "epSystem.h"
+#include "epJobHandle.h"
+#include <limits.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+ThreadPoolWorker::ThreadPoolWorker(ThreadPool *owner, unsigned int workerIdx, LockPolicy lockPolicyType):BaseWorkerThread(THREAD_LIFE_INFINITE,lockPolicyType)
+{
+	m_owner=owner;
+	m_workerIdx=workerIdx;
+	m_numaNode=0;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_localLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_localLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_localLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_localLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_localLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_localLock=NULL;
+		break;
+	}
+}
+
+ThreadPoolWorker::~ThreadPoolWorker()
+{
+	BaseJob *jobPtr;
+	while((jobPtr=popLocal())!=NULL)
+	{
+		jobPtr->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+		jobPtr->ReleaseObj();
+	}
+	if(m_localLock)
+		EP_DELETE m_localLock;
+}
+
+size_t ThreadPoolWorker::GetLocalJobCount() const
+{
+	LockObj lock(m_localLock);
+	return m_localQueue.size();
+}
+
+void ThreadPoolWorker::pushLocal(BaseJob * const job)
+{
+	LockObj lock(m_localLock);
+	m_localQueue.push_back(job);
+}
+
+BaseJob *ThreadPoolWorker::popLocal()
+{
+	LockObj lock(m_localLock);
+	if(m_localQueue.empty())
+		return NULL;
+	BaseJob *retJob=m_localQueue.back();
+	m_localQueue.pop_back();
+	return retJob;
+}
+
+BaseJob *ThreadPoolWorker::stealLocal()
+{
+	LockObj lock(m_localLock);
+	if(m_localQueue.empty())
+		return NULL;
+	BaseJob *retJob=m_localQueue.front();
+	m_localQueue.pop_front();
+	return retJob;
+}
+
+void ThreadPoolWorker::execute()
+{
+	while(!m_owner->isStopping())
+	{
+		BaseJob *jobPtr=popLocal();
+		if(!jobPtr)
+			jobPtr=m_owner->steal(m_workerIdx);
+		if(!jobPtr)
+		{
+			callCallBack();
+			__int64 idleStartTime=WorkerMetrics::GetCurrentMicroSec();
+			m_owner->waitForJob(WAITTIME_INIFINITE);
+			recordIdle(idleStartTime);
+			continue;
+		}
+		m_owner->processJob(this,jobPtr);
+	}
+}
+
+
+ThreadPool::ThreadPool(BaseJobProcessor *jobProcessor, unsigned int workerCount, LockPolicy lockPolicyType):m_jobSignal(0L)
+{
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_poolLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_poolLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_poolLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_poolLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_poolLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_poolLock=NULL;
+		break;
+	}
+	m_nextWorkerIdx=0;
+	m_jobCount=0;
+	m_isStopping=0;
+	m_isStarted=0;
+	m_placementPolicy=PLACEMENT_POLICY_NONE;
+
+	m_jobProcessor=jobProcessor;
+	if(m_jobProcessor)
+		m_jobProcessor->RetainObj();
+
+	if(workerCount==0)
+		workerCount=static_cast<unsigned int>(System::GetNumberOfCores());
+	if(workerCount==0)
+		workerCount=1;
+
+	for(unsigned int workerTrav=0;workerTrav<workerCount;workerTrav++)
+	{
+		ThreadPoolWorker *worker=EP_NEW ThreadPoolWorker(this,workerTrav,lockPolicyType);
+		worker->SetJobProcessor(m_jobProcessor);
+		m_workers.push_back(worker);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	Stop();
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		EP_DELETE m_workers[workerTrav];
+	}
+	m_workers.clear();
+	if(m_jobProcessor)
+		m_jobProcessor->ReleaseObj();
+	if(m_poolLock)
+		EP_DELETE m_poolLock;
+}
+
+bool ThreadPool::Start()
+{
+	LockObj lock(m_poolLock);
+	EP_ASSERT_EXPR(m_jobProcessor,_T("Job Processor is NULL!"));
+	if(!m_jobProcessor || m_isStarted)
+		return false;
+	InterlockedExchange(&m_isStopping,0);
+	placeWorkers();
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		if(!m_workers[workerTrav]->Start())
+		{
+			InterlockedExchange(&m_isStopping,1);
+			m_jobSignal.Release(static_cast<long>(m_workers.size()));
+			for(unsigned int stopTrav=0;stopTrav<workerTrav;stopTrav++)
+			{
+				m_workers[stopTrav]->TerminateWorker();
+			}
+			return false;
+		}
+	}
+	InterlockedExchange(&m_isStarted,1);
+	return true;
+}
+
+void ThreadPool::Stop(unsigned int waitTimeInMilliSec)
+{
+	LockObj lock(m_poolLock);
+	if(m_isStarted)
+	{
+		InterlockedExchange(&m_isStopping,1);
+		m_jobSignal.Release(static_cast<long>(m_workers.size()));
+		for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+		{
+			m_workers[workerTrav]->TerminateWorker(waitTimeInMilliSec);
+		}
+		InterlockedExchange(&m_isStarted,0);
+	}
+
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		BaseJob *jobPtr;
+		while((jobPtr=m_workers[workerTrav]->popLocal())!=NULL)
+		{
+			InterlockedDecrement(&m_jobCount);
+			jobPtr->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+			jobPtr->ReleaseObj();
+		}
+	}
+}
+
+void ThreadPool::SetPlacementPolicy(PlacementPolicy policy)
+{
+	LockObj lock(m_poolLock);
+	m_placementPolicy=policy;
+}
+
+ThreadPool::PlacementPolicy ThreadPool::GetPlacementPolicy() const
+{
+	LockObj lock(m_poolLock);
+	return m_placementPolicy;
+}
+
+void ThreadPool::placeWorkers()
+{
+	if(m_placementPolicy!=PLACEMENT_POLICY_PHYSICAL_CORE)
+		return;
+	std::vector<ULONG_PTR> coreMaskList;
+	System::GetPhysicalCoreAffinityMasks(coreMaskList);
+	if(coreMaskList.empty())
+		return;
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		ULONG_PTR coreMask=coreMaskList[workerTrav%coreMaskList.size()];
+		unsigned long firstProcessor=0;
+		while(firstProcessor<sizeof(ULONG_PTR)*8 && !(coreMask&(static_cast<ULONG_PTR>(1)<<firstProcessor)))
+			firstProcessor++;
+		m_workers[workerTrav]->SetAffinityMask(coreMask);
+		m_workers[workerTrav]->m_numaNode=System::GetNumaNodeOfProcessor(firstProcessor);
+	}
+}
+
+void ThreadPool::Push(BaseJob * const job)
+{
+	EP_ASSERT_EXPR(job,_T("Job is NULL!"));
+	if(!job)
+		return;
+	job->RetainObj();
+	job->JobReport(BaseJob::JOB_STATUS_IN_QUEUE);
+
+	ThreadPoolWorker *worker=findCurrentWorker();
+	if(!worker)
+	{
+		unsigned long workerIdx=static_cast<unsigned long>(InterlockedIncrement(&m_nextWorkerIdx));
+		worker=m_workers[workerIdx%m_workers.size()];
+	}
+	worker->pushLocal(job);
+	InterlockedIncrement(&m_jobCount);
+	m_jobSignal.Release(1);
+}
+
+JobHandle *ThreadPool::Submit(BaseJob * const job)
+{
+	EP_ASSERT_EXPR(job,_T("Job is NULL!"));
+	if(!job)
+		return NULL;
+	Push(job);
+	return job->GetHandle();
+}
+
+bool ThreadPool::IsStarted() const
+{
+	return m_isStarted!=0;
+}
+
+unsigned int ThreadPool::GetWorkerCount() const
+{
+	return static_cast<unsigned int>(m_workers.size());
+}
+
+ThreadPoolWorker *ThreadPool::GetWorker(unsigned int workerIdx)
+{
+	EP_ASSERT_EXPR(workerIdx<m_workers.size(),_T("Index out of range! (index: %d, worker count: %d)"),workerIdx,m_workers.size());
+	return m_workers[workerIdx];
+}
+
+size_t ThreadPool::GetJobCount() const
+{
+	long jobCount=m_jobCount;
+	if(jobCount<0)
+		return 0;
+	return static_cast<size_t>(jobCount);
+}
+
+void ThreadPool::GetMetrics(WorkerMetricsSnapshot &retSnapshot) const
+{
+	retSnapshot=WorkerMetricsSnapshot();
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		WorkerMetricsSnapshot workerSnapshot;
+		m_workers[workerTrav]->GetMetrics(workerSnapshot);
+		retSnapshot.Add(workerSnapshot);
+	}
+}
+
+BaseJobProcessor* ThreadPool::GetJobProcessor()
+{
+	return m_jobProcessor;
+}
+
+ThreadPoolWorker *ThreadPool::findCurrentWorker()
+{
+	Thread::ThreadID curThreadID=static_cast<Thread::ThreadID>(GetCurrentThreadId());
+	for(unsigned int workerTrav=0;workerTrav<m_workers.size();workerTrav++)
+	{
+		if(m_workers[workerTrav]->GetID()==curThreadID)
+			return m_workers[workerTrav];
+	}
+	return NULL;
+}
+
+BaseJob *ThreadPool::steal(unsigned int thiefIdx)
+{
+	unsigned int workerCount=static_cast<unsigned int>(m_workers.size());
+	for(unsigned int workerTrav=1;workerTrav<workerCount;workerTrav++)
+	{
+		BaseJob *jobPtr=m_workers[(thiefIdx+workerTrav)%workerCount]->stealLocal();
+		if(jobPtr)
+			return jobPtr;
+	}
+	return NULL;
+}
+
+void ThreadPool::processJob(ThreadPoolWorker *worker, BaseJob *job)
+{
+	InterlockedDecrement(&m_jobCount);
+	worker->processJob(job);
+}
+
+void ThreadPool::waitForJob(unsigned int waitTimeInMilliSec)
+{
+	if(m_jobCount>0 || isStopping())
+		return;
+	m_jobSignal.TryLockFor(waitTimeInMilliSec);
+}
+
+bool ThreadPool::isStopping() const
+{
+	return m_isStopping!=0;
+}
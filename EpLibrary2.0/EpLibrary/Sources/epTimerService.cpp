@@ -0,0 +1,400 @@
+/*! 
+TimerService for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epTimerService.h"
+#include "epThreadPool.h"
+#include "epThread.h"
+#include "epEventEx.h"
+#include "epClock.h"
+#include "epCriticalSectionEx.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the number of the ticks the whole timer wheel covers
+#define TIMER_WHEEL_RANGE (((__int64)1)<<(TIMER_WHEEL_SLOT_BITS*TIMER_WHEEL_LEVEL_COUNT))
+/// the mask of the slot index of each level
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOT_COUNT-1)
+/// the node index marking the end of the list
+#define TIMER_NODE_INVALID 0xFFFFFFFF
+/// the tick to wake up at when no timer exists
+#define TIMER_TICK_INFINITE 0x7FFFFFFFFFFFFFFFLL
+
+namespace epl
+{
+	/*! 
+	@class TimerServiceThread epTimerService.cpp
+	@brief A background thread advancing the timer wheel of TimerService.
+	*/
+	class TimerServiceThread:public Thread
+	{
+	public:
+		/*!
+		Default Constructor
+		@param[in] service the timer service to advance.
+		*/
+		TimerServiceThread(TimerService &service):Thread(),m_service(service),m_wakeEvent(false,false)
+		{
+			m_isStopping=false;
+		}
+
+		/*!
+		Wake the thread to recalculate the time to wait.
+		*/
+		void Wake()
+		{
+			m_wakeEvent.SetEvent();
+		}
+
+		/*!
+		Stop the thread, and wait until it ends.
+		*/
+		void Stop()
+		{
+			m_isStopping=true;
+			m_wakeEvent.SetEvent();
+			WaitFor();
+		}
+
+	protected:
+		/*!
+		Advance the wheel and push the jobs expired to the pool until stopped.
+		*/
+		virtual void execute()
+		{
+			vector<BaseJob*> jobList;
+			while(!m_isStopping)
+			{
+				unsigned int waitTime=m_service.advance(jobList);
+				for(size_t jobTrav=0;jobTrav<jobList.size();jobTrav++)
+				{
+					m_service.m_pool->Push(jobList[jobTrav]);
+					jobList[jobTrav]->ReleaseObj();
+				}
+				jobList.clear();
+				if(m_isStopping)
+					break;
+				WaitForSingleObject(m_wakeEvent.GetEventHandle(),waitTime);
+			}
+		}
+
+	private:
+		/// the timer service to advance
+		TimerService &m_service;
+		/// the event waking the thread
+		EventEx m_wakeEvent;
+		/// the flag whether the thread is stopping
+		volatile bool m_isStopping;
+	};
+}
+
+TimerService::TimerService(ThreadPool *pool, unsigned int resolutionInMilliSec):m_farHeap(KARY_HEAP_MODE_INDEXED,LOCK_POLICY_NONE)
+{
+	EP_ASSERT(pool);
+	EP_ASSERT(resolutionInMilliSec>0);
+	m_pool=pool;
+	m_resolution=resolutionInMilliSec;
+	m_startMilliSec=Clock::GetMilliSec();
+	m_currentTick=0;
+	m_wakeTick=TIMER_TICK_INFINITE;
+	m_freeHead=TIMER_NODE_INVALID;
+	m_slotHeadList.resize(TIMER_WHEEL_SLOT_COUNT*TIMER_WHEEL_LEVEL_COUNT,TIMER_NODE_INVALID);
+	m_wheelCount=0;
+	m_timerLock=EP_NEW CriticalSectionEx();
+	m_thread=EP_NEW TimerServiceThread(*this);
+	m_thread->Start();
+}
+
+TimerService::~TimerService()
+{
+	m_thread->Stop();
+	EP_DELETE m_thread;
+	for(size_t nodeTrav=0;nodeTrav<m_nodeList.size();nodeTrav++)
+	{
+		if(m_nodeList[nodeTrav].location!=NODE_LOCATION_FREE)
+			m_nodeList[nodeTrav].job->ReleaseObj();
+	}
+	EP_DELETE m_timerLock;
+}
+
+TimerId TimerService::Schedule(BaseJob * const job, unsigned int delayInMilliSec)
+{
+	EP_ASSERT(job);
+	if(!job)
+		return 0;
+	job->RetainObj();
+
+	TimerId retId;
+	bool shouldWake=false;
+	{
+		LockObj lock(m_timerLock);
+		unsigned int nodeIdx=m_freeHead;
+		if(nodeIdx!=TIMER_NODE_INVALID)
+		{
+			m_freeHead=m_nodeList[nodeIdx].prev;
+		}
+		else
+		{
+			TimerNode newNode;
+			newNode.generation=1;
+			nodeIdx=(unsigned int)m_nodeList.size();
+			m_nodeList.push_back(newNode);
+		}
+
+		TimerNode &node=m_nodeList[nodeIdx];
+		node.job=job;
+		// round up, so the timer never expires before its delay
+		node.expireTick=(Clock::GetMilliSec()-m_startMilliSec+delayInMilliSec+m_resolution-1)/m_resolution;
+		if(node.expireTick<=m_currentTick)
+			node.expireTick=m_currentTick+1;
+		place(nodeIdx);
+
+		__int64 wakeTick=getWakeTick(nodeIdx);
+		if(wakeTick<m_wakeTick)
+		{
+			m_wakeTick=wakeTick;
+			shouldWake=true;
+		}
+		retId=(((TimerId)node.generation)<<32)|nodeIdx;
+	}
+	if(shouldWake)
+		m_thread->Wake();
+	return retId;
+}
+
+bool TimerService::Cancel(TimerId timerId)
+{
+	unsigned int nodeIdx=(unsigned int)(timerId&0xFFFFFFFF);
+	unsigned int generation=(unsigned int)(timerId>>32);
+	BaseJob *job;
+	{
+		LockObj lock(m_timerLock);
+		if(nodeIdx>=m_nodeList.size())
+			return false;
+		TimerNode &node=m_nodeList[nodeIdx];
+		if(node.location==NODE_LOCATION_FREE || node.generation!=generation)
+			return false;
+		if(node.location==NODE_LOCATION_WHEEL)
+		{
+			unlink(nodeIdx);
+		}
+		else
+		{
+			HeapKey key;
+			key.expireTick=node.expireTick;
+			key.nodeIdx=nodeIdx;
+			m_farHeap.Erase(key);
+		}
+		job=node.job;
+		freeNode(nodeIdx);
+	}
+	// the thread just wakes up for nothing if the cancelled timer was the earliest
+	job->ReleaseObj();
+	return true;
+}
+
+size_t TimerService::GetTimerCount() const
+{
+	LockObj lock(m_timerLock);
+	return m_wheelCount+m_farHeap.Size();
+}
+
+unsigned int TimerService::GetResolution() const
+{
+	return m_resolution;
+}
+
+ThreadPool *TimerService::GetThreadPool() const
+{
+	return m_pool;
+}
+
+__int64 TimerService::getClockTick() const
+{
+	return (Clock::GetMilliSec()-m_startMilliSec)/m_resolution;
+}
+
+void TimerService::place(unsigned int nodeIdx)
+{
+	TimerNode &node=m_nodeList[nodeIdx];
+	__int64 delta=node.expireTick-m_currentTick;
+	if(delta<TIMER_WHEEL_RANGE)
+	{
+		unsigned int slot;
+		if(delta<=0)
+		{
+			// only while cascading, so the node is expired in the slot of the current tick
+			slot=(unsigned int)(m_currentTick&TIMER_WHEEL_SLOT_MASK);
+		}
+		else
+		{
+			int level=0;
+			while(delta>=(((__int64)1)<<(TIMER_WHEEL_SLOT_BITS*(level+1))))
+				level++;
+			slot=level*TIMER_WHEEL_SLOT_COUNT+(unsigned int)((node.expireTick>>(TIMER_WHEEL_SLOT_BITS*level))&TIMER_WHEEL_SLOT_MASK);
+		}
+		node.slot=slot;
+		node.prev=TIMER_NODE_INVALID;
+		node.next=m_slotHeadList[slot];
+		if(node.next!=TIMER_NODE_INVALID)
+			m_nodeList[node.next].prev=nodeIdx;
+		m_slotHeadList[slot]=nodeIdx;
+		node.location=NODE_LOCATION_WHEEL;
+		m_wheelCount++;
+	}
+	else
+	{
+		HeapKey key;
+		key.expireTick=node.expireTick;
+		key.nodeIdx=nodeIdx;
+		m_farHeap.Push(key,nodeIdx);
+		node.location=NODE_LOCATION_HEAP;
+	}
+}
+
+void TimerService::unlink(unsigned int nodeIdx)
+{
+	TimerNode &node=m_nodeList[nodeIdx];
+	if(node.prev!=TIMER_NODE_INVALID)
+		m_nodeList[node.prev].next=node.next;
+	else
+		m_slotHeadList[node.slot]=node.next;
+	if(node.next!=TIMER_NODE_INVALID)
+		m_nodeList[node.next].prev=node.prev;
+	m_wheelCount--;
+}
+
+__int64 TimerService::getWakeTick(unsigned int nodeIdx) const
+{
+	const TimerNode &node=m_nodeList[nodeIdx];
+	if(node.location==NODE_LOCATION_WHEEL)
+		return m_currentTick+1;
+	// the first tick the far timer can be moved into the wheel
+	return node.expireTick-TIMER_WHEEL_RANGE+1;
+}
+
+void TimerService::freeNode(unsigned int nodeIdx)
+{
+	TimerNode &node=m_nodeList[nodeIdx];
+	node.job=NULL;
+	node.location=NODE_LOCATION_FREE;
+	node.generation++;
+	if(node.generation==0)
+		node.generation=1;
+	node.prev=m_freeHead;
+	m_freeHead=nodeIdx;
+}
+
+void TimerService::tick(vector<BaseJob*> &retJobList)
+{
+	__int64 curTick=++m_currentTick;
+
+	// cascade the upper levels whose slot comes due on this tick, from the top
+	for(int levelTrav=TIMER_WHEEL_LEVEL_COUNT-1;levelTrav>0;levelTrav--)
+	{
+		if((curTick&((((__int64)1)<<(TIMER_WHEEL_SLOT_BITS*levelTrav))-1))!=0)
+			continue;
+		unsigned int slot=levelTrav*TIMER_WHEEL_SLOT_COUNT+(unsigned int)((curTick>>(TIMER_WHEEL_SLOT_BITS*levelTrav))&TIMER_WHEEL_SLOT_MASK);
+		unsigned int nodeIdx=m_slotHeadList[slot];
+		m_slotHeadList[slot]=TIMER_NODE_INVALID;
+		while(nodeIdx!=TIMER_NODE_INVALID)
+		{
+			unsigned int nextIdx=m_nodeList[nodeIdx].next;
+			m_wheelCount--;
+			place(nodeIdx);
+			nodeIdx=nextIdx;
+		}
+	}
+
+	// move the far timers coming within the wheel
+	HeapKey key;
+	unsigned int nodeIdx;
+	while(m_farHeap.Front(key,nodeIdx) && key.expireTick-curTick<TIMER_WHEEL_RANGE)
+	{
+		m_farHeap.Pop(key,nodeIdx);
+		place(nodeIdx);
+	}
+
+	// expire the timers of the current slot
+	unsigned int slot=(unsigned int)(curTick&TIMER_WHEEL_SLOT_MASK);
+	nodeIdx=m_slotHeadList[slot];
+	m_slotHeadList[slot]=TIMER_NODE_INVALID;
+	while(nodeIdx!=TIMER_NODE_INVALID)
+	{
+		unsigned int nextIdx=m_nodeList[nodeIdx].next;
+		m_wheelCount--;
+		retJobList.push_back(m_nodeList[nodeIdx].job);
+		freeNode(nodeIdx);
+		nodeIdx=nextIdx;
+	}
+}
+
+unsigned int TimerService::advance(vector<BaseJob*> &retJobList)
+{
+	LockObj lock(m_timerLock);
+	__int64 targetTick=getClockTick();
+	HeapKey key;
+	unsigned int nodeIdx;
+	while(m_currentTick<targetTick)
+	{
+		if(m_wheelCount==0)
+		{
+			// nothing to expire until the first far timer comes within the wheel
+			if(!m_farHeap.Front(key,nodeIdx))
+			{
+				m_currentTick=targetTick;
+				break;
+			}
+			__int64 jumpTick=key.expireTick-TIMER_WHEEL_RANGE;
+			if(jumpTick>m_currentTick)
+				m_currentTick=(jumpTick<targetTick)?jumpTick:targetTick;
+			if(m_currentTick>=targetTick)
+				break;
+		}
+		tick(retJobList);
+	}
+
+	if(m_wheelCount>0)
+		m_wakeTick=m_currentTick+1;
+	else if(m_farHeap.Front(key,nodeIdx))
+		m_wakeTick=getWakeTick(nodeIdx);
+	else
+	{
+		m_wakeTick=TIMER_TICK_INFINITE;
+		return WAITTIME_INIFINITE;
+	}
+
+	__int64 waitTime=m_startMilliSec+m_wakeTick*m_resolution-Clock::GetMilliSec();
+	if(waitTime<0)
+		return 0;
+	if(waitTime>=WAITTIME_INIFINITE)
+		return WAITTIME_INIFINITE-1;
+	return (unsigned int)waitTime;
+}
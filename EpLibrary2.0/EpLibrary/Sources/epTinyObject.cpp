@@ -44,6 +44,13 @@ suitability of this software for any purpose. It is provided "as is"
 #include "epException.h"
 
 
+/// the size of the header in front of the fragment data, which keeps the index of the fragment
+#define TINY_OBJECT_FRAGMENT_HEADER_SIZE 16
+/// the page number of the deleted entry in the page map
+#define TINY_OBJECT_PAGE_DELETED (~static_cast<size_t>(0))
+/// the minimum capacity of the page map
+#define TINY_OBJECT_PAGE_MAP_MIN_CAPACITY 16
+
 namespace epl
 {
 	void StaticAllocator::Fragment::Init(size_t blockSize, unsigned char blocks)
@@ -52,7 +59,7 @@ namespace epl
 		EP_ASSERT(blocks > 0);
 		EP_ASSERT((blockSize * blocks) / blockSize == blocks);
 
-		m_Data = EP_NEW unsigned char[blockSize * static_cast<size_t>(blocks)];
+		m_Data = EP_NEW unsigned char[TINY_OBJECT_FRAGMENT_HEADER_SIZE + blockSize * static_cast<size_t>(blocks)] + TINY_OBJECT_FRAGMENT_HEADER_SIZE;
 		Reset(blockSize, blocks);
 
 	}
@@ -96,7 +103,7 @@ namespace epl
 	void StaticAllocator::Fragment::Clear()
 	{
 		if (m_Data)
-			EP_DELETE[] m_Data;
+			EP_DELETE[] (m_Data - TINY_OBJECT_FRAGMENT_HEADER_SIZE);
 		m_Data=NULL;
 		firstAvailableBlock=0;
 		numBlocksAvailable=0;
@@ -108,6 +115,9 @@ namespace epl
 		: m_blockSize(blockSize)
 		, m_allocFragment(0)
 		, m_deallocFragment(0)
+		, m_pageShift(0)
+		, m_pageCount(0)
+		, m_pageUsed(0)
 	{
 		EP_ASSERT(m_blockSize > 0);
 
@@ -117,6 +127,11 @@ namespace epl
 
 		m_numBlocks = static_cast<unsigned char>(numBlocks);
 		EP_ASSERT(m_numBlocks == numBlocks);
+
+		// the fragment is not larger than the page, so it lies on at most 2 pages
+		size_t chunkLength = m_numBlocks * m_blockSize;
+		while ((static_cast<size_t>(1) << m_pageShift) < chunkLength)
+			m_pageShift++;
 	}
 
 
@@ -124,6 +139,10 @@ namespace epl
 		: m_blockSize(rhs.m_blockSize)
 		, m_numBlocks(rhs.m_numBlocks)
 		, m_fragments(rhs.m_fragments)
+		, m_pageShift(rhs.m_pageShift)
+		, m_pageMap(rhs.m_pageMap)
+		, m_pageCount(rhs.m_pageCount)
+		, m_pageUsed(rhs.m_pageUsed)
 	{
 		m_allocFragment = rhs.m_allocFragment
 			? &(m_fragments.front()) + (rhs.m_allocFragment - &(rhs.m_fragments.front()))
@@ -151,6 +170,10 @@ namespace epl
 		SwapFunc<Fragments>(&m_fragments, &(rhs.m_fragments));
 		SwapFunc<Fragment*>(&m_allocFragment, &(rhs.m_allocFragment));
 		SwapFunc<Fragment*>(&m_deallocFragment, &(rhs.m_deallocFragment));
+		SwapFunc<size_t>(&m_pageShift, &(rhs.m_pageShift));
+		m_pageMap.swap(rhs.m_pageMap);
+		SwapFunc<size_t>(&m_pageCount, &(rhs.m_pageCount));
+		SwapFunc<size_t>(&m_pageUsed, &(rhs.m_pageUsed));
 	}
 
 	void *StaticAllocator::Allocate()
@@ -171,6 +194,7 @@ namespace epl
 					m_fragments.push_back(newFragment);
 					Fragment *tmpFrag=&(m_fragments.at(m_fragments.size()-1));
 					*tmpFrag=newFragment;
+					registerFragment(m_fragments.size()-1);
 					m_allocFragment=&(m_fragments.back());
 					m_deallocFragment=&(m_fragments.back());
 					break;
@@ -193,7 +217,7 @@ namespace epl
 		EP_ASSERT(&(m_fragments.front()) <= m_deallocFragment);
 		EP_ASSERT(&(m_fragments.back()) >= m_deallocFragment);
 
-		m_deallocFragment  = VicinityFind(p);
+		m_deallocFragment  = findFragment(p);
 		EP_ASSERT(m_deallocFragment);
 
 		Release(p,type);
@@ -202,6 +226,9 @@ namespace epl
 	{
 		EP_ASSERT(m_fragments.empty());
 		m_fragments.clear();
+		m_pageMap.clear();
+		m_pageCount=0;
+		m_pageUsed=0;
 	}
 	void StaticAllocator::Delete()
 	{
@@ -214,6 +241,9 @@ namespace epl
 			tmp->Clear();
 		}
 		m_fragments.clear();
+		m_pageMap.clear();
+		m_pageCount=0;
+		m_pageUsed=0;
 		m_blockSize=0;
 		m_numBlocks=0;
 		m_allocFragment=NULL;
@@ -229,8 +259,12 @@ namespace epl
 				Fragment *tmp=&(m_fragments.at(trav));
 				if(tmp->numBlocksAvailable==m_numBlocks)
 				{
+					unregisterFragment(trav);
 					tmp->Clear();
 					m_fragments.erase(m_fragments.begin()+trav);
+					// the fragments after the erased one moved forward
+					for(size_t moveTrav=trav;moveTrav<m_fragments.size();moveTrav++)
+						setFragmentIndex(moveTrav);
 				}
 			}
 			if(m_fragments.empty())
@@ -245,43 +279,114 @@ namespace epl
 		}
 
 	}
-	StaticAllocator::Fragment* StaticAllocator::VicinityFind(void* p)
+	StaticAllocator::Fragment* StaticAllocator::findFragment(void* p)
 	{
 		EP_ASSERT(!m_fragments.empty());
-		EP_ASSERT(m_deallocFragment);
+		EP_ASSERT(!m_pageMap.empty());
 
 		size_t chunkLength = m_numBlocks * m_blockSize;
+		size_t page = reinterpret_cast<size_t>(p) >> m_pageShift;
+		size_t mask = m_pageMap.size() - 1;
+		// up to 3 fragments share the page, so check the range of each entry of the page
+		for (size_t slot = (page * 0x9E3779B1) & mask; m_pageMap[slot].m_page; slot = (slot + 1) & mask)
+		{
+			PageEntry &entry = m_pageMap[slot];
+			if (entry.m_page == page && p >= entry.m_data && p < entry.m_data + chunkLength)
+			{
+				size_t fragmentIdx = *reinterpret_cast<size_t*>(entry.m_data - TINY_OBJECT_FRAGMENT_HEADER_SIZE);
+				EP_ASSERT(fragmentIdx < m_fragments.size());
+				return &(m_fragments.at(fragmentIdx));
+			}
+		}
+		EP_ASSERT(0);
+		return NULL;
+	}
+
+	void StaticAllocator::setFragmentIndex(size_t fragmentIdx)
+	{
+		Fragment &fragment = m_fragments.at(fragmentIdx);
+		if (fragment.m_Data)
+			*reinterpret_cast<size_t*>(fragment.m_Data - TINY_OBJECT_FRAGMENT_HEADER_SIZE) = fragmentIdx;
+	}
 
-		Fragment* lo = m_deallocFragment;
-		Fragment* hi = m_deallocFragment + 1;
-		Fragment* loBound = &(m_fragments.front());
-		Fragment* hiBound = &(m_fragments.back()) + 1;
+	void StaticAllocator::registerFragment(size_t fragmentIdx)
+	{
+		setFragmentIndex(fragmentIdx);
+		unsigned char *data = m_fragments.at(fragmentIdx).m_Data;
+		size_t firstPage = reinterpret_cast<size_t>(data) >> m_pageShift;
+		size_t lastPage = (reinterpret_cast<size_t>(data) + m_numBlocks * m_blockSize - 1) >> m_pageShift;
+		for (size_t pageTrav = firstPage; pageTrav <= lastPage; pageTrav++)
+			insertPage(pageTrav, data);
+	}
 
-		if (hi == hiBound) hi = 0;
+	void StaticAllocator::unregisterFragment(size_t fragmentIdx)
+	{
+		unsigned char *data = m_fragments.at(fragmentIdx).m_Data;
+		size_t firstPage = reinterpret_cast<size_t>(data) >> m_pageShift;
+		size_t lastPage = (reinterpret_cast<size_t>(data) + m_numBlocks * m_blockSize - 1) >> m_pageShift;
+		for (size_t pageTrav = firstPage; pageTrav <= lastPage; pageTrav++)
+			removePage(pageTrav, data);
+	}
 
-		for (;;)
+	void StaticAllocator::insertPage(size_t page, unsigned char *data)
+	{
+		// keep the table at most half full, counting the deleted entries
+		if ((m_pageUsed + 1) * 2 > m_pageMap.size())
 		{
-			if (lo)
-			{
-				if (p >= lo->m_Data && p < lo->m_Data + chunkLength)
-				{
-					return lo;
-				}
-				if (lo == loBound) 
-					lo = 0;
-				else --lo;
-			}
+			size_t capacity = TINY_OBJECT_PAGE_MAP_MIN_CAPACITY;
+			while (capacity < (m_pageCount + 1) * 4)
+				capacity <<= 1;
+			rehashPageMap(capacity);
+		}
+		size_t mask = m_pageMap.size() - 1;
+		size_t slot = (page * 0x9E3779B1) & mask;
+		while (m_pageMap[slot].m_page && m_pageMap[slot].m_page != TINY_OBJECT_PAGE_DELETED)
+			slot = (slot + 1) & mask;
+		if (!m_pageMap[slot].m_page)
+			m_pageUsed++;
+		m_pageMap[slot].m_page = page;
+		m_pageMap[slot].m_data = data;
+		m_pageCount++;
+	}
 
-			if (hi)
+	void StaticAllocator::removePage(size_t page, unsigned char *data)
+	{
+		size_t mask = m_pageMap.size() - 1;
+		for (size_t slot = (page * 0x9E3779B1) & mask; m_pageMap[slot].m_page; slot = (slot + 1) & mask)
+		{
+			if (m_pageMap[slot].m_page == page && m_pageMap[slot].m_data == data)
 			{
-				if (p >= hi->m_Data && p < hi->m_Data + chunkLength)
-				{
-					return hi;
-				}
-				if (++hi == hiBound) 
-					hi = 0;
+				m_pageMap[slot].m_page = TINY_OBJECT_PAGE_DELETED;
+				m_pageMap[slot].m_data = NULL;
+				m_pageCount--;
+				return;
 			}
 		}
+		EP_ASSERT(0);
+	}
+
+	void StaticAllocator::rehashPageMap(size_t capacity)
+	{
+		PageMap oldMap;
+		oldMap.swap(m_pageMap);
+		PageEntry emptyEntry;
+		emptyEntry.m_page = 0;
+		emptyEntry.m_data = NULL;
+		m_pageMap.assign(capacity, emptyEntry);
+		m_pageCount = 0;
+		m_pageUsed = 0;
+		size_t mask = capacity - 1;
+		for (size_t entryTrav = 0; entryTrav < oldMap.size(); entryTrav++)
+		{
+			if (!oldMap[entryTrav].m_page || oldMap[entryTrav].m_page == TINY_OBJECT_PAGE_DELETED)
+				continue;
+			size_t slot = (oldMap[entryTrav].m_page * 0x9E3779B1) & mask;
+			while (m_pageMap[slot].m_page)
+				slot = (slot + 1) & mask;
+			m_pageMap[slot] = oldMap[entryTrav];
+			m_pageCount++;
+			m_pageUsed++;
+		}
 	}
 
 	void StaticAllocator::Release(void* p, CacheType type)
@@ -299,12 +404,15 @@ namespace epl
 		{
 			Fragment * lastFragment =&(m_fragments.back());
 			SwapFunc<Fragment>(m_deallocFragment,lastFragment);
+			setFragmentIndex(m_deallocFragment-&(m_fragments.front()));
+			setFragmentIndex(m_fragments.size()-1);
 			if(type&CACHE_TYPE_FRAGMENT)
 			{
 				lastFragment->Reset(m_blockSize,m_numBlocks);
 			}
 			else
 			{
+				unregisterFragment(m_fragments.size()-1);
 				lastFragment->Clear();
 				m_fragments.erase(m_fragments.begin()+(m_fragments.size()-1));
 			}
@@ -353,20 +461,53 @@ namespace epl
 
 
 
-	TinyObjAllocator::TinyObjAllocator(size_t fragmentSize,size_t maxObjectSize)
+	TinyObjAllocator::TinyObjAllocator(size_t fragmentSize,size_t maxObjectSize,LockPolicy lockPolicyType)
 		: m_lastAlloc(0), m_lastDealloc(0), m_fragmentSize(fragmentSize), m_maxObjectSize(maxObjectSize) 
 	{   
+		m_tlsIndex=TlsAlloc();
+		EP_ASSERT(m_tlsIndex!=TLS_OUT_OF_INDEXES);
+		m_lockPolicy=lockPolicyType;
+		switch(lockPolicyType)
+		{
+		case LOCK_POLICY_CRITICALSECTION:
+			m_poolLock=EP_NEW CriticalSectionEx();
+			break;
+		case LOCK_POLICY_MUTEX:
+			m_poolLock=EP_NEW Mutex();
+			break;
+		case LOCK_POLICY_NONE:
+			m_poolLock=EP_NEW NoLock();
+			break;
+		case LOCK_POLICY_SPIN_PARK:
+			m_poolLock=EP_NEW SpinParkLock();
+			break;
+		case LOCK_POLICY_READER_WRITER:
+			m_poolLock=EP_NEW ReaderWriterLock();
+			break;
+		default:
+			m_poolLock=NULL;
+			break;
+		}
 	}
 	TinyObjAllocator::~TinyObjAllocator()
 	{
 		size_t trav;
+		// the cached blocks belong to the fragments deleted below
+		for(trav=0;trav<m_threadCaches.size();trav++)
+		{
+			EP_DELETE m_threadCaches.at(trav);
+		}
+		m_threadCaches.clear();
+		if(m_tlsIndex!=TLS_OUT_OF_INDEXES)
+			TlsFree(m_tlsIndex);
 		for(trav=0;trav<m_pool.size();trav++)
 		{
 			StaticAllocator *tmp=&(m_pool.at(trav));
 			tmp->Delete();
 		}
 		m_pool.clear();
-
+		if(m_poolLock)
+			EP_DELETE m_poolLock;
 	}
 
 	void* TinyObjAllocator::Allocate(size_t numBytes)
@@ -374,6 +515,102 @@ namespace epl
 		if (numBytes > m_maxObjectSize) 
 			return operator new(numBytes);
 
+		Magazine &magazine=getThreadCache()->at(numBytes);
+		if(magazine.m_count==0)
+			refill(magazine,numBytes);
+		return magazine.m_blocks[--magazine.m_count];
+	}
+
+	void TinyObjAllocator::Deallocate(void* p, size_t numBytes, CacheType type)
+	{
+		if (numBytes > m_maxObjectSize) 
+		{
+			operator delete(p);
+			return;
+		}
+
+		// the cache types releasing the memory right away bypass the magazine
+		if(!(type&CACHE_TYPE_STATIC) || (type&CACHE_TYPE_COMPRESS))
+		{
+			m_poolLock->Lock();
+			deallocateBlock(p,numBytes,type);
+			m_poolLock->Unlock();
+			return;
+		}
+
+		Magazine &magazine=getThreadCache()->at(numBytes);
+		if(magazine.m_count==TINY_OBJECT_MAGAZINE_SIZE)
+			flush(magazine,numBytes,type,TINY_OBJECT_MAGAZINE_SIZE/2);
+		magazine.m_blocks[magazine.m_count++]=p;
+	}
+
+	void TinyObjAllocator::Compress(CacheType type)
+	{
+		FlushThreadCache(type);
+		m_poolLock->Lock();
+		compressPool(type);
+		m_poolLock->Unlock();
+	}
+
+	void TinyObjAllocator::FlushThreadCache(CacheType type)
+	{
+		ThreadCache *cache=reinterpret_cast<ThreadCache*>(TlsGetValue(m_tlsIndex));
+		if(!cache)
+			return;
+		size_t trav;
+		for(trav=0;trav<cache->size();trav++)
+		{
+			Magazine &magazine=cache->at(trav);
+			if(magazine.m_count)
+				flush(magazine,trav,type,magazine.m_count);
+		}
+	}
+
+	TinyObjAllocator::ThreadCache *TinyObjAllocator::getThreadCache()
+	{
+		ThreadCache *cache=reinterpret_cast<ThreadCache*>(TlsGetValue(m_tlsIndex));
+		if(cache)
+			return cache;
+		Magazine emptyMagazine;
+		emptyMagazine.m_count=0;
+		cache=EP_NEW ThreadCache(m_maxObjectSize+1,emptyMagazine);
+		m_poolLock->Lock();
+		m_threadCaches.push_back(cache);
+		m_poolLock->Unlock();
+		TlsSetValue(m_tlsIndex,cache);
+		return cache;
+	}
+
+	void TinyObjAllocator::refill(Magazine &magazine, size_t numBytes)
+	{
+		m_poolLock->Lock();
+		while(magazine.m_count<TINY_OBJECT_MAGAZINE_SIZE/2)
+		{
+			magazine.m_blocks[magazine.m_count++]=allocateBlock(numBytes);
+		}
+		m_poolLock->Unlock();
+	}
+
+	void TinyObjAllocator::flush(Magazine &magazine, size_t numBytes, CacheType type, unsigned int flushCount)
+	{
+		EP_ASSERT(flushCount<=magazine.m_count);
+		m_poolLock->Lock();
+		// give back the oldest blocks, and keep the most recently freed ones which are likely in the cache
+		unsigned int trav;
+		for(trav=0;trav<flushCount;trav++)
+		{
+			deallocateBlock(magazine.m_blocks[trav],numBytes,type);
+		}
+		m_poolLock->Unlock();
+		for(trav=flushCount;trav<magazine.m_count;trav++)
+		{
+			magazine.m_blocks[trav-flushCount]=magazine.m_blocks[trav];
+		}
+		magazine.m_count-=flushCount;
+	}
+
+	void* TinyObjAllocator::allocateBlock(size_t numBytes)
+	{
 		if (m_lastAlloc && m_lastAlloc->GetBlockSize() == numBytes)
 		{
 			return m_lastAlloc->Allocate();
@@ -401,19 +638,13 @@ namespace epl
 		return m_lastAlloc->Allocate();
 	}
 
-	void TinyObjAllocator::Deallocate(void* p, size_t numBytes, CacheType type)
+	void TinyObjAllocator::deallocateBlock(void* p, size_t numBytes, CacheType type)
 	{
-		if (numBytes > m_maxObjectSize) 
-		{
-			operator delete(p);
-			return;
-		}
-
 		if (m_lastDealloc && m_lastDealloc->GetBlockSize() == numBytes)
 		{
 			m_lastDealloc->Deallocate(p,type);
 			if(type&CACHE_TYPE_COMPRESS)
-				Compress(type);
+				compressPool(type);
 			return;
 		}
 
@@ -449,10 +680,10 @@ namespace epl
 		}
 
 		if(type&CACHE_TYPE_COMPRESS)
-			Compress(type);
+			compressPool(type);
 	}
 
-	void TinyObjAllocator::Compress(CacheType type)
+	void TinyObjAllocator::compressPool(CacheType type)
 	{
 		ssize_t trav;
 		for(trav=static_cast<ssize_t>(m_pool.size())-1;trav>=0;trav--)
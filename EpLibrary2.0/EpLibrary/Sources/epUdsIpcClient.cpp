@@ -0,0 +1,315 @@
+/*! 
+UdsIpcClient for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdsIpcClient.h"
+
+#if defined(EP_PLATFORM_LINUX)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+UdsIpcClient::UdsIpcClient(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType),m_channel(lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	m_epoll=-1;
+	m_bufferPoolSet=NULL;
+}
+
+UdsIpcClient::~UdsIpcClient()
+{
+	Disconnect();
+	closeConnection();
+	if(m_bufferPoolSet)
+		m_bufferPoolSet->ReleaseObj();
+}
+
+epl::EpTString UdsIpcClient::GetFullPipeName() const
+{
+	return m_pipeName;
+}
+
+void UdsIpcClient::SetCallbackObject(IpcClientCallbackInterface *callBackObj)
+{
+	m_options.callBackObj=callBackObj;
+}
+
+IpcClientCallbackInterface *UdsIpcClient::GetCallbackObject()
+{
+	return m_options.callBackObj;
+}
+
+ConnectStatus UdsIpcClient::Connect(const IpcClientOps &ops, unsigned int waitTimeInMilliSec)
+{
+	EP_ASSERT(ops.callBackObj);
+	if(IsConnected())
+		return CONNECT_STATUS_SUCCESS;
+	// the previous connection disconnected on the thread of this instance is closed here
+	closeConnection();
+
+	if(ops.pipeName)
+	{
+		m_pipeName=UDS_IPC_NAME_PREFIX;
+		m_pipeName.append(ops.pipeName);
+	}
+	m_options=ops;
+	if(ops.numOfWriteBytes==0)
+		m_options.numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
+	if(ops.numOfReadBytes==0)
+		m_options.numOfReadBytes=DEFAULT_READ_BUF_SIZE;
+	if(ops.maxMessageByteSize==0)
+		m_options.maxMessageByteSize=IPC_MESSAGE_BYTE_SIZE_UNLIMITED;
+	if(waitTimeInMilliSec==0)
+		waitTimeInMilliSec=m_options.waitTimeInMilliSec;
+
+	if(!m_bufferPoolSet || m_bufferPoolSet->GetMinBufferByteSize()!=m_options.numOfWriteBytes)
+	{
+		// the elements still acquired keep the old pool set alive until released
+		if(m_bufferPoolSet)
+			m_bufferPoolSet->ReleaseObj();
+		m_bufferPoolSet=EP_NEW IpcBufferPoolSet(m_options.numOfWriteBytes,IPC_BUFFER_POOL_SET_MAX_FREE_COUNT,m_lockPolicy);
+	}
+
+	ConnectStatus status=CONNECT_STATUS_SUCCESS;
+	int socket=connectSocket(waitTimeInMilliSec,status);
+	if(socket==-1)
+		return status;
+
+	m_epoll=epoll_create1(EPOLL_CLOEXEC);
+	struct epoll_event event;
+	System::Memset(&event,0,sizeof(event));
+	event.events=EPOLLIN|EPOLLOUT|EPOLLRDHUP|EPOLLET;
+	event.data.ptr=this;
+	if(m_epoll==-1 || epoll_ctl(m_epoll,EPOLL_CTL_ADD,socket,&event)!=0)
+	{
+		close(socket);
+		if(m_epoll!=-1)
+			close(m_epoll);
+		m_epoll=-1;
+		return CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+	}
+	m_channel.Attach(socket,m_options.numOfReadBytes,m_options.maxMessageByteSize,0,m_bufferPoolSet);
+	if(!Start())
+	{
+		m_channel.Close();
+		close(m_epoll);
+		m_epoll=-1;
+		return CONNECT_STATUS_FAIL_READ_FAILED;
+	}
+	return CONNECT_STATUS_SUCCESS;
+}
+
+int UdsIpcClient::connectSocket(unsigned int waitTimeInMilliSec, ConnectStatus &retStatus)
+{
+	sockaddr_un address;
+	socklen_t addressByteSize=0;
+	if(!UdsIpcChannel::MakeAddress(m_pipeName.c_str(),address,addressByteSize))
+	{
+		EP_ASSERT_EXPR(0,_T("The pipe name is too long.\n"));
+		retStatus=CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+		return -1;
+	}
+
+	unsigned int startTime=System::GetTickCount();
+	while(true)
+	{
+		int socket=::socket(AF_UNIX,SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC,0);
+		if(socket==-1)
+		{
+			retStatus=CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+			return -1;
+		}
+		if(connect(socket,reinterpret_cast<sockaddr*>(&address),addressByteSize)==0)
+		{
+			retStatus=CONNECT_STATUS_SUCCESS;
+			return socket;
+		}
+		int error=errno;
+		close(socket);
+		// EAGAIN is given while the backlog of the server is full, otherwise no server is listening
+		if(error!=EAGAIN && error!=EINTR)
+		{
+			retStatus=CONNECT_STATUS_FAIL_PIPE_OPEN_FAILED;
+			return -1;
+		}
+		if(waitTimeInMilliSec!=WAITTIME_INIFINITE && System::GetTickCount()-startTime>=waitTimeInMilliSec)
+		{
+			retStatus=CONNECT_STATUS_FAIL_TIME_OUT;
+			return -1;
+		}
+		usleep(1000);
+	}
+}
+
+void UdsIpcClient::Disconnect()
+{
+	if(!m_channel.IsOpened())
+		return;
+	m_channel.Shutdown();
+	// the connection is closed at the next Connect or the destruction when disconnected on the thread of this instance
+	if(GetID()!=GetCurrentThreadId())
+		closeConnection();
+}
+
+void UdsIpcClient::closeConnection()
+{
+	if(!m_channel.IsOpened())
+		return;
+	WaitFor(m_options.waitTimeInMilliSec);
+	m_channel.Close();
+	close(m_epoll);
+	m_epoll=-1;
+}
+
+bool UdsIpcClient::IsConnected() const
+{
+	return m_channel.IsOpened() && !m_channel.IsClosed();
+}
+
+unsigned int UdsIpcClient::GetMaxWriteDataByteSize() const
+{
+	return m_options.maxMessageByteSize;
+}
+
+unsigned int UdsIpcClient::GetMaxReadDataByteSize() const
+{
+	return m_options.maxMessageByteSize;
+}
+
+void UdsIpcClient::execute()
+{
+	vector<unsigned int> reportByteSizes;
+	struct epoll_event events[1];
+	bool isAlive=true;
+	while(isAlive)
+	{
+		int eventCount=epoll_wait(m_epoll,events,1,-1);
+		if(eventCount<0)
+		{
+			if(errno==EINTR)
+				continue;
+			break;
+		}
+		if(eventCount==0)
+			continue;
+		if(events[0].events&EPOLLOUT)
+		{
+			reportByteSizes.clear();
+			isAlive=m_channel.Flush(reportByteSizes);
+			for(size_t reportTrav=0;reportTrav<reportByteSizes.size();reportTrav++)
+				m_options.callBackObj->OnWriteComplete(this,reportByteSizes[reportTrav],WRITE_STATUS_SUCCESS,0);
+		}
+		if(!isAlive || !(events[0].events&(EPOLLIN|EPOLLRDHUP|EPOLLHUP|EPOLLERR)))
+			continue;
+
+		// the socket is read until empty, since it is reported again only when more arrives
+		while(true)
+		{
+			const char *data=NULL;
+			unsigned int byteSize=0;
+			ReadStatus status=READ_STATUS_SUCCESS;
+			while(m_channel.Peek(data,byteSize,status))
+			{
+				// the data is read in place, so the space is given back after the callback
+				m_options.callBackObj->OnReadComplete(this,data,byteSize,status,0);
+				m_channel.Pop();
+			}
+			int recvByteSize=m_channel.Fill();
+			if(recvByteSize==0)
+				break;
+			if(recvByteSize<0)
+			{
+				isAlive=false;
+				break;
+			}
+		}
+	}
+	m_channel.Shutdown();
+	reportByteSizes.clear();
+	m_channel.DropQueue(reportByteSizes);
+	for(size_t reportTrav=0;reportTrav<reportByteSizes.size();reportTrav++)
+		m_options.callBackObj->OnWriteComplete(this,reportByteSizes[reportTrav],WRITE_STATUS_FAIL_WRITE_FAILED,0);
+	m_options.callBackObj->OnDisconnect(this);
+}
+
+void UdsIpcClient::reportSend(UdsIpcSendStatus status, unsigned int dataByteSize)
+{
+	switch(status)
+	{
+	case UDS_IPC_SEND_STATUS_COMPLETED:
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_SUCCESS,0);
+		break;
+	case UDS_IPC_SEND_STATUS_QUEUED:
+		// reported by the event loop once sent
+		break;
+	case UDS_IPC_SEND_STATUS_QUEUE_FULL:
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_QUEUE_FULL,0);
+		break;
+	default:
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_WRITE_FAILED,0);
+		break;
+	}
+}
+
+void UdsIpcClient::Write(char *data,unsigned int dataByteSize)
+{
+	IpcWriteSegment segment;
+	segment.m_data=data;
+	segment.m_dataSize=dataByteSize;
+	Write(&segment,1);
+}
+
+void UdsIpcClient::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	unsigned int dataByteSize=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		dataByteSize+=segmentList[segmentTrav].m_dataSize;
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+	reportSend(m_channel.Send(segmentList,segmentCount,dataByteSize),dataByteSize);
+}
+
+PipeWriteElem *UdsIpcClient::AcquireWriteBuffer(unsigned int dataByteSize)
+{
+	EP_ASSERT(m_bufferPoolSet);
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+	return m_bufferPoolSet->Acquire(dataByteSize);
+}
+
+void UdsIpcClient::WriteOwned(PipeWriteElem *elem)
+{
+	EP_ASSERT(elem);
+	// the element may be released once sent
+	unsigned int dataByteSize=elem->m_dataSize;
+	reportSend(m_channel.SendOwned(elem),dataByteSize);
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
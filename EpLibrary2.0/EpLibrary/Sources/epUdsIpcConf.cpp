@@ -0,0 +1,487 @@
+/*! 
+UdsIpcConf for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdsIpcConf.h"
+
+#if defined(EP_PLATFORM_LINUX)
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+UdsIpcChannel::UdsIpcChannel(LockPolicy lockPolicyType)
+{
+	m_socket=-1;
+	m_isClosed=1;
+	m_maxMessageByteSize=IPC_MESSAGE_BYTE_SIZE_UNLIMITED;
+	m_writeQueueCapacity=0;
+	m_bufferPoolSet=NULL;
+	m_sendOffset=0;
+	m_recvBuffer=NULL;
+	m_recvBufferByteSize=0;
+	m_recvHead=0;
+	m_recvTail=0;
+	m_peekByteSize=0;
+	m_longMessage=NULL;
+	m_longByteSize=0;
+	m_skipByteSize=0;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_sendLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_sendLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_sendLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_sendLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_sendLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_sendLock=NULL;
+		break;
+	}
+}
+
+UdsIpcChannel::~UdsIpcChannel()
+{
+	Close();
+	if(m_recvBuffer)
+		EP_DELETE[] m_recvBuffer;
+	if(m_sendLock)
+		EP_DELETE m_sendLock;
+}
+
+bool UdsIpcChannel::MakeAddress(const TCHAR *name, sockaddr_un &retAddress, socklen_t &retAddressByteSize)
+{
+	System::Memset(&retAddress,0,sizeof(sockaddr_un));
+	retAddress.sun_family=AF_UNIX;
+	// the address starting with the NULL is in the abstract namespace, so no file is left behind the server
+#if defined(_UNICODE) || defined(UNICODE)
+	size_t nameLength=wcstombs(retAddress.sun_path+1,name,UDS_IPC_MAX_NAME_LENGTH);
+	if(nameLength==static_cast<size_t>(-1) || nameLength>=UDS_IPC_MAX_NAME_LENGTH)
+		return false;
+#else //defined(_UNICODE) || defined(UNICODE)
+	size_t nameLength=strlen(name);
+	if(nameLength>=UDS_IPC_MAX_NAME_LENGTH)
+		return false;
+	System::Memcpy(retAddress.sun_path+1,name,nameLength);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	retAddressByteSize=static_cast<socklen_t>(offsetof(sockaddr_un,sun_path)+1+nameLength);
+	return true;
+}
+
+void UdsIpcChannel::Attach(int socket, unsigned int readByteSize, unsigned int maxMessageByteSize, unsigned int writeQueueCapacity, IpcBufferPoolSet *bufferPoolSet)
+{
+	EP_ASSERT(m_socket==-1);
+	EP_ASSERT(bufferPoolSet);
+	unsigned int recvBufferByteSize=readByteSize+IPC_FRAME_HEADER_SIZE;
+	if(recvBufferByteSize<UDS_IPC_MIN_READ_BUFFER_BYTE_SIZE)
+		recvBufferByteSize=UDS_IPC_MIN_READ_BUFFER_BYTE_SIZE;
+	if(m_recvBuffer && m_recvBufferByteSize!=recvBufferByteSize)
+	{
+		EP_DELETE[] m_recvBuffer;
+		m_recvBuffer=NULL;
+	}
+	if(!m_recvBuffer)
+		m_recvBuffer=EP_NEW char[recvBufferByteSize];
+	m_recvBufferByteSize=recvBufferByteSize;
+	m_recvHead=0;
+	m_recvTail=0;
+	m_peekByteSize=0;
+	m_skipByteSize=0;
+
+	m_maxMessageByteSize=maxMessageByteSize;
+	m_writeQueueCapacity=writeQueueCapacity;
+	m_bufferPoolSet=bufferPoolSet;
+	m_bufferPoolSet->RetainObj();
+	m_sendOffset=0;
+	m_socket=socket;
+	InterlockedExchange(&m_isClosed,0);
+}
+
+void UdsIpcChannel::Close()
+{
+	if(m_socket==-1)
+		return;
+	Shutdown();
+	vector<unsigned int> droppedByteSizes;
+	DropQueue(droppedByteSizes);
+	m_sendLock->Lock();
+	close(m_socket);
+	m_socket=-1;
+	m_sendLock->Unlock();
+
+	if(m_longMessage)
+		m_longMessage->ReleaseObj();
+	m_longMessage=NULL;
+	m_bufferPoolSet->ReleaseObj();
+	m_bufferPoolSet=NULL;
+}
+
+bool UdsIpcChannel::IsOpened() const
+{
+	return m_socket!=-1;
+}
+
+int UdsIpcChannel::GetSocket() const
+{
+	return m_socket;
+}
+
+int UdsIpcChannel::sendDirect(struct iovec *vectorList, unsigned int vectorCount, unsigned int frameByteSize)
+{
+	struct msghdr message;
+	System::Memset(&message,0,sizeof(message));
+	message.msg_iov=vectorList;
+	message.msg_iovlen=vectorCount;
+	ssize_t sentByteSize;
+	// MSG_NOSIGNAL keeps the peer gone from raising SIGPIPE
+	while((sentByteSize=sendmsg(m_socket,&message,MSG_DONTWAIT|MSG_NOSIGNAL))<0 && errno==EINTR);
+	if(sentByteSize>=0)
+		return static_cast<int>(sentByteSize);
+	if(errno==EAGAIN || errno==EWOULDBLOCK)
+		return 0;
+	return -1;
+}
+
+void UdsIpcChannel::gather(PipeWriteElem *elem, const IpcWriteSegment *segmentList, unsigned int segmentCount)
+{
+	unsigned int offset=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+	{
+		System::Memcpy(elem->m_data+offset,segmentList[segmentTrav].m_data,segmentList[segmentTrav].m_dataSize);
+		offset+=segmentList[segmentTrav].m_dataSize;
+	}
+}
+
+void UdsIpcChannel::queue(PipeWriteElem *elem, unsigned int sentByteSize)
+{
+	UdsIpcSendItem item;
+	item.m_header=elem->m_dataSize;
+	item.m_elem=elem;
+	if(m_sendQueue.empty())
+		m_sendOffset=sentByteSize;
+	m_sendQueue.push_back(item);
+}
+
+UdsIpcSendStatus UdsIpcChannel::Send(const IpcWriteSegment *segmentList, unsigned int segmentCount, unsigned int byteSize)
+{
+	if(segmentCount>UDS_IPC_MAX_SEGMENT_COUNT)
+	{
+		// too many segments to send at once, so they are gathered into one buffer first
+		PipeWriteElem *elem=m_bufferPoolSet->Acquire(byteSize);
+		gather(elem,segmentList,segmentCount);
+		return SendOwned(elem);
+	}
+
+	LockObj lock(m_sendLock);
+	if(m_socket==-1 || m_isClosed)
+		return UDS_IPC_SEND_STATUS_FAILED;
+
+	int sentByteSize=0;
+	if(m_sendQueue.empty())
+	{
+		unsigned int header=byteSize;
+		struct iovec vectorList[UDS_IPC_MAX_SEGMENT_COUNT+1];
+		vectorList[0].iov_base=&header;
+		vectorList[0].iov_len=IPC_FRAME_HEADER_SIZE;
+		for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		{
+			vectorList[segmentTrav+1].iov_base=const_cast<void*>(segmentList[segmentTrav].m_data);
+			vectorList[segmentTrav+1].iov_len=segmentList[segmentTrav].m_dataSize;
+		}
+		sentByteSize=sendDirect(vectorList,segmentCount+1,IPC_FRAME_HEADER_SIZE+byteSize);
+		if(sentByteSize<0)
+			return UDS_IPC_SEND_STATUS_FAILED;
+		if(static_cast<unsigned int>(sentByteSize)==IPC_FRAME_HEADER_SIZE+byteSize)
+			return UDS_IPC_SEND_STATUS_COMPLETED;
+		// the frame partly sent is queued regardless of the capacity to complete it
+	}
+	else if(m_writeQueueCapacity && m_sendQueue.size()>=m_writeQueueCapacity)
+		return UDS_IPC_SEND_STATUS_QUEUE_FULL;
+
+	PipeWriteElem *elem=m_bufferPoolSet->Acquire(byteSize);
+	gather(elem,segmentList,segmentCount);
+	queue(elem,static_cast<unsigned int>(sentByteSize));
+	return UDS_IPC_SEND_STATUS_QUEUED;
+}
+
+UdsIpcSendStatus UdsIpcChannel::SendOwned(PipeWriteElem *elem)
+{
+	m_sendLock->Lock();
+	if(m_socket==-1 || m_isClosed)
+	{
+		m_sendLock->Unlock();
+		elem->ReleaseObj();
+		return UDS_IPC_SEND_STATUS_FAILED;
+	}
+
+	int sentByteSize=0;
+	if(m_sendQueue.empty())
+	{
+		unsigned int header=elem->m_dataSize;
+		struct iovec vectorList[2];
+		vectorList[0].iov_base=&header;
+		vectorList[0].iov_len=IPC_FRAME_HEADER_SIZE;
+		vectorList[1].iov_base=elem->m_data;
+		vectorList[1].iov_len=elem->m_dataSize;
+		sentByteSize=sendDirect(vectorList,2,IPC_FRAME_HEADER_SIZE+elem->m_dataSize);
+		if(sentByteSize<0 || static_cast<unsigned int>(sentByteSize)==IPC_FRAME_HEADER_SIZE+elem->m_dataSize)
+		{
+			m_sendLock->Unlock();
+			elem->ReleaseObj();
+			if(sentByteSize<0)
+				return UDS_IPC_SEND_STATUS_FAILED;
+			return UDS_IPC_SEND_STATUS_COMPLETED;
+		}
+	}
+	else if(m_writeQueueCapacity && m_sendQueue.size()>=m_writeQueueCapacity)
+	{
+		m_sendLock->Unlock();
+		elem->ReleaseObj();
+		return UDS_IPC_SEND_STATUS_QUEUE_FULL;
+	}
+	queue(elem,static_cast<unsigned int>(sentByteSize));
+	m_sendLock->Unlock();
+	return UDS_IPC_SEND_STATUS_QUEUED;
+}
+
+bool UdsIpcChannel::Flush(vector<unsigned int> &retSentByteSizes)
+{
+	LockObj lock(m_sendLock);
+	if(m_socket==-1)
+		return false;
+	while(!m_sendQueue.empty())
+	{
+		// the queued frames are gathered into one send
+		struct iovec vectorList[UDS_IPC_SEND_BATCH_COUNT*2];
+		unsigned int vectorCount=0;
+		size_t requestedByteSize=0;
+		size_t itemCount=m_sendQueue.size();
+		if(itemCount>UDS_IPC_SEND_BATCH_COUNT)
+			itemCount=UDS_IPC_SEND_BATCH_COUNT;
+		for(size_t itemTrav=0;itemTrav<itemCount;itemTrav++)
+		{
+			UdsIpcSendItem &item=m_sendQueue[itemTrav];
+			unsigned int skipByteSize=(itemTrav==0)?m_sendOffset:0;
+			if(skipByteSize<IPC_FRAME_HEADER_SIZE)
+			{
+				vectorList[vectorCount].iov_base=reinterpret_cast<char*>(&item.m_header)+skipByteSize;
+				vectorList[vectorCount].iov_len=IPC_FRAME_HEADER_SIZE-skipByteSize;
+				requestedByteSize+=vectorList[vectorCount].iov_len;
+				vectorCount++;
+				skipByteSize=0;
+			}
+			else
+				skipByteSize-=IPC_FRAME_HEADER_SIZE;
+			vectorList[vectorCount].iov_base=item.m_elem->m_data+skipByteSize;
+			vectorList[vectorCount].iov_len=item.m_elem->m_dataSize-skipByteSize;
+			requestedByteSize+=vectorList[vectorCount].iov_len;
+			vectorCount++;
+		}
+
+		int sentByteSize=sendDirect(vectorList,vectorCount,static_cast<unsigned int>(requestedByteSize));
+		if(sentByteSize<0)
+			return false;
+
+		unsigned int offset=m_sendOffset+static_cast<unsigned int>(sentByteSize);
+		while(!m_sendQueue.empty())
+		{
+			UdsIpcSendItem &item=m_sendQueue.front();
+			unsigned int frameByteSize=IPC_FRAME_HEADER_SIZE+item.m_elem->m_dataSize;
+			if(offset<frameByteSize)
+				break;
+			offset-=frameByteSize;
+			retSentByteSizes.push_back(item.m_elem->m_dataSize);
+			item.m_elem->ReleaseObj();
+			m_sendQueue.pop_front();
+		}
+		m_sendOffset=offset;
+		// the socket is full, so the rest is sent when it becomes writable
+		if(static_cast<size_t>(sentByteSize)<requestedByteSize)
+			break;
+	}
+	return true;
+}
+
+void UdsIpcChannel::DropQueue(vector<unsigned int> &retDroppedByteSizes)
+{
+	LockObj lock(m_sendLock);
+	while(!m_sendQueue.empty())
+	{
+		retDroppedByteSizes.push_back(m_sendQueue.front().m_elem->m_dataSize);
+		m_sendQueue.front().m_elem->ReleaseObj();
+		m_sendQueue.pop_front();
+	}
+	m_sendOffset=0;
+}
+
+int UdsIpcChannel::Fill()
+{
+	char *position=NULL;
+	unsigned int byteSize=0;
+	if(m_longMessage)
+	{
+		position=m_longMessage->m_data+m_longByteSize;
+		byteSize=m_longMessage->m_dataSize-m_longByteSize;
+	}
+	else
+	{
+		// only the part of the frame not completed is left, which is moved to the front
+		if(m_recvHead)
+		{
+			memmove(m_recvBuffer,m_recvBuffer+m_recvHead,m_recvTail-m_recvHead);
+			m_recvTail-=m_recvHead;
+			m_recvHead=0;
+		}
+		position=m_recvBuffer+m_recvTail;
+		byteSize=m_recvBufferByteSize-m_recvTail;
+	}
+	EP_ASSERT(byteSize);
+
+	ssize_t recvByteSize;
+	while((recvByteSize=recv(m_socket,position,byteSize,MSG_DONTWAIT))<0 && errno==EINTR);
+	if(recvByteSize>0)
+	{
+		if(m_longMessage)
+			m_longByteSize+=static_cast<unsigned int>(recvByteSize);
+		else
+			m_recvTail+=static_cast<unsigned int>(recvByteSize);
+		return static_cast<int>(recvByteSize);
+	}
+	if(recvByteSize<0 && (errno==EAGAIN || errno==EWOULDBLOCK))
+		return 0;
+	// the peer closed the connection
+	return -1;
+}
+
+bool UdsIpcChannel::Peek(const char *&retData, unsigned int &retByteSize, ReadStatus &retStatus)
+{
+	m_peekByteSize=0;
+	if(m_longMessage)
+	{
+		if(m_longByteSize<m_longMessage->m_dataSize)
+			return false;
+		retData=m_longMessage->m_data;
+		retByteSize=m_longMessage->m_dataSize;
+		retStatus=READ_STATUS_SUCCESS;
+		return true;
+	}
+
+	unsigned int availableByteSize=m_recvTail-m_recvHead;
+	if(m_skipByteSize)
+	{
+		unsigned int skipByteSize=(m_skipByteSize<availableByteSize)?m_skipByteSize:availableByteSize;
+		m_recvHead+=skipByteSize;
+		m_skipByteSize-=skipByteSize;
+		availableByteSize-=skipByteSize;
+		if(m_skipByteSize)
+			return false;
+	}
+	if(availableByteSize<IPC_FRAME_HEADER_SIZE)
+		return false;
+
+	unsigned int frameByteSize=0;
+	System::Memcpy(&frameByteSize,m_recvBuffer+m_recvHead,IPC_FRAME_HEADER_SIZE);
+	if(frameByteSize>m_maxMessageByteSize)
+	{
+		// the message is reported once and discarded as it is received
+		m_recvHead+=IPC_FRAME_HEADER_SIZE;
+		m_skipByteSize=frameByteSize;
+		retData=NULL;
+		retByteSize=frameByteSize;
+		retStatus=READ_STATUS_FAIL_READ_FAILED;
+		return true;
+	}
+	if(IPC_FRAME_HEADER_SIZE+frameByteSize<=availableByteSize)
+	{
+		retData=m_recvBuffer+m_recvHead+IPC_FRAME_HEADER_SIZE;
+		retByteSize=frameByteSize;
+		retStatus=READ_STATUS_SUCCESS;
+		m_peekByteSize=IPC_FRAME_HEADER_SIZE+frameByteSize;
+		return true;
+	}
+	if(IPC_FRAME_HEADER_SIZE+frameByteSize>m_recvBufferByteSize)
+	{
+		// the rest of the long message is received directly into the buffer from the pool set
+		m_longMessage=m_bufferPoolSet->Acquire(frameByteSize);
+		m_longByteSize=availableByteSize-IPC_FRAME_HEADER_SIZE;
+		System::Memcpy(m_longMessage->m_data,m_recvBuffer+m_recvHead+IPC_FRAME_HEADER_SIZE,m_longByteSize);
+		m_recvHead=0;
+		m_recvTail=0;
+	}
+	return false;
+}
+
+void UdsIpcChannel::Pop()
+{
+	if(m_longMessage)
+	{
+		if(m_longByteSize==m_longMessage->m_dataSize)
+		{
+			m_longMessage->ReleaseObj();
+			m_longMessage=NULL;
+			m_longByteSize=0;
+		}
+		return;
+	}
+	m_recvHead+=m_peekByteSize;
+	m_peekByteSize=0;
+	if(m_recvHead==m_recvTail)
+	{
+		m_recvHead=0;
+		m_recvTail=0;
+	}
+}
+
+void UdsIpcChannel::Shutdown()
+{
+	InterlockedExchange(&m_isClosed,1);
+	if(m_socket!=-1)
+		shutdown(m_socket,SHUT_RDWR);
+}
+
+bool UdsIpcChannel::IsClosed() const
+{
+	return m_isClosed!=0;
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
@@ -0,0 +1,205 @@
+/*! 
+UdsIpcPipe for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdsIpcPipe.h"
+
+#if defined(EP_PLATFORM_LINUX)
+#include <sys/epoll.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+UdsIpcPipe::UdsIpcPipe(int socket, const IpcServerOps &options, IpcBufferPoolSet *bufferPoolSet, epl::LockPolicy lockPolicyType):SmartObject(lockPolicyType),m_channel(lockPolicyType)
+{
+	m_options=options;
+	m_bufferPoolSet=bufferPoolSet;
+	m_bufferPoolSet->RetainObj();
+	m_isFinished=0;
+	m_channel.Attach(socket,m_options.numOfReadBytes,m_options.maxMessageByteSize,m_options.writeQueueCapacity,m_bufferPoolSet);
+}
+
+UdsIpcPipe::~UdsIpcPipe()
+{
+	// closing the socket also removes it from the event loop
+	m_channel.Close();
+	m_bufferPoolSet->ReleaseObj();
+}
+
+bool UdsIpcPipe::accept(int epoll)
+{
+	m_options.callBackObj->OnNewConnection(this);
+	struct epoll_event event;
+	System::Memset(&event,0,sizeof(event));
+	// edge triggered, so the socket is only reported again when more arrives or the room is made
+	event.events=EPOLLIN|EPOLLOUT|EPOLLRDHUP|EPOLLET;
+	event.data.ptr=this;
+	if(epoll_ctl(epoll,EPOLL_CTL_ADD,m_channel.GetSocket(),&event)!=0)
+	{
+		finish();
+		return false;
+	}
+	return true;
+}
+
+bool UdsIpcPipe::isFinished() const
+{
+	return m_isFinished!=0;
+}
+
+void UdsIpcPipe::onEvent(unsigned int events)
+{
+	if(isFinished())
+		return;
+	if(events&EPOLLOUT)
+	{
+		m_reportByteSizes.clear();
+		bool isAlive=m_channel.Flush(m_reportByteSizes);
+		for(size_t reportTrav=0;reportTrav<m_reportByteSizes.size();reportTrav++)
+			m_options.callBackObj->OnWriteComplete(this,m_reportByteSizes[reportTrav],WRITE_STATUS_SUCCESS,0);
+		if(!isAlive)
+		{
+			finish();
+			return;
+		}
+	}
+	if(!(events&(EPOLLIN|EPOLLRDHUP|EPOLLHUP|EPOLLERR)))
+		return;
+
+	// the socket is read until empty, since it is reported again only when more arrives
+	while(true)
+	{
+		const char *data=NULL;
+		unsigned int byteSize=0;
+		ReadStatus status=READ_STATUS_SUCCESS;
+		while(m_channel.Peek(data,byteSize,status))
+		{
+			// the data is read in place, so the space is given back after the callback
+			m_options.callBackObj->OnReadComplete(this,data,byteSize,status,0);
+			m_channel.Pop();
+		}
+		int recvByteSize=m_channel.Fill();
+		if(recvByteSize==0)
+			break;
+		if(recvByteSize<0)
+		{
+			finish();
+			break;
+		}
+	}
+}
+
+void UdsIpcPipe::finish()
+{
+	m_channel.Shutdown();
+	m_reportByteSizes.clear();
+	m_channel.DropQueue(m_reportByteSizes);
+	for(size_t reportTrav=0;reportTrav<m_reportByteSizes.size();reportTrav++)
+		m_options.callBackObj->OnWriteComplete(this,m_reportByteSizes[reportTrav],WRITE_STATUS_FAIL_WRITE_FAILED,0);
+	m_options.callBackObj->OnDisconnect(this);
+	InterlockedExchange(&m_isFinished,1);
+}
+
+void UdsIpcPipe::reportSend(UdsIpcSendStatus status, unsigned int dataByteSize)
+{
+	switch(status)
+	{
+	case UDS_IPC_SEND_STATUS_COMPLETED:
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_SUCCESS,0);
+		break;
+	case UDS_IPC_SEND_STATUS_QUEUED:
+		// reported by the event loop once sent
+		break;
+	case UDS_IPC_SEND_STATUS_QUEUE_FULL:
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_QUEUE_FULL,0);
+		break;
+	default:
+		m_options.callBackObj->OnWriteComplete(this,dataByteSize,WRITE_STATUS_FAIL_WRITE_FAILED,0);
+		break;
+	}
+}
+
+void UdsIpcPipe::Write(char *data,unsigned int dataByteSize)
+{
+	IpcWriteSegment segment;
+	segment.m_data=data;
+	segment.m_dataSize=dataByteSize;
+	Write(&segment,1);
+}
+
+void UdsIpcPipe::Write(const IpcWriteSegment *segmentList,unsigned int segmentCount)
+{
+	unsigned int dataByteSize=0;
+	for(unsigned int segmentTrav=0;segmentTrav<segmentCount;segmentTrav++)
+		dataByteSize+=segmentList[segmentTrav].m_dataSize;
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+	reportSend(m_channel.Send(segmentList,segmentCount,dataByteSize),dataByteSize);
+}
+
+PipeWriteElem *UdsIpcPipe::AcquireWriteBuffer(unsigned int dataByteSize)
+{
+	EP_ASSERT(dataByteSize<=GetMaxWriteDataByteSize());
+	return m_bufferPoolSet->Acquire(dataByteSize);
+}
+
+void UdsIpcPipe::WriteOwned(PipeWriteElem *elem)
+{
+	EP_ASSERT(elem);
+	// the element may be released once sent
+	unsigned int dataByteSize=elem->m_dataSize;
+	reportSend(m_channel.SendOwned(elem),dataByteSize);
+}
+
+unsigned int UdsIpcPipe::GetMaxWriteDataByteSize() const
+{
+	return m_options.maxMessageByteSize;
+}
+
+bool UdsIpcPipe::IsConnectionAlive() const
+{
+	return !m_channel.IsClosed();
+}
+
+void UdsIpcPipe::KillConnection()
+{
+	m_channel.Shutdown();
+}
+
+void UdsIpcPipe::SetCallbackObject(IpcServerCallbackInterface *callBackObj)
+{
+	EP_ASSERT(callBackObj);
+	m_options.callBackObj=callBackObj;
+}
+
+IpcServerCallbackInterface *UdsIpcPipe::GetCallbackObject()
+{
+	return m_options.callBackObj;
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
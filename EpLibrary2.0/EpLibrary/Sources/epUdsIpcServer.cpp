@@ -0,0 +1,311 @@
+/*! 
+UdsIpcServer for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUdsIpcServer.h"
+
+#if defined(EP_PLATFORM_LINUX)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+UdsIpcServer::UdsIpcServer(epl::LockPolicy lockPolicyType):Thread(EP_THREAD_PRIORITY_NORMAL,lockPolicyType)
+{
+	m_lockPolicy=lockPolicyType;
+	switch(m_lockPolicy)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_pipesLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_pipesLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_pipesLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_pipesLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_pipesLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_pipesLock=NULL;
+		break;
+	}
+	m_started=false;
+	m_isStopping=false;
+	m_listenSocket=-1;
+	m_epoll=-1;
+	m_wakeEvent=-1;
+	m_bufferPoolSet=NULL;
+}
+
+UdsIpcServer::~UdsIpcServer()
+{
+	StopServer();
+	if(m_pipesLock)
+		EP_DELETE m_pipesLock;
+	if(m_bufferPoolSet)
+		m_bufferPoolSet->ReleaseObj();
+}
+
+epl::EpTString UdsIpcServer::GetFullPipeName() const
+{
+	return m_pipeName;
+}
+unsigned int UdsIpcServer::GetMaximumInstances() const
+{
+	return m_options.maximumInstances;
+}
+void UdsIpcServer::SetCallbackObject(IpcServerCallbackInterface *callBackObj)
+{
+	m_options.callBackObj=callBackObj;
+}
+IpcServerCallbackInterface *UdsIpcServer::GetCallbackObject()
+{
+	return m_options.callBackObj;
+}
+
+bool UdsIpcServer::StartServer(const IpcServerOps &ops)
+{
+	EP_ASSERT(ops.callBackObj);
+	if(m_started)
+		return true;
+	if(ops.pipeName)
+	{
+		m_pipeName=UDS_IPC_NAME_PREFIX;
+		m_pipeName.append(ops.pipeName);
+	}
+
+	m_options=ops;
+	if(ops.numOfWriteBytes==0)
+		m_options.numOfWriteBytes=DEFAULT_WRITE_BUF_SIZE;
+	if(ops.numOfReadBytes==0)
+		m_options.numOfReadBytes=DEFAULT_READ_BUF_SIZE;
+	if(ops.maxMessageByteSize==0)
+		m_options.maxMessageByteSize=IPC_MESSAGE_BYTE_SIZE_UNLIMITED;
+
+	sockaddr_un address;
+	socklen_t addressByteSize=0;
+	if(!UdsIpcChannel::MakeAddress(m_pipeName.c_str(),address,addressByteSize))
+	{
+		EP_ASSERT_EXPR(0,_T("The pipe name is too long.\n"));
+		return false;
+	}
+	m_listenSocket=socket(AF_UNIX,SOCK_STREAM|SOCK_NONBLOCK|SOCK_CLOEXEC,0);
+	if(m_listenSocket==-1)
+	{
+		EP_ASSERT_EXPR(0,_T("Create socket failed with %d.\n"),errno);
+		return false;
+	}
+	// the bind fails with EADDRINUSE when another server is already listening with the same name
+	if(bind(m_listenSocket,reinterpret_cast<sockaddr*>(&address),addressByteSize)!=0 || listen(m_listenSocket,UDS_IPC_LISTEN_BACKLOG)!=0)
+	{
+		stopServer();
+		return false;
+	}
+
+	m_epoll=epoll_create1(EPOLL_CLOEXEC);
+	m_wakeEvent=eventfd(0,EFD_NONBLOCK|EFD_CLOEXEC);
+	struct epoll_event event;
+	System::Memset(&event,0,sizeof(event));
+	event.events=EPOLLIN;
+	bool isRegistered=false;
+	if(m_epoll!=-1 && m_wakeEvent!=-1)
+	{
+		// the listening socket and the wake event are told apart from the pipes by the address of their members
+		event.data.ptr=&m_listenSocket;
+		isRegistered=epoll_ctl(m_epoll,EPOLL_CTL_ADD,m_listenSocket,&event)==0;
+		event.data.ptr=&m_wakeEvent;
+		isRegistered=isRegistered && epoll_ctl(m_epoll,EPOLL_CTL_ADD,m_wakeEvent,&event)==0;
+	}
+	if(!isRegistered)
+	{
+		EP_ASSERT_EXPR(0,_T("Create event loop failed with %d.\n"),errno);
+		stopServer();
+		return false;
+	}
+
+	if(!m_bufferPoolSet || m_bufferPoolSet->GetMinBufferByteSize()!=m_options.numOfWriteBytes)
+	{
+		// the instances still alive keep the old pool set until destroyed
+		if(m_bufferPoolSet)
+			m_bufferPoolSet->ReleaseObj();
+		m_bufferPoolSet=EP_NEW IpcBufferPoolSet(m_options.numOfWriteBytes,IPC_BUFFER_POOL_SET_MAX_FREE_COUNT,m_lockPolicy);
+	}
+
+	m_isStopping=false;
+	if(!Start())
+	{
+		stopServer();
+		return false;
+	}
+	m_started=true;
+	return true;
+}
+
+void UdsIpcServer::StopServer()
+{
+	if(!m_started)
+		return;
+	m_isStopping=true;
+	uint64_t wakeCount=1;
+	write(m_wakeEvent,&wakeCount,sizeof(wakeCount));
+	WaitFor(m_options.waitTimeInMilliSec);
+	removeInstances(true);
+	stopServer();
+	m_started=false;
+}
+
+void UdsIpcServer::stopServer()
+{
+	if(m_listenSocket!=-1)
+		close(m_listenSocket);
+	m_listenSocket=-1;
+	if(m_wakeEvent!=-1)
+		close(m_wakeEvent);
+	m_wakeEvent=-1;
+	if(m_epoll!=-1)
+		close(m_epoll);
+	m_epoll=-1;
+}
+
+bool UdsIpcServer::IsServerStarted() const
+{
+	return m_started;
+}
+
+void UdsIpcServer::ShutdownAllClient()
+{
+	LockObj lock(m_pipesLock);
+	// the closed instances are removed when the event loop finds them hung up
+	for(int trav=0;trav<m_pipes.size();trav++)
+		m_pipes.at(trav)->KillConnection();
+}
+
+unsigned int UdsIpcServer::GetMaxWriteDataByteSize() const
+{
+	return m_options.maxMessageByteSize;
+}
+
+unsigned int UdsIpcServer::GetMaxReadDataByteSize() const
+{
+	return m_options.maxMessageByteSize;
+}
+
+void UdsIpcServer::execute()
+{
+	struct epoll_event events[UDS_IPC_EPOLL_EVENT_COUNT];
+	while(!m_isStopping)
+	{
+		int eventCount=epoll_wait(m_epoll,events,UDS_IPC_EPOLL_EVENT_COUNT,-1);
+		if(eventCount<0)
+		{
+			if(errno==EINTR)
+				continue;
+			break;
+		}
+		for(int eventTrav=0;eventTrav<eventCount;eventTrav++)
+		{
+			void *key=events[eventTrav].data.ptr;
+			if(key==&m_listenSocket)
+				acceptConnections();
+			else if(key==&m_wakeEvent)
+			{
+				uint64_t wakeCount=0;
+				read(m_wakeEvent,&wakeCount,sizeof(wakeCount));
+			}
+			else
+				reinterpret_cast<UdsIpcPipe*>(key)->onEvent(events[eventTrav].events);
+		}
+		// the finished instances are only removed after all events taken are handled
+		removeInstances(false);
+	}
+}
+
+void UdsIpcServer::acceptConnections()
+{
+	while(!m_isStopping)
+	{
+		int socket=accept4(m_listenSocket,NULL,NULL,SOCK_NONBLOCK|SOCK_CLOEXEC);
+		if(socket==-1)
+		{
+			if(errno==EINTR || errno==ECONNABORTED)
+				continue;
+			break;
+		}
+		m_pipesLock->Lock();
+		bool isAccept=m_pipes.size()<m_options.maximumInstances;
+		m_pipesLock->Unlock();
+		// the event loop is the only one adding the instances, so the count does not grow until pushed
+		if(!isAccept)
+		{
+			close(socket);
+			continue;
+		}
+		UdsIpcPipe *pipeInst=EP_NEW UdsIpcPipe(socket,m_options,m_bufferPoolSet,m_lockPolicy);
+		if(!pipeInst->accept(m_epoll))
+		{
+			pipeInst->ReleaseObj();
+			continue;
+		}
+		LockObj lock(m_pipesLock);
+		m_pipes.push_back(pipeInst);
+	}
+}
+
+void UdsIpcServer::removeInstances(bool isAll)
+{
+	vector<UdsIpcPipe*> removedPipes;
+	m_pipesLock->Lock();
+	for(int trav=static_cast<int>(m_pipes.size())-1;trav>=0;trav--)
+	{
+		if(isAll || m_pipes.at(trav)->isFinished())
+		{
+			removedPipes.push_back(m_pipes.at(trav));
+			m_pipes.erase(m_pipes.begin()+trav);
+		}
+	}
+	m_pipesLock->Unlock();
+
+	// finished out of the lock, since the callbacks may call back into the server
+	for(int trav=0;trav<removedPipes.size();trav++)
+	{
+		if(!removedPipes.at(trav)->isFinished())
+			removedPipes.at(trav)->finish();
+		removedPipes.at(trav)->ReleaseObj();
+	}
+}
+
+#endif //defined(EP_PLATFORM_LINUX)
@@ -0,0 +1,586 @@
+/*! 
+UnicodeHelper for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epUnicodeHelper.h"
+#include "epAssert.h"
+
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_UNICODE_SSE2
+#if _MSC_VER>=MSVC110
+#include <immintrin.h>
+#define EP_UNICODE_AVX2
+#endif //_MSC_VER>=MSVC110
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the maximum number of the bytes or the characters processed one by one before trying the SIMD again
+#define UNICODE_SCALAR_RUN_SIZE 32
+
+/// the replacement character for the invalid sequences
+#define UNICODE_REPLACEMENT_CHARACTER 0xFFFD
+
+#if defined(EP_UNICODE_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
+{
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
+}
+
+/*!
+Return the length of the leading ASCII bytes in the whole 16 byte blocks.
+@param[in] src the bytes to check.
+@param[in] byteSize the byte size of the bytes.
+@return the length of the leading ASCII bytes, which is a multiple of 16.
+*/
+static size_t asciiLengthSSE2(const unsigned char *src, size_t byteSize)
+{
+	size_t byteTrav=0;
+	while(byteTrav+16<=byteSize)
+	{
+		__m128i bytes=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+byteTrav));
+		if(_mm_movemask_epi8(bytes))
+			break;
+		byteTrav+=16;
+	}
+	return byteTrav;
+}
+
+/*!
+Return the length of the leading ASCII characters in the whole 16 character blocks.
+@param[in] src the characters to check.
+@param[in] charCount the number of the characters.
+@return the length of the leading ASCII characters, which is a multiple of 16.
+*/
+static size_t asciiLengthSSE2(const wchar_t *src, size_t charCount)
+{
+	const __m128i nonAsciiMask=_mm_set1_epi16(static_cast<short>(0xFF80));
+	const __m128i zero=_mm_setzero_si128();
+	size_t charTrav=0;
+	while(charTrav+16<=charCount)
+	{
+		__m128i low=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+charTrav));
+		__m128i high=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+charTrav+8));
+		__m128i nonAscii=_mm_and_si128(_mm_or_si128(low,high),nonAsciiMask);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii,zero))!=0xFFFF)
+			break;
+		charTrav+=16;
+	}
+	return charTrav;
+}
+
+/*!
+Return the length of the leading characters without the surrogate in the whole 8 character blocks.
+@param[in] src the characters to check.
+@param[in] charCount the number of the characters.
+@return the length of the leading characters without the surrogate, which is a multiple of 8.
+*/
+static size_t nonSurrogateLengthSSE2(const wchar_t *src, size_t charCount)
+{
+	const __m128i surrogateMask=_mm_set1_epi16(static_cast<short>(0xF800));
+	const __m128i surrogate=_mm_set1_epi16(static_cast<short>(0xD800));
+	size_t charTrav=0;
+	while(charTrav+8<=charCount)
+	{
+		__m128i chars=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+charTrav));
+		if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(chars,surrogateMask),surrogate)))
+			break;
+		charTrav+=8;
+	}
+	return charTrav;
+}
+
+/*!
+Widen the leading ASCII bytes in the whole 16 byte blocks to the UTF-16.
+@param[in] src the bytes to widen.
+@param[in] byteSize the byte size of the bytes.
+@param[out] retDest the buffer to write the UTF-16 characters.
+@return the number of the bytes widened, which is a multiple of 16.
+*/
+static size_t widenAsciiSSE2(const unsigned char *src, size_t byteSize, wchar_t *retDest)
+{
+	const __m128i zero=_mm_setzero_si128();
+	size_t byteTrav=0;
+	while(byteTrav+16<=byteSize)
+	{
+		__m128i bytes=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+byteTrav));
+		if(_mm_movemask_epi8(bytes))
+			break;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(retDest+byteTrav),_mm_unpacklo_epi8(bytes,zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(retDest+byteTrav+8),_mm_unpackhi_epi8(bytes,zero));
+		byteTrav+=16;
+	}
+	return byteTrav;
+}
+
+/*!
+Narrow the leading ASCII characters in the whole 16 character blocks to the UTF-8.
+@param[in] src the characters to narrow.
+@param[in] charCount the number of the characters.
+@param[out] retDest the buffer to write the UTF-8 bytes.
+@return the number of the characters narrowed, which is a multiple of 16.
+*/
+static size_t narrowAsciiSSE2(const wchar_t *src, size_t charCount, unsigned char *retDest)
+{
+	const __m128i nonAsciiMask=_mm_set1_epi16(static_cast<short>(0xFF80));
+	const __m128i zero=_mm_setzero_si128();
+	size_t charTrav=0;
+	while(charTrav+16<=charCount)
+	{
+		__m128i low=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+charTrav));
+		__m128i high=_mm_loadu_si128(reinterpret_cast<const __m128i*>(src+charTrav+8));
+		__m128i nonAscii=_mm_and_si128(_mm_or_si128(low,high),nonAsciiMask);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii,zero))!=0xFFFF)
+			break;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(retDest+charTrav),_mm_packus_epi16(low,high));
+		charTrav+=16;
+	}
+	return charTrav;
+}
+#endif //defined(EP_UNICODE_SSE2)
+
+#if defined(EP_UNICODE_AVX2)
+/*!
+Return the flag whether the processor and the OS support AVX2.
+@return true if supported, otherwise false.
+*/
+static bool hasAVX2()
+{
+	static volatile int s_hasAVX2=-1;
+	if(s_hasAVX2<0)
+	{
+		int cpuInfo[4];
+		int hasAVX2=0;
+		__cpuid(cpuInfo,0);
+		if(cpuInfo[0]>=7)
+		{
+			__cpuid(cpuInfo,1);
+			// the OS must save the YMM registers with the XSAVE.
+			if((cpuInfo[2]&(1<<27)) && (cpuInfo[2]&(1<<28)) && (_xgetbv(0)&6)==6)
+			{
+				__cpuidex(cpuInfo,7,0);
+				hasAVX2=(cpuInfo[1]&(1<<5))?1:0;
+			}
+		}
+		s_hasAVX2=hasAVX2;
+	}
+	return s_hasAVX2==1;
+}
+
+/*!
+Widen the leading ASCII bytes in the whole 32 byte blocks to the UTF-16.
+@param[in] src the bytes to widen.
+@param[in] byteSize the byte size of the bytes.
+@param[out] retDest the buffer to write the UTF-16 characters.
+@return the number of the bytes widened, which is a multiple of 32.
+*/
+static size_t widenAsciiAVX2(const unsigned char *src, size_t byteSize, wchar_t *retDest)
+{
+	size_t byteTrav=0;
+	while(byteTrav+32<=byteSize)
+	{
+		__m256i bytes=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+byteTrav));
+		if(_mm256_movemask_epi8(bytes))
+			break;
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(retDest+byteTrav),_mm256_cvtepu8_epi16(_mm256_castsi256_si128(bytes)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(retDest+byteTrav+16),_mm256_cvtepu8_epi16(_mm256_extracti128_si256(bytes,1)));
+		byteTrav+=32;
+	}
+	// avoid the penalty of the SSE instructions following
+	_mm256_zeroupper();
+	return byteTrav;
+}
+
+/*!
+Narrow the leading ASCII characters in the whole 32 character blocks to the UTF-8.
+@param[in] src the characters to narrow.
+@param[in] charCount the number of the characters.
+@param[out] retDest the buffer to write the UTF-8 bytes.
+@return the number of the characters narrowed, which is a multiple of 32.
+*/
+static size_t narrowAsciiAVX2(const wchar_t *src, size_t charCount, unsigned char *retDest)
+{
+	const __m256i nonAsciiMask=_mm256_set1_epi16(static_cast<short>(0xFF80));
+	size_t charTrav=0;
+	while(charTrav+32<=charCount)
+	{
+		__m256i low=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+charTrav));
+		__m256i high=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src+charTrav+16));
+		if(!_mm256_testz_si256(_mm256_or_si256(low,high),nonAsciiMask))
+			break;
+		// the packing interleaves the 128 bit lanes of the two, so put the 64 bit quarters back in order.
+		__m256i bytes=_mm256_permute4x64_epi64(_mm256_packus_epi16(low,high),0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(retDest+charTrav),bytes);
+		charTrav+=32;
+	}
+	_mm256_zeroupper();
+	return charTrav;
+}
+#endif //defined(EP_UNICODE_AVX2)
+
+/*!
+Return the length of the leading ASCII bytes.
+@param[in] src the bytes to check.
+@param[in] byteSize the byte size of the bytes.
+@return the length of the leading ASCII bytes.
+*/
+static size_t asciiLength(const unsigned char *src, size_t byteSize)
+{
+	size_t byteTrav=0;
+#if defined(EP_UNICODE_SSE2)
+	if(hasSSE2())
+		byteTrav=asciiLengthSSE2(src,byteSize);
+#endif //defined(EP_UNICODE_SSE2)
+	while(byteTrav<byteSize && src[byteTrav]<0x80)
+		byteTrav++;
+	return byteTrav;
+}
+
+/*!
+Return the length of the leading ASCII characters.
+@param[in] src the characters to check.
+@param[in] charCount the number of the characters.
+@return the length of the leading ASCII characters.
+*/
+static size_t asciiLength(const wchar_t *src, size_t charCount)
+{
+	size_t charTrav=0;
+#if defined(EP_UNICODE_SSE2)
+	if(hasSSE2())
+		charTrav=asciiLengthSSE2(src,charCount);
+#endif //defined(EP_UNICODE_SSE2)
+	while(charTrav<charCount && static_cast<unsigned short>(src[charTrav])<0x80)
+		charTrav++;
+	return charTrav;
+}
+
+/*!
+Widen the leading ASCII bytes to the UTF-16.
+@param[in] src the bytes to widen.
+@param[in] byteSize the byte size of the bytes.
+@param[out] retDest the buffer to write the UTF-16 characters.
+@return the number of the bytes widened.
+*/
+static size_t widenAscii(const unsigned char *src, size_t byteSize, wchar_t *retDest)
+{
+	size_t byteTrav=0;
+#if defined(EP_UNICODE_AVX2)
+	if(hasAVX2())
+		byteTrav=widenAsciiAVX2(src,byteSize,retDest);
+#endif //defined(EP_UNICODE_AVX2)
+#if defined(EP_UNICODE_SSE2)
+	if(hasSSE2())
+		byteTrav+=widenAsciiSSE2(src+byteTrav,byteSize-byteTrav,retDest+byteTrav);
+#endif //defined(EP_UNICODE_SSE2)
+	while(byteTrav<byteSize && src[byteTrav]<0x80)
+	{
+		retDest[byteTrav]=static_cast<wchar_t>(src[byteTrav]);
+		byteTrav++;
+	}
+	return byteTrav;
+}
+
+/*!
+Narrow the leading ASCII characters to the UTF-8.
+@param[in] src the characters to narrow.
+@param[in] charCount the number of the characters.
+@param[out] retDest the buffer to write the UTF-8 bytes.
+@return the number of the characters narrowed.
+*/
+static size_t narrowAscii(const wchar_t *src, size_t charCount, unsigned char *retDest)
+{
+	size_t charTrav=0;
+#if defined(EP_UNICODE_AVX2)
+	if(hasAVX2())
+		charTrav=narrowAsciiAVX2(src,charCount,retDest);
+#endif //defined(EP_UNICODE_AVX2)
+#if defined(EP_UNICODE_SSE2)
+	if(hasSSE2())
+		charTrav+=narrowAsciiSSE2(src+charTrav,charCount-charTrav,retDest+charTrav);
+#endif //defined(EP_UNICODE_SSE2)
+	while(charTrav<charCount && static_cast<unsigned short>(src[charTrav])<0x80)
+	{
+		retDest[charTrav]=static_cast<unsigned char>(src[charTrav]);
+		charTrav++;
+	}
+	return charTrav;
+}
+
+/*!
+Decode the UTF-8 sequence at the given bytes.
+@param[in] src the bytes to decode.
+@param[in] byteSize the byte size of the bytes left, which is greater than 0.
+@param[out] retCodePoint the code point decoded.
+@return the byte size of the sequence, or 0 if the sequence is invalid.
+@remark the ranges of the second byte follow the well-formed byte sequences of the Unicode Standard.
+*/
+static size_t decodeUtf8(const unsigned char *src, size_t byteSize, unsigned int &retCodePoint)
+{
+	unsigned char lead=src[0];
+	if(lead<0x80)
+	{
+		retCodePoint=lead;
+		return 1;
+	}
+	if(lead<0xC2)
+		return 0;
+	if(lead<0xE0)
+	{
+		if(byteSize<2 || (src[1]&0xC0)!=0x80)
+			return 0;
+		retCodePoint=((lead&0x1F)<<6)|(src[1]&0x3F);
+		return 2;
+	}
+	if(lead<0xF0)
+	{
+		unsigned char lower=(lead==0xE0)?0xA0:0x80;
+		unsigned char upper=(lead==0xED)?0x9F:0xBF;
+		if(byteSize<3 || src[1]<lower || src[1]>upper || (src[2]&0xC0)!=0x80)
+			return 0;
+		retCodePoint=((lead&0x0F)<<12)|((src[1]&0x3F)<<6)|(src[2]&0x3F);
+		return 3;
+	}
+	if(lead<0xF5)
+	{
+		unsigned char lower=(lead==0xF0)?0x90:0x80;
+		unsigned char upper=(lead==0xF4)?0x8F:0xBF;
+		if(byteSize<4 || src[1]<lower || src[1]>upper || (src[2]&0xC0)!=0x80 || (src[3]&0xC0)!=0x80)
+			return 0;
+		retCodePoint=((lead&0x07)<<18)|((src[1]&0x3F)<<12)|((src[2]&0x3F)<<6)|(src[3]&0x3F);
+		return 4;
+	}
+	return 0;
+}
+
+bool UnicodeHelper::IsAscii(const char *src, size_t byteSize)
+{
+	EP_ASSERT(src || !byteSize);
+	return asciiLength(reinterpret_cast<const unsigned char*>(src),byteSize)==byteSize;
+}
+
+bool UnicodeHelper::IsAscii(const wchar_t *src, size_t charCount)
+{
+	EP_ASSERT(src || !charCount);
+	return asciiLength(src,charCount)==charCount;
+}
+
+bool UnicodeHelper::ValidateUtf8(const char *src, size_t byteSize)
+{
+	EP_ASSERT(src || !byteSize);
+	const unsigned char *bytes=reinterpret_cast<const unsigned char*>(src);
+	size_t byteTrav=0;
+	while(byteTrav<byteSize)
+	{
+		byteTrav+=asciiLength(bytes+byteTrav,byteSize-byteTrav);
+		size_t runEnd=byteTrav+UNICODE_SCALAR_RUN_SIZE;
+		if(runEnd>byteSize)
+			runEnd=byteSize;
+		while(byteTrav<runEnd)
+		{
+			unsigned int codePoint;
+			size_t sequenceSize=decodeUtf8(bytes+byteTrav,byteSize-byteTrav,codePoint);
+			if(!sequenceSize)
+				return false;
+			byteTrav+=sequenceSize;
+		}
+	}
+	return true;
+}
+
+bool UnicodeHelper::ValidateUtf16(const wchar_t *src, size_t charCount)
+{
+	EP_ASSERT(src || !charCount);
+	size_t charTrav=0;
+	while(charTrav<charCount)
+	{
+#if defined(EP_UNICODE_SSE2)
+		if(hasSSE2())
+		{
+			charTrav+=nonSurrogateLengthSSE2(src+charTrav,charCount-charTrav);
+			if(charTrav>=charCount)
+				break;
+		}
+#endif //defined(EP_UNICODE_SSE2)
+		size_t runEnd=charTrav+UNICODE_SCALAR_RUN_SIZE;
+		if(runEnd>charCount)
+			runEnd=charCount;
+		while(charTrav<runEnd)
+		{
+			unsigned short unit=static_cast<unsigned short>(src[charTrav]);
+			if(unit>=0xD800 && unit<=0xDFFF)
+			{
+				if(unit>=0xDC00 || charTrav+1>=charCount)
+					return false;
+				unsigned short next=static_cast<unsigned short>(src[charTrav+1]);
+				if(next<0xDC00 || next>0xDFFF)
+					return false;
+				charTrav++;
+			}
+			charTrav++;
+		}
+	}
+	return true;
+}
+
+size_t UnicodeHelper::Utf8ToUtf16(const char *src, size_t byteSize, wchar_t *retDest)
+{
+	EP_ASSERT((src && retDest) || !byteSize);
+	const unsigned char *bytes=reinterpret_cast<const unsigned char*>(src);
+	wchar_t *destTrav=retDest;
+	size_t byteTrav=0;
+	while(byteTrav<byteSize)
+	{
+		size_t asciiSize=widenAscii(bytes+byteTrav,byteSize-byteTrav,destTrav);
+		byteTrav+=asciiSize;
+		destTrav+=asciiSize;
+
+		size_t runEnd=byteTrav+UNICODE_SCALAR_RUN_SIZE;
+		if(runEnd>byteSize)
+			runEnd=byteSize;
+		while(byteTrav<runEnd)
+		{
+			unsigned int codePoint;
+			size_t sequenceSize=decodeUtf8(bytes+byteTrav,byteSize-byteTrav,codePoint);
+			if(!sequenceSize)
+			{
+				*destTrav++=static_cast<wchar_t>(UNICODE_REPLACEMENT_CHARACTER);
+				byteTrav++;
+				continue;
+			}
+			if(codePoint>=0x10000)
+			{
+				codePoint-=0x10000;
+				*destTrav++=static_cast<wchar_t>(0xD800|(codePoint>>10));
+				*destTrav++=static_cast<wchar_t>(0xDC00|(codePoint&0x3FF));
+			}
+			else
+				*destTrav++=static_cast<wchar_t>(codePoint);
+			byteTrav+=sequenceSize;
+		}
+	}
+	return destTrav-retDest;
+}
+
+size_t UnicodeHelper::Utf16ToUtf8(const wchar_t *src, size_t charCount, char *retDest)
+{
+	EP_ASSERT((src && retDest) || !charCount);
+	unsigned char *destTrav=reinterpret_cast<unsigned char*>(retDest);
+	size_t charTrav=0;
+	while(charTrav<charCount)
+	{
+		size_t asciiCount=narrowAscii(src+charTrav,charCount-charTrav,destTrav);
+		charTrav+=asciiCount;
+		destTrav+=asciiCount;
+
+		size_t runEnd=charTrav+UNICODE_SCALAR_RUN_SIZE;
+		if(runEnd>charCount)
+			runEnd=charCount;
+		while(charTrav<runEnd)
+		{
+			unsigned int codePoint=static_cast<unsigned short>(src[charTrav++]);
+			if(codePoint<0x80)
+			{
+				*destTrav++=static_cast<unsigned char>(codePoint);
+				continue;
+			}
+			if(codePoint<0x800)
+			{
+				*destTrav++=static_cast<unsigned char>(0xC0|(codePoint>>6));
+				*destTrav++=static_cast<unsigned char>(0x80|(codePoint&0x3F));
+				continue;
+			}
+			if(codePoint>=0xD800 && codePoint<=0xDFFF)
+			{
+				unsigned int next=(charTrav<charCount)?static_cast<unsigned short>(src[charTrav]):0;
+				if(codePoint<0xDC00 && next>=0xDC00 && next<=0xDFFF)
+				{
+					codePoint=0x10000+((codePoint-0xD800)<<10)+(next-0xDC00);
+					charTrav++;
+					*destTrav++=static_cast<unsigned char>(0xF0|(codePoint>>18));
+					*destTrav++=static_cast<unsigned char>(0x80|((codePoint>>12)&0x3F));
+					*destTrav++=static_cast<unsigned char>(0x80|((codePoint>>6)&0x3F));
+					*destTrav++=static_cast<unsigned char>(0x80|(codePoint&0x3F));
+					continue;
+				}
+				codePoint=UNICODE_REPLACEMENT_CHARACTER;
+			}
+			*destTrav++=static_cast<unsigned char>(0xE0|(codePoint>>12));
+			*destTrav++=static_cast<unsigned char>(0x80|((codePoint>>6)&0x3F));
+			*destTrav++=static_cast<unsigned char>(0x80|(codePoint&0x3F));
+		}
+	}
+	return reinterpret_cast<char*>(destTrav)-retDest;
+}
+
+EpWString UnicodeHelper::Utf8ToUtf16(const EpString &src)
+{
+	EpWString retString;
+	if(src.empty())
+		return retString;
+	retString.resize(src.size());
+	retString.resize(Utf8ToUtf16(src.c_str(),src.size(),&retString[0]));
+	return retString;
+}
+
+EpString UnicodeHelper::Utf16ToUtf8(const EpWString &src)
+{
+	EpString retString;
+	if(src.empty())
+		return retString;
+	retString.resize(src.size()*3);
+	retString.resize(Utf16ToUtf8(src.c_str(),src.size(),&retString[0]));
+	return retString;
+}
+
+bool UnicodeHelper::IsHardwareAccelerated()
+{
+#if defined(EP_UNICODE_SSE2)
+	return hasSSE2();
+#else //defined(EP_UNICODE_SSE2)
+	return false;
+#endif //defined(EP_UNICODE_SSE2)
+}
@@ -0,0 +1,227 @@
+/*! 
+VirtualBuffer for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epVirtualBuffer.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// Function pointer type for GetLargePageMinimum
+typedef SIZE_T (WINAPI *LPFN_GETLARGEPAGEMINIMUM)(void);
+
+#ifndef MEM_LARGE_PAGES
+#define MEM_LARGE_PAGES 0x20000000
+#endif //MEM_LARGE_PAGES
+
+/*!
+Enable SeLockMemoryPrivilege of the calling process.
+@return true if the privilege is enabled, otherwise false.
+*/
+static bool _EnableLockMemoryPrivilege()
+{
+	HANDLE token=NULL;
+	if(!OpenProcessToken(GetCurrentProcess(),TOKEN_ADJUST_PRIVILEGES|TOKEN_QUERY,&token))
+		return false;
+	TOKEN_PRIVILEGES privileges;
+	privileges.PrivilegeCount=1;
+	privileges.Privileges[0].Attributes=SE_PRIVILEGE_ENABLED;
+	bool retVal=false;
+	if(LookupPrivilegeValue(NULL,SE_LOCK_MEMORY_NAME,&privileges.Privileges[0].Luid))
+	{
+		// AdjustTokenPrivileges succeeds with ERROR_NOT_ALL_ASSIGNED if the privilege is not held.
+		if(AdjustTokenPrivileges(token,FALSE,&privileges,0,NULL,NULL) && GetLastError()==ERROR_SUCCESS)
+			retVal=true;
+	}
+	CloseHandle(token);
+	return retVal;
+}
+
+size_t VirtualBuffer::GetLargePageSize()
+{
+	static volatile long s_largePageSize=-1;
+	if(s_largePageSize<0)
+	{
+		long largePageSize=0;
+		//GetLargePageMinimum is not available before Windows Server 2003.
+		LPFN_GETLARGEPAGEMINIMUM fnGetLargePageMinimum = (LPFN_GETLARGEPAGEMINIMUM) GetProcAddress(
+			GetModuleHandle(TEXT("kernel32")),"GetLargePageMinimum");
+		if(fnGetLargePageMinimum && _EnableLockMemoryPrivilege())
+			largePageSize=static_cast<long>(fnGetLargePageMinimum());
+		InterlockedExchange(&s_largePageSize,largePageSize);
+	}
+	return static_cast<size_t>(s_largePageSize);
+}
+
+VirtualBuffer::VirtualBuffer()
+{
+	SYSTEM_INFO sysInfo;
+	GetSystemInfo(&sysInfo);
+	m_pageSize=sysInfo.dwPageSize;
+	m_buffer=NULL;
+	m_committedSize=0;
+	m_reservedSize=0;
+	m_isLargePage=false;
+	m_isGuardPage=false;
+}
+
+VirtualBuffer::~VirtualBuffer()
+{
+	Release();
+}
+
+bool VirtualBuffer::Reserve(size_t maxSize, unsigned int flags)
+{
+	Release();
+	if(maxSize==0)
+		return false;
+
+	if(flags&VIRTUAL_BUFFER_FLAG_LARGE_PAGE)
+	{
+		size_t largePageSize=GetLargePageSize();
+		if(largePageSize)
+		{
+			size_t reservedSize=(maxSize+largePageSize-1)&~(largePageSize-1);
+			// the large pages cannot be committed one by one, so commit the whole region.
+			m_buffer=reinterpret_cast<unsigned char*>(VirtualAlloc(NULL,reservedSize,MEM_RESERVE|MEM_COMMIT|MEM_LARGE_PAGES,PAGE_READWRITE));
+			if(m_buffer)
+			{
+				m_pageSize=largePageSize;
+				m_reservedSize=reservedSize;
+				m_committedSize=reservedSize;
+				m_isLargePage=true;
+				return true;
+			}
+		}
+	}
+
+	SYSTEM_INFO sysInfo;
+	GetSystemInfo(&sysInfo);
+	m_pageSize=sysInfo.dwPageSize;
+	m_isGuardPage=(flags&VIRTUAL_BUFFER_FLAG_GUARD_PAGE)!=0;
+	size_t reservedSize=(maxSize+m_pageSize-1)&~(m_pageSize-1);
+	m_buffer=reinterpret_cast<unsigned char*>(VirtualAlloc(NULL,reservedSize+(m_isGuardPage?m_pageSize:0),MEM_RESERVE,PAGE_NOACCESS));
+	if(!m_buffer)
+	{
+		m_isGuardPage=false;
+		return false;
+	}
+	m_reservedSize=reservedSize;
+	if(m_isGuardPage && !placeGuardPage(0))
+	{
+		Release();
+		return false;
+	}
+	return true;
+}
+
+bool VirtualBuffer::Commit(size_t size)
+{
+	if(size<=m_committedSize)
+		return true;
+	if(!m_buffer || size>m_reservedSize)
+		return false;
+
+	size_t committedSize=(size+m_pageSize-1)&~(m_pageSize-1);
+	if(!VirtualAlloc(m_buffer+m_committedSize,committedSize-m_committedSize,MEM_COMMIT,PAGE_READWRITE))
+		return false;
+	if(m_isGuardPage)
+	{
+		// the old guard page is now the part of the committed region.
+		DWORD oldProtect=0;
+		VirtualProtect(m_buffer+m_committedSize,m_pageSize,PAGE_READWRITE,&oldProtect);
+	}
+	if(m_isGuardPage && !placeGuardPage(committedSize))
+	{
+		VirtualFree(m_buffer+m_committedSize,committedSize-m_committedSize,MEM_DECOMMIT);
+		placeGuardPage(m_committedSize);
+		return false;
+	}
+	m_committedSize=committedSize;
+	return true;
+}
+
+void VirtualBuffer::Decommit(size_t size)
+{
+	if(!m_buffer || m_isLargePage)
+		return;
+	size_t committedSize=(size+m_pageSize-1)&~(m_pageSize-1);
+	if(committedSize>=m_committedSize)
+		return;
+	VirtualFree(m_buffer+committedSize,m_committedSize-committedSize+(m_isGuardPage?m_pageSize:0),MEM_DECOMMIT);
+	m_committedSize=committedSize;
+	if(m_isGuardPage)
+		placeGuardPage(m_committedSize);
+}
+
+void VirtualBuffer::Release()
+{
+	if(m_buffer)
+		VirtualFree(m_buffer,0,MEM_RELEASE);
+	m_buffer=NULL;
+	m_committedSize=0;
+	m_reservedSize=0;
+	m_isLargePage=false;
+	m_isGuardPage=false;
+}
+
+void *VirtualBuffer::GetBuffer() const
+{
+	return m_buffer;
+}
+
+size_t VirtualBuffer::GetCommittedSize() const
+{
+	return m_committedSize;
+}
+
+size_t VirtualBuffer::GetReservedSize() const
+{
+	return m_reservedSize;
+}
+
+size_t VirtualBuffer::GetPageSize() const
+{
+	return m_pageSize;
+}
+
+bool VirtualBuffer::IsLargePage() const
+{
+	return m_isLargePage;
+}
+
+bool VirtualBuffer::IsReserved() const
+{
+	return m_buffer!=NULL;
+}
+
+bool VirtualBuffer::placeGuardPage(size_t offset)
+{
+	return VirtualAlloc(m_buffer+offset,m_pageSize,MEM_COMMIT,PAGE_READWRITE|PAGE_GUARD)!=NULL;
+}
\ No newline at end of file
@@ -24,11 +24,16 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 */
 #include "epWinProcessHelper.h"
-#include <WinPerf.h>
-#include <comdef.h>
 #include <tchar.h>
 #include <tlhelp32.h>
 #include "epMemory.h"
+#include "epClock.h"
+#include "epLocale.h"
+#include "epCriticalSectionEx.h"
+#include "epMutex.h"
+#include "epNoLock.h"
+#include "epSpinParkLock.h"
+#include "epReaderWriterLock.h"
 
 #if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 #define new DEBUG_NEW
@@ -40,156 +45,178 @@ using namespace epl;
 
 #pragma warning(disable: 4996)
 
-PPERF_OBJECT_TYPE FirstObject( PPERF_DATA_BLOCK PerfData )
+ProcessSnapshot::ProcessSnapshot(bool isCapture, LockPolicy lockPolicyType)
 {
-    return reinterpret_cast<PPERF_OBJECT_TYPE>((PBYTE)PerfData + 
-        PerfData->HeaderLength);
+	m_captureTime=0;
+	m_isCaptured=false;
+	m_lockPolicy=lockPolicyType;
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_snapshotLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_snapshotLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_snapshotLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_snapshotLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_snapshotLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_snapshotLock=NULL;
+		break;
+	}
+	if(isCapture)
+		Refresh();
 }
 
-PPERF_OBJECT_TYPE NextObject( PPERF_OBJECT_TYPE PerfObj )
+ProcessSnapshot::~ProcessSnapshot()
 {
-    return reinterpret_cast<PPERF_OBJECT_TYPE>((PBYTE)PerfObj + 
-        PerfObj->TotalByteLength);
+	if(m_snapshotLock)
+		EP_DELETE m_snapshotLock;
 }
 
-PPERF_INSTANCE_DEFINITION FirstInstance( PPERF_OBJECT_TYPE PerfObj )
+EpTString ProcessSnapshot::getNameKey(const TCHAR *pProcessName)
 {
-    return reinterpret_cast<PPERF_INSTANCE_DEFINITION>((PBYTE)PerfObj + 
-        PerfObj->DefinitionLength);
+	EpTString nameKey;
+	if(!pProcessName)
+		return nameKey;
+	nameKey=pProcessName;
+	for(size_t charTrav=0;charTrav<nameKey.length();charTrav++)
+		nameKey[charTrav]=Locale::ToLower(nameKey[charTrav]);
+	// the performance data names the process without the extension
+	if(nameKey.length()>4 && nameKey.compare(nameKey.length()-4,4,_T(".exe"))==0)
+		nameKey.erase(nameKey.length()-4);
+	return nameKey;
 }
 
-PPERF_INSTANCE_DEFINITION NextInstance( 
-    PPERF_INSTANCE_DEFINITION PerfInst )
+bool ProcessSnapshot::Refresh(unsigned int maxAgeInMilliSec)
 {
-    PPERF_COUNTER_BLOCK PerfCntrBlk;
+	LockObj lock(m_snapshotLock);
+	__int64 currentTime=Clock::GetMilliSec();
+	if(maxAgeInMilliSec && m_isCaptured && currentTime-m_captureTime<static_cast<__int64>(maxAgeInMilliSec))
+		return true;
 
-    PerfCntrBlk = reinterpret_cast<PPERF_COUNTER_BLOCK>((PBYTE)PerfInst + 
-        PerfInst->ByteLength);
+	HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+	if(snapshot==INVALID_HANDLE_VALUE)
+		return false;
+	std::map<unsigned long,EpTString> nameMap;
+	PROCESSENTRY32 entry;
+	entry.dwSize = sizeof(PROCESSENTRY32);
+	if (Process32First(snapshot, &entry) == TRUE)
+	{
+		do
+		{
+			nameMap[entry.th32ProcessID]=entry.szExeFile;
+		}while (Process32Next(snapshot, &entry) == TRUE);
+	}
+	CloseHandle(snapshot);
 
-    return reinterpret_cast<PPERF_INSTANCE_DEFINITION>((PBYTE)PerfCntrBlk + 
-        PerfCntrBlk->ByteLength);
+	// only the exited and the started processes are updated in the index
+	std::map<unsigned long,EpTString>::iterator oldIter=m_nameMap.begin();
+	std::map<unsigned long,EpTString>::iterator newIter=nameMap.begin();
+	while(oldIter!=m_nameMap.end() || newIter!=nameMap.end())
+	{
+		bool isExited=newIter==nameMap.end() || (oldIter!=m_nameMap.end() && oldIter->first<newIter->first);
+		bool isStarted=oldIter==m_nameMap.end() || (newIter!=nameMap.end() && newIter->first<oldIter->first);
+		if(!isExited && !isStarted && oldIter->second!=newIter->second)
+		{
+			// the process ID is reused by the other executable
+			isExited=true;
+			isStarted=true;
+		}
+		if(isExited)
+		{
+			std::map<EpTString,std::vector<unsigned long> >::iterator indexIter=m_processIdMap.find(getNameKey(oldIter->second.c_str()));
+			if(indexIter!=m_processIdMap.end())
+			{
+				std::vector<unsigned long> &processIdList=indexIter->second;
+				for(size_t idTrav=0;idTrav<processIdList.size();idTrav++)
+				{
+					if(processIdList[idTrav]==oldIter->first)
+					{
+						processIdList.erase(processIdList.begin()+idTrav);
+						break;
+					}
+				}
+				if(processIdList.empty())
+					m_processIdMap.erase(indexIter);
+			}
+		}
+		if(isStarted)
+			m_processIdMap[getNameKey(newIter->second.c_str())].push_back(newIter->first);
+
+		if(oldIter!=m_nameMap.end() && (isExited || !isStarted))
+			oldIter++;
+		if(newIter!=nameMap.end() && (isStarted || !isExited))
+			newIter++;
+	}
+	m_nameMap.swap(nameMap);
+	m_captureTime=currentTime;
+	m_isCaptured=true;
+	return true;
 }
 
-PPERF_COUNTER_DEFINITION FirstCounter( PPERF_OBJECT_TYPE PerfObj )
+unsigned int ProcessSnapshot::GetAgeInMilliSec() const
 {
-    return reinterpret_cast<PPERF_COUNTER_DEFINITION>((PBYTE)PerfObj + 
-        PerfObj->HeaderLength);
+	SharedLockObj lock(m_snapshotLock);
+	return static_cast<unsigned int>(Clock::GetMilliSec()-m_captureTime);
 }
 
-PPERF_COUNTER_DEFINITION NextCounter( 
-    PPERF_COUNTER_DEFINITION PerfCntr )
+void ProcessSnapshot::GetProcessID(const TCHAR * pProcessName, std::vector<unsigned long>& retSetOfPID) const
 {
-    return reinterpret_cast<PPERF_COUNTER_DEFINITION>((PBYTE)PerfCntr + 
-        PerfCntr->ByteLength);
+	SharedLockObj lock(m_snapshotLock);
+	retSetOfPID.clear();
+	std::map<EpTString,std::vector<unsigned long> >::const_iterator indexIter=m_processIdMap.find(getNameKey(pProcessName));
+	if(indexIter!=m_processIdMap.end())
+		retSetOfPID=indexIter->second;
 }
 
-
-PPERF_COUNTER_BLOCK CounterBlock(PPERF_INSTANCE_DEFINITION PerfInst)
+size_t ProcessSnapshot::GetNumberOfProcess(const TCHAR * pProcessName) const
 {
-	return reinterpret_cast<PPERF_COUNTER_BLOCK>((LPBYTE) PerfInst + PerfInst->ByteLength);
+	SharedLockObj lock(m_snapshotLock);
+	std::map<EpTString,std::vector<unsigned long> >::const_iterator indexIter=m_processIdMap.find(getNameKey(pProcessName));
+	if(indexIter!=m_processIdMap.end())
+		return indexIter->second.size();
+	return 0;
 }
 
-#define TOTALBYTES    64*1024
-#define BYTEINCREMENT 1024
-
-#define PROCESS_OBJECT_INDEX	230
-#define PROC_ID_COUNTER			784
-
-
-void WinProcessHelper::GetProcessID(const TCHAR *pProcessName, std::vector<unsigned long>& retSetOfPID)
+bool ProcessSnapshot::GetProcessName(unsigned long processID, EpTString &retProcessName) const
 {
-    PPERF_DATA_BLOCK pPerfData = NULL;
-    PPERF_OBJECT_TYPE pPerfObj;
-    PPERF_INSTANCE_DEFINITION pPerfInst;
-    PPERF_COUNTER_DEFINITION pPerfCntr, pCurCntr;
-    PPERF_COUNTER_BLOCK PtrToCntr;
-    unsigned long BufferSize = TOTALBYTES;
-    unsigned long i, j;
-	LONG k;
-
-// Allocate the buffer for the performance data.
-
-    pPerfData = reinterpret_cast<PPERF_DATA_BLOCK>(EP_Malloc( BufferSize ));
-
-	TCHAR szKey[32];
-	_stprintf(szKey,_T("%d %d"),PROCESS_OBJECT_INDEX, PROC_ID_COUNTER);
-	LONG lRes;
-    while( (lRes = RegQueryValueEx( HKEY_PERFORMANCE_DATA,
-                               szKey,
-                               NULL,
-                               NULL,
-                               reinterpret_cast<LPBYTE>(pPerfData),
-                               &BufferSize )) == ERROR_MORE_DATA )
-    {
-		// Get a buffer that is big enough.
-
-        BufferSize += BYTEINCREMENT;
-        pPerfData = reinterpret_cast<PPERF_DATA_BLOCK>(EP_Realloc( pPerfData, BufferSize ));
-    }
-
-	// Get the first object type.
-
-    pPerfObj = FirstObject( pPerfData );
-
-	// Process all objects.
-
-    for( i=0; i < pPerfData->NumObjectTypes; i++ )
-    {
-
-		if (pPerfObj->ObjectNameTitleIndex != PROCESS_OBJECT_INDEX)
-		{
-			pPerfObj = NextObject( pPerfObj );
-			continue;
-		}
-    
-		retSetOfPID.clear();
-
-		// Get the first counter.
-
-        pPerfCntr = FirstCounter( pPerfObj );
-
-		// Get the first instance.
-
-        pPerfInst = FirstInstance( pPerfObj );
-
-		_bstr_t bstrProcessName,bstrInput;
-
-		// Retrieve all instances.
-
-        for( k=0; k < pPerfObj->NumInstances; k++ )
-        {
-			pCurCntr = pPerfCntr;
-			bstrInput = pProcessName;
-			bstrProcessName = reinterpret_cast<wchar_t *>(reinterpret_cast<PBYTE>(pPerfInst) + pPerfInst->NameOffset);
-			if (!_tcscmp(static_cast<const TCHAR *>(bstrProcessName), static_cast<const TCHAR *>(bstrInput)))
-			{
-			
-				// Retrieve all counters.
-
-				for( j=0; j < pPerfObj->NumCounters; j++ )
-				{
-					if (pCurCntr->CounterNameTitleIndex == PROC_ID_COUNTER)
-					{
-						PtrToCntr = CounterBlock(pPerfInst);
-						unsigned long *pdwValue = reinterpret_cast<unsigned long*>(reinterpret_cast<LPBYTE>(PtrToCntr) + pCurCntr->CounterOffset);
-						retSetOfPID.push_back(*pdwValue);
-						break;
-					}
-
-
-					// Get the next counter.
+	SharedLockObj lock(m_snapshotLock);
+	std::map<unsigned long,EpTString>::const_iterator nameIter=m_nameMap.find(processID);
+	if(nameIter==m_nameMap.end())
+		return false;
+	retProcessName=nameIter->second;
+	return true;
+}
 
-					pCurCntr = NextCounter( pCurCntr );
-				}
-			}
+bool ProcessSnapshot::IsProcessRunning(unsigned long processID) const
+{
+	SharedLockObj lock(m_snapshotLock);
+	return m_nameMap.find(processID)!=m_nameMap.end();
+}
 
-			// Get the next instance.
+size_t ProcessSnapshot::GetProcessCount() const
+{
+	SharedLockObj lock(m_snapshotLock);
+	return m_nameMap.size();
+}
 
-            pPerfInst = NextInstance( pPerfInst );
-        }
-    }
-	EP_Free(pPerfData);
-	RegCloseKey(HKEY_PERFORMANCE_DATA);
+void WinProcessHelper::GetProcessID(const TCHAR *pProcessName, std::vector<unsigned long>& retSetOfPID, const ProcessSnapshot *snapshot)
+{
+	if(snapshot)
+	{
+		snapshot->GetProcessID(pProcessName,retSetOfPID);
+		return;
+	}
+	ProcessSnapshot currentSnapshot(true,LOCK_POLICY_NONE);
+	currentSnapshot.GetProcessID(pProcessName,retSetOfPID);
 }
 
 unsigned long WinProcessHelper::GetProcessID(HANDLE processHandle)
@@ -219,10 +246,10 @@ bool WinProcessHelper::TerminateProcess(HANDLE processHandle)
 	return false;
 }
 
-bool WinProcessHelper::SwitchToProcess(const TCHAR * pProcessName)
+bool WinProcessHelper::SwitchToProcess(const TCHAR * pProcessName, const ProcessSnapshot *snapshot)
 {
 	std::vector<unsigned long> setOfPID;
-	epl::WinProcessHelper::GetProcessID(pProcessName,setOfPID);
+	epl::WinProcessHelper::GetProcessID(pProcessName,setOfPID,snapshot);
 	if(!setOfPID.empty())
 	{
 		HWND hwnd= ::GetTopWindow(0);
@@ -278,15 +305,17 @@ bool WinProcessHelper::SwitchToProcess(HANDLE processHandle)
 	return false;
 }
 
-bool WinProcessHelper::TerminateProcess(const TCHAR *pProcessName)
+bool WinProcessHelper::TerminateProcess(const TCHAR *pProcessName, const ProcessSnapshot *snapshot)
 {
 	std::vector<unsigned long> setOfPid;
-	epl::WinProcessHelper::GetProcessID(pProcessName,setOfPid);
+	epl::WinProcessHelper::GetProcessID(pProcessName,setOfPid,snapshot);
 	if(!setOfPid.empty())
 	{
 		for(unsigned int i=0; i<setOfPid.size(); i++)
 		{
 			HANDLE pProcess = OpenProcess(PROCESS_ALL_ACCESS,FALSE,setOfPid[i]);
+			if(!pProcess)
+				continue;
 			::TerminateProcess(pProcess,0);
 			::CloseHandle(pProcess);
 		}
@@ -298,37 +327,29 @@ bool WinProcessHelper::TerminateProcess(const TCHAR *pProcessName)
 	return true;
 }
 
-size_t WinProcessHelper::GetNumberOfProcess(const TCHAR * pProcessName)
+size_t WinProcessHelper::GetNumberOfProcess(const TCHAR * pProcessName, const ProcessSnapshot *snapshot)
 {
-	std::vector<unsigned long> setOfPid;
-	epl::WinProcessHelper::GetProcessID(pProcessName,setOfPid);
-	return setOfPid.size();
+	if(snapshot)
+		return snapshot->GetNumberOfProcess(pProcessName);
+	ProcessSnapshot currentSnapshot(true,LOCK_POLICY_NONE);
+	return currentSnapshot.GetNumberOfProcess(pProcessName);
 }
 
 
-void WinProcessHelper::CommandOnProcess(const TCHAR *pProcessName, void (__cdecl *Func)(HANDLE) )
+void WinProcessHelper::CommandOnProcess(const TCHAR *pProcessName, void (__cdecl *Func)(HANDLE), const ProcessSnapshot *snapshot)
 {
-	PROCESSENTRY32 entry;
-	entry.dwSize = sizeof(PROCESSENTRY32);
-
-	HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, NULL);
-
-	if (Process32First(snapshot, &entry) == TRUE)
+	std::vector<unsigned long> setOfPid;
+	epl::WinProcessHelper::GetProcessID(pProcessName,setOfPid,snapshot);
+	for(size_t pidTrav=0;pidTrav<setOfPid.size();pidTrav++)
 	{
-		while (Process32Next(snapshot, &entry) == TRUE)
-		{
-			if (_tcsicmp(entry.szExeFile, pProcessName) == 0)
-			{  
-				HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, entry.th32ProcessID);
+		HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, setOfPid[pidTrav]);
+		if(!hProcess)
+			continue;
 
-				Func(hProcess);
+		Func(hProcess);
 
-				CloseHandle(hProcess);
-			}
-		}
+		CloseHandle(hProcess);
 	}
-
-	CloseHandle(snapshot);
 }
 
 ProcessPriority WinProcessHelper::GetPriority(HANDLE processHandle)
@@ -0,0 +1,215 @@
+/*! 
+WorkerMetrics for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epWorkerMetrics.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+WorkerMetricsSnapshot::WorkerMetricsSnapshot()
+{
+	jobsProcessed=0;
+	totalWaitTime=0;
+	totalServiceTime=0;
+	totalIdleTime=0;
+	maxWaitTime=0;
+	maxServiceTime=0;
+	for(unsigned int bucketTrav=0;bucketTrav<WORKER_METRICS_BUCKET_COUNT;bucketTrav++)
+	{
+		waitHistogram[bucketTrav]=0;
+		serviceHistogram[bucketTrav]=0;
+	}
+}
+
+void WorkerMetricsSnapshot::Subtract(const WorkerMetricsSnapshot &b)
+{
+	jobsProcessed-=b.jobsProcessed;
+	totalWaitTime-=b.totalWaitTime;
+	totalServiceTime-=b.totalServiceTime;
+	totalIdleTime-=b.totalIdleTime;
+	for(unsigned int bucketTrav=0;bucketTrav<WORKER_METRICS_BUCKET_COUNT;bucketTrav++)
+	{
+		waitHistogram[bucketTrav]-=b.waitHistogram[bucketTrav];
+		serviceHistogram[bucketTrav]-=b.serviceHistogram[bucketTrav];
+	}
+}
+
+void WorkerMetricsSnapshot::Add(const WorkerMetricsSnapshot &b)
+{
+	jobsProcessed+=b.jobsProcessed;
+	totalWaitTime+=b.totalWaitTime;
+	totalServiceTime+=b.totalServiceTime;
+	totalIdleTime+=b.totalIdleTime;
+	if(b.maxWaitTime>maxWaitTime)
+		maxWaitTime=b.maxWaitTime;
+	if(b.maxServiceTime>maxServiceTime)
+		maxServiceTime=b.maxServiceTime;
+	for(unsigned int bucketTrav=0;bucketTrav<WORKER_METRICS_BUCKET_COUNT;bucketTrav++)
+	{
+		waitHistogram[bucketTrav]+=b.waitHistogram[bucketTrav];
+		serviceHistogram[bucketTrav]+=b.serviceHistogram[bucketTrav];
+	}
+}
+
+double WorkerMetricsSnapshot::GetUtilization() const
+{
+	__int64 totalTime=totalServiceTime+totalIdleTime;
+	if(totalTime<=0)
+		return 0.0;
+	return static_cast<double>(totalServiceTime)/static_cast<double>(totalTime);
+}
+
+double WorkerMetricsSnapshot::GetMeanWaitTime() const
+{
+	if(jobsProcessed<=0)
+		return 0.0;
+	return static_cast<double>(totalWaitTime)/static_cast<double>(jobsProcessed);
+}
+
+double WorkerMetricsSnapshot::GetMeanServiceTime() const
+{
+	if(jobsProcessed<=0)
+		return 0.0;
+	return static_cast<double>(totalServiceTime)/static_cast<double>(jobsProcessed);
+}
+
+static __int64 getHistogramPercentile(const __int64 *histogram, __int64 maxValue, double percentile)
+{
+	__int64 totalCount=0;
+	for(unsigned int bucketTrav=0;bucketTrav<WORKER_METRICS_BUCKET_COUNT;bucketTrav++)
+		totalCount+=histogram[bucketTrav];
+	if(totalCount==0)
+		return 0;
+	double targetCount=static_cast<double>(totalCount)*percentile/100.0;
+	__int64 accCount=0;
+	for(unsigned int bucketTrav=0;bucketTrav<WORKER_METRICS_BUCKET_COUNT;bucketTrav++)
+	{
+		accCount+=histogram[bucketTrav];
+		if(static_cast<double>(accCount)>=targetCount)
+		{
+			__int64 upperBound=static_cast<__int64>(1)<<bucketTrav;
+			return (upperBound<maxValue)?upperBound:maxValue;
+		}
+	}
+	return maxValue;
+}
+
+__int64 WorkerMetricsSnapshot::GetWaitTimePercentile(double percentile) const
+{
+	return getHistogramPercentile(waitHistogram,maxWaitTime,percentile);
+}
+
+__int64 WorkerMetricsSnapshot::GetServiceTimePercentile(double percentile) const
+{
+	return getHistogramPercentile(serviceHistogram,maxServiceTime,percentile);
+}
+
+
+WorkerMetrics::WorkerMetrics()
+{
+	m_sequence=0;
+}
+
+WorkerMetrics::~WorkerMetrics()
+{
+}
+
+void WorkerMetrics::RecordJob(__int64 waitTime, __int64 serviceTime)
+{
+	if(waitTime<0)
+		waitTime=0;
+	if(serviceTime<0)
+		serviceTime=0;
+	InterlockedIncrement(&m_sequence);
+	m_counters.jobsProcessed++;
+	m_counters.totalWaitTime+=waitTime;
+	m_counters.totalServiceTime+=serviceTime;
+	m_counters.waitHistogram[getBucket(waitTime)]++;
+	m_counters.serviceHistogram[getBucket(serviceTime)]++;
+	if(waitTime>m_counters.maxWaitTime)
+		m_counters.maxWaitTime=waitTime;
+	if(serviceTime>m_counters.maxServiceTime)
+		m_counters.maxServiceTime=serviceTime;
+	InterlockedIncrement(&m_sequence);
+}
+
+void WorkerMetrics::RecordIdle(__int64 idleTime)
+{
+	if(idleTime<=0)
+		return;
+	InterlockedIncrement(&m_sequence);
+	m_counters.totalIdleTime+=idleTime;
+	InterlockedIncrement(&m_sequence);
+}
+
+void WorkerMetrics::GetSnapshot(WorkerMetricsSnapshot &retSnapshot) const
+{
+	while(true)
+	{
+		long sequence=m_sequence;
+		if(sequence&1)
+		{
+			// the worker is in the middle of recording
+			YieldProcessor();
+			continue;
+		}
+		MemoryBarrier();
+		retSnapshot=m_counters;
+		MemoryBarrier();
+		if(m_sequence==sequence)
+			return;
+	}
+}
+
+__int64 WorkerMetrics::GetCurrentMicroSec()
+{
+	static LARGE_INTEGER frequency={0};
+	if(frequency.QuadPart==0)
+	{
+		// the frequency is fixed at system boot, so the racing threads store the same value
+		if(!QueryPerformanceFrequency(&frequency) || frequency.QuadPart==0)
+			return static_cast<__int64>(GetTickCount())*1000;
+	}
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	// split the conversion so that counter*1000000 does not overflow
+	return (counter.QuadPart/frequency.QuadPart)*1000000+(counter.QuadPart%frequency.QuadPart)*1000000/frequency.QuadPart;
+}
+
+unsigned int WorkerMetrics::getBucket(__int64 time)
+{
+	unsigned int bucket=0;
+	while(time>0 && bucket<WORKER_METRICS_BUCKET_COUNT-1)
+	{
+		time>>=1;
+		bucket++;
+	}
+	return bucket;
+}
@@ -32,26 +32,69 @@ static char THIS_FILE[] = __FILE__;
 #endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
 
 using namespace epl;
-WorkerThreadInfinite::WorkerThreadInfinite(const ThreadLifePolicy policy):BaseWorkerThread(policy)
+WorkerThreadInfinite::WorkerThreadInfinite(const ThreadLifePolicy policy, const IdleWaitPolicy idlePolicy, unsigned int maxSpinCount):BaseWorkerThread(policy)
 {
-	m_terminateEvent=EventEx(false,false);
+	m_terminateEvent=LightEvent(false,false);
+	m_workEvent=LightEvent(false,false);
+	m_idlePolicy=idlePolicy;
+	m_maxSpinCount=maxSpinCount;
+	m_spinCount=maxSpinCount;
 }
 
 WorkerThreadInfinite::WorkerThreadInfinite(const WorkerThreadInfinite & b):BaseWorkerThread(b)
 {
-	m_terminateEvent=EventEx(false,false);
+	m_terminateEvent=LightEvent(false,false);
+	m_workEvent=LightEvent(false,false);
+	m_idlePolicy=b.m_idlePolicy;
+	m_maxSpinCount=b.m_maxSpinCount;
+	m_spinCount=b.m_maxSpinCount;
+}
+
+void WorkerThreadInfinite::signalWork()
+{
+	BaseWorkerThread::signalWork();
+	m_workEvent.SetEvent();
 }
 
 Thread::TerminateResult WorkerThreadInfinite::TerminateWorker(unsigned int waitTimeInMilliSec)
 {
 	m_terminateEvent.SetEvent();
+	m_workEvent.SetEvent();
 	Resume();
 	return TerminateAfter(waitTimeInMilliSec);
 
 }
 
+void WorkerThreadInfinite::waitForWork()
+{
+	if(m_idlePolicy==IDLE_WAIT_YIELD)
+	{
+		Sleep(0);
+		return;
+	}
+
+	for(unsigned int spinTrav=0;spinTrav<m_spinCount;spinTrav++)
+	{
+		if(!m_workPool.IsEmpty())
+		{
+			// spinning paid off, so spin longer next time
+			m_spinCount=(m_spinCount*2<m_maxSpinCount)?m_spinCount*2:m_maxSpinCount;
+			return;
+		}
+		YieldProcessor();
+	}
+	m_spinCount=m_spinCount/2;
+	if(m_spinCount==0 && m_maxSpinCount>0)
+		m_spinCount=1;
+
+	// the event is auto-reset, so a Push between IsEmpty() and here is not lost
+	if(m_workPool.IsEmpty())
+		m_workEvent.WaitForEvent();
+}
+
 void WorkerThreadInfinite::execute()
 {
+	std::vector<BaseJob*> jobBatch;
 	while(true)
 	{
 		if(m_terminateEvent.WaitForEvent(0))
@@ -63,22 +106,34 @@ void WorkerThreadInfinite::execute()
 			if(m_lifePolicy==THREAD_LIFE_SUSPEND_AFTER_WORK)
 			{
 				callCallBack();
+				__int64 idleStartTime=WorkerMetrics::GetCurrentMicroSec();
 				Suspend();
+				recordIdle(idleStartTime);
 				continue;
 			}
 			callCallBack();
-			Sleep(0);
+			__int64 idleStartTime=WorkerMetrics::GetCurrentMicroSec();
+			waitForWork();
+			recordIdle(idleStartTime);
 			continue;
 		}
 		EP_ASSERT_EXPR(m_jobProcessor,_T("Job Processor is NULL!"));
 		if(!m_jobProcessor)
 			break;
-		BaseJob * jobPtr=m_workPool.Front();
-		jobPtr->RetainObj();
-		m_workPool.Pop();
-		jobPtr->JobReport(BaseJob::JOB_STATUS_IN_PROCESS);
-		m_jobProcessor->DoJob(this, jobPtr);
-		jobPtr->JobReport(BaseJob::JOB_STATUS_DONE);
-		jobPtr->ReleaseObj();
+		size_t jobCount=popJobBatch(jobBatch);
+		for(size_t jobTrav=0;jobTrav<jobCount;jobTrav++)
+		{
+			BaseJob * jobPtr=jobBatch[jobTrav];
+			if(jobTrav>0 && m_terminateEvent.WaitForEvent(0))
+			{
+				for(;jobTrav<jobCount;jobTrav++)
+				{
+					jobBatch[jobTrav]->JobReport(BaseJob::JOB_STATUS_INCOMPLETE);
+					jobBatch[jobTrav]->ReleaseObj();
+				}
+				return;
+			}
+			processJob(jobPtr);
+		}
 	}
 }
\ No newline at end of file
@@ -33,22 +33,95 @@ static char THIS_FILE[] = __FILE__;
 
 using namespace epl;
 
+WorkerThreadSingle::WorkerThreadSingle(const ThreadLifePolicy policy,LockPolicy lockPolicyType,unsigned int keepAliveInMilliSec):BaseWorkerThread(policy,lockPolicyType),m_workEvent(false,false)
+{
+	m_keepAliveTime=keepAliveInMilliSec;
+	m_isParked=0;
+	m_isTerminating=0;
+}
+
+WorkerThreadSingle::WorkerThreadSingle(const WorkerThreadSingle & b):BaseWorkerThread(b),m_workEvent(false,false)
+{
+	m_keepAliveTime=b.m_keepAliveTime;
+	m_isParked=0;
+	m_isTerminating=0;
+}
+
+bool WorkerThreadSingle::Start(const ThreadOpCode opCode, const ThreadType threadType, const int stackSize)
+{
+	// take the parked thread only if it has not timed out yet, the caller has already pushed the work
+	if(InterlockedCompareExchange(&m_isParked,0,1)==1)
+	{
+		m_workEvent.SetEvent();
+		return true;
+	}
+	InterlockedExchange(&m_isTerminating,0);
+	return Thread::Start(opCode,threadType,stackSize);
+}
+
+void WorkerThreadSingle::signalWork()
+{
+	BaseWorkerThread::signalWork();
+	m_workEvent.SetEvent();
+}
+
+Thread::TerminateResult WorkerThreadSingle::TerminateWorker(unsigned int waitTimeInMilliSec)
+{
+	InterlockedExchange(&m_isTerminating,1);
+	m_workEvent.SetEvent();
+	return TerminateAfter(waitTimeInMilliSec);
+}
+
+void WorkerThreadSingle::SetKeepAliveTime(unsigned int keepAliveInMilliSec)
+{
+	m_keepAliveTime=keepAliveInMilliSec;
+}
+
+unsigned int WorkerThreadSingle::GetKeepAliveTime() const
+{
+	return m_keepAliveTime;
+}
+
+bool WorkerThreadSingle::IsParked() const
+{
+	return m_isParked!=0;
+}
+
 void WorkerThreadSingle::execute()
 {
+	std::vector<BaseJob*> jobBatch;
 	while(true)
 	{
-		if(m_workPool.IsEmpty())
+		while(!m_workPool.IsEmpty() && !m_isTerminating)
+		{
+			EP_ASSERT_EXPR(m_jobProcessor,_T("Job Processor is NULL!"));
+			if(!m_jobProcessor)
+				break;
+			size_t jobCount=popJobBatch(jobBatch);
+			for(size_t jobTrav=0;jobTrav<jobCount;jobTrav++)
+			{
+				processJob(jobBatch[jobTrav]);
+			}
+		}
+		callCallBack();
+		if(m_keepAliveTime==0 || m_isTerminating || !m_jobProcessor)
 			break;
-		EP_ASSERT_EXPR(m_jobProcessor,_T("Job Processor is NULL!"));
-		if(!m_jobProcessor)
+
+		// park the thread instead of terminating, so the next burst does not pay for the thread creation
+		InterlockedExchange(&m_isParked,1);
+		bool isSignaled=true;
+		// check again after parking, since the work pushed before parking was signalled to the running thread
+		if(m_workPool.IsEmpty() && !m_isTerminating)
+		{
+			__int64 idleStartTime=WorkerMetrics::GetCurrentMicroSec();
+			isSignaled=m_workEvent.WaitForEvent(m_keepAliveTime);
+			recordIdle(idleStartTime);
+		}
+		// Start took the thread, so it stays for the work even if the wait timed out
+		if(InterlockedCompareExchange(&m_isParked,0,1)==0)
+			continue;
+		// the work pushed right after the time-out is still taken by this thread
+		if(!isSignaled && m_workPool.IsEmpty())
 			break;
-		BaseJob * jobPtr=m_workPool.Front();
-		jobPtr->RetainObj();
-		m_workPool.Pop();
-		jobPtr->JobReport(BaseJob::JOB_STATUS_IN_PROCESS);
-		m_jobProcessor->DoJob(this,jobPtr);
-		jobPtr->JobReport(BaseJob::JOB_STATUS_DONE);
-		jobPtr->ReleaseObj();
 	}
-	callCallBack();
 }
\ No newline at end of file
@@ -121,8 +121,6 @@ void XMLFile::Clear()
 }
 void XMLFile::writeLoop()
 {
-	EpTString toFileString;
-
 	if(m_xmlInfo.m_isWriteComment)
 	{
 		EpTString commentToFile=_T("<?xml version=\"");
@@ -133,10 +131,26 @@ void XMLFile::writeLoop()
 		writeToFile(commentToFile.c_str());
 	}
 
-	toFileString=GetXML().GetString();
-	toFileString.append(_T("\r\n"));
-	writeToFile(toFileString.c_str());
+	// stream the nodes to the file through the buffer, instead of building the whole document as a string
+	FileWriter writer(this);
+	writer.WriteNode(this);
+	writer.Write(_T("\r\n"),2);
+}
+XMLFile::FileWriter::FileWriter(XMLFile *owner):XMLStreamWriter()
+{
+	m_owner=owner;
+}
+
+XMLFile::FileWriter::~FileWriter()
+{
+	Flush();
 }
+
+void XMLFile::FileWriter::flushChars(const TCHAR *chars, size_t count)
+{
+	m_owner->writeToFile(chars,count);
+}
+
 void XMLFile::loadFromFile(const EpTString &lines)
 {
 	Close();
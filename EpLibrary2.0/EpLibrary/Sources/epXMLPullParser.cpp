@@ -0,0 +1,603 @@
+/*! 
+XMLPullParser for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epXMLPullParser.h"
+#include <wchar.h>
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the longest entity reference decoded, such as "&#x10FFFF;"
+#define XML_PULL_MAX_REFERENCE_LENGTH 10
+
+/*!
+Return the flag whether the given character is the whitespace of the XML.
+@param[in] ch the character to check.
+@return true if the whitespace, otherwise false.
+*/
+static inline bool isXmlSpace(TCHAR ch)
+{
+	return ch==_T(' ') || ch==_T('\t') || ch==_T('\r') || ch==_T('\n');
+}
+
+/*!
+Skip the whitespaces.
+@param[in] cur the character to start.
+@param[in] end the end of the characters.
+@return the first character which is not the whitespace, or end if none.
+*/
+static inline const TCHAR *skipSpace(const TCHAR *cur, const TCHAR *end)
+{
+	while(cur<end && isXmlSpace(*cur))
+		cur++;
+	return cur;
+}
+
+/*!
+Find the given character.
+@param[in] cur the character to start.
+@param[in] end the end of the characters.
+@param[in] ch the character to find.
+@return the character found, or end if not found.
+*/
+static inline const TCHAR *findChar(const TCHAR *cur, const TCHAR *end, TCHAR ch)
+{
+	if(cur>=end)
+		return end;
+#if defined(_UNICODE) || defined(UNICODE)
+	const TCHAR *found=wmemchr(cur,ch,end-cur);
+#else //defined(_UNICODE) || defined(UNICODE)
+	const TCHAR *found=reinterpret_cast<const TCHAR*>(memchr(cur,ch,end-cur));
+#endif //defined(_UNICODE) || defined(UNICODE)
+	return found?found:end;
+}
+
+/*!
+Find the given string.
+@param[in] cur the character to start.
+@param[in] end the end of the characters.
+@param[in] str the string to find.
+@param[in] strLength the number of the characters of the string.
+@return the first character of the string found, or end if not found.
+*/
+static const TCHAR *findString(const TCHAR *cur, const TCHAR *end, const TCHAR *str, size_t strLength)
+{
+	while(true)
+	{
+		cur=findChar(cur,end,str[0]);
+		if(static_cast<size_t>(end-cur)<strLength)
+			return end;
+		if(memcmp(cur,str,strLength*sizeof(TCHAR))==0)
+			return cur;
+		cur++;
+	}
+}
+
+/*!
+Return the flag whether the characters start with the given string.
+@param[in] cur the character to start.
+@param[in] end the end of the characters.
+@param[in] str the string to compare.
+@param[in] strLength the number of the characters of the string.
+@return true if start with the string, otherwise false.
+*/
+static inline bool startsWith(const TCHAR *cur, const TCHAR *end, const TCHAR *str, size_t strLength)
+{
+	return static_cast<size_t>(end-cur)>=strLength && memcmp(cur,str,strLength*sizeof(TCHAR))==0;
+}
+
+/*!
+Return the flag whether the given strings are the same.
+@param[in] a the first string.
+@param[in] b the second string.
+@return true if the same, otherwise false.
+*/
+static inline bool isSame(const XMLStringRef &a, const XMLStringRef &b)
+{
+	return a.m_length==b.m_length && memcmp(a.m_begin,b.m_begin,a.m_length*sizeof(TCHAR))==0;
+}
+
+/*!
+Decode the entity reference between '&' and ';'.
+@param[in] begin the first character after '&'.
+@param[in] end the ';' closing the reference.
+@param[out] retCodePoint the code point of the reference.
+@return true if decoded, otherwise false.
+*/
+static bool decodeReference(const TCHAR *begin, const TCHAR *end, unsigned int &retCodePoint)
+{
+	size_t length=end-begin;
+	if(length==0)
+		return false;
+	if(*begin!=_T('#'))
+	{
+		static const struct { const TCHAR *m_name; size_t m_length; TCHAR m_char; } s_entities[]={
+			{_T("lt"),2,_T('<')},{_T("gt"),2,_T('>')},{_T("amp"),3,_T('&')},{_T("quot"),4,_T('"')},{_T("apos"),4,_T('\'')}
+		};
+		for(size_t entityTrav=0;entityTrav<sizeof(s_entities)/sizeof(s_entities[0]);entityTrav++)
+		{
+			if(s_entities[entityTrav].m_length==length && memcmp(begin,s_entities[entityTrav].m_name,length*sizeof(TCHAR))==0)
+			{
+				retCodePoint=static_cast<unsigned int>(s_entities[entityTrav].m_char);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const TCHAR *digit=begin+1;
+	unsigned int base=10;
+	if(digit<end && (*digit==_T('x') || *digit==_T('X')))
+	{
+		base=16;
+		digit++;
+	}
+	if(digit>=end)
+		return false;
+	unsigned int codePoint=0;
+	for(;digit<end;digit++)
+	{
+		unsigned int value;
+		if(*digit>=_T('0') && *digit<=_T('9'))
+			value=*digit-_T('0');
+		else if(base==16 && *digit>=_T('a') && *digit<=_T('f'))
+			value=*digit-_T('a')+10;
+		else if(base==16 && *digit>=_T('A') && *digit<=_T('F'))
+			value=*digit-_T('A')+10;
+		else
+			return false;
+		codePoint=codePoint*base+value;
+		if(codePoint>0x10FFFF)
+			return false;
+	}
+	if(codePoint==0 || (codePoint>=0xD800 && codePoint<=0xDFFF))
+		return false;
+	retCodePoint=codePoint;
+	return true;
+}
+
+/*!
+Append the given code point to the string.
+@param[in] retString the string to append to.
+@param[in] codePoint the code point to append.
+*/
+static void appendCodePoint(EpTString &retString, unsigned int codePoint)
+{
+	wchar_t wideChars[2];
+	size_t wideCount=1;
+	if(codePoint>=0x10000)
+	{
+		codePoint-=0x10000;
+		wideChars[0]=static_cast<wchar_t>(0xD800|(codePoint>>10));
+		wideChars[1]=static_cast<wchar_t>(0xDC00|(codePoint&0x3FF));
+		wideCount=2;
+	}
+	else
+		wideChars[0]=static_cast<wchar_t>(codePoint);
+#if defined(_UNICODE) || defined(UNICODE)
+	retString.append(wideChars,wideCount);
+#else //defined(_UNICODE) || defined(UNICODE)
+	if(codePoint<0x80)
+		retString.push_back(static_cast<char>(codePoint));
+	else
+		retString.append(System::WideCharToMultiByte(wideChars,static_cast<int>(wideCount)));
+#endif //defined(_UNICODE) || defined(UNICODE)
+}
+
+bool XMLStringRef::Equals(const TCHAR *str) const
+{
+	for(size_t charTrav=0;charTrav<m_length;charTrav++)
+	{
+		if(str[charTrav]!=m_begin[charTrav])
+			return false;
+	}
+	return str[m_length]==_T('\0');
+}
+
+EpTString XMLStringRef::ToString() const
+{
+	if(!m_length)
+		return EpTString();
+	return EpTString(m_begin,m_length);
+}
+
+XMLPullParser::XMLPullParser(const TCHAR *xml, size_t length, bool skipWhitespaceText)
+{
+	EP_ASSERT(xml || !length);
+	m_xml=xml;
+	m_end=xml+length;
+	m_cur=xml;
+	m_skipWhitespaceText=skipWhitespaceText;
+	m_event=XML_PULL_EVENT_NONE;
+	m_attrCount=0;
+	m_isEmptyElement=false;
+	m_errorCode=PIE_PARSE_WELFORMED;
+	m_errorPos=NULL;
+}
+
+XMLPullParser::~XMLPullParser()
+{
+}
+
+XMLPullEvent XMLPullParser::Next()
+{
+	if(m_event==XML_PULL_EVENT_END_DOCUMENT || m_event==XML_PULL_EVENT_ERROR)
+		return m_event;
+
+	m_attrCount=0;
+	m_value=XMLStringRef();
+	// the element is counted in the depth until its end tag is passed
+	if(m_event==XML_PULL_EVENT_END_ELEMENT)
+		m_openNames.pop_back();
+	if(m_event==XML_PULL_EVENT_START_ELEMENT && m_isEmptyElement)
+	{
+		// the name of the start tag is kept for the end
+		m_isEmptyElement=false;
+		m_event=XML_PULL_EVENT_END_ELEMENT;
+		return m_event;
+	}
+	m_isEmptyElement=false;
+	m_name=XMLStringRef();
+
+	while(true)
+	{
+		if(m_cur>=m_end)
+		{
+			if(!m_openNames.empty())
+				return setError(PIE_NOT_CLOSED,m_end);
+			m_event=XML_PULL_EVENT_END_DOCUMENT;
+			return m_event;
+		}
+
+		if(*m_cur==_T('<'))
+		{
+			XMLPullEvent event=readMarkup();
+			// nothing is reported for the declaration skipped
+			if(event==XML_PULL_EVENT_NONE)
+				continue;
+			m_event=event;
+			return m_event;
+		}
+
+		const TCHAR *textBegin=m_cur;
+		m_cur=findChar(m_cur,m_end,_T('<'));
+		if(m_skipWhitespaceText && skipSpace(textBegin,m_cur)==m_cur)
+			continue;
+		m_value.m_begin=textBegin;
+		m_value.m_length=m_cur-textBegin;
+		m_event=XML_PULL_EVENT_TEXT;
+		return m_event;
+	}
+}
+
+XMLPullEvent XMLPullParser::GetEvent() const
+{
+	return m_event;
+}
+
+const XMLStringRef &XMLPullParser::GetName() const
+{
+	return m_name;
+}
+
+const XMLStringRef &XMLPullParser::GetValue() const
+{
+	return m_value;
+}
+
+size_t XMLPullParser::GetAttrCount() const
+{
+	return m_attrCount;
+}
+
+const XMLPullAttr &XMLPullParser::GetAttr(size_t attrIdx) const
+{
+	EP_ASSERT(attrIdx<m_attrCount);
+	return m_attrs[attrIdx];
+}
+
+bool XMLPullParser::FindAttr(const TCHAR *name, XMLStringRef &retValue) const
+{
+	for(size_t attrTrav=0;attrTrav<m_attrCount;attrTrav++)
+	{
+		if(m_attrs[attrTrav].m_name.Equals(name))
+		{
+			retValue=m_attrs[attrTrav].m_value;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool XMLPullParser::IsEmptyElement() const
+{
+	return m_isEmptyElement;
+}
+
+size_t XMLPullParser::GetDepth() const
+{
+	return m_openNames.size();
+}
+
+PCODE XMLPullParser::GetErrorCode() const
+{
+	return m_errorCode;
+}
+
+size_t XMLPullParser::GetErrorOffset() const
+{
+	if(!m_errorPos)
+		return 0;
+	return m_errorPos-m_xml;
+}
+
+EpTString XMLPullParser::DecodeEntities(const XMLStringRef &raw)
+{
+	EpTString retString;
+	const TCHAR *cur=raw.m_begin;
+	const TCHAR *end=raw.m_begin+raw.m_length;
+	const TCHAR *amp=findChar(cur,end,_T('&'));
+	if(amp==end)
+		return raw.ToString();
+
+	retString.reserve(raw.m_length);
+	while(cur<end)
+	{
+		amp=findChar(cur,end,_T('&'));
+		retString.append(cur,amp-cur);
+		if(amp==end)
+			break;
+		const TCHAR *referenceEnd=(end-amp>XML_PULL_MAX_REFERENCE_LENGTH)?amp+XML_PULL_MAX_REFERENCE_LENGTH:end;
+		const TCHAR *semicolon=findChar(amp+1,referenceEnd,_T(';'));
+		unsigned int codePoint;
+		if(semicolon==referenceEnd || !decodeReference(amp+1,semicolon,codePoint))
+		{
+			// not the reference, so keep '&' as it is
+			retString.push_back(_T('&'));
+			cur=amp+1;
+			continue;
+		}
+		appendCodePoint(retString,codePoint);
+		cur=semicolon+1;
+	}
+	return retString;
+}
+
+bool XMLPullParser::ParseSax(const TCHAR *xml, size_t length, XMLSaxHandler *handler, bool skipWhitespaceText)
+{
+	EP_ASSERT(handler);
+	XMLPullParser parser(xml,length,skipWhitespaceText);
+	while(true)
+	{
+		bool isContinued=true;
+		switch(parser.Next())
+		{
+		case XML_PULL_EVENT_START_ELEMENT:
+			isContinued=handler->OnStartElement(parser);
+			break;
+		case XML_PULL_EVENT_END_ELEMENT:
+			isContinued=handler->OnEndElement(parser.GetName());
+			break;
+		case XML_PULL_EVENT_TEXT:
+			isContinued=handler->OnText(parser.GetValue(),false);
+			break;
+		case XML_PULL_EVENT_CDATA:
+			isContinued=handler->OnText(parser.GetValue(),true);
+			break;
+		case XML_PULL_EVENT_COMMENT:
+			isContinued=handler->OnComment(parser.GetValue());
+			break;
+		case XML_PULL_EVENT_PROCESSING_INSTRUCTION:
+			isContinued=handler->OnProcessingInstruction(parser.GetName(),parser.GetValue());
+			break;
+		case XML_PULL_EVENT_END_DOCUMENT:
+			return true;
+		case XML_PULL_EVENT_ERROR:
+			handler->OnError(parser.GetErrorCode(),parser.GetErrorOffset());
+			return false;
+		default:
+			break;
+		}
+		if(!isContinued)
+			return false;
+	}
+}
+
+XMLPullEvent XMLPullParser::readMarkup()
+{
+	const TCHAR *next=m_cur+1;
+	if(next<m_end && *next==_T('/'))
+		return readEndTag();
+	if(next<m_end && *next==_T('?'))
+	{
+		if(readEnclosed(XML_PULL_EVENT_PROCESSING_INSTRUCTION,2,_T("?>"))==XML_PULL_EVENT_ERROR)
+			return XML_PULL_EVENT_ERROR;
+		// split the target from the rest
+		const TCHAR *begin=m_value.m_begin;
+		const TCHAR *end=m_value.m_begin+m_value.m_length;
+		const TCHAR *targetEnd=begin;
+		while(targetEnd<end && !isXmlSpace(*targetEnd))
+			targetEnd++;
+		m_name.m_begin=begin;
+		m_name.m_length=targetEnd-begin;
+		m_value.m_begin=skipSpace(targetEnd,end);
+		m_value.m_length=end-m_value.m_begin;
+		return XML_PULL_EVENT_PROCESSING_INSTRUCTION;
+	}
+	if(startsWith(m_cur,m_end,_T("<!--"),4))
+		return readEnclosed(XML_PULL_EVENT_COMMENT,4,_T("-->"));
+	if(startsWith(m_cur,m_end,_T("<![CDATA["),9))
+		return readEnclosed(XML_PULL_EVENT_CDATA,9,_T("]]>"));
+	if(next<m_end && *next==_T('!'))
+	{
+		if(!skipDeclaration())
+			return setError(PIE_NOT_CLOSED,m_cur);
+		return XML_PULL_EVENT_NONE;
+	}
+	return readStartTag();
+}
+
+XMLPullEvent XMLPullParser::readStartTag()
+{
+	const TCHAR *cur=m_cur+1;
+	const TCHAR *nameBegin=cur;
+	while(cur<m_end && !isXmlSpace(*cur) && *cur!=_T('/') && *cur!=_T('>'))
+		cur++;
+	if(cur==nameBegin)
+		return setError(PIE_NOT_CLOSED,m_cur);
+	m_name.m_begin=nameBegin;
+	m_name.m_length=cur-nameBegin;
+
+	while(true)
+	{
+		cur=skipSpace(cur,m_end);
+		if(cur>=m_end)
+			return setError(PIE_NOT_CLOSED,m_cur);
+		if(*cur==_T('>'))
+		{
+			cur++;
+			break;
+		}
+		if(*cur==_T('/'))
+		{
+			if(cur+1>=m_end || cur[1]!=_T('>'))
+				return setError(PIE_ALONE_NOT_CLOSED,cur);
+			m_isEmptyElement=true;
+			cur+=2;
+			break;
+		}
+
+		const TCHAR *attrNameBegin=cur;
+		while(cur<m_end && !isXmlSpace(*cur) && *cur!=_T('=') && *cur!=_T('/') && *cur!=_T('>'))
+			cur++;
+		const TCHAR *attrNameEnd=cur;
+		cur=skipSpace(cur,m_end);
+		if(cur>=m_end || *cur!=_T('='))
+			return setError(PIE_ATTR_NO_VALUE,attrNameBegin);
+		cur=skipSpace(cur+1,m_end);
+		if(cur>=m_end)
+			return setError(PIE_ATTR_NO_VALUE,attrNameBegin);
+
+		const TCHAR *valueBegin;
+		const TCHAR *valueEnd;
+		if(*cur==_T('"') || *cur==_T('\''))
+		{
+			valueBegin=cur+1;
+			valueEnd=findChar(valueBegin,m_end,*cur);
+			if(valueEnd>=m_end)
+				return setError(PIE_NOT_CLOSED,attrNameBegin);
+			cur=valueEnd+1;
+		}
+		else
+		{
+			// the value without the quotation marks is accepted as the XMLite does, until the whitespace, '>' or "/>"
+			valueBegin=cur;
+			while(cur<m_end && !isXmlSpace(*cur) && *cur!=_T('>') && !(*cur==_T('/') && cur+1<m_end && cur[1]==_T('>')))
+				cur++;
+			valueEnd=cur;
+		}
+
+		if(m_attrCount==m_attrs.size())
+			m_attrs.push_back(XMLPullAttr());
+		XMLPullAttr &attr=m_attrs[m_attrCount++];
+		attr.m_name.m_begin=attrNameBegin;
+		attr.m_name.m_length=attrNameEnd-attrNameBegin;
+		attr.m_value.m_begin=valueBegin;
+		attr.m_value.m_length=valueEnd-valueBegin;
+	}
+
+	m_openNames.push_back(m_name);
+	m_cur=cur;
+	return XML_PULL_EVENT_START_ELEMENT;
+}
+
+XMLPullEvent XMLPullParser::readEndTag()
+{
+	const TCHAR *cur=m_cur+2;
+	const TCHAR *nameBegin=cur;
+	while(cur<m_end && !isXmlSpace(*cur) && *cur!=_T('>'))
+		cur++;
+	m_name.m_begin=nameBegin;
+	m_name.m_length=cur-nameBegin;
+	cur=skipSpace(cur,m_end);
+	if(cur>=m_end || *cur!=_T('>'))
+		return setError(PIE_NOT_CLOSED,m_cur);
+	if(m_openNames.empty() || !isSame(m_openNames.back(),m_name))
+		return setError(PIE_NOT_NESTED,m_cur);
+	m_cur=cur+1;
+	return XML_PULL_EVENT_END_ELEMENT;
+}
+
+XMLPullEvent XMLPullParser::readEnclosed(XMLPullEvent event, size_t openLength, const TCHAR *close)
+{
+	size_t closeLength=_tcslen(close);
+	const TCHAR *begin=m_cur+openLength;
+	const TCHAR *closeBegin=findString(begin,m_end,close,closeLength);
+	if(closeBegin>=m_end)
+		return setError(PIE_NOT_CLOSED,m_cur);
+	m_value.m_begin=begin;
+	m_value.m_length=closeBegin-begin;
+	m_cur=closeBegin+closeLength;
+	return event;
+}
+
+bool XMLPullParser::skipDeclaration()
+{
+	int bracketDepth=0;
+	TCHAR quote=_T('\0');
+	for(const TCHAR *cur=m_cur+2;cur<m_end;cur++)
+	{
+		if(quote)
+		{
+			if(*cur==quote)
+				quote=_T('\0');
+		}
+		else if(*cur==_T('"') || *cur==_T('\''))
+			quote=*cur;
+		else if(*cur==_T('['))
+			bracketDepth++;
+		else if(*cur==_T(']'))
+			bracketDepth--;
+		else if(*cur==_T('>') && bracketDepth<=0)
+		{
+			m_cur=cur+1;
+			return true;
+		}
+	}
+	return false;
+}
+
+XMLPullEvent XMLPullParser::setError(PCODE errorCode, const TCHAR *errorPos)
+{
+	m_errorCode=errorCode;
+	m_errorPos=errorPos;
+	m_event=XML_PULL_EVENT_ERROR;
+	return m_event;
+}
@@ -0,0 +1,411 @@
+/*! 
+XMLStreamWriter for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epXMLStreamWriter.h"
+#include "epUnicodeHelper.h"
+
+#if _MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#include <emmintrin.h>
+#define EP_XML_WRITER_SSE2
+#endif //_MSC_VER>=MSVC90 && (defined(_M_IX86) || defined(_M_X64))
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+/// the maximum number of the entities compared at once by the SIMD scan
+#define XML_WRITER_SIMD_ENTITY_COUNT 8
+
+/// the maximum number of the tabs written from the table at once
+#define XML_WRITER_TAB_TABLE_SIZE 32
+
+/// the new line followed by the tabs, whose prefix is written for the indentation
+static const TCHAR s_newLineTabs[]=_T("\r\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t");
+
+static const TCHAR szXMLPIOpen[] = _T("<?");
+static const TCHAR szXMLPIClose[] = _T("?>");
+static const TCHAR szXMLCommentOpen[] = _T("<!--");
+static const TCHAR szXMLCommentClose[] = _T("-->");
+static const TCHAR szXMLCDATAOpen[] = _T("<![CDATA[");
+static const TCHAR szXMLCDATAClose[] = _T("]]>");
+
+#if defined(EP_XML_WRITER_SSE2)
+/*!
+Return the flag whether the processor supports SSE2.
+@return true if supported, otherwise false.
+*/
+static bool hasSSE2()
+{
+#if defined(_M_X64)
+	return true;
+#else //defined(_M_X64)
+	static volatile int s_hasSSE2=-1;
+	if(s_hasSSE2<0)
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo,1);
+		s_hasSSE2=(cpuInfo[3]&(1<<26))?1:0;
+	}
+	return s_hasSSE2==1;
+#endif //defined(_M_X64)
+}
+
+/*!
+Find the first character of the given entities in the whole 16 byte blocks.
+@param[in] str the characters to scan.
+@param[in] length the number of the characters.
+@param[in] entityChars the characters of the entities.
+@param[in] entityCount the number of the entities.
+@return the index of the character found, or the number of the characters in the whole blocks if not found.
+*/
+static size_t findEntitySSE2(const TCHAR *str, size_t length, const TCHAR *entityChars, size_t entityCount)
+{
+	const size_t blockLength=16/sizeof(TCHAR);
+	__m128i entityVecs[XML_WRITER_SIMD_ENTITY_COUNT];
+	for(size_t entityTrav=0;entityTrav<entityCount;entityTrav++)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		entityVecs[entityTrav]=_mm_set1_epi16(static_cast<short>(entityChars[entityTrav]));
+#else //defined(_UNICODE) || defined(UNICODE)
+		entityVecs[entityTrav]=_mm_set1_epi8(entityChars[entityTrav]);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+
+	size_t charTrav=0;
+	while(charTrav+blockLength<=length)
+	{
+		__m128i chars=_mm_loadu_si128(reinterpret_cast<const __m128i*>(str+charTrav));
+		__m128i matched=_mm_setzero_si128();
+		for(size_t entityTrav=0;entityTrav<entityCount;entityTrav++)
+		{
+#if defined(_UNICODE) || defined(UNICODE)
+			matched=_mm_or_si128(matched,_mm_cmpeq_epi16(chars,entityVecs[entityTrav]));
+#else //defined(_UNICODE) || defined(UNICODE)
+			matched=_mm_or_si128(matched,_mm_cmpeq_epi8(chars,entityVecs[entityTrav]));
+#endif //defined(_UNICODE) || defined(UNICODE)
+		}
+		int mask=_mm_movemask_epi8(matched);
+		if(mask)
+		{
+			unsigned long bitIdx;
+			_BitScanForward(&bitIdx,static_cast<unsigned long>(mask));
+			return charTrav+bitIdx/sizeof(TCHAR);
+		}
+		charTrav+=blockLength;
+	}
+	return charTrav;
+}
+#endif //defined(EP_XML_WRITER_SSE2)
+
+/*!
+Find the first character of the given entities.
+@param[in] str the characters to scan.
+@param[in] length the number of the characters.
+@param[in] entityChars the characters of the entities.
+@param[in] entityCount the number of the entities.
+@return the index of the character found, or the number of the characters if not found.
+*/
+static size_t findEntity(const TCHAR *str, size_t length, const TCHAR *entityChars, size_t entityCount)
+{
+	size_t charTrav=0;
+#if defined(EP_XML_WRITER_SSE2)
+	if(hasSSE2())
+		charTrav=findEntitySSE2(str,length,entityChars,entityCount);
+#endif //defined(EP_XML_WRITER_SSE2)
+	for(;charTrav<length;charTrav++)
+	{
+		for(size_t entityTrav=0;entityTrav<entityCount;entityTrav++)
+		{
+			if(str[charTrav]==entityChars[entityTrav])
+				return charTrav;
+		}
+	}
+	return length;
+}
+
+XMLStreamWriter::XMLStreamWriter(Stream *stream, FileEncodingType encodingType, size_t bufferSize)
+{
+	EP_ASSERT_EXPR(bufferSize>1,_T("The buffer size must be greater than 1."));
+	m_stream=stream;
+	m_encodingType=encodingType;
+	m_buffer.resize(bufferSize);
+	m_count=0;
+	m_flushedCount=0;
+}
+
+XMLStreamWriter::~XMLStreamWriter()
+{
+	Flush();
+}
+
+void XMLStreamWriter::WriteNode(LPXNode node, LPDISP_OPT opt)
+{
+	if(!node)
+		return;
+	if(!opt)
+		opt=&DISP_OPT::optDefault;
+	writeNode(node,opt,opt->m_tab_base);
+}
+
+void XMLStreamWriter::Write(const TCHAR *str, size_t length)
+{
+	while(length)
+	{
+		if(m_count==m_buffer.size())
+			flushBuffer(true);
+		size_t copyLength=m_buffer.size()-m_count;
+		if(copyLength>length)
+			copyLength=length;
+		System::Memcpy(&m_buffer[m_count],str,copyLength*sizeof(TCHAR));
+		m_count+=copyLength;
+		str+=copyLength;
+		length-=copyLength;
+	}
+}
+
+void XMLStreamWriter::Write(const TCHAR *str)
+{
+	if(str)
+		Write(str,_tcslen(str));
+}
+
+void XMLStreamWriter::WriteChar(TCHAR ch)
+{
+	if(m_count==m_buffer.size())
+		flushBuffer(true);
+	m_buffer[m_count++]=ch;
+}
+
+void XMLStreamWriter::WriteEscaped(const TCHAR *str, size_t length, LPXENTITYS entitys)
+{
+	if(!entitys || entitys->empty())
+	{
+		Write(str,length);
+		return;
+	}
+	if(entitys->size()>XML_WRITER_SIMD_ENTITY_COUNT)
+	{
+		for(size_t charTrav=0;charTrav<length;charTrav++)
+		{
+			LPXENTITY entity=entitys->GetEntity(str[charTrav]);
+			if(entity)
+				Write(entity->m_ref);
+			else
+				WriteChar(str[charTrav]);
+		}
+		return;
+	}
+
+	TCHAR entityChars[XML_WRITER_SIMD_ENTITY_COUNT];
+	size_t entityCount=entitys->size();
+	for(size_t entityTrav=0;entityTrav<entityCount;entityTrav++)
+		entityChars[entityTrav]=entitys->at(entityTrav).m_entity;
+
+	size_t startIdx=0;
+	while(startIdx<length)
+	{
+		size_t foundIdx=startIdx+findEntity(str+startIdx,length-startIdx,entityChars,entityCount);
+		Write(str+startIdx,foundIdx-startIdx);
+		if(foundIdx==length)
+			break;
+		Write(entitys->GetEntity(str[foundIdx])->m_ref);
+		startIdx=foundIdx+1;
+	}
+}
+
+void XMLStreamWriter::WriteNewLine(int tabCount)
+{
+	if(tabCount<0)
+		tabCount=0;
+	size_t tableCount=tabCount<XML_WRITER_TAB_TABLE_SIZE?tabCount:XML_WRITER_TAB_TABLE_SIZE;
+	Write(s_newLineTabs,2+tableCount);
+	tabCount-=static_cast<int>(tableCount);
+	while(tabCount>0)
+	{
+		tableCount=tabCount<XML_WRITER_TAB_TABLE_SIZE?tabCount:XML_WRITER_TAB_TABLE_SIZE;
+		Write(s_newLineTabs+2,tableCount);
+		tabCount-=static_cast<int>(tableCount);
+	}
+}
+
+void XMLStreamWriter::Flush()
+{
+	flushBuffer(false);
+}
+
+size_t XMLStreamWriter::GetWrittenCount() const
+{
+	return m_flushedCount+m_count;
+}
+
+void XMLStreamWriter::flushChars(const TCHAR *chars, size_t count)
+{
+	if(!m_stream || !count)
+		return;
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF8)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		if(m_encodeBuffer.size()<count*3)
+			m_encodeBuffer.resize(count*3);
+		size_t byteSize=UnicodeHelper::Utf16ToUtf8(chars,count,&m_encodeBuffer[0]);
+#else //defined(_UNICODE) || defined(UNICODE)
+		EpWString wideChars=System::MultiByteToWideChar(chars,static_cast<int>(count));
+		if(wideChars.empty())
+			return;
+		if(m_encodeBuffer.size()<wideChars.size()*3)
+			m_encodeBuffer.resize(wideChars.size()*3);
+		size_t byteSize=UnicodeHelper::Utf16ToUtf8(wideChars.c_str(),wideChars.size(),&m_encodeBuffer[0]);
+#endif //defined(_UNICODE) || defined(UNICODE)
+		m_stream->WriteBytes(reinterpret_cast<const unsigned char*>(&m_encodeBuffer[0]),byteSize);
+	}
+	else if(m_encodingType==FILE_ENCODING_TYPE_ANSI)
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		EpString multiByteChars=System::WideCharToMultiByte(chars,static_cast<int>(count));
+		m_stream->WriteBytes(reinterpret_cast<const unsigned char*>(multiByteChars.c_str()),multiByteChars.size());
+#else //defined(_UNICODE) || defined(UNICODE)
+		m_stream->WriteBytes(reinterpret_cast<const unsigned char*>(chars),count);
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+	else
+	{
+#if defined(_UNICODE) || defined(UNICODE)
+		m_stream->WriteBytes(reinterpret_cast<const unsigned char*>(chars),count*sizeof(wchar_t));
+#else //defined(_UNICODE) || defined(UNICODE)
+		EpWString wideChars=System::MultiByteToWideChar(chars,static_cast<int>(count));
+		m_stream->WriteBytes(reinterpret_cast<const unsigned char*>(wideChars.c_str()),wideChars.size()*sizeof(wchar_t));
+#endif //defined(_UNICODE) || defined(UNICODE)
+	}
+}
+
+void XMLStreamWriter::flushBuffer(bool keepHighSurrogate)
+{
+	if(!m_count)
+		return;
+	size_t flushCount=m_count;
+#if defined(_UNICODE) || defined(UNICODE)
+	// keep the high surrogate for its pair written next, so the pair is not split over two flushes
+	if(keepHighSurrogate && m_count>1 && m_buffer[m_count-1]>=0xD800 && m_buffer[m_count-1]<=0xDBFF)
+		flushCount--;
+#endif //defined(_UNICODE) || defined(UNICODE)
+	flushChars(&m_buffer[0],flushCount);
+	m_flushedCount+=flushCount;
+	m_count-=flushCount;
+	if(m_count)
+		m_buffer[0]=m_buffer[flushCount];
+}
+
+void XMLStreamWriter::writeNode(LPXNode node, LPDISP_OPT opt, int tabBase)
+{
+	bool isNewLine=opt->m_newline;
+	if(isNewLine)
+		WriteNewLine(tabBase);
+
+	switch(node->m_type)
+	{
+	case XNODE_DOC:
+		for(size_t childTrav=0;childTrav<node->m_childs.size();childTrav++)
+			writeNode(node->m_childs[childTrav],opt,tabBase);
+		return;
+	case XNODE_PI:
+		Write(szXMLPIOpen,sizeof(szXMLPIOpen)/sizeof(TCHAR)-1);
+		Write(node->m_name,node->m_name.GetLength());
+		if(!node->m_attrs.empty())
+			WriteChar(_T(' '));
+		for(size_t attrTrav=0;attrTrav<node->m_attrs.size();attrTrav++)
+			writeAttr(node->m_attrs[attrTrav],opt);
+		Write(szXMLPIClose,sizeof(szXMLPIClose)/sizeof(TCHAR)-1);
+		return;
+	case XNODE_COMMENT:
+		Write(szXMLCommentOpen,sizeof(szXMLCommentOpen)/sizeof(TCHAR)-1);
+		Write(node->m_value,node->m_value.GetLength());
+		Write(szXMLCommentClose,sizeof(szXMLCommentClose)/sizeof(TCHAR)-1);
+		return;
+	case XNODE_CDATA:
+		Write(szXMLCDATAOpen,sizeof(szXMLCDATAOpen)/sizeof(TCHAR)-1);
+		Write(node->m_value,node->m_value.GetLength());
+		Write(szXMLCDATAClose,sizeof(szXMLCDATAClose)/sizeof(TCHAR)-1);
+		return;
+	default:
+		break;
+	}
+
+	// <TAG Attr1="Val1" 
+	WriteChar(_T('<'));
+	Write(node->m_name,node->m_name.GetLength());
+	if(!node->m_attrs.empty())
+		WriteChar(_T(' '));
+	for(size_t attrTrav=0;attrTrav<node->m_attrs.size();attrTrav++)
+		writeAttr(node->m_attrs[attrTrav],opt);
+
+	if(node->m_childs.empty() && node->m_value.IsEmpty())
+	{
+		Write(_T("/>"),2);
+		return;
+	}
+
+	// as XNode::GetXML, the children, the text value and the close tag are indented one more than the node
+	WriteChar(_T('>'));
+	bool isIndented=isNewLine && !node->m_childs.empty();
+	int childTabBase=isIndented?tabBase+1:tabBase;
+	for(size_t childTrav=0;childTrav<node->m_childs.size();childTrav++)
+		writeNode(node->m_childs[childTrav],opt,childTabBase);
+
+	if(!node->m_value.IsEmpty())
+	{
+		if(isIndented)
+			WriteNewLine(childTabBase);
+		writeValue(node->m_value,opt);
+	}
+
+	if(isIndented)
+		WriteNewLine(childTabBase-1);
+	Write(_T("</"),2);
+	Write(node->m_name,node->m_name.GetLength());
+	WriteChar(_T('>'));
+}
+
+void XMLStreamWriter::writeAttr(LPXAttr attr, LPDISP_OPT opt)
+{
+	Write(attr->m_name,attr->m_name.GetLength());
+	WriteChar(_T('='));
+	WriteChar(opt->m_value_quotation_mark);
+	writeValue(attr->m_value,opt);
+	WriteChar(opt->m_value_quotation_mark);
+	WriteChar(_T(' '));
+}
+
+void XMLStreamWriter::writeValue(const CString &value, LPDISP_OPT opt)
+{
+	if(opt->m_reference_value && opt->m_entitys)
+		WriteEscaped(value,value.GetLength(),opt->m_entitys);
+	else
+		Write(value,value.GetLength());
+}
@@ -0,0 +1,318 @@
+/*! 
+XMLViewDocument for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epXMLView.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+EpTString _xmlViewAttr::GetValue() const
+{
+	return XMLPullParser::DecodeEntities(m_value);
+}
+
+XMLViewNode::XMLViewNode()
+{
+	m_type=XNODE_ELEMENT;
+	m_parent=NULL;
+	m_firstChild=NULL;
+	m_lastChild=NULL;
+	m_nextSibling=NULL;
+	m_childCount=0;
+	m_attrs=NULL;
+	m_attrCount=0;
+}
+
+NODE_TYPE XMLViewNode::GetType() const
+{
+	return m_type;
+}
+
+const XMLStringRef &XMLViewNode::GetName() const
+{
+	return m_name;
+}
+
+const XMLStringRef &XMLViewNode::GetRawValue() const
+{
+	return m_value;
+}
+
+EpTString XMLViewNode::GetValue() const
+{
+	if(m_type==XNODE_ELEMENT)
+		return XMLPullParser::DecodeEntities(m_value);
+	return m_value.ToString();
+}
+
+XMLViewNode *XMLViewNode::GetParent() const
+{
+	return m_parent;
+}
+
+XMLViewNode *XMLViewNode::GetFirstChild() const
+{
+	return m_firstChild;
+}
+
+XMLViewNode *XMLViewNode::GetNextSibling() const
+{
+	return m_nextSibling;
+}
+
+size_t XMLViewNode::GetChildCount() const
+{
+	return m_childCount;
+}
+
+XMLViewNode *XMLViewNode::GetChild(size_t childIdx) const
+{
+	if(childIdx>=m_childCount)
+		return NULL;
+	XMLViewNode *child=m_firstChild;
+	for(size_t childTrav=0;childTrav<childIdx;childTrav++)
+		child=child->m_nextSibling;
+	return child;
+}
+
+XMLViewNode *XMLViewNode::GetChild(const TCHAR *name) const
+{
+	for(XMLViewNode *child=m_firstChild;child;child=child->m_nextSibling)
+	{
+		if(child->m_type==XNODE_ELEMENT && child->m_name.Equals(name))
+			return child;
+	}
+	return NULL;
+}
+
+EpTString XMLViewNode::GetChildValue(const TCHAR *name) const
+{
+	XMLViewNode *child=GetChild(name);
+	if(child)
+		return child->GetValue();
+	return EpTString();
+}
+
+size_t XMLViewNode::GetAttrCount() const
+{
+	return m_attrCount;
+}
+
+const XMLViewAttr *XMLViewNode::GetAttr(size_t attrIdx) const
+{
+	if(attrIdx>=m_attrCount)
+		return NULL;
+	return m_attrs+attrIdx;
+}
+
+const XMLViewAttr *XMLViewNode::GetAttr(const TCHAR *attrName) const
+{
+	for(size_t attrTrav=0;attrTrav<m_attrCount;attrTrav++)
+	{
+		if(m_attrs[attrTrav].m_name.Equals(attrName))
+			return m_attrs+attrTrav;
+	}
+	return NULL;
+}
+
+EpTString XMLViewNode::GetAttrValue(const TCHAR *attrName) const
+{
+	const XMLViewAttr *attr=GetAttr(attrName);
+	if(attr)
+		return attr->GetValue();
+	return EpTString();
+}
+
+const XMLViewAttr *XMLViewNode::GetChildAttr(const TCHAR *name, const TCHAR *attrName) const
+{
+	XMLViewNode *child=GetChild(name);
+	if(child)
+		return child->GetAttr(attrName);
+	return NULL;
+}
+
+EpTString XMLViewNode::GetChildAttrValue(const TCHAR *name, const TCHAR *attrName) const
+{
+	const XMLViewAttr *attr=GetChildAttr(name,attrName);
+	if(attr)
+		return attr->GetValue();
+	return EpTString();
+}
+
+XMLViewNode *XMLViewNode::Find(const TCHAR *name) const
+{
+	// walk the descendants in the depth-first order without the recursion
+	const XMLViewNode *node=m_firstChild;
+	while(node)
+	{
+		if(node->m_type==XNODE_ELEMENT && node->m_name.Equals(name))
+			return const_cast<XMLViewNode*>(node);
+		if(node->m_firstChild)
+		{
+			node=node->m_firstChild;
+			continue;
+		}
+		while(node!=this && !node->m_nextSibling)
+			node=node->m_parent;
+		if(node==this)
+			break;
+		node=node->m_nextSibling;
+	}
+	return NULL;
+}
+
+
+XMLViewDocument::XMLViewDocument(size_t arenaBlockSize):m_arena(arenaBlockSize,LOCK_POLICY_NONE)
+{
+	m_docNode.m_type=XNODE_DOC;
+	m_nodeCount=0;
+	m_errorCode=PIE_PARSE_WELFORMED;
+	m_errorOffset=0;
+}
+
+XMLViewDocument::~XMLViewDocument()
+{
+	m_arena.Release();
+}
+
+bool XMLViewDocument::Load(const TCHAR *xml, size_t length, bool skipWhitespaceText)
+{
+	Clear();
+	XMLPullParser parser(xml,length,skipWhitespaceText);
+	XMLViewNode *current=&m_docNode;
+	XMLViewNode *node;
+	while(true)
+	{
+		switch(parser.Next())
+		{
+		case XML_PULL_EVENT_START_ELEMENT:
+			node=newNode(XNODE_ELEMENT,current);
+			node->m_name=parser.GetName();
+			node->m_attrCount=parser.GetAttrCount();
+			if(node->m_attrCount)
+			{
+				node->m_attrs=reinterpret_cast<XMLViewAttr*>(m_arena.Allocate(sizeof(XMLViewAttr)*node->m_attrCount,__alignof(XMLViewAttr)));
+				for(size_t attrTrav=0;attrTrav<node->m_attrCount;attrTrav++)
+				{
+					XMLViewAttr *attr=::new(node->m_attrs+attrTrav) XMLViewAttr();
+					attr->m_name=parser.GetAttr(attrTrav).m_name;
+					attr->m_value=parser.GetAttr(attrTrav).m_value;
+				}
+			}
+			current=node;
+			break;
+		case XML_PULL_EVENT_END_ELEMENT:
+			current=current->m_parent;
+			break;
+		case XML_PULL_EVENT_TEXT:
+			// as XNode, the first text is the value of the element
+			if(current!=&m_docNode && current->m_value.m_length==0)
+				current->m_value=parser.GetValue();
+			break;
+		case XML_PULL_EVENT_CDATA:
+			node=newNode(XNODE_CDATA,current);
+			node->m_value=parser.GetValue();
+			break;
+		case XML_PULL_EVENT_COMMENT:
+			node=newNode(XNODE_COMMENT,current);
+			node->m_value=parser.GetValue();
+			break;
+		case XML_PULL_EVENT_PROCESSING_INSTRUCTION:
+			node=newNode(XNODE_PI,current);
+			node->m_name=parser.GetName();
+			node->m_value=parser.GetValue();
+			break;
+		case XML_PULL_EVENT_END_DOCUMENT:
+			return true;
+		default:
+			Clear();
+			m_errorCode=parser.GetErrorCode();
+			m_errorOffset=parser.GetErrorOffset();
+			return false;
+		}
+	}
+}
+
+void XMLViewDocument::Clear()
+{
+	// the nodes and the attributes have no destructor to call, so the blocks are just rewound.
+	m_arena.Reset();
+	m_docNode.m_firstChild=NULL;
+	m_docNode.m_lastChild=NULL;
+	m_docNode.m_childCount=0;
+	m_nodeCount=0;
+	m_errorCode=PIE_PARSE_WELFORMED;
+	m_errorOffset=0;
+}
+
+XMLViewNode *XMLViewDocument::GetDocumentNode()
+{
+	return &m_docNode;
+}
+
+XMLViewNode *XMLViewDocument::GetRoot() const
+{
+	for(XMLViewNode *child=m_docNode.m_firstChild;child;child=child->m_nextSibling)
+	{
+		if(child->m_type==XNODE_ELEMENT)
+			return child;
+	}
+	return NULL;
+}
+
+size_t XMLViewDocument::GetNodeCount() const
+{
+	return m_nodeCount;
+}
+
+PCODE XMLViewDocument::GetErrorCode() const
+{
+	return m_errorCode;
+}
+
+size_t XMLViewDocument::GetErrorOffset() const
+{
+	return m_errorOffset;
+}
+
+XMLViewNode *XMLViewDocument::newNode(NODE_TYPE type, XMLViewNode *parent)
+{
+	XMLViewNode *node=::new(m_arena.Allocate(sizeof(XMLViewNode),__alignof(XMLViewNode))) XMLViewNode();
+	node->m_type=type;
+	node->m_parent=parent;
+	if(parent->m_lastChild)
+		parent->m_lastChild->m_nextSibling=node;
+	else
+		parent->m_firstChild=node;
+	parent->m_lastChild=node;
+	parent->m_childCount++;
+	m_nodeCount++;
+	return node;
+}
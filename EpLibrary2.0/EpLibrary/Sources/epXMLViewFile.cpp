@@ -0,0 +1,85 @@
+/*! 
+XMLViewFile for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epXMLViewFile.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+XMLViewFile::XMLViewFile(FileEncodingType encodingType, LockPolicy lockPolicyType) :BaseTextFile(encodingType,lockPolicyType)
+{
+}
+
+XMLViewFile::~XMLViewFile()
+{
+}
+
+XMLViewDocument &XMLViewFile::GetDocument()
+{
+	return m_document;
+}
+
+XMLViewNode *XMLViewFile::GetRoot() const
+{
+	LockObj lock(m_baseTextLock);
+	return m_document.GetRoot();
+}
+
+void XMLViewFile::writeLoop()
+{
+	writeToFile(m_buffer.c_str());
+}
+
+void XMLViewFile::loadFromFile(const EpTString &lines)
+{
+	m_buffer=lines;
+	m_document.Load(m_buffer.c_str(),m_buffer.length());
+}
+
+void XMLViewFile::loadFromReader(TextLineReader &reader)
+{
+	// read into the buffer kept, so the nodes refer to it without another copy
+	m_document.Clear();
+	m_buffer.clear();
+	if(m_encodingType==FILE_ENCODING_TYPE_UTF16LE)
+		m_buffer.reserve(static_cast<size_t>(reader.GetFileSize()/sizeof(wchar_t)));
+	else
+		m_buffer.reserve(static_cast<size_t>(reader.GetFileSize()));
+	const TCHAR *line;
+	size_t lineLength;
+	bool hasNewLine;
+	while(reader.ReadLine(line,lineLength,&hasNewLine))
+	{
+		m_buffer.append(line,lineLength);
+		if(hasNewLine)
+			m_buffer.append(_T("\n"));
+	}
+	m_document.Load(m_buffer.c_str(),m_buffer.length());
+}
@@ -32,6 +32,7 @@ Copyright (c) 2002 Cho,Kyung Min <bro@shinbiro.com>
 Please refer to <http://www.codeproject.com/Articles/3426/XMLite-simple-XML-parser> for the license.
 */
 #include "epXMLite.h"
+#include "epHashMap.h"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -332,15 +333,131 @@ void _SetString( LPTSTR psz, LPTSTR end, CString* ps, bool trim = FALSE, int esc
 	}
 	else
 	{
-		LPTSTR pss = EP_NEW TCHAR[len+1];
-		System::Memset(pss,0,sizeof(TCHAR)*(len+1));
-		memcpy( pss, psz, len * sizeof(TCHAR) );
-		pss[len] = _T('\0');
-		*ps=pss;
-		EP_DELETE[] pss;
+		// copy into the buffer of the string without the temporary buffer
+		memcpy( ps->GetBufferSetLength( len ), psz, len * sizeof(TCHAR) );
+		ps->ReleaseBuffer( len );
 	}
 }
 
+//========================================================
+// Name   : _SetName
+// Desc   : put name of (psz~end) on ps string, 
+//          interned by the name pool of document if any
+// Param  : doc - document of the node, or NULL
+// Return : 
+//========================================================
+static void _SetName( LPXDoc doc, LPTSTR psz, LPTSTR end, CString* ps )
+{
+	if( doc && doc->m_namePool && psz && end > psz )
+		*ps = doc->m_namePool->Intern( psz, static_cast<int>(end - psz) );
+	else
+		_SetString( psz, end, ps );
+}
+
+//========================================================
+// Name   : Intern
+// Desc   : find the name in the pool, or add it
+// Param  : psz - first character of the name
+//          len - length of the name
+// Return : string sharing the buffer with the same names
+//========================================================
+CString _tagXMLNamePool::Intern( const TCHAR * psz, int len )
+{
+	if( len <= 0 )
+		return CString();
+
+	// keep the slots at most half full
+	if( ( m_count + 1 ) * 2 > m_names.size() )
+	{
+		size_t size = m_names.empty() ? 64 : m_names.size() * 2;
+		std::vector<CString> names( size );
+		std::vector<size_t> hashes( size );
+		for( size_t i = 0; i < m_names.size(); i++ )
+		{
+			if( m_names[i].IsEmpty() )
+				continue;
+			size_t slot = m_hashes[i] & ( size - 1 );
+			while( !names[slot].IsEmpty() )
+				slot = ( slot + 1 ) & ( size - 1 );
+			names[slot] = m_names[i];
+			hashes[slot] = m_hashes[i];
+		}
+		m_names.swap( names );
+		m_hashes.swap( hashes );
+	}
+
+	size_t hash = HashBytes( psz, len * sizeof(TCHAR) );
+	size_t mask = m_names.size() - 1;
+	size_t slot = hash & mask;
+	while( !m_names[slot].IsEmpty() )
+	{
+		if( m_hashes[slot] == hash && m_names[slot].GetLength() == len && memcmp( (const TCHAR *)m_names[slot], psz, len * sizeof(TCHAR) ) == 0 )
+			return m_names[slot];
+		slot = ( slot + 1 ) & mask;
+	}
+	m_names[slot] = CString( psz, len );
+	m_hashes[slot] = hash;
+	m_count++;
+	return m_names[slot];
+}
+
+void _tagXMLNamePool::Clear()
+{
+	m_names.clear();
+	m_hashes.clear();
+	m_count = 0;
+}
+
+//========================================================
+// Name   : _NewNode, _NewAttr
+// Desc   : allocate node/attribute from the arena of document
+// Param  : doc - document of the parent, or NULL
+// Return : new node/attribute
+//========================================================
+static LPXNode _NewNode( LPXDoc doc )
+{
+	if( doc && doc->m_nodeArena )
+	{
+		LPXNode node = ::new( doc->m_nodeArena->Allocate( sizeof(XNode), __alignof(XNode) ) ) XNode;
+		node->m_arena = doc->m_nodeArena;
+		return node;
+	}
+	return EP_NEW XNode;
+}
+
+static LPXAttr _NewAttr( LPXDoc doc )
+{
+	if( doc && doc->m_nodeArena )
+	{
+		LPXAttr attr = ::new( doc->m_nodeArena->Allocate( sizeof(XAttr), __alignof(XAttr) ) ) XAttr;
+		attr->m_arena = doc->m_nodeArena;
+		return attr;
+	}
+	return EP_NEW XAttr;
+}
+
+//========================================================
+// Name   : _DeleteNode, _DeleteAttr
+// Desc   : destroy node/attribute, and free unless from the arena
+// Param  : node/attribute to delete
+// Return : 
+//========================================================
+static void _DeleteNode( LPXNode node )
+{
+	if( node->m_arena )
+		node->~XNode();
+	else
+		EP_DELETE node;
+}
+
+static void _DeleteAttr( LPXAttr attr )
+{
+	if( attr->m_arena )
+		attr->~XAttr();
+	else
+		EP_DELETE attr;
+}
+
 _tagXMLNode::~_tagXMLNode()
 {
 	Close();
@@ -354,7 +471,7 @@ void _tagXMLNode::Close()
 		LPXNode p = m_childs[i];
 		if( p )
 		{
-			EP_DELETE p; m_childs[i] = NULL;
+			_DeleteNode( p ); m_childs[i] = NULL;
 		}
 	}
 	m_childs.clear();
@@ -364,7 +481,7 @@ void _tagXMLNode::Close()
 		LPXAttr p = m_attrs[i];
 		if( p )
 		{
-			EP_DELETE p; m_attrs[i] = NULL;
+			_DeleteAttr( p ); m_attrs[i] = NULL;
 		}
 	}
 	m_attrs.clear();
@@ -410,11 +527,11 @@ LPTSTR _tagXMLNode::LoadAttributes( const TCHAR * pszAttrs ,LPVALUEPARSEINFO vpi
 				return NULL;
 			}
 			
-			LPXAttr attr = EP_NEW XAttr;
+			LPXAttr attr = _NewAttr( m_doc );
 			attr->m_parent = this;
 
 			// XML Attr Name
-			_SetString( xml, pEnd, &attr->m_name );
+			_SetName( m_doc, xml, pEnd, &attr->m_name );
 			
 			// add new attribute
 			m_attrs.push_back( attr );
@@ -501,11 +618,11 @@ LPTSTR _tagXMLNode::LoadAttributes( const TCHAR * pszAttrs, const TCHAR * pszEnd
 				return NULL;
 			}
 			
-			LPXAttr attr = EP_NEW XAttr;
+			LPXAttr attr = _NewAttr( m_doc );
 			attr->m_parent = this;
 
 			// XML Attr Name
-			_SetString( xml, pEnd, &attr->m_name );
+			_SetName( m_doc, xml, pEnd, &attr->m_name );
 			
 			// add new attribute
 			m_attrs.push_back( attr );
@@ -575,14 +692,14 @@ LPTSTR _tagXMLNode::LoadProcessingInstrunction( const TCHAR * pszXml,LPVALUEPARS
 	{
 		LPTSTR xml = (LPTSTR)pszXml;
 
-		LPXNode node = EP_NEW XNode;
+		LPXNode node = _NewNode( m_doc );
 		node->m_parent = this;
 		node->m_doc = m_doc;
 		node->m_type = XNODE_PI;
 		
 		xml += sizeof(szXMLPIOpen)/sizeof(TCHAR)-1;
 		TCHAR* pTagEnd = _tcspbrk( xml, _T(" ?>") );
-		_SetString( xml, pTagEnd, &node->m_name );
+		_SetName( m_doc, xml, pTagEnd, &node->m_name );
 		xml = pTagEnd;
 		
 		node->LoadAttributes( xml, end, vpi, pi);
@@ -622,7 +739,7 @@ LPTSTR _tagXMLNode::LoadComment( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*=
 		LPTSTR xml = (LPTSTR)pszXml;
 		xml += sizeof(szXMLCommentOpen)/sizeof(TCHAR)-1;
 		
-		LPXNode node = EP_NEW XNode;
+		LPXNode node = _NewNode( m_doc );
 		node->m_parent = this;
 		node->m_doc = m_doc;
 		node->m_type = XNODE_COMMENT;
@@ -664,7 +781,7 @@ LPTSTR _tagXMLNode::LoadCDATA( const TCHAR * pszXml,LPVALUEPARSEINFO vpi /*= &vp
 		LPTSTR xml = (LPTSTR)pszXml;
 		xml += sizeof(szXMLCDATAOpen)/sizeof(TCHAR)-1;
 		
-		LPXNode node = EP_NEW XNode;
+		LPXNode node = _NewNode( m_doc );
 		node->m_parent = this;
 		node->m_doc = m_doc;
 		node->m_type = XNODE_CDATA;
@@ -804,7 +921,7 @@ LPTSTR _tagXMLNode::Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*= &vpiDef
 	// XML Node Tag Name Open
 	xml++;
 	TCHAR* pTagEnd = _tcspbrk( xml, _T(" />\t\r\n") );
-	_SetString( xml, pTagEnd, &m_name );
+	_SetName( m_doc, xml, pTagEnd, &m_name );
 	xml = pTagEnd;
 	// Generate XML Attributte List
 	if( xml = LoadAttributes( xml, vpi, pi ) )
@@ -867,7 +984,7 @@ LPTSTR _tagXMLNode::Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*= &vpiDef
 			// generate child nodes
 			while( xml && *xml )
 			{
-				LPXNode node = EP_NEW XNode;
+				LPXNode node = _NewNode( m_doc );
 				node->m_parent = this;
 				node->m_doc = m_doc;
 				node->m_type = m_type;
@@ -880,7 +997,7 @@ LPTSTR _tagXMLNode::Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*= &vpiDef
 				}
 				else
 				{
-					EP_DELETE node;
+					_DeleteNode( node );
 				}
 
 				// open/close tag <TAG ..> ... </TAG>
@@ -907,8 +1024,8 @@ LPTSTR _tagXMLNode::Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*= &vpiDef
 							// error
 							return NULL;
 						}
-						_SetString( xml, pEnd, &closename );
-						if( closename == this->m_name )
+						// compare in place, and copy the close name only for the error
+						if( pEnd - xml == m_name.GetLength() && memcmp( xml, (const TCHAR *)m_name, (pEnd - xml) * sizeof(TCHAR) ) == 0 )
 						{
 							// wel-formed open/close
 							xml = pEnd+1;
@@ -917,6 +1034,7 @@ LPTSTR _tagXMLNode::Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*= &vpiDef
 						}
 						else
 						{
+							_SetString( xml, pEnd, &closename );
 							xml = pEnd+1;
 							// 2004.6.15 - example <B> alone tag
 							// now it can parse with attribute 'force_arse'
@@ -993,7 +1111,7 @@ LPTSTR _tagXMLNode::Load( const TCHAR * pszXml, LPVALUEPARSEINFO vpi /*= &vpiDef
 //========================================================
 LPTSTR _tagXMLDocument::Load( const TCHAR * pszXml,  LPVALUEPARSEINFO vpi /*= NULL*/, LPPARSEINFO pi /*= NULL*/)
 {
-	LPXNode node = EP_NEW XNode;
+	LPXNode node = _NewNode( this );
 	node->m_parent = (LPXNode)this;
 	node->m_type = XNODE_ELEMENT;
 	node->m_doc = this;
@@ -1007,7 +1125,7 @@ LPTSTR _tagXMLDocument::Load( const TCHAR * pszXml,  LPVALUEPARSEINFO vpi /*= NU
 
 	if( (end = node->Load( pszXml, vpi, pi)) == NULL )
 	{
-		EP_DELETE node;
+		_DeleteNode( node );
 		return NULL;
 	}
 
@@ -1504,7 +1622,7 @@ bool _tagXMLNode::RemoveChild( LPXNode node )
 	XNodes::iterator it = GetChildIterator( node );
 	if( *it )
 	{
-		EP_DELETE *it;
+		_DeleteNode( *it );
 		m_childs.erase( it );
 		return true;
 	}
@@ -1579,7 +1697,7 @@ bool _tagXMLNode::RemoveAttr( LPXAttr attr )
 	XAttrs::iterator it = GetAttrIterator( attr );
 	if( *it )
 	{
-		EP_DELETE *it;
+		_DeleteAttr( *it );
 		m_attrs.erase( it );
 		return true;
 	}
@@ -1881,6 +1999,7 @@ CString _tagXMLEntitys::Entity2Ref( const TCHAR * str )
 		System::Memset(sbuf,0,sizeof(TCHAR)*(len+1));
 		if( sbuf )
 			Entity2Ref( str, sbuf, len );
+		s = sbuf;
 		EP_DELETE[] sbuf;
 	}
 	return s;
@@ -0,0 +1,576 @@
+/*! 
+XPathQuery for the EpLibrary
+
+The MIT License (MIT)
+
+Copyright (c) 2008-2013 Woong Gyu La <juhgiyo@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+#include "epXPathQuery.h"
+
+#if defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+#define new DEBUG_NEW
+#undef THIS_FILE
+static char THIS_FILE[] = __FILE__;
+#endif // defined(_DEBUG) && defined(EP_ENABLE_CRTDBG)
+
+using namespace epl;
+
+XNodeIndex::XNodeIndex(LockPolicy lockPolicyType):m_nodeMap(HASH_MAP_DEFAULT_CAPACITY,LOCK_POLICY_NONE)
+{
+	switch(lockPolicyType)
+	{
+	case LOCK_POLICY_CRITICALSECTION:
+		m_indexLock=EP_NEW CriticalSectionEx();
+		break;
+	case LOCK_POLICY_MUTEX:
+		m_indexLock=EP_NEW Mutex();
+		break;
+	case LOCK_POLICY_NONE:
+		m_indexLock=EP_NEW NoLock();
+		break;
+	case LOCK_POLICY_SPIN_PARK:
+		m_indexLock=EP_NEW SpinParkLock();
+		break;
+	case LOCK_POLICY_READER_WRITER:
+		m_indexLock=EP_NEW ReaderWriterLock();
+		break;
+	default:
+		m_indexLock=NULL;
+		break;
+	}
+}
+
+XNodeIndex::~XNodeIndex()
+{
+	Clear();
+	if(m_indexLock)
+		EP_DELETE m_indexLock;
+}
+
+LPXNode XNodeIndex::GetChild(LPXNode node, const TCHAR *name)
+{
+	LockObj lock(m_indexLock);
+	const XNodes *childs=findChilds(node,name);
+	if(childs)
+		return childs->front();
+	return NULL;
+}
+
+XNodes XNodeIndex::GetChilds(LPXNode node, const TCHAR *name)
+{
+	LockObj lock(m_indexLock);
+	const XNodes *childs=findChilds(node,name);
+	if(childs)
+		return *childs;
+	return XNodes();
+}
+
+void XNodeIndex::Invalidate(LPXNode node)
+{
+	LockObj lock(m_indexLock);
+	ChildNameMap *childMap;
+	if(m_nodeMap.Find(node,childMap))
+	{
+		EP_DELETE childMap;
+		m_nodeMap.Erase(node);
+	}
+}
+
+void XNodeIndex::Clear()
+{
+	LockObj lock(m_indexLock);
+	vector<LPXNode> nodeList;
+	m_nodeMap.GetKeyList(nodeList);
+	for(size_t nodeTrav=0;nodeTrav<nodeList.size();nodeTrav++)
+		EP_DELETE m_nodeMap[nodeList[nodeTrav]];
+	m_nodeMap.Clear();
+}
+
+size_t XNodeIndex::GetIndexedNodeCount() const
+{
+	SharedLockObj lock(m_indexLock);
+	return m_nodeMap.Size();
+}
+
+const XNodes *XNodeIndex::findChilds(LPXNode node, const EpTString &name)
+{
+	ChildNameMap *childMap;
+	if(!m_nodeMap.Find(node,childMap))
+	{
+		childMap=EP_NEW ChildNameMap(node->m_childs.size(),LOCK_POLICY_NONE);
+		for(size_t childTrav=0;childTrav<node->m_childs.size();childTrav++)
+		{
+			LPXNode child=node->m_childs[childTrav];
+			if(child && child->m_type==XNODE_ELEMENT)
+				(*childMap)[EpTString(child->m_name)].push_back(child);
+		}
+		m_nodeMap.Insert(node,childMap);
+	}
+	if(!childMap->IsExist(name))
+		return NULL;
+	return &static_cast<const ChildNameMap*>(childMap)->operator[](name);
+}
+
+
+/*!
+Return the flag whether the given character ends the name in the path
+@param[in] ch the character to check
+@return true if the character ends the name, otherwise false
+*/
+static bool isNameDelimiter(TCHAR ch)
+{
+	switch(ch)
+	{
+	case _T('\0'):
+	case _T('/'):
+	case _T('['):
+	case _T(']'):
+	case _T('='):
+	case _T('@'):
+	case _T('\''):
+	case _T('"'):
+	case _T(' '):
+	case _T('\t'):
+	case _T('\r'):
+	case _T('\n'):
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*!
+Skip the whitespaces in the path
+@param[in] cur the current position
+@return the position after the whitespaces
+*/
+static const TCHAR *skipSpaces(const TCHAR *cur)
+{
+	while(*cur==_T(' ') || *cur==_T('\t') || *cur==_T('\r') || *cur==_T('\n'))
+		cur++;
+	return cur;
+}
+
+/*!
+Read the name in the path
+@param[in] cur the current position
+@param[out] retName the name read
+@return the position after the name
+*/
+static const TCHAR *readName(const TCHAR *cur, EpTString &retName)
+{
+	const TCHAR *start=cur;
+	while(!isNameDelimiter(*cur))
+		cur++;
+	retName.assign(start,cur-start);
+	return cur;
+}
+
+/*!
+Collect the descendant elements of the given node with the given name in the document order
+@param[in] node the node to collect its descendants
+@param[in] name the name of the elements, or empty for any
+@param[out] retNodes the elements collected
+*/
+static void collectDescendants(LPXNode node, const EpTString &name, XNodes &retNodes)
+{
+	for(size_t childTrav=0;childTrav<node->m_childs.size();childTrav++)
+	{
+		LPXNode child=node->m_childs[childTrav];
+		if(!child || child->m_type!=XNODE_ELEMENT)
+			continue;
+		if(name.empty() || child->m_name==name.c_str())
+			retNodes.push_back(child);
+		collectDescendants(child,name,retNodes);
+	}
+}
+
+XPathQuery::XPathQuery()
+{
+	m_isAbsolute=false;
+	m_mayRepeat=false;
+	m_isValid=false;
+	m_errorOffset=0;
+}
+
+XPathQuery::XPathQuery(const TCHAR *path)
+{
+	Compile(path);
+}
+
+XPathQuery::XPathQuery(const XPathQuery& b)
+{
+	m_path=b.m_path;
+	m_steps=b.m_steps;
+	m_isAbsolute=b.m_isAbsolute;
+	m_mayRepeat=b.m_mayRepeat;
+	m_isValid=b.m_isValid;
+	m_errorOffset=b.m_errorOffset;
+}
+
+XPathQuery::~XPathQuery()
+{
+}
+
+XPathQuery & XPathQuery::operator=(const XPathQuery&b)
+{
+	if(this!=&b)
+	{
+		m_path=b.m_path;
+		m_steps=b.m_steps;
+		m_isAbsolute=b.m_isAbsolute;
+		m_mayRepeat=b.m_mayRepeat;
+		m_isValid=b.m_isValid;
+		m_errorOffset=b.m_errorOffset;
+	}
+	return *this;
+}
+
+bool XPathQuery::Compile(const TCHAR *path)
+{
+	m_path=path?path:_T("");
+	m_steps.clear();
+	m_isAbsolute=false;
+	m_mayRepeat=false;
+	m_isValid=false;
+	m_errorOffset=0;
+
+	const TCHAR *base=m_path.c_str();
+	const TCHAR *cur=base;
+	XPathAxis axis=XPATH_AXIS_CHILD;
+	if(*cur==_T('/'))
+	{
+		m_isAbsolute=true;
+		cur++;
+		if(*cur==_T('/'))
+		{
+			axis=XPATH_AXIS_DESCENDANT;
+			cur++;
+		}
+		else if(*cur==_T('\0'))
+		{
+			// "/" selects the document itself
+			m_isValid=true;
+			return true;
+		}
+	}
+
+	while(true)
+	{
+		Step step;
+		step.m_axis=axis;
+		if(cur[0]==_T('.') && cur[1]==_T('.') && isNameDelimiter(cur[2]))
+		{
+			if(axis==XPATH_AXIS_DESCENDANT)
+				return setError(cur,base);
+			step.m_axis=XPATH_AXIS_PARENT;
+			cur+=2;
+		}
+		else if(cur[0]==_T('.') && isNameDelimiter(cur[1]))
+		{
+			if(axis==XPATH_AXIS_DESCENDANT)
+				return setError(cur,base);
+			step.m_axis=XPATH_AXIS_SELF;
+			cur++;
+		}
+		else if(*cur==_T('*'))
+			cur++;
+		else
+		{
+			cur=readName(cur,step.m_name);
+			if(step.m_name.empty())
+				return setError(cur,base);
+		}
+
+		while(*cur==_T('['))
+		{
+			Predicate predicate;
+			predicate.m_position=0;
+			cur=skipSpaces(cur+1);
+			if(*cur==_T('@'))
+			{
+				predicate.m_type=XPATH_PREDICATE_TYPE_HAS_ATTR;
+				cur=readName(cur+1,predicate.m_name);
+				if(predicate.m_name.empty())
+					return setError(cur,base);
+			}
+			else if(*cur>=_T('0') && *cur<=_T('9'))
+			{
+				predicate.m_type=XPATH_PREDICATE_TYPE_POSITION;
+				while(*cur>=_T('0') && *cur<=_T('9'))
+				{
+					predicate.m_position=predicate.m_position*10+(*cur-_T('0'));
+					cur++;
+				}
+				if(predicate.m_position==0)
+					return setError(cur,base);
+			}
+			else
+			{
+				predicate.m_type=XPATH_PREDICATE_TYPE_HAS_CHILD;
+				cur=readName(cur,predicate.m_name);
+				if(predicate.m_name.empty())
+					return setError(cur,base);
+			}
+			cur=skipSpaces(cur);
+
+			if(*cur==_T('=') && predicate.m_type!=XPATH_PREDICATE_TYPE_POSITION)
+			{
+				cur=skipSpaces(cur+1);
+				TCHAR quote=*cur;
+				if(quote!=_T('\'') && quote!=_T('"'))
+					return setError(cur,base);
+				const TCHAR *valueStart=++cur;
+				while(*cur && *cur!=quote)
+					cur++;
+				if(*cur!=quote)
+					return setError(cur,base);
+				predicate.m_value.assign(valueStart,cur-valueStart);
+				cur=skipSpaces(cur+1);
+				if(predicate.m_type==XPATH_PREDICATE_TYPE_HAS_ATTR)
+					predicate.m_type=XPATH_PREDICATE_TYPE_ATTR_EQUALS;
+				else
+					predicate.m_type=XPATH_PREDICATE_TYPE_CHILD_EQUALS;
+			}
+			if(*cur!=_T(']'))
+				return setError(cur,base);
+			cur++;
+			step.m_predicates.push_back(predicate);
+		}
+
+		if(step.m_axis==XPATH_AXIS_DESCENDANT || step.m_axis==XPATH_AXIS_PARENT)
+			m_mayRepeat=true;
+		m_steps.push_back(step);
+
+		if(*cur==_T('\0'))
+			break;
+		if(*cur!=_T('/'))
+			return setError(cur,base);
+		cur++;
+		axis=XPATH_AXIS_CHILD;
+		if(*cur==_T('/'))
+		{
+			axis=XPATH_AXIS_DESCENDANT;
+			cur++;
+		}
+	}
+	m_isValid=true;
+	return true;
+}
+
+bool XPathQuery::IsValid() const
+{
+	return m_isValid;
+}
+
+const EpTString &XPathQuery::GetPath() const
+{
+	return m_path;
+}
+
+size_t XPathQuery::GetErrorOffset() const
+{
+	return m_errorOffset;
+}
+
+XNodes XPathQuery::Select(LPXNode context, XNodeIndex *index) const
+{
+	XNodes retNodes;
+	if(!m_isValid || !context)
+		return retNodes;
+	if(m_isAbsolute)
+	{
+		while(context->m_parent)
+			context=context->m_parent;
+	}
+
+	if(index)
+	{
+		LockObj lock(index->m_indexLock);
+		select(0,context,index,false,retNodes);
+	}
+	else
+		select(0,context,NULL,false,retNodes);
+
+	if(m_mayRepeat && retNodes.size()>1)
+	{
+		// the same node may be reached from the different nodes, such as the nested elements or the parent
+		HashMap<LPXNode,size_t> foundMap(retNodes.size(),LOCK_POLICY_NONE);
+		size_t uniqueCount=0;
+		for(size_t nodeTrav=0;nodeTrav<retNodes.size();nodeTrav++)
+		{
+			if(foundMap.Insert(retNodes[nodeTrav],nodeTrav))
+				retNodes[uniqueCount++]=retNodes[nodeTrav];
+		}
+		retNodes.resize(uniqueCount);
+	}
+	return retNodes;
+}
+
+LPXNode XPathQuery::SelectFirst(LPXNode context, XNodeIndex *index) const
+{
+	XNodes retNodes;
+	if(!m_isValid || !context)
+		return NULL;
+	if(m_isAbsolute)
+	{
+		while(context->m_parent)
+			context=context->m_parent;
+	}
+
+	if(index)
+	{
+		LockObj lock(index->m_indexLock);
+		select(0,context,index,true,retNodes);
+	}
+	else
+		select(0,context,NULL,true,retNodes);
+
+	if(retNodes.empty())
+		return NULL;
+	return retNodes.front();
+}
+
+void XPathQuery::select(size_t stepIdx, LPXNode node, XNodeIndex *index, bool firstOnly, XNodes &retNodes) const
+{
+	if(stepIdx==m_steps.size())
+	{
+		retNodes.push_back(node);
+		return;
+	}
+	const Step &step=m_steps[stepIdx];
+
+	const XNodes *candidates;
+	XNodes collected;
+	if(index && step.m_axis==XPATH_AXIS_CHILD && !step.m_name.empty())
+	{
+		candidates=index->findChilds(node,step.m_name);
+		if(!candidates)
+			return;
+	}
+	else
+	{
+		collect(step,node,index,collected);
+		candidates=&collected;
+	}
+
+	XNodes filtered;
+	for(size_t predTrav=0;predTrav<step.m_predicates.size();predTrav++)
+	{
+		const Predicate &predicate=step.m_predicates[predTrav];
+		XNodes passed;
+		if(predicate.m_type==XPATH_PREDICATE_TYPE_POSITION)
+		{
+			if(predicate.m_position<=candidates->size())
+				passed.push_back(candidates->at(predicate.m_position-1));
+		}
+		else
+		{
+			for(size_t nodeTrav=0;nodeTrav<candidates->size();nodeTrav++)
+			{
+				if(test(predicate,candidates->at(nodeTrav),index))
+					passed.push_back(candidates->at(nodeTrav));
+			}
+		}
+		filtered.swap(passed);
+		candidates=&filtered;
+	}
+
+	for(size_t nodeTrav=0;nodeTrav<candidates->size();nodeTrav++)
+	{
+		select(stepIdx+1,candidates->at(nodeTrav),index,firstOnly,retNodes);
+		if(firstOnly && !retNodes.empty())
+			return;
+	}
+}
+
+void XPathQuery::collect(const Step &step, LPXNode node, XNodeIndex *index, XNodes &retNodes)
+{
+	switch(step.m_axis)
+	{
+	case XPATH_AXIS_CHILD:
+		for(size_t childTrav=0;childTrav<node->m_childs.size();childTrav++)
+		{
+			LPXNode child=node->m_childs[childTrav];
+			if(child && child->m_type==XNODE_ELEMENT && (step.m_name.empty() || child->m_name==step.m_name.c_str()))
+				retNodes.push_back(child);
+		}
+		break;
+	case XPATH_AXIS_DESCENDANT:
+		collectDescendants(node,step.m_name,retNodes);
+		break;
+	case XPATH_AXIS_SELF:
+		retNodes.push_back(node);
+		break;
+	case XPATH_AXIS_PARENT:
+		if(node->m_parent)
+			retNodes.push_back(node->m_parent);
+		break;
+	}
+}
+
+bool XPathQuery::test(const Predicate &predicate, LPXNode node, XNodeIndex *index)
+{
+	switch(predicate.m_type)
+	{
+	case XPATH_PREDICATE_TYPE_HAS_ATTR:
+		return node->GetAttr(predicate.m_name.c_str())!=NULL;
+	case XPATH_PREDICATE_TYPE_ATTR_EQUALS:
+		{
+			LPXAttr attr=node->GetAttr(predicate.m_name.c_str());
+			return attr && attr->m_value==predicate.m_value.c_str();
+		}
+	case XPATH_PREDICATE_TYPE_HAS_CHILD:
+		if(index)
+			return index->findChilds(node,predicate.m_name)!=NULL;
+		return node->GetChild(predicate.m_name.c_str())!=NULL;
+	case XPATH_PREDICATE_TYPE_CHILD_EQUALS:
+		if(index)
+		{
+			const XNodes *childs=index->findChilds(node,predicate.m_name);
+			if(!childs)
+				return false;
+			for(size_t childTrav=0;childTrav<childs->size();childTrav++)
+			{
+				if(childs->at(childTrav)->m_value==predicate.m_value.c_str())
+					return true;
+			}
+			return false;
+		}
+		for(size_t childTrav=0;childTrav<node->m_childs.size();childTrav++)
+		{
+			LPXNode child=node->m_childs[childTrav];
+			if(child && child->m_name==predicate.m_name.c_str() && child->m_value==predicate.m_value.c_str())
+				return true;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+bool XPathQuery::setError(const TCHAR *errorPos, const TCHAR *path)
+{
+	m_steps.clear();
+	m_isValid=false;
+	m_errorOffset=errorPos-path;
+	return false;
+}